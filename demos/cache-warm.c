@@ -0,0 +1,292 @@
+/* Offline shader cache generator for the d3d11 backend. Compiles all shaders
+ * needed for a fixed matrix of representative source formats, output formats
+ * and rendering presets, and writes the resulting `pl_cache` to a file. This
+ * file can be shipped alongside an application and loaded on first run (e.g.
+ * with `pl_cache_load_file`), to avoid the cost of the GLSL -> SPIR-V -> HLSL
+ * -> DXBC compilation chain on end user machines.
+ *
+ * Usage: cache-warm [-o <file>] [-w] [-l <feature level>] [-j <threads>]
+ *
+ *  -o  output file (default: placebo.cache)
+ *  -w  use the WARP software rasterizer, so no GPU is required
+ *  -l  D3D feature level to compile for, e.g. 11_0 (default: highest)
+ *  -j  number of shader compilation threads (default: 4)
+ *
+ * Note: The cache key includes the SPIRV-Cross and d3dcompiler versions as
+ * well as the device feature level, so the cache must be generated with the
+ * same libplacebo build, d3dcompiler DLL and feature level that clients will
+ * be using. Entries that don't match are simply ignored (and regenerated).
+ *
+ * License: CC0 / Public Domain
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libplacebo/cache.h>
+#include <libplacebo/d3d11.h>
+#include <libplacebo/renderer.h>
+#include <libplacebo/utils/upload.h>
+
+#include "pl_clock.h"
+
+#define SRC_W 1920
+#define SRC_H 1080
+#define MAX_PLANES 2
+#define MAX_FRAMES 8
+
+struct frame {
+    struct pl_frame frame;
+    pl_tex tex[MAX_PLANES];
+};
+
+struct plane_fmt {
+    int comps;
+    int depth;      // bits per component
+    int sub_x, sub_y;
+    int map[4];
+};
+
+static bool create_frame(pl_gpu gpu, struct frame *out, int w, int h,
+                         const struct plane_fmt *planes, int num_planes,
+                         struct pl_color_repr repr, struct pl_color_space csp)
+{
+    *out = (struct frame) {
+        .frame = {
+            .num_planes = num_planes,
+            .repr = repr,
+            .color = csp,
+        },
+    };
+
+    for (int i = 0; i < num_planes; i++) {
+        const struct plane_fmt *fmt = &planes[i];
+        struct pl_plane_data data = {
+            .type = PL_FMT_UNORM,
+            .width = w >> fmt->sub_x,
+            .height = h >> fmt->sub_y,
+            .pixel_stride = fmt->comps * (fmt->depth / 8),
+        };
+
+        for (int c = 0; c < fmt->comps; c++) {
+            data.component_size[c] = fmt->depth;
+            data.component_map[c] = fmt->map[c];
+        }
+
+        if (!pl_recreate_plane(gpu, &out->frame.planes[i], &out->tex[i], &data))
+            return false;
+    }
+
+    if (num_planes > 1)
+        pl_frame_set_chroma_location(&out->frame, PL_CHROMA_LEFT);
+    return true;
+}
+
+static void destroy_frame(pl_gpu gpu, struct frame *frame)
+{
+    for (int i = 0; i < MAX_PLANES; i++)
+        pl_tex_destroy(gpu, &frame->tex[i]);
+}
+
+static bool parse_level(const char *str, int *out)
+{
+    static const struct { const char *name; int level; } levels[] = {
+        { "9_1",  D3D_FEATURE_LEVEL_9_1  },
+        { "9_2",  D3D_FEATURE_LEVEL_9_2  },
+        { "9_3",  D3D_FEATURE_LEVEL_9_3  },
+        { "10_0", D3D_FEATURE_LEVEL_10_0 },
+        { "10_1", D3D_FEATURE_LEVEL_10_1 },
+        { "11_0", D3D_FEATURE_LEVEL_11_0 },
+        { "11_1", D3D_FEATURE_LEVEL_11_1 },
+        { "12_0", D3D_FEATURE_LEVEL_12_0 },
+        { "12_1", D3D_FEATURE_LEVEL_12_1 },
+    };
+
+    for (int i = 0; i < sizeof(levels) / sizeof(levels[0]); i++) {
+        if (strcmp(str, levels[i].name) == 0) {
+            *out = levels[i].level;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [-o <file>] [-w] [-l <feature level>] "
+            "[-j <threads>]\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    const char *out_path = "placebo.cache";
+    bool warp = false;
+    int level = 0;
+    int threads = 4;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "-w") == 0) {
+            warp = true;
+        } else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            if (!parse_level(argv[++i], &level)) {
+                fprintf(stderr, "Unknown feature level '%s'\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    int ret = 1;
+    pl_log log = pl_log_create(PL_API_VER, pl_log_params(
+        .log_cb    = pl_log_color,
+        .log_level = PL_LOG_INFO,
+    ));
+
+    pl_d3d11 d3d11 = pl_d3d11_create(log, pl_d3d11_params(
+        .force_software    = warp,
+        .min_feature_level = level,
+        .max_feature_level = level,
+    ));
+
+    pl_cache cache = NULL;
+    pl_renderer rr = NULL;
+    struct frame images[MAX_FRAMES] = {0}, targets[MAX_FRAMES] = {0};
+    int num_images = 0, num_targets = 0;
+    if (!d3d11)
+        goto done;
+
+    pl_gpu gpu = d3d11->gpu;
+    cache = pl_cache_create(pl_cache_params(.log = log));
+    pl_gpu_set_cache(gpu, cache);
+    rr = pl_renderer_create(log, gpu);
+
+    // Source formats: 8-bit 4:2:0 SDR, 10-bit 4:2:0 HDR10, 8-bit RGB
+    static const struct plane_fmt yuv8[] = {
+        { .comps = 1, .depth = 8, .map = {0} },
+        { .comps = 2, .depth = 8, .sub_x = 1, .sub_y = 1, .map = {1, 2} },
+    };
+
+    static const struct plane_fmt yuv16[] = {
+        { .comps = 1, .depth = 16, .map = {0} },
+        { .comps = 2, .depth = 16, .sub_x = 1, .sub_y = 1, .map = {1, 2} },
+    };
+
+    static const struct plane_fmt rgb8[] = {
+        { .comps = 4, .depth = 8, .map = {0, 1, 2, 3} },
+    };
+
+    struct pl_color_repr yuv10_repr = pl_color_repr_uhdtv;
+    yuv10_repr.sys = PL_COLOR_SYSTEM_BT_2020_NC;
+    yuv10_repr.bits = (struct pl_bit_encoding) {
+        .sample_depth = 16,
+        .color_depth = 10,
+    };
+
+    struct pl_color_repr rgb_repr = pl_color_repr_rgb;
+    rgb_repr.alpha = PL_ALPHA_NONE;
+
+    bool ok = true;
+#define IMAGE(...) ok &= create_frame(gpu, &images[num_images++], SRC_W, SRC_H, __VA_ARGS__)
+    IMAGE(yuv8, 2, pl_color_repr_hdtv, pl_color_space_bt709);
+    IMAGE(yuv16, 2, yuv10_repr, pl_color_space_hdr10);
+    IMAGE(rgb8, 1, rgb_repr, pl_color_space_srgb);
+#undef IMAGE
+
+    // Output formats: 8-bit SDR and 16-bit HDR10, at the source resolution
+    // as well as up- and downscaled, since these select different scalers
+    static const struct { int w, h; } sizes[] = {
+        { SRC_W, SRC_H },
+        { 3840,  2160  },
+        { 1280,  720   },
+    };
+
+    static const struct plane_fmt out8[] = {
+        { .comps = 4, .depth = 8, .map = {0, 1, 2, 3} },
+    };
+
+    static const struct plane_fmt out16[] = {
+        { .comps = 4, .depth = 16, .map = {0, 1, 2, 3} },
+    };
+
+    struct pl_color_repr out16_repr = pl_color_repr_rgb;
+    out16_repr.bits.color_depth = 10;
+
+    for (int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+#define TARGET(...) ok &= create_frame(gpu, &targets[num_targets++], sizes[i].w, sizes[i].h, __VA_ARGS__)
+        TARGET(out8, 1, pl_color_repr_rgb, pl_color_space_srgb);
+        TARGET(out16, 1, out16_repr, pl_color_space_hdr10);
+#undef TARGET
+    }
+
+    if (!ok) {
+        fprintf(stderr, "Failed creating frames!\n");
+        goto done;
+    }
+
+    struct pl_frame image_frames[MAX_FRAMES], target_frames[MAX_FRAMES];
+    for (int i = 0; i < num_images; i++)
+        image_frames[i] = images[i].frame;
+    for (int i = 0; i < num_targets; i++)
+        target_frames[i] = targets[i].frame;
+
+    const struct pl_render_params *presets[] = {
+        &pl_render_fast_params,
+        &pl_render_default_params,
+        &pl_render_high_quality_params,
+    };
+
+    pl_clock_t start = pl_clock_now();
+    ok = pl_render_precompile(rr, pl_render_precompile_params(
+        .images      = image_frames,
+        .num_images  = num_images,
+        .targets     = target_frames,
+        .num_targets = num_targets,
+        .params      = presets,
+        .num_params  = sizeof(presets) / sizeof(presets[0]),
+        .num_threads = threads,
+    ));
+
+    printf("Compiled %d shader objects (%zu bytes) in %.3f s\n",
+           pl_cache_objects(cache), pl_cache_size(cache),
+           pl_clock_diff(pl_clock_now(), start));
+    if (!ok)
+        fprintf(stderr, "Warning: some shaders failed to compile!\n");
+
+    FILE *file = fopen(out_path, "wb");
+    if (!file) {
+        fprintf(stderr, "Failed opening '%s' for writing!\n", out_path);
+        goto done;
+    }
+
+    bool saved = pl_cache_save_file(cache, file) > 0;
+    saved &= fclose(file) == 0;
+    if (!saved) {
+        fprintf(stderr, "Failed writing '%s'!\n", out_path);
+        goto done;
+    }
+
+    printf("Wrote %s\n", out_path);
+    ret = ok ? 0 : 1;
+
+done:
+    if (d3d11) {
+        for (int i = 0; i < num_images; i++)
+            destroy_frame(d3d11->gpu, &images[i]);
+        for (int i = 0; i < num_targets; i++)
+            destroy_frame(d3d11->gpu, &targets[i]);
+        pl_gpu_set_cache(d3d11->gpu, NULL);
+    }
+    pl_renderer_destroy(&rr);
+    pl_cache_destroy(&cache);
+    pl_d3d11_destroy(&d3d11);
+    pl_log_destroy(&log);
+    return ret;
+}
@@ -1,4 +1,5 @@
-/* GPU->GPU transfer benchmarks. Requires some manual setup.
+/* GPU->GPU transfer and multi-GPU rendering benchmarks. Requires some manual
+ * setup.
  *
  * License: CC0 / Public Domain
  */
@@ -11,7 +12,9 @@
 #include <math.h>
 
 #include <libplacebo/gpu.h>
+#include <libplacebo/renderer.h>
 #include <libplacebo/vulkan.h>
+#include <libplacebo/utils/multigpu.h>
 
 #include "pl_clock.h"
 
@@ -422,6 +425,108 @@ static void run_tests(pl_gpu srcgpu, pl_gpu dstgpu)
     }
 }
 
+static struct pl_frame frame_from_tex(pl_tex tex)
+{
+    return (struct pl_frame) {
+        .num_planes = 1,
+        .planes[0] = {
+            .texture           = tex,
+            .components        = 4,
+            .component_mapping = {0, 1, 2, 3},
+        },
+        .repr  = pl_color_repr_rgb,
+        .color = pl_color_space_srgb,
+    };
+}
+
+// Measures end-to-end rendering throughput of alternate frame rendering,
+// upscaling a source frame on every GPU to a target on the primary GPU
+static double bench_render(pl_log log, const pl_gpu gpus[], int num_gpus)
+{
+    pl_tex src[PL_MULTIGPU_MAX] = {0}, dst = NULL;
+    pl_multigpu mg = pl_multigpu_create(log, pl_multigpu_params(
+        .gpus     = gpus,
+        .num_gpus = num_gpus,
+    ));
+    if (!mg)
+        exit(2);
+
+    for (int i = 0; i < num_gpus; i++) {
+        pl_fmt fmt = pl_find_named_fmt(gpus[i], "rgba8");
+        if (!fmt)
+            exit(2);
+        src[i] = pl_tex_create(gpus[i], pl_tex_params(
+            .w          = WIDTH,
+            .h          = HEIGHT,
+            .format     = fmt,
+            .sampleable = true,
+            .blit_dst   = true,
+        ));
+        if (!src[i])
+            exit(2);
+        pl_tex_clear(gpus[i], src[i], (float[4]) { 0.5, 0.5, 0.5, 1.0 });
+    }
+
+    dst = pl_tex_create(gpus[0], pl_tex_params(
+        .w              = 2 * WIDTH,
+        .h              = 2 * HEIGHT,
+        .format         = pl_find_named_fmt(gpus[0], "rgba8"),
+        .renderable     = true,
+        .host_writable  = true,
+        .blit_dst       = true,
+    ));
+    if (!dst)
+        exit(2);
+
+    const struct pl_frame target = frame_from_tex(dst);
+    pl_clock_t start_warmup = pl_clock_now(), start_test = 0;
+    uint64_t frames = 0, frames_warmup = 0;
+    do {
+        // Keep one frame in flight per GPU
+        if (frames >= num_gpus) {
+            if (!pl_multigpu_present(mg, frames - num_gpus, &target, UINT64_MAX))
+                exit(2);
+        }
+
+        const struct pl_frame image = frame_from_tex(src[frames % num_gpus]);
+        if (!pl_multigpu_render(mg, frames, &image, &target, &pl_render_default_params))
+            exit(2);
+        frames++;
+
+        if (frames % POLL_FREQ == 0) {
+            pl_clock_t now = pl_clock_now();
+            if (start_test) {
+                if (pl_clock_diff(now, start_test) > TEST_MS * 1e-3)
+                    break;
+            } else if (pl_clock_diff(now, start_warmup) > WARMUP_MS * 1e-3) {
+                start_test = now;
+                frames_warmup = frames;
+            }
+        }
+    } while (true);
+
+    for (uint64_t i = frames - num_gpus; i < frames; i++)
+        pl_multigpu_present(mg, i, &target, UINT64_MAX);
+    pl_gpu_finish(gpus[0]);
+    double dur = pl_clock_diff(pl_clock_now(), start_test) / (frames - frames_warmup);
+
+    pl_multigpu_destroy(&mg);
+    pl_tex_destroy(gpus[0], &dst);
+    for (int i = 0; i < num_gpus; i++)
+        pl_tex_destroy(gpus[i], &src[i]);
+    return dur;
+}
+
+static void run_render_tests(pl_log log, pl_gpu primary, pl_gpu secondary)
+{
+    const pl_gpu gpus[] = { primary, secondary };
+    for (int num = 1; num <= 2; num++) {
+        double dur = bench_render(log, gpus, num);
+        printf("  render %d gpu%s      : avg %.0f μs\t%.3f fps\n",
+               num, num > 1 ? "s" : " ", 1e6 * dur, 1.0 / dur);
+    }
+}
+
 int main(int argc, const char *argv[])
 {
     if (argc < 3) {
@@ -477,6 +582,11 @@ int main(int argc, const char *argv[])
         run_tests(dev2->gpu, dev1->gpu);
     }
 
+    if (strcmp(argv[1], argv[2])) {
+        printf("%s + %s rendering:\n", argv[1], argv[2]);
+        run_render_tests(log, dev1->gpu, dev2->gpu);
+    }
+
     pl_vulkan_destroy(&dev1);
     pl_vulkan_destroy(&dev2);
     pl_vk_inst_destroy(&inst);
@@ -43,6 +43,8 @@ static void uninit(struct plplay *p)
     }
 
     pl_queue_destroy(&p->queue);
+    pl_dovi_state_destroy(&p->dovi_state);
+    pl_avhwmap_cache_destroy(&p->hwmap_cache);
     pl_renderer_destroy(&p->renderer);
     pl_options_free(&p->opts);
 
@@ -74,6 +76,7 @@ static void uninit(struct plplay *p)
 
     // Free this before destroying the window to release associated GPU buffers
     avcodec_free_context(&p->codec);
+    pl_avbuf_pool_destroy(&p->avbuf_pool);
     avformat_free_context(p->format);
 
     ui_destroy(&p->ui);
@@ -196,8 +199,14 @@ static bool init_codec(struct plplay *p)
         printf("Using software decoding\n");
 
     p->codec->thread_count = FFMIN(av_cpu_count() + 1, 16);
-    p->codec->get_buffer2 = pl_get_buffer2;
-    p->codec->opaque = &p->win->gpu;
+    p->avbuf_pool = pl_avbuf_pool_create(p->win->gpu);
+    if (p->avbuf_pool) {
+        p->codec->get_buffer2 = pl_get_buffer2_pooled;
+        p->codec->opaque = p->avbuf_pool;
+    } else {
+        p->codec->get_buffer2 = pl_get_buffer2;
+        p->codec->opaque = &p->win->gpu;
+    }
 #if LIBAVCODEC_VERSION_MAJOR < 60
     AV_NOWARN_DEPRECATED({
         p->codec->thread_safe_callbacks = 1;
@@ -225,6 +234,8 @@ static bool map_frame(pl_gpu gpu, pl_tex *tex,
         .frame      = frame,
         .tex        = tex,
         .map_dovi   = !p->ignore_dovi,
+        .dovi_state = p->dovi_state,
+        .hwmap_cache = p->hwmap_cache,
     ));
 
     av_frame_free(&frame); // references are preserved by `out_frame`
@@ -394,6 +405,7 @@ static bool render_frame(struct plplay *p, const struct pl_swapchain_frame *fram
         pl_icc_update(p->log, &p->icc, NULL, pl_icc_params(
             .max_luma  = target_luma,
             .force_bpc = p->force_bpc,
+            .progressive = true,
         ));
         target.icc = p->icc;
     }
@@ -744,6 +756,8 @@ int main(int argc, char *argv[])
     }
 
     p->queue = pl_queue_create(p->win->gpu);
+    p->dovi_state = pl_dovi_state_create();
+    p->hwmap_cache = pl_avhwmap_cache_create(p->win->gpu);
     int ret = pl_thread_create(&p->decoder_thread, decode_loop, p);
     if (ret != 0) {
         fprintf(stderr, "Failed creating decode thread: %s\n", strerror(errno));
@@ -2,6 +2,7 @@
 #include <libavformat/avformat.h>
 
 #include <libplacebo/options.h>
+#include <libplacebo/utils/dolbyvision.h>
 #include <libplacebo/utils/frame_queue.h>
 
 #include "common.h"
@@ -46,10 +47,13 @@ struct plplay {
     pl_renderer renderer;
     pl_queue queue;
     pl_cache cache;
+    pl_dovi_state dovi_state;
+    pl_avhwmap_cache hwmap_cache;
 
     // libav*
     AVFormatContext *format;
     AVCodecContext *codec;
+    pl_avbuf_pool avbuf_pool; // for `codec->get_buffer2`
     const AVStream *stream; // points to first video stream of `format`
     pl_thread decoder_thread;
     bool decoder_thread_created;
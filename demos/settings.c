@@ -562,6 +562,7 @@ void update_settings(struct plplay *p, const struct pl_frame *target)
             nk_property_float(nk, "Smoothing period", 0.0, &ppar->smoothing_period, 1000.0, 5.0, 1.0);
             nk_property_float(nk, "Peak percentile", 95.0, &ppar->percentile, 100.0, 0.01, 0.001);
             nk_checkbox_label(nk, "Allow 1-frame delay", &ppar->allow_delayed);
+            nk_property_int(nk, "Pixel stride", 0, &ppar->stride, PL_PEAK_DETECT_MAX_STRIDE, 1, 1);
 
             struct pl_hdr_metadata metadata;
             if (pl_renderer_get_hdr_metadata(p->renderer, &metadata)) {
@@ -637,6 +638,7 @@ void update_settings(struct plplay *p, const struct pl_frame *target)
             nk_property_int(nk, "3DLUT size h", 7, &cpar->lut3d_size[2], 1024, 1, 1);
 
             nk_checkbox_label(nk, "Tricubic interpolation", &cpar->lut3d_tricubic);
+            nk_checkbox_label(nk, "Adaptive 3DLUT size", &cpar->lut3d_adaptive);
             nk_checkbox_label(nk, "Force full LUT", &cpar->force_tone_mapping_lut);
             nk_checkbox_label(nk, "Inverse tone mapping", &cpar->inverse_tone_mapping);
             nk_checkbox_label(nk, "Gamut expansion", &cpar->gamut_expansion);
@@ -721,6 +723,7 @@ void update_settings(struct plplay *p, const struct pl_frame *target)
                 [PL_DITHER_ORDERED_LUT]     = "Ordered (LUT)",
                 [PL_DITHER_ORDERED_FIXED]   = "Ordered (fixed size)",
                 [PL_DITHER_WHITE_NOISE]     = "White noise",
+                [PL_DITHER_BLUE_NOISE_TEMPORAL] = "Blue noise (temporal)",
             };
 
             nk_label(nk, "Dither method:", NK_TEXT_LEFT);
@@ -734,6 +737,7 @@ void update_settings(struct plplay *p, const struct pl_frame *target)
             nk_label(nk, "LUT size:", NK_TEXT_LEFT);
             switch (dpar->method) {
             case PL_DITHER_BLUE_NOISE:
+            case PL_DITHER_BLUE_NOISE_TEMPORAL:
             case PL_DITHER_ORDERED_LUT: {
                 int size = dpar->lut_size - 1;
                 nk_combobox(nk, lut_sizes, 8, &size, 16, nk_vec2(nk_widget_width(nk), 200));
@@ -959,6 +963,7 @@ void update_settings(struct plplay *p, const struct pl_frame *target)
                     pl_icc_profile_compute_signature(&profile);
                     pl_icc_update(p->log, &p->icc, &profile, pl_icc_params(
                         .force_bpc = p->force_bpc,
+                        .progressive = true,
                         .max_luma  = p->use_icc_luma ? 0 : PL_COLOR_SDR_WHITE,
                     ));
                     av_file_unmap((void *) profile.data, profile.len);
@@ -1109,7 +1114,12 @@ void update_settings(struct plplay *p, const struct pl_frame *target)
             nk_checkbox_label(nk, "Disable gamma-aware dither", &par->disable_dither_gamma_correction);
             nk_checkbox_label(nk, "Disable FBOs / advanced rendering", &par->disable_fbos);
             nk_checkbox_label(nk, "Force low-bit depth FBOs", &par->force_low_bit_depth_fbos);
+            nk_checkbox_label(nk, "Packed 32-bit FBOs", &par->packed_fbos);
             nk_checkbox_label(nk, "Disable constant hard-coding", &par->dynamic_constants);
+            nk_checkbox_label(nk, "Dispatch plane passes as compute", &par->parallel_planes);
+            nk_checkbox_label(nk, "Reduced precision intermediates", &par->low_precision);
+            nk_checkbox_label(nk, "Approximate PQ transfer function", &par->fast_transfer);
+            nk_property_int(nk, "Pass timing interval", 0, &par->timer_interval, 1000, 1, 1);
 
             if (nk_check_label(nk, "Ignore Dolby Vision metadata", p->ignore_dovi) != p->ignore_dovi) {
                 // Flush the renderer cache on changes, since this can
@@ -15,7 +15,9 @@
  * License along with libplacebo. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <errno.h>
 #include <stdio.h>
+#include <string.h>
 #include <locale.h>
 #include <limits.h>
 
@@ -24,384 +26,2291 @@
 #include "log.h"
 #include "pl_thread.h"
 
+#if defined(PL_HAVE_UNIX) || defined(PL_HAVE_APPLE)
+#define PL_HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif defined(PL_HAVE_WIN32)
+#include <io.h>
+#include <windows.h>
+#endif
+
 const struct pl_cache_params pl_cache_default_params = {0};
 
-struct priv {
-    pl_log log;
+// Objects are stored in a flat node pool, linked together into an intrusive
+// doubly-linked list in LRU order (oldest first), and indexed by an
+// open-addressed hash table (linear probing, backwards-shift deletion)
+#define NODE_NONE (-1)
+
+struct cache_node {
+    pl_cache_obj obj;
+    int prev, next; // LRU list links, or NODE_NONE
+    int heap_idx;   // position in `shard.heap` (cost-aware eviction only)
+    double prio;    // GreedyDual-Size priority
+};
+
+struct shard {
     pl_mutex lock;
-    PL_ARRAY(pl_cache_obj) objects;
+    PL_ARRAY(struct cache_node) nodes;
+    PL_ARRAY(int) free_nodes;
+    int *table;         // node index + 1, or 0 for empty slots
+    size_t table_size;  // always a power of two (or 0)
+    int head, tail;     // oldest/newest node
+    int num_objects;
     size_t total_size;
+    size_t max_size;    // this shard's share of `max_total_size`
+    struct pl_cache_stats stats;
+
+    // Min-heap of nodes ordered by priority, for cost-aware eviction
+    PL_ARRAY(int) heap;
+    double inflation;   // priority of the most recently evicted object
 };
 
-int pl_cache_objects(pl_cache cache)
+#define MAX_SHARDS 64
+
+// Read-only view of a serialized cache file, see `pl_cache_load_mmap`
+struct cache_mapping {
+    const uint8_t *data;
+    size_t size;
+#ifdef PL_HAVE_WIN32
+    HANDLE file, mapping;
+#endif
+};
+
+// Lazily loaded object, see `pl_cache_load_lazy`
+struct lazy_entry {
+    uint64_t key;
+    uint64_t hash;
+    const uint8_t *data; // NULL for entries that were consumed or superseded
+    size_t size;         // stored (possibly compressed) size
+    size_t raw_size;
+    uint32_t codec;      // enum cache_codec
+    float cost;
+    int seq;             // load order, to resolve duplicate keys
+};
+
+// Deferred `pl_cache_params.set` event, see `pl_cache_params.async_set`
+struct set_event {
+    pl_cache_obj obj; // owned copy of the object, or size 0 for deletions
+    int seq;          // submission order, to coalesce events
+};
+
+struct async_state {
+    pl_mutex lock;
+    pl_cond wakeup;  // signals new events, flush requests or shutdown
+    pl_cond flushed; // signals that `flush_seq` has been processed
+    pl_thread thread;
+    PL_ARRAY(struct set_event) events;
+    int seq, flush_seq, done_seq;
+    bool quit;
+};
+
+// Position of the most recent record for a journaled object, see
+// `pl_cache_journal_open`
+struct journal_rec {
+    uint64_t key;
+    uint64_t hash;   // hash of the raw object data, to skip redundant records
+    uint64_t offset; // position of the record within the journal file
+    uint64_t len;    // total size of the record, including padding
+};
+
+struct journal {
+    pl_mutex lock;          // protects all other fields, nests inside shard locks
+    pl_mutex compact_lock;  // serializes compaction
+    pl_cond wakeup;         // signals compaction requests or shutdown
+    pl_thread thread;
+    bool has_thread;
+    bool compact;           // compaction requested
+    bool quit;
+    char *path, *tmp_path;
+    FILE *file;             // opened for appending, or NULL on error
+    uint64_t size;          // current size of the journal file
+    uint64_t live_size;     // total size of all live records
+    uint64_t compact_at;    // don't compact before reaching this size
+    PL_ARRAY(struct journal_rec) index; // live records, sorted by key
+};
+
+// Record prepared for an object about to be inserted, see `journal_prepare`
+struct journal_op {
+    uint64_t hash;
+    pl_str rec; // serialized record, or empty if it was already up-to-date
+};
+
+struct priv {
+    pl_log log;
+    struct shard shards[MAX_SHARDS];
+    int num_shards;
+    struct async_state *async;
+    struct journal *journal;
+
+    // Protected by `map_lock`, which nests inside shard locks
+    pl_mutex map_lock;
+    PL_ARRAY(struct cache_mapping) mappings;
+    PL_ARRAY(struct lazy_entry) lazy; // sorted by key
+
+    // Number of live lazy entries. Only modified with `map_lock` held, but
+    // may be read without it, to skip taking `map_lock` entirely when no
+    // lazy entries exist
+    atomic_int num_lazy;
+};
+
+static inline struct shard *get_shard(struct priv *p, uint64_t key)
 {
-    if (!cache)
-        return 0;
+    // Use the high bits, since the index is based on the (mixed) low bits
+    return &p->shards[(key >> 32) % p->num_shards];
+}
 
-    struct priv *p = PL_PRIV(cache);
-    pl_mutex_lock(&p->lock);
-    int num = p->objects.num;
-    pl_mutex_unlock(&p->lock);
-    return num;
+static inline size_t key_slot(const struct shard *s, uint64_t key)
+{
+    // Keys are usually already hashes, but mix them anyway to make sure the
+    // low bits are well distributed
+    return (key * GOLDEN_RATIO_64) >> 32 & (s->table_size - 1);
 }
 
-size_t pl_cache_size(pl_cache cache)
+// Returns the table slot containing `key`, or the empty slot it would go into
+static size_t find_slot(const struct shard *s, uint64_t key)
 {
-    if (!cache)
-        return 0;
+    const size_t mask = s->table_size - 1;
+    size_t i = key_slot(s, key);
+    while (s->table[i] && s->nodes.elem[s->table[i] - 1].obj.key != key)
+        i = (i + 1) & mask;
+    return i;
+}
 
-    struct priv *p = PL_PRIV(cache);
-    pl_mutex_lock(&p->lock);
-    size_t size = p->total_size;
-    pl_mutex_unlock(&p->lock);
-    return size;
+static int find_node(const struct shard *s, uint64_t key)
+{
+    if (!s->num_objects)
+        return NODE_NONE;
+    return s->table[find_slot(s, key)] - 1;
 }
 
-pl_cache pl_cache_create(const struct pl_cache_params *params)
+static void table_remove(struct shard *s, size_t slot)
 {
-    struct pl_cache_t *cache = pl_zalloc_obj(NULL, cache, struct priv);
-    struct priv *p = PL_PRIV(cache);
-    pl_mutex_init(&p->lock);
-    if (params) {
-        cache->params = *params;
-        p->log = params->log;
+    const size_t mask = s->table_size - 1;
+    size_t i = slot, j = slot;
+    s->table[i] = 0;
+    for (;;) {
+        j = (j + 1) & mask;
+        if (!s->table[j])
+            return;
+        size_t k = key_slot(s, s->nodes.elem[s->table[j] - 1].obj.key);
+        // Entry at `j` can be moved into the hole at `i` unless its home slot
+        // `k` lies cyclically within (i, j]
+        if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+            continue;
+        s->table[i] = s->table[j];
+        s->table[j] = 0;
+        i = j;
     }
+}
 
-    // Sanitize size limits
-    size_t total_size  = PL_DEF(cache->params.max_total_size,  SIZE_MAX);
-    size_t object_size = PL_DEF(cache->params.max_object_size, SIZE_MAX);
-    object_size = PL_MIN(total_size, object_size);
-    cache->params.max_total_size  = total_size;
-    cache->params.max_object_size = object_size;
+static void table_resize(pl_cache cache, struct shard *s, size_t size)
+{
+    pl_free(s->table);
+    s->table = pl_calloc((void *) cache, size, sizeof(s->table[0]));
+    s->table_size = size;
+    for (int n = s->head; n != NODE_NONE; n = s->nodes.elem[n].next)
+        s->table[find_slot(s, s->nodes.elem[n].obj.key)] = n + 1;
+}
 
-    return cache;
+static void list_unlink(struct shard *s, int n)
+{
+    struct cache_node *node = &s->nodes.elem[n];
+    if (node->prev != NODE_NONE) {
+        s->nodes.elem[node->prev].next = node->next;
+    } else {
+        s->head = node->next;
+    }
+    if (node->next != NODE_NONE) {
+        s->nodes.elem[node->next].prev = node->prev;
+    } else {
+        s->tail = node->prev;
+    }
+    node->prev = node->next = NODE_NONE;
 }
 
-static void remove_obj(pl_cache cache, pl_cache_obj obj)
+static void list_append(struct shard *s, int n)
 {
-    struct priv *p = PL_PRIV(cache);
+    struct cache_node *node = &s->nodes.elem[n];
+    node->prev = s->tail;
+    node->next = NODE_NONE;
+    if (s->tail != NODE_NONE) {
+        s->nodes.elem[s->tail].next = n;
+    } else {
+        s->head = n;
+    }
+    s->tail = n;
+}
 
-    p->total_size -= obj.size;
-    if (obj.free)
-        obj.free(obj.data);
+// Objects without an explicit cost are assumed to be regenerated at this rate
+#define DEFAULT_COST_PER_BYTE 1e-9
+
+static inline bool heap_less(const struct shard *s, int a, int b)
+{
+    return s->nodes.elem[s->heap.elem[a]].prio < s->nodes.elem[s->heap.elem[b]].prio;
 }
 
-void pl_cache_destroy(pl_cache *pcache)
+static inline void heap_swap(struct shard *s, int a, int b)
 {
-    pl_cache cache = *pcache;
-    if (!cache)
-         return;
+    PL_SWAP(s->heap.elem[a], s->heap.elem[b]);
+    s->nodes.elem[s->heap.elem[a]].heap_idx = a;
+    s->nodes.elem[s->heap.elem[b]].heap_idx = b;
+}
 
-    struct priv *p = PL_PRIV(cache);
-    for (int i = 0; i < p->objects.num; i++)
-        remove_obj(cache, p->objects.elem[i]);
+static void heap_sift(struct shard *s, int i)
+{
+    while (i > 0 && heap_less(s, i, (i - 1) / 2)) {
+        heap_swap(s, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
 
-    pl_assert(p->total_size == 0);
-    pl_mutex_destroy(&p->lock);
-    pl_free((void *) cache);
-    *pcache = NULL;
+    for (;;) {
+        int min = i, l = 2 * i + 1, r = 2 * i + 2;
+        if (l < s->heap.num && heap_less(s, l, min))
+            min = l;
+        if (r < s->heap.num && heap_less(s, r, min))
+            min = r;
+        if (min == i)
+            return;
+        heap_swap(s, i, min);
+        i = min;
+    }
 }
 
-void pl_cache_reset(pl_cache cache)
+// GreedyDual-Size: prefer evicting objects that are cheap to regenerate
+// relative to the space they occupy, aging out objects via `inflation`
+static void heap_insert(pl_cache cache, struct shard *s, int n)
 {
-    if (!cache)
-        return;
+    struct cache_node *node = &s->nodes.elem[n];
+    double cost = node->obj.cost > 0 ? node->obj.cost
+                                     : node->obj.size * DEFAULT_COST_PER_BYTE;
+    node->prio = s->inflation + cost / node->obj.size;
+    node->heap_idx = s->heap.num;
+    PL_ARRAY_APPEND((void *) cache, s->heap, n);
+    heap_sift(s, node->heap_idx);
+}
 
-    struct priv *p = PL_PRIV(cache);
-    pl_mutex_lock(&p->lock);
-    for (int i = 0; i < p->objects.num; i++)
-        remove_obj(cache, p->objects.elem[i]);
-    p->objects.num = 0;
-    pl_assert(p->total_size == 0);
-    pl_mutex_unlock(&p->lock);
+static void heap_remove(struct shard *s, int n)
+{
+    const int i = s->nodes.elem[n].heap_idx;
+    const int last = s->heap.num - 1;
+    if (i != last)
+        heap_swap(s, i, last);
+    s->heap.num--;
+    if (i != last)
+        heap_sift(s, i);
 }
 
-static bool try_set(pl_cache cache, pl_cache_obj obj)
+// Returns the node to evict next
+static int evict_node(pl_cache cache, struct shard *s)
 {
-    struct priv *p = PL_PRIV(cache);
+    if (!cache->params.cost_aware)
+        return s->head;
 
-    // Remove any existing entry with this key
-    for (int i = p->objects.num - 1; i >= 0; i--) {
-        pl_cache_obj prev = p->objects.elem[i];
-        if (prev.key == obj.key) {
-            PL_TRACE(p, "Removing out-of-date object 0x%"PRIx64, prev.key);
-            remove_obj(cache, prev);
-            PL_ARRAY_REMOVE_AT(p->objects, i);
-            break;
-        }
-    }
+    const int n = s->heap.elem[0];
+    s->inflation = s->nodes.elem[n].prio;
+    return n;
+}
 
-    if (!obj.size) {
-        PL_TRACE(p, "Deleted object 0x%"PRIx64, obj.key);
-        return true;
-    }
+// Removes a node from the index and LRU list, returning the object it held.
+// Ownership of the object passes to the caller.
+static pl_cache_obj take_node(pl_cache cache, struct shard *s, int n)
+{
+    pl_cache_obj obj = s->nodes.elem[n].obj;
+    table_remove(s, find_slot(s, obj.key));
+    list_unlink(s, n);
+    if (cache->params.cost_aware)
+        heap_remove(s, n);
+    s->nodes.elem[n].obj = (pl_cache_obj) {0};
+    PL_ARRAY_APPEND((void *) cache, s->free_nodes, n);
+    s->num_objects--;
+    s->total_size -= obj.size;
+    return obj;
+}
 
-    if (obj.size > cache->params.max_object_size) {
-        PL_DEBUG(p, "Object 0x%"PRIx64" (size %zu) exceeds max size %zu, discarding",
-                 obj.key, obj.size, cache->params.max_object_size);
-        return false;
-    }
+static void lock_shard(struct shard *s)
+{
+    if (pl_mutex_trylock(&s->lock) == 0)
+        return;
 
-    // Make space by deleting old objects
-    while (p->total_size + obj.size > cache->params.max_total_size ||
-           p->objects.num == INT_MAX)
-    {
-        pl_assert(p->objects.num);
-        pl_cache_obj old = p->objects.elem[0];
-        PL_TRACE(p, "Removing object 0x%"PRIx64" (size %zu) to make room",
-                 old.key, old.size);
-        remove_obj(cache, old);
-        PL_ARRAY_REMOVE_AT(p->objects, 0);
-    }
+    pl_clock_t start = pl_clock_now();
+    pl_mutex_lock(&s->lock);
+    s->stats.lock_wait += pl_clock_diff(pl_clock_now(), start);
+}
 
-    if (!obj.free) {
-        obj.data = pl_memdup(NULL, obj.data, obj.size);
-        obj.free = pl_free;
-    }
+static void lock_all(struct priv *p)
+{
+    for (int i = 0; i < p->num_shards; i++)
+        pl_mutex_lock(&p->shards[i].lock);
+}
 
-    PL_TRACE(p, "Inserting new object 0x%"PRIx64" (size %zu)", obj.key, obj.size);
-    PL_ARRAY_APPEND((void *) cache, p->objects, obj);
-    p->total_size += obj.size;
-    return true;
+static void unlock_all(struct priv *p)
+{
+    for (int i = p->num_shards - 1; i >= 0; i--)
+        pl_mutex_unlock(&p->shards[i].lock);
 }
 
-static pl_cache_obj strip_obj(pl_cache_obj obj)
+// --- Payload compression
+
+enum cache_codec {
+    CODEC_NONE  = 0,
+    CODEC_LZ    = 1, // byte-oriented LZ77
+    CODEC_DELTA = 2, // byte-plane delta filter on 32-bit words, then LZ
+    CODEC_COUNT,
+};
+
+#define LZ_MIN_MATCH  4
+#define LZ_HASH_BITS  14
+#define LZ_MAX_OFFSET UINT16_MAX
+
+// Upper bound on the size of the compressed output
+static inline size_t lz_bound(size_t size)
 {
-    return (pl_cache_obj) { .key = obj.key };
+    return size + size / 255 + 16;
 }
 
-bool pl_cache_try_set(pl_cache cache, pl_cache_obj *pobj)
+static inline uint8_t *lz_put_len(uint8_t *out, size_t len)
 {
-    if (!cache)
-        return false;
+    for (; len >= UINT8_MAX; len -= UINT8_MAX)
+        *out++ = UINT8_MAX;
+    *out++ = len;
+    return out;
+}
 
-    pl_cache_obj obj = *pobj;
-    struct priv *p = PL_PRIV(cache);
-    pl_mutex_lock(&p->lock);
-    bool ok = try_set(cache, obj);
-    pl_mutex_unlock(&p->lock);
-    if (ok) {
-        *pobj = strip_obj(obj); // ownership transfers, clear ptr
-    } else {
-        obj = strip_obj(obj); // ownership remains with caller, clear copy
+static inline bool lz_get_len(const uint8_t **in, const uint8_t *end, size_t *len)
+{
+    for (;;) {
+        if (*in >= end)
+            return false;
+        uint8_t b = *(*in)++;
+        *len += b;
+        if (b != UINT8_MAX)
+            return true;
     }
-    if (cache->params.set)
-        cache->params.set(cache->params.priv, obj);
-    return ok;
 }
 
-void pl_cache_set(pl_cache cache, pl_cache_obj *obj)
+// Simple greedy LZ77 encoder producing a sequence of (literals, match)
+// pairs, each prefixed by a token byte containing both lengths. The final
+// sequence contains only literals. Returns the number of bytes written to
+// `dst`, which must have room for at least `lz_bound(size)` bytes.
+static size_t lz_compress(const uint8_t *src, size_t size, uint8_t *dst)
 {
-    if (!pl_cache_try_set(cache, obj)) {
-        if (obj->free)
-            obj->free(obj->data);
-        *obj = (pl_cache_obj) { .key = obj->key };
+    uint32_t *table = pl_calloc(NULL, 1 << LZ_HASH_BITS, sizeof(uint32_t));
+    const uint8_t *ip = src, *anchor = src, *const end = src + size;
+    uint8_t *op = dst;
+
+    while (end - ip >= LZ_MIN_MATCH) {
+        uint32_t seq;
+        memcpy(&seq, ip, sizeof(seq));
+        const uint32_t h = (seq * UINT32_C(2654435761)) >> (32 - LZ_HASH_BITS);
+        const uint8_t *ref = src + table[h];
+        table[h] = ip - src;
+        if (ref >= ip || ip - ref > LZ_MAX_OFFSET || memcmp(ref, ip, LZ_MIN_MATCH)) {
+            ip++;
+            continue;
+        }
+
+        size_t match = LZ_MIN_MATCH;
+        while (ip + match < end && ref[match] == ip[match])
+            match++;
+
+        const size_t lit = ip - anchor, ml = match - LZ_MIN_MATCH;
+        *op++ = PL_MIN(lit, 15) << 4 | PL_MIN(ml, 15);
+        if (lit >= 15)
+            op = lz_put_len(op, lit - 15);
+        memcpy(op, anchor, lit);
+        op += lit;
+        const size_t offset = ip - ref;
+        *op++ = offset & 0xFF;
+        *op++ = offset >> 8;
+        if (ml >= 15)
+            op = lz_put_len(op, ml - 15);
+        ip += match;
+        anchor = ip;
     }
+
+    const size_t lit = end - anchor;
+    *op++ = PL_MIN(lit, 15) << 4;
+    if (lit >= 15)
+        op = lz_put_len(op, lit - 15);
+    memcpy(op, anchor, lit);
+    op += lit;
+
+    pl_free(table);
+    return op - dst;
 }
 
-static void noop(void *ignored)
+static bool lz_decompress(const uint8_t *src, size_t size, uint8_t *dst, size_t dst_size)
 {
-    (void) ignored;
+    const uint8_t *ip = src, *const end = src + size;
+    uint8_t *op = dst, *const oend = dst + dst_size;
+
+    while (ip < end) {
+        const uint8_t token = *ip++;
+        size_t lit = token >> 4;
+        if (lit == 15 && !lz_get_len(&ip, end, &lit))
+            return false;
+        if (lit > end - ip || lit > oend - op)
+            return false;
+        memcpy(op, ip, lit);
+        op += lit;
+        ip += lit;
+        if (ip == end)
+            break; // final sequence
+
+        if (end - ip < 2)
+            return false;
+        const size_t offset = ip[0] | (size_t) ip[1] << 8;
+        ip += 2;
+        size_t match = token & 15;
+        if (match == 15 && !lz_get_len(&ip, end, &match))
+            return false;
+        match += LZ_MIN_MATCH;
+        if (!offset || offset > op - dst || match > oend - op)
+            return false;
+
+        // Matches may overlap the output, so copy byte-by-byte
+        const uint8_t *ref = op - offset;
+        for (size_t i = 0; i < match; i++)
+            op[i] = ref[i];
+        op += match;
+    }
+
+    return op == oend;
 }
 
-bool pl_cache_get(pl_cache cache, pl_cache_obj *out_obj)
+// Splits 32-bit words into byte planes and delta-codes each plane. This
+// turns smoothly varying float/integer LUTs into long runs of small values.
+static void delta_encode(const uint8_t *src, size_t size, uint8_t *dst)
 {
-    const uint64_t key = out_obj->key;
-    if (!cache)
-        goto fail;
+    const size_t num = size / 4;
+    for (int b = 0; b < 4; b++) {
+        uint8_t prev = 0;
+        for (size_t i = 0; i < num; i++) {
+            const uint8_t v = src[4 * i + b];
+            dst[b * num + i] = v - prev;
+            prev = v;
+        }
+    }
+}
 
-    struct priv *p = PL_PRIV(cache);
-    pl_mutex_lock(&p->lock);
-
-    // Search backwards to prioritize recently added entries
-    for (int i = p->objects.num - 1; i >= 0; i--) {
-        pl_cache_obj obj = p->objects.elem[i];
-        if (obj.key == key) {
-            PL_ARRAY_REMOVE_AT(p->objects, i);
-            p->total_size -= obj.size;
-            pl_mutex_unlock(&p->lock);
-            pl_assert(obj.free);
-            *out_obj = obj;
-            return true;
+static void delta_decode(const uint8_t *src, size_t size, uint8_t *dst)
+{
+    const size_t num = size / 4;
+    for (int b = 0; b < 4; b++) {
+        uint8_t prev = 0;
+        for (size_t i = 0; i < num; i++) {
+            prev += src[b * num + i];
+            dst[4 * i + b] = prev;
         }
     }
+}
 
-    pl_mutex_unlock(&p->lock);
-    if (!cache->params.get)
-        goto fail;
+// Compresses `obj` using the most efficient codec. Returns CODEC_NONE if
+// compression is not worthwhile, otherwise `*out` is set to a newly
+// allocated buffer (owned by `alloc`) containing `*out_size` bytes.
+static enum cache_codec encode_payload(void *alloc, pl_cache_obj obj,
+                                       uint8_t **out, size_t *out_size)
+{
+    enum cache_codec codec = CODEC_NONE;
+    size_t best = obj.size - obj.size / 8; // require at least 12.5% savings
+    uint8_t *buf = pl_alloc(alloc, lz_bound(obj.size));
+    size_t size = lz_compress(obj.data, obj.size, buf);
+    if (size < best) {
+        codec = CODEC_LZ;
+        best = size;
+        *out = buf;
+        buf = NULL;
+    }
 
-    pl_cache_obj obj = cache->params.get(cache->params.priv, key);
-    if (!obj.size)
-        goto fail;
+    if (obj.size % 4 == 0) {
+        uint8_t *tmp = pl_alloc(NULL, obj.size);
+        delta_encode(obj.data, obj.size, tmp);
+        if (!buf)
+            buf = pl_alloc(alloc, lz_bound(obj.size));
+        size = lz_compress(tmp, obj.size, buf);
+        pl_free(tmp);
+        if (size < best) {
+            if (codec != CODEC_NONE)
+                pl_free(*out);
+            codec = CODEC_DELTA;
+            best = size;
+            *out = buf;
+            buf = NULL;
+        }
+    }
 
-    // Sanitize object
-    obj.key = key;
-    obj.free = PL_DEF(obj.free, noop);
-    *out_obj = obj;
-    return true;
+    pl_free(buf);
+    if (codec != CODEC_NONE)
+        *out_size = best;
+    return codec;
+}
 
-fail:
-    *out_obj = (pl_cache_obj) { .key = key };
-    return false;
+// Decompresses a stored payload into a newly allocated buffer, or returns
+// NULL on failure
+static void *decode_payload(enum cache_codec codec, const uint8_t *data,
+                            size_t size, size_t raw_size)
+{
+    uint8_t *buf = pl_alloc(NULL, PL_MAX(raw_size, 1));
+    switch (codec) {
+    case CODEC_NONE:
+        if (size != raw_size)
+            goto error;
+        memcpy(buf, data, size);
+        return buf;
+    case CODEC_LZ:
+        if (!lz_decompress(data, size, buf, raw_size))
+            goto error;
+        return buf;
+    case CODEC_DELTA: {
+        if (raw_size % 4)
+            goto error;
+        uint8_t *tmp = pl_alloc(NULL, PL_MAX(raw_size, 1));
+        bool ok = lz_decompress(data, size, tmp, raw_size);
+        if (ok)
+            delta_decode(tmp, raw_size, buf);
+        pl_free(tmp);
+        if (!ok)
+            goto error;
+        return buf;
+    }
+    case CODEC_COUNT:
+        break;
+    }
+
+error:
+    pl_free(buf);
+    return NULL;
 }
 
-void pl_cache_iterate(pl_cache cache,
-                      void (*cb)(void *priv, pl_cache_obj obj),
-                      void *priv)
+static int cmp_key(const void *pa, const void *pb)
 {
-    if (!cache)
-        return;
+    const struct lazy_entry *a = pa, *b = pb;
+    return PL_CMP(a->key, b->key);
+}
 
-    struct priv *p = PL_PRIV(cache);
-    pl_mutex_lock(&p->lock);
-    for (int i = 0; i < p->objects.num; i++)
-        cb(priv, p->objects.elem[i]);
-    pl_mutex_unlock(&p->lock);
+static int cmp_lazy(const void *pa, const void *pb)
+{
+    const struct lazy_entry *a = pa, *b = pb;
+    return PL_CMP(a->key, b->key) ? PL_CMP(a->key, b->key) : PL_CMP(a->seq, b->seq);
 }
 
-// --- Saving/loading
+// Must be called with `map_lock` held
+static struct lazy_entry *find_lazy(struct priv *p, uint64_t key)
+{
+    if (!atomic_load(&p->num_lazy))
+        return NULL;
 
-#define CACHE_MAGIC   "pl_cache"
-#define CACHE_VERSION 1
-#define PAD_ALIGN(x)  PL_ALIGN2(x, sizeof(uint32_t))
+    struct lazy_entry *e = bsearch(&(struct lazy_entry) { .key = key },
+                                   p->lazy.elem, p->lazy.num,
+                                   sizeof(p->lazy.elem[0]), cmp_key);
+    return e && e->data ? e : NULL;
+}
 
-struct __attribute__((__packed__)) cache_header {
-    char     magic[8];
-    uint32_t version;
-    uint32_t num_entries;
-};
+// Detaches the lazy entry for `key`, if any, returning whether one existed
+static bool take_lazy(struct priv *p, uint64_t key, struct lazy_entry *out)
+{
+    if (!atomic_load(&p->num_lazy))
+        return false;
 
-struct __attribute__((__packed__)) cache_entry {
-    uint64_t key;
-    uint64_t size;
-    uint64_t hash;
-};
+    pl_mutex_lock(&p->map_lock);
+    struct lazy_entry *e = find_lazy(p, key);
+    if (e) {
+        *out = *e;
+        e->data = NULL;
+        atomic_fetch_sub(&p->num_lazy, 1);
+    }
+    pl_mutex_unlock(&p->map_lock);
+    return e;
+}
 
-pl_static_assert(sizeof(struct cache_header) % alignof(struct cache_entry) == 0);
+static void drop_lazy(struct priv *p, uint64_t key)
+{
+    struct lazy_entry e;
+    take_lazy(p, key, &e);
+}
 
-int pl_cache_save_ex(pl_cache cache,
-                     void (*write)(void *priv, size_t size, const void *ptr),
-                     void *priv)
+int pl_cache_objects(pl_cache cache)
 {
     if (!cache)
         return 0;
 
     struct priv *p = PL_PRIV(cache);
-    pl_mutex_lock(&p->lock);
-    pl_clock_t start = pl_clock_now();
-
-    const int num_objects = p->objects.num;
-    const size_t saved_bytes = p->total_size;
-    write(priv, sizeof(struct cache_header), &(struct cache_header) {
-        .magic       = CACHE_MAGIC,
-        .version     = CACHE_VERSION,
-        .num_entries = num_objects,
-    });
-
-    for (int i = 0; i < num_objects; i++) {
-        pl_cache_obj obj = p->objects.elem[i];
-        PL_TRACE(p, "Saving object 0x%"PRIx64" (size %zu)", obj.key, obj.size);
-        write(priv, sizeof(struct cache_entry), &(struct cache_entry) {
-            .key  = obj.key,
-            .size = obj.size,
-            .hash = pl_mem_hash(obj.data, obj.size),
-        });
-        static const uint8_t padding[PAD_ALIGN(1)] = {0};
-        write(priv, obj.size, obj.data);
-        write(priv, PAD_ALIGN(obj.size) - obj.size, padding);
+    int num = 0;
+    for (int i = 0; i < p->num_shards; i++) {
+        pl_mutex_lock(&p->shards[i].lock);
+        num += p->shards[i].num_objects;
+        pl_mutex_unlock(&p->shards[i].lock);
     }
-
-    pl_mutex_unlock(&p->lock);
-    pl_log_cpu_time(p->log, start, pl_clock_now(), "saving cache");
-    if (num_objects)
-        PL_DEBUG(p, "Saved %d objects, totalling %zu bytes", num_objects, saved_bytes);
-
-    return num_objects;
+    return num;
 }
 
-int pl_cache_load_ex(pl_cache cache,
-                     bool (*read)(void *priv, size_t size, void *ptr),
-                     void *priv)
+size_t pl_cache_size(pl_cache cache)
 {
     if (!cache)
         return 0;
 
     struct priv *p = PL_PRIV(cache);
-    struct cache_header header;
-    if (!read(priv, sizeof(header), &header)) {
-        PL_ERR(p, "Failed loading cache: file seems empty or truncated");
-        return -1;
+    size_t size = 0;
+    for (int i = 0; i < p->num_shards; i++) {
+        pl_mutex_lock(&p->shards[i].lock);
+        size += p->shards[i].total_size;
+        pl_mutex_unlock(&p->shards[i].lock);
     }
-    if (memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0) {
-        PL_ERR(p, "Failed loading cache: invalid magic bytes");
-        return -1;
-    }
-    if (header.version != CACHE_VERSION) {
-        PL_INFO(p, "Failed loading cache: wrong version... skipping");
+    return size;
+}
+
+static int cmp_event(const void *pa, const void *pb)
+{
+    const struct set_event *a = pa, *b = pb;
+    return PL_CMP(a->obj.key, b->obj.key) ? PL_CMP(a->obj.key, b->obj.key)
+                                          : PL_CMP(a->seq, b->seq);
+}
+
+// Dispatches a batch of events, coalescing multiple updates to the same key
+static void dispatch_events(pl_cache cache, struct set_event *events, int num)
+{
+    qsort(events, num, sizeof(events[0]), cmp_event);
+    for (int i = 0; i < num; i++) {
+        pl_cache_obj obj = events[i].obj;
+        if (i + 1 == num || events[i + 1].obj.key != obj.key)
+            cache->params.set(cache->params.priv, obj);
+        pl_free(obj.data);
+    }
+}
+
+static PL_THREAD_VOID async_worker(void *arg)
+{
+    pl_cache cache = arg;
+    struct priv *p = PL_PRIV(cache);
+    struct async_state *as = p->async;
+    const double interval = PL_DEF(cache->params.async_interval, 1.0f);
+    struct set_event *batch = NULL;
+    int num_batch = 0;
+
+    pl_mutex_lock(&as->lock);
+    for (;;) {
+        while (!as->events.num && !as->quit)
+            pl_cond_wait(&as->wakeup, &as->lock);
+
+        // Wait for more events to accumulate, unless explicitly flushing
+        const pl_clock_t start = pl_clock_now();
+        while (!as->quit && as->flush_seq <= as->done_seq) {
+            double left = interval - pl_clock_diff(pl_clock_now(), start);
+            if (left <= 0)
+                break;
+            pl_cond_timedwait(&as->wakeup, &as->lock, left * 1e9);
+        }
+
+        // Swap out the event list, recycling the old allocation
+        PL_SWAP(batch, as->events.elem);
+        PL_SWAP(num_batch, as->events.num);
+        as->events.num = 0;
+        const int seq = as->seq;
+        pl_mutex_unlock(&as->lock);
+        dispatch_events(cache, batch, num_batch);
+        pl_mutex_lock(&as->lock);
+
+        as->done_seq = seq;
+        pl_cond_broadcast(&as->flushed);
+        if (as->quit && !as->events.num)
+            break;
+    }
+    pl_mutex_unlock(&as->lock);
+
+    pl_free(batch);
+    PL_THREAD_RETURN();
+}
+
+static void async_init(pl_cache cache)
+{
+    struct priv *p = PL_PRIV(cache);
+    struct async_state *as = pl_zalloc_ptr((void *) cache, as);
+    pl_mutex_init(&as->lock);
+    pl_cond_init(&as->wakeup);
+    pl_cond_init(&as->flushed);
+    if (pl_thread_create(&as->thread, async_worker, (void *) cache) != 0) {
+        PL_WARN(p, "Failed creating cache writer thread, using synchronous "
+                "`set` callback instead");
+        pl_cond_destroy(&as->flushed);
+        pl_cond_destroy(&as->wakeup);
+        pl_mutex_destroy(&as->lock);
+        pl_free(as);
+        return;
+    }
+
+    p->async = as;
+}
+
+static void async_uninit(pl_cache cache)
+{
+    struct priv *p = PL_PRIV(cache);
+    struct async_state *as = p->async;
+    if (!as)
+        return;
+
+    pl_mutex_lock(&as->lock);
+    as->quit = true;
+    pl_cond_broadcast(&as->wakeup);
+    pl_mutex_unlock(&as->lock);
+    pl_thread_join(as->thread);
+
+    pl_assert(!as->events.num);
+    pl_cond_destroy(&as->flushed);
+    pl_cond_destroy(&as->wakeup);
+    pl_mutex_destroy(&as->lock);
+    pl_free(as->events.elem);
+}
+
+// Queues a `set` event. Takes over ownership of `obj.data`, which must be
+// allocated with pl_alloc
+static void async_push(pl_cache cache, pl_cache_obj obj)
+{
+    struct priv *p = PL_PRIV(cache);
+    struct async_state *as = p->async;
+    pl_mutex_lock(&as->lock);
+    PL_ARRAY_APPEND(NULL, as->events, (struct set_event) {
+        .obj = obj,
+        .seq = ++as->seq,
+    });
+    if (as->events.num == 1)
+        pl_cond_signal(&as->wakeup);
+    pl_mutex_unlock(&as->lock);
+}
+
+void pl_cache_flush(pl_cache cache)
+{
+    if (!cache)
+        return;
+
+    struct priv *p = PL_PRIV(cache);
+    struct async_state *as = p->async;
+    if (!as)
+        return;
+
+    pl_mutex_lock(&as->lock);
+    const int seq = as->seq;
+    as->flush_seq = PL_MAX(as->flush_seq, seq);
+    pl_cond_broadcast(&as->wakeup);
+    while (as->done_seq < seq)
+        pl_cond_wait(&as->flushed, &as->lock);
+    pl_mutex_unlock(&as->lock);
+}
+
+static void add_stats(struct pl_cache_stats *sum, const struct pl_cache_stats *s)
+{
+    sum->hits           += s->hits;
+    sum->misses         += s->misses;
+    sum->external_hits  += s->external_hits;
+    sum->insertions     += s->insertions;
+    sum->evictions      += s->evictions;
+    sum->bytes_evicted  += s->bytes_evicted;
+    sum->lock_wait      += s->lock_wait;
+}
+
+void pl_cache_get_stats(pl_cache cache, struct pl_cache_stats *out)
+{
+    *out = (struct pl_cache_stats) {0};
+    if (!cache)
+        return;
+
+    struct priv *p = PL_PRIV(cache);
+    for (int i = 0; i < p->num_shards; i++) {
+        pl_mutex_lock(&p->shards[i].lock);
+        add_stats(out, &p->shards[i].stats);
+        pl_mutex_unlock(&p->shards[i].lock);
+    }
+}
+
+void pl_cache_reset_stats(pl_cache cache)
+{
+    if (!cache)
+        return;
+
+    struct priv *p = PL_PRIV(cache);
+    for (int i = 0; i < p->num_shards; i++) {
+        pl_mutex_lock(&p->shards[i].lock);
+        p->shards[i].stats = (struct pl_cache_stats) {0};
+        pl_mutex_unlock(&p->shards[i].lock);
+    }
+}
+
+pl_cache pl_cache_create(const struct pl_cache_params *params)
+{
+    struct pl_cache_t *cache = pl_zalloc_obj(NULL, cache, struct priv);
+    struct priv *p = PL_PRIV(cache);
+    if (params) {
+        cache->params = *params;
+        p->log = params->log;
+    }
+
+    // Sanitize size limits
+    p->num_shards = PL_CLAMP(cache->params.shards, 1, MAX_SHARDS);
+    size_t total_size  = PL_DEF(cache->params.max_total_size,  SIZE_MAX);
+    size_t shard_size  = total_size == SIZE_MAX ? SIZE_MAX : total_size / p->num_shards;
+    size_t object_size = PL_DEF(cache->params.max_object_size, SIZE_MAX);
+    object_size = PL_MIN(shard_size, object_size);
+    cache->params.max_total_size  = total_size;
+    cache->params.max_object_size = object_size;
+    cache->params.shards          = p->num_shards;
+    pl_mutex_init(&p->map_lock);
+
+    for (int i = 0; i < p->num_shards; i++) {
+        struct shard *s = &p->shards[i];
+        pl_mutex_init(&s->lock);
+        s->head = s->tail = NODE_NONE;
+        s->max_size = shard_size;
+    }
+
+    if (cache->params.set && cache->params.async_set)
+        async_init(cache);
+
+    return cache;
+}
+
+static void noop(void *ignored)
+{
+    (void) ignored;
+}
+
+static void unmap_file(struct cache_mapping *map)
+{
+#if defined(PL_HAVE_MMAP)
+    munmap((void *) map->data, map->size);
+#elif defined(PL_HAVE_WIN32)
+    UnmapViewOfFile(map->data);
+    CloseHandle(map->mapping);
+    CloseHandle(map->file);
+#endif
+}
+
+// See the journaling section below
+static bool journal_prepare(pl_cache cache, pl_cache_obj obj, struct journal_op *op);
+static void journal_write(pl_cache cache, pl_cache_obj obj, const struct journal_op *op);
+static void journal_drop(pl_cache cache, uint64_t key);
+static void journal_clear(pl_cache cache);
+
+static void remove_obj(pl_cache cache, pl_cache_obj obj)
+{
+    if (obj.free)
+        obj.free(obj.data);
+}
+
+static void remove_all(pl_cache cache, struct shard *s)
+{
+    while (s->head != NODE_NONE)
+        remove_obj(cache, take_node(cache, s, s->head));
+
+    pl_assert(s->total_size == 0);
+    s->nodes.num = 0;
+    s->free_nodes.num = 0;
+    s->inflation = 0.0;
+}
+
+void pl_cache_destroy(pl_cache *pcache)
+{
+    pl_cache cache = *pcache;
+    if (!cache)
+         return;
+
+    struct priv *p = PL_PRIV(cache);
+    async_uninit(cache);
+    pl_cache_journal_close(cache);
+    for (int i = 0; i < p->num_shards; i++) {
+        remove_all(cache, &p->shards[i]);
+        pl_mutex_destroy(&p->shards[i].lock);
+    }
+    for (int i = 0; i < p->mappings.num; i++)
+        unmap_file(&p->mappings.elem[i]);
+    pl_mutex_destroy(&p->map_lock);
+    pl_free((void *) cache);
+    *pcache = NULL;
+}
+
+void pl_cache_reset(pl_cache cache)
+{
+    if (!cache)
+        return;
+
+    struct priv *p = PL_PRIV(cache);
+    for (int i = 0; i < p->num_shards; i++) {
+        pl_mutex_lock(&p->shards[i].lock);
+        remove_all(cache, &p->shards[i]);
+        pl_mutex_unlock(&p->shards[i].lock);
+    }
+    journal_clear(cache);
+
+    pl_mutex_lock(&p->map_lock);
+    p->lazy.num = 0;
+    atomic_store(&p->num_lazy, 0);
+    pl_mutex_unlock(&p->map_lock);
+}
+
+// Must be called with `s->lock` held. If `op` is NULL, the object itself is
+// not recorded in the journal (e.g. because it is being loaded from a file).
+static bool try_set(pl_cache cache, struct shard *s, pl_cache_obj obj,
+                    const struct journal_op *op)
+{
+    struct priv *p = PL_PRIV(cache);
+
+    // Remove any existing entry with this key
+    int n = find_node(s, obj.key);
+    if (n != NODE_NONE) {
+        PL_TRACE(p, "Removing out-of-date object 0x%"PRIx64, obj.key);
+        remove_obj(cache, take_node(cache, s, n));
+    }
+    drop_lazy(p, obj.key);
+    if (!op || !obj.size)
+        journal_drop(cache, obj.key);
+
+    if (!obj.size) {
+        PL_TRACE(p, "Deleted object 0x%"PRIx64, obj.key);
+        pl_trace_ev(p->log, PL_EV_CACHE_DELETE, 0, obj.key, 0);
+        return true;
+    }
+
+    if (obj.size > cache->params.max_object_size) {
+        PL_DEBUG(p, "Object 0x%"PRIx64" (size %zu) exceeds max size %zu, discarding",
+                 obj.key, obj.size, cache->params.max_object_size);
+        if (op)
+            journal_drop(cache, obj.key);
+        return false;
+    }
+
+    // Make space by deleting old objects
+    while (s->total_size + obj.size > s->max_size ||
+           s->num_objects == INT_MAX)
+    {
+        pl_assert(s->head != NODE_NONE);
+        pl_cache_obj old = take_node(cache, s, evict_node(cache, s));
+        PL_TRACE(p, "Removing object 0x%"PRIx64" (size %zu) to make room",
+                 old.key, old.size);
+        pl_trace_ev(p->log, PL_EV_CACHE_EVICT, 0, old.key, old.size);
+        s->stats.evictions++;
+        s->stats.bytes_evicted += old.size;
+        journal_drop(cache, old.key);
+        remove_obj(cache, old);
+    }
+
+    if (!obj.free) {
+        obj.data = pl_memdup(NULL, obj.data, obj.size);
+        obj.free = pl_free;
+    }
+
+    // Keep the load factor of the index at or below 1/2
+    if ((size_t) (s->num_objects + 1) * 2 > s->table_size)
+        table_resize(cache, s, PL_MAX(s->table_size * 2, 16));
+
+    if (!PL_ARRAY_POP(s->free_nodes, &n)) {
+        n = s->nodes.num;
+        PL_ARRAY_APPEND((void *) cache, s->nodes, (struct cache_node) {0});
+    }
+
+    PL_TRACE(p, "Inserting new object 0x%"PRIx64" (size %zu)", obj.key, obj.size);
+    pl_trace_ev(p->log, PL_EV_CACHE_INSERT, 0, obj.key, obj.size);
+    s->nodes.elem[n].obj = obj;
+    s->table[find_slot(s, obj.key)] = n + 1;
+    list_append(s, n);
+    if (cache->params.cost_aware)
+        heap_insert(cache, s, n);
+    s->num_objects++;
+    s->total_size += obj.size;
+    s->stats.insertions++;
+    if (op)
+        journal_write(cache, obj, op);
+    return true;
+}
+
+static pl_cache_obj strip_obj(pl_cache_obj obj)
+{
+    return (pl_cache_obj) { .key = obj.key };
+}
+
+bool pl_cache_try_set(pl_cache cache, pl_cache_obj *pobj)
+{
+    if (!cache)
+        return false;
+
+    pl_cache_obj obj = *pobj;
+    struct priv *p = PL_PRIV(cache);
+    struct shard *s = get_shard(p, obj.key);
+
+    // Copy the object beforehand, since it may be evicted at any time
+    pl_cache_obj copy = strip_obj(obj);
+    if (p->async && obj.size) {
+        copy.data = pl_memdup(NULL, obj.data, obj.size);
+        copy.size = obj.size;
+        copy.cost = obj.cost;
+    }
+
+    // Serialize the journal record outside the lock, since it may be slow
+    struct journal_op op;
+    const bool journal = journal_prepare(cache, obj, &op);
+
+    lock_shard(s);
+    bool ok = try_set(cache, s, obj, journal ? &op : NULL);
+    pl_mutex_unlock(&s->lock);
+    if (journal)
+        pl_free(op.rec.buf);
+    if (ok) {
+        *pobj = strip_obj(obj); // ownership transfers, clear ptr
+    } else {
+        obj = strip_obj(obj); // ownership remains with caller, clear copy
+        pl_free(copy.data);
+        copy = obj;
+    }
+
+    if (p->async) {
+        async_push(cache, copy);
+    } else if (cache->params.set) {
+        cache->params.set(cache->params.priv, obj);
+    }
+    return ok;
+}
+
+void pl_cache_set(pl_cache cache, pl_cache_obj *obj)
+{
+    if (!pl_cache_try_set(cache, obj)) {
+        if (obj->free)
+            obj->free(obj->data);
+        *obj = (pl_cache_obj) { .key = obj->key };
+    }
+}
+
+bool pl_cache_get(pl_cache cache, pl_cache_obj *out_obj)
+{
+    const uint64_t key = out_obj->key;
+    if (!cache)
+        goto fail;
+
+    struct shard *s = get_shard(PL_PRIV(cache), key);
+    lock_shard(s);
+
+    int n = find_node(s, key);
+    if (n != NODE_NONE) {
+        pl_cache_obj obj = take_node(cache, s, n);
+        s->stats.hits++;
+        pl_mutex_unlock(&s->lock);
+        pl_assert(obj.free);
+        *out_obj = obj;
+        return true;
+    }
+
+    // Fetch lazily loaded objects on first use. (The entry is detached while
+    // still holding the shard lock, so the hit or miss can be counted in the
+    // shard's stats; `map_lock` is only taken if lazy entries exist at all)
+    struct priv *p = PL_PRIV(cache);
+    struct lazy_entry e;
+    const bool lazy = take_lazy(p, key, &e);
+    if (lazy) {
+        s->stats.hits++;
+    } else {
+        s->stats.misses++;
+    }
+    pl_mutex_unlock(&s->lock);
+
+    if (lazy) {
+        pl_cache_obj obj = { .key = key, .data = (void *) e.data,
+                             .size = e.raw_size, .free = noop, .cost = e.cost };
+        bool ok = pl_mem_hash(e.data, e.size) == e.hash;
+        if (ok && e.codec != CODEC_NONE) {
+            obj.data = decode_payload(e.codec, e.data, e.size, e.raw_size);
+            obj.free = pl_free;
+            ok = obj.data;
+        }
+        if (ok) {
+            PL_TRACE(p, "Fetched lazy object 0x%"PRIx64" (size %zu)", key, obj.size);
+            *out_obj = obj;
+            return true;
+        }
+        PL_WARN(p, "Cache entry 0x%"PRIx64" seems corrupt, checksum mismatch.. "
+                "ignoring", key);
+        pl_mutex_lock(&s->lock);
+        s->stats.hits--;
+        s->stats.misses++;
+        pl_mutex_unlock(&s->lock);
+    }
+
+    if (!cache->params.get)
+        goto fail;
+
+    pl_cache_obj obj = cache->params.get(cache->params.priv, key);
+    if (!obj.size)
+        goto fail;
+
+    pl_mutex_lock(&s->lock);
+    s->stats.external_hits++;
+    pl_mutex_unlock(&s->lock);
+
+    // Sanitize object
+    obj.key = key;
+    obj.free = PL_DEF(obj.free, noop);
+    *out_obj = obj;
+    return true;
+
+fail:
+    *out_obj = (pl_cache_obj) { .key = key };
+    return false;
+}
+
+void pl_cache_iterate(pl_cache cache,
+                      void (*cb)(void *priv, pl_cache_obj obj),
+                      void *priv)
+{
+    if (!cache)
+        return;
+
+    struct priv *p = PL_PRIV(cache);
+    lock_all(p);
+    for (int i = 0; i < p->num_shards; i++) {
+        const struct shard *s = &p->shards[i];
+        for (int n = s->head; n != NODE_NONE; n = s->nodes.elem[n].next)
+            cb(priv, s->nodes.elem[n].obj);
+    }
+    pl_mutex_lock(&p->map_lock);
+    for (int i = 0; i < p->lazy.num; i++) {
+        const struct lazy_entry *e = &p->lazy.elem[i];
+        if (!e->data)
+            continue;
+        pl_cache_obj obj = { .key = e->key, .data = (void *) e->data,
+                             .size = e->raw_size, .free = noop };
+        if (e->codec != CODEC_NONE) {
+            obj.data = decode_payload(e->codec, e->data, e->size, e->raw_size);
+            if (!obj.data)
+                continue;
+        }
+        cb(priv, obj);
+        if (obj.data != e->data)
+            pl_free(obj.data);
+    }
+    pl_mutex_unlock(&p->map_lock);
+    unlock_all(p);
+}
+
+// --- Saving/loading
+
+#define CACHE_MAGIC   "pl_cache"
+#define CACHE_VERSION 2 // highest supported version
+#define PAD_ALIGN(x)  PL_ALIGN2(x, sizeof(uint32_t))
+
+struct __attribute__((__packed__)) cache_header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t num_entries;
+};
+
+struct __attribute__((__packed__)) cache_entry {
+    uint64_t key;
+    uint64_t size; // stored size
+    uint64_t hash; // hash of the stored bytes
+};
+
+// Follows each `cache_entry` in version 2 and above
+struct __attribute__((__packed__)) cache_entry_ext {
+    uint64_t raw_size; // uncompressed size
+    uint32_t codec;    // enum cache_codec
+    float    cost;     // pl_cache_obj.cost
+};
+
+pl_static_assert(sizeof(struct cache_header) % alignof(struct cache_entry) == 0);
+pl_static_assert(sizeof(struct cache_entry_ext) % alignof(struct cache_entry) == 0);
+
+static const uint8_t padding[PAD_ALIGN(1)] = {0};
+
+// Whether a lazy entry is still valid and not shadowed by a resident object.
+// Must be called with all locks held.
+static bool lazy_live(struct priv *p, const struct lazy_entry *e)
+{
+    return e->data && find_node(get_shard(p, e->key), e->key) == NODE_NONE;
+}
+
+static void write_entry(void (*write)(void *priv, size_t size, const void *ptr),
+                        void *priv, int version, const struct cache_entry *entry,
+                        const struct cache_entry_ext *ext, const void *data)
+{
+    write(priv, sizeof(*entry), entry);
+    if (version >= 2)
+        write(priv, sizeof(*ext), ext);
+    write(priv, entry->size, data);
+    write(priv, PAD_ALIGN(entry->size) - entry->size, padding);
+}
+
+int pl_cache_save_ex(pl_cache cache,
+                     void (*write)(void *priv, size_t size, const void *ptr),
+                     void *priv)
+{
+    if (!cache)
+        return 0;
+
+    struct priv *p = PL_PRIV(cache);
+    lock_all(p);
+    pl_mutex_lock(&p->map_lock);
+    pl_clock_t start = pl_clock_now();
+
+    // Version 1 is still used for uncompressed caches without any costs, for
+    // compatibility. Version 2 is needed to store either.
+    int version = cache->params.compress ? 2 : 1;
+    int num_objects = 0;
+    size_t saved_bytes = 0, stored_bytes = 0;
+    for (int i = 0; i < p->num_shards; i++) {
+        const struct shard *s = &p->shards[i];
+        num_objects += s->num_objects;
+        saved_bytes += s->total_size;
+        for (int n = s->head; version < 2 && n != NODE_NONE; n = s->nodes.elem[n].next) {
+            if (s->nodes.elem[n].obj.cost > 0)
+                version = 2;
+        }
+    }
+    for (int i = 0; i < p->lazy.num; i++) {
+        const struct lazy_entry *e = &p->lazy.elem[i];
+        if (lazy_live(p, e)) {
+            num_objects++;
+            if (e->codec != CODEC_NONE || e->cost > 0)
+                version = 2; // lazy objects are written back as-is
+        }
+    }
+
+    write(priv, sizeof(struct cache_header), &(struct cache_header) {
+        .magic       = CACHE_MAGIC,
+        .version     = version,
+        .num_entries = num_objects,
+    });
+
+    for (int i = 0; i < p->num_shards; i++) {
+        const struct shard *s = &p->shards[i];
+        for (int n = s->head; n != NODE_NONE; n = s->nodes.elem[n].next) {
+            pl_cache_obj obj = s->nodes.elem[n].obj;
+            PL_TRACE(p, "Saving object 0x%"PRIx64" (size %zu)", obj.key, obj.size);
+            uint8_t *data = obj.data;
+            size_t size = obj.size;
+            enum cache_codec codec = CODEC_NONE;
+            if (cache->params.compress)
+                codec = encode_payload(NULL, obj, &data, &size);
+            write_entry(write, priv, version, &(struct cache_entry) {
+                .key  = obj.key,
+                .size = size,
+                .hash = pl_mem_hash(data, size),
+            }, &(struct cache_entry_ext) {
+                .raw_size = obj.size,
+                .codec    = codec,
+                .cost     = obj.cost,
+            }, data);
+            stored_bytes += size;
+            if (data != obj.data)
+                pl_free(data);
+        }
+    }
+
+    // Write back lazily loaded objects unmodified
+    for (int i = 0; i < p->lazy.num; i++) {
+        const struct lazy_entry *e = &p->lazy.elem[i];
+        if (!lazy_live(p, e))
+            continue;
+        write_entry(write, priv, version, &(struct cache_entry) {
+            .key  = e->key,
+            .size = e->size,
+            .hash = e->hash,
+        }, &(struct cache_entry_ext) {
+            .raw_size = e->raw_size,
+            .codec    = e->codec,
+            .cost     = e->cost,
+        }, e->data);
+        saved_bytes += e->raw_size;
+        stored_bytes += e->size;
+    }
+
+    pl_mutex_unlock(&p->map_lock);
+    unlock_all(p);
+    pl_log_cpu_time(p->log, start, pl_clock_now(), "saving cache");
+    if (num_objects) {
+        PL_DEBUG(p, "Saved %d objects, totalling %zu bytes (%zu stored)",
+                 num_objects, saved_bytes, stored_bytes);
+    }
+
+    return num_objects;
+}
+
+// Returns 1 if the header is valid, 0 if it should be skipped, or a negative
+// number if it is corrupt
+static int check_header(struct priv *p, const struct cache_header *header)
+{
+    if (memcmp(header->magic, CACHE_MAGIC, sizeof(header->magic)) != 0) {
+        PL_ERR(p, "Failed loading cache: invalid magic bytes");
+        return -1;
+    }
+    if (header->version < 1 || header->version > CACHE_VERSION) {
+        PL_INFO(p, "Failed loading cache: wrong version... skipping");
+        return 0;
+    }
+    if (header->num_entries > INT_MAX) {
+        PL_ERR(p, "Failed loading cache: %"PRIu32" entries overflows int",
+               header->num_entries);
+        return 0;
+    }
+
+    return 1;
+}
+
+static bool check_entry(struct priv *p, const struct cache_entry *entry,
+                        const struct cache_entry_ext *ext)
+{
+    if (entry->size > SIZE_MAX || ext->raw_size > SIZE_MAX) {
+        PL_WARN(p, "Cache object size %"PRIu64" overflows SIZE_MAX.. "
+                "suspect broken file, ignoring rest",
+                PL_MAX(entry->size, ext->raw_size));
+        return false;
+    }
+
+    if (ext->codec >= CODEC_COUNT) {
+        PL_WARN(p, "Cache object uses unknown codec %"PRIu32".. suspect broken "
+                "file, ignoring rest", ext->codec);
+        return false;
+    }
+
+    if (ext->codec == CODEC_NONE && ext->raw_size != entry->size) {
+        PL_WARN(p, "Cache object size mismatch.. suspect broken file, "
+                "ignoring rest");
+        return false;
+    }
+
+    return true;
+}
+
+static bool load_obj(pl_cache cache, pl_cache_obj obj)
+{
+    struct priv *p = PL_PRIV(cache);
+    PL_TRACE(p, "Loading object 0x%"PRIx64" (size %zu)", obj.key, obj.size);
+    struct shard *s = get_shard(p, obj.key);
+    lock_shard(s);
+    bool ok = try_set(cache, s, obj, NULL);
+    pl_mutex_unlock(&s->lock);
+    return ok;
+}
+
+int pl_cache_load_ex(pl_cache cache,
+                     bool (*read)(void *priv, size_t size, void *ptr),
+                     void *priv)
+{
+    if (!cache)
         return 0;
+
+    struct priv *p = PL_PRIV(cache);
+    struct cache_header header;
+    if (!read(priv, sizeof(header), &header)) {
+        PL_ERR(p, "Failed loading cache: file seems empty or truncated");
+        return -1;
+    }
+
+    int ret = check_header(p, &header);
+    if (ret <= 0)
+        return ret;
+
+    int num_loaded = 0;
+    size_t loaded_bytes = 0;
+    pl_clock_t start = pl_clock_now();
+
+    for (int i = 0; i < header.num_entries; i++) {
+        struct cache_entry entry;
+        if (!read(priv, sizeof(entry), &entry)) {
+            PL_WARN(p, "Cache seems truncated, missing objects.. ignoring rest");
+            goto error;
+        }
+
+        struct cache_entry_ext ext = { .raw_size = entry.size };
+        if (header.version >= 2 && !read(priv, sizeof(ext), &ext)) {
+            PL_WARN(p, "Cache seems truncated, missing objects.. ignoring rest");
+            goto error;
+        }
+
+        if (!check_entry(p, &entry, &ext))
+            goto error;
+
+        void *buf = pl_alloc(NULL, PAD_ALIGN(entry.size));
+        if (!read(priv, PAD_ALIGN(entry.size), buf)) {
+            PL_WARN(p, "Cache seems truncated, missing objects.. ignoring rest");
+            pl_free(buf);
+            goto error;
+        }
+
+        uint64_t checksum = pl_mem_hash(buf, entry.size);
+        if (checksum != entry.hash) {
+            PL_WARN(p, "Cache entry seems corrupt, checksum mismatch.. ignoring rest");
+            pl_free(buf);
+            goto error;
+        }
+
+        if (ext.codec != CODEC_NONE) {
+            void *raw = decode_payload(ext.codec, buf, entry.size, ext.raw_size);
+            pl_free(buf);
+            if (!raw) {
+                PL_WARN(p, "Cache entry seems corrupt, failed decompressing.. "
+                        "ignoring rest");
+                goto error;
+            }
+            buf = raw;
+        }
+
+        pl_cache_obj obj = {
+            .key  = entry.key,
+            .size = ext.raw_size,
+            .data = buf,
+            .free = pl_free,
+            .cost = ext.cost,
+        };
+
+        if (load_obj(cache, obj)) {
+            num_loaded++;
+            loaded_bytes += obj.size;
+        } else {
+            pl_free(buf);
+        }
+    }
+
+    pl_log_cpu_time(p->log, start, pl_clock_now(), "loading cache");
+    if (num_loaded)
+        PL_DEBUG(p, "Loaded %d objects, totalling %zu bytes", num_loaded, loaded_bytes);
+
+    // fall through
+error:
+    return num_loaded;
+}
+
+static int load_mapped(pl_cache cache, const uint8_t *data, size_t size, bool lazy)
+{
+    struct priv *p = PL_PRIV(cache);
+    struct cache_header header;
+    if (size < sizeof(header)) {
+        PL_ERR(p, "Failed loading cache: file seems empty or truncated");
+        return -1;
+    }
+
+    memcpy(&header, data, sizeof(header));
+    int ret = check_header(p, &header);
+    if (ret <= 0)
+        return ret;
+
+    int num_loaded = 0;
+    size_t loaded_bytes = 0, pos = sizeof(header);
+    pl_clock_t start = pl_clock_now();
+    if (lazy) {
+        // Don't trust `num_entries` for the allocation size
+        const size_t max_entries = (size - pos) / sizeof(struct cache_entry);
+        pl_mutex_lock(&p->map_lock);
+        PL_ARRAY_RESIZE((void *) cache, p->lazy, p->lazy.num +
+                        PL_MIN(header.num_entries, max_entries));
+    }
+
+    for (int i = 0; i < header.num_entries; i++) {
+        struct cache_entry entry;
+        if (size - pos < sizeof(entry)) {
+            PL_WARN(p, "Cache seems truncated, missing objects.. ignoring rest");
+            break;
+        }
+
+        memcpy(&entry, data + pos, sizeof(entry));
+        pos += sizeof(entry);
+
+        struct cache_entry_ext ext = { .raw_size = entry.size };
+        if (header.version >= 2) {
+            if (size - pos < sizeof(ext)) {
+                PL_WARN(p, "Cache seems truncated, missing objects.. ignoring rest");
+                break;
+            }
+            memcpy(&ext, data + pos, sizeof(ext));
+            pos += sizeof(ext);
+        }
+
+        if (!check_entry(p, &entry, &ext))
+            break;
+        if (entry.size > size - pos || PAD_ALIGN(entry.size) > size - pos) {
+            PL_WARN(p, "Cache seems truncated, missing objects.. ignoring rest");
+            break;
+        }
+
+        const uint8_t *buf = data + pos;
+        pos += PAD_ALIGN(entry.size);
+        if (!entry.size)
+            continue;
+
+        if (lazy) {
+            // Defer checksum verification until the object is first used, to
+            // avoid touching the payload at all until then
+            const int idx = p->lazy.num++;
+            p->lazy.elem[idx] = (struct lazy_entry) {
+                .key  = entry.key,
+                .hash = entry.hash,
+                .data     = buf,
+                .size     = entry.size,
+                .raw_size = ext.raw_size,
+                .codec    = ext.codec,
+                .cost     = ext.cost,
+                .seq      = idx,
+            };
+            num_loaded++;
+            loaded_bytes += ext.raw_size;
+            continue;
+        }
+
+        if (pl_mem_hash(buf, entry.size) != entry.hash) {
+            PL_WARN(p, "Cache entry seems corrupt, checksum mismatch.. ignoring rest");
+            break;
+        }
+
+        // The mapping outlives all objects, so no need to free anything
+        pl_cache_obj obj = {
+            .key  = entry.key,
+            .size = entry.size,
+            .data = (void *) buf,
+            .free = noop,
+            .cost = ext.cost,
+        };
+
+        if (ext.codec != CODEC_NONE) {
+            obj.data = decode_payload(ext.codec, buf, entry.size, ext.raw_size);
+            obj.size = ext.raw_size;
+            obj.free = pl_free;
+            if (!obj.data) {
+                PL_WARN(p, "Cache entry seems corrupt, failed decompressing.. "
+                        "ignoring rest");
+                break;
+            }
+        }
+
+        if (load_obj(cache, obj)) {
+            num_loaded++;
+            loaded_bytes += obj.size;
+        } else if (obj.free == pl_free) {
+            pl_free(obj.data);
+        }
     }
-    if (header.num_entries > INT_MAX) {
-        PL_ERR(p, "Failed loading cache: %"PRIu32" entries overflows int",
-               header.num_entries);
+
+    if (lazy) {
+        // Sort by key and deduplicate, keeping only the most recent entries
+        qsort(p->lazy.elem, p->lazy.num, sizeof(p->lazy.elem[0]), cmp_lazy);
+        int num = 0;
+        for (int i = 0; i < p->lazy.num; i++) {
+            struct lazy_entry e = p->lazy.elem[i];
+            if (!e.data)
+                continue;
+            if (num && p->lazy.elem[num - 1].key == e.key) {
+                p->lazy.elem[num - 1] = e;
+            } else {
+                p->lazy.elem[num++] = e;
+            }
+        }
+        for (int i = 0; i < num; i++)
+            p->lazy.elem[i].seq = i;
+        p->lazy.num = num;
+        atomic_store(&p->num_lazy, num);
+        pl_mutex_unlock(&p->map_lock);
+    }
+
+    pl_log_cpu_time(p->log, start, pl_clock_now(), "loading mapped cache");
+    if (num_loaded) {
+        PL_DEBUG(p, "%s %d objects, totalling %zu bytes",
+                 lazy ? "Indexed" : "Mapped", num_loaded, loaded_bytes);
+    }
+    return num_loaded;
+}
+
+static bool map_file(struct priv *p, const char *path, struct cache_mapping *map)
+{
+#if defined(PL_HAVE_MMAP)
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        PL_ERR(p, "Failed opening cache file '%s': %s", path, strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size <= 0) {
+        PL_ERR(p, "Failed loading cache: file '%s' seems empty", path);
+        close(fd);
+        return false;
+    }
+
+    map->size = st.st_size;
+    void *ptr = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+        PL_ERR(p, "Failed mapping cache file '%s': %s", path, strerror(errno));
+        return false;
+    }
+    map->data = ptr;
+    return true;
+#elif defined(PL_HAVE_WIN32)
+    map->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (map->file == INVALID_HANDLE_VALUE) {
+        PL_ERR(p, "Failed opening cache file '%s'", path);
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(map->file, &file_size) || file_size.QuadPart <= 0) {
+        PL_ERR(p, "Failed loading cache: file '%s' seems empty", path);
+        CloseHandle(map->file);
+        return false;
+    }
+
+    map->size = file_size.QuadPart;
+    map->mapping = CreateFileMappingA(map->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (map->mapping)
+        map->data = MapViewOfFile(map->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!map->data) {
+        PL_ERR(p, "Failed mapping cache file '%s'", path);
+        if (map->mapping)
+            CloseHandle(map->mapping);
+        CloseHandle(map->file);
+        return false;
+    }
+    return true;
+#else
+    PL_ERR(p, "Memory-mapped cache loading not supported on this platform!");
+    return false;
+#endif
+}
+
+static int load_file(pl_cache cache, const char *path, bool lazy)
+{
+    if (!cache)
         return 0;
+
+    struct priv *p = PL_PRIV(cache);
+    struct cache_mapping map = {0};
+    if (!map_file(p, path, &map))
+        return -1;
+
+    int ret = load_mapped(cache, map.data, map.size, lazy);
+    if (ret <= 0) {
+        unmap_file(&map);
+        return ret;
     }
 
-    int num_loaded = 0;
-    size_t loaded_bytes = 0;
-    pl_mutex_lock(&p->lock);
+    pl_mutex_lock(&p->map_lock);
+    PL_ARRAY_APPEND((void *) cache, p->mappings, map);
+    pl_mutex_unlock(&p->map_lock);
+    return ret;
+}
+
+int pl_cache_load_mmap(pl_cache cache, const char *path)
+{
+    return load_file(cache, path, false);
+}
+
+int pl_cache_load_lazy(pl_cache cache, const char *path)
+{
+    return load_file(cache, path, true);
+}
+
+// --- Journaling
+
+#define JOURNAL_MAGIC    "pl_cjrnl"
+#define JOURNAL_VERSION  1
+#define JOURNAL_MIN_SIZE (1 << 20) // smaller journals are never compacted
+
+// The journal consists of a `cache_header` followed by a sequence of records,
+// using the same layout as version 2 cache entries. Deletions are recorded as
+// empty objects. Replaying all records in order reproduces the cache.
+static const struct cache_header journal_header = {
+    .magic   = JOURNAL_MAGIC,
+    .version = JOURNAL_VERSION,
+};
+
+static bool file_seek(FILE *file, uint64_t pos)
+{
+#if defined(PL_HAVE_WIN32)
+    return _fseeki64(file, pos, SEEK_SET) == 0;
+#elif defined(PL_HAVE_MMAP)
+    return fseeko(file, pos, SEEK_SET) == 0;
+#else
+    return pos <= LONG_MAX && fseek(file, pos, SEEK_SET) == 0;
+#endif
+}
+
+static bool file_sync(FILE *file)
+{
+    if (fflush(file) != 0)
+        return false;
+#if defined(PL_HAVE_WIN32)
+    return _commit(_fileno(file)) == 0;
+#elif defined(PL_HAVE_MMAP)
+    return fsync(fileno(file)) == 0;
+#else
+    return true;
+#endif
+}
+
+// Atomically replaces `dst` by `src`
+static bool file_replace(const char *src, const char *dst)
+{
+#ifdef PL_HAVE_WIN32
+    return MoveFileExA(src, dst, MOVEFILE_REPLACE_EXISTING);
+#else
+    return rename(src, dst) == 0;
+#endif
+}
+
+static bool copy_range(FILE *in, FILE *out, uint64_t pos, uint64_t len)
+{
+    uint8_t buf[16 << 10];
+    if (!file_seek(in, pos))
+        return false;
+    while (len) {
+        const size_t num = PL_MIN(len, sizeof(buf));
+        if (fread(buf, 1, num, in) != num || fwrite(buf, 1, num, out) != num)
+            return false;
+        len -= num;
+    }
+    return true;
+}
+
+static void write_str(void *priv, size_t size, const void *ptr)
+{
+    pl_str_append_raw(NULL, priv, ptr, size);
+}
+
+// Serializes a record for `obj`, or its deletion if `obj.size` is 0
+static pl_str journal_encode(pl_cache cache, pl_cache_obj obj)
+{
+    uint8_t *data = obj.data;
+    size_t size = obj.size;
+    enum cache_codec codec = CODEC_NONE;
+    if (cache->params.compress && obj.size)
+        codec = encode_payload(NULL, obj, &data, &size);
+
+    pl_str rec = {0};
+    write_entry(write_str, &rec, 2, &(struct cache_entry) {
+        .key  = obj.key,
+        .size = size,
+        .hash = pl_mem_hash(data, size),
+    }, &(struct cache_entry_ext) {
+        .raw_size = obj.size,
+        .codec    = codec,
+        .cost     = obj.cost,
+    }, data);
+    if (data != obj.data)
+        pl_free(data);
+    return rec;
+}
+
+// Returns the index of the record for `key`, or the position to insert it at
+static int journal_find(const struct journal *j, uint64_t key, bool *found)
+{
+    int lo = 0, hi = j->index.num;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (j->index.elem[mid].key < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    *found = lo < j->index.num && j->index.elem[lo].key == key;
+    return lo;
+}
+
+static int cmp_rec(const void *pa, const void *pb)
+{
+    const struct journal_rec *a = pa, *b = pb;
+    return PL_CMP(a->key, b->key);
+}
+
+// Must be called with `j->lock` held
+static bool journal_append(struct priv *p, struct journal *j, pl_str rec)
+{
+    if (fwrite(rec.buf, 1, rec.len, j->file) != rec.len || fflush(j->file) != 0) {
+        PL_ERR(p, "Failed writing to cache journal '%s': %s, disabling journal",
+               j->path, strerror(errno));
+        fclose(j->file);
+        j->file = NULL;
+        return false;
+    }
+
+    j->size += rec.len;
+    return true;
+}
+
+// Requests compaction once superseded records make up most of the journal.
+// Must be called with `j->lock` held.
+static void journal_check(struct journal *j)
+{
+    if (j->size < PL_MAX(j->compact_at, JOURNAL_MIN_SIZE))
+        return;
+    if (j->size - j->live_size < j->live_size || j->compact)
+        return;
+
+    j->compact = true;
+    pl_cond_signal(&j->wakeup);
+}
+
+// Appends a deletion record for `j->index.elem[idx]` and removes it. Must be
+// called with `j->lock` held.
+static bool journal_remove(pl_cache cache, struct journal *j, int idx)
+{
+    const struct journal_rec rec = j->index.elem[idx];
+    pl_str del = journal_encode(cache, (pl_cache_obj) { .key = rec.key });
+    const bool ok = journal_append(PL_PRIV(cache), j, del);
+    pl_free(del.buf);
+    if (ok) {
+        j->live_size -= rec.len;
+        PL_ARRAY_REMOVE_AT(j->index, idx);
+    }
+    return ok;
+}
+
+static bool journal_prepare(pl_cache cache, pl_cache_obj obj, struct journal_op *op)
+{
+    struct priv *p = PL_PRIV(cache);
+    struct journal *j = p->journal;
+    if (!j)
+        return false;
+
+    *op = (struct journal_op) {0};
+    if (!obj.size)
+        return true;
+
+    // Objects are routinely re-inserted unmodified after `pl_cache_get`, so
+    // avoid re-serializing (and re-recording) them
+    op->hash = pl_mem_hash(obj.data, obj.size);
+    pl_mutex_lock(&j->lock);
+    bool found;
+    const int idx = journal_find(j, obj.key, &found);
+    const bool dirty = !found || j->index.elem[idx].hash != op->hash;
+    pl_mutex_unlock(&j->lock);
+    if (dirty)
+        op->rec = journal_encode(cache, obj);
+    return true;
+}
+
+// Must be called with the object's shard lock held
+static void journal_write(pl_cache cache, pl_cache_obj obj, const struct journal_op *op)
+{
+    struct priv *p = PL_PRIV(cache);
+    struct journal *j = p->journal;
+    pl_mutex_lock(&j->lock);
+    if (!j->file)
+        goto done;
+
+    bool found;
+    const int idx = journal_find(j, obj.key, &found);
+    pl_str rec = op->rec;
+    if (!rec.len) {
+        if (found && j->index.elem[idx].hash == op->hash)
+            goto done; // already up-to-date
+        rec = journal_encode(cache, obj); // raced with a concurrent update
+    }
+
+    const struct journal_rec jrec = {
+        .key    = obj.key,
+        .hash   = op->hash,
+        .offset = j->size,
+        .len    = rec.len,
+    };
+
+    if (journal_append(p, j, rec)) {
+        PL_TRACE(p, "Journaled object 0x%"PRIx64" (size %zu)", obj.key, obj.size);
+        if (found) {
+            j->live_size -= j->index.elem[idx].len;
+            j->index.elem[idx] = jrec;
+        } else {
+            PL_ARRAY_INSERT_AT(j, j->index, idx, jrec);
+        }
+        j->live_size += jrec.len;
+        journal_check(j);
+    }
+
+    if (rec.buf != op->rec.buf)
+        pl_free(rec.buf);
+    // fall through
+done:
+    pl_mutex_unlock(&j->lock);
+}
+
+static void journal_drop(pl_cache cache, uint64_t key)
+{
+    struct priv *p = PL_PRIV(cache);
+    struct journal *j = p->journal;
+    if (!j)
+        return;
+
+    pl_mutex_lock(&j->lock);
+    bool found;
+    const int idx = journal_find(j, key, &found);
+    if (found && j->file && journal_remove(cache, j, idx))
+        journal_check(j);
+    pl_mutex_unlock(&j->lock);
+}
+
+static void journal_clear(pl_cache cache)
+{
+    struct priv *p = PL_PRIV(cache);
+    struct journal *j = p->journal;
+    if (!j)
+        return;
+
+    pl_mutex_lock(&j->lock);
+    while (j->index.num && j->file) {
+        if (!journal_remove(cache, j, j->index.num - 1))
+            break;
+    }
+    journal_check(j);
+    pl_mutex_unlock(&j->lock);
+}
+
+// Rewrites the journal to contain only live records, and atomically replaces
+// the old journal by it. Records may be appended concurrently, except while
+// swapping in the new journal.
+static bool journal_compact(pl_cache cache, struct journal *j)
+{
+    struct priv *p = PL_PRIV(cache);
+    pl_mutex_lock(&j->compact_lock);
     pl_clock_t start = pl_clock_now();
 
-    for (int i = 0; i < header.num_entries; i++) {
-        struct cache_entry entry;
-        if (!read(priv, sizeof(entry), &entry)) {
-            PL_WARN(p, "Cache seems truncated, missing objects.. ignoring rest");
-            goto error;
+    pl_mutex_lock(&j->lock);
+    j->compact = false;
+    if (!j->file) {
+        pl_mutex_unlock(&j->lock);
+        pl_mutex_unlock(&j->compact_lock);
+        return false;
+    }
+
+    const uint64_t old_size = j->size;
+    const int num = j->index.num;
+    struct journal_rec *recs = pl_memdup(NULL, j->index.elem, num * sizeof(recs[0]));
+    bool ok = fflush(j->file) == 0;
+    pl_mutex_unlock(&j->lock);
+
+    FILE *in = fopen(j->path, "rb");
+    FILE *out = fopen(j->tmp_path, "wb");
+    ok = ok && in && out;
+    ok = ok && fwrite(&journal_header, sizeof(journal_header), 1, out) == 1;
+    uint64_t pos = sizeof(journal_header);
+    for (int i = 0; ok && i < num; i++) {
+        ok = copy_range(in, out, recs[i].offset, recs[i].len);
+        recs[i].offset = pos;
+        pos += recs[i].len;
+    }
+
+    // Copy over all records appended in the meantime
+    pl_mutex_lock(&j->lock);
+    const uint64_t tail = j->size - old_size;
+    ok = ok && j->file && fflush(j->file) == 0;
+    ok = ok && copy_range(in, out, old_size, tail);
+    ok = ok && file_sync(out);
+    if (out)
+        ok = fclose(out) == 0 && ok;
+    if (in)
+        fclose(in);
+
+    if (ok) {
+        fclose(j->file);
+        ok = file_replace(j->tmp_path, j->path);
+        j->file = fopen(j->path, "ab");
+        if (!j->file) {
+            PL_ERR(p, "Failed re-opening cache journal '%s': %s, disabling journal",
+                   j->path, strerror(errno));
         }
+    }
 
-        if (entry.size > SIZE_MAX) {
-            PL_WARN(p, "Cache object size %"PRIu64" overflows SIZE_MAX.. "
-                    "suspect broken file, ignoring rest", entry.size);
-            goto error;
+    if (ok) {
+        for (int i = 0; i < j->index.num; i++) {
+            struct journal_rec *rec = &j->index.elem[i];
+            if (rec->offset >= old_size) {
+                rec->offset = rec->offset - old_size + pos;
+            } else {
+                // Records predating the compaction are still unchanged
+                const struct journal_rec *new = bsearch(rec, recs, num,
+                                                        sizeof(recs[0]), cmp_rec);
+                pl_assert(new && new->len == rec->len);
+                rec->offset = new->offset;
+            }
         }
+        PL_DEBUG(p, "Compacted cache journal from %"PRIu64" to %"PRIu64" bytes",
+                 j->size, pos + tail);
+        j->size = pos + tail;
+        j->compact_at = 0;
+    } else {
+        PL_WARN(p, "Failed compacting cache journal '%s'", j->path);
+        remove(j->tmp_path);
+        j->compact_at = 2 * j->size; // back off
+    }
 
-        void *buf = pl_alloc(NULL, PAD_ALIGN(entry.size));
-        if (!read(priv, PAD_ALIGN(entry.size), buf)) {
-            PL_WARN(p, "Cache seems truncated, missing objects.. ignoring rest");
+    pl_mutex_unlock(&j->lock);
+    pl_free(recs);
+    pl_log_cpu_time(p->log, start, pl_clock_now(), "compacting cache journal");
+    pl_mutex_unlock(&j->compact_lock);
+    return ok;
+}
+
+static PL_THREAD_VOID journal_worker(void *arg)
+{
+    pl_cache cache = arg;
+    struct priv *p = PL_PRIV(cache);
+    struct journal *j = p->journal;
+
+    pl_mutex_lock(&j->lock);
+    for (;;) {
+        while (!j->compact && !j->quit)
+            pl_cond_wait(&j->wakeup, &j->lock);
+        if (j->quit)
+            break;
+        pl_mutex_unlock(&j->lock);
+        journal_compact(cache, j);
+        pl_mutex_lock(&j->lock);
+    }
+    pl_mutex_unlock(&j->lock);
+
+    PL_THREAD_RETURN();
+}
+
+// Replays all valid records from `file` into the cache, returning the size of
+// the valid prefix of the journal (or 0 if it is empty), or a negative number
+// if the file is not a valid journal
+static int64_t journal_replay(pl_cache cache, struct journal *j, FILE *file,
+                              bool *truncated)
+{
+    struct priv *p = PL_PRIV(cache);
+    struct cache_header header;
+    size_t num = fread(&header, 1, sizeof(header), file);
+    if (!num)
+        return 0;
+    if (num != sizeof(header) ||
+        memcmp(header.magic, JOURNAL_MAGIC, sizeof(header.magic)) != 0)
+    {
+        PL_ERR(p, "Failed opening cache journal '%s': invalid header", j->path);
+        return -1;
+    }
+    if (header.version != JOURNAL_VERSION) {
+        PL_ERR(p, "Failed opening cache journal '%s': unsupported version %"PRIu32,
+               j->path, header.version);
+        return -1;
+    }
+
+    uint64_t pos = sizeof(header);
+    for (;;) {
+        struct cache_entry entry;
+        struct cache_entry_ext ext;
+        num = fread(&entry, 1, sizeof(entry), file);
+        if (!num && feof(file))
+            break;
+        if (num != sizeof(entry) || fread(&ext, sizeof(ext), 1, file) != 1)
+            goto truncated;
+        if (!check_entry(p, &entry, &ext))
+            goto truncated;
+
+        const size_t size = PAD_ALIGN(entry.size);
+        const uint64_t len = sizeof(entry) + sizeof(ext) + size;
+        void *buf = pl_alloc(NULL, PL_MAX(size, 1));
+        if (fread(buf, 1, size, file) != size ||
+            pl_mem_hash(buf, entry.size) != entry.hash)
+        {
             pl_free(buf);
-            goto error;
+            goto truncated;
         }
 
-        uint64_t checksum = pl_mem_hash(buf, entry.size);
-        if (checksum != entry.hash) {
-            PL_WARN(p, "Cache entry seems corrupt, checksum mismatch.. ignoring rest");
+        if (ext.codec != CODEC_NONE) {
+            void *raw = decode_payload(ext.codec, buf, entry.size, ext.raw_size);
             pl_free(buf);
-            goto error;
+            if (!raw)
+                goto truncated;
+            buf = raw;
         }
 
         pl_cache_obj obj = {
             .key  = entry.key,
-            .size = entry.size,
+            .size = ext.raw_size,
             .data = buf,
             .free = pl_free,
+            .cost = ext.cost,
         };
 
-        PL_TRACE(p, "Loading object 0x%"PRIx64" (size %zu)", obj.key, obj.size);
-        if (try_set(cache, obj)) {
-            num_loaded++;
-            loaded_bytes += entry.size;
+        bool found;
+        const int idx = journal_find(j, obj.key, &found);
+        const struct journal_rec rec = {
+            .key    = obj.key,
+            .hash   = pl_mem_hash(obj.data, obj.size),
+            .offset = pos,
+            .len    = len,
+        };
+
+        if (!obj.size) {
+            if (found)
+                PL_ARRAY_REMOVE_AT(j->index, idx);
+        } else if (found) {
+            j->index.elem[idx] = rec;
         } else {
+            PL_ARRAY_INSERT_AT(j, j->index, idx, rec);
+        }
+
+        if (!obj.size) {
             pl_free(buf);
+            obj.data = NULL;
+            obj.free = NULL;
         }
+        if (!load_obj(cache, obj))
+            pl_free(obj.data);
+        pos += len;
     }
 
-    pl_log_cpu_time(p->log, start, pl_clock_now(), "loading cache");
-    if (num_loaded)
-        PL_DEBUG(p, "Loaded %d objects, totalling %zu bytes", num_loaded, loaded_bytes);
+    return pos;
 
-    // fall through
-error:
-    pl_mutex_unlock(&p->lock);
-    return num_loaded;
+truncated:
+    PL_WARN(p, "Cache journal '%s' seems truncated or corrupt, discarding "
+            "records past offset %"PRIu64, j->path, pos);
+    *truncated = true;
+    return pos;
+}
+
+int pl_cache_journal_open(pl_cache cache, const char *path)
+{
+    if (!cache)
+        return 0;
+
+    struct priv *p = PL_PRIV(cache);
+    if (p->journal) {
+        PL_ERR(p, "Failed opening cache journal '%s': a journal is already "
+               "attached to this cache", path);
+        return -1;
+    }
+
+    struct journal *j = pl_zalloc_ptr(NULL, j);
+    j->path = pl_strdup0(j, pl_str0(path));
+    j->tmp_path = pl_asprintf(j, "%s.tmp", path);
+    pl_clock_t start = pl_clock_now();
+
+    int64_t size = 0;
+    bool truncated = false;
+    FILE *file = fopen(path, "rb");
+    if (file) {
+        size = journal_replay(cache, j, file, &truncated);
+        fclose(file);
+    } else if (errno != ENOENT) {
+        PL_ERR(p, "Failed opening cache journal '%s': %s", path, strerror(errno));
+        size = -1;
+    }
+
+    if (size >= 0)
+        j->file = fopen(path, "ab");
+    if (size >= 0 && !j->file) {
+        PL_ERR(p, "Failed opening cache journal '%s' for writing: %s",
+               path, strerror(errno));
+        size = -1;
+    }
+    if (size == 0) {
+        // New (or empty) journal
+        if (fwrite(&journal_header, sizeof(journal_header), 1, j->file) != 1 ||
+            fflush(j->file) != 0)
+        {
+            PL_ERR(p, "Failed writing cache journal '%s': %s", path, strerror(errno));
+            size = -1;
+        } else {
+            size = sizeof(journal_header);
+        }
+    }
+
+    if (size < 0) {
+        if (j->file)
+            fclose(j->file);
+        pl_free(j);
+        return -1;
+    }
+
+    // Forget about records that did not survive being replayed, e.g. due to
+    // size limits, so the journal mirrors the contents of the cache
+    int num = 0;
+    for (int i = 0; i < j->index.num; i++) {
+        const struct journal_rec rec = j->index.elem[i];
+        struct shard *s = get_shard(p, rec.key);
+        lock_shard(s);
+        const bool resident = find_node(s, rec.key) != NODE_NONE;
+        pl_mutex_unlock(&s->lock);
+        if (resident) {
+            j->index.elem[num++] = rec;
+            j->live_size += rec.len;
+        }
+    }
+    j->index.num = num;
+    j->size = size;
+
+    pl_mutex_init(&j->lock);
+    pl_mutex_init(&j->compact_lock);
+    pl_cond_init(&j->wakeup);
+
+    // Discard any incomplete trailing record before appending new ones
+    const bool compact = j->size >= JOURNAL_MIN_SIZE &&
+                         j->size - j->live_size >= j->live_size;
+    if ((truncated || compact) && !journal_compact(cache, j) && truncated) {
+        PL_ERR(p, "Failed recovering cache journal '%s'", path);
+        if (j->file)
+            fclose(j->file);
+        pl_cond_destroy(&j->wakeup);
+        pl_mutex_destroy(&j->compact_lock);
+        pl_mutex_destroy(&j->lock);
+        pl_free(j);
+        return -1;
+    }
+
+    p->journal = j;
+    if (pl_thread_create(&j->thread, journal_worker, (void *) cache) == 0) {
+        j->has_thread = true;
+    } else {
+        PL_WARN(p, "Failed creating cache journal thread, journal will only be "
+                "compacted by `pl_cache_journal_sync`");
+    }
+
+    pl_log_cpu_time(p->log, start, pl_clock_now(), "replaying cache journal");
+    PL_DEBUG(p, "Opened cache journal '%s' (%"PRIu64" bytes), replayed %d objects",
+             path, j->size, num);
+    return num;
+}
+
+void pl_cache_journal_close(pl_cache cache)
+{
+    if (!cache)
+        return;
+
+    struct priv *p = PL_PRIV(cache);
+    struct journal *j = p->journal;
+    if (!j)
+        return;
+
+    if (j->has_thread) {
+        pl_mutex_lock(&j->lock);
+        j->quit = true;
+        pl_cond_broadcast(&j->wakeup);
+        pl_mutex_unlock(&j->lock);
+        pl_thread_join(j->thread);
+    }
+
+    if (j->file)
+        fclose(j->file);
+    pl_cond_destroy(&j->wakeup);
+    pl_mutex_destroy(&j->compact_lock);
+    pl_mutex_destroy(&j->lock);
+    pl_free(j);
+    p->journal = NULL;
+}
+
+bool pl_cache_journal_sync(pl_cache cache, bool compact)
+{
+    if (!cache)
+        return false;
+
+    struct priv *p = PL_PRIV(cache);
+    struct journal *j = p->journal;
+    if (!j)
+        return false;
+    if (compact && !journal_compact(cache, j))
+        return false;
+
+    pl_mutex_lock(&j->lock);
+    bool ok = j->file && file_sync(j->file);
+    pl_mutex_unlock(&j->lock);
+    return ok;
 }
 
 // Save/load wrappers
@@ -19,6 +19,7 @@
 
 #include "../common.h"
 #include "../log.h"
+#include "../pl_thread.h"
 
 #ifdef PL_HAVE_DXGI_DEBUG
 #include <dxgidebug.h>
@@ -38,6 +39,12 @@ struct d3d11_ctx {
     // DXGI device. This does hold a reference.
     IDXGIDevice1 *dxgi_dev;
 
+    // Recursive lock serializing all use of the immediate context (including
+    // implicit use by the swapchain) and of the debug message queue. The
+    // device itself is free-threaded, so e.g. shader compilation does not
+    // need to hold this.
+    pl_mutex lock;
+
 #ifdef PL_HAVE_DXGI_DEBUG
     // Debug interfaces
     IDXGIDebug *debug;
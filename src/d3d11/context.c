@@ -336,6 +336,7 @@ void pl_d3d11_destroy(pl_d3d11 *ptr)
     SAFE_RELEASE(ctx->iqueue);
 #endif
 
+    pl_mutex_destroy(&ctx->lock);
     pl_free_ptr((void **) ptr);
 }
 
@@ -351,6 +352,7 @@ pl_d3d11 pl_d3d11_create(pl_log log, const struct pl_d3d11_params *params)
     struct d3d11_ctx *ctx = PL_PRIV(d3d11);
     ctx->log = log;
     ctx->d3d11 = d3d11;
+    pl_mutex_init_type(&ctx->lock, PL_MUTEX_RECURSIVE);
 
     if (params->device) {
         d3d11->device = params->device;
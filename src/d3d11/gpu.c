@@ -284,6 +284,7 @@ static void d3d11_gpu_destroy(pl_gpu gpu)
     SAFE_RELEASE(p->imm4);
     SAFE_RELEASE(p->vbuf.buf);
     SAFE_RELEASE(p->ibuf.buf);
+    SAFE_RELEASE(p->cbuf.buf);
     SAFE_RELEASE(p->rstate);
     SAFE_RELEASE(p->dsstate);
     for (int i = 0; i < PL_TEX_SAMPLE_MODE_COUNT; i++) {
@@ -361,28 +362,87 @@ static bool load_d3d_compiler(pl_gpu gpu)
     return false;
 }
 
+// All operations which touch the immediate context, or state shared with it
+// (stream buffers, staging resources, queries), are serialized by the context
+// lock. Pass creation is deliberately left unlocked, since it mostly consists
+// of shader compilation, which can run concurrently on `pl_dispatch` worker
+// threads while other threads keep rendering.
+#define LOCKED(ret, fn, params, args)                                       \
+    static ret fn##_locked params                                           \
+    {                                                                       \
+        struct pl_gpu_d3d11 *p = PL_PRIV(gpu);                              \
+        pl_mutex_lock(&p->ctx->lock);                                       \
+        ret res = fn args;                                                  \
+        pl_mutex_unlock(&p->ctx->lock);                                     \
+        return res;                                                         \
+    }
+
+#define LOCKED_VOID(fn, params, args)                                       \
+    static void fn##_locked params                                          \
+    {                                                                       \
+        struct pl_gpu_d3d11 *p = PL_PRIV(gpu);                              \
+        pl_mutex_lock(&p->ctx->lock);                                       \
+        fn args;                                                            \
+        pl_mutex_unlock(&p->ctx->lock);                                     \
+    }
+
+LOCKED(pl_tex, pl_d3d11_tex_create, (pl_gpu gpu, const struct pl_tex_params *params),
+       (gpu, params))
+LOCKED_VOID(pl_d3d11_tex_destroy, (pl_gpu gpu, pl_tex tex), (gpu, tex))
+LOCKED_VOID(pl_d3d11_tex_invalidate, (pl_gpu gpu, pl_tex tex), (gpu, tex))
+LOCKED_VOID(pl_d3d11_tex_clear_ex, (pl_gpu gpu, pl_tex tex, const union pl_clear_color color),
+            (gpu, tex, color))
+LOCKED_VOID(pl_d3d11_tex_blit, (pl_gpu gpu, const struct pl_tex_blit_params *params),
+            (gpu, params))
+LOCKED(bool, pl_d3d11_tex_upload, (pl_gpu gpu, const struct pl_tex_transfer_params *params),
+       (gpu, params))
+LOCKED(bool, pl_d3d11_tex_download, (pl_gpu gpu, const struct pl_tex_transfer_params *params),
+       (gpu, params))
+LOCKED(pl_buf, pl_d3d11_buf_create, (pl_gpu gpu, const struct pl_buf_params *params),
+       (gpu, params))
+LOCKED_VOID(pl_d3d11_buf_destroy, (pl_gpu gpu, pl_buf buf), (gpu, buf))
+LOCKED_VOID(pl_d3d11_buf_write, (pl_gpu gpu, pl_buf buf, size_t offset,
+                                 const void *data, size_t size),
+            (gpu, buf, offset, data, size))
+LOCKED(bool, pl_d3d11_buf_read, (pl_gpu gpu, pl_buf buf, size_t offset,
+                                 void *dest, size_t size),
+       (gpu, buf, offset, dest, size))
+LOCKED_VOID(pl_d3d11_buf_copy, (pl_gpu gpu, pl_buf dst, size_t dst_offset,
+                                pl_buf src, size_t src_offset, size_t size),
+            (gpu, dst, dst_offset, src, src_offset, size))
+LOCKED_VOID(pl_d3d11_pass_run, (pl_gpu gpu, const struct pl_pass_run_params *params),
+            (gpu, params))
+LOCKED(pl_timer, d3d11_timer_create, (pl_gpu gpu), (gpu))
+LOCKED_VOID(d3d11_timer_destroy, (pl_gpu gpu, pl_timer timer), (gpu, timer))
+LOCKED(uint64_t, d3d11_timer_query, (pl_gpu gpu, pl_timer timer), (gpu, timer))
+LOCKED_VOID(d3d11_gpu_flush, (pl_gpu gpu), (gpu))
+LOCKED_VOID(d3d11_gpu_finish, (pl_gpu gpu), (gpu))
+
+#undef LOCKED
+#undef LOCKED_VOID
+
 static struct pl_gpu_fns pl_fns_d3d11 = {
-    .tex_create             = pl_d3d11_tex_create,
-    .tex_destroy            = pl_d3d11_tex_destroy,
-    .tex_invalidate         = pl_d3d11_tex_invalidate,
-    .tex_clear_ex           = pl_d3d11_tex_clear_ex,
-    .tex_blit               = pl_d3d11_tex_blit,
-    .tex_upload             = pl_d3d11_tex_upload,
-    .tex_download           = pl_d3d11_tex_download,
-    .buf_create             = pl_d3d11_buf_create,
-    .buf_destroy            = pl_d3d11_buf_destroy,
-    .buf_write              = pl_d3d11_buf_write,
-    .buf_read               = pl_d3d11_buf_read,
-    .buf_copy               = pl_d3d11_buf_copy,
+    .tex_create             = pl_d3d11_tex_create_locked,
+    .tex_destroy            = pl_d3d11_tex_destroy_locked,
+    .tex_invalidate         = pl_d3d11_tex_invalidate_locked,
+    .tex_clear_ex           = pl_d3d11_tex_clear_ex_locked,
+    .tex_blit               = pl_d3d11_tex_blit_locked,
+    .tex_upload             = pl_d3d11_tex_upload_locked,
+    .tex_download           = pl_d3d11_tex_download_locked,
+    .buf_create             = pl_d3d11_buf_create_locked,
+    .buf_destroy            = pl_d3d11_buf_destroy_locked,
+    .buf_write              = pl_d3d11_buf_write_locked,
+    .buf_read               = pl_d3d11_buf_read_locked,
+    .buf_copy               = pl_d3d11_buf_copy_locked,
     .desc_namespace         = d3d11_desc_namespace,
     .pass_create            = pl_d3d11_pass_create,
     .pass_destroy           = pl_d3d11_pass_destroy,
-    .pass_run               = pl_d3d11_pass_run,
-    .timer_create           = d3d11_timer_create,
-    .timer_destroy          = d3d11_timer_destroy,
-    .timer_query            = d3d11_timer_query,
-    .gpu_flush              = d3d11_gpu_flush,
-    .gpu_finish             = d3d11_gpu_finish,
+    .pass_run               = pl_d3d11_pass_run_locked,
+    .timer_create           = d3d11_timer_create_locked,
+    .timer_destroy          = d3d11_timer_destroy_locked,
+    .timer_query            = d3d11_timer_query_locked,
+    .gpu_flush              = d3d11_gpu_flush_locked,
+    .gpu_finish             = d3d11_gpu_finish_locked,
     .gpu_is_failed          = d3d11_gpu_is_failed,
     .destroy                = d3d11_gpu_destroy,
 };
@@ -411,6 +471,12 @@ pl_gpu pl_gpu_create_d3d11(struct d3d11_ctx *ctx)
         }),
         .vbuf.bind_flags = D3D11_BIND_VERTEX_BUFFER,
         .ibuf.bind_flags = D3D11_BIND_INDEX_BUFFER,
+        .cbuf = {
+            .bind_flags = D3D11_BIND_CONSTANT_BUFFER,
+            // *SSetConstantBuffers1 offsets must be multiples of 16 constants
+            .align = 16 * CBUF_ELEM,
+            .min_size = 256 * 1024,
+        },
     };
     if (!p->spirv)
         goto error;
@@ -439,6 +505,15 @@ pl_gpu pl_gpu_create_d3d11(struct d3d11_ctx *ctx)
 
     PL_INFO(gpu, "Using Direct3D 11.%d runtime", p->minor);
 
+    if (p->imm1) {
+        // Allows binding constant buffers at an offset, which we use to
+        // stream all uniforms through a single NO_OVERWRITE ring buffer
+        D3D11_FEATURE_DATA_D3D11_OPTIONS opts = {0};
+        hr = ID3D11Device_CheckFeatureSupport(p->dev, D3D11_FEATURE_D3D11_OPTIONS,
+                                              &opts, sizeof(opts));
+        p->has_cbuf_offsetting = SUCCEEDED(hr) && opts.ConstantBufferOffsetting;
+    }
+
     D3D(ID3D11Device_QueryInterface(p->dev, &IID_IDXGIDevice1, (void **) &dxgi_dev));
     D3D(IDXGIDevice1_GetParent(dxgi_dev, &IID_IDXGIAdapter1, (void **) &adapter));
 
@@ -475,6 +550,11 @@ pl_gpu pl_gpu_create_d3d11(struct d3d11_ctx *ctx)
     if (p->fl >= D3D_FEATURE_LEVEL_10_0)
         p->vbuf.bind_flags |= D3D11_BIND_INDEX_BUFFER;
 
+    // Devices created with D3D11_CREATE_DEVICE_SINGLETHREADED can't be used
+    // from more than one thread at a time, even for resource creation
+    UINT create_flags = ID3D11Device_GetCreationFlags(p->dev);
+    gpu->limits.thread_safe = !(create_flags & D3D11_CREATE_DEVICE_SINGLETHREADED);
+
     if (p->fl >= D3D_FEATURE_LEVEL_10_0) {
         gpu->limits.max_ubo_size = D3D11_REQ_CONSTANT_BUFFER_ELEMENT_COUNT * CBUF_ELEM;
     } else {
@@ -42,6 +42,13 @@ struct d3d_stream_buf {
     size_t size;
     size_t used;
     unsigned int align;
+    size_t min_size; // initial allocation size, or 0 for the default
+};
+
+struct stream_buf_slice {
+    const void *data;
+    unsigned int size;
+    unsigned int offset;
 };
 
 struct pl_gpu_d3d11 {
@@ -66,6 +73,7 @@ struct pl_gpu_d3d11 {
     D3D_FEATURE_LEVEL fl;
     bool has_timestamp_queries;
     bool has_monitored_fences;
+    bool has_cbuf_offsetting;
 
     int max_srvs;
     int max_uavs;
@@ -74,6 +82,9 @@ struct pl_gpu_d3d11 {
     struct d3d_stream_buf vbuf;
     struct d3d_stream_buf ibuf;
 
+    // Streaming constant buffer, bound at an offset (if has_cbuf_offsetting)
+    struct d3d_stream_buf cbuf;
+
     // Shared rasterizer state
     ID3D11RasterizerState *rstate;
 
@@ -201,6 +212,9 @@ struct pl_pass_d3d11 {
 
     // Pre-allocated resource arrays to use in pl_pass_run
     ID3D11Buffer **cbv_arr;
+    UINT *cbv_first; // for *SSetConstantBuffers1
+    UINT *cbv_count;
+    struct stream_buf_slice *cbv_slices; // vertex stage first, then main
     ID3D11ShaderResourceView **srv_arr;
     ID3D11SamplerState **sampler_arr;
     ID3D11UnorderedAccessView **uav_arr;
@@ -20,12 +20,6 @@
 #include "glsl/spirv.h"
 #include "../cache.h"
 
-struct stream_buf_slice {
-    const void *data;
-    unsigned int size;
-    unsigned int offset;
-};
-
 // Upload one or more slices of single-use data to a suballocated dynamic
 // buffer. Only call this once per-buffer per-pass, since it will discard or
 // reallocate the buffer when full.
@@ -51,7 +45,7 @@ static bool stream_buf_upload(pl_gpu gpu, struct d3d_stream_buf *stream,
         size_t new_size = stream->size;
         // Arbitrary base size
         if (!new_size)
-            new_size = 16 * 1024;
+            new_size = PL_DEF(stream->min_size, 16 * 1024);
         while (new_size < size)
             new_size *= 2;
         new_size = PL_MIN(new_size, gpu->limits.max_buf_size);
@@ -351,19 +345,36 @@ static ID3DBlob *shader_compile_glsl(pl_gpu gpu, pl_pass pass,
     ID3DBlob *errors = NULL;
     HRESULT hr;
 
-    pl_clock_t start = pl_clock_now();
-    pl_str spirv = pl_spirv_compile_glsl(p->spirv, tmp, gpu->glsl, stage, glsl);
-    if (!spirv.len)
-        goto error;
+    // The SPIR-V is cached separately from the final DXBC, so that updates
+    // to SPIRV-Cross or d3dcompiler only re-run the later stages
+    pl_cache cache = pl_gpu_cache(gpu);
+    pl_cache_obj spirv = {0};
+    if (cache) {
+        spirv.key = pl_spirv_cache_key(p->spirv, glsl);
+        if (pl_cache_get(cache, &spirv))
+            PL_DEBUG(gpu, "Re-using cached SPIR-V object 0x%"PRIx64, spirv.key);
+    }
 
     pl_clock_t after_glsl = pl_clock_now();
-    pl_log_cpu_time(gpu->log, start, after_glsl, "translating GLSL to SPIR-V");
+    if (!spirv.size) {
+        pl_str res = pl_spirv_compile_glsl(p->spirv, tmp, gpu->glsl, stage, glsl);
+        if (!res.len)
+            goto error;
+
+        spirv.data = res.buf;
+        spirv.size = res.len;
+        spirv.free = pl_free;
+
+        pl_clock_t start = after_glsl;
+        after_glsl = pl_clock_now();
+        pl_log_cpu_time(gpu->log, start, after_glsl, "translating GLSL to SPIR-V");
+    }
 
     SC(spvc_context_create(&sc));
 
     spvc_parsed_ir sc_ir;
-    SC(spvc_context_parse_spirv(sc, (SpvId *) spirv.buf,
-                                spirv.len / sizeof(SpvId), &sc_ir));
+    SC(spvc_context_parse_spirv(sc, (const SpvId *) spirv.data,
+                                spirv.size / sizeof(SpvId), &sc_ir));
 
     SC(spvc_context_create_compiler(sc, SPVC_BACKEND_HLSL, sc_ir,
                                     SPVC_CAPTURE_MODE_TAKE_OWNERSHIP,
@@ -488,6 +499,11 @@ error:;
 
     if (sc)
         spvc_context_destroy(sc);
+    if (out) {
+        pl_cache_steal(cache, &spirv);
+    } else {
+        pl_cache_obj_free(&spirv);
+    }
     SAFE_RELEASE(errors);
     pl_free(tmp);
     return out;
@@ -861,6 +877,15 @@ const struct pl_pass_t *pl_d3d11_pass_create(pl_gpu gpu,
     pass_p->cbv_arr = pl_calloc(pass,
         PL_MAX(pass_p->main.cbvs.num, pass_p->vertex.cbvs.num),
         sizeof(*pass_p->cbv_arr));
+    pass_p->cbv_first = pl_calloc(pass,
+        PL_MAX(pass_p->main.cbvs.num, pass_p->vertex.cbvs.num),
+        sizeof(*pass_p->cbv_first));
+    pass_p->cbv_count = pl_calloc(pass,
+        PL_MAX(pass_p->main.cbvs.num, pass_p->vertex.cbvs.num),
+        sizeof(*pass_p->cbv_count));
+    pass_p->cbv_slices = pl_calloc(pass,
+        pass_p->main.cbvs.num + pass_p->vertex.cbvs.num,
+        sizeof(*pass_p->cbv_slices));
     pass_p->srv_arr = pl_calloc(pass,
         PL_MAX(pass_p->main.srvs.num, pass_p->vertex.srvs.num),
         sizeof(*pass_p->srv_arr));
@@ -921,16 +946,80 @@ error:
 
 // Shared logic between VS, PS and CS for filling the resource arrays that are
 // passed to ID3D11DeviceContext methods
+// Uploads the contents of all constant buffers used by the pass to the
+// streaming constant buffer, to be bound at an offset by `fill_streamed_cbvs`.
+// This avoids updating each constant buffer in place on every pass, which
+// forces the driver to rename it. Returns false if this isn't possible, in
+// which case the constant buffers must be bound directly.
+static bool stream_cbvs(pl_gpu gpu, pl_pass pass,
+                        const struct pl_pass_run_params *params)
+{
+    struct pl_gpu_d3d11 *p = PL_PRIV(gpu);
+    struct pl_pass_d3d11 *pass_p = PL_PRIV(pass);
+    if (!p->has_cbuf_offsetting)
+        return false;
+
+    const struct d3d_pass_stage *stages[] = { &pass_p->vertex, &pass_p->main };
+    int num_slices = 0;
+    for (int s = 0; s < PL_ARRAY_SIZE(stages); s++) {
+        for (int i = 0; i < stages[s]->cbvs.num; i++) {
+            struct stream_buf_slice *slice = &pass_p->cbv_slices[num_slices++];
+            int binding = stages[s]->cbvs.elem[i];
+            if (binding == HLSL_BINDING_NUM_WORKGROUPS) {
+                *slice = (struct stream_buf_slice) {
+                    .data = &pass_p->last_num_wgs,
+                    .size = sizeof(pass_p->last_num_wgs),
+                };
+                continue;
+            } else if (binding < 0) {
+                *slice = (struct stream_buf_slice) {0};
+                continue;
+            }
+
+            // Only buffers with a system memory mirror can be streamed
+            pl_buf buf = params->desc_bindings[binding].object;
+            struct pl_buf_d3d11 *buf_p = PL_PRIV(buf);
+            if (!buf_p->data)
+                return false;
+
+            *slice = (struct stream_buf_slice) {
+                .data = buf_p->data,
+                .size = PL_ALIGN2(buf->params.size, CBUF_ELEM),
+            };
+        }
+    }
+
+    if (!num_slices)
+        return false;
+
+    return stream_buf_upload(gpu, &p->cbuf, pass_p->cbv_slices, num_slices);
+}
+
+// Fills the constant buffer bindings for one stage from the slices uploaded
+// by `stream_cbvs`
+static void fill_streamed_cbvs(pl_gpu gpu, int num,
+                               const struct stream_buf_slice *slices,
+                               ID3D11Buffer **cbvs, UINT *first, UINT *count)
+{
+    struct pl_gpu_d3d11 *p = PL_PRIV(gpu);
+    for (int i = 0; i < num; i++) {
+        cbvs[i] = slices[i].size ? p->cbuf.buf : NULL;
+        first[i] = slices[i].offset / CBUF_ELEM;
+        count[i] = PL_ALIGN2(slices[i].size, p->cbuf.align) / CBUF_ELEM;
+    }
+}
+
 static void fill_resources(pl_gpu gpu, pl_pass pass,
                            struct d3d_pass_stage *pass_s,
                            const struct pl_pass_run_params *params,
-                           ID3D11Buffer **cbvs, ID3D11ShaderResourceView **srvs,
+                           bool streamed_cbvs, ID3D11Buffer **cbvs,
+                           ID3D11ShaderResourceView **srvs,
                            ID3D11SamplerState **samplers)
 {
     struct pl_gpu_d3d11 *p = PL_PRIV(gpu);
     struct pl_pass_d3d11 *pass_p = PL_PRIV(pass);
 
-    for (int i = 0; i < pass_s->cbvs.num; i++) {
+    for (int i = 0; !streamed_cbvs && i < pass_s->cbvs.num; i++) {
         int binding = pass_s->cbvs.elem[i];
         if (binding == HLSL_BINDING_NUM_WORKGROUPS) {
             cbvs[i] = pass_p->num_workgroups_buf;
@@ -1129,11 +1218,21 @@ static void pass_run_raster(pl_gpu gpu, const struct pl_pass_run_params *params)
     ID3D11SamplerState **samplers = pass_p->sampler_arr;
     ID3D11UnorderedAccessView **uavs = pass_p->uav_arr;
 
+    bool streamed = stream_cbvs(gpu, pass, params);
+    const struct stream_buf_slice *slices = pass_p->cbv_slices;
+    UINT *first = pass_p->cbv_first, *count = pass_p->cbv_count;
+
     // Set vertex shader resources. The device context is called conditionally
     // because the debug layer complains if these are called with 0 resources.
-    fill_resources(gpu, pass, &pass_p->vertex, params, cbvs, srvs, samplers);
-    if (pass_p->vertex.cbvs.num)
+    fill_resources(gpu, pass, &pass_p->vertex, params, streamed, cbvs, srvs, samplers);
+    if (pass_p->vertex.cbvs.num && streamed) {
+        fill_streamed_cbvs(gpu, pass_p->vertex.cbvs.num, slices, cbvs,
+                           first, count);
+        ID3D11DeviceContext1_VSSetConstantBuffers1(p->imm1, 0, pass_p->vertex.cbvs.num,
+                                                   cbvs, first, count);
+    } else if (pass_p->vertex.cbvs.num) {
         ID3D11DeviceContext_VSSetConstantBuffers(p->imm, 0, pass_p->vertex.cbvs.num, cbvs);
+    }
     if (pass_p->vertex.srvs.num)
         ID3D11DeviceContext_VSSetShaderResources(p->imm, 0, pass_p->vertex.srvs.num, srvs);
     if (pass_p->vertex.samplers.num)
@@ -1158,9 +1257,15 @@ static void pass_run_raster(pl_gpu gpu, const struct pl_pass_run_params *params)
     ID3D11DeviceContext_PSSetShader(p->imm, pass_p->ps, NULL, 0);
 
     // Set pixel shader resources
-    fill_resources(gpu, pass, &pass_p->main, params, cbvs, srvs, samplers);
-    if (pass_p->main.cbvs.num)
+    fill_resources(gpu, pass, &pass_p->main, params, streamed, cbvs, srvs, samplers);
+    if (pass_p->main.cbvs.num && streamed) {
+        fill_streamed_cbvs(gpu, pass_p->main.cbvs.num,
+                           slices + pass_p->vertex.cbvs.num, cbvs, first, count);
+        ID3D11DeviceContext1_PSSetConstantBuffers1(p->imm1, 0, pass_p->main.cbvs.num,
+                                                   cbvs, first, count);
+    } else if (pass_p->main.cbvs.num) {
         ID3D11DeviceContext_PSSetConstantBuffers(p->imm, 0, pass_p->main.cbvs.num, cbvs);
+    }
     if (pass_p->main.srvs.num)
         ID3D11DeviceContext_PSSetShaderResources(p->imm, 0, pass_p->main.srvs.num, srvs);
     if (pass_p->main.samplers.num)
@@ -1239,11 +1344,19 @@ static void pass_run_compute(pl_gpu gpu, const struct pl_pass_run_params *params
     ID3D11UnorderedAccessView **uavs = pass_p->uav_arr;
     ID3D11SamplerState **samplers = pass_p->sampler_arr;
 
-    fill_resources(gpu, pass, &pass_p->main, params, cbvs, srvs, samplers);
+    bool streamed = stream_cbvs(gpu, pass, params);
+    fill_resources(gpu, pass, &pass_p->main, params, streamed, cbvs, srvs, samplers);
     fill_uavs(pass, params, uavs);
 
-    if (pass_p->main.cbvs.num)
+    if (pass_p->main.cbvs.num && streamed) {
+        UINT *first = pass_p->cbv_first, *count = pass_p->cbv_count;
+        fill_streamed_cbvs(gpu, pass_p->main.cbvs.num, pass_p->cbv_slices,
+                           cbvs, first, count);
+        ID3D11DeviceContext1_CSSetConstantBuffers1(p->imm1, 0, pass_p->main.cbvs.num,
+                                                   cbvs, first, count);
+    } else if (pass_p->main.cbvs.num) {
         ID3D11DeviceContext_CSSetConstantBuffers(p->imm, 0, pass_p->main.cbvs.num, cbvs);
+    }
     if (pass_p->main.srvs.num)
         ID3D11DeviceContext_CSSetShaderResources(p->imm, 0, pass_p->main.srvs.num, srvs);
     if (pass_p->main.samplers.num)
@@ -20,6 +20,8 @@
 #include <math.h>
 
 #include "gpu.h"
+#include "pl_clock.h"
+#include "pl_thread.h"
 #include "swapchain.h"
 #include "utils.h"
 
@@ -94,6 +96,14 @@ struct priv {
 
     // Fallback to 8-bit RGB was triggered due to lack of compatiblity
     bool fallback_8bit_rgb;
+
+    // Frame latency waitable object, if low-latency mode is active
+    HANDLE latency_handle;
+
+    // Presentation timing feedback, from the DXGI frame statistics
+    pl_mutex timing_lock;
+    struct pl_sw_timing timing;
+    UINT last_present_count;
 };
 
 static void d3d11_sw_destroy(pl_swapchain sw)
@@ -101,7 +111,10 @@ static void d3d11_sw_destroy(pl_swapchain sw)
     struct priv *p = PL_PRIV(sw);
 
     pl_tex_destroy(sw->gpu, &p->backbuffer);
+    if (p->latency_handle)
+        CloseHandle(p->latency_handle);
     SAFE_RELEASE(p->swapchain);
+    pl_mutex_destroy(&p->timing_lock);
     pl_free((void *) sw);
 }
 
@@ -109,6 +122,8 @@ static int d3d11_sw_latency(pl_swapchain sw)
 {
     struct priv *p = PL_PRIV(sw);
     struct d3d11_ctx *ctx = p->ctx;
+    if (p->latency_handle)
+        return 1;
 
     UINT max_latency;
     IDXGIDevice1_GetMaximumFrameLatency(ctx->dxgi_dev, &max_latency);
@@ -134,7 +149,7 @@ error:
     return tex;
 }
 
-static bool d3d11_sw_resize(pl_swapchain sw, int *width, int *height)
+static bool resize_buffers(pl_swapchain sw, int *width, int *height)
 {
     struct priv *p = PL_PRIV(sw);
     struct d3d11_ctx *ctx = p->ctx;
@@ -188,6 +203,17 @@ error:
     return false;
 }
 
+static bool d3d11_sw_resize(pl_swapchain sw, int *width, int *height)
+{
+    struct priv *p = PL_PRIV(sw);
+
+    // ResizeBuffers implicitly uses the immediate context
+    pl_mutex_lock(&p->ctx->lock);
+    bool ok = resize_buffers(sw, width, height);
+    pl_mutex_unlock(&p->ctx->lock);
+    return ok;
+}
+
 static bool d3d11_sw_start_frame(pl_swapchain sw,
                                  struct pl_swapchain_frame *out_frame)
 {
@@ -208,6 +234,14 @@ static bool d3d11_sw_start_frame(pl_swapchain sw,
             return false;
     }
 
+    // Pace the frame start to the display, so that the frame is rendered
+    // from the most recent input possible
+    if (p->latency_handle) {
+        DWORD ret = WaitForSingleObjectEx(p->latency_handle, 1000, TRUE);
+        if (ret == WAIT_TIMEOUT)
+            PL_WARN(sw, "Timed out waiting for frame latency waitable object!");
+    }
+
     p->backbuffer = get_backbuffer(sw);
     if (!p->backbuffer)
         return false;
@@ -248,16 +282,46 @@ static bool d3d11_sw_submit_frame(pl_swapchain sw)
     return !ctx->is_failed;
 }
 
+static void poll_timing(struct priv *p)
+{
+    // Frame statistics are only available in some cases (e.g. flip model or
+    // exclusive fullscreen), and may fail sporadically with
+    // DXGI_ERROR_FRAME_STATISTICS_DISJOINT, so just ignore any errors
+    DXGI_FRAME_STATISTICS stats;
+    if (FAILED(IDXGISwapChain_GetFrameStatistics(p->swapchain, &stats)))
+        return;
+    if (!stats.PresentCount || stats.PresentCount == p->last_present_count)
+        return;
+
+    p->last_present_count = stats.PresentCount;
+    pl_mutex_lock(&p->timing_lock);
+    pl_sw_timing_push(&p->timing, pl_clock_diff(stats.SyncQPCTime.QuadPart, 0),
+                      stats.SyncRefreshCount);
+    pl_mutex_unlock(&p->timing_lock);
+}
+
 static void d3d11_sw_swap_buffers(pl_swapchain sw)
 {
     struct priv *p = PL_PRIV(sw);
     struct d3d11_ctx *ctx = p->ctx;
 
-    // Present can fail with a device removed error
+    // Present implicitly uses the immediate context, and can fail with a
+    // device removed error
+    pl_mutex_lock(&ctx->lock);
     D3D(IDXGISwapChain_Present(p->swapchain, 1, 0));
+    poll_timing(p);
 
 error:
-    return;
+    pl_mutex_unlock(&ctx->lock);
+}
+
+static bool d3d11_sw_get_timing(pl_swapchain sw, struct pl_swapchain_timing *out)
+{
+    struct priv *p = PL_PRIV(sw);
+    pl_mutex_lock(&p->timing_lock);
+    bool ok = pl_sw_timing_get(&p->timing, pl_clock_diff(pl_clock_now(), 0), out);
+    pl_mutex_unlock(&p->timing_lock);
+    return ok;
 }
 
 static DXGI_HDR_METADATA_HDR10 set_hdr10_metadata(const struct pl_hdr_metadata *hdr)
@@ -439,6 +503,7 @@ static const struct pl_sw_fns d3d11_swapchain = {
     .start_frame     = d3d11_sw_start_frame,
     .submit_frame    = d3d11_sw_submit_frame,
     .swap_buffers    = d3d11_sw_swap_buffers,
+    .get_timing      = d3d11_sw_get_timing,
 };
 
 static HRESULT create_swapchain_1_2(struct d3d11_ctx *ctx,
@@ -462,6 +527,9 @@ static HRESULT create_swapchain_1_2(struct d3d11_ctx *ctx,
     if (ID3D11Device_GetFeatureLevel(ctx->dev) >= D3D_FEATURE_LEVEL_11_0)
         desc.BufferUsage |= DXGI_USAGE_UNORDERED_ACCESS;
 
+    if (flip && params->low_latency)
+        desc.Flags |= DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+
     if (flip) {
         UINT max_latency;
         IDXGIDevice1_GetMaximumFrameLatency(ctx->dxgi_dev, &max_latency);
@@ -632,7 +700,9 @@ pl_swapchain pl_d3d11_create_swapchain(pl_d3d11 d3d11,
                  DXGI_FORMAT_R10G10B10A2_UNORM : DXGI_FORMAT_R8G8B8A8_UNORM),
         },
         .disable_10bit_sdr = params->disable_10bit_sdr,
+        .timing.last_count = -1,
     };
+    pl_mutex_init(&p->timing_lock);
 
     if (params->swapchain) {
         p->swapchain = params->swapchain;
@@ -654,6 +724,25 @@ pl_swapchain pl_d3d11_create_swapchain(pl_d3d11 d3d11,
 
     p->csp_map.d3d11_fmt = scd.BufferDesc.Format;
 
+    if (scd.Flags & DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT) {
+        IDXGISwapChain2 *swapchain2 = NULL;
+        HRESULT hr = IDXGISwapChain_QueryInterface(p->swapchain,
+            &IID_IDXGISwapChain2, (void **) &swapchain2);
+        if (SUCCEEDED(hr)) {
+            hr = IDXGISwapChain2_SetMaximumFrameLatency(swapchain2, 1);
+            if (SUCCEEDED(hr))
+                p->latency_handle = IDXGISwapChain2_GetFrameLatencyWaitableObject(swapchain2);
+            SAFE_RELEASE(swapchain2);
+        }
+
+        if (p->latency_handle) {
+            PL_INFO(gpu, "Using frame latency waitable object");
+        } else {
+            PL_WARN(gpu, "Failed enabling frame latency waitable object: %s",
+                    pl_hresult_to_str(hr));
+        }
+    }
+
     update_swapchain_color_config(sw, &pl_color_space_unknown, true);
 
     success = true;
@@ -86,14 +86,9 @@ static enum pl_log_level log_level_override(unsigned int id)
         return PL_LOG_NONE;
     }
 }
-#endif
 
-void pl_d3d11_flush_message_queue(struct d3d11_ctx *ctx, const char *header)
+static void flush_message_queue(struct d3d11_ctx *ctx, const char *header)
 {
-#ifdef PL_HAVE_DXGI_DEBUG
-    if (!ctx->iqueue)
-        return;
-
     static const enum pl_log_level severity_map[] = {
         [DXGI_INFO_QUEUE_MESSAGE_SEVERITY_CORRUPTION] = PL_LOG_FATAL,
         [DXGI_INFO_QUEUE_MESSAGE_SEVERITY_ERROR]      = PL_LOG_ERR,
@@ -167,6 +162,18 @@ void pl_d3d11_flush_message_queue(struct d3d11_ctx *ctx, const char *header)
 
 error:
     IDXGIInfoQueue_ClearStoredMessages(ctx->iqueue, DXGI_DEBUG_ALL);
+}
+#endif
+
+void pl_d3d11_flush_message_queue(struct d3d11_ctx *ctx, const char *header)
+{
+#ifdef PL_HAVE_DXGI_DEBUG
+    if (!ctx->iqueue)
+        return;
+
+    pl_mutex_lock(&ctx->lock);
+    flush_message_queue(ctx, header);
+    pl_mutex_unlock(&ctx->lock);
 #endif
 }
 
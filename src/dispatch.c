@@ -27,6 +27,17 @@
 #define MAX_PASSES 100
 #define MIN_AGE 10
 
+// Upper bound on the number of precompilation worker threads
+#define MAX_WORKERS 32
+
+// Maximum number of memoized shader fingerprints, see `shader_fingerprint`
+#define MAX_MEMO 4096
+
+// Maximum number of uniform buffers to rotate between per pass, see
+// `flush_pass_ubo`. Inside batches, the ring may grow up to MAX_BATCH_UBOS
+#define MAX_UBOS 4
+#define MAX_BATCH_UBOS 16
+
 enum {
     TMP_PRELUDE,   // GLSL version, global definitions, etc.
     TMP_MAIN,      // main GLSL shader body
@@ -35,25 +46,80 @@ enum {
     TMP_COUNT,
 };
 
+// Compiled pass shared between all dispatch objects attached to a pool
+struct pool_entry {
+    uint64_t signature;
+    pl_pass pass;
+    int refs;
+    bool ready; // finished compiling
+};
+
+struct pl_dispatch_pool_t {
+    pl_mutex lock;
+    pl_cond ready_cond;
+    pl_log log;
+    pl_gpu gpu;
+    PL_ARRAY(struct pool_entry *) entries;
+};
+
 struct pl_dispatch_t {
     pl_mutex lock;
     pl_log log;
     pl_gpu gpu;
+    pl_dispatch_pool pool; // optional
     uint8_t current_ident;
     uint8_t current_index;
     bool dynamic_constants;
+    bool low_precision;
+    bool fast_transfer;
     int max_passes;
+    int timer_interval;                         // see `pl_dispatch_set_timer_interval`
+    uint64_t num_frames;                        // number of `pl_dispatch_reset_frame` calls
 
     void (*info_callback)(void *, const struct pl_dispatch_info *);
     void *info_priv;
 
     PL_ARRAY(pl_shader) shaders;                // to avoid re-allocations
-    PL_ARRAY(struct pass *) passes;             // compiled passes
+
+    // compiled passes, indexed by signature and kept in LRU order
+    struct pass **buckets;
+    int num_buckets;                            // power of two
+    int num_passes;
+    struct pass *lru_head;                      // least recently used
+    struct pass *lru_tail;                      // most recently used
+
+    // maps shader fingerprints to pass signatures (open addressing)
+    struct memo_entry *memo;
+    int memo_size;                              // power of two
+    int memo_num;
 
     // temporary buffers to help avoid re_allocations during pass creation
     PL_ARRAY(const struct pl_buffer_var *) buf_tmp;
     pl_str_builder tmp[TMP_COUNT];
-    uint8_t *ubo_tmp;
+    struct pass *spare_pass;                    // recycled by `reuse_pass`
+
+    // background compilation state, see `pl_dispatch_precompile_begin`
+    // and `pl_dispatch_set_async`
+    bool precompile;
+    bool precompile_failed;
+    bool async;
+    uint64_t num_deferred;
+    uint64_t num_compiled;
+
+    // see `pl_dispatch_batch_begin`
+    bool batch;
+    uint64_t batch_id;
+    bool workers_quit;
+    pl_cond pending_cond;            // signalled when a pass is queued
+    pl_cond done_cond;               // signalled when a pass was compiled
+    pl_thread workers[MAX_WORKERS];
+    int num_workers;
+    PL_ARRAY(struct pass *) pending; // passes waiting for / being compiled
+};
+
+struct memo_entry {
+    uint64_t fingerprint; // 0 for empty slots
+    uint64_t signature;
 };
 
 enum pass_var_type {
@@ -76,6 +142,9 @@ struct pass {
     pl_pass pass;
     int last_index;
 
+    struct pass *hash_next;             // next pass in the same bucket
+    struct pass *lru_prev, *lru_next;   // neighbours in LRU order
+
     // contains cached data and update metadata, same order as pl_shader
     struct pass_var *vars;
     int num_var_locs;
@@ -83,7 +152,20 @@ struct pass {
     // for uniform buffer updates
     struct pl_shader_desc ubo_desc; // temporary
     int ubo_index;
-    pl_buf ubo;
+    size_t ubo_size;
+    uint8_t *ubo_data;      // host copy of the UBO contents
+    bool ubo_dirty;         // `ubo_data` was modified since the last upload
+    pl_buf ubos[MAX_BATCH_UBOS]; // ring of uniform buffers, see `flush_pass_ubo`
+    int num_ubos;
+    int ubo_idx;            // index of the most recently uploaded buffer
+    uint64_t batch_id;      // last batch this pass was dispatched in
+    int batch_ubos;         // number of distinct buffers bound in this batch
+
+    // pass parameters, while waiting for compilation by a worker thread
+    struct pl_pass_params *pending;
+    bool compiling; // picked up by a worker thread
+    bool compiled;  // finished compiling, waiting for `collect_pending`
+    bool pool_ref;  // `pass` is a reference owned by `dp->pool`
 
     // Cached pl_pass_run_params. This will also contain mutable allocations
     // for the push constants, descriptor bindings (including the binding for
@@ -97,23 +179,350 @@ struct pass {
     uint64_t ts_sum;
     uint64_t samples[PL_ARRAY_SIZE(((struct pl_dispatch_info *) NULL)->samples)];
     int ts_idx;
+
+    // CPU submission times of outstanding timer queries, for `pl_trace_gpu`
+    pl_clock_t ts_cpu[8];
+    unsigned ts_cpu_head, ts_cpu_tail;
 };
 
+pl_dispatch_pool pl_dispatch_pool_create(pl_log log, pl_gpu gpu)
+{
+    struct pl_dispatch_pool_t *pool = pl_zalloc_ptr(NULL, pool);
+    pl_mutex_init(&pool->lock);
+    pl_cond_init(&pool->ready_cond);
+    pool->log = log;
+    pool->gpu = gpu;
+    return pool;
+}
+
+void pl_dispatch_pool_destroy(pl_dispatch_pool *ptr)
+{
+    pl_dispatch_pool pool = *ptr;
+    if (!pool)
+        return;
+
+    if (pool->entries.num) {
+        PL_ERR(pool, "Destroying dispatch pool with %d passes still in use!",
+               pool->entries.num);
+    }
+
+    for (int i = 0; i < pool->entries.num; i++)
+        pl_pass_destroy(pool->gpu, &pool->entries.elem[i]->pass);
+    pl_cond_destroy(&pool->ready_cond);
+    pl_mutex_destroy(&pool->lock);
+    pl_free(pool);
+    *ptr = NULL;
+}
+
+// Returns a reference to the compiled pass with the given signature, compiling
+// it if needed. If another dispatch is currently compiling the same pass,
+// this blocks until it's done.
+static pl_pass pool_acquire(pl_dispatch_pool pool, uint64_t signature,
+                            const struct pl_pass_params *params)
+{
+    pl_mutex_lock(&pool->lock);
+    for (int i = 0; i < pool->entries.num; i++) {
+        struct pool_entry *e = pool->entries.elem[i];
+        if (e->signature != signature)
+            continue;
+
+        e->refs++;
+        while (!e->ready)
+            pl_cond_wait(&pool->ready_cond, &pool->lock);
+        pl_mutex_unlock(&pool->lock);
+        return e->pass;
+    }
+
+    struct pool_entry *e = pl_alloc_ptr(pool, e);
+    *e = (struct pool_entry) {
+        .signature = signature,
+        .refs = 1,
+    };
+    PL_ARRAY_APPEND(pool, pool->entries, e);
+    pl_mutex_unlock(&pool->lock);
+
+    pl_pass pass = pl_pass_create(pool->gpu, params);
+
+    pl_mutex_lock(&pool->lock);
+    e->pass = pass;
+    e->ready = true;
+    pl_cond_broadcast(&pool->ready_cond);
+    pl_mutex_unlock(&pool->lock);
+    return pass;
+}
+
+static void pool_release(pl_dispatch_pool pool, uint64_t signature)
+{
+    pl_mutex_lock(&pool->lock);
+    for (int i = 0; i < pool->entries.num; i++) {
+        struct pool_entry *e = pool->entries.elem[i];
+        if (e->signature != signature)
+            continue;
+
+        pl_assert(e->refs > 0);
+        if (--e->refs == 0) {
+            pl_pass_destroy(pool->gpu, &e->pass);
+            PL_ARRAY_REMOVE_AT(pool->entries, i);
+            pl_free(e);
+        }
+        break;
+    }
+    pl_mutex_unlock(&pool->lock);
+}
+
+static pl_pass pass_compile(pl_dispatch dp, uint64_t signature,
+                            const struct pl_pass_params *params)
+{
+    if (dp->pool)
+        return pool_acquire(dp->pool, signature, params);
+    return pl_pass_create(dp->gpu, params);
+}
+
 static void pass_destroy(pl_dispatch dp, struct pass *pass)
 {
     if (!pass)
         return;
 
-    pl_buf_destroy(dp->gpu, &pass->ubo);
+    for (int i = 0; i < pass->num_ubos; i++)
+        pl_buf_destroy(dp->gpu, &pass->ubos[i]);
+    if (pass->pool_ref) {
+        pool_release(dp->pool, pass->signature);
+        pass->pass = NULL;
+    }
     pl_pass_destroy(dp->gpu, &pass->pass);
     pl_timer_destroy(dp->gpu, &pass->timer);
     pl_free(pass);
 }
 
+static inline struct pass **pass_bucket(pl_dispatch dp, uint64_t signature)
+{
+    return &dp->buckets[signature & (dp->num_buckets - 1)];
+}
+
+static struct pass *pass_lookup(pl_dispatch dp, uint64_t signature)
+{
+    if (!dp->num_buckets)
+        return NULL;
+
+    for (struct pass *p = *pass_bucket(dp, signature); p; p = p->hash_next) {
+        if (p->signature == signature)
+            return p;
+    }
+
+    return NULL;
+}
+
+static void lru_unlink(pl_dispatch dp, struct pass *pass)
+{
+    if (pass->lru_prev) {
+        pass->lru_prev->lru_next = pass->lru_next;
+    } else {
+        dp->lru_head = pass->lru_next;
+    }
+
+    if (pass->lru_next) {
+        pass->lru_next->lru_prev = pass->lru_prev;
+    } else {
+        dp->lru_tail = pass->lru_prev;
+    }
+
+    pass->lru_prev = pass->lru_next = NULL;
+}
+
+static void lru_append(pl_dispatch dp, struct pass *pass)
+{
+    pass->lru_prev = dp->lru_tail;
+    pass->lru_next = NULL;
+    if (dp->lru_tail) {
+        dp->lru_tail->lru_next = pass;
+    } else {
+        dp->lru_head = pass;
+    }
+    dp->lru_tail = pass;
+}
+
+// Marks a pass as used in the current frame
+static void pass_touch(pl_dispatch dp, struct pass *pass)
+{
+    pass->last_index = dp->current_index;
+    if (pass != dp->lru_tail) {
+        lru_unlink(dp, pass);
+        lru_append(dp, pass);
+    }
+}
+
+static void pass_insert(pl_dispatch dp, struct pass *pass)
+{
+    if (dp->num_passes >= dp->num_buckets) {
+        // Grow the hash table to keep the chains short
+        int num_buckets = PL_MAX(dp->num_buckets * 2, 64);
+        struct pass **buckets = pl_calloc_ptr(dp, num_buckets, buckets);
+        for (int i = 0; i < dp->num_buckets; i++) {
+            struct pass *p = dp->buckets[i];
+            while (p) {
+                struct pass *next = p->hash_next;
+                struct pass **b = &buckets[p->signature & (num_buckets - 1)];
+                p->hash_next = *b;
+                *b = p;
+                p = next;
+            }
+        }
+
+        pl_free(dp->buckets);
+        dp->buckets = buckets;
+        dp->num_buckets = num_buckets;
+    }
+
+    struct pass **b = pass_bucket(dp, pass->signature);
+    pass->hash_next = *b;
+    *b = pass;
+    lru_append(dp, pass);
+    dp->num_passes++;
+}
+
+static void pass_remove(pl_dispatch dp, struct pass *pass)
+{
+    struct pass **b = pass_bucket(dp, pass->signature);
+    while (*b != pass)
+        b = &(*b)->hash_next;
+    *b = pass->hash_next;
+    lru_unlink(dp, pass);
+    dp->num_passes--;
+}
+
+// Finishes setting up a pass after `pass->pass` was created
+static bool pass_create_ubo(pl_dispatch dp, struct pass *pass)
+{
+    pass->run_params.pass = pass->pass;
+    if (!pass->ubo_size || !pass->pass)
+        return true;
+
+    pass->ubos[0] = pl_buf_create(dp->gpu, pl_buf_params(
+        .size = pass->ubo_size,
+        .uniform = true,
+        .host_writable = true,
+    ));
+
+    if (!pass->ubos[0]) {
+        PL_ERR(dp, "Failed creating uniform buffer for dispatch");
+        return false;
+    }
+
+    pass->ubo_data = pl_zalloc(pass, pass->ubo_size);
+    pass->num_ubos = 1;
+    pass->ubo_idx = 0;
+    return true;
+}
+
+// Moves all passes finished compiling into the pass cache. Must be called
+// with `dp->lock` held.
+static void collect_pending(pl_dispatch dp)
+{
+    for (int i = 0; i < dp->pending.num; i++) {
+        struct pass *pass = dp->pending.elem[i];
+        if (!pass->compiled)
+            continue;
+
+        PL_ARRAY_REMOVE_AT(dp->pending, i--);
+        pl_free_ptr(&pass->pending);
+        if (!pass->pass) {
+            PL_ERR(dp, "Failed creating render pass for dispatch");
+            dp->precompile_failed = true;
+            // Add it anyway
+        }
+
+        if (!pass_create_ubo(dp, pass)) {
+            dp->precompile_failed = true;
+            pass_destroy(dp, pass);
+            continue;
+        }
+
+        pass_insert(dp, pass);
+    }
+}
+
+static PL_THREAD_VOID compile_worker(void *arg)
+{
+    pl_dispatch dp = arg;
+    pl_mutex_lock(&dp->lock);
+    for (;;) {
+        struct pass *pass = NULL;
+        for (int i = 0; i < dp->pending.num; i++) {
+            if (!dp->pending.elem[i]->compiling) {
+                pass = dp->pending.elem[i];
+                break;
+            }
+        }
+
+        if (pass) {
+            pass->compiling = true;
+            pl_mutex_unlock(&dp->lock);
+            pl_pass ppass = pass_compile(dp, pass->signature, pass->pending);
+            pl_mutex_lock(&dp->lock);
+            pass->pass = ppass;
+            pass->pool_ref = dp->pool;
+            pass->compiled = true;
+            pl_cond_broadcast(&dp->done_cond);
+            continue;
+        }
+
+        if (dp->workers_quit)
+            break;
+        pl_cond_wait(&dp->pending_cond, &dp->lock);
+    }
+    pl_mutex_unlock(&dp->lock);
+    PL_THREAD_RETURN();
+}
+
+// Ensures at least `num` worker threads are running. Must be called with
+// `dp->lock` held.
+static void workers_start(pl_dispatch dp, int num)
+{
+    if (!dp->gpu->limits.thread_safe)
+        return;
+
+    num = PL_MIN(num, MAX_WORKERS);
+    while (dp->num_workers < num) {
+        pl_thread *thread = &dp->workers[dp->num_workers];
+        if (pl_thread_create(thread, compile_worker, dp) != 0) {
+            PL_WARN(dp, "Failed creating compilation thread, compiling "
+                    "with %d threads", dp->num_workers);
+            break;
+        }
+        dp->num_workers++;
+    }
+}
+
+// Stops all worker threads, after all queued passes were compiled. Must be
+// called with `dp->lock` held.
+static void workers_stop(pl_dispatch dp)
+{
+    if (!dp->num_workers)
+        return;
+
+    dp->workers_quit = true;
+    pl_cond_broadcast(&dp->pending_cond);
+    pl_mutex_unlock(&dp->lock);
+    for (int i = 0; i < dp->num_workers; i++)
+        pl_thread_join(dp->workers[i]);
+    pl_mutex_lock(&dp->lock);
+    dp->workers_quit = false;
+    dp->num_workers = 0;
+}
+
+pl_dispatch pl_dispatch_create_shared(pl_dispatch_pool pool)
+{
+    pl_dispatch dp = pl_dispatch_create(pool->log, pool->gpu);
+    dp->pool = pool;
+    return dp;
+}
+
 pl_dispatch pl_dispatch_create(pl_log log, pl_gpu gpu)
 {
     struct pl_dispatch_t *dp = pl_zalloc_ptr(NULL, dp);
     pl_mutex_init(&dp->lock);
+    pl_cond_init(&dp->pending_cond);
+    pl_cond_init(&dp->done_cond);
     dp->log = log;
     dp->gpu = gpu;
     dp->max_passes = MAX_PASSES;
@@ -129,11 +538,21 @@ void pl_dispatch_destroy(pl_dispatch *ptr)
     if (!dp)
         return;
 
-    for (int i = 0; i < dp->passes.num; i++)
-        pass_destroy(dp, dp->passes.elem[i]);
+    pl_mutex_lock(&dp->lock);
+    workers_stop(dp);
+    collect_pending(dp);
+    pl_mutex_unlock(&dp->lock);
+
+    while (dp->lru_head) {
+        struct pass *pass = dp->lru_head;
+        lru_unlink(dp, pass);
+        pass_destroy(dp, pass);
+    }
     for (int i = 0; i < dp->shaders.num; i++)
         pl_shader_free(&dp->shaders.elem[i]);
 
+    pl_cond_destroy(&dp->pending_cond);
+    pl_cond_destroy(&dp->done_cond);
     pl_mutex_destroy(&dp->lock);
     pl_free(dp);
     *ptr = NULL;
@@ -141,6 +560,7 @@ void pl_dispatch_destroy(pl_dispatch *ptr)
 
 pl_shader pl_dispatch_begin_ex(pl_dispatch dp, bool unique)
 {
+    PL_ALLOC_SCOPE(DISPATCH);
     pl_mutex_lock(&dp->lock);
 
     struct pl_shader_params params = {
@@ -148,6 +568,8 @@ pl_shader pl_dispatch_begin_ex(pl_dispatch dp, bool unique)
         .gpu = dp->gpu,
         .index = dp->current_index,
         .dynamic_constants = dp->dynamic_constants,
+        .low_precision = dp->low_precision,
+        .fast_transfer = dp->fast_transfer,
     };
 
     pl_shader sh = NULL;
@@ -167,6 +589,16 @@ void pl_dispatch_mark_dynamic(pl_dispatch dp, bool dynamic)
     dp->dynamic_constants = dynamic;
 }
 
+void pl_dispatch_mark_low_precision(pl_dispatch dp, bool low_precision)
+{
+    dp->low_precision = low_precision;
+}
+
+void pl_dispatch_mark_fast_transfer(pl_dispatch dp, bool fast_transfer)
+{
+    dp->fast_transfer = fast_transfer;
+}
+
 void pl_dispatch_callback(pl_dispatch dp, void *priv,
                           void (*cb)(void *priv, const struct pl_dispatch_info *))
 {
@@ -697,29 +1129,21 @@ static void generate_shaders(pl_dispatch dp,
 
 #define pass_age(pass) (dp->current_index - (pass)->last_index)
 
-static int cmp_pass_age(const void *ptra, const void *ptrb)
-{
-    const struct pass *a = *(const struct pass **) ptra;
-    const struct pass *b = *(const struct pass **) ptrb;
-    return b->last_index - a->last_index;
-}
-
 static void garbage_collect_passes(pl_dispatch dp)
 {
-    if (dp->passes.num <= dp->max_passes)
+    if (dp->num_passes <= dp->max_passes)
         return;
 
-    // Garbage collect oldest passes, starting at the middle
-    qsort(dp->passes.elem, dp->passes.num, sizeof(struct pass *), cmp_pass_age);
-    int idx = dp->passes.num / 2;
-    while (idx < dp->passes.num && pass_age(dp->passes.elem[idx]) < MIN_AGE)
-        idx++;
-
-    for (int i = idx; i < dp->passes.num; i++)
-        pass_destroy(dp, dp->passes.elem[i]);
-
-    int num_evicted = dp->passes.num - idx;
-    dp->passes.num = idx;
+    // Garbage collect the least recently used passes, down to half the limit
+    int num_evicted = 0;
+    while (dp->num_passes > dp->max_passes / 2) {
+        struct pass *pass = dp->lru_head;
+        if (pass_age(pass) < MIN_AGE)
+            break;
+        pass_remove(dp, pass);
+        pass_destroy(dp, pass);
+        num_evicted++;
+    }
 
     if (num_evicted) {
         PL_DEBUG(dp, "Evicted %d passes from dispatch cache, consider "
@@ -729,13 +1153,206 @@ static void garbage_collect_passes(pl_dispatch dp)
     }
 }
 
+static const uint64_t *memo_lookup(pl_dispatch dp, uint64_t fingerprint)
+{
+    if (!dp->memo_size)
+        return NULL;
+
+    int mask = dp->memo_size - 1;
+    for (int i = fingerprint & mask;; i = (i + 1) & mask) {
+        const struct memo_entry *e = &dp->memo[i];
+        if (e->fingerprint == fingerprint)
+            return &e->signature;
+        if (!e->fingerprint)
+            return NULL;
+    }
+}
+
+static void memo_insert(pl_dispatch dp, uint64_t fingerprint, uint64_t signature)
+{
+    if ((dp->memo_num + 1) * 2 > dp->memo_size) {
+        struct memo_entry *old = dp->memo;
+        int old_size = dp->memo_size;
+        if (old_size >= MAX_MEMO) {
+            // Simply start over, rather than tracking entry ages
+            PL_TRACE(dp, "Flushing shader fingerprint cache");
+            memset(dp->memo, 0, old_size * sizeof(dp->memo[0]));
+            dp->memo_num = 0;
+            old_size = 0;
+        } else {
+            dp->memo_size = PL_MAX(old_size * 2, 64);
+            dp->memo = pl_calloc_ptr(dp, dp->memo_size, dp->memo);
+            dp->memo_num = 0;
+        }
+
+        for (int i = 0; i < old_size; i++) {
+            if (old[i].fingerprint)
+                memo_insert(dp, old[i].fingerprint, old[i].signature);
+        }
+        if (old != dp->memo)
+            pl_free(old);
+    }
+
+    int mask = dp->memo_size - 1;
+    for (int i = fingerprint & mask;; i = (i + 1) & mask) {
+        struct memo_entry *e = &dp->memo[i];
+        if (e->fingerprint == fingerprint) {
+            e->signature = signature;
+            return;
+        } else if (!e->fingerprint) {
+            *e = (struct memo_entry) { fingerprint, signature };
+            dp->memo_num++;
+            return;
+        }
+    }
+}
+
+// Computes a hash of everything that `generate_shaders` depends on, except
+// for the raster state already hashed into `signature`. This is used to
+// memoize the final pass signature, so that passes can be re-used without
+// re-running the variable placement and shader generation.
+static uint64_t shader_fingerprint(const pl_shader sh, uint64_t signature,
+                                   const struct generate_params *params)
+{
+    uint64_t hash = signature;
+    pl_hash_merge(&hash, (uint64_t) params->pass_params->type);
+    pl_hash_merge(&hash, (uint64_t) params->vert_idx);
+    pl_hash_merge(&hash, (uint64_t) params->out_mat << 16 | params->out_off);
+    for (int i = 0; i < SH_BUF_COUNT; i++)
+        pl_hash_merge(&hash, pl_str_builder_hash(sh->buffers[i]));
+
+    pl_hash_merge(&hash, (uint64_t) sh->name << 32 | (uint64_t) sh->prefix << 16 | sh->fresh);
+    pl_hash_merge(&hash, (uint64_t) sh->input << 32 | sh->output);
+    pl_hash_merge(&hash, (uint64_t) sh->sampler_type << 8 | sh->sampler_prefix);
+    pl_hash_merge(&hash, (uint64_t) sh->group_size[0] << 32 | sh->group_size[1]);
+
+#define HASH_VAR(v)                                                             \
+    do {                                                                        \
+        pl_hash_merge(&hash, (uintptr_t) (v).name);                             \
+        pl_hash_merge(&hash, (uint64_t) (v).type << 48 |                        \
+                             (uint64_t) (v).dim_v << 32 |                       \
+                             (uint64_t) (v).dim_m << 16 | (v).dim_a);           \
+    } while (0)
+
+    for (int i = 0; i < sh->vas.num; i++) {
+        const struct pl_vertex_attrib *va = &sh->vas.elem[i].attr;
+        pl_hash_merge(&hash, (uintptr_t) va->name);
+        pl_hash_merge(&hash, (uintptr_t) va->fmt);
+    }
+
+    for (int i = 0; i < sh->vars.num; i++) {
+        HASH_VAR(sh->vars.elem[i].var);
+        pl_hash_merge(&hash, sh->vars.elem[i].dynamic);
+    }
+
+    for (int i = 0; i < sh->descs.num; i++) {
+        const struct pl_shader_desc *sd = &sh->descs.elem[i];
+        pl_hash_merge(&hash, (uintptr_t) sd->desc.name);
+        pl_hash_merge(&hash, (uint64_t) sd->desc.type << 32 | sd->desc.access << 16 |
+                             sd->memory);
+
+        switch (sd->desc.type) {
+        case PL_DESC_SAMPLED_TEX:
+        case PL_DESC_STORAGE_IMG: {
+            pl_tex tex = sd->binding.object;
+            pl_hash_merge(&hash, (uintptr_t) tex->params.format);
+            pl_hash_merge(&hash, (uint64_t) tex->sampler_type << 8 |
+                                 pl_tex_params_dimension(tex->params));
+            break;
+        }
+        case PL_DESC_BUF_TEXEL_UNIFORM:
+        case PL_DESC_BUF_TEXEL_STORAGE: {
+            pl_buf buf = sd->binding.object;
+            pl_hash_merge(&hash, (uintptr_t) buf->params.format);
+            break;
+        }
+        case PL_DESC_BUF_UNIFORM:
+        case PL_DESC_BUF_STORAGE:
+            break;
+        case PL_DESC_INVALID:
+        case PL_DESC_TYPE_COUNT:
+            pl_unreachable();
+        }
+
+        for (int j = 0; j < sd->num_buffer_vars; j++) {
+            const struct pl_buffer_var *bv = &sd->buffer_vars[j];
+            HASH_VAR(bv->var);
+            pl_hash_merge(&hash, bv->layout.offset);
+            pl_hash_merge(&hash, bv->layout.stride);
+            pl_hash_merge(&hash, bv->layout.size);
+        }
+    }
+
+    for (int i = 0; i < sh->consts.num; i++) {
+        pl_hash_merge(&hash, (uintptr_t) sh->consts.elem[i].name);
+        pl_hash_merge(&hash, sh->consts.elem[i].type);
+    }
+
+#undef HASH_VAR
+
+    return PL_DEF(hash, 1); // 0 is reserved for empty slots
+}
+
+// Looks up an existing (or currently compiling) pass by signature
+static struct pass *find_pass(pl_dispatch dp, uint64_t signature)
+{
+    collect_pending(dp);
+    for (int i = 0; i < dp->pending.num; i++) {
+        struct pass *p = dp->pending.elem[i];
+        if (p->signature != signature)
+            continue;
+
+        if (dp->precompile || dp->async)
+            return p;
+
+        // Synchronous dispatch, block until the pass is ready
+        while (!p->compiled)
+            pl_cond_wait(&dp->done_cond, &dp->lock);
+        collect_pending(dp);
+        break;
+    }
+
+    return pass_lookup(dp, signature);
+}
+
+// Re-uses an existing pass `p` for `sh`, recycling the temporary `pass`
+static struct pass *reuse_pass(pl_dispatch dp, pl_shader sh, struct pass *p,
+                               struct pass *pass, const uint8_t *constant_data,
+                               size_t constant_size)
+{
+    pl_free_children(pass);
+    dp->spare_pass = pass;
+
+    if (p->pending) {
+        // Still compiling; and the worker thread is using the constant
+        // data, so leave it alone
+        p->last_index = dp->current_index;
+        return p;
+    }
+
+    if (p->num_ubos)
+        sh->descs.elem[p->ubo_index].binding.object = p->ubos[p->ubo_idx];
+    if (constant_size) {
+        // Same signature implies the same constant layout
+        if (!p->run_params.constant_data)
+            p->run_params.constant_data = pl_alloc(p, constant_size);
+        memcpy(p->run_params.constant_data, constant_data, constant_size);
+    }
+    pass_touch(dp, p);
+    return p;
+}
+
 static struct pass *finalize_pass(pl_dispatch dp, pl_shader sh,
                                   pl_tex target, int vert_idx,
                                   const struct pl_blend_params *blend, bool load,
                                   const struct pl_dispatch_vertex_params *vparams,
                                   const pl_transform2x2 *proj)
 {
-    struct pass *pass = pl_alloc_ptr(dp, pass);
+    PL_TRACE_ZONE(dp->log, FINALIZE_PASS);
+    struct pass *pass = dp->spare_pass;
+    if (!pass)
+        pass = pl_alloc_ptr(dp, pass);
+    dp->spare_pass = NULL;
     *pass = (struct pass) {
         .signature = 0x0, // updated incrementally below
         .last_index = dp->current_index,
@@ -826,6 +1443,7 @@ static struct pass *finalize_pass(pl_dispatch dp, pl_shader sh,
 
     // Place all of the compile-time constants
     uint8_t *constant_data = NULL;
+    size_t constant_size = 0;
     if (sh->consts.num) {
         params.num_constants = sh->consts.num;
         params.constants = pl_alloc(tmp, sh->consts.num * sizeof(struct pl_constant));
@@ -843,7 +1461,8 @@ static struct pass *finalize_pass(pl_dispatch dp, pl_shader sh,
         }
 
         // Write values into the constants buffer
-        params.constant_data = constant_data = pl_alloc(pass, total_size);
+        constant_size = total_size;
+        constant_data = pl_alloc(tmp, total_size);
         for (int i = 0; i < sh->consts.num; i++) {
             const struct pl_shader_const *sc = &sh->consts.elem[i];
             void *data = constant_data + params.constants[i].offset;
@@ -851,6 +1470,21 @@ static struct pass *finalize_pass(pl_dispatch dp, pl_shader sh,
         }
     }
 
+    // Try re-using the signature from a previous invocation of this shader,
+    // which saves us from having to go through the rest of this function
+    uint64_t fingerprint = shader_fingerprint(sh, pass->signature, &gen_params);
+    const uint64_t *memo_sig = memo_lookup(dp, fingerprint);
+    struct pass *memo_pass = memo_sig ? find_pass(dp, *memo_sig) : NULL;
+    if (memo_pass) {
+        if (memo_pass->ubo_size) {
+            pl_assert(memo_pass->ubo_index == sh->descs.num);
+            PL_ARRAY_APPEND(sh, sh->descs, pass->ubo_desc);
+        }
+
+        sh_finalize_info(sh);
+        return reuse_pass(dp, sh, memo_pass, pass, constant_data, constant_size);
+    }
+
     // Place all the variables; these will dynamically end up in different
     // locations based on what the underlying GPU supports (UBOs, pushc, etc.)
     //
@@ -887,29 +1521,25 @@ static struct pass *finalize_pass(pl_dispatch dp, pl_shader sh,
 
     // Finalize the shader and look it up in the pass cache
     pl_str_builder vert_builder = NULL, glsl_builder = NULL;
+    pl_clock_t start = pl_clock_now();
     generate_shaders(dp, &gen_params, &vert_builder, &glsl_builder);
-    for (int i = 0; i < dp->passes.num; i++) {
-        struct pass *p = dp->passes.elem[i];
-        if (p->signature != pass->signature)
-            continue;
+    memo_insert(dp, fingerprint, pass->signature);
+
+    // Found existing shader, re-use directly
+    struct pass *p = find_pass(dp, pass->signature);
+    if (p)
+        return reuse_pass(dp, sh, p, pass, constant_data, constant_size);
 
-        // Found existing shader, re-use directly
-        if (p->ubo)
-            sh->descs.elem[p->ubo_index].binding.object = p->ubo;
-        pl_free(p->run_params.constant_data);
-        p->run_params.constant_data = pl_steal(p, constant_data);
-        p->last_index = dp->current_index;
-        pl_free(pass);
-        return p;
-    }
 
     // Need to compile new shader, execute templates now
+    dp->num_compiled++;
     if (vert_builder) {
         pl_str vert = pl_str_builder_exec(vert_builder);
         params.vertex_shader = (char *) vert.buf;
     }
     pl_str glsl = pl_str_builder_exec(glsl_builder);
     params.glsl_shader = (char *) glsl.buf;
+    pl_log_cpu_time(dp->log, start, pl_clock_now(), "generating GLSL");
 
     // Turn all shader identifiers into actual strings before passing it
     // to the `pl_gpu`
@@ -923,35 +1553,15 @@ static struct pass *finalize_pass(pl_dispatch dp, pl_shader sh,
         FIX_IDENT(params.vertex_attribs[i].name);
 #undef FIX_IDENT
 
-    pass->pass = pl_pass_create(dp->gpu, &params);
-    if (!pass->pass) {
-        PL_ERR(dp, "Failed creating render pass for dispatch");
-        // Add it anyway
-    }
+    if (constant_size)
+        params.constant_data = constant_data = pl_memdup(pass, constant_data, constant_size);
 
     struct pl_pass_run_params *rparams = &pass->run_params;
-    rparams->pass = pass->pass;
     rparams->constant_data = constant_data;
     rparams->push_constants = pl_zalloc(pass, params.push_constants_size);
     rparams->desc_bindings = pl_calloc_ptr(pass, params.num_descriptors,
                                            rparams->desc_bindings);
 
-    if (ubo_size && pass->pass) {
-        // Create the UBO
-        pass->ubo = pl_buf_create(dp->gpu, pl_buf_params(
-            .size = ubo_size,
-            .uniform = true,
-            .host_writable = true,
-        ));
-
-        if (!pass->ubo) {
-            PL_ERR(dp, "Failed creating uniform buffer for dispatch");
-            goto error;
-        }
-
-        sh->descs.elem[pass->ubo_index].binding.object = pass->ubo;
-    }
-
     if (params.type == PL_PASS_RASTER && !vparams) {
         // Generate the vertex array placeholder
         rparams->vertex_count = 4; // single quad
@@ -960,8 +1570,31 @@ static struct pass *finalize_pass(pl_dispatch dp, pl_shader sh,
     }
 
     pass->timer = pl_timer_create(dp->gpu);
+    pass->ubo_size = ubo_size;
 
-    PL_ARRAY_APPEND(dp, dp->passes, pass);
+    if (dp->num_workers && (dp->precompile || dp->async)) {
+        // Defer compilation to the worker threads
+        pass->pending = pl_alloc_ptr(pass, pass->pending);
+        *pass->pending = pl_pass_params_copy(pass->pending, &params);
+        pass->pending->constant_data = constant_data;
+        PL_ARRAY_APPEND(dp, dp->pending, pass);
+        pl_cond_signal(&dp->pending_cond);
+        return pass;
+    }
+
+    pass->pass = pass_compile(dp, pass->signature, &params);
+    pass->pool_ref = dp->pool;
+    if (!pass->pass) {
+        PL_ERR(dp, "Failed creating render pass for dispatch");
+        // Add it anyway
+    }
+
+    if (!pass_create_ubo(dp, pass))
+        goto error;
+    if (pass->num_ubos)
+        sh->descs.elem[pass->ubo_index].binding.object = pass->ubos[0];
+
+    pass_insert(dp, pass);
     return pass;
 
 error:
@@ -994,30 +1627,14 @@ static void update_pass_var(pl_dispatch dp, struct pass *pass,
         PL_ARRAY_APPEND_RAW(pass, rparams->var_updates, rparams->num_var_updates, vu);
         break;
     }
-    case PASS_VAR_UBO: {
-        pl_assert(pass->ubo);
-        const size_t offset = pv->layout.offset;
-        if (host_layout.stride == pv->layout.stride) {
-            pl_assert(host_layout.size == pv->layout.size);
-            pl_buf_write(dp->gpu, pass->ubo, offset, sv->data, host_layout.size);
-        } else {
-            // Coalesce strided UBO write into a single pl_buf_write to avoid
-            // unnecessary synchronization overhead by assembling the correctly
-            // strided upload in RAM
-            pl_grow(dp, &dp->ubo_tmp, pv->layout.size);
-            uint8_t * const tmp = dp->ubo_tmp;
-            const uint8_t *src = sv->data;
-            const uint8_t *end = src + host_layout.size;
-            uint8_t *dst = tmp;
-            while (src < end) {
-                memcpy(dst, src, host_layout.stride);
-                src += host_layout.stride;
-                dst += pv->layout.stride;
-            }
-            pl_buf_write(dp->gpu, pass->ubo, offset, tmp, pv->layout.size);
-        }
+    case PASS_VAR_UBO:
+        // Assemble the correctly strided contents in RAM, and coalesce all
+        // changes into a single upload by `flush_pass_ubo`
+        pl_assert(pass->ubo_data);
+        pl_assert(pv->layout.offset + pv->layout.size <= pass->ubo_size);
+        memcpy_layout(pass->ubo_data, pv->layout, sv->data, host_layout);
+        pass->ubo_dirty = true;
         break;
-    }
     case PASS_VAR_PUSHC:
         pl_assert(rparams->push_constants);
         memcpy_layout(rparams->push_constants, pv->layout, sv->data, host_layout);
@@ -1025,6 +1642,61 @@ static void update_pass_var(pl_dispatch dp, struct pass *pass,
     };
 }
 
+// Uploads the pending UBO contents and updates the pass' UBO binding. Since
+// the current buffer was bound by the previous dispatch, and may still be in
+// use, every upload rotates to the next buffer in a small, lazily grown ring
+// of uniform buffers, to avoid serializing consecutive dispatches of the same
+// pass. Inside batches, the ring grows further rather than
+// overwriting a buffer bound earlier in the same batch. (Note: this
+// deliberately avoids `pl_buf_poll`, which may force a submission on some
+// backends)
+static void flush_pass_ubo(pl_dispatch dp, struct pass *pass)
+{
+    if (!pass->num_ubos)
+        return;
+
+    bool batch = dp->batch;
+    if (batch && pass->batch_id != dp->batch_id) {
+        pass->batch_id = dp->batch_id;
+        pass->batch_ubos = 0;
+    }
+
+    pl_gpu gpu = dp->gpu;
+    const bool rotated = pass->ubo_dirty;
+    if (rotated) {
+        bool grow = pass->num_ubos < MAX_UBOS;
+        if (batch && pass->batch_ubos >= pass->num_ubos)
+            grow = pass->num_ubos < MAX_BATCH_UBOS;
+
+        int idx = (pass->ubo_idx + 1) % pass->num_ubos;
+        if (grow) {
+            pl_buf buf = pl_buf_create(gpu, pl_buf_params(
+                .size = pass->ubo_size,
+                .uniform = true,
+                .host_writable = true,
+            ));
+
+            if (buf) {
+                // Insert the new buffer right after the current one
+                idx = pass->ubo_idx + 1;
+                memmove(&pass->ubos[idx + 1], &pass->ubos[idx],
+                        (pass->num_ubos - idx) * sizeof(pass->ubos[0]));
+                pass->ubos[idx] = buf;
+                pass->num_ubos++;
+            }
+        }
+
+        pl_buf_write(gpu, pass->ubos[idx], 0, pass->ubo_data, pass->ubo_size);
+        pass->ubo_idx = idx;
+        pass->ubo_dirty = false;
+    }
+
+    if (batch && (rotated || !pass->batch_ubos))
+        pass->batch_ubos++;
+
+    pass->run_params.desc_bindings[pass->ubo_index].object = pass->ubos[pass->ubo_idx];
+}
+
 static void compute_vertex_attribs(pl_dispatch dp, pl_shader sh,
                                    int width, int height, ident_t *out_scale)
 {
@@ -1126,13 +1798,39 @@ static void translate_compute_shader(pl_dispatch dp, pl_shader sh,
     sh->output = PL_SHADER_SIG_NONE;
 }
 
+// Returns the timer to use for this frame's invocations of `pass`, or NULL
+static pl_timer pass_timer(pl_dispatch dp, const struct pass *pass)
+{
+    if (dp->timer_interval <= 1)
+        return pass->timer;
+
+    // Stagger the sampled frames by pass, to spread the queries out evenly
+    const unsigned interval = dp->timer_interval;
+    return (dp->num_frames + pass->signature) % interval ? NULL : pass->timer;
+}
+
 static void run_pass(pl_dispatch dp, pl_shader sh, struct pass *pass)
 {
     pl_shader_info shader = &sh->info->info;
+    pl_clock_t start = pl_trace_test(dp->log) ? pl_clock_now() : 0;
     pl_pass_run(dp->gpu, &pass->run_params);
-
-    for (uint64_t ts; (ts = pl_timer_query(dp->gpu, pass->timer));) {
+    pl_trace_ev(dp->log, PL_EV_DISPATCH_RUN, start, pass->signature, pass->ts_last);
+    if (pass->timer && pass->run_params.timer == pass->timer) {
+        const unsigned size = PL_ARRAY_SIZE(pass->ts_cpu);
+        pass->ts_cpu[pass->ts_cpu_head++ % size] = start;
+        if (pass->ts_cpu_head - pass->ts_cpu_tail > size)
+            pass->ts_cpu_tail = pass->ts_cpu_head - size; // drop oldest
+    }
+
+    // Only poll the timer while queries are outstanding, since polling itself
+    // is not free on all backends
+    const bool pending = pass->ts_cpu_head != pass->ts_cpu_tail;
+    for (uint64_t ts; pending && (ts = pl_timer_query(dp->gpu, pass->timer));) {
         PL_TRACE(dp, "Spent %.3f ms on shader: %s", ts / 1e6, shader->description);
+        if (pass->ts_cpu_tail != pass->ts_cpu_head) {
+            const unsigned idx = pass->ts_cpu_tail++ % PL_ARRAY_SIZE(pass->ts_cpu);
+            pl_trace_gpu(dp->log, PL_EV_GPU_PASS, pass->ts_cpu[idx], ts, pass->signature);
+        }
 
         uint64_t old = pass->samples[pass->ts_idx];
         pass->samples[pass->ts_idx] = ts;
@@ -1181,6 +1879,7 @@ static void run_pass(pl_dispatch dp, pl_shader sh, struct pass *pass)
 
 bool pl_dispatch_finish(pl_dispatch dp, const struct pl_dispatch_params *params)
 {
+    PL_ALLOC_SCOPE(DISPATCH);
     pl_shader sh = *params->shader;
     bool ret = false;
     pl_mutex_lock(&dp->lock);
@@ -1216,7 +1915,9 @@ bool pl_dispatch_finish(pl_dispatch dp, const struct pl_dispatch_params *params)
         PL_ERR(dp, "Trying to dispatch using a compute shader with a "
                "non-storable or incompatible target texture.");
         goto error;
-    } else if (can_compute && limits->compute_queues > limits->fragment_queues) {
+    } else if (can_compute && limits->compute_queues > limits->fragment_queues &&
+               !(pl_rect_w(params->scissors) && pl_rect_h(params->scissors)))
+    {
         if (sh_try_compute(sh, 16, 16, true, 0))
             PL_TRACE(dp, "Upgrading fragment shader to compute shader.");
     }
@@ -1277,11 +1978,40 @@ bool pl_dispatch_finish(pl_dispatch dp, const struct pl_dispatch_params *params)
     rc_norm.y0 = PL_MAX(rc_norm.y0, 0);
     rc_norm.x1 = PL_MIN(rc_norm.x1, tpars->w);
     rc_norm.y1 = PL_MIN(rc_norm.y1, tpars->h);
+    if (pl_rect_w(params->scissors) && pl_rect_h(params->scissors) &&
+        !pl_shader_is_compute(sh))
+    {
+        pl_rect2d sc = params->scissors;
+        pl_rect2d_normalize(&sc);
+        rc_norm.x0 = PL_MAX(rc_norm.x0, sc.x0);
+        rc_norm.y0 = PL_MAX(rc_norm.y0, sc.y0);
+        rc_norm.x1 = PL_MIN(rc_norm.x1, sc.x1);
+        rc_norm.y1 = PL_MIN(rc_norm.y1, sc.y1);
+        if (rc_norm.x1 <= rc_norm.x0 || rc_norm.y1 <= rc_norm.y0) {
+            // Nothing to draw
+            ret = true;
+            goto error;
+        }
+    }
     bool load = params->blend_params || !pl_rect2d_eq(rc_norm, full);
 
     struct pass *pass = finalize_pass(dp, sh, params->target, vert_idx,
                                       params->blend_params, load, NULL, proj);
 
+    if (dp->precompile) {
+        // Only compile the pass, don't execute it
+        dp->precompile_failed |= !pass || (!pass->pass && !pass->pending);
+        ret = true;
+        goto error;
+    }
+
+    if (pass && pass->pending) {
+        // Still compiling in the background, skip this dispatch
+        dp->num_deferred++;
+        ret = true;
+        goto error;
+    }
+
     // Silently return on failed passes
     if (!pass || !pass->pass)
         goto error;
@@ -1296,6 +2026,7 @@ bool pl_dispatch_finish(pl_dispatch dp, const struct pl_dispatch_params *params)
     rparams->num_var_updates = 0;
     for (int i = 0; i < sh->vars.num; i++)
         update_pass_var(dp, pass, &sh->vars.elem[i], &pass->vars[i]);
+    flush_pass_ubo(dp, pass);
 
     // Update the vertex data
     if (rparams->vertex_data) {
@@ -1334,7 +2065,7 @@ bool pl_dispatch_finish(pl_dispatch dp, const struct pl_dispatch_params *params)
 
     // Dispatch the actual shader
     rparams->target = params->target;
-    rparams->timer = PL_DEF(params->timer, pass->timer);
+    rparams->timer = PL_DEF(params->timer, pass_timer(dp, pass));
     run_pass(dp, sh, pass);
 
     ret = true;
@@ -1352,6 +2083,7 @@ error:
 
 bool pl_dispatch_compute(pl_dispatch dp, const struct pl_dispatch_compute_params *params)
 {
+    PL_ALLOC_SCOPE(DISPATCH);
     pl_shader sh = *params->shader;
     bool ret = false;
     pl_mutex_lock(&dp->lock);
@@ -1391,6 +2123,20 @@ bool pl_dispatch_compute(pl_dispatch dp, const struct pl_dispatch_compute_params
 
     struct pass *pass = finalize_pass(dp, sh, NULL, -1, NULL, false, NULL, NULL);
 
+    if (dp->precompile) {
+        // Only compile the pass, don't execute it
+        dp->precompile_failed |= !pass || (!pass->pass && !pass->pending);
+        ret = true;
+        goto error;
+    }
+
+    if (pass && pass->pending) {
+        // Still compiling in the background, skip this dispatch
+        dp->num_deferred++;
+        ret = true;
+        goto error;
+    }
+
     // Silently return on failed passes
     if (!pass || !pass->pass)
         goto error;
@@ -1405,6 +2151,7 @@ bool pl_dispatch_compute(pl_dispatch dp, const struct pl_dispatch_compute_params
     rparams->num_var_updates = 0;
     for (int i = 0; i < sh->vars.num; i++)
         update_pass_var(dp, pass, &sh->vars.elem[i], &pass->vars[i]);
+    flush_pass_ubo(dp, pass);
 
     // Update the dispatch size
     int groups = 1;
@@ -1426,7 +2173,7 @@ bool pl_dispatch_compute(pl_dispatch dp, const struct pl_dispatch_compute_params
     }
 
     // Dispatch the actual shader
-    rparams->timer = PL_DEF(params->timer, pass->timer);
+    rparams->timer = PL_DEF(params->timer, pass_timer(dp, pass));
     run_pass(dp, sh, pass);
 
     ret = true;
@@ -1444,6 +2191,7 @@ error:
 
 bool pl_dispatch_vertex(pl_dispatch dp, const struct pl_dispatch_vertex_params *params)
 {
+    PL_ALLOC_SCOPE(DISPATCH);
     pl_shader sh = *params->shader;
     bool ret = false;
     pl_mutex_lock(&dp->lock);
@@ -1528,6 +2276,20 @@ bool pl_dispatch_vertex(pl_dispatch dp, const struct pl_dispatch_vertex_params *
     struct pass *pass = finalize_pass(dp, sh, params->target, pos_idx,
                                       params->blend_params, true, params, &proj);
 
+    if (dp->precompile) {
+        // Only compile the pass, don't execute it
+        dp->precompile_failed |= !pass || (!pass->pass && !pass->pending);
+        ret = true;
+        goto error;
+    }
+
+    if (pass && pass->pending) {
+        // Still compiling in the background, skip this dispatch
+        dp->num_deferred++;
+        ret = true;
+        goto error;
+    }
+
     // Silently return on failed passes
     if (!pass || !pass->pass)
         goto error;
@@ -1542,6 +2304,7 @@ bool pl_dispatch_vertex(pl_dispatch dp, const struct pl_dispatch_vertex_params *
     rparams->num_var_updates = 0;
     for (int i = 0; i < sh->vars.num; i++)
         update_pass_var(dp, pass, &sh->vars.elem[i], &pass->vars[i]);
+    flush_pass_ubo(dp, pass);
 
     // Update the scissors
     rparams->scissors = params->scissors;
@@ -1561,7 +2324,7 @@ bool pl_dispatch_vertex(pl_dispatch dp, const struct pl_dispatch_vertex_params *
     rparams->index_fmt = params->index_fmt;
     rparams->index_buf = params->index_buf;
     rparams->index_offset = params->index_offset;
-    rparams->timer = PL_DEF(params->timer, pass->timer);
+    rparams->timer = PL_DEF(params->timer, pass_timer(dp, pass));
     run_pass(dp, sh, pass);
 
     ret = true;
@@ -1579,6 +2342,7 @@ error:
 
 void pl_dispatch_abort(pl_dispatch dp, pl_shader *psh)
 {
+    PL_ALLOC_SCOPE(DISPATCH);
     pl_shader sh = *psh;
     if (!sh)
         return;
@@ -1595,15 +2359,106 @@ void pl_dispatch_abort(pl_dispatch dp, pl_shader *psh)
 
 void pl_dispatch_reset_frame(pl_dispatch dp)
 {
+    PL_ALLOC_SCOPE(DISPATCH);
     pl_mutex_lock(&dp->lock);
 
     dp->current_ident = 0;
     dp->current_index++;
+    dp->num_frames++;
     garbage_collect_passes(dp);
 
     pl_mutex_unlock(&dp->lock);
 }
 
+void pl_dispatch_precompile_begin(pl_dispatch dp, int num_threads)
+{
+    pl_mutex_lock(&dp->lock);
+    if (dp->precompile) {
+        PL_ERR(dp, "Precompilation already in progress!");
+        goto done;
+    }
+
+    dp->precompile = true;
+    dp->precompile_failed = false;
+    workers_start(dp, num_threads);
+    PL_DEBUG(dp, "Precompiling passes using %d threads", dp->num_workers);
+    // fall through
+
+done:
+    pl_mutex_unlock(&dp->lock);
+}
+
+bool pl_dispatch_precompile_end(pl_dispatch dp)
+{
+    pl_mutex_lock(&dp->lock);
+    if (!dp->precompile) {
+        pl_mutex_unlock(&dp->lock);
+        return false;
+    }
+
+    // Wait for all outstanding compilation jobs, and shut down the worker
+    // threads again (they will be restarted by `pl_dispatch_set_async`)
+    int num_passes = dp->num_passes;
+    workers_stop(dp);
+    collect_pending(dp);
+    PL_DEBUG(dp, "Precompiled %d passes", dp->num_passes - num_passes);
+
+    dp->precompile = false;
+    bool ok = !dp->precompile_failed;
+    pl_mutex_unlock(&dp->lock);
+    return ok;
+}
+
+void pl_dispatch_set_timer_interval(pl_dispatch dp, int interval)
+{
+    pl_mutex_lock(&dp->lock);
+    dp->timer_interval = interval;
+    pl_mutex_unlock(&dp->lock);
+}
+
+void pl_dispatch_set_async(pl_dispatch dp, bool async)
+{
+    pl_mutex_lock(&dp->lock);
+    dp->async = async;
+    if (async)
+        workers_start(dp, 1);
+    pl_mutex_unlock(&dp->lock);
+}
+
+uint64_t pl_dispatch_num_deferred(pl_dispatch dp)
+{
+    pl_mutex_lock(&dp->lock);
+    uint64_t num = dp->num_deferred;
+    pl_mutex_unlock(&dp->lock);
+    return num;
+}
+
+uint64_t pl_dispatch_num_compiled(pl_dispatch dp)
+{
+    pl_mutex_lock(&dp->lock);
+    uint64_t num = dp->num_compiled;
+    pl_mutex_unlock(&dp->lock);
+    return num;
+}
+
+void pl_dispatch_batch_begin(pl_dispatch dp)
+{
+    pl_mutex_lock(&dp->lock);
+    pl_assert(!dp->batch);
+    dp->batch = true;
+    dp->batch_id++;
+    pl_mutex_unlock(&dp->lock);
+}
+
+void pl_dispatch_batch_end(pl_dispatch dp)
+{
+    pl_mutex_lock(&dp->lock);
+    pl_assert(dp->batch);
+    dp->batch = false;
+    pl_mutex_unlock(&dp->lock);
+    pl_gpu_flush(dp->gpu);
+}
+
 size_t pl_dispatch_save(pl_dispatch dp, uint8_t *out)
 {
     return pl_cache_save(pl_gpu_cache(dp->gpu), out, out ? SIZE_MAX : 0);
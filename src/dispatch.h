@@ -29,3 +29,13 @@ pl_shader pl_dispatch_begin_ex(pl_dispatch dp, bool unique);
 //
 // This is a private API because it's sort of clunky/stateful.
 void pl_dispatch_mark_dynamic(pl_dispatch dp, bool dynamic);
+
+// Set the `low_precision` field for newly created `pl_shader` objects.
+void pl_dispatch_mark_low_precision(pl_dispatch dp, bool low_precision);
+
+// Set the `fast_transfer` field for newly created `pl_shader` objects.
+void pl_dispatch_mark_fast_transfer(pl_dispatch dp, bool fast_transfer);
+
+// Returns the total number of new passes created so far, i.e. dispatches that
+// were not served from the in-memory pass cache.
+uint64_t pl_dispatch_num_compiled(pl_dispatch dp);
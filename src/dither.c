@@ -30,6 +30,7 @@
 #include <math.h>
 
 #include "common.h"
+#include "dither_tables.h"
 
 #include <libplacebo/dither.h>
 
@@ -72,6 +73,7 @@ struct ctx {
     bool calcmat[MAX_SIZE2];
     uint64_t gaussmat[MAX_SIZE2];
     index_t unimat[MAX_SIZE2];
+    index_t resnum; // number of valid entries in `randomat`
 };
 
 static void makegauss(struct ctx *k, unsigned int sizeb)
@@ -121,50 +123,58 @@ static void makegauss(struct ctx *k, unsigned int sizeb)
 #endif
 }
 
-static void setbit(struct ctx *k, index_t c)
+// Accumulates the energy of `gauss`, shifted by `offset`, into `gaussmat` over
+// the range [start, end), while also collecting the minimum energy cells that
+// have not been set yet.
+static inline void update_range(struct ctx *k, index_t start, index_t end,
+                                const uint64_t *g, uint64_t *min, index_t *resnum)
 {
-    if (k->calcmat[c])
-        return;
-    k->calcmat[c] = true;
     uint64_t *m = k->gaussmat;
-    uint64_t *me = k->gaussmat + k->size2;
-    uint64_t *g = k->gauss + WRAP_SIZE2(k, k->gauss_middle + k->size2 - c);
-    uint64_t *ge = k->gauss + k->size2;
-    while (g < ge)
-        *m++ += *g++;
-    g = k->gauss;
-    while (m < me)
-        *m++ += *g++;
+    const bool *calc = k->calcmat;
+    for (index_t c = start; c < end; c++, g++) {
+        uint64_t total = m[c] += *g;
+        if (total > *min || calc[c])
+            continue;
+        if (total != *min) {
+            *min = total;
+            *resnum = 0;
+        }
+        k->randomat[(*resnum)++] = c;
+    }
 }
 
-static index_t getmin(struct ctx *k)
+// Sets the bit at `c` and adds its energy to the map. Also finds the
+// candidates for the next minimum in the same pass, rather than scanning the
+// entire energy map a second time.
+static void setbit(struct ctx *k, index_t c)
 {
+    pl_assert(!k->calcmat[c]);
+    k->calcmat[c] = true;
+
     uint64_t min = UINT64_MAX;
     index_t resnum = 0;
-    unsigned int size2 = k->size2;
-    for (index_t c = 0; c < size2; c++) {
-        if (k->calcmat[c])
-            continue;
-        uint64_t total = k->gaussmat[c];
-        if (total <= min) {
-            if (total != min) {
-                min = total;
-                resnum = 0;
-            }
-            k->randomat[resnum++] = c;
-        }
-    }
+    const index_t size2 = k->size2;
+    const index_t offset = WRAP_SIZE2(k, k->gauss_middle + size2 - c);
+    update_range(k, 0, size2 - offset, k->gauss + offset, &min, &resnum);
+    update_range(k, size2 - offset, size2, k->gauss, &min, &resnum);
+    k->resnum = resnum;
+}
+
+static index_t getmin(struct ctx *k)
+{
+    const index_t resnum = k->resnum;
     assert(resnum > 0);
     if (resnum == 1)
         return k->randomat[0];
-    if (resnum == size2)
-        return size2 / 2;
+    if (resnum == k->size2)
+        return k->size2 / 2;
     return k->randomat[rand() % resnum];
 }
 
 static void makeuniform(struct ctx *k)
 {
     unsigned int size2 = k->size2;
+    k->resnum = size2; // all cells start out with zero energy
     for (index_t c = 0; c < size2; c++) {
         index_t r = getmin(k);
         setbit(k, r);
@@ -172,12 +182,32 @@ static void makeuniform(struct ctx *k)
     }
 }
 
+static const uint16_t *blue_noise_table(int size)
+{
+    switch (size) {
+    case 16:  return blue_noise_16;
+    case 32:  return blue_noise_32;
+    case 64:  return blue_noise_64;
+    case 128: return blue_noise_128;
+    default:  return NULL;
+    }
+}
+
 void pl_generate_blue_noise(float *data, int size)
 {
     pl_assert(size > 0);
     int shift = PL_LOG2(size);
-
     pl_assert((1 << shift) == size);
+
+    // Use the precomputed matrices for the common sizes
+    const uint16_t *table = blue_noise_table(size);
+    if (table) {
+        const float scale = 1.0f / (size * size);
+        for (int i = 0; i < size * size; i++)
+            data[i] = table[i] * scale;
+        return;
+    }
+
     struct ctx *k = pl_zalloc_ptr(NULL, k);
     makegauss(k, shift);
     makeuniform(k);
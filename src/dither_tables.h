@@ -0,0 +1,1397 @@
+/*
+ * This file is part of libplacebo.
+ *
+ * libplacebo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libplacebo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libplacebo. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Precomputed void-and-cluster blue noise matrices, stored as the rank of each
+// texel (i.e. the value multiplied by size * size). These were generated by
+// the runtime generator in dither.c and are embedded to avoid the considerable
+// startup cost of generating the larger sizes on the fly.
+
+#pragma once
+
+#include <stdint.h>
+
+static const uint16_t blue_noise_16[16 * 16] = {
+     193,  122,   17,  215,   79,  240,   60,  192,  107,   13,  229,   33,  105,  205,   81,  217,
+      74,  234,  152,   56,  170,    2,  178,   75,  221,  146,   61,  183,  135,   14,  184,   57,
+     169,   43,  103,  252,   72,  216,   49,  156,   29,  117,  200,   73,  253,   98,  133,  241,
+       6,  212,  129,   19,  182,  139,  106,  247,   90,  225,    4,  175,   40,  195,   28,  108,
+     174,   77,  154,  206,   97,   35,  191,   12,  177,   53,  148,  109,  223,   89,  138,  213,
+      67,  226,   45,   87,  243,  131,   62,  210,  134,  104,  239,   52,  155,   11,  185,   41,
+     168,   23,  194,  128,    7,  164,  227,   93,   39,  189,   18,  204,  113,  246,   63,  218,
+     112,  249,   68,  153,  208,   83,   30,  140,  251,   71,  130,  162,   36,   91,  176,  119,
+       0,  118,  179,   46,   99,  238,  115,  197,    3,  120,  233,   69,  214,  151,   26,  187,
+      95,  201,   27,  228,  144,   16,  172,   66,  147,  209,   38,  173,    8,  125,  224,   47,
+     244,   85,  159,  124,   50,  199,   82,  242,   51,  100,  186,   76,  255,   58,  160,  110,
+     142,   15,  220,   64,  254,   78,  181,   25,  161,  230,   20,  149,  114,  203,   21,  235,
+      55,  198,  102,  165,    5,  141,   48,  222,  126,   59,  121,  237,   34,   96,  180,   80,
+     171,  116,   31,  231,   86,  207,   88,  166,   10,  219,  163,   70,  211,  157,   42,  202,
+       9,  245,  137,   94,  188,   22,  232,  127,   84,  132,   37,  190,    1,  123,  248,  101,
+     143,   65,  196,   44,  158,  111,  145,   32,  250,  167,   92,  136,  236,   54,  150,   24,
+};
+
+static const uint16_t blue_noise_32[32 * 32] = {
+     840,   13,  919,  557,   71,  822,  346,  902,  264,  866,  484, 1006,  253,  875,  190,  328,
+     767,  540,  429,  571,  950,  249,  608,  426, 1021,  125,  394,  923,  531,  427,  764,  128,
+     403,  681,  177,  723,  331,  567,  734,   22,  658,  389,   69,  428,  674,   27,  637,  940,
+     376,  153,  844,   92,  388,  803,  116,  746,  220,  836,  639,  336,  119,  889,  223,  944,
+     588,  281,  824,  481,  966,  122,  489,  995,  187,  852,  500,  859,  294,  908,  513,  109,
+     617,  978,  325,  688,  532,  186,  909,  370,  583,  497,   57,  956,  558,  362,  795,  501,
+      74,  992,  436,   46,  374,  699,  274,  536,  713,  246,  668,   95,  740,  155,  365,  775,
+     443,    9,  749,  272, 1004,  440,  602,   20,  971,  280,  697,  212,  728,   18,  604,  188,
+     704,  245,  763,  572,  916,  206,  871,  412,   48,  894,  364,  955,  435,  547, 1002,  256,
+     832,  545,  217,  848,   55,  745,  231,  776,  175,  823,  444,  865,  385, 1012,  259,  906,
+     456,  868,  127,  334,  490,  733,  105,  622,  793,  471,  178,  599,  229,  718,   60,  650,
+     185,  925,  419,  507,  625,  357,  905,  512,  418,  632,   83,  582,  154,  464,  791,  550,
+      40,  384,  636,  834,    4,  542,  973,  194,  338, 1023,  664,   14,  913,  383,  876,  319,
+     678,   77,  773,  133,  958,  157,  581,   73,  842,  266,  985,  326,  892,  665,  108,  353,
+     667, 1001,  171,  527,  945,  261,  404,  717,  548,  121,  447,  781,  549,  124,  470,  810,
+     278,  974,  242,  640,  387,  805,  293,  946,  347,  663,  203,  726,   47,  373,  624,  918,
+     150,  505,  770,  371,  141,  568,  857,   39,  931,  323,  870,  342,  202,  994,  618,   37,
+     715,  415,  515,  896,   23,  476,  701,  196,  768,    6,  830,  430,  530,  993,  252,  520,
+     792,  333,   62,  911,  461,  786,  232,  682,  452,  737,   87,  638,  826,  410,  227,  915,
+     543,   99,  739,  201,  594, 1017,  101,  648,  316,  968,  565,  269,  760,  179,  849,   16,
+     420,  965,  621,  224,  669,   81,  991,  555,  142,  375,  982,  516,   42,  585,  761,  442,
+     193,  996,  339,  855,  454,  221,  801,  275,  685,  462,  148,  921,   91,  684,  386,  562,
+     714,  129,  522,  828,  322,  757,  425,  241,  890,  644,  172,  360,  893,  352,  107,  827,
+     611,  298,  662,   67,  725,  381,  561,  914,   85,  815,  411,  538,  798,  451,  207,  927,
+     308,  809,  398,   28,  943,  146,  528,  720,   11,  422,  861,  630,  164,  643,  930,  372,
+       1,  886,  226,  952,  180,  884,   35,  469,  698,  219, 1009,   30,  329,  895,  627,   64,
+     659,  263, 1019,  458,  631,  378,  837,  305, 1010,  551,  106,  479,  975,  400,  147,  546,
+     730,  349,  703,  303,  620,  523,  358,  980,  295,  652,  343,  719,  559,  123,  477,  970,
+     200,  690,   96,  766,  165,  912,   88,  654,  161,  736,  335,  695,   32,  762,  467, 1015,
+     271,  854,  100,  486,  796,   89,  747,  166,  783,   94,  821,  267,  947,  414,  683,  289,
+     835,  318,  888,  533,  354,  564,  759,  250,  813,  450,  949,  191,  816,  279,  673,   70,
+     661,  210,  521,  988,  234,  899,  392,  600,  446,  957,  197,  601,   43,  800,  159,  748,
+       0,  613,  483,  218,  984,   34,  468,  928,  377,   53,  526,  616,  406,  936,  176,  858,
+     311,  937,  610,   29,  692,  453,  138,  847,   10,  574,  382,  907,  508,  366,  999,  519,
+     393,  961,   86,  818,  570,  401,  708,  117,  606,  864,  268,  901,   79,  506,  609,  416,
+     769,  131,  399,  778,  315,  587, 1020,  297,  772,  254,  744,  115,  782,  169,  598,   93,
+     799,  324,  754,  502,  130,  841,  209, 1003,  236,  496,  645,  174,  804,  230,  998,   21,
+     579,  478,  839,  265,  903,   80,  499,  626,  145,  920,  438,  607,  283,  883,  327,  934,
+     485,  144,  573,  345,  963,  291,  655,  320,  771,    7,  969,  407,  525,  642,  363,  811,
+     225,  951,   66,  651,  184,  710,  251,  788,  423,  576,   65, 1007,  493,   26,  721,  222,
+     687,  439,  802,   24,  534,  758,   68,  831,  431,  633,  277,  814,   59,  910,  136,  455,
+     670,  332,  700,  310,  983,  432,  872,   38,  976,  243,  820,  299,  779,  553,  413,  863,
+      61, 1000,  255,  898,  421,  239,  941,  539,  182,  924,  498,  192,  675,  276,  593,  977,
+      82,  880,  204,  807,  560,  113,  517,  619,  368,  716,  163,  680,  103,  960,  156,  510,
+     614,  379,  705,  183,  686,  566,  137,  390,  724,   78,  596, 1022,  340,  819,  480,  181,
+     787,  434,  612,    5,  391,  942,  215,  825,  111,  463,  948,  348,  647,  330,  817,  290,
+     933,  120,  541,  873,   58, 1011,  459,  856,  307,  877,  417,  135,  756,   17,  932,  409,
+     578,  257, 1008,  472,  838,  306,  751,  288,  917,  589,   12,  743,  173,  677,   45,  709,
+     235,  794,  301,  482,  789,  228,  711,   19,  653,  262,  785,  575,  309,  660,  244,  735,
+      49,  693,  134,  738,  158,  586,   54,  641,  504,  233,  806,  296,  922,  351, 1005,  313,
+     595,    8,  987,  205,  511,  628,  369,  926,  208,  990,   51,  441,  967,  152,  867,  367,
+     954,  445,  878,  356,  514,  986,  405,  879,  118, 1014,  424,  580,  104,  727,  162,  503,
+     891,  396,  563,  765,   90,  851,  149,  465,  672,  314,  590,  797,  284,  712,  457,  112,
+     584,  170,  623,   72,  702,  199,  732,  258,  487,  629,   52,  885,  494,  287,  869,  634,
+     114,  722,  160,  491,  962,  355,  544,  829,   84,  753,  475,  140,  904,   41,  656,  845,
+     300,  752,  286,  939,  408,  862,   25,  537,  790,  302,  696,  282,  742,  554,   33,  402,
+     953,  337,  874,  260,  635,   31,  750,  213,  959,  240,  887,  380,  605,  492,  237,  524,
+    1016,   15,  812,  556,  238,  615,  437,  972,   98,  860,  168,  989,   97,  929,  460,  808,
+     270,  679,   56,  777,  397,  846,  292,  689,  321,  597,    3,  774,  214,  979,  671,  132,
+     395,  691,  466,  110,  997,  143,  694,  211,  666,  341,  646,  350,  657,  216,  676,  102,
+     649,  198,  981,  529,  139,  569, 1018,   76,  495,  938,  359,  518,  843,   75,  344,  900,
+     603,  247,  850,  361,  535,  833,  304,  881,  273,  935,    2,  853,  317,  882,  285, 1013,
+     312,  729,  433,  248,  897,  449,  189,  552,  741,  126,  706,  151,  592,  448,  784,  509,
+      50,  964,  167,  755,   36,  488,  780,   63,  577,  473,  731,  195,  707,   44,  591,  474,
+};
+
+static const uint16_t blue_noise_64[64 * 64] = {
+    2836,  925, 2673,  173, 2396,  851, 2639,   58, 3604,  872, 3977, 2879, 1282,  481, 4061,  764,
+    3697,  314, 3265,  892, 3954,  356, 3525,  652, 2574, 1039, 1976, 3933, 1307, 3636, 2171, 1392,
+    3728, 2076, 3546,  849, 1705, 3875, 1941, 3153,  749, 2472, 1655, 2609,  257, 2837,  760, 3168,
+    2469,  369, 3202, 1037, 1985, 3249, 1413, 4090, 1679, 3270, 1261, 2556, 1483, 2900, 1853, 3241,
+    1398, 3955, 1919, 3349, 1429, 4005, 1627, 3097, 1175, 2313, 1822,  148, 3539, 2397, 1493, 2984,
+    1181, 2474, 1877, 2218, 1546, 2660, 1426, 2138, 3830,  390, 3214,  688, 3048,  495, 3336, 1938,
+     423, 1034, 1471, 3104, 2108,  517, 2662, 1265, 2029, 3613,  492, 4083, 1048, 2111, 3850, 1570,
+    1073, 3931, 2141,  549, 3597,  277, 2955,  639, 2604,  338, 3057,  672, 4013,  387, 2233,  628,
+    2576,  306, 2178,  604, 2791,  393, 2240,  724, 3848,  439, 3421, 2570, 1984, 1002, 2712,   11,
+    3495,  617, 3846,  200, 3388,  748, 3667,   45, 1707, 2919, 1366, 2334, 1788, 2605, 1076, 2897,
+    2033, 3986, 2743,  229, 3473,  992, 3724,   61, 3274, 1017, 2321, 1801, 3004, 1441,  505, 2304,
+    3060,  839, 1723, 2848, 1296, 2670, 1843, 3714, 1157, 3413, 1895, 2265, 1621, 3330, 1167, 3852,
+    1695, 3462, 1127, 3659, 1753, 3276, 1276, 2735, 1700, 2932, 1368,  756, 3943,  370, 3626, 2147,
+    1596, 2783, 1273, 3058, 1745, 2506, 1218, 3015, 2046,  900, 3706,  196, 3474,  841, 3855,    1,
+    3201,  575, 1816, 2481, 1318, 2802, 1827, 2384, 1580, 2757,  871, 3219,  122, 3512, 1971, 3635,
+     243, 2082, 3493,   85, 3824,  887, 2224,  204, 2401,  926, 3893,   79, 2988,  865, 2538,  214,
+    2868,  885, 3100,   75, 2498,  909, 3781,  205, 3380,  547, 2075, 3157, 1465, 3039, 1779,  781,
+    3141,  420, 2343,  929, 4078,  302, 3305,  579, 3979, 2464, 1625, 2691, 1267, 2228, 1712, 2561,
+    1224, 2305, 3580,  797, 3920,  349, 3365,  662, 4001,  268, 3645, 1518, 2504,  960, 2876,  987,
+    1876, 3156, 1110, 2458, 1602, 2979, 1400, 3162, 1778, 2850, 1490, 2620, 1270, 3565, 1916, 3689,
+    1308, 2345, 1875, 4049, 1362, 3075, 1812, 2347, 1086, 2661, 3666,  114, 2507, 1049, 2089, 3912,
+    1391, 3723, 1907, 2875, 1124, 2283, 1806, 2708, 1440,  438, 3414,  633, 3926,  328, 3616,  715,
+    3376,  466, 1516, 3116, 1715, 2247, 1233, 2585, 1422, 2943, 1964,  522, 3965, 2057,  372, 3803,
+    2547,  485, 4054,  723, 3326,  347, 3985,  774, 3503,  430, 3683,  601, 3143,  321, 2190,  661,
+    3037,  425, 2765,  641, 2212,  334, 3533,  671, 3903, 1871,  963, 1975, 3829,  530, 3340,  177,
+    2400,  704, 3419,   77, 3592,  819, 3814,  160, 3518, 2161, 1147, 2901, 1887, 3148, 1544, 3002,
+    1376, 4070, 2060,  107, 2855,  737, 3797,  237, 3515, 1051, 2129, 3121, 1230, 3328, 1587, 2152,
+    1090, 2914, 1504, 2266, 1790, 2509, 1191, 2685, 1624, 2179, 1121, 2425, 1799, 4036, 1417, 3320,
+    1636, 3886, 1189, 3504, 1592, 2822, 1257, 2588, 2049,  313, 3434, 2173, 1183, 2610, 1652, 2960,
+    1204, 2692, 1629, 2188, 1523, 3136, 1356, 2412, 1931,  883, 3243,   73, 2502,  817, 2355,  155,
+    2666,  949, 2542, 3746, 1094, 3282, 1507, 2905, 1924,  554, 3873,  147, 2434,  727, 2956,   54,
+    3372,  856, 3528,  169, 3751,  611, 3455,   17, 3859,  696, 3296,  181, 2887,  918, 2586,   52,
+    2282,  809, 2519,  168, 3190,  845, 3981,   28, 3235, 1547, 2695,  583, 3218,  273, 3575,  890,
+    4018,  343, 3248,  632, 2618,  377, 2904,  597, 3722, 2780, 1669, 4048, 1386, 3496, 1088, 3782,
+    1726, 3205,  324, 1925, 2329,  471, 2471,  955, 3196, 2242, 1537, 2810, 1080, 3605, 1789, 3854,
+    1403, 2640, 1906, 2797, 1320, 3133, 1885, 2338, 1363, 2596, 1909, 3795, 1553, 3486, 1148, 3763,
+    1831, 3397, 1466, 3699, 2002, 2391, 1670, 3026,  969, 3640, 1103, 4067, 1769, 2829, 1384, 2253,
+    1815, 2857, 1305, 3716, 1886, 3997, 1221, 3225, 1533,  478, 2297,  668, 2741,  278, 2114, 2908,
+     528, 2031, 3633,  973, 3444, 1599, 4035, 2026,   19, 3664,  941, 3411, 2022,  464, 2696,  635,
+    2349,  326, 3917,  691, 2191,  385, 2888,  932, 3166,  307, 2820,  832, 2219,  376, 3177,  719,
+    2727,  283, 2896, 1056,  562, 3130,  435, 2263, 2013,  512, 2529,  131, 2335,  735, 3784,   48,
+    3323,  784, 2348,  199, 2732,  906, 2254,   26, 2541, 3861, 1272, 3359, 1817, 3665, 1584,  983,
+    3964, 1207, 2192, 3014,  145, 2702,  592, 3405, 1246, 2680, 1993,  258, 2495, 4008, 1344, 3209,
+    1697, 3083, 1222, 3343, 1659, 3976, 1135, 3618, 1751, 4024, 1200, 3534, 1375, 2771, 1740, 2375,
+    1295, 4086, 2150, 1943, 3821, 1427, 3461, 1152, 3856, 2819, 1651, 3173, 1334, 3063, 1936, 2569,
+    1075, 3883, 1677, 3554, 1160, 3396, 1605, 3625, 1967, 1023, 3067,  226, 2379,  790, 3110, 2515,
+      35, 2828,  670, 1750, 3885, 1316, 2169, 2861, 1802,  510, 3786, 2982, 1158,  744, 2142,  188,
+    3676,  842, 2277,   65, 2577,  822, 2683,  209, 2238,  758, 2456,  104, 3113,  638, 3936,  138,
+    3093, 1006,  532, 2966,  100, 2510,  729, 2643,  223, 1033, 3478,  556, 3921, 1015,  381, 3127,
+    2017,  491, 2906,  717, 2493,  312, 2948,  750, 2723,  403, 2043, 3562, 1489, 3928,  434, 1839,
+    3428, 1389, 3569, 2094,  524, 2961, 1016,  267, 3910, 2137,  804, 1561, 3438, 1953, 3577, 2557,
+    1093, 2849, 1813, 3793, 1283, 3553, 1858, 3312, 1269, 2980, 1678, 3866, 1989, 2543, 1448, 3334,
+    1849, 2085, 3377, 1328, 3589, 1824, 4017, 1491, 3071, 1978, 2214, 1535, 2483, 2000, 3523, 1259,
+    3661, 2223, 1420, 3223, 1864, 3827, 1354, 2122, 4032, 1689, 2898,  970, 2677, 1061, 2243, 3171,
+     947, 2439,  341, 3087, 1539, 3725, 1956, 3333, 1112, 3080, 1923, 2801,   87, 2710,  548, 1575,
+    4059,  264, 3260,  731, 3032,  454, 2330,  594, 3777,  410, 3256,  539, 1032, 3415,  448, 2301,
+     782, 3837,  270, 2714,  899, 2229,  357, 3268,  783, 3602,  461, 3721,  125, 2831,  700, 2446,
+     248,  993, 4089,  101, 2323,  647, 3371,  139, 1082, 3281,  572, 3755,   86, 3448, 1983,  544,
+    4056, 1699, 3768,  959, 2616,   72, 2420,  694, 2636,  219, 3632,  982, 3967, 1409, 3348, 2090,
+     946, 2377, 1385, 2535, 2058, 1619, 3123, 1430, 2559, 2045, 1496, 2799, 2133, 1598, 3719, 1219,
+    2993, 1613, 2411, 1506, 3140, 1186, 2789, 1758, 2366, 1108, 2918,  962, 3224, 1101, 3994, 1672,
+    3338, 2611, 1782, 2981, 1206, 2751, 1732, 3118, 2524, 1432, 2291, 1800, 2480, 1252, 2971, 1412,
+    2740,  133, 2020, 3244, 1238, 3468, 1594, 4079, 1981, 3271, 1371, 2317,  676, 2491,  389, 2965,
+    1841, 3487,  525, 3932,  134, 3608,  846, 4072,   41, 3511,  894, 3680,  193, 3053,  683, 2521,
+      12, 3570,  623, 3971,  179, 3713,  663, 3429,   34, 3905, 1591, 2533, 1797, 2250,  501, 2944,
+    1324,  482, 3471,  830, 3630,  422, 3914, 1009,  535, 3807,  290, 3394,  780, 3860,  263, 3639,
+    2070, 1085, 2926,  486, 2318,  802, 2933,  397, 1044, 2455,  498, 3193, 1796, 3761, 1063, 3614,
+       5, 2813, 2027, 1566, 2619, 1081, 2825, 1766, 2293, 1223, 2642, 1814, 2395, 1339, 4027, 1905,
+    3229, 1132, 2826, 1881, 2294, 1641, 2518, 1331, 2866, 2097,  569, 3788,  240, 3395, 2015,  965,
+    3817, 2131, 1582, 2044, 2512, 1452, 2234, 1994, 2920, 1586, 2638, 1205, 2872, 1970,  996, 2537,
+     519, 3527, 1531, 3961, 1896, 3610, 1382, 2105, 3651, 1520, 3876, 2067,  250, 2021, 2672, 1545,
+    2274, 1107, 3758,  971, 3362, 2127,  274, 3155,  649, 3007,  329, 3938,  808, 3442,  359, 2756,
+     924, 2195,  418, 3297,  812, 3479,  287, 4069, 1000, 1942, 3331, 1460, 2742, 1151, 3628, 2422,
+       6, 3197,  595, 3959,  202, 3409,  664, 3598,   44, 3308,  722, 4007,  189, 2269, 3313, 1459,
+    3117, 2126,  728, 2482,  210, 2668,  588, 3011,   33, 2627,  712, 3020, 1003, 3440,  489, 3924,
+     689, 3161,  289, 2719,  552, 1837, 3657, 1310, 3867, 1686, 3277, 1143, 2856, 1730, 2285, 1250,
+    3857, 1792, 3700, 1241, 2705, 1442, 3027, 2157,  529, 2987,  275, 2393,  785, 3072,  399, 1926,
+    2883, 1508, 2628, 1144, 2844, 1696, 3065, 1289, 2473, 1808, 2202, 1378, 3013, 1658,  565, 3949,
+      10, 1734, 3740, 1165, 3301, 1614, 3816, 1821, 3477, 1236, 3290, 1667, 2445, 1445, 2772, 1244,
+    2517, 1768, 3581, 1498, 3992, 2497,  770, 2676,  180, 2433,  713, 2213,   80, 3213,  602, 3400,
+     215, 3091,  674, 2373,   68, 3840, 1055, 1977, 3544, 1563, 3678, 1294, 3879, 1999, 1030, 4053,
+     759, 3491,  355, 3687,  895, 2326,  316, 4060,  914, 3702,  406, 3410,  857, 3753, 2653, 1264,
+    2414, 3025,  408, 2747,  905, 2245,  309, 2548,  881, 2268,  469, 4025,  124, 3584,  798, 3254,
+     166, 3006,  884, 2332,   90, 1150, 3459, 2072, 3335, 1473, 3773, 1901, 3615, 1300, 2659, 1653,
+    2430, 1379, 2869, 1714, 3208, 2102,  560, 2886,  140, 2656,  720, 3181,   81, 2287, 3147, 1635,
+    2528, 1291, 2261, 1830, 3238, 1234, 2693, 1883, 2942, 1142, 2804, 1562, 2443, 2005,  364, 3568,
+     811, 2036, 3510, 1329, 4043, 1478, 3420, 1137, 3918, 1757, 2731, 1394, 2925, 1968, 2249, 1558,
+    4095, 2054, 1355, 3146, 1980, 2915, 1628,  515, 1026, 2782,  394, 2589,  902, 3021,  305, 4075,
+     852, 3483,  367, 3984,  873, 1495, 3506, 1673, 3796, 1231, 2235, 1764, 2774, 1477,  542, 3418,
+     158, 3794,  708, 2958,   74, 3787,  775, 3447,  171, 2309,  620, 3547,  111, 3217, 1042, 1927,
+    3149, 1513,  650, 2558,  116, 3101,  603, 2816,  225, 3125,  653, 3634, 1036,  412, 3767,  584,
+    2431,  374, 3499,  619, 3836,  427, 3607, 2025, 4052, 1345, 3464, 1564, 3877, 1844, 2181, 1119,
+    2761, 1913, 2252, 1171, 2566, 3119,  424, 2385,  827, 3262,  333, 4014,  882, 3646, 2380, 1225,
+    2811, 1897, 3183, 1377, 2573, 1662, 2180, 1361, 3187, 1729, 3963, 1315, 2725, 1600, 4085, 2149,
+     149, 3789, 2073, 3222, 1752, 2361, 2028, 1597, 3567, 2063, 1278, 2460, 2007, 3035, 1701, 2778,
+    1174, 2969, 1616, 2374, 1102, 2698,  948, 3160,   23, 2490,  778, 2306,  165, 3303,  631, 3624,
+      49, 3800,  654, 3038,  186, 1854, 3937, 1314, 2750, 1829, 2579, 1141, 2946, 2051,  443, 3946,
+     913, 2204,  301, 3998,  609, 3538,  431, 3862,  695, 2664,  339, 3105,  733, 2342,  470, 2939,
+    1220, 2686,  497, 1018, 3648,  386, 3872,  831, 2413,  504, 3345,  132, 3858,  854, 3378,   56,
+    3653,  834, 3904,  227, 3317, 1743, 2280, 1253, 2880, 1805, 3134, 1159, 2895, 1421, 2633, 1690,
+    2410, 1352, 3287, 1609, 3650, 2084, 1008, 3354,   24, 3853,  657, 3555,  197, 1437, 3078, 1694,
+    3230, 1155, 2758, 1773, 2369, 1120, 2809, 1918, 3074, 1214, 2205, 1863, 3381, 1115, 3712,  853,
+    3519, 1682, 3929, 2476, 1396, 2912, 1213, 3211, 1454, 4016, 1709, 2608, 1510, 2270, 1271, 2652,
+    1476, 2208, 1899, 2572,  747, 3695,  292, 3922,  627, 3520,  358, 3962,  710, 3574,  432, 3212,
+     930, 2824,  311, 2353,  803, 2892,  493, 2151, 2967, 1411, 2312, 1642, 2544, 3402,  596, 2423,
+      50, 3672,  823, 3445,  213, 3261,  931, 2404,   21, 3660,  877, 3884,  230, 2792, 1480, 2595,
+    2010,  563, 2125,  203, 3452,  763, 2298,   30, 2667,  989, 3070,  577, 3234,  276, 3996,  701,
+    3458,  401, 3266, 1245, 3115, 1511, 2814, 1889, 2438, 1407, 2203, 1549, 2706, 1774, 2267, 1281,
+    3974, 1836, 3439, 1239, 4051, 1463, 3548, 1946, 1060, 3629,  468, 3198,  794, 1868, 3785, 1325,
+    3030, 1848, 2325, 1424, 2976, 1620, 4050, 1401, 3327, 1786, 2842, 1514, 2394,  976, 3449,   59,
+    3253, 1091, 3086, 1540, 2612, 1847, 3576, 2053, 3735,  348, 2120, 3698, 1079, 2902, 1803, 2390,
+    1648, 2927,  991, 4041,   70, 2184,  863, 3427,  198, 3732,  919, 3332,   88, 3813,  821, 3028,
+     211, 2193,  610, 2730,  115, 2555,  738, 3144,  246, 2004, 2858, 1216, 4080, 2092,  354, 2613,
+     734, 3891,  414, 3582,  690, 2211,  345, 2744,  766, 2311,  279, 3228,  567, 3818, 2101, 1639,
+    2215, 4000,  323, 3611,  629, 3049,  467, 1072, 1671, 2940, 1312, 1948, 2477,  537, 3594,  220,
+    3808,  878, 2319, 1850, 2703, 1195, 3052, 1623, 2594, 1129, 2843, 1917, 2457, 1199, 2584, 1892,
+    3696, 1131, 3586, 1557, 3257, 1828, 3844, 1297, 2492, 3930,  870, 2365,  118, 2788, 1035, 3300,
+    2144, 1534, 2675, 1193, 2833, 1902, 3743, 1166, 3509, 1589, 3957, 1203, 3005, 1957,  421, 3068,
+     593, 1453, 2760, 1777, 2257, 1301, 4076, 2553, 3406,  753, 3892,  108, 3436, 2047, 1450, 3180,
+    1053, 2630,  295, 3662,  605, 3513,  426, 3878,  660, 3259,  318, 4006,  600, 3441,  391, 3239,
+     746, 2840,  366, 2437,  921, 2237,  342, 2936,  587, 1479, 3263, 1727, 3524, 1302, 3727, 1702,
+     187, 3407,  908, 3969,   84, 3236,  621, 2591,  156, 2689,  534, 2055, 2478, 1070, 3374, 1304,
+    3739, 2462,  897, 3790,   91, 3206,  820, 2003,  235, 2432,  978, 2882, 1066, 2716,  771, 2109,
+    2998, 1585, 3246, 1367, 2873, 1738, 2416, 1340, 2239, 1754, 2637, 1372, 2177, 1716, 2690, 1319,
+    2303, 1484, 3863, 1748, 3417, 1168, 3684, 1645, 3507, 2091,  392, 2621,  681, 3096,  480, 2038,
+    2923, 1260, 2489, 1749, 2288, 1348, 2999, 1719, 2145, 3675, 1010, 3426,  117, 4062,  776, 2773,
+     174, 1929, 3280, 1161, 2847, 1710, 2359, 3663, 1502, 3288, 2030, 1574, 3638,  450, 4065, 1825,
+      15, 3894,  711, 2220,  167, 4003,  815, 3393,   53, 3802,  886, 3535,  172, 3704,  927, 4088,
+       0, 2963,  645, 2567,  170, 2815,  716, 2453,   60, 2770, 1028, 3839, 2154, 1606, 2534, 3988,
+     585, 3561,  310, 3703,  836, 3469,  384, 3842,  787, 1464, 3046, 1692, 2603, 1436, 2324, 1717,
+    3603, 2166,  449, 2546,  703, 3896,  320, 1045, 2997,  521, 3960,  261, 2217, 3050, 1099, 3368,
+    2354, 1284, 2779, 1884, 3062, 1149, 2607, 1921, 3033, 1212, 2889, 1872, 2444, 1117, 3079, 1552,
+    3284, 1920, 3532, 1299, 3980, 1878, 3306, 1332, 4039, 1780, 3361, 1503,  152, 3631,  891, 1428,
+    2327, 1804, 3175, 1126, 2795, 1882, 2508, 1211, 2929, 2040,  447, 3591,  707, 3275,  319, 3163,
+     860, 1526, 4021, 1336, 3386, 1536, 3109, 1969, 2634, 1341, 2115, 3120,  967, 1746, 2562,  518,
+    1012, 3521,  396, 3731,  888, 3316,  346, 3759,  761, 2336,  433, 3184,  630, 2803,  300, 2225,
+     814, 2650,  429, 2183,  896, 2707,  304, 2251,  835, 2903,  472, 2042, 3000, 1145, 3318, 2769,
+      13, 2968,  702, 2206,  206, 4092,  721, 3358,   36, 3950, 2386, 1163, 2812, 1867, 3881, 1217,
+    2450, 3095,  551, 2808,  141, 2279,  791, 3587,   37, 3760,  666, 1945, 3552,  128, 3847, 1997,
+    3132, 1713, 2645, 1457, 2440, 1638, 2182, 1408, 2766, 1527, 4033, 1630, 3498, 1351, 3865, 1755,
+    3481, 1176, 3780, 1665, 3232, 1123, 3742, 1681, 3517, 1202, 2479, 3911,  789, 2403,  365, 1928,
+    3655, 1350, 3868, 1617, 3139, 1418, 2346, 1680, 2764, 1525,  816, 3756,  195, 2216,  643, 2729,
+       2, 2008, 3643, 1668, 2056, 3806, 1256, 2500, 1691, 2174, 3186, 1249, 2755, 2164,  942, 2835,
+     236, 4011,  667, 3398,   78, 3948,  613, 3599,  212, 3102,  709, 2199,   83, 2669,  725, 3099,
+     217, 2378,  606, 2874,   76, 2419,  651, 2644,  201, 3142,  612, 1423, 3178, 1725, 4055, 2168,
+     840, 2539,  407, 2749,  904, 3585,  285, 3729,  559, 2100, 3341, 1728, 3111, 1359, 3356, 1654,
+    3811, 1087, 2389,  917, 3344,  428, 3018,  546, 3392, 1019,  335, 4029,  568, 1903, 3692, 1485,
+    2470, 1369, 2231, 1179, 2581, 1900, 2854, 1125, 2408, 1859, 3325, 1172, 3791, 1898, 2320, 1444,
+    3993, 1852, 3319, 1313, 3945, 1912, 3446, 1380, 3880, 1855, 2300, 3596,  112, 2651,  541, 1532,
+    3430, 1170, 3291, 1851, 2415, 1274, 3034, 1963, 1054, 2970,  272, 2654,  910, 4010,  416, 3001,
+     799, 3401,  280, 3131, 1497, 2671, 1840, 3978, 1358, 2953, 2001, 2580, 1116, 3159,  281, 3036,
+     768, 3298,  361, 3819,  923, 3247,  308, 3470,  867, 3835,  336, 2739,  933, 3023,  402, 2863,
+     901, 2681,  317, 2260,  859, 2763,  378, 2201,  922, 3056,  350, 1612, 2950, 1262, 3744, 2442,
+     178, 2995,  634, 4009,   67, 3475,  531, 2155, 3995, 1458, 3606, 1240, 2310, 1908, 2617, 1288,
+    2337, 1856, 2776, 1185, 3889,  988, 2302,  233, 2468,  687, 3783,  123, 3456, 1555, 2376, 1083,
+    3627, 1842, 2921, 1565, 2699, 1335, 2248, 1739, 2655, 1303, 2308, 1693, 3531, 1500, 3707, 1130,
+    3364, 1370, 3679, 1581, 3514, 1196, 3252, 1785, 2709, 1140, 3718, 2032,  769, 3200, 1024, 1986,
+    3622, 1698, 2281, 1469, 2907, 2083, 1004, 2859,  136, 2475,  675, 3084,   69, 3505,  608, 3671,
+     175, 4064,  636, 2209,   98, 3450,  786, 3654, 1615, 3108, 1439, 2328, 1932,  520, 3916, 2064,
+      38, 2505,  618, 3482,  185, 3637,  765, 4082,   20, 2992,  578, 3192,  154, 2503,  626, 2167,
+      51, 2565,  754, 2945,  159, 2383,  673, 4074,   29, 3304,  589, 2520, 3973, 2119,  413, 2899,
+     862, 2713,  337, 3733,  772, 1826, 3688, 1323, 3433, 1845, 3826, 1622, 2701, 1136, 2185, 1741,
+    2682, 1405, 3055, 1560, 2911, 1762, 3179, 1067, 2745,  409, 3351, 1047, 3709, 2665,  979, 3258,
+    1721, 4042, 1287, 2048, 2362, 1818, 3059, 1251, 3285, 1595, 3869, 2050, 1342, 3956, 1934, 3432,
+    1529, 4045, 1873, 2080, 3833, 1664, 2817, 1277, 2275, 1703, 2885, 1322,  241, 1517, 3488, 1646,
+    3947, 1365, 3267, 1156, 2448, 3164,  446, 2563,  824, 2226,  382, 3231,  876, 3944,  322, 3329,
+     903, 3563,  362, 3799,  861, 2428,  477, 2132, 1954, 4091,  937, 2549,  251, 2037, 3017,  373,
+    2737,  875, 3194,  456, 3871,  581, 2522,  411, 2159,  893, 2454,  458, 2937,  810, 3054,  363,
+    2405,  580, 3088,  441, 1040, 3154,  488, 3541,  825, 3810,  462, 3530, 2333, 3129,  644, 2625,
+      39, 2232,  679, 2954,  150, 1455, 3888, 1747, 3292, 1173, 2894, 1414, 2357, 1798, 2786, 1461,
+    2485, 1229, 2264, 1866, 3309, 1275, 3915, 2935,   27, 1395, 2990, 1742, 3167,  844, 1663, 3737,
+    1373, 2387, 1601, 2852, 1138, 3355, 1492, 3764, 1893, 3460, 1118, 3669, 1807, 2314, 1180, 3766,
+    1772, 3289, 1255, 2536, 3578, 1499, 2436, 2006, 3042, 1438, 2578, 1933, 1041, 2011, 3762, 1201,
+    3366, 1834, 3823, 1567, 3579, 2290,  637, 2806,   18, 4068,  658, 3694,  191, 3457,  755, 3765,
+      43, 3242,  685, 2752,  242, 2632,  576, 1530, 3715, 2221,  463, 3557, 1292, 3991, 2165,  590,
+    3416,  153, 3792,  743, 2244,  105, 2796,  714, 2951,  208, 2590,  699, 3085,   94, 2807,  928,
+    2688,  207, 3906,  829, 2116,  102, 3983,  994,  247, 3423,  686, 4023,  126, 2985,  490, 2352,
+     818, 2571,  284, 2785, 1031, 1988, 3114, 1247, 2382, 1551, 2684, 2009, 3137, 1286, 2258, 1973,
+    3008, 1633, 3953, 1096, 3620, 1706, 3404, 2093,  912, 3264, 1991,  706, 2452,   92, 2884, 1190,
+    2099, 3066, 1765, 3278, 1406, 4015, 1711, 2322, 1280, 3942, 1737, 3360, 1419, 4020, 1631, 3529,
+    1397, 2272, 1538, 2996, 1811, 2767, 1298, 2934, 1949, 2156, 2845, 1388, 2494, 1559, 3295, 1731,
+    4071, 1317, 3526, 2121,  540, 3990,  269, 3467,  850, 3609,  288, 1007, 2511,  561, 4026,  395,
+    1029, 2523,  503, 3106, 2035,  848, 2513,  260, 2846, 1071, 2587, 3690,  984, 3369, 1578, 3677,
+     513, 1005, 2674,  344, 2560,  869, 3443,  303, 3151,  916, 2230,  330, 2663,  615, 2198,  405,
+    3158,  648, 3489,  315, 3741,  669, 3379,  496, 3774, 1074,  442, 3551,  847, 3804,  972, 2759,
+     144, 3022,  741, 1869, 3342, 1374, 2718, 1708, 2136, 2878, 1888, 3215, 1593, 3040, 1475, 3363,
+    2019, 3736, 1505, 2331,  121, 4047, 1050, 3593, 1894, 3970,  216, 1607, 2959, 2012,  298, 2724,
+    1879, 3390, 1268, 3851, 1820, 3092, 1197, 2694, 1860, 3536, 1554, 3749, 1232, 3273, 1911, 3801,
+    1128, 2839, 1736, 2575, 1169, 2351, 1685, 2606, 1364, 3003, 2087, 1744, 3081,  297, 2255, 1443,
+    3652, 2162, 1114, 2928,   89, 2398,  718, 3815,  142, 1058, 3968,  523, 3717,   97, 2392,  740,
+    2798,  249, 3199,  985, 2781, 1640, 2964, 2113,  558, 1346, 3103, 2170,  538, 3890, 1084, 2197,
+    4058,    7, 2407,  693, 2153,  194, 3738,  640, 2371,   46, 2800,  805, 2435,  176, 2717,  880,
+    2461,   14, 4094,  915, 3322,  182, 3951,  788, 3497,   55, 3909, 1046, 2564, 1922, 3152,  574,
+    1998,  509, 3925, 2062, 3644, 1610, 3077, 1266, 3182, 1992, 2447, 1326, 2077, 2736, 1089, 3902,
+    1874, 1209, 2123, 3682,  659, 3472,  460, 1494, 3165, 2339,  956, 3754, 1402, 2071, 2913,  573,
+    1383, 3051, 1569, 3612, 2860, 1519, 2086, 3245, 1425, 4066, 1154, 3466, 1767, 3908, 1333, 3590,
+    1838, 3090, 1309, 2187, 1914, 2827, 1472, 2241, 1823, 2467,  736, 3350,  222, 4012,  958, 3558,
+    2526, 3210, 1528,  383,  998, 2624,  475, 3550,  800, 2700,  352, 3453,  936, 3573, 1770,  457,
+    2931, 3522,  514, 1950, 2602, 1290, 2370, 3895,   63, 3559, 1930,  451, 3220,  127, 3601, 1939,
+    3324,  951, 2711,  474, 1059, 3982,  379, 1011, 2947,  543, 2545,  445, 2118,  678, 2924,  271,
+    2262,  732, 3387,  417, 3649,  614, 3240,  353, 3098, 1208, 2841, 1644, 2307, 1258, 2865, 1688,
+       4, 1062, 2832, 3454, 1965, 4037, 1431, 2175, 1832, 3897, 1446, 3069, 1958,  239, 3170, 2488,
+     975, 2236, 1568, 3940,  221, 3064,  968, 1972, 2647,  757, 2098, 2871, 1650, 2641,  907, 2463,
+     255, 3772, 2104, 1966, 3337, 1660, 2734, 3571, 1759, 2039, 3089, 1467, 3357, 2496, 1548, 3302,
+    1242, 3812, 1675, 2777, 1433, 2629, 1113, 3828,  945, 3537,  293, 3779,  795, 3227,  453, 2427,
+    3882, 1947, 2143,  779, 2465,  224, 3009,  586, 2867,   57, 2296,  607, 2622, 4081, 1235, 1940,
+    3838,    8, 2978,  950, 3283, 1684, 3711,  325, 3347, 1456, 4077,  990, 3500, 1198, 3975, 1604,
+    3174, 1474,  566, 2916,   82, 2429,  742, 2163,  161, 3841,  879, 3658,  103, 1057, 4031,  533,
+    2614,  137, 2341,  796, 4002,   66, 2284, 1550, 2678, 1910, 2194, 1381, 2599, 1862, 3686, 1353,
+     837, 3286,  291, 3771, 1164, 3314, 1783, 3745, 1237, 3370, 1676, 3710,  995, 2069,  506, 2768,
+     752, 3195, 1182, 2441, 2023,  536, 2501, 2068,  911, 2949,  231, 2487,  553, 2295,  419, 2891,
+    1052, 2360, 3901, 1111, 3508, 1338, 3923, 1482, 3226, 1210, 2356, 1718, 2754, 1959, 2096, 3107,
+    1735, 2983, 1178, 3188, 1795, 3045,  855, 3353,  232, 4063,  692, 3311,   96, 2805,  582, 2176,
+    3047, 1462, 2697, 1590, 2598,  943, 2278,  296, 2583,  826, 2994,  404, 2399, 3403, 1487, 3726,
+    2128, 1724, 3566,  294, 4040, 1263, 3425, 1078, 3849, 2210, 1835, 3412, 1481, 3820, 2034,  793,
+    3668,  146, 1833, 3082,  940, 2582,  459, 2938,  665, 2657,  340, 3279,  642, 3708,  286, 1001,
+    3864,  564, 3543,  368, 2486, 1027, 3685, 1733, 2388, 1187, 2890, 1791, 3939, 1133, 3375, 1761,
+     192, 4087,  697, 3490,   71, 3898, 1637, 3476, 1470, 4019, 1104, 2728, 1915,  119, 3031, 1064,
+     259, 2658,  935, 2893, 1626, 2623,   93, 3126, 1579,  479, 3172,  682, 2679,   32, 2986, 1704,
+    2160, 3385, 2626,  499, 2124, 3674, 1787, 2078, 3600, 1647, 3987, 1410, 3012, 1279, 3382, 2134,
+    1512, 2552, 2024, 1399, 3307, 2135,  487, 2787,  625, 3138,  327, 2316,  920, 2466,  415, 3734,
+    2540, 1192, 2299, 1890, 2975, 1100, 2823,  745, 2449,  234, 2130, 3545,  957, 3934, 1643, 2196,
+    3463, 1330, 3845, 2079,  571, 3647, 2139,  726, 2838, 2088, 1285, 3750, 1760, 3549,  964, 3204,
+     351, 1022, 1447, 4073, 1572,  253, 3016, 1038,   25, 2864,  828, 2259,  190, 2600,  777, 2877,
+      40, 3642,  838, 3972,  162, 1962, 3900, 1293, 3502, 1674, 3747, 1311, 2991, 1634, 3145, 2041,
+     889, 3556,  332, 3233,  624, 2200,  375, 3272, 1861, 3673, 1543,  507, 3094, 2061,  436, 2794,
+     646, 2972,  130, 1521, 3024,  980, 1763, 3542, 1043, 3999,  143, 2424,  874, 2059, 2551, 1343,
+    3775, 2065, 3122,  762, 2554, 3373, 1327, 3809, 2340, 1177, 3484, 1781, 3748, 1576, 3958, 1944,
+    3255, 1347, 2074, 2597, 1522, 2962,  953, 2527,   22, 2207,  813, 3383,  157, 3822,  599, 1404,
+    2917, 1603, 2748, 1321, 3701, 1810, 3966, 1248, 3019,  981, 3189, 1955, 2568, 1092, 3776,  974,
+    3621, 1937, 2146, 3339,  444, 3870, 2406,  282, 2593, 1666, 2930, 1451, 3399,  262, 4022,  550,
+    1618, 2870,   64, 3588, 1982,  944, 2158,  516, 3185, 2014,  452, 3128,  684, 2426,  494, 1014,
+    2344,  398, 3176,  598, 3617,  455, 3437, 1846, 3831, 1468, 2762, 1891, 2514, 1226, 2148, 3465,
+      42, 3874,  739, 2402,  183, 2631,  868, 2315,   16, 2720,  616, 3989,  218, 3293, 1687, 2417,
+    1415,  502, 4004, 1065, 2726, 1979, 1357, 3408,  934, 3623,  511, 3150, 1020, 2715, 1793, 2292,
+    3299,  833, 1880, 2367,  483, 3952, 2834, 1809,  961, 4046, 2530, 1105, 2775, 1306, 2952, 3431,
+    1657, 3832, 1188, 2830, 1756, 2289, 1106, 2853,  751, 3207,  371, 4034,  698, 3061,  473, 2550,
+    1819, 2103, 3124, 1524, 3294, 1184, 3492, 1722, 3825, 1501, 2484, 1228, 2276,  767, 2881,   62,
+    3216, 2615, 1577, 2363,  792, 3135,   31, 2851, 2095, 1109, 2246, 1951, 3907,  705, 3494,  184,
+    1095, 3887, 2746, 1134, 3221, 1541,  129, 3641, 2271,  254, 1960, 3540,   95, 3656, 2018,  245,
+    2646,  807, 2459,  113, 4084,  866, 3321,  228, 2451, 1122, 2273, 1416, 3269, 1720, 3927, 1069,
+    3619,  400, 1013, 4030,  545, 2957,  440, 2784,  773, 3315,  266, 3720, 1771, 3480, 1077, 3805,
+    2066,  898, 3501,  252, 3681, 1215, 4057, 1776,  380, 3834, 2738,  106, 1583, 2409, 1227, 3043,
+    2516, 1995,  299, 3691,  954, 2649, 2081,  999, 3041, 1556, 3169,  966, 1865, 2286, 1068, 4028,
+    1488, 3595, 1870, 3251, 1390, 2704, 1542, 3919, 1784, 3670,  952, 2790,  109, 2368,  864, 2687,
+    1449, 2941, 1987, 2364, 1632, 2052, 3730, 1393, 2222, 1996, 2862,  939, 3029,  484, 2525, 1952,
+     388, 2821, 1021, 3010, 1961, 2172,  591, 2531, 3250,  858, 1434, 3583, 3076,  437, 3705, 1683,
+     526, 3389, 1515, 2110, 2973,  508, 3191, 1935,  476, 3843,  555, 2818, 3913,  465, 3203,  656,
+    2977,  331, 2227,  677, 2989,  360, 2186,  622, 2909,  265, 3352, 1974, 3770, 1025, 3451,  238,
+    3346,  655, 3778,   99, 3435,  806, 2418,  151, 4044,  527, 1608, 3564, 1486, 2112, 4093, 1194,
+    3384, 1656, 3941, 1509,  500, 2793, 3560,  997, 1571, 2922, 2107,  570, 1990, 2648,  977, 2189,
+    4038,  938, 3073,  135, 1661, 3899, 1098, 3516, 2753, 1435, 2372, 2016, 1097, 2635, 1649, 2350,
+    1243, 3485, 1588, 3798, 1153, 3572, 1904, 3237, 1349, 2532, 1573,  557, 2106, 3044, 1611, 2256,
+    1794, 2592, 1360, 2722, 1146, 2910, 1775, 3112, 1254, 3367, 2381,  110, 2733,  986,  244, 2974,
+     680, 2601,  120, 2421, 3310, 1162,  256, 2140, 3935,  163, 3391, 1139, 3769, 1387, 3424,    9,
+    1857, 2721, 1337, 3752, 2358,  730, 2499,   47, 2117,  843, 3693,  164, 3422,  801, 3757,    3,
+};
+
+static const uint16_t blue_noise_128[128 * 128] = {
+     8704, 14653,  7521,  4177, 15080, 10018,  2797,  7767,  9404,   761, 10858,  2894, 16283,  9858,  3767, 13306,
+      996, 15917,  3094, 14151,  7055,   931, 10913,  7887, 11454,   140, 14351,  6969,  2837, 12316,  7398,  1460,
+    14295,  3017,  7527, 11719,  5903,  2376, 12512,  1355, 16085,  3069, 14100,  7922, 15945, 10662,  1453, 11900,
+      894,  5987, 14744,  9205,  5287,  8096, 12876,  4833, 11377, 14760,   196, 11947,  2051,  4631, 12645,  9452,
+    13879,   702,  8941,  2663, 12998,  3693, 16200,  2006,  8272, 10513,  6768,  9821, 14511,   532,  5787, 15576,
+     8845,  2486, 10199,  1197,  5506, 16365,   701,  8341, 14191, 10999,  1013, 14791,  1898,  9189, 15755,  3596,
+     7125,  9090, 12689,  6424,  1478, 10978,  2813, 12819,  4045, 12278,  4574, 10766,  5587,  2609,  8192, 12872,
+     4725,  9267, 12094,  5284,  8490, 10441,  4641,  7062, 10748,  5402, 13450,  3579, 14466, 10369,  5959, 16324,
+      418,  9810,  2540, 12435,  8187,  5137, 12816, 11436,  4280, 14772,  7029, 12547,  6053,  2371, 11875,  5440,
+    10786,  4526, 11505,  8966,  5093, 16212,  3577, 13236,  4594,  9555,  5353, 11739,  8747,   494, 13162, 11078,
+     4586,  9458, 12855,  1608,  9941, 15361,  5108, 10472,  7375, 11845,  6785,  1748,  9001,  4149, 15210,  5091,
+     8218, 12626,  4555,    34, 12109,  2555,  9720,   727,  8620,  3395,  9903,  7131,  8779, 14363,  1251,  7733,
+     3311, 11269, 14207,  4858,  6347, 11920,  7652,  5192, 12818,  3486, 15497,  1678,  4539, 11423,  8470,  3964,
+    12867,  6140, 15856,  7518, 13062,  2891, 12186,  5712,  2241,  7050, 10212,  3752, 12366,  4627,  7605, 11125,
+     2149, 14132,   735,  8480, 13368,  5818, 15484,  7159,  8926,  2116, 16242,   519, 13775, 11926,  6698,  3540,
+    11039,  1350,  7493,  3019, 15503,  1767, 13156,   943, 16224,  2124,  7451, 12019,  5064,  1989, 13900,  3191,
+    10873,  4904, 15353,  6674,  1859, 16120,    13,  6398, 13270,  3211,  8479,  1141, 13643,  7952, 14975,  8818,
+     1658, 13811,  7806,   409, 12674,  9791,  7325,  1367, 15437,  2638, 13848,  1835, 15734,  6554,  3570,  8275,
+    15456,   820,  5443, 14714,  6849,   396,  8648, 13796,  3901,   764,  9799, 14672,  5845, 12423,  3177,  9572,
+    13461,  2729, 10099, 16377,  7432, 13604,  5566, 14170,  6862, 16164,  5161, 13514,  3949, 10065,  6253, 16079,
+    10502,  5929,  1550, 15696,  9876,   463, 10758, 14312,  1205, 12085,  5537, 13263,  7440, 16126,  3133, 14203,
+      868, 11975,  3377,  9213,  4370, 10653,  7700,  9713, 15455, 13340,  5199, 15971,  6130, 14364,  1405, 13008,
+     6239, 10052,  5300, 16315,  3701,  9790,   320, 11699,  5237, 14162,  6581,  9441,  7771,  1692,  9871, 15823,
+     5944, 14138, 12653,  9753,  6418, 12219,  7855,  9323,  5816, 12595,  8893,   107, 15187,  8447,  7004, 12666,
+     6340, 13530,  1032,  9116, 11128,  3559,  8744, 14317,  1701, 10168, 15816,  5708, 10637,  4347,   216,  7135,
+    12438,  6151,  2774, 15534,  4251,  2054, 12071,  9076,  5924, 12476,  7657, 10827,  4349,  9856, 14599,  2341,
+     5764, 12062,  8521,  3781, 11261, 13066,  2676,  6128, 12205, 15632,  4901,  2817, 11338,   292, 14423,  7005,
+     1804, 11103,  6339,  3923, 11448,  1883, 10354,  3033, 12411,  1632, 10857,  2435, 15580,   499, 12974,  2836,
+     4428, 12198,  8507,  7492,  4129, 15127,  3166,  9161,  6501,  8660, 11037,  2706,  9384,  1106, 10603,  6914,
+     9782,  5261, 14809,   366, 13693,  1802, 14681,  3835,   129,  8576,  2718,  9392,   617, 10501,  8226,  4225,
+    15002,  3226, 11257,  2344, 12240,  8041, 15099,  3159, 10523,  1164, 11440,  3837, 15159,  4927, 13222,   299,
+     8435,  2397,  4335, 14800,   626,  3772, 15097,  2618, 13871,  4117, 11090,  6266,  9911,  4361, 11404,  1418,
+     9453,  2929, 11810,  5563, 14051,  7121, 10679,  4635, 11989,  7551,  3943, 14015,  2115,  9190, 16063, 11342,
+     3630, 14621,  8510, 10551,  6694, 14010,  4803, 14677,  3350, 10408,   851,  6270, 13574,  1272, 11604,  7219,
+    10452, 13901,  1884, 15795,  7655,  4739, 14443,  9144,  1981,  8253, 10759, 13123,  6468, 10201,  7845,  3660,
+    15752,  8651, 14869,  1245,  6765, 14461,  7995, 15416,  4665,  9135,  6460, 12225,  8141, 11503,  5251,  9240,
+    15197,   241, 13256,  2493, 13731,  6990, 12412,  2232, 15834,  4243,   334, 14965,  6248, 12709,  4755, 13504,
+     2278, 11102,  8165,  6640, 11452,  5049,  6293, 12546, 11287,  4796, 12792,  6799, 11706,  3373, 13449,  9618,
+        1, 11939,  7834, 14589,  6842,  1741,  4822, 13179,  8396, 15630,  6180,  2496, 12421,  8645,  3205, 14583,
+    10536,  7242, 11366,  5536,  8777, 10891,  4908, 11656,  6854,  1520, 15807,  2773, 13703,   756, 15544,  3867,
+    14354,  7344, 15922,  4101,  2245, 13039,   891, 15564,  2681,  9685,   403, 11164,  6792, 12759,  5218,  2524,
+    10056,   787,  5321, 13402,  1192,  7990, 11112,   287,  8439, 16083,  4971, 15022,  2949,  8993,  3891, 16152,
+        3,  4445,  9660,  3185, 10283,  1123, 10899,  3588, 14986,  7128,  4091,  1094, 16203,  2218, 13876,  5588,
+    12191,   615,  4972, 12741,  9507,  4399,   373,  6113, 11658,   858, 15094,  4232,  1359,  7272, 14623,  1914,
+     6795, 10216,  5013, 11382,  8838,   878, 10020,  5825, 12962,  7727, 13896,  5098, 11766,  1926, 15168,  7782,
+     4191, 15408,  1474, 14094,  2576, 15701, 10014,  1256,  7255, 16148,  1690, 14069,  5394, 15154,  2003,  5772,
+    15652,  6603,  4666,  1001, 10391, 13949,  9567,  7015,  1980,  4377, 12938,  7436, 10352,   937, 11581,  5767,
+     3953, 16328,  1055, 13681,  2080, 15951,  7593,   359, 14503, 10248,  8283,  4745, 12401,  9077,  5427, 10571,
+     8085,   243,  8589, 10154, 14963,  6142,  9378,  8281,  5408, 15109, 12305,  4775, 15441,  1383,  8117, 14259,
+     6550, 15251, 11606,  3795,  9610, 15781,  3014, 13096,  6992,  2129, 11923,  7840, 12680,  6754, 13260,  5266,
+     8143, 12346,  6451, 13318,  5947, 16307,  7892, 12731,   173, 11636, 13734,  9305,  5326,  8181, 11498,  1366,
+     7280, 10614, 13999,  8314,  2930, 15833, 10711, 13045,  3597, 13919,  7607,  9559, 13695,  3366, 11073,  8265,
+    14075,  3611, 16266,  1731,  5390, 14705,  3524, 11516,  1396,  9585,  3343, 10287,  8249,  3783,  9045,   165,
+    12516,  9337,  5655, 10393,  7410,  8712,  3284, 13550,  9131,  4048,  7898,  9926,   963,  8791,  7329, 11042,
+     3005, 13639,  8992, 12617,  3969,  6066,   650, 12020, 14698,  9832,   119, 14293,  5277, 15733,  7046, 12732,
+     1787,  8989, 11882,  6562,  9925,  3449, 12765,  9531,  5297,  3281, 13253,  7694,  2204,  6592, 14703,  1793,
+    12788,  5910, 13309,  1561,  4981, 11611,  3345, 12571,  7251,  1287,  6076,  8907,  3301, 10492, 13171,  4160,
+     9304,  1857,  7470, 12528,  2272,  6025, 10276,  5447, 14202,  9494,  3683, 10151,   423, 11000,  1979,  9332,
+    14261,  2795, 15191,   631, 11818,  5210,  1721,  6609, 10044,  5617,  2465, 15130,  3357, 12797,  4597,  9704,
+    15386,  3788,  2277,  5855, 11861,  7099,  2057,  8415,  9857,  5757,  2694, 12553,  4886, 15937,  5670,   796,
+    11781,  5989,  9495,  7959, 12703,  6619, 15553,  4799, 13537,  7071, 16336,   789, 14580,  6745, 10860, 15928,
+     6465,  2925, 12161,  3619, 12917,   520, 15051,  5527,  2412, 14535, 11167,  3515, 12203, 15876,  4328, 12845,
+     8140,  1365, 10685,  2760, 14913,  8666, 15913,  3565,  5542,  7691, 11212,  3411,  9237,  2215,  4252, 10003,
+    13920,  7673,  3086, 13356,  4556, 14303,  1283,  6060, 11254, 15440,   903, 11856, 16173, 10064,  3388, 11545,
+     4616, 15725,  3674, 12112,  7968,   516, 16299,  1986, 13959, 10297, 13464,  2294, 14711,  7404,   565, 11971,
+     3121, 11014, 16326,  4554,  8836, 14925,   715, 12238,  4202,  1135, 15357,  5719, 14516,  4719, 15584,  6104,
+     1204, 11341,  7414,  8863,  2514, 13846,  9514, 15425,  4392, 13415,  8746,  6940, 10520,   472, 14188,  2872,
+     6170, 13172, 10054, 15174,   929, 13445,  5236, 14796,  1191, 16248, 10531,   105,  8751,  2248, 10635, 12918,
+     3045, 13468,  1136, 14472,  2616, 10907,    12,  8428, 10486,  2032,  5466, 12304,  3049, 13378,  1341,  4959,
+     8573, 13810,   826, 16240,  4873, 11605,  7072, 10480, 12092,  6445,   310, 13867,  6080,  2595, 10147,   533,
+    14234,  5577, 16159,  7444,  5111, 11408,  2386, 10867, 13469,  1492, 16176,  6444, 13623,  7926, 15056,   535,
+     5055, 15342,  6160,    35, 10577,  6971,  8506, 14950,  1957,  8929,  7246,  3807,  5713,   429, 14040,  7041,
+     9597,  2460, 10817,  6467, 13767,  9755,  6851, 10753,  3824,  8040,  4408, 11470,  9518,  4952, 15766,  6123,
+    13854,  5596,    44,  7068, 13569,  3490, 11226,  6472,  8565, 12833,  7489,  2589, 11467,  8715,  3325, 10525,
+    12965,  5054,  3519, 14861, 10980,  4168,  8379,  2945, 11949,   926, 11115,  1662,  5804, 15593,  8475, 11784,
+     9115,   138,  7510,  4161,  8927, 10959,  3469,  7746, 11335,  4127,  6929, 13290,  6307, 14999,  7461,  4325,
+     8947,  7049, 10361,  4645, 12010,  3812,  7416, 13971,  2819, 15061, 11229,  7942,  9890,  5847, 11852, 14417,
+     2096, 10238,  5998,  8231,  9624,  2216, 13269,  1045,  4448, 15376,  9524,  4723,  8438, 14670,  6985, 11985,
+     3728,  9283,  1903, 13024,   270, 14371,  6684,  8317,  4566,  8917,  2744, 11756,  1104, 10941,  6021,  9512,
+    12065,  2349, 11104,  8000, 15551,  2575, 12303,  4319, 13004,  2941, 14192, 10691,  8008, 12284,  8734,  1237,
+    15239,  7624,   792, 14856,  2716,  4270, 12859,  5202, 14594,   139, 15980,  6485,  1010, 12609,  8711,  1630,
+     9866,  8196, 12894, 10657,  1516,  7754, 14394,  1815, 15996,  5068,  9934, 13366,  1625,  7259, 14038,   752,
+     7983, 15887, 10102,  1408,  7043, 12893,   435, 14152,  7549, 15970,  5022, 14638, 12239,  7402,  4239,  1949,
+    16115,  4871, 14392, 12385,  1644, 16037,  6575, 14031,  2311,  9011, 14523,  3239, 11613,  1417,  9642, 15716,
+      357, 14786,  2146, 15900,  6187,  9299, 12343,  4499,  9072,  6337,  4063,   453, 15443,  2464,  4350,  7626,
+    11281,  3929, 14943,  1594, 14266,  6724,  3712, 15780,  8608,  1948,  7471, 13155,  1455, 10916,  2251,  4977,
+    15355, 11309,  6379,  9959,  8019,  4229, 12384,   892, 15378, 10112, 12775,  4890, 14767,  3761, 13111,  1598,
+     8371, 14439,  3617, 12576,  5423,  9345,   739, 10840,  5165,  9825,  6365,  1484, 15048,  2655,  5233, 13584,
+     4156, 12482,  9262,  5356, 11373, 14373,  1215,  9030,  3058, 12215,  8542,  3554, 14159,  7006,  2861, 15070,
+     3924, 14529,  2697,  5122, 15190, 10013,  4040,  9286,  2904, 11701,   130,  6331, 16268,  4410, 11984,  9534,
+     2305,  6564, 12189,  4569, 14496,  5832, 10555,  3729,  6326,  2165,  9930,  3551,  9219,   817, 13037,  6809,
+    10822,  8046,  2450, 10290,  5664,  8593,   297, 11962,  5077, 12353,   675, 10152,  5407, 14143,  3711,  6566,
+    12145,  5510, 11247,  7790,   669, 14173,  1693, 16065,  1024, 12639, 14258,  9474,  7208, 12900,  8901, 15623,
+      379, 13089,  7273, 12025,  4581, 11085,  7827, 10057,  5920, 12742, 10631,  3138, 16330,  5343, 13400,  8888,
+     7636,  1075, 13892,  3396, 15563,  2110,  9350, 13784,  3118,  5922,   442,  7136,  8728, 10496,  2854, 16095,
+     4654,  6794, 10180,  1398, 13789,  3936, 16143,  7799, 13895,   213, 15768, 11312,  4007, 12922, 10329,  6713,
+    11178,  3090, 16050,  1824,  8331,  5974,  7708, 15600, 11106,  5572,  1732, 13015, 10094,  4591, 11662, 10429,
+     7598,   933, 11918,  8974,  6201,   505, 12618,  6732, 13910,  7684, 14710,  3775, 10749,  8397,  2847, 15313,
+     4092, 13478,   240,  8168,  9846,  1905, 15574,  8586, 11406, 12654,  8081, 13909,  2715, 11297,  5396, 14892,
+     1168, 12082,  6435, 13797,  3310, 12914,  9766,  2999, 15372,  6175,  8295, 15604,  2000,  7703, 10832, 13666,
+     2423,  9907,  3998, 13210,  8365,  3378, 10085,  5323, 10695,  8108,  1830,  5045, 11555,  1166,  6159,  3245,
+     9975,  5330,  9165,  2979, 16005,    50, 13589,  2654, 14458,   645,  4154, 11780,  6635,  9671,   150, 14989,
+     3057, 12502,  4536, 10618,  5823, 11721,  5207,  7351, 10712, 14211,  8084, 15788,  2037,  5663, 12375,  7321,
+    11354,   799, 15698,  9029,  7222, 11441,  1820,  6678,  3542, 11995,  8183,  4770,  9198,  6184,  1875, 14241,
+       58,  8617,  5678, 10405, 13359,   362, 11954,  2355,  6687,  9601, 14923,  7358,  2182, 16211,   322,  5459,
+    13533,  6524, 15562,  3283, 11414, 15889,  4892, 10876,   988,  4625,  9437, 12370,  1265,  5819, 13764,  6927,
+    11094,  5405,  9208, 16064,  3264, 12419,  5243,  1246, 15068,  4668,    60,  6067, 16226,  7714, 13535,  3074,
+     9901,  3819, 15778,   724,  7215, 14933,  4733,  7946, 10436,  1685, 13185,  4529,  9252, 12814,   921,  8487,
+     5130, 15267,  1318,  5797, 11583, 15365,  6943, 13485,  3100, 11909,  6822, 14799,  3658, 16117, 10798, 13665,
+     6917, 14141,  1086, 10683,  6400,  8875,  5619, 11457,  5040,  9109, 14891,  8128,  1189, 12298,  3945, 10306,
+     6258,  8269, 16000,   689,  8783, 15075,  1289, 12895,  3876,  1711, 12194,  4332, 13446,  9416,   203, 14148,
+     4062, 13267,  5809,  3059, 14696,  4919, 13389, 10360, 15292,  5839,  2224, 13221,   656, 16366,  9734,  4913,
+    15384,  7144, 12988,  3518,  4712, 15123,  9841,  4113, 13831,   636,  4862, 11857,  5941,  9230,  7807, 12287,
+     2410,  9631,  4458, 13161,  1933,  8313,  2477, 13471,  8782, 15707,  2255,  7104, 15143,  9081,   513, 12723,
+     1536, 14757,  6152,  2398, 11584,  7612, 13608,  9047,  3099,  7203, 13234, 11013,  4072,  1463,  9471,  4706,
+    12515,  8404,  5302,  9374, 11665,  1978, 11067,   994, 14646,  3842,  7373, 11797,  2838,  6045, 16355,  3496,
+    12453,  7165,  9435, 14383,  1947,  4840,  8815,   277, 15726,  5573, 12999,  2389, 10190,  7812,  4639,  1663,
+    12403,  2730, 15202,  4241, 12829,  3464, 15303,  1391, 12428,  7162,  2076, 13709,  5862, 15664,  7276, 14306,
+     1576, 11632,  2627,  7051, 13108,  2964, 10198,  6551, 16354,  9762,  6315, 11170,  3242, 15027,  5117,  8227,
+    10040,  2263,  8698, 12129,   344,  9768,  2685,  8399,   984,  9431, 14524,  6944, 11709,  3365,  7522, 12034,
+     2404, 10722,   993, 14642,  9132,  6902,  2822, 12726,  8635, 15884, 10250,  1252, 13337,  3633, 15344,  4236,
+    14311,  1353, 10741,  7893,  5366, 14131, 10223,  5964,  3196, 11283,  5560, 12977,  3466, 11621,  4961,  9736,
+     7870,  3687, 10358, 14088,  6777,   561,  4027, 10793, 14407, 10097,  2073,  8680, 14267, 10500,  6367, 15300,
+      330, 14508,  2571, 13251,  4441, 15483,  6731, 12662,  5575,  9532, 15899,   411, 14244,  9974,  4278, 11413,
+      156, 13853,  3011,  7563, 10558, 12852,  2577, 11116,  3879,  9606,   841,  8610, 13324,   116, 14537,  9271,
+     5095,  8468,  7511, 11874,  1910, 13883,  7969,  9777,  3313, 15934, 10410,  4513, 11239,  2431,  9229,  4780,
+    12783,  5649,  9498, 14742,  4905,  7905, 14487,    66,  8524,  2653, 15229,   847,  8970,  6650, 11801,  1357,
+    15265,  6227, 10782,  4412, 12945,  6449, 15101,  5579, 12627,  3204, 10917,  4436,  8462, 14834,  1184, 13426,
+     8803,  4357, 11576,  7839,  1610, 16235, 10950,  6147,  1935,  7548,  3359, 14547,  8179, 10843,   807, 11288,
+     8652,  6881, 16109,   191, 11792,  7205,  1222, 14978,  8006,   342, 14333, 10305,  1750,  6707, 14167,  2111,
+    15763, 12320,   947,  4746, 13055,  9653, 16346,  5674,   987,  6541, 15758,  5150,   652, 12815,  2375,  7290,
+    11358,  5909, 10647,  7755,  1381,  9145,  3426,  8204, 13726,  2369,  4918, 11130,  7095,  1517, 14868,  8905,
+     6259, 10267,  4583, 16127,   594,  6531, 15025,  5965, 13921,  7381, 15219,  4253,  5871, 12136,  6660,  2259,
+    11323, 16278,   502,  9448,  4855, 10279,   848,  6876, 13057,  5485,   353,  8762,  3686, 13258,   774, 10802,
+     3236, 13761,   380, 11100,  1828, 12315,  4189, 11468,  5612, 12001,  4765,  7861, 14344,  1919, 12825,  7614,
+     3556, 13686,  1064, 16270,  8116,  1588, 11664,  3985, 15923,  7647,  1429, 13655,  2510, 10234,  6533,  3741,
+    15967,  6016, 13908,  3249, 12383,  5084,   846, 13526,  4314, 12259, 11166,  6406,  2559,  5212, 13903,  3006,
+     5731, 12420,  3763,  9342, 14597,  3533, 12756,  4262,  9759, 12140,  3958,  7472,  8615, 16142,  4290, 10634,
+     5270,  7284,  8933, 15444,  1743,  8328,  2700, 11837,  7944, 12549,  3779, 12040,  8228,  5571, 15660,  8922,
+     1601, 13654,  3669, 16325,  6250, 13980, 11544,    36, 10573,  6499, 12489,  8658,  3358, 13274,  7965,  2605,
+    15561,  1229, 13126,  8172, 12078,  9015,  4378,  9956,  1623, 11477,  2802, 10517, 15860,  3184,  9749, 15011,
+     5722,  3803, 13455,  6558, 14788,  5943, 15596, 11356,  2276, 14079,  7729, 15037, 12064,  6714, 14577,  8402,
+    16185,  7378,  4060,  8588, 15681,  6853,  9599,  3323, 13983,  1564, 13311, 11002,  3965, 10285,  2939, 16007,
+     9615,  6911, 11220,  5273,  3331, 14255,  7098, 10562,   489,  8919, 12361,  6114, 15611,  5186, 12789,  8110,
+      529,  9986,  1992,  9425,  6319, 14206,  8254, 10027, 15213,  5753,    96, 15500,  8830, 12550,  7111,  9722,
+    15014,  1869, 13622,  6273,  2572, 11044,  8529, 16381,  2145,  6515, 15471,   840, 13169,  2737, 11925,    78,
+    13360,  2558, 11473,  3512, 10937,  6306, 13932,  4360, 15256,  1637,  9542,  2636, 14661, 10264,  3255, 11914,
+     4308,  8093, 12301,   572, 10207,  2860,  5436, 15995,  4155, 14413,  1115, 15201,  5746, 11998,  4700, 10954,
+     6890, 11694,  5599,  2229,  3593, 14592,  1049, 12557,  7882,  4933, 14307,  6997,  1415, 11715,  7982,   951,
+    12677, 10071,  1508, 10821,  2586, 12364,  3614,  4620,  9319, 10904,  3047,  6145,  1469,  9877,  2711,  5362,
+     1733, 10017, 12113,  5988,  2478, 13380,   915, 15931,  7512,  9270,  5876,   388, 15597,  6111, 11514,  4876,
+      530, 12518,  2422, 14859, 10203,  8528,  2064, 13936,  5397, 14770,  3467,  9672,   166, 11434,  2119, 14424,
+    11070,  5292, 11890, 14896,   248, 10627,  3651,  7019,  1424,  9352, 13116,  4622, 10533,  1563, 15747,   422,
+     4841, 10183,  8380,  4573, 15291,  6800,   599,  5145, 13413,  9052,  4673, 10993,  5488,  9924,  7941,  6387,
+    14531,  8467,  5743, 14949,  4987, 12847,   200,  7379, 10377,  5446, 13424,  7117,  4565,  1134, 13870,  6607,
+    15028,  2157,  9725,  5050, 15160,  7452, 13063,  8862,  2085,  9863,  7571,  2987, 10366,   706, 13957,  1882,
+    14546,  3961,  8687, 15801, 11218,  7286, 13436,  3250, 16311,  9355,   479,  8772, 13701,  5372,  3506, 13968,
+     8329,  4430,  7409, 14287,  8794,   215,  8271, 14556,  6426,  1029, 16246, 11648,  4996, 15459,  7992, 12535,
+     6489, 15121,  1157, 14220, 10338,  5476, 10918,  4422, 12608,  2336, 14887,  9920,  7266,  1206, 14046,  8478,
+    14603,  5699,  9187,  7501,    86, 12247,  4329,  9523,  2594,  7312, 11114,  4832, 14135,  6725,  9258,  4568,
+     2875, 15669,  7091,  3895,  7682, 15785,  2457, 11730, 14000,  3136,  7770,  2090, 14369,  4035,  8056, 13058,
+     6545, 11548,   865, 12061,  1664, 10395, 12530,  7802, 11402,  1558, 14658,  3075, 13898,  1185, 15348,  3315,
+     9579,  1459, 12133,   763, 10058,  2996,  8816, 14778,  2321, 11092,   421, 16039, 11511,  7631,  9354,   135,
+    10960,  5786, 14337,  8737,  2333, 11252,  1208,  7026, 12234,  5244, 13545,  8242, 16170,  6657,  9210,  5340,
+     9787,   370, 12790,  6074,  1570,  5147, 10240,  6442,  2103, 12281,  6106, 12821,  2440, 11054, 15461,  6281,
+     2038, 15789, 11152,  3106,  5429, 16078, 11543,  1782, 12670,  7927,  3887,  8923, 13864,    99, 11029,  3417,
+    13499,  4659,  9058,  7823,  3759, 15419,  2074,  8848,  6705, 10736,  3480,  5198, 13153,  9104,  4306,  2087,
+    10656,  3643, 13401,  4600, 15625,  6692, 13173,  6035, 11523, 16187,  1779, 13266,  7940,  1126, 15223,  7359,
+    12532,  8409,  1347, 13228,  8928,  4818, 12807,  5521,  8456, 16016, 11445,  6700,  9529,  5629, 11929,  2317,
+    14676,  3190, 15947,  7293, 13822,  5770,  2912, 14068,  3703, 10009,  6226, 12395,  8799,  5914, 10508, 12824,
+     4614, 15973,  7706, 13714,  6891, 15602, 11348,  3941,  8516, 14246,  6033,  8965,  2942, 12685,  4934, 15864,
+     3438, 13124,   934,  6798, 12739,  4680, 14692,  3709, 15520,   497, 11634,  4351,  1651, 12686,  3650, 15404,
+     7476, 13642,  2948, 10805,  9490, 15177,    64, 11877,  8320,  4602, 14812,  3846,  7542,  9079,   302, 10301,
+    12214,  6892,   719, 13339,  9225,  4085,  7093, 10196,  4805, 13511, 10549,  1967,  6830, 12909,  4397,  9548,
+      704, 11521,  2843, 13068,   261, 11836,  6224, 14581,   604, 13663,  8370, 16253,  2696, 12218,  7734, 12911,
+     6618, 15890,  1512, 11755,  2852, 10872,  1292, 15358,   765,  8621,  4124, 10055,  3039, 12075,  3810, 10834,
+      732, 13788,  5879, 10466,  2247, 14475,  1042, 11019,  3956,   568,  5038, 13692,   953, 16284,  3470, 10368,
+     7699,  9111,  5304,  9884,  3883,  8718, 15512,  1047,  7169, 15924,   260,  7664,  2281, 14811,  3932,   536,
+     7122, 10824,  2184,  4209,  9394,  1832,  5308, 12432,  6624,  1354, 12978,  3699, 14843,  1847, 10063,  7007,
+     8458,  4485, 10351, 16088,  3143,  9447,  7883, 10886,  6372,  9125,  2565, 10616, 14634,  5925, 10142,  2306,
+    11840,  4881,  7011, 14334,  4059,  8001, 13781,  3678, 15392,  9797,   896, 10773, 16044,  4346, 13213,  5006,
+     8699,  3715, 14872,  6042, 11901,  1284, 13813,  2933, 15318,   456,  5783, 14829,  8517,  2352, 15830,  7559,
+    14011,  6978, 16023,  5144,  9443,  7401, 12812,  3037, 11286,  4943,  1420,  6923, 10499,   147, 15414,  5312,
+      887,  8058,  9565,  5861, 13845,  8774,  3845,  7856, 12664,  5653, 14359,  6361, 15740,  8297, 13060,  5618,
+     9614,  2693, 15129,  4247, 12115,  6556,  9239,  7371, 14980,  9746, 12367,  2829, 10737,  8556, 12786,  5977,
+     1201, 13434,  2046, 14441,    26, 12887,  4735,  9482, 10850,  5342, 13103, 11525,  4847,  9289, 12009,  8129,
+    14218,  3169, 13220, 11748,  5888, 14105,  8020,   876, 16196,  9836,  4846,  8160, 10745,  6186, 13555,  1285,
+    11211, 14160,  1945,  6004, 12135,   268, 13377,  1752, 14018,  4870, 15824,  7173,  8515,   125, 12306,  7854,
+     1148, 16068,  9043,   823, 12441,  2408,  6735, 10454,  1795,  5626, 14027,  6576,  1328, 11773,  3031, 15237,
+     1673, 12994,  9536,  2226,  8077, 15117,  6252,  9760,  7600, 12138,  9389,  3289, 11932,  5419, 10641,  1313,
+     5657, 10243,  1913, 11181, 14817,  1496,  4615,  9969, 15240,  7928, 12068, 14408,  4153, 11650,  3273, 10002,
+    15018, 11057,  3107, 12377,   580,  5163, 14569,  9780,  2772, 10639,  1534, 11769,   414,  5119,  1909, 16133,
+     3498, 11591,  6828,  9868,   434, 16337,  3042, 13495,  1951,  6204,  8098, 15360,  6889,  4223,   271, 15083,
+    11079,  4478, 12222,  6334, 10602,  7588, 11753,  2630, 14871,  2002,  8386,  3478, 15653,  6534,  1689, 16298,
+     5080,  9035,  6693,   339, 15784,  3659, 10277, 13317,  3382, 11703,  2468, 15496,   676, 12236,  3918, 15185,
+     2830,  7544, 11761,  8623,  4052, 14914,  5640, 10072,  3488, 12042,  1030, 13022,  3071, 14189,  4572, 15019,
+    10540,  2736, 11484,  5755,  8416, 15735,  4305, 13198,  7641, 11540,  3344,  8485, 14526,  7160,  9656,  5680,
+    10661,  7675,  4532, 12426,  5075, 10726,   811, 12956,  2512,  4450, 15708,  7346,   867, 14451,  3939, 12389,
+    15204,  3616,  8741,  6373,  4030,  8454, 16141,  5905,   974,  3804,  9694,  1940,  8764,  6208, 13917,  7085,
+     2225,  4736, 14294,  7629, 16313, 10420,  1970,  6824, 15149,  4623, 13760,  6986,  9418, 14528, 10376,  6283,
+     8553, 14111,  1669,  7917, 12650,  5335, 11317,  4679, 10314, 12984,  3680,  1280, 11839, 14225,  9820,  7503,
+     2713, 15659,  8345,  3354, 16154,  1776,  6037, 13323,  4316,  6942, 14346, 10134,   773, 13757,  9814,  2764,
+    12510,  1258, 15105,  9748,  4707, 11157,  1569,  7247,  9101,  5732, 13815,  6934,  9688,  5497,  7847,  9184,
+    12850,  5157,   736, 15700,  6895, 10731,  2652,  7639, 15139,  6189,  9617,  5535, 11336,  6841,  9439,  3433,
+     6432, 13453,  4435, 14777,  1480, 10969,  9176,   668, 16175,  2635, 12766, 10218,  5168,  2327, 13738,   655,
+    14430,  2753, 16327,    30, 14201,  3546,  8972, 15994,  5568, 11196,  1523, 12826, 10100,  6193,  9202,  8071,
+     2551, 11737, 14301,   573, 13723, 12254,  2298, 13211,  8954, 14072,  6506, 15645,  5503, 12479,  1262,  9321,
+    13297, 11455,  6420,  1698,  4061,  6167, 11628, 12987,   221,  8958,  3269, 12485,  2392,  7547,  4214, 13540,
+        6,  5014, 10763, 15317,  3582,  8775,  1528, 15624,   160,  5831, 14602,  9078,  5481,  2142,  4958, 13766,
+     6634,  9432,   742, 11328,  5104,  9278, 15145,   571,  8963, 11179,  1314,  5820, 12700,  4385,  7262, 11321,
+     6049, 10690,  8352,  2506, 12757,  6330, 14620,  2919, 15286,    16, 10926,  4134, 14504,  2249, 16273,   321,
+     6291, 14579,  9808,  3337, 13599,  1259,  8902, 12889,   649, 11137,  3854, 13808,  1902, 16300,  1315, 12770,
+     8730,   445, 10059,  7339, 12952,  3219,  5256, 12015,  5982,  9433,  4703,   174, 15891,  7933, 12295,  6411,
+     8567, 11426,  6966,  9938,  5894, 11635,  7240,  2098,  8580, 14256,  6642,  4195, 13792,  2897, 16379,   206,
+    13393,  6764,  4749, 10788,  7649,  3335,  6888, 10421,  5070,  2580, 12648,   469, 10170,  2924, 16124,  3732,
+     8174,   312,  9042, 15270,  9932, 13491,  3441,  7721,  5358, 11310, 16029,  5891, 10988, 15382,  1194, 11951,
+     9107, 14707,  2525,  5693, 13294,  6378, 14021,  7081, 11981,  8407,  2504, 11199, 15868,  7895, 10812,  1519,
+    12506,  3954, 14783,  7054, 13934,  3024,  7999, 12341,  3737, 16230,  7842, 11798,  3000,  8707, 15000,   118,
+    13454,  3285,  5240, 13863,  7557,   640, 12262,  8251,  5096, 12002,  7938,  1645, 12594,  8691,  3472, 11938,
+    10563,  2419,  8088, 12461,  4819, 11492, 16221,  4322,  8391,  2324, 15457,  8835,  4992,  8065, 10856,  5677,
+    15571,  3916, 14116,  2058,  6301, 15134,  7871, 13877,  1394, 14622,  7394, 13442,  3618, 11033,  1162, 15558,
+     4025,  1531, 13615,  3132, 15380,  1346, 13275,  4898, 12519,   293,  8191, 10939,  1860,  7685, 11472,  5215,
+     9815,  1742, 15745,  9570,  1236, 11393, 14541,    15, 15848,  7443, 11083,  4528, 14934,  7763, 10752,  5968,
+    14741,  4284, 12866,  2672,  8268,   860, 15839,  9333, 14082,  2151,  8079,   788,  8650,  3410, 12948,  6907,
+     2901,  7750, 12333, 10179,   771,  9513,  2221, 10067,  4075, 13874,  7424,  4456,   661, 13129,  3308, 15451,
+     5807, 10079,  2367, 11885,  1165, 13003,  4562, 10253,  6414,  2461, 13605,  4973, 15402,  1927, 10417,  4001,
+     7749, 15532, 11624,  1956, 16150,  9197,  4288, 10453, 13652,  2130, 15814,  6412, 10161,  5024, 14016,  7301,
+     4273, 15548,  5812,  1700, 10184,  6439,  2961,  7285, 14534, 11873,  6565,   327, 13262,  3274, 14665,  2475,
+     7623, 11803,  5058,  8582, 12258,   258,  9913,  2886,  6875, 11333,  2175,  8810, 11968,  6030,  9269,  4853,
+    10335, 12720,  5262,  8408, 10955,  4105,  9361, 14851,  3393,  9905, 15546,  5033, 14674,  8896,  3451, 14906,
+     7254, 12764,  3130,  5813, 14990,  8130,  4110,  9255, 11883,  3544,  8429, 13133,  1735,  5135, 13578,   790,
+    11864,  7260, 10588,  5602, 12308,  4928,  7138,  1461,  4187, 10507, 13417,  4790, 14919,  9991,  5508, 11214,
+     4660, 15540,  1322,  7277, 16100,  4861, 14827,  3342, 12582,  1069, 10446, 14905,  9297,  6368, 11533,  8802,
+      375, 13370,  8241,  5530, 10468,  6583, 15779,  1611, 14641, 10646,   347,  9388,  6834, 12970,  5645, 14289,
+     9256,   958,  7065, 10050,  3458,  5960, 14857,  1161,  6801,  9463,  4497, 13144,   798, 11326,  1430,  9300,
+    13083,   964, 13743,  8984, 15261,    85, 14115,  9723,  1535,  5278, 10254, 12398,  7362,  9996,   775, 12143,
+     9563,  1555, 10482, 15968,  3555, 11183,  4817, 15617, 10542,  4207, 15340,  5500,  1722, 14931,  2920, 14163,
+     7447,  2413, 15844,   607,  6680, 14037,  7761,   973, 10591,  6356,  2675, 11826,   674,  5880, 13216,  1081,
+    11096,  4465,  8597, 12039,  2230,  5329, 12969,  6294,  2041, 13825,  1110,  6701,  9457, 11520,  2452,  8638,
+     3399, 15732,  1155, 13948,  2267, 14880, 10125, 12047, 15543,  6523,  3098, 11722,  7212,  1862, 16209,   544,
+    13704,  9339,  4274, 11816,  3127, 11056,  7567,  8988,  6651, 15969,  5267,  1843, 12100,  2645,  4165, 14114,
+     7310,  4512, 16049,  3507, 14382,   184,  9604,  8546,  5368,  7541, 12523,  3389, 11034,  1079,  8503,  2418,
+    11969,  4480, 14494,  5541, 13046, 10813,  2670, 11427,  3747, 14343,  7474,  3101, 14897,  5923, 15983,  2787,
+     6577, 11559,  3545,  7191,  5354, 12651,  8164,  4546, 10925, 13633,  2814,  4107, 15880,  5457, 14003,  6789,
+     4502, 14984,  6078,   927,  7082, 14406,  8977,  1114,  8300, 13669,   583,  9750, 12961,  6810, 10581,   354,
+     8705, 11690,  6103,  9577, 12007,  2545,  5720, 12179, 16228,  3882, 13472,  6926,  9652, 12335,  4012, 10412,
+     6127, 15387,   393, 14049,  9082, 16205,   829, 10610, 15071,  5687, 10062, 14460,  3913, 15577,  6987, 14144,
+    10288,  4831,  9519,  6626, 11256,  8448,  2968,  5805,   474,  8851, 12564,  1342, 14205,  4039,  9687,  8259,
+     6593,  2288, 13184,  5899, 14179,  1786, 13023,   460, 11695,  2792,  8522, 13510,  7016, 16227,  8156,  1303,
+    12207, 10659,  1723,  9093,  7478, 12676,  3989, 12172,  2803, 14180,  4206, 15952,  6109, 13930,  4689, 16094,
+     6375, 12660,  1736,  8868,   251,  7678, 15406,  8493, 12525,   425,  9968, 11795,  8569,  3673, 10724,  8212,
+    14416,  4688, 10394, 14815,  2063, 11093,  3246, 15803,   824,  7044, 14904,  9226,  1177, 11231,  3696,  8897,
+    13519,  2758, 12605,  8185, 13305,  2227,  5793, 12830,  3104,  6430, 12390,  8113,  3853, 16197,  4520, 13361,
+     3497, 14737,  1818, 13203,  4462, 15170,  8787,  1934,  7157,  9103,  1368, 15233,  2293,  7912, 16093,  1661,
+    13641,  2796, 10033,  6561,  3655,  7552, 11620,  3070,  8258,  4592, 12325,  2864,  8866,   212, 12197,  5404,
+     1616, 13104,  3081, 16082,    47,  4507, 14254, 12781,  9636, 14693,  4985,  7955, 10268,  6141, 12656,  3657,
+    14478, 11387,  8670,   274,  8048, 10526,  5450, 15463,  6061, 14358,  4629,  9916,    76,  5648, 10226, 15188,
+     6150,  2926, 14972, 11221,  5042,  2258, 15519,  5956, 11294,   813,  9995,  8115,  1562, 11570,  9733,   451,
+    10865,  3681, 10300, 15870,  4955, 13385,  1587,  4115,  6092, 16368,  5377,  1817, 13517,  6988,   168, 12801,
+     1911,  9509,   545, 12084,  4152,  7810, 13334,  6055, 12253,  8669,  1941,  6349, 13042,  8125,  2134, 16105,
+        4, 11459,  5301,  9727,  3760, 10345, 16370,  4084, 11557, 14719,  4989,  2480, 10963,  1046,  7830, 11388,
+     5606, 10039,  7264,  3725,  8244,   169, 11110, 14338,  4751, 13013, 11300,  5518, 13944,  4663,  9272,  6816,
+     8354, 11678,  5012, 12562,  1537, 13428,  4313,  9681, 15473,   557,  7343, 16339,  6236, 10989,  4218,  8053,
+    15241,  6031,  8961, 11944,  7376, 10935,  6374,  1715,  3822,  7427,  2467, 13661,   163, 15687,  2637, 10894,
+     1085,  5136, 15815,  6428, 15010,  4128,  9663,  3572, 10715,  1468, 11453,  3815, 14562, 12555,  2329,  4874,
+     9573, 12960,  6703,   880, 13711,  9923,  7901,  1371, 15039,  7114, 13353,  2360, 14756,  6995,  3235, 13183,
+     7824, 15079,  7326,  3029, 11518,  6540,  9369, 14134, 10359,  2867,  8131, 15088,  4575,  9644, 15316,  5254,
+     7663, 15647,  6165,  8411, 16081,  1050,  9397,  2522, 10443,  4887, 15603, 11660,  4258, 14397,  6135, 10692,
+     7495,  3347, 15389,  1773, 14070,  7773,   392,  9505,  7528,  1615, 10111, 15782,  5761, 14381,  9426,  2084,
+    15442,   854, 12452, 16112, 10407, 13717,  5414,  2811, 10082,   501,  8322,  3149, 10255,    84, 12864,  3027,
+    14324,   917, 15866,  8010, 10833,  7124, 14368,  1850,  6450, 13247, 11357,  1446, 13541,  2176, 14640,  9716,
+      623, 12436,  4024,  2014, 13742,  2793, 15368,  8028, 11615, 16374, 10730,  5332, 11480,  8579,  4514, 15259,
+     7788, 10382,  3215, 12754,  2078, 12187,   976, 13749,  8199,  7154, 13259,  9365,  3053,  7741, 11151, 13650,
+      528,  3888,  8464, 11943,  5673,  3423, 13997, 10882,  4398,  9160,  5252, 11889,  8753,  4907, 15568,  9031,
+     2603,  5437,   722, 13777,  8392,  2197, 12119,   827,  7279, 12975, 10854,  1062, 12275,  2268, 11233,  3890,
+    12404,  3135, 13488,  2343,  9988,  6815, 14053,  5608, 14608,   214,  7690,  3162,  9937,   593, 12484,  4695,
+     9382, 12982,  6661, 10995,  4417, 12312,  6162, 15031,  2691, 13245,  8442,    97, 12192,  7023,  3334, 13834,
+     6563,  9075,  5109,  1410,  6327,  3229, 12356,  8002, 15907,  4169, 14633, 12230,  7430, 15713,  5636, 10975,
+     4354,  9478,  2429,  3922, 14825,   177,  5768, 12081, 10373,  2508,  4816,  9340,  5609, 12584,  7524,  3260,
+    10699,  6871, 14966,  8590,  5036, 10431,  1000, 13031,  5576,   697,  3563, 14858,  2140,  7075, 13248,  5792,
+     1729, 13830,  9557,  4740,  7349,  8823, 16036,  4995,  2391, 15218,   780,  6505, 15767,  5327,  1130,  8740,
+    15605,  7181, 14431,  1890, 16290,  8987,   466,  6357, 13034,  2940, 15373,    43,  3870, 12328,  1142,  5992,
+    11359, 14086,  9590, 12414,  4348, 15589,  5652, 14802,  4810,  2395,  6464, 13890,  8882,  5781,  7984, 14194,
+     1242, 10911,  5495, 11711,  4787, 12747,  1617, 11292,  3976, 12568,  9309, 13888,  5232, 15315,  8720,  1585,
+    14874,  5583,   708,  8625, 15842,  1374, 11707,  5187, 10613,  6743,  4309, 14002,  8957,  1462, 11796,  4693,
+    12862,  3021, 11184, 14457,  7509,  9676, 15330,  1589,  6001, 10704,  6455,  1200,  3806, 11786,  1886,  7709,
+    15304,  5971, 13082, 10302,  5173,  9183, 16046,  3303,  8453, 14129,  7661, 15308,  3590, 10016,  1017, 15964,
+     5216, 13329,  1297, 11383,  7656, 14365,  9150,  4336,  9973, 13489,  8773,  6243,  9484, 12116,   834,  9188,
+    11858,  6685,   597, 11575, 14598,  2983,  6221, 11095, 12701,  5559,  8633, 12004,  1996, 10385, 14795,  5906,
+     3174, 11495,  4758, 10575,  2734, 12748,  7399, 15754,  1707,  9634,  6749, 10768, 13670,  7463, 10123, 14518,
+     1809,  8208,  3917,  1363,  6980,  9853,  3216, 11123,  7837, 16013,  9276,  4231,  3076, 15727,   672,  9889,
+     6696,  8759, 14736,   305, 15398,  3400,  7448,  8552, 16344,  2726,  6648,  1277, 10883,  2414,  7092, 11957,
+     2971, 10303, 13437,  2562,  6957,  9211,  3152, 13778,   881, 15462, 11208,  3653,  5316, 15212,  7334,  9849,
+      303, 15730,  7876,  2302, 11884,   620,  4941,  9019, 13420,  2174, 14043,  8688, 14924,  6615,  9781, 13507,
+      579, 11528,  6946,  1286, 13798,  2202,  7764, 12822,  1071,  5448, 10885,   348,  8562, 14297,  6580, 11704,
+     2434,  9204,  3714, 16180,   431,  5926,  3016, 15609,  1939,  6611, 12464,  1227, 15956,  4170, 14300,  2918,
+    14942,  3983, 16265,  8333,  1379, 10153, 13107,   187,  9127,  3370, 10912,  4366, 13459,  8051,  4136, 12348,
+    10035,  1442, 13336,  6196,  8299,  4104, 10105,  4965, 11432,  3584, 14281,  5519,  2056, 16333,  3077,  4633,
+    12863,  6452, 16132, 10914, 14626,   104, 13600,  8792,  1491, 12016,   324, 14452, 11489,  6234, 12933,  4863,
+    16249,  2688,  7589,  4215,  9060, 10778, 14285,   630,  5939, 10232, 15115,  7973, 13163,  5817, 16184,  4018,
+    14136,  7738,  4237, 11327, 14362,  4764, 12760,  7275,  8874,  5875,  1880, 12661,  7976, 10447,  2528, 14883,
+     4121, 10600,  5493, 13587,  4419, 14841,  6948, 11060,  3539,  7632, 11482,  5081,  2579, 12692,  4808,  3510,
+     8749,  2701, 15034,  8293, 11045,  6182, 11751,  4407,  9625, 15759,  3878, 13070,  2831, 11213,  4387,  8216,
+    13933,  6174, 12690,  4605, 10165, 12380,  7059, 11144,  8240, 14582,  4717, 10582,  3306,  8136, 10202,  5410,
+     7577, 10794,  2485,  5715, 14087,  6856,  4431, 15594,  7609, 14233,  1619, 16353,  6915,   329, 14165,  2239,
+     7464, 16017,  8899,   121, 15225, 11815,  1074, 14721,  8090, 12433,   692, 10403,  8346,  6586,  9419, 12054,
+      332, 10515,  2509,  7621,  4742, 11906,  6046,  3823, 13239,  5422, 10146,  7435,  1777, 10495,  3351, 11829,
+     1577, 13177, 10284, 13783,  6433,  2125,  5102, 12972, 11908,  1873,  4533, 11564,  3538,  9711,   313, 11171,
+     8494,  1132, 15521,  6370,   201, 10093,  2044, 16098,  3494, 14230,  9798,  2876, 16247,   753, 13515,  5961,
+     8642, 12587,  1158,  8210, 10271,  2650, 13077,  1058, 15615,  9999,   316, 16060,  9223,   862, 14402, 10638,
+    16316,  5421, 12182,  4179,  2970, 15581,   673, 14728,  6903,  1730, 12170,  7218, 14912,  5846,  1798, 15689,
+      134,  9774,  1901, 14669,  8400,  1433, 13624,  3995,   236, 11765,  2674, 13951,  6935, 12905,  1841, 12533,
+       71, 13546,  9028, 12087,  3718, 11350,  1916,  9823,  2606,  6105, 12507,  9544,  3500, 11586,  9264,  6325,
+    12841,  4567,  3607, 11127,  6831,  2533, 13520,  5984,  2179,  7261, 15861,  4519, 13233,   966, 15126,  5766,
+     8694, 14842,  5333, 13073,  9251,  2050, 15850, 10658,  6817,  2899, 15371,  4662, 13457,  8372, 15153,  7345,
+     9375,  3664,  5726,   910, 11475, 15897,  9641,  3797,  7133, 13718,  9002,   843, 14718,  7560, 13560,  6223,
+     2252, 12856,  9325,  3317, 14792,  7919, 12060,  5090, 10949,   413,  7586, 11530,  6269,  9123,  5026, 12005,
+     1789,  6835, 14150,  3479, 16349,  6146,  8500, 11749,  5738,  4509, 12522,  7226,  5930, 11222,  8068,  1607,
+     7153,  9955,   328, 14268,  9307,  6653, 10127,  3437, 13613,  8822,  4690, 10503,   842,  9048, 12921,  6802,
+    11996,  4895, 10976,  7269,  2584, 15806,  5369,  9287, 15176,  5851,  9809,  7832,   482, 15550,  6034,  8534,
+    15214,  4658,  7100,  1012, 15396,  7438, 13432,  4917, 14846, 10550,   679,  5176, 15040,  8376,  2879, 15438,
+      819,  9786, 14056,  5285, 14552,  9399,  4363, 10806, 12904,  3977,  8627, 11731,  2769, 11185,  3487, 13512,
+     1952,  4056, 11680,   873, 14350,  3591,  8465,   651, 14938,  8043, 12339,   971,  9692,  2542,  5281,    38,
+    14544, 12296,  8594, 14996,  3180,  8037,  1325, 14649,  8348,  2991, 15999,  5507, 12183,  2799,  5009, 10174,
+    15798,  4650,  7324, 12391,  5379, 13538,  1181,  9470,  6655, 12944,  4468, 14481,  1300, 13086,  3299,  9602,
+    15948,  3874, 11003,  9347,    42, 12267,  4023,  1990, 13844,  9414,  2976, 13316,  1806, 15458,  3272, 13873,
+     3864, 12901,  7884,  4990, 13358,  1494, 12603,  5656, 11280,  2566, 16213,  6115, 13866,  3404, 10113,  2683,
+     7777, 15090,  3326, 14024, 11579,  6547,  3134, 12989,  7530,  2094, 16147,  5003, 11417,  4365, 10922,  3142,
+     9719,  2107, 13012, 10607,  3282,  9294,   444, 12210,  8488,  3978,  7923, 13197,  5821,  1186, 12041,  5039,
+    10965,  7791,  1973, 12223,  1271,  7670, 16165,   386,  9071, 14961,  1500,  6322, 15435,  7843,  5085, 10237,
+     7233, 15792,  8120,  6276, 10324,  7170, 13852,  4545, 11569,  2161,  9146,  5887, 16104,  6981, 13707, 11192,
+     6336,  1963,  4626, 10592,  6867, 12491,  5305, 11098,   109, 10068,  6504, 10681,  1792,  8809, 15209,  1338,
+     8151, 11679,   776, 10717,  2364,  8742,  3971, 15086,  2548, 15711,  8422,  3710, 10706,  6938, 14761,   480,
+     7769, 12798,  2189,  5661, 15151,  7058,  9870, 14685,  7909,   725, 15119,  4213, 10479,  5205,  9623,  6342,
+    11898,  1169, 15264,  2383, 11401,  4522,  8523, 14495,    54,  8188,  9801,  1370, 11510,  5295, 15478,  4267,
+    13451,  1087,  8829,  5498,   537,  9633, 12204,  1031, 10851,  3844, 11977,  1546,  9067, 14500,  1125, 13857,
+     6364, 15855,  8277,  5067, 14700,  5616, 16160,  6536,  1336, 11774, 15905,  2301, 10797, 14480,  7291, 13630,
+     3288, 15737,  5739,  8679, 13075,  3471, 10269,  7083,  2892,  5828, 13801, 10026,   180,  9320, 14216,  1260,
+    12655,  9092,  2982, 15252,  1622, 12554,  2710,  9982,  6207, 14071,  3495, 12787,  4000, 10744,  1440,  4340,
+    15944,  7797, 13998,   438, 15536,  2569, 13568,  6185, 15374,  4732, 13271,  3921, 14391,  7188, 12529,  4190,
+    13992,  3064, 14951,  5893, 16003,  7003, 11249,  6089, 11791,  1553, 10162,  5690, 15362,  2339,  8279, 11619,
+     4628,  6388, 14404,  8727,  2858, 13448,  1427,  4906, 10799,  6254, 11598,  8570,  7405, 12381,   128, 14755,
+     9050,  5705, 10430,  6873,  8885, 16070,  2097,  7556,  5078, 13276,  4151, 15049,  7915, 12633,   395,  8418,
+    10760,  6265, 16287, 10419, 13240,  4126,  7175, 14948,  5134, 14058,  8466, 13106,  6813,  3450, 12360,  5230,
+    11746,   726,  3920, 12307,  1582, 10051,  2732, 11053, 14012,  3110,  6279,  9893,  4396,  8865,  1775,  6557,
+    10445,   300, 11610,  2783,  6416, 15309,  4771, 14186, 11048, 12148,  3371,  5357, 12396,  2446,  6808, 11507,
+     4489,   447, 13680,  5004, 11259,  5721,  8872, 16233,  1335,  7710, 11156,   412, 14679,  8184, 12577,  9096,
+     2443, 12076,  9978,  6008,  9186, 11747,  3594,  8833,  2185, 12340,  1099,  7936, 11428,   471,  5660, 10585,
+     6447,  9537,  3850,  9971,  1675, 12715,   491, 14126,  4798,  7789, 13748,   122, 12153,  4275, 13947,  1604,
+    15480, 10048,   901, 11945,  5188, 11194,  7595, 16009,  2331, 14320,  3621,  1308, 16217,  2659, 13164,  4479,
+     1964, 15858,  3168, 14005,   755,  6139, 12128, 10211, 15633,  3113, 10649,  6482,  2337,  9434,  6921, 14585,
+     2170, 12352,  3768,  1600,  8134, 14437,  2308,  8713, 10295,   629,  6219,  2560, 14833,  9921,  8021,  2332,
+     8796, 10257, 14319,  7776,  6772, 13793,  8097,  4477,  9083,  7230, 12964,    25, 15186,  3780, 12588,  9314,
+     4729, 14635,  7978, 13827,  9586,   635, 12520,  2018,  8148,   990,  9535, 15992,  7539, 14532,  3751, 16255,
+     6108, 10934,  6954,  9665,  3713, 12935,   225,  5293, 11813, 15445,  4942,  9843,  6605,  3015,  5613, 14395,
+     7258,  3865,  1152, 13115,  4400,  1511,  7651, 14215, 10838,  6771,  9446, 15587,  3261,  9154, 16272,  2033,
+    13105,    69, 13620,  7487, 14445,  4587,  9168,  3415, 10467, 12449,  2985,  9232,  7227,  9756,  6179, 10855,
+     3155,  7282, 13208,  4159, 15787,   549,  9172,  3821, 12873,  6805,  8964, 13690,  5789, 11285,  6681,  8374,
+    10924,  7644, 11700,  4053,  9767, 14964,  3773,  1101,  7031, 12508,   641, 14169,  3840, 15925,  1705, 11352,
+     5725,  9329,  7580, 15337,  4850, 11129,  6011, 16030,  3525,  7916, 15631, 10477,  5512,   194, 16320,  6645,
+    15085,  4535,  2815, 11305,   262, 12714,  2153, 14575,   911, 15682,  4877, 11412,  7751, 13891,   962, 16207,
+     2407, 12097,  4038,  1565, 11207,  5547,  8960,  6762, 15549,  4980, 13364,  1870,  4249, 10548,  8766,  1557,
+    13254,  2624, 14695,  1095, 15714,  7881, 14483, 10416,  3896,  1895,  7209, 13310,  1231, 15706, 10334,   601,
+    10987, 15260,  8270,  5441, 16286, 10459, 12669,   664,  4144, 14927,  2476,  5204, 13482,  6905,  3580, 11805,
+     7743,  8864,  5125, 11538,  2882, 10908,  8087, 16331,   916,  6483, 14570,  5005, 16048,  1056, 13313,  5393,
+     8944, 11392,  2031,  8024, 10362,  6477, 12406,  5528, 10217,   289, 12023,  4772,  9928,   982, 15206,  2934,
+    13576,   467,  5158, 12735,  8145,  2613, 11080, 13907,  9087,  5516, 11637,  7468, 13114,  5138, 10322,  4552,
+    13782,   749, 12973,  2903,  9894,    23, 12422,  1799, 13315, 11219,  1311,  4250, 13685, 11539,  3813, 12581,
+     1273, 13217,  6117, 16042,  9455,  5352, 11688,  6023, 10402,  3552, 12374,  2030,  5338,  6826, 11118,  8173,
+     5874,  9855,  7197, 15941,  4427, 14862,  3067, 13145,  3816, 10720,  6513,  8491, 11917,   770, 12749,  7389,
+     9860,  4768,  8224, 12086,  3247,  6570,  2291,  8504, 13588,  9390, 14819,  2660, 11979,  8632,  3444, 12886,
+     5047,  2114, 13640,  9709,  2910,  7086,  5015, 15746,  8395,  5858, 12088, 10383,  1580,  9778, 14147,  4687,
+    15055,  2680, 15757,  1068,  6718, 15288,  1872,  5489, 13384,  8700,  1997, 11443,  3612, 12572,  2757, 15658,
+      281, 14609,  5946, 13725,  3223, 14801,  1670, 14055,  3013, 15567,  7967,  2152, 14485,  4108,  8814, 12273,
+     5554, 10021, 14619,  1680,  5966, 13204,  6716,  4326,  1877, 14682,  2754,  9662,  1233,  8509, 12176,  3157,
+     7327, 14864,  5229, 11647,  6720, 13850,  4470,  9468,  6899,  4754, 12802,  9238,  7067,  1983,  7658,  9592,
+     5635, 10971,  7502,  1822,  3742, 15468,  8685,  2921, 13345,  9603,  8248, 15364, 10229,  2805, 13429,  3635,
+    15021,   703, 13279,  2194, 10363,  7578, 11744,  1243,  9253, 14733,   351, 14044,  5928, 15338,  5517,  3119,
+    15046, 11372,  2067,  9201, 13972, 10784,  4264, 12311,   844,  6314,  4476, 10877,  7579,  4757, 14127,  6897,
+     8895, 11597,  6122,   189, 11381, 14708,  1720,  9949,  3201, 13770,   286,  7455, 12780,  6119,   859, 11074,
+     1466, 10323,  5774, 12834,  9611,  4266, 12134,  7383,  9899,  4043, 15232,  7674, 10388,  6757,  8519,  4094,
+    12279,  4891,  9683,  1119, 11672,  4563,  8236,  9583,  7147, 11091,  3463, 12657,  6192, 10765,  7347,  1413,
+    15657,  2424,  7076, 10622, 16195,   226,  9533, 15450,  7798, 10815,  4661, 16362,  5948, 14388,   185, 15756,
+     9054,  2444, 10177,  1392, 15882,  3198,  7728, 15222,  2689, 14291,  8388,  3088, 15326, 10664, 14101,  2943,
+    14732,   504,  8560, 13509, 10529,  4794,   696, 14908,  6933,  1597,  5765,   518, 14238,  8628,  1483, 10570,
+     4851, 12427,  6233,  8520, 14367,    95,  6039, 16363,  7795,  2668, 11488,  3275, 10084,  2213,  8327, 13737,
+        9,  6302, 15513,  5344,   584,  7035, 15918,  5780, 15030,  8057, 12995,   111, 16347,  1953,  9605,   920,
+    15557,  4109, 14947,  7853,  3740,  8708, 13209,  6579, 11831,  8982,  4888, 16092,  2932, 14673,  8564,  5413,
+    12478,  7056, 14322,  3647,  8373, 13887,   263, 14860,  2611, 13074,  5985,   524, 14023,  1747, 15026, 10006,
+     7875,  2433, 16291,  8619,  6691, 15446,  2642, 13252,   919,  5317, 14881,  9301,   589, 15965,  3202, 11830,
+     4590,  9196, 14174,  3477,  8644,  4820, 11854,  3018, 12885,   432,  7195, 12418,  3599, 10983,  7951,  4141,
+    11828,  6110, 12614,  8330,  5815,  8980, 10823,   977, 12059,  6344,   391, 11859,  5884,   885,  4948,  8846,
+    12096,  4174, 15282,  2535,  6461, 14121,  7868, 11022,  4320, 16310, 11892,  7380,  4216, 12725,  6429, 15829,
+     9118,  2927, 11558,  5171,  3413, 12891,  9965,  4287, 12250,  5310,  7305, 15665,  4837, 13097, 11068,  4367,
+     9423, 12407,  3950,  7662, 13327, 11871,  1503,  9735,  3083, 11551,  3671, 10167,  5543, 12283,  6407, 13392,
+     3126, 10073,  1407, 12551, 14017,  2323,  5533,   949, 14429,  2053, 10992,  8119,  4444, 11365,  2273, 15961,
+     4031,  9247,   581, 11891,  2183,  6267, 11216,  4939, 10762,  1382, 11994,  9456,  5234, 11108,  5799,   783,
+    14298,  6979, 10977,  3667, 12620,   131, 10630,  5908, 16114,  8492,  1774,  7519, 13033,  5106, 13802,  8193,
+     6401, 12431,   879, 11343,  5751, 13745,  1479,  8942,  6247, 15104, 10251,  1593,  9233,  2234, 13597,  6883,
+     1061, 15405,  3690, 14187,   526, 13440,  3925, 14664,  5209,  9690, 16113,  4003, 10110, 12879, 15808,  1640,
+     6571, 10019,  5268, 12663,  9344,  1428, 12269,  3304, 13026,  8936,  2599, 14655, 10023,  3256, 11339,   250,
+     7494, 14080,  1352, 15674,  8884,  6984,  2454, 14235,  1584, 13551, 10487,   940,  9173,  7119,  1326, 16177,
+     7813,  1823, 14356, 10261,  2835,  8916,  5032, 14224,  7360,  1696, 15279,  8375, 14327,  2788, 11041,  5220,
+     8086, 11933,  6699,  4643, 10370,  7328, 15879, 10709,  7596,  3944, 15277,   744, 13902,  7176, 10049,  6610,
+    13365,  2998, 15394,  7537, 10213, 15915,  3356,  9084,  7087, 15723,  8200,  3225, 16166,  2292, 13609, 11868,
+     3348, 12966,  1495,  5582, 14181,  9068,  4811, 12173,  3733, 11355, 13961,  4307, 10339,  2055,  9714,    10,
+    14835,  3897,  7604, 15298,  2187,  7903, 15902,  5180, 12043,  3933,  8255, 14095,  6544, 15208,  5319, 12761,
+    10434,  8061,  2010,  9560,  5029, 12226,  7040,  2212, 11369,  7850,  1716, 13606,  7183,  2290,  8064, 11063,
+    13904,  3214, 11595,   975,  7320, 15849,  5548,  9945,   159,  6345, 10853,  5191,  1093, 13651,  5604, 14781,
+     4511,  9737,  6783, 10776,   908, 15205, 11315,  5735,  9613,  8215,  3625, 12056,  4029, 14615,  6071, 11675,
+     3511, 10734,  6490,   992, 16075,  3800, 11337,   360, 10460, 13187,  6084,  4147,  1268,  8795, 15791,   346,
+    14507,  2487, 16118,  9407,   556, 12265,  4296,  2865, 13002,  9670,  6362, 12538,  8754,  1667, 12248,   176,
+     8014, 10629,  5030, 13009,  1276,  5607, 12638,   806, 13674,  2862,  6384, 12702,  4692,  8861,  7194,  4411,
+     9363,  6245, 15096, 10160,  2092,  7460, 15250,  1372,  9847,  6380,  2798, 12313,  6840, 15148,  6041, 11173,
+     2731, 13349,  9595,  4443, 10331, 13017,  3238,  9962,  1011, 13414,  2588,  4936, 11496,   730,  9741,  2878,
+     4644, 14513,  6377, 11087, 16257,  1510, 10258,  8548, 15511,  3420, 12460,  4496,  9026, 14870,  3601,  5750,
+       81, 16201,  8235, 13141,  4047, 10751,  2354, 14512,  7554, 13974,  2060, 15975,  7772,  9473,  1856,  8133,
+    12030,  2099, 13522,  3899, 12659,  4911,  7947,   543, 14957,  2132, 15921,  6641, 13847,  2403,  9805,   677,
+    14929,  4889, 13619,  8405,  5590, 12706,  8123, 15607,  5378,  2417,  9312, 12559,  7102, 13741,  4369,  7484,
+    10518,  5775,  8495,  3430, 15108,  6210,  9074, 14830,  5795,  1339, 11553,  5279,  3240, 15667,  5665, 14902,
+     3724, 14120,  1771,  8849,  4193, 14584,  8054, 11554,  4525,  9783, 14425,    32, 10194, 14699,  1223, 10676,
+    15946,   365,  8326,  4140, 13532, 11573,  3257,  8180, 14440,   385, 15718,  8931,  1092, 11627,  3532, 16341,
+     8839,  6968,  1269, 14057,  6595,   534, 11461,  7101, 14773,  5824, 11145, 15676,  3428, 13067,  8598, 16072,
+    11588,   291, 13137,  2570,  7671,  4341, 13985,  5654,   170, 10615,  6203, 14400,   683, 11437,  6727, 12330,
+     9499,  7009,  4701,  1900, 14981,  6161,  8717,  3685, 11397,  4676,  8526, 12319,  3935, 15420,  6677, 13047,
+     3492, 16244,  5935,  8378,  2722, 10150, 13906,  4150, 12345,  6137,  8853,   242, 10624,  8023, 12612,  5671,
+     8697, 12925,  2534,  9882, 14787,  1917,  6647,  3309, 13925,  7793, 16161,   577, 11237,  3336,  9698, 12184,
+     2043, 13098,  1080, 10921, 12843,  1813, 11659,    18,  8276, 16241,  2574, 13612,  9872,  4277, 10866,  2420,
+     9398,  5950, 11691, 16282,  6441,  9957,  2388,  6861, 15428,  1652,  5456, 11301,  7705,  3720, 13170,  2947,
+     7392, 12537,  2567, 11131,  6018,   686,  7008, 12447,  5170, 10944,  7820,  3826, 13594,  5630,  8363,   745,
+     4963, 12752, 10537,  3401, 15590,  8530,  4186, 12578,  2322,  9121,    91,  7659, 10060,  6069,  1358,  4022,
+     7231,  9371,  5406, 15008,  8859, 11913,  2960, 12782,  7431, 14953,  2612,  9909,  8306,  5092, 15677,  1241,
+    13462,  2747, 14282, 11215,  9094,   405, 12164, 15586,  1230, 13371,  6063,   600, 11639,  2755, 10372,   857,
+    11038,  9055,   371, 11899, 15542,  1708,  9155,  6520, 10943,  3220, 12996,  5124, 15285,  4471,  3025, 15836,
+     1635,  6855, 11234,   199,  4557, 12200,  9088, 10861,  1054, 11727,  4713, 10034,  6538, 15155,  1532,  6178,
+    15424,  4791, 14208,  7171,  3979,  8042,  5132, 13419,  9465,  3645, 10464,  7720,   439, 14399,  6493, 13206,
+    12098,   717,  7316,  2714, 11009,   343, 13967,  3919, 12202,  8288, 13410,  2201, 15569,  5963,  8451, 11734,
+     4947,  8985, 15684,  4603, 14560,  9740, 16193,  2231, 13439,  4440,  1648, 14735, 10095,  2275, 13112, 10739,
+    14342,  2019,  5482, 12174,  6005,  1923, 14488,  9485,  5373, 16155,  6769, 13702,  2042, 14886,  7849, 13894,
+    10868,  1863, 12378,  3801,   707,  6512, 15739,  1224,  9227,  4869, 11802,  1437, 13341,  3010, 10273,  4282,
+     8496, 10579,  5389,  7718,  3361, 13557,  5018,  6823,  9817,  3009, 15131,  9200,  6964, 14133,  5250, 14997,
+     6309,  4112, 14505,  5403,  7270, 13128,  2981, 16110,  1052, 14444,  7403,  9668,  1505, 13319, 10974,  7576,
+    12107,  3338, 15354,  7445, 13816,  6032,  2649, 12955,  7232,  3626, 14420,  2156, 13292,  5154, 12773,  8220,
+     3708, 11391,  8940,  2684, 15654, 10000, 14548,  2244,  6748, 14247,  4720, 15156,  7038,  9117,  1253,  8176,
+     4777, 15069,  8639, 13500,  5294, 15257,  7408, 10693,   960,  9386,  3429,  6741, 12300,   647, 14903,  1943,
+    14140,   938,  6608, 11960,  1746,  8646,  3988, 10483,  6526,  9138, 11934,  7274,  4753, 15527,  6666,  4026,
+     7885,  9940, 15990,   283,  8914, 13553,  7506,  1380, 10942,  2965, 12095,  4334, 10544,  4872, 11849,  2789,
+     5672, 15552,  6939, 10587, 14330,  9789,  4601, 11024,  3561, 13547,  6953, 16357,  5931, 12542,  7396, 14521,
+     2416, 15395,   768, 12018, 15955,  9598,  2144,  8036, 12696,  4285, 10628,  1725, 13226,  4455,  8776,  2396,
+    12541,  7835,  9883,  1234, 10688,  4433, 11717,  7711,  4709, 10256,  1982, 11959,  6740,  9000,   477,  4737,
+    14476,  9245,  3993, 10427,  1386,  9576, 14994,  4331, 15472,  8595,  5936,  8997,  3020, 10738,   815,  9288,
+    13860,   222,  5580, 12080,  6548,   688,  4482, 10846, 12590,   978, 11967,  1881, 12877,  3796, 16074, 11421,
+     3109, 10398,  4111,  1173, 12694,  3293,  9025,  4912, 15982,  5741, 14242, 10456,  4344,  9609,  6913, 10829,
+     5412,  9977, 13835,  3418,  7722, 12908,  5468, 14089,   869, 15892,  3060, 12716,   219,  8672, 11752,  1473,
+    15095,  2634,  7388, 11531,  4793, 10703,  3721, 15224,  6397, 12954,  8321,  1188, 15429,  8812,   454, 14563,
+     8417,   981, 13369,  3117,  8155,  1759, 13765,  7581, 15215,   486,  9589,  4068,  2045, 10951,   304,  9157,
+     5623, 12746,  7198,  4457,  1477,  6390, 14610, 10905,   825, 16119,  5452,  8205, 11107,    49, 15692, 10181,
+     1498, 13750,  3176, 15320,  6848, 14153,   123,  8733, 15150,  5534, 13689,  3875, 16301,  2863, 13950, 10188,
+     6232,   905, 11804,  5451, 16231,  8189,   657, 10292,  1765, 11999,    51, 11431, 14647,  7735, 15979,  3218,
+     6774, 10149, 16277,  1647, 13563,  8736, 15269,  7491,  3387,  5991,  7980, 11217,  5513, 10135,  6158,  2007,
+    13861,  6652, 15797,  9769,  5863, 11273,  1816, 12444,  2828, 11862,  7918,  1345, 16382,  2648, 13570,  3898,
+    15417,  7972,  1443, 10559, 14840,    94,  9497,  2857, 11390,  7996,  5275,  9667, 14228,  3292,  5728, 12347,
+     9429,  6321, 13926,  3139, 14916,   906,  7985, 11668,  4582,   622, 14128,  7364,  3676, 12695,  6614,  9886,
+     4401, 12026,  9038,  4979, 16137,  6054, 11625,  2380,  8729,  5473, 12997,  8132, 14168,  6371, 15531,  3509,
+    11501,  1751,  9852, 13993,  8280, 11760,  3817,  5710, 13791,  7488,  2264, 14849,  3520, 12778,  5662,  7340,
+    11485,  4944,  8512, 11241,  2497,  9396,  3684, 12868,  2295, 11175,   624,  8501,  5843, 11425,  7914,  2169,
+    15639,  7145, 13416,  2785, 12492,  4825, 14098,  6719, 13516,  4964, 15835,  6977,  1864,  5639,  4269, 11793,
+    14826,  2405,  7932, 11201,  5269,  2841, 10315,  1438, 13120, 15943,  9322,  2992, 15366,   836, 14172,  7574,
+    12302,    98,  8319,  2297, 14688,  7633, 13818,  6543, 14854,   205,  4674, 13056,  8671,  5249, 11420,   279,
+     9153,  3023, 12637,  5870,  3808,  7249, 15351,  6136, 13069,  1294, 15050,  2372,  7048, 10842, 15805,   605,
+     4467, 13175,  1159,  9216,  6859, 12634,  9639,  2523, 15722, 10294,  5115,  9244, 11109,  2356, 13566,  3332,
+    15896,  6225,  2180, 12884,    61, 10038,  3856, 12583,  6670, 10552,  3140, 11692,  1007,  9739,  4968, 13225,
+     7921, 15084,  5975,  2880, 10411,   197, 15334,  8953,  3182, 10126, 12066,  6473,  9526,  7687,  2907, 14309,
+     3756, 15909,   507,  6087, 13391,  5105, 15810,  5917,  9910,  7126, 14763, 12457,  1344, 15052,  5231, 12854,
+     4293,  8800,  1852, 10648,  7653,  3536, 11270,  2374,  7954,  9958,  3909,  9508, 13708, 12456, 10475,  1261,
+     7523,  4923, 12646,  3762,  9569, 13994,  6133, 11696,  8583,  4897,   245, 13534,  4432,  8784, 11036,  3534,
+     9479,  5103, 13244, 11607,  4375,   591,  9571,  3829,  8502, 10282,  7180, 11140,  2083, 15183,  7513, 12874,
+     6496, 11646,  4718, 16054,  8393, 12190,  1834, 10225,  3648,  8561, 11066,  5994, 13756,  4166,  9003,  7587,
+    14645,  5385, 11004,  3930, 16281,  2113,  5272, 13354,  7156,  3175, 14660,  1659, 16236,  5976,  8114, 11375,
+     1481, 10409, 15044,  6766, 11302,  5247, 14118,   899, 15985,  1682, 14637,  4517, 15820,  7646,  2250, 10463,
+      606,  3973, 12206, 16220,  4826, 12941,  7306,  1586, 12399,  4970,   424, 13527,  1378, 16345, 11806,   991,
+     9705,  6622, 11965, 14822,  1676, 10423,  8332,  1160, 12237,  4103,  2662,  6484,  9366,  3237,  9831,    87,
+    11058, 14219,  5748, 15495,   376, 14624,  8951,  5840, 12681,   969, 14917,  2801,  8294,   485,  6228, 14288,
+     9730, 13383,   884, 14967,  7338,   369, 15773,  4106,  2536, 14727, 10698,  6947, 12437,  2334,  5320, 14866,
+     1540, 15490,  2950,  7027, 10343, 16223,  5557, 13132,  1574, 15634,  3217, 14549,  5842,  9827,  1153,  4196,
+    15736,  2173, 13338,   613, 10990,  2592, 13698,  6878, 16297,  4807, 14426,   782, 10012,  1624, 12558,  2782,
+    11346,  1851,  8112, 12108,  5904, 10163, 14393,   153,  8867, 11973,  5742,  9757,  4257, 12177,   252,  5322,
+    13805,  7613,  4077,  9528,  2704, 15399,  7142,  9266,  4797, 11135,  6097,  8925,  2765, 12294, 13839,  6916,
+    14747,  8854,  6573,  1154,  9316,  2481, 11153, 14081,  6009, 15515,  8356,  4010, 10511,  4578,  8702,  7069,
+    13298,  2013,  8976,  3960,  7745, 12698,  3316, 14387,  7550, 15601, 10560, 13486,  4920, 14326,  7341, 16051,
+     3727,  8099,  3054,  9466,  6462, 12077,  1538, 16012,  3227, 10998,  6572, 12125,  5086, 15297,  8806,  4037,
+     2065,  6417, 10608,  3160, 12224,  5730,  8342, 12500,  7216,  9691,  5633,  1330, 16342,  7803, 12058,  6820,
+    10623,  6047,  9169, 14374,  1406,  8063, 11745,  2495, 10915,  6200,  9306,   738, 12601,  3564, 14019,  8073,
+    10206,  6168,  9556,  7590,  5097, 14576,  4246,  9241,   406, 11860,  3206,  7446, 13291,  8433,  6244, 16138,
+     9558,  6588, 15475,   458, 13819,  3383,  8367,  6214, 10859,  1969, 13140,   861, 13956,  7053, 15200,  8743,
+     2893, 12474,   690, 14379,  8591,  1403, 12160,  3375, 13598,  8029,   220, 13158, 10088,  5365,  1320,  4198,
+    11363,  3055, 10936, 13653,  5264, 14489,  6723,  3589,  9666,  2682, 11330, 14687,  6197, 13945,  2518, 15234,
+     5309, 12373,  4691, 10835, 16219,   709,  6668, 11384,  4571,   315,  8195,  1885, 11833,   967, 10387,  5979,
+    12318,  1304, 11508, 13720,  4222, 10115,  5044,  8549, 13160,  4491, 14184,  1447, 10325,  2484, 13000, 10938,
+    15585,  8430,  4406, 16076,  9170,  2181, 11007,  1021, 13333,  1929, 14214, 11527,  3287,  9993,   415, 13700,
+     3911, 12514,   791,  4848, 12946,  3461, 15032,  5201, 14166,  4263, 13694,  8302,  6623, 10718,  5052, 12117,
+     2766, 14260,  1369, 15102,  8709,  1022, 11517,  5659, 12688,  7877, 10450, 15245,  2093,  4613, 14076,    75,
+     3809, 12846,  2955,  8769,  4393, 11768,  1567, 14865,  3974, 15978,  6552,  8609,  3502, 10672,  2082, 10119,
+    14769,  5637, 11661,  4531,  7804, 13214,  5808, 10291,  2143, 14847, 11515,  3605,  7089, 14469,  8616, 16040,
+     5694, 13053,  1987,  7533, 10244,   510,  8667, 15857,  1027, 13135,  7014,  1928,  9212,   687, 11139,  3398,
+    10103,   238, 14618,  2347,  5621,  9788, 13928,  2198,  9517, 13174,  5492, 15936,  8825,  4423, 12711,  2365,
+     9207, 14982,  6972,   762, 12827,  2235, 15169,  7177,   257,  9380,  7545,  5526, 16358,  7869,  3453,  5848,
+      136, 13629, 11592,  1343,  6804, 14433,  5061, 15431,  3548,  8121,  4220,  8908,  6329, 15076,  4681,  8532,
+     2091, 15906,  7900, 11182,  6262,  8945,   352, 10041,  7786,  1078, 11360,  2709, 15877,  1794, 14969,   441,
+     8887,  5565, 11198,  3179, 10663,  6722, 13151,  2938, 15514,  1513,  5361,  3902, 12231, 10687,  5594, 11643,
+     7713, 10108,  5143, 15013, 10491,  7323, 13005,  4849, 12276,  7756,  2756, 11513, 15522,  5011, 12934,  3873,
+     6852,  1210,  9779, 16303,  3186, 10997,   443, 15662,  7419,  4230,  6404, 15367,   805, 11853,  2530,  9545,
+        0,  8344, 15693,  3333, 14884,  4362, 11879,  5598, 10694,  7752,  4744, 12573, 15641,  5763,  7993, 12892,
+     6352, 13697,  8261,  7390, 12151,  3628,  8535, 15421,  6209,  3128, 10984,  6999,  3442, 15217,  6756, 13996,
+     5315,  4014,  8390, 16276,  5593,  7846, 11349,  3682, 10796, 15616,  2956, 13355,   731, 11841,  6865, 14553,
+     9308,  2914,  5483,  8031, 12947,  3893,  9839,  6453, 11888, 10415, 15613,   734, 12771,  2581, 11353, 14539,
+     5762,  9908,  2750, 14034,  1844, 15579,  6839, 12560,  3717, 16146,  7079, 12277,  5477,  9214,  7295, 12990,
+     3769, 16204,  7052, 13632,  4416, 15851,  2126,  9952,  6402,  8903, 13963,  6951,  9290,  1088, 15400,  2507,
+    14564,  1402, 13375,  6739,   961, 15865,  2601,  9199,   555,  9918, 14275,  1175,  7515,  9281,   483, 15831,
+     8312, 13427,  7353,  1871,  6479, 13941,  9056,  5069, 12836,  9813,  1827, 10757,  7948,  4900, 13497,  6636,
+    12149,  4624,  9829,  6212, 12477,  8003,  1654, 13388,  3931, 15118,   115,  9984,  2844, 11724,  4227, 15938,
+     1629,  9408,  3154, 15583,  1216, 13001,  4843,  1450, 11738, 14573,   779, 13744,  9994,  1566,  8558,   468,
+    10785, 13307,  1790, 10470,  3194, 14405,  1211, 13812,  6292,  1897, 11578,  8360,  9929,  4291, 12410,  1688,
+    11161,  7422, 15135, 10046,   619, 13773,  2469, 14775,    70,  4782,  7080, 13590,  5208,  9549,  7369,  1036,
+    13166,  4099, 11834,  7292,  9707,  4504, 10837,  2246, 13257,  9511,  4829,    52, 13474,  3122, 11596,  4611,
+    10375,  1936, 11903,   162,  9771,  5953,  8103, 14804,  3530, 11272,   267, 15977,  2825, 12992,  7190,  8856,
+     4885, 11172,  8217,  2314,  9661,  5584, 11289,  7002, 15287,  5363,  3290, 13513,  4472, 12591,  6148, 11069,
+     2373, 11953,  4762, 14656, 10172,  3967,  2479, 11911,  1070,  8358, 14014,  3774, 16250,  1486, 10349,  3445,
+    15255,  1800, 13897,   897, 11065,  2752, 16294,  9167,  2286,  8581, 13849,  5392,  8211, 14229,   944,  7229,
+    10609,  5131, 11585,  5937, 11075,  6814, 14845, 10353,  7805,  5164,  9191,  2834, 12162,  4747, 11324, 15796,
+     6382,  2771, 12246,  9063,  6688, 11927,  9562,  5241,  8689, 14750,  3951,  5973, 15001,  2285,  9020, 15904,
+     4878, 12808,  2004,  4619, 11788,  8858,  5865,  7780, 12691,  9303,  2873, 10864,  1825, 16156,  3475, 10564,
+     8206, 15175,   141,  5341, 12261,  3144, 14659,  8654,  5724,  1703, 14345, 10519,  8518, 14604,  1305, 15281,
+     6335, 13987,  4058,  8421, 12616,  1642, 12142,   747, 13558,  4937, 12513,  8186,  5829, 10266,  3640, 13591,
+      670, 15764,  4086, 12454, 14471,  3736, 13691,  1349, 12751,  8413, 11136,  6443, 10425,  1754, 15100,  5211,
+    14125,  3629,  9387,   157, 12556,  8190, 16014,  6742, 15006,  3082,  5760, 12221,  9206,  7298, 14353,  8178,
+     5945, 10655,  7150,  8999,  5175, 12883,  6959,  4486, 11541,  6517, 12093,  1499, 10931,  3531,  9044, 12448,
+     2428, 15089,   610, 13872,  2791,  9008,    22,  4139, 12621,  1974, 16380,  8070,  5860, 14278,  7643,  3644,
+     9703, 14709,  4953,   132, 15401,  2436,  4324, 12469,   548, 10076, 12738,  1100,  7257, 13851,  5376,   419,
+    10367,  3692, 14091,  7116, 16261,  1633, 11380,  3114, 15987,  1467, 12199,  7634, 13943,  8731,  6132, 12327,
+     1643,  6589,  9284, 16069,  1240, 13573,  6470,   713, 15403, 11205,  7441,  2394,  6022,  3517,  9967,  8044,
+      828,  9400,  7504, 15453,  3271, 14328,  5166, 10538,  7744,  2393,  9654,  4157, 14993,  1717, 11809,  6507,
+     9409,  5718, 10590,  7480,   230,  8696,  6328, 10654,  4311,  2208, 16375,    33, 14555,  7879,  3085,  9012,
+      821, 10816,  6019, 15275,  5386,  1521, 10497,  4383,  8789, 10896, 13328,   298,  5274,  2721, 11186,   562,
+    12820,  3102, 14974,  3839, 14217,   306,  9754, 15307,  1131, 14432,  3258,  7457, 16163,  5882, 14590,  4403,
+    13344,  6582,  8725,  4543, 10042, 16106,  7483, 13585,  6434,  9835,  3814, 13028,   229, 10166,  2095, 12878,
+     1059,  7395, 13688,  8169,  5999, 10710, 15872,  7108, 14142,  4838,  7924, 16123,  3295, 10849,  8127, 13255,
+     6631,  8722,  1043, 10640,  3425,  8366, 14314,  5253, 10130,  6568, 14900,  3771,  5658,   308, 15359,  4358,
+    14418,  3036, 12881,  7693, 10645,  3603,  8171, 11948,  4710,  9065,  4073, 12063, 15751,  6908, 12744,  5023,
+    11395, 13283,  2312,  5381, 11043,  6928,  9313,  3843, 15619,  6797, 14493,   922, 11101,  8531, 16267,  3096,
+    14146,  1912, 15172,  3252, 11537, 16056,  2839, 14093,  8030, 11904,  5838,  9467,  4118, 12132, 10030,  6702,
+    16067,  7971, 13087,  2913, 11419,  7695, 13521,   608, 14310,  2256,  6304, 10010, 15093, 12630,  4292, 15638,
+     5401, 11702,  1226, 10144,  7686, 11936,  3481,  6026, 10384,  5059,  9510, 12806,  2163, 10185,   335,  7785,
+     9811,  3792, 11905, 14470,  1780,  5324, 10756,  2466, 15116,   957, 11487,  7140, 15460,  4212, 14867,  6188,
+    11720,  4382, 11006,  3369, 12959,   932,  8879,  1988,  3521, 11132,  2554,  9334, 12159,  4559,  1518, 15397,
+     2641, 11997, 15679,  5000, 12592,  6303,   459, 13242,  4181,  8592,   852, 10357, 13010, 11568,  2499, 10031,
+     6993, 11052,  4621,  2136,  5951, 15671, 10122,  2520, 13016,  1122, 14915,  7874,   602, 10764,  2017, 16087,
+     2902,  5878, 14888,  8979,   553, 16352,  2632, 11463,  1302, 12012,  6093, 13078,  7384,  5071,   356, 12705,
+     4493,  9904,  6191, 13186,  5258,  1772, 10070,  4921,   801, 14937,  3462, 13278,  7236,  2441, 13927,  1400,
+    12443,  4183,  1960,  8857, 14467,  3405,  5650, 11654,  7363,  4657, 15841,  7814,  1954,  8701,  6466,  9649,
+     2316,  8311, 15935,  5788,  2205, 14758,  8484, 13595,  2895, 15719,   541,  6272, 13518,  4828, 15426, 12180,
+     1867, 16021,  1105,  7078,  8401, 13194,  3568, 12070,  5642,  8282, 14110,  2625,  5431, 12371,  8710,  3084,
+     9328, 16181,  1677, 15041,  9862,  5470, 13610,  7716, 15220,  6425, 13466,    28,  6773, 14283,  9658, 11278,
+     6100,  4163,  7650,  9496,  2353, 15246,  9209, 10994,  2139, 11978, 15743,  3207,  6868,  9007,  5041, 13404,
+      680, 14078,  8424, 14820, 11429,   404,  5257, 14221,  6690, 10312,  3030, 13330,  5181, 13829,  8723,  4299,
+     9742, 12235,  1464,  6509, 12809,  4530, 13438,  8245, 14041,  4640,  1993, 10045,  3385, 13915, 10831,  7042,
+     8074, 12185,  1019,  9159,  7833, 12362,  6922, 15498,  8946,  6621, 10246,  1249, 15750,  8499,  4940, 11491,
+     5700,  9726, 15592,  6287,   950, 10074, 15430,  2563,  9607, 12369,  1267, 11291,  3860, 14185,  1035, 13229,
+     6885, 13735,  4064, 11379, 13064,  4931,   769,  6836, 12359,  7591, 11449,  8420,  3871, 11180,  7152,  3097,
+     6044,  8045, 11290,  3305, 12408,   500, 15790,  9263,  1545, 11028,  4046,  9122, 10660,  1360,  7784, 13406,
+      523,  5611,  8486,  6874,  2707, 11876,  4116, 10444,  1348, 11685,  5101, 15637,  8640,  3046,  5651,   870,
+    12683, 14540,   209, 13889, 11203,  5567,  1291,  7033, 13646,  5978,  4564,  8285, 14559,  1150, 15949,  7958,
+    12037,  5552,  1441,  9124,  4148, 12531,  7386,  9359,  3790, 16334,  8384,  5791, 11319,  1244,  6596, 14509,
+      282,  7836, 14176, 10801,  3567, 10124,  7304,    20,  5754,  9143, 16097,  7801, 14895,  2340,  9017,  1452,
+    15566,  2719, 14715,  3791, 14349,   503, 13394,  3041, 11708,  2021, 12625,  5494, 10895,   587, 14836,  3267,
+    13501,   318,  7187, 11032, 13814,  4080,  8563,  6530, 13072,  3501, 14731,  5089, 12079,  7217, 10310,  3320,
+    10881,   151,  9236,  7413,  1529,  9454, 16116, 10682,  1938,  4210, 14988,  1432, 14145,  8860,   998, 13052,
+    10707, 14092,  4954, 15343,  5776, 10422,  6758,  4330, 14652,  6256, 15651,   648, 13817,  6601, 15910,  4646,
+    10242, 14063, 12498,  3884, 14477,   331, 16032,  5810, 13118,  8266,  3704, 10204,  1749, 13006, 14959,  7348,
+     8900,  3265, 10275,  6539,  3991, 14702,  8101, 15539,  2745,  9773, 14061,  1734, 10910,  4078,  9580,  2023,
+     3818,  9806, 16237,  6205, 13721,  2824, 15078,  1656, 11574,   198, 12466,  2100,  9578, 15485,  3735, 10245,
+    11742,  4925,  3079,  8361, 15293,  1758, 12289, 15054, 10701,  3050, 11772,   576,  5549, 11332,  3980, 13430,
+     5895, 10458,  6788, 11374,  4438, 10791,  5773,  9708,  4638, 13986,  7622,  3750, 13011,  6229,  9353,  7507,
+    10595,  4501, 12286,  2192,  5142, 12743,  1612, 16186,    74,  8287,  6040,  9376,   667, 15321,  5520, 16361,
+     4860, 14491,  2823, 15489,  6529, 11122,  2591,  5380,  8971, 12707,  5707,  9896,  2664,  6438, 14743,  9242,
+     4133,   164,  9587,  2223,  8891, 13463,  2917,  7943, 12817,  2342, 11887,  7465,  3465, 11265,  1845, 12103,
+     2517,  7265,  1128,  9493, 11311,  7529,  9141,  2980,  9715,   723, 14442,  6177, 11396,  7829,  4368, 10714,
+     2237, 15888,  7945,  1671, 12424,  2952, 10574,  4804, 11649,   154,  6697, 12472,  5474, 13182,  6409, 14740,
+     7534, 12721,  3291, 10770,  1004,  8027,  9951,  6353, 13502,  4950,  7253, 14380,  4395,  7717, 12903,  2617,
+     7202, 15984, 13130,   952,  6194,  9568,  5286,  2438,  6553, 14612,  4303,  8431, 12597,  6673, 15901,  5206,
+    11946,   108,  8786,  2109, 16190,  7517,  1431, 14793,  8163,   264, 16121,  8801,  2614, 15347,  1638, 14263,
+     2742, 16260,  7796, 15057,  9099,  6956, 11811,  4774, 10964, 14026,  2123, 10626, 13425,  2922,  8932,  1812,
+    11843,  8013, 12274,  4558, 13396,  3770, 14384,  7891, 13706,    48, 10890,  3602, 16269, 11846,  5159,  2069,
+    15761,  7400, 13739, 11713,  4593,  1255, 14360,  9480,   273, 10313,  4510,  8788, 15161,  5110,  9616,  6056,
+    15322, 10841,  5167, 15678,  2105,  4812, 13953,  6672, 15009,  4584, 12388,  2492, 16252,   449, 12227,  3799,
+    13635,  5445, 11474, 13387,  7168,  9105,   808, 12888,  7555, 16372,  8676,  3004, 15311,   525, 10611,  2853,
+    11370,     2,  7113, 15244,  5120, 12211,  4460, 15881,  2379,  8826, 10621,  3164, 11921,   495,  9024, 15091,
+     1606,  9249,  5578, 11277, 13794,  4119, 15874,  8842, 13218,  1195,  9738, 13636,  1879, 10321,   895,  9364,
+     2986, 15310,  4845, 13751,  9430,  3581, 12110,  2549, 11206,  6118, 10489,  5156, 12167,  6904, 11268,  4821,
+     8716,  1149, 10318,  3764,   551, 14629,  2962,  9461,  7594,  3987, 15959,  6812,  4271,  7913, 12496,  5932,
+     9818,  1254,  6220, 10476,   496,  8738, 11775,  1183,  4612, 15235,  6686, 13157,  7821,   639,  8234, 12495,
+     5515, 10228,  2997,  6222, 14940,  7599, 11097,  5238, 16254,  7001, 13617,  1209, 12600,  2994, 14339,    73,
+     8369,  3181, 13224,  6278,  8767, 12730,  1444, 11993,  2274, 10652,  7271,  8995,  5182,  9912,  7012, 15228,
+     1138,  9403,  4506,   546, 16144,  5288, 14361,  3857,  1994, 10220,  4312, 11842,  7211,  9073,  4728, 15554,
+     5395, 13820,  8664,  2265, 13205,  8930,   552, 11040,  5854, 14663,  1340, 15650,  6847, 13905,  4606,  6051,
+    12382,  3623, 10474,  2159,  7000, 11930,   646,  7637,  3868, 11187,  7161,  4956, 15146,  3553, 14226,  8274,
+    13121,  7115, 12397,  1103,  6261, 12986,  8483, 15668,  4171, 13458,  1838, 14648,   923,  9686,  3543, 12865,
+     5934, 14039,  6569, 12053, 13332,  5744, 10442, 15180,   856, 12208,  8768,  1411, 11411, 14954,   377, 14066,
+     3578, 14816, 12896,  2427, 15107,  5538,  6974, 15885, 10169,  3115,  9358,  1728,  4722, 13964, 10516,  3694,
+    15106,  1395, 12913,  8481,   767, 12565,  3841,  1918, 12038,  2748,  9902,  5872,  8080, 10438,  6850, 12929,
+     4424, 11653,  7866,   681, 14768,  3571, 10919,  5371,  7986, 15559,  1003, 13580,  3379, 14161,  2040,  8423,
+    11718,  6052, 14782, 10015,  3414, 11064,  6249,  9632, 15035,  5631, 13542,  1334, 14449,  2532, 12932,  7851,
+     1699, 10286,  3996, 11546,  6559,  3484, 14117,  7585,  3942, 12598,  8257,  5359, 10011,  1894, 11088,  8477,
+      784, 14716,  4721, 15686,  8152,  3286, 14435, 10378, 12473,  2816, 15655,   254,  7570, 11651,  6333,  4390,
+     1533, 10025,  3421,  8135, 14998,  5053,   633,  6712, 10107,  3294,  9235,  4333, 13832,  8207, 15626,   114,
+    11682,  3150,  9275,  5276,  2447,  8449,  1866,  6211, 13657,  3108,  5418, 13899,  2620,  9139,  4677, 10790,
+     7057,  8613,  4315,  7757,  9961,  3346, 12602,  2137,  8089, 12244,  5850, 11240, 15466,  7047,  2490, 11638,
+     8790,  6843,  4234, 16151, 10593,  5605, 15448,  8357,  6116, 14073,  3600, 15960,   818, 14803,  2147,  9250,
+    16318,  1631, 14155,  4142,  9964,  7032, 16129,   158, 13342,  4013,  9522,  5729, 11035,  6491, 12763,  4935,
+     2898, 13100,  1803,  8158, 12252,  2211, 13865,  1172,  8237, 11439,  3302,  9381,  5889, 11011,   939,  9718,
+    14183,  6057, 15777,  1202, 14565, 10522,  1915, 12943,  9488,   875, 11262,  3434, 13227,  6298, 16179,  4097,
+    12728,  7500, 11593,   193,  9914, 12950,  5121,  1373,  6271, 13881,  5460,  8732, 12919,  2415,  9674, 14823,
+    11016,  6002, 15939, 11762,  2315, 10578, 14035, 11590,  1232, 15294,  7350, 11832,  6502,  2348,  5561, 10191,
+     7420, 15873,  1549, 14450, 10721, 15502,  4415, 11191,  7141,  9954, 12673,  7497, 15610,  6324, 13131,  2178,
+    16006,   797, 11618, 15672,  1599, 13833,  9175,  5066, 14182,   838, 14628,  2826,  8629,  1266, 13603,  6358,
+      430, 14223, 11260,  1998,  7245,  3161,  9701, 12980,   539,  8996, 10947,  5387, 11562,  4716, 12220,  3688,
+     6487,  8876, 10554,  5717, 12314,  2463,  8457, 10281,  6024, 12561,  2931, 14720,  1502, 15413,   255, 10348,
+    16010,  9051,  6870,  4083, 15505,  7616,  4903, 12021,  6522,   407, 16022,  7450, 12292,  3641, 15893,  6629,
+     3158, 12354,  4632,  9412,  8144,  5643, 15432,  6738,  2973, 16059,  7127, 14855,    90,  9137,  2851, 14139,
+     9710,  2527,  6403, 14025,  5711,  1959,  9222, 16061,  8222,  2106, 10157, 12168,  3955, 16285,   716,  7872,
+     2690, 13367,   350,  5475,  9575,  7210,  2850,  4604,  7929, 12504,  5398,   470, 13191, 10643, 14960,  4070,
+    13552,  4634,  9859,  7017,   336,  7865, 13154,  1196, 15772,  4882,   233,  3716, 10156,  1020,  7712,  9640,
+     5169, 13631,  2975,  5796, 11200,  6399,   314, 11529,  3549,  7256, 10404,  5334, 12853,  9828,  4451, 16025,
+    10104,  2733,  9181,  5028, 14639, 11608,  1506,  4776, 15067,  7370,  1718, 13281,  2564,  7638, 10066, 13771,
+      455, 15020,  2717, 13473,  1190, 15243,  4653, 14269,  1887,  8149, 11549,  6752,  8798,  4538, 11955,  7739,
+     5553,   945, 13769, 10808,    56,  8817, 15179,  2629, 13346, 10677,  5222,  1921, 14928,  8350,  4988, 11716,
+     8547,   659, 13409,  2761, 12101,   269,  4289, 10061, 11991,  4852,  2430,  7957, 11835,  5214, 10729,  6767,
+     1412, 15506,  8912,  3032, 10903, 14955,  6717,  3443, 11081, 15352,  4473,  1120,  6896, 10777,  5698, 14001,
+    11405,  4054,  8924, 14411,  1592, 12870, 16323,  9080, 14270,  2253,  9816, 16045,  3063,  7822,  1709,  8990,
+     1033, 12486,  2702, 11334, 12804,  3319,  8878, 11725,  2502,  9335, 14759, 12028,  5622, 11141, 15262,  3276,
+    11966,  6729, 10381,  9018,  4034, 14680,  7573, 16321,  9564, 13238,  3952, 15776,   208,  7701, 12033,  3446,
+     5918, 13303,  7844, 12229,    88,  8052, 13842,  6663, 11308,  4067, 14561,  6313,  8682, 15703,  1317,  5501,
+     7318, 11493,  4875,  7582,  9402,  6366, 11865,  3224,  7477, 15847,   527, 10539,  2544, 13918,  9593,  2131,
+    14436, 11177,  3210,  6348, 12993,  4464, 10298,  7090,  3491,  8915, 14036,  4055,  9935,   234, 13616,  2307,
+    15163,  7309, 10164,  5194, 16312,  7668, 13577,  1524,  8571, 14271, 10400, 13719,  3834, 15312,  1028, 12141,
+     8004,  4883, 13326,  4286,  7747,   989, 11855, 13475,   389,  5921,  9491, 14463, 13286,  3089,  9171,  1907,
+     7336, 15691,  4763,  7991, 10871,  3836,  5745,    45,  6318, 11124,  3990,  8557, 12740,  6017, 14502, 11534,
+     6818,  8377, 15132,  5020,  6062, 16108,  3947,  6627, 14347,  5868,  8182,  1944, 13379,  4164,  1544, 12811,
+     8381,   102, 14308,  1976, 12684,  1140, 10761,  2622,  5995,  1425, 11732,  8406,  6190, 14920,  1896,  9395,
+    14501,  1111,  3877, 15656,  5734, 10341,  3482, 15819,  2409,  9372, 10568,   195, 12392,  4194, 14204, 11018,
+     8572,  1854, 12871, 15802,  3455, 11160,   837, 13807,  9874,  4420, 12930,  5400, 16340,  7139,  3723, 12459,
+     4248,  7315, 15774,  9804,  2402, 14210,  1445, 12386, 15683,   866,  7672, 12753,  5570, 11325,  7061,  4180,
+    10826,  1490, 14730,  9089,  2034, 10887,  5993, 15038,  5439,   598,  6454,  1724,  9377,  5911, 13084,  3665,
+    14630, 11295,   558, 12351, 16309, 10078,  4783,  8653,  7352, 12699,  2602,  8018,  4699, 11532, 15470,  5172,
+    10233,  1044, 12708,  3008, 15189,  6909, 12233, 10200, 14776,  1419, 13625,  5128,   814, 11020,  4767,  2127,
+    16302,  3849,   644, 13976,  9596,  1390, 10293, 13712,   728, 10825,  3192, 16279,  7200,  8703, 14164,  6065,
+     4483, 16130,  4949,  7374, 15356,  8559,  4414, 13447,  8827, 15196,  4786,  2399, 12379,  3228, 11120,  7366,
+     4682, 12545, 10716,  7030,  2598, 13418,  8606,   954, 12628,  7783,  4991, 15199,  3268,  9729,  6780,  2832,
+    15422,  3959,  9834,   276,  8243, 14543,  5221,  8726,  1547, 15058,  3493,  9174,  1198, 13285,  8339,   609,
+    15124,  8622,  1281,  5190, 11563,  5913,  8310,  3907,  9440,  6081, 11919,  1603, 14385,  2699, 16202,  8781,
+    12644,  6169,  3583,  6894, 13049,  3802, 11504,  3195,  9678, 12394, 15529,  7740, 11609,  2724,  8436, 10224,
+     2207,  7037,  9525,  6006,  2357,  3885, 14251,  1579, 14779,  3695, 10650, 15120,  1660,  7665,   124, 13030,
+     6775, 11910,  6156,  9837,   682, 13878,  2029,  7698,  3349, 11986,  6669,  9515, 15799,  3409, 10096, 12297,
+     6238,  9218, 10852,  7357,  2284, 12193,  7679,  4685,  8476, 12875,  5248, 11542,   465, 10543,  2884,  9445,
+    11027,  2519, 12317,  9850,  3407,  5667, 12067,  6846,   481, 10155,  7107, 14077,  8981,  5155, 13139,   592,
+    15508,  8543,  1739, 14824,  9612,  4515, 11982,  6469,  3784, 13668,  1423, 11735,  8260, 13159,   671, 12027,
+     5099, 13644,  5958, 12268,  6925,  2088, 12793,  5834, 10981,  7289, 12105,  6395, 10789,  4748, 11777,  6206,
+    10231,  2790, 12593,  9113, 14853,   678, 16295, 10928,  2148, 14689,  4541, 10493,  8122,  6311,  9550,  1038,
+     4836, 14243, 11935,   436, 15306,  8066,   997, 12758,  7331,  2289,  4146, 13398,  4686, 16251,   337, 13868,
+     5509, 15825,  1783, 13659,  8289, 11640,  6516,  9795,  5339, 12003,   662,  8967,  6217, 12357,  8541,  3280,
+    14911,  2193, 13676,  3706, 11306,  8719,  4976, 15742,  8445,  4446, 15065,  2515,  7096, 14130,  8139,   228,
+    13399,  2935, 14752,  4317, 13280,  5522, 15393,  2855, 14910,  1639,  9721,  4338, 14545,  6476, 15136,   942,
+     6937, 13554,  8126,   710, 11478, 13924,  1710, 15954,  3851, 14462,  2036, 10973,   909, 16216,  6431, 10461,
+     2951,  5464, 11783,  6263,   721, 16350,  2104, 14447,  9989,  6982, 15993,  5562,  2009,  6010, 16232,  7896,
+     9228,  1117, 10755,  2978, 16167, 10145,  3793, 15545,  2381, 13556,    92, 14522,  2671, 15644,  1778, 14257,
+     5019, 13562,  6587,  3663,  7499, 12832,  4784,  6778, 13649,  8663,  3062, 15575,   588, 13320,  3233, 15411,
+    10333,  2190,  7864,  9822,  4402, 10553, 14096,  4752, 15854,  8771, 11082,  1127,  9878,  6237, 12293,  7365,
+     3986,  8674, 10557,  5002, 15231,    57, 13127,  3148, 15962,  7010, 13687,  4914, 16206,  3811, 14190, 10465,
+     4434,  9391,  8303,  5525, 16125,  2587, 12599,   980, 13241, 10524,   398, 11729,  8938,  1605,  5778, 15325,
+     5303, 11641,  7907,  1145,  8760, 11117,    17,  7109, 11867,  6131, 15894,  7774,  2328, 12567,  3904, 11681,
+    15629,  1475,  5337, 14789,  6585,  2768,  9296,  7683, 11322,  5430, 12615,  7888,  4240,  9942,  1626, 13754,
+     7625, 14272,  4036, 13094,  9009,  7439, 10783,  5306,   349, 11061,  2885,  9040, 14375, 10386,  4459,  2313,
+    14899,  7106, 14042,  4576,  8894,   569, 11794,  6709,  9450,  4279,  8604,  5585,  9747,  6949, 11245,  3355,
+     9338,   295, 16073, 11299,  1581,  9897,  2896, 11693,   171,  5461, 13059,  6955, 10053,  5179, 11821,  7406,
+     5747, 13795,  3362, 16102,  6376,  2646,  9004,  6791,   155,  5696, 14468,  7060,  3508, 14797,  1650, 11150,
+    15047,   872, 12924,  2972,  7453, 11047,  4386,  9129,  1091, 11253,  2488, 10299,  2015,  9651,  1238,  5969,
+    15852,   452, 14538,  1451,  7565, 10669,  6230,  9627,  5666,  2953,  7426, 13922,  3937, 13014, 11244,  3661,
+     9680,  1855, 12772,  6488, 16018,  3537, 14232,  9180,  3832, 10439,  1096, 13508,  9005,  5480, 10080,  7950,
+     3541,  9151, 13080,  4120, 10319, 15537,  4823, 12915,  1077,  9626,  3341, 13531,  6711, 15081,  8343,  3702,
+    11446,   290, 10219,  2473,  4910, 13884,  3380, 15381,  8107, 12967,  4245, 11450,  1008,  7393, 12762, 11174,
+     3738,  9620,  1683, 12632,  6295, 14713,  5008, 13142,  1040, 14930, 11589,  3112, 12719,   760,  8102, 15328,
+     5683, 10481,  7860,  2516, 14104,  5756, 14519,  7732, 15230,  9650,  1842, 11193,  3755, 14813,  1971, 12968,
+       79,  8455, 11466,  1274, 12282, 14691,  1805, 13628, 12123, 10175,  2868, 12880, 10673,  8304,  5178,  9110,
+     3208, 11983,  6744, 14377, 10197,  2633, 15535,  7848, 13969,  5784,  8138, 12795,  6664, 11770,  7415, 12501,
+     2762, 10848,  6630, 11705, 13422,  4102, 15253,  1796, 14578,  8198, 15530,  5239,  9998,  6363,   877, 14284,
+     6893, 15640,  4609, 10556,  2723, 10036,  5200, 12450,  2155, 13119,  6869,  3352, 11293,   207, 14006,  2020,
+    12154,  5759, 10719,  2167,  8474,   253, 10893,  3093, 15007,  6282, 15729,    27, 11916,  2686, 12503,  5949,
+     9112, 15871,  6781, 15226,  9851,  1063, 11667,  8820,  1810,  6143, 15033,  6736, 13536,  3474,  8714,     8,
+    13265,  5472, 15268,  7794,  2583, 10906,  8142,  3296, 10471,  7505,  2011, 16189,  7696, 14033,  4095, 12217,
+     2199, 13223,  4607, 12050,  8550,  3794, 10619,  1217,  4254, 12310,  6427, 15828,  1306,  7762,  9248,  4019,
+    10644, 14554,  4589,  9405,  7479,  5296, 11195,  3912,  8137,  1575, 16047,  4570,   654, 14030,  2378, 15712,
+     6075,  9758,  4523,  1332,  5545, 12665,  6277,  1726,  9970,  3339, 15642,   296, 14831,  4145, 13804,  5025,
+     7974, 13147,  4651,  3048,  9016,   218,  7148, 11567,  3622, 11142,  1225, 12349,  2164, 16198,  7654, 10700,
+     2421,  8575,   427, 14936,  8264, 13567,   918,  7994, 15467,  5610,  8602, 14438,  4983, 15760,  7516,  6385,
+    14898,   540, 16256,  7143, 14277,  5877, 13710,  7319,  8763,  2254, 10612,  8213,  5644,  9503,  1144, 14613,
+     2122,  4294, 12169,  1556,  7184, 12823,  5881,  3007, 14048,  9318,   596,  9793,  2640, 14754,  5245, 15813,
+     6604, 10514,   855, 11623,  4069, 14213,  1458, 15666,  4475, 13882,  6173, 10131,  5107,  1618, 10696,  6695,
+     8850,  1112, 15016,  6157,   492, 15516,  7221, 13476,  8262,  2458,  9053,  4922, 13979, 11526,  5589, 15963,
+     6721,  2363,  6064, 13456,   694, 15748,  2959,  9619, 15194,  5409,  7543,  9326, 11823,  6521,  7937, 12402,
+      237, 13559,  7697, 15914,  9292,   509, 14704, 11499,  5056, 12209,  4549,  8463,  2946, 10546,   759,  9195,
+    15045,  1672, 10022, 15477,  5313, 14231, 10222,  4521, 12776,  6459,  9293,  4684, 13493,  8686,  3243, 12536,
+     4998, 13736, 11812,  5723,  1691,  6320, 11438,  4074,  9647,   566, 11964,  1807, 10809,  2988, 12920,  4204,
+     9943,  8309,  4648, 12415,  3318,  9732,  1583, 12099,  5193, 11663,  4544, 14196,  3523, 15981,  4957, 10945,
+     7939, 13372,  5581,  8511, 11147,  3903, 16038,  7689, 12299,  4618, 15675,  5697, 11820,  8009, 10118,  1906,
+    11990,  3244,  8403, 16026,  5912,  9803,  7182,  9066, 12331,   440, 11318,  3638, 13412,  8318, 14694,  3044,
+    15920,  9983,  3436, 10889, 12622,  9158,  2035,  5370, 16027, 10800, 12704,   361,  8574,  2619, 13529,   883,
+    12442,  8230, 15098,  3637, 10795,  8637, 13020,  6216,   488, 11535, 13779,  3171, 14983,  1298, 10143,  4172,
+    14572,  3392, 10819,  2150, 11897,  8202,  3743,  7268, 15166,   893, 13376,  9475, 14286,  6408, 16020,  2401,
+     5806, 12114,  6936,   956, 12326,  8033,  2282, 13758,   666, 15957,  2695, 10929,   106,  5967, 14506,  1397,
+     9346,  7248,  3789,  9838, 12623, 14607,  2552, 16373,  7281, 13856,  4449, 15247,  8111,  6013,  9393,  1333,
+    13662,  2677, 11148,  1039, 13348,  6746, 16062,  3900, 14684,   698, 13168,  1837, 10364,  7569, 12794,  3051,
+     9763,   653, 14979,  2818, 14137,   110,  5149, 10336,  1295, 10869,  2350, 12613,  3981,  1199, 13869,  4697,
+     9149, 14459,  5048,  2210, 12534,   223, 13699,  2449,  5523,  8508, 15114,  1247,  9383,  5869,   186, 12906,
+     4339,  7442, 13952,  4962,  6975,  3141, 13102, 10193,   800,  3927,  5962, 15064,  7034, 10426,  4487,  9880,
+     3189, 11159,  1422, 12779,  6973,  2120,  4830, 14352, 10440,  4260,  1924,  8813,  5849, 12813,  2784, 11340,
+     8612,  5681, 13192,  6877,  4298, 13746, 10633,  2279,  8785, 10927,  6819,  1819,  5453, 11612,  3606, 11121,
+     8584,  4009, 13981,  9584,  3504, 16356,  5835,  8831,  7342,  9875,  5083, 14968,  7975, 12032,  4205, 10414,
+    15193,   741, 15838,  3003,  7615,  4561,  8819, 10746,  1426,  6528, 10182,  2626, 12667,   831, 15997, 10506,
+     5242,  7611, 15369,  9036,  5051, 11433,  2849,  7966, 10133,  6471,  9156,  7074, 15349,   433,  6101, 13823,
+     6599, 11822,  4839, 10521,  6458, 13027,  8325, 14922,  3586,  7022, 13407,  8585,  7538, 15494,  6421, 12336,
+      521,  7332, 13496,  9417,  6833, 11119,  4726, 10356, 15950,  3928,  6863, 12668,  4585, 15720, 11099,  6436,
+    11814,   832,  9489,  1666, 16239, 11347,  4500,  6612, 13787,  7934, 14296,  3279, 11869,  1548, 15370,  7189,
+    14074,  5112,  9682,  4192, 15436,  7920, 12052,  1235,  6649, 13302,  7244, 15620, 10769,  4778, 16174,  7151,
+     1829, 15336,   750,  9023, 16376,  1514,  5375, 14222,  6015,  2712, 16157,  7819, 13043,  1151,  7627, 13477,
+       11, 15753,  2075,  7526, 10909,  1324, 11870,  3172, 14386,  1868, 13138,  6945,  3558, 15697,  8869,  2807,
+     5454, 12842,  6708, 11012, 14109,   175, 12178,  5074, 13230,  3522, 14724,  8748,  4865, 11561,  6965,  3719,
+    14389, 11922,  1899,  4051, 14542,   416,  9464, 15464,  1329, 13988,  2600, 12291,  4096,  8889, 11362,  1449,
+    16275,  3440,  8943, 15710,  1753,  9645,  2561,  6240, 11566, 16194,  4932,   265, 10667,  2118, 11209,  3562,
+    16322,  2915, 10803,  1264, 15173,  3147, 14771,  6481,  1744, 12074,  9887,  2848, 14099,  1846,  8659,  2679,
+     7825, 14557,  5531, 13395,  8075,    21, 14668,  9695,  2778, 11149,  1170,  9351,  4802, 12899,  2889,  8937,
+      473, 16222,  6486, 11671,   246, 10262,  3459, 16338,  9257,  2498, 12264,    31,  3677,  9516,   914, 13041,
+     5046,  9693, 12163,  2908,  6389, 12488,  9622,   143, 12897, 11726,  3861,  9845,  4809, 15329, 10158,  4404,
+     9368, 11410,  6264, 12828,  4866, 15004,  6750, 10589,  5384, 12245,  8498,   986, 11582,  1737,  6532, 14029,
+     7811, 11386,  4372,  1312,  9500,  6077, 14995,  1985,  7899, 11723,   326,  7372, 13444,  1679, 13973,  8913,
+       68,  6500,  8540, 10599,  6120, 12243,  7417,  5556, 12839,  4761, 10779,  5800, 14807,  2384, 14372,  4418,
+     7288, 12649,  1037,  7481,  4114, 12017, 14396,   781,  9086,  1848,  9976, 14517,  6038, 15053,  8959,  5544,
+     7862, 13051,  4426,  8675,  5758, 12777,   930,  8955, 13308,  7640,   712, 11686,  7300, 10561,  5346, 15418,
+    12400,  2240, 10317,  2928, 11963,  5996,  8614,  1791, 15690,  5265, 12255,  6386, 16086,  7692, 10880,  5686,
+    12035,  8095,  2257, 14593,  9064,  5471, 13862,  7597,  5088, 14890,  8412,  5586, 14454, 11763,  6251,  8353,
+    14265,  3892,  7779, 14632, 10340,  3592,  7575, 15258,  4211,  8278, 14662,   478, 12290,  3095,  6535, 14446,
+     2503,  5226, 14706,   585,  8934,  4197, 13050,   284, 15390,  2856,  4343, 14734,  9148, 13675, 10787,   341,
+     9953,  2079, 13382,  8147, 16034,  3360,  7077, 10316, 15504,  5391,  9802, 16182,  3167, 10991,  5777,  2451,
+    12465, 15661,  3026, 13249,  1487, 15112,  2325, 10967,  3627,  8362, 16169,   888,  7726, 10091,  5364,  8600,
+    10733,  2644, 13678,  9379, 14712,  5428,  7818, 13215,  4495, 13954,  7308,  2780, 12882,  4185,   907, 13732,
+     9819,  1636, 11416, 15694,  3746,  7781, 11547,  5203,  3330, 14510,  5692, 16367,  3460, 13667,  9706,  1146,
+     4135,  8998, 14973,  7335,  4272, 15305,  3642, 12455,  6882, 10350,  4081, 13386,   181,  3610, 14739,  1858,
+    13682,  3963, 13193,  5919,  2845, 12610,  1745, 11282,   803, 10092,  3230, 11134,  7841,  2070, 13840,  2578,
+    10604,   325, 11409,  4636,  1118, 15608,  2456, 11204,  6613,  1388, 10399,  5907,  8950, 13728,  1488,  7172,
+    12586,  8364,  3391, 10270, 13614,  2556,  7753,  9413,  6096, 10132, 11298,  7411,  5564,  2459,  4896, 16238,
+     3689, 14766,  5289, 11907,  2377,  8983, 13618,   979,  3940, 12552,  2287,  6183,  9298,  4255, 15182, 10109,
+     7193,  4439, 11258,  5348,  9807,  8177,  4384, 13673,   146, 11785,  3120,  9327, 13423,  1797, 12121,   204,
+    15171,  5897, 11522,  4730,   408, 11271,  3087, 10236,  6667,  3838, 12165,  9487,  5345,  8250, 11776,  6886,
+     2539, 14666,  6308,   390, 10087, 13911,  2596, 15507, 10735,  8446,  2299,  9259,  6369,   368,  4884, 14316,
+    11398,  6305,   522, 13029, 10972,  1270, 14065,  9220,   603, 14486,  2196,  8427, 10024, 11571,  6625,  9492,
+     4670, 10527,  1108,  8525, 10957,  6807, 15769,  4490, 12936,  6126, 13596,  1178, 15242,  4352,  7421, 12604,
+     5462, 15765,  6960, 13296,  5844,  8877, 13627,  4750,  9277, 14028,  3439, 15770,  2166,  7964, 10565, 16274,
+      822, 11838, 15518,  1627,  6567, 11084, 15817,  3675, 13893,  1571, 16096,   531, 13273,  8324, 11710,  6285,
+     9231,  7466,   849, 10510,  5885, 12425,  4678, 11163,  8655,  6638, 14498, 11462,   733, 13038,  8059,  1171,
+    14675,  9140,   632, 16343,  3372, 14158,  6782,  8921, 15744,  6199, 12607,  6958,  3754, 15621,  6659, 13044,
+     3970,  8159,  1942, 15452,  6920,  8757, 15933,  1180, 15087, 10970,   490, 15840,  1476, 14227,  3125, 15379,
+    10605,  5123,  8335, 12139,  7220,  1493,  9538,  6616,    55, 12963,  4671, 14893, 11238,  8209, 12130,  7063,
+     3178, 16084,  5118,  8745,  2553,  9873,  7454,  4759, 11676,  8154,  6154, 15572,  5072,  2491, 15273,   737,
+    14355,  7485, 15875,  3390, 14832,   542,  8034,  9794,  2016, 15528,  4005,  9428,  6584, 10490, 16024,  1416,
+     8752,  3103, 10069,  1762, 11687,  8032,   616, 12697,  1995, 10828,  7387, 11974,  4945, 12976,  3745,  5399,
+     9179,  6020,  3966,  8082, 14313,  4984,   886, 12013,  8175,  4756,  6845,  9751,  3881, 15082,  1193, 12985,
+     2740, 12102, 15339,  4017, 14357,   450, 15721,  2911, 14008,  1362,  8334,  4801, 15809,  6811,  3432, 12029,
+     2777, 13583,  6296,  7748, 12727,   935, 11556,  2024,  5153,  9891,  1278, 14067, 10530,  5043, 11189,  2923,
+     9684, 14262, 10326,  3613, 12321,  2133,  6079, 12566,  8072,  2455,  8661,  5890, 12475,  7163,  9164,   120,
+     4041, 12624,  2005, 14340,  4864, 16149, 12429,  4327, 14209,  6991, 10120,  1331,  3785, 15547,  1958, 13494,
+    10713,  1559, 12574,  6597, 15771,  5790, 13282,  2077, 16317,  3203, 12652,  1005, 13914,  7314,  8677, 12481,
+     6028,  2661, 11451,  9203,  4894, 11987,  3734, 14198,  6912,  8665, 11644,  2739, 12372,   512,  9097,  3782,
+    11941, 15066,  6149, 13977,  2808, 14932,  5184,  7066, 16107,  5551,   925,  8649, 14252,   210, 11367, 15063,
+     2804, 10940, 13246,  9895,  2206, 12368,  7137, 10346,  2368, 12768, 14456,  3034, 12413,  5902, 10098,  4508,
+    14083,  6761,  1925,  8568,  6492, 10141,  7760,  5197,  9728, 12949,  3631, 10684,  2121,  9917, 14103,  5435,
+    10432,  4705, 11758,  2214, 10304,  5668, 14838,  7498, 13299,  4201, 15266,  2547,  8292,   611,  8821, 16058,
+     6310,   812,  7677, 13176,  4951,  9861, 13740,  3485,  5282, 11736, 14571,  3652, 10075,  4550, 11154, 13301,
+     6088, 15895,  9273,  3435, 10498,  5972,  2883,  8105, 10956,  2059, 12285,  7723, 13134,  5614,  9133,  4453,
+     7981,  9527,  3489, 13806,   882, 11458,  3862, 10505,  7815,  5675,  8880, 10742,  4355, 11894,  1472,  3805,
+     9939, 13036,  5420,  1681, 13960,  6323, 10342,  2557, 12458,   202,  4800, 14745,  5769, 13435,  4993, 14410,
+     7112,   850,  4405,  9348, 10948,  3705, 12195,  9980,  3146, 11483, 14794,  2656,  6837,  9796,  6286,  1853,
+    13955,  7330,   358,  5529, 16183,  8634,  3324, 15227,  5424,  8910,  1048, 10743,  7610,  2101, 15919,  8109,
+       39, 10900,  9552, 13539,  3231, 11616,  1591, 14808,  7223,   113, 15278,  5709, 12785,  7618,   372,  8678,
+    16080,  1439,  8434, 15412,  3994,  9436,  2708, 10473,   506, 11307,  7910,  5714, 11712, 14617,  4518,  1655,
+    13571,  5478, 11669,  1327, 16378,  7263,    41,  9034, 15324,  1712,  7553, 13575,   809, 16243,  2236,  6730,
+    10320,  1107,  7423, 11825,   642, 13465,  9095,  1051, 15332,  3946,  5915, 16001,   748, 10396,  2703, 14479,
+      133, 15178,  7228, 10239,  4642,  8452, 14852,   249, 13634,  1602, 15077,  2869, 13095,  5505, 10397, 16135,
+     7902,    67, 15391,  7132, 12672,  1018, 15164,  8232,  5328, 16153, 10811,  7201,  1808,  7897, 10265,  2220,
+    11158,  8315, 12796,  6796,    80, 15859,  7737,  1288, 13506,  8223,  4503, 10311, 15628,  4176, 12232,  7890,
+     9600,  4656, 14878, 11243,  1307,  5938, 14097,   117, 11371,  6338, 15635,  4259, 13828,  9373,  3529, 11471,
+     5703, 15578,  4868,  1067, 16296,  5601, 13109,  2673, 12120,  4463,  8881, 11866,  1628, 14876,  6098, 13165,
+     3679,  7110, 12524,   217, 13747,  6456, 15958,  3707, 14434,  9098,  1876, 12505,  3312,  9520,  6880, 12257,
+    10686,  2494, 14956,  8459,  3212, 10897, 14156,  4608, 10601,  6560,  9655,  2877, 11403,  5213,  8599, 14748,
+     3251, 13786,  4743, 15110,  8426,  4203, 14723, 11594,  5259, 13601,  9442,  2993, 11430,  6919, 12483,  6124,
+    11059,  5433, 11902,  1814, 15487,  2725,  6728, 12288,  4986, 11250,  6495,  9659,   401, 14701,  6787,  2238,
+    13548,  4182,  8852, 10732,  3254,  9540,  4089, 13335,  1507,  8986,  3056, 13110,  9702, 15688,  3384, 13684,
+     5347, 16218,  2511, 14305,  5625,  8968,  4238, 14514,  6218,   400, 12835,  5852,  1364, 13304,  3234, 15953,
+      983, 12493,  3052,  7669,  9085, 12942,  4488,  9462, 13492,  1904,  8414, 11924,   417,  6900, 14614,  1684,
+    12642,  2842,  7878, 12337,  9091,  4178,  8256, 10584,  5981, 16099,  7828,  3123, 11072,  4032,  9591,  2426,
+    10820, 14370,  5087,  8005, 11015,  1609,  8514, 12979,  7045,  4867, 16214,  6360, 13855,  1207, 15493,  3666,
+     7382,  9162,  4079,  6497, 12803,  5679,  2728, 12036,  1015, 13277,  4268, 15524,  7889, 12838,  1596, 11958,
+     5502,  8012,  9900,  1766, 13081,  6383,  2361,  7149, 10004,   475,  8267, 14595,  5037, 13885,  1393, 16199,
+     4008,  2345, 14154,  8920,  5217, 12916, 10029,  3367,  9163, 15988,  4049, 14022,  7561,  3514,  9362, 12152,
+     5141, 11236,  6176,  2048, 16035,  7407, 11111,  5798, 11506,  7564, 14497,  4235,   999,  6095, 11743,   288,
+     9547,  3997, 12072,  9906,  1694, 13146, 10666,  2359,  9724, 15345,  3608,  9142, 11223,  7207,  8811,  5174,
+    10428,  6679, 13586,  3825, 15377,  2608, 10597,  7508,  4016, 14839,  3151,  5225, 10195, 12923,  4667,  8973,
+     7243, 14304, 10392,  2160,  6918, 15042,   643, 13913,  2039,  9367,  1089, 14414,  5228, 15673,  6734, 12166,
+     1026,  9182,  2995, 15198,  4228, 12334,  5417,   995, 11880,  2906, 10740,    82,  7642, 10280,  5318, 12890,
+      323, 14412, 10037, 15573,   684,  9459, 14850,  7018, 15783,  5539, 10418,   301,  6332,  3880, 13939,  9013,
+      457, 15434,  2759, 11202,  3766, 10620,  7880, 15724,  3314, 12784,  6525,  1788,  8847,  3406,  9915,  7532,
+     8539, 13196,  6343,   464, 11565,  7666,  1187, 14611,  7283,   845,  8394,  1930, 10968, 15350,  1167,  8247,
+    14253,   874, 14882, 11767,  4842,   382, 14336,  2319, 15423,   729,  6354, 12122, 10636, 14848,  4617,  8146,
+    15272,  6410,  1076,  7458, 15533,  3424,  6639, 12526,  4857,  7520, 11787,  2242, 15152,   628, 13800,  2471,
+    14474,  1687,  8284, 11631,   559,  6514, 12090,  1457, 12687,  6665, 10986, 16271,  6070,  1337, 15158, 11165,
+      772,  4076,  6112, 13264, 10996,  3595,  9657,  6656, 11378,  3855, 13638, 10089,  7412,   554, 13452,  4827,
+    15005,  5859, 11580,  6643,  9869,  2309, 14276, 10121,  5901, 15103,  8225, 13200,  4698, 14751,  2827,  7956,
+    11389,  5814,  1760,  4856, 11255,  7731,  1551,  4011,  8843,  2186, 12713,  8347, 10932, 15140,  2470,  6976,
+    10767,  5826, 12451,  6864, 16305,   179, 12008,  1568, 14250,  4494, 10272, 15837, 11937,  4708, 14765,   924,
+    12241,  3105,  9765, 15853,  4123, 13716,  5632, 11789,  2501, 13250, 10205, 12417,  5841,  4481, 12840,  6396,
+     3137,  9731,  3698,  7826, 13656,  8631,  6637, 10007,  3604,  9357, 12851,  2472,  8472,  1634,  7354, 12579,
+     1966, 13288, 11025,  4738,  8060, 11424,   746,  8692, 16314,  1552, 14090,  8349,  5307, 10606,  4057, 12031,
+     9295,  5684, 15827,  4353, 10090, 14644,  5140, 16002,  8229,   705,  9166,  2330, 12146,  8673,  2966,  5511,
+    13470,  9960, 15295,   317,  5263, 14482,  1454, 15818,  5010, 12309,  6284,  2228, 12679,  8385,  2720, 10241,
+     7908,  1892, 13237,   758, 15822,  7356,  8978,  3473, 12675,  1404,  4033,  9800,  2081,  8706, 11980, 15912,
+     2280, 13931,  8778, 12521,  2406, 13411, 10221, 13978, 11464,  7473,  3427, 14280,  1361,  5027,  9422, 16089,
+     4283, 13443,  1293,  8683,  4655, 14009,  5469,  8939,  6164, 11089,  2593,  7418,   275, 13040,  6704, 10598,
+     5702, 14958,  1530,  8039, 10862,  1968,  9483,  4442, 15216,  6300,  4792,  3078, 15883,  8724,  2537, 10594,
+    16369,  6930, 13178,  1399, 10214,  2900, 12260,  5082, 13841,  7962,  4527, 16264,  5592, 14085,  9224,  3739,
+    10390,  3072,  8605, 14195,  2692, 15003,  5727, 13381,  3833, 10902,  6359,  3111, 13025,  6932, 16131,  6166,
+       62, 10863,  2936, 13148,  7186,  2061,  9629,  3535, 11481,  4967, 14274,  7333,  3926, 13970,  7676, 15878,
+     1849,  8482,  3340,  8150, 11697,  7583, 12736,  3043,  8626,   247, 15138,  9049,  3483, 11497, 14178,  4318,
+    16033, 10670,  3872,  8797,  4741, 13549,   333, 14818,  7192, 11046, 15699,  6671, 13664,  6163,   864,  4409,
+     7129, 10389,  3402,  6753, 16122,  6068,  3080,  5160,   550, 16043,  9812,  5737, 11754,  7296, 12563,   900,
+    11536,  3187,  9679, 14814,  2261,  9360, 12585,  3527, 13261,  1098, 15137, 11645,  5540,  9554,  2177, 15627,
+     4381, 11376,  7073,  3573, 14341,  6806, 16280,  8239,   570, 11133, 14292,  7800,   152, 11415, 13593,  5016,
+      514, 12045,  5487, 15704,  4374, 14605,  1147, 15911,  1874, 11827,   103, 10159,  3262, 11190,   625, 15821,
+     6860, 13776,  5465,   363, 12251,  9279,  2086,  7313, 11988,   188,  9506, 14717,  1053,  9992,  2008,  8537,
+    14985,  7758, 12272,  1124,  8755, 14149,  6138, 13677,  2767, 15486,  1212, 13202,  9699,   172, 10455,  4301,
+    11863,  6600, 12589, 16136,  2304,  4484, 10210,  7120, 13314, 10775,  4219,  6941, 16329,  5647,  1522,  9460,
+        5,  7531, 13935,  2812, 12106,  6082, 11276,  2623,  4540,  9215,   595, 11790,  3368, 10878, 15249,  9477,
+    13343,  1102, 15023,  8337,   183,  9330, 14596,  8026, 12937,  6422,  1831, 14780,  2916, 13672,  3700,  8489,
+     6058, 14329,  7496,  5314, 11320,  6602,   778, 15510,  9717,  5148,  8461,  2957,  8016, 13790,  3828,  8770,
+      612, 13544,  9291, 12544,    46, 10424,  2990, 12057,  3748,  9059,  1653, 12717,  9792,  7070,  1811, 15060,
+     7704,  9265,  2117,  8296, 10884,  5980,  9120,  6970, 10534,  5425, 13503,  7174, 14987,  6478, 13007,  5021,
+    11600,  1356, 10008, 16057,  6983,  4265, 10451, 13929,  4675, 15741,  7904,  4929, 11599,  3726, 12569,  4595,
+    11138,  3448,  5449, 15614,  4727, 11266,   266,  7961,  9947,  6793, 10651,  5669,  3270, 12322,  6241, 14536,
+     2665,  9770,  1023,  5830,  9192, 14122,   795, 15439,  5432,  1821, 14631,  9824,   902, 10930,  7206, 12861,
+     6215, 11850,  5374, 15525, 10187,  1686,  8153, 16306,  5624, 14020,  7859,  5224, 14520,  1706,  5490,  8124,
+     3730, 10982,  4547, 12124,  5442, 11684,  1310, 10680,  4200, 11931,  9100,  4731,  8161,   100, 10117, 15685,
+     2154, 10478,   383, 15916,  3938, 13733,  8214,  7307,  2047, 14427, 12332,  4158, 16245,  1248, 11030, 14237,
+     7601,  5094,  2072,  6094, 15072,  4902, 12981,  5916, 13838,  6632, 15738,  5444,  3852, 14651,  6007, 10139,
+     2821, 12910,  3934, 11633,   239, 12527,  3209, 13061,  3886, 15157,  2639,  9637,  1214,  8871,  2172,  8336,
+     4132, 15092,  6274,  3620, 11169, 14616,  1025,  8460,  2887, 10116,  1719, 13481,  5927, 15427,  7469, 14050,
+     1375, 13543, 10330,  7025,  2582, 15141,  3972, 12971,  1840, 12468,  4389, 14798,  8083, 15383,  1515,  8898,
+    13090,  4806, 14894, 11303,  3654,  6394, 12156,  2621,  8301, 11824,  6003,  2874, 13803,  4598, 15465,  3322,
+    14738,  2188,  9302,  1073,  6857, 13117,  3639,  9628, 12363,  1539, 12991,  2483,  8918, 10504, 12710,   399,
+    16288,  6260, 13092,  2631, 14321,  3587, 15648,  7235,  2500, 15238,   955, 13190, 11264, 15012,  6299,  4946,
+    13035,  7979, 12228,  3028, 10209,  1646, 11799,  4342, 10818,  6288,   560, 10380,  7020, 12733,  6446,  2751,
+    12157, 10347, 16053,  8170,  2604,  8828,  1470,  9936,   941, 10792,  2400,  8536, 11741,  1219, 12324,  4276,
+    14054,  6503, 15333,  5706, 13942,  7514, 15492,   786,  8793,  7759, 11476,  4789, 12201, 13990,  5827, 14568,
+     9501,  2775, 12750,  9037,  1763,  5986, 12636,  5336, 15181,  6763, 12365,  2568,  8975,   410,  9761,  2786,
+     6620,  8873,   658, 12641,  9421,  7540, 10532,  5367, 16191,  8545,   578, 11601,  2191,  5146, 11055,  7130,
+      511, 10708,  7391,  1713, 13572,  9574,  4734, 10541, 14318,  1218,  8840, 12767,  7719, 12044,  1975, 10355,
+     8338,  4997, 12580, 14944,  4371,  8641, 14398,   839,  7482,  3908,  9922, 15989,  4302,  6989,  3035, 14171,
+     7562,  9830,  1482,  9014,  7028, 10148,  4813,  8693, 13730,  5802,  9950,  6683,  4088,  2022,  8890, 11972,
+     1220,  4469,  6755, 13231,  8596, 15024,  5779, 16015,  3241, 13487,  9152, 14909,  2370,  4854,  9990, 15499,
+     5803,  1066,  3722, 13167, 11071, 14045,  7179, 15415,  5113, 14453,  7428, 13272,  3321, 15523,  7911,  8949,
+      740, 10448,  1560,  9438,  2597,  4683,  9864,  6555, 14428,  1526,  6125, 16008,  4020,  3002, 10923,   224,
+    12046,  7635,   833, 13565,  8007, 15599,  3266, 11465,   590, 10780,  4359, 15974,  7238, 14422,  5060, 11512,
+    16293,  4304, 14550,  5836,  1755, 13886,   965, 11778,  3068,  5954, 14199,  7437,  9472, 13373,  3516, 16335,
+     5736, 14248,  3091, 15598,  7949,    93, 15972,  7648,  3381,  6706, 15786,  3962,   355,  9134,  6440, 14290,
+      700, 11225,  3040,  7766, 10844,  2346, 11603,  6405, 15388, 11950,  6000,   142, 11469, 14790,  8527, 11197,
+     2128,  5007, 15517, 11509,   793, 13243,  1937, 12196,   364, 11050,  3173, 16225,  7736, 10747, 13824,  3376,
+    15280,  9234, 14667,   928,  5177,  2658,  9885,    14, 12127,  7568,  1826,  5638, 13099,  8624,   190,  4224,
+     8340, 14643,  9784,  6574,   720,  4137, 11626,  2779, 12463,  3957,  9643,   397, 10569,  5331,  2222, 11331,
+    16101,  4781, 13390,  7185, 14946, 11227,  2028, 11976,  3668, 10697, 13352,   487, 10332,  8104, 15538,  7134,
+     4498, 16359, 10642,  5076,  2432,  9879,  7103,  8844, 14332,  6235,  9415,  1296, 11235,  3550, 12858,  8233,
+     1931, 10723,  3353,  9927, 15930,  4915,  9022,  6475, 14935,  9246,  2462,  4028, 15762,   913,  8630, 12104,
+     2068,  8238, 10101,  5189, 12342,  4244, 10953,  2012, 12467,  9981,  4880, 11146, 15221,  5195, 13357,  3778,
+     7377, 15862,  5952, 13727,   256, 16103,  5114,  3221, 10289,  1984,  8443, 13405,  6508,  1221,  4015,  5716,
+    13762, 12376,  3156,  5942, 15133,  8273,  6510, 15927,  3866,  7459, 14060,  1263, 12338,  5486,   637,  7105,
+    11010,  2351,  5957, 11602,  7816, 12805,  6546, 14064,  8837,  4975, 15289, 11364,  3634, 14533, 11992, 10668,
+    13683,  1770,  4788, 12393,  7808, 15826,  5676,  9336,  8069,  1908, 16208,  6083, 13774,  7322, 14249,  3575,
+     6784,  8643,  3012, 10810,   968,  7977, 16289,  5641, 12800,  2362,  8450,  6898, 12462,  5349,  1614, 12953,
+    10136,  3364,  6658, 14490, 11808,    24, 12927,  4082,  1946, 13696,  3165, 13136,  5634, 10215,   948,  6129,
+    14952,  7831, 13331,  2445,  6751, 12350,  3574, 13113,  1401, 10966, 13564, 10189,  6355, 11361,  4652,  6825,
+    13843,  4100, 12869,  1133,  9041,  6998, 13152,  5853, 14992,   638, 13490,  2271,  8050, 10128,  1179, 11714,
+     9594,  1769,  8883,  4066,  9966,  6654, 13268,  7953, 14107,  4577, 15167,  2881,  9521, 15595, 12144, 10129,
+      693,  8805,  7433, 10754,  4337,  2840, 11316,  5546,  9243, 12640,  4534,  9588,  2746, 14499,  8440, 15832,
+     4021,  9785, 13965,  3560, 15588,  1485, 10566,  4093,  2243, 10962,   970,  9486,  7873,  1509,  7250,  2531,
+     6351,  9069, 15331,  3131, 10583,  2168, 13347,   231, 14686,  6879, 11155,  4425,  9119,  1083,  9963, 12643,
+        7, 11677, 14726,  5299, 12446,  4345,  8904,   307,  9331, 15680,  4982, 14821,  2529, 13759,  9062,  6027,
+     2112, 14102,  1182,  8668,  3758, 15926,  5782, 14885,  8100, 11893,  5126,  8368, 15283,  2335, 13989, 12249,
+     4548,   145, 11844,  8351, 10879,   428, 15327,  8055,  4696,  7225,    19,  5280, 12693,  1649, 15111, 10374,
+      309, 11494,  6542, 15248,  2859, 14004,  1448,  8533,  3731,  9310,  7252,  5615, 14084,  3170, 16192,  4516,
+    13088,  5467, 14587, 12181,  2698, 11351,  1351,  9261,   665, 12439,  5524, 11026,  7606,  4899,  2666,  6827,
+    15867,  3765, 14901,    29, 14119,  9546, 13479,  1002, 14762,  2209,  8221, 15481,  6134, 10435,  4879,  1436,
+    12416,  7429,   272, 11162,  9021,  4773, 14601,  8308, 16360,  7118, 13858,  3061, 15702,  5892, 12635, 16128,
+     3456, 11851,   384,  7039, 14264,  5255,  8603, 10327,  4630, 12137,  1323, 13054,  3073, 14907,  4006,  8047,
+    15646,  5898,  1865, 10043,  3397, 13724,  6393, 14212,  4098,  7546,  1084,  9553, 11344,  4391,   711, 15236,
+    11674,  7867, 12405,  5574, 11031,  7462,  2615, 10263,  1065,  6866, 16145,   278,  9664,  7660,  3869,  9147,
+     7064, 15800,  5514,  1525, 14348,  4226,  9743,  2108, 12073, 16077,  8252, 14013,  2781,  7742,  9070,  3248,
+    14591,  2526,  9449,  5416, 11666,  3910,  9752, 16258, 11345,  2513, 14722, 10484,  1501, 12213,  8513,  6872,
+     2538, 10535,   567,  7166, 15670,  4704, 15015,  5833, 10727,  7299,  1738, 14650,   448, 12596, 13982,  9185,
+     1999, 11779,  5246, 12769,  6715,  1714,  4930, 10528,  3431,  6931, 11622,   192, 13289,  1965, 11819,  8739,
+    13561,  5291, 16158,  6950,  2800, 13325,   614,  5491, 12490,  3757,  6195, 11740,  4373, 10192,   754,  8022,
+    10847,  5463, 12940,  9424,  1435, 11460,  3528, 15162,  6316,  2866, 15903,  8290, 10830,  6474, 11970,  5001,
+     2543,  9530, 13149,  7088, 15886,  1414, 11572,  2749, 10249, 13525, 11817,  3454,  6457, 16090,  9931,  7267,
+     3906,  9406,  4599, 15476,  1573, 13351,  9136, 12494,  4454, 10979,  2809, 12671,  4188, 14806, 11642,  1665,
+    10457,  2890, 13752,  9311,  6050, 11407,  6963, 14729,  5857,  3199, 11657,  3820,  9673, 15622,  4466, 13071,
+     6091,  8410, 16028,   751,  7536, 14492,  6231,   285,  5298, 12024,  4323,  7894, 12902,  6289,   126, 11447,
+    15560,  7680, 13602,  3547,  8425,  9712,  2071, 12848,  2984, 16041,  8841,  3656, 10433,  8078,  1434,  5856,
+    13363,  7970, 10252,  2442,  8566, 16139,  7619, 15276,  8765, 13019,  5219, 10176,  7838,  3831, 15125,  6341,
+     2958, 10702,  1833, 12658,  5886, 10260,  7475, 11313,  1282,  9844, 13188,   345,  8962, 14200,  4916, 13523,
+     2027, 14962,  7620,  4281, 16263,  8246, 12729,   830, 13611,  7688,  9854,  5152,   575, 15274,  1697, 13645,
+     8473, 14390,  4208,   493,  8355, 10665,  5496, 15195,  6737,  1785,  5771, 14279,  8684,  1932, 13048,  2738,
+    14690,   340, 13658,  2909,  9745,  4994,   663, 15335,  6346, 13946,  8994,  7167, 10617,   816,  6381, 15449,
+     5151, 12926,  7602,  3662, 15591,  2643, 12799,   794,  8956, 10596,  1163, 14464,  5689,   634, 12014,  7155,
+     1279, 10874,  4766, 13362, 10171,  2171, 12511,  8106, 13753,  6952,   863, 15898,  3416,  9401, 14455,  3697,
+     9106,  1590,  6153, 11764,  1097, 14236,  5290,  8194, 13780,  4394, 11689,  6275, 14325,  4184, 16188, 11113,
+     4610,   912, 14566,  6181, 11550,  4050, 12409,   538,  6036,  1595, 14335,  2905, 16308,  6770,  9469,   517,
+    14403,  8094,  4447,  9561, 14837,  2102, 14124,  3297, 15488,  7935,  2453, 14749,  6759,  2833, 11552,  8657,
+     3858,  9948,  1143, 13768,  5955,  2573,  6682,  9541,  4173, 11385,  2049, 14112,  7224,  9385,  5597, 10952,
+      898,  6242, 12126,  7628, 12734,  4647,  9108,   695, 12270,  8017, 15454,    89, 10898,  5271,  7702, 11188,
+     5685, 10494,  6962, 11560,  6171, 14239,  8305,  2195, 11728,  3576,  1421, 14574,  5822, 13431,  8611,  3476,
+    11176,   586,  9840, 12155,  1060,  8578,  5325, 13626,  4356, 15410,  6662,  8681, 13235, 11005,  2270,  9979,
+    15043,  3422, 12280,  1781,  6786, 15491,  4596, 10728,  2967, 15142,  9826,  5062, 11105,  2135,  5867, 13180,
+     5129, 10750, 15184,  4256, 12540,  6776, 11051,    65,  6996, 10077,  1016, 13199,  2203,  9700,  7097,  3066,
+    15207,  9343,  3468, 13592,  1228,  9892,  2776, 10920, 13875,  9675,  4300, 12118,  1090, 11228,  4715, 12957,
+     3636, 11912, 15346,   802,  8382,  3984, 12158,  6391,  9324,  4588, 12022,  5283, 10545, 15966,  1621,  6494,
+    15556,  5073, 11248,  3307, 10173, 12051, 14376,  1727, 15474,  5785, 12619,  3386, 11617,  2318, 12898,  3749,
+    16178, 10344,  3163, 15409,  2062, 14654,  2974, 13287,  3827,  9775,  4553, 12682,  3222, 13984,   904, 15128,
+     8587,  3499, 13181,  1129, 16234,  3183, 10774,  7566,  5311, 15663, 10001,  4785,  1991, 12069,  2590, 14177,
+     7368, 16055,  4649,  6590, 14627, 10235,  3116, 11126,  7681,  1893, 12517,  2585,  4814,  7558, 16229,  4217,
+     7987, 13671,  5591,  8804, 11168,  3609,  9254,  1109, 12722,  8432,  1839, 13408,  7603, 15433,  9997,  1006,
+    14774,  3022,  7852,  9842,  2219, 16371,  3329, 12216, 14746,  2546, 15731,  5079,  8298, 12048,   259, 13065,
+     7778,  5139, 10674,  7287, 15501,  5646, 14671,  7158,  3672,  7925, 15618,  5873,  8948, 13958,  2233, 10081,
+     7715,  1321,  6617, 11394,  5065, 15869,  8756,   149, 13713,  1761, 15122,  8419,   889,  7707, 13085,  9689,
+       77, 12430,  6829, 14805,   498,  7960,  4551, 10961,  7456,   112,  8808, 14586,  4711, 15717,  6675,  9010,
+     7886,  1489, 11251,  5733,  9697,  6887, 11001,  7434, 15929,  2217, 10567,  8219,  6821,  9178, 12089,  4261,
+     1641, 15804,  4844,  8906,  7213, 12256,  4233, 13763,  8750,   446, 12983,  7997, 16304,  6644,  9621,  5458,
+     1387,  8807,  2200, 13295,  3968,  7278, 16383,   211, 14240,  9867,  5438, 10449, 14784,  1456,  6014, 12629,
+      137,  9608,  2657, 15812,   515, 14106,  5740, 14810,  6121,  4167, 11771,  6518,   462,  4461, 12329,  6726,
+     8662, 12712,   338, 13837,  4969,  8911,  6029,  9411,  4087,  8577,  6463, 11263,  3412, 15447,  5983, 10032,
+     1891, 12499,   476, 11956,  2300,  9046,  4769, 11757,  1922, 12745,   766, 10771,  3193,  6994, 14976,  5628,
+    16071,  9177, 13679,  3124, 13076,  1543,  5569, 10933,  6838, 10005,  2969, 11210,  4138, 12212,  5603,  3197,
+    13880,  7486,  2262,  9027, 13021,  5434, 15794,  2425, 13374,  3905, 10485,  1275,  7768, 10208,   319, 13966,
+     2678, 14785,  4835, 13441,   182, 13916,  4143,  1113, 11442,  6290, 14415,  1299, 16168,  2651,  6099, 12857,
+    10227,  6594, 11399,  2505, 14945,   144,  9833,  1740, 15074,  6779,  3982, 10892,  3145, 11435,    72, 15036,
+    10406, 13859, 11800,  5701, 10839,  1695, 12387,  9194,  6102,  3298, 15908,   437,  8166, 13809,  9221,  3569,
+    14299,  6297, 11524,  7630,  5100, 11847,  7863,  2474, 10413, 16066,  3253, 14331,  8832, 13940,  2439, 11275,
+     4042,  5749, 15775,  7311, 11490,   810, 15363,  1620, 10580, 13579,   582, 12774,  9032,  1377, 13715,  3859,
+    14828,  6884, 16332,  4376,  8263, 13212,   227, 15940,  9317,  6591, 14844,  5162, 13467,  8398,    53, 12509,
+     4044,  2541,  5837, 10371,  7234,  9696, 14323,  3394, 16172,  4859, 13480,  6048, 14366,  2141, 15263,  8780,
+     4452, 10888, 16019,  3975, 11500,  1385,  9881,  8647,  6213, 12263, 16319,  5970, 13498,  4065, 11872,  5360,
+    12497,  7013,  9282,  3585, 11952,  6012,  8886, 14926,  4795,  9349,  3632, 13125,  4926, 11076, 14625,  2260,
+     7963,   574, 14062,  9315,  5426, 12810,  6043, 11242,  2743, 12131,  9285,  1116, 14378,  4999, 12471,  7730,
+     4297,  2846,  8092,   394, 15271,  8444,  4779,  2382, 11479, 13433,  7123,  4122, 11224,  2820, 11881,  7021,
+    10278,  1176, 14873,  3200, 12951,  1668,  9898, 13607,    37,  8991,  7239,  1376, 10781,  4834,  8203, 16215,
+     1702, 12011,  2727, 10259,  3786, 13312,  8025, 12606,  5688,  3092, 15062,  7237,  4714, 10836,  7906,  5455,
+    11368,  2944,  9582,  6312, 14245,  3327, 10274,  6090,  4131, 11422,  2669,  9865,  1527, 12049,  4974, 10462,
+     7490, 11519, 14697,   374, 15612,  2303,  7809, 11683,  1156, 12539,  7535,   426,  9280,  6924, 10230,  1203,
+    14636,  5866,   804,  8441,  6419, 15017,  3447, 13729,   959,  8076,  2810,  9502,  1878,  8554, 15165,  3277,
+     9933,   743, 15565,  8118,  2338, 16351,  1657,  7765, 12487,   508, 12000,  7608,  9987,   280,  8437,  5196,
+    15541, 11848,  4505,  1888, 10576,  3776, 14551,  7775,  4669, 15932,  5558, 13647,  7204,  8909,  1861, 13201,
+     6257, 15811,  9451, 12755,  3419, 13938,  6511, 14991,  8015,  1082,  9543, 12928,  5794, 15695,  5183,  1962,
+    15469,  4560,  8291, 10807,  6498, 16348,  4380,  6910, 12111,  3915, 11456, 15649,  5620, 13018,   718,  9669,
+     7094, 14401,  9061,  1257, 14889,  6598,  2326,  4537, 14527,  7725,  9772,  1961, 16011,  2735, 14421,   714,
+     8471, 12912,  1572, 11023,  1034, 12188,  8049, 14484,  1309, 13772,  8636, 15845,  7302,  3503, 15301,  1955,
+    14157,  1137,  8555,  4664, 11062,  6144, 12837,  4388,  9039,  2610, 10705, 15728,  3566, 12907,  4724, 11940,
+     2888, 13322, 10512, 14123,  2667,  7367, 11915,  4760, 15385, 10772,  5260, 14918, 11304,  6549,  1139, 11049,
+     6072, 13032,  4364, 11486, 10296,  5127, 12844,  9888,  2794, 15643,  5883,  1972, 15254,  3914, 13705,  9646,
+     3300,  7303, 13091,  8359, 16052,  6906,  1290, 13524,  8551,   785, 10365,  2411,  3848, 15570, 10178,  3505,
+    11017,   972,  5057,  7036, 10083,  1301, 10675,  3894, 12171,  5035, 15203,  1801,  8870,   871, 10547, 13207,
+     8607, 12434,  2358, 13962,   685,  8721,  2806, 15211,  5479, 13284,  1950,  9504,  2647,  7667, 14971,  3153,
+    10985,  4295,  6107, 12958,  5350, 10814,  9566, 11928,  1121, 11086,  5185, 11782,  6172,  9274, 12271,  6606,
+    15793,  4579, 14032,  3798, 15296,  5223,  2089,  7214, 12575,  5600,   387,  4524, 10870, 13093,  8855,  5499,
+     9539, 12791,  6415, 12358,  3598, 13937,   660, 15284,  7024, 14515,  5235,  8167, 11614,  1674, 16292,  6268,
+     9410,  7857,  1768,  5133, 12344,  9102,   294, 10086,  6961,  3213, 13143,   461,  4492, 14175,  7592, 16111,
+     2026,  7361, 14302,  1319,  6413, 14530,  3403,  6646, 14108,  5351,  8735, 13460,  7084, 11577,  6423,  1497,
+    10845, 14315,   985,  5864,  3001, 12480,  9630,  3408, 11750,  5933, 14725,  8197, 12737,  6085,   627, 15147,
+     6832, 14047, 11673,  2550, 16140,  5940, 13101,   564,  7355, 13722,  3615,  6790, 12055, 14600,  7787,  3830,
+      367,  5532,  7294, 10028,  4966, 14409,  9341, 11021,  1014,  7998, 14683,  6280, 12548,  3753, 10488,  6448,
+    13637,   148, 11670,  8505,  2977, 15636,   381,  6967, 16162,  3889, 14193,   178, 13150,  4242,  1250, 10401,
+     2448,  9126,  7449, 10509,  6760,  8892, 16091, 11246,  2989, 10572,  7724, 14588,  2385,  6255,   699, 15976,
+     4221,  2870, 15059,  1704,  9356,  5415,  8316, 10337,  1889,  9764,  3999,  1009, 13991,  7297,  8544,   244,
+    12718,  3691, 15509,  9776,  4130, 16134,  5627, 14525,  1977, 11587,  7317,  8969, 12091,  2521,  9677,  4938,
+    13582,  8656,  2954,  9193, 12323,   378,  8497, 10689,   946, 11232,  3188, 10328,  4429,   777, 12631, 16259,
+     5595,  2687, 10047, 15341, 11143,   420,  7467, 15715,  2162, 13293,  4175, 11296,  1578,  9551, 12006,  7858,
+     4125,  2066,  8758, 14419,  7931,  4421,  9006, 15606,  9946,  2310,  8469, 10946,  4474,  2963,  6437, 16171,
+     9128, 11652, 15302,  3363, 12611,  1554,  7397,  3646, 12355,  4893, 10308,   311,  8383, 14113,  1174, 15314,
+     4694,  7930, 15991,  1920, 13995,  4815,  8323, 13505,  2489,  8935,  7425, 10114,  3259, 13912,  8201, 15407,
+     5801, 11733,    83, 13484,  2607, 12831,   618,  4824,  9260, 15555,  3374, 11886,  8157, 13975, 11279,  6901,
+    11961,  8062, 10186,  7146, 16262,  2741, 12147,  3744, 13397,  6317, 15479, 11008,  5691,  3263, 14941, 11267,
+     5382, 14273,  6710,   621, 13219,  2366,  8286, 12570,  4379, 14059,  1471, 15942,  5550, 12860,  3557, 10632,
+       59, 11807,  5695, 15863,  4199,  7199, 15319,  2437, 13189,  7337, 15998,  1384, 15029,  9481,  7792,  3526,
+     9057, 12242,  6537,  4090,  8761, 13826,  5017, 10804,  6350,  9919,   232,  7385, 16210,  4924,  3038, 14567,
+     9848, 13483,  5504,   167, 12445,  1836, 11400,  3065,  5383, 11759, 15986,    63, 14052, 12543, 10106,  2138,
+    13581,  4162,  1239, 13350,  5704, 11418, 15749,  6073, 13799,  2390, 16004,  4413, 11314,  5227,  9217,  2283,
+    12150, 10138,  3457,  6858,  9268, 12266,  3649, 10469,  6246, 12939,  1784, 15192,  6747, 11284,  5031,  2025,
+    12724,  3513, 15073,  5555,  8387,  4071,  9985, 13621,  6519,  1613, 12931,  5811,  1057,  9744,  3847,  2158,
+    13648,   235,  4909, 13232,   936, 10875,  6633, 14877,   101, 11444,  2269,  8695, 13195,  9944,  2482,  4321,
+    10307,  2052, 11698,  7241, 10625,  6155, 11077,  1072,  9420,  6392, 10379,  3777,  8389,   890, 14678,  7989,
+    15482,  3863, 10140,  1764, 10901, 13528,  4702, 11655,  3992,  9114,  4978, 11895,  6202,  2387, 13923,  5063,
+    14875,    40, 13403,  7988,  2001,  3670, 14921,  1465,  8952, 15299,  5355, 13079,  2628, 13785,  8601,  5752,
+     1213, 11502,  7525, 10586,  3787, 14879,  6676,  8307, 14657,  1389,  5990,  9648,  7196,  1541,  5116, 11274,
+     6198,  8038, 10678,  6803,  9581,  2266,  8162,   484,  9972,  8618,  6628, 12849,  2871, 15582,  7164, 13122,
+     5682,  1504, 13421, 11230,   691,  5896, 14473,  1409, 15526,  5388, 12083,  4672,  8690,   547, 14558,  7584,
+     9476,  6480, 10137,  1756, 11942, 14764,  5997,  2320, 15113,  8538,  4002, 10309, 16364,  5034, 14970,  9130,
+     6059, 10671, 15705,  3452,  8824, 14197,  4310,  8011,  9427,  5484, 12647,  4580,   563,  6578, 13660,  7572,
+    15846,  8834,  3328, 13836,  1542, 15144,  3624, 15709,  7645,  2763, 13300,  5900, 15290, 10958,  6689,  2296,
+     5411, 12470,  6844, 14863,  8035,  1041,  9638,  6086, 14753,   127, 13755,  2937,  8091, 12440, 10437,  1757,
+     7178, 11329,  4637, 14465, 11629,  9444,  6733, 12678,  4437,  3129, 11878,  8067,  6527, 10725,   402, 12175,
+    15323,  4542,  2705, 15843,  9370,  4960, 13821,   835, 10247,  7617, 13321,  3278, 15375,  9033, 14448,   757,
+    14977,  2770, 16031,   161, 14007,  4004, 14606, 11896,  3232, 14939,  1316,  9635,  7817,   853, 11630,  3948,
+};
@@ -39,6 +39,8 @@
 #include "common.h"
 #include "filters.h"
 #include "log.h"
+#include "pl_thread.h"
+#include "pl_thread_pool.h"
 
 #ifdef PL_HAVE_WIN32
 #define j1 _j1
@@ -63,7 +65,8 @@ bool pl_filter_config_eq(const struct pl_filter_config *a,
               a->blur     == b->blur   &&
               a->taper    == b->taper  &&
               a->polar    == b->polar  &&
-              a->antiring == b->antiring;
+              a->antiring == b->antiring &&
+              a->separable_terms == b->separable_terms;
 
     for (int i = 0; i < PL_FILTER_MAX_PARAMS; i++) {
         if (a->kernel->tunable[i])
@@ -75,9 +78,49 @@ bool pl_filter_config_eq(const struct pl_filter_config *a,
     return eq;
 }
 
-double pl_filter_sample(const struct pl_filter_config *c, double x)
+// Pre-resolved state for evaluating a filter config at many points, so the
+// per-config invariants don't need to be recomputed for every single tap
+struct sampler {
+    const struct pl_filter_config *c;
+    struct pl_filter_ctx kctx, wctx;
+    double radius;
+    double wscale;   // maps x to the window's domain
+    double taper_scale;
+};
+
+static void sampler_init(struct sampler *s, const struct pl_filter_config *c)
 {
     const float radius = pl_filter_radius_bound(c);
+    pl_assert(!c->kernel->opaque);
+    *s = (struct sampler) {
+        .c = c,
+        .radius = radius,
+        .taper_scale = 1.0 - c->taper / radius,
+        .kctx = {
+            .radius = radius,
+            .params = {
+                c->kernel->tunable[0] ? c->params[0] : c->kernel->params[0],
+                c->kernel->tunable[1] ? c->params[1] : c->kernel->params[1],
+            },
+        },
+    };
+
+    if (c->window) {
+        pl_assert(!c->window->opaque);
+        s->wscale = c->window->radius / radius;
+        s->wctx = (struct pl_filter_ctx) {
+            .radius = c->window->radius,
+            .params = {
+                c->window->tunable[0] ? c->wparams[0] : c->window->params[0],
+                c->window->tunable[1] ? c->wparams[1] : c->window->params[1],
+            },
+        };
+    }
+}
+
+static inline double sampler_eval(const struct sampler *s, double x)
+{
+    const struct pl_filter_config *c = s->c;
 
     // All filters are symmetric, and in particular only need to be defined
     // for [0, radius].
@@ -86,49 +129,42 @@ double pl_filter_sample(const struct pl_filter_config *c, double x)
     // Return early for values outside of the kernel radius, since the functions
     // are not necessarily valid outside of this interval. No such check is
     // needed for the window, because it's always stretched to fit.
-    if (x > radius)
+    if (x > s->radius)
         return 0.0;
 
     // Apply the blur and taper coefficients as needed
-    double kx = x <= c->taper ? 0.0 : (x - c->taper) / (1.0 - c->taper / radius);
+    double kx = x <= c->taper ? 0.0 : (x - c->taper) / s->taper_scale;
     if (c->blur > 0.0)
         kx /= c->blur;
 
-    pl_assert(!c->kernel->opaque);
-    double k = c->kernel->weight(&(const struct pl_filter_ctx) {
-        .radius = radius,
-        .params = {
-            c->kernel->tunable[0] ? c->params[0] : c->kernel->params[0],
-            c->kernel->tunable[1] ? c->params[1] : c->kernel->params[1],
-        },
-    }, kx);
+    double k = c->kernel->weight(&s->kctx, kx);
 
     // Apply the optional windowing function
-    if (c->window) {
-        pl_assert(!c->window->opaque);
-        double wx = x / radius * c->window->radius;
-        k *= c->window->weight(&(struct pl_filter_ctx) {
-            .radius = c->window->radius,
-            .params = {
-                c->window->tunable[0] ? c->wparams[0] : c->window->params[0],
-                c->window->tunable[1] ? c->wparams[1] : c->window->params[1],
-            },
-        }, wx);
-    }
+    if (c->window)
+        k *= c->window->weight(&s->wctx, x * s->wscale);
 
     return k < 0 ? (1 - c->clamp) * k : k;
 }
 
+double pl_filter_sample(const struct pl_filter_config *c, double x)
+{
+    struct sampler s;
+    sampler_init(&s, c);
+    return sampler_eval(&s, x);
+}
+
 static void filter_cutoffs(const struct pl_filter_config *c, float cutoff,
                            float *out_radius, float *out_radius_zero)
 {
-    const float bound = pl_filter_radius_bound(c);
-    float prev = 0.0, fprev = pl_filter_sample(c, prev);
+    struct sampler s;
+    sampler_init(&s, c);
+    const float bound = s.radius;
+    float prev = 0.0, fprev = sampler_eval(&s, prev);
     bool found_root = false;
 
     const float step = 1e-2f;
     for (float x = 0.0; x < bound + step; x += step) {
-        float fx = pl_filter_sample(c, x);
+        float fx = sampler_eval(&s, x);
         if ((fprev > cutoff && fx <= cutoff) || (fprev < -cutoff && fx >= -cutoff)) {
             // Found zero crossing
             float root = x - fx * (x - prev) / (fx - fprev); // secant method
@@ -148,31 +184,233 @@ static void filter_cutoffs(const struct pl_filter_config *c, float cutoff,
 
 // Compute a single row of weights for a given filter in one dimension, indexed
 // by the indicated subpixel offset. Writes `f->row_size` values to `out`.
-static void compute_row(struct pl_filter_t *f, double offset, float *out)
+static void compute_row(struct pl_filter_t *f, const struct sampler *s,
+                        double offset, float *out)
 {
+    // For the example of a filter with row size 4 and offset 0.3, we have:
+    //
+    // 0    1 *  2    3
+    //
+    // * indicates the sampled position. What we want to compute is the
+    // distance from each index to that sampled position.
+    pl_assert(f->row_size % 2 == 0);
+    const int base = f->row_size / 2 - 1; // index to the left of the center
+    const double center = base + offset; // offset of center relative to idx 0
+
     double wsum = 0.0;
     for (int i = 0; i < f->row_size; i++) {
-        // For the example of a filter with row size 4 and offset 0.3, we have:
-        //
-        // 0    1 *  2    3
-        //
-        // * indicates the sampled position. What we want to compute is the
-        // distance from each index to that sampled position.
-        pl_assert(f->row_size % 2 == 0);
-        const int base = f->row_size / 2 - 1; // index to the left of the center
-        const double center = base + offset; // offset of center relative to idx 0
-        double w = pl_filter_sample(&f->params.config, i - center);
+        double w = sampler_eval(s, i - center);
         out[i] = w;
         wsum += w;
     }
 
     // Readjust weights to preserve energy
     pl_assert(wsum > 0);
+    const double scale = 1.0 / wsum;
     for (int i = 0; i < f->row_size; i++)
-        out[i] /= wsum;
+        out[i] *= scale;
+}
+
+// Number of LUT rows computed per parallel job
+#define ROWS_PER_JOB 16
+
+struct generate_args {
+    struct pl_filter_t *f;
+    float *weights;
+};
+
+static void generate_polar(void *priv, int index)
+{
+    const struct generate_args *args = priv;
+    const struct pl_filter_t *f = args->f;
+    const int lut_entries = f->params.lut_entries;
+    const int end = PL_MIN((index + 1) * ROWS_PER_JOB, lut_entries);
+    struct sampler s;
+    sampler_init(&s, &f->params.config);
+    for (int i = index * ROWS_PER_JOB; i < end; i++) {
+        double x = f->radius * i / (lut_entries - 1);
+        args->weights[i] = sampler_eval(&s, x);
+    }
+}
+
+static void generate_rows(void *priv, int index)
+{
+    const struct generate_args *args = priv;
+    struct pl_filter_t *f = args->f;
+    const int lut_entries = f->params.lut_entries;
+    const int end = PL_MIN((index + 1) * ROWS_PER_JOB, lut_entries);
+    struct sampler s;
+    sampler_init(&s, &f->params.config);
+    for (int i = index * ROWS_PER_JOB; i < end; i++) {
+        compute_row(f, &s, i / (double)(lut_entries - 1),
+                    args->weights + f->row_stride * i);
+    }
+}
+
+// Resolution of the grid used to decompose polar filters into separable terms
+#define SEP_GRID 96
+
+// Cyclic Jacobi eigenvalue algorithm for the symmetric n*n matrix `a`, which
+// is destroyed in the process. Eigenvalues end up on the diagonal of `a`, and
+// the corresponding (unit) eigenvectors in the columns of `v`.
+static void jacobi_eigen(double *a, double *v, int n)
+{
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++)
+            v[i * n + j] = i == j;
+    }
+
+    for (int sweep = 0; sweep < 50; sweep++) {
+        double off = 0.0, diag = 0.0;
+        for (int i = 0; i < n; i++) {
+            diag += a[i * n + i] * a[i * n + i];
+            for (int j = i + 1; j < n; j++)
+                off += a[i * n + j] * a[i * n + j];
+        }
+        if (off <= 1e-22 * diag)
+            return;
+
+        for (int p = 0; p < n; p++) {
+            for (int q = p + 1; q < n; q++) {
+                const double apq = a[p * n + q];
+                if (fabs(apq) < 1e-30)
+                    continue;
+                const double theta = (a[q * n + q] - a[p * n + p]) / (2 * apq);
+                const double t = (theta >= 0 ? 1 : -1) /
+                                 (fabs(theta) + sqrt(theta * theta + 1));
+                const double c = 1 / sqrt(t * t + 1), s = t * c;
+                for (int k = 0; k < n; k++) {
+                    const double akp = a[k * n + p], akq = a[k * n + q];
+                    a[k * n + p] = c * akp - s * akq;
+                    a[k * n + q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < n; k++) {
+                    const double apk = a[p * n + k], aqk = a[q * n + k];
+                    a[p * n + k] = c * apk - s * aqk;
+                    a[q * n + k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < n; k++) {
+                    const double vkp = v[k * n + p], vkq = v[k * n + q];
+                    v[k * n + p] = c * vkp - s * vkq;
+                    v[k * n + q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+}
+
+// Approximates the polar filter by `num_terms` separable terms. Sampled on a
+// square grid, the 2D kernel forms a symmetric matrix W[x][y], so its
+// eigendecomposition W = sum(λ_k * v_k * v_kᵀ) directly gives separable
+// terms, of which the ones with the largest |λ_k| form the best low-rank
+// approximation. The eigenvectors are then linearly interpolated to get
+// continuous 1D kernels, which are laid out like separable filter rows.
+static void generate_terms(struct pl_filter_t *f, int num_terms)
+{
+    const int n = SEP_GRID;
+    const double step = 2.0 * f->radius / n;
+    double *a = pl_alloc(NULL, 2 * n * n * sizeof(double)), *v = a + n * n;
+
+    struct sampler s;
+    sampler_init(&s, &f->params.config);
+    for (int i = 0; i < n; i++) {
+        const double x = (i + 0.5) * step - f->radius;
+        for (int j = 0; j <= i; j++) {
+            const double y = (j + 0.5) * step - f->radius;
+            a[i * n + j] = a[j * n + i] = sampler_eval(&s, sqrt(x * x + y * y));
+        }
+    }
+
+    jacobi_eigen(a, v, n);
+
+    f->row_size = ceilf(f->radius) * 2;
+    f->row_stride = PL_ALIGN(f->row_size + 1, f->params.row_stride_align);
+    f->num_terms = num_terms;
+
+    bool used[SEP_GRID] = {0};
+    const int lut_entries = f->params.lut_entries;
+    for (int k = 0; k < num_terms; k++) {
+        int best = 0;
+        for (int i = 1; i < n; i++) {
+            if (!used[i] && (used[best] || fabs(a[i * n + i]) > fabs(a[best * n + best])))
+                best = i;
+        }
+        used[best] = true;
+
+        const double lambda = a[best * n + best];
+        const double scale = sqrt(fabs(lambda));
+        f->term_signs[k] = lambda < 0 ? -1.0f : 1.0f;
+
+        float *weights = pl_calloc(f, lut_entries * f->row_stride, sizeof(float));
+        const int base = f->row_size / 2 - 1;
+        for (int r = 0; r < lut_entries; r++) {
+            float *row = weights + r * f->row_stride;
+            const double center = base + r / (double) (lut_entries - 1);
+            double wsum = 0.0;
+            for (int i = 0; i < f->row_size; i++) {
+                // Position on the grid, relative to the first sample
+                const double g = (i - center + f->radius) / step - 0.5;
+                const int g0 = floor(g);
+                const double t = g - g0;
+                double w = 0.0;
+                if (g0 >= 0 && g0 < n)
+                    w += (1 - t) * v[g0 * n + best];
+                if (g0 + 1 >= 0 && g0 + 1 < n)
+                    w += t * v[(g0 + 1) * n + best];
+                row[i] = scale * w;
+                wsum += row[i];
+            }
+            row[f->row_size] = wsum;
+        }
+
+        f->terms[k] = weights;
+    }
+
+    pl_free(a);
 }
 
 // Needed for backwards compatibility with v1 configuration API
+// Generated filters are shared process-wide between all users requesting
+// identical parameters, since they are immutable once generated. This mainly
+// avoids recomputing the same LUTs for every plane and every renderer.
+struct filter_priv {
+    int refcount; // protected by filter_cache.lock
+};
+
+static struct {
+    pl_static_mutex lock;
+    PL_ARRAY(struct pl_filter_t *) filters;
+} filter_cache = {
+    .lock = PL_STATIC_MUTEX_INITIALIZER,
+};
+
+// Stricter than `pl_filter_function_eq`, since the cached filter must be
+// identical for all practical purposes
+static bool filter_function_same(const struct pl_filter_function *a,
+                                 const struct pl_filter_function *b)
+{
+    if (!a || !b)
+        return a == b;
+
+    return a->weight    == b->weight    &&
+           a->radius    == b->radius    &&
+           a->resizable == b->resizable &&
+           !memcmp(a->tunable, b->tunable, sizeof(a->tunable)) &&
+           !memcmp(a->params, b->params, sizeof(a->params));
+}
+
+static bool filter_params_eq(const struct pl_filter_params *a,
+                             const struct pl_filter_params *b)
+{
+    return pl_filter_config_eq(&a->config, &b->config) &&
+           filter_function_same(a->config.kernel, b->config.kernel) &&
+           filter_function_same(a->config.window, b->config.window) &&
+           a->lut_entries      == b->lut_entries  &&
+           a->cutoff           == b->cutoff       &&
+           a->max_row_size     == b->max_row_size &&
+           a->row_stride_align == b->row_stride_align;
+}
+
 static struct pl_filter_function *dupfilter(void *alloc,
                                             const struct pl_filter_function *f)
 {
@@ -199,7 +437,21 @@ pl_filter pl_filter_generate(pl_log log, const struct pl_filter_params *params)
         return NULL;
     }
 
-    struct pl_filter_t *f = pl_zalloc_ptr(NULL, f);
+    // Re-use an existing filter with identical parameters, if possible
+    pl_static_mutex_lock(&filter_cache.lock);
+    for (int i = 0; i < filter_cache.filters.num; i++) {
+        struct pl_filter_t *f = filter_cache.filters.elem[i];
+        if (filter_params_eq(&f->params, params)) {
+            struct filter_priv *p = PL_PRIV(f);
+            p->refcount++;
+            pl_static_mutex_unlock(&filter_cache.lock);
+            return f;
+        }
+    }
+
+    struct pl_filter_t *f = pl_zalloc_obj(NULL, f, struct filter_priv);
+    struct filter_priv *p = PL_PRIV(f);
+    p->refcount = 1;
     f->params = *params;
     f->params.config.kernel = dupfilter(f, params->config.kernel);
     f->params.config.window = dupfilter(f, params->config.window);
@@ -209,13 +461,23 @@ pl_filter pl_filter_generate(pl_log log, const struct pl_filter_params *params)
     f->radius_cutoff = f->radius; // backwards compatibility
 
     float *weights;
+    const int num_jobs = PL_DIV_UP(params->lut_entries, ROWS_PER_JOB);
     if (params->config.polar) {
         // Compute a 1D array indexed by radius
         weights = pl_alloc(f, params->lut_entries * sizeof(float));
-        for (int i = 0; i < params->lut_entries; i++) {
-            double x = f->radius * i / (params->lut_entries - 1);
-            weights[i] = pl_filter_sample(&params->config, x);
+        pl_parallel_for(num_jobs, generate_polar, &(struct generate_args) {
+            .f       = f,
+            .weights = weights,
+        });
+
+        int num_terms = params->config.separable_terms;
+        if (num_terms > PL_FILTER_MAX_TERMS) {
+            pl_warn(log, "Requested %d separable terms, exceeding the maximum "
+                    "of %d!", num_terms, PL_FILTER_MAX_TERMS);
+            num_terms = PL_FILTER_MAX_TERMS;
         }
+        if (num_terms > 0)
+            generate_terms(f, num_terms);
     } else {
         // Pick the most appropriate row size
         f->row_size = ceilf(f->radius) * 2;
@@ -230,19 +492,43 @@ pl_filter pl_filter_generate(pl_log log, const struct pl_filter_params *params)
 
         // Compute a 2D array indexed by the subpixel position
         weights = pl_calloc(f, params->lut_entries * f->row_stride, sizeof(float));
-        for (int i = 0; i < params->lut_entries; i++) {
-            compute_row(f, i / (double)(params->lut_entries - 1),
-                        weights + f->row_stride * i);
-        }
+        pl_parallel_for(num_jobs, generate_rows, &(struct generate_args) {
+            .f       = f,
+            .weights = weights,
+        });
     }
 
     f->weights = weights;
+    PL_ARRAY_APPEND(NULL, filter_cache.filters, f);
+    pl_static_mutex_unlock(&filter_cache.lock);
     return f;
 }
 
 void pl_filter_free(pl_filter *filter)
 {
-    pl_free_ptr((void **) filter);
+    struct pl_filter_t *f = (struct pl_filter_t *) *filter;
+    if (!f)
+        return;
+
+    struct filter_priv *p = PL_PRIV(f);
+    pl_static_mutex_lock(&filter_cache.lock);
+    if (--p->refcount == 0) {
+        for (int i = 0; i < filter_cache.filters.num; i++) {
+            if (filter_cache.filters.elem[i] == f) {
+                PL_ARRAY_REMOVE_AT(filter_cache.filters, i);
+                break;
+            }
+        }
+
+        if (!filter_cache.filters.num) {
+            pl_free(filter_cache.filters.elem);
+            filter_cache.filters.elem = NULL;
+        }
+
+        pl_free(f);
+    }
+    pl_static_mutex_unlock(&filter_cache.lock);
+    *filter = NULL;
 }
 
 // Built-in filter functions
@@ -578,6 +864,19 @@ const struct pl_filter_function pl_filter_function_oversample = {
     .opaque  = true,
 };
 
+static double motion(const struct pl_filter_ctx *f, double x)
+{
+    return 1.0 - x / f->radius;
+}
+
+const struct pl_filter_function pl_filter_function_motion = {
+    .name    = "motion",
+    .weight  = motion,
+    .radius  = 1.0,
+    .params  = {16.0, 4.0},
+    .tunable = {true, true},
+};
+
 const struct pl_filter_function * const pl_filter_functions[] = {
     &pl_filter_function_box,
     &filter_function_dirichlet, // alias
@@ -604,6 +903,7 @@ const struct pl_filter_function * const pl_filter_functions[] = {
     &pl_filter_function_spline36,
     &pl_filter_function_spline64,
     &pl_filter_function_oversample,
+    &pl_filter_function_motion,
     NULL,
 };
 
@@ -894,6 +1194,14 @@ const struct pl_filter_config pl_filter_oversample = {
     .recommended = PL_FILTER_UPSCALING | PL_FILTER_FRAME_MIXING,
 };
 
+const struct pl_filter_config pl_filter_motion = {
+    .name        = "motion",
+    .description = "Motion-compensated interpolation",
+    .kernel      = &pl_filter_function_motion,
+    .params      = {16.0, 4.0},
+    .allowed     = PL_FILTER_FRAME_MIXING,
+};
+
 const struct pl_filter_config * const pl_filter_configs[] = {
     // Sorted roughly in terms of priority / relevance
     &pl_filter_bilinear,
@@ -912,6 +1220,7 @@ const struct pl_filter_config * const pl_filter_configs[] = {
     &pl_filter_hermite,
     &pl_filter_gaussian,
     &pl_filter_oversample,
+    &pl_filter_motion,
     &pl_filter_mitchell,
     &pl_filter_mitchell_clamp,
     &pl_filter_sinc,
@@ -19,6 +19,18 @@
 
 #include "common.h"
 
+// Fast path for %hx, which is used for every shader identifier
+static inline int print_hex(char *buf, unsigned short n)
+{
+    static const char digits[] = "0123456789abcdef";
+    int len = 1;
+    for (unsigned short t = n >> 4; t; t >>= 4)
+        len++;
+    for (int i = len - 1; i >= 0; i--, n >>= 4)
+        buf[i] = digits[n & 0xF];
+    return len;
+}
+
 void pl_str_append_asprintf_c(void *alloc, pl_str *str, const char *fmt, ...)
 {
     va_list ap;
@@ -65,7 +77,7 @@ void pl_str_append_vasprintf_c(void *alloc, pl_str *str, const char *fmt,
             break;
         case 'h': ; // only used for %hx
             assert(c[1] == 'x');
-            len = pl_str_print_hex(buf, sizeof(buf), (unsigned short) va_arg(ap, unsigned int));
+            len = print_hex(buf, (unsigned short) va_arg(ap, unsigned int));
             c++;
             break;
         case 'u':
@@ -154,7 +166,7 @@ size_t pl_str_append_memprintf_c(void *alloc, pl_str *str, const char *fmt,
             assert(c[1] == 'x');
             unsigned short hx;
             LOAD(hx);
-            len = pl_str_print_hex(buf, sizeof(buf), hx);
+            len = print_hex(buf, hx);
             c++;
             break;
         case 'u': ;
@@ -18,7 +18,7 @@
 #include <math.h>
 
 #include "common.h"
-#include "pl_thread.h"
+#include "pl_thread_pool.h"
 
 #include <libplacebo/gamut_mapping.h>
 
@@ -247,7 +247,7 @@ static const float pq_eotf_lut[1024+1] = {
 static inline float pq_eotf(float x)
 {
     float idxf  = fminf(fmaxf(x, 0.0f), 1.0f) * (PQ_LUT_SIZE - 1);
-    int ipart   = floorf(idxf);
+    int ipart   = (int) idxf; // truncation, `idxf` is never negative
     float fpart = idxf - ipart;
     return PL_MIX(pq_eotf_lut[ipart], pq_eotf_lut[ipart + 1], fpart);
 }
@@ -381,27 +381,26 @@ struct generate_args {
     int count;
 };
 
-static PL_THREAD_VOID generate(void *priv)
+static void generate(void *priv, int index)
 {
-    const struct generate_args *args = priv;
+    const struct generate_args *args = &((const struct generate_args *) priv)[index];
     const struct pl_gamut_map_params *params = args->params;
 
     float *in = args->out;
     const int end = args->start + args->count;
     for (int h = args->start; h < end; h++) {
+        const float hx = (float) h / (params->lut_size_h - 1);
+        const float hue = PL_MIX(-M_PI, M_PI, hx);
+        const float cos_h = cosf(hue), sin_h = sinf(hue);
         for (int C = 0; C < params->lut_size_C; C++) {
+            const float Cx = (float) C / (params->lut_size_C - 1);
+            const float chroma = PL_MIX(0.0f, 0.5f, Cx);
+            const float P = chroma * cos_h, T = chroma * sin_h;
             for (int I = 0; I < params->lut_size_I; I++) {
                 float Ix = (float) I / (params->lut_size_I - 1);
-                float Cx = (float) C / (params->lut_size_C - 1);
-                float hx = (float) h / (params->lut_size_h - 1);
-                struct IPT ipt = ich2ipt((struct ICh) {
-                    .I = PL_MIX(params->min_luma, params->max_luma, Ix),
-                    .C = PL_MIX(0.0f, 0.5f, Cx),
-                    .h = PL_MIX(-M_PI, M_PI, hx),
-                });
-                in[0] = ipt.I;
-                in[1] = ipt.P;
-                in[2] = ipt.T;
+                in[0] = PL_MIX(params->min_luma, params->max_luma, Ix);
+                in[1] = P;
+                in[2] = T;
                 in += params->lut_stride;
             }
         }
@@ -411,19 +410,18 @@ static PL_THREAD_VOID generate(void *priv)
     fix_constants(&fixed.constants);
     fixed.lut_size_h = args->count;
     FUN(params).map(args->out, &fixed);
-    PL_THREAD_RETURN();
 }
 
 void pl_gamut_map_generate(float *out, const struct pl_gamut_map_params *params)
 {
-    enum { MAX_WORKERS = 32 };
-    struct generate_args args[MAX_WORKERS];
-
-    const int num_per_worker = PL_DIV_UP(params->lut_size_h, MAX_WORKERS);
-    const int num_workers = PL_DIV_UP(params->lut_size_h, num_per_worker);
-    for (int i = 0; i < num_workers; i++) {
-        const int start = i * num_per_worker;
-        const int count = PL_MIN(num_per_worker, params->lut_size_h - start);
+    enum { MAX_JOBS = 32 };
+    struct generate_args args[MAX_JOBS];
+
+    const int num_per_job = PL_DIV_UP(params->lut_size_h, MAX_JOBS);
+    const int num_jobs = PL_DIV_UP(params->lut_size_h, num_per_job);
+    for (int i = 0; i < num_jobs; i++) {
+        const int start = i * num_per_job;
+        const int count = PL_MIN(num_per_job, params->lut_size_h - start);
         args[i] = (struct generate_args) {
             .params = params,
             .out    = out,
@@ -433,18 +431,7 @@ void pl_gamut_map_generate(float *out, const struct pl_gamut_map_params *params)
         out += count * params->lut_size_C * params->lut_size_I * params->lut_stride;
     }
 
-    pl_thread workers[MAX_WORKERS] = {0};
-    for (int i = 0; i < num_workers; i++) {
-        if (pl_thread_create(&workers[i], generate, &args[i]) != 0)
-            generate(&args[i]); // fallback
-    }
-
-    for (int i = 0; i < num_workers; i++) {
-        if (!workers[i])
-            continue;
-        if (pl_thread_join(workers[i]) != 0)
-            generate(&args[i]); // fallback
-    }
+    pl_parallel_for(num_jobs, generate, args);
 }
 
 void pl_gamut_map_sample(float x[3], const struct pl_gamut_map_params *params)
@@ -457,6 +444,99 @@ void pl_gamut_map_sample(float x[3], const struct pl_gamut_map_params *params)
     FUN(params).map(x, &fixed);
 }
 
+// Probe LUT size, chosen as 2^k + 1 so that all candidate sizes nest
+static const int probe_size[3] = { 17, 17, 65 };
+
+static inline struct IPT probe_input(const struct pl_gamut_map_params *params,
+                                     int I, int C, int h)
+{
+    const float Ix = (float) I / (probe_size[0] - 1);
+    const float Cx = (float) C / (probe_size[1] - 1);
+    const float hx = (float) h / (probe_size[2] - 1);
+    return ich2ipt((struct ICh) {
+        .I = PL_MIX(params->min_luma, params->max_luma, Ix),
+        .C = PL_MIX(0.0f, 0.5f, Cx),
+        .h = PL_MIX(-M_PI, M_PI, hx),
+    });
+}
+
+// Maximum error of reconstructing the probe from every `step`-th sample
+// along `axis`, considering only samples inside the source gamut
+static float probe_error(const float *lut, const bool *relevant, int axis, int step)
+{
+    const int stride[3] = { 1, probe_size[0], probe_size[0] * probe_size[1] };
+    float err = 0.0f;
+    for (int h = 0; h < probe_size[2]; h++) {
+        for (int C = 0; C < probe_size[1]; C++) {
+            for (int I = 0; I < probe_size[0]; I++) {
+                const int idx[3] = { I, C, h };
+                const int pos = idx[axis] % step;
+                const int i = I * stride[0] + C * stride[1] + h * stride[2];
+                if (!pos || !relevant[i])
+                    continue;
+                const float *x = &lut[3 * i];
+                const float *a = x - 3 * pos * stride[axis];
+                const float *b = a + 3 * step * stride[axis];
+                const float t = (float) pos / step;
+                for (int c = 0; c < 3; c++)
+                    err = fmaxf(err, fabsf(PL_MIX(a[c], b[c], t) - x[c]));
+            }
+        }
+    }
+
+    return err;
+}
+
+bool pl_gamut_map_fit_lut_size(struct pl_gamut_map_params *params, float max_error)
+{
+    struct pl_gamut_map_params probe = *params;
+    probe.lut_size_I = probe_size[0];
+    probe.lut_size_C = probe_size[1];
+    probe.lut_size_h = probe_size[2];
+    probe.lut_stride = 3;
+
+    const int num = probe_size[0] * probe_size[1] * probe_size[2];
+    float *lut = pl_alloc(NULL, num * sizeof(float[3]));
+    bool *relevant = pl_alloc(NULL, num * sizeof(bool));
+    pl_gamut_map_generate(lut, &probe);
+
+    struct cache cache;
+    struct gamut src;
+    get_gamuts(NULL, &src, &cache, params);
+
+    float id_err = 0.0f;
+    for (int h = 0, i = 0; h < probe_size[2]; h++) {
+        for (int C = 0; C < probe_size[1]; C++) {
+            for (int I = 0; I < probe_size[0]; I++, i++) {
+                const struct IPT in = probe_input(params, I, C, h);
+                relevant[i] = ingamut(in, src);
+                if (!relevant[i])
+                    continue;
+                const float *out = &lut[3 * i];
+                id_err = fmaxf(id_err, fabsf(out[0] - in.I));
+                id_err = fmaxf(id_err, fabsf(out[1] - in.P));
+                id_err = fmaxf(id_err, fabsf(out[2] - in.T));
+            }
+        }
+    }
+
+    int *sizes[3] = { &params->lut_size_I, &params->lut_size_C, &params->lut_size_h };
+    for (int axis = 0; axis < 3; axis++) {
+        // Sizes beyond the probe resolution can't be validated, leave as-is
+        for (int step = probe_size[axis] - 1; step > 1; step /= 2) {
+            if (probe_error(lut, relevant, axis, step) <= max_error) {
+                const int size = (probe_size[axis] - 1) / step + 1;
+                *sizes[axis] = PL_MIN(*sizes[axis], size);
+                break;
+            }
+        }
+    }
+
+    pl_free(lut);
+    pl_free(relevant);
+    return id_err > max_error;
+}
+
 #define LUT_SIZE(p) (p->lut_size_I * p->lut_size_C * p->lut_size_h * p->lut_stride)
 #define FOREACH_LUT(lut, C)                                                     \
     for (struct IPT *_i = (struct IPT *) lut,                                   \
@@ -466,13 +546,14 @@ void pl_gamut_map_sample(float x[3], const struct pl_gamut_map_params *params)
          *_i = C, _i = (struct IPT *) ((float *) _i + params->lut_stride))
 
 // Something like PL_MIX(base, c, x) but follows an exponential curve, note
-// that this can be used to extend 'c' outwards for x > 1
-static inline struct ICh mix_exp(struct ICh c, float x, float gamma, float base)
+// that this can be used to extend 'c' outwards for x > 1. Scaling the chroma
+// preserves the hue, so this operates on IPT directly.
+static inline struct IPT mix_exp(struct IPT c, float x, float gamma, float base)
 {
-    return (struct ICh) {
+    return (struct IPT) {
         .I = base + (c.I - base) * powf(x, gamma),
-        .C = c.C * x,
-        .h = c.h,
+        .P = c.P * x,
+        .T = c.T * x,
     };
 }
 
@@ -498,10 +579,13 @@ desat_bounded(float I, float h, float Cmin, float Cmax, struct gamut gamut)
     if (I >= gamut.max_luma)
         return (struct ICh) { .I = gamut.max_luma, .C = 0, .h = h };
 
+    // The hue is constant, so compute the direction in the P/T plane once
+    const float cos_h = cosf(h), sin_h = sinf(h);
     const float maxDI = I * maxDelta;
     struct ICh res = { .I = I, .C = (Cmin + Cmax) / 2, .h = h };
     do {
-        if (ingamut(ich2ipt(res), gamut)) {
+        const struct IPT ipt = { .I = I, .P = res.C * cos_h, .T = res.C * sin_h };
+        if (ingamut(ipt, gamut)) {
             Cmin = res.C;
         } else {
             Cmax = res.C;
@@ -567,8 +651,7 @@ clip_gamma(struct IPT ipt, float gamma, struct gamut gamut)
     gamma = scale_gamma(gamma, ich, peak, gamut);
     float lo = 0.0f, hi = 1.0f, x = 0.5f;
     do {
-        struct ICh test = mix_exp(ich, x, gamma, peak.I);
-        if (ingamut(ich2ipt(test), gamut)) {
+        if (ingamut(mix_exp(ipt, x, gamma, peak.I), gamut)) {
             lo = x;
         } else {
             hi = x;
@@ -576,7 +659,7 @@ clip_gamma(struct IPT ipt, float gamma, struct gamut gamut)
         x = (lo + hi) / 2.0f;
     } while (hi - lo > maxDI);
 
-    return ich2ipt(mix_exp(ich, x, gamma, peak.I));
+    return mix_exp(ipt, x, gamma, peak.I);
 }
 
 static float softclip(float value, float source, float target,
@@ -923,9 +1006,8 @@ static void linear(float *lut, const struct pl_gamut_map_params *params)
         gain = fminf(gain, saturate(hue, dst).C / saturate(hue, src).C);
 
     FOREACH_LUT(lut, ipt) {
-        struct ICh ich = ipt2ich(ipt);
-        ich.C *= gain;
-        ipt = ich2ipt(ich);
+        ipt.P *= gain;
+        ipt.T *= gain;
     }
 }
 
@@ -15,6 +15,8 @@
  * License along with libplacebo. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "cache.h"
+#include "pl_thread.h"
 #include "spirv.h"
 
 extern const struct spirv_compiler pl_spirv_shaderc;
@@ -29,6 +31,292 @@ static const struct spirv_compiler *compilers[] = {
 #endif
 };
 
+// Upper bound on the number of compilation worker threads
+#define MAX_SPIRV_WORKERS 16
+
+struct spirv_job {
+    struct spirv_job *next;     // next job in `queue`
+    uint64_t hash;
+    struct pl_glsl_version glsl_ver;
+    enum glsl_shader_stage stage;
+    char *shader;
+    pl_str result;              // allocated on the job itself
+    int refcount;               // number of outstanding handles
+    bool running;
+    bool done;
+};
+
+struct spirv_service {
+    pl_mutex lock;
+    pl_cond wakeup;                         // signalled for new jobs, or on quit
+    pl_cond done;                           // signalled when a job completes
+    struct spirv_job *queue;                // jobs not yet picked up, oldest first
+    PL_ARRAY(struct spirv_job *) inflight;  // jobs not yet completed
+    pl_thread workers[MAX_SPIRV_WORKERS];
+    int num_workers;
+    int max_workers;
+    bool quit;
+};
+
+// Runs the compiler, followed by the optional optimization stage
+static pl_str spirv_compile(pl_spirv spirv, void *alloc,
+                            struct pl_glsl_version glsl_ver,
+                            enum glsl_shader_stage stage,
+                            const char *shader)
+{
+    pl_str res = spirv->impl->compile(spirv, alloc, glsl_ver, stage, shader);
+    if (!res.len || !spirv->opt)
+        return res;
+
+#ifdef PL_HAVE_SPIRV_TOOLS
+    pl_str opt = pl_spirv_optimize(spirv, alloc, spirv->opt, res);
+    if (opt.len) {
+        pl_free(res.buf);
+        return opt;
+    }
+
+    // Keep the unoptimized module, which is still perfectly valid
+    PL_WARN(spirv, "Falling back to unoptimized SPIR-V");
+#endif
+    return res;
+}
+
+bool pl_spirv_set_opt(pl_spirv spirv, enum pl_spirv_opt opt)
+{
+#ifdef PL_HAVE_SPIRV_TOOLS
+    struct pl_spirv_t *s = (struct pl_spirv_t *) spirv;
+    pl_assert(!s->opt); // may only be set once
+    if (opt) {
+        s->opt = opt;
+        pl_hash_merge(&s->signature, pl_spirv_opt_signature(opt));
+        PL_INFO(spirv, "Enabled SPIRV-Tools %s optimization",
+                opt == PL_SPIRV_OPT_SIZE ? "size" : "performance");
+    }
+    return true;
+#else
+    if (opt)
+        PL_WARN(spirv, "libplacebo was built without SPIRV-Tools, ignoring "
+                "requested SPIR-V optimization!");
+    return !opt;
+#endif
+}
+
+static bool glsl_equal(const struct pl_glsl_version *a,
+                       const struct pl_glsl_version *b)
+{
+    return a->version           == b->version &&
+           a->gles              == b->gles &&
+           a->vulkan            == b->vulkan &&
+           a->compute           == b->compute &&
+           a->max_shmem_size    == b->max_shmem_size &&
+           a->max_group_threads == b->max_group_threads &&
+           a->max_group_size[0] == b->max_group_size[0] &&
+           a->max_group_size[1] == b->max_group_size[1] &&
+           a->max_group_size[2] == b->max_group_size[2] &&
+           a->subgroup_size     == b->subgroup_size &&
+           a->min_gather_offset == b->min_gather_offset &&
+           a->max_gather_offset == b->max_gather_offset;
+}
+
+// Unlinks `job` from the queue. Must be called with `lock` held.
+static void dequeue_job(struct spirv_service *s, struct spirv_job *job)
+{
+    for (struct spirv_job **prev = &s->queue; *prev; prev = &(*prev)->next) {
+        if (*prev == job) {
+            *prev = job->next;
+            job->next = NULL;
+            return;
+        }
+    }
+}
+
+// Runs a dequeued job. Must be called with `lock` held, which is released for
+// the duration of the compilation.
+static void run_job(pl_spirv spirv, struct spirv_job *job)
+{
+    struct spirv_service *s = spirv->service;
+    job->running = true;
+    pl_mutex_unlock(&s->lock);
+
+    pl_str res = spirv_compile(spirv, job, job->glsl_ver, job->stage,
+                               job->shader);
+
+    pl_mutex_lock(&s->lock);
+    job->result = res;
+    job->done = true;
+    for (int i = 0; i < s->inflight.num; i++) {
+        if (s->inflight.elem[i] == job) {
+            PL_ARRAY_REMOVE_AT(s->inflight, i);
+            break;
+        }
+    }
+    pl_cond_broadcast(&s->done);
+}
+
+static PL_THREAD_VOID spirv_worker(void *arg)
+{
+    pl_spirv spirv = arg;
+    struct spirv_service *s = spirv->service;
+
+    pl_mutex_lock(&s->lock);
+    while (!s->quit) {
+        struct spirv_job *job = s->queue;
+        if (!job) {
+            pl_cond_wait(&s->wakeup, &s->lock);
+            continue;
+        }
+
+        dequeue_job(s, job);
+        run_job(spirv, job);
+    }
+    pl_mutex_unlock(&s->lock);
+
+    PL_THREAD_RETURN();
+}
+
+int pl_spirv_set_threads(pl_spirv spirv, int num_threads)
+{
+    struct spirv_service *s = spirv->service;
+    pl_mutex_lock(&s->lock);
+    s->max_workers = PL_CLAMP(num_threads, s->num_workers, MAX_SPIRV_WORKERS);
+    int num = s->max_workers;
+    pl_mutex_unlock(&s->lock);
+    return num;
+}
+
+// Starts any missing worker threads. Must be called with `lock` held.
+static void start_workers(pl_spirv spirv)
+{
+    struct spirv_service *s = spirv->service;
+    while (s->num_workers < s->max_workers) {
+        pl_thread *thread = &s->workers[s->num_workers];
+        if (pl_thread_create(thread, spirv_worker, (void *) spirv) != 0) {
+            PL_WARN(spirv, "Failed starting SPIR-V compilation thread, "
+                    "limiting to %d threads!", s->num_workers);
+            s->max_workers = s->num_workers;
+            break;
+        }
+        s->num_workers++;
+    }
+}
+
+pl_spirv_job pl_spirv_compile_async(pl_spirv spirv,
+                                    struct pl_glsl_version glsl_ver,
+                                    enum glsl_shader_stage stage,
+                                    const char *shader)
+{
+    struct spirv_service *s = spirv->service;
+    uint64_t hash = pl_str0_hash(shader);
+    pl_hash_merge(&hash, stage);
+    pl_hash_merge(&hash, glsl_ver.version);
+
+    pl_mutex_lock(&s->lock);
+    for (int i = 0; i < s->inflight.num; i++) {
+        struct spirv_job *job = s->inflight.elem[i];
+        if (job->hash == hash && job->stage == stage &&
+            glsl_equal(&job->glsl_ver, &glsl_ver) &&
+            strcmp(job->shader, shader) == 0)
+        {
+            PL_TRACE(spirv, "Sharing in-flight SPIR-V compilation job 0x%"PRIx64,
+                     hash);
+            job->refcount++;
+            pl_mutex_unlock(&s->lock);
+            return job;
+        }
+    }
+
+    struct spirv_job *job = pl_zalloc_ptr(NULL, job);
+    *job = (struct spirv_job) {
+        .hash     = hash,
+        .glsl_ver = glsl_ver,
+        .stage    = stage,
+        .shader   = pl_str0dup0(job, shader),
+        .refcount = 1,
+    };
+
+    PL_ARRAY_APPEND(s, s->inflight, job);
+    struct spirv_job **tail = &s->queue;
+    while (*tail)
+        tail = &(*tail)->next;
+    *tail = job;
+
+    start_workers(spirv);
+    pl_cond_signal(&s->wakeup);
+    pl_mutex_unlock(&s->lock);
+    return job;
+}
+
+bool pl_spirv_job_done(pl_spirv spirv, pl_spirv_job job)
+{
+    struct spirv_service *s = spirv->service;
+    pl_mutex_lock(&s->lock);
+    bool done = job->done;
+    pl_mutex_unlock(&s->lock);
+    return done;
+}
+
+pl_str pl_spirv_job_wait(pl_spirv spirv, pl_spirv_job *pjob, void *alloc)
+{
+    struct spirv_service *s = spirv->service;
+    struct spirv_job *job = *pjob;
+    if (!job)
+        return (pl_str) {0};
+
+    pl_mutex_lock(&s->lock);
+    if (!job->running) {
+        // Not picked up by any worker yet, so just run it ourselves
+        dequeue_job(s, job);
+        run_job(spirv, job);
+    }
+
+    while (!job->done)
+        pl_cond_wait(&s->done, &s->lock);
+
+    pl_str res;
+    if (--job->refcount == 0) {
+        pl_mutex_unlock(&s->lock);
+        res = job->result;
+        pl_steal(alloc, res.buf);
+        pl_free(job);
+    } else {
+        res = pl_strdup(alloc, job->result);
+        pl_mutex_unlock(&s->lock);
+    }
+
+    *pjob = NULL;
+    return res;
+}
+
+static void service_init(pl_spirv spirv)
+{
+    struct spirv_service *s = pl_zalloc_ptr(NULL, s);
+    pl_mutex_init(&s->lock);
+    pl_cond_init(&s->wakeup);
+    pl_cond_init(&s->done);
+    ((struct pl_spirv_t *) spirv)->service = s;
+}
+
+static void service_uninit(pl_spirv spirv)
+{
+    struct spirv_service *s = spirv->service;
+    if (!s)
+        return;
+
+    pl_mutex_lock(&s->lock);
+    pl_assert(!s->inflight.num); // all jobs must have been waited on
+    s->quit = true;
+    pl_cond_broadcast(&s->wakeup);
+    pl_mutex_unlock(&s->lock);
+
+    for (int i = 0; i < s->num_workers; i++)
+        pl_thread_join(s->workers[i]);
+
+    pl_cond_destroy(&s->done);
+    pl_cond_destroy(&s->wakeup);
+    pl_mutex_destroy(&s->lock);
+    pl_free(s);
+}
+
 pl_spirv pl_spirv_create(pl_log log, struct pl_spirv_version spirv_ver)
 {
     for (int i = 0; i < PL_ARRAY_SIZE(compilers); i++) {
@@ -37,6 +325,7 @@ pl_spirv pl_spirv_create(pl_log log, struct pl_spirv_version spirv_ver)
             continue;
 
         pl_info(log, "Initialized SPIR-V compiler '%s'", compilers[i]->name);
+        service_init(spirv);
         return spirv;
     }
 
@@ -51,14 +340,23 @@ void pl_spirv_destroy(pl_spirv *pspirv)
     if (!spirv)
         return;
 
+    service_uninit(spirv);
     spirv->impl->destroy(spirv);
     *pspirv = NULL;
 }
 
+uint64_t pl_spirv_cache_key(pl_spirv spirv, const char *shader)
+{
+    uint64_t key = CACHE_KEY_SPIRV;
+    pl_hash_merge(&key, spirv->signature);
+    pl_hash_merge(&key, pl_str0_hash(shader));
+    return key;
+}
+
 pl_str pl_spirv_compile_glsl(pl_spirv spirv, void *alloc,
                              struct pl_glsl_version glsl,
                              enum glsl_shader_stage stage,
                              const char *shader)
 {
-    return spirv->impl->compile(spirv, alloc, glsl, stage, shader);
+    return spirv_compile(spirv, alloc, glsl, stage, shader);
 }
@@ -20,6 +20,13 @@
 #include "log.h"
 #include "utils.h"
 
+// Optional SPIRV-Tools optimization presets
+enum pl_spirv_opt {
+    PL_SPIRV_OPT_NONE = 0,  // use the compiler output as-is
+    PL_SPIRV_OPT_PERF,      // run the spirv-opt performance passes
+    PL_SPIRV_OPT_SIZE,      // run the spirv-opt size passes
+};
+
 typedef const struct pl_spirv_t {
     const struct spirv_compiler *impl;
     pl_log log;
@@ -30,18 +37,71 @@ typedef const struct pl_spirv_t {
     // For cache invalidation, should uniquely identify everything about this
     // spirv compiler and its configuration.
     uint64_t signature;
+
+    // Additional optimization stage, see `pl_spirv_set_opt`
+    enum pl_spirv_opt opt;
+
+    // Asynchronous compilation service, owned by `pl_spirv_create`
+    struct spirv_service *service;
 } *pl_spirv;
 
 // Initialize a SPIR-V compiler instance, or returns NULL on failure.
 pl_spirv pl_spirv_create(pl_log log, struct pl_spirv_version spirv_ver);
 void pl_spirv_destroy(pl_spirv *spirv);
 
+// Enables an additional SPIRV-Tools (spirv-opt) stage, run on the output of
+// every compilation. This is included in `signature`, so it must be set before
+// any compilation takes place. Returns false if libplacebo was built without
+// SPIRV-Tools, in which case the setting is ignored.
+bool pl_spirv_set_opt(pl_spirv spirv, enum pl_spirv_opt opt);
+
+// Returns the `pl_cache` key under which the SPIR-V module for `shader` should
+// be stored. This depends only on the GLSL source and the compiler (see
+// `signature`), never on the GPU driver, so these entries stay valid across
+// driver updates that invalidate downstream caches (e.g. pipeline binaries).
+uint64_t pl_spirv_cache_key(pl_spirv spirv, const char *shader);
+
 // Compile GLSL to SPIR-V. Returns {0} on failure.
 pl_str pl_spirv_compile_glsl(pl_spirv spirv, void *alloc,
                              struct pl_glsl_version glsl_ver,
                              enum glsl_shader_stage stage,
                              const char *shader);
 
+// Asynchronous compilation. Jobs are processed by a pool of worker threads
+// owned by the `pl_spirv`, and identical requests (same GLSL version, stage
+// and source) which are in flight at the same time share a single job.
+//
+// Thread-safety: Safe to call concurrently from multiple threads, provided
+// the underlying compiler implementation is.
+typedef struct spirv_job *pl_spirv_job;
+
+// Sets the number of worker threads used to process jobs. Threads are started
+// lazily on the first submission. With zero threads (the default), jobs are
+// only processed by threads waiting on them. Returns the number of threads
+// actually running, which may be lower than requested.
+int pl_spirv_set_threads(pl_spirv spirv, int num_threads);
+
+// Submits a compilation job and returns a handle to its result. Never fails.
+// The caller must eventually pass the handle to `pl_spirv_job_wait`.
+pl_spirv_job pl_spirv_compile_async(pl_spirv spirv,
+                                    struct pl_glsl_version glsl_ver,
+                                    enum glsl_shader_stage stage,
+                                    const char *shader);
+
+// Returns whether the result of a job is ready, i.e. whether
+// `pl_spirv_job_wait` would return without blocking.
+bool pl_spirv_job_done(pl_spirv spirv, pl_spirv_job job);
+
+// Waits for a job to complete, and returns its result (allocated on `alloc`),
+// or {0} on failure. If the job has not been picked up by a worker yet, it is
+// run on the calling thread instead. Releases `*job` and sets it to NULL.
+pl_str pl_spirv_job_wait(pl_spirv spirv, pl_spirv_job *job, void *alloc);
+
+// Internal helpers, implemented in spirv_opt.c
+uint64_t pl_spirv_opt_signature(enum pl_spirv_opt opt);
+pl_str pl_spirv_optimize(pl_spirv spirv, void *alloc, enum pl_spirv_opt opt,
+                         pl_str code);
+
 struct spirv_compiler {
     const char *name;
     void (*destroy)(pl_spirv spirv);
@@ -0,0 +1,81 @@
+/*
+ * This file is part of libplacebo.
+ *
+ * libplacebo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libplacebo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libplacebo. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <spirv-tools/libspirv.h>
+
+#include "hash.h"
+#include "spirv.h"
+
+static spv_target_env target_env(struct pl_spirv_version ver)
+{
+    if (ver.spv_version >= PL_SPV_VERSION(1, 6))
+        return SPV_ENV_VULKAN_1_3;
+    if (ver.spv_version >= PL_SPV_VERSION(1, 5))
+        return SPV_ENV_VULKAN_1_2;
+    if (ver.spv_version >= PL_SPV_VERSION(1, 4))
+        return SPV_ENV_VULKAN_1_1_SPIRV_1_4;
+    if (ver.spv_version >= PL_SPV_VERSION(1, 1))
+        return SPV_ENV_VULKAN_1_1;
+    return SPV_ENV_VULKAN_1_0;
+}
+
+uint64_t pl_spirv_opt_signature(enum pl_spirv_opt opt)
+{
+    uint64_t sig = opt;
+    pl_hash_merge(&sig, pl_str0_hash(spvSoftwareVersionDetailsString()));
+    return sig;
+}
+
+pl_str pl_spirv_optimize(pl_spirv spirv, void *alloc, enum pl_spirv_opt opt,
+                         pl_str code)
+{
+    pl_str ret = {0};
+    spv_optimizer_t *optimizer = spvOptimizerCreate(target_env(spirv->version));
+    spv_optimizer_options opts = spvOptimizerOptionsCreate();
+    spv_binary binary = NULL;
+    if (!optimizer || !opts)
+        goto done;
+
+    switch (opt) {
+    case PL_SPIRV_OPT_PERF: spvOptimizerRegisterPerformancePasses(optimizer); break;
+    case PL_SPIRV_OPT_SIZE: spvOptimizerRegisterSizePasses(optimizer); break;
+    case PL_SPIRV_OPT_NONE: pl_unreachable();
+    }
+
+    // The input was just produced by a GLSL frontend, no need to re-validate
+    spvOptimizerOptionsSetRunValidator(opts, false);
+
+    pl_clock_t start = pl_clock_now();
+    spv_result_t res = spvOptimizerRun(optimizer, (const uint32_t *) code.buf,
+                                       code.len / sizeof(uint32_t), &binary,
+                                       opts);
+    if (res != SPV_SUCCESS || !binary) {
+        PL_ERR(spirv, "SPIRV-Tools optimization failed (error %d)", (int) res);
+        goto done;
+    }
+
+    ret.len = binary->wordCount * sizeof(uint32_t);
+    ret.buf = pl_memdup(alloc, binary->code, ret.len);
+    pl_log_cpu_time(spirv->log, start, pl_clock_now(), "optimizing SPIR-V");
+    PL_TRACE(spirv, "Optimized SPIR-V from %zu to %zu bytes", code.len, ret.len);
+
+done:
+    spvBinaryDestroy(binary);
+    spvOptimizerOptionsDestroy(opts);
+    spvOptimizerDestroy(optimizer);
+    return ret;
+}
@@ -17,6 +17,7 @@
 
 #include "common.h"
 #include "gpu.h"
+#include "hash.h"
 
 #define require(expr) pl_require(gpu, expr)
 
@@ -27,6 +28,14 @@ void pl_gpu_destroy(pl_gpu gpu)
 
     struct pl_gpu_fns *impl = PL_PRIV(gpu);
     pl_dispatch_destroy(&impl->dp);
+    for (int i = 0; i < impl->staging.num; i++)
+        pl_buf_destroy(gpu, &impl->staging.elem[i]);
+    pl_mutex_destroy(&impl->staging_lock);
+    pl_mutex_destroy(&impl->fmt_lock);
+    for (int i = 0; i < impl->shared.num; i++)
+        pl_tex_destroy(gpu, &impl->shared.elem[i].tex);
+    pl_mutex_destroy(&impl->shared_lock);
+    pl_mutex_destroy(&impl->capture_lock);
     impl->destroy(gpu);
 }
 
@@ -91,8 +100,121 @@ bool pl_fmt_has_modifier(pl_fmt fmt, uint64_t modifier)
     return false;
 }
 
-pl_fmt pl_find_fmt(pl_gpu gpu, enum pl_fmt_type type, int num_components,
-                    int min_depth, int host_bits, enum pl_fmt_caps caps)
+bool pl_gpu_fmt_cache_get(pl_gpu gpu, uint64_t key, pl_fmt *fmt, int map[4])
+{
+    struct pl_gpu_fns *impl = PL_PRIV(gpu);
+    key = PL_DEF(key, 1); // reserve 0 for unused entries
+    bool found = false;
+
+    pl_mutex_lock(&impl->fmt_lock);
+    for (int i = 0; i < PL_FMT_CACHE_SIZE; i++) {
+        const struct pl_fmt_cache_entry *e;
+        e = &impl->fmt_cache[(key + i) & (PL_FMT_CACHE_SIZE - 1)];
+        if (!e->key)
+            break;
+        if (e->key != key)
+            continue;
+
+        *fmt = e->fmt;
+        for (int c = 0; map && c < PL_ARRAY_SIZE(e->map); c++)
+            map[c] = e->map[c];
+        found = true;
+        break;
+    }
+    pl_mutex_unlock(&impl->fmt_lock);
+    return found;
+}
+
+void pl_gpu_fmt_cache_set(pl_gpu gpu, uint64_t key, pl_fmt fmt, const int map[4])
+{
+    struct pl_gpu_fns *impl = PL_PRIV(gpu);
+    key = PL_DEF(key, 1);
+
+    pl_mutex_lock(&impl->fmt_lock);
+    for (int i = 0; i < PL_FMT_CACHE_SIZE; i++) {
+        struct pl_fmt_cache_entry *e;
+        e = &impl->fmt_cache[(key + i) & (PL_FMT_CACHE_SIZE - 1)];
+        if (e->key && e->key != key)
+            continue;
+
+        *e = (struct pl_fmt_cache_entry) { .key = key, .fmt = fmt };
+        for (int c = 0; map && c < PL_ARRAY_SIZE(e->map); c++)
+            e->map[c] = map[c];
+        break;
+    }
+    // If the table is full, the result simply doesn't get memoized
+    pl_mutex_unlock(&impl->fmt_lock);
+}
+
+pl_tex pl_gpu_shared_tex_get(pl_gpu gpu, uint64_t key)
+{
+    struct pl_gpu_fns *impl = PL_PRIV(gpu);
+    pl_tex tex = NULL;
+
+    pl_mutex_lock(&impl->shared_lock);
+    for (int i = 0; i < impl->shared.num; i++) {
+        struct pl_shared_tex *e = &impl->shared.elem[i];
+        if (e->key == key) {
+            e->refs++;
+            tex = e->tex;
+            break;
+        }
+    }
+    pl_mutex_unlock(&impl->shared_lock);
+    return tex;
+}
+
+pl_tex pl_gpu_shared_tex_add(pl_gpu gpu, uint64_t key, pl_tex tex)
+{
+    struct pl_gpu_fns *impl = PL_PRIV(gpu);
+
+    pl_mutex_lock(&impl->shared_lock);
+    for (int i = 0; i < impl->shared.num; i++) {
+        struct pl_shared_tex *e = &impl->shared.elem[i];
+        if (e->key == key) {
+            // Lost the race against another thread registering the same key
+            pl_tex_destroy(gpu, &tex);
+            e->refs++;
+            tex = e->tex;
+            goto done;
+        }
+    }
+
+    PL_ARRAY_APPEND((void *) gpu, impl->shared, (struct pl_shared_tex) {
+        .key  = key,
+        .tex  = tex,
+        .refs = 1,
+    });
+
+done:
+    pl_mutex_unlock(&impl->shared_lock);
+    return tex;
+}
+
+void pl_gpu_shared_tex_release(pl_gpu gpu, pl_tex *tex)
+{
+    if (!*tex)
+        return;
+
+    struct pl_gpu_fns *impl = PL_PRIV(gpu);
+    pl_mutex_lock(&impl->shared_lock);
+    for (int i = 0; i < impl->shared.num; i++) {
+        struct pl_shared_tex *e = &impl->shared.elem[i];
+        if (e->tex != *tex)
+            continue;
+
+        if (--e->refs == 0) {
+            pl_tex_destroy(gpu, &e->tex);
+            PL_ARRAY_REMOVE_AT(impl->shared, i);
+        }
+        break;
+    }
+    pl_mutex_unlock(&impl->shared_lock);
+    *tex = NULL;
+}
+
+static pl_fmt find_fmt(pl_gpu gpu, enum pl_fmt_type type, int num_components,
+                       int min_depth, int host_bits, enum pl_fmt_caps caps)
 {
     for (int n = 0; n < gpu->num_formats; n++) {
         pl_fmt fmt = gpu->formats[n];
@@ -127,6 +249,23 @@ next_fmt: ; // equivalent to `continue`
     return NULL;
 }
 
+pl_fmt pl_find_fmt(pl_gpu gpu, enum pl_fmt_type type, int num_components,
+                    int min_depth, int host_bits, enum pl_fmt_caps caps)
+{
+    const struct {
+        uint32_t type, num_components, min_depth, host_bits, caps;
+    } params = { type, num_components, min_depth, host_bits, caps };
+
+    const uint64_t key = pl_var_hash(params);
+    pl_fmt fmt;
+    if (pl_gpu_fmt_cache_get(gpu, key, &fmt, NULL))
+        return fmt;
+
+    fmt = find_fmt(gpu, type, num_components, min_depth, host_bits, caps);
+    pl_gpu_fmt_cache_set(gpu, key, fmt, NULL);
+    return fmt;
+}
+
 pl_fmt pl_find_vertex_fmt(pl_gpu gpu, enum pl_fmt_type type, int comps)
 {
     static const size_t sizes[] = {
@@ -188,6 +327,7 @@ static inline bool check_mod(pl_gpu gpu, pl_fmt fmt, uint64_t mod)
 
 pl_tex pl_tex_create(pl_gpu gpu, const struct pl_tex_params *params)
 {
+    PL_ALLOC_SCOPE(BACKEND);
     require(params->format);
     require(!params->import_handle || !params->export_handle);
     require(!params->import_handle || !params->initial_data);
@@ -263,9 +403,13 @@ error:
 
 void pl_tex_destroy(pl_gpu gpu, pl_tex *tex)
 {
+    PL_ALLOC_SCOPE(BACKEND);
     if (!*tex)
         return;
 
+    if (pl_gpu_is_capturing(gpu))
+        pl_capture_forget(gpu, *tex);
+
     const struct pl_gpu_fns *impl = PL_PRIV(gpu);
     impl->tex_destroy(gpu, *tex);
     *tex = NULL;
@@ -286,6 +430,7 @@ static bool pl_tex_params_superset(struct pl_tex_params a, struct pl_tex_params
 
 bool pl_tex_recreate(pl_gpu gpu, pl_tex *tex, const struct pl_tex_params *params)
 {
+    PL_ALLOC_SCOPE(BACKEND);
     if (params->initial_data) {
         PL_ERR(gpu, "pl_tex_recreate may not be used with `initial_data`!");
         return false;
@@ -313,6 +458,7 @@ bool pl_tex_recreate(pl_gpu gpu, pl_tex *tex, const struct pl_tex_params *params
 
 void pl_tex_clear_ex(pl_gpu gpu, pl_tex dst, const union pl_clear_color color)
 {
+    PL_ALLOC_SCOPE(BACKEND);
     require(dst->params.blit_dst);
 
     const struct pl_gpu_fns *impl = PL_PRIV(gpu);
@@ -343,6 +489,7 @@ void pl_tex_clear(pl_gpu gpu, pl_tex dst, const float color[4])
 
 void pl_tex_invalidate(pl_gpu gpu, pl_tex tex)
 {
+    PL_ALLOC_SCOPE(BACKEND);
     const struct pl_gpu_fns *impl = PL_PRIV(gpu);
     if (impl->tex_invalidate)
         impl->tex_invalidate(gpu, tex);
@@ -373,6 +520,7 @@ static void infer_rc(pl_tex tex, pl_rect3d *rc)
 
 void pl_tex_blit(pl_gpu gpu, const struct pl_tex_blit_params *params)
 {
+    PL_ALLOC_SCOPE(BACKEND);
     pl_tex src = params->src, dst = params->dst;
     require(src && dst);
     pl_fmt src_fmt = src->params.format;
@@ -498,6 +646,8 @@ error:
 
 bool pl_tex_upload(pl_gpu gpu, const struct pl_tex_transfer_params *params)
 {
+    PL_ALLOC_SCOPE(BACKEND);
+    PL_TRACE_ZONE(gpu->log, TEX_UPLOAD);
     pl_tex tex = params->tex;
     require(tex->params.host_writable);
 
@@ -516,6 +666,7 @@ error:
 
 bool pl_tex_download(pl_gpu gpu, const struct pl_tex_transfer_params *params)
 {
+    PL_ALLOC_SCOPE(BACKEND);
     pl_tex tex = params->tex;
     require(tex->params.host_readable);
 
@@ -540,6 +691,7 @@ bool pl_tex_poll(pl_gpu gpu, pl_tex tex, uint64_t t)
 
 pl_buf pl_buf_create(pl_gpu gpu, const struct pl_buf_params *params)
 {
+    PL_ALLOC_SCOPE(BACKEND);
     struct pl_buf_params params_rounded;
 
     require(!params->import_handle || !params->export_handle);
@@ -614,9 +766,13 @@ error:
 
 void pl_buf_destroy(pl_gpu gpu, pl_buf *buf)
 {
+    PL_ALLOC_SCOPE(BACKEND);
     if (!*buf)
         return;
 
+    if (pl_gpu_is_capturing(gpu))
+        pl_capture_forget(gpu, *buf);
+
     const struct pl_gpu_fns *impl = PL_PRIV(gpu);
     impl->buf_destroy(gpu, *buf);
     *buf = NULL;
@@ -637,6 +793,7 @@ static bool pl_buf_params_superset(struct pl_buf_params a, struct pl_buf_params
 
 bool pl_buf_recreate(pl_gpu gpu, pl_buf *buf, const struct pl_buf_params *params)
 {
+    PL_ALLOC_SCOPE(BACKEND);
 
     if (params->initial_data) {
         PL_ERR(gpu, "pl_buf_recreate may not be used with `initial_data`!");
@@ -656,10 +813,14 @@ bool pl_buf_recreate(pl_gpu gpu, pl_buf *buf, const struct pl_buf_params *params
 void pl_buf_write(pl_gpu gpu, pl_buf buf, size_t buf_offset,
                   const void *data, size_t size)
 {
+    PL_ALLOC_SCOPE(BACKEND);
     require(buf->params.host_writable);
     require(buf_offset + size <= buf->params.size);
     require(buf_offset == PL_ALIGN2(buf_offset, 4));
 
+    if (pl_gpu_is_capturing(gpu))
+        pl_capture_buf_write(gpu, buf, buf_offset, data, size);
+
     const struct pl_gpu_fns *impl = PL_PRIV(gpu);
     impl->buf_write(gpu, buf, buf_offset, data, size);
     return;
@@ -672,6 +833,7 @@ error:
 bool pl_buf_read(pl_gpu gpu, pl_buf buf, size_t buf_offset,
                  void *dest, size_t size)
 {
+    PL_ALLOC_SCOPE(BACKEND);
     require(buf->params.host_readable);
     require(buf_offset + size <= buf->params.size);
 
@@ -687,6 +849,7 @@ error:
 void pl_buf_copy(pl_gpu gpu, pl_buf dst, size_t dst_offset,
                  pl_buf src, size_t src_offset, size_t size)
 {
+    PL_ALLOC_SCOPE(BACKEND);
     require(src_offset + size <= src->params.size);
     require(dst_offset + size <= dst->params.size);
     require(src != dst);
@@ -1018,6 +1181,7 @@ static void log_spec_constants(pl_log log, enum pl_log_level lev,
 
 pl_pass pl_pass_create(pl_gpu gpu, const struct pl_pass_params *params)
 {
+    PL_ALLOC_SCOPE(BACKEND);
     require(params->glsl_shader);
     switch(params->type) {
     case PL_PASS_RASTER:
@@ -1092,9 +1256,13 @@ error:
 
 void pl_pass_destroy(pl_gpu gpu, pl_pass *pass)
 {
+    PL_ALLOC_SCOPE(BACKEND);
     if (!*pass)
         return;
 
+    if (pl_gpu_is_capturing(gpu))
+        pl_capture_forget(gpu, *pass);
+
     const struct pl_gpu_fns *impl = PL_PRIV(gpu);
     impl->pass_destroy(gpu, *pass);
     *pass = NULL;
@@ -1102,6 +1270,7 @@ void pl_pass_destroy(pl_gpu gpu, pl_pass *pass)
 
 void pl_pass_run(pl_gpu gpu, const struct pl_pass_run_params *params)
 {
+    PL_ALLOC_SCOPE(BACKEND);
     pl_pass pass = params->pass;
     struct pl_pass_run_params new = *params;
 
@@ -1244,6 +1413,11 @@ void pl_pass_run(pl_gpu gpu, const struct pl_pass_run_params *params)
         pl_unreachable();
     }
 
+    if (pl_gpu_is_capturing(gpu)) {
+        pl_capture_pass_run(gpu, &new);
+        return;
+    }
+
     const struct pl_gpu_fns *impl = PL_PRIV(gpu);
     impl->pass_run(gpu, &new);
 
@@ -1253,6 +1427,7 @@ error:
 
 void pl_gpu_flush(pl_gpu gpu)
 {
+    PL_ALLOC_SCOPE(BACKEND);
     const struct pl_gpu_fns *impl = PL_PRIV(gpu);
     if (impl->gpu_flush)
         impl->gpu_flush(gpu);
@@ -1260,6 +1435,7 @@ void pl_gpu_flush(pl_gpu gpu)
 
 void pl_gpu_finish(pl_gpu gpu)
 {
+    PL_ALLOC_SCOPE(BACKEND);
     const struct pl_gpu_fns *impl = PL_PRIV(gpu);
     impl->gpu_finish(gpu);
 }
@@ -19,9 +19,11 @@
 
 #include "common.h"
 #include "log.h"
+#include "pl_thread.h"
 
 #include <libplacebo/gpu.h>
 #include <libplacebo/dispatch.h>
+#include <libplacebo/utils/capture.h>
 
 // To avoid having to include drm_fourcc.h
 #ifndef DRM_FORMAT_MOD_LINEAR
@@ -32,6 +34,8 @@
 // This struct must be the first member of the gpu's priv struct. The `pl_gpu`
 // helpers will cast the priv struct to this struct!
 
+#define PL_FMT_CACHE_SIZE 64 // must be a power of two
+
 #define GPU_PFN(name) __typeof__(pl_##name) *name
 struct pl_gpu_fns {
     // This is a pl_dispatch used (on the pl_gpu itself!) for the purposes of
@@ -44,6 +48,31 @@ struct pl_gpu_fns {
     // Internal cache, or NULL. Set by the user (via pl_gpu_set_cache).
     _Atomic(pl_cache) cache;
 
+    // Idle staging buffers, recycled by `pl_tex_upload/download_pbo`.
+    pl_mutex staging_lock;
+    PL_ARRAY(pl_buf) staging;
+
+    // Memoized format lookups, see `pl_gpu_fmt_cache_get/set`.
+    pl_mutex fmt_lock;
+    struct pl_fmt_cache_entry {
+        uint64_t key; // 0 = unused
+        pl_fmt fmt;   // may be NULL (negative result)
+        int8_t map[4];
+    } fmt_cache[PL_FMT_CACHE_SIZE];
+
+    // Immutable textures shared between all users of this GPU, see
+    // `pl_gpu_shared_tex_get/add/release`.
+    pl_mutex shared_lock;
+    PL_ARRAY(struct pl_shared_tex {
+        uint64_t key;
+        pl_tex tex;
+        int refs;
+    }) shared;
+
+    // Attached command capture, or NULL. See `pl_capture_create`.
+    pl_mutex capture_lock;
+    _Atomic(pl_capture) capture;
+
     // Destructors: These also free the corresponding objects, but they
     // must not be called on NULL. (The NULL checks are done by the pl_*_destroy
     // wrappers)
@@ -100,6 +129,37 @@ static inline bool pl_gpu_supports_interop(pl_gpu gpu)
 pl_dispatch pl_gpu_dispatch(pl_gpu gpu);
 pl_cache pl_gpu_cache(pl_gpu gpu);
 
+// Thread-safe memoization of format lookups (e.g. `pl_find_fmt`), keyed by a
+// hash of the lookup parameters. `map` is optional, and stores up to four
+// extra component indices alongside the result. Returns false on cache miss.
+bool pl_gpu_fmt_cache_get(pl_gpu gpu, uint64_t key, pl_fmt *fmt, int map[4]);
+void pl_gpu_fmt_cache_set(pl_gpu gpu, uint64_t key, pl_fmt fmt, const int map[4]);
+
+// Thread-safe registry of immutable textures (e.g. shader LUTs) shared by all
+// users of a `pl_gpu`, keyed by a hash uniquely identifying their contents.
+// `get` returns a new reference to the texture registered under `key`, or
+// NULL. `add` registers a newly created `tex` under `key` and returns it,
+// unless another texture was registered under the same key in the meantime,
+// in which case `tex` is destroyed and a reference to that one is returned.
+// `release` drops a reference, destroying the texture along with the last.
+pl_tex pl_gpu_shared_tex_get(pl_gpu gpu, uint64_t key);
+pl_tex pl_gpu_shared_tex_add(pl_gpu gpu, uint64_t key, pl_tex tex);
+void pl_gpu_shared_tex_release(pl_gpu gpu, pl_tex *tex);
+
+// Hooks called by the `pl_gpu` wrappers while a capture is attached, defined
+// in `utils/capture.c`. `pl_capture_pass_run` records the invocation (unless
+// nested inside another one) before executing it.
+void pl_capture_pass_run(pl_gpu gpu, const struct pl_pass_run_params *params);
+void pl_capture_buf_write(pl_gpu gpu, pl_buf buf, size_t offset,
+                          const void *data, size_t size);
+void pl_capture_forget(pl_gpu gpu, const void *obj);
+
+static inline bool pl_gpu_is_capturing(pl_gpu gpu)
+{
+    const struct pl_gpu_fns *impl = PL_PRIV(gpu);
+    return atomic_load_explicit(&impl->capture, memory_order_relaxed);
+}
+
 // GPU-internal helpers: these should not be used outside of GPU implementations
 
 // This performs several tasks. It sorts the format list, logs GPU metadata,
@@ -268,6 +268,11 @@ pl_gpu pl_gpu_finalize(struct pl_gpu_t *gpu)
     // Finally, create a `pl_dispatch` object for internal operations
     struct pl_gpu_fns *impl = PL_PRIV(gpu);
     atomic_init(&impl->cache, NULL);
+    atomic_init(&impl->capture, NULL);
+    pl_mutex_init(&impl->staging_lock);
+    pl_mutex_init(&impl->fmt_lock);
+    pl_mutex_init(&impl->shared_lock);
+    pl_mutex_init(&impl->capture_lock);
     impl->dp = pl_dispatch_create(gpu->log, gpu);
     return gpu;
 }
@@ -523,6 +528,68 @@ int pl_tex_transfer_slices(pl_gpu gpu, pl_fmt texel_fmt,
     return slices.num;
 }
 
+// Staging buffers are allocated in power-of-two size classes starting from
+// this size, so that they can be reused for similarly sized transfers
+#define STAGING_MIN_SIZE (64 << 10) // 64 KiB
+#define STAGING_MAX_BUFS 16
+
+// Returns a staging buffer to the pool. The buffer may still be in use by the
+// GPU, in which case it will only be handed out again once it becomes idle.
+static void staging_put(pl_gpu gpu, pl_buf *buf)
+{
+    struct pl_gpu_fns *impl = PL_PRIV(gpu);
+    pl_mutex_lock(&impl->staging_lock);
+    if (impl->staging.num < STAGING_MAX_BUFS) {
+        PL_ARRAY_APPEND((void *) gpu, impl->staging, *buf);
+        *buf = NULL;
+    }
+    pl_mutex_unlock(&impl->staging_lock);
+    pl_buf_destroy(gpu, buf);
+}
+
+// Returns an idle staging buffer of at least `size` bytes, creating a new one
+// if none is available.
+static pl_buf staging_get(pl_gpu gpu, size_t size, bool readable)
+{
+    struct pl_gpu_fns *impl = PL_PRIV(gpu);
+    size_t bucket = STAGING_MIN_SIZE;
+    while (bucket < size)
+        bucket <<= 1;
+    if (bucket > gpu->limits.max_buf_size)
+        bucket = size;
+
+    // Buffers are returned in FIFO order, so the first match is also the one
+    // most likely to be idle by now
+    pl_buf buf = NULL;
+    pl_mutex_lock(&impl->staging_lock);
+    for (int i = 0; i < impl->staging.num; i++) {
+        pl_buf cand = impl->staging.elem[i];
+        if (cand->params.size == bucket && cand->params.host_readable == readable) {
+            PL_ARRAY_REMOVE_AT(impl->staging, i);
+            buf = cand;
+            break;
+        }
+    }
+    pl_mutex_unlock(&impl->staging_lock);
+
+    // Polling may run callbacks which return buffers to the pool, so this
+    // must not be done with the lock held
+    if (buf && pl_buf_poll(gpu, buf, 0)) {
+        staging_put(gpu, &buf); // still in use by a previous transfer
+    }
+
+    if (!buf) {
+        buf = pl_buf_create(gpu, pl_buf_params(
+            .size          = bucket,
+            .host_writable = !readable,
+            .host_readable = readable,
+            .debug_tag     = PL_DEBUG_TAG,
+        ));
+    }
+
+    return buf;
+}
+
 bool pl_tex_upload_pbo(pl_gpu gpu, const struct pl_tex_transfer_params *params)
 {
     if (params->buf)
@@ -559,20 +626,24 @@ bool pl_tex_upload_pbo(pl_gpu gpu, const struct pl_tex_transfer_params *params)
         pl_log_level_cap(gpu->log, PL_LOG_NONE);
     }
 
+    bool staged = false;
     if (!fixed.buf) {
-        bufparams.import_handle = 0;
-        bufparams.host_writable = true;
-        fixed.buf = pl_buf_create(gpu, &bufparams);
+        fixed.buf = staging_get(gpu, bufparams.size, false);
         if (!fixed.buf)
             return false;
         pl_buf_write(gpu, fixed.buf, 0, params->ptr, bufparams.size);
         if (params->callback)
             params->callback(params->priv);
         fixed.callback = NULL;
+        staged = true;
     }
 
     bool ok = pl_tex_upload(gpu, &fixed);
-    pl_buf_destroy(gpu, &fixed.buf);
+    if (staged) {
+        staging_put(gpu, &fixed.buf);
+    } else {
+        pl_buf_destroy(gpu, &fixed.buf);
+    }
     return ok;
 }
 
@@ -580,6 +651,7 @@ struct pbo_cb_ctx {
     pl_gpu gpu;
     pl_buf buf;
     void *ptr;
+    size_t size;
     void (*callback)(void *priv);
     void *priv;
 };
@@ -587,8 +659,8 @@ struct pbo_cb_ctx {
 static void pbo_download_cb(void *priv)
 {
     struct pbo_cb_ctx *p = priv;
-    pl_buf_read(p->gpu, p->buf, 0, p->ptr, p->buf->params.size);
-    pl_buf_destroy(p->gpu, &p->buf);
+    pl_buf_read(p->gpu, p->buf, 0, p->ptr, p->size);
+    staging_put(p->gpu, &p->buf);
 
     // Run the original callback
     p->callback(p->priv);
@@ -630,8 +702,7 @@ bool pl_tex_download_pbo(pl_gpu gpu, const struct pl_tex_transfer_params *params
     if (!buf) {
         // Fallback when host pointer import is not supported
         bufparams.import_handle = 0;
-        bufparams.host_readable = true;
-        buf = pl_buf_create(gpu, &bufparams);
+        buf = staging_get(gpu, bufparams.size, true);
     }
 
     if (!buf)
@@ -648,13 +719,18 @@ bool pl_tex_download_pbo(pl_gpu gpu, const struct pl_tex_transfer_params *params
             .gpu = gpu,
             .buf = buf,
             .ptr = params->ptr,
+            .size = bufparams.size,
             .callback = params->callback,
             .priv = params->priv,
         });
     }
 
     if (!pl_tex_download(gpu, &newparams)) {
-        pl_buf_destroy(gpu, &buf);
+        if (bufparams.import_handle) {
+            pl_buf_destroy(gpu, &buf);
+        } else {
+            staging_put(gpu, &buf);
+        }
         return false;
     }
 
@@ -673,7 +749,7 @@ bool pl_tex_download_pbo(pl_gpu gpu, const struct pl_tex_transfer_params *params
     } else if (!params->callback) {
         // Synchronous read back to the host pointer
         ok = pl_buf_read(gpu, buf, 0, params->ptr, bufparams.size);
-        pl_buf_destroy(gpu, &buf);
+        staging_put(gpu, &buf);
     } else {
         // Nothing left to do here, the rest will be done by pbo_download_cb
         ok = true;
@@ -870,9 +946,12 @@ bool pl_tex_blit_compute(pl_gpu gpu, const struct pl_tex_blit_params *params)
     if (needs_sampling && !params->src->params.sampleable)
         return false;
 
+    // Each invocation handles `rows` texels, spaced `bh` rows apart so that
+    // every iteration of the work group still touches a contiguous block
     const int threads = 256;
     int bw = PL_MIN(32, pl_rect_w(dst_rc));
     int bh = PL_MIN(threads / bw, pl_rect_h(dst_rc));
+    int rows = PL_CLAMP(pl_rect_h(dst_rc) / (bh * 4), 1, 4);
     pl_dispatch dp = pl_gpu_dispatch(gpu);
     pl_shader sh = pl_dispatch_begin(dp);
     if (!sh_try_compute(sh, bw, bh, false, 0)) {
@@ -888,10 +967,16 @@ bool pl_tex_blit_compute(pl_gpu gpu, const struct pl_tex_blit_params *params)
              pl_rect_w(dst_rc));
     }
 
-    int groups_y = PL_DIV_UP(pl_rect_h(dst_rc), bh);
-    if (groups_y * bh != pl_rect_h(dst_rc)) {
-        GLSL("if (gl_GlobalInvocationID.y >= %d) \n"
-             "    return;                        \n",
+    int groups_y = PL_DIV_UP(pl_rect_h(dst_rc), bh * rows);
+    GLSL("for (int r = 0; r < %d; r++) {                              \n"
+         "ivec3 pos = ivec3(gl_GlobalInvocationID);                   \n"
+         "pos.y = int(gl_WorkGroupID.y) * %d + r * %d                 \n"
+         "      + int(gl_LocalInvocationID.y);                        \n",
+         rows, bh * rows, bh);
+
+    if (groups_y * bh * rows != pl_rect_h(dst_rc)) {
+        GLSL("if (pos.y >= %d) \n"
+             "    break;       \n",
              pl_rect_h(dst_rc));
     }
 
@@ -920,10 +1005,9 @@ bool pl_tex_blit_compute(pl_gpu gpu, const struct pl_tex_blit_params *params)
 
     int src_dims = pl_tex_params_dimension(params->src->params);
     int dst_dims = pl_tex_params_dimension(params->dst->params);
-    GLSL("ivec3 pos = ivec3(gl_GlobalInvocationID); \n"
-         "%s dst_pos = %s(pos + ivec3(%d, %d, %d)); \n",
+    GLSL("%s dst_pos = %s(pos + ivec3(%d, %d, %d)); \n",
          ivecs[dst_dims], ivecs[dst_dims],
-         params->dst_rc.x0, params->dst_rc.y0, params->dst_rc.z0);
+         dst_rc.x0, dst_rc.y0, dst_rc.z0);
 
     if (needs_sampling || (needs_scaling && params->src->params.sampleable)) {
 
@@ -999,6 +1083,7 @@ bool pl_tex_blit_compute(pl_gpu gpu, const struct pl_tex_blit_params *params)
 
     }
 
+    GLSL("} \n");
     return pl_dispatch_compute(dp, pl_dispatch_compute_params(
         .shader = &sh,
         .dispatch_size = {
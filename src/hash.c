@@ -0,0 +1,48 @@
+/*
+ * This file is part of libplacebo.
+ *
+ * libplacebo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libplacebo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libplacebo. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+
+#ifdef PL_HAVE_XXHASH
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(__AVX2__)
+
+// Compile a separate copy of XXH3 with AVX2 enabled for the whole file. This
+// deliberately does not include hash.h, which has the baseline copy.
+#ifdef __clang__
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC target("avx2")
+#endif
+
+#define XXH_NAMESPACE pl_avx2_
+#define XXH_INLINE_ALL
+#define XXH_NO_STREAM
+#define XXH_VECTOR XXH_AVX2
+#include <xxhash.h>
+
+uint64_t pl_mem_hash_avx2(const void *mem, size_t size);
+uint64_t pl_mem_hash_avx2(const void *mem, size_t size)
+{
+    return XXH3_64bits(mem, size);
+}
+
+#ifdef __clang__
+#pragma clang attribute pop
+#endif
+
+#endif // __x86_64__
+#endif // PL_HAVE_XXHASH
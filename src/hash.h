@@ -45,8 +45,25 @@ static inline uint64_t pl_str0_hash(const char *str)
 #define XXH_NO_STREAM
 #include <xxhash.h>
 
+// XXH3 is compiled for the baseline instruction set, so dispatch long inputs
+// to an AVX2 build of the same hash at runtime where available. All XXH3
+// kernels produce identical output, so hashes remain portable.
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(__AVX2__)
+#define PL_HASH_DISPATCH
+
+// Inputs below this size are (mostly) hashed by scalar code regardless of the
+// vector extension, so don't bother dispatching them
+#define PL_HASH_DISPATCH_MIN 1024
+
+uint64_t pl_mem_hash_avx2(const void *mem, size_t size);
+#endif
+
 XXH_FORCE_INLINE uint64_t pl_mem_hash(const void *mem, size_t size)
 {
+#ifdef PL_HASH_DISPATCH
+    if (size >= PL_HASH_DISPATCH_MIN && __builtin_cpu_supports("avx2"))
+        return pl_mem_hash_avx2(mem, size);
+#endif
     return XXH3_64bits(mem, size);
 }
 
@@ -42,6 +42,10 @@ typedef struct pl_cache_obj {
     // Will be called when the object is either explicitly deleted, culled
     // due to hitting size limits, or on pl_cache_destroy().
     void (*free)(void *data);
+
+    // Estimated cost (in seconds) of regenerating this object. (Optional)
+    // Only used with `pl_cache_params.cost_aware`.
+    float cost;
 } pl_cache_obj;
 
 struct pl_cache_params {
@@ -56,6 +60,30 @@ struct pl_cache_params {
     size_t max_object_size;
     size_t max_total_size;
 
+    // If greater than 1, the cache is internally split into this many
+    // independently locked shards (up to 64), with objects assigned to
+    // shards based on their key. This reduces lock contention when many
+    // threads share the same cache. Each shard receives an equal share of
+    // `max_total_size`, which also limits the effective `max_object_size`.
+    // LRU eviction happens independently per shard.
+    int shards;
+
+    // If true, objects are evicted based on `pl_cache_obj.cost` relative to
+    // their size (GreedyDual-Size), rather than least-recently-used order.
+    // This favors keeping objects that are expensive to regenerate (e.g.
+    // compiled pipelines) over cheap ones, while still aging out stale
+    // objects. Objects without an explicit cost are assumed to be cheap.
+    bool cost_aware;
+
+    // If true, `pl_cache_save` compresses objects where doing so is
+    // beneficial. This is especially effective for large LUTs. Compressed
+    // caches require libplacebo API version 342 or newer to load. Loading
+    // always supports both compressed and uncompressed caches.
+    //
+    // Note: Objects loaded from compressed caches are no longer zero-copy
+    // when using `pl_cache_load_mmap`.
+    bool compress;
+
     // Optional external callback to call after a cached object is modified
     // (including deletion and (re-)insertion). Note that this is not called on
     // objects which are merely pruned from the cache due to `max_total_size`,
@@ -67,6 +95,18 @@ struct pl_cache_params {
     // Note: This function must be thread safe.
     void (*set)(void *priv, pl_cache_obj obj);
 
+    // If true, calls to `set` are deferred to a dedicated background thread,
+    // so that slow callbacks (e.g. writing to disk) never block the calling
+    // thread. Events are batched for up to `async_interval` seconds (default
+    // 1.0), and multiple updates to the same key within a batch are coalesced
+    // into a single call reflecting the most recent state. Objects are copied
+    // for this purpose, so `set` observes a stable snapshot of the data.
+    //
+    // Note: Pending events are always flushed by `pl_cache_destroy`, and can
+    // also be explicitly flushed using `pl_cache_flush`.
+    bool async_set;
+    float async_interval;
+
     // Optional external callback to call on a cache miss. Ownership of the
     // returned object passes to the `pl_cache`. Objects returned by this
     // callback *should* have a valid `free` callback, unless lifetime can be
@@ -102,6 +142,30 @@ PL_API void pl_cache_destroy(pl_cache *cache);
 // Note: Objects destroyed in this way *not* propagated to the `set` callback.
 PL_API void pl_cache_reset(pl_cache cache);
 
+// Cumulative cache usage statistics, e.g. to help tune `max_total_size`.
+struct pl_cache_stats {
+    uint64_t hits;          // lookups satisfied by objects in the cache
+    uint64_t misses;        // lookups not satisfied by objects in the cache
+    uint64_t external_hits; // misses satisfied by `pl_cache_params.get`
+    uint64_t insertions;    // objects successfully inserted
+    uint64_t evictions;     // objects pruned due to `max_total_size`
+    uint64_t bytes_evicted; // total size of all pruned objects
+    double lock_wait;       // total time (in seconds) spent waiting on locks
+};
+
+// Retrieve the statistics accumulated since creation (or the last reset).
+//
+// Note: Caches are shared between many different types of objects (shaders,
+// LUTs, pipeline binaries, ...), but since keys are opaque hashes, these
+// statistics are only available for the cache as a whole. Use separate
+// `pl_cache` instances to track different object types independently.
+PL_API void pl_cache_get_stats(pl_cache cache, struct pl_cache_stats *out);
+PL_API void pl_cache_reset_stats(pl_cache cache);
+
+// Block until all pending `set` events are processed. Only meaningful when
+// using `pl_cache_params.async_set`, otherwise this is a no-op.
+PL_API void pl_cache_flush(pl_cache cache);
+
 // Return the current internal number of objects and total size (bytes)
 PL_API int pl_cache_objects(pl_cache cache);
 PL_API size_t pl_cache_size(pl_cache cache);
@@ -139,6 +203,32 @@ PL_API size_t pl_cache_save(pl_cache cache, uint8_t *data, size_t size);
 // not avoid a copy.
 PL_API int pl_cache_load(pl_cache cache, const uint8_t *data, size_t size);
 
+// Memory-maps the cache file at `path` read-only and loads its contents
+// without copying them into memory. Objects loaded this way point directly
+// into the mapping, which remains valid until the `pl_cache` is destroyed.
+// Returns the number of objects loaded, or a negative number on error (e.g.
+// file not found or corrupt header).
+//
+// Note: Objects retrieved from a `pl_cache` loaded this way are read-only,
+// and must not outlive the `pl_cache` itself.
+//
+// Note: Modifying or truncating the file while it is mapped is undefined
+// behavior. To update a cache file, write it to a new file and atomically
+// rename it over the old one instead.
+PL_API int pl_cache_load_mmap(pl_cache cache, const char *path);
+
+// Variant of `pl_cache_load_mmap` which only builds an index of the objects
+// contained in the file, without touching or verifying their contents.
+// Indexed objects are fetched (and verified) the first time they are
+// requested via `pl_cache_get`, taking priority over `pl_cache_params.get`.
+// Returns the number of objects indexed, or a negative number on error.
+//
+// Note: Objects which have not yet been fetched do not count towards
+// `pl_cache_objects`, `pl_cache_size` or `max_total_size`, but they are still
+// included in `pl_cache_save` and `pl_cache_iterate`. Objects already present
+// in the cache take precedence over indexed objects with the same key.
+PL_API int pl_cache_load_lazy(pl_cache cache, const char *path);
+
 // Writes/loads data to/from a FILE stream at the current position.
 #define pl_cache_save_file(c, file) pl_cache_save_ex(c, pl_write_file_cb, file)
 #define pl_cache_load_file(c, file) pl_cache_load_ex(c, pl_read_file_cb,  file)
@@ -153,6 +243,41 @@ static inline bool pl_read_file_cb(void *priv, size_t size, void *ptr)
     return fread(ptr, 1, size, (FILE *) priv) == size;
 }
 
+// --- Journaled persistence
+
+// Attaches an append-only journal file at `path` to `cache`, creating it if
+// it does not exist. Any objects recorded in an existing journal are first
+// replayed into the cache. Afterwards, every insertion, deletion and eviction
+// of an object is appended to the journal as it happens, so the cost of
+// persisting the cache is proportional to the number of changes, and objects
+// survive application crashes without an explicit `pl_cache_save`.
+//
+// Superseded records are periodically discarded by rewriting the journal on
+// a background thread, and atomically renaming it over the old file, once
+// they make up the majority of its size. A journal left behind by a crash is
+// recovered up to the last complete record. Returns the number of objects
+// replayed, or a negative number on error (e.g. the file exists but is not a
+// valid journal), in which case no journal is attached.
+//
+// Note: Objects loaded using `pl_cache_load` and friends are not recorded,
+// unless they are subsequently re-inserted. Objects are only replayed from
+// the journal itself, so a journal should generally be attached to an empty
+// cache, and then used instead of, rather than alongside, `pl_cache_save`.
+//
+// Note: Only one journal may be attached to a cache at a time, and this
+// function (as well as `pl_cache_journal_close`) must not be called
+// concurrently with any other function on the same `pl_cache`.
+PL_API int pl_cache_journal_open(pl_cache cache, const char *path);
+
+// Detaches and closes the journal, if any. Pending records are flushed, but
+// no compaction is performed. Implicitly called by `pl_cache_destroy`.
+PL_API void pl_cache_journal_close(pl_cache cache);
+
+// Blocks until all records appended so far have been committed to stable
+// storage, so they survive system crashes as well. If `compact` is true, the
+// journal is also compacted (synchronously). Returns whether successful.
+PL_API bool pl_cache_journal_sync(pl_cache cache, bool compact);
+
 // --- Object modification API. Mostly intended for internal use.
 
 // Insert a new cached object into a `pl_cache`. Returns whether successful.
@@ -34,6 +34,12 @@ typedef const struct pl_d3d11_t {
     // purposes, including taking a reference to the device (with AddRef) and
     // using it beyond the lifetime of the pl_d3d11 that created it (though if
     // this is done with debug enabled, it will confuse the leak checker.)
+    //
+    // Note: libplacebo serializes its own use of the immediate context
+    // internally, so the resulting `pl_gpu` is `thread_safe` unless the
+    // device was created with D3D11_CREATE_DEVICE_SINGLETHREADED. Users who
+    // access the immediate context themselves, concurrently with libplacebo,
+    // are responsible for their own synchronization (e.g. ID3D11Multithread).
     ID3D11Device *device;
 
     // True if the device is using a software (WARP) adapter
@@ -188,6 +194,18 @@ struct pl_d3d11_swapchain_params {
     // may fail if an unsupported combination is requested.
     UINT flags;
 
+    // If set, libplacebo will create the swapchain with the
+    // DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT flag, restrict the
+    // number of queued frames to one, and make `pl_swapchain_start_frame`
+    // block until the swapchain is ready to accept the next frame. This
+    // reduces input-to-photon latency for interactive use, at the cost of
+    // less buffering against hitches. Requires the flip presentation model and
+    // DXGI 1.3 (Windows 8.1), and is ignored otherwise.
+    //
+    // Note: When wrapping an existing swapchain, this behavior is enabled
+    // automatically if the swapchain was created with the above flag.
+    bool low_latency;
+
     // --- Swapchain usage behavior options
 
     // Disable using a 10-bit swapchain format for SDR output
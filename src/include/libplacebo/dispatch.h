@@ -33,6 +33,24 @@ typedef struct pl_dispatch_t *pl_dispatch;
 PL_API pl_dispatch pl_dispatch_create(pl_log log, pl_gpu gpu);
 PL_API void pl_dispatch_destroy(pl_dispatch *dp);
 
+// A pool of compiled passes, which can be shared by multiple `pl_dispatch`
+// objects. This allows e.g. using a separate dispatch object per thread,
+// while still compiling every pass only once.
+//
+// Thread-safety: Safe
+typedef struct pl_dispatch_pool_t *pl_dispatch_pool;
+
+// Creates a new, empty pass pool. The pool must outlive all dispatch objects
+// attached to it.
+PL_API pl_dispatch_pool pl_dispatch_pool_create(pl_log log, pl_gpu gpu);
+PL_API void pl_dispatch_pool_destroy(pl_dispatch_pool *pool);
+
+// Like `pl_dispatch_create`, but compiled passes are looked up in (and added
+// to) the given pool. Each dispatch object still keeps its own shaders,
+// uniform buffers and other per-pass state, so different dispatch objects
+// attached to the same pool can be used concurrently without contention.
+PL_API pl_dispatch pl_dispatch_create_shared(pl_dispatch_pool pool);
+
 // Reset/increments the internal counters of the pl_dispatch. This must be
 // called whenever the user is going to begin with a new frame, in order to
 // perform garbage collection and advance the state of the internal PRNG.
@@ -103,6 +121,15 @@ struct pl_dispatch_params {
     // entire texture will be rendered to.
     pl_rect2d rect;
 
+    // If set, only the part of `rect` inside these scissors (in texture
+    // coordinates) is actually written to, while leaving the rest of the
+    // target untouched. The shader is still evaluated relative to `rect`.
+    // Optional, if left as {0}, no scissors are applied.
+    //
+    // Note: This is purely an optimization, and is ignored for compute
+    // shaders, which always write to all of `rect`.
+    pl_rect2d scissors;
+
     // If set, enables and controls the blending for this pass. Optional. When
     // using this with fragment shaders, `target->params.fmt->caps` must
     // include `PL_FMT_CAP_BLENDABLE`.
@@ -229,6 +256,61 @@ PL_API bool pl_dispatch_vertex(pl_dispatch dp, const struct pl_dispatch_vertex_p
 // if the shader was instead merged into a different shader.
 PL_API void pl_dispatch_abort(pl_dispatch dp, pl_shader *sh);
 
+// Enables precompilation mode. While active, all shaders submitted via
+// `pl_dispatch_finish`, `pl_dispatch_compute` and `pl_dispatch_vertex` are
+// generated and compiled, but not actually executed. (These calls return true
+// without touching the target, as long as the shader itself was valid)
+//
+// Compilation is spread across up to `num_threads` worker threads. If this is
+// 0, or the GPU is not `thread_safe`, passes are compiled synchronously.
+// Compiled passes are retained by the dispatch object as well as written to
+// the `pl_cache` associated with the GPU, so future dispatches of the same
+// shaders do not need to wait for compilation.
+//
+// Note: This affects all threads using this `pl_dispatch` concurrently.
+PL_API void pl_dispatch_precompile_begin(pl_dispatch dp, int num_threads);
+
+// Ends precompilation mode, blocking until all outstanding compilation jobs
+// have finished. Returns false if any pass failed compiling.
+PL_API bool pl_dispatch_precompile_end(pl_dispatch dp);
+
+// Limits how often passes are timed: each pass is only timed on one out of
+// every `interval` frames (as delimited by `pl_dispatch_reset_frame`), with
+// the sampled frames staggered across passes. The timings reported by
+// `pl_dispatch_info` are then correspondingly less fresh, but the overhead of
+// timer queries is reduced by the same factor. A value of 0 or 1 (the
+// default) times every pass invocation.
+PL_API void pl_dispatch_set_timer_interval(pl_dispatch dp, int interval);
+
+// Enables or disables asynchronous pass compilation. While enabled, shaders
+// which require compiling a new pass are not executed; instead, the pass is
+// compiled on a background thread, and the dispatch call returns true
+// without touching the target. Once the pass is ready, it will be used by
+// subsequent dispatches of the same shader. Passes which are still compiling
+// when async compilation gets disabled are waited on when next dispatched.
+//
+// This has no effect unless the GPU is `thread_safe`.
+PL_API void pl_dispatch_set_async(pl_dispatch dp, bool async);
+
+// Returns the total number of dispatches which were skipped so far because of
+// asynchronous compilation. Callers can compare this before and after
+// rendering a frame to determine whether the result is complete.
+PL_API uint64_t pl_dispatch_num_deferred(pl_dispatch dp);
+
+// Begins a batch of dispatches, e.g. when rendering the same source to
+// several targets at once. Passes are still executed in order, but until the
+// matching `pl_dispatch_batch_end`, the dispatch object avoids re-writing any
+// uniform buffer used earlier in the same batch, so that consecutive
+// dispatches (including repeated dispatches of the same shader) can be
+// recorded back-to-back without stalling on each other. Batches do not nest.
+//
+// Note: This affects all threads using this `pl_dispatch` concurrently.
+PL_API void pl_dispatch_batch_begin(pl_dispatch dp);
+
+// Ends the current batch and flushes the recorded work to the GPU, as if by
+// `pl_gpu_flush`.
+PL_API void pl_dispatch_batch_end(pl_dispatch dp);
+
 // Deprecated in favor of `pl_cache_save/pl_cache_load` on the `pl_cache`
 // associated with the `pl_gpu` this dispatch is using.
 PL_DEPRECATED PL_API size_t pl_dispatch_save(pl_dispatch dp, uint8_t *out_cache);
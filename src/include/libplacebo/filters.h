@@ -24,6 +24,7 @@
 PL_API_BEGIN
 
 #define PL_FILTER_MAX_PARAMS 2
+#define PL_FILTER_MAX_TERMS  4
 
 // Invocation parameters for a given kernel
 struct pl_filter_ctx {
@@ -154,6 +155,15 @@ PL_API extern const struct pl_filter_function pl_filter_function_spline64;
 // nearest neighbour sampling. (See `pl_shader_sample_oversample`)
 PL_API extern const struct pl_filter_function pl_filter_function_oversample;
 
+// Special filter function for motion-compensated frame interpolation. Only
+// meaningful for frame mixing. The weights are identical to `triangle`, but
+// `pl_render_image_mix` additionally estimates the motion between the two
+// frames surrounding the vsync and blends them along the motion vectors,
+// rather than blending them in place. Has two tunable parameters: the block
+// size (in output pixels) used for motion estimation, and the search radius
+// (in blocks), defaulting to 16 and 4 respectively.
+PL_API extern const struct pl_filter_function pl_filter_function_motion;
+
 // A list of built-in filter functions, terminated by NULL
 //
 // Note: May contain extra aliases for the above functions.
@@ -242,6 +252,14 @@ struct pl_filter_config {
     // but provides information about how the results are to be interpreted.
     bool polar;
 
+    // For polar filters only: If nonzero, the 2D filter is approximated by a
+    // sum of this many separable terms (the strongest terms of its
+    // eigendecomposition), each of which can be applied as a pair of 1D
+    // convolutions. This reduces the sampling cost from O(radius²) to
+    // O(radius) per term, at the cost of some accuracy, mostly along the
+    // diagonals. Must not exceed PL_FILTER_MAX_TERMS.
+    int separable_terms;
+
     // Antiringing strength. A value of 0.0 disables antiringing, and a value
     // of 1.0 enables full-strength antiringing. Defaults to 0.0 if
     // unspecified.
@@ -291,6 +309,7 @@ PL_API extern const struct pl_filter_config pl_filter_ewa_robidoux;
 PL_API extern const struct pl_filter_config pl_filter_ewa_robidouxsharp;
 // Special/opaque filters
 PL_API extern const struct pl_filter_config pl_filter_oversample;
+PL_API extern const struct pl_filter_config pl_filter_motion;
 
 // Backwards compatibility
 #define pl_filter_triangle          pl_filter_bilinear
@@ -399,6 +418,18 @@ typedef const struct pl_filter_t {
     // a multiple of params.row_stride_align.
     int row_stride;
 
+    // --- polar filters with `params.config.separable_terms` only
+
+    // The separable terms approximating the 2D filter, each laid out like
+    // the `weights` of a separable filter (using `row_size` and `row_stride`
+    // as above). The weight of source texel (x, y) is given by the sum of
+    // `term_signs[k] * terms[k][x] * terms[k][y]` over all terms. Unlike the
+    // weights of separable filters, rows are not normalized; instead, the
+    // entry at index `row_size` of each row contains the sum of that row.
+    int num_terms;
+    const float *terms[PL_FILTER_MAX_TERMS];
+    float term_signs[PL_FILTER_MAX_TERMS];
+
     // --- deprecated / removed fields
     float radius_cutoff PL_DEPRECATED; // identical to `radius`
 } *pl_filter;
@@ -407,6 +438,11 @@ typedef const struct pl_filter_t {
 // The resulting pl_filter must be freed with `pl_filter_free` when no longer
 // needed. Returns NULL if filter generation fails due to invalid parameters
 // (i.e. missing a required parameter).
+//
+// Note: Filters are immutable and shared internally, so generating a filter
+// with parameters identical to those of a still-live filter returns a new
+// reference to the existing object rather than recomputing it. This is
+// thread-safe. Each returned reference must still be freed individually.
 PL_API pl_filter pl_filter_generate(pl_log log, const struct pl_filter_params *params);
 PL_API void pl_filter_free(pl_filter *filter);
 
@@ -128,6 +128,16 @@ PL_API void pl_gamut_map_generate(float *out, const struct pl_gamut_map_params *
 // values are updated in-place.
 PL_API void pl_gamut_map_sample(float x[3], const struct pl_gamut_map_params *params);
 
+// Estimates the smallest LUT size (per channel, not exceeding the sizes
+// currently set in `params`) for which linear interpolation of the LUT
+// reproduces the gamut mapping to within `max_error` (in IPTPQc4 units) for
+// all colors inside `input_gamut`, based on a coarse probe of the mapping
+// function. Updates `params->lut_size_*` in-place. Returns false if the
+// mapping is indistinguishable from the identity within `max_error`, in which
+// case no LUT is needed at all.
+PL_API bool pl_gamut_map_fit_lut_size(struct pl_gamut_map_params *params,
+                                      float max_error);
+
 // Performs no gamut-mapping, just hard clips out-of-range colors per-channel.
 PL_API extern const struct pl_gamut_map_function pl_gamut_map_clip;
 
@@ -48,6 +48,32 @@ struct pl_log_params {
     // in increased CPU usage as it may enable extra debug paths based on the
     // configured log level.
     enum pl_log_level log_level;
+
+    // If nonzero, log messages are formatted directly by the calling thread
+    // into a lock-free ring buffer of (approximately) this many bytes, and
+    // delivered to `log_cb` asynchronously from a dedicated thread. This
+    // avoids serializing all logging threads on the callback, at the cost of
+    // a small delivery delay. Messages which don't fit into the ring buffer
+    // are dropped, see `pl_log_dropped`.
+    //
+    // Note: `log_cb` is still never called concurrently. Any messages still
+    // pending are delivered before `pl_log_update` or `pl_log_destroy`
+    // return. This field can only be set by `pl_log_create`, changing it
+    // via `pl_log_update` has no effect.
+    size_t async_buffer;
+
+    // If nonzero, enables always-on structured tracing of internal events
+    // (cache updates, shader dispatches, GPU memory allocations, ...) into a
+    // ring buffer holding the most recent `trace_events` events. Recording an
+    // event only stores its ID, timestamp and integer arguments; formatting
+    // is deferred until the events are exported with `pl_log_trace_save`.
+    // Independent of `log_level`. Like `async_buffer`, this can only be set
+    // by `pl_log_create`.
+    //
+    // CPU zones around the main rendering stages are recorded as well, and
+    // GPU pass timings (where supported) appear on a separate "GPU" track.
+    // Ignored if libplacebo was built with `-Dtrace=false`.
+    size_t trace_events;
 };
 
 #define pl_log_params(...) (&(struct pl_log_params) { __VA_ARGS__ })
@@ -94,6 +120,20 @@ PL_API struct pl_log_params pl_log_update(pl_log log, const struct pl_log_params
 // Returns the previous log level, atomically.
 PL_API enum pl_log_level pl_log_level_update(pl_log log, enum pl_log_level level);
 
+// Returns the total number of messages dropped because the asynchronous ring
+// buffer was full. Always 0 unless `pl_log_params.async_buffer` is set.
+PL_API uint64_t pl_log_dropped(pl_log log);
+
+// Exports all trace events recorded since the last call, in the Chrome
+// trace event (JSON) format, which can be loaded by e.g. `chrome://tracing` or
+// the Perfetto UI. Each call writes a complete JSON document. Events which were
+// overwritten (or still being written) at the time of the call are skipped.
+// Returns the number of events written. `pl_write_file_cb` from
+// <libplacebo/cache.h> can be used to write directly to a FILE stream.
+PL_API int pl_log_trace_save(pl_log log,
+                             void (*write)(void *priv, size_t size, const void *ptr),
+                             void *priv);
+
 // Two simple, stream-based loggers. You can use these as the log_cb. If you
 // also set log_priv to a FILE* (e.g. stdout or stderr) it will be printed
 // there; otherwise, it will be printed to stdout or stderr depending on the
@@ -45,6 +45,7 @@ typedef struct pl_options_t {
     struct pl_blend_params blend_params;
     struct pl_deinterlace_params deinterlace_params;
     struct pl_distort_params distort_params;
+    struct pl_adaptive_params adaptive_params;
 
     // Backing storage for "custom" scalers. `params.upscaler` etc. will
     // always be a pointer either to a built-in pl_filter_config, or one of
@@ -75,6 +76,52 @@ PL_API void pl_options_free(pl_options *opts);
 // `preset`, such as any custom upscalers.
 PL_API void pl_options_reset(pl_options opts, const struct pl_render_params *preset);
 
+// Immutable, reference-counted copy of a `pl_options`, with all internal
+// pointers (`params.*_params`, scalers, hooks array) redirected into the
+// copy itself. `&snap->params` can thus be passed directly to the renderer,
+// and remains valid, even while the original `pl_options` is modified or
+// freed, for as long as a reference to the snapshot is held.
+//
+// Note: Objects referenced but not owned by `pl_options` (e.g. hooks, the
+// `lut` or `info_priv`) are shared, not copied.
+//
+// Thread-safety: Safe
+typedef const struct pl_options_t *pl_opt_snapshot;
+
+// Take a snapshot of the current state of `opts`. The result starts out with
+// a single reference, which must be released with `pl_opt_snapshot_unref`.
+PL_API pl_opt_snapshot pl_options_snapshot(pl_options opts);
+PL_API pl_opt_snapshot pl_opt_snapshot_ref(pl_opt_snapshot snap);
+PL_API void pl_opt_snapshot_unref(pl_opt_snapshot *snap);
+
+// Helper for distributing configuration changes to any number of rendering
+// threads. A writer publishes new snapshots (after modifying its own
+// private `pl_options`), and each reader keeps its own reference to the most
+// recently seen snapshot, which it can cheaply refresh at the start of every
+// frame.
+//
+// Thread-safety: Safe
+typedef struct pl_opt_source_t *pl_opt_source;
+
+// Create a source initially publishing `initial`, which must not be NULL.
+// The source holds its own reference to all published snapshots.
+PL_API pl_opt_source pl_opt_source_create(pl_opt_snapshot initial);
+PL_API void pl_opt_source_destroy(pl_opt_source *src);
+
+// Replace the currently published snapshot. Readers holding a reference to
+// the previous snapshot may continue using it until they next update.
+PL_API void pl_opt_source_publish(pl_opt_source src, pl_opt_snapshot snap);
+
+// Update `*snap` (which must hold a reference obtained from this source, or
+// NULL) to the currently published snapshot, releasing the old reference.
+// Returns whether `*snap` was changed.
+//
+// If nothing was published since the last update, this is a single atomic
+// load. Otherwise, this briefly takes a lock which is never held for longer
+// than a pointer swap, so it can not be blocked by the writer doing any
+// actual work (parsing, copying, freeing, etc.).
+PL_API bool pl_opt_source_update(pl_opt_source src, pl_opt_snapshot *snap);
+
 typedef const struct pl_opt_data_t {
     // Original options struct.
     pl_options opts;
@@ -121,6 +168,22 @@ PL_API const char *pl_options_save(pl_options opts);
 // Returns true if no errors occurred.
 PL_API bool pl_options_load(pl_options opts, const char *str);
 
+// Pre-parsed set of option updates, which can be applied to any number of
+// `pl_options` objects much more cheaply than re-parsing the equivalent
+// string with `pl_options_load`. Patches are immutable once compiled.
+//
+// Thread-safety: Safe
+typedef const struct pl_opt_patch_t *pl_opt_patch;
+
+// Compile a key/value string, in the same syntax as `pl_options_load`, into
+// a patch. Returns NULL if any errors occurred.
+PL_API pl_opt_patch pl_opt_patch_compile(pl_log log, const char *str);
+PL_API void pl_opt_patch_free(pl_opt_patch *patch);
+
+// Apply a patch to `opts`, with the same effect as `pl_options_load` on the
+// string the patch was compiled from. This cannot fail.
+PL_API void pl_options_apply_patch(pl_options opts, pl_opt_patch patch);
+
 // Helpers for interfacing with `opts->params.hooks`. Note that using any of
 // these helpers will overwrite the array by an internally managed pointer,
 // so care must be taken when combining them with external management of
@@ -52,6 +52,7 @@ enum pl_render_error {
     PL_RENDER_ERR_ERROR_DIFFUSION   = 1 << 9,
     PL_RENDER_ERR_HOOKS             = 1 << 10,
     PL_RENDER_ERR_CONTRAST_RECOVERY = 1 << 11,
+    PL_RENDER_ERR_MOTION            = 1 << 12,
 };
 
 // Struct describing current renderer state, including internal processing errors,
@@ -79,6 +80,48 @@ PL_API struct pl_render_errors pl_renderer_get_errors(pl_renderer rr);
 PL_API void pl_renderer_reset_errors(pl_renderer rr,
                                      const struct pl_render_errors *errors);
 
+// Aggregated statistics about the most recent `pl_render_image` or
+// `pl_render_image_mix` call, e.g. for adaptively adjusting the rendering
+// parameters to fit within a frame time budget.
+struct pl_render_stats {
+    // GPU time (in nanoseconds) spent on the shaders dispatched by each stage
+    // of the rendering pipeline, as well as the total over all stages. These
+    // are based on `pl_dispatch_info.last`, i.e. the most recent available
+    // measurement of each pass, which typically lags a few frames behind.
+    // All times are zero if the GPU does not support timer queries.
+    //
+    // Note: Since libplacebo merges as many operations as possible into
+    // a single shader, work is counted towards the stage that dispatched the
+    // shader it ended up in. For example, color mapping and ordered dithering
+    // are usually merged into the output pass, and only counted separately
+    // when they require passes of their own (e.g. error diffusion, or color
+    // conversion of frames cached by `pl_render_image_mix`).
+    uint64_t time_read;     // reading, merging and debanding source planes
+    uint64_t time_scale;    // main scaler (including linearization/sigmoid)
+    uint64_t time_color;    // color conversion / tone mapping
+    uint64_t time_dither;   // error diffusion
+    uint64_t time_overlay;  // drawing overlays
+    uint64_t time_output;   // final output, including plane scaling and blending
+    uint64_t time_total;
+
+    int num_passes;         // number of shaders dispatched
+    int num_compiled;       // number of new shaders compiled for this frame
+    int num_fbos;           // number of intermediate textures held by the renderer
+    size_t fbo_memory;      // estimated VRAM used by those textures, in bytes
+
+    // Current quality reduction step of the adaptive quality controller (see
+    // `pl_adaptive_params`), or 0 if running at full quality.
+    int adaptive_level;
+
+    // Region of the target that was actually redrawn, in pixels. This covers
+    // the whole target unless `pl_render_params.damage_tracking` was used,
+    // and is suitable for passing on to `pl_swapchain_damage`.
+    pl_rect2d damage;
+};
+
+// Returns the statistics for the most recently rendered frame.
+PL_API struct pl_render_stats pl_renderer_get_stats(pl_renderer rr);
+
 enum pl_lut_type {
     PL_LUT_UNKNOWN = 0,
     PL_LUT_NATIVE,      // applied to raw image contents (after fixing bit depth)
@@ -116,6 +159,43 @@ struct pl_render_info {
     int count;
 };
 
+// Closed-loop controller for automatically reducing rendering quality to
+// hold a GPU frame time budget. Based on the total GPU time measured for each
+// frame (see `pl_render_stats.time_total`), the renderer steps down through
+// progressively cheaper configurations whenever the budget is exceeded, and
+// back up again once there is sufficient headroom. In order, these steps:
+//
+// 1. disable error diffusion and limit debanding to a single iteration
+// 2. disable peak detection and sigmoidization
+// 3. disable debanding and replace all scalers by built-in sampling
+//
+// Has no effect if the GPU does not support timer queries.
+struct pl_adaptive_params {
+    // Target GPU time per frame, in milliseconds. Should typically be set
+    // somewhat below the display's frame interval. Disabled if 0.
+    float target_ms;
+
+    // Fraction of `target_ms` that the frame time must drop below before
+    // quality is increased again. Defaults to 0.7.
+    float headroom;
+
+    // Number of consecutive frames exceeding the budget before stepping down
+    // (default: 3), or staying below the headroom before stepping back up
+    // (default: 120). Since GPU timings are reported with a delay of a few
+    // frames, `frames_down` should not be set too low.
+    int frames_down;
+    int frames_up;
+};
+
+#define PL_ADAPTIVE_DEFAULTS    \
+    .target_ms   = 14.0,        \
+    .headroom    = 0.7,         \
+    .frames_down = 3,           \
+    .frames_up   = 120,
+
+#define pl_adaptive_params(...) (&(struct pl_adaptive_params) { PL_ADAPTIVE_DEFAULTS __VA_ARGS__ })
+PL_API extern const struct pl_adaptive_params pl_adaptive_default_params;
+
 // Represents the options used for rendering. These affect the quality of
 // the result.
 struct pl_render_params {
@@ -155,6 +235,9 @@ struct pl_render_params {
     // `pl_render_image_mix` will use nearest-neighbour semantics. (Note that
     // this still goes through the redraw cache, unless you also enable
     // `skip_caching_single_frame`)
+    //
+    // Setting this to `pl_filter_motion` enables motion-compensated frame
+    // interpolation, see `pl_filter_function_motion`.
     const struct pl_filter_config *frame_mixer;
 
     // Configures the settings used to deband source textures. Leaving this as
@@ -192,6 +275,11 @@ struct pl_render_params {
     // possible. Leaving this as NULL disables error diffusion.
     const struct pl_error_diffusion_kernel *error_diffusion;
 
+    // Splits error diffusion into independently dithered tiles, processed
+    // in parallel. This is dramatically faster at high resolutions, but only
+    // approximates the exact result. See `pl_error_diffusion_params.tile_w`.
+    bool tiled_error_diffusion;
+
     // Configures the settings used to simulate color blindness, if desired.
     // If NULL, this feature is disabled.
     const struct pl_cone_params *cone_params;
@@ -274,6 +362,13 @@ struct pl_render_params {
     // Significantly speeds up downscaling with high downscaling ratios.
     bool skip_anti_aliasing;
 
+    // For downscaling ratios above 4x, first box filters the image by the
+    // largest power of two that still leaves a ratio of at least 2x for the
+    // configured `downscaler`, which then only needs to handle the remaining
+    // (small) ratio. This results in slight aliasing, but greatly reduces the
+    // cost of very large downscales (e.g. thumbnail generation).
+    bool box_prescaling;
+
     // Normally, when the size of the `target` used with `pl_render_image_mix`
     // changes, or the render parameters are updated, the internal cache of
     // mixed frames must be discarded in order to re-render all required
@@ -325,6 +420,14 @@ struct pl_render_params {
     // disabling linear scaling and sigmoidization.
     bool force_low_bit_depth_fbos;
 
+    // Use packed 32-bit formats (rgb10a2, rg11b10f) for intermediate FBOs
+    // without alpha, where the loss of precision is bounded, i.e. for SDR
+    // content of at most 10 bits. This halves the memory bandwidth of these
+    // passes, which is mainly beneficial on bandwidth-starved integrated
+    // GPUs. Linear light intermediates are only packed when a floating point
+    // format is available.
+    bool packed_fbos;
+
     // If this is true, all shaders will be generated as "dynamic" shaders,
     // with any compile-time constants being replaced by runtime-adjustable
     // values. This is generally a performance loss, but has the advantage of
@@ -335,6 +438,63 @@ struct pl_render_params {
     // user, but it should be set to false once those values are "dialed in".
     bool dynamic_constants;
 
+    // If true, shaders which have not been compiled yet are compiled on a
+    // background thread instead of stalling rendering. Until they are ready,
+    // frames are instead rendered using a cheaper fallback configuration
+    // (built-in scalers, no debanding, sigmoidization, peak detection or
+    // error diffusion), which typically only requires already-compiled or
+    // far cheaper shaders. Has no effect unless `pl_gpu_limits.thread_safe`.
+    bool async_compile;
+
+    // Dispatches the independent per-plane passes of the source image (e.g.
+    // deinterlacing, plane merging or sampling of subsampled chroma planes)
+    // as compute shaders where possible. On backends with dedicated compute
+    // queues (e.g. `pl_vulkan_params.async_compute`), these tiny passes can
+    // then execute in parallel with each other and with fragment work, rather
+    // than leaving the GPU underutilized while running them in sequence. Has
+    // no effect if the FBO format is not storable.
+    bool parallel_planes;
+
+    // Computes intermediate color values in the scaling and debanding shaders
+    // at reduced (`mediump`) precision, allowing fp16 arithmetic on GLSL ES
+    // and Vulkan devices. This is typically a sizable speedup on mobile GPUs,
+    // at the cost of a small amount of extra error (well below the precision
+    // of 16-bit FBOs). See `pl_shader_params.low_precision`.
+    bool low_precision;
+
+    // Uses fast polynomial approximations of the PQ transfer function when
+    // linearizing and delinearizing HDR content, which is a sizable speedup
+    // on GPUs with low transcendental throughput (e.g. mobile GPUs). See
+    // `pl_shader_params.fast_transfer` for the error bounds.
+    bool fast_transfer;
+
+    // If set above 1, each pass is only timed on one out of every
+    // `timer_interval` frames, which reduces the overhead of timer queries
+    // accordingly. The times reported by `pl_render_stats` and
+    // `info_callback` are then up to this many frames old. See
+    // `pl_dispatch_set_timer_interval`.
+    int timer_interval;
+
+    // Enables automatic quality reduction to hold a frame time budget. The
+    // reductions are applied on top of the other settings in this struct.
+    // See `pl_adaptive_params` for more information. Optional.
+    const struct pl_adaptive_params *adaptive_params;
+
+    // Enables damage tracking for `pl_render_image`. The renderer keeps a copy
+    // of the last rendered output, and frames specifying `pl_frame.damage`
+    // for both the image and the target only redraw the affected part of the
+    // target, copying the rest from the previous frame. This costs an extra
+    // texture copy per frame, but can drastically reduce GPU usage for mostly
+    // static content. Frames are always redrawn fully when the parameters or
+    // geometry change, as well as for planar or flipped targets, when using
+    // `blend_params`, `skip_target_clearing` or custom hooks, or if the target
+    // texture is not `blit_dst`.
+    //
+    // Note: Effects that depend on the whole frame (e.g. peak detection or
+    // error diffusion) are still computed for the whole frame, but only
+    // updated inside the damaged region.
+    bool damage_tracking;
+
     // This callback is invoked for every pass successfully executed in the
     // process of rendering a frame. Optional.
     //
@@ -504,6 +664,18 @@ struct pl_overlay {
     // The number of parts for this overlay.
     const struct pl_overlay_part *parts;
     int num_parts;
+
+    // Optional unique signature for the contents of this overlay. If set, the
+    // renderer is allowed to assume that an overlay with the same signature
+    // looks identical to a previously drawn one, and may cache the result of
+    // compositing (and color converting) it. Users *must* change the
+    // signature whenever any of the other fields, or the contents of `tex`,
+    // change in any way. Setting this to 0 disables caching.
+    //
+    // Note: Caching only takes effect if all overlays drawn to the same frame
+    // have a signature set. This is mostly useful for subtitles, which tend
+    // to stay unchanged over many consecutive frames.
+    uint64_t signature;
 };
 
 // High-level description of a complete frame, including metadata and planes
@@ -602,6 +774,19 @@ struct pl_frame {
     const struct pl_overlay *overlays;
     int num_overlays;
 
+    // List of regions of this frame (in the same coordinate system as `crop`)
+    // which changed since the previous call to `pl_render_image`. This should
+    // include changes to overlays. Only used with
+    // `pl_render_params.damage_tracking`, see there. If NULL, the whole frame
+    // is assumed to have changed, whereas `num_damage == 0` with a non-NULL
+    // `damage` indicates that nothing changed.
+    //
+    // Note: It's the user's responsibility to make sure that nothing except
+    // the contents of these regions changed. In particular, the frames must
+    // otherwise be identical to the previous call.
+    const pl_rect2d *damage;
+    int num_damage;
+
     // Note on subsampling and plane correspondence: All planes belonging to
     // the same frame will only be stretched by an integer multiple (or inverse
     // thereof) in order to match the reference dimensions of this image. For
@@ -702,15 +887,173 @@ PL_API bool pl_render_image(pl_renderer rr, const struct pl_frame *image,
                             const struct pl_frame *target,
                             const struct pl_render_params *params);
 
+// Render a single image to multiple targets at once, e.g. different output
+// resolutions of the same source. This is equivalent to calling
+// `pl_render_image` for each target in turn, except that the source-side
+// passes (plane merging, debanding, film grain, chroma scaling, color
+// decoding and HDR peak detection) are only performed once, with the result
+// shared between all targets. Only the main scaling and output stages are
+// repeated per target.
+//
+// Note: Targets whose geometry requires a different adjustment of the source
+// crop (e.g. due to subpixel target crops or differing flips/rotations), as
+// well as all targets when using custom hooks, fall back to being rendered
+// individually. `pl_render_stats` are accumulated over all targets.
+PL_API bool pl_render_image_multi(pl_renderer rr, const struct pl_frame *image,
+                                  const struct pl_frame *targets, int num_targets,
+                                  const struct pl_render_params *params);
+
+// Token identifying a frame submitted using `pl_render_image_async`. Tokens
+// are assigned in increasing order, starting at 1. 0 is never a valid token.
+typedef uint64_t pl_render_token;
+
+struct pl_render_async_params {
+    // If set, called once the GPU has finished rendering to `target`, at
+    // which point its planes may be reused or read back without stalling.
+    // Callbacks are invoked in submission order, on whichever thread calls
+    // into the renderer (`pl_render_image_async`, `pl_renderer_poll` or
+    // `pl_renderer_destroy`) after the frame completes.
+    void (*done)(void *priv, pl_render_token token);
+    void *priv;
+
+    // If nonzero, limits the number of frames in flight. If this many frames
+    // are already pending, `pl_render_image_async` first blocks until the
+    // oldest of them completes, bounding both latency and memory usage.
+    int max_frames_in_flight;
+};
+
+#define pl_render_async_params(...) (&(struct pl_render_async_params) { __VA_ARGS__ })
+
+// Variant of `pl_render_image` which immediately submits the rendered frame
+// to the GPU, and tracks its completion. Returns a token that can be waited
+// on using `pl_renderer_poll`, or 0 on failure (in which case `done` is
+// never called). This allows keeping multiple frames in flight (e.g. render,
+// download and encode) without blocking on `pl_gpu_finish`.
+//
+// Note: Completion is tracked using `pl_tex_poll` on the planes of `target`,
+// which must therefore remain valid until the frame completes. On GPUs where
+// `pl_tex_poll` is a no-op (which lack `pl_gpu_limits.callbacks`), frames are
+// considered complete as soon as they are submitted.
+PL_API pl_render_token pl_render_image_async(pl_renderer rr,
+                                             const struct pl_frame *image,
+                                             const struct pl_frame *target,
+                                             const struct pl_render_params *params,
+                                             const struct pl_render_async_params *async);
+
+// Returns true if the frame identified by `token` is still in flight, after
+// blocking for up to `timeout` nanoseconds for it to complete, analogous to
+// `pl_tex_poll`. Also dispatches the `done` callbacks of all frames completed
+// so far. Unknown (or already completed) tokens are never in flight.
+PL_API bool pl_renderer_poll(pl_renderer rr, pl_render_token token, uint64_t timeout);
+
+struct pl_render_precompile_params {
+    // Representative source and target frames. Every combination of image,
+    // target and params is rendered once, with all shaders compiled but not
+    // executed. The frame contents are irrelevant, but the frame metadata
+    // (textures formats and sizes, crops, color spaces, etc.) should match
+    // what will be used for actual rendering, since they affect the
+    // generated shaders. `targets` may still be written to (e.g. cleared).
+    const struct pl_frame *images;
+    int num_images;
+    const struct pl_frame *targets;
+    int num_targets;
+
+    // List of rendering parameters to precompile. If empty, defaults to
+    // `pl_render_default_params`.
+    const struct pl_render_params *const *params;
+    int num_params;
+
+    // Number of worker threads to compile shaders on. If 0, all shaders are
+    // compiled on the calling thread. See `pl_dispatch_precompile_begin`.
+    int num_threads;
+};
+
+#define pl_render_precompile_params(...) (&(struct pl_render_precompile_params) { __VA_ARGS__ })
+
+// Pre-generates and compiles all shaders which would be needed for rendering
+// the given frames with the given sets of parameters, for example to warm up
+// the shader cache during a loading screen. The compiled shaders are written
+// to the `pl_cache` associated with the GPU, and also retained by the
+// renderer for future calls to `pl_render_image`. Returns false if any
+// shader failed to compile.
+//
+// Note: This does not support frame mixing, and flushes the renderer's
+// internal caches (`pl_renderer_flush_cache`) before returning.
+PL_API bool pl_render_precompile(pl_renderer rr,
+                                 const struct pl_render_precompile_params *params);
+
+// See <libplacebo/utils/upload.h>
+struct pl_plane_data;
+
+struct pl_render_tiled_params {
+    // Source and target frames. Only the metadata of these frames is used
+    // (colorspace, crops, plane shifts, etc.), the plane textures are ignored
+    // and may be NULL. Flipped planes, rotation and overlays are not
+    // supported. If the crops are left empty, they default to the full size of
+    // the largest plane.
+    const struct pl_frame *image;
+    const struct pl_frame *target;
+
+    // Host memory backing each plane, one entry per plane of `image` and
+    // `target`, respectively. The plane data must be given as `pixels`,
+    // `buf` is not supported. The `target_data[i].pixels` are written to, and
+    // must exactly match the texel layout of a texture format supported by
+    // `pl_recreate_plane`.
+    const struct pl_plane_data *image_data;
+    const struct pl_plane_data *target_data;
+
+    // Size of each tile, in target pixels. Rounded up to a multiple of 16
+    // and reduced as needed to make the corresponding source tiles fit into
+    // `pl_gpu_limits.max_tex_2d_dim`. Defaults to 1024 if left as 0.
+    int tile_size;
+
+    // Rendering parameters. Defaults to `pl_render_default_params`.
+    const struct pl_render_params *params;
+};
+
+#define pl_render_tiled_params(...) (&(struct pl_render_tiled_params) { __VA_ARGS__ })
+
+// Render an image which may be larger than the texture size limits of the
+// GPU, by splitting the target into tiles. Each tile is rendered from the
+// corresponding region of the source, padded by the support of the scalers,
+// which gets uploaded from host memory. The result is downloaded back into
+// host memory while the next tile is being rendered, so GPU memory usage
+// stays bounded by roughly two tiles' worth of textures, independently of the
+// image size. Returns whether successful.
+//
+// Note: Features which depend on the frame as a whole (peak detection,
+// corner rounding, distortion and damage tracking) are disabled. Dithering,
+// debanding and film grain are performed independently for each tile, so
+// their noise patterns will not be identical to an untiled render.
+PL_API bool pl_render_image_tiled(pl_renderer rr,
+                                  const struct pl_render_tiled_params *params);
+
 // Flushes the internal state of this renderer. This is normally not needed,
 // even if the image parameters, colorspace or target configuration change,
 // since libplacebo will internally detect such circumstances and recreate
 // outdated resources automatically. Doing this explicitly *may* be useful to
-// purge some state related to things like HDR peak detection or frame mixing,
-// so calling it is a good idea if the content source is expected to change
-// dramatically (e.g. when switching to a different file).
+// purge some state related to things like HDR peak detection, frame mixing or
+// damage tracking (forcing the next frame to be redrawn fully), so calling it
+// is a good idea if the content source is expected to change dramatically
+// (e.g. when switching to a different file).
 PL_API void pl_renderer_flush_cache(pl_renderer rr);
 
+// Frees cached GPU textures held by this renderer in between calls
+// (intermediate FBOs, composited overlays, damage tracking and frame mixing
+// caches), roughly in least-recently-used order, until at most `target` bytes
+// remain. Returns the number of bytes still held afterwards. If `target` is 0,
+// this additionally frees all internal shader objects (scaler and color
+// management LUTs, dither matrices, film grain textures etc.), which are not
+// otherwise accounted for. Everything is recreated on demand, at the cost of
+// extra work on the next frame.
+PL_API size_t pl_renderer_trim(pl_renderer rr, size_t target);
+
+// Limits the amount of cached GPU texture memory held by this renderer in
+// between calls, by calling `pl_renderer_trim` after every rendering call
+// (and immediately). Memory needed to render the current frame is always
+// allocated, so this is a soft limit. 0 disables the budget (the default).
+PL_API void pl_renderer_set_memory_budget(pl_renderer rr, size_t bytes);
+
 // Mirrors `pl_get_detected_hdr_metadata`, giving you the current internal peak
 // detection HDR metadata (when peak detection is active). Returns false if no
 // information is available (e.g. not HDR source, peak detection disabled).
@@ -772,6 +1115,17 @@ struct pl_frame_mix {
     // vsync being painted is visible for the period [0.0, 0.4].
     float vsync_duration;
 
+    // Optional list of signatures of frames which are expected to be needed
+    // again by future calls, in addition to the frames in this mix (e.g. all
+    // frames still held by the frame queue). If provided, the renderer keeps
+    // any cached copies of these frames around, rather than evicting
+    // everything not used by the current mix. This avoids re-rendering frames
+    // which only temporarily drop out of the mix, e.g. due to vsync jitter.
+    //
+    // Note: `pl_queue_update` fills this in automatically.
+    const uint64_t *retain;
+    int num_retain;
+
     // Explanation of the frame mixing radius: The algorithm chosen in
     // `pl_render_params.frame_mixer` has a canonical radius equal to
     // `pl_filter_config.kernel->radius`. This means that the frame mixing
@@ -812,6 +1166,12 @@ PL_API const struct pl_frame *pl_frame_mix_nearest(const struct pl_frame_mix *mi
 // This allows libplacebo to perform rudimentary frame mixing / interpolation,
 // in order to eliminate judder artifacts typically associated with
 // source/display frame rate mismatch.
+//
+// Note: Frames are normally rendered individually into an internal cache at
+// the output resolution before being mixed. When no per-frame processing
+// beyond color conversion is required (i.e. no scaling, hooks, LUTs, ICC
+// profiles, overlays etc.), the frames are instead mixed in a single pass
+// directly from their source textures, bypassing the cache.
 PL_API bool pl_render_image_mix(pl_renderer rr, const struct pl_frame_mix *images,
                                 const struct pl_frame *target,
                                 const struct pl_render_params *params);
@@ -63,6 +63,21 @@ struct pl_shader_params {
     // dynamic variables. This is mainly useful to avoid recompilation for
     // shaders which expect to have their values change constantly.
     bool dynamic_constants;
+
+    // If true, shaders may compute intermediate color values (e.g. filter
+    // weights and accumulators) at reduced (`mediump`) precision. On GLSL ES
+    // and Vulkan, this allows the driver to use fp16 arithmetic, which is
+    // typically twice as fast on mobile GPUs. Texture coordinates are always
+    // kept at full precision. Has no effect on desktop GLSL.
+    bool low_precision;
+
+    // If true, `pl_shader_linearize` and `pl_shader_delinearize` evaluate the
+    // PQ transfer function using piecewise polynomial approximations instead
+    // of the exact `pow`-based formulas, avoiding transcendental functions
+    // almost entirely. The maximum error is around 1e-4 in PQ space (about
+    // 0.1 code values at 10 bits) for signals above the first 10-bit code
+    // value. Other transfer functions are unaffected.
+    bool fast_transfer;
 };
 
 #define pl_shader_params(...) (&(struct pl_shader_params) { __VA_ARGS__ })
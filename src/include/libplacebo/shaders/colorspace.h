@@ -41,6 +41,17 @@ PL_API void pl_shader_set_alpha(pl_shader sh, struct pl_color_repr *repr,
 // automatically by `pl_shader_decode_color` for PL_COLOR_SYSTEM_DOLBYVISION.
 PL_API void pl_shader_dovi_reshape(pl_shader sh, const struct pl_dovi_metadata *data);
 
+// Like `pl_shader_dovi_reshape`, but bakes the reshaping curves of components
+// which use only polynomial reshaping into a small 1D LUT, trading the
+// per-pixel polynomial evaluation for a single texture lookup. Components
+// using MMR reshaping are still evaluated directly.
+//
+// `lut_state` must be a pointer to a NULL-initialized shader state object,
+// which should be reused across frames. The LUT is only regenerated when the
+// reshaping metadata changes, e.g. at scene boundaries.
+PL_API void pl_shader_dovi_reshape_lut(pl_shader sh, const struct pl_dovi_metadata *data,
+                                       pl_shader_obj *lut_state);
+
 // Decode the color into normalized RGB, given a specified color_repr. This
 // also takes care of additional pre- and post-conversions requires for the
 // "special" color systems (XYZ, BT.2020-C, etc.). If `params` is left as NULL,
@@ -138,11 +149,30 @@ struct pl_peak_detect_params {
     // possibility of 1-frame flickers on transitions. Disabled by default.
     bool allow_delayed;
 
+    // If `allow_delayed` is enabled, this controls the maximum number of
+    // frames the peak detection result may lag behind. Results are consumed
+    // as soon as the GPU has finished producing them, and the CPU only ever
+    // blocks on a peak detection buffer once more than this many frames are
+    // in flight. Values above 1 allow the GPU to run ahead of the CPU without
+    // stalling on the readback. Defaults to 1 if left as 0. Limited to
+    // PL_PEAK_DETECT_MAX_DELAY.
+    int max_delay;
+
+    // If set above 1, only one out of every `stride` x `stride` pixels is
+    // measured, on a regular grid. Since the statistics being estimated are
+    // aggregates over the whole frame, a stride of 2 or 4 (1/4 or 1/16 of all
+    // pixels) is typically indistinguishable from a full measurement, while
+    // skipping most of the per-pixel work. Limited to PL_PEAK_DETECT_MAX_STRIDE.
+    int stride;
+
     // --- Deprecated / removed fields
     float overshoot_margin PL_DEPRECATED;
     float minimum_peak PL_DEPRECATED;
 };
 
+#define PL_PEAK_DETECT_MAX_DELAY 4
+#define PL_PEAK_DETECT_MAX_STRIDE 16
+
 #define PL_PEAK_DETECT_DEFAULTS         \
     .smoothing_period       = 20.0f,    \
     .scene_threshold_low    = 1.0f,     \
@@ -244,6 +274,13 @@ struct pl_color_map_params {
     // default size.
     bool lut3d_tricubic;
 
+    // If true, `lut3d_size` is treated as an upper bound, and the gamut
+    // mapping 3DLUT is shrunk to the smallest size that still reproduces the
+    // mapping accurately (see `pl_gamut_map_fit_lut_size`), or skipped
+    // entirely if the mapping turns out to be a no-op. Saves both generation
+    // time and texture memory when the source and target gamuts are similar.
+    bool lut3d_adaptive;
+
     // If true, allows the gamut mapping function to expand the gamut, in
     // cases where the target gamut exceeds that of the source. If false,
     // the source gamut will never be enlarged, even when using a gamut
@@ -285,7 +322,8 @@ struct pl_color_map_params {
     // --- Debugging options
 
     // Force the use of a full tone-mapping LUT even for functions that have
-    // faster pure GLSL replacements (e.g. clip, linear, saturation).
+    // faster pure GLSL replacements (e.g. clip, linear, spline, bt2390,
+    // saturation).
     bool force_tone_mapping_lut;
 
     // Visualize the tone-mapping LUT and gamut mapping 3DLUT, in IPT space.
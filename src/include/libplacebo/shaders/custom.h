@@ -334,6 +334,26 @@ struct pl_hook {
 PL_API const struct pl_hook *
 pl_mpv_user_shader_parse(pl_gpu gpu, const char *shader_text, size_t shader_len);
 
+struct pl_mpv_user_shader_params {
+    // If true, fragment-style passes which only sample HOOKED at constant
+    // integer offsets (via `HOOKED_texOff` or `HOOKED_tex(HOOKED_pos)`),
+    // and which don't resize the image, are run as tiled compute shaders
+    // that prefetch the sampled neighbourhood into shared memory. This can
+    // significantly speed up convolution-heavy shaders without requiring
+    // any changes to them. Passes not meeting these criteria, or GPUs
+    // without compute shader support, transparently fall back to fragment
+    // shaders.
+    bool compute_tiling;
+};
+
+#define pl_mpv_user_shader_params(...) (&(struct pl_mpv_user_shader_params) { __VA_ARGS__ })
+
+// Like `pl_mpv_user_shader_parse`, but with extra parameters. `params` may
+// be NULL, in which case this is identical to `pl_mpv_user_shader_parse`.
+PL_API const struct pl_hook *
+pl_mpv_user_shader_parse_ex(pl_gpu gpu, const char *shader_text, size_t shader_len,
+                            const struct pl_mpv_user_shader_params *params);
+
 PL_API void pl_mpv_user_shader_destroy(const struct pl_hook **hook);
 
 PL_API_END
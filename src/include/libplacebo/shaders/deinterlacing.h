@@ -132,6 +132,20 @@ PL_API extern const struct pl_deinterlace_params pl_deinterlace_default_params;
 PL_API void pl_shader_deinterlace(pl_shader sh, const struct pl_deinterlace_source *src,
                                   const struct pl_deinterlace_params *params);
 
+// Deinterlaces several independent sources (e.g. the channels of a
+// multiviewer) in a single shader, packing the results into a shared output
+// atlas. `rects[i]` gives the output rectangle for `srcs[i]`, which must not
+// be flipped and must match the size of `srcs[i].cur.top`. Rects should not
+// overlap. The output size is the bounding box of all rects, with the origin
+// at (0, 0). Pixels not covered by any rect are output as transparent black.
+//
+// Note: Every source binds its own textures, so the number of sources per
+// batch is limited by the number of descriptors the GPU supports.
+PL_API void pl_shader_deinterlace_batch(pl_shader sh,
+                                        const struct pl_deinterlace_source *srcs,
+                                        const pl_rect2d *rects, int num_srcs,
+                                        const struct pl_deinterlace_params *params);
+
 PL_API_END
 
 #endif // LIBPLACEBO_SHADERS_DEINTERLACING_H_
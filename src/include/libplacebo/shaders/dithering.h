@@ -51,6 +51,17 @@ enum pl_dither_method {
     // noise spectrum.
     PL_DITHER_WHITE_NOISE,
 
+    // Spatiotemporal blue noise. Uses the same LUT as `PL_DITHER_BLUE_NOISE`,
+    // but additionally offsets every texel's threshold by a low-discrepancy
+    // (golden ratio) sequence over successive frames. Each frame remains blue
+    // noise spatially, while the value sequence at every pixel is evenly
+    // distributed over time, so the error averages out much faster than with
+    // a static or randomly perturbed matrix. This gives noticeably smoother
+    // results at low output depths on displays that can keep up with it.
+    // Implies `temporal`, and ignores the matrix perturbation it would
+    // otherwise apply.
+    PL_DITHER_BLUE_NOISE_TEMPORAL,
+
     PL_DITHER_METHOD_COUNT,
 };
 
@@ -116,13 +127,28 @@ struct pl_error_diffusion_params {
     // Error diffusion kernel to use. Optional. If unspecified, defaults to
     // `&pl_error_diffusion_sierra_lite`.
     const struct pl_error_diffusion_kernel *kernel;
+
+    // If either of these is nonzero, the image is split into tiles of (at
+    // most) this size, each of which is dithered by an independent work
+    // group, rather than by a single work group sweeping over the whole
+    // image. A zero value means the tiles span the full width/height. Each
+    // work group also dithers a margin of `PL_EDF_TILE_MARGIN` pixels above
+    // and to the left of its tile, without writing the result, to estimate
+    // the error diffused into the tile from its neighbours. This makes error
+    // diffusion fast enough for realtime usage at high resolutions, at the
+    // cost of the output not being exactly identical to the untiled result.
+    int tile_w, tile_h;
 };
 
+// Size of the margin dithered (but not written) around each tile.
+#define PL_EDF_TILE_MARGIN 16
+
 #define pl_error_diffusion_params(...) (&(struct pl_error_diffusion_params) { __VA_ARGS__ })
 
 // Computes the shared memory requirements for a given error diffusion kernel.
 // This can be used to test up-front whether or not error diffusion would be
-// supported or not, before having to initialize textures.
+// supported or not, before having to initialize textures. When using tiling,
+// `height` should be `tile_h + PL_EDF_TILE_MARGIN` (if smaller than the image).
 PL_API size_t pl_error_diffusion_shmem_req(const struct pl_error_diffusion_kernel *kernel,
                                            int height);
 
@@ -132,7 +158,8 @@ PL_API size_t pl_error_diffusion_shmem_req(const struct pl_error_diffusion_kerne
 //
 // Requires compute shader support. Returns false if dithering fail e.g. as a
 // result of shader memory limits being exceeded. The resulting shader must be
-// dispatched with a work group count of exactly 1.
+// dispatched with a work group count of exactly 1, or, when using tiling, of
+// ceil(width / tile_w) x ceil(height / tile_h).
 PL_API bool pl_shader_error_diffusion(pl_shader sh, const struct pl_error_diffusion_params *params);
 
 PL_API_END
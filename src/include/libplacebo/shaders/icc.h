@@ -58,8 +58,18 @@ struct pl_icc_params {
     // or when using PL_INTENT_PERCEPTUAL, but YMMV.
     bool force_bpc;
 
+    // If true, `pl_icc_decode` and `pl_icc_encode` don't block on generating
+    // large 3DLUTs. Instead, a coarse 3DLUT (17x17x17) is generated and used
+    // immediately, while the full-size 3DLUT is generated on a background
+    // thread. Once that is done, it transparently replaces the coarse 3DLUT
+    // on the next call, i.e. the next rendered frame. Mainly useful to get
+    // color managed output on screen immediately after e.g. display hotplug.
+    bool progressive;
+
     // If provided, this pl_cache instance will be used, instead of the
-    // GPU-internal cache, to cache the generated 3DLUTs. Note that these can
+    // GPU-internal cache, to cache the generated 3DLUTs (as well as the
+    // results of the profile analysis, e.g. detected primaries and contrast,
+    // which are otherwise recomputed on every open). Note that the LUTs can
     // get large, especially for large values of size_{r,g,b}, so the user may
     // wish to split this cache off from the main shader cache. (Optional)
     pl_cache cache;
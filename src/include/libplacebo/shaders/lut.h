@@ -59,7 +59,25 @@ struct pl_custom_lut {
 // Parse a 3DLUT in .cube format. Returns NULL if the file fails parsing.
 PL_API struct pl_custom_lut *pl_lut_parse_cube(pl_log log, const char *str, size_t str_len);
 
-// Frees a LUT created by `pl_lut_parse_*`.
+// Serialize a `pl_custom_lut` into a compact binary representation, which can
+// be loaded back with `pl_lut_load` without any text parsing. The LUT data is
+// stored as raw native-endian 32-bit floats, so the resulting blob is only
+// portable between machines of the same endianness.
+//
+// If `out` is NULL, returns the number of bytes required. Otherwise, writes
+// the serialized LUT to `out`, and returns the number of bytes written. Returns
+// 0 if `out_size` is too small, or if the LUT dimensions are invalid.
+PL_API size_t pl_lut_save(const struct pl_custom_lut *lut, uint8_t *out,
+                          size_t out_size);
+
+// Load a LUT previously serialized with `pl_lut_save`. This only validates the
+// header and copies the LUT data as-is, so it's cheap enough to switch between
+// LUTs at will. `data` may e.g. point directly into a memory-mapped file, and
+// is not referenced after this function returns. Returns NULL on failure.
+PL_API struct pl_custom_lut *pl_lut_load(pl_log log, const uint8_t *data,
+                                         size_t size);
+
+// Frees a LUT created by `pl_lut_parse_*` or `pl_lut_load`.
 PL_API void pl_lut_free(struct pl_custom_lut **lut);
 
 // Apply a `pl_custom_lut`. The user is responsible for ensuring colors going
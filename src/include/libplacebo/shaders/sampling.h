@@ -80,6 +80,13 @@ struct pl_deband_params {
     // lower radius will smooth more aggressively. Defaults to 16.0.
     float radius;
 
+    // If true, skip all further iterations for pixels where the first
+    // iteration did not find a flat neighbourhood. Since the threshold only
+    // gets stricter for later iterations, these would almost never change
+    // anything, so this mainly saves time on detailed content when using
+    // multiple iterations, at the cost of some branching.
+    bool adaptive;
+
     // Add some extra noise to the image. This significantly helps cover up
     // remaining quantization artifacts. Higher numbers add more noise.
     // Note: When debanding HDR sources, even a small amount of grain can
@@ -153,6 +160,15 @@ PL_API bool pl_shader_sample_gaussian(pl_shader sh, const struct pl_sample_src *
 PL_API bool pl_shader_sample_oversample(pl_shader sh, const struct pl_sample_src *src,
                                         float threshold);
 
+// Box filter downscaling, which averages all source texels covered by each
+// output pixel using a grid of bilinear taps placed between texel pairs. For
+// large downscaling ratios, this reads every source texel roughly once, and
+// is therefore much cheaper than the generic (anti-aliased) downscalers, at
+// the cost of aliasing. Mainly useful for reducing the source to a few times
+// the target size before applying a high quality downscaler. Requires linear
+// sampling support. Degrades to bilinear sampling when not downscaling.
+PL_API bool pl_shader_sample_box(pl_shader sh, const struct pl_sample_src *src);
+
 struct pl_sample_filter_params {
     // The filter to use for sampling.
     struct pl_filter_config filter;
@@ -204,6 +220,19 @@ PL_API bool pl_shader_sample_polar(pl_shader sh, const struct pl_sample_src *src
 PL_API bool pl_shader_sample_ortho2(pl_shader sh, const struct pl_sample_src *src,
                                     const struct pl_sample_filter_params *params);
 
+// Performs both passes of an orthogonal (separable) filter at once, using a
+// compute shader that keeps the horizontally filtered rows of each work group
+// in shared memory instead of round-tripping them through an intermediate
+// texture. Unlike `pl_shader_sample_ortho2`, `src` may scale in both
+// directions. Uses the same `params->lut` object as `pl_shader_sample_ortho2`.
+//
+// Returns false without modifying `sh` if this is not possible (e.g. compute
+// shaders are unsupported or disabled, or the required amount of shared
+// memory is too large), in which case users should fall back to two passes
+// of `pl_shader_sample_ortho2`.
+PL_API bool pl_shader_sample_ortho2_tiled(pl_shader sh, const struct pl_sample_src *src,
+                                          const struct pl_sample_filter_params *params);
+
 struct pl_distort_params {
     // An arbitrary 2x2 affine transformation to apply to the input image.
     // For simplicity, the input image is explicitly centered and scaled such
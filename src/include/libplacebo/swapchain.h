@@ -115,6 +115,17 @@ struct pl_swapchain_frame {
 // API)
 PL_API bool pl_swapchain_start_frame(pl_swapchain sw, struct pl_swapchain_frame *out_frame);
 
+// Hint the regions of the currently started frame that changed compared to
+// the previously submitted frame, in `pl_swapchain_frame.fbo` pixel
+// coordinates. The presentation engine may use this to only update the
+// damaged parts of the screen (e.g. via VK_KHR_incremental_present). This is
+// purely a hint, and the entire framebuffer must still be rendered to.
+// Applies only to the current frame, and must be called between
+// `pl_swapchain_start_frame` and `pl_swapchain_submit_frame`. If never called
+// (or called with `num_rects == 0`), the whole frame is assumed to have
+// changed.
+PL_API void pl_swapchain_damage(pl_swapchain sw, const pl_rect2d *rects, int num_rects);
+
 // Submits the previously started frame. Non-blocking. This must be issued in
 // lockstep with pl_swapchain_start_frame - there is no way to start multiple
 // frames and submit them out-of-order. The frames submitted this way will
@@ -166,6 +177,53 @@ PL_API bool pl_swapchain_submit_frame(pl_swapchain sw);
 // `start_frame` blocked for should also be included).
 PL_API void pl_swapchain_swap_buffers(pl_swapchain sw);
 
+// Presentation timing feedback, as reported by the presentation engine for
+// frames that have actually been displayed.
+struct pl_swapchain_timing {
+    // The number of presented frames for which timing feedback has been
+    // received so far. Increments as feedback for new frames becomes
+    // available, which may lag behind `pl_swapchain_swap_buffers` by a few
+    // frames.
+    uint64_t frames_presented;
+
+    // The duration of a display refresh cycle, in seconds, as measured from
+    // the actual presentation timestamps. This is generally a lot more
+    // accurate than measuring the time spent in `pl_swapchain_swap_buffers`.
+    float vsync_duration;
+
+    // The estimated time, in seconds, from the call to
+    // `pl_swapchain_get_timing` until the next display refresh. This can be
+    // used to delay rendering until shortly before the frame is needed, in
+    // order to minimize latency. 0 if unknown.
+    float next_vsync;
+};
+
+// Query the presentation timing feedback for this swapchain. Returns false
+// if this is unsupported by the swapchain, or no timing feedback has been
+// received yet. Unlike the other swapchain functions, this does not block on
+// a started frame, and can be safely called in between
+// `pl_swapchain_start_frame` and `pl_swapchain_submit_frame`.
+PL_API bool pl_swapchain_get_timing(pl_swapchain sw,
+                                    struct pl_swapchain_timing *out_timing);
+
+// Block until at most `max_queued` of the previously submitted frames are
+// still waiting to be displayed, or until `timeout` (in nanoseconds) expires.
+// Unlike `pl_swapchain_swap_buffers`, which only waits for the rendering of
+// frames to complete, this waits for their actual presentation on-screen.
+//
+// This can be used to implement explicit frame pacing for low-latency
+// applications: calling this with `max_queued = 0` before
+// `pl_swapchain_start_frame` ensures that no frame is ever queued behind
+// another one, so rendering can start as late as possible before the next
+// vsync. (See `pl_swapchain_timing.next_vsync`)
+//
+// Returns false on timeout, or if this is unsupported by the swapchain, in
+// which case it returns immediately. Note that like `pl_swapchain_resize`,
+// this may not be called in between `pl_swapchain_start_frame` and
+// `pl_swapchain_submit_frame`.
+PL_API bool pl_swapchain_wait_presented(pl_swapchain sw, int max_queued,
+                                        uint64_t timeout);
+
 PL_API_END
 
 #endif // LIBPLACEBO_SWAPCHAIN_H_
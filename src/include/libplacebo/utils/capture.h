@@ -0,0 +1,90 @@
+/*
+ * This file is part of libplacebo.
+ *
+ * libplacebo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libplacebo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libplacebo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBPLACEBO_CAPTURE_H
+#define LIBPLACEBO_CAPTURE_H
+
+#include <libplacebo/gpu.h>
+
+PL_API_BEGIN
+
+// Helper for recording the GPU workload submitted to a `pl_gpu`, so it can be
+// replayed (and profiled) later, without the original application or media.
+//
+// While a capture is attached, every `pl_pass_run` on the GPU is recorded,
+// together with the parameters of the pass and of all textures and buffers
+// it uses, as well as the contents of all `pl_buf_write` calls to uniform or
+// vertex buffers. Texture and storage buffer contents are deliberately not
+// recorded, so captures stay small and contain no user content; they are
+// replayed with zero-initialized contents instead.
+//
+// Note: Variables and uniform buffers not updated during the capture are
+// likewise replayed as zero. For the most faithful results, attach the
+// capture before creating the renderer (or other dispatch user), so that
+// all passes are first seen while capturing.
+//
+// Thread-safety: Safe
+typedef struct pl_capture_t *pl_capture;
+
+// Starts capturing all work submitted to `gpu`. Only one capture can be
+// attached to a GPU at any given time. Returns NULL on failure.
+PL_API pl_capture pl_capture_create(pl_gpu gpu);
+
+// Stops capturing and frees all recorded state.
+PL_API void pl_capture_destroy(pl_capture *cap);
+
+// Serializes everything recorded so far into `out`. Returns the number of
+// bytes written, or the number of bytes required if `out` is NULL (or
+// `out_size` is too small, in which case nothing is written).
+PL_API size_t pl_capture_save(pl_capture cap, uint8_t *out, size_t out_size);
+
+// Per-pass statistics reported by `pl_capture_replay`.
+struct pl_capture_pass_info {
+    int index;                      // index of this pass, in order of first use
+    enum pl_pass_type type;
+    const char *shader;             // fragment or compute shader source
+    int runs;                       // number of invocations per iteration
+
+    // Total GPU time spent executing this pass, summed over all invocations
+    // and iterations, in nanoseconds. Left as 0 if the GPU lacks timers.
+    uint64_t total_ns;
+};
+
+struct pl_capture_replay_params {
+    // Number of times to re-execute the captured workload. Defaults to 1.
+    int iterations;
+
+    // If set, called once per replayed pass after all iterations complete.
+    // The referenced data is only valid for the duration of the callback.
+    void (*pass_info)(void *priv, const struct pl_capture_pass_info *info);
+    void *priv;
+};
+
+#define pl_capture_replay_params(...) (&(struct pl_capture_replay_params) { __VA_ARGS__ })
+
+// Re-creates all passes and resources from a serialized capture on `gpu`
+// and replays the recorded sequence of `pl_pass_run` calls, timing each
+// invocation. `gpu` may differ from the one captured on, but must accept
+// the captured shaders (which are specific to the GLSL dialect and
+// descriptor binding model of the original GPU) and formats (which are
+// looked up by name). Returns whether successful.
+PL_API bool pl_capture_replay(pl_gpu gpu, const uint8_t *data, size_t size,
+                              const struct pl_capture_replay_params *params);
+
+PL_API_END
+
+#endif // LIBPLACEBO_CAPTURE_H
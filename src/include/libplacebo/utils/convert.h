@@ -0,0 +1,82 @@
+/*
+ * This file is part of libplacebo.
+ *
+ * libplacebo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libplacebo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libplacebo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBPLACEBO_CONVERT_H
+#define LIBPLACEBO_CONVERT_H
+
+#include <libplacebo/colorspace.h>
+#include <libplacebo/shaders/colorspace.h>
+#include <libplacebo/utils/upload.h>
+
+PL_API_BEGIN
+
+// This file contains a helper for converting images between color spaces
+// entirely on the CPU, using the same math as the equivalent shaders. This is
+// intended for small outputs (thumbnails, previews, image analysis) where a
+// round trip through the GPU would cost more than the conversion itself, as
+// well as for situations where no GPU is available at all.
+//
+// Compared to `pl_render_image`, this has a number of limitations:
+// - Resampling (including chroma upsampling) uses nearest neighbour sampling.
+// - Only color systems which are a linear transformation of the encoded
+//   values (i.e. excluding BT.2020-CL, BT.2100 ICtCp, XYZ and Dolby Vision)
+//   are supported.
+// - Only byte-aligned components of 8 or 16 bits (UNORM), or 32 bits (FLOAT),
+//   are supported.
+// - Only the tone mapping and gamut mapping parts of `pl_color_map_params`
+//   are respected. Options like `contrast_recovery` or `visualize_lut` are
+//   ignored.
+
+struct pl_convert_params {
+    // Planes (in host memory) and colorimetry of the source image. The first
+    // plane with the largest dimensions determines the size of the image,
+    // other planes are assumed to be subsampled relative to it. If
+    // `src_repr.bits` is left unset, `sample_depth` is inferred from the
+    // component size of the first plane. (Required)
+    const struct pl_plane_data *src_planes;
+    int num_src_planes;
+    struct pl_color_repr src_repr;
+    struct pl_color_space src_color;
+
+    // Host layout and colorimetry of the destination image. All destination
+    // planes must have the same dimensions, which may differ from those of the
+    // source image. The `pixels` field is ignored, the converted pixels are
+    // instead written to `dst_data[i]` for each plane `i`. (Required)
+    const struct pl_plane_data *dst_planes;
+    int num_dst_planes;
+    void *dst_data[PL_MAX_PLANES];
+    struct pl_color_repr dst_repr;
+    struct pl_color_space dst_color;
+
+    // Optional color adjustment applied while decoding the source image.
+    const struct pl_color_adjustment *adjustment;
+
+    // Tone mapping and gamut mapping configuration. Defaults to
+    // `pl_color_map_default_params`.
+    const struct pl_color_map_params *color_map_params;
+};
+
+#define pl_convert_params(...) (&(struct pl_convert_params) { __VA_ARGS__ })
+
+// Converts the source image to the destination image, as described by
+// `params`. Rows are distributed across all available CPU cores. Returns false
+// on failure, e.g. due to an unsupported color system or plane layout.
+PL_API bool pl_convert_planes(pl_log log, const struct pl_convert_params *params);
+
+PL_API_END
+
+#endif // LIBPLACEBO_CONVERT_H
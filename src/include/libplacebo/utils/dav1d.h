@@ -102,6 +102,25 @@ PL_DAV1D_API bool pl_upload_dav1dpicture(pl_gpu gpu,
 PL_DAV1D_API int pl_allocate_dav1dpicture(Dav1dPicture *picture, void *gpu);
 PL_DAV1D_API void pl_release_dav1dpicture(Dav1dPicture *picture, void *gpu);
 
+// Pool of persistently mapped buffers, for use with the pooled variants of
+// the allocation functions above. Instead of creating (and destroying) a new
+// `pl_buf` for every picture, released buffers are kept around and recycled
+// for subsequent pictures, so steady-state decoding performs no allocations.
+typedef struct pl_dav1d_pool_t *pl_dav1d_pool;
+PL_DAV1D_API pl_dav1d_pool pl_dav1d_pool_create(pl_gpu gpu);
+
+// Pictures allocated from the pool may safely outlive it, the pool is only
+// freed once the last of them has been released.
+PL_DAV1D_API void pl_dav1d_pool_destroy(pl_dav1d_pool *pool);
+
+// Variants of `pl_allocate/release_dav1dpicture` that allocate from the
+// `pl_dav1d_pool` passed as the value of `cookie`. These are thread-safe
+// (given a `pl_gpu.limits.thread_safe` GPU) and may be used directly as a
+// Dav1dPicAllocator. Allocated pictures are compatible with
+// `pl_dav1d_upload_params.gpu_allocated`.
+PL_DAV1D_API int pl_allocate_dav1dpicture_pooled(Dav1dPicture *picture, void *pool);
+PL_DAV1D_API void pl_release_dav1dpicture_pooled(Dav1dPicture *picture, void *pool);
+
 // Mapping functions for the various Dav1dColor* enums. Note that these are not
 // quite 1:1, and even for values that exist in both, the semantics sometimes
 // differ. Some special cases (e.g. ICtCp, or XYZ) are handled differently in
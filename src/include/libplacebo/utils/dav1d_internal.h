@@ -22,6 +22,7 @@
 #else
 
 #include <assert.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -401,6 +402,16 @@ struct pl_dav1dalloc {
     pl_buf buf;
 };
 
+#define PL_DAV1D_POOL_SIZE 16
+
+struct pl_dav1d_pool_t {
+    pl_gpu gpu;
+    atomic_int refcount; // 1 for the pool itself, +1 per allocated picture
+
+    // Idle allocations, taken and returned with atomic exchanges
+    _Atomic(struct pl_dav1dalloc *) idle[PL_DAV1D_POOL_SIZE];
+};
+
 struct pl_dav1dref {
     Dav1dPicture pic;
     uint8_t count;
@@ -520,9 +531,11 @@ PL_DAV1D_API bool pl_upload_dav1dpicture(pl_gpu gpu,
     return true;
 }
 
-PL_DAV1D_API int pl_allocate_dav1dpicture(Dav1dPicture *p, void *cookie)
+// Fills in the strides of `p` and computes the required buffer size
+static inline int pl_dav1dpicture_layout(pl_gpu gpu, Dav1dPicture *p,
+                                         size_t *y_sz, size_t *uv_sz,
+                                         size_t *total_size)
 {
-    pl_gpu gpu = cookie;
     if (!gpu->limits.max_mapped_size || !gpu->limits.host_cached ||
         !gpu->limits.buf_transfer)
     {
@@ -545,31 +558,36 @@ PL_DAV1D_API int pl_allocate_dav1dpicture(Dav1dPicture *p, void *cookie)
 
     // Aligning offsets to 4 also implicitly aligns to the texel alignment (1 or 2)
     size_t off_align = PL_ALIGN2(gpu->limits.align_tex_xfer_offset, 4);
-    const size_t y_sz = PL_ALIGN2(p->stride[0] * aligned_h, off_align);
-    const size_t uv_sz = PL_ALIGN2(p->stride[1] * (aligned_h >> ss_ver), off_align);
+    *y_sz = PL_ALIGN2(p->stride[0] * aligned_h, off_align);
+    *uv_sz = PL_ALIGN2(p->stride[1] * (aligned_h >> ss_ver), off_align);
 
     // The extra DAV1D_PICTURE_ALIGNMENTs are to brute force plane alignment,
     // even in the case that the driver gives us insane alignments
-    const size_t pic_size = y_sz + 2 * uv_sz;
-    const size_t total_size = pic_size + DAV1D_PICTURE_ALIGNMENT * 4;
+    const size_t pic_size = *y_sz + 2 * *uv_sz;
+    *total_size = pic_size + DAV1D_PICTURE_ALIGNMENT * 4;
 
     // Validate size limitations
-    if (total_size > gpu->limits.max_mapped_size)
+    if (*total_size > gpu->limits.max_mapped_size)
         return DAV1D_ERR(ENOMEM);
 
+    return 0;
+}
+
+static inline struct pl_dav1dalloc *pl_dav1dalloc_create(pl_gpu gpu, size_t size)
+{
     pl_buf buf = pl_buf_create(gpu, pl_buf_params(
-        .size = total_size,
+        .size = size,
         .host_mapped = true,
         .memory_type = PL_BUF_MEM_HOST,
     ));
 
     if (!buf)
-        return DAV1D_ERR(ENOMEM);
+        return NULL;
 
     struct pl_dav1dalloc *alloc = malloc(sizeof(struct pl_dav1dalloc));
     if (!alloc) {
         pl_buf_destroy(gpu, &buf);
-        return DAV1D_ERR(ENOMEM);
+        return NULL;
     }
 
     *alloc = (struct pl_dav1dalloc) {
@@ -579,7 +597,22 @@ PL_DAV1D_API int pl_allocate_dav1dpicture(Dav1dPicture *p, void *cookie)
     };
 
     assert(buf->data);
-    uintptr_t base = (uintptr_t) buf->data, data[3];
+    return alloc;
+}
+
+static inline void pl_dav1dalloc_destroy(struct pl_dav1dalloc *alloc)
+{
+    assert(alloc->magic[0] == PL_MAGIC0);
+    assert(alloc->magic[1] == PL_MAGIC1);
+    pl_buf_destroy(alloc->gpu, &alloc->buf);
+    free(alloc);
+}
+
+static inline void pl_dav1dpicture_attach(Dav1dPicture *p,
+                                          struct pl_dav1dalloc *alloc,
+                                          size_t y_sz, size_t uv_sz)
+{
+    uintptr_t base = (uintptr_t) alloc->buf->data, data[3];
     data[0] = PL_ALIGN2(base, DAV1D_PICTURE_ALIGNMENT);
     data[1] = PL_ALIGN2(data[0] + y_sz, DAV1D_PICTURE_ALIGNMENT);
     data[2] = PL_ALIGN2(data[1] + uv_sz, DAV1D_PICTURE_ALIGNMENT);
@@ -588,6 +621,21 @@ PL_DAV1D_API int pl_allocate_dav1dpicture(Dav1dPicture *p, void *cookie)
     p->data[0] = (void *) data[0];
     p->data[1] = (void *) data[1];
     p->data[2] = (void *) data[2];
+}
+
+PL_DAV1D_API int pl_allocate_dav1dpicture(Dav1dPicture *p, void *cookie)
+{
+    pl_gpu gpu = cookie;
+    size_t y_sz, uv_sz, total_size;
+    int ret = pl_dav1dpicture_layout(gpu, p, &y_sz, &uv_sz, &total_size);
+    if (ret < 0)
+        return ret;
+
+    struct pl_dav1dalloc *alloc = pl_dav1dalloc_create(gpu, total_size);
+    if (!alloc)
+        return DAV1D_ERR(ENOMEM);
+
+    pl_dav1dpicture_attach(p, alloc, y_sz, uv_sz);
     return 0;
 }
 
@@ -597,17 +645,106 @@ PL_DAV1D_API void pl_release_dav1dpicture(Dav1dPicture *p, void *cookie)
     if (!alloc)
         return;
 
-    assert(alloc->magic[0] == PL_MAGIC0);
-    assert(alloc->magic[1] == PL_MAGIC1);
     assert(alloc->gpu == cookie);
-    pl_buf_destroy(alloc->gpu, &alloc->buf);
-    free(alloc);
+    pl_dav1dalloc_destroy(alloc);
+    p->data[0] = p->data[1] = p->data[2] = p->allocator_data = NULL;
+}
+
+PL_DAV1D_API pl_dav1d_pool pl_dav1d_pool_create(pl_gpu gpu)
+{
+    pl_dav1d_pool pool = malloc(sizeof(*pool));
+    if (!pool)
+        return NULL;
+
+    pool->gpu = gpu;
+    atomic_init(&pool->refcount, 1);
+    for (int i = 0; i < PL_DAV1D_POOL_SIZE; i++)
+        atomic_init(&pool->idle[i], NULL);
+    return pool;
+}
+
+static inline void pl_dav1d_pool_unref(pl_dav1d_pool pool)
+{
+    if (atomic_fetch_sub(&pool->refcount, 1) > 1)
+        return;
+
+    for (int i = 0; i < PL_DAV1D_POOL_SIZE; i++) {
+        struct pl_dav1dalloc *alloc = atomic_load(&pool->idle[i]);
+        if (alloc)
+            pl_dav1dalloc_destroy(alloc);
+    }
+
+    free(pool);
+}
 
+PL_DAV1D_API void pl_dav1d_pool_destroy(pl_dav1d_pool *ppool)
+{
+    pl_dav1d_pool pool = *ppool;
+    if (!pool)
+        return;
+
+    pl_dav1d_pool_unref(pool);
+    *ppool = NULL;
+}
+
+PL_DAV1D_API int pl_allocate_dav1dpicture_pooled(Dav1dPicture *p, void *cookie)
+{
+    pl_dav1d_pool pool = cookie;
+    pl_gpu gpu = pool->gpu;
+    size_t y_sz, uv_sz, total_size;
+    int ret = pl_dav1dpicture_layout(gpu, p, &y_sz, &uv_sz, &total_size);
+    if (ret < 0)
+        return ret;
+
+    // Try reusing an idle buffer of sufficient size, discarding any stale
+    // (too small) buffers left over from e.g. resolution changes
+    struct pl_dav1dalloc *alloc = NULL;
+    for (int i = 0; !alloc && i < PL_DAV1D_POOL_SIZE; i++) {
+        alloc = atomic_exchange(&pool->idle[i], NULL);
+        if (alloc && alloc->buf->params.size < total_size) {
+            pl_dav1dalloc_destroy(alloc);
+            alloc = NULL;
+        }
+    }
+
+    if (alloc) {
+        // Wait for any previous upload from this buffer to complete
+        while (pl_buf_poll(gpu, alloc->buf, UINT64_MAX))
+            ; // do nothing
+    } else if (!(alloc = pl_dav1dalloc_create(gpu, total_size))) {
+        return DAV1D_ERR(ENOMEM);
+    }
+
+    atomic_fetch_add(&pool->refcount, 1);
+    pl_dav1dpicture_attach(p, alloc, y_sz, uv_sz);
+    return 0;
+}
+
+PL_DAV1D_API void pl_release_dav1dpicture_pooled(Dav1dPicture *p, void *cookie)
+{
+    pl_dav1d_pool pool = cookie;
+    struct pl_dav1dalloc *alloc = p->allocator_data;
+    if (!alloc)
+        return;
+
+    assert(alloc->gpu == pool->gpu);
     p->data[0] = p->data[1] = p->data[2] = p->allocator_data = NULL;
+
+    // Return the buffer to the first free slot, or drop it if the pool is full
+    for (int i = 0; alloc && i < PL_DAV1D_POOL_SIZE; i++) {
+        struct pl_dav1dalloc *expected = NULL;
+        if (atomic_compare_exchange_strong(&pool->idle[i], &expected, alloc))
+            alloc = NULL;
+    }
+
+    if (alloc)
+        pl_dav1dalloc_destroy(alloc);
+    pl_dav1d_pool_unref(pool);
 }
 
 #undef PL_ALIGN2
 #undef PL_MAGIC0
 #undef PL_MAGIC1
+#undef PL_DAV1D_POOL_SIZE
 
 #endif // LIBPLACEBO_DAV1D_H_
@@ -29,6 +29,44 @@ PL_API_BEGIN
 PL_API void pl_hdr_metadata_from_dovi_rpu(struct pl_hdr_metadata *out,
                                           const uint8_t *buf, size_t size);
 
+// Per-stream Dolby Vision metadata state. Since DoVi metadata typically only
+// changes at scene boundaries, this remembers the result of converting the
+// most recent metadata, so identical metadata on subsequent frames can skip
+// the conversion entirely.
+//
+// Note: This object is not thread-safe, and is intended to be used for a
+// single stream at a time.
+typedef struct pl_dovi_state_t *pl_dovi_state;
+
+PL_API pl_dovi_state pl_dovi_state_create(void);
+PL_API void pl_dovi_state_destroy(pl_dovi_state *state);
+
+// Like `pl_hdr_metadata_from_dovi_rpu`, but only parses the RPU if it differs
+// from the one most recently passed to this function. Otherwise, the cached
+// brightness metadata is used. Returns whether the RPU changed.
+//
+// Note: requires `PL_HAVE_LIBDOVI` to be defined, no-op otherwise.
+PL_API bool pl_dovi_state_parse_rpu(pl_dovi_state state, struct pl_hdr_metadata *out,
+                                    const uint8_t *buf, size_t size);
+
+// Caches `pl_dovi_metadata` converted from an external representation (e.g.
+// FFmpeg's `AVDOVIMetadata`), keyed by the raw bytes of that representation.
+//
+// `pl_dovi_state_lookup` copies the cached metadata to `out` and returns true
+// if `src` matches the source of the most recently stored metadata. If it
+// returns false, the caller should convert the metadata itself, and pass the
+// result to `pl_dovi_state_store`.
+PL_API bool pl_dovi_state_lookup(pl_dovi_state state, struct pl_dovi_metadata *out,
+                                 const void *src, size_t size);
+PL_API void pl_dovi_state_store(pl_dovi_state state, const struct pl_dovi_metadata *dovi,
+                                const void *src, size_t size);
+
+// Returns a signature uniquely identifying the current metadata (RPU and
+// reshaping metadata), which stays constant for as long as the metadata does.
+// This can be used to cheaply detect scene changes, e.g. to decide whether
+// downstream state needs to be regenerated. Returns 0 if no metadata was seen.
+PL_API uint64_t pl_dovi_state_signature(pl_dovi_state state);
+
 PL_API_END
 
 #endif // LIBPLACEBO_DOLBYVISION_H_
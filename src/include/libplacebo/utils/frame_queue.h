@@ -20,6 +20,7 @@
 
 #include <libplacebo/renderer.h>
 #include <libplacebo/shaders/deinterlacing.h>
+#include <libplacebo/swapchain.h>
 
 PL_API_BEGIN
 
@@ -120,6 +121,10 @@ PL_API void pl_queue_reset(pl_queue queue);
 //
 // When no more frames are available, call this function with `frame == NULL`
 // to indicate EOF and begin draining the frame queue.
+//
+// Note: This does not normally block on any other `pl_queue_*` call, e.g. a
+// concurrent `pl_queue_update`. Pushed frames are only processed by the next
+// call that needs to inspect the queue contents.
 PL_API void pl_queue_push(pl_queue queue, const struct pl_source_frame *frame);
 
 // Variant of `pl_queue_push` that blocks while the queue is judged
@@ -179,6 +184,34 @@ struct pl_queue_params {
     enum pl_queue_status (*get_frame)(struct pl_source_frame *out_frame,
                                       const struct pl_queue_params *params);
     void *priv;
+
+    // Number of frames that may be queued in advance before being mapped,
+    // in addition to the frames required by the mixer. Higher values give
+    // slow `map` callbacks more headroom, at the cost of memory. Defaults to
+    // 2 if left as 0. (Optional)
+    int prefetch_frames;
+
+    // If true, the prefetch depth is adapted dynamically, starting at
+    // `prefetch_frames`: it grows whenever a frame misses its mapping
+    // deadline (i.e. `pl_queue_update` spent more than a vsync duration
+    // waiting on it), and slowly shrinks again while mapping is fast
+    // compared to the vsync duration. See `pl_queue_get_stats`.
+    bool adaptive_prefetch;
+
+    // Upper bound, in bytes, on the size of textures kept around for reuse
+    // by future `map` callbacks. Cached textures are bucketed by format and
+    // size, and the least recently used ones are freed first once this limit
+    // is exceeded. Textures which no longer match the frames being mapped
+    // (e.g. after a resolution change) are freed regardless. If left as 0,
+    // the cache size is not limited. (Optional)
+    size_t max_cache_size;
+
+    // If set, the vsync duration is estimated from the actual presentation
+    // timestamps reported by this swapchain (see `pl_swapchain_get_timing`),
+    // where available, instead of from the `pts` deltas between calls. This
+    // gives a much more accurate estimate, which is also unaffected by
+    // dropped frames or stalls in the render loop. (Optional)
+    pl_swapchain swapchain;
 };
 
 #define pl_queue_params(...) (&(struct pl_queue_params) { __VA_ARGS__ })
@@ -206,11 +239,41 @@ struct pl_queue_params {
 PL_API enum pl_queue_status pl_queue_update(pl_queue queue, struct pl_frame_mix *out_mix,
                                             const struct pl_queue_params *params);
 
+// Map up to `num_frames` upcoming frames (i.e. frames with a PTS after the
+// target PTS of the most recent `pl_queue_update`) ahead of time, by invoking
+// their `pl_source_frame.map` callbacks from the calling thread. Frames that
+// are already mapped count towards `num_frames`. Returns the number of frames
+// newly mapped by this call.
+//
+// This is intended to be called from a separate worker thread (or scheduled
+// on an external executor), e.g. after every `pl_queue_push` or
+// `pl_queue_update`, so that uploads are performed off the render thread.
+// `pl_queue_update` will then only pick up already-mapped frames, blocking
+// only if a frame it needs is still in the process of being mapped.
+//
+// Note: This requires the `map` callbacks (and therefore usually the
+// `pl_gpu`) to be thread-safe. Since `pl_queue_push_block` only limits the
+// number of frames that are not yet mapped, `num_frames` also bounds how far
+// ahead of the render thread the queue may grow.
+PL_API int pl_queue_map_ahead(pl_queue queue, int num_frames);
+
 // Returns a pl_queue's internal estimates for FPS and VPS (vsyncs per second).
 // Returns 0.0 if no estimate is available.
 PL_API float pl_queue_estimate_fps(pl_queue queue);
 PL_API float pl_queue_estimate_vps(pl_queue queue);
 
+struct pl_queue_stats {
+    int prefetch_frames;    // current prefetch depth
+    uint64_t mapped_frames; // total number of frames mapped
+    uint64_t missed_frames; // number of frames that missed their deadline
+    float map_latency;      // moving average of `map` latency, in seconds
+    float map_latency_max;  // highest observed `map` latency, in seconds
+};
+
+// Returns a pl_queue's internal mapping statistics. These are reset by
+// `pl_queue_reset`.
+PL_API void pl_queue_get_stats(pl_queue queue, struct pl_queue_stats *out);
+
 // Returns the number of frames currently contained in a pl_queue.
 PL_API int pl_queue_num_frames(pl_queue queue);
 
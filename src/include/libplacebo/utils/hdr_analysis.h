@@ -0,0 +1,108 @@
+/*
+ * This file is part of libplacebo.
+ *
+ * libplacebo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libplacebo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libplacebo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBPLACEBO_HDR_ANALYSIS_H
+#define LIBPLACEBO_HDR_ANALYSIS_H
+
+#include <libplacebo/renderer.h>
+
+PL_API_BEGIN
+
+// Helpers for offline, two-pass HDR analysis of file-based content. The first
+// pass measures every frame with `pl_hdr_analysis`, splits the content into
+// scenes, and serializes per-scene HDR metadata into a small text sidecar.
+// The second pass loads the sidecar with `pl_hdr_scenes_parse`, and attaches
+// the metadata of each frame's scene to its `pl_frame` using
+// `pl_hdr_scenes_apply`, which also makes the renderer skip live peak
+// detection for it (see `pl_peak_detect_params`).
+//
+// Compared to live peak detection, each scene is tone mapped as a whole,
+// with no IIR smoothing lag or flicker, and the per-frame cost of detection
+// (including the readback) disappears from the final render.
+//
+// Thread-safety: Unsafe
+typedef struct pl_hdr_analysis_t *pl_hdr_analysis;
+
+struct pl_hdr_analysis_params {
+    // Threshold for detecting scene cuts, as the difference in average
+    // brightness between two consecutive frames, in units of 1% PQ.
+    float scene_threshold;
+
+    // Brightness histogram percentile to consider as the peak of each frame,
+    // see `pl_peak_detect_params.percentile`. The peak of a scene is the
+    // highest peak among its frames.
+    float percentile;
+
+    // Pixel stride used when measuring frames, see
+    // `pl_peak_detect_params.stride`.
+    int stride;
+};
+
+#define PL_HDR_ANALYSIS_DEFAULTS    \
+    .scene_threshold    = 3.0f,     \
+    .percentile         = 99.995f,  \
+    .stride             = 4,
+
+#define pl_hdr_analysis_params(...) (&(struct pl_hdr_analysis_params) { PL_HDR_ANALYSIS_DEFAULTS __VA_ARGS__ })
+PL_API extern const struct pl_hdr_analysis_params pl_hdr_analysis_default_params;
+
+// Create a new analysis, measuring frames on `gpu`. Returns NULL on failure,
+// or if the GPU does not support peak detection (which requires compute
+// shaders and storage buffers).
+PL_API pl_hdr_analysis pl_hdr_analysis_create(pl_log log, pl_gpu gpu,
+                                              const struct pl_hdr_analysis_params *params);
+PL_API void pl_hdr_analysis_destroy(pl_hdr_analysis *analysis);
+
+// Measures the next frame of the content. Frames must be submitted in
+// presentation order, which defines their index in the sidecar (starting
+// at 0). Blocks until the measurement is complete. Returns false on failure.
+PL_API bool pl_hdr_analysis_add_frame(pl_hdr_analysis analysis,
+                                      const struct pl_frame *image);
+
+// Serializes the scenes measured so far into a text sidecar. The returned
+// string has a lifetime valid until either the next call to this function,
+// or until the `pl_hdr_analysis` is destroyed.
+PL_API const char *pl_hdr_analysis_save(pl_hdr_analysis analysis);
+
+// A single scene, i.e. range of frames sharing the same HDR metadata.
+struct pl_hdr_scene {
+    uint64_t first_frame;
+    uint64_t num_frames;
+    float max_pq_y;     // see `pl_hdr_metadata`
+    float avg_pq_y;
+};
+
+// Parsed contents of an HDR metadata sidecar, with scenes in frame order.
+typedef const struct pl_hdr_scenes_t {
+    const struct pl_hdr_scene *scenes;
+    int num_scenes;
+} *pl_hdr_scenes;
+
+// Parses a sidecar as returned by `pl_hdr_analysis_save`. Returns NULL on
+// failure.
+PL_API pl_hdr_scenes pl_hdr_scenes_parse(pl_log log, const char *str, size_t len);
+PL_API void pl_hdr_scenes_free(pl_hdr_scenes *scenes);
+
+// Looks up the scene containing frame `index`, and if found, sets the
+// `max_pq_y` and `avg_pq_y` metadata of `hdr` accordingly. Returns whether
+// a scene was found.
+PL_API bool pl_hdr_scenes_apply(pl_hdr_scenes scenes, uint64_t index,
+                                struct pl_hdr_metadata *hdr);
+
+PL_API_END
+
+#endif // LIBPLACEBO_HDR_ANALYSIS_H
@@ -21,6 +21,7 @@
 #include <libplacebo/config.h>
 #include <libplacebo/gpu.h>
 #include <libplacebo/shaders/deinterlacing.h>
+#include <libplacebo/utils/dolbyvision.h>
 #include <libplacebo/utils/upload.h>
 
 #if defined(__cplusplus) && !defined(PL_LIBAV_IMPLEMENTATION)
@@ -146,6 +147,19 @@ PL_LIBAV_API bool pl_test_pixfmt_caps(pl_gpu gpu, enum AVPixelFormat pixfmt,
 PL_LIBAV_API bool pl_frame_recreate_from_avframe(pl_gpu gpu, struct pl_frame *out_frame,
                                                  pl_tex tex[4], const AVFrame *frame);
 
+// Cache of imported hardware frame surfaces (DRM PRIME, VAAPI and Vulkan).
+// Hardware decoders cycle through a small, fixed pool of surfaces, so instead
+// of re-importing (or re-wrapping) each surface on every mapped frame, the
+// resulting textures are kept around and reused for subsequent frames backed
+// by the same surface. This holds a reference to the frames' hardware frames
+// context for as long as any of its surfaces are cached.
+//
+// Note: The cache must not be used from multiple threads at once, and must
+// only be destroyed once all frames mapped using it have been unmapped.
+typedef struct pl_avhwmap_cache_t *pl_avhwmap_cache;
+PL_LIBAV_API pl_avhwmap_cache pl_avhwmap_cache_create(pl_gpu gpu);
+PL_LIBAV_API void pl_avhwmap_cache_destroy(pl_avhwmap_cache *cache);
+
 struct pl_avframe_params {
     // The AVFrame to map. Required.
     const AVFrame *frame;
@@ -161,6 +175,14 @@ struct pl_avframe_params {
     // Also map Dolby Vision metadata (if supported). Note that this also
     // overrides the colorimetry metadata (forces BT.2020+PQ).
     bool map_dovi;
+
+    // Optional per-stream Dolby Vision state. If set, the DoVi metadata and
+    // RPU of each frame are only converted when they differ from those of the
+    // previous frame. Must only be used for frames from a single stream.
+    pl_dovi_state dovi_state;
+
+    // Optional cache of hardware frame mappings, see `pl_avhwmap_cache`.
+    pl_avhwmap_cache hwmap_cache;
 };
 
 #define PL_AVFRAME_DEFAULTS \
@@ -198,6 +220,64 @@ PL_LIBAV_API bool pl_download_avframe(pl_gpu gpu,
                                       const struct pl_frame *frame,
                                       AVFrame *out_frame);
 
+// Asynchronous variant of `pl_download_avframe`, for e.g. feeding rendered
+// frames to an encoder without stalling the GPU. Frames are downloaded into
+// a pool of persistently mapped buffers, which are directly exposed as the
+// data buffers of the resulting AVFrames and recycled once those are freed.
+// Up to `max_frames` downloads may be in flight at the same time. Requires
+// `pl_gpu_limits.buf_transfer` and mappable buffers, returns NULL otherwise.
+//
+// Note: This object is not thread-safe.
+typedef struct pl_avdownload_t *pl_avdownload;
+PL_LIBAV_API pl_avdownload pl_avdownload_create(pl_gpu gpu, int max_frames);
+
+// Waits for all pending downloads to finish and discards them. Frames already
+// returned by `pl_avdownload_get` remain valid.
+PL_LIBAV_API void pl_avdownload_destroy(pl_avdownload *dl);
+
+// Start downloading `frame` into a new AVFrame. `props` gives the pixel
+// format and dimensions of the resulting AVFrame, and all other properties
+// (e.g. timestamps, color metadata) are copied from it as well. Returns false
+// on failure, or if there are already `max_frames` downloads pending.
+//
+// Note: The same notes as for `pl_download_avframe` apply.
+PL_LIBAV_API bool pl_download_avframe_async(pl_avdownload dl,
+                                            const struct pl_frame *frame,
+                                            const AVFrame *props);
+
+// Returns the oldest pending AVFrame once its download has completed, waiting
+// up to `timeout` nanoseconds for it. Returns NULL if there are no pending
+// downloads, or the oldest one did not complete in time. The caller takes
+// ownership of the returned frame.
+PL_LIBAV_API AVFrame *pl_avdownload_get(pl_avdownload dl, uint64_t timeout);
+
+// Creates a DRM PRIME AVHWFramesContext of the given software format and
+// size, whose surfaces are backed by exportable libplacebo render targets.
+// Frames allocated from it (with `av_hwframe_get_buffer`) can be rendered to
+// directly, and passed on to e.g. VAAPI or Vulkan hardware encoders (possibly
+// via `av_hwframe_ctx_create_derived` / `av_hwframe_map`) without any copies.
+// `drm_device` optionally gives the DRM device context to attach; if NULL, a
+// standalone one is created. Requires PL_HANDLE_DMA_BUF in
+// `pl_gpu.export_caps.tex` and explicit DRM format modifier support. Returns
+// NULL on failure.
+//
+// Note: The `pl_gpu` must outlive the frames context and all of its frames.
+PL_LIBAV_API AVBufferRef *pl_avexport_frames_create(pl_gpu gpu, AVBufferRef *drm_device,
+                                                   enum AVPixelFormat sw_format,
+                                                   int width, int height);
+
+// Sets up `out_frame` as a render target for an AVFrame allocated from a
+// frames context created by `pl_avexport_frames_create`, in the same way as
+// `pl_frame_from_avframe`. The resulting textures remain valid for as long as
+// `frame` is referenced. Returns false if `frame` was not allocated this way.
+//
+// Note: libplacebo does not synchronize with the consumer of the exported
+// memory. Rendering must have completed (e.g. via `pl_gpu_finish`) before
+// `frame` is handed off, and the consumer must be done with it before the
+// same surface is rendered to again.
+PL_LIBAV_API bool pl_frame_from_avexport(struct pl_frame *out_frame,
+                                         const AVFrame *frame);
+
 // Helper functions to update the colorimetry data in an AVFrame based on
 // the values specified in the given color space / color repr / profile.
 //
@@ -229,12 +309,32 @@ PL_LIBAV_API int pl_plane_data_from_pixfmt(struct pl_plane_data data[4],
 // Callback for AVCodecContext.get_buffer2 that allocates memory from
 // persistently mapped buffers. This can be more efficient than regular
 // system memory, especially on platforms that don't support importing
-// PL_HANDLE_HOST_PTR as buffers.
+// PL_HANDLE_HOST_PTR as buffers. All planes of a frame share a single
+// buffer. This requires a thread-safe `pl_gpu` with host-cached, mappable
+// buffers, and falls back to `avcodec_default_get_buffer2` otherwise.
 //
 // Note: `avctx->opaque` must be a pointer that *points* to the GPU instance.
 // That is, it should have type `pl_gpu *`.
 PL_LIBAV_API int pl_get_buffer2(AVCodecContext *avctx, AVFrame *pic, int flags);
 
+// Pool of persistently mapped buffers, for use with `pl_get_buffer2_pooled`.
+// Buffers are recycled across frames instead of being created and destroyed
+// for every decoded picture, and the pool is transparently re-sized whenever
+// the required buffer size changes (e.g. on resolution changes). There
+// should be one pool per AVCodecContext.
+typedef struct pl_avbuf_pool_t *pl_avbuf_pool;
+PL_LIBAV_API pl_avbuf_pool pl_avbuf_pool_create(pl_gpu gpu);
+
+// Frames allocated from the pool may safely outlive it, their buffers are
+// released once the last reference is dropped.
+PL_LIBAV_API void pl_avbuf_pool_destroy(pl_avbuf_pool *pool);
+
+// Variant of `pl_get_buffer2` that allocates from a `pl_avbuf_pool`, and has
+// otherwise identical semantics and requirements.
+//
+// Note: `avctx->opaque` must be the `pl_avbuf_pool` instance itself.
+PL_LIBAV_API int pl_get_buffer2_pooled(AVCodecContext *avctx, AVFrame *pic, int flags);
+
 // Mapping functions for the various libavutil enums. Note that these are not
 // quite 1:1, and even for values that exist in both, the semantics sometimes
 // differ. Some special cases (e.g. ICtCp, or XYZ) are handled differently in
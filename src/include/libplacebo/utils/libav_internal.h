@@ -500,15 +500,18 @@ PL_LIBAV_API int pl_plane_data_from_pixfmt(struct pl_plane_data out_data[4],
             const AVComponentDescriptor *comp = &desc->comp[c];
             if (comp->plane != p)
                 continue;
-            if (data->swapped && comp->shift) {
-                // We cannot naively handle packed big endian formats because
-                // swapping the words also swaps the component order, so just
-                // exit out as a stupid safety measure
-                return 0;
-            }
-
             size[c] = comp->depth;
             shift[c] = comp->shift + comp->offset * 8;
+            if (data->swapped && comp->shift) {
+                // Packed big endian formats are swapped as whole pixels, so
+                // convert the offset of the big endian read into a position
+                // within the native endian pixel word
+                if (comp->step != 2 && comp->step != 4)
+                    return 0;
+                int read = comp->shift + comp->depth <= 8  ? 1 :
+                           comp->shift + comp->depth <= 16 ? 2 : 4;
+                shift[c] = comp->shift + (comp->step - comp->offset - read) * 8;
+            }
 
             if (data->pixel_stride && (int) data->pixel_stride != comp->step) {
                 // Pixel format contains components with different pixel stride
@@ -886,28 +889,33 @@ PL_LIBAV_API void pl_map_dovi_metadata(struct pl_dovi_metadata *out,
     }
 }
 
+static void pl_frame_set_avdovi(struct pl_frame *out_frame,
+                                const struct pl_dovi_metadata *dovi,
+                                const AVDOVIMetadata *metadata)
+{
+    const AVDOVIColorMetadata *color = av_dovi_get_color(metadata);
+    out_frame->repr.dovi = dovi;
+    out_frame->repr.sys = PL_COLOR_SYSTEM_DOLBYVISION;
+    out_frame->color.primaries = PL_COLOR_PRIM_BT_2020;
+    out_frame->color.transfer = PL_COLOR_TRC_PQ;
+    out_frame->color.hdr.min_luma =
+        pl_hdr_rescale(PL_HDR_PQ, PL_HDR_NITS, color->source_min_pq / 4095.0f);
+    out_frame->color.hdr.max_luma =
+        pl_hdr_rescale(PL_HDR_PQ, PL_HDR_NITS, color->source_max_pq / 4095.0f);
+}
+
 PL_LIBAV_API void pl_frame_map_avdovi_metadata(struct pl_frame *out_frame,
                                                struct pl_dovi_metadata *dovi,
                                                const AVDOVIMetadata *metadata)
 {
     const AVDOVIRpuDataHeader *header;
-    const AVDOVIColorMetadata *color;
     if (!dovi || !metadata)
         return;
 
     header = av_dovi_get_header(metadata);
-    color = av_dovi_get_color(metadata);
     if (header->disable_residual_flag) {
         pl_map_dovi_metadata(dovi, metadata);
-
-        out_frame->repr.dovi = dovi;
-        out_frame->repr.sys = PL_COLOR_SYSTEM_DOLBYVISION;
-        out_frame->color.primaries = PL_COLOR_PRIM_BT_2020;
-        out_frame->color.transfer = PL_COLOR_TRC_PQ;
-        out_frame->color.hdr.min_luma =
-            pl_hdr_rescale(PL_HDR_PQ, PL_HDR_NITS, color->source_min_pq / 4095.0f);
-        out_frame->color.hdr.max_luma =
-            pl_hdr_rescale(PL_HDR_PQ, PL_HDR_NITS, color->source_max_pq / 4095.0f);
+        pl_frame_set_avdovi(out_frame, dovi, metadata);
     }
 }
 #endif // PL_HAVE_LAV_DOLBY_VISION
@@ -951,6 +959,36 @@ struct pl_avalloc {
     uint32_t magic[2];
     pl_gpu gpu;
     pl_buf buf;
+    AVBufferRef *pooled; // reference to `buf` held from a `pl_avbuf_pool`
+};
+
+struct pl_avbuf_pool_t {
+    pl_gpu gpu;
+    AVBufferPool *pool;
+    size_t size;
+    bool storable;
+};
+
+// Configuration of an individual AVBufferPool, freed along with it
+struct pl_avbuf_pool_cfg {
+    pl_gpu gpu;
+    bool storable;
+};
+
+#define PL_AVHWMAP_CACHE_SIZE 64
+
+struct pl_avhwmap_entry {
+    AVBufferRef *hwfc; // NULL = unused entry
+    const void *surface;
+    uintptr_t extra;
+    pl_tex tex[4];
+    pl_tex planar;
+    int refs; // number of currently mapped frames using this entry
+};
+
+struct pl_avhwmap_cache_t {
+    pl_gpu gpu;
+    struct pl_avhwmap_entry entries[PL_AVHWMAP_CACHE_SIZE];
 };
 
 // Attached to `pl_frame.user_data` for mapped AVFrames
@@ -958,8 +996,118 @@ struct pl_avframe_priv {
     AVFrame *avframe;
     struct pl_dovi_metadata dovi; // backing storage for per-frame dovi metadata
     pl_tex planar; // for planar vulkan textures
+    struct pl_avhwmap_entry *hwmap; // textures owned by a `pl_avhwmap_cache`
 };
 
+PL_LIBAV_API pl_avhwmap_cache pl_avhwmap_cache_create(pl_gpu gpu)
+{
+    pl_avhwmap_cache cache = calloc(1, sizeof(*cache));
+    if (!cache)
+        return NULL;
+
+    cache->gpu = gpu;
+    return cache;
+}
+
+static void pl_avhwmap_entry_free(pl_gpu gpu, struct pl_avhwmap_entry *entry)
+{
+    assert(!entry->refs);
+    if (entry->planar) {
+        pl_tex_destroy(gpu, &entry->planar);
+    } else {
+        for (int i = 0; i < 4; i++)
+            pl_tex_destroy(gpu, &entry->tex[i]);
+    }
+
+    av_buffer_unref(&entry->hwfc);
+    memset(entry, 0, sizeof(*entry));
+}
+
+PL_LIBAV_API void pl_avhwmap_cache_destroy(pl_avhwmap_cache *pcache)
+{
+    pl_avhwmap_cache cache = *pcache;
+    if (!cache)
+        return;
+
+    for (int i = 0; i < PL_AVHWMAP_CACHE_SIZE; i++) {
+        if (cache->entries[i].hwfc)
+            pl_avhwmap_entry_free(cache->gpu, &cache->entries[i]);
+    }
+
+    free(cache);
+    *pcache = NULL;
+}
+
+// Looks up the textures for a given surface of `frame->hw_frames_ctx`, and
+// attaches them to `out` if found
+static bool pl_avhwmap_get(pl_avhwmap_cache cache, struct pl_frame *out,
+                           const AVFrame *frame, const void *surface,
+                           uintptr_t extra)
+{
+    struct pl_avframe_priv *priv = out->user_data;
+    if (!cache)
+        return false;
+
+    for (int i = 0; i < PL_AVHWMAP_CACHE_SIZE; i++) {
+        struct pl_avhwmap_entry *entry = &cache->entries[i];
+        if (!entry->hwfc || entry->hwfc->data != frame->hw_frames_ctx->data)
+            continue;
+        if (entry->surface != surface || entry->extra != extra)
+            continue;
+
+        for (int n = 0; n < out->num_planes; n++)
+            out->planes[n].texture = entry->tex[n];
+        priv->planar = entry->planar;
+        priv->hwmap = entry;
+        entry->refs++;
+        return true;
+    }
+
+    return false;
+}
+
+// Hands ownership of the freshly imported textures of `out` over to the cache
+static void pl_avhwmap_put(pl_avhwmap_cache cache, struct pl_frame *out,
+                           const AVFrame *frame, const void *surface,
+                           uintptr_t extra)
+{
+    struct pl_avframe_priv *priv = out->user_data;
+    if (!cache)
+        return;
+
+    struct pl_avhwmap_entry *entry = NULL;
+    for (int i = 0; i < PL_AVHWMAP_CACHE_SIZE; i++) {
+        struct pl_avhwmap_entry *e = &cache->entries[i];
+        if (!e->hwfc) {
+            entry = PL_DEF(entry, e);
+        } else if (!e->refs && e->hwfc->data != frame->hw_frames_ctx->data) {
+            // Evict unused surfaces of previous frames contexts
+            pl_avhwmap_entry_free(cache->gpu, e);
+            entry = PL_DEF(entry, e);
+        }
+    }
+
+    if (!entry)
+        return; // cache full, textures remain owned by the frame
+
+    *entry = (struct pl_avhwmap_entry) {
+        .hwfc = av_buffer_ref(frame->hw_frames_ctx),
+        .surface = surface,
+        .extra = extra,
+        .planar = priv->planar,
+        .refs = 1,
+    };
+
+    if (!entry->hwfc) {
+        memset(entry, 0, sizeof(*entry));
+        return;
+    }
+
+    for (int n = 0; n < out->num_planes; n++)
+        entry->tex[n] = out->planes[n].texture;
+    priv->hwmap = entry;
+}
+
 static void pl_fix_hwframe_sample_depth(struct pl_frame *out, const AVFrame *frame)
 {
     const AVHWFramesContext *hwfc = (AVHWFramesContext *) frame->hw_frames_ctx->data;
@@ -974,8 +1122,11 @@ static void pl_fix_hwframe_sample_depth(struct pl_frame *out, const AVFrame *fra
     }
 }
 
+// `src` is the frame used to identify the surface in `cache`, which differs
+// from `frame` for DRM frames derived from other hwaccel formats
 static bool pl_map_avframe_drm(pl_gpu gpu, struct pl_frame *out,
-                               const AVFrame *frame)
+                               const AVFrame *frame, pl_avhwmap_cache cache,
+                               const AVFrame *src)
 {
     const AVHWFramesContext *hwfc = (AVHWFramesContext *) frame->hw_frames_ctx->data;
     const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(hwfc->sw_format);
@@ -984,6 +1135,16 @@ static bool pl_map_avframe_drm(pl_gpu gpu, struct pl_frame *out,
     if (!(gpu->import_caps.tex & PL_HANDLE_DMA_BUF))
         return false;
 
+    // Native DRM frames are identified by their (pooled) descriptor, derived
+    // frames by the surface they were derived from
+    const bool native = src->format == AV_PIX_FMT_DRM_PRIME;
+    const void *surface = native ? (const void *) drm : (const void *) src->data[3];
+    const uintptr_t extra = native ? (uintptr_t) drm->objects[0].fd : 0;
+    if (pl_avhwmap_get(cache, out, src, surface, extra)) {
+        pl_fix_hwframe_sample_depth(out, frame);
+        return true;
+    }
+
     assert(drm->nb_layers >= out->num_planes);
     for (int n = 0; n < out->num_planes; n++) {
         const AVDRMLayerDescriptor *layer = &drm->layers[n];
@@ -1016,12 +1177,13 @@ static bool pl_map_avframe_drm(pl_gpu gpu, struct pl_frame *out,
     }
 
     pl_fix_hwframe_sample_depth(out, frame);
+    pl_avhwmap_put(cache, out, src, surface, extra);
     return true;
 }
 
 // Derive a DMABUF from any other hwaccel format, and map that instead
 static bool pl_map_avframe_derived(pl_gpu gpu, struct pl_frame *out,
-                                   const AVFrame *frame)
+                                   const AVFrame *frame, pl_avhwmap_cache cache)
 {
     const int flags = AV_HWFRAME_MAP_READ | AV_HWFRAME_MAP_DIRECT;
     struct pl_avframe_priv *priv = out->user_data;
@@ -1034,7 +1196,9 @@ static bool pl_map_avframe_derived(pl_gpu gpu, struct pl_frame *out,
         goto error;
     if (av_frame_copy_props(derived, frame) < 0)
         goto error;
-    if (!pl_map_avframe_drm(gpu, out, derived))
+    // Note: The mapping is still required on cache hits, since it also
+    // synchronizes the surface with the decoder
+    if (!pl_map_avframe_drm(gpu, out, derived, cache, frame))
         goto error;
 
     av_frame_free(&priv->avframe);
@@ -1109,7 +1273,7 @@ static void pl_release_avframe(pl_gpu gpu, struct pl_frame *frame)
 }
 
 static bool pl_map_avframe_vulkan(pl_gpu gpu, struct pl_frame *out,
-                                  const AVFrame *frame)
+                                  const AVFrame *frame, pl_avhwmap_cache cache)
 {
     const AVHWFramesContext *hwfc = (AVHWFramesContext *) frame->hw_frames_ctx->data;
     const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(hwfc->sw_format);
@@ -1129,6 +1293,10 @@ static bool pl_map_avframe_vulkan(pl_gpu gpu, struct pl_frame *out,
     if (!vk)
         return false;
 
+    const uintptr_t img = (uintptr_t) vkf->img[0];
+    if (pl_avhwmap_get(cache, out, frame, vkf, img))
+        goto done;
+
     for (int n = 0; n < out->num_planes; n++) {
         struct pl_plane *plane = &out->planes[n];
         bool chroma = n == 1 || n == 2;
@@ -1155,6 +1323,9 @@ static bool pl_map_avframe_vulkan(pl_gpu gpu, struct pl_frame *out,
         }
     }
 
+    pl_avhwmap_put(cache, out, frame, vkf, img);
+
+done:
     out->acquire = pl_acquire_avframe;
     out->release = pl_release_avframe;
     pl_fix_hwframe_sample_depth(out, frame);
@@ -1164,7 +1335,7 @@ static bool pl_map_avframe_vulkan(pl_gpu gpu, struct pl_frame *out,
 static void pl_unmap_avframe_vulkan(pl_gpu gpu, struct pl_frame *frame)
 {
     struct pl_avframe_priv *priv = frame->user_data;
-    if (priv->planar) {
+    if (priv->planar && !priv->hwmap) {
         pl_tex_destroy(gpu, &priv->planar);
         for (int n = 0; n < frame->num_planes; n++)
             frame->planes[n].texture = NULL;
@@ -1187,6 +1358,8 @@ PL_LIBAV_API bool pl_map_avframe_ex(pl_gpu gpu, struct pl_frame *out,
 
     pl_frame_from_avframe(out, frame);
     priv->avframe = av_frame_clone(frame);
+    priv->planar = NULL;
+    priv->hwmap = NULL;
     out->user_data = priv;
 
 #ifdef PL_HAVE_LAV_DOLBY_VISION
@@ -1196,14 +1369,28 @@ PL_LIBAV_API bool pl_map_avframe_ex(pl_gpu gpu, struct pl_frame *out,
             const AVDOVIMetadata *metadata = (AVDOVIMetadata *) sd->data;
             const AVDOVIRpuDataHeader *header = av_dovi_get_header(metadata);
             // Only automatically map DoVi RPUs that don't require an EL
-            if (header->disable_residual_flag)
+            if (header->disable_residual_flag && params->dovi_state) {
+                // Copied into per-frame storage, since queued frames may
+                // outlive the metadata cached in the state
+                pl_dovi_state state = params->dovi_state;
+                if (!pl_dovi_state_lookup(state, &priv->dovi, sd->data, sd->size)) {
+                    pl_map_dovi_metadata(&priv->dovi, metadata);
+                    pl_dovi_state_store(state, &priv->dovi, sd->data, sd->size);
+                }
+                pl_frame_set_avdovi(out, &priv->dovi, metadata);
+            } else if (header->disable_residual_flag) {
                 pl_frame_map_avdovi_metadata(out, &priv->dovi, metadata);
+            }
         }
 
 #ifdef PL_HAVE_LIBDOVI
         sd = av_frame_get_side_data(frame, AV_FRAME_DATA_DOVI_RPU_BUFFER);
-        if (sd)
+        if (sd && params->dovi_state) {
+            pl_dovi_state_parse_rpu(params->dovi_state, &out->color.hdr,
+                                    sd->buf->data, sd->buf->size);
+        } else if (sd) {
             pl_hdr_metadata_from_dovi_rpu(&out->color.hdr, sd->buf->data, sd->buf->size);
+        }
 #endif // PL_HAVE_LIBDOVI
     }
 
@@ -1211,18 +1398,18 @@ PL_LIBAV_API bool pl_map_avframe_ex(pl_gpu gpu, struct pl_frame *out,
 
     switch (frame->format) {
     case AV_PIX_FMT_DRM_PRIME:
-        if (!pl_map_avframe_drm(gpu, out, frame))
+        if (!pl_map_avframe_drm(gpu, out, frame, params->hwmap_cache, frame))
             goto error;
         return true;
 
     case AV_PIX_FMT_VAAPI:
-        if (!pl_map_avframe_derived(gpu, out, frame))
+        if (!pl_map_avframe_derived(gpu, out, frame, params->hwmap_cache))
             goto error;
         return true;
 
 #ifdef PL_HAVE_LAV_VULKAN
     case AV_PIX_FMT_VULKAN:
-        if (!pl_map_avframe_vulkan(gpu, out, frame))
+        if (!pl_map_avframe_vulkan(gpu, out, frame, params->hwmap_cache))
             goto error;
         return true;
 #endif
@@ -1303,7 +1490,10 @@ PL_LIBAV_API void pl_unmap_avframe(pl_gpu gpu, struct pl_frame *frame)
 #endif
 
     desc = av_pix_fmt_desc_get(priv->avframe->format);
-    if (desc->flags & AV_PIX_FMT_FLAG_HWACCEL) {
+    if (priv->hwmap) {
+        // Textures are owned by the cache
+        priv->hwmap->refs--;
+    } else if (desc->flags & AV_PIX_FMT_FLAG_HWACCEL) {
         for (int i = 0; i < 4; i++)
             pl_tex_destroy(gpu, &frame->planes[i].texture);
     }
@@ -1368,11 +1558,106 @@ static inline void pl_avalloc_free(void *opaque, uint8_t *data)
     assert(alloc->magic[0] == PL_MAGIC0);
     assert(alloc->magic[1] == PL_MAGIC1);
     assert(alloc->buf->data == data);
-    pl_buf_destroy(alloc->gpu, &alloc->buf);
+    if (alloc->pooled) {
+        av_buffer_unref(&alloc->pooled); // returns `buf` to the pool
+    } else {
+        pl_buf_destroy(alloc->gpu, &alloc->buf);
+    }
     free(alloc);
 }
 
-PL_LIBAV_API int pl_get_buffer2(AVCodecContext *avctx, AVFrame *pic, int flags)
+// The pooled AVBufferRefs hold the `pl_buf` handle itself as their data
+static inline void pl_avbuf_pool_buf_free(void *opaque, uint8_t *data)
+{
+    struct pl_avbuf_pool_cfg *cfg = opaque;
+    pl_buf buf = (pl_buf) data;
+    pl_buf_destroy(cfg->gpu, &buf);
+}
+
+#if LIBAVUTIL_VERSION_MAJOR >= 57
+static inline AVBufferRef *pl_avbuf_pool_alloc(void *opaque, size_t size)
+#else
+static inline AVBufferRef *pl_avbuf_pool_alloc(void *opaque, int size)
+#endif
+{
+    struct pl_avbuf_pool_cfg *cfg = opaque;
+    pl_buf buf = pl_buf_create(cfg->gpu, pl_buf_params(
+        .size = size,
+        .memory_type = PL_BUF_MEM_HOST,
+        .host_mapped = true,
+        .storable = cfg->storable,
+    ));
+
+    if (!buf)
+        return NULL;
+
+    AVBufferRef *ref = av_buffer_create((uint8_t *) buf, sizeof(*buf),
+                                        pl_avbuf_pool_buf_free, cfg, 0);
+    if (!ref)
+        pl_buf_destroy(cfg->gpu, &buf);
+    return ref;
+}
+
+static inline void pl_avbuf_pool_cfg_free(void *opaque)
+{
+    free(opaque);
+}
+
+PL_LIBAV_API pl_avbuf_pool pl_avbuf_pool_create(pl_gpu gpu)
+{
+    pl_avbuf_pool pool = calloc(1, sizeof(*pool));
+    if (!pool)
+        return NULL;
+
+    pool->gpu = gpu;
+    return pool;
+}
+
+PL_LIBAV_API void pl_avbuf_pool_destroy(pl_avbuf_pool *ppool)
+{
+    pl_avbuf_pool pool = *ppool;
+    if (!pool)
+        return;
+
+    av_buffer_pool_uninit(&pool->pool);
+    free(pool);
+    *ppool = NULL;
+}
+
+// Returns a reference to a `pl_buf` of the given size from `pool`, re-creating
+// the underlying AVBufferPool if its parameters no longer match
+static inline AVBufferRef *pl_avbuf_pool_get(pl_avbuf_pool pool, size_t size,
+                                             bool storable)
+{
+    if (!pool->pool || pool->size != size || pool->storable != storable) {
+        // Outstanding buffers of the old pool are freed when released
+        av_buffer_pool_uninit(&pool->pool);
+        struct pl_avbuf_pool_cfg *cfg = malloc(sizeof(*cfg));
+        if (!cfg)
+            return NULL;
+
+        *cfg = (struct pl_avbuf_pool_cfg) {
+            .gpu = pool->gpu,
+            .storable = storable,
+        };
+
+        pool->pool = av_buffer_pool_init2(size, cfg, pl_avbuf_pool_alloc,
+                                          pl_avbuf_pool_cfg_free);
+        if (!pool->pool) {
+            free(cfg);
+            return NULL;
+        }
+
+        pool->size = size;
+        pool->storable = storable;
+    }
+
+    return av_buffer_pool_get(pool->pool);
+}
+
+static inline int pl_get_buffer2_internal(AVCodecContext *avctx, AVFrame *pic,
+                                          int flags, pl_gpu gpu,
+                                          pl_avbuf_pool pool)
 {
     int alignment[AV_NUM_DATA_POINTERS];
     int width = pic->width;
@@ -1380,8 +1665,6 @@ PL_LIBAV_API int pl_get_buffer2(AVCodecContext *avctx, AVFrame *pic, int flags)
     size_t planesize[4];
     int ret = 0;
 
-    pl_gpu *pgpu = avctx->opaque;
-    pl_gpu gpu = pgpu ? *pgpu : NULL;
     struct pl_plane_data data[4];
     struct pl_avalloc *alloc;
     const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(pic->format);
@@ -1428,44 +1711,67 @@ PL_LIBAV_API int pl_get_buffer2(AVCodecContext *avctx, AVFrame *pic, int flags)
         planesize[p] = (uintptr_t) ptrs[p] - (uintptr_t) base;
 #endif
 
-    for (int p = 0; p < planes; p++) {
-        const size_t buf_size = planesize[p] + alignment[p];
-        if (buf_size > gpu->limits.max_mapped_size) {
-            av_frame_unref(pic);
-            goto fallback;
-        }
+    // Allocate all planes from a single buffer, to avoid the overhead of
+    // creating (and later destroying) a separate `pl_buf` for every plane
+    size_t buf_size = 0;
+    for (int p = 0; p < planes; p++)
+        buf_size += planesize[p] + alignment[p]; // include alignment slack
+    if (buf_size > gpu->limits.max_mapped_size) {
+        av_frame_unref(pic);
+        goto fallback;
+    }
 
-        alloc = malloc(sizeof(*alloc));
-        if (!alloc) {
-            av_frame_unref(pic);
-            return AVERROR(ENOMEM);
-        }
+    alloc = malloc(sizeof(*alloc));
+    if (!alloc) {
+        av_frame_unref(pic);
+        return AVERROR(ENOMEM);
+    }
 
-        *alloc = (struct pl_avalloc) {
-            .magic = { PL_MAGIC0, PL_MAGIC1 },
-            .gpu = gpu,
-            .buf = pl_buf_create(gpu, pl_buf_params(
-                .size = buf_size,
-                .memory_type = PL_BUF_MEM_HOST,
-                .host_mapped = true,
-                .storable = desc->flags & AV_PIX_FMT_FLAG_BE,
-            )),
-        };
+    const bool storable = desc->flags & AV_PIX_FMT_FLAG_BE;
+    *alloc = (struct pl_avalloc) {
+        .magic = { PL_MAGIC0, PL_MAGIC1 },
+        .gpu = gpu,
+    };
 
-        if (!alloc->buf) {
-            free(alloc);
-            av_frame_unref(pic);
-            return AVERROR(ENOMEM);
-        }
+    if (pool) {
+        alloc->pooled = pl_avbuf_pool_get(pool, buf_size, storable);
+        alloc->buf = alloc->pooled ? (pl_buf) alloc->pooled->data : NULL;
+
+        // Recycled buffers may still be in use by a previous upload
+        while (alloc->buf && pl_buf_poll(gpu, alloc->buf, UINT64_MAX))
+            ; // do nothing
+    } else {
+        alloc->buf = pl_buf_create(gpu, pl_buf_params(
+            .size = buf_size,
+            .memory_type = PL_BUF_MEM_HOST,
+            .host_mapped = true,
+            .storable = storable,
+        ));
+    }
 
-        pic->data[p] = (uint8_t *) PL_ALIGN((uintptr_t) alloc->buf->data, alignment[p]);
-        pic->buf[p] = av_buffer_create(alloc->buf->data, buf_size, pl_avalloc_free, alloc, 0);
-        if (!pic->buf[p]) {
+    if (!alloc->buf) {
+        free(alloc);
+        av_frame_unref(pic);
+        return AVERROR(ENOMEM);
+    }
+
+    uint8_t *ptr = alloc->buf->data;
+    for (int p = 0; p < planes; p++) {
+        pic->data[p] = (uint8_t *) PL_ALIGN((uintptr_t) ptr, alignment[p]);
+        ptr = pic->data[p] + planesize[p];
+    }
+
+    assert(ptr <= alloc->buf->data + buf_size);
+    pic->buf[0] = av_buffer_create(alloc->buf->data, buf_size, pl_avalloc_free, alloc, 0);
+    if (!pic->buf[0]) {
+        if (alloc->pooled) {
+            av_buffer_unref(&alloc->pooled);
+        } else {
             pl_buf_destroy(gpu, &alloc->buf);
-            free(alloc);
-            av_frame_unref(pic);
-            return AVERROR(ENOMEM);
         }
+        free(alloc);
+        av_frame_unref(pic);
+        return AVERROR(ENOMEM);
     }
 
     return 0;
@@ -1474,6 +1780,356 @@ fallback:
     return avcodec_default_get_buffer2(avctx, pic, flags);
 }
 
+PL_LIBAV_API int pl_get_buffer2(AVCodecContext *avctx, AVFrame *pic, int flags)
+{
+    pl_gpu *pgpu = avctx->opaque;
+    return pl_get_buffer2_internal(avctx, pic, flags, pgpu ? *pgpu : NULL, NULL);
+}
+
+PL_LIBAV_API int pl_get_buffer2_pooled(AVCodecContext *avctx, AVFrame *pic, int flags)
+{
+    // Note: get_buffer2 is never called from more than one thread at once,
+    // so the pool itself needs no locking. Buffers may be released from any
+    // thread, which AVBufferPool handles internally.
+    pl_avbuf_pool pool = avctx->opaque;
+    return pl_get_buffer2_internal(avctx, pic, flags, pool ? pool->gpu : NULL, pool);
+}
+
+struct pl_avdownload_t {
+    pl_gpu gpu;
+    pl_avbuf_pool pool;
+    int max_frames;
+    int head, num; // ring of pending downloads
+    struct pl_avdownload_entry {
+        AVFrame *frame;
+        pl_buf buf;
+    } *pending;
+};
+
+PL_LIBAV_API pl_avdownload pl_avdownload_create(pl_gpu gpu, int max_frames)
+{
+    if (!gpu->limits.buf_transfer || !gpu->limits.max_mapped_size || max_frames < 1)
+        return NULL;
+
+    pl_avdownload dl = calloc(1, sizeof(*dl));
+    if (!dl)
+        return NULL;
+
+    dl->gpu = gpu;
+    dl->max_frames = max_frames;
+    dl->pool = pl_avbuf_pool_create(gpu);
+    dl->pending = calloc(max_frames, sizeof(*dl->pending));
+    if (!dl->pool || !dl->pending) {
+        pl_avdownload_destroy(&dl);
+        return NULL;
+    }
+
+    return dl;
+}
+
+PL_LIBAV_API void pl_avdownload_destroy(pl_avdownload *pdl)
+{
+    pl_avdownload dl = *pdl;
+    if (!dl)
+        return;
+
+    AVFrame *frame;
+    while (dl->num && (frame = pl_avdownload_get(dl, UINT64_MAX)))
+        av_frame_free(&frame);
+
+    pl_avbuf_pool_destroy(&dl->pool);
+    free(dl->pending);
+    free(dl);
+    *pdl = NULL;
+}
+
+PL_LIBAV_API bool pl_download_avframe_async(pl_avdownload dl,
+                                            const struct pl_frame *frame,
+                                            const AVFrame *props)
+{
+    pl_gpu gpu = dl->gpu;
+    size_t offset[4], linesize[4], buf_size = 0;
+    if (dl->num == dl->max_frames)
+        return false;
+    if (frame->num_planes != av_pix_fmt_count_planes(props->format))
+        return false;
+
+    // Lay out all planes in a single buffer, respecting the GPU's transfer
+    // alignment requirements
+    for (int p = 0; p < frame->num_planes; p++) {
+        pl_tex tex = frame->planes[p].texture;
+        const size_t texel = tex->params.format->texel_size;
+        const int pitch_align = PL_LCM(PL_MAX(gpu->limits.align_tex_xfer_pitch, 1), texel);
+        const int off_align = PL_LCM(PL_MAX(gpu->limits.align_tex_xfer_offset, 1),
+                                     PL_LCM(texel, 64));
+        linesize[p] = PL_ALIGN(tex->params.w * texel, pitch_align);
+        offset[p] = PL_ALIGN(buf_size, off_align);
+        buf_size = offset[p] + linesize[p] * tex->params.h;
+    }
+
+    if (buf_size > gpu->limits.max_mapped_size)
+        return false;
+
+    pl_buf buf = NULL;
+    struct pl_avalloc *alloc = malloc(sizeof(*alloc));
+    AVFrame *out = av_frame_alloc();
+    if (!alloc || !out)
+        goto error;
+
+    *alloc = (struct pl_avalloc) {
+        .magic = { PL_MAGIC0, PL_MAGIC1 },
+        .gpu = gpu,
+        .pooled = pl_avbuf_pool_get(dl->pool, buf_size, false),
+    };
+
+    if (!alloc->pooled)
+        goto error;
+
+    buf = alloc->buf = (pl_buf) alloc->pooled->data;
+    out->buf[0] = av_buffer_create(buf->data, buf_size, pl_avalloc_free, alloc, 0);
+    if (!out->buf[0]) {
+        av_buffer_unref(&alloc->pooled);
+        buf = NULL;
+        goto error;
+    }
+    alloc = NULL; // now owned by `out`
+
+    if (av_frame_copy_props(out, props) < 0)
+        goto error;
+
+    out->format = props->format;
+    out->width = props->width;
+    out->height = props->height;
+    for (int p = 0; p < frame->num_planes; p++) {
+        out->data[p] = buf->data + offset[p];
+        out->linesize[p] = linesize[p];
+        bool ok = pl_tex_download(gpu, pl_tex_transfer_params(
+            .tex        = frame->planes[p].texture,
+            .row_pitch  = linesize[p],
+            .buf        = buf,
+            .buf_offset = offset[p],
+        ));
+
+        if (!ok)
+            goto error;
+    }
+
+    dl->pending[(dl->head + dl->num++) % dl->max_frames] = (struct pl_avdownload_entry) {
+        .frame  = out,
+        .buf    = buf,
+    };
+    return true;
+
+error:
+    // Wait for any partially submitted downloads before recycling the buffer
+    while (buf && pl_buf_poll(gpu, buf, UINT64_MAX))
+        ; // do nothing
+    av_frame_free(&out);
+    free(alloc);
+    return false;
+}
+
+PL_LIBAV_API AVFrame *pl_avdownload_get(pl_avdownload dl, uint64_t timeout)
+{
+    if (!dl->num)
+        return NULL;
+
+    struct pl_avdownload_entry *entry = &dl->pending[dl->head];
+    if (pl_buf_poll(dl->gpu, entry->buf, timeout))
+        return NULL; // still in use
+
+    AVFrame *frame = entry->frame;
+    *entry = (struct pl_avdownload_entry) {0};
+    dl->head = (dl->head + 1) % dl->max_frames;
+    dl->num--;
+    return frame;
+}
+
+// Backing storage of a surface of a `pl_avexport_frames_create` context
+struct pl_avexport_surface {
+    AVDRMFrameDescriptor drm; // must be the first member
+    uint32_t magic[2];
+    pl_gpu gpu;
+    pl_tex tex[4];
+};
+
+// Configuration of the surface pool, freed along with it
+struct pl_avexport_cfg {
+    pl_gpu gpu;
+    enum AVPixelFormat sw_format;
+    int width, height;
+};
+
+static inline void pl_avexport_surface_free(void *opaque, uint8_t *data)
+{
+    struct pl_avexport_surface *surf = (struct pl_avexport_surface *) data;
+    for (int i = 0; i < 4; i++)
+        pl_tex_destroy(surf->gpu, &surf->tex[i]);
+    free(surf);
+}
+
+#if LIBAVUTIL_VERSION_MAJOR >= 57
+static inline AVBufferRef *pl_avexport_surface_alloc(void *opaque, size_t size)
+#else
+static inline AVBufferRef *pl_avexport_surface_alloc(void *opaque, int size)
+#endif
+{
+    const struct pl_avexport_cfg *cfg = opaque;
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(cfg->sw_format);
+    pl_gpu gpu = cfg->gpu;
+    struct pl_plane_data data[4];
+    struct pl_bit_encoding bits;
+    int planes = pl_plane_data_from_pixfmt(data, &bits, cfg->sw_format);
+    if (!planes)
+        return NULL;
+
+    struct pl_avexport_surface *surf = calloc(1, sizeof(*surf));
+    if (!surf)
+        return NULL;
+
+    surf->magic[0] = PL_MAGIC0;
+    surf->magic[1] = PL_MAGIC1;
+    surf->gpu = gpu;
+    surf->drm.nb_objects = planes;
+    surf->drm.nb_layers = planes;
+    for (int p = 0; p < planes; p++) {
+        int map[4];
+        pl_fmt fmt = pl_plane_find_fmt(gpu, map, &data[p]);
+        if (!fmt || !fmt->fourcc || !(fmt->caps & PL_FMT_CAP_RENDERABLE))
+            goto error;
+
+        bool is_chroma = p == 1 || p == 2; // matches lavu logic
+        surf->tex[p] = pl_tex_create(gpu, pl_tex_params(
+            .w = AV_CEIL_RSHIFT(cfg->width, is_chroma ? desc->log2_chroma_w : 0),
+            .h = AV_CEIL_RSHIFT(cfg->height, is_chroma ? desc->log2_chroma_h : 0),
+            .format = fmt,
+            .renderable = true,
+            .sampleable = fmt->caps & PL_FMT_CAP_SAMPLEABLE,
+            .blit_dst = fmt->caps & PL_FMT_CAP_BLITTABLE,
+            .export_handle = PL_HANDLE_DMA_BUF,
+        ));
+
+        if (!surf->tex[p])
+            goto error;
+
+        // The memory layout is only known with explicit format modifiers
+        const struct pl_shared_mem *mem = &surf->tex[p]->shared_mem;
+        if (mem->drm_format_mod == ((UINT64_C(1) << 56) - 1)) // DRM_FORMAT_MOD_INVALID
+            goto error;
+
+        surf->drm.objects[p] = (AVDRMObjectDescriptor) {
+            .fd = mem->handle.fd,
+            .size = mem->size,
+            .format_modifier = mem->drm_format_mod,
+        };
+
+        surf->drm.layers[p] = (AVDRMLayerDescriptor) {
+            .format = fmt->fourcc,
+            .nb_planes = 1,
+            .planes[0] = {
+                .object_index = p,
+                .offset = mem->offset,
+                .pitch = mem->stride_w,
+            },
+        };
+    }
+
+    AVBufferRef *ref = av_buffer_create((uint8_t *) surf, sizeof(*surf),
+                                        pl_avexport_surface_free, NULL, 0);
+    if (!ref)
+        goto error;
+    return ref;
+
+error:
+    pl_avexport_surface_free(NULL, (uint8_t *) surf);
+    return NULL;
+}
+
+static inline void pl_avexport_cfg_free(void *opaque)
+{
+    free(opaque);
+}
+
+PL_LIBAV_API AVBufferRef *pl_avexport_frames_create(pl_gpu gpu, AVBufferRef *drm_device,
+                                                   enum AVPixelFormat sw_format,
+                                                   int width, int height)
+{
+    AVBufferRef *device = NULL, *frames = NULL;
+    struct pl_avexport_cfg *cfg = NULL;
+    if (!(gpu->export_caps.tex & PL_HANDLE_DMA_BUF))
+        return NULL;
+
+    if (drm_device) {
+        device = av_buffer_ref(drm_device);
+    } else {
+        // The device file descriptor is not needed for wrapping surfaces
+        device = av_hwdevice_ctx_alloc(AV_HWDEVICE_TYPE_DRM);
+        if (device) {
+            AVHWDeviceContext *devctx = (AVHWDeviceContext *) device->data;
+            ((AVDRMDeviceContext *) devctx->hwctx)->fd = -1;
+            if (av_hwdevice_ctx_init(device) < 0)
+                av_buffer_unref(&device);
+        }
+    }
+
+    if (!device)
+        goto error;
+
+    frames = av_hwframe_ctx_alloc(device);
+    cfg = malloc(sizeof(*cfg));
+    if (!frames || !cfg)
+        goto error;
+
+    *cfg = (struct pl_avexport_cfg) {
+        .gpu = gpu,
+        .sw_format = sw_format,
+        .width = width,
+        .height = height,
+    };
+
+    AVHWFramesContext *hwfc = (AVHWFramesContext *) frames->data;
+    hwfc->format = AV_PIX_FMT_DRM_PRIME;
+    hwfc->sw_format = sw_format;
+    hwfc->width = width;
+    hwfc->height = height;
+    hwfc->pool = av_buffer_pool_init2(sizeof(struct pl_avexport_surface), cfg,
+                                      pl_avexport_surface_alloc,
+                                      pl_avexport_cfg_free);
+    if (!hwfc->pool)
+        goto error;
+    cfg = NULL; // now owned by `hwfc->pool`
+
+    if (av_hwframe_ctx_init(frames) < 0)
+        goto error;
+
+    av_buffer_unref(&device);
+    return frames;
+
+error:
+    av_buffer_unref(&frames);
+    av_buffer_unref(&device);
+    free(cfg);
+    return NULL;
+}
+
+PL_LIBAV_API bool pl_frame_from_avexport(struct pl_frame *out, const AVFrame *frame)
+{
+    if (frame->format != AV_PIX_FMT_DRM_PRIME || !frame->hw_frames_ctx)
+        return false;
+
+    const struct pl_avexport_surface *surf = (void *) frame->data[0];
+    if (!frame->buf[0] || frame->buf[0]->size != sizeof(*surf))
+        return false;
+    if (surf->magic[0] != PL_MAGIC0 || surf->magic[1] != PL_MAGIC1)
+        return false;
+
+    pl_frame_from_avframe(out, frame);
+    for (int p = 0; p < out->num_planes; p++)
+        out->planes[p].texture = surf->tex[p];
+    pl_fix_hwframe_sample_depth(out, frame);
+    return true;
+}
+
 #undef PL_MAGIC0
 #undef PL_MAGIC1
 #undef PL_ALIGN
@@ -0,0 +1,85 @@
+/*
+ * This file is part of libplacebo.
+ *
+ * libplacebo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libplacebo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libplacebo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBPLACEBO_MULTIGPU_H
+#define LIBPLACEBO_MULTIGPU_H
+
+#include <libplacebo/renderer.h>
+
+PL_API_BEGIN
+
+// Helper for spreading rendering across multiple GPUs, using alternate frame
+// rendering: frame `index` is rendered by GPU `index % num_gpus`, into an
+// intermediate texture on that GPU, and then transferred to the final
+// target on the primary GPU (`gpus[0]`).
+//
+// Transfers go through a DMA-BUF exported by the rendering GPU and imported
+// by the primary GPU where supported, and through host-mapped buffers (and
+// one memcpy) otherwise. Frames rendered by the primary GPU are simply
+// blitted.
+//
+// Thread-safety: Unsafe
+typedef struct pl_multigpu_t *pl_multigpu;
+
+// Maximum number of GPUs supported by `pl_multigpu`.
+#define PL_MULTIGPU_MAX 8
+
+struct pl_multigpu_params {
+    // The GPUs to distribute rendering across. The first GPU is the primary
+    // GPU, which owns all final render targets. (Required)
+    const pl_gpu *gpus;
+    int num_gpus;
+};
+
+#define pl_multigpu_params(...) (&(struct pl_multigpu_params) { __VA_ARGS__ })
+
+PL_API pl_multigpu pl_multigpu_create(pl_log log, const struct pl_multigpu_params *params);
+
+// Waits for all pending transfers to complete before destroying all state.
+PL_API void pl_multigpu_destroy(pl_multigpu *mg);
+
+// Returns the GPU (and its associated renderer) responsible for rendering
+// the frame with the given index. The textures of images passed to
+// `pl_multigpu_render` for this index must belong to this GPU.
+PL_API pl_gpu pl_multigpu_gpu(pl_multigpu mg, uint64_t index);
+PL_API pl_renderer pl_multigpu_renderer(pl_multigpu mg, uint64_t index);
+
+// Renders `image` for frame `index`, and starts transferring the result to
+// the primary GPU. `target` describes the final target on the primary GPU,
+// and must have a single plane, whose texture must be `host_writable` (for
+// frames rendered by other GPUs) and `blit_dst` (for frames rendered by the
+// primary GPU). Only its format, size and colorimetry are used here; the
+// texture itself is only written to by `pl_multigpu_present`.
+//
+// Frames must be presented in order, and each GPU can only have one frame in
+// flight at a time, so at most `num_gpus` frames may be rendered ahead of the
+// last presented frame. Returns whether successful.
+PL_API bool pl_multigpu_render(pl_multigpu mg, uint64_t index,
+                               const struct pl_frame *image,
+                               const struct pl_frame *target,
+                               const struct pl_render_params *params);
+
+// Waits for frame `index` to become available (up to `timeout` nanoseconds),
+// and copies it into `target->planes[0].texture`. Returns false on timeout
+// or failure, in which case this may be retried.
+PL_API bool pl_multigpu_present(pl_multigpu mg, uint64_t index,
+                                const struct pl_frame *target,
+                                uint64_t timeout);
+
+PL_API_END
+
+#endif // LIBPLACEBO_MULTIGPU_H
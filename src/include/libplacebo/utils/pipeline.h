@@ -0,0 +1,121 @@
+/*
+ * This file is part of libplacebo.
+ *
+ * libplacebo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libplacebo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libplacebo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBPLACEBO_PIPELINE_H
+#define LIBPLACEBO_PIPELINE_H
+
+#include <libplacebo/renderer.h>
+#include <libplacebo/utils/upload.h>
+
+PL_API_BEGIN
+
+// Helper for headless batch rendering of frames from host memory to host
+// memory at maximum throughput, e.g. for transcoding. Every frame passes
+// through three stages: uploading its planes, rendering, and downloading
+// the result. Up to `frames_in_flight` frames are processed at once, each
+// with its own set of textures and buffers, and all stages are submitted to
+// the GPU asynchronously, so that e.g. the upload of the next frame, the
+// rendering of the current frame and the download of the previous frame can
+// all overlap. Transfers use dedicated transfer queues where the GPU backend
+// provides them (see e.g. `pl_vulkan_params.async_transfer`). Output frames
+// are delivered in submission order, through a callback.
+//
+// Thread-safety: Unsafe
+typedef struct pl_pipeline_t *pl_pipeline;
+
+// Rendered frame, as delivered to `pl_pipeline_params.output`.
+struct pl_pipeline_frame {
+    uint64_t index;     // submission order, starting at 0
+    void *priv;         // `pl_pipeline_source.priv`
+
+    // Host memory containing the data of each output plane, laid out as
+    // described by `pl_pipeline_params.planes`. Only valid for the duration
+    // of the callback.
+    const void *data[PL_MAX_PLANES];
+    size_t row_stride[PL_MAX_PLANES];
+    int num_planes;
+};
+
+struct pl_pipeline_params {
+    // Host layout and dimensions of each output plane. The fields related to
+    // the source of the data (`pixels`, `buf`, `callback` etc.) are ignored.
+    // If `row_stride` is left as 0, rows are tightly packed. (Required)
+    const struct pl_plane_data *planes;
+    int num_planes;
+
+    // Colorimetry of the output frames.
+    struct pl_color_repr repr;
+    struct pl_color_space color;
+    enum pl_chroma_location chroma_location;
+
+    // Parameters used for rendering. Defaults to `pl_render_default_params`.
+    const struct pl_render_params *render_params;
+
+    // Maximum number of frames in flight. Higher values increase throughput
+    // on GPUs with asynchronous queues, at the cost of latency and memory.
+    // Defaults to 3.
+    int frames_in_flight;
+
+    // Called once for every frame, in submission order, after it has been
+    // downloaded back to host memory. (Required)
+    void (*output)(void *priv, const struct pl_pipeline_frame *frame);
+    void *priv;
+};
+
+#define pl_pipeline_params(...) (&(struct pl_pipeline_params) { __VA_ARGS__ })
+
+// Create a new pipeline rendering on `gpu`. Returns NULL on failure, e.g. if
+// the output planes do not correspond to any renderable and host-readable
+// texture format.
+PL_API pl_pipeline pl_pipeline_create(pl_log log, pl_gpu gpu,
+                                      const struct pl_pipeline_params *params);
+
+// Destroys the pipeline. Frames still in flight are discarded without being
+// delivered, use `pl_pipeline_flush` before this to avoid that.
+PL_API void pl_pipeline_destroy(pl_pipeline *pipeline);
+
+// Source frame, as submitted to `pl_pipeline_push`.
+struct pl_pipeline_source {
+    // Planes of the frame, see `pl_upload_plane`. Data in host memory is
+    // copied into internal staging buffers, so it may be reused as soon as
+    // `pl_pipeline_push` returns.
+    const struct pl_plane_data *planes;
+    int num_planes;
+
+    // Colorimetry of the source frame.
+    struct pl_color_repr repr;
+    struct pl_color_space color;
+    enum pl_chroma_location chroma_location;
+
+    // User data passed through to `pl_pipeline_frame.priv`.
+    void *priv;
+};
+
+// Submits a frame to the pipeline. Delivers any frames completed so far
+// (from within this call), and blocks until the oldest frame completes if
+// `frames_in_flight` frames are already pending. Returns false on failure,
+// in which case the frame is dropped.
+PL_API bool pl_pipeline_push(pl_pipeline pipeline, const struct pl_pipeline_source *src);
+
+// Blocks until all frames in flight have been delivered. Returns false if
+// any frame was dropped (due to a failure downloading it) since the last
+// call to this function.
+PL_API bool pl_pipeline_flush(pl_pipeline pipeline);
+
+PL_API_END
+
+#endif // LIBPLACEBO_PIPELINE_H
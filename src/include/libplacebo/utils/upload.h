@@ -133,11 +133,43 @@ PL_API pl_fmt pl_plane_find_fmt(pl_gpu gpu, int out_map[4], const struct pl_plan
 // and maximize compatibility with the other `pl_renderer` requirements
 // (blittable, linear filterable, etc.).
 //
+// If no texture format matches the plane's layout (e.g. packed formats with
+// components that don't correspond to any GPU format), and the GPU supports
+// compute shaders and storage buffers, the raw pixel data is uploaded as-is
+// and unpacked into a storable texture on the GPU instead. This only works
+// for native-endian PL_FMT_UNORM data with components of at most 32 bits.
+//
 // Note: `out_plane->shift_x/y` and `out_plane->flipped` are left
 // uninitialized, and should be set explicitly by the user.
 PL_API bool pl_upload_plane(pl_gpu gpu, struct pl_plane *out_plane,
                             pl_tex *tex, const struct pl_plane_data *data);
 
+// Ring of persistent staging buffers, used to pipeline plane uploads. Instead
+// of transferring directly from host memory (which typically blocks until the
+// data has been copied), `pl_upload_ring_plane` copies the plane into the
+// next staging buffer of the ring and uploads from that, which lets the GPU
+// perform the transfer asynchronously (e.g. on a dedicated transfer queue)
+// while the previous frame is still being rendered.
+//
+// Synchronization of the staging buffers and the resulting textures is
+// handled internally: `data->pixels` may be reused as soon as the call
+// returns, and the texture may be used immediately. If all buffers in the
+// ring are still in use, `pl_upload_ring_plane` blocks until the oldest one
+// becomes available again.
+typedef struct pl_upload_ring_t *pl_upload_ring;
+
+// Create a ring of `num_buffers` staging buffers. For full pipelining, this
+// should be at least the number of planes uploaded per frame times the number
+// of frames in flight. The buffers are allocated lazily, on first use.
+PL_API pl_upload_ring pl_upload_ring_create(pl_gpu gpu, int num_buffers);
+PL_API void pl_upload_ring_destroy(pl_upload_ring *ring);
+
+// Like `pl_upload_plane`, but stages uploads from host memory through `ring`.
+// Falls back to a regular `pl_upload_plane` if the plane is already in a
+// `pl_buf`, or if the GPU does not support buffer transfers.
+PL_API bool pl_upload_ring_plane(pl_upload_ring ring, struct pl_plane *out_plane,
+                                 pl_tex *tex, const struct pl_plane_data *data);
+
 // Like `pl_upload_plane`, but only creates an uninitialized texture object
 // rather than actually performing an upload. This can be useful to, for
 // example, prepare textures to be used as the target of rendering.
@@ -159,6 +159,29 @@ struct pl_vulkan_t {
     int num_queues PL_DEPRECATED;
 };
 
+// Memory usage and budget of a single memory heap.
+struct pl_vulkan_heap_budget {
+    VkMemoryHeapFlags flags;
+    VkDeviceSize size;   // total size of the heap
+    VkDeviceSize budget; // estimated amount of memory available to the process
+    VkDeviceSize usage;  // estimated amount of memory used by the process
+};
+
+// Called whenever a memory heap's usage exceeds 90% of its budget. This is
+// checked during libplacebo's internal garbage collection, which runs roughly
+// once per frame, and repeats for as long as the heap remains under pressure.
+// Users may react by e.g. releasing cached resources via
+// `pl_renderer_flush_cache`. Must not call back into the `pl_gpu`.
+typedef void (*pl_vulkan_memory_pressure_cb)(void *priv, int heap,
+                                             const struct pl_vulkan_heap_budget *budget);
+
+// Optional SPIR-V optimization presets, see `pl_vulkan_params.spirv_opt`.
+enum pl_vulkan_spirv_opt {
+    PL_VULKAN_SPIRV_OPT_NONE = 0,       // pass the compiler output as-is
+    PL_VULKAN_SPIRV_OPT_PERFORMANCE,    // optimize for execution speed
+    PL_VULKAN_SPIRV_OPT_SIZE,           // optimize for code size
+};
+
 struct pl_vulkan_params {
     // The vulkan instance. Optional, if NULL then libplacebo will internally
     // create a VkInstance with the settings from `instance_params`.
@@ -236,6 +259,17 @@ struct pl_vulkan_params {
     // enables all queue families supported by the device.
     VkQueueFlags extra_queues;
 
+    // Requests a system-wide scheduling priority for all queues of the device,
+    // relative to other devices and processes using the same GPU, via
+    // VK_EXT_global_priority (if supported). This can be used to keep the
+    // frame pacing of interactive playback while batch jobs use the same GPU,
+    // or conversely, to let batch jobs only soak up the leftover GPU time.
+    // Priorities above VK_QUEUE_GLOBAL_PRIORITY_MEDIUM_EXT may require
+    // elevated privileges; if they are not permitted, the device is created
+    // with the default priority instead. If left as 0, the driver default is
+    // used.
+    VkQueueGlobalPriorityEXT global_priority;
+
     // Enables extra device extensions. Device creation will fail if these
     // extensions are not all supported. The user may use this to enable e.g.
     // interop extensions.
@@ -252,6 +286,18 @@ struct pl_vulkan_params {
     // otherwise kept disabled.
     const VkPhysicalDeviceFeatures2 *features;
 
+    // Optional callback for memory pressure notifications. See
+    // `pl_vulkan_memory_pressure_cb`.
+    pl_vulkan_memory_pressure_cb memory_pressure;
+    void *memory_pressure_priv;
+
+    // Optionally run the SPIRV-Tools optimizer on all generated SPIR-V before
+    // handing it to the driver. Some (especially mobile) driver compilers
+    // generate noticeably better code from pre-optimized SPIR-V. The result
+    // is cached together with the SPIR-V. Ignored if libplacebo was built
+    // without SPIRV-Tools (`PL_HAVE_SPIRV_TOOLS`).
+    enum pl_vulkan_spirv_opt spirv_opt;
+
     // --- Misc/debugging options
 
     // Restrict specific features to e.g. work around driver bugs, or simply
@@ -293,6 +339,16 @@ PL_API void pl_vulkan_destroy(pl_vulkan *vk);
 // the underlying `pl_vulkan`. Returns NULL for any other type of `gpu`.
 PL_API pl_vulkan pl_vulkan_get(pl_gpu gpu);
 
+// Queries the current usage and budget of each memory heap, writing one entry
+// per heap to `out`. Returns the number of heaps, or 0 if `gpu` is not backed
+// by `pl_vulkan`. If VK_EXT_memory_budget is enabled, these are the driver's
+// estimates for the whole process. Otherwise, `budget` is the heap size and
+// `usage` only accounts for memory allocated by libplacebo itself.
+//
+// Thread-safety: Safe
+PL_API int pl_vulkan_get_memory_budget(pl_gpu gpu,
+                                       struct pl_vulkan_heap_budget out[VK_MAX_MEMORY_HEAPS]);
+
 struct pl_vulkan_device_params {
     // The instance to use. Required!
     //
@@ -335,10 +391,18 @@ struct pl_vulkan_swapchain_params {
     // documentation for `pl_swapchain_get_latency` for more information. For
     // vulkan specifically, we are only able to wait until the GPU has finished
     // rendering a frame - we are unable to wait until the display has actually
-    // finished displaying it. So this only provides a rough guideline.
+    // finished displaying it. So this only provides a rough guideline. (See
+    // `pl_swapchain_wait_presented` for the latter)
     // Optional, defaults to 3.
     int swapchain_depth;
 
+    // The number of swapchain images to request. More images allow more
+    // frames to be queued up for presentation, e.g. triple buffering in
+    // combination with VK_PRESENT_MODE_MAILBOX_KHR, at the cost of memory and
+    // (in FIFO modes) latency. Clamped to the range supported by the surface.
+    // Optional, defaults to `swapchain_depth + 1`.
+    int image_count;
+
     // This suppresses automatic recreation of the swapchain when any call
     // returns VK_SUBOPTIMAL_KHR. Normally, libplacebo will recreate the
     // swapchain internally on the next `pl_swapchain_start_frame`. If enabled,
@@ -367,6 +431,33 @@ PL_API pl_swapchain pl_vulkan_create_swapchain(pl_vulkan vk,
 // who have `params->allow_suboptimal` enabled.
 PL_API bool pl_vulkan_swapchain_suboptimal(pl_swapchain sw);
 
+// Change the presentation mode of an existing swapchain, e.g. to switch
+// between VK_PRESENT_MODE_FIFO_KHR and VK_PRESENT_MODE_MAILBOX_KHR at
+// runtime. The swapchain is recreated on the next `pl_swapchain_start_frame`.
+// Returns false, leaving the swapchain unchanged, if the mode is not
+// supported by the surface.
+PL_API bool pl_vulkan_swapchain_set_present_mode(pl_swapchain sw,
+                                                 VkPresentModeKHR mode);
+
+struct pl_vulkan_swapchain_stats {
+    VkPresentModeKHR present_mode;  // currently requested presentation mode
+    int num_images;                 // number of images in the swapchain
+    int frames_in_flight;           // frames submitted but not yet rendered
+    uint64_t acquired_frames;       // total number of images acquired
+    float acquire_time;             // moving average of time spent blocking
+                                    // in vkAcquireNextImageKHR, in seconds
+    float acquire_time_max;         // highest observed acquire time, in seconds
+    float swap_time;                // moving average of time spent blocking in
+                                    // `pl_swapchain_swap_buffers`, in seconds
+};
+
+// Returns runtime statistics about a vulkan swapchain, which can be used to
+// judge the effects of the presentation mode and swapchain depth. May be
+// called from any thread, including in between `pl_swapchain_start_frame`
+// and `pl_swapchain_submit_frame`.
+PL_API void pl_vulkan_swapchain_get_stats(pl_swapchain sw,
+                                          struct pl_vulkan_swapchain_stats *out);
+
 // Vulkan interop API, for sharing a single VkDevice (and associated vulkan
 // resources) directly with the API user. The use of this API is a bit sketchy
 // and requires careful communication of Vulkan API state.
@@ -410,6 +501,16 @@ struct pl_vulkan_import_params {
     struct pl_vulkan_queue queue_compute;  // must support VK_QUEUE_COMPUTE_BIT
     struct pl_vulkan_queue queue_transfer; // must support VK_QUEUE_TRANSFER_BIT
 
+    // Index of the first queue to use within each of the above queue families.
+    // libplacebo will use the queues `first_queue` to `first_queue + count - 1`
+    // of each family. This can be used to give multiple `pl_vulkan` instances
+    // sharing the same VkDevice (e.g. interactive playback and a background
+    // transcode) disjoint sets of queues, so that their submissions don't
+    // serialize behind each other. Combined with per-queue priorities (see
+    // `VkDeviceQueueCreateInfo.pQueuePriorities`), this lets latency-sensitive
+    // work take precedence over batch jobs. Defaults to 0.
+    int first_queue;
+
     // Enabled VkPhysicalDeviceFeatures. The device *must* be created with
     // all of the features in `pl_vulkan_required_features` enabled.
     const VkPhysicalDeviceFeatures2 *features;
@@ -420,6 +521,15 @@ struct pl_vulkan_import_params {
     void (*unlock_queue)(void *ctx, uint32_t qf, uint32_t qidx);
     void *queue_ctx;
 
+    // Optional callback for memory pressure notifications. See
+    // `pl_vulkan_memory_pressure_cb`. Budget information requires
+    // VK_EXT_memory_budget to be included in `extensions`.
+    pl_vulkan_memory_pressure_cb memory_pressure;
+    void *memory_pressure_priv;
+
+    // See `pl_vulkan_params.spirv_opt`.
+    enum pl_vulkan_spirv_opt spirv_opt;
+
     // --- Misc/debugging options
 
     // Restrict specific features to e.g. work around driver bugs, or simply
@@ -469,6 +579,11 @@ struct pl_vulkan_wrap_params {
     // and VK_IMAGE_ASPECT_COLOR_BIT otherwise).
     VkImageAspectFlags aspect;
 
+    // Which array layer of `image` to wrap. Useful for wrapping individual
+    // pictures of layered images, such as Vulkan Video decode output images
+    // coinciding with a layered DPB. Must be 0 for 3D images.
+    uint32_t layer;
+
     // The image's dimensions (unused dimensions must be 0)
     int width;
     int height;
@@ -480,7 +595,11 @@ struct pl_vulkan_wrap_params {
 
     // The usage flags the image was created with. libplacebo will set the
     // pl_tex capabilities to include whatever it can, as determined by the set
-    // of enabled usage flags.
+    // of enabled usage flags. Flags not understood by libplacebo (e.g.
+    // VK_IMAGE_USAGE_VIDEO_DECODE_DST_BIT_KHR) are ignored, so decoder output
+    // images can be wrapped and sampled directly as long as they were created
+    // with VK_IMAGE_USAGE_SAMPLED_BIT. The decoder's queue family can be
+    // handed over via `pl_vulkan_release_params.qf`.
     VkImageUsageFlags usage;
 
     // See `pl_tex_params`
@@ -611,6 +730,14 @@ struct pl_vulkan_sem_params {
     enum pl_handle_type export_handle;
     union pl_handle *out_handle;
 
+    // If set, imports the payload of an external semaphore (e.g. one exported
+    // by another process) from `import`. Must be exactly *one* of
+    // `pl_gpu.import_caps.sync`, and is mutually exclusive with
+    // `export_handle`. `type` must match the type of the exported semaphore.
+    // The handle remains owned by the caller.
+    enum pl_handle_type import_handle;
+    union pl_handle import;
+
     // Optional debug tag to identify this semaphore.
     pl_debug_tag debug_tag;
 };
@@ -625,6 +752,79 @@ struct pl_vulkan_sem_params {
 PL_API VkSemaphore pl_vulkan_sem_create(pl_gpu gpu, const struct pl_vulkan_sem_params *params);
 PL_API void pl_vulkan_sem_destroy(pl_gpu gpu, VkSemaphore *semaphore);
 
+// Maximum number of frames in a `pl_vulkan_shared_pool`.
+#define PL_VULKAN_SHARED_POOL_MAX 16
+
+// Description of a `pl_vulkan_shared_pool`, which can be sent to another
+// process (e.g. over a UNIX domain socket using SCM_RIGHTS, or after
+// duplicating the handles with `DuplicateHandle`) to import the same pool
+// there. All handles are owned by the pool they were exported from.
+struct pl_vulkan_shared_pool_desc {
+    int num_frames;
+    int width, height;
+    char format[32]; // `pl_fmt.name`
+
+    // Handle types and per-frame handles of the texture memory, and of the
+    // timeline semaphore synchronizing access to each frame
+    enum pl_handle_type mem_handle;
+    enum pl_handle_type sem_handle;
+    struct pl_shared_mem mem[PL_VULKAN_SHARED_POOL_MAX];
+    union pl_handle sem[PL_VULKAN_SHARED_POOL_MAX];
+};
+
+struct pl_vulkan_shared_pool_params {
+    // Texture parameters of each frame. To create a new pool, `export_handle`
+    // must be set, and `w`, `h` and `format` define the frames. When
+    // importing, only the capabilities (e.g. `sampleable`, `renderable`) are
+    // used. Must be 2D and non-planar. (Required)
+    const struct pl_tex_params *tex;
+
+    // When creating a new pool: The number of frames, and the handle type to
+    // export the semaphores with. Must be one of `pl_gpu.export_caps.sync`.
+    int num_frames;
+    enum pl_handle_type sem_handle;
+
+    // Alternatively, a pool exported by another process to import. The
+    // handles remain owned by the caller, and may be closed after creation.
+    const struct pl_vulkan_shared_pool_desc *import;
+};
+
+#define pl_vulkan_shared_pool_params(...) (&(struct pl_vulkan_shared_pool_params) { __VA_ARGS__ })
+
+// A fixed ring of textures shared between processes, with handles exported
+// (or imported) once, so that frames can be passed back and forth by index
+// without per-frame handle exports or copies. Ownership of each frame is
+// passed along together with a timeline semaphore value: the process giving
+// up a frame calls `pl_vulkan_shared_pool_send` and forwards (index, value)
+// to its peer, which calls `pl_vulkan_shared_pool_recv` before using it.
+//
+// Initially, all frames are owned by the process that created the pool.
+// Frames of an imported pool must not be used before receiving them.
+//
+// Thread-safety: Unsafe
+typedef struct pl_vulkan_shared_pool_t *pl_vulkan_shared_pool;
+PL_API pl_vulkan_shared_pool pl_vulkan_shared_pool_create(pl_gpu gpu,
+                                const struct pl_vulkan_shared_pool_params *params);
+PL_API void pl_vulkan_shared_pool_destroy(pl_vulkan_shared_pool *pool);
+
+// Returns the description of a pool, for sending to other processes.
+PL_API const struct pl_vulkan_shared_pool_desc *
+pl_vulkan_shared_pool_desc(pl_vulkan_shared_pool pool);
+
+// Returns the texture backing the frame with the given index.
+PL_API pl_tex pl_vulkan_shared_pool_tex(pl_vulkan_shared_pool pool, int index);
+
+// Gives up ownership of a frame, after all previously submitted operations
+// involving it have completed. Returns the semaphore value to forward to the
+// peer in `out_value`. Returns whether successful.
+PL_API bool pl_vulkan_shared_pool_send(pl_vulkan_shared_pool pool, int index,
+                                       uint64_t *out_value);
+
+// Takes over a frame sent by the peer. Subsequent operations involving the
+// frame wait for `value` to be signalled. Returns whether successful.
+PL_API bool pl_vulkan_shared_pool_recv(pl_vulkan_shared_pool pool, int index,
+                                       uint64_t value);
+
 // Backwards-compatibility wrappers for older versions of the API.
 PL_DEPRECATED PL_API bool pl_vulkan_hold(pl_gpu gpu, pl_tex tex, VkImageLayout layout,
                                          pl_vulkan_sem sem_out);
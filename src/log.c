@@ -22,12 +22,315 @@
 #include "log.h"
 #include "pl_thread.h"
 
+// Asynchronous logging: producers claim a contiguous run of slots in a
+// bounded MPSC ring and format each message in place. Every slot has a
+// sequence number, which is `pos` while the slot is free, and `pos + 1` once
+// the first slot of a record at `pos` is ready to be consumed. Records never
+// wrap around the end of the ring, the remaining slots are instead claimed
+// as a padding record. The (single) consumer is whoever holds `priv.lock`.
+#define SLOT_SIZE 64
+#define MIN_SLOTS 16
+#define ASYNC_TIMEOUT UINT64_C(50000000) // 50 ms
+
+struct log_meta {
+    uint32_t num;               // number of slots in this record
+    enum pl_log_level level;    // PL_LOG_NONE for padding
+};
+
+struct log_ring {
+    size_t size;                // number of slots, power of two
+    char *data;                 // size * SLOT_SIZE bytes
+    struct log_meta *meta;
+    atomic_size_t *seq;
+    atomic_size_t head;         // next slot to claim
+    size_t tail;                // next slot to consume
+    atomic_uint_fast64_t dropped;
+    uint64_t reported;          // number of dropped messages already reported
+    atomic_bool waiting;
+    bool quit;
+    pl_cond wakeup;
+    pl_thread thread;
+};
+
+// Structured tracing: a fixed-size ring of events which is overwritten once
+// full. Each slot is guarded by a seqlock, which is odd while the slot is
+// being written and `2 * pos + 2` once the event at `pos` is complete.
+struct trace_slot {
+    atomic_uint_fast64_t seq;
+    atomic_uint_fast64_t ts, dur;
+    atomic_uint_fast64_t args[2];
+    atomic_uint_fast32_t ev, tid;
+};
+
+struct trace_ring {
+    size_t size; // power of two
+    struct trace_slot *slots;
+    atomic_uint_fast64_t head;
+    uint64_t tail; // next event to export, protected by `priv.lock`
+    pl_clock_t base;
+};
+
+static const struct trace_ev_info {
+    const char *name, *cat;
+    const char *arg[2];
+    bool hex0; // format the first arg as hex
+    bool gpu;  // duration is in nanoseconds
+} trace_evs[PL_EV_COUNT] = {
+    [PL_EV_CACHE_INSERT]        = { "insert",   "cache",    {"key", "size"}, true },
+    [PL_EV_CACHE_EVICT]         = { "evict",    "cache",    {"key", "size"}, true },
+    [PL_EV_CACHE_DELETE]        = { "delete",   "cache",    {"key"}, true },
+    [PL_EV_DISPATCH_RUN]        = { "run",      "dispatch", {"signature", "gpu_ns"}, true },
+    [PL_EV_VK_MALLOC]           = { "malloc",   "vulkan",   {"size", "dedicated"} },
+    [PL_EV_RENDER_IMAGE]        = { "pl_render_image",    "renderer" },
+    [PL_EV_PASS_READ_IMAGE]     = { "pass_read_image",    "renderer" },
+    [PL_EV_PASS_SCALE_MAIN]     = { "pass_scale_main",    "renderer" },
+    [PL_EV_PASS_OUTPUT_TARGET]  = { "pass_output_target", "renderer" },
+    [PL_EV_FINALIZE_PASS]       = { "finalize_pass",      "dispatch" },
+    [PL_EV_TEX_UPLOAD]          = { "pl_tex_upload",      "gpu" },
+    [PL_EV_VK_SUBMIT]           = { "vk_cmd_submit",      "vulkan" },
+    [PL_EV_GPU_PASS]            = { "pass",     "gpu",      {"signature"}, true, .gpu = true },
+};
+
 struct priv {
     pl_mutex lock;
-    enum pl_log_level log_level_cap;
+    atomic_int log_level_cap;
     pl_str logbuffer;
+    struct log_ring *ring;
+    struct trace_ring *trace;
 };
 
+// Delivers all ready messages, must be called with `priv.lock` held
+static void ring_drain(pl_log log)
+{
+    struct priv *p = PL_PRIV(log);
+    struct log_ring *r = p->ring;
+    const size_t mask = r->size - 1;
+
+    for (;;) {
+        const size_t pos = r->tail, idx = pos & mask;
+        if (atomic_load_explicit(&r->seq[idx], memory_order_acquire) != pos + 1)
+            break;
+
+        const struct log_meta meta = r->meta[idx];
+        if (meta.level && log->params.log_cb)
+            log->params.log_cb(log->params.log_priv, meta.level, &r->data[idx * SLOT_SIZE]);
+
+        for (size_t i = 0; i < meta.num; i++) {
+            atomic_store_explicit(&r->seq[idx + i], pos + i + r->size,
+                                  memory_order_release);
+        }
+        r->tail = pos + meta.num;
+    }
+
+    uint64_t dropped = atomic_load_explicit(&r->dropped, memory_order_relaxed);
+    if (dropped != r->reported && pl_msg_test(log, PL_LOG_WARN)) {
+        p->logbuffer.len = 0;
+        pl_str_append_asprintf_c((void *) log, &p->logbuffer,
+            "Dropped %llu log messages (async buffer full)",
+            (unsigned long long) (dropped - r->reported));
+        log->params.log_cb(log->params.log_priv, PL_LOG_WARN, (char *) p->logbuffer.buf);
+    }
+    r->reported = dropped;
+}
+
+static PL_THREAD_VOID log_worker(void *arg)
+{
+    pl_log log = arg;
+    struct priv *p = PL_PRIV(log);
+    struct log_ring *r = p->ring;
+
+    pl_mutex_lock(&p->lock);
+    while (!r->quit) {
+        ring_drain(log);
+        atomic_store(&r->waiting, true);
+        // Producers signal without holding the lock, so a wakeup may be
+        // missed here; the timeout bounds the resulting delivery delay
+        size_t idx = r->tail & (r->size - 1);
+        if (atomic_load(&r->seq[idx]) != r->tail + 1 && !r->quit)
+            pl_cond_timedwait(&r->wakeup, &p->lock, ASYNC_TIMEOUT);
+        atomic_store(&r->waiting, false);
+    }
+    ring_drain(log);
+    pl_mutex_unlock(&p->lock);
+    PL_THREAD_RETURN();
+}
+
+static void ring_init(pl_log log, size_t bytes)
+{
+    struct priv *p = PL_PRIV(log);
+    size_t size = MIN_SLOTS;
+    while (size * SLOT_SIZE < bytes)
+        size <<= 1;
+
+    struct log_ring *r = pl_alloc_ptr((void *) log, r);
+    *r = (struct log_ring) {
+        .size = size,
+        .data = pl_alloc((void *) r, size * SLOT_SIZE),
+        .meta = pl_calloc_ptr(r, size, r->meta),
+        .seq  = pl_alloc((void *) r, size * sizeof(r->seq[0])),
+    };
+
+    for (size_t i = 0; i < size; i++)
+        atomic_init(&r->seq[i], i);
+    atomic_init(&r->head, 0);
+    atomic_init(&r->dropped, 0);
+    atomic_init(&r->waiting, false);
+    pl_cond_init(&r->wakeup);
+
+    p->ring = r;
+    if (pl_thread_create(&r->thread, log_worker, (void *) log) != 0) {
+        p->ring = NULL;
+        pl_cond_destroy(&r->wakeup);
+        pl_free(r);
+        pl_warn(log, "Failed creating logging thread, using synchronous "
+                "logging instead");
+    }
+}
+
+static void ring_uninit(pl_log log)
+{
+    struct priv *p = PL_PRIV(log);
+    struct log_ring *r = p->ring;
+    if (!r)
+        return;
+
+    pl_mutex_lock(&p->lock);
+    r->quit = true;
+    pl_cond_signal(&r->wakeup);
+    pl_mutex_unlock(&p->lock);
+    pl_thread_join(r->thread);
+
+    p->ring = NULL;
+    pl_cond_destroy(&r->wakeup);
+    pl_free(r);
+}
+
+static void trace_init(pl_log log, size_t events)
+{
+    struct priv *p = PL_PRIV(log);
+    size_t size = 1;
+    while (size < events)
+        size <<= 1;
+
+    struct trace_ring *t = pl_alloc_ptr((void *) log, t);
+    *t = (struct trace_ring) {
+        .size  = size,
+        .slots = pl_alloc((void *) t, size * sizeof(t->slots[0])),
+        .base  = pl_clock_now(),
+    };
+
+    for (size_t i = 0; i < size; i++)
+        atomic_init(&t->slots[i].seq, 0);
+    atomic_init(&t->head, 0);
+    p->trace = t;
+}
+
+void pl_trace_record(pl_log log, enum pl_trace_ev ev, uint32_t tid,
+                     pl_clock_t ts, uint64_t dur, uint64_t arg0, uint64_t arg1)
+{
+    struct priv *p = PL_PRIV(log);
+    struct trace_ring *t = p->trace;
+    if (!t)
+        return;
+
+    static atomic_uint_fast32_t num_threads;
+    static _Thread_local uint32_t thread_id;
+    if (!thread_id)
+        thread_id = atomic_fetch_add_explicit(&num_threads, 1, memory_order_relaxed) + 1;
+
+    if (!tid) {
+        // Regular CPU event, ending now
+        const pl_clock_t now = pl_clock_now();
+        tid = thread_id;
+        dur = ts ? now - ts : 0;
+        ts = ts ? ts : now;
+    }
+
+    const uint64_t pos = atomic_fetch_add_explicit(&t->head, 1, memory_order_relaxed);
+    struct trace_slot *s = &t->slots[pos & (t->size - 1)];
+    atomic_store_explicit(&s->seq, 2 * pos + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&s->ts, ts, memory_order_relaxed);
+    atomic_store_explicit(&s->dur, dur, memory_order_relaxed);
+    atomic_store_explicit(&s->args[0], arg0, memory_order_relaxed);
+    atomic_store_explicit(&s->args[1], arg1, memory_order_relaxed);
+    atomic_store_explicit(&s->ev, ev, memory_order_relaxed);
+    atomic_store_explicit(&s->tid, tid, memory_order_relaxed);
+    atomic_store_explicit(&s->seq, 2 * pos + 2, memory_order_release);
+}
+
+int pl_log_trace_save(pl_log log,
+                      void (*write)(void *priv, size_t size, const void *ptr),
+                      void *priv)
+{
+    if (!log)
+        return 0;
+    struct priv *p = PL_PRIV(log);
+    struct trace_ring *t = p->trace;
+    if (!t)
+        return 0;
+
+    pl_mutex_lock(&p->lock);
+    const uint64_t head = atomic_load_explicit(&t->head, memory_order_acquire);
+    uint64_t pos = PL_MAX(t->tail, head > t->size ? head - t->size : 0);
+    t->tail = head;
+
+    int count = 0;
+    pl_str out = {0};
+    // The GPU track (see `pl_trace_gpu`) is emitted as thread 0
+    pl_str_append_asprintf_c(NULL, &out, "{\"traceEvents\":["
+        "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+        "\"args\":{\"name\":\"GPU\"}}");
+    for (; pos < head; pos++) {
+        struct trace_slot *s = &t->slots[pos & (t->size - 1)];
+        const uint64_t seq = atomic_load_explicit(&s->seq, memory_order_acquire);
+        if (seq != 2 * pos + 2)
+            continue; // overwritten or incomplete
+        const uint64_t ts   = atomic_load_explicit(&s->ts, memory_order_relaxed),
+                       dur  = atomic_load_explicit(&s->dur, memory_order_relaxed),
+                       arg0 = atomic_load_explicit(&s->args[0], memory_order_relaxed),
+                       arg1 = atomic_load_explicit(&s->args[1], memory_order_relaxed);
+        const uint32_t ev   = atomic_load_explicit(&s->ev, memory_order_relaxed),
+                       tid  = atomic_load_explicit(&s->tid, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&s->seq, memory_order_relaxed) != seq || ev >= PL_EV_COUNT)
+            continue;
+
+        const struct trace_ev_info *info = &trace_evs[ev];
+        pl_str_append_asprintf_c(NULL, &out,
+            ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":%f,",
+            info->name, info->cat, tid == UINT32_MAX ? 0u : (unsigned) tid,
+            ts > t->base ? pl_clock_diff(ts, t->base) * 1e6 : 0.0);
+        if (dur) {
+            pl_str_append_asprintf_c(NULL, &out, "\"ph\":\"X\",\"dur\":%f,",
+                                     info->gpu ? dur * 1e-3 : pl_clock_diff(ts + dur, ts) * 1e6);
+        } else {
+            pl_str_append_asprintf_c(NULL, &out, "\"ph\":\"i\",\"s\":\"t\",");
+        }
+        pl_str_append_asprintf_c(NULL, &out, "\"args\":{");
+        for (int i = 0; i < PL_ARRAY_SIZE(info->arg) && info->arg[i]; i++) {
+            const uint64_t arg = i ? arg1 : arg0;
+            pl_str_append_asprintf(NULL, &out, (i == 0 && info->hex0)
+                                     ? "%s\"%s\":\"0x%llx\"" : "%s\"%s\":%llu",
+                                     i ? "," : "", info->arg[i],
+                                     (unsigned long long) arg);
+        }
+        pl_str_append_asprintf_c(NULL, &out, "}}");
+        count++;
+
+        if (out.len >= (1 << 16)) {
+            write(priv, out.len, out.buf);
+            out.len = 0;
+        }
+    }
+    pl_mutex_unlock(&p->lock);
+
+    pl_str_append_asprintf_c(NULL, &out, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    write(priv, out.len, out.buf);
+    pl_free(out.buf);
+    return count;
+}
+
 pl_log pl_log_create(int api_ver, const struct pl_log_params *params)
 {
     (void) api_ver;
@@ -35,6 +338,13 @@ pl_log pl_log_create(int api_ver, const struct pl_log_params *params)
     struct priv *p = PL_PRIV(log);
     log->params = *PL_DEF(params, &pl_log_default_params);
     pl_mutex_init(&p->lock);
+    atomic_init(&p->log_level_cap, PL_LOG_NONE);
+    if (log->params.async_buffer)
+        ring_init(log, log->params.async_buffer);
+#ifdef PL_HAVE_TRACE
+    if (log->params.trace_events)
+        trace_init(log, log->params.trace_events);
+#endif
     pl_info(log, "Initialized libplacebo %s (API v%d)", PL_VERSION, PL_API_VER);
     return log;
 }
@@ -48,11 +358,21 @@ void pl_log_destroy(pl_log *plog)
         return;
 
     struct priv *p = PL_PRIV(log);
+    ring_uninit(log);
     pl_mutex_destroy(&p->lock);
     pl_free((void *) log);
     *plog = NULL;
 }
 
+uint64_t pl_log_dropped(pl_log log)
+{
+    if (!log)
+        return 0;
+
+    struct priv *p = PL_PRIV(log);
+    return p->ring ? atomic_load(&p->ring->dropped) : 0;
+}
+
 struct pl_log_params pl_log_update(pl_log ptr, const struct pl_log_params *params)
 {
     struct pl_log_t *log = (struct pl_log_t *) ptr;
@@ -61,8 +381,12 @@ struct pl_log_params pl_log_update(pl_log ptr, const struct pl_log_params *param
 
     struct priv *p = PL_PRIV(log);
     pl_mutex_lock(&p->lock);
+    if (p->ring)
+        ring_drain(log); // flush messages meant for the old callback
     struct pl_log_params prev_params = log->params;
     log->params = *PL_DEF(params, &pl_log_default_params);
+    log->params.async_buffer = prev_params.async_buffer;
+    log->params.trace_events = prev_params.trace_events;
     pl_mutex_unlock(&p->lock);
 
     return prev_params;
@@ -89,9 +413,7 @@ void pl_log_level_cap(pl_log log, enum pl_log_level cap)
         return;
 
     struct priv *p = PL_PRIV(log);
-    pl_mutex_lock(&p->lock);
-    p->log_level_cap = cap;
-    pl_mutex_unlock(&p->lock);
+    atomic_store(&p->log_level_cap, cap);
 }
 
 static FILE *default_stream(void *stream, enum pl_log_level level)
@@ -133,6 +455,57 @@ void pl_log_color(void *stream, enum pl_log_level level, const char *msg)
         fflush(h);
 }
 
+static void ring_msg(pl_log log, enum pl_log_level lev,
+                     const char *fmt, va_list va)
+{
+    struct priv *p = PL_PRIV(log);
+    struct log_ring *r = p->ring;
+    const size_t mask = r->size - 1;
+
+    va_list copy;
+    va_copy(copy, va);
+    int len = vsnprintf(NULL, 0, fmt, copy);
+    va_end(copy);
+    if (len < 0)
+        return;
+
+    const size_t num = PL_DIV_UP((size_t) len + 1, SLOT_SIZE);
+    size_t pos, idx, pad;
+    for (;;) {
+        pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+        idx = pos & mask;
+        pad = idx + num > r->size ? r->size - idx : 0;
+        const size_t last = pos + pad + num - 1;
+        // Slots are freed in order, so if the last slot is free, so are all
+        // of the slots before it
+        const size_t seq = atomic_load_explicit(&r->seq[last & mask],
+                                                memory_order_acquire);
+        const ptrdiff_t diff = (ptrdiff_t) (seq - last);
+        if (diff < 0 || pad + num > r->size) {
+            atomic_fetch_add_explicit(&r->dropped, 1, memory_order_relaxed);
+            return;
+        }
+
+        if (diff == 0 && atomic_compare_exchange_weak_explicit(&r->head, &pos,
+                            pos + pad + num, memory_order_relaxed,
+                            memory_order_relaxed))
+            break;
+    }
+
+    if (pad) {
+        r->meta[idx] = (struct log_meta) { .num = pad, .level = PL_LOG_NONE };
+        atomic_store_explicit(&r->seq[idx], pos + 1, memory_order_release);
+        pos += pad;
+        idx = 0;
+    }
+
+    vsnprintf(&r->data[idx * SLOT_SIZE], num * SLOT_SIZE, fmt, va);
+    r->meta[idx] = (struct log_meta) { .num = num, .level = lev };
+    atomic_store_explicit(&r->seq[idx], pos + 1, memory_order_release);
+    if (atomic_load_explicit(&r->waiting, memory_order_relaxed))
+        pl_cond_signal(&r->wakeup);
+}
+
 static void pl_msg_va(pl_log log, enum pl_log_level lev,
                       const char *fmt, va_list va)
 {
@@ -144,14 +517,22 @@ static void pl_msg_va(pl_log log, enum pl_log_level lev,
     if (!pl_msg_test(log, lev))
         return;
 
+    struct priv *p = PL_PRIV(log);
+    if (p->ring) {
+        // Asynchronous mode never takes the lock
+        lev = PL_MAX(lev, atomic_load(&p->log_level_cap));
+        if (pl_msg_test(log, lev))
+            ring_msg(log, lev, fmt, va);
+        return;
+    }
+
     // Re-test the log message level with held lock to avoid false positives,
     // which would be a considerably bigger deal than false negatives
-    struct priv *p = PL_PRIV(log);
     pl_mutex_lock(&p->lock);
 
     // Apply this cap before re-testing the log level, to avoid giving users
     // messages that should have been dropped by the log level.
-    lev = PL_MAX(lev, p->log_level_cap);
+    lev = PL_MAX(lev, atomic_load(&p->log_level_cap));
     if (!pl_msg_test(log, lev))
         goto done;
 
@@ -23,6 +23,13 @@
 
 #include <libplacebo/log.h>
 
+#ifdef PL_HAVE_TRACY
+# ifndef TRACY_ENABLE
+#  define TRACY_ENABLE
+# endif
+# include <tracy/TracyC.h>
+#endif
+
 // Internal logging-related functions
 
 // Warning: Not entirely thread-safe. Exercise caution when using. May result
@@ -80,5 +87,95 @@ static inline void pl_log_cpu_time(pl_log log, pl_clock_t start, pl_clock_t stop
            ms > 100 ? " (slow!)" : "");
 }
 
+// Structured trace events, see `pl_log_params.trace_events`. Each event
+// carries up to two integer arguments, whose meaning is defined by the table
+// in log.c.
+enum pl_trace_ev {
+    PL_EV_CACHE_INSERT,     // key, size
+    PL_EV_CACHE_EVICT,      // key, size
+    PL_EV_CACHE_DELETE,     // key
+    PL_EV_DISPATCH_RUN,     // pass signature, GPU time of an earlier run (ns)
+    PL_EV_VK_MALLOC,        // size, dedicated
+
+    // CPU zones, see `PL_TRACE_ZONE`
+    PL_EV_RENDER_IMAGE,
+    PL_EV_PASS_READ_IMAGE,
+    PL_EV_PASS_SCALE_MAIN,
+    PL_EV_PASS_OUTPUT_TARGET,
+    PL_EV_FINALIZE_PASS,
+    PL_EV_TEX_UPLOAD,
+    PL_EV_VK_SUBMIT,
+
+    // Recorded on a separate GPU track, see `pl_trace_gpu`
+    PL_EV_GPU_PASS,         // pass signature
+    PL_EV_COUNT,
+};
+
+static inline bool pl_trace_test(pl_log log)
+{
+#ifdef PL_HAVE_TRACE
+    return log && log->params.trace_events;
+#else
+    return false;
+#endif
+}
+
+void pl_trace_record(pl_log log, enum pl_trace_ev ev, uint32_t tid,
+                     pl_clock_t ts, uint64_t dur, uint64_t arg0, uint64_t arg1);
+
+// Records an event ending now. If `start` is nonzero, this records a
+// duration event spanning from `start`, otherwise an instant event.
+static inline void pl_trace_ev(pl_log log, enum pl_trace_ev ev, pl_clock_t start,
+                               uint64_t arg0, uint64_t arg1)
+{
+    if (pl_trace_test(log))
+        pl_trace_record(log, ev, 0, start, 0, arg0, arg1);
+}
+
+// Records a GPU event of `gpu_ns` nanoseconds, as measured by a `pl_timer`,
+// on the GPU track. Since timer queries only measure durations, `cpu_start`
+// should be the time at which the corresponding work was submitted; this
+// places the GPU zone directly below the CPU zone that caused it.
+static inline void pl_trace_gpu(pl_log log, enum pl_trace_ev ev, pl_clock_t cpu_start,
+                                uint64_t gpu_ns, uint64_t arg0)
+{
+    if (pl_trace_test(log) && cpu_start)
+        pl_trace_record(log, ev, UINT32_MAX, cpu_start, gpu_ns, arg0, 0);
+}
+
+// Scoped CPU zone around the rest of the enclosing block, recorded as a trace
+// event and, if built with Tracy support, also emitted to Tracy
+struct pl_trace_zone {
+    pl_log log;
+    enum pl_trace_ev ev;
+    pl_clock_t start;
+#ifdef PL_HAVE_TRACY
+    TracyCZoneCtx tracy;
+#endif
+};
+
+static inline void pl_trace_zone_end(struct pl_trace_zone *zone)
+{
+#ifdef PL_HAVE_TRACY
+    TracyCZoneEnd(zone->tracy);
+#endif
+    pl_trace_ev(zone->log, zone->ev, zone->start, 0, 0);
+}
+
+#if defined(PL_HAVE_TRACY)
+# define PL_TRACE_ZONE(log, ev)                                                 \
+    TracyCZoneN(_pl_tracy_##ev, #ev, 1);                                        \
+    struct pl_trace_zone _pl_zone_##ev                                          \
+        __attribute__((cleanup(pl_trace_zone_end), unused)) =                   \
+        { (log), PL_EV_##ev, pl_trace_test(log) ? pl_clock_now() : 0, _pl_tracy_##ev }
+#elif defined(PL_HAVE_TRACE)
+# define PL_TRACE_ZONE(log, ev)                                                 \
+    struct pl_trace_zone _pl_zone_##ev                                          \
+        __attribute__((cleanup(pl_trace_zone_end), unused)) =                   \
+        { (log), PL_EV_##ev, pl_trace_test(log) ? pl_clock_now() : 0 }
+#else
+# define PL_TRACE_ZONE(log, ev) do {} while (0)
+#endif
+
 // Log stack trace
 PL_NOINLINE void pl_log_stack_trace(pl_log log, enum pl_log_level lev);
@@ -39,6 +39,10 @@ static void gl_gpu_destroy(pl_gpu gpu)
     while (p->callbacks.num > 0)
         gl_poll_callbacks(gpu);
 
+    gl_upload_ring_destroy(gpu);
+    gl_readback_destroy(gpu);
+    gl_dmabuf_cache_destroy(gpu);
+
     pl_free((void *) gpu);
 }
 
@@ -236,6 +240,10 @@ pl_gpu pl_gpu_create_gl(pl_log log, pl_opengl pl_gl, const struct pl_opengl_para
     p->has_queries = gl_test_ext(gpu, "GL_ARB_timer_query", 33, 0);
     p->has_storage = gl_test_ext(gpu, "GL_ARB_shader_image_load_store", 42, 0);
     p->has_readback = true;
+    p->has_upload_ring = gpu->limits.callbacks && gpu->limits.max_mapped_size;
+    p->has_parallel_compile = gl_test_ext(gpu, "GL_KHR_parallel_shader_compile", 0, 0);
+    if (p->has_parallel_compile)
+        gl->MaxShaderCompilerThreadsKHR(0xFFFFFFFFu); // let the driver decide
 
     if (p->has_readback && p->gles_ver) {
         GLuint fbo = 0, tex = 0;
@@ -626,6 +634,7 @@ static const struct pl_gpu_fns pl_fns_gl = {
     .tex_blit               = gl_tex_blit,
     .tex_upload             = gl_tex_upload,
     .tex_download           = gl_tex_download,
+    .tex_poll               = gl_tex_poll,
     .buf_create             = gl_buf_create,
     .buf_destroy            = gl_buf_destroy,
     .buf_write              = gl_buf_write,
@@ -25,6 +25,16 @@ pl_gpu pl_gpu_create_gl(pl_log log, pl_opengl gl, const struct pl_opengl_params
 
 // --- pl_gpu internal structs and functions
 
+// Persistently mapped ring buffer used to stage texture uploads
+struct gl_upload_ring {
+    pl_buf buf;
+    size_t head, tail;
+    PL_ARRAY(struct gl_ring_fence {
+        GLsync sync;
+        size_t end; // value of `tail` once this fence retires
+    }) fences;
+};
+
 struct pl_gl {
     struct pl_gpu_fns impl;
     pl_opengl gl;
@@ -37,11 +47,21 @@ struct pl_gl {
 #ifdef PL_HAVE_UNIX
     // List of formats supported by EGL_EXT_image_dma_buf_import
     PL_ARRAY(EGLint) egl_formats;
+
+    // Cache of imported DMA-BUFs, to avoid re-creating EGLImages for
+    // recycled buffers (e.g. from hardware decoder pools)
+    PL_ARRAY(struct gl_dmabuf *) dmabufs;
+    uint64_t dmabuf_age;
 #endif
 
     // Sync objects and associated callbacks
     PL_ARRAY(struct gl_cb) callbacks;
 
+    // Staging buffer for texture uploads, or {0} if unavailable
+    struct gl_upload_ring upload_ring;
+
+    // Idle persistently mapped buffers for asynchronous texture downloads
+    PL_ARRAY(pl_buf) readback;
 
     // Incrementing counters to keep track of object uniqueness
     int buf_id;
@@ -58,6 +78,8 @@ struct pl_gl {
     bool has_readback;
     bool has_egl_storage;
     bool has_egl_import;
+    bool has_upload_ring;
+    bool has_parallel_compile;
     int gather_comps;
 };
 
@@ -107,6 +129,10 @@ struct pl_tex_gl {
     // For imported/exported textures
     EGLImageKHR image;
     int fd;
+    struct gl_dmabuf *dmabuf; // cached import, owns `texture`
+
+    // Fence covering the most recent transfer, or NULL
+    GLsync fence;
 };
 
 pl_tex gl_tex_create(pl_gpu, const struct pl_tex_params *);
@@ -116,6 +142,11 @@ void gl_tex_clear_ex(pl_gpu, pl_tex, const union pl_clear_color);
 void gl_tex_blit(pl_gpu, const struct pl_tex_blit_params *);
 bool gl_tex_upload(pl_gpu, const struct pl_tex_transfer_params *);
 bool gl_tex_download(pl_gpu, const struct pl_tex_transfer_params *);
+bool gl_tex_poll(pl_gpu, pl_tex, uint64_t timeout);
+void gl_tex_fence(pl_gpu, pl_tex);
+void gl_dmabuf_cache_destroy(pl_gpu);
+void gl_upload_ring_destroy(pl_gpu);
+void gl_readback_destroy(pl_gpu);
 
 struct pl_buf_gl {
     uint64_t id; // unique per buffer
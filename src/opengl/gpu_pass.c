@@ -72,13 +72,23 @@ static enum pl_log_level gl_log_level(GLint status, GLint log_length)
     }
 }
 
-static bool gl_attach_shader(pl_gpu gpu, GLuint program, GLenum type, const char *src)
+static GLuint gl_start_shader(pl_gpu gpu, GLuint program, GLenum type, const char *src)
 {
     const gl_funcs *gl = gl_funcs_get(gpu);
     GLuint shader = gl->CreateShader(type);
     gl->ShaderSource(shader, 1, &src, NULL);
     gl->CompileShader(shader);
+    gl->AttachShader(program, shader);
+    return shader;
+}
 
+// Checks the compile status of a shader started by `gl_start_shader`. Querying
+// this may block until compilation has finished, so it's deferred until after
+// the program was linked, to give the driver a chance to compile all stages
+// concurrently.
+static bool gl_check_shader(pl_gpu gpu, GLuint shader)
+{
+    const gl_funcs *gl = gl_funcs_get(gpu);
     GLint status = 0;
     gl->GetShaderiv(shader, GL_COMPILE_STATUS, &status);
     GLint log_length = 0;
@@ -92,31 +102,57 @@ static bool gl_attach_shader(pl_gpu gpu, GLuint program, GLenum type, const char
         pl_free(logstr);
     }
 
-    if (!status || !gl_check_err(gpu, "gl_attach_shader"))
-        goto error;
+    return status;
+}
 
-    gl->AttachShader(program, shader);
-    gl->DeleteShader(shader);
-    return true;
+// With GL_KHR_parallel_shader_compile, compilation and linking happen on
+// driver threads. Wait for them to finish without holding on to the context,
+// so other threads (e.g. the render thread, while passes are compiled in the
+// background by `pl_dispatch`) can keep using it in the meantime. Returns
+// false if the context could not be re-acquired afterwards.
+static bool gl_await_program(pl_gpu gpu, GLuint prog)
+{
+    const gl_funcs *gl = gl_funcs_get(gpu);
+    struct pl_gl *p = PL_PRIV(gpu);
+    if (!p->has_parallel_compile || !gpu->limits.thread_safe)
+        return true; // querying the link status will block instead
 
-error:
-    gl->DeleteShader(shader);
-    return false;
+    double delay = 1e-4;
+    for (;;) {
+        GLint done = 0;
+        gl->GetProgramiv(prog, GL_COMPLETION_STATUS_KHR, &done);
+        if (done)
+            return true;
+
+        RELEASE_CURRENT();
+        pl_thread_sleep(delay);
+        delay = PL_MIN(delay * 2, 2e-3);
+        if (!MAKE_CURRENT())
+            return false;
+    }
 }
 
-static GLuint gl_compile_program(pl_gpu gpu, const struct pl_pass_params *params)
+// Sets `*lost` if the context was lost while compiling, in which case it is
+// no longer current on return
+static GLuint gl_compile_program(pl_gpu gpu, const struct pl_pass_params *params,
+                                 bool *lost)
 {
     const gl_funcs *gl = gl_funcs_get(gpu);
     GLuint prog = gl->CreateProgram();
+    GLuint shaders[2] = {0};
+    int num_shaders = 0;
     bool ok = true;
 
     switch (params->type) {
     case PL_PASS_COMPUTE:
-        ok &= gl_attach_shader(gpu, prog, GL_COMPUTE_SHADER, params->glsl_shader);
+        shaders[num_shaders++] = gl_start_shader(gpu, prog, GL_COMPUTE_SHADER,
+                                                 params->glsl_shader);
         break;
     case PL_PASS_RASTER:
-        ok &= gl_attach_shader(gpu, prog, GL_VERTEX_SHADER, params->vertex_shader);
-        ok &= gl_attach_shader(gpu, prog, GL_FRAGMENT_SHADER, params->glsl_shader);
+        shaders[num_shaders++] = gl_start_shader(gpu, prog, GL_VERTEX_SHADER,
+                                                 params->vertex_shader);
+        shaders[num_shaders++] = gl_start_shader(gpu, prog, GL_FRAGMENT_SHADER,
+                                                 params->glsl_shader);
         for (int i = 0; i < params->num_vertex_attribs; i++)
             gl->BindAttribLocation(prog, i, params->vertex_attribs[i].name);
         break;
@@ -125,10 +161,23 @@ static GLuint gl_compile_program(pl_gpu gpu, const struct pl_pass_params *params
         pl_unreachable();
     }
 
-    if (!ok || !gl_check_err(gpu, "gl_compile_program: attach shader"))
+    if (!gl_check_err(gpu, "gl_compile_program: attach shader"))
         goto error;
 
+    // Linking with failed shaders is harmless, it just fails as well
     gl->LinkProgram(prog);
+    if (!gl_await_program(gpu, prog)) {
+        PL_ERR(gpu, "Failed re-acquiring context while compiling GLSL program, "
+               "leaking resources!");
+        *lost = true;
+        return 0;
+    }
+
+    for (int i = 0; i < num_shaders; i++)
+        ok &= gl_check_shader(gpu, shaders[i]);
+    if (!ok || !gl_check_err(gpu, "gl_compile_program: compile shader"))
+        goto error;
+
     GLint status = 0;
     gl->GetProgramiv(prog, GL_LINK_STATUS, &status);
     GLint log_length = 0;
@@ -145,9 +194,13 @@ static GLuint gl_compile_program(pl_gpu gpu, const struct pl_pass_params *params
     if (!gl_check_err(gpu, "gl_compile_program: link program"))
         goto error;
 
+    for (int i = 0; i < num_shaders; i++)
+        gl->DeleteShader(shaders[i]);
     return prog;
 
 error:
+    for (int i = 0; i < num_shaders; i++)
+        gl->DeleteShader(shaders[i]);
     gl->DeleteProgram(prog);
     PL_ERR(gpu, "Failed compiling/linking GLSL program");
     return 0;
@@ -239,8 +292,14 @@ pl_pass gl_pass_create(pl_gpu gpu, const struct pl_pass_params *params)
         PL_DEBUG(gpu, "Using cached GL program");
     } else {
         pl_clock_t start = pl_clock_now();
-        pass_gl->program = gl_compile_program(gpu, params);
+        bool lost = false;
+        pass_gl->program = gl_compile_program(gpu, params, &lost);
         pl_log_cpu_time(gpu->log, start, pl_clock_now(), "compiling shader");
+        if (lost) {
+            pl_cache_obj_free(&obj);
+            pl_free((void *) pass);
+            return NULL;
+        }
     }
 
     if (!pass_gl->program)
@@ -670,6 +729,9 @@ void gl_pass_run(pl_gpu gpu, const struct pl_pass_run_params *params)
         gl_timer_end(gpu, params->timer);
         gl_check_err(gpu, "gl_pass_run: drawing");
 
+        // Allow `pl_tex_poll` to track rendering, not just transfers
+        gl_tex_fence(gpu, params->target);
+
         if (pass_gl->vao) {
             gl->BindVertexArray(0);
         } else {
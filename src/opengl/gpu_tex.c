@@ -18,12 +18,99 @@
 #include "gpu.h"
 #include "formats.h"
 #include "utils.h"
+#include "pl_thread_pool.h"
 
 #ifdef PL_HAVE_UNIX
 #include <unistd.h>
 #include <errno.h>
+#include <sys/stat.h>
 #endif
 
+#ifdef PL_HAVE_UNIX
+
+// Maximum number of unused DMA-BUF imports kept alive
+#define DMABUF_CACHE_SIZE 16
+
+struct gl_dmabuf {
+    // Identity of the imported buffer. Since the cache holds a reference to
+    // the underlying DMA-BUF (via `fd`), its inode can't be reused while the
+    // entry exists
+    dev_t dev;
+    ino_t ino;
+    size_t offset;
+    size_t pitch;
+    uint64_t modifier;
+    pl_fmt fmt;
+    int w, h;
+
+    EGLImageKHR image;
+    GLuint texture;
+    int fd;
+    int refs;
+    uint64_t last_used;
+};
+
+// Must be called with the context current
+static void dmabuf_free(pl_gpu gpu, struct gl_dmabuf *dmabuf)
+{
+    const gl_funcs *gl = gl_funcs_get(gpu);
+    struct pl_gl *p = PL_PRIV(gpu);
+    gl->DeleteTextures(1, &dmabuf->texture);
+    eglDestroyImageKHR(p->egl_dpy, dmabuf->image);
+    close(dmabuf->fd);
+    pl_free(dmabuf);
+}
+
+// Evicts the least recently used idle entries in excess of the cache size.
+// Must be called with the context current
+static void dmabuf_cache_trim(pl_gpu gpu)
+{
+    struct pl_gl *p = PL_PRIV(gpu);
+    for (;;) {
+        int num_idle = 0, oldest = -1;
+        for (int i = 0; i < p->dmabufs.num; i++) {
+            const struct gl_dmabuf *dmabuf = p->dmabufs.elem[i];
+            if (dmabuf->refs)
+                continue;
+            num_idle++;
+            if (oldest < 0 || dmabuf->last_used < p->dmabufs.elem[oldest]->last_used)
+                oldest = i;
+        }
+
+        if (num_idle <= DMABUF_CACHE_SIZE)
+            return;
+
+        dmabuf_free(gpu, p->dmabufs.elem[oldest]);
+        PL_ARRAY_REMOVE_AT(p->dmabufs, oldest);
+    }
+}
+
+#endif // PL_HAVE_UNIX
+
+void gl_dmabuf_cache_destroy(pl_gpu gpu)
+{
+#ifdef PL_HAVE_UNIX
+    struct pl_gl *p = PL_PRIV(gpu);
+    if (!p->dmabufs.num)
+        goto done;
+
+    if (!MAKE_CURRENT()) {
+        PL_ERR(gpu, "Failed uninitializing DMA-BUF cache, leaking resources!");
+        goto done;
+    }
+
+    for (int i = 0; i < p->dmabufs.num; i++)
+        dmabuf_free(gpu, p->dmabufs.elem[i]);
+    gl_check_err(gpu, "gl_dmabuf_cache_destroy");
+    RELEASE_CURRENT();
+
+done:
+    pl_free(p->dmabufs.elem);
+    p->dmabufs.elem = NULL;
+    p->dmabufs.num = 0;
+#endif
+}
+
 void gl_tex_destroy(pl_gpu gpu, pl_tex tex)
 {
     const gl_funcs *gl = gl_funcs_get(gpu);
@@ -41,10 +128,17 @@ void gl_tex_destroy(pl_gpu gpu, pl_tex tex)
     }
     if (!tex_gl->wrapped_tex)
         gl->DeleteTextures(1, &tex_gl->texture);
+    gl->DeleteSync(tex_gl->fence);
 
 #ifdef PL_HAVE_UNIX
     if (tex_gl->fd != -1)
         close(tex_gl->fd);
+    if (tex_gl->dmabuf) {
+        struct pl_gl *p = PL_PRIV(gpu);
+        tex_gl->dmabuf->refs--;
+        tex_gl->dmabuf->last_used = ++p->dmabuf_age;
+        dmabuf_cache_trim(gpu);
+    }
 #endif
 
     gl_check_err(gpu, "gl_tex_destroy");
@@ -106,6 +200,10 @@ static bool gl_tex_import(pl_gpu gpu,
 
     struct pl_tex_gl *tex_gl = PL_PRIV(tex);
     const struct pl_tex_params *params = &tex->params;
+#ifdef PL_HAVE_UNIX
+    struct gl_dmabuf key;
+    bool cacheable = false;
+#endif
 
     int attribs[20] = {};
     int num_attribs = 0;
@@ -121,6 +219,44 @@ static bool gl_tex_import(pl_gpu gpu,
             goto error;
         }
 
+        key = (struct gl_dmabuf) {
+            .offset   = shared_mem->offset,
+            .pitch    = PL_DEF(shared_mem->stride_w, params->w),
+            .modifier = shared_mem->drm_format_mod,
+            .fmt      = params->format,
+            .w        = params->w,
+            .h        = params->h,
+        };
+
+        struct stat st;
+        cacheable = fstat(shared_mem->handle.fd, &st) == 0;
+        if (cacheable) {
+            key.dev = st.st_dev;
+            key.ino = st.st_ino;
+        }
+
+        for (int i = 0; cacheable && i < p->dmabufs.num; i++) {
+            struct gl_dmabuf *dmabuf = p->dmabufs.elem[i];
+            if (dmabuf->dev != key.dev || dmabuf->ino != key.ino ||
+                dmabuf->offset != key.offset || dmabuf->pitch != key.pitch ||
+                dmabuf->modifier != key.modifier || dmabuf->fmt != key.fmt ||
+                dmabuf->w != key.w || dmabuf->h != key.h)
+            {
+                continue;
+            }
+
+            // Re-use the existing import in place of the fresh texture
+            gl->DeleteTextures(1, &tex_gl->texture);
+            tex_gl->texture = dmabuf->texture;
+            tex_gl->wrapped_tex = true;
+            tex_gl->dmabuf = dmabuf;
+            dmabuf->refs++;
+            gl->BindTexture(GL_TEXTURE_2D, tex_gl->texture);
+            bool ok = gl_check_err(gpu, "gl_tex_import");
+            RELEASE_CURRENT();
+            return ok;
+        }
+
         tex_gl->fd = dup(shared_mem->handle.fd);
         if (tex_gl->fd == -1) {
             PL_ERR(gpu, "%s: cannot duplicate fd %d for importing: %s",
@@ -171,6 +307,23 @@ static bool gl_tex_import(pl_gpu gpu,
     if (!egl_check_err(gpu, "EGLImageTargetTexture2DOES"))
         goto error;
 
+#ifdef PL_HAVE_UNIX
+    if (cacheable) {
+        // Hand over ownership of the import to the cache
+        struct gl_dmabuf *dmabuf = pl_alloc_ptr(NULL, dmabuf);
+        *dmabuf = key;
+        dmabuf->image = tex_gl->image;
+        dmabuf->texture = tex_gl->texture;
+        dmabuf->fd = tex_gl->fd;
+        dmabuf->refs = 1;
+        PL_ARRAY_APPEND(NULL, p->dmabufs, dmabuf);
+        tex_gl->image = NULL;
+        tex_gl->fd = -1;
+        tex_gl->wrapped_tex = true;
+        tex_gl->dmabuf = dmabuf;
+    }
+#endif
+
     RELEASE_CURRENT();
     return true;
 
@@ -866,6 +1019,207 @@ static int get_alignment(size_t pitch)
     return 1;
 }
 
+// Replaces the texture's fence by one covering all work submitted so far.
+// Must be called with the context current.
+void gl_tex_fence(pl_gpu gpu, pl_tex tex)
+{
+    const gl_funcs *gl = gl_funcs_get(gpu);
+    struct pl_tex_gl *tex_gl = PL_PRIV(tex);
+    if (!gpu->limits.callbacks)
+        return;
+
+    gl->DeleteSync(tex_gl->fence);
+    tex_gl->fence = gl->FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+bool gl_tex_poll(pl_gpu gpu, pl_tex tex, uint64_t timeout)
+{
+    const gl_funcs *gl = gl_funcs_get(gpu);
+    struct pl_tex_gl *tex_gl = PL_PRIV(tex);
+    if (!MAKE_CURRENT())
+        return true; // conservative guess
+
+    if (tex_gl->fence) {
+        GLenum res = gl->ClientWaitSync(tex_gl->fence,
+                                        timeout ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                                        timeout);
+        if (res == GL_ALREADY_SIGNALED || res == GL_CONDITION_SATISFIED) {
+            gl->DeleteSync(tex_gl->fence);
+            tex_gl->fence = NULL;
+        }
+    }
+
+    gl_poll_callbacks(gpu);
+    RELEASE_CURRENT();
+    return !!tex_gl->fence;
+}
+
+#define UPLOAD_RING_MIN_SIZE (4 << 20)  // 4 MiB
+#define UPLOAD_RING_MAX_SIZE (64 << 20) // 64 MiB
+#define UPLOAD_RING_ALIGN    64
+
+// Blocks until the oldest pending upload has retired, freeing its region
+static void ring_wait(pl_gpu gpu, struct gl_upload_ring *ring)
+{
+    const gl_funcs *gl = gl_funcs_get(gpu);
+    pl_assert(ring->fences.num > 0);
+    struct gl_ring_fence f = ring->fences.elem[0];
+    gl->ClientWaitSync(f.sync, GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_MAX);
+    gl->DeleteSync(f.sync);
+    PL_ARRAY_REMOVE_AT(ring->fences, 0);
+    ring->tail = f.end;
+}
+
+static void ring_flush(pl_gpu gpu, struct gl_upload_ring *ring)
+{
+    while (ring->fences.num > 0)
+        ring_wait(gpu, ring);
+    ring->head = ring->tail = 0;
+}
+
+void gl_upload_ring_destroy(pl_gpu gpu)
+{
+    struct pl_gl *p = PL_PRIV(gpu);
+    struct gl_upload_ring *ring = &p->upload_ring;
+    if (!ring->buf)
+        return;
+
+    if (MAKE_CURRENT()) {
+        ring_flush(gpu, ring);
+        RELEASE_CURRENT();
+    }
+
+    pl_buf_destroy(gpu, &ring->buf);
+    pl_free(ring->fences.elem);
+    *ring = (struct gl_upload_ring) {0};
+}
+
+// Reserves `size` bytes of the upload ring, growing it if needed. Returns
+// false if the ring can't accommodate the request. Must be called with the
+// context current.
+static bool ring_alloc(pl_gpu gpu, size_t size, size_t *out_offset)
+{
+    struct pl_gl *p = PL_PRIV(gpu);
+    struct gl_upload_ring *ring = &p->upload_ring;
+    if (!p->has_upload_ring || size > UPLOAD_RING_MAX_SIZE / 2)
+        return false;
+
+    if (!ring->buf || ring->buf->params.size < 2 * size) {
+        size_t cap = ring->buf ? ring->buf->params.size : UPLOAD_RING_MIN_SIZE;
+        while (cap < 2 * size)
+            cap *= 2;
+        cap = PL_MIN(cap, UPLOAD_RING_MAX_SIZE);
+
+        ring_flush(gpu, ring);
+        pl_buf_destroy(gpu, &ring->buf);
+        ring->buf = pl_buf_create(gpu, pl_buf_params(
+            .size = cap,
+            .host_mapped = true,
+            .memory_type = PL_BUF_MEM_HOST,
+            .debug_tag = PL_DEBUG_TAG,
+        ));
+
+        if (!ring->buf) {
+            PL_WARN(gpu, "Failed creating texture upload ring, falling back "
+                    "to direct uploads");
+            p->has_upload_ring = false;
+            return false;
+        }
+    }
+
+    const size_t cap = ring->buf->params.size;
+    for (;;) {
+        if (!ring->fences.num)
+            ring->head = ring->tail = 0;
+
+        size_t off = PL_ALIGN2(ring->head, UPLOAD_RING_ALIGN);
+        if (ring->tail <= ring->head) {
+            // Free space is [head, cap) and [0, tail)
+            if (off + size <= cap)
+                goto done;
+            if (size < ring->tail) {
+                off = 0;
+                goto done;
+            }
+        } else if (off + size < ring->tail) {
+            // Ring has wrapped around, free space is [head, tail)
+            goto done;
+        }
+
+        ring_wait(gpu, ring);
+        continue;
+
+done:
+        ring->head = off + size;
+        *out_offset = off;
+        return true;
+    }
+}
+
+// Stages the upload through the persistently mapped upload ring. Returns
+// false if the ring was unavailable, in which case nothing was done.
+static bool upload_ring(pl_gpu gpu, const struct pl_tex_transfer_params *params,
+                        bool *ok)
+{
+    const gl_funcs *gl = gl_funcs_get(gpu);
+    struct pl_gl *p = PL_PRIV(gpu);
+    pl_tex tex = params->tex;
+    pl_fmt fmt = tex->params.format;
+
+    const int w = pl_rect_w(params->rc), h = pl_rect_h(params->rc),
+              d = pl_rect_d(params->rc);
+    const size_t row_size = (size_t) w * fmt->texel_size;
+    const size_t img_size = row_size * h;
+    const size_t size = img_size * d;
+
+    if (!MAKE_CURRENT())
+        return false;
+
+    size_t offset;
+    if (!ring_alloc(gpu, size, &offset)) {
+        RELEASE_CURRENT();
+        return false;
+    }
+
+    // Repack into tightly packed rows, which also avoids the row-by-row
+    // upload path for pitches that aren't a multiple of the texel size
+    struct gl_upload_ring *ring = &p->upload_ring;
+    uint8_t *dst = ring->buf->data + offset;
+    const uint8_t *src = params->ptr;
+    if (params->row_pitch == row_size && params->depth_pitch == img_size) {
+        pl_parallel_memcpy(dst, src, size);
+    } else {
+        for (int z = 0; z < d; z++) {
+            const uint8_t *img = src + z * params->depth_pitch;
+            for (int y = 0; y < h; y++) {
+                memcpy(dst, img + y * params->row_pitch, row_size);
+                dst += row_size;
+            }
+        }
+    }
+
+    struct pl_tex_transfer_params fixed = *params;
+    fixed.buf = ring->buf;
+    fixed.buf_offset = offset;
+    fixed.ptr = NULL;
+    fixed.row_pitch = row_size;
+    fixed.depth_pitch = img_size;
+    fixed.callback = NULL;
+    *ok = gl_tex_upload(gpu, &fixed);
+
+    PL_ARRAY_APPEND(gpu, ring->fences, (struct gl_ring_fence) {
+        .sync = gl->FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0),
+        .end = ring->head,
+    });
+
+    RELEASE_CURRENT();
+
+    // The source data has already been copied, so it's safe to release it
+    if (params->callback)
+        params->callback(params->priv);
+    return true;
+}
+
 bool gl_tex_upload(pl_gpu gpu, const struct pl_tex_transfer_params *params)
 {
     const gl_funcs *gl = gl_funcs_get(gpu);
@@ -877,15 +1231,26 @@ bool gl_tex_upload(pl_gpu gpu, const struct pl_tex_transfer_params *params)
     struct pl_buf_gl *buf_gl = buf ? PL_PRIV(buf) : NULL;
 
     // If the user requests asynchronous uploads, it's more efficient to do
-    // them via a PBO - this allows us to skip blocking the caller, especially
-    // when the host pointer can be imported directly.
+    // them via a PBO - this allows us to skip blocking the caller. Prefer
+    // importing the host pointer directly when possible, and staging it
+    // through the upload ring otherwise.
+    bool use_pbo = false;
     if (params->callback && !buf) {
         size_t buf_size = pl_tex_transfer_size(params);
         const size_t min_size = 32*1024; // 32 KiB
-        if (buf_size >= min_size && buf_size <= gpu->limits.max_buf_size)
-            return pl_tex_upload_pbo(gpu, params);
+        use_pbo = buf_size >= min_size && buf_size <= gpu->limits.max_buf_size;
     }
 
+    bool can_import = !params->no_import && (gpu->import_caps.buf & PL_HANDLE_HOST_PTR);
+    if (use_pbo && can_import)
+        return pl_tex_upload_pbo(gpu, params);
+
+    bool staged_ok;
+    if (!buf && upload_ring(gpu, params, &staged_ok))
+        return staged_ok;
+    if (use_pbo)
+        return pl_tex_upload_pbo(gpu, params);
+
     if (!MAKE_CURRENT())
         return false;
 
@@ -961,6 +1326,7 @@ bool gl_tex_upload(pl_gpu gpu, const struct pl_tex_transfer_params *params)
         }
     }
 
+    gl_tex_fence(gpu, tex);
     if (params->callback) {
         PL_ARRAY_APPEND(gpu, p->callbacks, (struct gl_cb) {
             .sync = gl->FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0),
@@ -974,6 +1340,112 @@ bool gl_tex_upload(pl_gpu gpu, const struct pl_tex_transfer_params *params)
     return ok;
 }
 
+#define READBACK_MIN_SIZE  (64 << 10) // 64 KiB
+#define READBACK_POOL_SIZE 4
+
+void gl_readback_destroy(pl_gpu gpu)
+{
+    struct pl_gl *p = PL_PRIV(gpu);
+    for (int i = 0; i < p->readback.num; i++)
+        pl_buf_destroy(gpu, &p->readback.elem[i]);
+    pl_free(p->readback.elem);
+    p->readback.elem = NULL;
+    p->readback.num = 0;
+}
+
+struct readback_ctx {
+    pl_gpu gpu;
+    pl_buf buf;
+    void *ptr;
+    size_t size;
+    void (*callback)(void *priv);
+    void *priv;
+};
+
+static void readback_cb(void *priv)
+{
+    struct readback_ctx *ctx = priv;
+    pl_gpu gpu = ctx->gpu;
+    struct pl_gl *p = PL_PRIV(gpu);
+
+    // The fence has retired, and the mapping is coherent
+    pl_parallel_memcpy(ctx->ptr, ctx->buf->data, ctx->size);
+
+    // Return the buffer to the pool, evicting the oldest one if full. This
+    // runs from `gl_poll_callbacks`, so the context is already current.
+    if (p->readback.num == READBACK_POOL_SIZE) {
+        pl_buf_destroy(gpu, &p->readback.elem[0]);
+        PL_ARRAY_REMOVE_AT(p->readback, 0);
+    }
+    PL_ARRAY_APPEND(gpu, p->readback, ctx->buf);
+
+    ctx->callback(ctx->priv);
+    pl_free(ctx);
+}
+
+// Performs an asynchronous download into a pooled, persistently mapped PBO,
+// copying the result out to the user's pointer once its fence retires.
+// Returns false if no such buffer was available, in which case nothing was
+// done.
+static bool download_async(pl_gpu gpu, const struct pl_tex_transfer_params *params,
+                           bool *ok)
+{
+    struct pl_gl *p = PL_PRIV(gpu);
+    if (!gpu->limits.callbacks || !gpu->limits.max_mapped_size)
+        return false;
+
+    const size_t size = pl_tex_transfer_size(params);
+    if (!MAKE_CURRENT())
+        return false;
+
+    // Buffers are only ever in the pool once idle, so take the first fit
+    pl_buf buf = NULL;
+    for (int i = 0; i < p->readback.num; i++) {
+        if (p->readback.elem[i]->params.size >= size) {
+            buf = p->readback.elem[i];
+            PL_ARRAY_REMOVE_AT(p->readback, i);
+            break;
+        }
+    }
+
+    if (!buf) {
+        size_t bucket = READBACK_MIN_SIZE;
+        while (bucket < size)
+            bucket <<= 1;
+        buf = pl_buf_create(gpu, pl_buf_params(
+            .size = bucket,
+            .host_readable = true,
+            .host_mapped = true,
+            .memory_type = PL_BUF_MEM_HOST,
+            .debug_tag = PL_DEBUG_TAG,
+        ));
+    }
+
+    if (!buf) {
+        RELEASE_CURRENT();
+        return false;
+    }
+
+    struct pl_tex_transfer_params fixed = *params;
+    fixed.buf = buf;
+    fixed.buf_offset = 0;
+    fixed.ptr = NULL;
+    fixed.callback = readback_cb;
+    fixed.priv = pl_alloc_struct(NULL, struct readback_ctx, {
+        .gpu = gpu,
+        .buf = buf,
+        .ptr = params->ptr,
+        .size = size,
+        .callback = params->callback,
+        .priv = params->priv,
+    });
+
+    // The callback is queued even on failure, and returns the buffer itself
+    *ok = gl_tex_download(gpu, &fixed);
+    RELEASE_CURRENT();
+    return true;
+}
+
 bool gl_tex_download(pl_gpu gpu, const struct pl_tex_transfer_params *params)
 {
     const gl_funcs *gl = gl_funcs_get(gpu);
@@ -985,10 +1457,19 @@ bool gl_tex_download(pl_gpu gpu, const struct pl_tex_transfer_params *params)
     struct pl_buf_gl *buf_gl = buf ? PL_PRIV(buf) : NULL;
     bool ok = true;
 
+    // Asynchronous downloads go through a PBO so the caller isn't blocked on
+    // the readback. Prefer importing the host pointer directly when possible,
+    // and reading back into a pooled mapped buffer otherwise.
     if (params->callback && !buf) {
         size_t buf_size = pl_tex_transfer_size(params);
         const size_t min_size = 32*1024; // 32 KiB
-        if (buf_size >= min_size && buf_size <= gpu->limits.max_buf_size)
+        bool use_pbo = buf_size >= min_size && buf_size <= gpu->limits.max_buf_size;
+        bool can_import = !params->no_import && (gpu->import_caps.buf & PL_HANDLE_HOST_PTR);
+        if (use_pbo && can_import)
+            return pl_tex_download_pbo(gpu, params);
+        if (buf_size <= gpu->limits.max_buf_size && download_async(gpu, params, &ok))
+            return ok;
+        if (use_pbo)
             return pl_tex_download_pbo(gpu, params);
     }
 
@@ -1064,6 +1545,7 @@ bool gl_tex_download(pl_gpu gpu, const struct pl_tex_transfer_params *params)
         }
     }
 
+    gl_tex_fence(gpu, tex);
     if (params->callback) {
         PL_ARRAY_APPEND(gpu, p->callbacks, (struct gl_cb) {
             .sync = gl->FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0),
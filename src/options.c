@@ -19,6 +19,7 @@
 
 #include "common.h"
 #include "log.h"
+#include "pl_thread.h"
 
 #include <libplacebo/options.h>
 
@@ -48,6 +49,7 @@ static const struct pl_options_t defaults = {
     .cone_params        = { PL_CONE_NONE, 1.0 },
     .deinterlace_params = { PL_DEINTERLACE_DEFAULTS },
     .distort_params     = { PL_DISTORT_DEFAULTS },
+    .adaptive_params    = { PL_ADAPTIVE_DEFAULTS },
     .upscaler = {
         .name           = "custom",
         .description    = "Custom upscaler",
@@ -86,6 +88,7 @@ static inline void copy_filter(struct pl_filter_config *dst,
     dst->blur   = src->blur;
     dst->taper  = src->taper;
     dst->polar  = src->polar;
+    dst->separable_terms = src->separable_terms;
     for (int i = 0; i < PL_FILTER_MAX_PARAMS; i++) {
         dst->params[i]  = src->params[i];
         dst->wparams[i] = src->wparams[i];
@@ -113,6 +116,7 @@ static inline void redirect_params(pl_options opts)
     REDIRECT_PARAMS(cone_params);
     REDIRECT_PARAMS(deinterlace_params);
     REDIRECT_PARAMS(distort_params);
+    REDIRECT_PARAMS(adaptive_params);
 }
 
 void pl_options_reset(pl_options opts, const struct pl_render_params *preset)
@@ -185,6 +189,7 @@ void pl_options_add_hook(pl_options opts, const struct pl_hook *hook)
     make_hooks_internal(opts);
     PL_ARRAY_APPEND(opts, p->hooks, hook);
     opts->params.hooks = p->hooks.elem;
+    opts->params.num_hooks = p->hooks.num;
 }
 
 void pl_options_insert_hook(pl_options opts, const struct pl_hook *hook, int idx)
@@ -193,6 +198,7 @@ void pl_options_insert_hook(pl_options opts, const struct pl_hook *hook, int idx
     make_hooks_internal(opts);
     PL_ARRAY_INSERT_AT(opts, p->hooks, idx, hook);
     opts->params.hooks = p->hooks.elem;
+    opts->params.num_hooks = p->hooks.num;
 }
 
 void pl_options_remove_hook_at(pl_options opts, int idx)
@@ -201,6 +207,123 @@ void pl_options_remove_hook_at(pl_options opts, int idx)
     make_hooks_internal(opts);
     PL_ARRAY_REMOVE_AT(p->hooks, idx);
     opts->params.hooks = p->hooks.elem;
+    opts->params.num_hooks = p->hooks.num;
+}
+
+struct snapshot_priv {
+    pl_rc_t rc;
+};
+
+pl_opt_snapshot pl_options_snapshot(pl_options opts)
+{
+    struct pl_options_t *snap = pl_alloc_obj(NULL, snap, struct snapshot_priv);
+    struct snapshot_priv *p = PL_PRIV(snap);
+    atomic_init(&p->rc, 1);
+    *snap = *opts;
+
+    // Redirect all pointers into `opts` to the corresponding snapshot fields
+#define RELOCATE(field) do                                                  \
+{                                                                           \
+    const uintptr_t addr = (uintptr_t) snap->params.field;                  \
+    if (addr >= (uintptr_t) opts && addr < (uintptr_t) (opts + 1))          \
+        snap->params.field = (void *) ((uintptr_t) snap + (addr - (uintptr_t) opts)); \
+} while (0)
+
+    RELOCATE(upscaler);
+    RELOCATE(downscaler);
+    RELOCATE(plane_upscaler);
+    RELOCATE(plane_downscaler);
+    RELOCATE(frame_mixer);
+    RELOCATE(deband_params);
+    RELOCATE(sigmoid_params);
+    RELOCATE(color_adjustment);
+    RELOCATE(peak_detect_params);
+    RELOCATE(color_map_params);
+    RELOCATE(dither_params);
+    RELOCATE(icc_params);
+    RELOCATE(cone_params);
+    RELOCATE(blend_params);
+    RELOCATE(deinterlace_params);
+    RELOCATE(distort_params);
+    RELOCATE(adaptive_params);
+#undef RELOCATE
+
+    // The hooks array may be modified or reallocated along with `opts`
+    if (snap->params.num_hooks) {
+        snap->params.hooks = pl_memdup(snap, snap->params.hooks,
+                                       snap->params.num_hooks * sizeof(snap->params.hooks[0]));
+    }
+
+    return snap;
+}
+
+pl_opt_snapshot pl_opt_snapshot_ref(pl_opt_snapshot snap)
+{
+    struct snapshot_priv *p = PL_PRIV(snap);
+    pl_rc_ref(&p->rc);
+    return snap;
+}
+
+void pl_opt_snapshot_unref(pl_opt_snapshot *psnap)
+{
+    pl_opt_snapshot snap = *psnap;
+    if (!snap)
+        return;
+
+    struct snapshot_priv *p = PL_PRIV(snap);
+    if (pl_rc_deref(&p->rc))
+        pl_free((void *) snap);
+    *psnap = NULL;
+}
+
+struct pl_opt_source_t {
+    pl_mutex lock; // only held to swap or ref `current`
+    _Atomic(pl_opt_snapshot) current;
+};
+
+pl_opt_source pl_opt_source_create(pl_opt_snapshot initial)
+{
+    struct pl_opt_source_t *src = pl_zalloc_ptr(NULL, src);
+    pl_mutex_init(&src->lock);
+    atomic_init(&src->current, pl_opt_snapshot_ref(initial));
+    return src;
+}
+
+void pl_opt_source_destroy(pl_opt_source *psrc)
+{
+    pl_opt_source src = *psrc;
+    if (!src)
+        return;
+
+    pl_opt_snapshot snap = atomic_load(&src->current);
+    pl_opt_snapshot_unref(&snap);
+    pl_mutex_destroy(&src->lock);
+    pl_free(src);
+    *psrc = NULL;
+}
+
+void pl_opt_source_publish(pl_opt_source src, pl_opt_snapshot snap)
+{
+    pl_opt_snapshot_ref(snap);
+    pl_mutex_lock(&src->lock);
+    pl_opt_snapshot old = atomic_exchange(&src->current, snap);
+    pl_mutex_unlock(&src->lock);
+    pl_opt_snapshot_unref(&old);
+}
+
+bool pl_opt_source_update(pl_opt_source src, pl_opt_snapshot *snap)
+{
+    // Fast path: `*snap` is referenced by the caller, so its address can't
+    // be reused by a different snapshot while this comparison is made
+    if (atomic_load_explicit(&src->current, memory_order_acquire) == *snap)
+        return false;
+
+    pl_mutex_lock(&src->lock);
+    pl_opt_snapshot cur = pl_opt_snapshot_ref(atomic_load(&src->current));
+    pl_mutex_unlock(&src->lock);
+    pl_opt_snapshot_unref(snap);
+    *snap = cur;
+    return true;
 }
 
 // Options printing/parsing context
@@ -321,27 +444,11 @@ const char *pl_options_save(pl_options opts)
     return p->saved.len ? (char *) p->saved.buf : "";
 }
 
-static bool option_set_raw(pl_options opts, pl_str k, pl_str v)
+static pl_opt find_option(pl_str key);
+
+static bool option_parse(pl_options opts, pl_opt opt, pl_str v)
 {
     struct priv *p = PL_PRIV(opts);
-    k = pl_str_strip(k);
-    v = pl_str_strip(v);
-
-    pl_opt opt;
-    for (opt = pl_option_list; opt->key; opt++) {
-        if (pl_str_equals0(k, opt->key))
-            goto found;
-    }
-
-    PL_ERR(p, "Unrecognized option '%.*s', in '%.*s=%.*s'",
-           PL_STR_FMT(k), PL_STR_FMT(k), PL_STR_FMT(v));
-    return false;
-
-found:
-    PL_TRACE(p, "Parsing option '%s' = '%.*s'", opt->key, PL_STR_FMT(v));
-    if (opt->deprecated)
-        PL_WARN(p, "Option '%s' is deprecated", opt->key);
-
     struct opt_ctx_t ctx = {
         .log  = p->log,
         .opts = opts,
@@ -353,6 +460,31 @@ found:
     return priv->parse(&ctx, v, val);
 }
 
+static pl_opt option_lookup(pl_log log, pl_str k, pl_str v)
+{
+    pl_opt opt = find_option(k);
+    if (!opt) {
+        pl_err(log, "Unrecognized option '%.*s', in '%.*s=%.*s'",
+               PL_STR_FMT(k), PL_STR_FMT(k), PL_STR_FMT(v));
+        return NULL;
+    }
+
+    pl_trace(log, "Parsing option '%s' = '%.*s'", opt->key, PL_STR_FMT(v));
+    if (opt->deprecated)
+        pl_warn(log, "Option '%s' is deprecated", opt->key);
+    return opt;
+}
+
+static bool option_set_raw(pl_options opts, pl_str k, pl_str v)
+{
+    struct priv *p = PL_PRIV(opts);
+    k = pl_str_strip(k);
+    v = pl_str_strip(v);
+
+    pl_opt opt = option_lookup(p->log, k, v);
+    return opt && option_parse(opts, opt, v);
+}
+
 bool pl_options_set_str(pl_options opts, const char *key, const char *value)
 {
     return option_set_raw(opts, pl_str0(key), pl_str0(value));
@@ -903,7 +1035,9 @@ static bool parse_scaler_preset(opt_ctx p, pl_str str, void *out)
     OPT_FLOAT(PREFIX"_param2", NAME" parameter 2", FIELD.params[1]),                  \
     OPT_FLOAT(PREFIX"_wparam1", NAME" window parameter 1", FIELD.wparams[0]),         \
     OPT_FLOAT(PREFIX"_wparam2", NAME" window parameter 2", FIELD.wparams[1]),         \
-    OPT_BOOL(PREFIX"_polar", NAME" polar", FIELD.polar)
+    OPT_BOOL(PREFIX"_polar", NAME" polar", FIELD.polar),                            \
+    OPT_INT(PREFIX"_separable_terms", NAME" separable terms", FIELD.separable_terms,  \
+            .max = PL_FILTER_MAX_TERMS)
 
 const struct pl_opt_t pl_option_list[] = {
     OPT_PRESET("preset", "Global preset", params, LIST(
@@ -926,6 +1060,7 @@ const struct pl_opt_t pl_option_list[] = {
     OPT_INT("deband_iterations", "Debanding iterations", deband_params.iterations, .max = 16),
     OPT_FLOAT("deband_threshold", "Debanding threshold", deband_params.threshold, .max = 1000.0),
     OPT_FLOAT("deband_radius", "Debanding radius", deband_params.radius, .max = 1000.0),
+    OPT_BOOL("deband_adaptive", "Adaptive debanding", deband_params.adaptive),
     OPT_FLOAT("deband_grain", "Debanding grain", deband_params.grain, .max = 1000.0),
     OPT_FLOAT("deband_grain_neutral_r", "Debanding grain neutral R", deband_params.grain_neutral[0]),
     OPT_FLOAT("deband_grain_neutral_g", "Debanding grain neutral G", deband_params.grain_neutral[1]),
@@ -962,6 +1097,8 @@ const struct pl_opt_t pl_option_list[] = {
     OPT_FLOAT("minimum_peak", "Minimum detected peak", peak_detect_params.minimum_peak, .max = 100.0, .deprecated = true),
     OPT_FLOAT("peak_percentile", "Peak detection percentile", peak_detect_params.percentile, .max = 100.0),
     OPT_BOOL("allow_delayed_peak", "Allow delayed peak detection", peak_detect_params.allow_delayed),
+    OPT_INT("peak_max_delay", "Maximum delay of peak detection results", peak_detect_params.max_delay, .max = PL_PEAK_DETECT_MAX_DELAY),
+    OPT_INT("peak_stride", "Peak detection pixel stride", peak_detect_params.stride, .max = PL_PEAK_DETECT_MAX_STRIDE),
 
     // Color mapping
     OPT_ENABLE_PARAMS("color_map", "Enable color mapping", color_map_params),
@@ -979,6 +1116,7 @@ const struct pl_opt_t pl_option_list[] = {
     OPT_INT("lut3d_size_C", "Gamut 3DLUT size C", color_map_params.lut3d_size[1], .max = 1024),
     OPT_INT("lut3d_size_h", "Gamut 3DLUT size h", color_map_params.lut3d_size[2], .max = 1024),
     OPT_BOOL("lut3d_tricubic", "Gamut 3DLUT tricubic interpolation", color_map_params.lut3d_tricubic),
+    OPT_BOOL("lut3d_adaptive", "Gamut 3DLUT adaptive size", color_map_params.lut3d_adaptive),
     OPT_BOOL("gamut_expansion", "Gamut expansion", color_map_params.gamut_expansion),
     OPT_NAMED("tone_mapping", "Tone mapping function", color_map_params.tone_mapping_function,
               pl_tone_map_functions),
@@ -1022,7 +1160,8 @@ const struct pl_opt_t pl_option_list[] = {
              {"blue",         PL_DITHER_BLUE_NOISE},
              {"ordered_lut",  PL_DITHER_ORDERED_LUT},
              {"ordered",      PL_DITHER_ORDERED_FIXED},
-             {"white",        PL_DITHER_WHITE_NOISE})),
+             {"white",        PL_DITHER_WHITE_NOISE},
+             {"blue_temporal", PL_DITHER_BLUE_NOISE_TEMPORAL})),
     OPT_INT("dither_lut_size", "Dither LUT size", dither_params.lut_size, .min = 1, .max = 8),
     OPT_BOOL("dither_temporal", "Temporal dithering", dither_params.temporal),
 
@@ -1115,6 +1254,7 @@ const struct pl_opt_t pl_option_list[] = {
     // Misc renderer settings
     OPT_NAMED("error_diffusion", "Error diffusion kernel", params.error_diffusion,
               pl_error_diffusion_kernels),
+    OPT_BOOL("tiled_error_diffusion", "Tiled error diffusion", params.tiled_error_diffusion),
     OPT_ENUM("lut_type", "Color mapping LUT type", params.lut_type, LIST(
              {"unknown",    PL_LUT_UNKNOWN},
              {"native",     PL_LUT_NATIVE},
@@ -1137,6 +1277,7 @@ const struct pl_opt_t pl_option_list[] = {
 
     // Performance / quality trade-offs and debugging options
     OPT_BOOL("skip_anti_aliasing", "Skip anti-aliasing", params.skip_anti_aliasing),
+    OPT_BOOL("box_prescaling", "Box filter before large downscales", params.box_prescaling),
     OPT_INT("lut_entries", "Scaler LUT entries", params.lut_entries, .max = 256, .deprecated = true),
     OPT_FLOAT("polar_cutoff", "Polar LUT cutoff", params.polar_cutoff, .max = 1.0, .deprecated = true),
     OPT_BOOL("preserve_mixing_cache", "Preserve mixing cache", params.preserve_mixing_cache),
@@ -1149,18 +1290,167 @@ const struct pl_opt_t pl_option_list[] = {
     OPT_BOOL("disable_dither_gamma_correction", "Disable gamma-correct dithering", params.disable_dither_gamma_correction),
     OPT_BOOL("disable_fbos", "Disable FBOs", params.disable_fbos),
     OPT_BOOL("force_low_bit_depth_fbos", "Force 8-bit FBOs", params.force_low_bit_depth_fbos),
+    OPT_BOOL("packed_fbos", "Packed 32-bit FBOs", params.packed_fbos),
     OPT_BOOL("dynamic_constants", "Dynamic constants", params.dynamic_constants),
+    OPT_BOOL("parallel_planes", "Dispatch plane passes as compute shaders", params.parallel_planes),
+    OPT_BOOL("low_precision", "Reduced precision intermediates", params.low_precision),
+    OPT_BOOL("fast_transfer", "Approximate PQ transfer function", params.fast_transfer),
+    OPT_INT("timer_interval", "Pass timing interval (frames)", params.timer_interval, .max = 1000),
+
+    // Adaptive quality
+    OPT_ENABLE_PARAMS("adaptive", "Enable adaptive quality", adaptive_params),
+    OPT_PRESET("adaptive_preset", "Adaptive quality preset", adaptive_params, LIST(
+               {"default", &pl_adaptive_default_params})),
+    OPT_FLOAT("adaptive_target", "Adaptive quality target frame time", adaptive_params.target_ms, .max = 1000.0),
+    OPT_FLOAT("adaptive_headroom", "Adaptive quality headroom", adaptive_params.headroom, .max = 1.0),
+    OPT_INT("adaptive_frames_down", "Adaptive quality frames before reducing", adaptive_params.frames_down, .max = 1000),
+    OPT_INT("adaptive_frames_up", "Adaptive quality frames before increasing", adaptive_params.frames_up, .max = 10000),
     {0},
 };
 
 const int pl_option_count = PL_ARRAY_SIZE(pl_option_list) - 1;
 
-pl_opt pl_find_option(const char *key)
+// Index of all options, sorted by key, built on first use
+static struct {
+    pl_static_mutex lock;
+    atomic_bool ready;
+    pl_opt opts[PL_ARRAY_SIZE(pl_option_list) - 1];
+} option_index = {
+    .lock = PL_STATIC_MUTEX_INITIALIZER,
+};
+
+static int compare_opt(const void *pa, const void *pb)
 {
-    for (int i = 0; i < pl_option_count; i++) {
-        if (!strcmp(key, pl_option_list[i].key))
-            return &pl_option_list[i];
+    pl_opt a = *(pl_opt *) pa, b = *(pl_opt *) pb;
+    return strcmp(a->key, b->key);
+}
+
+static int compare_key(pl_str key, const char *optkey)
+{
+    int cmp = strncmp((const char *) key.buf, optkey, key.len);
+    return cmp ? cmp : -(unsigned char) optkey[key.len];
+}
+
+static pl_opt find_option(pl_str key)
+{
+    if (!atomic_load_explicit(&option_index.ready, memory_order_acquire)) {
+        pl_static_mutex_lock(&option_index.lock);
+        if (!atomic_load_explicit(&option_index.ready, memory_order_relaxed)) {
+            for (int i = 0; i < pl_option_count; i++)
+                option_index.opts[i] = &pl_option_list[i];
+            qsort(option_index.opts, pl_option_count, sizeof(pl_opt), compare_opt);
+            atomic_store_explicit(&option_index.ready, true, memory_order_release);
+        }
+        pl_static_mutex_unlock(&option_index.lock);
+    }
+
+    if (memchr(key.buf, '\0', key.len))
+        return NULL;
+
+    int lo = 0, hi = pl_option_count - 1;
+    while (lo <= hi) {
+        const int mid = (lo + hi) / 2;
+        pl_opt opt = option_index.opts[mid];
+        const int cmp = compare_key(key, opt->key);
+        if (cmp == 0)
+            return opt;
+        if (cmp < 0) {
+            hi = mid - 1;
+        } else {
+            lo = mid + 1;
+        }
     }
 
     return NULL;
 }
+
+pl_opt pl_find_option(const char *key)
+{
+    return find_option(pl_str0(key));
+}
+
+// Options whose parsed values don't depend on the state of the `pl_options`
+// they are parsed into, and can thus be copied around as-is
+static bool option_is_pure(pl_opt opt)
+{
+    opt_priv priv = opt->priv;
+    return priv->parse == parse_bool  ||
+           priv->parse == parse_int   ||
+           priv->parse == parse_float ||
+           priv->parse == parse_enum  ||
+           priv->parse == parse_named;
+}
+
+struct patch_entry {
+    pl_opt opt;
+    pl_str value;   // for impure options, re-parsed on application
+    bool pure;
+    uint8_t data[sizeof(uint64_t)]; // parsed value, for pure options
+};
+
+struct pl_opt_patch_t {
+    PL_ARRAY(struct patch_entry) entries;
+};
+
+pl_opt_patch pl_opt_patch_compile(pl_log log, const char *str)
+{
+    struct pl_opt_patch_t *patch = pl_zalloc_ptr(NULL, patch);
+    pl_options scratch = pl_options_alloc(log);
+    bool ok = true;
+
+    pl_str rest = pl_strdup(patch, pl_str0(str));
+    while (rest.len) {
+        pl_str kv = pl_str_strip(pl_str_split_chars(rest, " ,;:\n", &rest));
+        if (!kv.len)
+            continue;
+        pl_str v, k = pl_str_split_char(kv, '=', &v);
+        k = pl_str_strip(k);
+        v = pl_str_strip(v);
+
+        pl_opt opt = option_lookup(log, k, v);
+        if (!opt || !option_parse(scratch, opt, v)) {
+            ok = false;
+            continue;
+        }
+
+        struct patch_entry entry = {
+            .opt   = opt,
+            .value = v,
+            .pure  = option_is_pure(opt),
+        };
+
+        if (entry.pure) {
+            opt_priv priv = opt->priv;
+            pl_assert(priv->size <= sizeof(entry.data));
+            memcpy(entry.data, (void *) ((uintptr_t) scratch + priv->offset),
+                   priv->size);
+        }
+
+        PL_ARRAY_APPEND(patch, patch->entries, entry);
+    }
+
+    pl_options_free(&scratch);
+    if (!ok)
+        pl_free_ptr(&patch);
+    return patch;
+}
+
+void pl_opt_patch_free(pl_opt_patch *patch)
+{
+    pl_free_ptr((void **) patch);
+}
+
+void pl_options_apply_patch(pl_options opts, pl_opt_patch patch)
+{
+    for (int i = 0; i < patch->entries.num; i++) {
+        const struct patch_entry *entry = &patch->entries.elem[i];
+        opt_priv priv = entry->opt->priv;
+        if (entry->pure) {
+            memcpy((void *) ((uintptr_t) opts + priv->offset), entry->data,
+                   priv->size);
+        } else {
+            bool ok = option_parse(opts, entry->opt, entry->value);
+            pl_assert(ok);
+        }
+    }
+}
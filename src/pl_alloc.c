@@ -24,7 +24,7 @@ struct header {
 #endif
     size_t size;
     struct header *parent;
-    struct ext *ext;
+    struct ext *ext; // or tagged `struct arena *`, see `get_arena`
 
     // Pointer to actual data, for alignment purposes
     max_align_t data[];
@@ -38,10 +38,53 @@ struct ext {
     struct header *children[];
 };
 
+// Arena chunks, from which all allocations inside an arena are carved
+struct chunk {
+    struct chunk *next;
+    size_t size;
+    size_t used;
+    max_align_t data[];
+};
+
+struct arena {
+    struct header *root;    // the arena allocation itself
+    struct chunk *chunks;   // all chunks, in order of allocation
+    struct chunk *cur;      // chunk currently being allocated from
+    struct header *last;    // most recent allocation, may be grown/freed in place
+    size_t chunk_size;
+    struct ext *foreign;    // regular allocations reparented onto the arena
+};
+
 #define PTR_OFFSET offsetof(struct header, data)
 #define MAX_ALLOC (SIZE_MAX - PTR_OFFSET)
 #define MINIMUM_CHILDREN 4
 
+// Both the arena root and all allocations carved out of it have their `ext`
+// field replaced by a pointer to the `struct arena`, tagged with this bit
+#define ARENA_TAG ((uintptr_t) 1)
+
+static inline struct arena *get_arena(const struct header *h)
+{
+    uintptr_t ext = (uintptr_t) h->ext;
+    return (ext & ARENA_TAG) ? (struct arena *) (ext & ~ARENA_TAG) : NULL;
+}
+
+// Returns the arena `h` was carved out of, or NULL for regular allocations
+// (including the arena root itself)
+static inline struct arena *arena_of(const struct header *h)
+{
+    struct arena *a = get_arena(h);
+    return a && a->root != h ? a : NULL;
+}
+
+// Children list of `h`. Allocations inside an arena never track their
+// children, so this is only valid for regular allocations and arena roots.
+static inline struct ext **ext_ptr(struct header *h)
+{
+    struct arena *a = get_arena(h);
+    return a ? &a->foreign : &h->ext;
+}
+
 static inline struct header *get_header(void *ptr)
 {
     if (!ptr)
@@ -55,6 +98,47 @@ static inline struct header *get_header(void *ptr)
     return hdr;
 }
 
+static atomic_bool stats_enabled;
+_Thread_local enum pl_alloc_scope pl_alloc_cur_scope;
+static struct {
+    atomic_uint_fast64_t allocs, reallocs, frees, bytes, sys_calls;
+} stats[PL_ALLOC_SCOPE_COUNT];
+
+#define COUNT(field, n)                                                         \
+    do {                                                                        \
+        if (atomic_load_explicit(&stats_enabled, memory_order_relaxed))         \
+            atomic_fetch_add_explicit(&stats[pl_alloc_cur_scope].field, n, memory_order_relaxed); \
+    } while (0)
+
+void pl_alloc_stats_enable(bool enable)
+{
+    atomic_store(&stats_enabled, enable);
+}
+
+void pl_alloc_stats_reset(void)
+{
+    for (int i = 0; i < PL_ALLOC_SCOPE_COUNT; i++) {
+        atomic_store(&stats[i].allocs, 0);
+        atomic_store(&stats[i].reallocs, 0);
+        atomic_store(&stats[i].frees, 0);
+        atomic_store(&stats[i].bytes, 0);
+        atomic_store(&stats[i].sys_calls, 0);
+    }
+}
+
+void pl_alloc_stats_get(struct pl_alloc_stats out[PL_ALLOC_SCOPE_COUNT])
+{
+    for (int i = 0; i < PL_ALLOC_SCOPE_COUNT; i++) {
+        out[i] = (struct pl_alloc_stats) {
+            .allocs     = atomic_load(&stats[i].allocs),
+            .reallocs   = atomic_load(&stats[i].reallocs),
+            .frees      = atomic_load(&stats[i].frees),
+            .bytes      = atomic_load(&stats[i].bytes),
+            .sys_calls  = atomic_load(&stats[i].sys_calls),
+        };
+    }
+}
+
 static inline void *oom(void)
 {
     fprintf(stderr, "out of memory\n");
@@ -66,19 +150,26 @@ static inline struct ext *alloc_ext(struct header *h)
     if (!h)
         return NULL;
 
-    if (!h->ext) {
-        h->ext = malloc(sizeof(struct ext) + MINIMUM_CHILDREN * sizeof(void *));
-        if (!h->ext)
+    struct ext **ext = ext_ptr(h);
+    if (!*ext) {
+        *ext = malloc(sizeof(struct ext) + MINIMUM_CHILDREN * sizeof(void *));
+        if (!*ext)
             oom();
-        h->ext->num_children = 0;
-        h->ext->children_size = MINIMUM_CHILDREN;
+        COUNT(sys_calls, 1);
+        (*ext)->num_children = 0;
+        (*ext)->children_size = MINIMUM_CHILDREN;
     }
 
-    return h->ext;
+    return *ext;
 }
 
 static inline void attach_child(struct header *parent, struct header *child)
 {
+    // Regular allocations attached to anything inside an arena are owned by
+    // the arena root, and released when the arena is reset
+    if (parent && get_arena(parent))
+        parent = get_arena(parent)->root;
+
     child->parent = parent;
     if (!parent)
         return;
@@ -90,8 +181,9 @@ static inline void attach_child(struct header *parent, struct header *child)
         ext = realloc(ext, sizeof(struct ext) + new_size * sizeof(void *));
         if (!ext)
             oom();
+        COUNT(sys_calls, 1);
         ext->children_size = new_size;
-        parent->ext = ext;
+        *ext_ptr(parent) = ext;
     }
 
     ext->children[ext->num_children++] = child;
@@ -103,7 +195,7 @@ static inline void unlink_child(struct header *parent, struct header *child)
     if (!parent)
         return;
 
-    struct ext *ext = parent->ext;
+    struct ext *ext = *ext_ptr(parent);
     for (size_t i = 0; i < ext->num_children; i++) {
         if (ext->children[i] == child) {
             memmove(&ext->children[i], &ext->children[i + 1],
@@ -115,14 +207,107 @@ static inline void unlink_child(struct header *parent, struct header *child)
     assert(!"unlinking orphaned child?");
 }
 
+static struct header *arena_alloc(struct arena *a, size_t size)
+{
+    const size_t need = PTR_OFFSET + PL_ALIGN_MEM(size);
+    struct chunk *c = a->cur;
+    while (c && c->size - c->used < need)
+        c = c->next;
+
+    if (!c) {
+        size_t chunk_size = a->chunk_size;
+        for (struct chunk *old = a->chunks; old; old = old->next)
+            chunk_size = PL_MAX(chunk_size, old->size * 2);
+        chunk_size = PL_MAX(chunk_size, need);
+
+        c = malloc(sizeof(struct chunk) + chunk_size);
+        if (!c)
+            oom();
+        COUNT(sys_calls, 1);
+        *c = (struct chunk) { .size = chunk_size };
+
+        struct chunk **tail = &a->chunks;
+        while (*tail)
+            tail = &(*tail)->next;
+        *tail = c;
+    }
+
+    struct header *h = (struct header *) ((uintptr_t) c->data + c->used);
+    c->used += need;
+    a->cur = c;
+    a->last = h;
+
+#ifndef NDEBUG
+    h->magic = MAGIC;
+#endif
+    h->size = size;
+    h->parent = a->root;
+    h->ext = (struct ext *) ((uintptr_t) a | ARENA_TAG);
+    return h;
+}
+
+// Releases everything allocated from `a`, in O(1) (plus the number of
+// regular allocations which were reparented onto it)
+static void arena_reset(struct arena *a)
+{
+    if (a->foreign) {
+        struct ext *ext = a->foreign;
+        for (size_t i = 0; i < ext->num_children; i++) {
+            ext->children[i]->parent = NULL; // prevent recursive access
+            pl_free(ext->children[i]->data);
+        }
+        ext->num_children = 0;
+    }
+
+    if (a->chunks && a->chunks->next) {
+        // More than one chunk was needed, so replace them all by a single
+        // chunk big enough to hold everything, to get zero allocations in
+        // the steady state
+        size_t total = 0;
+        for (struct chunk *c = a->chunks, *next; c; c = next) {
+            next = c->next;
+            total += c->size;
+            free(c);
+        }
+
+        a->chunks = malloc(sizeof(struct chunk) + total);
+        if (!a->chunks)
+            oom();
+        COUNT(sys_calls, 1);
+        *a->chunks = (struct chunk) { .size = total };
+    } else if (a->chunks) {
+        a->chunks->used = 0;
+    }
+
+    a->cur = a->chunks;
+    a->last = NULL;
+}
+
+void *pl_arena_create(void *parent, size_t chunk_size)
+{
+    // Always a regular allocation, even if `parent` is (inside) an arena
+    struct arena *a = pl_zalloc_ptr(NULL, a);
+    a->root = get_header(a);
+    a->root->ext = (struct ext *) ((uintptr_t) a | ARENA_TAG);
+    a->chunk_size = PL_ALIGN_MEM(PL_DEF(chunk_size, 4096));
+    return pl_steal(parent, a);
+}
+
 void *pl_alloc(void *parent, size_t size)
 {
     if (size >= MAX_ALLOC)
         return oom();
 
+    COUNT(allocs, 1);
+    COUNT(bytes, size);
+    struct header *ph = get_header(parent);
+    if (ph && get_arena(ph))
+        return arena_alloc(get_arena(ph), size)->data;
+
     struct header *h = malloc(PTR_OFFSET + size);
     if (!h)
         return oom();
+    COUNT(sys_calls, 1);
 
 #ifndef NDEBUG
     h->magic = MAGIC;
@@ -139,9 +324,19 @@ void *pl_zalloc(void *parent, size_t size)
     if (size >= MAX_ALLOC)
         return oom();
 
+    COUNT(allocs, 1);
+    COUNT(bytes, size);
+    struct header *ph = get_header(parent);
+    if (ph && get_arena(ph)) {
+        struct header *h = arena_alloc(get_arena(ph), size);
+        memset(h->data, 0, size);
+        return h->data;
+    }
+
     struct header *h = calloc(1, PTR_OFFSET + size);
     if (!h)
         return oom();
+    COUNT(sys_calls, 1);
 
 #ifndef NDEBUG
     h->magic = MAGIC;
@@ -159,21 +354,42 @@ void *pl_realloc(void *parent, void *ptr, size_t size)
     if (!ptr)
         return pl_alloc(parent, size);
 
+    COUNT(reallocs, 1);
+    COUNT(bytes, size);
     struct header *h = get_header(ptr);
-    assert(get_header(parent) == h->parent);
+    struct header *ph = get_header(parent);
+    assert(ph == h->parent || (ph && get_arena(ph) && get_arena(ph)->root == h->parent));
     if (h->size == size)
         return ptr;
 
+    struct arena *a = arena_of(h);
+    if (a) {
+        // Try growing/shrinking the most recent allocation in place
+        struct chunk *c = a->cur;
+        size_t end = (uintptr_t) h->data + PL_ALIGN_MEM(h->size) - (uintptr_t) c->data;
+        size_t new_end = end - PL_ALIGN_MEM(h->size) + PL_ALIGN_MEM(size);
+        if (h == a->last && end == c->used && new_end <= c->size) {
+            c->used = new_end;
+            h->size = size;
+            return ptr;
+        }
+
+        struct header *new_h = arena_alloc(a, size);
+        memcpy(new_h->data, h->data, PL_MIN(h->size, size));
+        return new_h->data;
+    }
+
     struct header *old_h = h;
     h = realloc(h, PTR_OFFSET + size);
     if (!h)
         return oom();
+    COUNT(sys_calls, 1);
 
     h->size = size;
 
     if (h != old_h) {
         if (h->parent) {
-            struct ext *ext = h->parent->ext;
+            struct ext *ext = *ext_ptr(h->parent);
             for (size_t i = 0; i < ext->num_children; i++) {
                 if (ext->children[i] == old_h) {
                     ext->children[i] = h;
@@ -199,16 +415,46 @@ void pl_free(void *ptr)
     if (!h)
         return;
 
+    COUNT(frees, 1);
+    struct arena *a = get_arena(h);
+    if (a && a->root != h) {
+        // Memory inside an arena is only released by resetting the arena,
+        // except for the most recent allocation, which can be undone
+        struct chunk *c = a->cur;
+        if (h == a->last && (uintptr_t) h->data + PL_ALIGN_MEM(h->size) ==
+                            (uintptr_t) c->data + c->used)
+        {
+            c->used = (uintptr_t) h - (uintptr_t) c->data;
+            a->last = NULL;
+        }
+        return;
+    }
+
     pl_free_children(ptr);
     unlink_child(h->parent, h);
 
-    free(h->ext);
+    if (a) {
+        for (struct chunk *c = a->chunks, *next; c; c = next) {
+            next = c->next;
+            free(c);
+        }
+        free(a->foreign);
+    } else {
+        free(h->ext);
+    }
     free(h);
 }
 
 void pl_free_children(void *ptr)
 {
     struct header *h = get_header(ptr);
+    struct arena *a = h ? get_arena(h) : NULL;
+    if (a) {
+        if (a->root == h)
+            arena_reset(a);
+        return;
+    }
+
     if (!h || !h->ext)
         return;
 
@@ -241,6 +487,19 @@ void *pl_steal(void *parent, void *ptr)
         return NULL;
 
     struct header *new_par = get_header(parent);
+    struct arena *a = arena_of(h);
+    if (a) {
+        if (new_par && get_arena(new_par) == a)
+            return ptr;
+
+        // Can't move memory out of an arena, so make a copy instead
+        void *copy = pl_alloc(parent, h->size);
+        memcpy(copy, ptr, h->size);
+        return copy;
+    }
+
+    if (new_par && get_arena(new_par))
+        new_par = get_arena(new_par)->root;
     if (new_par != h->parent) {
         unlink_child(h->parent, h);
         attach_child(new_par, h);
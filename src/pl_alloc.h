@@ -19,6 +19,7 @@
 
 #include <stdalign.h>
 #include <stdarg.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
@@ -58,6 +59,21 @@ void pl_free_children(void *ptr);
         *(ptr) = NULL;      \
     } while (0)
 
+// Create an arena, which can be used as a parent like any other allocation.
+// All allocations made on the arena (or on any allocation inside it) are
+// carved out of large chunks of `chunk_size` bytes (0 for the default) rather
+// than being allocated individually. `pl_free_children` on the arena releases
+// everything inside it at once, in O(1), and keeps the chunks around for
+// re-use, so a steady state workload makes no calls to the system allocator.
+// `pl_free` on the arena releases it entirely.
+//
+// Note: `pl_free` on an allocation inside an arena only reclaims its memory
+// if it was the most recent allocation; everything else lives until the next
+// reset. Regular allocations reparented onto the arena with `pl_steal` are
+// freed on reset. Allocations can't be moved out of an arena, so `pl_steal`
+// returns a copy in that case, and the return value must be used.
+void *pl_arena_create(void *parent, size_t chunk_size);
+
 // Get the current size of an allocation.
 size_t pl_get_size(const void *ptr);
 
@@ -68,7 +84,8 @@ size_t pl_get_size(const void *ptr);
             *(ptr) = pl_realloc(parent, *(ptr), _size); \
     } while (0)
 
-// Reparent an allocation onto a new parent
+// Reparent an allocation onto a new parent. Returns the (possibly relocated,
+// see `pl_arena_create`) allocation.
 void *pl_steal(void *parent, void *ptr);
 
 // Wrapper functions around common string utilities
@@ -79,6 +96,52 @@ char *pl_strndup0(void *parent, const char *str, size_t size);
 #define pl_memdup_ptr(parent, ptr) \
     (__typeof__(ptr)) pl_memdup(parent, ptr, sizeof(*(ptr)))
 
+// Allocation statistics, for debugging and benchmarking allocation churn.
+// Allocations are attributed to the subsystem (scope) active on the calling
+// thread at the time, see `PL_ALLOC_SCOPE`. Disabled by default.
+enum pl_alloc_scope {
+    PL_ALLOC_SCOPE_OTHER = 0,
+    PL_ALLOC_SCOPE_RENDERER,
+    PL_ALLOC_SCOPE_DISPATCH,
+    PL_ALLOC_SCOPE_SHADERS,
+    PL_ALLOC_SCOPE_BACKEND,
+    PL_ALLOC_SCOPE_COUNT,
+};
+
+struct pl_alloc_stats {
+    uint64_t allocs;    // number of pl_alloc/pl_zalloc calls
+    uint64_t reallocs;  // number of pl_realloc calls
+    uint64_t frees;     // number of pl_free calls
+    uint64_t bytes;     // total bytes requested by the above
+    uint64_t sys_calls; // resulting calls to the system allocator
+};
+
+void pl_alloc_stats_enable(bool enable);
+void pl_alloc_stats_reset(void);
+void pl_alloc_stats_get(struct pl_alloc_stats out[PL_ALLOC_SCOPE_COUNT]);
+
+// Scope of the calling thread. Internal, use `PL_ALLOC_SCOPE` instead.
+extern _Thread_local enum pl_alloc_scope pl_alloc_cur_scope;
+
+// Sets the scope for the calling thread, returning the previous one
+static inline enum pl_alloc_scope pl_alloc_scope_set(enum pl_alloc_scope scope)
+{
+    enum pl_alloc_scope prev = pl_alloc_cur_scope;
+    pl_alloc_cur_scope = scope;
+    return prev;
+}
+
+static inline void pl_alloc_scope_restore(enum pl_alloc_scope *prev)
+{
+    pl_alloc_scope_set(*prev);
+}
+
+// Attributes all allocations until the end of the enclosing block to `scope`
+#define PL_ALLOC_SCOPE(scope)                                           \
+    enum pl_alloc_scope _pl_alloc_scope                                 \
+        __attribute__((cleanup(pl_alloc_scope_restore), unused)) =      \
+        pl_alloc_scope_set(PL_ALLOC_SCOPE_##scope)
+
 // Helper functions for allocating public/private pairs, done by allocating
 // `priv` at the address of `pub` + sizeof(pub), rounded up to the maximum
 // alignment requirements.
@@ -113,21 +113,6 @@ size_t pl_strcspn(pl_str str, const char *reject)
     return str.len;
 }
 
-static inline bool pl_isspace(char c)
-{
-    switch (c) {
-    case ' ':
-    case '\n':
-    case '\r':
-    case '\t':
-    case '\v':
-    case '\f':
-        return true;
-    default:
-        return false;
-    }
-}
-
 pl_str pl_str_strip(pl_str str)
 {
     while (str.len && pl_isspace(str.buf[0])) {
@@ -255,6 +240,7 @@ struct pl_str_builder_t {
     PL_ARRAY(pl_str_template) templates;
     pl_str args;
     pl_str output;
+    size_t output_size; // upper bound on the output of the built-in templates
 };
 
 pl_str_builder pl_str_builder_alloc(void *alloc)
@@ -290,6 +276,9 @@ pl_str pl_str_builder_exec(pl_str_builder b)
 {
     pl_str args = b->args;
 
+    // Reserve space for the entire output up-front, so the templates below
+    // never need to grow the buffer (unless custom templates are involved)
+    grow_str(b, &b->output, b->output_size + 1);
     b->output.len = 0;
     for (int i = 0; i < b->templates.num; i++) {
         size_t consumed = b->templates.elem[i](b, &b->output, args.buf);
@@ -314,19 +303,27 @@ void pl_str_builder_concat(pl_str_builder b, const pl_str_builder append)
 {
     PL_ARRAY_CONCAT(b, b->templates, append->templates);
     pl_str_append_raw(b, &b->args, append->args.buf, append->args.len);
+    b->output_size += append->output_size;
 }
 
+struct str_ptr {
+    const char *str;
+    size_t len;
+};
+
 static size_t template_str_ptr(void *alloc, pl_str *buf, const uint8_t *args)
 {
-    const char *str;
+    struct str_ptr str;
     memcpy(&str, args, sizeof(str));
-    pl_str_append_raw(alloc, buf, str, strlen(str));
+    pl_str_append_raw(alloc, buf, str.str, str.len);
     return sizeof(str);
 }
 
 void pl_str_builder_const_str(pl_str_builder b, const char *str)
 {
-    pl_str_builder_append(b, template_str_ptr, &str, sizeof(str));
+    struct str_ptr arg = { str, strlen(str) };
+    pl_str_builder_append(b, template_str_ptr, &arg, sizeof(arg));
+    b->output_size += arg.len;
 }
 
 static size_t template_str(void *alloc, pl_str *buf, const uint8_t *args)
@@ -341,6 +338,7 @@ void pl_str_builder_str(pl_str_builder b, const pl_str str)
 {
     pl_str_builder_append(b, template_str, &str.len, sizeof(str.len));
     pl_str_append_raw(b, &b->args, str.buf, str.len);
+    b->output_size += str.len;
 }
 
 void pl_str_builder_printf_c(pl_str_builder b, const char *fmt, ...)
@@ -364,39 +362,46 @@ void pl_str_builder_vprintf_c(pl_str_builder b, const char *fmt, va_list ap)
 {
     pl_str_builder_append(b, template_printf, &fmt, sizeof(fmt));
 
-    // Push all of the variadic arguments directly onto `b->args`
+    // Push all of the variadic arguments directly onto `b->args`, while
+    // keeping track of the maximum formatted size of each conversion
+    size_t size = 0;
     for (const char *c; (c = strchr(fmt, '%')) != NULL; fmt = c + 1) {
+        size += c - fmt;
         c++;
         switch (c[0]) {
-#define WRITE(T, x) pl_str_append_raw(b, &b->args, &(T) {x}, sizeof(T))
-        case '%': continue;
-        case 'c': WRITE(char,       va_arg(ap, int)); break;
-        case 'd': WRITE(int,        va_arg(ap, int)); break;
-        case 'u': WRITE(unsigned,   va_arg(ap, unsigned)); break;
-        case 'f': WRITE(double,     va_arg(ap, double)); break;
+#define WRITE(T, x, max) do {                                           \
+            pl_str_append_raw(b, &b->args, &(T) {x}, sizeof(T));        \
+            size += max;                                                \
+        } while (0)
+        case '%': size++; continue;
+        case 'c': WRITE(char,       va_arg(ap, int), 1); break;
+        case 'd': WRITE(int,        va_arg(ap, int), 11); break;
+        case 'u': WRITE(unsigned,   va_arg(ap, unsigned), 10); break;
+        case 'f': WRITE(double,     va_arg(ap, double), 32); break;
         case 'h':
             assert(c[1] == 'x');
-            WRITE(unsigned short, va_arg(ap, unsigned));
+            WRITE(unsigned short, va_arg(ap, unsigned), 4);
             c++;
             break;
         case 'l':
             assert(c[1] == 'l');
             switch (c[2]) {
-            case 'u': WRITE(long long unsigned, va_arg(ap, long long unsigned)); break;
-            case 'd': WRITE(long long int,      va_arg(ap, long long int)); break;
+            case 'u': WRITE(long long unsigned, va_arg(ap, long long unsigned), 20); break;
+            case 'd': WRITE(long long int,      va_arg(ap, long long int), 20); break;
             default: abort();
             }
             c += 2;
             break;
         case 'z':
             assert(c[1] == 'u');
-            WRITE(size_t, va_arg(ap, size_t));
+            WRITE(size_t, va_arg(ap, size_t), 20);
             c++;
             break;
         case 's': {
             pl_str str = pl_str0(va_arg(ap, const char *));
             pl_str_append(b, &b->args, str);
             b->args.len++; // expand to include \0 byte (from pl_str_append)
+            size += str.len;
             break;
         }
         case '.': {
@@ -404,7 +409,7 @@ void pl_str_builder_vprintf_c(pl_str_builder b, const char *fmt, va_list ap)
             assert(c[2] == 's');
             int len = va_arg(ap, int);
             const char *str = va_arg(ap, const char *);
-            WRITE(int, len);
+            WRITE(int, len, len);
             pl_str_append_raw(b, &b->args, str, len);
             c += 2;
             break;
@@ -415,4 +420,6 @@ void pl_str_builder_vprintf_c(pl_str_builder b, const char *fmt, va_list ap)
         }
 #undef WRITE
     }
+
+    b->output_size += size + strlen(fmt);
 }
@@ -118,6 +118,21 @@ int pl_strchr(pl_str str, int c);
 size_t pl_strspn(pl_str str, const char *accept);
 size_t pl_strcspn(pl_str str, const char *reject);
 
+static inline bool pl_isspace(char c)
+{
+    switch (c) {
+    case ' ':
+    case '\n':
+    case '\r':
+    case '\t':
+    case '\v':
+    case '\f':
+        return true;
+    default:
+        return false;
+    }
+}
+
 // Strip leading/trailing whitespace
 pl_str pl_str_strip(pl_str str);
 
@@ -266,7 +281,9 @@ void pl_str_builder_reset(pl_str_builder builder);
 uint64_t pl_str_builder_hash(const pl_str_builder builder);
 
 // Executes a string builder, dispatching all templates. The resulting string
-// is guaranteed to be \0-terminated, as a minor convenience.
+// is guaranteed to be \0-terminated, as a minor convenience. The output buffer
+// is sized once up-front, based on the (maximum) size of all built-in
+// templates, so only custom templates may cause it to be reallocated.
 //
 // Calling any other `pl_str_builder_*` function on this builder causes the
 // contents of the returned string to become undefined.
@@ -37,6 +37,9 @@ int pl_mutex_destroy(pl_mutex *mutex);
 int pl_mutex_lock(pl_mutex *mutex);
 int pl_mutex_unlock(pl_mutex *mutex);
 
+// Returns 0 if the mutex was acquired, or nonzero if it is already locked
+int pl_mutex_trylock(pl_mutex *mutex);
+
 typedef void pl_cond;
 int pl_cond_init(pl_cond *cond);
 int pl_cond_destroy(pl_cond *cond);
@@ -61,6 +64,9 @@ int pl_thread_join(pl_thread thread);
 // Returns true if slept the full time, false otherwise
 bool pl_thread_sleep(double t);
 
+// Returns the number of logical CPUs available, or 1 if unknown
+int pl_thread_num_cpus(void);
+
 #endif
 
 // Actual platform-specific implementation
@@ -0,0 +1,183 @@
+/*
+ * This file is part of libplacebo.
+ *
+ * libplacebo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libplacebo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libplacebo. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "pl_thread.h"
+#include "pl_thread_pool.h"
+
+// Upper bound on the number of worker threads in the pool
+#define MAX_POOL_WORKERS 32
+
+struct pool_job {
+    struct pool_job *next;
+    pl_parallel_fn fun;
+    void *priv;
+    int count;
+    int next_idx;   // next index to be claimed
+    int num_done;   // number of completed invocations
+};
+
+static struct {
+    pl_mutex lock;
+    pl_cond wakeup;             // signalled when new jobs are queued
+    pl_cond done;               // signalled when a job completes
+    struct pool_job *jobs;      // jobs with unclaimed indices, oldest first
+    pl_thread workers[MAX_POOL_WORKERS];
+    int num_workers;
+    bool initialized;
+} pool;
+
+static pl_static_mutex pool_init_lock = PL_STATIC_MUTEX_INITIALIZER;
+
+// Claims the next index of `job`, unlinking it from the queue once all of its
+// indices have been handed out. Must be called with `pool.lock` held.
+static int claim_index(struct pool_job *job)
+{
+    pl_assert(job->next_idx < job->count);
+    int idx = job->next_idx++;
+    if (job->next_idx == job->count) {
+        for (struct pool_job **prev = &pool.jobs; *prev; prev = &(*prev)->next) {
+            if (*prev == job) {
+                *prev = job->next;
+                break;
+            }
+        }
+    }
+
+    return idx;
+}
+
+// Runs a single claimed index of `job`. Must be called with `pool.lock` held,
+// which is released for the duration of the call.
+static void run_index(struct pool_job *job, int idx)
+{
+    pl_mutex_unlock(&pool.lock);
+    job->fun(job->priv, idx);
+    pl_mutex_lock(&pool.lock);
+    if (++job->num_done == job->count)
+        pl_cond_broadcast(&pool.done);
+}
+
+static PL_THREAD_VOID pool_worker(void *arg)
+{
+    pl_mutex_lock(&pool.lock);
+    for (;;) {
+        struct pool_job *job = pool.jobs;
+        if (!job) {
+            pl_cond_wait(&pool.wakeup, &pool.lock);
+            continue;
+        }
+
+        run_index(job, claim_index(job));
+    }
+
+    pl_unreachable();
+}
+
+// Returns the number of available worker threads, starting them if needed
+static int pool_start(void)
+{
+    pl_static_mutex_lock(&pool_init_lock);
+    if (!pool.initialized) {
+        pl_mutex_init(&pool.lock);
+        pl_cond_init(&pool.wakeup);
+        pl_cond_init(&pool.done);
+
+        // The calling thread always participates, so leave one CPU for it
+        int num = PL_MIN(pl_thread_num_cpus() - 1, MAX_POOL_WORKERS);
+        while (pool.num_workers < num) {
+            pl_thread *thread = &pool.workers[pool.num_workers];
+            if (pl_thread_create(thread, pool_worker, NULL) != 0)
+                break;
+            pool.num_workers++;
+        }
+
+        pool.initialized = true;
+    }
+
+    int num_workers = pool.num_workers;
+    pl_static_mutex_unlock(&pool_init_lock);
+    return num_workers;
+}
+
+struct memcpy_job {
+    uint8_t *dst;
+    const uint8_t *src;
+    size_t size;
+    size_t chunk;
+};
+
+static void memcpy_chunk(void *priv, int index)
+{
+    struct memcpy_job *job = priv;
+    size_t offset = index * job->chunk;
+    memcpy(job->dst + offset, job->src + offset,
+           PL_MIN(job->chunk, job->size - offset));
+}
+
+void pl_parallel_memcpy(void *dst, const void *src, size_t size)
+{
+    if (size < PL_PARALLEL_MEMCPY_MIN) {
+        memcpy(dst, src, size);
+        return;
+    }
+
+    // A few chunks per thread, to balance out uneven scheduling
+    const size_t chunk_min = 1 << 20;
+    int chunks = PL_MIN((pool_start() + 1) * 4, size / chunk_min);
+    struct memcpy_job job = {
+        .dst   = dst,
+        .src   = src,
+        .size  = size,
+        .chunk = PL_ALIGN2(PL_DIV_UP(size, chunks), 4096),
+    };
+
+    pl_parallel_for(PL_DIV_UP(size, job.chunk), memcpy_chunk, &job);
+}
+
+void pl_parallel_for(int count, pl_parallel_fn fun, void *priv)
+{
+    if (count <= 0)
+        return;
+
+    if (count == 1 || !pool_start()) {
+        for (int i = 0; i < count; i++)
+            fun(priv, i);
+        return;
+    }
+
+    struct pool_job job = {
+        .fun   = fun,
+        .priv  = priv,
+        .count = count,
+    };
+
+    pl_mutex_lock(&pool.lock);
+    struct pool_job **tail = &pool.jobs;
+    while (*tail)
+        tail = &(*tail)->next;
+    *tail = &job;
+    pl_cond_broadcast(&pool.wakeup);
+
+    // Work on our own job until all indices have been claimed
+    while (job.next_idx < job.count)
+        run_index(&job, claim_index(&job));
+
+    while (job.num_done < job.count)
+        pl_cond_wait(&pool.done, &pool.lock);
+    pl_mutex_unlock(&pool.lock);
+}
@@ -0,0 +1,40 @@
+/*
+ * This file is part of libplacebo.
+ *
+ * libplacebo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libplacebo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libplacebo. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common.h"
+
+// Process-wide pool of persistent worker threads, shared by all CPU-side LUT
+// generation code (gamut mapping, ICC, filter kernels). Threads are started
+// lazily on first use and kept alive for the rest of the process lifetime.
+
+typedef void (*pl_parallel_fn)(void *priv, int index);
+
+// Invokes `fun(priv, i)` for every `i` in [0, count), in unspecified order,
+// spread across the worker pool. The calling thread also participates in the
+// work, and this function only returns once all invocations have completed.
+// Falls back to running everything on the calling thread if no worker threads
+// are available. Safe to call concurrently from multiple threads.
+void pl_parallel_for(int count, pl_parallel_fn fun, void *priv);
+
+// Equivalent to `memcpy`, but splits copies of at least
+// PL_PARALLEL_MEMCPY_MIN bytes into chunks spread across the worker pool.
+// Mainly useful for copying large frames into or out of mapped memory, where
+// a single thread can't saturate the available bandwidth.
+#define PL_PARALLEL_MEMCPY_MIN (8 << 20)
+void pl_parallel_memcpy(void *dst, const void *src, size_t size);
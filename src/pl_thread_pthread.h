@@ -21,6 +21,7 @@
 #include <pthread.h>
 #include <sys/time.h>
 #include <time.h>
+#include <unistd.h>
 
 #include <pl_assert.h>
 
@@ -65,6 +66,7 @@ static inline int pl_mutex_init_type_internal(pl_mutex *mutex, enum pl_mutex_typ
 #define pl_mutex_destroy    pthread_mutex_destroy
 #define pl_mutex_lock       pthread_mutex_lock
 #define pl_mutex_unlock     pthread_mutex_unlock
+#define pl_mutex_trylock    pthread_mutex_trylock
 
 static inline int pl_cond_init(pl_cond *cond)
 {
@@ -135,3 +137,9 @@ static inline bool pl_thread_sleep(double t)
 
     return nanosleep(&ts, NULL) == 0;
 }
+
+static inline int pl_thread_num_cpus(void)
+{
+    long num = sysconf(_SC_NPROCESSORS_ONLN);
+    return num > 0 ? (int) num : 1;
+}
@@ -54,6 +54,11 @@ static inline int pl_mutex_unlock(pl_mutex *mutex)
     return 0;
 }
 
+static inline int pl_mutex_trylock(pl_mutex *mutex)
+{
+    return TryEnterCriticalSection(mutex) ? 0 : EBUSY;
+}
+
 static inline int pl_cond_init(pl_cond *cond)
 {
     InitializeConditionVariable(cond);
@@ -180,3 +185,10 @@ end:
         CloseHandle(timer);
     return ret;
 }
+
+static inline int pl_thread_num_cpus(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int) info.dwNumberOfProcessors : 1;
+}
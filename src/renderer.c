@@ -24,6 +24,7 @@
 #include "dispatch.h"
 
 #include <libplacebo/renderer.h>
+#include <libplacebo/utils/upload.h>
 
 struct cached_frame {
     uint64_t signature;
@@ -45,6 +46,35 @@ struct osd_vertex {
     float pos[2];
     float coord[2];
     float color[4];
+    float bounds[4]; // clamp range for `coord`, only for overlay atlases
+};
+
+// Cached result of compositing a list of overlays, see `draw_overlays`
+struct osd_layer {
+    uint64_t key;                 // hash of all overlay signatures/transforms
+    struct pl_color_space color;  // target color space of `tex`
+    struct pl_color_repr repr;    // target color repr of `tex`
+    uint64_t icc;                 // signature of the target ICC profile
+    int fbo_w, fbo_h;             // dimensions of the target FBO
+    pl_rect2d rect;               // region of the target FBO covered by `tex`
+    pl_tex tex;                   // premultiplied composited overlays
+    bool valid;                   // whether `tex` is up-to-date
+    uint64_t last_use;            // for LRU eviction
+};
+
+// Overlay with its transformation to the target FBO, see `draw_overlays`
+struct osd_item {
+    const struct pl_overlay *ol;
+    pl_transform2x2 tf;
+};
+
+// Frame submitted by `pl_render_image_async`, pending completion
+struct inflight_frame {
+    pl_render_token token;
+    pl_tex planes[PL_MAX_PLANES];
+    int num_planes;
+    void (*done)(void *priv, pl_render_token token);
+    void *priv;
 };
 
 struct icc_state {
@@ -70,20 +100,55 @@ struct pl_renderer_t {
     pl_shader_obj lut_state[3];
     pl_shader_obj icc_state[2];
     PL_ARRAY(pl_tex) fbos;
+    PL_ARRAY(int) fbo_idle; // number of passes each FBO has gone unused for
     struct sampler sampler_main;
     struct sampler sampler_contrast;
     struct sampler samplers_src[4];
     struct sampler samplers_dst[4];
+    PL_ARRAY(struct sampler) samplers_multi; // see `pl_render_image_multi`
 
     // Temporary storage for vertex/index data
     PL_ARRAY(struct osd_vertex) osd_vertices;
     PL_ARRAY(uint16_t) osd_indices;
-    struct pl_vertex_attrib osd_attribs[3];
+    struct pl_vertex_attrib osd_attribs[4];
+
+    // Persistent overlay atlases, one per texture format
+    PL_ARRAY(pl_tex) osd_atlases;
+    bool osd_atlas_failed;
+
+    // Cached overlay layers, for overlays with signatures
+    PL_ARRAY(struct osd_item) osd_items;
+    PL_ARRAY(struct osd_layer) osd_layers;
+    uint64_t osd_layer_clock;
 
     // Frame cache (for frame mixing / interpolation)
     PL_ARRAY(struct cached_frame) frames;
     PL_ARRAY(pl_tex) frame_fbos;
 
+    // Scratch arenas for `pass_state.tmp`, recycled between passes
+    PL_ARRAY(void *) arenas;
+
+    // Limit on cached texture memory, see `pl_renderer_set_memory_budget`
+    size_t memory_budget;
+
+    // Statistics for the current/last frame, see `pl_renderer_get_stats`
+    struct pl_render_stats stats;
+    uint64_t stats_compiled;
+
+    // Damage tracking state, see `pl_render_params.damage_tracking`
+    pl_tex damage_tex;      // retained copy of the last output
+    uint64_t damage_hash;   // signature of the frame rendered to `damage_tex`
+    bool damage_valid;      // whether `damage_tex` holds a complete frame
+    bool damage_allowed;    // set for the duration of `pl_render_image`
+
+    // Frames in flight, in submission order, see `pl_render_image_async`
+    PL_ARRAY(struct inflight_frame) inflight;
+    pl_render_token last_token;
+
+    // Adaptive quality controller state, see `pl_adaptive_params`
+    int adaptive_level;
+    int adaptive_over, adaptive_under; // consecutive frames over/under budget
+
     // For debugging / logging purposes
     int prev_dither;
 
@@ -124,6 +189,10 @@ pl_renderer pl_renderer_create(pl_log log, pl_gpu gpu)
                 .name = "osd_color",
                 .offset = offsetof(struct osd_vertex, color),
                 .fmt = pl_find_vertex_fmt(gpu, PL_FMT_FLOAT, 4),
+            }, {
+                .name = "osd_bounds",
+                .offset = offsetof(struct osd_vertex, bounds),
+                .fmt = pl_find_vertex_fmt(gpu, PL_FMT_FLOAT, 4),
             }
         },
     };
@@ -138,21 +207,9 @@ static void sampler_destroy(pl_renderer rr, struct sampler *sampler)
     pl_shader_obj_destroy(&sampler->downscaler_state);
 }
 
-void pl_renderer_destroy(pl_renderer *p_rr)
+// Frees all shader resource objects, including those of the samplers
+static void free_shader_objs(pl_renderer rr)
 {
-    pl_renderer rr = *p_rr;
-    if (!rr)
-        return;
-
-    // Free all intermediate FBOs
-    for (int i = 0; i < rr->fbos.num; i++)
-        pl_tex_destroy(rr->gpu, &rr->fbos.elem[i]);
-    for (int i = 0; i < rr->frames.num; i++)
-        pl_tex_destroy(rr->gpu, &rr->frames.elem[i].tex);
-    for (int i = 0; i < rr->frame_fbos.num; i++)
-        pl_tex_destroy(rr->gpu, &rr->frame_fbos.elem[i]);
-
-    // Free all shader resource objects
     pl_shader_obj_destroy(&rr->tone_map_state);
     pl_shader_obj_destroy(&rr->dither_state);
     for (int i = 0; i < PL_ARRAY_SIZE(rr->lut_state); i++)
@@ -162,13 +219,40 @@ void pl_renderer_destroy(pl_renderer *p_rr)
     for (int i = 0; i < PL_ARRAY_SIZE(rr->icc_state); i++)
         pl_shader_obj_destroy(&rr->icc_state[i]);
 
-    // Free all samplers
     sampler_destroy(rr, &rr->sampler_main);
     sampler_destroy(rr, &rr->sampler_contrast);
     for (int i = 0; i < PL_ARRAY_SIZE(rr->samplers_src); i++)
         sampler_destroy(rr, &rr->samplers_src[i]);
     for (int i = 0; i < PL_ARRAY_SIZE(rr->samplers_dst); i++)
         sampler_destroy(rr, &rr->samplers_dst[i]);
+    for (int i = 0; i < rr->samplers_multi.num; i++)
+        sampler_destroy(rr, &rr->samplers_multi.elem[i]);
+}
+
+void pl_renderer_destroy(pl_renderer *p_rr)
+{
+    pl_renderer rr = *p_rr;
+    if (!rr)
+        return;
+
+    // Wait for all frames in flight, so their callbacks still fire
+    if (rr->inflight.num)
+        pl_renderer_poll(rr, rr->last_token, UINT64_MAX);
+
+    // Free all intermediate FBOs
+    for (int i = 0; i < rr->fbos.num; i++)
+        pl_tex_destroy(rr->gpu, &rr->fbos.elem[i]);
+    for (int i = 0; i < rr->frames.num; i++)
+        pl_tex_destroy(rr->gpu, &rr->frames.elem[i].tex);
+    for (int i = 0; i < rr->frame_fbos.num; i++)
+        pl_tex_destroy(rr->gpu, &rr->frame_fbos.elem[i]);
+    for (int i = 0; i < rr->osd_atlases.num; i++)
+        pl_tex_destroy(rr->gpu, &rr->osd_atlases.elem[i]);
+    for (int i = 0; i < rr->osd_layers.num; i++)
+        pl_tex_destroy(rr->gpu, &rr->osd_layers.elem[i].tex);
+    pl_tex_destroy(rr->gpu, &rr->damage_tex);
+
+    free_shader_objs(rr);
 
     // Free fallback ICC profiles
     for (int i = 0; i < PL_ARRAY_SIZE(rr->icc_fallback); i++)
@@ -193,10 +277,437 @@ void pl_renderer_flush_cache(pl_renderer rr)
     for (int i = 0; i < rr->frames.num; i++)
         pl_tex_destroy(rr->gpu, &rr->frames.elem[i].tex);
     rr->frames.num = 0;
+    for (int i = 0; i < rr->osd_layers.num; i++)
+        pl_tex_destroy(rr->gpu, &rr->osd_layers.elem[i].tex);
+    rr->osd_layers.num = 0;
+    rr->damage_valid = false;
 
     pl_reset_detected_peak(rr->tone_map_state);
 }
 
+static size_t tex_memory(pl_tex tex)
+{
+    if (!tex)
+        return 0;
+
+    return (size_t) tex->params.format->texel_size *
+           PL_MAX(tex->params.w, 1) *
+           PL_MAX(tex->params.h, 1) *
+           PL_MAX(tex->params.d, 1);
+}
+
+static size_t cache_memory(pl_renderer rr)
+{
+    size_t total = tex_memory(rr->damage_tex);
+    for (int i = 0; i < rr->fbos.num; i++)
+        total += tex_memory(rr->fbos.elem[i]);
+    for (int i = 0; i < rr->frame_fbos.num; i++)
+        total += tex_memory(rr->frame_fbos.elem[i]);
+    for (int i = 0; i < rr->frames.num; i++)
+        total += tex_memory(rr->frames.elem[i].tex);
+    for (int i = 0; i < rr->osd_atlases.num; i++)
+        total += tex_memory(rr->osd_atlases.elem[i]);
+    for (int i = 0; i < rr->osd_layers.num; i++)
+        total += tex_memory(rr->osd_layers.elem[i].tex);
+    return total;
+}
+
+size_t pl_renderer_trim(pl_renderer rr, size_t target)
+{
+    size_t total = cache_memory(rr);
+
+    // Spare textures for future cached frames
+    while (total > target && rr->frame_fbos.num) {
+        pl_tex *tex = &rr->frame_fbos.elem[--rr->frame_fbos.num];
+        total -= tex_memory(*tex);
+        pl_tex_destroy(rr->gpu, tex);
+    }
+
+    // Intermediate FBOs, starting with the ones unused for the longest
+    while (total > target && rr->fbos.num) {
+        int idx = 0;
+        for (int i = 1; i < rr->fbos.num; i++) {
+            if (rr->fbo_idle.elem[i] > rr->fbo_idle.elem[idx])
+                idx = i;
+        }
+
+        total -= tex_memory(rr->fbos.elem[idx]);
+        pl_tex_destroy(rr->gpu, &rr->fbos.elem[idx]);
+        PL_ARRAY_REMOVE_AT(rr->fbos, idx);
+        PL_ARRAY_REMOVE_AT(rr->fbo_idle, idx);
+    }
+
+    // Composited overlay layers, least recently used first
+    while (total > target && rr->osd_layers.num) {
+        int idx = 0;
+        for (int i = 1; i < rr->osd_layers.num; i++) {
+            if (rr->osd_layers.elem[i].last_use < rr->osd_layers.elem[idx].last_use)
+                idx = i;
+        }
+
+        total -= tex_memory(rr->osd_layers.elem[idx].tex);
+        pl_tex_destroy(rr->gpu, &rr->osd_layers.elem[idx].tex);
+        PL_ARRAY_REMOVE_AT(rr->osd_layers, idx);
+    }
+
+    while (total > target && rr->osd_atlases.num) {
+        pl_tex *tex = &rr->osd_atlases.elem[--rr->osd_atlases.num];
+        total -= tex_memory(*tex);
+        pl_tex_destroy(rr->gpu, tex);
+    }
+
+    if (total > target && rr->damage_tex) {
+        total -= tex_memory(rr->damage_tex);
+        pl_tex_destroy(rr->gpu, &rr->damage_tex);
+        rr->damage_valid = false;
+    }
+
+    // Cached frames for frame mixing, oldest first
+    while (total > target && rr->frames.num) {
+        total -= tex_memory(rr->frames.elem[0].tex);
+        pl_tex_destroy(rr->gpu, &rr->frames.elem[0].tex);
+        PL_ARRAY_REMOVE_AT(rr->frames, 0);
+    }
+
+    if (target)
+        return total;
+
+    // Shader objects are not accounted for, so only free them when trimming
+    // everything. They are regenerated on demand.
+    free_shader_objs(rr);
+
+    return total;
+}
+
+void pl_renderer_set_memory_budget(pl_renderer rr, size_t bytes)
+{
+    rr->memory_budget = bytes;
+    if (bytes)
+        pl_renderer_trim(rr, bytes);
+}
+
+static bool render_image(pl_renderer rr, const struct pl_frame *pimage,
+                         const struct pl_frame *ptarget,
+                         const struct pl_render_params *params);
+
+bool pl_render_precompile(pl_renderer rr,
+                          const struct pl_render_precompile_params *params)
+{
+    static const struct pl_render_params *const default_params[] = {
+        &pl_render_default_params,
+    };
+
+    const struct pl_render_params *const *rparams = params->params;
+    int num_params = params->num_params;
+    if (!num_params) {
+        rparams = default_params;
+        num_params = PL_ARRAY_SIZE(default_params);
+    }
+
+    bool ok = true;
+    pl_dispatch_precompile_begin(rr->dp, params->num_threads);
+    for (int t = 0; t < params->num_targets; t++) {
+        for (int i = 0; i < params->num_images; i++) {
+            for (int n = 0; n < num_params; n++) {
+                ok &= render_image(rr, &params->images[i], &params->targets[t],
+                                   rparams[n]);
+            }
+        }
+    }
+
+    ok &= pl_dispatch_precompile_end(rr->dp);
+    pl_renderer_flush_cache(rr);
+    return ok;
+}
+
+// Returns the (rounded) subsampling factor of a plane of size `size`, relative
+// to the reference size `ref`
+static int tile_sub(int ref, int size)
+{
+    return PL_MAX(1, (ref + size / 2) / PL_MAX(size, 1));
+}
+
+// Maps a rect in reference plane coordinates to the corresponding region of
+// a plane subsampled by `sx`, `sy`, rounding outwards
+static pl_rect2d tile_plane_rect(pl_rect2d rc, int sx, int sy,
+                                 const struct pl_plane_data *data)
+{
+    return (pl_rect2d) {
+        .x0 = rc.x0 / sx,
+        .y0 = rc.y0 / sy,
+        .x1 = PL_MIN(PL_DIV_UP(rc.x1, sx), data->width),
+        .y1 = PL_MIN(PL_DIV_UP(rc.y1, sy), data->height),
+    };
+}
+
+static size_t tile_row_stride(const struct pl_plane_data *data)
+{
+    return PL_DEF(data->row_stride, data->width * data->pixel_stride);
+}
+
+static void *tile_pixels(const struct pl_plane_data *data, pl_rect2d rc)
+{
+    return (uint8_t *) data->pixels + rc.y0 * tile_row_stride(data) +
+                                      rc.x0 * data->pixel_stride;
+}
+
+static void tile_done(void *priv)
+{
+    // nothing to do, the transfer is waited on by `pl_gpu_finish`
+}
+
+// Map a coordinate from the destination crop `d0-d1` to the source crop `s0-s1`
+static inline float tile_map(float x, float d0, float d1, float s0, float s1)
+{
+    return s0 + (x - d0) * (s1 - s0) / (d1 - d0);
+}
+
+#define TILE_ALIGN 16
+
+struct tile_slot {
+    pl_tex src[PL_MAX_PLANES];
+    pl_tex dst[PL_MAX_PLANES];
+};
+
+bool pl_render_image_tiled(pl_renderer rr,
+                           const struct pl_render_tiled_params *tparams)
+{
+    const struct pl_frame *image = tparams->image, *target = tparams->target;
+    pl_gpu gpu = rr->gpu;
+
+    if (image->num_overlays || target->num_overlays) {
+        PL_ERR(rr, "Tiled rendering does not support overlays!");
+        return false;
+    }
+
+    if ((image->rotation - target->rotation) % PL_ROTATION_360) {
+        PL_ERR(rr, "Tiled rendering does not support rotation!");
+        return false;
+    }
+
+    // Features which depend on the frame as a whole can't be tiled
+    struct pl_render_params params = *PL_DEF(tparams->params, &pl_render_default_params);
+    params.peak_detect_params = NULL;
+    params.corner_rounding = 0.0;
+    params.distort_params = NULL;
+    params.damage_tracking = false;
+
+    int src_w = 0, src_h = 0, dst_w = 0, dst_h = 0;
+    for (int i = 0; i < image->num_planes; i++) {
+        const struct pl_plane_data *data = &tparams->image_data[i];
+        if (!data->pixels || image->planes[i].flipped) {
+            PL_ERR(rr, "Tiled rendering requires non-flipped host memory planes!");
+            return false;
+        }
+        src_w = PL_MAX(src_w, data->width);
+        src_h = PL_MAX(src_h, data->height);
+    }
+
+    for (int i = 0; i < target->num_planes; i++) {
+        const struct pl_plane_data *data = &tparams->target_data[i];
+        if (!data->pixels || target->planes[i].flipped) {
+            PL_ERR(rr, "Tiled rendering requires non-flipped host memory planes!");
+            return false;
+        }
+        dst_w = PL_MAX(dst_w, data->width);
+        dst_h = PL_MAX(dst_h, data->height);
+    }
+
+    if (!src_w || !src_h || !dst_w || !dst_h) {
+        PL_ERR(rr, "Tiled rendering requires non-empty frames!");
+        return false;
+    }
+
+    pl_rect2df src = image->crop, dst = target->crop;
+    if (!pl_rect_w(src))
+        src.x0 = 0, src.x1 = src_w;
+    if (!pl_rect_h(src))
+        src.y0 = 0, src.y1 = src_h;
+    if (!pl_rect_w(dst))
+        dst.x0 = 0, dst.x1 = dst_w;
+    if (!pl_rect_h(dst))
+        dst.y0 = 0, dst.y1 = dst_h;
+
+    // Determine the subsampling of each plane
+    int src_sub[PL_MAX_PLANES][2], dst_sub[PL_MAX_PLANES][2];
+    int align = 1, max_sub = 1;
+    for (int i = 0; i < image->num_planes; i++) {
+        const struct pl_plane_data *data = &tparams->image_data[i];
+        src_sub[i][0] = tile_sub(src_w, data->width);
+        src_sub[i][1] = tile_sub(src_h, data->height);
+        max_sub = PL_MAX(max_sub, PL_MAX(src_sub[i][0], src_sub[i][1]));
+    }
+
+    for (int i = 0; i < target->num_planes; i++) {
+        const struct pl_plane_data *data = &tparams->target_data[i];
+        dst_sub[i][0] = tile_sub(dst_w, data->width);
+        dst_sub[i][1] = tile_sub(dst_h, data->height);
+        align = PL_MAX(align, PL_MAX(dst_sub[i][0], dst_sub[i][1]));
+    }
+
+    // Size of the padding around each source tile, in source pixels
+    const float scale = PL_MIN(fabsf(pl_rect_w(dst) / pl_rect_w(src)),
+                               fabsf(pl_rect_h(dst) / pl_rect_h(src)));
+    const struct pl_filter_config *filters[] = {
+        params.upscaler, params.downscaler,
+        params.plane_upscaler, params.plane_downscaler,
+    };
+
+    float radius = 1.0; // built-in bilinear sampling
+    for (int i = 0; i < PL_ARRAY_SIZE(filters); i++) {
+        if (filters[i])
+            radius = PL_MAX(radius, pl_filter_radius_bound(filters[i]));
+    }
+
+    float margin = radius * PL_MAX3(1.0f, 1.0f / scale, max_sub) + 2.0;
+    if (params.deband_params)
+        margin += params.deband_params->radius;
+    const int pad = ceilf(margin) + max_sub;
+
+    // Pick the largest tile size that fits the texture size limits
+    const int max_dim = PL_MIN(gpu->limits.max_tex_2d_dim, INT_MAX);
+    align = PL_MAX(align, TILE_ALIGN);
+    int tile = PL_ALIGN(PL_DEF(tparams->tile_size, 1024), align);
+    tile = PL_MIN(tile, max_dim / align * align);
+    while (tile > align && tile / scale + 2 * pad > max_dim)
+        tile = PL_ALIGN(tile / 2, align);
+    if (!tile || tile / scale + 2 * pad > max_dim) {
+        PL_ERR(rr, "Source tiles for a scale factor of %f exceed the maximum "
+               "texture size of %d!", scale, max_dim);
+        return false;
+    }
+
+    PL_DEBUG(rr, "Rendering %dx%d -> %dx%d in tiles of %dx%d",
+             src_w, src_h, dst_w, dst_h, tile, tile);
+
+    // Alternate between two sets of textures, so the download of each tile
+    // may overlap with rendering the next one
+    struct tile_slot slots[2] = {0};
+    const bool async = gpu->limits.callbacks;
+    pl_rect2df dn = dst;
+    pl_rect2df_normalize(&dn);
+    bool ok = true;
+    int num_tiles = 0;
+
+    for (int ty = 0; ok && ty < dst_h; ty += tile) {
+        for (int tx = 0; ok && tx < dst_w; tx += tile) {
+            struct tile_slot *slot = &slots[num_tiles++ % PL_ARRAY_SIZE(slots)];
+            const pl_rect2d rc = {
+                .x0 = tx,
+                .y0 = ty,
+                .x1 = PL_MIN(tx + tile, dst_w),
+                .y1 = PL_MIN(ty + tile, dst_h),
+            };
+
+            struct pl_frame tile_img = *image, tile_dst = *target;
+            for (int i = 0; ok && i < target->num_planes; i++) {
+                struct pl_plane_data data = tparams->target_data[i];
+                data.width = PL_DIV_UP(tile, dst_sub[i][0]);
+                data.height = PL_DIV_UP(tile, dst_sub[i][1]);
+                ok = pl_recreate_plane(gpu, &tile_dst.planes[i], &slot->dst[i], &data);
+                if (ok && slot->dst[i]->params.format->texel_size != data.pixel_stride) {
+                    PL_ERR(rr, "Target plane %d does not match the texel layout "
+                           "of any texture format!", i);
+                    ok = false;
+                }
+            }
+
+            if (!ok)
+                break;
+
+            // Visible part of the target crop within this tile, in the same
+            // orientation as the original crop
+            pl_rect2df vis = {
+                .x0 = PL_MAX(dn.x0, rc.x0),
+                .y0 = PL_MAX(dn.y0, rc.y0),
+                .x1 = PL_MIN(dn.x1, rc.x1),
+                .y1 = PL_MIN(dn.y1, rc.y1),
+            };
+
+            if (vis.x0 >= vis.x1 || vis.y0 >= vis.y1) {
+                // Nothing visible, just clear the tile
+                ok = pl_render_image(rr, NULL, &tile_dst, &params);
+            } else {
+                if (dst.x0 > dst.x1)
+                    PL_SWAP(vis.x0, vis.x1);
+                if (dst.y0 > dst.y1)
+                    PL_SWAP(vis.y0, vis.y1);
+
+                const pl_rect2df vis_src = {
+                    .x0 = tile_map(vis.x0, dst.x0, dst.x1, src.x0, src.x1),
+                    .y0 = tile_map(vis.y0, dst.y0, dst.y1, src.y0, src.y1),
+                    .x1 = tile_map(vis.x1, dst.x0, dst.x1, src.x0, src.x1),
+                    .y1 = tile_map(vis.y1, dst.y0, dst.y1, src.y0, src.y1),
+                };
+
+                // Region of the source needed to render this tile, aligned
+                // to the chroma subsampling
+                pl_rect2d src_rc = {
+                    .x0 = floorf(PL_MIN(vis_src.x0, vis_src.x1)) - pad,
+                    .y0 = floorf(PL_MIN(vis_src.y0, vis_src.y1)) - pad,
+                    .x1 =  ceilf(PL_MAX(vis_src.x0, vis_src.x1)) + pad,
+                    .y1 =  ceilf(PL_MAX(vis_src.y0, vis_src.y1)) + pad,
+                };
+
+                src_rc.x0 = PL_CLAMP(src_rc.x0, 0, src_w) / max_sub * max_sub;
+                src_rc.y0 = PL_CLAMP(src_rc.y0, 0, src_h) / max_sub * max_sub;
+                src_rc.x1 = PL_CLAMP(src_rc.x1, 0, src_w);
+                src_rc.y1 = PL_CLAMP(src_rc.y1, 0, src_h);
+
+                for (int i = 0; ok && i < image->num_planes; i++) {
+                    const struct pl_plane_data *data = &tparams->image_data[i];
+                    const pl_rect2d prc = tile_plane_rect(src_rc, src_sub[i][0],
+                                                          src_sub[i][1], data);
+                    struct pl_plane_data tile_data = *data;
+                    tile_data.width = pl_rect_w(prc);
+                    tile_data.height = pl_rect_h(prc);
+                    tile_data.row_stride = tile_row_stride(data);
+                    tile_data.pixels = tile_pixels(data, prc);
+                    tile_data.callback = NULL;
+                    ok = pl_upload_plane(gpu, &tile_img.planes[i], &slot->src[i],
+                                         &tile_data);
+                }
+
+                if (!ok)
+                    break;
+
+                tile_img.crop = vis_src;
+                pl_rect2df_offset(&tile_img.crop, -src_rc.x0, -src_rc.y0);
+                tile_dst.crop = vis;
+                pl_rect2df_offset(&tile_dst.crop, -rc.x0, -rc.y0);
+                ok = pl_render_image(rr, &tile_img, &tile_dst, &params);
+            }
+
+            for (int i = 0; ok && i < target->num_planes; i++) {
+                const struct pl_plane_data *data = &tparams->target_data[i];
+                const pl_rect2d prc = tile_plane_rect(rc, dst_sub[i][0],
+                                                      dst_sub[i][1], data);
+                ok = pl_tex_download(gpu, pl_tex_transfer_params(
+                    .tex        = slot->dst[i],
+                    .rc         = { .x1 = pl_rect_w(prc), .y1 = pl_rect_h(prc) },
+                    .row_pitch  = tile_row_stride(data),
+                    .ptr        = tile_pixels(data, prc),
+                    .callback   = async ? tile_done : NULL,
+                ));
+            }
+
+            pl_gpu_flush(gpu);
+        }
+    }
+
+    pl_gpu_finish(gpu);
+    for (int n = 0; n < PL_ARRAY_SIZE(slots); n++) {
+        for (int i = 0; i < PL_MAX_PLANES; i++) {
+            pl_tex_destroy(gpu, &slots[n].src[i]);
+            pl_tex_destroy(gpu, &slots[n].dst[i]);
+        }
+    }
+
+    if (!ok)
+        PL_ERR(rr, "Failed rendering tile %d!", num_tiles - 1);
+    return ok;
+}
+
 const struct pl_render_params pl_render_fast_params = { PL_RENDER_DEFAULTS };
 const struct pl_render_params pl_render_default_params = {
     PL_RENDER_DEFAULTS
@@ -226,6 +737,7 @@ const struct pl_filter_preset pl_frame_mixers[] = {
     { "oversample",     &pl_filter_oversample,      "Oversample (AKA SmoothMotion)" },
     { "mitchell_clamp", &pl_filter_mitchell_clamp,  "Clamped Mitchell spline" },
     { "hermite",        &pl_filter_hermite,         "Cubic spline (Hermite)" },
+    { "motion",         &pl_filter_motion,          "Motion-compensated interpolation" },
     {0}
 };
 
@@ -262,6 +774,10 @@ struct img {
     enum pl_render_error err_enum;
     pl_tex err_tex;
 
+    // Intermediate FBOs only read by `sh`, which are released for re-use by
+    // later passes once `sh` was dispatched (see `release_fbo`)
+    pl_tex fbo_deps[2];
+
     // Current effective source area, will be sampled by the main scaler
     pl_rect2df rect;
 
@@ -330,11 +846,24 @@ static inline enum plane_type detect_plane_type(const struct pl_plane *plane,
     pl_unreachable();
 }
 
+// Lifetime of each texture in `rr->fbos`, for the current pass
+enum fbo_state {
+    FBO_FREE = 0,   // not yet used
+    FBO_USED,       // currently holds an intermediate
+    FBO_PINNED,     // handed out to hooks, can't be released
+    FBO_RELEASED,   // no longer needed, may be aliased by a later intermediate
+};
+
 struct pass_state {
     void *tmp;
     pl_renderer rr;
     const struct pl_render_params *params;
     struct pl_render_info info; // for info callback
+    uint64_t *stat;             // field of `rr->stats` to account passes to
+
+    // If set, restricts all output to this region of the target (in pixels),
+    // see `pass_setup_damage`
+    pl_rect2d scissors;
 
     // Represents the "current" image which we're in the process of rendering.
     // This is initially set by pass_read_image, and all of the subsequent
@@ -366,8 +895,14 @@ struct pass_state {
 
     // Metadata for `rr->fbos`
     pl_fmt fbofmt[5];
-    bool *fbos_used;
+    pl_fmt packedfmt[2]; // see `pass_packed_fmt`, indexed by `linear`
+    enum fbo_state *fbo_state;
     bool need_peak_fbo; // need indirection for peak detection
+    bool peak_detected; // peak detection was already performed on `img`
+    bool parallel_planes; // dispatch plane passes as compute shaders
+
+    // Main scaler state, defaults to `rr->sampler_main`
+    struct sampler *sampler_main;
 
     // Map of acquired frames
     struct {
@@ -375,6 +910,30 @@ struct pass_state {
     } acquired;
 };
 
+static void find_packed_formats(struct pass_state *pass)
+{
+    static const char * const names[2] = {
+        [false] = "rgb10a2",
+        [true]  = "rg11b10f",
+    };
+
+    // Packed formats must not lose any capabilities the rest of the pipeline
+    // makes decisions on based on `fbofmt[4]`
+    const enum pl_fmt_caps req = PL_FMT_CAP_SAMPLEABLE | PL_FMT_CAP_RENDERABLE;
+    const enum pl_fmt_caps keep = PL_FMT_CAP_LINEAR | PL_FMT_CAP_STORABLE |
+                                  PL_FMT_CAP_BLITTABLE | PL_FMT_CAP_BLENDABLE;
+    const enum pl_fmt_caps caps = req | (pass->fbofmt[4]->caps & keep);
+
+    for (int i = 0; i < PL_ARRAY_SIZE(names); i++) {
+        pl_fmt fmt = pl_find_named_fmt(pass->rr->gpu, names[i]);
+        if (!fmt || (fmt->caps & caps) != caps)
+            continue;
+        if (fmt->texel_size >= pass->fbofmt[3]->texel_size)
+            continue;
+        pass->packedfmt[i] = fmt;
+    }
+}
+
 static void find_fbo_format(struct pass_state *pass)
 {
     const struct pl_render_params *params = pass->params;
@@ -421,6 +980,9 @@ static void find_fbo_format(struct pass_state *pass)
                                         configs[i].depth, 0, fmt->caps);
             pass->fbofmt[c] = PL_DEF(pass->fbofmt[c], pass->fbofmt[c+1]);
         }
+
+        if (params->packed_fbos && configs[i].depth > 8)
+            find_packed_formats(pass);
         return;
     }
 
@@ -432,6 +994,10 @@ static void info_callback(void *priv, const struct pl_dispatch_info *dinfo)
 {
     struct pass_state *pass = priv;
     const struct pl_render_params *params = pass->params;
+    struct pl_render_stats *stats = &pass->rr->stats;
+    stats->num_passes++;
+    stats->time_total += dinfo->last;
+    *PL_DEF(pass->stat, &stats->time_output) += dinfo->last;
     if (!params->info_callback)
         return;
 
@@ -440,6 +1006,16 @@ static void info_callback(void *priv, const struct pl_dispatch_info *dinfo)
     pass->info.index++;
 }
 
+// Number of passes an FBO must have gone unused for before it may be recreated
+// at a different size, rather than allocating a new FBO
+#define FBO_WARM_PASSES 4
+
+// Maximum size of the FBO pool, beyond which FBOs are always recreated
+#define FBO_POOL_MAX 32
+
+// FBOs which have gone unused for this many passes are freed
+#define FBO_EVICT_PASSES 256
+
 static pl_tex get_fbo(struct pass_state *pass, int w, int h, pl_fmt fmt,
                       int comps, pl_debug_tag debug_tag)
 {
@@ -460,12 +1036,12 @@ static pl_tex get_fbo(struct pass_state *pass, int w, int h, pl_fmt fmt,
         .debug_tag  = debug_tag,
     };
 
-    int best_idx = -1;
-    int best_diff = 0;
+    int best_idx = -1, cold_idx = -1;
+    int best_diff = 0, cold_diff = 0;
 
     // Find the best-fitting texture out of rr->fbos
     for (int i = 0; i < rr->fbos.num; i++) {
-        if (pass->fbos_used[i])
+        if (pass->fbo_state[i] == FBO_USED || pass->fbo_state[i] == FBO_PINNED)
             continue;
 
         // Orthogonal distance, with penalty for format mismatches
@@ -473,27 +1049,120 @@ static pl_tex get_fbo(struct pass_state *pass, int w, int h, pl_fmt fmt,
                    abs(rr->fbos.elem[i]->params.h - h) +
                    ((rr->fbos.elem[i]->params.format != fmt) ? 1000 : 0);
 
+        // Only alias released textures when they fit exactly, to avoid
+        // recreating the same texture multiple times per frame
+        if (pass->fbo_state[i] == FBO_RELEASED && diff)
+            continue;
+
         if (best_idx < 0 || diff < best_diff) {
             best_idx = i;
             best_diff = diff;
         }
+
+        bool cold = rr->fbo_idle.elem[i] > FBO_WARM_PASSES;
+        if (cold && (cold_idx < 0 || diff < cold_diff)) {
+            cold_idx = i;
+            cold_diff = diff;
+        }
     }
 
-    // No texture found at all, add a new one
+    // Textures used by recent passes are likely to be needed again at their
+    // current size (e.g. when alternating between source resolutions), so
+    // only reshape cold textures, and otherwise grow the pool instead
+    if (best_idx >= 0 && best_diff) {
+        if (cold_idx >= 0) {
+            best_idx = cold_idx;
+        } else if (rr->fbos.num < FBO_POOL_MAX) {
+            best_idx = -1;
+        }
+    }
+
+    // No suitable texture found, add a new one
     if (best_idx < 0) {
         best_idx = rr->fbos.num;
         PL_ARRAY_APPEND(rr, rr->fbos, NULL);
-        pl_grow(pass->tmp, &pass->fbos_used, rr->fbos.num * sizeof(bool));
-        pass->fbos_used[best_idx] = false;
+        PL_ARRAY_APPEND(rr, rr->fbo_idle, 0);
+        pl_grow(pass->tmp, &pass->fbo_state, rr->fbos.num * sizeof(enum fbo_state));
+        pass->fbo_state[best_idx] = FBO_FREE;
     }
 
     if (!pl_tex_recreate(rr->gpu, &rr->fbos.elem[best_idx], &params))
         return NULL;
 
-    pass->fbos_used[best_idx] = true;
+    pass->fbo_state[best_idx] = FBO_USED;
+    rr->fbo_idle.elem[best_idx] = 0;
     return rr->fbos.elem[best_idx];
 }
 
+static void set_fbo_state(struct pass_state *pass, pl_tex tex,
+                          enum fbo_state from, enum fbo_state to)
+{
+    pl_renderer rr = pass->rr;
+    if (!tex)
+        return;
+
+    for (int i = 0; i < rr->fbos.num; i++) {
+        if (rr->fbos.elem[i] == tex) {
+            if (pass->fbo_state[i] == from)
+                pass->fbo_state[i] = to;
+            return;
+        }
+    }
+}
+
+// Marks an intermediate FBO as no longer needed by the current pass. Must only
+// be called once all shaders reading from `tex` were dispatched. No-op for
+// textures not owned by `rr->fbos`, or which were pinned
+static inline void release_fbo(struct pass_state *pass, pl_tex tex)
+{
+    set_fbo_state(pass, tex, FBO_USED, FBO_RELEASED);
+}
+
+// Prevents an FBO from ever being released in the current pass, e.g. because
+// it was handed out to a hook which may hold on to it
+static inline void pin_fbo(struct pass_state *pass, pl_tex tex)
+{
+    set_fbo_state(pass, tex, FBO_USED, FBO_PINNED);
+}
+
+// Records `tex` as being read by `img->sh`. (If there is no space left, the
+// texture simply stays alive until the end of the pass)
+static void img_add_fbo_dep(struct img *img, pl_tex tex)
+{
+    for (int i = 0; tex && i < PL_ARRAY_SIZE(img->fbo_deps); i++) {
+        if (!img->fbo_deps[i] || img->fbo_deps[i] == tex) {
+            img->fbo_deps[i] = tex;
+            return;
+        }
+    }
+}
+
+static void img_release_fbo_deps(struct pass_state *pass, struct img *img)
+{
+    for (int i = 0; i < PL_ARRAY_SIZE(img->fbo_deps); i++) {
+        release_fbo(pass, img->fbo_deps[i]);
+        img->fbo_deps[i] = NULL;
+    }
+}
+
+// Returns a packed 32-bit FBO format suitable for storing `img`, if enabled
+// and the loss of precision is known to be bounded, or NULL otherwise.
+static pl_fmt pass_packed_fmt(struct pass_state *pass, const struct img *img)
+{
+    // Only worth it for three channel images, which would otherwise be
+    // stored in (typically) 64-bit FBOs, and keeps the 2-bit alpha unused
+    if (img->comps != 3 || !pass->fbofmt[3])
+        return NULL;
+
+    // HDR and high bit depth content need the full precision/range
+    if (pl_color_space_is_hdr(&img->color) || img->repr.bits.color_depth > 10)
+        return NULL;
+
+    // Linear light needs the precision of a floating point format to avoid
+    // banding in dark regions, everything else fits into 10-bit unorm
+    return pass->packedfmt[img->color.transfer == PL_COLOR_TRC_LINEAR];
+}
+
 // Forcibly convert an img to `tex`, dispatching where necessary
 static pl_tex _img_tex(struct pass_state *pass, struct img *img, pl_debug_tag tag)
 {
@@ -503,18 +1172,26 @@ static pl_tex _img_tex(struct pass_state *pass, struct img *img, pl_debug_tag ta
     }
 
     pl_renderer rr = pass->rr;
-    pl_tex tex = get_fbo(pass, img->w, img->h, img->fmt, img->comps, tag);
+    pl_fmt fmt = PL_DEF(img->fmt, pass_packed_fmt(pass, img));
+    pl_tex tex = get_fbo(pass, img->w, img->h, fmt, img->comps, tag);
     img->fmt = NULL;
 
     if (!tex) {
         PL_ERR(rr, "Failed creating FBO texture! Disabling advanced rendering..");
         memset(pass->fbofmt, 0, sizeof(pass->fbofmt));
         pl_dispatch_abort(rr->dp, &img->sh);
+        memset(img->fbo_deps, 0, sizeof(img->fbo_deps));
         rr->errors |= PL_RENDER_ERR_FBO;
         return img->err_tex;
     }
 
     pl_assert(img->sh);
+    if (pass->parallel_planes && tex->params.storable) {
+        // Lets the backend schedule this pass on an async compute queue
+        if (sh_try_compute(img->sh, 16, 16, true, 0))
+            PL_TRACE(rr, "Dispatching plane pass as compute shader");
+    }
+
     bool ok = pl_dispatch_finish(rr->dp, pl_dispatch_params(
         .shader = &img->sh,
         .target = tex,
@@ -530,11 +1207,13 @@ static pl_tex _img_tex(struct pass_state *pass, struct img *img, pl_debug_tag ta
     if (!ok) {
         PL_ERR(rr, "%s", PL_DEF(err_msg, "Failed dispatching intermediate pass!"));
         rr->errors |= err_enum;
+        memset(img->fbo_deps, 0, sizeof(img->fbo_deps));
         img->sh = pl_dispatch_begin(rr->dp);
         img->tex = err_tex;
         return img->tex;
     }
 
+    img_release_fbo_deps(pass, img);
     img->tex = tex;
     return img->tex;
 }
@@ -553,6 +1232,7 @@ static pl_shader img_sh(struct pass_state *pass, struct img *img)
     img->sh = pl_dispatch_begin_ex(pass->rr->dp, img->unique);
     pl_shader_sample_direct(img->sh, pl_sample_src( .tex = img->tex ));
 
+    img_add_fbo_dep(img, img->tex);
     img->tex = NULL;
     return img->sh;
 }
@@ -674,10 +1354,40 @@ static struct sampler_info sample_src_info(struct pass_state *pass,
     return info;
 }
 
-static void dispatch_sampler(struct pass_state *pass, pl_shader sh,
-                             struct sampler *sampler, enum sampler_usage usage,
-                             pl_tex target_tex, const struct pl_sample_src *src)
+// Whether a compute shader can be dispatched directly to `tex`, mirroring
+// the checks performed by `pl_dispatch_finish`
+static bool tex_can_compute(const struct pass_state *pass, pl_tex tex)
+{
+    if (!tex->params.storable)
+        return false;
+    if (pass->params->blend_params)
+        return tex->params.format->caps & PL_FMT_CAP_READWRITE;
+    return true;
+}
+
+// Returns the texture the main scaler output is likely to be dispatched to
+// directly (skipping any intermediate FBO), or NULL if unknown
+static pl_tex direct_output_tex(const struct pass_state *pass)
+{
+    const struct pl_render_params *params = pass->params;
+    const struct pl_frame *target = &pass->target;
+    if (target->num_planes != 1 || params->distort_params || params->error_diffusion)
+        return NULL;
+    return target->planes[0].texture;
+}
+
+// Returns the intermediate FBO read by `sh`, if one was needed
+// Minimum downscaling ratio (in both directions) before the single-pass tiled
+// compute shader is preferred over two passes of `pl_shader_sample_ortho2`.
+// Below this, the horizontal pass fetches too few rows per output tile for
+// skipping the intermediate texture to pay off
+#define TILED_MIN_RATIO 2.0f
+
+static pl_tex dispatch_sampler(struct pass_state *pass, pl_shader sh,
+                               struct sampler *sampler, enum sampler_usage usage,
+                               pl_tex target_tex, const struct pl_sample_src *src)
 {
+    pl_tex inter_tex = NULL;
     const struct pl_render_params *params = pass->params;
     if (!sampler)
         goto fallback;
@@ -701,19 +1411,19 @@ static void dispatch_sampler(struct pass_state *pass, pl_shader sh,
         goto fallback;
     case SAMPLER_NEAREST:
         pl_shader_sample_nearest(sh, src);
-        return;
+        return NULL;
     case SAMPLER_OVERSAMPLE:
         pl_shader_sample_oversample(sh, src, info.config->kernel->params[0]);
-        return;
+        return NULL;
     case SAMPLER_BICUBIC:
         pl_shader_sample_bicubic(sh, src);
-        return;
+        return NULL;
     case SAMPLER_HERMITE:
         pl_shader_sample_hermite(sh, src);
-        return;
+        return NULL;
     case SAMPLER_GAUSSIAN:
         pl_shader_sample_gaussian(sh, src);
-        return;
+        return NULL;
     case SAMPLER_COMPLEX:
         break; // continue below
     }
@@ -730,12 +1440,26 @@ static void dispatch_sampler(struct pass_state *pass, pl_shader sh,
         fparams.no_compute = !target_tex->params.storable;
     } else {
         fparams.no_compute = !(pass->fbofmt[4]->caps & PL_FMT_CAP_STORABLE);
+
+        // Avoid compute shaders for the main scaler if they would force an
+        // extra FBO round-trip on the way to the output, and write directly
+        // to the output otherwise
+        pl_tex out = usage == SAMPLER_MAIN ? direct_output_tex(pass) : NULL;
+        if (out && !tex_can_compute(pass, out))
+            fparams.no_compute = true;
     }
 
     bool ok;
     if (info.config->polar) {
         // Polar samplers are always a single function call
         ok = pl_shader_sample_polar(sh, src, &fparams);
+    } else if (info.dir == SAMPLER_DOWN && info.dir_sep[0] && info.dir_sep[1] &&
+               fabsf(pl_rect_w(src->rect)) >= TILED_MIN_RATIO * src->new_w &&
+               fabsf(pl_rect_h(src->rect)) >= TILED_MIN_RATIO * src->new_h &&
+               pl_shader_sample_ortho2_tiled(sh, src, &fparams))
+    {
+        // Both directions handled by a single compute shader
+        ok = true;
     } else if (info.dir_sep[0] && info.dir_sep[1]) {
         // Scaling is needed in both directions
         struct pl_sample_src src1 = *src, src2 = *src;
@@ -759,7 +1483,7 @@ static void dispatch_sampler(struct pass_state *pass, pl_shader sh,
             .comps = src->components,
         };
 
-        src2.tex = img_tex(pass, &img);
+        src2.tex = inter_tex = img_tex(pass, &img);
         src2.scale = 1.0;
         ok = src2.tex && pl_shader_sample_ortho2(sh, &src2, &fparams);
     } else {
@@ -774,11 +1498,12 @@ done:
         goto fallback;
     }
 
-    return;
+    return inter_tex;
 
 fallback:
     // If all else fails, fall back to auto sampling
     pl_shader_sample_direct(sh, src);
+    return NULL;
 }
 
 static void swizzle_color(pl_shader sh, int comps, const int comp_map[4],
@@ -800,7 +1525,568 @@ static void swizzle_color(pl_shader sh, int comps, const int comp_map[4],
         GLSL("color.a = "$".a; \n", orig);
 }
 
-// `scale` adapts from `pass->dst_rect` to the plane being rendered to
+// Size of the overlay atlases, see `osd_atlas_get`
+#define OSD_ATLAS_SIZE 2048
+
+// State of the current batch of overlays, see `draw_overlays`
+struct osd_batch {
+    const struct pl_overlay *ol; // first overlay of the batch, or NULL
+    pl_tex tex;                  // texture all parts are sampled from
+    bool atlas;                  // `tex` is an overlay atlas
+
+    // Shelf packer position within the atlas
+    int x, y, row_h;
+};
+
+// Returns the persistent overlay atlas for a given texture format, if possible
+static pl_tex osd_atlas_get(pl_renderer rr, pl_fmt fmt)
+{
+    if (rr->osd_atlas_failed || !(fmt->caps & PL_FMT_CAP_BLITTABLE))
+        return NULL;
+
+    for (int i = 0; i < rr->osd_atlases.num; i++) {
+        if (rr->osd_atlases.elem[i]->params.format == fmt)
+            return rr->osd_atlases.elem[i];
+    }
+
+    const int size = PL_MIN(OSD_ATLAS_SIZE, rr->gpu->limits.max_tex_2d_dim);
+    pl_tex tex = pl_tex_create(rr->gpu, pl_tex_params(
+        .w          = size,
+        .h          = size,
+        .format     = fmt,
+        .sampleable = true,
+        .blit_dst   = true,
+        .debug_tag  = PL_DEBUG_TAG,
+    ));
+
+    if (!tex) {
+        PL_WARN(rr, "Failed creating overlay atlas, drawing overlays "
+                "individually!");
+        rr->osd_atlas_failed = true;
+        return NULL;
+    }
+
+    PL_ARRAY_APPEND(rr, rr->osd_atlases, tex);
+    return tex;
+}
+
+// Region of `ol.tex` to copy into the atlas for `part`. This includes an extra
+// texel of margin on each side (where available), so that linear sampling at
+// the edges of the part matches sampling from the original texture
+static pl_rect2d osd_part_region(const struct pl_overlay *ol,
+                                 const struct pl_overlay_part *part)
+{
+    pl_rect2df src = part->src;
+    pl_rect2df_normalize(&src);
+    return (pl_rect2d) {
+        .x0 = PL_MAX(floorf(src.x0) - 1, 0),
+        .y0 = PL_MAX(floorf(src.y0) - 1, 0),
+        .x1 = PL_MIN(ceilf(src.x1) + 1, ol->tex->params.w),
+        .y1 = PL_MIN(ceilf(src.y1) + 1, ol->tex->params.h),
+    };
+}
+
+// Whether all parts of an overlay can be packed into the atlas `atlas`
+static bool osd_atlas_fits(const struct pl_overlay *ol, pl_tex atlas)
+{
+    if (!atlas || !ol->tex->params.blit_src)
+        return false;
+
+    for (int i = 0; i < ol->num_parts; i++) {
+        pl_rect2d rc = osd_part_region(ol, &ol->parts[i]);
+        if (pl_rect_w(rc) > atlas->params.w || pl_rect_h(rc) > atlas->params.h)
+            return false;
+    }
+
+    return true;
+}
+
+// Whether `a` and `b` may be drawn as part of the same batch
+static bool osd_compatible(const struct pl_overlay *a, const struct pl_overlay *b)
+{
+    return a->mode == b->mode &&
+           a->tex->params.format == b->tex->params.format &&
+           pl_color_repr_equal(&a->repr, &b->repr) &&
+           pl_color_space_equal(&a->color, &b->color);
+}
+
+static void osd_emit_part(pl_renderer rr, pl_tex fbo, const pl_transform2x2 *tf,
+                          const struct pl_overlay_part *part, pl_tex tex,
+                          const pl_rect2df *coords, const float bounds[4])
+{
+#define EMIT_VERT(x, y)                                                         \
+    do {                                                                        \
+        float pos[2] = { part->dst.x, part->dst.y };                            \
+        pl_transform2x2_apply(tf, pos);                                         \
+        PL_ARRAY_APPEND(rr, rr->osd_vertices, (struct osd_vertex) {             \
+            .pos = {                                                            \
+                2.0 * (pos[0] / fbo->params.w) - 1.0,                           \
+                2.0 * (pos[1] / fbo->params.h) - 1.0,                           \
+            },                                                                  \
+            .coord = {                                                          \
+                coords->x / tex->params.w,                                      \
+                coords->y / tex->params.h,                                      \
+            },                                                                  \
+            .color = {                                                          \
+                part->color[0], part->color[1],                                 \
+                part->color[2], part->color[3],                                 \
+            },                                                                  \
+            .bounds = {                                                         \
+                bounds[0], bounds[1],                                           \
+                bounds[2], bounds[3],                                           \
+            },                                                                  \
+        });                                                                     \
+    } while (0)
+
+    int idx_base = rr->osd_vertices.num;
+    EMIT_VERT(x0, y0); // idx 0: top left
+    EMIT_VERT(x1, y0); // idx 1: top right
+    EMIT_VERT(x0, y1); // idx 2: bottom left
+    EMIT_VERT(x1, y1); // idx 3: bottom right
+    PL_ARRAY_APPEND(rr, rr->osd_indices, idx_base + 0);
+    PL_ARRAY_APPEND(rr, rr->osd_indices, idx_base + 1);
+    PL_ARRAY_APPEND(rr, rr->osd_indices, idx_base + 2);
+    PL_ARRAY_APPEND(rr, rr->osd_indices, idx_base + 2);
+    PL_ARRAY_APPEND(rr, rr->osd_indices, idx_base + 1);
+    PL_ARRAY_APPEND(rr, rr->osd_indices, idx_base + 3);
+#undef EMIT_VERT
+}
+
+// Copies `part` into the atlas and emits its vertices. Returns false if there
+// is no space left in the atlas
+static bool osd_atlas_part(pl_renderer rr, pl_tex fbo, struct osd_batch *batch,
+                           const pl_transform2x2 *tf, const struct pl_overlay *ol,
+                           const struct pl_overlay_part *part)
+{
+    pl_tex atlas = batch->tex;
+    const pl_rect2d rc = osd_part_region(ol, part);
+    const int w = pl_rect_w(rc), h = pl_rect_h(rc);
+    if (batch->x + w > atlas->params.w) {
+        batch->x = 0;
+        batch->y += batch->row_h;
+        batch->row_h = 0;
+    }
+
+    if (batch->y + h > atlas->params.h)
+        return false;
+
+    const int x = batch->x, y = batch->y;
+    batch->x += w;
+    batch->row_h = PL_MAX(batch->row_h, h);
+
+    pl_tex_blit(rr->gpu, pl_tex_blit_params(
+        .src    = ol->tex,
+        .dst    = atlas,
+        .src_rc = { rc.x0, rc.y0, 0, rc.x1, rc.y1, 1 },
+        .dst_rc = { x, y, 0, x + w, y + h, 1 },
+    ));
+
+    const pl_rect2df coords = {
+        .x0 = x + part->src.x0 - rc.x0,
+        .y0 = y + part->src.y0 - rc.y0,
+        .x1 = x + part->src.x1 - rc.x0,
+        .y1 = y + part->src.y1 - rc.y0,
+    };
+
+    // Clamp to the copied region, as if sampling from the original texture
+    const float bounds[4] = {
+        (x + 0.5f) / atlas->params.w,
+        (y + 0.5f) / atlas->params.h,
+        (x + w - 0.5f) / atlas->params.w,
+        (y + h - 0.5f) / atlas->params.h,
+    };
+
+    osd_emit_part(rr, fbo, tf, part, atlas, &coords, bounds);
+    return true;
+}
+
+// Draws all vertices emitted so far, using `batch->ol` as the template for
+// all overlays in the batch
+static bool osd_flush(struct pass_state *pass, pl_tex fbo, struct osd_batch *batch,
+                      int comps, const int comp_map[4],
+                      struct pl_color_space color, struct pl_color_repr repr)
+{
+    pl_renderer rr = pass->rr;
+    const struct pl_overlay *ol = batch->ol;
+    const struct pl_frame *target = &pass->target;
+    if (!ol || !rr->osd_indices.num)
+        goto done;
+
+    pl_shader sh = pl_dispatch_begin(rr->dp);
+    ident_t tex = sh_desc(sh, (struct pl_shader_desc) {
+        .desc = {
+            .name = "osd_tex",
+            .type = PL_DESC_SAMPLED_TEX,
+        },
+        .binding = {
+            .object = batch->tex,
+            .sample_mode = (batch->tex->params.format->caps & PL_FMT_CAP_LINEAR)
+                ? PL_TEX_SAMPLE_LINEAR
+                : PL_TEX_SAMPLE_NEAREST,
+        },
+    });
+
+    sh_describe(sh, "overlay");
+    GLSL("// overlay \n");
+    GLSL("vec2 osd_pos = %s; \n", batch->atlas
+         ? "clamp(coord, osd_bounds.xy, osd_bounds.zw)" : "coord");
+
+    switch (ol->mode) {
+    case PL_OVERLAY_NORMAL:
+        GLSL("vec4 color = textureLod("$", osd_pos, 0.0); \n", tex);
+        break;
+    case PL_OVERLAY_MONOCHROME:
+        GLSL("vec4 color = osd_color; \n");
+        break;
+    case PL_OVERLAY_MODE_COUNT:
+        pl_unreachable();
+    };
+
+    static const struct pl_color_map_params osd_params = {
+        PL_COLOR_MAP_DEFAULTS
+        .tone_mapping_function = &pl_tone_map_linear,
+        .gamut_mapping         = &pl_gamut_map_saturation,
+    };
+
+    struct pl_color_repr ol_repr = ol->repr;
+    sh->output = PL_SHADER_SIG_COLOR;
+    pl_shader_decode_color(sh, &ol_repr, NULL);
+    if (target->icc)
+        color.transfer = PL_COLOR_TRC_LINEAR;
+    pl_shader_color_map_ex(sh, &osd_params, pl_color_map_args(ol->color, color));
+    if (target->icc)
+        pl_icc_encode(sh, target->icc, &rr->icc_state[ICC_TARGET]);
+
+    bool premul = repr.alpha == PL_ALPHA_PREMULTIPLIED;
+    pl_shader_encode_color(sh, &repr);
+    if (ol->mode == PL_OVERLAY_MONOCHROME) {
+        GLSL("color.%s *= textureLod("$", osd_pos, 0.0).r; \n",
+             premul ? "rgba" : "a", tex);
+    }
+
+    swizzle_color(sh, comps, comp_map, true);
+
+    struct pl_blend_params blend_params = {
+        .src_rgb = premul ? PL_BLEND_ONE : PL_BLEND_SRC_ALPHA,
+        .src_alpha = PL_BLEND_ONE,
+        .dst_rgb = PL_BLEND_ONE_MINUS_SRC_ALPHA,
+        .dst_alpha = PL_BLEND_ONE_MINUS_SRC_ALPHA,
+    };
+
+    int num_attribs = ol->mode == PL_OVERLAY_NORMAL ? 2 : 3;
+    if (batch->atlas)
+        num_attribs = PL_ARRAY_SIZE(rr->osd_attribs);
+
+    uint64_t *prev_stat = pass->stat;
+    pass->stat = &rr->stats.time_overlay;
+    bool ok = pl_dispatch_vertex(rr->dp, pl_dispatch_vertex_params(
+        .shader = &sh,
+        .target = fbo,
+        .scissors = pass->scissors,
+        .blend_params = (rr->errors & PL_RENDER_ERR_BLENDING)
+                        ? NULL : &blend_params,
+        .vertex_stride = sizeof(struct osd_vertex),
+        .num_vertex_attribs = num_attribs,
+        .vertex_attribs = rr->osd_attribs,
+        .vertex_position_idx = 0,
+        .vertex_coords = PL_COORDS_NORMALIZED,
+        .vertex_type = PL_PRIM_TRIANGLE_LIST,
+        .vertex_count = rr->osd_indices.num,
+        .vertex_data = rr->osd_vertices.elem,
+        .index_data = rr->osd_indices.elem,
+    ));
+    pass->stat = prev_stat;
+
+    if (!ok) {
+        PL_ERR(rr, "Failed rendering overlays!");
+        rr->errors |= PL_RENDER_ERR_OVERLAY;
+        return false;
+    }
+
+done:
+    rr->osd_vertices.num = 0;
+    rr->osd_indices.num = 0;
+    *batch = (struct osd_batch) {0};
+    return true;
+}
+
+// Draws all overlays in `rr->osd_items` to `fbo`, additionally transformed by
+// `shift` (if set). Overlays are drawn in batches of consecutive compatible
+// overlays, with all of their parts copied into a shared atlas texture.
+// Overlays which can't be batched are drawn individually, from their own
+// texture
+static bool osd_draw_items(struct pass_state *pass, pl_tex fbo,
+                           int comps, const int comp_map[4],
+                           struct pl_color_space color, struct pl_color_repr repr,
+                           const pl_transform2x2 *shift)
+{
+    pl_renderer rr = pass->rr;
+    struct osd_batch batch = {0};
+    static const float no_bounds[4] = {0};
+    rr->osd_vertices.num = 0;
+    rr->osd_indices.num = 0;
+
+#define FLUSH()                                                                 \
+    do {                                                                        \
+        if (!osd_flush(pass, fbo, &batch, comps, comp_map, color, repr))        \
+            return false;                                                       \
+    } while (0)
+
+    for (int n = 0; n < rr->osd_items.num; n++) {
+        const struct pl_overlay *ol = rr->osd_items.elem[n].ol;
+        pl_transform2x2 item_tf = rr->osd_items.elem[n].tf;
+        if (shift)
+            pl_transform2x2_rmul(shift, &item_tf);
+        const pl_transform2x2 *tf = &item_tf;
+
+        // Flush the current batch if this overlay can't be added to it
+        pl_tex atlas = osd_atlas_get(rr, ol->tex->params.format);
+        bool use_atlas = osd_atlas_fits(ol, atlas);
+        if (batch.ol && (!use_atlas || !batch.atlas || !osd_compatible(batch.ol, ol)))
+            FLUSH();
+
+        // Avoid overflowing the 16-bit vertex indices
+        if (rr->osd_vertices.num + 4 * ol->num_parts > UINT16_MAX)
+            FLUSH();
+
+        if (!batch.ol) {
+            batch.ol = ol;
+            batch.tex = use_atlas ? atlas : ol->tex;
+            batch.atlas = use_atlas;
+        }
+
+        for (int i = 0; i < ol->num_parts; i++) {
+            const struct pl_overlay_part *part = &ol->parts[i];
+            if (!use_atlas) {
+                osd_emit_part(rr, fbo, tf, part, ol->tex, &part->src, no_bounds);
+                continue;
+            }
+
+            if (!osd_atlas_part(rr, fbo, &batch, tf, ol, part)) {
+                // Atlas is full, draw everything so far and start over
+                FLUSH();
+                batch.ol = ol;
+                batch.tex = atlas;
+                batch.atlas = true;
+                bool ok = osd_atlas_part(rr, fbo, &batch, tf, ol, part);
+                pl_assert(ok);
+            }
+        }
+
+        if (!use_atlas)
+            FLUSH();
+    }
+
+    FLUSH();
+    return true;
+#undef FLUSH
+}
+
+// Maximum number of cached overlay layers, see `osd_layer_get`
+#define OSD_LAYERS_MAX 4
+
+// Returns the cached overlay layer matching the given parameters, creating a
+// new (invalid) one if there is none. `found` is set if the layer existed
+static struct osd_layer *osd_layer_get(pl_renderer rr, pl_tex fbo, uint64_t key,
+                                       const struct pl_color_space *color,
+                                       const struct pl_color_repr *repr,
+                                       uint64_t icc, bool *found)
+{
+    struct osd_layer *layer = NULL;
+    for (int i = 0; i < rr->osd_layers.num; i++) {
+        struct osd_layer *l = &rr->osd_layers.elem[i];
+        if (l->key == key && l->icc == icc &&
+            l->fbo_w == fbo->params.w && l->fbo_h == fbo->params.h &&
+            pl_color_space_equal(&l->color, color) &&
+            pl_color_repr_equal(&l->repr, repr))
+        {
+            layer = l;
+            break;
+        }
+    }
+
+    *found = layer;
+    if (!layer) {
+        if (rr->osd_layers.num < OSD_LAYERS_MAX) {
+            PL_ARRAY_APPEND(rr, rr->osd_layers, (struct osd_layer) {0});
+            layer = &rr->osd_layers.elem[rr->osd_layers.num - 1];
+        } else {
+            // Evict the least recently used layer
+            layer = &rr->osd_layers.elem[0];
+            for (int i = 1; i < rr->osd_layers.num; i++) {
+                if (rr->osd_layers.elem[i].last_use < layer->last_use)
+                    layer = &rr->osd_layers.elem[i];
+            }
+        }
+
+        *layer = (struct osd_layer) {
+            .key    = key,
+            .color  = *color,
+            .repr   = *repr,
+            .icc    = icc,
+            .fbo_w  = fbo->params.w,
+            .fbo_h  = fbo->params.h,
+            .tex    = layer->tex,
+        };
+    }
+
+    layer->last_use = ++rr->osd_layer_clock;
+    return layer;
+}
+
+// Composites all overlays in `rr->osd_items` into `layer->tex`
+static bool osd_layer_update(struct pass_state *pass, struct osd_layer *layer,
+                             pl_tex fbo)
+{
+    pl_renderer rr = pass->rr;
+
+    // Compute the bounding box of all parts, to keep the layer small
+    pl_rect2df bbox = { INFINITY, INFINITY, -INFINITY, -INFINITY };
+    for (int n = 0; n < rr->osd_items.num; n++) {
+        const struct osd_item *item = &rr->osd_items.elem[n];
+        for (int i = 0; i < item->ol->num_parts; i++) {
+            const pl_rect2df *dst = &item->ol->parts[i].dst;
+            const float corners[4][2] = {
+                { dst->x0, dst->y0 }, { dst->x1, dst->y0 },
+                { dst->x0, dst->y1 }, { dst->x1, dst->y1 },
+            };
+
+            for (int c = 0; c < 4; c++) {
+                float pos[2] = { corners[c][0], corners[c][1] };
+                pl_transform2x2_apply(&item->tf, pos);
+                bbox.x0 = fminf(bbox.x0, pos[0]);
+                bbox.y0 = fminf(bbox.y0, pos[1]);
+                bbox.x1 = fmaxf(bbox.x1, pos[0]);
+                bbox.y1 = fmaxf(bbox.y1, pos[1]);
+            }
+        }
+    }
+
+    layer->rect = (pl_rect2d) {
+        .x0 = PL_CLAMP(floorf(bbox.x0), 0, fbo->params.w),
+        .y0 = PL_CLAMP(floorf(bbox.y0), 0, fbo->params.h),
+        .x1 = PL_CLAMP(ceilf(bbox.x1),  0, fbo->params.w),
+        .y1 = PL_CLAMP(ceilf(bbox.y1),  0, fbo->params.h),
+    };
+
+    const int w = pl_rect_w(layer->rect), h = pl_rect_h(layer->rect);
+    if (w <= 0 || h <= 0) {
+        // Nothing visible, so there's nothing to composite
+        layer->rect = (pl_rect2d) {0};
+        layer->valid = true;
+        return true;
+    }
+
+    bool ok = pl_tex_recreate(rr->gpu, &layer->tex, pl_tex_params(
+        .w          = w,
+        .h          = h,
+        .format     = pass->fbofmt[4],
+        .sampleable = true,
+        .renderable = true,
+        .blit_dst   = true,
+        .debug_tag  = PL_DEBUG_TAG,
+    ));
+
+    if (!ok)
+        return false;
+
+    pl_tex_clear(rr->gpu, layer->tex, (float[4]) {0});
+
+    // Shift all overlays into the coordinate system of the layer
+    const pl_transform2x2 shift = {
+        .mat = {{{ 1, 0 }, { 0, 1 }}},
+        .c = { -layer->rect.x0, -layer->rect.y0 },
+    };
+
+    // The layer is always premultiplied, so that blending it onto the target
+    // is equivalent to blending each overlay onto the target in turn
+    struct pl_color_repr repr = layer->repr;
+    repr.alpha = PL_ALPHA_PREMULTIPLIED;
+
+    // Scissors are relative to the target, and the layer must be complete
+    const pl_rect2d scissors = pass->scissors;
+    pass->scissors = (pl_rect2d) {0};
+    ok = osd_draw_items(pass, layer->tex, 4, NULL, layer->color, repr, &shift);
+    pass->scissors = scissors;
+
+    layer->valid = ok;
+    return ok;
+}
+
+// Blends a previously composited overlay layer onto `fbo`
+static void osd_layer_draw(struct pass_state *pass, pl_tex fbo,
+                           const struct osd_layer *layer,
+                           int comps, const int comp_map[4])
+{
+    pl_renderer rr = pass->rr;
+    if (!pl_rect_w(layer->rect) || !pl_rect_h(layer->rect))
+        return;
+
+    pl_shader sh = pl_dispatch_begin(rr->dp);
+    ident_t tex = sh_desc(sh, (struct pl_shader_desc) {
+        .desc = {
+            .name = "osd_layer",
+            .type = PL_DESC_SAMPLED_TEX,
+        },
+        .binding = {
+            .object = layer->tex,
+            .sample_mode = PL_TEX_SAMPLE_NEAREST,
+        },
+    });
+
+    sh_describe(sh, "overlay (cached)");
+    GLSL("// overlay (cached) \n"
+         "vec4 color = textureLod("$", coord, 0.0); \n", tex);
+    sh->output = PL_SHADER_SIG_COLOR;
+    swizzle_color(sh, comps, comp_map, true);
+
+    static const struct pl_blend_params blend_params = {
+        .src_rgb = PL_BLEND_ONE,
+        .src_alpha = PL_BLEND_ONE,
+        .dst_rgb = PL_BLEND_ONE_MINUS_SRC_ALPHA,
+        .dst_alpha = PL_BLEND_ONE_MINUS_SRC_ALPHA,
+    };
+
+    const struct pl_overlay_part part = {
+        .src = { 0, 0, pl_rect_w(layer->rect), pl_rect_h(layer->rect) },
+        .dst = {
+            layer->rect.x0, layer->rect.y0,
+            layer->rect.x1, layer->rect.y1,
+        },
+    };
+
+    static const float no_bounds[4] = {0};
+    rr->osd_vertices.num = 0;
+    rr->osd_indices.num = 0;
+    osd_emit_part(rr, fbo, &pl_transform2x2_identity, &part, layer->tex,
+                  &part.src, no_bounds);
+
+    uint64_t *prev_stat = pass->stat;
+    pass->stat = &rr->stats.time_overlay;
+    bool ok = pl_dispatch_vertex(rr->dp, pl_dispatch_vertex_params(
+        .shader = &sh,
+        .target = fbo,
+        .scissors = pass->scissors,
+        .blend_params = &blend_params,
+        .vertex_stride = sizeof(struct osd_vertex),
+        .num_vertex_attribs = 2,
+        .vertex_attribs = rr->osd_attribs,
+        .vertex_position_idx = 0,
+        .vertex_coords = PL_COORDS_NORMALIZED,
+        .vertex_type = PL_PRIM_TRIANGLE_LIST,
+        .vertex_count = rr->osd_indices.num,
+        .vertex_data = rr->osd_vertices.elem,
+        .index_data = rr->osd_indices.elem,
+    ));
+    pass->stat = prev_stat;
+
+    if (!ok) {
+        PL_ERR(rr, "Failed rendering overlays!");
+        rr->errors |= PL_RENDER_ERR_OVERLAY;
+    }
+}
+
+// `output_shift` adapts from `pass->dst_rect` to the plane being rendered to
 static void draw_overlays(struct pass_state *pass, pl_tex fbo,
                           int comps, const int comp_map[4],
                           const struct pl_overlay *overlays, int num,
@@ -844,19 +2130,29 @@ static void draw_overlays(struct pass_state *pass, pl_tex fbo,
     pl_rect2df_rotate(&dst_crop, -pass->rotation);
     pl_rect2df_normalize(&dst_crop);
 
+    // Overlays can only be cached if all of them carry a signature, and the
+    // layer can be composited with the correct blending
+    pl_fmt layer_fmt = pass->fbofmt[4];
+    const enum pl_fmt_caps layer_caps = PL_FMT_CAP_BLENDABLE | PL_FMT_CAP_BLITTABLE;
+    bool cacheable = layer_fmt && (layer_fmt->caps & layer_caps) == layer_caps &&
+                     !(rr->errors & PL_RENDER_ERR_BLENDING);
+    uint64_t key = 0;
+
+    rr->osd_items.num = 0;
     for (int n = 0; n < num; n++) {
-        struct pl_overlay ol = overlays[n];
-        if (!ol.num_parts)
+        const struct pl_overlay *ol = &overlays[n];
+        if (!ol->num_parts)
             continue;
 
-        if (!ol.coords) {
-            ol.coords = overlays == target->overlays
-                            ? PL_OVERLAY_COORDS_DST_FRAME
-                            : PL_OVERLAY_COORDS_SRC_FRAME;
+        enum pl_overlay_coords coords = ol->coords;
+        if (!coords) {
+            coords = overlays == target->overlays
+                        ? PL_OVERLAY_COORDS_DST_FRAME
+                        : PL_OVERLAY_COORDS_SRC_FRAME;
         }
 
         pl_transform2x2 tf = pl_transform2x2_identity;
-        switch (ol.coords) {
+        switch (coords) {
             case PL_OVERLAY_COORDS_SRC_CROP:
                 if (!image)
                     continue;
@@ -882,133 +2178,43 @@ static void draw_overlays(struct pass_state *pass, pl_tex fbo,
         if (output_shift)
             pl_transform2x2_rmul(output_shift, &tf);
 
-        // Construct vertex/index buffers
-        rr->osd_vertices.num = 0;
-        rr->osd_indices.num = 0;
-        for (int i = 0; i < ol.num_parts; i++) {
-            const struct pl_overlay_part *part = &ol.parts[i];
-
-#define EMIT_VERT(x, y)                                                         \
-            do {                                                                \
-                float pos[2] = { part->dst.x, part->dst.y };                    \
-                pl_transform2x2_apply(&tf, pos);                                \
-                PL_ARRAY_APPEND(rr, rr->osd_vertices, (struct osd_vertex) {     \
-                    .pos = {                                                    \
-                        2.0 * (pos[0] / fbo->params.w) - 1.0,                   \
-                        2.0 * (pos[1] / fbo->params.h) - 1.0,                   \
-                    },                                                          \
-                    .coord = {                                                  \
-                        part->src.x / ol.tex->params.w,                         \
-                        part->src.y / ol.tex->params.h,                         \
-                    },                                                          \
-                    .color = {                                                  \
-                        part->color[0], part->color[1],                         \
-                        part->color[2], part->color[3],                         \
-                    },                                                          \
-                });                                                             \
-            } while (0)
-
-            int idx_base = rr->osd_vertices.num;
-            EMIT_VERT(x0, y0); // idx 0: top left
-            EMIT_VERT(x1, y0); // idx 1: top right
-            EMIT_VERT(x0, y1); // idx 2: bottom left
-            EMIT_VERT(x1, y1); // idx 3: bottom right
-            PL_ARRAY_APPEND(rr, rr->osd_indices, idx_base + 0);
-            PL_ARRAY_APPEND(rr, rr->osd_indices, idx_base + 1);
-            PL_ARRAY_APPEND(rr, rr->osd_indices, idx_base + 2);
-            PL_ARRAY_APPEND(rr, rr->osd_indices, idx_base + 2);
-            PL_ARRAY_APPEND(rr, rr->osd_indices, idx_base + 1);
-            PL_ARRAY_APPEND(rr, rr->osd_indices, idx_base + 3);
-        }
-
-        // Draw parts
-        pl_shader sh = pl_dispatch_begin(rr->dp);
-        ident_t tex = sh_desc(sh, (struct pl_shader_desc) {
-            .desc = {
-                .name = "osd_tex",
-                .type = PL_DESC_SAMPLED_TEX,
-            },
-            .binding = {
-                .object = ol.tex,
-                .sample_mode = (ol.tex->params.format->caps & PL_FMT_CAP_LINEAR)
-                    ? PL_TEX_SAMPLE_LINEAR
-                    : PL_TEX_SAMPLE_NEAREST,
-            },
-        });
-
-        sh_describe(sh, "overlay");
-        GLSL("// overlay \n");
-
-        switch (ol.mode) {
-        case PL_OVERLAY_NORMAL:
-            GLSL("vec4 color = textureLod("$", coord, 0.0); \n", tex);
-            break;
-        case PL_OVERLAY_MONOCHROME:
-            GLSL("vec4 color = osd_color; \n");
-            break;
-        case PL_OVERLAY_MODE_COUNT:
-            pl_unreachable();
-        };
-
-        static const struct pl_color_map_params osd_params = {
-            PL_COLOR_MAP_DEFAULTS
-            .tone_mapping_function = &pl_tone_map_linear,
-            .gamut_mapping         = &pl_gamut_map_saturation,
-        };
+        PL_ARRAY_APPEND(rr, rr->osd_items, (struct osd_item) { ol, tf });
+        cacheable &= ol->signature != 0;
+        pl_hash_merge(&key, ol->signature);
+        pl_hash_merge(&key, pl_mem_hash(&tf, sizeof(tf)));
+    }
 
-        sh->output = PL_SHADER_SIG_COLOR;
-        pl_shader_decode_color(sh, &ol.repr, NULL);
-        if (target->icc)
-            color.transfer = PL_COLOR_TRC_LINEAR;
-        pl_shader_color_map_ex(sh, &osd_params, pl_color_map_args(ol.color, color));
-        if (target->icc)
-            pl_icc_encode(sh, target->icc, &rr->icc_state[ICC_TARGET]);
+    if (!rr->osd_items.num)
+        return;
 
-        bool premul = repr.alpha == PL_ALPHA_PREMULTIPLIED;
-        pl_shader_encode_color(sh, &repr);
-        if (ol.mode == PL_OVERLAY_MONOCHROME) {
-            GLSL("color.%s *= textureLod("$", coord, 0.0).r; \n",
-                 premul ? "rgba" : "a", tex);
+    if (cacheable) {
+        const uint64_t icc = target->icc ? target->icc->signature : 0;
+        bool found;
+        struct osd_layer *layer = osd_layer_get(rr, fbo, key, &color, &repr,
+                                                icc, &found);
+
+        // Only composite the overlays into a layer once they have been seen
+        // at least twice, to avoid the extra pass for overlays which change
+        // on every frame
+        if (layer->valid || (found && osd_layer_update(pass, layer, fbo))) {
+            osd_layer_draw(pass, fbo, layer, comps, comp_map);
+            return;
         }
 
-        swizzle_color(sh, comps, comp_map, true);
-
-        struct pl_blend_params blend_params = {
-            .src_rgb = premul ? PL_BLEND_ONE : PL_BLEND_SRC_ALPHA,
-            .src_alpha = PL_BLEND_ONE,
-            .dst_rgb = PL_BLEND_ONE_MINUS_SRC_ALPHA,
-            .dst_alpha = PL_BLEND_ONE_MINUS_SRC_ALPHA,
-        };
-
-        bool ok = pl_dispatch_vertex(rr->dp, pl_dispatch_vertex_params(
-            .shader = &sh,
-            .target = fbo,
-            .blend_params = (rr->errors & PL_RENDER_ERR_BLENDING)
-                            ? NULL : &blend_params,
-            .vertex_stride = sizeof(struct osd_vertex),
-            .num_vertex_attribs = ol.mode == PL_OVERLAY_NORMAL ? 2 : 3,
-            .vertex_attribs = rr->osd_attribs,
-            .vertex_position_idx = 0,
-            .vertex_coords = PL_COORDS_NORMALIZED,
-            .vertex_type = PL_PRIM_TRIANGLE_LIST,
-            .vertex_count = rr->osd_indices.num,
-            .vertex_data = rr->osd_vertices.elem,
-            .index_data = rr->osd_indices.elem,
-        ));
-
-        if (!ok) {
-            PL_ERR(rr, "Failed rendering overlays!");
-            rr->errors |= PL_RENDER_ERR_OVERLAY;
+        if (rr->errors & PL_RENDER_ERR_OVERLAY)
             return;
-        }
     }
+
+    osd_draw_items(pass, fbo, comps, comp_map, color, repr, NULL);
 }
 
 static pl_tex get_hook_tex(void *priv, int width, int height)
 {
     struct pass_state *pass = priv;
 
-    return get_fbo(pass, width, height, NULL, 4, PL_DEBUG_TAG);
+    pl_tex tex = get_fbo(pass, width, height, NULL, 4, PL_DEBUG_TAG);
+    pin_fbo(pass, tex);
+    return tex;
 }
 
 // Returns if any hook was applied (even if there were errors)
@@ -1067,6 +2273,7 @@ static bool pass_hook(struct pass_state *pass, struct img *img,
                 PL_ERR(rr, "Failed dispatching shader prior to hook!");
                 goto hook_error;
             }
+            pin_fbo(pass, hparams.tex); // hooks may hold on to it
             break;
         }
 
@@ -1163,6 +2370,8 @@ static void hdr_update_peak(struct pass_state *pass)
 {
     const struct pl_render_params *params = pass->params;
     pl_renderer rr = pass->rr;
+    if (pass->peak_detected)
+        return;
     if (!params->peak_detect_params || !pl_color_space_is_hdr(&pass->img.color))
         goto cleanup;
 
@@ -1533,6 +2742,9 @@ static bool pass_read_image(struct pass_state *pass)
     const struct pl_render_params *params = pass->params;
     struct pl_frame *image = &pass->image;
     pl_renderer rr = pass->rr;
+    PL_TRACE_ZONE(rr->log, PASS_READ_IMAGE);
+    pass->stat = &rr->stats.time_read;
+    pass->parallel_planes = params->parallel_planes;
 
     struct plane_state planes[4];
     struct plane_state *ref = &planes[pass->src_ref];
@@ -1829,6 +3041,7 @@ static bool pass_read_image(struct pass_state *pass)
     }
 
     GLSL("}\n");
+    pass->parallel_planes = false;
 
     pass->img = (struct img) {
         .sh     = sh,
@@ -1894,10 +3107,67 @@ static bool pass_read_image(struct pass_state *pass)
     return true;
 }
 
+// Reduces `src` by a power of two box filter ahead of a large downscale, as
+// per `params->box_prescaling`. Returns the reduced texture (and updates
+// `src` to match), or NULL if not applicable
+static pl_tex pass_box_prescale(struct pass_state *pass, struct pl_sample_src *src,
+                                const struct sampler_info *info)
+{
+    const struct pl_render_params *params = pass->params;
+    pl_renderer rr = pass->rr;
+    if (!params->box_prescaling || info->dir != SAMPLER_DOWN)
+        return NULL;
+    if (info->type != SAMPLER_COMPLEX || !(src->tex->params.format->caps & PL_FMT_CAP_LINEAR))
+        return NULL;
+
+    // Leave a ratio of at least 2x (and less than 4x) to the real downscaler
+    const float src_w = fabsf(pl_rect_w(src->rect)), src_h = fabsf(pl_rect_h(src->rect));
+    int fx = 1, fy = 1;
+    while (src_w / (fx * 4) >= src->new_w)
+        fx *= 2;
+    while (src_h / (fy * 4) >= src->new_h)
+        fy *= 2;
+    if (fx == 1 && fy == 1)
+        return NULL;
+
+    const int w = lrintf(src_w / fx), h = lrintf(src_h / fy);
+    pl_tex tex = get_fbo(pass, w, h, NULL, src->components, PL_DEBUG_TAG);
+    if (!tex)
+        return NULL;
+
+    struct pl_sample_src box = *src;
+    box.new_w = w;
+    box.new_h = h;
+
+    pl_shader sh = pl_dispatch_begin(rr->dp);
+    if (!pl_shader_sample_box(sh, &box)) {
+        pl_dispatch_abort(rr->dp, &sh);
+        release_fbo(pass, tex);
+        return NULL;
+    }
+
+    bool ok = pl_dispatch_finish(rr->dp, pl_dispatch_params(
+        .shader = &sh,
+        .target = tex,
+    ));
+
+    if (!ok) {
+        release_fbo(pass, tex);
+        return NULL;
+    }
+
+    PL_TRACE(rr, "Box prescaling %dx%d -> %dx%d", (int) src_w, (int) src_h, w, h);
+    src->tex = tex;
+    src->rect = (pl_rect2df) { .x1 = w, .y1 = h }; // already flipped, if needed
+    return tex;
+}
+
 static bool pass_scale_main(struct pass_state *pass)
 {
     const struct pl_render_params *params = pass->params;
     pl_renderer rr = pass->rr;
+    PL_TRACE_ZONE(rr->log, PASS_SCALE_MAIN);
+    pass->stat = &rr->stats.time_scale;
 
     pl_fmt fbofmt = pass->fbofmt[pass->img.comps];
     if (!fbofmt) {
@@ -1927,6 +3197,12 @@ static bool pass_scale_main(struct pass_state *pass)
         need_fbo |= out_w != src.new_w || out_h != src.new_h;
 
     struct sampler_info info = sample_src_info(pass, &src, SAMPLER_MAIN);
+
+    // If the main scaler would be an identity resample, the stages around it
+    // can be inlined into the existing shader instead of round-tripping the
+    // image through an FBO
+    bool fuse_stages = info.dir == SAMPLER_NOOP && !need_fbo &&
+                       pl_rect2d_eq(img->rect, new_rect);
     bool use_sigmoid = info.dir == SAMPLER_UP && params->sigmoid_params;
     bool use_linear  = info.dir == SAMPLER_DOWN;
 
@@ -1992,18 +3268,30 @@ static bool pass_scale_main(struct pass_state *pass)
 
     pass_hook(pass, img, PL_HOOK_PRE_KERNEL);
 
-    src.tex = img_tex(pass, img);
-    if (!src.tex)
-        return false;
-    pass->need_peak_fbo = false;
-
-    pl_shader sh = pl_dispatch_begin_ex(rr->dp, true);
-    dispatch_sampler(pass, sh, &rr->sampler_main, SAMPLER_MAIN, NULL, &src);
-    img->tex  = NULL;
-    img->sh   = sh;
-    img->w    = src.new_w;
-    img->h    = src.new_h;
-    img->rect = new_rect;
+    if (fuse_stages) {
+        PL_TRACE(rr, "Skipping main scaler (fused with adjacent stages)");
+    } else {
+        src.tex = img_tex(pass, img);
+        if (!src.tex)
+            return false;
+        pass->need_peak_fbo = false;
+
+        pl_tex box_tex = pass_box_prescale(pass, &src, &info);
+        if (box_tex)
+            release_fbo(pass, img->tex); // superseded by `box_tex`
+
+        pl_shader sh = pl_dispatch_begin_ex(rr->dp, true);
+        struct sampler *sampler = PL_DEF(pass->sampler_main, &rr->sampler_main);
+        pl_tex inter_tex = dispatch_sampler(pass, sh, sampler, SAMPLER_MAIN,
+                                            NULL, &src);
+        img->tex  = NULL;
+        img->sh   = sh;
+        img_add_fbo_dep(img, src.tex);
+        img_add_fbo_dep(img, inter_tex);
+        img->w    = src.new_w;
+        img->h    = src.new_h;
+        img->rect = new_rect;
+    }
 
     pass_hook(pass, img, PL_HOOK_POST_KERNEL);
 
@@ -2017,71 +3305,87 @@ done:
     return true;
 }
 
-static pl_tex get_feature_map(struct pass_state *pass)
+// Extract an intensity feature map (see `pl_shader_extract_features`) from
+// the region `rect` of `tex`, downscaled to `out_w` x `out_h`
+static pl_tex extract_feature_map(struct pass_state *pass, pl_tex tex,
+                                  pl_rect2df rect, struct pl_color_space csp,
+                                  int out_w, int out_h)
 {
-    const struct pl_render_params *params = pass->params;
     pl_renderer rr = pass->rr;
-    const struct pl_color_map_params *cparams = params->color_map_params;
-    cparams = PL_DEF(cparams, &pl_color_map_default_params);
-    if (!cparams->contrast_recovery || cparams->contrast_smoothness <= 1)
-        return NULL;
-    if (!pass->fbofmt[4])
-        return NULL;
-    if (!pl_color_space_is_hdr(&pass->img.color))
-        return NULL;
-    if (rr->errors & (PL_RENDER_ERR_SAMPLING | PL_RENDER_ERR_CONTRAST_RECOVERY))
-        return NULL;
-    if (pass->img.color.hdr.max_luma <= pass->target.color.hdr.max_luma + 1e-6)
-        return NULL; // no adaptation needed
-    if (params->lut && params->lut_type == PL_LUT_CONVERSION)
-        return NULL; // LUT handles tone mapping
-
-    struct img *img = &pass->img;
-    if (!img_tex(pass, img))
-        return NULL;
-
-    const float ratio = cparams->contrast_smoothness;
-    const int cr_w = ceilf(abs(pl_rect_w(pass->dst_rect)) / ratio);
-    const int cr_h = ceilf(abs(pl_rect_h(pass->dst_rect)) / ratio);
-    pl_tex inter_tex = get_fbo(pass, img->w, img->h, NULL, 1, PL_DEBUG_TAG);
-    pl_tex out_tex   = get_fbo(pass, cr_w, cr_h, NULL, 1, PL_DEBUG_TAG);
+    pl_tex inter_tex = get_fbo(pass, tex->params.w, tex->params.h, NULL, 1, PL_DEBUG_TAG);
+    pl_tex out_tex   = get_fbo(pass, out_w, out_h, NULL, 1, PL_DEBUG_TAG);
     if (!inter_tex || !out_tex)
-        goto error;
+        return NULL;
 
     pl_shader sh = pl_dispatch_begin(rr->dp);
-    pl_shader_sample_direct(sh, pl_sample_src( .tex = img->tex ));
-    pl_shader_extract_features(sh, img->color);
+    pl_shader_sample_direct(sh, pl_sample_src( .tex = tex ));
+    pl_shader_extract_features(sh, csp);
     bool ok = pl_dispatch_finish(rr->dp, pl_dispatch_params(
         .shader = &sh,
         .target = inter_tex,
     ));
     if (!ok)
-        goto error;
+        return NULL;
 
     const struct pl_sample_src src = {
         .tex          = inter_tex,
-        .rect         = img->rect,
+        .rect         = rect,
         .address_mode = PL_TEX_ADDRESS_MIRROR,
         .components   = 1,
-        .new_w        = cr_w,
-        .new_h        = cr_h,
+        .new_w        = out_w,
+        .new_h        = out_h,
     };
 
     sh = pl_dispatch_begin(rr->dp);
-    dispatch_sampler(pass, sh, &rr->sampler_contrast, SAMPLER_CONTRAST, out_tex, &src);
+    pl_tex tmp_tex = dispatch_sampler(pass, sh, &rr->sampler_contrast,
+                                      SAMPLER_CONTRAST, out_tex, &src);
     ok = pl_dispatch_finish(rr->dp, pl_dispatch_params(
         .shader = &sh,
         .target = out_tex,
     ));
     if (!ok)
-        goto error;
+        return NULL;
 
+    release_fbo(pass, inter_tex);
+    release_fbo(pass, tmp_tex);
     return out_tex;
+}
 
-error:
-    PL_ERR(rr, "Failed extracting luma for contrast recovery, disabling");
-    rr->errors |= PL_RENDER_ERR_CONTRAST_RECOVERY;
-    return NULL;
+static pl_tex get_feature_map(struct pass_state *pass)
+{
+    const struct pl_render_params *params = pass->params;
+    pl_renderer rr = pass->rr;
+    const struct pl_color_map_params *cparams = params->color_map_params;
+    cparams = PL_DEF(cparams, &pl_color_map_default_params);
+    if (!cparams->contrast_recovery || cparams->contrast_smoothness <= 1)
+        return NULL;
+    if (!pass->fbofmt[4])
+        return NULL;
+    if (!pl_color_space_is_hdr(&pass->img.color))
+        return NULL;
+    if (rr->errors & (PL_RENDER_ERR_SAMPLING | PL_RENDER_ERR_CONTRAST_RECOVERY))
+        return NULL;
+    if (pass->img.color.hdr.max_luma <= pass->target.color.hdr.max_luma + 1e-6)
+        return NULL; // no adaptation needed
+    if (params->lut && params->lut_type == PL_LUT_CONVERSION)
+        return NULL; // LUT handles tone mapping
+
+    struct img *img = &pass->img;
+    if (!img_tex(pass, img))
+        return NULL;
+
+    const float ratio = cparams->contrast_smoothness;
+    const int cr_w = ceilf(abs(pl_rect_w(pass->dst_rect)) / ratio);
+    const int cr_h = ceilf(abs(pl_rect_h(pass->dst_rect)) / ratio);
+    pl_tex out_tex = extract_feature_map(pass, img->tex, img->rect, img->color,
+                                         cr_w, cr_h);
+    if (!out_tex) {
+        PL_ERR(rr, "Failed extracting luma for contrast recovery, disabling");
+        rr->errors |= PL_RENDER_ERR_CONTRAST_RECOVERY;
+        return NULL;
+    }
+
+    return out_tex;
 }
 
 // Transforms image into the output color space (tone-mapping, ICC 3DLUT, etc)
@@ -2091,6 +3395,7 @@ static void pass_convert_colors(struct pass_state *pass)
     const struct pl_frame *image = &pass->image;
     const struct pl_frame *target = &pass->target;
     pl_renderer rr = pass->rr;
+    pass->stat = &rr->stats.time_color;
 
     struct img *img = &pass->img;
     pl_shader sh = img_sh(pass, img);
@@ -2123,8 +3428,22 @@ static void pass_convert_colors(struct pass_state *pass)
     pl_shader_set_alpha(sh, &img->repr, PL_ALPHA_INDEPENDENT);
 
     // Apply color blindness simulation if requested
-    if (params->cone_params)
+    if (params->cone_params) {
+        bool fuse = !params->lut && !prelinearized && !pass->need_peak_fbo &&
+                    !pl_color_space_is_hdr(&img->color);
+        if (fuse) {
+            // Distort the cones in linear light directly, rather than going
+            // back to non-linear light only for `pl_shader_color_map` to
+            // linearize again right away. Avoided for HDR content, since the
+            // image may still get materialized for peak detection or
+            // contrast recovery
+            pl_shader_linearize(sh, &img->color);
+            img->color.transfer = PL_COLOR_TRC_LINEAR;
+            prelinearized = true;
+        }
+
         pl_shader_cone_distort(sh, img->color, params->cone_params);
+    }
 
     if (params->lut) {
         struct pl_color_space lut_in = params->lut->color_in;
@@ -2188,6 +3507,7 @@ static void pass_convert_colors(struct pass_state *pass)
         // generate HDR feature map if required
         pl_tex feature_map = get_feature_map(pass);
         sh = img_sh(pass, img); // `get_feature_map` dispatches previous shader
+        img_add_fbo_dep(img, feature_map);
 
         // current -> target
         pl_shader_color_map_ex(sh, params->color_map_params, pl_color_map_args(
@@ -2209,6 +3529,10 @@ static void pass_convert_colors(struct pass_state *pass)
     img->color = target->color;
 }
 
+// Tile size used for `tiled_error_diffusion`
+#define ED_TILE_W 256
+#define ED_TILE_H 128
+
 // Returns true if error diffusion was successfully performed
 static bool pass_error_diffusion(struct pass_state *pass, pl_shader *sh,
                                  int new_depth, int comps, int out_w, int out_h)
@@ -2218,7 +3542,11 @@ static bool pass_error_diffusion(struct pass_state *pass, pl_shader *sh,
     if (!params->error_diffusion || (rr->errors & PL_RENDER_ERR_ERROR_DIFFUSION))
         return false;
 
-    size_t shmem_req = pl_error_diffusion_shmem_req(params->error_diffusion, out_h);
+    // Tiles are sized to keep the rows of each tile within one work group
+    const int tile_w = params->tiled_error_diffusion ? ED_TILE_W : 0;
+    const int tile_h = params->tiled_error_diffusion ? ED_TILE_H : 0;
+    const int rows = tile_h ? PL_MIN(tile_h + PL_EDF_TILE_MARGIN, out_h) : out_h;
+    size_t shmem_req = pl_error_diffusion_shmem_req(params->error_diffusion, rows);
     if (shmem_req > rr->gpu->glsl.max_shmem_size) {
         PL_TRACE(rr, "Disabling error diffusion due to shmem requirements (%zu) "
                  "exceeding capabilities (%zu)", shmem_req, rr->gpu->glsl.max_shmem_size);
@@ -2235,6 +3563,8 @@ static bool pass_error_diffusion(struct pass_state *pass, pl_shader *sh,
     struct pl_error_diffusion_params edpars = {
         .new_depth = new_depth,
         .kernel = params->error_diffusion,
+        .tile_w = tile_w,
+        .tile_h = tile_h,
     };
 
     // Create temporary framebuffers
@@ -2256,10 +3586,17 @@ static bool pass_error_diffusion(struct pass_state *pass, pl_shader *sh,
     ));
 
     if (ok) {
+        uint64_t *prev_stat = pass->stat;
+        pass->stat = &rr->stats.time_dither;
         ok = pl_dispatch_compute(rr->dp, pl_dispatch_compute_params(
             .shader = &dsh,
-            .dispatch_size = {1, 1, 1},
+            .dispatch_size = {
+                tile_w ? PL_DIV_UP(out_w, tile_w) : 1,
+                tile_h ? PL_DIV_UP(out_h, tile_h) : 1,
+                1,
+            },
         ));
+        pass->stat = prev_stat;
     }
 
     *sh = pl_dispatch_begin(rr->dp);
@@ -2287,6 +3624,8 @@ static bool pass_output_target(struct pass_state *pass)
     const struct pl_frame *image = &pass->image;
     const struct pl_frame *target = &pass->target;
     pl_renderer rr = pass->rr;
+    PL_TRACE_ZONE(rr->log, PASS_OUTPUT_TARGET);
+    pass->stat = &rr->stats.time_output;
 
     struct img *img = &pass->img;
     pl_shader sh = img_sh(pass, img);
@@ -2436,7 +3775,9 @@ static bool pass_output_target(struct pass_state *pass)
     bool flipped_x = dst_rect.x1 < dst_rect.x0,
          flipped_y = dst_rect.y1 < dst_rect.y0;
 
-    if (!params->skip_target_clearing && pl_frame_is_cropped(target))
+    // With damage tracking, the retained borders are still valid
+    const bool scissored = pl_rect_w(pass->scissors) && pl_rect_h(pass->scissors);
+    if (!params->skip_target_clearing && !scissored && pl_frame_is_cropped(target))
         pl_frame_clear_rgba(rr->gpu, target, CLEAR_COL(params));
 
     for (int p = 0; p < target->num_planes; p++) {
@@ -2511,7 +3852,7 @@ static bool pass_output_target(struct pass_state *pass)
             // Single plane, so we can directly re-use the img shader unless
             // it's incompatible with the FBO capabilities
             bool is_comp = pl_shader_is_compute(img_sh(pass, img));
-            if (is_comp && !plane->texture->params.storable) {
+            if (is_comp && !tex_can_compute(pass, plane->texture)) {
                 if (!img_tex(pass, img)) {
                     PL_ERR(rr, "Rendering requires compute shaders, but output "
                            "is not storable, and FBOs are unavailable. This "
@@ -2580,6 +3921,7 @@ static bool pass_output_target(struct pass_state *pass)
             .target = plane->texture,
             .blend_params = params->blend_params,
             .rect = plane_rect,
+            .scissors = pass->scissors,
         ));
 
         if (!ok)
@@ -2859,7 +4201,11 @@ static void pass_uninit(struct pass_state *pass)
     release_frame(pass, &pass->prev, &pass->acquired.prev);
     release_frame(pass, &pass->image, &pass->acquired.image);
     release_frame(pass, &pass->target, &pass->acquired.target);
-    pl_free_ptr(&pass->tmp);
+    if (pass->tmp) {
+        pl_free_children(pass->tmp);
+        PL_ARRAY_APPEND(rr, rr->arenas, pass->tmp);
+        pass->tmp = NULL;
+    }
 }
 
 static void icc_fallback(struct pass_state *pass, struct pl_frame *frame,
@@ -2996,7 +4342,9 @@ static bool pass_init(struct pass_state *pass, bool acquire_image)
     find_fbo_format(pass);
     pass_fix_frames(pass);
 
-    pass->tmp = pl_tmp(NULL);
+    // Passes may be nested, so each active pass needs its own arena
+    if (!PL_ARRAY_POP(pass->rr->arenas, &pass->tmp))
+        pass->tmp = pl_arena_create(pass->rr, 0);
     return true;
 
 error:
@@ -3010,6 +4358,7 @@ static void pass_begin_frame(struct pass_state *pass)
     const struct pl_render_params *params = pass->params;
 
     pl_dispatch_callback(rr->dp, pass, info_callback);
+    pl_dispatch_set_timer_interval(rr->dp, params->timer_interval);
     pl_dispatch_reset_frame(rr->dp);
 
     for (int i = 0; i < params->num_hooks; i++) {
@@ -3017,9 +4366,18 @@ static void pass_begin_frame(struct pass_state *pass)
             params->hooks[i]->reset(params->hooks[i]->priv);
     }
 
-    size_t size = rr->fbos.num * sizeof(bool);
-    pass->fbos_used = pl_realloc(pass->tmp, pass->fbos_used, size);
-    memset(pass->fbos_used, 0, size);
+    // Age the FBO pool, freeing textures that have gone unused for too long
+    for (int i = rr->fbos.num - 1; i >= 0; i--) {
+        if (++rr->fbo_idle.elem[i] < FBO_EVICT_PASSES)
+            continue;
+        pl_tex_destroy(rr->gpu, &rr->fbos.elem[i]);
+        PL_ARRAY_REMOVE_AT(rr->fbos, i);
+        PL_ARRAY_REMOVE_AT(rr->fbo_idle, i);
+    }
+
+    size_t size = rr->fbos.num * sizeof(enum fbo_state);
+    pass->fbo_state = pl_realloc(pass->tmp, pass->fbo_state, size);
+    memset(pass->fbo_state, 0, size);
 }
 
 static bool draw_empty_overlays(pl_renderer rr,
@@ -3076,12 +4434,162 @@ static bool draw_empty_overlays(pl_renderer rr,
     return true;
 }
 
-bool pl_render_image(pl_renderer rr, const struct pl_frame *pimage,
-                     const struct pl_frame *ptarget,
-                     const struct pl_render_params *params)
+// Parameter fields are classified by the rendering stages they affect, so
+// that changing e.g. only the background color does not invalidate the
+// results of earlier stages
+struct params_info {
+    uint64_t hash;          // per-frame rendering (cached by frame mixing)
+    uint64_t mix_hash;      // frame mixing and background/tile drawing
+    uint64_t output_hash;   // final output stage (pass_output_target)
+    bool trivial;
+};
+
+static struct params_info render_params_info(const struct pl_render_params *params);
+
+static void damage_add(pl_rect2d *box, pl_rect2d rc)
+{
+    pl_rect2d_normalize(&rc);
+    if (!pl_rect_w(rc) || !pl_rect_h(rc))
+        return;
+    if (!pl_rect_w(*box) || !pl_rect_h(*box)) {
+        *box = rc;
+        return;
+    }
+    box->x0 = PL_MIN(box->x0, rc.x0);
+    box->y0 = PL_MIN(box->y0, rc.y0);
+    box->x1 = PL_MAX(box->x1, rc.x1);
+    box->y1 = PL_MAX(box->y1, rc.y1);
+}
+
+// Redirects the output of `pass` into the retained texture, and limits
+// rendering to the damaged region if the previous frame is still valid.
+// Returns the original target texture, which the retained texture must be
+// copied to after rendering, or NULL if damage tracking is not possible.
+// Sets `*skip` if nothing needs to be redrawn at all.
+static pl_tex pass_setup_damage(struct pass_state *pass, bool *skip)
+{
+    const struct pl_render_params *params = pass->params;
+    const struct pl_frame *image = &pass->image;
+    struct pl_frame *target = &pass->target;
+    pl_renderer rr = pass->rr;
+    *skip = false;
+
+    if (target->num_planes != 1 || target->planes[0].flipped ||
+        params->blend_params || params->skip_target_clearing)
+    {
+        return NULL;
+    }
+
+    pl_tex out = target->planes[0].texture;
+    pl_fmt fmt = out->params.format;
+    if (!out->params.blit_dst || !(fmt->caps & PL_FMT_CAP_BLITTABLE))
+        return NULL;
+
+    pl_tex tex = rr->damage_tex;
+    if (!tex || tex->params.w != out->params.w || tex->params.h != out->params.h ||
+        tex->params.format != fmt)
+    {
+        rr->damage_valid = false;
+        bool ok = pl_tex_recreate(rr->gpu, &rr->damage_tex, pl_tex_params(
+            .w          = out->params.w,
+            .h          = out->params.h,
+            .format     = fmt,
+            .renderable = true,
+            .storable   = out->params.storable,
+            .blit_src   = true,
+            .debug_tag  = PL_DEBUG_TAG,
+        ));
+        if (!ok)
+            return NULL;
+    }
+
+    // Everything except the contents of the frames must match the frame
+    // retained in `damage_tex`
+    const struct params_info par_info = render_params_info(params);
+    uint64_t hash = par_info.hash;
+    pl_hash_merge(&hash, par_info.mix_hash);
+    pl_hash_merge(&hash, par_info.output_hash);
+    pl_hash_merge(&hash, pl_var_hash(pass->ref_rect));
+    pl_hash_merge(&hash, pl_var_hash(pass->dst_rect));
+    pl_hash_merge(&hash, pl_var_hash(pass->rotation));
+    pl_hash_merge(&hash, pl_var_hash(image->color));
+    pl_hash_merge(&hash, pl_var_hash(image->repr));
+    pl_hash_merge(&hash, pl_var_hash(target->color));
+    pl_hash_merge(&hash, pl_var_hash(target->repr));
+    for (int i = 0; i < image->num_planes; i++) {
+        const struct pl_tex_params *tpars = &image->planes[i].texture->params;
+        pl_hash_merge(&hash, pl_var_hash(tpars->w));
+        pl_hash_merge(&hash, pl_var_hash(tpars->h));
+        pl_hash_merge(&hash, (uintptr_t) tpars->format);
+    }
+
+    target->planes[0].texture = rr->damage_tex;
+    const bool full = !rr->damage_valid || rr->damage_hash != hash ||
+                      !image->damage || !target->damage || params->num_hooks;
+    rr->damage_hash = hash;
+    rr->damage_valid = false; // until successfully rendered
+    if (full)
+        return out;
+
+    pl_rect2d box = {0};
+    const pl_rect2df ref = pass->ref_rect;
+    const pl_rect2d dst = pass->dst_rect;
+    const float sx = pl_rect_w(dst) / pl_rect_w(ref),
+                sy = pl_rect_h(dst) / pl_rect_h(ref);
+
+    // Account for the support of the scalers and debanding, in source pixels
+    float margin = 8.0;
+    if (params->deband_params)
+        margin += params->deband_params->radius;
+    margin = margin * PL_MAX(fabsf(sx), fabsf(sy)) + 1.0;
+
+    for (int i = 0; i < image->num_damage; i++) {
+        if (pass->rotation % PL_ROTATION_360) {
+            damage_add(&box, dst);
+            break;
+        }
+
+        const pl_rect2d rc = image->damage[i];
+        pl_rect2df rcf = {
+            .x0 = dst.x0 + (rc.x0 - ref.x0) * sx,
+            .y0 = dst.y0 + (rc.y0 - ref.y0) * sy,
+            .x1 = dst.x0 + (rc.x1 - ref.x0) * sx,
+            .y1 = dst.y0 + (rc.y1 - ref.y0) * sy,
+        };
+
+        pl_rect2df_normalize(&rcf);
+        damage_add(&box, (pl_rect2d) {
+            .x0 = floorf(rcf.x0 - margin),
+            .y0 = floorf(rcf.y0 - margin),
+            .x1 =  ceilf(rcf.x1 + margin),
+            .y1 =  ceilf(rcf.y1 + margin),
+        });
+    }
+
+    for (int i = 0; i < target->num_damage; i++)
+        damage_add(&box, target->damage[i]);
+
+    box.x0 = PL_CLAMP(box.x0, 0, out->params.w);
+    box.y0 = PL_CLAMP(box.y0, 0, out->params.h);
+    box.x1 = PL_CLAMP(box.x1, 0, out->params.w);
+    box.y1 = PL_CLAMP(box.y1, 0, out->params.h);
+    if (!pl_rect_w(box) || !pl_rect_h(box)) {
+        *skip = true;
+        box = (pl_rect2d) {0};
+    }
+
+    pass->scissors = box;
+    return out;
+}
+
+static bool render_image(pl_renderer rr, const struct pl_frame *pimage,
+                         const struct pl_frame *ptarget,
+                         const struct pl_render_params *params)
 {
     params = PL_DEF(params, &pl_render_default_params);
     pl_dispatch_mark_dynamic(rr->dp, params->dynamic_constants);
+    pl_dispatch_mark_low_precision(rr->dp, params->low_precision);
+    pl_dispatch_mark_fast_transfer(rr->dp, params->fast_transfer);
     if (!pimage)
         return draw_empty_overlays(rr, ptarget, params);
 
@@ -3102,14 +4610,32 @@ bool pl_render_image(pl_renderer rr, const struct pl_frame *pimage,
         return draw_empty_overlays(rr, ptarget, params);
     }
 
-    pass_begin_frame(&pass);
-    if (!pass_read_image(&pass))
-        goto error;
-    if (!pass_scale_main(&pass))
-        goto error;
-    pass_convert_colors(&pass);
-    if (!pass_output_target(&pass))
-        goto error;
+    bool skip = false;
+    pl_tex damage_out = NULL;
+    if (params->damage_tracking && rr->damage_allowed)
+        damage_out = pass_setup_damage(&pass, &skip);
+
+    if (!skip) {
+        pass_begin_frame(&pass);
+        if (!pass_read_image(&pass))
+            goto error;
+        if (!pass_scale_main(&pass))
+            goto error;
+        pass_convert_colors(&pass);
+        if (!pass_output_target(&pass))
+            goto error;
+    }
+
+    if (damage_out) {
+        pl_tex_blit(rr->gpu, pl_tex_blit_params(
+            .src = rr->damage_tex,
+            .dst = damage_out,
+        ));
+        rr->damage_valid = true;
+    }
+
+    if (skip || pl_rect_w(pass.scissors))
+        rr->stats.damage = pass.scissors;
 
     pass_uninit(&pass);
     return true;
@@ -3120,6 +4646,128 @@ error:
     return false;
 }
 
+static bool render_image_multi(pl_renderer rr, const struct pl_frame *pimage,
+                               const struct pl_frame *targets, int num_targets,
+                               const struct pl_render_params *params)
+{
+    bool ok = true;
+    params = PL_DEF(params, &pl_render_default_params);
+    pl_dispatch_mark_dynamic(rr->dp, params->dynamic_constants);
+    pl_dispatch_mark_low_precision(rr->dp, params->low_precision);
+    pl_dispatch_mark_fast_transfer(rr->dp, params->fast_transfer);
+
+    // User hooks may depend on the output size, so they can't be shared
+    if (!pimage || num_targets < 2 || params->num_hooks)
+        goto fallback;
+
+    struct pass_state src = {
+        .rr = rr,
+        .params = params,
+        .image = *pimage,
+        .target = targets[0],
+        .info.stage = PL_RENDER_STAGE_FRAME,
+    };
+
+    if (!pass_init(&src, true))
+        return false;
+
+    if (!src.fbofmt[4]) {
+        pass_uninit(&src);
+        goto fallback;
+    }
+
+    // Run all source-side passes once, and retain the result for the
+    // duration of this call
+    pass_begin_frame(&src);
+    if (!pass_read_image(&src))
+        goto error;
+    hdr_update_peak(&src);
+    if (!img_tex(&src, &src.img))
+        goto error;
+
+    // Take the shared image out of the FBO pool for the duration of this
+    // call, so the passes for the individual targets can't alias it
+    pl_tex shared = NULL;
+    for (int i = 0; i < rr->fbos.num; i++) {
+        if (rr->fbos.elem[i] == src.img.tex) {
+            shared = src.img.tex;
+            PL_ARRAY_REMOVE_AT(rr->fbos, i);
+            PL_ARRAY_REMOVE_AT(rr->fbo_idle, i);
+            break;
+        }
+    }
+
+    while (rr->samplers_multi.num < num_targets - 1)
+        PL_ARRAY_APPEND(rr, rr->samplers_multi, (struct sampler) {0});
+
+    for (int i = 0; i < num_targets; i++) {
+        struct pass_state pass = {
+            .rr = rr,
+            .params = params,
+            .image = *pimage,
+            .target = targets[i],
+            .info.stage = PL_RENDER_STAGE_FRAME,
+            .sampler_main = i ? &rr->samplers_multi.elem[i - 1] : NULL,
+        };
+
+        if (!pass_init(&pass, false)) {
+            ok = false;
+            continue;
+        }
+
+        // The source crop may be adjusted depending on the target geometry,
+        // in which case the shared image can't be reused
+        if (!pl_rect2d_eq(pass.image.crop, src.image.crop) ||
+            pass.rotation != src.rotation)
+        {
+            PL_TRACE(rr, "Target %d does not match the shared source, "
+                     "rendering separately", i);
+            pass_uninit(&pass);
+            ok &= render_image(rr, pimage, &targets[i], params);
+            continue;
+        }
+
+        if (!pl_rect_w(pass.dst_rect) || !pl_rect_h(pass.dst_rect)) {
+            pass_uninit(&pass);
+            ok &= draw_empty_overlays(rr, &targets[i], params);
+            continue;
+        }
+
+        pass_begin_frame(&pass);
+        pass.img = src.img;
+        pass.ref_rect = src.ref_rect;
+        pass.peak_detected = true;
+
+        bool pass_ok = pass_scale_main(&pass);
+        if (pass_ok) {
+            pass_convert_colors(&pass);
+            pass_ok = pass_output_target(&pass);
+        }
+
+        if (!pass_ok)
+            PL_ERR(rr, "Failed rendering image to target %d!", i);
+        ok &= pass_ok;
+        pass_uninit(&pass);
+    }
+
+    if (shared) {
+        PL_ARRAY_APPEND(rr, rr->fbos, shared);
+        PL_ARRAY_APPEND(rr, rr->fbo_idle, 0);
+    }
+    pass_uninit(&src);
+    return ok;
+
+error:
+    PL_ERR(rr, "Failed rendering image!");
+    pass_uninit(&src);
+    return false;
+
+fallback:
+    for (int i = 0; i < num_targets; i++)
+        ok &= render_image(rr, pimage, &targets[i], params);
+    return ok;
+}
+
 const struct pl_frame *pl_frame_mix_current(const struct pl_frame_mix *mix)
 {
     const struct pl_frame *cur = NULL;
@@ -3153,11 +4801,6 @@ const struct pl_frame *pl_frame_mix_nearest(const struct pl_frame_mix *mix)
     return best;
 }
 
-struct params_info {
-    uint64_t hash;
-    bool trivial;
-};
-
 static struct params_info render_params_info(const struct pl_render_params *params_orig)
 {
     struct pl_render_params params = *params_orig;
@@ -3166,7 +4809,7 @@ static struct params_info render_params_info(const struct pl_render_params *para
         .hash = 0,
     };
 
-#define HASH_PTR(ptr, def, ptr_trivial)                                         \
+#define HASH_PTR_INTO(hash, ptr, def, ptr_trivial)                              \
     do {                                                                        \
         if (ptr) {                                                              \
             pl_hash_merge(&info.hash, pl_mem_hash(ptr, sizeof(*ptr)));          \
@@ -3177,6 +4820,8 @@ static struct params_info render_params_info(const struct pl_render_params *para
         }                                                                       \
     } while (0)
 
+#define HASH_PTR(ptr, def, ptr_trivial) HASH_PTR_INTO(hash, ptr, def, ptr_trivial)
+
 #define HASH_FILTER(scaler)                                                     \
     do {                                                                        \
         if ((scaler == &pl_filter_bilinear || scaler == &pl_filter_nearest) &&  \
@@ -3222,28 +4867,44 @@ static struct params_info render_params_info(const struct pl_render_params *para
     }
 
 #define CLEAR(field) field = (__typeof__(field)) {0}
+#define MOVE(hash, field)                                                       \
+    do {                                                                        \
+        pl_hash_merge(&info.hash, pl_var_hash(field));                          \
+        memset(&(field), 0, sizeof(field));                                     \
+    } while (0)
 
-    // Clear out fields only relevant to pl_render_image_mix
-    CLEAR(params.frame_mixer);
-    CLEAR(params.preserve_mixing_cache);
-    CLEAR(params.skip_caching_single_frame);
-    memset(params.background_color, 0, sizeof(params.background_color));
-    CLEAR(params.background_transparency);
-    CLEAR(params.skip_target_clearing);
-    CLEAR(params.blend_against_tiles);
-    memset(params.tile_colors, 0, sizeof(params.tile_colors));
-    CLEAR(params.tile_size);
-
-    // Clear out fields only relevant to pass_output_target
-    CLEAR(params.blend_params);
-    CLEAR(params.distort_params);
-    CLEAR(params.dither_params);
-    CLEAR(params.error_diffusion);
-    CLEAR(params.force_dither);
-    CLEAR(params.corner_rounding);
+    // Move out fields only relevant to pl_render_image_mix
+    if (params.frame_mixer) {
+        struct pl_filter_config mixer = *params.frame_mixer;
+        HASH_PTR_INTO(mix_hash, mixer.kernel, NULL, true);
+        HASH_PTR_INTO(mix_hash, mixer.window, NULL, true);
+        pl_hash_merge(&info.mix_hash, pl_var_hash(mixer));
+        CLEAR(params.frame_mixer);
+    }
+    MOVE(mix_hash, params.preserve_mixing_cache);
+    MOVE(mix_hash, params.skip_caching_single_frame);
+    MOVE(mix_hash, params.background_color);
+    MOVE(mix_hash, params.background_transparency);
+    MOVE(mix_hash, params.skip_target_clearing);
+    MOVE(mix_hash, params.blend_against_tiles);
+    MOVE(mix_hash, params.tile_colors);
+    MOVE(mix_hash, params.tile_size);
+
+    // Move out fields only relevant to pass_output_target
+    HASH_PTR_INTO(output_hash, params.blend_params, NULL, true);
+    HASH_PTR_INTO(output_hash, params.distort_params, NULL, true);
+    HASH_PTR_INTO(output_hash, params.dither_params, NULL, true);
+    MOVE(output_hash, params.error_diffusion);
+    MOVE(output_hash, params.tiled_error_diffusion);
+    MOVE(output_hash, params.force_dither);
+    MOVE(output_hash, params.corner_rounding);
 
     // Clear out other irrelevant fields
     CLEAR(params.dynamic_constants);
+    CLEAR(params.async_compile);
+    CLEAR(params.parallel_planes);
+    CLEAR(params.adaptive_params);
+    CLEAR(params.damage_tracking);
     CLEAR(params.info_callback);
     CLEAR(params.info_priv);
 
@@ -3253,16 +4914,272 @@ static struct params_info render_params_info(const struct pl_render_params *para
 
 #define MAX_MIX_FRAMES 16
 
-bool pl_render_image_mix(pl_renderer rr, const struct pl_frame_mix *images,
-                         const struct pl_frame *ptarget,
-                         const struct pl_render_params *params)
+// Upper bound on the number of textures bound by the direct mixing shader
+#define MAX_DIRECT_TEXTURES 16
+
+// Check whether a frame (as prepared by `pass_init`) can be sampled directly
+// by the frame mixing shader, bypassing the intermediate per-frame rendering
+// step. This requires that the frame needs no scaling, and nothing beyond
+// decoding and color mapping (which the mixing shader can do itself).
+static bool can_mix_direct(const struct pass_state *pass,
+                           const struct pass_state *fpass,
+                           const struct params_info *par_info,
+                           int out_w, int out_h)
+{
+    const struct pl_render_params *params = pass->params;
+    const struct pl_frame *img = &fpass->image;
+    if (!par_info->trivial || params->cone_params)
+        return false;
+    if (pass->target.icc || pass->target.profile.data)
+        return false;
+    if (img->icc || img->profile.data || img->lut || img->num_overlays)
+        return false;
+    if (img->film_grain.type != PL_FILM_GRAIN_NONE || img->field != PL_FIELD_NONE)
+        return false;
+    if (img->repr.sys == PL_COLOR_SYSTEM_XYZ || img->repr.sys == PL_COLOR_SYSTEM_DOLBYVISION)
+        return false;
+    if (fpass->rotation || !pl_rect2d_eq(fpass->dst_rect, pass->dst_rect))
+        return false;
+
+    // The source must be sampled 1:1, aligned to the texel grid
+    const pl_rect2df *rc = &fpass->ref_rect;
+    if (pl_rect_w(*rc) != out_w || pl_rect_h(*rc) != out_h ||
+        rc->x0 != roundf(rc->x0) || rc->y0 != roundf(rc->y0))
+        return false;
+
+    // All planes must be full-resolution, and together provide all channels
+    pl_tex ref = img->planes[fpass->src_ref].texture;
+    int channels = 0;
+    for (int i = 0; i < img->num_planes; i++) {
+        const struct pl_plane *plane = &img->planes[i];
+        pl_tex tex = plane->texture;
+        if (!tex->params.sampleable || plane->flipped)
+            return false;
+        if (tex->params.w != ref->params.w || tex->params.h != ref->params.h)
+            return false;
+        if (plane->shift_x || plane->shift_y)
+            return false;
+        for (int c = 0; c < plane->components; c++) {
+            int ch = plane->component_mapping[c];
+            if (ch >= 0 && ch < 4)
+                channels |= 1 << ch;
+        }
+    }
+
+    return (channels & 0x7) == 0x7;
+}
+
+// Sample a frame accepted by `can_mix_direct` into `color`, converted to the
+// mixing color space and with premultiplied alpha. Returns the number of
+// components.
+static int mix_direct_frame(const struct pass_state *pass, pl_shader sh,
+                            const struct pass_state *fpass)
+{
+    const struct pl_render_params *params = pass->params;
+    const struct pl_frame *img = &fpass->image;
+    const pl_rect2df *rc = &fpass->ref_rect;
+    int comps = 3;
+
+    GLSL("color = vec4(0.0, 0.0, 0.0, 1.0); \n");
+    for (int i = 0; i < img->num_planes; i++) {
+        const struct pl_plane *plane = &img->planes[i];
+        ident_t pos, tex = sh_bind(sh, plane->texture, PL_TEX_ADDRESS_CLAMP,
+                                   PL_TEX_SAMPLE_NEAREST, "plane", rc, &pos, NULL);
+
+        GLSL("{                                         \n"
+             "vec4 tmp = textureLod("$", "$", 0.0);     \n", tex, pos);
+        for (int c = 0; c < plane->components; c++) {
+            int ch = plane->component_mapping[c];
+            if (ch >= 0 && ch < 4)
+                GLSL("color[%d] = tmp[%d]; \n", ch, c);
+            if (ch == PL_CHANNEL_A && img->repr.alpha != PL_ALPHA_UNKNOWN)
+                comps = 4;
+        }
+        GLSL("} \n");
+    }
+
+    struct pl_color_repr repr = img->repr;
+    pl_shader_decode_color(sh, &repr, params->color_adjustment);
+    pl_shader_set_alpha(sh, &repr, PL_ALPHA_INDEPENDENT);
+
+    // Use the same HDR metadata for all frames, to keep tone mapping
+    // consistent and avoid recompilation, similar to the cached path below
+    struct pl_color_space frame_csp = img->color;
+    frame_csp.hdr = pass->image.color.hdr;
+    pl_shader_color_map_ex(sh, params->color_map_params, pl_color_map_args(
+        .src = frame_csp,
+        .dst = pass->target.color,
+    ));
+
+    pl_shader_set_alpha(sh, &repr, PL_ALPHA_PREMULTIPLIED);
+    return comps;
+}
+
+static void release_direct_frames(struct pass_state *fpasses, int num)
+{
+    for (int i = 0; i < num; i++) {
+        fpasses[i].acquired.target = false; // don't release target
+        pass_uninit(&fpasses[i]);
+    }
+}
+
+// Estimate the motion between two cached frames by block matching on their
+// feature maps, symmetrically around the interpolated position `t`. Returns
+// a texture with one motion vector (and confidence) per block, or NULL on
+// failure.
+static pl_tex estimate_motion(struct pass_state *pass,
+                              const struct cached_frame frames[2], float t,
+                              const struct pl_filter_config *mixer,
+                              int out_w, int out_h)
+{
+    pl_renderer rr = pass->rr;
+    const float *p = mixer->params;
+    const int block = p[0] ? PL_CLAMP(lrintf(p[0]), 1, 256) : 16;
+    const int radius = p[1] ? PL_CLAMP(lrintf(p[1]), 1, 16) : 4;
+    const int fm_w = PL_DIV_UP(out_w, block),
+              fm_h = PL_DIV_UP(out_h, block);
+
+    pl_tex feat[2];
+    for (int i = 0; i < 2; i++) {
+        const struct pl_tex_params *tpars = &frames[i].tex->params;
+        const pl_rect2df rect = { 0, 0, tpars->w, tpars->h };
+        feat[i] = extract_feature_map(pass, frames[i].tex, rect,
+                                      frames[i].color, fm_w, fm_h);
+        if (!feat[i])
+            return NULL;
+    }
+
+    pl_tex mv_tex = get_fbo(pass, fm_w, fm_h, NULL, 4, PL_DEBUG_TAG);
+    if (!mv_tex)
+        return NULL;
+
+    pl_shader sh = pl_dispatch_begin(rr->dp);
+    sh_describe(sh, "motion estimation");
+    sh->output = PL_SHADER_SIG_COLOR;
+    sh->output_w = fm_w;
+    sh->output_h = fm_h;
+
+    enum pl_tex_sample_mode sample_mode = PL_TEX_SAMPLE_NEAREST;
+    if (feat[0]->params.format->caps & PL_FMT_CAP_LINEAR)
+        sample_mode = PL_TEX_SAMPLE_LINEAR;
+
+    ident_t pos_a, pt_a, tex_a = sh_bind(sh, feat[0], PL_TEX_ADDRESS_MIRROR,
+                                         sample_mode, "feat_a", NULL, &pos_a, &pt_a);
+    ident_t pos_b, pt_b, tex_b = sh_bind(sh, feat[1], PL_TEX_ADDRESS_MIRROR,
+                                         sample_mode, "feat_b", NULL, &pos_b, &pt_b);
+
+    // For every candidate vector `d` (in blocks), compare the neighbourhood
+    // of A at `pos - t * d` against B at `pos + (1 - t) * d`, with a slight
+    // bias towards shorter vectors to stabilize flat regions
+    GLSL("vec4 color;                                                   \n"
+         "// estimate_motion                                            \n"
+         "{                                                             \n"
+         "float t = "$";                                                \n"
+         "float best_cost = 1e9;                                        \n"
+         "vec2 best = vec2(0.0);                                        \n"
+         "for (int y = -%d; y <= %d; y++) {                             \n"
+         "for (int x = -%d; x <= %d; x++) {                             \n"
+         "    vec2 d = vec2(float(x), float(y));                        \n"
+         "    vec2 pa = "$" - t * d * "$";                              \n"
+         "    vec2 pb = "$" + (1.0 - t) * d * "$";                      \n"
+         "    float cost = 0.01 * length(d);                            \n"
+         "    for (int j = -1; j <= 1; j++) {                           \n"
+         "    for (int i = -1; i <= 1; i++) {                           \n"
+         "        vec2 o = vec2(float(i), float(j));                    \n"
+         "        float a = textureLod("$", pa + o * "$", 0.0).x;       \n"
+         "        float b = textureLod("$", pb + o * "$", 0.0).x;       \n"
+         "        cost += abs(a - b);                                   \n"
+         "    }}                                                        \n"
+         "    if (cost < best_cost) {                                   \n"
+         "        best_cost = cost;                                     \n"
+         "        best = d;                                             \n"
+         "    }                                                         \n"
+         "}}                                                            \n"
+         "float conf = 1.0 - smoothstep(0.02, 0.08, best_cost / 9.0);   \n"
+         "color = vec4(best * vec2(%f) + vec2(0.5), conf, 1.0);         \n"
+         "}                                                             \n",
+         SH_FLOAT_DYN(t), radius, radius, radius, radius,
+         pos_a, pt_a, pos_b, pt_b, tex_a, pt_a, tex_b, pt_b,
+         0.5f / radius);
+
+    bool ok = pl_dispatch_finish(rr->dp, pl_dispatch_params(
+        .shader = &sh,
+        .target = mv_tex,
+    ));
+
+    release_fbo(pass, feat[0]);
+    release_fbo(pass, feat[1]);
+    return ok ? mv_tex : NULL;
+}
+
+// Mix two cached frames along the motion vectors estimated by
+// `estimate_motion`, adding the result to `mix_color`. Returns the number of
+// components.
+static int mix_motion_frames(const struct pass_state *pass, pl_shader sh,
+                             const struct cached_frame frames[2], float t,
+                             const struct pl_filter_config *mixer,
+                             pl_tex mv_tex)
+{
+    const struct pl_frame *target = &pass->target;
+    const float *p = mixer->params;
+    const int radius = p[1] ? PL_CLAMP(lrintf(p[1]), 1, 16) : 4;
+
+    enum pl_tex_sample_mode mv_mode = PL_TEX_SAMPLE_NEAREST;
+    if (mv_tex->params.format->caps & PL_FMT_CAP_LINEAR)
+        mv_mode = PL_TEX_SAMPLE_LINEAR;
+
+    ident_t mv_pos, mv = sh_bind(sh, mv_tex, PL_TEX_ADDRESS_CLAMP, mv_mode,
+                                 "motion", NULL, &mv_pos, NULL);
+
+    // Scale the vectors from blocks to normalized texture coordinates, and
+    // fade them out where the match was poor
+    GLSL("vec4 mv = textureLod("$", "$", 0.0);                  \n"
+         "vec2 mv_d = mv.z * (mv.xy - vec2(0.5)) * vec2(%f, %f);\n",
+         mv, mv_pos,
+         2.0f * radius / mv_tex->params.w,
+         2.0f * radius / mv_tex->params.h);
+
+    int comps = 0;
+    for (int i = 0; i < 2; i++) {
+        const struct pl_tex_params *tpars = &frames[i].tex->params;
+        enum pl_tex_sample_mode sample_mode = PL_TEX_SAMPLE_NEAREST;
+        if (tpars->format->caps & PL_FMT_CAP_LINEAR)
+            sample_mode = PL_TEX_SAMPLE_LINEAR;
+
+        ident_t pos, tex = sh_bind(sh, frames[i].tex, PL_TEX_ADDRESS_CLAMP,
+                                   sample_mode, "frame", NULL, &pos, NULL);
+
+        // Frame A is sampled at `pos - t * d`, frame B at `pos + (1 - t) * d`
+        const float offset = i ? 1.0f - t : -t;
+        GLSL("color = textureLod("$", "$" + vec2("$") * mv_d, 0.0); \n",
+             tex, pos, SH_FLOAT_DYN(offset));
+
+        // Same color space handling as the regular frame mixing path
+        struct pl_color_space frame_csp = frames[i].color;
+        struct pl_color_space mix_csp = target->color;
+        frame_csp.hdr = mix_csp.hdr = (struct pl_hdr_metadata) {0};
+        pl_shader_color_map_ex(sh, NULL, pl_color_map_args(frame_csp, mix_csp));
+
+        const float weight = i ? t : 1.0f - t;
+        GLSL("mix_color += vec4("$") * color; \n", SH_FLOAT_DYN(weight));
+        comps = PL_MAX(comps, frames[i].comps);
+    }
+
+    return comps;
+}
+
+static bool render_image_mix(pl_renderer rr, const struct pl_frame_mix *images,
+                             const struct pl_frame *ptarget,
+                             const struct pl_render_params *params)
 {
     if (!images->num_frames)
-        return pl_render_image(rr, NULL, ptarget, params);
+        return render_image(rr, NULL, ptarget, params);
 
     params = PL_DEF(params, &pl_render_default_params);
     struct params_info par_info = render_params_info(params);
     pl_dispatch_mark_dynamic(rr->dp, params->dynamic_constants);
+    pl_dispatch_mark_low_precision(rr->dp, params->low_precision);
+    pl_dispatch_mark_fast_transfer(rr->dp, params->fast_transfer);
 
     require(images->num_frames >= 1);
     require(images->vsync_duration > 0.0);
@@ -3278,6 +5195,10 @@ bool pl_render_image_mix(pl_renderer rr, const struct pl_frame_mix *images,
         .info.stage = PL_RENDER_STAGE_BLEND,
     };
 
+    // Frames sampled directly by the mixing shader, see `can_mix_direct`
+    struct pass_state *direct_frames = NULL;
+    int num_direct = 0, num_direct_tex = 0;
+
     if (rr->errors & PL_RENDER_ERR_FRAME_MIXING)
         goto fallback;
     if (!pass_init(&pass, false))
@@ -3297,9 +5218,17 @@ bool pl_render_image_mix(pl_renderer rr, const struct pl_frame_mix *images,
     float wsum = 0.0;
 
     // Garbage collect the cache by evicting all frames from the cache that are
-    // not determined to still be required
-    for (int i = 0; i < rr->frames.num; i++)
-        rr->frames.elem[i].evict = true;
+    // not determined to still be required, or hinted to be required again
+    for (int i = 0; i < rr->frames.num; i++) {
+        struct cached_frame *f = &rr->frames.elem[i];
+        f->evict = true;
+        for (int j = 0; j < images->num_retain; j++) {
+            if (images->retain[j] == f->signature) {
+                f->evict = false;
+                break;
+            }
+        }
+    }
 
     // Blur frame mixer according to vsync ratio (source / display)
     struct pl_filter_config mixer;
@@ -3318,6 +5247,16 @@ bool pl_render_image_mix(pl_renderer rr, const struct pl_frame_mix *images,
 
     // Traverse the input frames and determine/prepare the ones we need
     bool single_frame = !params->frame_mixer || images->num_frames == 1;
+
+    // Try mixing the frames directly from their source textures first, which
+    // avoids rendering and storing an intermediate texture per frame. Only
+    // worth it when mixing multiple frames, so single frames still go through
+    // the cache to speed up redraws.
+    bool motion = !single_frame && mixer.kernel == &pl_filter_function_motion;
+    bool direct = !single_frame && !motion && par_info.trivial;
+    if (direct)
+        direct_frames = pl_calloc_ptr(pass.tmp, MAX_MIX_FRAMES, direct_frames);
+
 retry:
     for (int i = 0; i < images->num_frames; i++) {
         uint64_t sig = images->signatures[i];
@@ -3382,7 +5321,7 @@ retry:
         }
 
         struct cached_frame *f = NULL;
-        for (int j = 0; j < rr->frames.num; j++) {
+        for (int j = 0; !direct && j < rr->frames.num; j++) {
             if (rr->frames.elem[j].signature == sig) {
                 f = &rr->frames.elem[j];
                 f->evict = false;
@@ -3401,6 +5340,44 @@ retry:
             continue;
         }
 
+        if (direct) {
+            pl_assert(num_direct < MAX_MIX_FRAMES);
+            struct pass_state *fpass = &direct_frames[num_direct];
+            *fpass = (struct pass_state) {
+                .rr = rr,
+                .params = pass.params,
+                .image = *img,
+                .target = *ptarget,
+                .info.stage = PL_RENDER_STAGE_FRAME,
+                .acquired = pass.acquired,
+            };
+
+            memcpy(fpass->fbofmt, pass.fbofmt, sizeof(pass.fbofmt));
+            if (!pass_init(fpass, true))
+                goto fail;
+
+            num_direct++;
+            num_direct_tex += fpass->image.num_planes;
+            if (num_direct_tex > MAX_DIRECT_TEXTURES ||
+                !can_mix_direct(&pass, fpass, &par_info, out_w, out_h))
+            {
+                // Fall back to rendering each frame into the cache
+                PL_TRACE(rr, "  -> Can't mix frames directly, using cache");
+                release_direct_frames(direct_frames, num_direct);
+                num_direct = num_direct_tex = 0;
+                fidx = 0;
+                wsum = 0.0;
+                direct = false;
+                goto retry;
+            }
+
+            PL_TRACE(rr, "  -> Mixing directly from source textures");
+            weights[fidx] = weight;
+            wsum += weight;
+            fidx++;
+            continue;
+        }
+
         bool skip_cache = single_frame && (params->skip_caching_single_frame || par_info.trivial);
         if (!f && skip_cache) {
             PL_TRACE(rr, "Single frame not found in cache, bypassing");
@@ -3557,6 +5534,7 @@ inter_pass_error:
     if (!fidx) {
         pl_assert(!single_frame);
         single_frame = true;
+        direct = false;
         goto retry;
     }
 
@@ -3565,6 +5543,19 @@ inter_pass_error:
     pass.info.count = fidx;
     pl_assert(fidx > 0);
 
+    // Motion compensation only supports interpolating between two frames,
+    // anything else falls back to regular blending
+    pl_tex mv_tex = NULL;
+    float motion_t = 0.0;
+    if (motion && fidx == 2 && wsum > 0 && !(rr->errors & PL_RENDER_ERR_MOTION)) {
+        motion_t = weights[1] / wsum;
+        mv_tex = estimate_motion(&pass, frames, motion_t, &mixer, out_w, out_h);
+        if (!mv_tex) {
+            PL_ERR(rr, "Failed estimating motion for frame mixing, disabling");
+            rr->errors |= PL_RENDER_ERR_MOTION;
+        }
+    }
+
     pl_shader sh = pl_dispatch_begin(rr->dp);
     sh_describef(sh, "frame mixing (%d frame%s)", fidx, fidx > 1 ? "s" : "");
     sh->output = PL_SHADER_SIG_COLOR;
@@ -3577,7 +5568,17 @@ inter_pass_error:
          "vec4 mix_color = vec4(0.0);   \n");
 
     int comps = 0;
-    for (int i = 0; i < fidx; i++) {
+    if (mv_tex)
+        comps = mix_motion_frames(&pass, sh, frames, motion_t, &mixer, mv_tex);
+
+    for (int i = 0; direct && i < fidx; i++) {
+        int frame_comps = mix_direct_frame(&pass, sh, &direct_frames[i]);
+        float weight = weights[i] / wsum;
+        GLSL("mix_color += vec4("$") * color; \n", SH_FLOAT_DYN(weight));
+        comps = PL_MAX(comps, frame_comps);
+    }
+
+    for (int i = 0; !direct && !mv_tex && i < fidx; i++) {
         const struct pl_tex_params *tpars = &frames[i].tex->params;
 
         // Use linear sampling if desired and possible
@@ -3631,6 +5632,7 @@ inter_pass_error:
     if (!pass_output_target(&pass))
         goto fallback;
 
+    release_direct_frames(direct_frames, num_direct);
     pass_uninit(&pass);
     return true;
 
@@ -3640,13 +5642,317 @@ fail:
     // fall through
 
 fallback:
+    release_direct_frames(direct_frames, num_direct);
     pass_uninit(&pass);
-    return pl_render_image(rr, refimg, ptarget, params);
+    return render_image(rr, refimg, ptarget, params);
 
 error: // for parameter validation failures
     return false;
 }
 
+// Cheaper parameters used while the shaders for `params` are still compiling
+static struct pl_render_params async_fallback_params(const struct pl_render_params *params)
+{
+    struct pl_render_params fallback = *params;
+    fallback.upscaler = fallback.downscaler = NULL;
+    fallback.plane_upscaler = fallback.plane_downscaler = NULL;
+    fallback.deband_params = NULL;
+    fallback.sigmoid_params = NULL;
+    fallback.peak_detect_params = NULL;
+    fallback.error_diffusion = NULL;
+    fallback.async_compile = false;
+    return fallback;
+}
+
+const struct pl_adaptive_params pl_adaptive_default_params = { PL_ADAPTIVE_DEFAULTS };
+
+enum {
+    // Quality reduction steps of the adaptive quality controller (cumulative)
+    ADAPTIVE_NONE = 0,
+    ADAPTIVE_DITHER,    // no error diffusion, single debanding iteration
+    ADAPTIVE_HDR,       // no peak detection or sigmoidization
+    ADAPTIVE_SCALERS,   // no debanding, built-in sampling only
+    ADAPTIVE_MAX = ADAPTIVE_SCALERS,
+};
+
+// Updates the quality level based on the statistics of the previous frame
+static void adaptive_update(pl_renderer rr, const struct pl_render_params *params)
+{
+    const struct pl_adaptive_params *ap = params->adaptive_params;
+    if (!ap || !ap->target_ms) {
+        rr->adaptive_level = ADAPTIVE_NONE;
+        rr->adaptive_over = rr->adaptive_under = 0;
+        return;
+    }
+
+    const uint64_t time = rr->stats.time_total;
+    if (!time)
+        return; // no measurements available (yet)
+
+    const float ms = time / 1e6;
+    if (ms > ap->target_ms) {
+        rr->adaptive_under = 0;
+        if (++rr->adaptive_over < PL_MAX(ap->frames_down, 1))
+            return;
+        rr->adaptive_over = 0;
+        if (rr->adaptive_level < ADAPTIVE_MAX) {
+            rr->adaptive_level++;
+            PL_INFO(rr, "Frame time %.2f ms exceeds target %.2f ms, reducing "
+                    "quality (level %d)", ms, ap->target_ms, rr->adaptive_level);
+        }
+    } else if (ms < ap->target_ms * ap->headroom) {
+        rr->adaptive_over = 0;
+        if (++rr->adaptive_under < PL_MAX(ap->frames_up, 1))
+            return;
+        rr->adaptive_under = 0;
+        if (rr->adaptive_level > ADAPTIVE_NONE) {
+            rr->adaptive_level--;
+            PL_INFO(rr, "Frame time %.2f ms within target %.2f ms, increasing "
+                    "quality (level %d)", ms, ap->target_ms, rr->adaptive_level);
+        }
+    } else {
+        rr->adaptive_over = rr->adaptive_under = 0;
+    }
+}
+
+// Applies the current quality level to `params`, using `tmp` as storage
+static const struct pl_render_params *
+adaptive_params(pl_renderer rr, const struct pl_render_params *params,
+                struct pl_render_params *tmp, struct pl_deband_params *deband)
+{
+    adaptive_update(rr, params);
+    const int level = rr->adaptive_level;
+    if (level == ADAPTIVE_NONE)
+        return params;
+
+    *tmp = *params;
+    if (level >= ADAPTIVE_DITHER) {
+        tmp->error_diffusion = NULL;
+        if (tmp->deband_params) {
+            *deband = *tmp->deband_params;
+            deband->iterations = PL_MIN(deband->iterations, 1);
+            tmp->deband_params = deband;
+        }
+    }
+
+    if (level >= ADAPTIVE_HDR) {
+        tmp->peak_detect_params = NULL;
+        tmp->sigmoid_params = NULL;
+    }
+
+    if (level >= ADAPTIVE_SCALERS) {
+        tmp->deband_params = NULL;
+        tmp->upscaler = tmp->downscaler = NULL;
+        tmp->plane_upscaler = tmp->plane_downscaler = NULL;
+    }
+
+    return tmp;
+}
+
+static void stats_begin(pl_renderer rr, const struct pl_frame *target)
+{
+    rr->stats = (struct pl_render_stats) {
+        .adaptive_level = rr->adaptive_level,
+    };
+
+    for (int i = 0; target && i < target->num_planes; i++) {
+        const struct pl_tex_params *tpars = &target->planes[i].texture->params;
+        rr->stats.damage.x1 = PL_MAX(rr->stats.damage.x1, tpars->w);
+        rr->stats.damage.y1 = PL_MAX(rr->stats.damage.y1, tpars->h);
+    }
+    rr->stats_compiled = pl_dispatch_num_compiled(rr->dp);
+}
+
+static bool stats_end(pl_renderer rr, bool ok)
+{
+    struct pl_render_stats *stats = &rr->stats;
+    rr->damage_allowed = false;
+    stats->num_compiled = pl_dispatch_num_compiled(rr->dp) - rr->stats_compiled;
+    if (rr->memory_budget)
+        pl_renderer_trim(rr, rr->memory_budget);
+
+    const pl_tex *fbos[] = { rr->fbos.elem, rr->frame_fbos.elem };
+    const int num_fbos[] = { rr->fbos.num, rr->frame_fbos.num };
+    for (int i = 0; i < PL_ARRAY_SIZE(fbos); i++) {
+        for (int j = 0; j < num_fbos[i]; j++) {
+            pl_tex tex = fbos[i][j];
+            if (!tex)
+                continue;
+            stats->num_fbos++;
+            stats->fbo_memory += tex_memory(tex);
+        }
+    }
+
+    return ok;
+}
+
+bool pl_render_image(pl_renderer rr, const struct pl_frame *pimage,
+                     const struct pl_frame *ptarget,
+                     const struct pl_render_params *params)
+{
+    PL_ALLOC_SCOPE(RENDERER);
+    PL_TRACE_ZONE(rr->log, RENDER_IMAGE);
+    params = PL_DEF(params, &pl_render_default_params);
+    struct pl_render_params adapted;
+    struct pl_deband_params deband;
+    params = adaptive_params(rr, params, &adapted, &deband);
+    stats_begin(rr, ptarget);
+    rr->damage_allowed = true;
+    if (!params->async_compile)
+        return stats_end(rr, render_image(rr, pimage, ptarget, params));
+
+    pl_dispatch_set_async(rr->dp, true);
+    uint64_t deferred = pl_dispatch_num_deferred(rr->dp);
+    bool ok = render_image(rr, pimage, ptarget, params);
+    pl_dispatch_set_async(rr->dp, false);
+    if (pl_dispatch_num_deferred(rr->dp) == deferred)
+        return stats_end(rr, ok);
+
+    // Some passes were skipped, redraw the frame using cheaper shaders
+    PL_TRACE(rr, "Shaders still compiling, rendering fallback frame");
+    struct pl_render_params fallback = async_fallback_params(params);
+    return stats_end(rr, render_image(rr, pimage, ptarget, &fallback));
+}
+
+static bool frame_busy(pl_renderer rr, const struct inflight_frame *frame,
+                       uint64_t timeout)
+{
+    for (int i = 0; i < frame->num_planes; i++) {
+        if (pl_tex_poll(rr->gpu, frame->planes[i], timeout))
+            return true;
+    }
+    return false;
+}
+
+// Retires all completed frames, in submission order. If `token` is nonzero,
+// blocks for up to `timeout` on each frame up to and including `token`.
+static void retire_frames(pl_renderer rr, pl_render_token token, uint64_t timeout)
+{
+    int num = 0;
+    while (num < rr->inflight.num) {
+        const struct inflight_frame *frame = &rr->inflight.elem[num];
+        if (frame_busy(rr, frame, frame->token <= token ? timeout : 0))
+            break;
+        num++;
+    }
+
+    if (!num)
+        return;
+
+    // Remove the frames before dispatching callbacks, which may re-enter
+    struct inflight_frame *done = pl_memdup(NULL, rr->inflight.elem,
+                                            num * sizeof(done[0]));
+    PL_ARRAY_REMOVE_RANGE(rr->inflight, 0, num);
+    for (int i = 0; i < num; i++) {
+        PL_TRACE(rr, "Frame %"PRIu64" completed", done[i].token);
+        if (done[i].done)
+            done[i].done(done[i].priv, done[i].token);
+    }
+    pl_free(done);
+}
+
+bool pl_renderer_poll(pl_renderer rr, pl_render_token token, uint64_t timeout)
+{
+    if (!token || token > rr->last_token)
+        return false;
+
+    // Frames are always retired in order, so all later frames are pending
+    retire_frames(rr, token, timeout);
+    return rr->inflight.num && rr->inflight.elem[0].token <= token;
+}
+
+pl_render_token pl_render_image_async(pl_renderer rr, const struct pl_frame *image,
+                                      const struct pl_frame *target,
+                                      const struct pl_render_params *params,
+                                      const struct pl_render_async_params *async)
+{
+    static const struct pl_render_async_params defaults = {0};
+    async = PL_DEF(async, &defaults);
+
+    // Throttle submission by waiting on the oldest frames
+    retire_frames(rr, 0, 0);
+    const int max_frames = async->max_frames_in_flight;
+    while (max_frames > 0 && rr->inflight.num >= max_frames) {
+        const pl_render_token oldest = rr->inflight.elem[0].token;
+        while (pl_renderer_poll(rr, oldest, UINT64_MAX))
+            ; // do nothing
+    }
+
+    if (!pl_render_image(rr, image, target, params))
+        return 0;
+
+    struct inflight_frame frame = {
+        .token      = ++rr->last_token,
+        .num_planes = target->num_planes,
+        .done       = async->done,
+        .priv       = async->priv,
+    };
+    for (int i = 0; i < target->num_planes; i++)
+        frame.planes[i] = target->planes[i].texture;
+
+    PL_ARRAY_APPEND(rr, rr->inflight, frame);
+    pl_gpu_flush(rr->gpu);
+    return frame.token;
+}
+
+bool pl_render_image_multi(pl_renderer rr, const struct pl_frame *image,
+                           const struct pl_frame *targets, int num_targets,
+                           const struct pl_render_params *params)
+{
+    PL_ALLOC_SCOPE(RENDERER);
+    PL_TRACE_ZONE(rr->log, RENDER_IMAGE);
+    params = PL_DEF(params, &pl_render_default_params);
+    struct pl_render_params adapted;
+    struct pl_deband_params deband;
+    params = adaptive_params(rr, params, &adapted, &deband);
+    stats_begin(rr, num_targets ? &targets[0] : NULL);
+    if (!params->async_compile) {
+        return stats_end(rr, render_image_multi(rr, image, targets,
+                                                num_targets, params));
+    }
+
+    pl_dispatch_set_async(rr->dp, true);
+    uint64_t deferred = pl_dispatch_num_deferred(rr->dp);
+    bool ok = render_image_multi(rr, image, targets, num_targets, params);
+    pl_dispatch_set_async(rr->dp, false);
+    if (pl_dispatch_num_deferred(rr->dp) == deferred)
+        return stats_end(rr, ok);
+
+    PL_TRACE(rr, "Shaders still compiling, rendering fallback frames");
+    struct pl_render_params fallback = async_fallback_params(params);
+    return stats_end(rr, render_image_multi(rr, image, targets, num_targets,
+                                            &fallback));
+}
+
+bool pl_render_image_mix(pl_renderer rr, const struct pl_frame_mix *images,
+                         const struct pl_frame *ptarget,
+                         const struct pl_render_params *params)
+{
+    PL_ALLOC_SCOPE(RENDERER);
+    params = PL_DEF(params, &pl_render_default_params);
+    struct pl_render_params adapted;
+    struct pl_deband_params deband;
+    params = adaptive_params(rr, params, &adapted, &deband);
+    stats_begin(rr, ptarget);
+    if (!params->async_compile)
+        return stats_end(rr, render_image_mix(rr, images, ptarget, params));
+
+    pl_dispatch_set_async(rr->dp, true);
+    uint64_t deferred = pl_dispatch_num_deferred(rr->dp);
+    bool ok = render_image_mix(rr, images, ptarget, params);
+    pl_dispatch_set_async(rr->dp, false);
+    if (pl_dispatch_num_deferred(rr->dp) == deferred)
+        return stats_end(rr, ok);
+
+    // Cached frames rendered by the incomplete attempt are invalid
+    for (int i = 0; i < rr->frames.num; i++)
+        rr->frames.elem[i].params_hash = 0;
+
+    PL_TRACE(rr, "Shaders still compiling, rendering fallback frame");
+    struct pl_render_params fallback = async_fallback_params(params);
+    return stats_end(rr, render_image_mix(rr, images, ptarget, &fallback));
+}
+
 void pl_frames_infer_mix(pl_renderer rr, const struct pl_frame_mix *mix,
                          struct pl_frame *target, struct pl_frame *out_ref)
 {
@@ -3769,6 +6075,11 @@ struct pl_render_errors pl_renderer_get_errors(pl_renderer rr)
     };
 }
 
+struct pl_render_stats pl_renderer_get_stats(pl_renderer rr)
+{
+    return rr->stats;
+}
+
 void pl_renderer_reset_errors(pl_renderer rr,
                               const struct pl_render_errors *errors)
 {
@@ -43,10 +43,33 @@ void pl_shader_info_deref(pl_shader_info *pinfo)
     *pinfo = NULL;
 }
 
+// Takes over the arena `*tmp` (owned by `donor`), replacing it by a recycled
+// or freshly created arena
+static void sh_tmp_adopt(void *owner, struct sh_tmp_pool *pool,
+                         void *donor, void **tmp)
+{
+    void *arena = NULL;
+    if (pool->num_used < pool->arenas.num) {
+        arena = pl_steal(donor, pool->arenas.elem[pool->num_used]);
+    } else {
+        PL_ARRAY_APPEND(owner, pool->arenas, NULL);
+    }
+
+    pool->arenas.elem[pool->num_used++] = pl_steal(owner, *tmp);
+    *tmp = PL_DEF(arena, pl_arena_create(donor, 0));
+}
+
+static void sh_tmp_reset(struct sh_tmp_pool *pool)
+{
+    for (int i = 0; i < pool->num_used; i++)
+        pl_free_children(pool->arenas.elem[i]);
+    pool->num_used = 0;
+}
+
 static struct sh_info *sh_info_alloc(void *alloc)
 {
     struct sh_info *info = pl_zalloc_ptr(alloc, info);
-    info->tmp = pl_tmp(info);
+    info->tmp = pl_arena_create(info, 0);
     pl_rc_init(&info->rc);
     return info;
 }
@@ -59,6 +82,7 @@ static struct sh_info *sh_info_recycle(struct sh_info *info)
 
     memset(&info->info, 0, sizeof(info->info)); // reset public fields
     pl_free_children(info->tmp);
+    sh_tmp_reset(&info->sub_tmp);
     pl_rc_ref(&info->rc);
     info->desc.len = 0;
     info->steps.num = 0;
@@ -92,6 +116,7 @@ static void init_shader(pl_shader sh, const struct pl_shader_params *params)
 
 pl_shader pl_shader_alloc(pl_log log, const struct pl_shader_params *params)
 {
+    PL_ALLOC_SCOPE(SHADERS);
     static const int glsl_ver_req = 130;
     if (params && params->glsl.version && params->glsl.version < 130) {
         pl_err(log, "Requested GLSL version %d too low (required: %d)",
@@ -102,7 +127,7 @@ pl_shader pl_shader_alloc(pl_log log, const struct pl_shader_params *params)
     pl_shader sh = pl_alloc_ptr(NULL, sh);
     *sh = (struct pl_shader_t) {
         .log        = log,
-        .tmp        = pl_tmp(sh),
+        .tmp        = pl_arena_create(sh, 0),
         .info       = sh_info_alloc(NULL),
         .mutable    = true,
     };
@@ -119,6 +144,8 @@ static void sh_obj_deref(pl_shader_obj obj);
 void sh_deref(pl_shader sh)
 {
     pl_free_children(sh->tmp);
+    sh_tmp_reset(&sh->sub_tmp);
+    sh->data = (pl_str) {0};
 
     for (int i = 0; i < sh->obj.num; i++)
         sh_obj_deref(sh->obj.elem[i]);
@@ -138,13 +165,14 @@ void pl_shader_free(pl_shader *psh)
 
 void pl_shader_reset(pl_shader sh, const struct pl_shader_params *params)
 {
+    PL_ALLOC_SCOPE(SHADERS);
     sh_deref(sh);
 
     struct pl_shader_t new = {
         .log            = sh->log,
         .tmp            = sh->tmp,
+        .sub_tmp        = sh->sub_tmp,
         .info           = sh_info_recycle(sh->info),
-        .data.buf       = sh->data.buf,
         .mutable        = true,
 
         // Preserve array allocations
@@ -174,12 +202,10 @@ static void *sh_alloc(pl_shader sh, size_t size, size_t align)
     }
 
     // We can't realloc this buffer because various pointers will be left
-    // dangling, so just reparent it onto `sh->tmp` (so it will be cleaned
-    // up when the shader is next reset) and allocate a new, larger buffer
-    // in its place
+    // dangling, so just leave it on `sh->tmp` (so it will be cleaned up when
+    // the shader is next reset) and allocate a new, larger buffer in its place
     const size_t new_size = PL_MAX(req_size << 1, 256);
-    pl_steal(sh->tmp, sh->data.buf);
-    sh->data.buf = pl_alloc(sh, new_size);
+    sh->data.buf = pl_alloc(sh->tmp, new_size);
     sh->data.len = size;
     return sh->data.buf;
 }
@@ -211,6 +237,15 @@ struct pl_glsl_version sh_glsl(const pl_shader sh)
     return (struct pl_glsl_version) { .version = 130 };
 }
 
+const char *sh_prec(const pl_shader sh)
+{
+    if (!SH_PARAMS(sh).low_precision)
+        return "";
+
+    struct pl_glsl_version glsl = sh_glsl(sh);
+    return (glsl.gles || glsl.vulkan) ? "mediump " : "";
+}
+
 bool sh_try_compute(pl_shader sh, int bw, int bh, bool flex, size_t mem)
 {
     pl_assert(bw && bh);
@@ -301,6 +336,7 @@ bool pl_shader_output_size(const pl_shader sh, int *w, int *h)
 
 ident_t sh_fresh(pl_shader sh, const char *name)
 {
+    PL_ALLOC_SCOPE(SHADERS);
     unsigned short id = ++sh->fresh;
     assert(!(sh->prefix & id));
     id |= sh->prefix;
@@ -318,6 +354,7 @@ static inline ident_t sh_fresh_name(pl_shader sh, const char **pname)
 
 ident_t sh_var(pl_shader sh, struct pl_shader_var sv)
 {
+    PL_ALLOC_SCOPE(SHADERS);
     ident_t id = sh_fresh_name(sh, &sv.var.name);
     struct pl_var_layout layout = pl_var_host_layout(0, &sv.var);
     sv.data = sh_memdup(sh, sv.data, layout.size, layout.stride);
@@ -362,6 +399,7 @@ ident_t sh_var_mat3(pl_shader sh, const char *name, pl_matrix3x3 val)
 
 ident_t sh_desc(pl_shader sh, struct pl_shader_desc sd)
 {
+    PL_ALLOC_SCOPE(SHADERS);
     switch (sd.desc.type) {
     case PL_DESC_BUF_UNIFORM:
     case PL_DESC_BUF_STORAGE:
@@ -396,6 +434,7 @@ ident_t sh_desc(pl_shader sh, struct pl_shader_desc sd)
 
 ident_t sh_const(pl_shader sh, struct pl_shader_const sc)
 {
+    PL_ALLOC_SCOPE(SHADERS);
     if (SH_PARAMS(sh).dynamic_constants && !sc.compile_time) {
         return sh_var(sh, (struct pl_shader_var) {
             .var = {
@@ -469,6 +508,7 @@ ident_t sh_const_float(pl_shader sh, const char *name, float val)
 
 ident_t sh_attr(pl_shader sh, struct pl_shader_va sva)
 {
+    PL_ALLOC_SCOPE(SHADERS);
     const size_t vsize = sva.attr.fmt->texel_size;
     uint8_t *data = sh_alloc(sh, vsize * 4, vsize);
     for (int i = 0; i < 4; i++) {
@@ -618,6 +658,7 @@ size_t sh_buf_desc_size(const struct pl_shader_desc *buf_desc)
 
 void sh_describef(pl_shader sh, const char *fmt, ...)
 {
+    PL_ALLOC_SCOPE(SHADERS);
     va_list ap;
     va_start(ap, fmt);
     sh_describe(sh, pl_vasprintf(sh->info->tmp, fmt, ap));
@@ -648,6 +689,7 @@ static const char *samplers2D[] = {
 
 ident_t sh_subpass(pl_shader sh, pl_shader sub)
 {
+    PL_ALLOC_SCOPE(SHADERS);
     pl_assert(sh->mutable);
 
     if (sh->prefix == sub->prefix) {
@@ -713,52 +755,24 @@ ident_t sh_subpass(pl_shader sh, pl_shader sub)
     ARRAY_STEAL(consts);
 #undef ARRAY_STEAL
 
-    // Steal the scratch buffer (if it holds data)
-    if (sub->data.len) {
-        pl_steal(sh->tmp, sub->data.buf);
-        sub->data = (pl_str) {0};
-    }
-
-    // Steal all temporary allocations and mark the child as unusable
-    pl_steal(sh->tmp, sub->tmp);
-    sub->tmp = pl_tmp(sub);
+    // Steal all temporary allocations (including the scratch buffer) and
+    // mark the child as unusable
+    sh_tmp_adopt(sh, &sh->sub_tmp, sub, &sub->tmp);
+    sub->data = (pl_str) {0};
     sub->failed = true;
 
     // Steal the shader steps array (and allocations)
     pl_assert(pl_rc_count(&sub->info->rc) == 1);
     PL_ARRAY_CONCAT(sh->info, sh->info->steps, sub->info->steps);
-    pl_steal(sh->info->tmp, sub->info->tmp);
-    sub->info->tmp = pl_tmp(sub->info);
+    sh_tmp_adopt(sh->info, &sh->info->sub_tmp, sub->info, &sub->info->tmp);
     sub->info->steps.num = 0; // sanity
 
     return sub->name;
 }
 
-pl_str_builder sh_finalize_internal(pl_shader sh)
+void sh_finalize_info(pl_shader sh)
 {
-    pl_assert(sh->mutable); // this function should only ever be called once
-    if (sh->failed)
-        return NULL;
-
-    // Padding for readability
-    GLSLP("\n");
-
-    // Concatenate everything onto the prelude to form the final output
-    pl_str_builder_concat(sh->buffers[SH_BUF_PRELUDE], sh->buffers[SH_BUF_HEADER]);
-
-    if (sh->input == PL_SHADER_SIG_SAMPLER) {
-        pl_assert(sh->sampler_prefix);
-        GLSLP("%s "$"(%c%s src_tex, vec2 tex_coord) {\n",
-              outsigs[sh->output], sh->name,
-              sh->sampler_prefix,
-              samplers2D[sh->sampler_type]);
-    } else {
-        GLSLP("%s "$"(%s) {\n", outsigs[sh->output], sh->name, insigs[sh->input]);
-    }
-
-    pl_str_builder_concat(sh->buffers[SH_BUF_PRELUDE], sh->buffers[SH_BUF_BODY]);
-    pl_str_builder_concat(sh->buffers[SH_BUF_PRELUDE], sh->buffers[SH_BUF_FOOTER]);
-    GLSLP("%s\n}\n\n", retvals[sh->output]);
+    pl_assert(sh->mutable);
 
     // Generate the shader info
     struct sh_info *info = sh->info;
@@ -798,11 +812,41 @@ next_step: ;
         info->info.description = (char *) info->desc.buf;
 
     sh->mutable = false;
+}
+
+pl_str_builder sh_finalize_internal(pl_shader sh)
+{
+    pl_assert(sh->mutable); // this function should only ever be called once
+    if (sh->failed)
+        return NULL;
+
+    // Padding for readability
+    GLSLP("\n");
+
+    // Concatenate everything onto the prelude to form the final output
+    pl_str_builder_concat(sh->buffers[SH_BUF_PRELUDE], sh->buffers[SH_BUF_HEADER]);
+
+    if (sh->input == PL_SHADER_SIG_SAMPLER) {
+        pl_assert(sh->sampler_prefix);
+        GLSLP("%s "$"(%c%s src_tex, vec2 tex_coord) {\n",
+              outsigs[sh->output], sh->name,
+              sh->sampler_prefix,
+              samplers2D[sh->sampler_type]);
+    } else {
+        GLSLP("%s "$"(%s) {\n", outsigs[sh->output], sh->name, insigs[sh->input]);
+    }
+
+    pl_str_builder_concat(sh->buffers[SH_BUF_PRELUDE], sh->buffers[SH_BUF_BODY]);
+    pl_str_builder_concat(sh->buffers[SH_BUF_PRELUDE], sh->buffers[SH_BUF_FOOTER]);
+    GLSLP("%s\n}\n\n", retvals[sh->output]);
+
+    sh_finalize_info(sh);
     return sh->buffers[SH_BUF_PRELUDE];
 }
 
 const struct pl_shader_res *pl_shader_finalize(pl_shader sh)
 {
+    PL_ALLOC_SCOPE(SHADERS);
     if (sh->failed) {
         return NULL;
     } else if (!sh->mutable) {
@@ -824,7 +868,7 @@ const struct pl_shader_res *pl_shader_finalize(pl_shader sh)
     for (int i = 0; i < sh->descs.num; i++) {
         struct pl_shader_desc *sd = &sh->descs.elem[i];
         FIX_IDENT(sd->desc.name);
-        for (int j = 0; j < sd->num_buffer_vars; sd++)
+        for (int j = 0; j < sd->num_buffer_vars; j++)
             FIX_IDENT(sd->buffer_vars[j].var.name);
     }
 #undef FIX_IDENT
@@ -925,6 +969,7 @@ void *sh_require_obj(pl_shader sh, pl_shader_obj *ptr,
                      enum pl_shader_obj_type type, size_t priv_size,
                      void (*uninit)(pl_gpu gpu, void *priv))
 {
+    PL_ALLOC_SCOPE(SHADERS);
     if (!ptr)
         return NULL;
 
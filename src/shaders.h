@@ -71,12 +71,19 @@ enum pl_shader_type {
     SH_FRAGMENT
 };
 
+// Arenas adopted from merged subpasses, recycled when the owner is reset
+struct sh_tmp_pool {
+    PL_ARRAY(void *) arenas; // [0, num_used) in use, the rest are spare
+    int num_used;
+};
+
 struct sh_info {
     // public-facing struct
     struct pl_shader_info_t info;
 
     // internal fields
     void *tmp;
+    struct sh_tmp_pool sub_tmp;
     pl_rc_t rc;
     pl_str desc;
     PL_ARRAY(const char *) steps;
@@ -85,8 +92,9 @@ struct sh_info {
 struct pl_shader_t {
     pl_log log;
     void *tmp; // temporary allocations (freed on pl_shader_reset)
+    struct sh_tmp_pool sub_tmp;
     struct sh_info *info;
-    pl_str data; // pooled/recycled scratch buffer for small allocations
+    pl_str data; // scratch buffer for small allocations, lives in `tmp`
     PL_ARRAY(pl_shader_obj) obj;
     bool failed;
     bool mutable;
@@ -127,6 +135,11 @@ void sh_deref(pl_shader sh);
 // will access the shader's internal fields directly.
 pl_str_builder sh_finalize_internal(pl_shader sh);
 
+// Finalizes only the `pl_shader_info`, without generating any GLSL. Used
+// when the caller already knows the shader's output, e.g. from a previous
+// finalization of an identical shader.
+void sh_finalize_info(pl_shader sh);
+
 // Helper functions for convenience
 #define SH_PARAMS(sh) ((sh)->info->info.params)
 #define SH_GPU(sh) (SH_PARAMS(sh).gpu)
@@ -135,6 +148,10 @@ pl_str_builder sh_finalize_internal(pl_shader sh);
 // Returns the GLSL version, defaulting to desktop 130.
 struct pl_glsl_version sh_glsl(const pl_shader sh);
 
+// Returns the precision qualifier (including trailing space) to use for
+// intermediate color values, or the empty string. See `low_precision`.
+const char *sh_prec(const pl_shader sh);
+
 #define SH_FAIL(sh, ...) do {    \
         sh->failed = true;       \
         PL_ERR(sh, __VA_ARGS__); \
@@ -285,6 +302,7 @@ enum sh_lut_type {
     SH_LUT_TEXTURE,  // upload as texture
     SH_LUT_UNIFORM,  // uniform array
     SH_LUT_LITERAL,  // constant / literal array in shader source (fallback)
+    SH_LUT_STORAGE,  // storage buffer, uses emulated interpolation
 };
 
 // Interpolation method
@@ -328,6 +346,11 @@ struct sh_lut_params {
     // rather than being treated as read-only.
     bool dynamic;
 
+    // If set to true, and `signature` uniquely identifies the LUT's contents,
+    // non-dynamic texture LUTs are shared between all shader objects on the
+    // same `pl_gpu`, rather than being generated and uploaded for each one.
+    bool shared;
+
     // If set , generated shader objects are automatically cached in this
     // cache. Requires `signature` to be set (and uniquely identify the LUT).
     pl_cache cache;
@@ -19,6 +19,7 @@
 
 #include "cache.h"
 #include "shaders.h"
+#include "tone_mapping.h"
 
 #include <libplacebo/shaders/colorspace.h>
 
@@ -29,6 +30,60 @@ static const float PQ_M1 = 2610./4096 * 1./4,
                    PQ_C2 = 2413./4096 * 32,
                    PQ_C3 = 2392./4096 * 32;
 
+// Piecewise polynomial approximations of PQ, see `pl_shader_params.fast_transfer`.
+// Each half is a degree 8 Chebyshev interpolant, converted to monomial form in
+// terms of its input linearly remapped to [-1, 1].
+struct pq_poly {
+    float split;
+    float lo[9]; // [0, split]
+    float hi[9]; // [split, 1]
+};
+
+// sqrt(EOTF(x)), with x in [0, 1] and the EOTF normalized to 10000 nits
+static const struct pq_poly pq_eotf_poly = {
+    .split = 0.16f,
+    .lo = {
+        0.00428122861, 0.00533647207, 0.00126461874, 0.000170681555,
+        -4.17392511e-05, -0.000142727295, 0.000133899963, 0.000132484945,
+        -0.000123082344,
+    },
+    .hi = {
+        0.142009247, 0.285358627, 0.259571757, 0.162898661, 0.0843650926,
+        0.036646747, 0.0158746702, 0.00958375671, 0.00368301749,
+    },
+};
+
+// OETF(y^8), with y in [0, 1] and the OETF normalized to 10000 nits
+static const struct pq_poly pq_oetf_poly = {
+    .split = 0.3f,
+    .lo = {
+        0.0105771355, 0.0455832489, 0.0670375821, 0.026003416, -0.0199424899,
+        -0.00803282916, 0.00965459059, 0.00120565874, -0.00256875412,
+    },
+    .hi = {
+        0.628275924, 0.458643118, -0.0888554754, -0.00972908035, 0.020273355,
+        -0.0135228175, 0.00587950469, -0.000155841322, -0.000810404107,
+    },
+};
+
+// Evaluates `poly` on `color.rgb`, which must be in the range [0, 1]
+static void eval_pq_poly(pl_shader sh, const struct pq_poly *poly)
+{
+    const float s = poly->split;
+    GLSL("{                                                 \n"
+         "bvec3 pq_lo = lessThan(color.rgb, vec3(%f));      \n"
+         "vec3 pq_t = color.rgb * mix(vec3(%f), vec3(%f), pq_lo) \n"
+         "          + mix(vec3(%f), vec3(%f), pq_lo);       \n"
+         "color.rgb = mix(vec3(%f), vec3(%f), pq_lo);       \n",
+         s, 2.0f / (1.0f - s), 2.0f / s, -(1.0f + s) / (1.0f - s), -1.0f,
+         poly->hi[8], poly->lo[8]);
+    for (int i = 7; i >= 0; i--) {
+        GLSL("color.rgb = color.rgb * pq_t + mix(vec3(%f), vec3(%f), pq_lo); \n",
+             poly->hi[i], poly->lo[i]);
+    }
+    GLSL("}\n");
+}
+
 // Common constants for ARIB STD-B67 (HLG)
 static const float HLG_A = 0.17883277,
                    HLG_B = 0.28466892,
@@ -116,15 +171,75 @@ static inline void reshape_poly(pl_shader sh)
 {
     GLSL("s = (coeffs.z * s + coeffs.y) * s + coeffs.x; \n");
 }
+
+// Components using only polynomial reshaping are a function of that
+// component alone, so they can be baked into a 1D LUT
+static inline bool reshape_is_1d(const struct pl_reshape_data *comp)
+{
+    if (!comp->num_pivots)
+        return false;
+    for (int i = 0; i < comp->num_pivots - 1; i++) {
+        if (comp->method[i] != 0)
+            return false;
+    }
+    return true;
+}
+
+#define DOVI_LUT_SIZE 1024
+
+struct dovi_lut_priv {
+    const struct pl_dovi_metadata *data;
+    uint8_t mask; // components baked into the LUT
+};
+
+static void fill_dovi_lut(void *datap, const struct sh_lut_params *params)
+{
+    const struct dovi_lut_priv *priv = params->priv;
+    float *data = datap;
+
+    for (int i = 0; i < params->width; i++) {
+        const float x = (float) i / (params->width - 1);
+        for (int c = 0; c < 4; c++) {
+            float *out = &data[i * 4 + c];
+            if (!(priv->mask & (1 << c))) {
+                *out = x;
+                continue;
+            }
+
+            // Pick the first piece whose upper pivot lies above `x`, matching
+            // the selection done by the shader
+            const struct pl_reshape_data *comp = &priv->data->comp[c];
+            int piece = 0;
+            while (piece < comp->num_pivots - 2 && x >= comp->pivots[piece + 1])
+                piece++;
+
+            const float *k = comp->poly_coeffs[piece];
+            const float s = (k[2] * x + k[1]) * x + k[0];
+            *out = PL_CLAMP(s, comp->pivots[0], comp->pivots[comp->num_pivots - 1]);
+        }
+    }
+}
 #endif
 
-void pl_shader_dovi_reshape(pl_shader sh, const struct pl_dovi_metadata *data)
+static void dovi_reshape(pl_shader sh, const struct pl_dovi_metadata *data,
+                         pl_shader_obj *lut_state)
 {
 #ifdef PL_HAVE_DOVI
     if (!sh_require(sh, PL_SHADER_SIG_COLOR, 0, 0) || !data)
         return;
 
-    sh_describe(sh, "reshaping");
+    struct dovi_lut_priv lut_priv = { .data = data };
+    uint64_t signature = 0;
+    if (lut_state) {
+        for (int c = 0; c < 3; c++) {
+            if (!reshape_is_1d(&data->comp[c]))
+                continue;
+            lut_priv.mask |= 1 << c;
+            pl_hash_merge(&signature, pl_var_hash(data->comp[c]) ^ c);
+        }
+    }
+
+    sh_describe(sh, lut_priv.mask ? "reshaping (LUT)" : "reshaping");
     GLSL("// pl_shader_reshape                  \n"
          "{                                     \n"
          "vec3 sig;                             \n"
@@ -132,12 +247,37 @@ void pl_shader_dovi_reshape(pl_shader sh, const struct pl_dovi_metadata *data)
          "float s;                              \n"
          "sig = clamp(color.rgb, 0.0, 1.0);     \n");
 
+    if (lut_priv.mask) {
+        ident_t lut = sh_lut(sh, sh_lut_params(
+            .object     = lut_state,
+            .var_type   = PL_VAR_FLOAT,
+            .method     = SH_LUT_LINEAR,
+            .width      = DOVI_LUT_SIZE,
+            .comps      = 4, // for better texel alignment
+            .dynamic    = true, // RPU metadata changes per scene
+            .signature  = signature,
+            .cache      = SH_CACHE(sh),
+            .fill       = fill_dovi_lut,
+            .priv       = &lut_priv,
+        ));
+
+        if (!lut) {
+            // Fall back to evaluating the curves directly
+            lut_priv.mask = 0;
+        } else {
+            for (int c = 0; c < 3; c++) {
+                if (lut_priv.mask & (1 << c))
+                    GLSL("color[%d] = "$"(sig[%d])[%d]; \n", c, lut, c, c);
+            }
+        }
+    }
+
     float coeffs_data[8][4];
     float mmr_packed_data[8*6][4];
 
     for (int c = 0; c < 3; c++) {
         const struct pl_reshape_data *comp = &data->comp[c];
-        if (!comp->num_pivots)
+        if (!comp->num_pivots || (lut_priv.mask & (1 << c)))
             continue;
 
         pl_assert(comp->num_pivots >= 2 && comp->num_pivots <= 9);
@@ -287,6 +427,17 @@ void pl_shader_dovi_reshape(pl_shader sh, const struct pl_dovi_metadata *data)
 #endif
 }
 
+void pl_shader_dovi_reshape(pl_shader sh, const struct pl_dovi_metadata *data)
+{
+    dovi_reshape(sh, data, NULL);
+}
+
+void pl_shader_dovi_reshape_lut(pl_shader sh, const struct pl_dovi_metadata *data,
+                                pl_shader_obj *lut_state)
+{
+    dovi_reshape(sh, data, lut_state);
+}
+
 void pl_shader_decode_color(pl_shader sh, struct pl_color_repr *repr,
                             const struct pl_color_adjustment *params)
 {
@@ -686,6 +837,14 @@ void pl_shader_linearize(pl_shader sh, const struct pl_color_space *csp)
         GLSL("color.rgb = vec3(52.37/48.0) * pow(color.rgb, vec3(2.6));\n");
         goto scale_out;
     case PL_COLOR_TRC_PQ:
+        if (SH_PARAMS(sh).fast_transfer) {
+            GLSL("color.rgb = clamp(color.rgb, 0.0, 1.0); \n");
+            eval_pq_poly(sh, &pq_eotf_poly);
+            GLSL("color.rgb *= vec3(%f) * color.rgb; \n",
+                 10000.0 / PL_COLOR_SDR_WHITE);
+            return;
+        }
+
         GLSL("color.rgb = pow(color.rgb, vec3(1.0/%f));         \n"
              "color.rgb = max(color.rgb - vec3(%f), 0.0)        \n"
              "             / (vec3(%f) - vec3(%f) * color.rgb); \n"
@@ -838,6 +997,14 @@ void pl_shader_delinearize(pl_shader sh, const struct pl_color_space *csp)
              "                lessThanEqual(vec3(0.001953), color.rgb));     \n");
         return;
     case PL_COLOR_TRC_PQ:
+        if (SH_PARAMS(sh).fast_transfer) {
+            GLSL("color.rgb = clamp(color.rgb * vec3(1.0/%f), 0.0, 1.0); \n"
+                 "color.rgb = sqrt(sqrt(sqrt(color.rgb)));                \n",
+                 10000 / PL_COLOR_SDR_WHITE);
+            eval_pq_poly(sh, &pq_oetf_poly);
+            return;
+        }
+
         GLSL("color.rgb *= vec3(1.0/%f);                         \n"
              "color.rgb = pow(color.rgb, vec3(%f));              \n"
              "color.rgb = (vec3(%f) + vec3(%f) * color.rgb)      \n"
@@ -943,7 +1110,8 @@ static bool peak_detect_params_eq(const struct pl_peak_detect_params *a,
     return a->smoothing_period     == b->smoothing_period     &&
            a->scene_threshold_low  == b->scene_threshold_low  &&
            a->scene_threshold_high == b->scene_threshold_high &&
-           a->percentile           == b->percentile;
+           a->percentile           == b->percentile           &&
+           a->stride               == b->stride;
     // don't compare `allow_delayed` because it doesn't change measurement
 }
 
@@ -1016,18 +1184,26 @@ struct sh_color_map_obj {
     // Gamut map state
     struct {
         pl_shader_obj lut;
+        uint64_t fit_sig;   // signature of the last `lut3d_adaptive` fit
+        int fit_size[3];
+        bool fit_needed;
     } gamut;
 
     // Peak detection state
     struct {
         struct pl_peak_detect_params params;    // currently active parameters
-        pl_buf buf;                             // pending peak detection buffer
+        pl_buf bufs[PL_PEAK_DETECT_MAX_DELAY];  // pending buffers, oldest first
+        int num_bufs;
         pl_buf readback;                        // readback buffer (fallback)
         float avg_pq;                           // current (smoothed) values
         float max_pq;
     } peak;
 };
 
+// Worst-case error bound for `lut3d_adaptive`, in IPTPQc4 units (about one
+// 8-bit PQ step; typical errors are far smaller)
+#define LUT3D_MAX_ERROR (1.0f / 256)
+
 // Excluding size, since this is checked by sh_lut
 static uint64_t gamut_map_signature(const struct pl_gamut_map_params *par)
 {
@@ -1046,7 +1222,8 @@ static void sh_color_map_uninit(pl_gpu gpu, void *ptr)
     struct sh_color_map_obj *obj = ptr;
     pl_shader_obj_destroy(&obj->tone.lut);
     pl_shader_obj_destroy(&obj->gamut.lut);
-    pl_buf_destroy(gpu, &obj->peak.buf);
+    for (int i = 0; i < obj->peak.num_bufs; i++)
+        pl_buf_destroy(gpu, &obj->peak.bufs[i]);
     pl_buf_destroy(gpu, &obj->peak.readback);
     memset(obj, 0, sizeof(*obj));
 }
@@ -1109,54 +1286,36 @@ static float measure_peak(const struct peak_buf_data *data, float percentile)
     pl_unreachable();
 }
 
-// if `force` is true, ensures the buffer is read, even if `allow_delayed`
-static void update_peak_buf(pl_gpu gpu, struct sh_color_map_obj *obj, bool force)
+static inline int peak_max_delay(const struct pl_peak_detect_params *params)
 {
-    const struct pl_peak_detect_params *params = &obj->peak.params;
-    if (!obj->peak.buf)
-        return;
-
-    if (!force && params->allow_delayed && pl_buf_poll(gpu, obj->peak.buf, 0))
-        return; // buffer not ready yet
+    if (!params->allow_delayed)
+        return 0;
+    return PL_CLAMP(PL_DEF(params->max_delay, 1), 1, PL_PEAK_DETECT_MAX_DELAY);
+}
 
-    bool ok;
-    struct peak_buf_data data = {0};
-    if (obj->peak.readback) {
-        pl_buf_copy(gpu, obj->peak.readback, 0, obj->peak.buf, 0, sizeof(data));
-        ok = pl_buf_read(gpu, obj->peak.readback, 0, &data, sizeof(data));
-    } else {
-        ok = pl_buf_read(gpu, obj->peak.buf, 0, &data, sizeof(data));
-    }
-    if (ok && data.frame_wg_count[0] > 0) {
-        // Peak detection completed successfully
-        pl_buf_destroy(gpu, &obj->peak.buf);
-    } else {
-        // No data read? Possibly this peak obj has not been executed yet
-        if (!ok) {
-            PL_ERR(gpu, "Failed reading peak detection buffer!");
-        } else if (params->allow_delayed) {
-            PL_TRACE(gpu, "Peak detection buffer not yet ready, ignoring..");
-        } else {
-            PL_WARN(gpu, "Peak detection usage error: attempted detecting peak "
-                    "and using detected peak in the same shader program, "
-                    "but `params->allow_delayed` is false! Ignoring, but "
-                    "expect incorrect output.");
-        }
-        if (force || !ok)
-            pl_buf_destroy(gpu, &obj->peak.buf);
-        return;
-    }
+static void pop_peak_buf(pl_gpu gpu, struct sh_color_map_obj *obj)
+{
+    pl_assert(obj->peak.num_bufs > 0);
+    pl_buf_destroy(gpu, &obj->peak.bufs[0]);
+    memmove(&obj->peak.bufs[0], &obj->peak.bufs[1],
+            (obj->peak.num_bufs - 1) * sizeof(obj->peak.bufs[0]));
+    obj->peak.bufs[--obj->peak.num_bufs] = NULL;
+}
 
+static void update_peak_data(struct sh_color_map_obj *obj,
+                             const struct peak_buf_data *data)
+{
+    const struct pl_peak_detect_params *params = &obj->peak.params;
     uint64_t frame_sum_pq = 0u, frame_wg_count = 0u, frame_wg_active = 0u;
     for (int k = 0; k < SLICES; k++) {
-        frame_sum_pq    += data.frame_sum_pq[k];
-        frame_wg_count  += data.frame_wg_count[k];
-        frame_wg_active += data.frame_wg_active[k];
+        frame_sum_pq    += data->frame_sum_pq[k];
+        frame_wg_count  += data->frame_wg_count[k];
+        frame_wg_active += data->frame_wg_active[k];
     }
     float avg_pq, max_pq;
     if (frame_wg_active) {
         avg_pq = (float) frame_sum_pq / (frame_wg_active * PQ_MAX);
-        max_pq = measure_peak(&data, params->percentile);
+        max_pq = measure_peak(data, params->percentile);
     } else {
         // Solid black frame
         avg_pq = max_pq = PL_COLOR_HDR_BLACK;
@@ -1193,6 +1352,53 @@ static void update_peak_buf(pl_gpu gpu, struct sh_color_map_obj *obj, bool force
     }
 }
 
+// Consumes the results of all completed peak detection buffers, oldest first.
+// Buffers still in use by the GPU are only waited on if `allow_delayed` is
+// false, or if more than `max_pending` buffers are outstanding. If `force` is
+// true, buffers that turn out to have never been executed are discarded.
+static void update_peak_buf(pl_gpu gpu, struct sh_color_map_obj *obj,
+                            int max_pending, bool force)
+{
+    const struct pl_peak_detect_params *params = &obj->peak.params;
+    while (obj->peak.num_bufs > 0) {
+        pl_buf buf = obj->peak.bufs[0];
+        bool wait = !params->allow_delayed || obj->peak.num_bufs > max_pending;
+        if (!wait && pl_buf_poll(gpu, buf, 0))
+            return; // buffer not ready yet, and neither are any newer ones
+
+        bool ok;
+        struct peak_buf_data data = {0};
+        if (obj->peak.readback) {
+            pl_buf_copy(gpu, obj->peak.readback, 0, buf, 0, sizeof(data));
+            ok = pl_buf_read(gpu, obj->peak.readback, 0, &data, sizeof(data));
+        } else {
+            ok = pl_buf_read(gpu, buf, 0, &data, sizeof(data));
+        }
+
+        if (ok && data.frame_wg_count[0] > 0) {
+            // Peak detection completed successfully
+            pop_peak_buf(gpu, obj);
+            update_peak_data(obj, &data);
+            continue;
+        }
+
+        // No data read? Possibly this peak obj has not been executed yet
+        if (!ok) {
+            PL_ERR(gpu, "Failed reading peak detection buffer!");
+        } else if (params->allow_delayed) {
+            PL_TRACE(gpu, "Peak detection buffer not yet ready, ignoring..");
+        } else {
+            PL_WARN(gpu, "Peak detection usage error: attempted detecting peak "
+                    "and using detected peak in the same shader program, "
+                    "but `params->allow_delayed` is false! Ignoring, but "
+                    "expect incorrect output.");
+        }
+        if (!force && ok)
+            return;
+        pop_peak_buf(gpu, obj);
+    }
+}
+
 bool pl_shader_detect_peak(pl_shader sh, struct pl_color_space csp,
                            pl_shader_obj *state,
                            const struct pl_peak_detect_params *params)
@@ -1228,23 +1434,28 @@ bool pl_shader_detect_peak(pl_shader sh, struct pl_color_space csp,
         return false;
 
     if (peak_detect_params_eq(&obj->peak.params, params)) {
-        update_peak_buf(gpu, obj, true); // prevent over-writing previous frame
+        // Make room for this frame's buffer, only blocking on buffers that
+        // have been in flight for more than `max_delay` frames
+        obj->peak.params.allow_delayed = params->allow_delayed;
+        int max_pending = PL_MAX(peak_max_delay(params) - 1, 0);
+        update_peak_buf(gpu, obj, max_pending, true);
     } else {
         pl_reset_detected_peak(*state);
     }
 
-    pl_assert(!obj->peak.buf);
+    pl_assert(obj->peak.num_bufs < PL_ARRAY_SIZE(obj->peak.bufs));
     static const struct peak_buf_data zero = {0};
+    pl_buf buf;
 
 retry_ssbo:
     if (obj->peak.readback) {
-        obj->peak.buf = pl_buf_create(gpu, pl_buf_params(
+        buf = pl_buf_create(gpu, pl_buf_params(
             .size           = sizeof(struct peak_buf_data),
             .storable       = true,
             .initial_data   = &zero,
         ));
     } else {
-        obj->peak.buf = pl_buf_create(gpu, pl_buf_params(
+        buf = pl_buf_create(gpu, pl_buf_params(
             .size           = sizeof(struct peak_buf_data),
             .memory_type    = PL_BUF_MEM_DEVICE,
             .host_readable  = true,
@@ -1253,7 +1464,7 @@ retry_ssbo:
         ));
     }
 
-    if (!obj->peak.buf && !obj->peak.readback) {
+    if (!buf && !obj->peak.readback) {
         PL_WARN(sh, "Failed creating host-readable peak detection SSBO, "
                 "retrying with fallback buffer");
         obj->peak.readback = pl_buf_create(gpu, pl_buf_params(
@@ -1264,11 +1475,12 @@ retry_ssbo:
             goto retry_ssbo;
     }
 
-    if (!obj->peak.buf) {
+    if (!buf) {
         SH_FAIL(sh, "Failed creating peak detection SSBO!");
         return false;
     }
 
+    obj->peak.bufs[obj->peak.num_bufs++] = buf;
     obj->peak.params = *params;
 
     sh_desc(sh, (struct pl_shader_desc) {
@@ -1277,7 +1489,7 @@ retry_ssbo:
             .type   = PL_DESC_BUF_STORAGE,
             .access = PL_DESC_ACCESS_READWRITE,
         },
-        .binding.object  = obj->peak.buf,
+        .binding.object  = buf,
         .buffer_vars     = (struct pl_buffer_var *) peak_buf_vars,
         .num_buffer_vars = PL_ARRAY_SIZE(peak_buf_vars),
     });
@@ -1310,6 +1522,17 @@ retry_ssbo:
          "barrier();                  \n",
          wg_sum, wg_max, wg_black);
 
+    // Pixels skipped by the stride are measured as black, which excludes
+    // them from all statistics without any extra bookkeeping
+    const int stride = PL_CLAMP(params->stride, 1, PL_PEAK_DETECT_MAX_STRIDE);
+    GLSL("uint y_pq = 0u; \n");
+    if (stride > 1) {
+        GLSL("if (gl_GlobalInvocationID.x %% %du == 0u && \n"
+             "    gl_GlobalInvocationID.y %% %du == 0u)   \n",
+             stride, stride);
+    }
+    GLSL("{ \n");
+
     // Decode color into linear light representation
     pl_color_space_infer(&csp);
     pl_shader_linearize(sh, &csp);
@@ -1321,7 +1544,8 @@ retry_ssbo:
          "luma = (%f + %f * luma) / (1.0 + %f * luma);  \n"
          "luma = pow(luma, %f);                         \n"
          "luma *= smoothstep(0.0, 1e-2, luma);          \n"
-         "uint y_pq = uint(%d.0 * luma);                \n",
+         "y_pq = uint(%d.0 * luma);                     \n"
+         "}                                             \n",
          sh_luma_coeffs(sh, &csp),
          PL_COLOR_SDR_WHITE / 10000.0,
          PQ_M1, PQ_C1, PQ_C2, PQ_C3, PQ_M2,
@@ -1335,14 +1559,21 @@ retry_ssbo:
              PQ_BITS - HIST_BITS, HIST_BIAS,
              HIST_BINS - 1);
         if (has_subgroups) {
-            // Optimize for the very common case of identical histogram bins
-            GLSL("if (subgroupAllEqual(bin)) {                  \n"
-                 "    if (subgroupElect())                      \n"
-                 "        atomicAdd("$"[bin], gl_SubgroupSize); \n"
-                 "} else {                                      \n"
-                 "    atomicAdd("$"[bin], 1u);                  \n"
-                 "}                                             \n",
-                 wg_hist, wg_hist);
+            // Reduce within the subgroup first, so that only one invocation
+            // per distinct bin touches shmem. Each iteration retires all
+            // invocations sharing the bin of the first active invocation,
+            // which typically converges after very few iterations since
+            // neighbouring pixels tend to have similar brightness.
+            GLSL("for (;;) {                                            \n"
+                 "    int lead = subgroupBroadcastFirst(bin);           \n"
+                 "    if (bin == lead) {                                \n"
+                 "        uint cnt = subgroupBallotBitCount(subgroupBallot(true)); \n"
+                 "        if (subgroupElect())                          \n"
+                 "            atomicAdd("$"[bin], cnt);                 \n"
+                 "        break;                                        \n"
+                 "    }                                                 \n"
+                 "}                                                     \n",
+                 wg_hist);
         } else {
             GLSL("atomicAdd("$"[bin], 1u); \n", wg_hist);
         }
@@ -1369,13 +1600,18 @@ retry_ssbo:
     }
 
     if (use_histogram) {
+        // Skip empty bins, since most bins are typically empty for any
+        // given work group and global atomics are comparatively expensive
         GLSL("if (gl_LocalInvocationIndex == 0u)                            \n"
              "    "$"[0] -= "$";                                            \n"
-             "for (uint i = gl_LocalInvocationIndex; i < %du; i += wg_size) \n"
-             "    atomicAdd(frame_hist[slice * %du + i], "$"[i]);           \n",
+             "for (uint i = gl_LocalInvocationIndex; i < %du; i += wg_size) { \n"
+             "    uint cnt = "$"[i];                                        \n"
+             "    if (cnt > 0u)                                             \n"
+             "        atomicAdd(frame_hist[slice * %du + i], cnt);          \n"
+             "}                                                             \n",
              wg_hist, wg_black,
-             HIST_BINS,
-             HIST_BINS, wg_hist);
+             HIST_BINS, wg_hist,
+             HIST_BINS);
     }
 
     // Have one thread per work group update the global atomics
@@ -1402,7 +1638,7 @@ bool pl_get_detected_hdr_metadata(const pl_shader_obj state,
         return false;
 
     struct sh_color_map_obj *obj = state->priv;
-    update_peak_buf(state->gpu, obj, false);
+    update_peak_buf(state->gpu, obj, PL_PEAK_DETECT_MAX_DELAY, false);
     if (!obj->peak.avg_pq)
         return false;
 
@@ -1431,7 +1667,8 @@ void pl_reset_detected_peak(pl_shader_obj state)
 
     struct sh_color_map_obj *obj = state->priv;
     pl_buf readback = obj->peak.readback;
-    pl_buf_destroy(state->gpu, &obj->peak.buf);
+    for (int i = 0; i < obj->peak.num_bufs; i++)
+        pl_buf_destroy(state->gpu, &obj->peak.bufs[i]);
     memset(&obj->peak, 0, sizeof(obj->peak));
     obj->peak.readback = readback;
 }
@@ -1636,6 +1873,34 @@ static void visualize_gamut_map(pl_shader sh, pl_rect2df rc,
          lut);
 }
 
+// Largest change in the measured/dynamic scene brightness (in PQ) for which an
+// existing tone-mapping LUT is kept instead of being regenerated. This is well
+// below the resolution of the LUT itself, but avoids constantly regenerating
+// it as the output of smoothed peak detection slowly drifts.
+static const float tone_lut_threshold = 1e-3f;
+
+// Returns true if `a` and `b` differ only in their dynamic scene brightness,
+// and by less than `tone_lut_threshold`
+static bool tone_map_params_similar(const struct pl_tone_map_params *a,
+                                    const struct pl_tone_map_params *b)
+{
+    const float thresh = tone_lut_threshold;
+    if (fabsf(a->input_max - b->input_max) > thresh ||
+        fabsf(a->input_avg - b->input_avg) > thresh ||
+        fabsf(a->hdr.max_pq_y - b->hdr.max_pq_y) > thresh ||
+        fabsf(a->hdr.avg_pq_y - b->hdr.avg_pq_y) > thresh)
+    {
+        return false;
+    }
+
+    struct pl_tone_map_params tmp = *a;
+    tmp.input_max  = b->input_max;
+    tmp.input_avg  = b->input_avg;
+    tmp.hdr.max_pq_y = b->hdr.max_pq_y;
+    tmp.hdr.avg_pq_y = b->hdr.avg_pq_y;
+    return pl_tone_map_params_equal(&tmp, b);
+}
+
 static void fill_tone_lut(void *data, const struct sh_lut_params *params)
 {
     const struct pl_tone_map_params *lut_params = params->priv;
@@ -1665,6 +1930,35 @@ static void fill_gamut_lut(void *data, const struct sh_lut_params *params)
     pl_free(tmp);
 }
 
+// Whether delinearizing with `dst` exactly undoes linearizing with `src`
+static bool transfer_roundtrip(const struct pl_color_space *src,
+                               const struct pl_color_space *dst)
+{
+    if (src->transfer != dst->transfer)
+        return false;
+    if (src->transfer == PL_COLOR_TRC_LINEAR)
+        return true;
+
+    float src_min, src_max, dst_min, dst_max;
+    pl_color_space_nominal_luma_ex(pl_nominal_luma_params(
+        .color      = src,
+        .metadata   = PL_HDR_METADATA_HDR10,
+        .scaling    = PL_HDR_NORM,
+        .out_min    = &src_min,
+        .out_max    = &src_max,
+    ));
+
+    pl_color_space_nominal_luma_ex(pl_nominal_luma_params(
+        .color      = dst,
+        .metadata   = PL_HDR_METADATA_HDR10,
+        .scaling    = PL_HDR_NORM,
+        .out_min    = &dst_min,
+        .out_max    = &dst_max,
+    ));
+
+    return fabsf(src_min - dst_min) < 1e-6f && fabsf(src_max - dst_max) < 1e-6f;
+}
+
 void pl_shader_color_map_ex(pl_shader sh, const struct pl_color_map_params *params,
                             const struct pl_color_map_args *args)
 {
@@ -1817,9 +2111,6 @@ void pl_shader_color_map_ex(pl_shader sh, const struct pl_color_map_params *para
     bool need_tone_map = !pl_tone_map_params_noop(&tone);
     bool need_gamut_map = !pl_gamut_map_params_noop(&gamut);
 
-    if (!args->prelinearized)
-        pl_shader_linearize(sh, &src);
-
     pl_matrix3x3 rgb2lms = pl_ipt_rgb2lms(pl_raw_primaries_get(src.primaries));
     pl_matrix3x3 lms2rgb = pl_ipt_lms2rgb(pl_raw_primaries_get(dst.primaries));
     ident_t lms2ipt = SH_MAT3(pl_ipt_lms2ipt);
@@ -1834,8 +2125,42 @@ void pl_shader_color_map_ex(pl_shader sh, const struct pl_color_map_params *para
         need_gamut_map = false;
     }
 
+    if (need_gamut_map && params->lut3d_adaptive && obj) {
+        // Re-use the previous fit for as long as the mapping is unchanged
+        uint64_t sig = gamut_map_signature(&gamut);
+        pl_hash_merge(&sig, gamut.lut_size_I);
+        pl_hash_merge(&sig, gamut.lut_size_C);
+        pl_hash_merge(&sig, gamut.lut_size_h);
+        if (obj->gamut.fit_sig != sig) {
+            struct pl_gamut_map_params fit = gamut;
+            obj->gamut.fit_needed = pl_gamut_map_fit_lut_size(&fit, LUT3D_MAX_ERROR);
+            obj->gamut.fit_size[0] = fit.lut_size_I;
+            obj->gamut.fit_size[1] = fit.lut_size_C;
+            obj->gamut.fit_size[2] = fit.lut_size_h;
+            obj->gamut.fit_sig = sig;
+            PL_DEBUG(sh, "Adaptive gamut map 3DLUT size: %dx%dx%d%s",
+                     fit.lut_size_I, fit.lut_size_C, fit.lut_size_h,
+                     obj->gamut.fit_needed ? "" : " (skipped, mapping is identity)");
+        }
+
+        gamut.lut_size_I = obj->gamut.fit_size[0];
+        gamut.lut_size_C = obj->gamut.fit_size[1];
+        gamut.lut_size_h = obj->gamut.fit_size[2];
+        need_gamut_map = obj->gamut.fit_needed;
+    }
+
     // Fast path: simply convert between primaries (if needed)
     if (!need_tone_map && !need_gamut_map) {
+        if (src.primaries == dst.primaries && !args->prelinearized &&
+            transfer_roundtrip(&src, &dst))
+        {
+            // Delinearization would exactly undo linearization, skip both
+            GLSL("}\n");
+            return;
+        }
+
+        if (!args->prelinearized)
+            pl_shader_linearize(sh, &src);
         if (src.primaries != dst.primaries) {
             sh_describe(sh, "colorspace conversion");
             pl_matrix3x3_mul(&lms2rgb, &rgb2lms);
@@ -1844,6 +2169,9 @@ void pl_shader_color_map_ex(pl_shader sh, const struct pl_color_map_params *para
         goto done;
     }
 
+    if (!args->prelinearized)
+        pl_shader_linearize(sh, &src);
+
     // Full path: convert input from normalized RGB to IPT
     GLSL("vec3 lms = "$" * color.rgb;               \n"
          "vec3 lmspq = %f * lms;                    \n"
@@ -1904,31 +2232,144 @@ void pl_shader_color_map_ex(pl_shader sh, const struct pl_color_map_params *para
 
             GLSL("#define tone_map(x) ("$"(x)) \n", linfun);
 
+        } else if (fun == &pl_tone_map_spline && can_fast) {
+
+            // Evaluate the spline directly, so that changes in the dynamic
+            // metadata only update uniforms instead of regenerating a LUT
+            struct pl_tone_spline c;
+            pl_tone_map_spline_coeffs(&c, &tone);
+
+            ident_t splinefun = sh_fresh(sh, "spline_pq");
+            GLSLH("float "$"(float x) {                         \n"
+                 "    x = clamp(x, "$", "$") - "$";             \n"
+                 "    x = x > 0.0 ? (("$" * x + "$") * x + "$") * x \n"
+                 "                : ("$" * x + "$") * x;        \n"
+                 "    return clamp(x + "$", "$", "$");          \n"
+                 "}                                             \n",
+                 splinefun,
+                 SH_FLOAT(tone.input_min), SH_FLOAT_DYN(tone.input_max),
+                 SH_FLOAT_DYN(c.src_pivot),
+                 SH_FLOAT_DYN(c.Qa), SH_FLOAT_DYN(c.Qb), SH_FLOAT_DYN(c.Qc),
+                 SH_FLOAT_DYN(c.Pa), SH_FLOAT_DYN(c.Pb),
+                 SH_FLOAT_DYN(c.dst_pivot),
+                 SH_FLOAT(tone.output_min), SH_FLOAT_DYN(tone.output_max));
+
+            GLSL("#define tone_map(x) ("$"(x)) \n", splinefun);
+
+        } else if (fun == &pl_tone_map_reinhard && can_fast) {
+
+            // Reinhard operates on linear light, so evaluate it in between
+            // an inline PQ EOTF and OETF rather than baking it into a LUT
+            const float norm_scale = 10000.0f / PL_COLOR_SDR_WHITE;
+            const float in_min  = pl_hdr_rescale(PL_HDR_PQ, PL_HDR_NORM, tone.input_min),
+                        in_max  = pl_hdr_rescale(PL_HDR_PQ, PL_HDR_NORM, tone.input_max),
+                        out_min = pl_hdr_rescale(PL_HDR_PQ, PL_HDR_NORM, tone.output_min),
+                        out_max = pl_hdr_rescale(PL_HDR_PQ, PL_HDR_NORM, tone.output_max);
+            const float range = out_max - out_min,
+                        peak = (in_max - in_min) / range,
+                        contrast = tone.constants.reinhard_contrast,
+                        offset = (1.0f - contrast) / contrast,
+                        scale = (peak + offset) / peak;
+
+            ident_t reinhard = sh_fresh(sh, "reinhard_pq");
+            GLSLH("float "$"(float x) {                         \n"
+                 "    x = clamp(x, "$", "$");                   \n"
+                 "    x = pow(x, 1.0/%f);                       \n"
+                 "    x = max(x - %f, 0.0) / (%f - %f * x);     \n"
+                 "    x = pow(x, 1.0/%f) * %f;                  \n"
+                 "    x = "$" * x + "$";                        \n"
+                 "    x = "$" * x / (x + "$") + "$";            \n"
+                 "    x = pow(max(x, 0.0) * %f, %f);            \n"
+                 "    x = (%f + %f * x) / (1.0 + %f * x);       \n"
+                 "    return clamp(pow(x, %f), "$", "$");       \n"
+                 "}                                             \n",
+                 reinhard,
+                 SH_FLOAT(tone.input_min), SH_FLOAT_DYN(tone.input_max),
+                 PQ_M2, PQ_C1, PQ_C2, PQ_C3, PQ_M1, norm_scale,
+                 SH_FLOAT_DYN(1.0f / range), SH_FLOAT(-in_min / range),
+                 SH_FLOAT_DYN(scale * range), SH_FLOAT(offset), SH_FLOAT(out_min),
+                 1.0f / norm_scale, PQ_M1, PQ_C1, PQ_C2, PQ_C3, PQ_M2,
+                 SH_FLOAT(tone.output_min), SH_FLOAT_DYN(tone.output_max));
+
+            GLSL("#define tone_map(x) ("$"(x)) \n", reinhard);
+
+        } else if (fun == &pl_tone_map_bt2390 && can_fast) {
+
+            struct pl_tone_bt2390 c;
+            pl_tone_map_bt2390_coeffs(&c, &tone);
+            const float scale = tone.input_max - tone.input_min;
+
+            ident_t eetf = sh_fresh(sh, "bt2390_pq");
+            GLSLH("float "$"(float x) {                         \n"
+                 // Rescale to input-relative
+                 "    x = clamp(x, "$", "$");                   \n"
+                 "    x = "$" * x + "$";                        \n",
+                 eetf,
+                 SH_FLOAT(tone.input_min), SH_FLOAT_DYN(tone.input_max),
+                 SH_FLOAT_DYN(1.0f / scale), SH_FLOAT_DYN(-tone.input_min / scale));
+
+            if (c.ks < 1) {
+                // Piece-wise hermite spline
+                GLSLH("    float ks = "$", maxLum = "$";            \n"
+                      "    float tb = (x - ks) / (1.0 - ks);        \n"
+                      "    float tb2 = tb * tb;                     \n"
+                      "    float tb3 = tb2 * tb;                    \n"
+                      "    float pb = (2.0 * tb3 - 3.0 * tb2 + 1.0) * ks +  \n"
+                      "               (tb3 - 2.0 * tb2 + tb) * (1.0 - ks) + \n"
+                      "               (-2.0 * tb3 + 3.0 * tb2) * maxLum;    \n"
+                      "    x = x < ks ? x : pb;                     \n",
+                      SH_FLOAT_DYN(c.ks), SH_FLOAT_DYN(c.maxLum));
+            }
+
+            GLSLH(// Black point adaptation
+                  "    if (x < 1.0) {                           \n"
+                  "        float minLum = "$";                  \n"
+                  "        x += minLum * pow(1.0 - x, "$");     \n"
+                  "        x = "$" * (x - minLum) + minLum;     \n"
+                  "    }                                        \n"
+                  "    x = "$" * x + "$";                       \n"
+                  "    return clamp(x, "$", "$");               \n"
+                  "}                                            \n",
+                  SH_FLOAT_DYN(c.minLum), SH_FLOAT_DYN(c.bp), SH_FLOAT_DYN(c.gain),
+                  SH_FLOAT_DYN(scale), SH_FLOAT(tone.input_min),
+                  SH_FLOAT(tone.output_min), SH_FLOAT_DYN(tone.output_max));
+
+            GLSL("#define tone_map(x) ("$"(x)) \n", eetf);
+
         } else {
 
             pl_assert(obj);
+
+            // Keep using the existing LUT (and its parameters) for small
+            // changes in dynamic brightness, so the LUT is only regenerated
+            // once the accumulated difference exceeds the threshold
+            const bool reuse = obj->tone.lut &&
+                               tone_map_params_similar(&tone, &obj->tone.params);
+            if (!reuse)
+                obj->tone.params = tone;
+            const struct pl_tone_map_params *lut_params = &obj->tone.params;
+
             ident_t lut = sh_lut(sh, sh_lut_params(
                 .object     = &obj->tone.lut,
                 .var_type   = PL_VAR_FLOAT,
                 .lut_type   = SH_LUT_AUTO,
                 .method     = SH_LUT_LINEAR,
-                .width      = tone.lut_size,
+                .width      = lut_params->lut_size,
                 .comps      = 1,
-                .update     = !pl_tone_map_params_equal(&tone, &obj->tone.params),
-                .dynamic    = tone.input_avg > 0, // dynamic metadata
+                .update     = !reuse,
+                .dynamic    = lut_params->input_avg > 0, // dynamic metadata
                 .fill       = fill_tone_lut,
-                .priv       = &tone,
+                .priv       = (void *) lut_params,
             ));
-            obj->tone.params = tone;
             if (!lut) {
                 SH_FAIL(sh, "Failed generating tone-mapping LUT!");
                 return;
             }
 
-            const float lut_range = tone.input_max - tone.input_min;
+            const float lut_range = lut_params->input_max - lut_params->input_min;
             GLSL("#define tone_map(x) ("$"("$" * (x) + "$")) \n",
                  lut, SH_FLOAT_DYN(1.0f / lut_range),
-                 SH_FLOAT_DYN(-tone.input_min / lut_range));
+                 SH_FLOAT_DYN(-lut_params->input_min / lut_range));
 
         }
 
@@ -2004,6 +2445,7 @@ void pl_shader_color_map_ex(pl_shader sh, const struct pl_color_map_params *para
             .depth      = gamut.lut_size_h,
             .comps      = 4,
             .signature  = gamut_map_signature(&gamut),
+            .shared     = true,
             .cache      = SH_CACHE(sh),
             .fill       = fill_gamut_lut,
             .priv       = &gamut,
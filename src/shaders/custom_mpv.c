@@ -27,7 +27,9 @@
 // Hard-coded size limits, mainly for convenience (to avoid dynamic memory)
 #define SHADER_MAX_HOOKS 16
 #define SHADER_MAX_BINDS 16
+#define SHADER_NUM_STAGES 16 // number of bits in `enum pl_hook_stage`
 #define MAX_SHEXP_SIZE 32
+#define TILE_MAX_RADIUS 8 // max. HOOKED offset for tiled compute passes
 
 enum shexp_op {
     SHEXP_OP_ADD,
@@ -49,6 +51,14 @@ enum shexp_tag {
     SHEXP_OP2, // Pop two elements and push the result of a dyadic operation
     SHEXP_OP1, // Pop one element and push the result of a monadic operation
     SHEXP_VAR, // Arbitrary variable (e.g. shader parameters)
+    SHEXP_PARAM, // Value of a shader parameter, resolved from SHEXP_VAR
+};
+
+// Special texture slots for SHEXP_TEX_W/H, see `resolve_shexpr`
+enum {
+    TEX_SLOT_HOOKED         = -1,
+    TEX_SLOT_NATIVE_CROPPED = -2,
+    TEX_SLOT_OUTPUT         = -3,
 };
 
 struct shexp {
@@ -57,6 +67,8 @@ struct shexp {
         float cval;
         pl_str varname;
         enum shexp_op op;
+        int tex; // texture slot, after resolving SHEXP_TEX_W/H
+        const struct pl_hook_par *par;
     } val;
 };
 
@@ -66,6 +78,7 @@ struct custom_shader_hook {
     pl_str hook_tex[SHADER_MAX_HOOKS];
     pl_str bind_tex[SHADER_MAX_BINDS];
     pl_str save_tex;
+    int save_slot;
 
     // Shader body itself + metadata
     pl_str pass_body;
@@ -82,6 +95,11 @@ struct custom_shader_hook {
     bool is_compute;
     int block_w, block_h;       // Block size (each block corresponds to one WG)
     int threads_w, threads_h;   // How many threads form a WG
+
+    // Bounding box of all HOOKED texel offsets sampled by fragment-style
+    // passes, if known (see `infer_tile_bounds`)
+    bool tileable;
+    int tile_min[2], tile_max[2];
 };
 
 static bool parse_rpn_shexpr(pl_str line, struct shexp out[MAX_SHEXP_SIZE])
@@ -302,6 +320,97 @@ static bool parse_hook(pl_log log, pl_str *body, struct custom_shader_hook *out)
     return true;
 }
 
+// Splits off the argument of a function call, with `str` pointing just past
+// the opening parenthesis
+static bool split_call_arg(pl_str *str, pl_str *arg)
+{
+    int depth = 1;
+    for (size_t i = 0; i < str->len; i++) {
+        if (str->buf[i] == '(') {
+            depth++;
+        } else if (str->buf[i] == ')' && !--depth) {
+            *arg = pl_str_strip(pl_str_take(*str, i));
+            *str = pl_str_drop(*str, i + 1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Parses a constant integer texel offset, e.g. `0` or `vec2(-1.0, 2)`
+static bool parse_tex_offset(pl_str arg, int off[2])
+{
+    if (pl_str_eatstart0(&arg, "vec2(") || pl_str_eatstart0(&arg, "ivec2(")) {
+        if (!pl_str_eatend0(&arg, ")"))
+            return false;
+    }
+
+    pl_str x = pl_str_strip(pl_str_split_char(arg, ',', &arg));
+    pl_str y = arg.len ? pl_str_strip(arg) : x;
+    float fx, fy;
+    if (!pl_str_parse_float(x, &fx) || !pl_str_parse_float(y, &fy))
+        return false;
+    if (fx != roundf(fx) || fy != roundf(fy))
+        return false;
+    if (fabsf(fx) > TILE_MAX_RADIUS || fabsf(fy) > TILE_MAX_RADIUS)
+        return false;
+
+    off[0] = fx;
+    off[1] = fy;
+    return true;
+}
+
+// Determines whether a fragment-style pass only ever samples HOOKED at
+// constant integer offsets from HOOKED_pos, and if so, the bounding box of
+// these offsets. This is deliberately conservative, so any other use of the
+// HOOKED sampling functions (including via macros) disqualifies the pass.
+static void infer_tile_bounds(struct custom_shader_hook *hook)
+{
+    static const char * const fragment_only[] = {
+        "dFdx", "dFdy", "fwidth", "discard",
+    };
+
+    if (hook->is_compute)
+        return;
+    for (int i = 0; i < PL_ARRAY_SIZE(fragment_only); i++) {
+        if (pl_str_find(hook->pass_body, pl_str0(fragment_only[i])) >= 0)
+            return;
+    }
+
+    int min[2] = {0}, max[2] = {0};
+    pl_str body = hook->pass_body;
+    int pos;
+    while ((pos = pl_str_find(body, pl_str0("HOOKED_"))) >= 0) {
+        body = pl_str_drop(body, pos + strlen("HOOKED_"));
+        int off[2] = {0};
+        pl_str arg;
+        if (pl_str_eatstart0(&body, "texOff(")) {
+            if (!split_call_arg(&body, &arg) || !parse_tex_offset(arg, off))
+                return;
+        } else if (pl_str_eatstart0(&body, "tex(")) {
+            if (!split_call_arg(&body, &arg) || !pl_str_equals0(arg, "HOOKED_pos"))
+                return;
+        } else if (pl_str_startswith0(body, "tex") ||
+                   pl_str_startswith0(body, "raw") ||
+                   pl_str_startswith0(body, "gather"))
+        {
+            return;
+        } else {
+            continue;
+        }
+
+        for (int c = 0; c < 2; c++) {
+            min[c] = PL_MIN(min[c], off[c]);
+            max[c] = PL_MAX(max[c], off[c]);
+        }
+    }
+
+    hook->tileable = true;
+    memcpy(hook->tile_min, min, sizeof(min));
+    memcpy(hook->tile_max, max, sizeof(max));
+}
+
 static bool parse_tex(pl_gpu gpu, void *alloc, pl_str *body,
                       struct pl_shader_desc *out)
 {
@@ -908,6 +1017,7 @@ struct hook_pass {
 
 struct pass_tex {
     pl_str name;
+    int slot; // index into `hook_priv.tex_names`
     pl_tex tex;
 
     // Metadata
@@ -928,6 +1038,13 @@ struct hook_priv {
     // Fixed (for shader-local resources)
     PL_ARRAY(struct pl_shader_desc) descriptors;
 
+    // Names of all textures that may be referenced by the hook passes, with
+    // the first SHADER_NUM_STAGES entries corresponding to the stage names
+    PL_ARRAY(pl_str) tex_names;
+
+    // Run eligible passes as tiled compute shaders
+    bool compute_tiling;
+
     // Dynamic per pass
     enum pl_hook_stage save_stages;
     PL_ARRAY(struct pass_tex) pass_textures;
@@ -951,35 +1068,31 @@ struct hook_ctx {
     struct pass_tex hooked;
 };
 
-static bool lookup_tex(struct hook_ctx *ctx, pl_str var, float size[2])
+static bool lookup_tex(struct hook_ctx *ctx, int slot, float size[2])
 {
     struct hook_priv *p = ctx->priv;
     const struct pl_hook_params *params = ctx->params;
 
-    if (pl_str_equals0(var, "HOOKED")) {
+    switch (slot) {
+    case TEX_SLOT_HOOKED:
         pl_assert(ctx->hooked.tex);
         size[0] = ctx->hooked.tex->params.w;
         size[1] = ctx->hooked.tex->params.h;
         return true;
-    }
 
-    if (pl_str_equals0(var, "NATIVE_CROPPED")) {
+    case TEX_SLOT_NATIVE_CROPPED:
         size[0] = fabs(pl_rect_w(params->src_rect));
         size[1] = fabs(pl_rect_h(params->src_rect));
         return true;
-    }
 
-    if (pl_str_equals0(var, "OUTPUT")) {
+    case TEX_SLOT_OUTPUT:
         size[0] = abs(pl_rect_w(params->dst_rect));
         size[1] = abs(pl_rect_h(params->dst_rect));
         return true;
     }
 
-    if (pl_str_equals0(var, "MAIN"))
-        var = pl_str0("MAINPRESUB");
-
     for (int i = 0; i < p->pass_textures.num; i++) {
-        if (pl_str_equals(var, p->pass_textures.elem[i].name)) {
+        if (p->pass_textures.elem[i].slot == slot) {
             pl_tex tex = p->pass_textures.elem[i].tex;
             size[0] = tex->params.w;
             size[1] = tex->params.h;
@@ -990,38 +1103,6 @@ static bool lookup_tex(struct hook_ctx *ctx, pl_str var, float size[2])
     return false;
 }
 
-static bool lookup_var(struct hook_ctx *ctx, pl_str var, float *val)
-{
-    struct hook_priv *p = ctx->priv;
-    for (int i = 0; i < p->hook_params.num; i++) {
-        const struct pl_hook_par *hp = &p->hook_params.elem[i];
-        if (pl_str_equals0(var, hp->name)) {
-            switch (hp->type) {
-            case PL_VAR_SINT:  *val = hp->data->i; return true;
-            case PL_VAR_UINT:  *val = hp->data->u; return true;
-            case PL_VAR_FLOAT: *val = hp->data->f; return true;
-            case PL_VAR_INVALID:
-            case PL_VAR_TYPE_COUNT:
-                break;
-            }
-
-            pl_unreachable();
-        }
-
-        if (hp->names) {
-            for (int j = hp->minimum.i; j <= hp->maximum.i; j++) {
-                if (pl_str_equals0(var, hp->names[j])) {
-                    *val = j;
-                    return true;
-                }
-            }
-        }
-    }
-
-    PL_WARN(p, "Variable '%.*s' not found in RPN expression!", PL_STR_FMT(var));
-    return false;
-}
-
 // Returns whether successful. 'result' is left untouched on failure
 static bool eval_shexpr(struct hook_ctx *ctx,
                         const struct shexp expr[MAX_SHEXP_SIZE],
@@ -1087,12 +1168,12 @@ static bool eval_shexpr(struct hook_ctx *ctx,
 
         case SHEXP_TEX_W:
         case SHEXP_TEX_H: {
-            pl_str name = expr[i].val.varname;
+            const int slot = expr[i].val.tex;
             float size[2];
 
-            if (!lookup_tex(ctx, name, size)) {
+            if (!lookup_tex(ctx, slot, size)) {
                 PL_WARN(p, "Variable '%.*s' not found in RPN expression!",
-                        PL_STR_FMT(name));
+                        PL_STR_FMT(p->tex_names.elem[slot]));
                 return false;
             }
 
@@ -1100,14 +1181,25 @@ static bool eval_shexpr(struct hook_ctx *ctx,
             continue;
         }
 
-        case SHEXP_VAR: {
-            pl_str name = expr[i].val.varname;
-            float val;
-            if (!lookup_var(ctx, name, &val))
-                return false;
-            stack[idx++] = val;
-            continue;
+        case SHEXP_PARAM: {
+            const struct pl_hook_par *hp = expr[i].val.par;
+            switch (hp->type) {
+            case PL_VAR_SINT:  stack[idx++] = hp->data->i; continue;
+            case PL_VAR_UINT:  stack[idx++] = hp->data->u; continue;
+            case PL_VAR_FLOAT: stack[idx++] = hp->data->f; continue;
+            case PL_VAR_INVALID:
+            case PL_VAR_TYPE_COUNT:
+                break;
+            }
+
+            pl_unreachable();
         }
+
+        case SHEXP_VAR:
+            // Left over from `resolve_shexpr`, so this can never succeed
+            PL_WARN(p, "Variable '%.*s' not found in RPN expression!",
+                    PL_STR_FMT(expr[i].val.varname));
+            return false;
         }
     }
 
@@ -1215,11 +1307,284 @@ static bool bind_pass_tex(pl_shader sh, pl_str name,
     return true;
 }
 
+// Sets up a fragment-style pass to run as a compute shader, prefetching the
+// neighbourhood of each work group in the hooked texture `name` into shmem.
+// Must be called before appending the pass body.
+static bool setup_tile(pl_shader sh, const struct custom_shader_hook *hook,
+                       pl_str name)
+{
+    const int bw = 16, bh = PL_MIN(16, sh_glsl(sh).max_group_threads / bw);
+    const int tw = bw + hook->tile_max[0] - hook->tile_min[0],
+              th = bh + hook->tile_max[1] - hook->tile_min[1];
+    if (!bh || !sh_try_compute(sh, bw, bh, false, tw * th * sizeof(float[4])))
+        return false;
+
+    ident_t tile = sh_fresh(sh, "tile");
+    GLSLH("shared vec4 "$"[%d]; \n"
+          "vec4 "$"_fetch(ivec2 off) { \n"
+          "    ivec2 idx = ivec2(gl_LocalInvocationID.xy) + off - ivec2(%d, %d); \n"
+          "    return "$"[idx.y * %d + idx.x]; \n"
+          "} \n"
+          "#undef HOOKED_tex \n"
+          "#undef HOOKED_texOff \n"
+          "#define HOOKED_tex(pos) "$"_fetch(ivec2(0)) \n"
+          "#define HOOKED_texOff(off) "$"_fetch(ivec2(vec2(off))) \n",
+          tile, tw * th, tile, hook->tile_min[0], hook->tile_min[1],
+          tile, tw, tile, tile);
+
+    // The hooked texture is bound 1:1 to the output, so offsets from the
+    // work group origin map directly onto texels
+    ident_t base = sh_fresh(sh, "base");
+    GLSL("vec2 "$" = %.*s_map(gl_WorkGroupID.xy * gl_WorkGroupSize.xy);   \n"
+         "for (int y = int(gl_LocalInvocationID.y); y < %d; y += %d) {     \n"
+         "for (int x = int(gl_LocalInvocationID.x); x < %d; x += %d) {     \n"
+         "    "$"[y * %d + x] = %.*s_tex("$" + %.*s_pt * vec2(x + %d, y + %d)); \n"
+         "}}                                                                \n"
+         "barrier();                                                        \n",
+         base, PL_STR_FMT(name), th, bh, tw, bw, tile, tw, PL_STR_FMT(name),
+         base, PL_STR_FMT(name), hook->tile_min[0], hook->tile_min[1]);
+
+    return true;
+}
+
+static int stage_index(enum pl_hook_stage stage)
+{
+    for (int i = 0; i < SHADER_NUM_STAGES; i++) {
+        if (stage == (1 << i))
+            return i;
+    }
+
+    pl_unreachable();
+}
+
+// Returns the slot for a named texture, allocating a new one if needed
+static int tex_slot(struct hook_priv *p, pl_str name)
+{
+    for (int i = 0; i < p->tex_names.num; i++) {
+        if (pl_str_equals(p->tex_names.elem[i], name))
+            return i;
+    }
+
+    PL_ARRAY_APPEND(p->alloc, p->tex_names, name);
+    return p->tex_names.num - 1;
+}
+
+// Resolves all texture and variable names in an expression in advance, so
+// that evaluating it does not involve any string comparisons. Variables that
+// can't be resolved are left as SHEXP_VAR, and fail at evaluation time.
+static void resolve_shexpr(struct hook_priv *p, struct shexp expr[MAX_SHEXP_SIZE])
+{
+    for (int i = 0; i < MAX_SHEXP_SIZE && expr[i].tag != SHEXP_END; i++) {
+        struct shexp *exp = &expr[i];
+        switch (exp->tag) {
+        case SHEXP_TEX_W:
+        case SHEXP_TEX_H: {
+            pl_str name = exp->val.varname;
+            if (pl_str_equals0(name, "HOOKED")) {
+                exp->val.tex = TEX_SLOT_HOOKED;
+            } else if (pl_str_equals0(name, "NATIVE_CROPPED")) {
+                exp->val.tex = TEX_SLOT_NATIVE_CROPPED;
+            } else if (pl_str_equals0(name, "OUTPUT")) {
+                exp->val.tex = TEX_SLOT_OUTPUT;
+            } else if (pl_str_equals0(name, "MAIN")) {
+                exp->val.tex = tex_slot(p, pl_str0("MAINPRESUB"));
+            } else {
+                exp->val.tex = tex_slot(p, name);
+            }
+            continue;
+        }
+
+        case SHEXP_VAR: {
+            pl_str name = exp->val.varname;
+            for (int n = 0; n < p->hook_params.num; n++) {
+                const struct pl_hook_par *hp = &p->hook_params.elem[n];
+                if (pl_str_equals0(name, hp->name)) {
+                    exp->tag = SHEXP_PARAM;
+                    exp->val.par = hp;
+                    break;
+                }
+
+                bool found = false;
+                for (int j = hp->minimum.i; hp->names && j <= hp->maximum.i; j++) {
+                    if (pl_str_equals0(name, hp->names[j])) {
+                        exp->tag = SHEXP_CONST;
+                        exp->val.cval = j;
+                        found = true;
+                        break;
+                    }
+                }
+
+                if (found)
+                    break;
+            }
+            continue;
+        }
+
+        case SHEXP_END:
+        case SHEXP_CONST:
+        case SHEXP_OP1:
+        case SHEXP_OP2:
+        case SHEXP_PARAM:
+            continue;
+        }
+
+        pl_unreachable();
+    }
+}
+
+// Returns the hook stages whose textures are referenced by a (resolved)
+// expression. This excludes OUTPUT, see TEX_SLOT_OUTPUT.
+static enum pl_hook_stage shexpr_stages(const struct shexp expr[MAX_SHEXP_SIZE])
+{
+    enum pl_hook_stage stages = 0;
+    for (int i = 0; i < MAX_SHEXP_SIZE && expr[i].tag != SHEXP_END; i++) {
+        if (expr[i].tag != SHEXP_TEX_W && expr[i].tag != SHEXP_TEX_H)
+            continue;
+        const int slot = expr[i].val.tex;
+        if (slot >= 0 && slot < SHADER_NUM_STAGES)
+            stages |= 1 << slot;
+    }
+
+    return stages;
+}
+
+// Returns whether an expression is constant, and if so, evaluates it
+static bool shexpr_const(struct hook_priv *p, const struct shexp expr[MAX_SHEXP_SIZE],
+                         float *result)
+{
+    for (int i = 0; i < MAX_SHEXP_SIZE && expr[i].tag != SHEXP_END; i++) {
+        switch (expr[i].tag) {
+        case SHEXP_CONST:
+        case SHEXP_OP1:
+        case SHEXP_OP2:
+            continue;
+        default:
+            return false;
+        }
+    }
+
+    return eval_shexpr(&(struct hook_ctx) { .priv = p }, expr, result);
+}
+
+// Whether a hook pass has side effects beyond the texture it renders to,
+// i.e. binds a writable storage buffer or image
+static bool pass_has_side_effects(struct hook_priv *p,
+                                  const struct custom_shader_hook *hook)
+{
+    for (int i = 0; i < PL_ARRAY_SIZE(hook->bind_tex) && hook->bind_tex[i].len; i++) {
+        for (int j = 0; j < p->descriptors.num; j++) {
+            const struct pl_desc *desc = &p->descriptors.elem[j].desc;
+            if (!pl_str_equals0(hook->bind_tex[i], desc->name))
+                continue;
+            if (desc->access != PL_DESC_ACCESS_READONLY &&
+                desc->type != PL_DESC_SAMPLED_TEX &&
+                desc->type != PL_DESC_BUF_UNIFORM &&
+                desc->type != PL_DESC_BUF_TEXEL_UNIFORM)
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// Marks all passes producing textures consumed by `hook` as live
+static bool mark_inputs_live(struct hook_priv *p, const struct custom_shader_hook *hook,
+                             bool *live, const bool *never)
+{
+    int slots[SHADER_MAX_BINDS + 3 * MAX_SHEXP_SIZE];
+    int num_slots = 0;
+
+    for (int i = 0; i < PL_ARRAY_SIZE(hook->bind_tex) && hook->bind_tex[i].len; i++) {
+        pl_str name = hook->bind_tex[i];
+        if (pl_str_equals0(name, "HOOKED"))
+            continue; // the stage itself, always available
+        if (pl_str_equals0(name, "MAIN"))
+            name = pl_str0("MAINPRESUB");
+        slots[num_slots++] = tex_slot(p, name);
+    }
+
+    const struct shexp *exprs[] = { hook->width, hook->height, hook->cond };
+    for (int e = 0; e < PL_ARRAY_SIZE(exprs); e++) {
+        for (int i = 0; i < MAX_SHEXP_SIZE && exprs[e][i].tag != SHEXP_END; i++) {
+            const struct shexp *exp = &exprs[e][i];
+            if ((exp->tag == SHEXP_TEX_W || exp->tag == SHEXP_TEX_H) && exp->val.tex >= 0)
+                slots[num_slots++] = exp->val.tex;
+        }
+    }
+
+    bool changed = false;
+    for (int n = 0; n < p->hook_passes.num; n++) {
+        if (live[n] || never[n])
+            continue;
+        for (int i = 0; i < num_slots; i++) {
+            if (p->hook_passes.elem[n].hook.save_slot == slots[i]) {
+                live[n] = changed = true;
+                break;
+            }
+        }
+    }
+
+    return changed;
+}
+
+// Removes all hook passes that can never run, or whose output is never
+// consumed (directly or indirectly) by the hooked stages. Requires resolved
+// expressions.
+static void eliminate_dead_passes(struct hook_priv *p)
+{
+    const int num = p->hook_passes.num;
+    if (!num)
+        return;
+
+    bool *live = pl_calloc_ptr(NULL, num, live);
+    bool *never = pl_calloc_ptr(NULL, num, never);
+    for (int n = 0; n < num; n++) {
+        const struct custom_shader_hook *hook = &p->hook_passes.elem[n].hook;
+        float cond;
+        if (shexpr_const(p, hook->cond, &cond) && !cond) {
+            never[n] = true;
+            continue;
+        }
+
+        // Passes writing to any of the stage textures directly affect the
+        // output, so these are always live
+        live[n] = !hook->save_tex.len || hook->save_slot < SHADER_NUM_STAGES ||
+                  pass_has_side_effects(p, hook);
+    }
+
+    bool changed;
+    do {
+        changed = false;
+        for (int n = 0; n < num; n++) {
+            if (live[n])
+                changed |= mark_inputs_live(p, &p->hook_passes.elem[n].hook, live, never);
+        }
+    } while (changed);
+
+    int out = 0;
+    for (int n = 0; n < num; n++) {
+        const struct hook_pass *pass = &p->hook_passes.elem[n];
+        if (!live[n]) {
+            PL_INFO(p, "Skipping %s hook pass: %.*s",
+                    never[n] ? "disabled" : "unused",
+                    PL_STR_FMT(pass->hook.pass_desc));
+            continue;
+        }
+        p->hook_passes.elem[out++] = *pass;
+    }
+
+    p->hook_passes.num = out;
+    pl_free(live);
+    pl_free(never);
+}
+
 static void save_pass_tex(struct hook_priv *p, struct pass_tex ptex)
 {
 
     for (int i = 0; i < p->pass_textures.num; i++) {
-        if (!pl_str_equals(p->pass_textures.elem[i].name, ptex.name))
+        if (p->pass_textures.elem[i].slot != ptex.slot)
             continue;
 
         p->pass_textures.elem[i] = ptex;
@@ -1234,6 +1599,7 @@ static struct pl_hook_res hook_hook(void *priv, const struct pl_hook_params *par
 {
     struct hook_priv *p = priv;
     pl_str stage = pl_stage_to_mp(params->stage);
+    const int stage_slot = stage_index(params->stage);
     struct pl_hook_res res = {0};
 
     pl_shader sh = NULL;
@@ -1242,6 +1608,7 @@ static struct pl_hook_res hook_hook(void *priv, const struct pl_hook_params *par
         .params = params,
         .hooked = {
             .name  = stage,
+            .slot  = stage_slot,
             .tex   = params->tex,
             .rect  = params->rect,
             .repr  = params->repr,
@@ -1280,6 +1647,8 @@ static struct pl_hook_res hook_hook(void *priv, const struct pl_hook_params *par
         sh = pl_dispatch_begin(params->dispatch);
 
         // Bind all necessary input textures
+        pl_str hooked_name = {0};
+        pl_tex hooked_tex = NULL;
         for (int i = 0; i < PL_ARRAY_SIZE(hook->bind_tex); i++) {
             pl_str texname = hook->bind_tex[i];
             if (!texname.len)
@@ -1345,6 +1714,10 @@ static struct pl_hook_res hook_hook(void *priv, const struct pl_hook_params *par
                     {
                         goto error;
                     }
+                    if (hooked) {
+                        hooked_name = texname;
+                        hooked_tex = ptex->tex;
+                    }
                     goto next_bind;
                 }
             }
@@ -1452,10 +1825,6 @@ static struct pl_hook_res hook_hook(void *priv, const struct pl_hook_params *par
         pl_shader_delinearize(p->trc_helper, params->orig_color);
         GLSLH("#define delinearize "$" \n", sh_subpass(sh, p->trc_helper));
 
-        // Load and run the user shader itself
-        sh_append_str(sh, SH_BUF_HEADER, hook->pass_body);
-        sh_describef(sh, "%.*s", PL_STR_FMT(hook->pass_desc));
-
         // Resolve output size and create framebuffer
         float out_size[2] = {0};
         if (!eval_shexpr(&ctx, hook->width,  &out_size[0]) ||
@@ -1478,6 +1847,18 @@ static struct pl_hook_res hook_hook(void *priv, const struct pl_hook_params *par
             goto error;
         }
 
+        // Passes which don't resize the hooked texture can be tiled
+        bool tiled = p->compute_tiling && hook->tileable && hooked_tex &&
+                     !hook->offset_align && fbo->params.storable &&
+                     out_w == hooked_tex->params.w && out_h == hooked_tex->params.h &&
+                     setup_tile(sh, hook, hooked_name);
+        if (tiled)
+            PL_TRACE(p, "Running hook pass as tiled compute shader");
+
+        // Load and run the user shader itself
+        sh_append_str(sh, SH_BUF_HEADER, hook->pass_body);
+        sh_describef(sh, "%.*s", PL_STR_FMT(hook->pass_desc));
+
         bool ok;
         if (hook->is_compute) {
 
@@ -1516,7 +1897,8 @@ static struct pl_hook_res hook_hook(void *priv, const struct pl_hook_params *par
 
             // Default non-COMPUTE shaders to explicitly use fragment shaders
             // only, to avoid breaking things like fwidth()
-            sh->type = PL_DEF(sh->type, SH_FRAGMENT);
+            if (!tiled)
+                sh->type = PL_DEF(sh->type, SH_FRAGMENT);
 
             GLSL("vec4 color = hook(); \n");
             ok = pl_dispatch_finish(params->dispatch, pl_dispatch_params(
@@ -1553,6 +1935,7 @@ static struct pl_hook_res hook_hook(void *priv, const struct pl_hook_params *par
         // Save the result of this shader invocation
         struct pass_tex ptex = {
             .name  = hook->save_tex.len ? hook->save_tex : stage,
+            .slot  = hook->save_tex.len ? hook->save_slot : stage_slot,
             .tex   = fbo,
             .repr  = ctx.hooked.repr,
             .color = ctx.hooked.color,
@@ -1569,7 +1952,7 @@ static struct pl_hook_res hook_hook(void *priv, const struct pl_hook_params *par
         save_pass_tex(p, ptex);
 
         // Update the result object, unless we saved to a different name
-        if (pl_str_equals(ptex.name, stage)) {
+        if (ptex.slot == stage_slot) {
             ctx.hooked = ptex;
             res = (struct pl_hook_res) {
                 .output     = PL_HOOK_SIG_TEX,
@@ -1594,6 +1977,14 @@ error:
 const struct pl_hook *pl_mpv_user_shader_parse(pl_gpu gpu,
                                                const char *shader_text,
                                                size_t shader_len)
+{
+    return pl_mpv_user_shader_parse_ex(gpu, shader_text, shader_len, NULL);
+}
+
+const struct pl_hook *pl_mpv_user_shader_parse_ex(pl_gpu gpu,
+                                                  const char *shader_text,
+                                                  size_t shader_len,
+                                                  const struct pl_mpv_user_shader_params *params)
 {
     if (!shader_len)
         return NULL;
@@ -1616,6 +2007,7 @@ const struct pl_hook *pl_mpv_user_shader_parse(pl_gpu gpu,
         .gpu = gpu,
         .alloc = hook,
         .trc_helper = pl_shader_alloc(gpu->log, NULL),
+        .compute_tiling = params && params->compute_tiling,
         .prng_state = {
             // Determined by fair die roll
             0xb76d71f9443c228allu, 0x93a02092fc4807e8llu,
@@ -1624,6 +2016,8 @@ const struct pl_hook *pl_mpv_user_shader_parse(pl_gpu gpu,
     };
 
     shader = pl_strdup(hook, shader);
+    for (int i = 0; i < SHADER_NUM_STAGES; i++)
+        PL_ARRAY_APPEND(hook, p->tex_names, pl_stage_to_mp(1 << i));
 
     // Skip all garbage (e.g. comments) before the first header
     int pos = pl_str_find(shader, pl_str0("//!"));
@@ -1670,6 +2064,7 @@ const struct pl_hook *pl_mpv_user_shader_parse(pl_gpu gpu,
         struct custom_shader_hook h;
         if (!parse_hook(gpu->log, &shader, &h))
             goto error;
+        infer_tile_bounds(&h);
 
         struct hook_pass pass = {
             .exec_stages = 0,
@@ -1678,10 +2073,30 @@ const struct pl_hook *pl_mpv_user_shader_parse(pl_gpu gpu,
 
         for (int i = 0; i < PL_ARRAY_SIZE(h.hook_tex); i++)
             pass.exec_stages |= mp_stage_to_pl(h.hook_tex[i]);
-        for (int i = 0; i < PL_ARRAY_SIZE(h.bind_tex); i++) {
-            p->save_stages |= mp_stage_to_pl(h.bind_tex[i]);
-            if (pl_str_equals0(h.bind_tex[i], "HOOKED"))
-                p->save_stages |= pass.exec_stages;
+
+        PL_INFO(gpu, "Registering hook pass: %.*s", PL_STR_FMT(h.pass_desc));
+        PL_ARRAY_APPEND(hook, p->hook_passes, pass);
+    }
+
+    // Now that all parameters are known, resolve all expressions
+    for (int i = 0; i < p->hook_passes.num; i++) {
+        struct custom_shader_hook *h = &p->hook_passes.elem[i].hook;
+        resolve_shexpr(p, h->width);
+        resolve_shexpr(p, h->height);
+        resolve_shexpr(p, h->cond);
+        if (h->save_tex.len)
+            h->save_slot = tex_slot(p, h->save_tex);
+    }
+
+    eliminate_dead_passes(p);
+
+    for (int n = 0; n < p->hook_passes.num; n++) {
+        const struct hook_pass *pass = &p->hook_passes.elem[n];
+        const struct custom_shader_hook *h = &pass->hook;
+        for (int i = 0; i < PL_ARRAY_SIZE(h->bind_tex); i++) {
+            p->save_stages |= mp_stage_to_pl(h->bind_tex[i]);
+            if (pl_str_equals0(h->bind_tex[i], "HOOKED"))
+                p->save_stages |= pass->exec_stages;
         }
 
         // As an extra precaution, this avoids errors when trying to run
@@ -1689,24 +2104,9 @@ const struct pl_hook *pl_mpv_user_shader_parse(pl_gpu gpu,
         // exception, OUTPUT is special because it's hard-coded to return the
         // dst_rect even before it was hooked. (This is an apparently
         // undocumented mpv quirk, but shaders rely on it in practice)
-        enum pl_hook_stage rpn_stages = 0;
-        for (int i = 0; i < PL_ARRAY_SIZE(h.width); i++) {
-            if (h.width[i].tag == SHEXP_TEX_W || h.width[i].tag == SHEXP_TEX_H)
-                rpn_stages |= mp_stage_to_pl(h.width[i].val.varname);
-        }
-        for (int i = 0; i < PL_ARRAY_SIZE(h.height); i++) {
-            if (h.height[i].tag == SHEXP_TEX_W || h.height[i].tag == SHEXP_TEX_H)
-                rpn_stages |= mp_stage_to_pl(h.height[i].val.varname);
-        }
-        for (int i = 0; i < PL_ARRAY_SIZE(h.cond); i++) {
-            if (h.cond[i].tag == SHEXP_TEX_W || h.cond[i].tag == SHEXP_TEX_H)
-                rpn_stages |= mp_stage_to_pl(h.cond[i].val.varname);
-        }
-
-        p->save_stages |= rpn_stages & ~PL_HOOK_OUTPUT;
-
-        PL_INFO(gpu, "Registering hook pass: %.*s", PL_STR_FMT(h.pass_desc));
-        PL_ARRAY_APPEND(hook, p->hook_passes, pass);
+        p->save_stages |= shexpr_stages(h->width);
+        p->save_stages |= shexpr_stages(h->height);
+        p->save_stages |= shexpr_stages(h->cond);
     }
 
     // We need to hook on both the exec and save stages, so that we can keep
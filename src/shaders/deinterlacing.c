@@ -22,25 +22,22 @@
 
 const struct pl_deinterlace_params pl_deinterlace_default_params = { PL_DEINTERLACE_DEFAULTS };
 
-void pl_shader_deinterlace(pl_shader sh, const struct pl_deinterlace_source *src,
-                           const struct pl_deinterlace_params *params)
+// Emits the deinterlacing code for a single source, writing to `color`. If
+// `atlas` is set, the source is sampled relative to `origin.xy` (in output
+// pixels) instead of using the bound texture coordinates.
+static bool deinterlace_src(pl_shader sh, const struct pl_deinterlace_source *src,
+                            const struct pl_deinterlace_params *params,
+                            ident_t atlas, ident_t origin)
 {
-    params = PL_DEF(params, &pl_deinterlace_default_params);
-
     const struct pl_tex_params *texparams = &src->cur.top->params;
-    if (!sh_require(sh, PL_SHADER_SIG_NONE, texparams->w, texparams->h))
-        return;
-
-    sh_describe(sh, "deinterlacing");
-    GLSL("vec4 color = vec4(0,0,0,1);   \n"
-         "// pl_shader_deinterlace      \n"
+    GLSL("// pl_shader_deinterlace      \n"
          "{                             \n");
 
     uint8_t comp_mask = PL_DEF(src->component_mask, 0xFu);
     comp_mask &= (1u << texparams->format->num_components) - 1u;
     if (!comp_mask) {
         SH_FAIL(sh, "pl_shader_deinterlace: empty component mask?");
-        return;
+        return false;
     }
 
     const uint8_t num_comps = sh_num_comps(comp_mask);
@@ -51,27 +48,86 @@ void pl_shader_deinterlace(pl_shader sh, const struct pl_deinterlace_source *src
     ident_t cur = sh_bind(sh, src->cur.top, PL_TEX_ADDRESS_MIRROR,
                           PL_TEX_SAMPLE_NEAREST, "cur", NULL, &pos, &pt);
     if (!cur)
-        return;
+        return false;
 
     GLSL("#define GET(TEX, X, Y)                              \\\n"
          "    (textureLod(TEX, pos + pt * vec2(X, Y), 0.0).%s)  \n"
-         "vec2 pos = "$";                                       \n"
          "vec2 pt  = "$";                                       \n"
          "T res;                                                \n",
-         swiz, pos, pt);
+         swiz, pt);
+
+    if (atlas) {
+        GLSL("vec2 pos = ("$" - vec2("$".xy)) * pt; \n", atlas, origin);
+    } else {
+        GLSL("vec2 pos = "$"; \n", pos);
+    }
 
     if (src->field == PL_FIELD_NONE) {
         GLSL("res = GET("$", 0, 0); \n", cur);
         goto done;
     }
 
+    // YADIF samples a 7 pixel wide window from both neighbouring lines of the
+    // current field for every output pixel. When possible, load these lines
+    // into shared memory once per work group instead. This has to happen
+    // before branching on the field parity, since it requires barrier().
+    //
+    // Either way, try using a compute shader for this, for the sole reason of
+    // optimizing for thread group synchronicity. Otherwise, because we
+    // alternate between lines output as-is and lines output deinterlaced,
+    // half of our thread group will be mostly idle at any point in time.
+    //
+    // Batched sources are selected by branching on the output position, so
+    // they can't use barrier() and always sample directly.
+    ident_t tile = NULL_IDENT;
+    if (params->algo == PL_DEINTERLACE_YADIF && !atlas) {
+        const int bw = PL_DEF(sh_glsl(sh).subgroup_size, 32), iw = bw + 6;
+        const size_t shmem_req = (2 * iw * num_comps + 2) * sizeof(float);
+        if (sh_try_compute(sh, bw, 1, false, shmem_req)) {
+            tile = sh_fresh(sh, "tile");
+            GLSLH("shared int "$"_base[2]; \n", tile);
+            for (uint8_t i = 0; i < num_comps; i++)
+                GLSLH("shared float "$"_%d[%d]; \n", tile, i, 2 * iw);
+
+            // Work groups may be mirrored, so take the leftmost thread
+            GLSL("int xo = int(pos.x * float(textureSize("$", 0).x));     \n"
+                 "if (gl_LocalInvocationID.x == 0u)                       \n"
+                 "    "$"_base[0] = xo;                                   \n"
+                 "if (gl_LocalInvocationID.x == gl_WorkGroupSize.x - 1u)  \n"
+                 "    "$"_base[1] = xo;                                   \n"
+                 "barrier();                                              \n"
+                 "int "$"_x = xo - min("$"_base[0], "$"_base[1]);         \n"
+                 "for (int x = int(gl_LocalInvocationID.x); x < %d; x += %d) { \n"
+                 "for (int y = 0; y < 2; y++) {                           \n"
+                 "    T c = GET("$", x - "$"_x - 3, 2 * y - 1);           \n",
+                 cur, tile, tile, tile, tile, tile, iw, bw, cur, tile);
+            for (uint8_t i = 0; i < num_comps; i++) {
+                GLSL("    "$"_%d[y * %d + x] = c%s; \n", tile, i, iw,
+                     num_comps > 1 ? (const char *[]) {".x", ".y", ".z", ".w"}[i] : "");
+            }
+            GLSL("}}         \n"
+                 "barrier(); \n");
+
+            // TILE(X, Y) fetches the pixel at offset X on the line above
+            // (Y = 0) or below (Y = 1) the current pixel
+            GLSL("#define TILE(X, Y) T(");
+            for (uint8_t i = 0; i < num_comps; i++) {
+                GLSL("%s"$"_%d[(Y) * %d + "$"_x + 3 + (X)]",
+                     i ? ", " : "", tile, i, iw, tile);
+            }
+            GLSL(") \n");
+        } else {
+            sh_try_compute(sh, bw, 1, true, 0);
+        }
+    }
+
     // Don't modify the primary field
     GLSL("int yh = textureSize("$", 0).y;   \n"
-         "int yo = int("$".y * float(yh));  \n"
+         "int yo = int(pos.y * float(yh));  \n"
          "if (yo %% 2 == %d) {              \n"
          "    res = GET("$", 0, 0);         \n"
          "} else {                          \n",
-         cur, pos,
+         cur,
          src->field == PL_FIELD_TOP ? 0 : 1,
          cur);
 
@@ -87,13 +143,6 @@ void pl_shader_deinterlace(pl_shader sh, const struct pl_deinterlace_source *src
 
 
     case PL_DEINTERLACE_YADIF: {
-        // Try using a compute shader for this, for the sole reason of
-        // optimizing for thread group synchronicity. Otherwise, because we
-        // alternate between lines output as-is and lines output deinterlaced,
-        // half of our thread group will be mostly idle at any point in time.
-        const int bw = PL_DEF(sh_glsl(sh).subgroup_size, 32);
-        sh_try_compute(sh, bw, 1, true, 0);
-
         // This magic constant is hard-coded in the original implementation as
         // '1' on an 8-bit scale. Since we work with arbitrary bit depth
         // floating point textures, we have to convert this somehow. Hard-code
@@ -134,21 +183,38 @@ void pl_shader_deinterlace(pl_shader sh, const struct pl_deinterlace_source *src
               "}                                                                        \n",
               spatial_pred, spatial_bias);
 
-        GLSL("T a = GET("$", -3, -1); \n"
-             "T b = GET("$", -2, -1); \n"
-             "T c = GET("$", -1, -1); \n"
-             "T d = GET("$",  0, -1); \n"
-             "T e = GET("$", +1, -1); \n"
-             "T f = GET("$", +2, -1); \n"
-             "T g = GET("$", +3, -1); \n"
-             "T h = GET("$", -3, +1); \n"
-             "T i = GET("$", -2, +1); \n"
-             "T j = GET("$", -1, +1); \n"
-             "T k = GET("$",  0, +1); \n"
-             "T l = GET("$", +1, +1); \n"
-             "T m = GET("$", +2, +1); \n"
-             "T n = GET("$", +3, +1); \n",
-             cur, cur, cur, cur, cur, cur, cur, cur, cur, cur, cur, cur, cur, cur);
+        if (tile) {
+            GLSL("T a = TILE(-3, 0); \n"
+                 "T b = TILE(-2, 0); \n"
+                 "T c = TILE(-1, 0); \n"
+                 "T d = TILE( 0, 0); \n"
+                 "T e = TILE(+1, 0); \n"
+                 "T f = TILE(+2, 0); \n"
+                 "T g = TILE(+3, 0); \n"
+                 "T h = TILE(-3, 1); \n"
+                 "T i = TILE(-2, 1); \n"
+                 "T j = TILE(-1, 1); \n"
+                 "T k = TILE( 0, 1); \n"
+                 "T l = TILE(+1, 1); \n"
+                 "T m = TILE(+2, 1); \n"
+                 "T n = TILE(+3, 1); \n");
+        } else {
+            GLSL("T a = GET("$", -3, -1); \n"
+                 "T b = GET("$", -2, -1); \n"
+                 "T c = GET("$", -1, -1); \n"
+                 "T d = GET("$",  0, -1); \n"
+                 "T e = GET("$", +1, -1); \n"
+                 "T f = GET("$", +2, -1); \n"
+                 "T g = GET("$", +3, -1); \n"
+                 "T h = GET("$", -3, +1); \n"
+                 "T i = GET("$", -2, +1); \n"
+                 "T j = GET("$", -1, +1); \n"
+                 "T k = GET("$",  0, +1); \n"
+                 "T l = GET("$", +1, +1); \n"
+                 "T m = GET("$", +2, +1); \n"
+                 "T n = GET("$", +3, +1); \n",
+                 cur, cur, cur, cur, cur, cur, cur, cur, cur, cur, cur, cur, cur, cur);
+        }
 
         if (num_comps == 1) {
             GLSL("res = "$"(a, b, c, d, e, f, g, h, i, j, k, l, m, n); \n", spatial_pred);
@@ -197,7 +263,7 @@ void pl_shader_deinterlace(pl_shader sh, const struct pl_deinterlace_source *src
             prev2 = sh_bind(sh, src->prev.top, PL_TEX_ADDRESS_MIRROR,
                             PL_TEX_SAMPLE_NEAREST, "prev", NULL, NULL, NULL);
             if (!prev2)
-                return;
+                return false;
         }
 
         if (src->next.top && src->next.top != src->cur.top) {
@@ -206,7 +272,7 @@ void pl_shader_deinterlace(pl_shader sh, const struct pl_deinterlace_source *src
             next2 = sh_bind(sh, src->next.top, PL_TEX_ADDRESS_MIRROR,
                             PL_TEX_SAMPLE_NEAREST, "next", NULL, NULL, NULL);
             if (!next2)
-                return;
+                return false;
         }
 
         enum pl_field first_field = PL_DEF(src->first_field, PL_FIELD_TOP);
@@ -217,17 +283,25 @@ void pl_shader_deinterlace(pl_shader sh, const struct pl_deinterlace_source *src
              "T B = GET("$", 0,  1); \n"
              "T C = GET("$", 0, -2); \n"
              "T D = GET("$", 0,  0); \n"
-             "T E = GET("$", 0, +2); \n"
-             "T F = GET("$", 0, -1); \n"
-             "T G = GET("$", 0, +1); \n"
-             "T H = GET("$", 0, -2); \n"
+             "T E = GET("$", 0, +2); \n",
+             prev2, prev2,
+             prev1, prev1, prev1);
+
+        // F and G are the same pixels as `d` and `k` from the current field
+        if (tile) {
+            GLSL("T F = d; \n"
+                 "T G = k; \n");
+        } else {
+            GLSL("T F = GET("$", 0, -1); \n"
+                 "T G = GET("$", 0, +1); \n",
+                 cur, cur);
+        }
+
+        GLSL("T H = GET("$", 0, -2); \n"
              "T I = GET("$", 0,  0); \n"
              "T J = GET("$", 0, +2); \n"
              "T K = GET("$", 0, -1); \n"
              "T L = GET("$", 0, +1); \n",
-             prev2, prev2,
-             prev1, prev1, prev1,
-             cur, cur,
              next1, next1, next1,
              next2, next2);
 
@@ -255,6 +329,82 @@ done:
     GLSL("color.%s = res;   \n"
          "#undef T          \n"
          "#undef GET        \n"
+         "#undef TILE       \n"
          "}                 \n",
          swiz);
+    return true;
+}
+
+void pl_shader_deinterlace(pl_shader sh, const struct pl_deinterlace_source *src,
+                           const struct pl_deinterlace_params *params)
+{
+    params = PL_DEF(params, &pl_deinterlace_default_params);
+
+    const struct pl_tex_params *texparams = &src->cur.top->params;
+    if (!sh_require(sh, PL_SHADER_SIG_NONE, texparams->w, texparams->h))
+        return;
+
+    sh_describe(sh, "deinterlacing");
+    GLSL("vec4 color = vec4(0,0,0,1); \n");
+    deinterlace_src(sh, src, params, NULL_IDENT, NULL_IDENT);
+}
+
+void pl_shader_deinterlace_batch(pl_shader sh, const struct pl_deinterlace_source *srcs,
+                                 const pl_rect2d *rects, int num_srcs,
+                                 const struct pl_deinterlace_params *params)
+{
+    params = PL_DEF(params, &pl_deinterlace_default_params);
+    if (num_srcs <= 0) {
+        SH_FAIL(sh, "pl_shader_deinterlace_batch: no sources?");
+        return;
+    }
+
+    int w = 0, h = 0;
+    for (int i = 0; i < num_srcs; i++) {
+        const pl_rect2d *rc = &rects[i];
+        const struct pl_tex_params *texparams = &srcs[i].cur.top->params;
+        if (rc->x0 < 0 || rc->y0 < 0 || pl_rect_w(*rc) != texparams->w ||
+            pl_rect_h(*rc) != texparams->h)
+        {
+            SH_FAIL(sh, "pl_shader_deinterlace_batch: rect %d {%d %d %d %d} "
+                    "does not match source size %dx%d!", i, rc->x0, rc->y0,
+                    rc->x1, rc->y1, texparams->w, texparams->h);
+            return;
+        }
+
+        w = PL_MAX(w, rc->x1);
+        h = PL_MAX(h, rc->y1);
+    }
+
+    if (!sh_require(sh, PL_SHADER_SIG_NONE, w, h))
+        return;
+
+    ident_t atlas = sh_attr_vec2(sh, "atlas_pos", &(pl_rect2df) {
+        .x1 = w, .y1 = h,
+    });
+    if (!atlas)
+        return;
+
+    sh_describe(sh, "deinterlacing (batched)");
+    GLSL("vec4 color = vec4(0,0,0,0); \n"
+         "ivec2 atlas_pos = ivec2("$"); \n",
+         atlas);
+
+    for (int i = 0; i < num_srcs; i++) {
+        const pl_rect2d *rc = &rects[i];
+        ident_t rect = sh_var(sh, (struct pl_shader_var) {
+            .var     = pl_var_ivec4("rect"),
+            .data    = &(int[4]) { rc->x0, rc->y0, rc->x1, rc->y1 },
+            .dynamic = true,
+        });
+
+        GLSL("%sif (all(greaterThanEqual(atlas_pos, "$".xy)) && \n"
+             "    all(lessThan(atlas_pos, "$".zw))) {           \n"
+             "    color = vec4(0,0,0,1);                         \n",
+             i ? "} else " : "", rect, rect);
+        if (!deinterlace_src(sh, &srcs[i], params, atlas, rect))
+            return;
+    }
+
+    GLSL("} \n");
 }
@@ -45,6 +45,7 @@ static void fill_dither_matrix(void *data, const struct sh_lut_params *params)
         return;
 
     case PL_DITHER_BLUE_NOISE:
+    case PL_DITHER_BLUE_NOISE_TEMPORAL:
         pl_assert(params->width == params->height);
         pl_generate_blue_noise(data, params->width);
         return;
@@ -62,6 +63,7 @@ static bool dither_method_is_lut(enum pl_dither_method method)
 {
     switch (method) {
     case PL_DITHER_BLUE_NOISE:
+    case PL_DITHER_BLUE_NOISE_TEMPORAL:
     case PL_DITHER_ORDERED_LUT:
         return true;
     case PL_DITHER_ORDERED_FIXED:
@@ -120,7 +122,8 @@ void pl_shader_dither(pl_shader sh, int new_depth,
     sh_describef(sh, "dithering (%d bits)", new_depth);
     GLSL("// pl_shader_dither \n"
         "{                    \n"
-        "float bias;          \n");
+        "%sfloat bias;        \n",
+        sh_prec(sh));
 
     params = PL_DEF(params, &pl_dither_default_params);
     if (params->lut_size < 0 || params->lut_size > 8) {
@@ -145,8 +148,13 @@ void pl_shader_dither(pl_shader sh, int new_depth,
         if (!obj)
             goto fallback;
 
-        bool cache = method == PL_DITHER_BLUE_NOISE;
         lut_size = 1 << PL_DEF(params->lut_size, pl_dither_default_params.lut_size);
+        // Both blue noise variants share the same matrix
+        enum pl_dither_method lut_method = method;
+        if (lut_method == PL_DITHER_BLUE_NOISE_TEMPORAL)
+            lut_method = PL_DITHER_BLUE_NOISE;
+        // Only sizes without a precomputed blue noise table are worth caching
+        bool cache = lut_method == PL_DITHER_BLUE_NOISE && lut_size > 128;
         lut = sh_lut(sh, sh_lut_params(
             .object     = &obj->lut,
             .var_type   = PL_VAR_FLOAT,
@@ -154,7 +162,8 @@ void pl_shader_dither(pl_shader sh, int new_depth,
             .height     = lut_size,
             .comps      = 1,
             .fill       = fill_dither_matrix,
-            .signature  = (CACHE_KEY_DITHER ^ method) * lut_size,
+            .signature  = (CACHE_KEY_DITHER ^ lut_method) * lut_size,
+            .shared     = true,
             .cache      = cache ? SH_CACHE(sh) : NULL,
             .priv       = (void *) params,
         ));
@@ -181,7 +190,7 @@ done: ;
         // Transform the screen position to the cyclic range [0,1)
         GLSL("vec2 pos = fract(gl_FragCoord.xy * 1.0/"$"); \n", SH_FLOAT(size));
 
-        if (params->temporal) {
+        if (params->temporal && method != PL_DITHER_BLUE_NOISE_TEMPORAL) {
             int phase = SH_PARAMS(sh).index % 8;
             float r = phase * (M_PI / 2); // rotate
             float m = phase < 4 ? 1 : -1; // mirror
@@ -229,6 +238,16 @@ done: ;
         GLSL("bias = "$"(ivec2(pos * "$"));\n", lut, SH_FLOAT(lut_size));
         break;
 
+    case PL_DITHER_BLUE_NOISE_TEMPORAL: {
+        pl_assert(lut);
+        // Additive recurrence with the golden ratio, i.e. the R1 sequence
+        const double phi = 0.61803398874989484820;
+        const double offset = fmod(SH_PARAMS(sh).index * phi, 1.0);
+        GLSL("bias = fract("$"(ivec2(pos * "$")) + "$");\n",
+             lut, SH_FLOAT(lut_size), SH_FLOAT_DYN(offset));
+        break;
+    }
+
     case PL_DITHER_METHOD_COUNT:
         pl_unreachable();
     }
@@ -348,23 +367,34 @@ bool pl_shader_error_diffusion(pl_shader sh, const struct pl_error_diffusion_par
     //           X    7/16                X    7/16
     //    3/16  5/16  1/16   ==>    0     0    3/16  5/16  1/16
 
+    // When tiling, every work group processes its own tile (plus a margin of
+    // PL_EDF_TILE_MARGIN pixels above and to the left of it, which is dithered
+    // but never written) as if it were a separate image. Otherwise, the one
+    // and only tile covers the whole image.
+    const bool tiled = params->tile_w || params->tile_h;
+    const int tile_w = PL_MIN(PL_DEF(params->tile_w, width), width);
+    const int tile_h = PL_MIN(PL_DEF(params->tile_h, height), height);
+    const int margin = tiled ? PL_EDF_TILE_MARGIN : 0;
+    const int tile_cols = PL_MIN(tile_w + margin, width);
+    const int tile_rows = PL_MIN(tile_h + margin, height);
+
     // Figuring out the size of rectangle containing all shifted pixels.
     // The rectangle height is not changed.
-    int shifted_width = width + (height - 1) * kernel->shift;
+    int shifted_width = tile_cols + (tile_rows - 1) * kernel->shift;
 
     // We process all pixels from the shifted rectangles column by column, with
-    // a single global work group of size |block_size|.
+    // a single work group of size |block_size| per tile.
     // Figuring out how many block are required to process all pixels. We need
     // this explicitly to make the number of barrier() calls match.
-    int block_size = PL_MIN(glsl.max_group_threads, height);
-    int blocks = PL_DIV_UP(height * shifted_width, block_size);
+    int block_size = PL_MIN(glsl.max_group_threads, tile_rows);
+    int blocks = PL_DIV_UP(tile_rows * shifted_width, block_size);
 
     // If we figure out how many of the next columns will be affected while the
     // current columns is being processed. We can store errors of only a few
     // columns in the shared memory. Using a ring buffer will further save the
     // cost while iterating to next column.
     //
-    int ring_buffer_rows = height + PL_EDF_MAX_DY;
+    int ring_buffer_rows = tile_rows + PL_EDF_MAX_DY;
     int ring_buffer_columns = compute_rightmost_shifted_column(kernel) + 1;
     ident_t ring_buffer_size = sh_const(sh, (struct pl_shader_const) {
         .type = PL_VAR_UINT,
@@ -399,16 +429,27 @@ bool pl_shader_error_diffusion(pl_shader sh, const struct pl_error_diffusion_par
     });
 
     sh->output = PL_SHADER_SIG_NONE;
-    sh_describef(sh, "error diffusion (%s, %d bits)",
-                 kernel->name, params->new_depth);
+    sh_describef(sh, "error diffusion (%s, %d bits%s)",
+                 kernel->name, params->new_depth, tiled ? ", tiled" : "");
 
     // Defines the ring buffer in shared memory.
     GLSLH("shared uint err_rgb8["$"]; \n", ring_buffer_size);
-    GLSL("// pl_shader_error_diffusion                                          \n"
-         // Safeguard against accidental over-execution
-         "if (gl_WorkGroupID != uvec3(0))                                       \n"
-         "    return;                                                           \n"
-         // Initialize the ring buffer.
+    GLSL("// pl_shader_error_diffusion                                          \n");
+    if (tiled) {
+        // The tile's own area, and the origin of the (clamped) margin
+        GLSL("const ivec2 tile_size = ivec2(%d, %d);                            \n"
+             "ivec2 tile_lo = ivec2(gl_WorkGroupID.xy) * tile_size;            \n"
+             "ivec2 tile_hi = tile_lo + tile_size;                             \n"
+             "ivec2 base = max(tile_lo - ivec2(%d), ivec2(0));                 \n",
+             tile_w, tile_h, margin);
+    } else {
+        // Safeguard against accidental over-execution
+        GLSL("if (gl_WorkGroupID != uvec3(0))                                   \n"
+             "    return;                                                       \n"
+             "const ivec2 base = ivec2(0);                                      \n");
+    }
+
+    GLSL(// Initialize the ring buffer.
          "for (uint i = gl_LocalInvocationIndex; i < "$"; i+=gl_WorkGroupSize.x)\n"
          "    err_rgb8[i] = 0u;                                                 \n"
 
@@ -422,18 +463,19 @@ bool pl_shader_error_diffusion(pl_shader sh, const struct pl_error_diffusion_par
          "const uint height = "$";                                              \n"
          "int y = int(id %% height), x_shifted = int(id / height);              \n"
          "int x = x_shifted - y * %d;                                           \n"
+         "ivec2 pos = base + ivec2(x, y);                                       \n"
          // Proceed only if we are processing a valid pixel.
-         "if (x >= 0 && x < "$") {                                              \n"
+         "if (x >= 0 && x < "$" && all(lessThan(pos, ivec2("$", "$")))) {       \n"
          // The index that the current pixel have on the ring buffer.
          "uint idx = uint(x_shifted * "$" + y) %% "$";                          \n"
          // Fetch the current pixel.
-         "vec4 pix_orig = texelFetch("$", ivec2(x, y), 0);                      \n"
+         "vec4 pix_orig = texelFetch("$", pos, 0);                              \n"
          "vec3 pix = pix_orig.rgb;                                              \n",
          ring_buffer_size,
          SH_UINT(blocks),
-         SH_UINT(height),
+         SH_UINT(tile_rows),
          kernel->shift,
-         SH_INT(width),
+         SH_INT(tile_cols), SH_INT(width), SH_INT(height),
          SH_INT(ring_buffer_rows),
          ring_buffer_size,
          in_tex);
@@ -472,14 +514,18 @@ bool pl_shader_error_diffusion(pl_shader sh, const struct pl_error_diffusion_par
          "                        int((err_u32 >> %d) & 0xFFu) - 128,           \n"
          "                        int( err_u32        & 0xFFu) - 128) / %d.0;   \n"
          "err_rgb8[idx] = 0u;                                                   \n"
-         // Write the dithered pixel.
+         // Write the dithered pixel, unless it's part of the margin.
          "vec3 dithered = round(pix);                                           \n"
-         "imageStore("$", ivec2(x, y), vec4(dithered / %d.0, pix_orig.a));      \n"
+         "%s"
+         "imageStore("$", pos, vec4(dithered / %d.0, pix_orig.a));              \n"
          // Prepare for error propagation pass
          "vec3 err_divided = (pix - dithered) * %d.0 / %d.0;                    \n"
          "ivec3 tmp;                                                            \n",
          (128u << bitshift_r) | (128u << bitshift_g) | 128u,
          dither_quant, bitshift_r, bitshift_g, uint8_mul,
+         tiled ? "if (all(greaterThanEqual(pos, tile_lo)) &&                  \n"
+                 "    all(lessThan(pos, tile_hi)))                             \n"
+               : "",
          out_img, dither_quant,
          uint8_mul, kernel->divisor);
 
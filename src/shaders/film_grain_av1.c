@@ -529,6 +529,7 @@ struct grain_obj_av1 {
     bool fg_has_y;
     bool fg_has_u;
     bool fg_has_v;
+    int sub_x, sub_y;
 
     // Space to store the temporary arrays, reused
     uint32_t *offsets;
@@ -656,12 +657,14 @@ bool pl_shader_fg_av1(pl_shader sh, pl_shader_obj *grain_state,
                         !pl_color_repr_equal(params->repr, &obj->repr) ||
                         fg_has_y != obj->fg_has_y ||
                         fg_has_u != obj->fg_has_u ||
-                        fg_has_v != obj->fg_has_v;
+                        fg_has_v != obj->fg_has_v ||
+                        sub_x != obj->sub_x ||
+                        sub_y != obj->sub_y;
 
-    if (needs_update) {
-        // This is needed even for chroma, so statically generate it
+    // This is needed even for chroma, unless there is no luma grain at all
+    // (in which case the chroma AR filter has no luma contribution)
+    if (needs_update && data->num_points_y)
         generate_grain_y(obj->grain[0], obj->grain_tmp_y, params);
-    }
 
     ident_t lut[3];
     int idx[3] = {-1};
@@ -686,18 +689,23 @@ bool pl_shader_fg_av1(pl_shader sh, pl_shader_obj *grain_state,
         }
     }
 
-    // Try merging the chroma LUTs into a single texture
+    // Try merging the chroma LUTs into a single texture. The templates only
+    // need to be regenerated when the LUT is actually going to be updated.
     int chroma_comps = 0;
     if (fg_has_u) {
-        generate_grain_uv(&obj->grain[chroma_comps][0][0], obj->grain_tmp_uv,
-                          obj->grain_tmp_y, PL_CHANNEL_CB, sub_x, sub_y,
-                          params);
+        if (needs_update) {
+            generate_grain_uv(&obj->grain[chroma_comps][0][0], obj->grain_tmp_uv,
+                              obj->grain_tmp_y, PL_CHANNEL_CB, sub_x, sub_y,
+                              params);
+        }
         idx[1] = chroma_comps++;
     }
     if (fg_has_v) {
-        generate_grain_uv(&obj->grain[chroma_comps][0][0], obj->grain_tmp_uv,
-                          obj->grain_tmp_y, PL_CHANNEL_CR, sub_x, sub_y,
-                          params);
+        if (needs_update) {
+            generate_grain_uv(&obj->grain[chroma_comps][0][0], obj->grain_tmp_uv,
+                              obj->grain_tmp_y, PL_CHANNEL_CR, sub_x, sub_y,
+                              params);
+        }
         idx[2] = chroma_comps++;
     }
 
@@ -812,6 +820,8 @@ bool pl_shader_fg_av1(pl_shader sh, pl_shader_obj *grain_state,
     obj->fg_has_y = fg_has_y;
     obj->fg_has_u = fg_has_u;
     obj->fg_has_v = fg_has_v;
+    obj->sub_x = sub_x;
+    obj->sub_y = sub_y;
 
     sh_describe(sh, "AV1 film grain");
     GLSL("vec4 color;                   \n"
@@ -17,6 +17,7 @@
 
 #include "shaders.h"
 #include "shaders/film_grain.h"
+#include "pl_thread.h"
 
 static const int8_t Gaussian_LUT[2048+4];
 static const uint32_t Seed_LUT[256];
@@ -31,7 +32,7 @@ static void prng_shift(uint32_t *state)
 }
 
 
-static void generate_slice(float *out, size_t out_width, uint8_t h, uint8_t v,
+static void generate_slice(int8_t *out, size_t out_width, uint8_t h, uint8_t v,
                            int8_t grain[64][64], int16_t tmp[64][64])
 {
     const uint8_t freq_h = ((h + 3) << 2) - 1;
@@ -87,7 +88,7 @@ static void generate_slice(float *out, size_t out_width, uint8_t h, uint8_t v,
         case 0: case 7:
             // Deblock
             for (int x = 0; x < 64; x++)
-                out[x] = ((grain[y][x] * deblock_coeff) >> 7) / 255.0;
+                out[x] = (grain[y][x] * deblock_coeff) >> 7;
             break;
 
         case 1: case 2:
@@ -95,7 +96,7 @@ static void generate_slice(float *out, size_t out_width, uint8_t h, uint8_t v,
         case 5: case 6:
             // No deblock
             for (int x = 0; x < 64; x++)
-                out[x] = grain[y][x] / 255.0;
+                out[x] = grain[y][x];
             break;
 
         default: pl_unreachable();
@@ -105,24 +106,49 @@ static void generate_slice(float *out, size_t out_width, uint8_t h, uint8_t v,
     }
 }
 
-static void fill_grain_lut(void *data, const struct sh_lut_params *params)
+#define DB_SIZE (13 * 64)
+
+// The database only depends on the static tables above, so generate it once
+// per process (in its compact 8-bit form) and share it between all LUTs
+static int8_t grain_db[DB_SIZE][DB_SIZE];
+static bool grain_db_init;
+static pl_static_mutex grain_db_mutex = PL_STATIC_MUTEX_INITIALIZER;
+
+static void init_grain_db(void)
 {
+    pl_static_mutex_lock(&grain_db_mutex);
+    if (grain_db_init)
+        goto done;
+
     struct {
         int8_t grain[64][64];
         int16_t tmp[64][64];
     } *tmp = pl_alloc_ptr(NULL, tmp);
 
-    float *out = data;
-    assert(params->var_type == PL_VAR_FLOAT);
-
     for (int h = 0; h < 13; h++) {
         for (int v = 0; v < 13; v++) {
-            float *slice = out + (h * 64) * params->width + (v * 64);
-            generate_slice(slice, params->width, h, v, tmp->grain, tmp->tmp);
+            int8_t *slice = &grain_db[h * 64][v * 64];
+            generate_slice(slice, DB_SIZE, h, v, tmp->grain, tmp->tmp);
         }
     }
 
     pl_free(tmp);
+    grain_db_init = true;
+
+done:
+    pl_static_mutex_unlock(&grain_db_mutex);
+}
+
+static void fill_grain_lut(void *data, const struct sh_lut_params *params)
+{
+    float *out = data;
+    assert(params->var_type == PL_VAR_FLOAT);
+    assert(params->width == DB_SIZE && params->height == DB_SIZE);
+
+    init_grain_db();
+    const int8_t *db = &grain_db[0][0];
+    for (size_t i = 0; i < DB_SIZE * DB_SIZE; i++)
+        out[i] = db[i] / 255.0f;
 }
 
 bool pl_needs_fg_h274(const struct pl_film_grain_params *params)
@@ -168,8 +194,8 @@ bool pl_shader_fg_h274(pl_shader sh, pl_shader_obj *grain_state,
         .object     = grain_state,
         .var_type   = PL_VAR_FLOAT,
         .lut_type   = SH_LUT_TEXTURE,
-        .width      = 13 * 64,
-        .height     = 13 * 64,
+        .width      = DB_SIZE,
+        .height     = DB_SIZE,
         .comps      = 1,
         .fill       = fill_grain_lut,
         .signature  = CACHE_KEY_H274, // doesn't depend on anything
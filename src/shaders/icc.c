@@ -28,6 +28,23 @@ const struct pl_icc_params pl_icc_default_params = { PL_ICC_DEFAULTS };
 #include <lcms2.h>
 #include <lcms2_plugin.h>
 
+#include "cache.h"
+#include "pl_thread.h"
+#include "pl_thread_pool.h"
+
+// Size of the coarse LUT used while progressively refining
+#define COARSE_SIZE 17
+
+// State of the background refinement of one full-size 3DLUT
+struct icc_refine {
+    pl_icc_object icc;
+    bool decode;
+    pl_thread thread;
+    bool running;   // `thread` was started and must be joined
+    bool done;      // `data` contains the full-size 3DLUT
+    uint16_t *data;
+};
+
 struct icc_priv {
     pl_log log;
     pl_cache cache; // for backwards compatibility
@@ -38,6 +55,11 @@ struct icc_priv {
     cmsCIEXYZ black;
     float gamma_stddev;
     uint64_t lut_sig;
+
+    // Guards `refine`, as well as creating transforms from `profile`/`approx`
+    // (which LittleCMS does not allow concurrently)
+    pl_mutex lock;
+    struct icc_refine refine[2]; // indexed by `decode`
 };
 
 static void error_callback(cmsContext cms, cmsUInt32Number code,
@@ -73,6 +95,19 @@ static pl_cache_obj get_callback(void *priv, uint64_t key)
     };
 }
 
+// Waits for any background refinement to finish and discards its results
+static void refine_stop(pl_icc_object icc)
+{
+    struct icc_priv *p = PL_PRIV(icc);
+    for (int i = 0; i < PL_ARRAY_SIZE(p->refine); i++) {
+        struct icc_refine *ref = &p->refine[i];
+        if (ref->running)
+            pl_thread_join(ref->thread);
+        pl_free(ref->data);
+        *ref = (struct icc_refine) {0};
+    }
+}
+
 void pl_icc_close(pl_icc_object *picc)
 {
     pl_icc_object icc = *picc;
@@ -80,6 +115,8 @@ void pl_icc_close(pl_icc_object *picc)
         return;
 
     struct icc_priv *p = PL_PRIV(icc);
+    refine_stop(icc);
+    pl_mutex_destroy(&p->lock);
     cmsCloseProfile(p->approx);
     cmsCloseProfile(p->profile);
     cmsDeleteContext(p->cms);
@@ -369,6 +406,84 @@ static void infer_clut_size(struct pl_icc_object_t *icc)
             (int) params->size_r, (int) params->size_g, (int) params->size_b);
 }
 
+// Results of the profile analysis, cached by profile signature and params
+struct icc_analysis {
+    struct pl_raw_primaries prim;
+    float max_luma, min_luma;
+    float gamma, gamma_stddev;
+    double black[3];
+    int intent;
+    int size_r, size_g, size_b;
+};
+
+static bool icc_analyze(struct pl_icc_object_t *icc)
+{
+    struct icc_priv *p = PL_PRIV(icc);
+    struct pl_icc_params *params = &icc->params;
+    struct pl_hdr_metadata *hdr = &icc->csp.hdr;
+
+    uint64_t key = CACHE_KEY_ICC_INFO;
+    pl_hash_merge(&key, icc->signature);
+    pl_hash_merge(&key, params->intent);
+    pl_hash_merge(&key, params->size_r);
+    pl_hash_merge(&key, params->size_g);
+    pl_hash_merge(&key, params->size_b);
+    union { double d; uint64_t u; } v = { .d = params->max_luma };
+    pl_hash_merge(&key, v.u);
+
+    struct icc_analysis info;
+    pl_cache_obj obj = { .key = key };
+    if (pl_cache_get(params->cache, &obj) && obj.size == sizeof(info)) {
+        PL_DEBUG(p, "Re-using cached ICC profile analysis (0x%"PRIx64")", key);
+        memcpy(&info, obj.data, sizeof(info));
+        pl_cache_set(params->cache, &obj);
+        hdr->prim       = info.prim;
+        hdr->max_luma   = info.max_luma;
+        hdr->min_luma   = info.min_luma;
+        icc->gamma      = info.gamma;
+        p->gamma_stddev = info.gamma_stddev;
+        p->black        = (cmsCIEXYZ) { info.black[0], info.black[1], info.black[2] };
+        params->intent  = info.intent;
+        params->size_r  = info.size_r;
+        params->size_g  = info.size_g;
+        params->size_b  = info.size_b;
+        return true;
+    }
+
+    if (obj.free)
+        obj.free(obj.data);
+
+    if (!detect_csp(icc, &hdr->prim, &icc->gamma))
+        return false;
+    if (!detect_contrast(icc, hdr, params, params->max_luma))
+        return false;
+    infer_clut_size(icc);
+
+    if (params->cache) {
+        memset(&info, 0, sizeof(info)); // avoid leaking padding into the cache
+        info.prim         = hdr->prim;
+        info.max_luma     = hdr->max_luma;
+        info.min_luma     = hdr->min_luma;
+        info.gamma        = icc->gamma;
+        info.gamma_stddev = p->gamma_stddev;
+        info.black[0]     = p->black.X;
+        info.black[1]     = p->black.Y;
+        info.black[2]     = p->black.Z;
+        info.intent       = params->intent;
+        info.size_r       = params->size_r;
+        info.size_g       = params->size_g;
+        info.size_b       = params->size_b;
+        pl_cache_set(params->cache, &(pl_cache_obj) {
+            .key  = key,
+            .data = pl_memdup(NULL, &info, sizeof(info)),
+            .size = sizeof(info),
+            .free = pl_free,
+        });
+    }
+
+    return true;
+}
+
 static bool icc_init(struct pl_icc_object_t *icc)
 {
     struct icc_priv *p = PL_PRIV(icc);
@@ -377,11 +492,8 @@ static bool icc_init(struct pl_icc_object_t *icc)
         params->intent = cmsGetHeaderRenderingIntent(p->profile);
 
     struct pl_raw_primaries *out_prim = &icc->csp.hdr.prim;
-    if (!detect_csp(icc, out_prim, &icc->gamma))
-        return false;
-    if (!detect_contrast(icc, &icc->csp.hdr, params, params->max_luma))
+    if (!icc_analyze(icc))
         return false;
-    infer_clut_size(icc);
 
     const struct pl_raw_primaries *best = NULL;
     for (enum pl_color_primaries prim = 1; prim < PL_COLOR_PRIM_COUNT; prim++) {
@@ -476,6 +588,7 @@ pl_icc_object pl_icc_open(pl_log log, const struct pl_icc_profile *profile,
     icc->params = params ? *params : pl_icc_default_params;
     icc->signature = profile->signature;
     p->log = log;
+    pl_mutex_init(&p->lock);
     p->cms = cmsCreateContext(NULL, (void *) log);
     if (!p->cms) {
         PL_ERR(p, "Failed creating LittleCMS context!");
@@ -509,6 +622,7 @@ static bool icc_reopen(pl_icc_object kicc, const struct pl_icc_params *params)
 {
     struct pl_icc_object_t *icc = (struct pl_icc_object_t *) kicc;
     struct icc_priv *p = PL_PRIV(icc);
+    refine_stop(icc);
     cmsCloseProfile(p->approx);
     pl_cache_destroy(&p->cache);
 
@@ -521,6 +635,7 @@ static bool icc_reopen(pl_icc_object kicc, const struct pl_icc_params *params)
         .log     = p->log,
         .cms     = p->cms,
         .profile = p->profile,
+        .lock    = p->lock,
     };
 
     PL_DEBUG(p, "Reinitializing ICC profile in-place");
@@ -553,8 +668,11 @@ bool pl_icc_update(pl_log log, pl_icc_object *out_icc,
                   size_r             == icc->params.size_r    &&
                   size_g             == icc->params.size_g    &&
                   size_b             == icc->params.size_b;
-    if (compat)
+    if (compat) {
+        // Doesn't affect the generated 3DLUTs, so just update it in-place
+        ((struct pl_icc_object_t *) icc)->params.progressive = params->progressive;
         return true;
+    }
 
     // ICC signature is the same but parameters are different, re-open in-place
     if (!icc_reopen(icc, params)) {
@@ -566,6 +684,49 @@ bool pl_icc_update(pl_log log, pl_icc_object *out_icc,
     return true;
 }
 
+struct fill_args {
+    pl_icc_object icc;
+    cmsHTRANSFORM tf;
+    uint16_t *data;
+    int s_r, s_g, s_b;
+};
+
+// Fills a single row (fixed green and blue) of the 3DLUT
+static void fill_row(void *priv, int idx)
+{
+    const struct fill_args *args = priv;
+    const int s_r = args->s_r, s_g = args->s_g, s_b = args->s_b;
+    const int g = idx % s_g, b = idx / s_g;
+
+    // Transform a single line of the output buffer
+    uint16_t *tmp = pl_alloc(NULL, s_r * 3 * sizeof(tmp[0]));
+    for (int r = 0; r < s_r; r++) {
+        tmp[r * 3 + 0] = r * 65535 / (s_r - 1);
+        tmp[r * 3 + 1] = g * 65535 / (s_g - 1);
+        tmp[r * 3 + 2] = b * 65535 / (s_b - 1);
+    }
+
+    size_t offset = (b * s_g + g) * s_r * 4;
+    uint16_t *data = args->data + offset;
+    cmsDoTransform(args->tf, tmp, data, s_r);
+
+    // Fix the black point manually. Work-around for "improper" profiles, as
+    // black point compensation should already have taken care of this
+    // normally.
+    const uint16_t knee = 16u << 8;
+    if (args->icc->params.force_bpc && tmp[0] < knee && tmp[1] < knee) {
+        for (int r = 0; r < s_r; r++) {
+            uint16_t s = (2 * tmp[1] + tmp[2] + tmp[r * 3]) >> 2;
+            if (s >= knee)
+                break;
+            for (int c = 0; c < 3; c++)
+                data[r * 3 + c] = (s * data[r * 3 + c] + (knee - s) * s) >> 12;
+        }
+    }
+
+    pl_free(tmp);
+}
+
 static void fill_lut(void *datap, const struct sh_lut_params *params, bool decode)
 {
     pl_icc_object icc = params->priv;
@@ -575,53 +736,34 @@ static void fill_lut(void *datap, const struct sh_lut_params *params, bool decod
     int s_r = params->width, s_g = params->height, s_b = params->depth;
 
     pl_clock_t start = pl_clock_now();
+    pl_mutex_lock(&p->lock);
     cmsHTRANSFORM tf = cmsCreateTransformTHR(p->cms, srcp, TYPE_RGB_16,
                                              dstp, TYPE_RGBA_16,
                                              icc->params.intent,
                                              cmsFLAGS_BLACKPOINTCOMPENSATION |
                                              cmsFLAGS_NOCACHE | cmsFLAGS_NOOPTIMIZE);
+    pl_mutex_unlock(&p->lock);
     if (!tf)
         return;
 
     pl_clock_t after_transform = pl_clock_now();
     pl_log_cpu_time(p->log, start, after_transform, "creating ICC transform");
 
-    uint16_t *tmp = pl_alloc(NULL, s_r * 3 * sizeof(tmp[0]));
-    for (int b = 0; b < s_b; b++) {
-        for (int g = 0; g < s_g; g++) {
-            // Transform a single line of the output buffer
-            for (int r = 0; r < s_r; r++) {
-                tmp[r * 3 + 0] = r * 65535 / (s_r - 1);
-                tmp[r * 3 + 1] = g * 65535 / (s_g - 1);
-                tmp[r * 3 + 2] = b * 65535 / (s_b - 1);
-            }
-
-            size_t offset = (b * s_g + g) * s_r * 4;
-            uint16_t *data = ((uint16_t *) datap) + offset;
-            cmsDoTransform(tf, tmp, data, s_r);
-
-            if (!icc->params.force_bpc)
-                continue;
-
-            // Fix the black point manually. Work-around for "improper"
-            // profiles, as black point compensation should already have
-            // taken care of this normally.
-            const uint16_t knee = 16u << 8;
-            if (tmp[0] >= knee || tmp[1] >= knee)
-                continue;
-            for (int r = 0; r < s_r; r++) {
-                uint16_t s = (2 * tmp[1] + tmp[2] + tmp[r * 3]) >> 2;
-                if (s >= knee)
-                    break;
-                for (int c = 0; c < 3; c++)
-                    data[r * 3 + c] = (s * data[r * 3 + c] + (knee - s) * s) >> 12;
-            }
-        }
-    }
+    // The transform was created with cmsFLAGS_NOCACHE, so it can safely be
+    // shared by all worker threads. Split the work by individual rows rather
+    // than blue slices, since the small LUT sizes picked for well-behaved
+    // profiles would otherwise leave most threads idle.
+    pl_parallel_for(s_g * s_b, fill_row, &(struct fill_args) {
+        .icc  = icc,
+        .tf   = tf,
+        .data = datap,
+        .s_r  = s_r,
+        .s_g  = s_g,
+        .s_b  = s_b,
+    });
 
     pl_log_cpu_time(p->log, after_transform, pl_clock_now(), "generating ICC 3DLUT");
     cmsDeleteTransform(tf);
-    pl_free(tmp);
 }
 
 static void fill_decode(void *datap, const struct sh_lut_params *params)
@@ -640,6 +782,86 @@ static pl_cache get_cache(pl_icc_object icc, pl_shader sh)
     return PL_DEF(icc->params.cache, PL_DEF(p->cache, SH_CACHE(sh)));
 }
 
+static PL_THREAD_VOID refine_thread(void *arg)
+{
+    struct icc_refine *ref = arg;
+    pl_icc_object icc = ref->icc;
+    struct icc_priv *p = PL_PRIV(icc);
+    const int s_r = icc->params.size_r, s_g = icc->params.size_g,
+              s_b = icc->params.size_b;
+
+    uint16_t *data = pl_calloc(NULL, s_r * s_g * s_b, sizeof(uint16_t[4]));
+    fill_lut(data, sh_lut_params(
+        .width  = s_r,
+        .height = s_g,
+        .depth  = s_b,
+        .comps  = 4,
+        .priv   = (void *) icc,
+    ), ref->decode);
+
+    pl_mutex_lock(&p->lock);
+    ref->data = data;
+    ref->done = true;
+    pl_mutex_unlock(&p->lock);
+    PL_DEBUG(p, "Finished refining ICC 3DLUT");
+    PL_THREAD_RETURN();
+}
+
+static void fill_refined(void *datap, const struct sh_lut_params *params)
+{
+    const struct icc_refine *ref = params->priv;
+    memcpy(datap, ref->data, params->width * params->height * params->depth *
+                             sizeof(uint16_t[4]));
+}
+
+// Substitutes a coarse 3DLUT in `lut` while the full-size 3DLUT is still
+// being generated in the background, see `pl_icc_params.progressive`
+static void refine_lut(pl_icc_object icc, bool decode, struct sh_lut_params *lut)
+{
+    struct icc_priv *p = PL_PRIV(icc);
+    if (!icc->params.progressive)
+        return;
+    if (lut->width <= COARSE_SIZE && lut->height <= COARSE_SIZE &&
+        lut->depth <= COARSE_SIZE)
+        return; // nothing to gain
+
+    struct icc_refine *ref = &p->refine[decode];
+    pl_mutex_lock(&p->lock);
+    if (ref->done) {
+        lut->fill = fill_refined;
+        lut->priv = ref;
+        pl_mutex_unlock(&p->lock);
+        return;
+    }
+
+    if (!ref->running) {
+        // Skip refinement if the full-size 3DLUT can be loaded from the cache
+        pl_cache_obj obj = { .key = CACHE_KEY_SH_LUT ^ lut->signature };
+        if (lut->cache && pl_cache_get(lut->cache, &obj)) {
+            pl_cache_set(lut->cache, &obj);
+            pl_mutex_unlock(&p->lock);
+            return;
+        }
+
+        ref->icc = icc;
+        ref->decode = decode;
+        ref->running = pl_thread_create(&ref->thread, refine_thread, ref) == 0;
+        if (!ref->running) {
+            PL_WARN(p, "Failed creating ICC refinement thread, generating "
+                    "3DLUT synchronously");
+            pl_mutex_unlock(&p->lock);
+            return;
+        }
+    }
+    pl_mutex_unlock(&p->lock);
+
+    // The coarse 3DLUT is short-lived, so don't bother caching it
+    lut->width  = PL_MIN(lut->width,  COARSE_SIZE);
+    lut->height = PL_MIN(lut->height, COARSE_SIZE);
+    lut->depth  = PL_MIN(lut->depth,  COARSE_SIZE);
+    lut->cache  = NULL;
+}
+
 void pl_icc_decode(pl_shader sh, pl_icc_object icc, pl_shader_obj *lut_obj,
                    struct pl_color_space *out_csp)
 {
@@ -653,7 +875,7 @@ void pl_icc_decode(pl_shader sh, pl_icc_object icc, pl_shader_obj *lut_obj,
         return;
     }
 
-    ident_t lut = sh_lut(sh, sh_lut_params(
+    struct sh_lut_params lut_params = {
         .object     = lut_obj,
         .var_type   = PL_VAR_FLOAT,
         .method     = SH_LUT_TETRAHEDRAL,
@@ -663,10 +885,15 @@ void pl_icc_decode(pl_shader sh, pl_icc_object icc, pl_shader_obj *lut_obj,
         .depth      = icc->params.size_b,
         .comps      = 4,
         .signature  = p->lut_sig,
+        .shared     = true,
         .fill       = fill_decode,
         .cache      = get_cache(icc, sh),
         .priv       = (void *) icc,
-    ));
+        .debug_tag  = PL_DEBUG_TAG,
+    };
+
+    refine_lut(icc, true, &lut_params);
+    ident_t lut = sh_lut(sh, &lut_params);
 
     if (!lut) {
         SH_FAIL(sh, "pl_icc_decode: failed generating LUT object");
@@ -708,7 +935,7 @@ void pl_icc_encode(pl_shader sh, pl_icc_object icc, pl_shader_obj *lut_obj)
         return;
     }
 
-    ident_t lut = sh_lut(sh, sh_lut_params(
+    struct sh_lut_params lut_params = {
         .object     = lut_obj,
         .var_type   = PL_VAR_FLOAT,
         .method     = SH_LUT_TETRAHEDRAL,
@@ -718,10 +945,15 @@ void pl_icc_encode(pl_shader sh, pl_icc_object icc, pl_shader_obj *lut_obj)
         .depth      = icc->params.size_b,
         .comps      = 4,
         .signature  = ~p->lut_sig, // avoid confusion with decoding LUTs
+        .shared     = true,
         .fill       = fill_encode,
         .cache      = get_cache(icc, sh),
         .priv       = (void *) icc,
-    ));
+        .debug_tag  = PL_DEBUG_TAG,
+    };
+
+    refine_lut(icc, false, &lut_params);
+    ident_t lut = sh_lut(sh, &lut_params);
 
     if (!lut) {
         SH_FAIL(sh, "pl_icc_encode: failed generating LUT object");
@@ -19,6 +19,7 @@
 #include <ctype.h>
 
 #include "shaders.h"
+#include "pl_thread_pool.h"
 
 #include <libplacebo/shaders/lut.h>
 
@@ -27,6 +28,49 @@ static inline bool isnumeric(char c)
     return (c >= '0' && c <= '9') || c == '-';
 }
 
+// Size of the chunks the LUT body is split into for parsing
+#define CUBE_CHUNK_SIZE (64 << 10)
+
+struct cube_chunk {
+    pl_str str;     // input text, split at whitespace boundaries
+    float *vals;    // parsed (unscaled) numbers
+    int num;
+    pl_str rest;    // unparsed remainder of `str` on error
+    pl_str entry;   // value which failed parsing, if any
+};
+
+static inline bool is_cube_digit(uint8_t c)
+{
+    return (c >= '0' && c <= '9') || c == '.' || c == '-' || c == '+' || c == 'e';
+}
+
+static void parse_cube_chunk(void *priv, int idx)
+{
+    struct cube_chunk *chunk = &((struct cube_chunk *) priv)[idx];
+    pl_str str = pl_str_strip(chunk->str);
+
+    // Every number is followed by at least one byte of whitespace
+    chunk->vals = pl_alloc(NULL, (str.len / 2 + 1) * sizeof(float));
+    while (str.len) {
+        // Extract valid digit sequence
+        size_t len = 0;
+        while (len < str.len && is_cube_digit(str.buf[len]))
+            len++;
+
+        pl_str entry = pl_str_take(str, len);
+        if (!len || !pl_str_parse_float(entry, &chunk->vals[chunk->num])) {
+            chunk->rest = str;
+            chunk->entry = entry;
+            return;
+        }
+
+        chunk->num++;
+
+        // Skip whitespace between digits
+        str = pl_str_strip(pl_str_drop(str, len));
+    }
+}
+
 void pl_lut_free(struct pl_custom_lut **lut)
 {
     pl_free_ptr(lut);
@@ -136,46 +180,66 @@ struct pl_custom_lut *pl_lut_parse_cube(pl_log log, const char *cstr, size_t cst
     float *data = pl_alloc(lut, sizeof(float[3]) * entries);
     lut->data = data;
 
-    // Parse LUT body
+    // Parse LUT body, split into chunks (at whitespace) parsed in parallel
     pl_clock_t start = pl_clock_now();
-    for (int n = 0; n < entries; n++) {
-        for (int c = 0; c < 3; c++) {
-            static const char * const digits = "0123456789.-+e";
-
-            // Extract valid digit sequence
-            size_t len = pl_strspn(str, digits);
-            pl_str entry = (pl_str) { str.buf, len };
-            str.buf += len;
-            str.len -= len;
-
-            if (!entry.len) {
-                if (!str.len) {
-                    pl_err(log, "Failed parsing LUT: Unexpected EOF, expected "
-                           "%d entries, got %d", entries * 3, n * 3 + c + 1);
-                } else {
-                    pl_err(log, "Failed parsing LUT: Unexpected '%c', expected "
-                           "digit", str.buf[0]);
-                }
-                goto error;
-            }
+    const int num_chunks = str.len / CUBE_CHUNK_SIZE + 1;
+    struct cube_chunk *chunks = pl_calloc_ptr(NULL, num_chunks, chunks);
+    for (int i = 0; i < num_chunks; i++) {
+        size_t len = PL_MIN(str.len, i < num_chunks - 1 ? CUBE_CHUNK_SIZE : SIZE_MAX);
+        while (len < str.len && !pl_isspace(str.buf[len]))
+            len++;
+        chunks[i].str = pl_str_take(str, len);
+        str = pl_str_drop(str, len);
+    }
 
-            float num;
-            if (!pl_str_parse_float(entry, &num)) {
-                pl_err(log, "Failed parsing float value '%.*s'", PL_STR_FMT(entry));
-                goto error;
-            }
+    pl_parallel_for(num_chunks, parse_cube_chunk, chunks);
 
+    const size_t needed = (size_t) entries * 3;
+    bool ok = true, extra = false;
+    size_t n = 0;
+    for (int i = 0; i < num_chunks; i++) {
+        const struct cube_chunk *chunk = &chunks[i];
+        if (n == needed) {
+            extra |= chunk->num || chunk->rest.len;
+            continue;
+        }
+
+        const int num = PL_MIN(chunk->num, needed - n);
+        for (int j = 0; j < num; j++, n++) {
             // Rescale to range 0.0 - 1.0
-            *data++ = (num - min[c]) / (max[c] - min[c]);
+            const int c = n % 3;
+            data[n] = (chunk->vals[j] - min[c]) / (max[c] - min[c]);
+        }
 
-            // Skip whitespace between digits
-            str = pl_str_strip(str);
+        if (n == needed) {
+            extra |= num < chunk->num || chunk->rest.len;
+        } else if (chunk->rest.len) {
+            if (chunk->entry.len) {
+                pl_err(log, "Failed parsing float value '%.*s'",
+                       PL_STR_FMT(chunk->entry));
+            } else {
+                pl_err(log, "Failed parsing LUT: Unexpected '%c', expected "
+                       "digit", chunk->rest.buf[0]);
+            }
+            ok = false;
+            break;
         }
     }
 
-    str = pl_str_strip(str);
-    if (str.len)
-        pl_warn(log, "Extra data after LUT?... ignoring '%c'", str.buf[0]);
+    if (ok && n < needed) {
+        pl_err(log, "Failed parsing LUT: Unexpected EOF, expected %zu entries, "
+               "got %zu", needed, n);
+        ok = false;
+    }
+
+    if (ok && extra)
+        pl_warn(log, "Extra data after LUT?... ignoring");
+
+    for (int i = 0; i < num_chunks; i++)
+        pl_free(chunks[i].vals);
+    pl_free(chunks);
+    if (!ok)
+        goto error;
 
     pl_log_cpu_time(log, start, pl_clock_now(), "parsing .cube LUT");
     return lut;
@@ -185,6 +249,134 @@ error:
     return NULL;
 }
 
+#define LUT_MAGIC   "pl_lut\0\0"
+#define LUT_VERSION 1
+
+struct __attribute__((__packed__)) lut_header {
+    char     magic[8];
+    uint32_t version;
+    int32_t  size[3];
+    uint64_t signature;
+    float    shaper_in[3][3];
+    float    shaper_out[3][3];
+    uint32_t sys_in, sys_out;
+    uint32_t levels_in, levels_out;
+    uint32_t prim_in, prim_out;
+    uint32_t trc_in, trc_out;
+};
+
+pl_static_assert(sizeof(struct lut_header) % alignof(float) == 0);
+
+static size_t lut_entries(int size_r, int size_g, int size_b)
+{
+    if (size_r > 0 && size_g > 0 && size_b > 0) {
+        if (size_r > 1024 || size_g > 1024 || size_b > 1024)
+            return 0;
+        return (size_t) size_r * size_g * size_b;
+    } else if (size_r > 0 && !size_g && !size_b) {
+        return size_r <= 65536 ? size_r : 0;
+    }
+
+    return 0;
+}
+
+size_t pl_lut_save(const struct pl_custom_lut *lut, uint8_t *out, size_t out_size)
+{
+    const size_t entries = lut_entries(lut->size[0], lut->size[1], lut->size[2]);
+    if (!entries)
+        return 0;
+
+    const size_t data_size = entries * sizeof(float[3]);
+    const size_t total = sizeof(struct lut_header) + data_size;
+    if (!out)
+        return total;
+    if (out_size < total)
+        return 0;
+
+    struct lut_header header = {
+        .magic      = LUT_MAGIC,
+        .version    = LUT_VERSION,
+        .size       = { lut->size[0], lut->size[1], lut->size[2] },
+        .signature  = lut->signature,
+        .sys_in     = lut->repr_in.sys,
+        .sys_out    = lut->repr_out.sys,
+        .levels_in  = lut->repr_in.levels,
+        .levels_out = lut->repr_out.levels,
+        .prim_in    = lut->color_in.primaries,
+        .prim_out   = lut->color_out.primaries,
+        .trc_in     = lut->color_in.transfer,
+        .trc_out    = lut->color_out.transfer,
+    };
+
+    memcpy(header.shaper_in, lut->shaper_in.m, sizeof(header.shaper_in));
+    memcpy(header.shaper_out, lut->shaper_out.m, sizeof(header.shaper_out));
+    memcpy(out, &header, sizeof(header));
+    memcpy(out + sizeof(header), lut->data, data_size);
+    return total;
+}
+
+struct pl_custom_lut *pl_lut_load(pl_log log, const uint8_t *data, size_t size)
+{
+    struct lut_header header;
+    if (size < sizeof(header)) {
+        pl_err(log, "Failed loading LUT: data seems empty or truncated");
+        return NULL;
+    }
+
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, LUT_MAGIC, sizeof(header.magic)) != 0) {
+        pl_err(log, "Failed loading LUT: invalid magic bytes");
+        return NULL;
+    }
+    if (header.version != LUT_VERSION) {
+        pl_err(log, "Failed loading LUT: unsupported version %u", header.version);
+        return NULL;
+    }
+
+    const size_t entries = lut_entries(header.size[0], header.size[1],
+                                       header.size[2]);
+    if (!entries) {
+        pl_err(log, "Failed loading LUT: invalid dimensions %dx%dx%d",
+               header.size[0], header.size[1], header.size[2]);
+        return NULL;
+    }
+
+    const size_t data_size = entries * sizeof(float[3]);
+    if (size - sizeof(header) != data_size) {
+        pl_err(log, "Failed loading LUT: expected %zu bytes of data, got %zu",
+               data_size, size - sizeof(header));
+        return NULL;
+    }
+
+    if (header.sys_in >= PL_COLOR_SYSTEM_COUNT ||
+        header.sys_out >= PL_COLOR_SYSTEM_COUNT ||
+        header.levels_in >= PL_COLOR_LEVELS_COUNT ||
+        header.levels_out >= PL_COLOR_LEVELS_COUNT ||
+        header.prim_in >= PL_COLOR_PRIM_COUNT ||
+        header.prim_out >= PL_COLOR_PRIM_COUNT ||
+        header.trc_in >= PL_COLOR_TRC_COUNT ||
+        header.trc_out >= PL_COLOR_TRC_COUNT)
+    {
+        pl_err(log, "Failed loading LUT: invalid color metadata");
+        return NULL;
+    }
+
+    struct pl_custom_lut *lut = pl_zalloc_ptr(NULL, lut);
+    *lut = (struct pl_custom_lut) {
+        .signature  = header.signature,
+        .size       = { header.size[0], header.size[1], header.size[2] },
+        .repr_in    = { .sys = header.sys_in,  .levels = header.levels_in  },
+        .repr_out   = { .sys = header.sys_out, .levels = header.levels_out },
+        .color_in   = { .primaries = header.prim_in,  .transfer = header.trc_in  },
+        .color_out  = { .primaries = header.prim_out, .transfer = header.trc_out },
+    };
+
+    memcpy(lut->shaper_in.m, header.shaper_in, sizeof(header.shaper_in));
+    memcpy(lut->shaper_out.m, header.shaper_out, sizeof(header.shaper_out));
+    lut->data = pl_memdup(lut, data + sizeof(header), data_size);
+    return lut;
+}
+
 static void fill_lut(void *datap, const struct sh_lut_params *params)
 {
     const struct pl_custom_lut *lut = params->priv;
@@ -305,14 +497,27 @@ struct sh_lut_obj {
 
     // weights, depending on the lut type
     pl_tex tex;
+    bool shared; // `tex` is owned by the `pl_gpu` shared texture registry
+    pl_buf buf;
     pl_str str;
     void *data;
 };
 
+static void release_tex(pl_gpu gpu, struct sh_lut_obj *lut)
+{
+    if (lut->shared) {
+        pl_gpu_shared_tex_release(gpu, &lut->tex);
+        lut->shared = false;
+    } else {
+        pl_tex_destroy(gpu, &lut->tex);
+    }
+}
+
 static void sh_lut_uninit(pl_gpu gpu, void *ptr)
 {
     struct sh_lut_obj *lut = ptr;
-    pl_tex_destroy(gpu, &lut->tex);
+    release_tex(gpu, lut);
+    pl_buf_destroy(gpu, &lut->buf);
     pl_free(lut->str.buf);
     pl_free(lut->data);
 
@@ -436,6 +641,8 @@ next_dim: ; // `continue` out of the inner loop
     }
 
     bool can_uniform = gpu && gpu->limits.max_variable_comps >= size * params->comps;
+    bool can_storage = gpu && gpu->limits.max_ssbo_size >=
+                       size * params->comps * pl_var_type_size(vartype);
     bool can_literal = sh_glsl(sh).version > 110; // needed for literal arrays
     can_literal &= size <= SH_LUT_MAX_LITERAL_HARD && !params->dynamic;
 
@@ -446,6 +653,8 @@ next_dim: ; // `continue` out of the inner loop
         type = SH_LUT_AUTO;
     if (type == SH_LUT_TEXTURE && !texfmt)
         type = SH_LUT_AUTO;
+    if (type == SH_LUT_STORAGE && !can_storage)
+        type = SH_LUT_AUTO;
 
     // Sorted by priority
     if (!type && can_literal && !method && size <= SH_LUT_MAX_LITERAL_SOFT)
@@ -454,6 +663,8 @@ next_dim: ; // `continue` out of the inner loop
         type = SH_LUT_TEXTURE;
     if (!type && can_uniform)
         type = SH_LUT_UNIFORM;
+    if (!type && can_storage)
+        type = SH_LUT_STORAGE;
     if (!type && can_literal)
         type = SH_LUT_LITERAL;
 
@@ -466,6 +677,31 @@ next_dim: ; // `continue` out of the inner loop
     update |= type != lut->type;
     update |= method != lut->method;
 
+    // Immutable texture LUTs with the same contents can be shared between all
+    // shader objects on this GPU, which avoids regenerating and re-uploading
+    // them for every renderer
+    uint64_t share_key = 0;
+    if (params->shared && params->signature && !params->dynamic &&
+        type == SH_LUT_TEXTURE && texdim && texfmt)
+    {
+        const int shape[] = { params->width, params->height, params->depth,
+                              params->comps };
+        share_key = CACHE_KEY_SH_LUT ^ params->signature;
+        pl_hash_merge(&share_key, pl_var_hash(texfmt));
+        pl_hash_merge(&share_key, pl_var_hash(shape));
+    }
+
+    if (update && share_key) {
+        pl_tex tex = pl_gpu_shared_tex_get(gpu, share_key);
+        if (tex) {
+            PL_TRACE(sh, "Re-using shared LUT texture (0x%"PRIx64")", share_key);
+            release_tex(gpu, lut);
+            lut->tex = tex;
+            lut->shared = true;
+            goto updated;
+        }
+    }
+
     if (update) {
         if (params->dynamic)
             pl_log_level_cap(sh->log, PL_LOG_TRACE);
@@ -483,7 +719,9 @@ next_dim: ; // `continue` out of the inner loop
             pl_cache_obj_resize(NULL, &obj, buf_size);
             pl_clock_t start = pl_clock_now();
             params->fill(obj.data, params);
-            pl_log_cpu_time(sh->log, start, pl_clock_now(), "generating shader LUT");
+            pl_clock_t after = pl_clock_now();
+            pl_log_cpu_time(sh->log, start, after, "generating shader LUT");
+            obj.cost = pl_clock_diff(after, start);
         }
 
         pl_assert(obj.data && obj.size);
@@ -515,6 +753,8 @@ next_dim: ; // `continue` out of the inner loop
 
             bool ok;
             if (params->dynamic) {
+                if (lut->shared)
+                    release_tex(gpu, lut);
                 ok = pl_tex_recreate(gpu, &lut->tex, &tex_params);
                 if (ok) {
                     ok = pl_tex_upload(gpu, pl_tex_transfer_params(
@@ -524,9 +764,13 @@ next_dim: ; // `continue` out of the inner loop
                 }
             } else {
                 // Can't use pl_tex_recreate because of `initial_data`
-                pl_tex_destroy(gpu, &lut->tex);
+                release_tex(gpu, lut);
                 lut->tex = pl_tex_create(gpu, &tex_params);
                 ok = lut->tex;
+                if (ok && share_key) {
+                    lut->tex = pl_gpu_shared_tex_add(gpu, share_key, lut->tex);
+                    lut->shared = true;
+                }
             }
 
             if (!ok) {
@@ -541,6 +785,40 @@ next_dim: ; // `continue` out of the inner loop
             lut->data = pl_memdup(NULL, obj.data, obj.size);
             break;
 
+        case SH_LUT_STORAGE: {
+            const uint8_t *old = lut->data, *new = obj.data;
+            bool partial = lut->type == SH_LUT_STORAGE && lut->buf && old &&
+                           lut->buf->params.size == obj.size;
+            if (partial) {
+                // Only re-upload the range of the LUT that actually changed
+                size_t start = 0, end = obj.size;
+                while (start < end && old[start] == new[start])
+                    start++;
+                while (end > start && old[end - 1] == new[end - 1])
+                    end--;
+                start &= ~(size_t) 3; // offset must be aligned
+                if (start < end)
+                    pl_buf_write(gpu, lut->buf, start, new + start, end - start);
+            } else {
+                pl_buf_destroy(gpu, &lut->buf);
+                lut->buf = pl_buf_create(gpu, pl_buf_params(
+                    .size           = obj.size,
+                    .storable       = true,
+                    .host_writable  = true,
+                    .initial_data   = obj.data,
+                    .debug_tag      = params->debug_tag,
+                ));
+                if (!lut->buf) {
+                    PL_ERR(sh, "Failed creating LUT storage buffer!");
+                    goto error;
+                }
+            }
+
+            pl_free(lut->data);
+            lut->data = pl_memdup(NULL, obj.data, obj.size);
+            break;
+        }
+
         case SH_LUT_LITERAL: {
             lut->str.len = 0;
             static const char prefix[PL_VAR_TYPE_COUNT] = {
@@ -588,6 +866,11 @@ next_dim: ; // `continue` out of the inner loop
             pl_unreachable();
         }
 
+        pl_cache_set(params->cache, &obj);
+    }
+
+updated:
+    if (update) {
         lut->type = type;
         lut->method = method;
         lut->vartype = vartype;
@@ -597,12 +880,12 @@ next_dim: ; // `continue` out of the inner loop
         lut->depth = params->depth;
         lut->comps = params->comps;
         lut->signature = params->signature;
-        pl_cache_set(params->cache, &obj);
     }
 
     // Done updating, generate the GLSL
     ident_t name = sh_fresh(sh, "lut");
     ident_t arr_name = NULL_IDENT;
+    const char *arr_brackets = "[]";
 
     static const char * const swizzles[] = {"x", "xy", "xyz", "xyzw"};
     static const char * const vartypes[PL_VAR_TYPE_COUNT][4] = {
@@ -674,6 +957,47 @@ next_dim: ; // `continue` out of the inner loop
         });
         break;
 
+    case SH_LUT_STORAGE: {
+        // Stored as a flat scalar array, to avoid std430 padding of vec3
+        ident_t data = sh_fresh(sh, "lut_data");
+        sh_desc(sh, (struct pl_shader_desc) {
+            .desc = {
+                .name   = "LutBuf",
+                .type   = PL_DESC_BUF_STORAGE,
+                .access = PL_DESC_ACCESS_READONLY,
+            },
+            .binding.object  = lut->buf,
+            .num_buffer_vars = 1,
+            .buffer_vars     = &(struct pl_buffer_var) {
+                .var = {
+                    .name  = sh_ident_tostr(data),
+                    .type  = vartype,
+                    .dim_v = 1,
+                    .dim_m = 1,
+                    .dim_a = size * params->comps,
+                },
+            },
+        });
+
+        if (params->comps == 1) {
+            arr_name = data;
+            break;
+        }
+
+        arr_name = sh_fresh(sh, "lut_fetch");
+        arr_brackets = "()";
+        GLSLH("%s "$"(int idx) {    \n"
+              "    idx *= %d;           \n"
+              "    return %s(",
+              vartypes[vartype][params->comps - 1], arr_name,
+              params->comps, vartypes[vartype][params->comps - 1]);
+        for (int c = 0; c < params->comps; c++)
+            GLSLH("%s"$"[idx + %d]", c > 0 ? ", " : "", data, c);
+        GLSLH(");\n"
+              "}   \n");
+        break;
+    }
+
     case SH_LUT_LITERAL:
         arr_name = sh_fresh(sh, "weights");
         GLSLH("const %s "$"[%d] = %s[](\n  ",
@@ -688,14 +1012,14 @@ next_dim: ; // `continue` out of the inner loop
     }
 
     if (arr_name) {
-        GLSLH("#define "$"(pos) ("$"[int((pos)%s)\\\n",
-              name, arr_name, dims > 1 ? "[0]" : "");
+        GLSLH("#define "$"(pos) ("$"%cint((pos)%s)\\\n",
+              name, arr_name, arr_brackets[0], dims > 1 ? "[0]" : "");
         int shift = params->width;
         for (int i = 1; i < dims; i++) {
             GLSLH("    + %d * int((pos)[%d])\\\n", shift, i);
             shift *= sizes[i];
         }
-        GLSLH("  ])\n");
+        GLSLH("  %c)\n", arr_brackets[1]);
 
         if (is_linear) {
             pl_assert(dims == 1);
@@ -211,10 +211,10 @@ void pl_shader_deband(pl_shader sh, const struct pl_sample_src *src,
          tex, swiz, sh_float_type(mask));
 
     ident_t prng = sh_prng(sh, true, NULL);
-    GLSL("T avg, diff, bound;   \n"
-         "T res = color.%s;     \n"
+    GLSL("%sT avg, diff, bound; \n"
+         "%sT res = color.%s;   \n"
          "vec2 d;               \n",
-         swiz);
+         sh_prec(sh), sh_prec(sh), swiz);
 
     if (params->iterations > 0) {
         ident_t radius = sh_const_float(sh, "radius", params->radius);
@@ -245,7 +245,16 @@ void pl_shader_deband(pl_shader sh, const struct pl_sample_src *src,
             } else {
                 GLSL("res = mix(avg, res, diff > bound); \n");
             }
+
+            // Early out for busy regions, based on the first iteration
+            if (i == 1 && params->adaptive && params->iterations > 1) {
+                GLSL("if (%s) { \n", num_comps > 1 ? "any(lessThanEqual(diff, bound))"
+                                                    : "diff <= bound");
+            }
         }
+
+        if (params->adaptive && params->iterations > 1)
+            GLSL("} \n");
     }
 
     // Add some random noise to smooth out residual differences
@@ -466,6 +475,37 @@ bool pl_shader_sample_oversample(pl_shader sh, const struct pl_sample_src *src,
     return true;
 }
 
+bool pl_shader_sample_box(pl_shader sh, const struct pl_sample_src *src)
+{
+    ident_t tex, pos, pt;
+    float rx, ry, scale;
+    if (!setup_src(sh, src, &tex, &pos, &pt, &rx, &ry, NULL, &scale, true, LINEAR))
+        return false;
+
+    // Each tap averages a 2x2 texel block, so cover the footprint of the
+    // output pixel with one tap per two source texels
+    const float fx = 1.0f / PL_MIN(rx, 1.0f), fy = 1.0f / PL_MIN(ry, 1.0f);
+    const int nx = PL_MAX(1, (int) roundf(fx / 2)), ny = PL_MAX(1, (int) roundf(fy / 2));
+
+    sh_describef(sh, "box downscaling (%dx%d taps)", nx, ny);
+    GLSL("// pl_shader_sample_box                                   \n"
+         "vec4 color = vec4(0.0);                                   \n"
+         "{                                                         \n"
+         "vec2 step = vec2("$", "$") * "$";                         \n"
+         "vec2 base = "$" - 0.5 * vec2(%d.0, %d.0) * step;          \n"
+         "for (int y = 0; y < %d; y++) {                            \n"
+         "    for (int x = 0; x < %d; x++)                          \n"
+         "        color += textureLod("$", base + vec2(x, y) * step, 0.0); \n"
+         "}                                                         \n"
+         "color *= vec4("$");                                       \n"
+         "}                                                         \n",
+         SH_FLOAT(fx / nx), SH_FLOAT(fy / ny), pt,
+         pos, nx - 1, ny - 1, ny, nx, tex,
+         SH_FLOAT(scale / (nx * ny)));
+
+    return true;
+}
+
 static void describe_filter(pl_shader sh, const struct pl_filter_config *cfg,
                             const char *stage, float rx, float ry)
 {
@@ -557,6 +597,7 @@ struct sh_sampler_obj {
     pl_filter filter;
     pl_shader_obj lut;
     pl_shader_obj pass2; // for pl_shader_sample_ortho
+    pl_shader_obj terms[PL_FILTER_MAX_TERMS]; // for separable polar filters
 };
 
 #define SCALER_LUT_SIZE     256
@@ -567,6 +608,8 @@ static void sh_sampler_uninit(pl_gpu gpu, void *ptr)
     struct sh_sampler_obj *obj = ptr;
     pl_shader_obj_destroy(&obj->lut);
     pl_shader_obj_destroy(&obj->pass2);
+    for (int i = 0; i < PL_FILTER_MAX_TERMS; i++)
+        pl_shader_obj_destroy(&obj->terms[i]);
     pl_filter_free(&obj->filter);
     *obj = (struct sh_sampler_obj) {0};
 }
@@ -580,6 +623,162 @@ static void fill_polar_lut(void *data, const struct sh_lut_params *params)
     memcpy(data, filt->weights, params->width * sizeof(float));
 }
 
+static void fill_term_lut(void *data, const struct sh_lut_params *params)
+{
+    const float *weights = params->priv;
+    memcpy(data, weights, params->width * params->height * params->comps * sizeof(float));
+}
+
+// Applies the separable approximation of a polar filter (see
+// `pl_filter_config.separable_terms`). This works like
+// `pl_shader_sample_ortho2_tiled`, except that every fetched texel is
+// convolved with all terms at once, and the results are normalized by the
+// total weight of the approximated 2D kernel. Returns false if unsupported.
+static bool polar_separable(pl_shader sh, struct sh_sampler_obj *obj,
+                            const struct pl_sample_src *src,
+                            const struct pl_filter_config *cfg, bool update,
+                            float rx, float ry, ident_t src_tex, ident_t pos,
+                            ident_t pt, uint8_t comps, float scale)
+{
+    pl_filter filt = obj->filter;
+    const int K = filt->num_terms, N = filt->row_size;
+    const int bw = 32, bh = 8;
+    const int ih = (int) ceilf(bh / ry - 1e-5) + N + 1;
+    const int num_comps = __builtin_popcount(comps);
+    size_t shmem_req = (ih * bw * num_comps * K + 1) * sizeof(float);
+    if (!sh_try_compute(sh, bw, bh, false, shmem_req))
+        return false;
+
+    ident_t lut[PL_FILTER_MAX_TERMS];
+    for (int k = 0; k < K; k++) {
+        lut[k] = sh_lut(sh, sh_lut_params(
+            .object     = &obj->terms[k],
+            .var_type   = PL_VAR_FLOAT,
+            .method     = SH_LUT_LINEAR,
+            .width      = filt->row_stride / 4,
+            .height     = SCALER_LUT_SIZE,
+            .comps      = 4,
+            .update     = update,
+            .fill       = fill_term_lut,
+            .priv       = (void *) filt->terms[k],
+        ));
+
+        if (!lut[k]) {
+            SH_FAIL(sh, "Failed initializing separable term LUT!");
+            return false;
+        }
+    }
+
+    describe_filter(sh, cfg, "polar (separable)", rx, ry);
+
+    const float denom = PL_MAX(1, filt->row_stride / 4 - 1);
+    const char *vtype = sh_float_type(comps), *swizzle = sh_swizzle(comps);
+    ident_t in = sh_fresh(sh, "in"), row = sh_fresh(sh, "row");
+    GLSLH("shared float "$"_base; \n", in);
+    for (int k = 0; k < K; k++) {
+        for (uint8_t cm = comps; cm;) {
+            uint8_t c = __builtin_ctz(cm);
+            GLSLH("shared %sfloat "$"_%d_%d[%d]; \n", sh_prec(sh), in, k, c, ih * bw);
+            cm &= ~(1 << c);
+        }
+
+        GLSLH("%s "$"_%d(int idx) { \n"
+              "return %s(", vtype, row, k, vtype);
+        for (uint8_t cm = comps; cm;) {
+            uint8_t c = __builtin_ctz(cm);
+            cm &= ~(1 << c);
+            GLSLH($"_%d_%d[idx]%s", in, k, c, cm ? ", " : "");
+        }
+        GLSLH("); \n"
+              "} \n");
+    }
+
+    GLSL("// pl_shader_sample_polar (separable)                        \n"
+         "vec4 color = vec4(0.0, 0.0, 0.0, 1.0);                       \n"
+         "{                                                            \n"
+         "vec2 pos = "$", pt = "$";                                    \n"
+         "vec2 size = vec2(textureSize("$", 0));                       \n"
+         "vec2 fcoord = fract(pos * size - vec2(0.5));                 \n"
+         "vec2 base = pos - fcoord * pt - pt * vec2(%d.0);             \n"
+         "%s%s c, acc = %s(0.0);                                       \n"
+         "float wsum = 0.0;                                            \n"
+         "if (gl_LocalInvocationID.xy == uvec2(0u, %s))                \n"
+         "    "$"_base = base.y;                                       \n"
+         "barrier();                                                   \n"
+         "int rel = int(round((base.y - "$"_base) * size.y));          \n"
+         "int col = int(gl_LocalInvocationID.x);                       \n",
+         pos, pt, src_tex, N / 2 - 1, sh_prec(sh), vtype, vtype,
+         src->rect.y0 > src->rect.y1 ? "gl_WorkGroupSize.y - 1u" : "0u",
+         in, in);
+
+    for (int k = 0; k < K; k++)
+        GLSL("vec4 ws%d; %s%s ca%d; \n", k, sh_prec(sh), vtype, k);
+
+    // Horizontal pass: convolve all source rows covered by this work group
+    GLSL("for (int y = int(gl_LocalInvocationID.y); y < %d; y += %d) { \n"
+         "float py = "$"_base + float(y) * pt.y;                         \n",
+         ih, bh, in);
+    for (int k = 0; k < K; k++)
+        GLSL("ca%d = %s(0.0); \n", k, vtype);
+    for (int n = 0; n < N; n++) {
+        for (int k = 0; n % 4 == 0 && k < K; k++) {
+            GLSL("ws%d = "$"(vec2(%f, fcoord.x)); \n",
+                 k, lut[k], (n / 4) / denom);
+        }
+        GLSL("c = textureLod("$", vec2(base.x + pt.x * %d.0, py), 0.0).%s; \n",
+             src_tex, n, swizzle);
+        for (int k = 0; k < K; k++)
+            GLSL("ca%d += ws%d[%d] * c; \n", k, k, n % 4);
+    }
+
+    for (int k = 0; k < K; k++) {
+        for (uint8_t cm = comps, i = 0; cm; i++) {
+            uint8_t c = __builtin_ctz(cm);
+            if (comps == (1 << c)) {
+                GLSL($"_%d_%d[y * %d + col] = ca%d; \n", in, k, c, bw, k);
+            } else {
+                GLSL($"_%d_%d[y * %d + col] = ca%d[%d]; \n", in, k, c, bw, k, i);
+            }
+            cm &= ~(1 << c);
+        }
+    }
+
+    GLSL("}          \n"
+         "barrier(); \n");
+
+    // Vertical pass, reading back the horizontally filtered rows
+    for (int k = 0; k < K; k++)
+        GLSL("ca%d = %s(0.0); \n", k, vtype);
+    for (int n = 0; n < N; n++) {
+        for (int k = 0; k < K; k++) {
+            if (n % 4 == 0) {
+                GLSL("ws%d = "$"(vec2(%f, fcoord.y)); \n",
+                     k, lut[k], (n / 4) / denom);
+            }
+            GLSL("ca%d += ws%d[%d] * "$"_%d((rel + %d) * %d + col); \n",
+                 k, k, n % 4, row, k, n, bw);
+        }
+    }
+
+    // Each row of the LUT stores its own sum right after the weights
+    for (int k = 0; k < K; k++) {
+        const float sign = filt->term_signs[k];
+        GLSL("acc += %s * ca%d; \n"
+             "wsum += %s * "$"(vec2(%f, fcoord.x))[%d] *              \n"
+             "             "$"(vec2(%f, fcoord.y))[%d];               \n",
+             sign < 0 ? "-1.0" : "1.0", k,
+             sign < 0 ? "-1.0" : "1.0",
+             lut[k], (N / 4) / denom, N % 4,
+             lut[k], (N / 4) / denom, N % 4);
+    }
+
+    GLSL("color.%s = "$" / wsum * acc; \n"
+         "}                            \n",
+         swizzle, SH_FLOAT(scale));
+
+    return true;
+}
+
 bool pl_shader_sample_polar(pl_shader sh, const struct pl_sample_src *src,
                             const struct pl_sample_filter_params *params)
 {
@@ -617,6 +816,7 @@ bool pl_shader_sample_polar(pl_shader sh, const struct pl_sample_src *src,
             .config         = cfg,
             .lut_entries    = SCALER_LUT_SIZE,
             .cutoff         = SCALER_LUT_CUTOFF,
+            .row_stride_align = 4, // for the separable terms, if any
         ));
 
         if (!obj->filter) {
@@ -626,6 +826,14 @@ bool pl_shader_sample_polar(pl_shader sh, const struct pl_sample_src *src,
         }
     }
 
+    if (obj->filter->num_terms && !params->no_compute && sh_glsl(sh).compute) {
+        if (polar_separable(sh, obj, src, &cfg, update, rx, ry, src_tex, pos,
+                            pt, cmask, scalef))
+            return true;
+        if (sh->failed)
+            return false;
+    }
+
     describe_filter(sh, &cfg, "polar", rx, ry);
     GLSL("// pl_shader_sample_polar                     \n"
          "vec4 color = vec4(0.0);                       \n"
@@ -636,10 +844,11 @@ bool pl_shader_sample_polar(pl_shader sh, const struct pl_sample_src *src,
          "vec2 base = pos - pt * fcoord;                \n"
          "vec2 center = base + pt * vec2(0.5);          \n"
          "ivec2 offset;                                 \n"
-         "float w, d, wsum = 0.0;                       \n"
+         "float d;                                      \n"
+         "%sfloat w, wsum = 0.0;                        \n"
          "int idx;                                      \n"
-         "vec4 c;                                       \n",
-         pos, pt, src_tex);
+         "%svec4 c;                                     \n",
+         pos, pt, src_tex, sh_prec(sh), sh_prec(sh));
 
     bool use_ar = cfg.antiring > 0;
     if (use_ar) {
@@ -746,7 +955,7 @@ bool pl_shader_sample_polar(pl_shader sh, const struct pl_sample_src *src,
 
         for (uint8_t comps = cmask; comps;) {
             uint8_t c = __builtin_ctz(comps);
-            GLSLH("shared float "$"_%d["$" * "$"]; \n", in, c, sizeh_c, sizew_c);
+            GLSLH("shared %sfloat "$"_%d["$" * "$"]; \n", sh_prec(sh), in, c, sizeh_c, sizew_c);
             GLSL(""$"_%d["$" * y + x] = c[%d]; \n", in, c, sizew_c, c);
             comps &= ~(1 << c);
         }
@@ -794,14 +1003,28 @@ bool pl_shader_sample_polar(pl_shader sh, const struct pl_sample_src *src,
                 if (gathered_cur & bit)
                     continue;
 
-                // Using texture gathering is only more efficient than direct
-                // sampling in the case where we expect to be able to use all
-                // four gathered texels, without having to discard any. So
-                // only do it if we suspect it will be a win rather than a
-                // loss.
+                // Using texture gathering is more efficient than direct
+                // sampling whenever it saves fetches, which it always does
+                // if all four gathered texels are used. Otherwise, compare
+                // the number of texels that may contribute (see
+                // `polar_sample`) against the one gather needed per
+                // component, which still favors gathering at the edges of
+                // the radius for sources with few components.
                 int xx = x*x, xx1 = (x+1)*(x+1);
                 int yy = y*y, yy1 = (y+1)*(y+1);
                 bool use_gather = PL_MAX(xx, xx1) + PL_MAX(yy, yy1) < radius2;
+                if (!use_gather) {
+                    int useful = 0;
+                    for (int p = 0; p < 4; p++) {
+                        int px = x + (p & 1), py = y + (p >> 1);
+                        if (px > bound || py > bound)
+                            continue;
+                        int dx = px > 0 ? px - 1 : px;
+                        int dy = py > 0 ? py - 1 : py;
+                        useful += dx * dx + dy * dy < radius2;
+                    }
+                    use_gather = useful > num_comps;
+                }
                 use_gather &= PL_MAX(x, y) <= sh_glsl(sh).max_gather_offset;
                 use_gather &= PL_MIN(x, y) >= sh_glsl(sh).min_gather_offset;
                 use_gather &= !src->tex || src->tex->params.format->gatherable;
@@ -922,6 +1145,63 @@ enum {
     SEP_PASSES
 };
 
+// (Re)generates the filter for one direction of a separable filter
+static bool ortho_update_filter(pl_shader sh, struct sh_sampler_obj *obj,
+                                const struct pl_sample_filter_params *params,
+                                float ratio, struct pl_filter_config *out_cfg,
+                                bool *out_update)
+{
+    pl_gpu gpu = SH_GPU(sh);
+    float inv_scale = 1.0 / ratio;
+    inv_scale = PL_MAX(inv_scale, 1.0);
+    if (params->no_widening)
+        inv_scale = 1.0;
+
+    struct pl_filter_config cfg = params->filter;
+    cfg.antiring = PL_DEF(cfg.antiring, params->antiring);
+    cfg.blur = PL_DEF(cfg.blur, 1.0f) * inv_scale;
+    bool update = !obj->filter || !pl_filter_config_eq(&obj->filter->params.config, &cfg);
+
+    if (update) {
+        pl_filter_free(&obj->filter);
+        obj->filter = pl_filter_generate(sh->log, pl_filter_params(
+            .config             = cfg,
+            .lut_entries        = SCALER_LUT_SIZE,
+            .max_row_size       = gpu->limits.max_tex_2d_dim / 4,
+            .row_stride_align   = 4,
+        ));
+
+        if (!obj->filter) {
+            // This should never happen, but just in case ..
+            SH_FAIL(sh, "Failed initializing separated filter!");
+            return false;
+        }
+    }
+
+    *out_cfg = cfg;
+    *out_update = update;
+    return true;
+}
+
+static ident_t ortho_lut(pl_shader sh, struct sh_sampler_obj *obj, bool update)
+{
+    ident_t lut = sh_lut(sh, sh_lut_params(
+        .object     = &obj->lut,
+        .var_type   = PL_VAR_FLOAT,
+        .method     = SH_LUT_LINEAR,
+        .width      = obj->filter->row_stride / 4,
+        .height     = SCALER_LUT_SIZE,
+        .comps      = 4,
+        .update     = update,
+        .fill       = fill_ortho_lut,
+        .priv       = obj,
+    ));
+
+    if (!lut)
+        SH_FAIL(sh, "Failed initializing separated LUT!");
+    return lut;
+}
+
 bool pl_shader_sample_ortho2(pl_shader sh, const struct pl_sample_src *src,
                              const struct pl_sample_filter_params *params)
 {
@@ -976,49 +1256,16 @@ bool pl_shader_sample_ortho2(pl_shader sh, const struct pl_sample_src *src,
         assert(obj);
     }
 
-    float inv_scale = 1.0 / ratio[pass];
-    inv_scale = PL_MAX(inv_scale, 1.0);
-    if (params->no_widening)
-        inv_scale = 1.0;
-
-    struct pl_filter_config cfg = params->filter;
-    cfg.antiring = PL_DEF(cfg.antiring, params->antiring);
-    cfg.blur = PL_DEF(cfg.blur, 1.0f) * inv_scale;
-    bool update = !obj->filter || !pl_filter_config_eq(&obj->filter->params.config, &cfg);
-
-    if (update) {
-        pl_filter_free(&obj->filter);
-        obj->filter = pl_filter_generate(sh->log, pl_filter_params(
-            .config             = cfg,
-            .lut_entries        = SCALER_LUT_SIZE,
-            .max_row_size       = gpu->limits.max_tex_2d_dim / 4,
-            .row_stride_align   = 4,
-        ));
-
-        if (!obj->filter) {
-            // This should never happen, but just in case ..
-            SH_FAIL(sh, "Failed initializing separated filter!");
-            return false;
-        }
-    }
+    struct pl_filter_config cfg;
+    bool update;
+    if (!ortho_update_filter(sh, obj, params, ratio[pass], &cfg, &update))
+        return false;
 
     int N = obj->filter->row_size; // number of samples to convolve
     int width = obj->filter->row_stride / 4; // width of the LUT texture
-    ident_t lut = sh_lut(sh, sh_lut_params(
-        .object     = &obj->lut,
-        .var_type   = PL_VAR_FLOAT,
-        .method     = SH_LUT_LINEAR,
-        .width      = width,
-        .height     = SCALER_LUT_SIZE,
-        .comps      = 4,
-        .update     = update,
-        .fill       = fill_ortho_lut,
-        .priv       = obj,
-    ));
-    if (!lut) {
-        SH_FAIL(sh, "Failed initializing separated LUT!");
+    ident_t lut = ortho_lut(sh, obj, update);
+    if (!lut)
         return false;
-    }
 
     const int dir[SEP_PASSES][2] = {
         [SEP_HORIZ] = {1, 0},
@@ -1036,6 +1283,7 @@ bool pl_shader_sample_ortho2(pl_shader sh, const struct pl_sample_src *src,
     bool use_ar = cfg.antiring > 0 && ratio[pass] > 1.0;
     bool use_linear = obj->filter->radius == obj->filter->radius_zero;
     use_ar &= !use_linear; // filter has no negative weights
+    bool low_prec = sh_prec(sh)[0];
 
 #pragma GLSL /* pl_shader_sample_ortho */                                       \
     vec4 color = vec4(0.0, 0.0, 0.0, 1.0);                                      \
@@ -1049,7 +1297,11 @@ bool pl_shader_sample_ortho2(pl_shader sh, const struct pl_sample_src *src,
     vec2 base = pos - fcoord * pt - pt * vec2(${const float: N / 2 - 1});       \
     vec4 ws;                                                                    \
     float off;                                                                  \
-    ${vecType: comps} c, ca = ${vecType: comps}(0.0);                           \
+    @if (low_prec) {                                                            \
+        mediump ${vecType: comps} c, ca = ${vecType: comps}(0.0);               \
+    @} else {                                                                   \
+        ${vecType: comps} c, ca = ${vecType: comps}(0.0);                       \
+    @}                                                                          \
     @if (use_ar) {                                                              \
         ${vecType: comps} hi = ${vecType: comps}(0.0);                          \
         ${vecType: comps} lo = ${vecType: comps}(1e9);                          \
@@ -1083,6 +1335,221 @@ bool pl_shader_sample_ortho2(pl_shader sh, const struct pl_sample_src *src,
     return true;
 }
 
+// Emits a 1D convolution into `ca`, as part of `pl_shader_sample_ortho2_tiled`.
+// The horizontal pass samples directly from `tex`, while the vertical pass
+// reads back the horizontally filtered rows from shmem via `row`.
+static void ortho_conv(pl_shader sh, pl_filter filter, ident_t lut, bool vert,
+                       ident_t tex, ident_t row, int bw, uint8_t comps,
+                       bool use_ar)
+{
+    const int N = filter->row_size;
+    const float denom = PL_MAX(1, filter->row_stride / 4 - 1);
+    const bool use_linear = filter->radius == filter->radius_zero;
+    const char *swizzle = sh_swizzle(comps);
+    const char *vtype = sh_float_type(comps);
+
+    GLSL("ca = %s(0.0); \n", vtype);
+    if (use_ar) {
+        GLSL("lo = %s(1e9); \n"
+             "hi = %s(0.0); \n",
+             vtype, vtype);
+    }
+
+    for (int n = 0; n < N; n++) {
+        if (n % 4 == 0) {
+            GLSL("ws = "$"(vec2(%f, fcoord.%c)); \n",
+                 lut, (n / 4) / denom, vert ? 'y' : 'x');
+        }
+
+        if (use_linear) {
+            // Filter has no negative weights, so we can use the linear
+            // resampling trick (see `fill_ortho_lut`)
+            if (n % 2)
+                continue;
+            if (vert) {
+                GLSL("ca += ws[%d] * mix("$"((rel + %d) * %d + col), "
+                     ""$"((rel + %d) * %d + col), ws[%d]); \n",
+                     n % 4, row, n, bw, row, n + 1, bw, n % 4 + 1);
+            } else {
+                GLSL("off = %d.0 + ws[%d]; \n"
+                     "ca += ws[%d] * textureLod("$", vec2(base.x + pt.x * off, py), "
+                     "0.0).%s; \n",
+                     n, n % 4 + 1, n % 4, tex, swizzle);
+            }
+            continue;
+        }
+
+        if (vert) {
+            GLSL("c = "$"((rel + %d) * %d + col); \n", row, n, bw);
+        } else {
+            GLSL("c = textureLod("$", vec2(base.x + pt.x * %d.0, py), 0.0).%s; \n",
+                 tex, n, swizzle);
+        }
+
+        GLSL("ca += ws[%d] * c; \n", n % 4);
+        if (use_ar && (n == N / 2 - 1 || n == N / 2)) {
+            GLSL("lo = min(lo, c); \n"
+                 "hi = max(hi, c); \n");
+        }
+    }
+
+    if (use_ar)
+        GLSL("ca = mix(ca, clamp(ca, lo, hi), "$"); \n",
+             SH_FLOAT(filter->params.config.antiring));
+}
+
+bool pl_shader_sample_ortho2_tiled(pl_shader sh, const struct pl_sample_src *src,
+                                   const struct pl_sample_filter_params *params)
+{
+    pl_assert(params);
+    if (params->filter.polar) {
+        SH_FAIL(sh, "Trying to use separated sampling with a polar filter?");
+        return false;
+    }
+
+    if (params->no_compute || !sh_glsl(sh).compute)
+        return false;
+
+    pl_gpu gpu = SH_GPU(sh);
+    pl_assert(gpu);
+
+    // Figure out the scaling ratios up-front, since `setup_src` already
+    // modifies the shader
+    float src_w = src->tex ? pl_rect_w(src->rect) : src->sampled_w;
+    float src_h = src->tex ? pl_rect_h(src->rect) : src->sampled_h;
+    src_w = PL_DEF(src_w, src_params(src).w);
+    src_h = PL_DEF(src_h, src_params(src).h);
+    int out_w = PL_DEF(src->new_w, roundf(fabs(src_w)));
+    int out_h = PL_DEF(src->new_h, roundf(fabs(src_h)));
+
+    float ratio[SEP_PASSES];
+    ratio[SEP_HORIZ] = out_w / fabs(src_w);
+    ratio[SEP_VERT]  = out_h / fabs(src_h);
+
+    // Use the same sampler objects as `pl_shader_sample_ortho2` would
+    struct sh_sampler_obj *obj[SEP_PASSES];
+    obj[SEP_VERT] = SH_OBJ(sh, params->lut, PL_SHADER_OBJ_SAMPLER,
+                           struct sh_sampler_obj, sh_sampler_uninit);
+    if (!obj[SEP_VERT])
+        return false;
+    obj[SEP_HORIZ] = SH_OBJ(sh, &obj[SEP_VERT]->pass2, PL_SHADER_OBJ_SAMPLER,
+                            struct sh_sampler_obj, sh_sampler_uninit);
+    assert(obj[SEP_HORIZ]);
+
+    struct pl_filter_config cfg[SEP_PASSES];
+    bool update[SEP_PASSES];
+    for (int p = 0; p < SEP_PASSES; p++) {
+        if (!ortho_update_filter(sh, obj[p], params, ratio[p], &cfg[p], &update[p]))
+            return false;
+    }
+
+    // Each work group first convolves all source rows covered by its output
+    // tile horizontally, storing the results in shmem, and then convolves
+    // those vertically. The extra margin on the ceilf guards against floating
+    // point inaccuracy on near-integer scaling ratios.
+    const int bw = 32, bh = 8;
+    const int NH = obj[SEP_HORIZ]->filter->row_size,
+              NV = obj[SEP_VERT]->filter->row_size;
+    const int ih = (int) ceilf(bh / ratio[SEP_VERT] - 1e-5) + NV + 1;
+    int max_comps = src->component_mask ? __builtin_popcount(src->component_mask)
+                                        : PL_DEF(src->components, 4);
+    max_comps = PL_MIN(max_comps, 4);
+    size_t shmem_req = (ih * bw * max_comps + 1) * sizeof(float);
+    if (!sh_try_compute(sh, bw, bh, false, shmem_req))
+        return false;
+
+    uint8_t comps;
+    float scale;
+    ident_t src_tex, pos, pt;
+    if (!setup_src(sh, src, &src_tex, &pos, &pt, NULL, NULL, &comps, &scale,
+                   false, LINEAR))
+        return false;
+    pl_assert(__builtin_popcount(comps) <= max_comps);
+
+    ident_t lut[SEP_PASSES];
+    for (int p = 0; p < SEP_PASSES; p++) {
+        if (!(lut[p] = ortho_lut(sh, obj[p], update[p])))
+            return false;
+    }
+
+    describe_filter(sh, &cfg[SEP_HORIZ], "ortho (tiled)",
+                    ratio[SEP_HORIZ], ratio[SEP_VERT]);
+
+    bool use_ar[SEP_PASSES];
+    for (int p = 0; p < SEP_PASSES; p++) {
+        pl_filter filt = obj[p]->filter;
+        use_ar[p] = cfg[p].antiring > 0 && ratio[p] > 1.0;
+        use_ar[p] &= filt->radius != filt->radius_zero;
+    }
+
+    // Set up the shmem arrays, plus a helper to read back a filtered texel
+    const char *vtype = sh_float_type(comps);
+    ident_t in = sh_fresh(sh, "in"), row = sh_fresh(sh, "row");
+    GLSLH("shared float "$"_base; \n", in);
+    for (uint8_t cm = comps; cm;) {
+        uint8_t c = __builtin_ctz(cm);
+        GLSLH("shared %sfloat "$"_%d[%d]; \n", sh_prec(sh), in, c, ih * bw);
+        cm &= ~(1 << c);
+    }
+
+    GLSLH("%s "$"(int idx) { \n"
+          "return %s(", vtype, row, vtype);
+    for (uint8_t cm = comps; cm;) {
+        uint8_t c = __builtin_ctz(cm);
+        cm &= ~(1 << c);
+        GLSLH($"_%d[idx]%s", in, c, cm ? ", " : "");
+    }
+    GLSLH("); \n"
+          "} \n");
+
+    GLSL("// pl_shader_sample_ortho2_tiled                             \n"
+         "vec4 color = vec4(0.0, 0.0, 0.0, 1.0);                       \n"
+         "{                                                            \n"
+         "vec2 pos = "$", pt = "$";                                    \n"
+         "vec2 size = vec2(textureSize("$", 0));                       \n"
+         "vec2 fcoord = fract(pos * size - vec2(0.5));                 \n"
+         "vec2 base = pos - fcoord * pt - pt * vec2(%d.0, %d.0);       \n"
+         "vec4 ws;                                                     \n"
+         "float off;                                                   \n"
+         "%s%s c, ca;                                                  \n"
+         "%s lo, hi;                                                   \n"
+         "if (gl_LocalInvocationID.xy == uvec2(0u, %s))                \n"
+         "    "$"_base = base.y;                                       \n"
+         "barrier();                                                   \n"
+         "int rel = int(round((base.y - "$"_base) * size.y));          \n"
+         "int col = int(gl_LocalInvocationID.x);                       \n"
+         "for (int y = int(gl_LocalInvocationID.y); y < %d; y += %d) { \n"
+         "float py = "$"_base + float(y) * pt.y;                       \n",
+         pos, pt, src_tex, NH / 2 - 1, NV / 2 - 1, sh_prec(sh), vtype, vtype,
+         src->rect.y0 > src->rect.y1 ? "gl_WorkGroupSize.y - 1u" : "0u",
+         in, in, ih, bh, in);
+
+    ortho_conv(sh, obj[SEP_HORIZ]->filter, lut[SEP_HORIZ], false, src_tex,
+               row, bw, comps, use_ar[SEP_HORIZ]);
+
+    for (uint8_t cm = comps, i = 0; cm; i++) {
+        uint8_t c = __builtin_ctz(cm);
+        if (comps == (1 << c)) {
+            GLSL($"_%d[y * %d + col] = ca; \n", in, c, bw);
+        } else {
+            GLSL($"_%d[y * %d + col] = ca[%d]; \n", in, c, bw, i);
+        }
+        cm &= ~(1 << c);
+    }
+
+    GLSL("}          \n"
+         "barrier(); \n");
+
+    ortho_conv(sh, obj[SEP_VERT]->filter, lut[SEP_VERT], true, src_tex,
+               row, bw, comps, use_ar[SEP_VERT]);
+
+    GLSL("color.%s = "$" * ca; \n"
+         "}                   \n",
+         sh_swizzle(comps), SH_FLOAT(scale));
+
+    return true;
+}
+
 const struct pl_distort_params pl_distort_default_params = { PL_DISTORT_DEFAULTS };
 
 void pl_shader_distort(pl_shader sh, pl_tex src_tex, int out_w, int out_h,
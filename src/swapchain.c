@@ -15,6 +15,8 @@
  * License along with libplacebo. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <math.h>
+
 #include "common.h"
 #include "log.h"
 #include "swapchain.h"
@@ -79,6 +81,13 @@ bool pl_swapchain_start_frame(pl_swapchain sw,
     return impl->start_frame(sw, out_frame);
 }
 
+void pl_swapchain_damage(pl_swapchain sw, const pl_rect2d *rects, int num_rects)
+{
+    const struct pl_sw_fns *impl = PL_PRIV(sw);
+    if (impl->damage)
+        impl->damage(sw, rects, num_rects);
+}
+
 bool pl_swapchain_submit_frame(pl_swapchain sw)
 {
     const struct pl_sw_fns *impl = PL_PRIV(sw);
@@ -90,3 +99,69 @@ void pl_swapchain_swap_buffers(pl_swapchain sw)
     const struct pl_sw_fns *impl = PL_PRIV(sw);
     impl->swap_buffers(sw);
 }
+
+bool pl_swapchain_get_timing(pl_swapchain sw, struct pl_swapchain_timing *out)
+{
+    *out = (struct pl_swapchain_timing) {0};
+
+    const struct pl_sw_fns *impl = PL_PRIV(sw);
+    if (!impl->get_timing)
+        return false;
+
+    return impl->get_timing(sw, out);
+}
+
+bool pl_swapchain_wait_presented(pl_swapchain sw, int max_queued,
+                                 uint64_t timeout)
+{
+    const struct pl_sw_fns *impl = PL_PRIV(sw);
+    if (!impl->wait_presented)
+        return false;
+
+    return impl->wait_presented(sw, max_queued, timeout);
+}
+
+void pl_sw_timing_push(struct pl_sw_timing *t, double time, int64_t count)
+{
+    if (t->presented++ && time > t->last_time) {
+        double delta = time - t->last_time;
+        int64_t vsyncs = 0;
+        if (count >= 0 && t->last_count >= 0) {
+            vsyncs = count - t->last_count;
+        } else if (t->nominal > 0) {
+            vsyncs = llround(delta / t->nominal);
+        }
+
+        // Discard samples from discontinuities, e.g. after a mode switch or
+        // the window being hidden
+        float sample = vsyncs > 0 ? delta / vsyncs : 0.0f;
+        if (sample > 0 && t->nominal > 0 && fabsf(sample / t->nominal - 1.0f) > 0.1f)
+            sample = 0.0f;
+
+        if (sample > 0) {
+            static const float smoothing = 0.05f;
+            t->estimate = t->estimate ? t->estimate + smoothing * (sample - t->estimate)
+                                      : sample;
+        }
+    }
+
+    t->last_time = time;
+    t->last_count = count;
+}
+
+bool pl_sw_timing_get(const struct pl_sw_timing *t, double now,
+                      struct pl_swapchain_timing *out)
+{
+    float vsync = PL_DEF(t->estimate, t->nominal);
+    if (!t->presented || !vsync)
+        return false;
+
+    out->frames_presented = t->presented;
+    out->vsync_duration = vsync;
+    if (now > 0 && now >= t->last_time) {
+        double phase = fmod(now - t->last_time, vsync);
+        out->next_vsync = vsync - phase;
+    }
+
+    return true;
+}
@@ -33,7 +33,32 @@ struct pl_sw_fns {
     SW_PFN(resize); // optional
     SW_PFN(colorspace_hint); // optional
     SW_PFN(start_frame);
+    SW_PFN(damage); // optional
     SW_PFN(submit_frame);
     SW_PFN(swap_buffers);
+    SW_PFN(get_timing); // optional
+    SW_PFN(wait_presented); // optional
 };
 #undef SW_PFN
+
+// Helper for implementing `get_timing` on top of raw presentation feedback.
+// Not thread-safe, implementations must provide their own locking.
+struct pl_sw_timing {
+    float nominal;          // nominal refresh duration (seconds), or 0
+    float estimate;         // measured refresh duration (seconds)
+    double last_time;       // timestamp of the last presentation (seconds)
+    int64_t last_count;     // refresh counter at `last_time`, or -1
+    uint64_t presented;     // number of presentations recorded
+};
+
+// Record the presentation of a frame at `time` (seconds, in an arbitrary but
+// consistent time base). `count` is the value of the display's refresh
+// counter at that time, or -1 if unavailable, in which case the number of
+// elapsed refresh cycles is inferred from `nominal`.
+void pl_sw_timing_push(struct pl_sw_timing *t, double time, int64_t count);
+
+// Fill in `out` based on the recorded feedback. `now` is the current time in
+// the same time base as `pl_sw_timing_push`, or 0 if unknown. Returns false
+// if no usable feedback has been recorded yet.
+bool pl_sw_timing_get(const struct pl_sw_timing *t, double now,
+                      struct pl_swapchain_timing *out);
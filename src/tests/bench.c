@@ -1,11 +1,22 @@
 #include "tests.h"
 
 #include <libplacebo/dispatch.h>
-#include <libplacebo/vulkan.h>
 #include <libplacebo/shaders/colorspace.h>
 #include <libplacebo/shaders/deinterlacing.h>
 #include <libplacebo/shaders/sampling.h>
 
+#ifdef PL_HAVE_VK_PROC_ADDR
+#include <libplacebo/vulkan.h>
+#endif
+
+#ifdef PL_HAVE_OPENGL
+#include "opengl/common.h"
+#endif
+
+#ifdef PL_HAVE_D3D11
+#include <libplacebo/d3d11.h>
+#endif
+
 enum {
     // Image configuration
     NUM_TEX     = 16,
@@ -92,6 +103,102 @@ static void run_bench(pl_gpu gpu, pl_dispatch dp,
     }
 }
 
+// Output configuration, see `usage()`
+enum format {
+    FMT_TEXT,
+    FMT_CSV,
+    FMT_JSON,
+};
+
+struct baseline {
+    char backend[32];
+    char name[64];
+    double ms;
+};
+
+static struct {
+    enum format format;
+    const char *backend;
+    int num_results;
+    struct baseline *baseline;
+    int num_baseline;
+} out;
+
+// Loads a baseline previously written by `--format csv`
+static bool load_baseline(const char *path)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        fprintf(stderr, "Failed opening baseline '%s'\n", path);
+        return false;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), fp)) {
+        struct baseline b;
+        if (sscanf(line, "%31[^,],%63[^,],%*u,%*f,%lf", b.backend, b.name, &b.ms) != 3)
+            continue; // header or malformed line
+        out.baseline = realloc(out.baseline, (out.num_baseline + 1) * sizeof(b));
+        REQUIRE(out.baseline);
+        out.baseline[out.num_baseline++] = b;
+    }
+
+    fclose(fp);
+    return true;
+}
+
+static const struct baseline *find_baseline(const char *name)
+{
+    for (int i = 0; i < out.num_baseline; i++) {
+        const struct baseline *b = &out.baseline[i];
+        if (strcmp(b->backend, out.backend) == 0 && strcmp(b->name, name) == 0)
+            return b;
+    }
+
+    return NULL;
+}
+
+static void report(const char *name, unsigned long frames, double secs,
+                   double gpu_ms)
+{
+    const double ms = 1000 * secs / frames;
+    const struct baseline *b = find_baseline(name);
+    const double delta = b ? 100.0 * (ms - b->ms) / b->ms : 0.0;
+
+    switch (out.format) {
+    case FMT_TEXT:
+        printf("'%s':\t%4lu frames in %1.6f seconds => %2.6f ms/frame (%5.2f FPS)",
+              name, frames, secs, ms, frames / secs);
+        if (gpu_ms)
+            printf(", gpu time: %2.6f ms", gpu_ms);
+        if (b)
+            printf(", vs. baseline: %+.2f%%", delta);
+        printf("\n");
+        break;
+
+    case FMT_CSV:
+        if (!out.num_results)
+            printf("backend,name,frames,seconds,ms_per_frame,gpu_ms,baseline_ms\n");
+        printf("%s,%s,%lu,%f,%f,%f,", out.backend, name, frames, secs, ms, gpu_ms);
+        if (b)
+            printf("%f", b->ms);
+        printf("\n");
+        break;
+
+    case FMT_JSON:
+        printf("%s\n  { \"backend\": \"%s\", \"name\": \"%s\", \"frames\": %lu, "
+               "\"seconds\": %f, \"ms_per_frame\": %f, \"gpu_ms\": %f",
+               out.num_results ? "," : "[", out.backend, name, frames, secs,
+               ms, gpu_ms);
+        if (b)
+            printf(", \"baseline_ms\": %f", b->ms);
+        printf(" }");
+        break;
+    }
+
+    out.num_results++;
+}
+
 static void benchmark(pl_gpu gpu, const char *name,
                       const struct bench *bench)
 {
@@ -171,12 +278,8 @@ static void benchmark(pl_gpu gpu, const char *name,
     }
 
     frames -= frames_warmup;
-    double secs = pl_clock_diff(stop, start_test);
-    printf("'%s':\t%4lu frames in %1.6f seconds => %2.6f ms/frame (%5.2f FPS)",
-          name, frames, secs, 1000 * secs / frames, frames / secs);
-    if (gputime_count)
-        printf(", gpu time: %2.6f ms", 1e-6 * gputime_total / gputime_count);
-    printf("\n");
+    report(name, frames, pl_clock_diff(stop, start_test),
+           gputime_count ? 1e-6 * gputime_total / gputime_count : 0.0);
 
     pl_timer_destroy(gpu, &timer);
     pl_shader_obj_destroy(&state);
@@ -202,6 +305,17 @@ static void bench_deband_heavy(pl_shader sh, pl_shader_obj *state, pl_tex src)
     ));
 }
 
+static void bench_deband_adaptive(pl_shader sh, pl_shader_obj *state, pl_tex src)
+{
+    pl_shader_deband(sh, pl_sample_src( .tex = src ), pl_deband_params(
+        .iterations = 4,
+        .threshold  = 4.0,
+        .radius     = 4.0,
+        .grain      = 16.0,
+        .adaptive   = true,
+    ));
+}
+
 static void bench_bilinear(pl_shader sh, pl_shader_obj *state, pl_tex src)
 {
     REQUIRE(pl_shader_sample_bilinear(sh, pl_sample_src( .tex = src )));
@@ -279,6 +393,14 @@ static void bench_hdr_peak_hq(pl_shader sh, pl_shader_obj *state, pl_tex src)
     REQUIRE(pl_shader_detect_peak(sh, pl_color_space_hdr10, state, &pl_peak_detect_high_quality_params));
 }
 
+static void bench_hdr_peak_strided(pl_shader sh, pl_shader_obj *state, pl_tex src)
+{
+    REQUIRE(pl_shader_sample_direct(sh, pl_sample_src( .tex = src )));
+    REQUIRE(pl_shader_detect_peak(sh, pl_color_space_hdr10, state, pl_peak_detect_params(
+        .stride = 4,
+    )));
+}
+
 static void bench_hdr_lut(pl_shader sh, pl_shader_obj *state, pl_tex src)
 {
     struct pl_color_map_params params = {
@@ -401,36 +523,44 @@ static void bench_h274_grain(pl_shader sh, pl_shader_obj *state, pl_tex src)
     REQUIRE(pl_shader_film_grain(sh, state, &params));
 }
 
+static const struct pl_dovi_metadata dovi_poly = { .comp = {
+    {
+        .num_pivots = 8,
+        .pivots = {0.0, 0.00488758553, 0.0420332365, 0.177908108,
+                   0.428152502, 0.678396881, 0.92864126, 1.0},
+        .method = {0, 0, 0, 0, 0, 0, 0},
+        .poly_coeffs = {
+            {0.00290930271, 2.30019712, 50.1446037},
+            {0.00725257397, 1.88119054, -4.49443769},
+            {0.0150123835, 1.61106598, -1.64833081},
+            {0.0498571396, 1.2059114, -0.430627108},
+            {0.0878019333, 1.01845241, -0.19669354},
+            {0.120447636, 0.920134187, -0.122338772},
+            {2.12430835, -3.30913281, 2.10893941},
+        },
+    }, {
+        .num_pivots = 2,
+        .pivots = {0.0, 1.0},
+        .method = {0},
+        .poly_coeffs = {{-0.397901177, 1.85908031, 0}},
+    }, {
+        .num_pivots = 2,
+        .pivots = {0.0, 1.0},
+        .method = {0},
+        .poly_coeffs = {{-0.399355531, 1.85591626, 0}},
+    },
+}};
+
 static void bench_reshape_poly(pl_shader sh, pl_shader_obj *state, pl_tex src)
 {
     REQUIRE(pl_shader_sample_direct(sh, pl_sample_src( .tex = src )));
-    pl_shader_dovi_reshape(sh, &(struct pl_dovi_metadata) { .comp = {
-        {
-            .num_pivots = 8,
-            .pivots = {0.0, 0.00488758553, 0.0420332365, 0.177908108,
-                       0.428152502, 0.678396881, 0.92864126, 1.0},
-            .method = {0, 0, 0, 0, 0, 0, 0},
-            .poly_coeffs = {
-                {0.00290930271, 2.30019712, 50.1446037},
-                {0.00725257397, 1.88119054, -4.49443769},
-                {0.0150123835, 1.61106598, -1.64833081},
-                {0.0498571396, 1.2059114, -0.430627108},
-                {0.0878019333, 1.01845241, -0.19669354},
-                {0.120447636, 0.920134187, -0.122338772},
-                {2.12430835, -3.30913281, 2.10893941},
-            },
-        }, {
-            .num_pivots = 2,
-            .pivots = {0.0, 1.0},
-            .method = {0},
-            .poly_coeffs = {{-0.397901177, 1.85908031, 0}},
-        }, {
-            .num_pivots = 2,
-            .pivots = {0.0, 1.0},
-            .method = {0},
-            .poly_coeffs = {{-0.399355531, 1.85591626, 0}},
-        },
-    }});
+    pl_shader_dovi_reshape(sh, &dovi_poly);
+}
+
+static void bench_reshape_poly_lut(pl_shader sh, pl_shader_obj *state, pl_tex src)
+{
+    REQUIRE(pl_shader_sample_direct(sh, pl_sample_src( .tex = src )));
+    pl_shader_dovi_reshape_lut(sh, &dovi_poly, state);
 }
 
 static void bench_reshape_mmr(pl_shader sh, pl_shader_obj *state, pl_tex src)
@@ -477,16 +607,70 @@ static void bench_upload_async(pl_gpu gpu, pl_tex tex)
     )));
 }
 
-int main()
+static void run_benchmarks(pl_gpu gpu)
 {
-    setbuf(stdout, NULL);
-    setbuf(stderr, NULL);
+#define BENCH_SH(fn)  &(struct bench) { .run_sh = fn }
+#define BENCH_TEX(fn) &(struct bench) { .run_tex = fn }
 
-    pl_log log = pl_log_create(PL_API_VER, pl_log_params(
-        .log_cb     = isatty(fileno(stdout)) ? pl_log_color : pl_log_simple,
-        .log_level  = PL_LOG_WARN,
-    ));
+    if (out.format == FMT_TEXT)
+        printf("= Running benchmarks (%s) =\n", out.backend);
+    benchmark(gpu, "tex_download ptr", BENCH_TEX(bench_download));
+    benchmark(gpu, "tex_download ptr async", BENCH_TEX(bench_download_async));
+    benchmark(gpu, "tex_upload ptr", BENCH_TEX(bench_upload));
+    benchmark(gpu, "tex_upload ptr async", BENCH_TEX(bench_upload_async));
+    benchmark(gpu, "bilinear", BENCH_SH(bench_bilinear));
+    benchmark(gpu, "bicubic", BENCH_SH(bench_bicubic));
+    benchmark(gpu, "hermite", BENCH_SH(bench_hermite));
+    benchmark(gpu, "gaussian", BENCH_SH(bench_gaussian));
+    benchmark(gpu, "deband", BENCH_SH(bench_deband));
+    benchmark(gpu, "deband_heavy", BENCH_SH(bench_deband_heavy));
+    benchmark(gpu, "deband_adaptive", BENCH_SH(bench_deband_adaptive));
+
+    // Deinterlacing
+    benchmark(gpu, "weave", BENCH_SH(bench_weave));
+    benchmark(gpu, "bob", BENCH_SH(bench_bob));
+    benchmark(gpu, "yadif", BENCH_SH(bench_yadif));
+
+    // Polar sampling
+    benchmark(gpu, "polar", BENCH_SH(bench_polar));
+    if (gpu->glsl.compute)
+        benchmark(gpu, "polar_nocompute", BENCH_SH(bench_polar_nocompute));
+
+    // Dithering algorithms
+    benchmark(gpu, "dither_blue", BENCH_SH(bench_dither_blue));
+    benchmark(gpu, "dither_white", BENCH_SH(bench_dither_white));
+    benchmark(gpu, "dither_ordered_fixed", BENCH_SH(bench_dither_ordered_fix));
+
+    // HDR peak detection
+    if (gpu->glsl.compute) {
+        benchmark(gpu, "hdr_peakdetect",    BENCH_SH(bench_hdr_peak));
+        benchmark(gpu, "hdr_peakdetect_hq", BENCH_SH(bench_hdr_peak_hq));
+        benchmark(gpu, "hdr_peakdetect_s4", BENCH_SH(bench_hdr_peak_strided));
+    }
+
+    // Tone mapping
+    benchmark(gpu, "hdr_lut", BENCH_SH(bench_hdr_lut));
+    benchmark(gpu, "hdr_clip", BENCH_SH(bench_hdr_clip));
+
+    // Misc stuff
+    benchmark(gpu, "av1_grain", BENCH_SH(bench_av1_grain));
+    benchmark(gpu, "av1_grain_lap", BENCH_SH(bench_av1_grain_lap));
+    benchmark(gpu, "h274_grain", BENCH_SH(bench_h274_grain));
+    benchmark(gpu, "reshape_poly", BENCH_SH(bench_reshape_poly));
+    benchmark(gpu, "reshape_poly_lut", BENCH_SH(bench_reshape_poly_lut));
+    benchmark(gpu, "reshape_mmr", BENCH_SH(bench_reshape_mmr));
+}
+
+// Backends
+struct backend {
+    const char *name;
+    pl_gpu (*create)(pl_log log, void **priv);
+    void (*destroy)(void *priv);
+};
 
+#ifdef PL_HAVE_VK_PROC_ADDR
+static pl_gpu vulkan_create(pl_log log, void **priv)
+{
     pl_vulkan vk = pl_vulkan_create(log, pl_vulkan_params(
         .allow_software = true,
         .async_transfer = ASYNC_TX,
@@ -494,57 +678,208 @@ int main()
         .queue_count    = NUM_QUEUES,
     ));
 
-    if (!vk)
-        return SKIP;
+    *priv = (void *) vk;
+    return vk ? vk->gpu : NULL;
+}
 
-#define BENCH_SH(fn)  &(struct bench) { .run_sh = fn }
-#define BENCH_TEX(fn) &(struct bench) { .run_tex = fn }
+static void vulkan_destroy(void *priv)
+{
+    pl_vulkan vk = priv;
+    pl_vulkan_destroy(&vk);
+}
+#endif
 
-    printf("= Running benchmarks =\n");
-    benchmark(vk->gpu, "tex_download ptr", BENCH_TEX(bench_download));
-    benchmark(vk->gpu, "tex_download ptr async", BENCH_TEX(bench_download_async));
-    benchmark(vk->gpu, "tex_upload ptr", BENCH_TEX(bench_upload));
-    benchmark(vk->gpu, "tex_upload ptr async", BENCH_TEX(bench_upload_async));
-    benchmark(vk->gpu, "bilinear", BENCH_SH(bench_bilinear));
-    benchmark(vk->gpu, "bicubic", BENCH_SH(bench_bicubic));
-    benchmark(vk->gpu, "hermite", BENCH_SH(bench_hermite));
-    benchmark(vk->gpu, "gaussian", BENCH_SH(bench_gaussian));
-    benchmark(vk->gpu, "deband", BENCH_SH(bench_deband));
-    benchmark(vk->gpu, "deband_heavy", BENCH_SH(bench_deband_heavy));
+#ifdef PL_HAVE_OPENGL
+struct egl_priv {
+    EGLDisplay dpy;
+    EGLContext ctx;
+    pl_opengl gl;
+};
 
-    // Deinterlacing
-    benchmark(vk->gpu, "weave", BENCH_SH(bench_weave));
-    benchmark(vk->gpu, "bob", BENCH_SH(bench_bob));
-    benchmark(vk->gpu, "yadif", BENCH_SH(bench_yadif));
+static void opengl_destroy(void *priv)
+{
+    struct egl_priv *p = priv;
+    pl_opengl_destroy(&p->gl);
+    if (p->ctx != EGL_NO_CONTEXT)
+        eglDestroyContext(p->dpy, p->ctx);
+    if (p->dpy != EGL_NO_DISPLAY)
+        eglTerminate(p->dpy);
+    gladLoaderUnloadEGL();
+    free(p);
+}
 
-    // Polar sampling
-    benchmark(vk->gpu, "polar", BENCH_SH(bench_polar));
-    if (vk->gpu->glsl.compute)
-        benchmark(vk->gpu, "polar_nocompute", BENCH_SH(bench_polar_nocompute));
+static pl_gpu opengl_create(pl_log log, void **priv)
+{
+    if (!gladLoaderLoadEGL(EGL_NO_DISPLAY))
+        return NULL;
+
+    const char *extstr = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (!extstr || !strstr(extstr, "EGL_MESA_platform_surfaceless"))
+        return NULL;
+
+    struct egl_priv *p = calloc(1, sizeof(*p));
+    REQUIRE(p);
+    p->ctx = EGL_NO_CONTEXT;
+    *priv = p;
+
+    p->dpy = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA,
+                                      (void *) EGL_DEFAULT_DISPLAY, NULL);
+    if (p->dpy == EGL_NO_DISPLAY || !eglInitialize(p->dpy, NULL, NULL))
+        return NULL;
+    if (!gladLoaderLoadEGL(p->dpy))
+        return NULL;
+
+    // Prefer desktop GL, falling back to GLES
+    static const struct {
+        EGLenum api;
+        EGLenum render;
+        EGLint attribs[7];
+    } apis[] = {{
+        EGL_OPENGL_API, EGL_OPENGL_BIT, {
+            EGL_CONTEXT_MAJOR_VERSION, 4,
+            EGL_CONTEXT_MINOR_VERSION, 6,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE,
+        }}, {
+        EGL_OPENGL_ES_API, EGL_OPENGL_ES3_BIT, {
+            EGL_CONTEXT_CLIENT_VERSION, 3,
+            EGL_NONE,
+        }},
+    };
 
-    // Dithering algorithms
-    benchmark(vk->gpu, "dither_blue", BENCH_SH(bench_dither_blue));
-    benchmark(vk->gpu, "dither_white", BENCH_SH(bench_dither_white));
-    benchmark(vk->gpu, "dither_ordered_fixed", BENCH_SH(bench_dither_ordered_fix));
+    for (int i = 0; i < PL_ARRAY_SIZE(apis) && p->ctx == EGL_NO_CONTEXT; i++) {
+        const EGLint cfg_attribs[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, apis[i].render,
+            EGL_NONE
+        };
 
-    // HDR peak detection
-    if (vk->gpu->glsl.compute) {
-        benchmark(vk->gpu, "hdr_peakdetect",    BENCH_SH(bench_hdr_peak));
-        benchmark(vk->gpu, "hdr_peakdetect_hq", BENCH_SH(bench_hdr_peak_hq));
+        EGLConfig config = 0;
+        EGLint num_configs = 0;
+        if (!eglChooseConfig(p->dpy, cfg_attribs, &config, 1, &num_configs) ||
+            !num_configs || !eglBindAPI(apis[i].api))
+            continue;
+
+        p->ctx = eglCreateContext(p->dpy, config, EGL_NO_CONTEXT, apis[i].attribs);
     }
 
-    // Tone mapping
-    benchmark(vk->gpu, "hdr_lut", BENCH_SH(bench_hdr_lut));
-    benchmark(vk->gpu, "hdr_clip", BENCH_SH(bench_hdr_clip));
+    if (p->ctx == EGL_NO_CONTEXT)
+        return NULL;
+    if (!eglMakeCurrent(p->dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, p->ctx))
+        return NULL;
 
-    // Misc stuff
-    benchmark(vk->gpu, "av1_grain", BENCH_SH(bench_av1_grain));
-    benchmark(vk->gpu, "av1_grain_lap", BENCH_SH(bench_av1_grain_lap));
-    benchmark(vk->gpu, "h274_grain", BENCH_SH(bench_h274_grain));
-    benchmark(vk->gpu, "reshape_poly", BENCH_SH(bench_reshape_poly));
-    benchmark(vk->gpu, "reshape_mmr", BENCH_SH(bench_reshape_mmr));
+    p->gl = pl_opengl_create(log, pl_opengl_params(
+        .get_proc_addr  = (pl_voidfunc_t (*)(const char *)) eglGetProcAddress,
+        .allow_software = true,
+        .egl_display    = p->dpy,
+        .egl_context    = p->ctx,
+    ));
 
-    pl_vulkan_destroy(&vk);
+    return p->gl ? p->gl->gpu : NULL;
+}
+#endif
+
+#ifdef PL_HAVE_D3D11
+static pl_gpu d3d11_create(pl_log log, void **priv)
+{
+    pl_d3d11 d3d11 = pl_d3d11_create(log, pl_d3d11_params(
+        .allow_software = true,
+    ));
+
+    *priv = (void *) d3d11;
+    return d3d11 ? d3d11->gpu : NULL;
+}
+
+static void d3d11_destroy(void *priv)
+{
+    pl_d3d11 d3d11 = priv;
+    pl_d3d11_destroy(&d3d11);
+}
+#endif
+
+static const struct backend backends[] = {
+#ifdef PL_HAVE_VK_PROC_ADDR
+    { "vulkan", vulkan_create, vulkan_destroy },
+#endif
+#ifdef PL_HAVE_OPENGL
+    { "opengl", opengl_create, opengl_destroy },
+#endif
+#ifdef PL_HAVE_D3D11
+    { "d3d11",  d3d11_create,  d3d11_destroy  },
+#endif
+};
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+        "Usage: %s [--backend <name>] [--format text|csv|json] [--baseline <file.csv>]\n"
+        "\n"
+        "  --backend   Only run the benchmarks on the given backend. Available:",
+        prog);
+    for (int i = 0; i < PL_ARRAY_SIZE(backends); i++)
+        fprintf(stderr, " %s", backends[i].name);
+    fprintf(stderr, "\n"
+        "  --format    Output format (default: text)\n"
+        "  --baseline  Compare against results previously saved with `--format csv`\n");
+}
+
+int main(int argc, char **argv)
+{
+    setbuf(stdout, NULL);
+    setbuf(stderr, NULL);
+
+    const char *only = NULL;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i], *val = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--backend") == 0 && val) {
+            only = val;
+        } else if (strcmp(arg, "--format") == 0 && val) {
+            if (strcmp(val, "text") == 0) {
+                out.format = FMT_TEXT;
+            } else if (strcmp(val, "csv") == 0) {
+                out.format = FMT_CSV;
+            } else if (strcmp(val, "json") == 0) {
+                out.format = FMT_JSON;
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(arg, "--baseline") == 0 && val) {
+            if (!load_baseline(val))
+                return 1;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+
+    pl_log log = pl_log_create(PL_API_VER, pl_log_params(
+        .log_cb     = isatty(fileno(stderr)) ? pl_log_color : pl_log_simple,
+        .log_level  = PL_LOG_WARN,
+    ));
+
+    bool ran = false;
+    for (int i = 0; i < PL_ARRAY_SIZE(backends); i++) {
+        const struct backend *b = &backends[i];
+        if (only && strcmp(only, b->name) != 0)
+            continue;
+
+        void *priv = NULL;
+        pl_gpu gpu = b->create(log, &priv);
+        if (gpu) {
+            out.backend = b->name;
+            run_benchmarks(gpu);
+            ran = true;
+        }
+        if (priv)
+            b->destroy(priv);
+    }
+
+    if (out.format == FMT_JSON)
+        printf("%s\n", out.num_results ? "\n]" : "[]");
+
+    free(out.baseline);
     pl_log_destroy(&log);
-    return 0;
+    return ran ? 0 : SKIP;
 }
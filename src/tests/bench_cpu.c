@@ -0,0 +1,305 @@
+#include "tests.h"
+
+#include <libplacebo/cache.h>
+#include <libplacebo/dither.h>
+#include <libplacebo/dummy.h>
+#include <libplacebo/filters.h>
+#include <libplacebo/gamut_mapping.h>
+#include <libplacebo/options.h>
+#include <libplacebo/tone_mapping.h>
+#include <libplacebo/shaders/icc.h>
+#include <libplacebo/shaders/lut.h>
+
+enum {
+    // Test configuration
+    TEST_MS     = 1000,
+    WARMUP_MS   = 200,
+
+    // Benchmark configuration
+    TONE_LUT    = 256,      // matches the renderer's tone mapping LUT
+    GAMUT_LUT   = 48,       // typical 3DLUT size used for gamut mapping
+    NOISE_SIZE  = 64,       // matches the renderer's blue noise texture
+    CUBE_SIZE   = 33,
+    CACHE_OBJS  = 256,
+    CACHE_OBJ   = 64 << 10,
+};
+
+// Shared state used by the benchmarks, set up once in `main`
+static struct {
+    pl_log log;
+    pl_gpu gpu;
+    float *buf;
+    pl_str cube;
+    pl_options opts;
+    const char *opts_str;
+    pl_opt_patch opts_patch;
+    pl_cache cache;
+    uint8_t *cache_data;
+    size_t cache_size;
+#ifdef PL_HAVE_LCMS
+    pl_icc_object icc;
+#endif
+} st;
+
+// Each benchmark returns the amount of work done, in units of `bench.unit`
+struct bench {
+    const char *name;
+    const char *unit;
+    double (*run)(void);
+};
+
+static void benchmark(const struct bench *bench)
+{
+    pl_clock_t start_warmup = pl_clock_now(), start_test = 0, now;
+    unsigned long iters = 0;
+    double work = 0.0;
+
+    do {
+        double done = bench->run();
+        now = pl_clock_now();
+        if (start_test) {
+            iters++;
+            work += done;
+            if (pl_clock_diff(now, start_test) > TEST_MS * 1e-3)
+                break;
+        } else if (pl_clock_diff(now, start_warmup) > WARMUP_MS * 1e-3) {
+            start_test = now;
+        }
+    } while (true);
+
+    double secs = pl_clock_diff(now, start_test);
+    printf("'%s':\t%5lu iterations in %1.6f seconds => %2.6f ms/iter "
+           "(%.2f %s/s)\n", bench->name, iters, secs, 1000 * secs / iters,
+           work / secs, bench->unit);
+}
+
+// List of benchmarks
+static double tone_map(const struct pl_tone_map_function *fun)
+{
+    struct pl_tone_map_params params = {
+        .function       = fun,
+        .constants      = { PL_TONE_MAP_CONSTANTS },
+        .input_scaling  = PL_HDR_PQ,
+        .output_scaling = PL_HDR_PQ,
+        .lut_size       = TONE_LUT,
+        .input_min      = pl_hdr_rescale(PL_HDR_NITS, PL_HDR_PQ, 0.005),
+        .input_max      = pl_hdr_rescale(PL_HDR_NITS, PL_HDR_PQ, 1000.0),
+        .output_min     = pl_hdr_rescale(PL_HDR_NITS, PL_HDR_PQ, 0.2),
+        .output_max     = pl_hdr_rescale(PL_HDR_NITS, PL_HDR_PQ, 203.0),
+    };
+
+    pl_tone_map_generate(st.buf, &params);
+    return TONE_LUT;
+}
+
+static double bench_tone_map_spline(void) { return tone_map(&pl_tone_map_spline); }
+static double bench_tone_map_bt2390(void) { return tone_map(&pl_tone_map_bt2390); }
+static double bench_tone_map_st2094(void) { return tone_map(&pl_tone_map_st2094_40); }
+
+static double gamut_map(const struct pl_gamut_map_function *fun)
+{
+    pl_gamut_map_generate(st.buf, &(struct pl_gamut_map_params) {
+        .function     = fun,
+        .input_gamut  = *pl_raw_primaries_get(PL_COLOR_PRIM_BT_2020),
+        .output_gamut = *pl_raw_primaries_get(PL_COLOR_PRIM_BT_709),
+        .max_luma     = pl_hdr_rescale(PL_HDR_NORM, PL_HDR_PQ, 1.0f),
+        .constants    = { PL_GAMUT_MAP_CONSTANTS },
+        .lut_size_I   = GAMUT_LUT,
+        .lut_size_C   = GAMUT_LUT,
+        .lut_size_h   = GAMUT_LUT,
+        .lut_stride   = 3,
+    });
+
+    return GAMUT_LUT * GAMUT_LUT * GAMUT_LUT;
+}
+
+static double bench_gamut_map_perceptual(void) { return gamut_map(&pl_gamut_map_perceptual); }
+static double bench_gamut_map_relative(void)   { return gamut_map(&pl_gamut_map_relative); }
+
+static double filter(const struct pl_filter_config *config, bool polar)
+{
+    struct pl_filter_config cfg = *config;
+    cfg.polar = polar;
+    pl_filter flt = pl_filter_generate(st.log, pl_filter_params(
+        .config         = cfg,
+        .lut_entries    = 256,
+        .max_row_size   = polar ? 0 : 64,
+    ));
+    REQUIRE(flt);
+    pl_filter_free(&flt);
+    return 256;
+}
+
+static double bench_filter_lanczos(void)     { return filter(&pl_filter_lanczos, false); }
+static double bench_filter_ewa_lanczos(void) { return filter(&pl_filter_ewa_lanczos, true); }
+
+static double bench_blue_noise(void)
+{
+    pl_generate_blue_noise(st.buf, NOISE_SIZE);
+    return NOISE_SIZE * NOISE_SIZE;
+}
+
+static double bench_parse_cube(void)
+{
+    struct pl_custom_lut *lut = pl_lut_parse_cube(st.log, (char *) st.cube.buf,
+                                                  st.cube.len);
+    REQUIRE(lut);
+    pl_lut_free(&lut);
+    return st.cube.len / 1e6;
+}
+
+static double bench_options_load(void)
+{
+    pl_options opts = pl_options_alloc(st.log);
+    REQUIRE(pl_options_load(opts, st.opts_str));
+    pl_options_free(&opts);
+    return 1;
+}
+
+static double bench_options_patch(void)
+{
+    pl_options_apply_patch(st.opts, st.opts_patch);
+    return 1;
+}
+
+static double bench_cache_save(void)
+{
+    REQUIRE_CMP(pl_cache_save(st.cache, st.cache_data, st.cache_size), ==,
+                st.cache_size, "zu");
+    return st.cache_size / 1e6;
+}
+
+static double bench_cache_load(void)
+{
+    pl_cache cache = pl_cache_create(pl_cache_params( .log = st.log ));
+    REQUIRE_CMP(pl_cache_load(cache, st.cache_data, st.cache_size), ==,
+                CACHE_OBJS, "d");
+    pl_cache_destroy(&cache);
+    return st.cache_size / 1e6;
+}
+
+#ifdef PL_HAVE_LCMS
+static double bench_icc_lut(void)
+{
+    // Regenerate the 3DLUT from scratch on every iteration
+    pl_shader_obj lut = NULL;
+    pl_shader sh = pl_shader_alloc(st.log, pl_shader_params( .gpu = st.gpu ));
+    pl_icc_decode(sh, st.icc, &lut, NULL);
+    REQUIRE(pl_shader_finalize(sh));
+    pl_shader_free(&sh);
+    pl_shader_obj_destroy(&lut);
+
+    const struct pl_icc_params *par = &st.icc->params;
+    return par->size_r * par->size_g * par->size_b;
+}
+#endif
+
+static void setup(void)
+{
+    st.buf = malloc(sizeof(float[GAMUT_LUT][GAMUT_LUT][GAMUT_LUT][3]));
+    REQUIRE(st.buf);
+
+    pl_str_append_asprintf(NULL, &st.cube, "LUT_3D_SIZE %d\n", CUBE_SIZE);
+    for (int b = 0; b < CUBE_SIZE; b++) {
+        for (int g = 0; g < CUBE_SIZE; g++) {
+            for (int r = 0; r < CUBE_SIZE; r++) {
+                pl_str_append_asprintf(NULL, &st.cube, "%f %f %f\n",
+                    r / (CUBE_SIZE - 1.0), g / (CUBE_SIZE - 1.0),
+                    b / (CUBE_SIZE - 1.0));
+            }
+        }
+    }
+
+    // Serialize a non-trivial set of options, to be loaded back
+    st.opts = pl_options_alloc(st.log);
+    pl_options_reset(st.opts, &pl_render_high_quality_params);
+    REQUIRE(pl_options_set_str(st.opts, "upscaler", "ewa_lanczossharp"));
+    REQUIRE(pl_options_set_str(st.opts, "tone_mapping", "st2094-40"));
+    REQUIRE(pl_options_set_str(st.opts, "dither_method", "ordered_lut"));
+    st.opts_str = pl_options_save(st.opts);
+    st.opts_patch = pl_opt_patch_compile(st.log, st.opts_str);
+    REQUIRE(st.opts_patch);
+
+    // Fill a cache with incompressible data, similar to compiled shaders
+    st.cache = pl_cache_create(pl_cache_params( .log = st.log ));
+    uint8_t *obj = malloc(CACHE_OBJ);
+    REQUIRE(obj);
+    uint64_t seed = 0x1234;
+    for (int i = 0; i < CACHE_OBJS; i++) {
+        for (int n = 0; n < CACHE_OBJ; n++) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            obj[n] = seed >> 56;
+        }
+        pl_cache_set(st.cache, &(pl_cache_obj) {
+            .key  = i + 1,
+            .data = obj,
+            .size = CACHE_OBJ,
+        });
+    }
+    free(obj);
+
+    st.cache_size = pl_cache_save(st.cache, NULL, 0);
+    st.cache_data = malloc(st.cache_size);
+    REQUIRE(st.cache_data);
+
+#ifdef PL_HAVE_LCMS
+    st.gpu = pl_gpu_dummy_create(st.log, NULL);
+    st.icc = pl_icc_open(st.log, &TEST_PROFILE(sRGB_v2_nano_icc), pl_icc_params(
+        .size_r = 64,
+        .size_g = 64,
+        .size_b = 64,
+    ));
+    REQUIRE(st.icc);
+#endif
+}
+
+static void teardown(void)
+{
+#ifdef PL_HAVE_LCMS
+    pl_icc_close(&st.icc);
+    pl_gpu_dummy_destroy(&st.gpu);
+#endif
+    free(st.cache_data);
+    pl_cache_destroy(&st.cache);
+    pl_opt_patch_free(&st.opts_patch);
+    pl_options_free(&st.opts);
+    pl_free(st.cube.buf);
+    free(st.buf);
+}
+
+int main()
+{
+    setbuf(stdout, NULL);
+    setbuf(stderr, NULL);
+
+    st.log = pl_log_create(PL_API_VER, pl_log_params(
+        .log_cb     = isatty(fileno(stdout)) ? pl_log_color : pl_log_simple,
+        .log_level  = PL_LOG_WARN,
+    ));
+
+    setup();
+
+#define BENCH(name, unit, fn) &(struct bench) { name, unit, fn }
+
+    printf("= Running CPU benchmarks =\n");
+    benchmark(BENCH("tone_map spline",     "entries", bench_tone_map_spline));
+    benchmark(BENCH("tone_map bt2390",     "entries", bench_tone_map_bt2390));
+    benchmark(BENCH("tone_map st2094-40",  "entries", bench_tone_map_st2094));
+    benchmark(BENCH("gamut_map perceptual", "entries", bench_gamut_map_perceptual));
+    benchmark(BENCH("gamut_map relative",  "entries", bench_gamut_map_relative));
+    benchmark(BENCH("filter lanczos",      "entries", bench_filter_lanczos));
+    benchmark(BENCH("filter ewa_lanczos",  "entries", bench_filter_ewa_lanczos));
+    benchmark(BENCH("blue_noise",          "texels",  bench_blue_noise));
+    benchmark(BENCH("lut_parse_cube",      "MB",      bench_parse_cube));
+    benchmark(BENCH("options_load",        "loads",   bench_options_load));
+    benchmark(BENCH("options_apply_patch", "loads",   bench_options_patch));
+    benchmark(BENCH("cache_save",          "MB",      bench_cache_save));
+    benchmark(BENCH("cache_load",          "MB",      bench_cache_load));
+#ifdef PL_HAVE_LCMS
+    benchmark(BENCH("icc_lut",             "entries", bench_icc_lut));
+#endif
+
+    teardown();
+    pl_log_destroy(&st.log);
+    return 0;
+}
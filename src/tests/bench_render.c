@@ -0,0 +1,457 @@
+#include "tests.h"
+
+#include <libplacebo/cache.h>
+#include <libplacebo/renderer.h>
+#include <libplacebo/utils/upload.h>
+#include <libplacebo/vulkan.h>
+
+enum {
+    // Output configuration
+    OUT_WIDTH   = 3840,
+    OUT_HEIGHT  = 2160,
+    NUM_FBOS    = 4,
+
+    // Frame mixing configuration
+    NUM_MIX     = 4,
+
+    // Test configuration
+    TEST_MS     = 1000,
+    WARMUP_MS   = 500,
+};
+
+enum source {
+    SRC_SDR,    // 8-bit 4:2:0 BT.709
+    SRC_HDR10,  // 10-bit 4:2:0 BT.2020 PQ
+    SRC_DOVI,   // 10-bit 4:2:0 Dolby Vision (profile 8-like reshaping)
+};
+
+struct scenario {
+    const char *name;
+    enum source source;
+    int width, height;
+    const struct pl_render_params *params;
+    bool mix;   // use `pl_render_image_mix` (24 fps source on a 60 Hz display)
+    bool icc;   // render to an ICC profiled target
+};
+
+struct source_img {
+    pl_tex tex[3];
+    struct pl_frame frame;
+};
+
+static void create_source(pl_gpu gpu, const struct scenario *sc,
+                          struct source_img *src)
+{
+    const int depth = sc->source == SRC_SDR ? 8 : 16;
+    const int bytes = depth / 8;
+    const float xc = (sc->width  - 1) / 2.0f;
+    const float yc = (sc->height - 1) / 2.0f;
+    const float kf = 0.5f / sqrtf(xc * xc + yc * yc);
+
+    src->frame = (struct pl_frame) {
+        .num_planes = 3,
+        .repr = {
+            .sys    = PL_COLOR_SYSTEM_BT_709,
+            .levels = PL_COLOR_LEVELS_LIMITED,
+            .bits   = { .sample_depth = depth, .color_depth = PL_MIN(depth, 10) },
+        },
+        .color = pl_color_space_bt709,
+    };
+
+    switch (sc->source) {
+    case SRC_SDR:
+        break;
+    case SRC_HDR10:
+        src->frame.repr.sys = PL_COLOR_SYSTEM_BT_2020_NC;
+        src->frame.color = pl_color_space_hdr10;
+        src->frame.color.hdr.max_luma = 1000;
+        break;
+    case SRC_DOVI:
+        src->frame.repr.sys = PL_COLOR_SYSTEM_DOLBYVISION;
+        src->frame.repr.dovi = &dovi_meta;
+        src->frame.color = pl_color_space_hdr10;
+        break;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        const int w = i ? (sc->width  + 1) >> 1 : sc->width;
+        const int h = i ? (sc->height + 1) >> 1 : sc->height;
+        const float freq = kf * M_PI * (0.2f - 0.05f * i) * (i ? 4 : 1);
+        uint8_t *data = malloc((size_t) w * h * bytes);
+        REQUIRE(data);
+
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                const float xx = x - (i ? xc / 2 : xc), yy = y - (i ? yc / 2 : yc);
+                const float v = 0.5f * sinf(freq * (xx * xx + yy * yy)) + 0.5f;
+                const size_t idx = (size_t) y * w + x;
+                if (bytes == 1) {
+                    data[idx] = 16 + v * (i ? 224 : 219);
+                } else {
+                    ((uint16_t *) data)[idx] = 64 + v * (i ? 896 : 876);
+                }
+            }
+        }
+
+        struct pl_plane_data plane = {
+            .type           = PL_FMT_UNORM,
+            .width          = w,
+            .height         = h,
+            .component_size = { depth },
+            .component_map  = { i },
+            .pixel_stride   = bytes,
+            .pixels         = data,
+        };
+
+        REQUIRE(pl_upload_plane(gpu, &src->frame.planes[i], &src->tex[i], &plane));
+        free(data);
+    }
+
+    pl_frame_set_chroma_location(&src->frame, PL_CHROMA_LEFT);
+}
+
+static void destroy_source(pl_gpu gpu, struct source_img *src)
+{
+    for (int i = 0; i < 3; i++)
+        pl_tex_destroy(gpu, &src->tex[i]);
+}
+
+static bool render_frame(pl_renderer rr, const struct scenario *sc,
+                         const struct pl_frame *image,
+                         const struct pl_frame *target,
+                         const struct pl_render_params *params,
+                         unsigned long frame)
+{
+    if (!sc->mix)
+        return pl_render_image(rr, image, target, params);
+
+    // Simulate 24 fps content on a 60 Hz display, with a new source frame
+    // (i.e. signature) displacing the oldest one every 2.5 vsyncs
+    const float vsync = 24.0f / 60.0f;
+    const float pts = frame * vsync;
+    const long base = (long) pts;
+    const struct pl_frame *frames[NUM_MIX];
+    uint64_t signatures[NUM_MIX];
+    float timestamps[NUM_MIX];
+    for (int i = 0; i < NUM_MIX; i++) {
+        const long idx = base + i - (NUM_MIX - 1) / 2;
+        frames[i] = image;
+        signatures[i] = idx + NUM_MIX; // avoid 0
+        timestamps[i] = idx - pts;
+    }
+
+    return pl_render_image_mix(rr, &(struct pl_frame_mix) {
+        .num_frames     = NUM_MIX,
+        .frames         = frames,
+        .signatures     = signatures,
+        .timestamps     = timestamps,
+        .vsync_duration = vsync,
+    }, target, params);
+}
+
+static pl_tex create_fbo(pl_gpu gpu)
+{
+    pl_fmt fmt = pl_find_fmt(gpu, PL_FMT_UNORM, 4, 8, 8, PL_FMT_CAP_RENDERABLE);
+    REQUIRE(fmt);
+
+    pl_tex fbo = pl_tex_create(gpu, pl_tex_params(
+        .format     = fmt,
+        .w          = OUT_WIDTH,
+        .h          = OUT_HEIGHT,
+        .renderable = true,
+    ));
+
+    REQUIRE(fbo);
+    return fbo;
+}
+
+static struct pl_frame create_target(const struct scenario *sc, pl_tex fbo)
+{
+    struct pl_frame target = {
+        .num_planes = 1,
+        .planes     = {{
+            .texture        = fbo,
+            .components     = 4,
+            .component_mapping = {0, 1, 2, 3},
+        }},
+        .repr       = pl_color_repr_rgb,
+        .color      = pl_color_space_srgb,
+    };
+
+    if (sc->icc)
+        target.profile = TEST_PROFILE(sRGB_v2_nano_icc);
+    return target;
+}
+
+static struct pl_render_params scenario_params(const struct scenario *sc)
+{
+    struct pl_render_params params = *sc->params;
+    if (sc->mix)
+        params.frame_mixer = PL_DEF(params.frame_mixer, &pl_oversample_frame_mixer);
+    return params;
+}
+
+static void benchmark(pl_gpu gpu, const struct scenario *sc)
+{
+    struct source_img src;
+    create_source(gpu, sc, &src);
+
+    pl_tex fbos[NUM_FBOS] = {0};
+    for (int i = 0; i < NUM_FBOS; i++)
+        fbos[i] = create_fbo(gpu);
+
+    struct pl_frame target = create_target(sc, fbos[0]);
+    struct pl_render_params params = scenario_params(sc);
+
+    // Render once and block to force shader compilation, LUT generation etc.
+    pl_renderer rr = pl_renderer_create(gpu->log, gpu);
+    REQUIRE(render_frame(rr, sc, &src.frame, &target, &params, 0));
+    pl_gpu_finish(gpu);
+
+    pl_clock_t start_warmup = 0, start_test = 0;
+    unsigned long frames = 0, frames_warmup = 0;
+    double cputime_total = 0.0;
+    uint64_t gputime_total = 0;
+    unsigned long gputime_count = 0;
+    size_t vram_max = 0;
+
+    start_warmup = pl_clock_now();
+    do {
+        const int idx = frames % NUM_FBOS;
+        while (pl_tex_poll(gpu, fbos[idx], UINT64_MAX))
+            ; // do nothing
+        target.planes[0].texture = fbos[idx];
+
+        pl_clock_t before = pl_clock_now();
+        REQUIRE(render_frame(rr, sc, &src.frame, &target, &params, frames + 1));
+        pl_gpu_flush(gpu);
+        pl_clock_t now = pl_clock_now();
+        frames++;
+
+        if (start_test) {
+            struct pl_render_stats stats = pl_renderer_get_stats(rr);
+            cputime_total += pl_clock_diff(now, before);
+            vram_max = PL_MAX(vram_max, stats.fbo_memory);
+            if (stats.time_total) {
+                gputime_total += stats.time_total;
+                gputime_count++;
+            }
+
+            if (pl_clock_diff(now, start_test) > TEST_MS * 1e-3)
+                break;
+        } else if (pl_clock_diff(now, start_warmup) > WARMUP_MS * 1e-3) {
+            start_test = now;
+            frames_warmup = frames;
+        }
+    } while (true);
+
+    pl_gpu_finish(gpu);
+    pl_clock_t stop = pl_clock_now();
+
+    frames -= frames_warmup;
+    double secs = pl_clock_diff(stop, start_test);
+    printf("'%s':\t%4lu frames in %1.6f seconds => %2.6f ms/frame (%5.2f FPS)"
+           ", cpu time: %2.6f ms", sc->name, frames, secs, 1000 * secs / frames,
+           frames / secs, 1000 * cputime_total / frames);
+    if (gputime_count)
+        printf(", gpu time: %2.6f ms", 1e-6 * gputime_total / gputime_count);
+    printf(", vram: %.1f MiB\n", vram_max / 1048576.0);
+
+    pl_renderer_destroy(&rr);
+    for (int i = 0; i < NUM_FBOS; i++)
+        pl_tex_destroy(gpu, &fbos[i]);
+    destroy_source(gpu, &src);
+}
+
+// Cold start measurements, based on the CPU time reported by libplacebo's
+// own debug messages ("Spent %f ms <operation>")
+enum phase {
+    PHASE_GLSL,         // GLSL generation
+    PHASE_COMPILE,      // GLSL to SPIR-V (or driver shader compilation)
+    PHASE_PIPELINE,     // driver pipeline creation
+    PHASE_LUT,          // CPU-side LUT generation
+    PHASE_COUNT,
+};
+
+static const struct {
+    const char *operation;
+    enum phase phase;
+} operations[] = {
+    { "generating GLSL",        PHASE_GLSL },
+    { "compiling shader",       PHASE_COMPILE },
+    { "creating pipeline",      PHASE_PIPELINE },
+    { "re-specializing shader", PHASE_PIPELINE },
+    { "generating shader LUT",  PHASE_LUT },
+};
+
+static struct {
+    bool active;
+    double ms[PHASE_COUNT];
+} phases;
+
+static void log_cb(void *stream, enum pl_log_level level, const char *msg)
+{
+    double ms;
+    int pos;
+    if (phases.active && sscanf(msg, "Spent %lf ms %n", &ms, &pos) == 1) {
+        for (int i = 0; i < PL_ARRAY_SIZE(operations); i++) {
+            const char *op = operations[i].operation;
+            if (strncmp(msg + pos, op, strlen(op)) == 0)
+                phases.ms[operations[i].phase] += ms;
+        }
+    }
+
+    if (level <= PL_LOG_WARN) {
+        if (isatty(fileno(stdout))) {
+            pl_log_color(stream, level, msg);
+        } else {
+            pl_log_simple(stream, level, msg);
+        }
+    }
+}
+
+enum cache_mode {
+    CACHE_NONE,     // no pl_cache at all
+    CACHE_EMPTY,    // freshly created pl_cache
+    CACHE_WARM,     // pl_cache populated by the previous run
+    CACHE_MODE_COUNT,
+};
+
+static const char *const cache_mode_names[CACHE_MODE_COUNT] = {
+    [CACHE_NONE]  = "no cache",
+    [CACHE_EMPTY] = "empty cache",
+    [CACHE_WARM]  = "warm cache",
+};
+
+// Measures the time to the first frame rendered by a fresh `pl_renderer`
+static void cold_start(pl_gpu gpu, const struct scenario *sc)
+{
+    struct source_img src;
+    create_source(gpu, sc, &src);
+    pl_tex fbo = create_fbo(gpu);
+    struct pl_frame target = create_target(sc, fbo);
+    struct pl_render_params params = scenario_params(sc);
+    pl_cache cache = NULL;
+
+    for (enum cache_mode mode = 0; mode < CACHE_MODE_COUNT; mode++) {
+        if (mode == CACHE_EMPTY)
+            cache = pl_cache_create(pl_cache_params( .log = gpu->log ));
+        pl_gpu_set_cache(gpu, cache);
+        pl_gpu_finish(gpu);
+
+        memset(&phases, 0, sizeof(phases));
+        phases.active = true;
+        enum pl_log_level old_level = pl_log_level_update(gpu->log, PL_LOG_DEBUG);
+
+        pl_clock_t start = pl_clock_now();
+        pl_renderer rr = pl_renderer_create(gpu->log, gpu);
+        REQUIRE(render_frame(rr, sc, &src.frame, &target, &params, 0));
+        pl_gpu_finish(gpu);
+        pl_clock_t stop = pl_clock_now();
+
+        pl_log_level_update(gpu->log, old_level);
+        phases.active = false;
+
+        struct pl_render_stats stats = pl_renderer_get_stats(rr);
+        pl_renderer_destroy(&rr);
+
+        double sum = 0.0;
+        for (int i = 0; i < PHASE_COUNT; i++)
+            sum += phases.ms[i];
+        const double total = 1e3 * pl_clock_diff(stop, start);
+        printf("'%s' (%s):\tfirst frame in %8.3f ms, %2d shaders compiled "
+               "(glsl: %.3f ms, compile: %.3f ms, pipeline: %.3f ms, "
+               "lut: %.3f ms, other: %.3f ms)\n", sc->name,
+               cache_mode_names[mode], total, stats.num_compiled,
+               phases.ms[PHASE_GLSL], phases.ms[PHASE_COMPILE],
+               phases.ms[PHASE_PIPELINE], phases.ms[PHASE_LUT],
+               PL_MAX(total - sum, 0.0));
+    }
+
+    pl_gpu_set_cache(gpu, NULL);
+    pl_cache_destroy(&cache);
+    pl_tex_destroy(gpu, &fbo);
+    destroy_source(gpu, &src);
+}
+
+#define SCENARIOS(name, src, w, h, mix, icc)                                 \
+    { name " fast",    src, w, h, &pl_render_fast_params,         mix, icc }, \
+    { name " default", src, w, h, &pl_render_default_params,      mix, icc }, \
+    { name " hq",      src, w, h, &pl_render_high_quality_params, mix, icc }
+
+static const struct scenario scenarios[] = {
+    SCENARIOS("1080p sdr",       SRC_SDR,   1920, 1080, false, false),
+    SCENARIOS("2160p hdr10",     SRC_HDR10, 3840, 2160, false, false),
+    SCENARIOS("2160p dovi",      SRC_DOVI,  3840, 2160, false, false),
+    SCENARIOS("4320p hdr10",     SRC_HDR10, 7680, 4320, false, false),
+    SCENARIOS("1080p sdr mix",   SRC_SDR,   1920, 1080, true,  false),
+    SCENARIOS("2160p hdr10 mix", SRC_HDR10, 3840, 2160, true,  false),
+#ifdef PL_HAVE_LCMS
+    SCENARIOS("1080p sdr icc",   SRC_SDR,   1920, 1080, false, true),
+    SCENARIOS("2160p hdr10 icc", SRC_HDR10, 3840, 2160, false, true),
+#endif
+};
+
+// Runs all scenarios whose name contains any of the given arguments, or all
+// scenarios if no arguments are given. `--cold-start` and `--throughput`
+// restrict the benchmarks to only measuring the time to the first frame, or
+// the steady state performance, respectively.
+int main(int argc, char **argv)
+{
+    setbuf(stdout, NULL);
+    setbuf(stderr, NULL);
+
+    bool run_cold = true, run_throughput = true;
+    int num_filters = 0;
+    for (int n = 1; n < argc; n++) {
+        if (strcmp(argv[n], "--cold-start") == 0) {
+            run_throughput = false;
+        } else if (strcmp(argv[n], "--throughput") == 0) {
+            run_cold = false;
+        } else {
+            argv[++num_filters] = argv[n];
+        }
+    }
+
+    pl_log log = pl_log_create(PL_API_VER, pl_log_params(
+        .log_cb     = log_cb,
+        .log_level  = PL_LOG_WARN,
+    ));
+
+    pl_vulkan vk = pl_vulkan_create(log, pl_vulkan_params(
+        .allow_software = true,
+    ));
+
+    if (!vk)
+        return SKIP;
+
+    bool selected[PL_ARRAY_SIZE(scenarios)];
+    for (int i = 0; i < PL_ARRAY_SIZE(scenarios); i++) {
+        selected[i] = !num_filters;
+        for (int n = 1; n <= num_filters; n++)
+            selected[i] |= !!strstr(scenarios[i].name, argv[n]);
+    }
+
+    if (run_throughput) {
+        printf("= Running renderer benchmarks (%dx%d output) =\n",
+               OUT_WIDTH, OUT_HEIGHT);
+        for (int i = 0; i < PL_ARRAY_SIZE(scenarios); i++) {
+            if (selected[i])
+                benchmark(vk->gpu, &scenarios[i]);
+        }
+    }
+
+    if (run_cold) {
+        // Note: Driver-internal shader caches (e.g. MESA_SHADER_CACHE_DISABLE)
+        // are outside of our control, and should be disabled externally
+        printf("= Measuring cold start latency =\n");
+        for (int i = 0; i < PL_ARRAY_SIZE(scenarios); i++) {
+            if (selected[i])
+                cold_start(vk->gpu, &scenarios[i]);
+        }
+    }
+
+    pl_vulkan_destroy(&vk);
+    pl_log_destroy(&log);
+    return 0;
+}
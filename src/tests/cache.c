@@ -18,6 +18,17 @@ static void update_count(void *priv, pl_cache_obj obj)
     *count += obj.size ? 1 : -1;
 }
 
+static long file_size(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+        return -1;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
 enum {
     KEY1 = 0x9c65575f419288f5,
     KEY2 = 0x92da969be9b88086,
@@ -120,6 +131,41 @@ int main()
     REQUIRE_CMP(pl_cache_save(test2, data, sizeof(data)), ==, sizeof(ref), "zu");
     REQUIRE_MEMEQ(data, ref, sizeof(ref));
 
+    // Test loading from a memory-mapped file
+    FILE *tmp = fopen("test_cache_mmap.bin", "wb");
+    if (tmp) {
+        REQUIRE_CMP(pl_cache_save_file(test2, tmp), ==, 2, "d");
+        fclose(tmp);
+        pl_cache test3 = pl_cache_create(pl_cache_params( .log = log ));
+        REQUIRE_CMP(pl_cache_load_mmap(test3, "test_cache_mmap.bin"), ==, 2, "d");
+        REQUIRE_CMP(pl_cache_size(test3), ==, 7, "zu");
+        REQUIRE_CMP(pl_cache_save(test3, data, sizeof(data)), ==, sizeof(ref), "zu");
+        REQUIRE_MEMEQ(data, ref, sizeof(ref));
+        pl_cache_obj obj = { .key = KEY3 };
+        REQUIRE(pl_cache_get(test3, &obj));
+        REQUIRE_MEMEQ(obj.data, "xyzw", 4);
+        pl_cache_set(test3, &obj);
+        pl_cache_destroy(&test3);
+
+        test3 = pl_cache_create(pl_cache_params( .log = log ));
+        REQUIRE_CMP(pl_cache_load_lazy(test3, "test_cache_mmap.bin"), ==, 2, "d");
+        REQUIRE_CMP(pl_cache_objects(test3), ==, 0, "d");
+        REQUIRE_CMP(pl_cache_save(test3, data, sizeof(data)), ==, sizeof(ref), "zu");
+        REQUIRE_MEMEQ(data, ref, sizeof(ref));
+        obj = (pl_cache_obj) { .key = KEY1 };
+        REQUIRE(pl_cache_get(test3, &obj));
+        REQUIRE_MEMEQ(obj.data, "abc", 3);
+        REQUIRE(!pl_cache_get(test3, &(pl_cache_obj) { .key = KEY1 }));
+        pl_cache_set(test3, &obj);
+        REQUIRE_CMP(pl_cache_objects(test3), ==, 1, "d");
+        REQUIRE(pl_cache_try_set(test3, &(pl_cache_obj) { .key = KEY3 })); // delete
+        REQUIRE(!pl_cache_get(test3, &(pl_cache_obj) { .key = KEY3 }));
+        REQUIRE_CMP(pl_cache_save(test3, NULL, 0), <, sizeof(ref), "zu");
+        pl_cache_destroy(&test3);
+        remove("test_cache_mmap.bin");
+    }
+    REQUIRE_CMP(pl_cache_load_mmap(test2, "test_cache_nonexistent.bin"), <, 0, "d");
+
     // Test loading invalid data
     REQUIRE_CMP(pl_cache_load(test2, ref, 0),   <, 0, "d"); // empty file
     REQUIRE_CMP(pl_cache_load(test2, ref, 5),   <, 0, "d"); // truncated header
@@ -165,6 +211,14 @@ int main()
     REQUIRE_CMP(pl_cache_size(test), ==, 30, "zu");
     REQUIRE_CMP(pl_cache_objects(test), ==, 3, "d");
 
+    struct pl_cache_stats stats;
+    pl_cache_get_stats(test, &stats);
+    REQUIRE_CMP(stats.evictions, ==, 1, PRIu64);
+    REQUIRE_CMP(stats.bytes_evicted, ==, 3, PRIu64);
+    REQUIRE_CMP(stats.misses, >=, 3, PRIu64);
+    REQUIRE_CMP(stats.hits, ==, 8, PRIu64);
+    pl_cache_reset_stats(test);
+
     // Inserting final 6-byte object should purge entry KEY3
     pl_cache_obj obj6 = { .key = KEY6, .data = zero, .size = 6 };
     REQUIRE(pl_cache_try_set(test, &obj6));
@@ -174,6 +228,11 @@ int main()
     REQUIRE(pl_cache_get(test, &obj4));
     REQUIRE(pl_cache_get(test, &obj5));
     REQUIRE(pl_cache_get(test, &obj6));
+    pl_cache_get_stats(test, &stats);
+    REQUIRE_CMP(stats.insertions, ==, 1, PRIu64);
+    REQUIRE_CMP(stats.evictions, ==, 1, PRIu64);
+    REQUIRE_CMP(stats.hits, ==, 3, PRIu64);
+    REQUIRE_CMP(stats.misses, ==, 1, PRIu64);
     REQUIRE_CMP(pl_cache_size(test), ==, 0, "zu");
     REQUIRE_CMP(pl_cache_objects(test), ==, 0, "d");
     pl_cache_obj_free(&obj4);
@@ -198,6 +257,8 @@ int main()
     REQUIRE_MEMEQ(obj2.data, "foo", 3);
     REQUIRE_CMP(pl_cache_objects(test2), ==, 0, "d");
     REQUIRE_CMP(num_objects, ==, 0, "d");
+    pl_cache_get_stats(test2, &stats);
+    REQUIRE_CMP(stats.external_hits, ==, 2, PRIu64);
     REQUIRE(pl_cache_try_set(test2, &obj1));
     REQUIRE(pl_cache_try_set(test2, &obj2));
     REQUIRE(pl_cache_try_set(test2, &(pl_cache_obj) { .key = KEY7, .data = "abcde", .size = 5 }));
@@ -209,6 +270,199 @@ int main()
     REQUIRE_CMP(num_objects, ==, 1, "d");
     pl_cache_destroy(&test2);
 
+    // Test index consistency with many objects
+    test2 = pl_cache_create(pl_cache_params( .log = log ));
+    static const int num_stress = 1000;
+    for (uint64_t i = 0; i < num_stress; i++) {
+        pl_cache_obj obj = { .key = i * 0x100, .data = &i, .size = sizeof(i) };
+        REQUIRE(pl_cache_try_set(test2, &obj));
+    }
+    REQUIRE_CMP(pl_cache_objects(test2), ==, num_stress, "d");
+    for (uint64_t i = 0; i < num_stress; i += 2) {
+        pl_cache_obj obj = { .key = i * 0x100 };
+        REQUIRE(pl_cache_get(test2, &obj));
+        REQUIRE_CMP(*(uint64_t *) obj.data, ==, i, PRIu64);
+        pl_cache_obj_free(&obj);
+    }
+    REQUIRE_CMP(pl_cache_objects(test2), ==, num_stress / 2, "d");
+    for (uint64_t i = 0; i < num_stress; i++) {
+        pl_cache_obj obj = { .key = i * 0x100 };
+        REQUIRE(pl_cache_get(test2, &obj) == (i & 1));
+        pl_cache_obj_free(&obj);
+    }
+    REQUIRE_CMP(pl_cache_objects(test2), ==, 0, "d");
+    pl_cache_destroy(&test2);
+
+    // Test sharded cache, round-tripping through a regular cache
+    test2 = pl_cache_create(pl_cache_params(
+        .log            = log,
+        .shards         = 4,
+        .max_total_size = 4 * 10 * sizeof(uint64_t),
+    ));
+    REQUIRE_CMP(test2->params.max_object_size, ==, 10 * sizeof(uint64_t), "zu");
+    for (uint64_t i = 0; i < num_stress; i++) {
+        pl_cache_obj obj = { .key = i << 32, .data = &i, .size = sizeof(i) };
+        REQUIRE(pl_cache_try_set(test2, &obj));
+    }
+    REQUIRE_CMP(pl_cache_objects(test2), ==, 4 * 10, "d");
+    for (uint64_t i = num_stress - 4 * 10; i < num_stress; i++) {
+        pl_cache_obj obj = { .key = i << 32 };
+        REQUIRE(pl_cache_get(test2, &obj));
+        REQUIRE_CMP(*(uint64_t *) obj.data, ==, i, PRIu64);
+        pl_cache_set(test2, &obj);
+    }
+
+    size_t save_size = pl_cache_save(test2, NULL, 0);
+    uint8_t *save_buf = malloc(save_size);
+    REQUIRE_CMP(pl_cache_save(test2, save_buf, save_size), ==, save_size, "zu");
+    pl_cache_destroy(&test2);
+    test2 = pl_cache_create(pl_cache_params( .log = log ));
+    REQUIRE_CMP(pl_cache_load(test2, save_buf, save_size), ==, 4 * 10, "d");
+    REQUIRE_CMP(pl_cache_size(test2), ==, 4 * 10 * sizeof(uint64_t), "zu");
+    pl_cache_destroy(&test2);
+    free(save_buf);
+
+    // Test compressed save/load round-trip
+    test2 = pl_cache_create(pl_cache_params( .log = log, .compress = true ));
+    static float ramp[4096];
+    static uint8_t noise[1024];
+    for (int i = 0; i < PL_ARRAY_SIZE(ramp); i++)
+        ramp[i] = i / 4096.0f;
+    for (int i = 0; i < PL_ARRAY_SIZE(noise); i++)
+        noise[i] = RANDOM_U8;
+    REQUIRE(pl_cache_try_set(test2, &(pl_cache_obj) { .key = KEY1, .data = ramp, .size = sizeof(ramp) }));
+    REQUIRE(pl_cache_try_set(test2, &(pl_cache_obj) { .key = KEY2, .data = noise, .size = sizeof(noise) }));
+    REQUIRE(pl_cache_try_set(test2, &(pl_cache_obj) { .key = KEY3, .data = "abc", .size = 3 }));
+    save_size = pl_cache_save(test2, NULL, 0);
+    REQUIRE_CMP(save_size, <, sizeof(ramp) / 2 + sizeof(noise) + 256, "zu");
+    save_buf = malloc(save_size);
+    REQUIRE_CMP(pl_cache_save(test2, save_buf, save_size), ==, save_size, "zu");
+    pl_cache_destroy(&test2);
+    test2 = pl_cache_create(pl_cache_params( .log = log ));
+    REQUIRE_CMP(pl_cache_load(test2, save_buf, save_size), ==, 3, "d");
+    REQUIRE_CMP(pl_cache_size(test2), ==, sizeof(ramp) + sizeof(noise) + 3, "zu");
+    obj1 = (pl_cache_obj) { .key = KEY1 };
+    obj2 = (pl_cache_obj) { .key = KEY2 };
+    REQUIRE(pl_cache_get(test2, &obj1));
+    REQUIRE(pl_cache_get(test2, &obj2));
+    REQUIRE_CMP(obj1.size, ==, sizeof(ramp), "zu");
+    REQUIRE_MEMEQ(obj1.data, ramp, sizeof(ramp));
+    REQUIRE_MEMEQ(obj2.data, noise, sizeof(noise));
+    pl_cache_obj_free(&obj1);
+    pl_cache_obj_free(&obj2);
+    save_buf[save_size - 16] ^= 0xFF; // corrupt data
+    REQUIRE_CMP(pl_cache_load(test2, save_buf, save_size), <, 3, "d");
+    pl_cache_destroy(&test2);
+    free(save_buf);
+
+    // Test cost-aware eviction
+    test2 = pl_cache_create(pl_cache_params(
+        .log            = log,
+        .max_total_size = 24,
+        .cost_aware     = true,
+    ));
+    REQUIRE(pl_cache_try_set(test2, &(pl_cache_obj) { .key = KEY1, .data = zero, .size = 8, .cost = 1.0f }));
+    REQUIRE(pl_cache_try_set(test2, &(pl_cache_obj) { .key = KEY2, .data = zero, .size = 8 }));
+    REQUIRE(pl_cache_try_set(test2, &(pl_cache_obj) { .key = KEY3, .data = zero, .size = 8, .cost = 0.5f }));
+    REQUIRE(pl_cache_try_set(test2, &(pl_cache_obj) { .key = KEY4, .data = zero, .size = 8, .cost = 0.1f }));
+    obj1 = (pl_cache_obj) { .key = KEY1 };
+    obj2 = (pl_cache_obj) { .key = KEY2 };
+    REQUIRE(!pl_cache_get(test2, &obj2)); // cheapest object was evicted
+    REQUIRE(pl_cache_try_set(test2, &(pl_cache_obj) { .key = KEY5, .data = zero, .size = 8, .cost = 0.2f }));
+    obj2 = (pl_cache_obj) { .key = KEY4 };
+    REQUIRE(!pl_cache_get(test2, &obj2));
+    REQUIRE(pl_cache_get(test2, &obj1));
+    REQUIRE_CMP(obj1.cost, ==, 1.0f, "f");
+    pl_cache_set(test2, &obj1);
+    REQUIRE_CMP(pl_cache_objects(test2), ==, 3, "d");
+
+    // Costs survive a round trip through an uncompressed save
+    uint8_t cost_buf[256];
+    const size_t cost_size = pl_cache_save(test2, cost_buf, sizeof(cost_buf));
+    REQUIRE_CMP(cost_size, <=, sizeof(cost_buf), "zu");
+    pl_cache_destroy(&test2);
+    test2 = pl_cache_create(pl_cache_params( .log = log ));
+    REQUIRE_CMP(pl_cache_load(test2, cost_buf, cost_size), ==, 3, "d");
+    obj1 = (pl_cache_obj) { .key = KEY1 };
+    REQUIRE(pl_cache_get(test2, &obj1));
+    REQUIRE_CMP(obj1.cost, ==, 1.0f, "f");
+    pl_cache_obj_free(&obj1);
+    pl_cache_destroy(&test2);
+
+    // Test journaled persistence
+    const char *journal = "test_cache_journal.bin";
+    remove(journal);
+    test2 = pl_cache_create(pl_cache_params( .log = log, .max_total_size = 24 ));
+    REQUIRE_CMP(pl_cache_journal_open(test2, journal), ==, 0, "d");
+    REQUIRE_CMP(pl_cache_journal_open(test2, journal), <, 0, "d");
+    REQUIRE(pl_cache_try_set(test2, &(pl_cache_obj) { .key = KEY1, .data = "abc", .size = 3 }));
+    REQUIRE(pl_cache_try_set(test2, &(pl_cache_obj) { .key = KEY2, .data = "defg", .size = 4 }));
+    REQUIRE(pl_cache_try_set(test2, &(pl_cache_obj) { .key = KEY3, .data = zero, .size = 8 }));
+    const long journal_size = file_size(journal);
+    obj1 = (pl_cache_obj) { .key = KEY1 };
+    REQUIRE(pl_cache_get(test2, &obj1));
+    pl_cache_set(test2, &obj1); // unmodified objects are not re-recorded
+    REQUIRE_CMP(file_size(journal), ==, journal_size, "ld");
+    REQUIRE(pl_cache_try_set(test2, &(pl_cache_obj) { .key = KEY2 })); // delete
+    REQUIRE(pl_cache_try_set(test2, &(pl_cache_obj) { .key = KEY4, .data = zero, .size = 16 })); // evicts KEY3
+    REQUIRE_CMP(file_size(journal), >, journal_size, "ld");
+    REQUIRE(pl_cache_journal_sync(test2, false));
+    pl_cache_destroy(&test2); // no explicit save
+
+    test2 = pl_cache_create(pl_cache_params( .log = log ));
+    REQUIRE_CMP(pl_cache_journal_open(test2, journal), ==, 2, "d");
+    REQUIRE_CMP(pl_cache_size(test2), ==, 3 + 16, "zu");
+    REQUIRE(!pl_cache_get(test2, &(pl_cache_obj) { .key = KEY2 }));
+    REQUIRE(!pl_cache_get(test2, &(pl_cache_obj) { .key = KEY3 }));
+    obj1 = (pl_cache_obj) { .key = KEY1 };
+    REQUIRE(pl_cache_get(test2, &obj1));
+    REQUIRE_MEMEQ(obj1.data, "abc", 3);
+    pl_cache_set(test2, &obj1);
+
+    // Compaction discards all superseded records
+    REQUIRE(pl_cache_journal_sync(test2, true));
+    const long compact_size = file_size(journal);
+    REQUIRE_CMP(compact_size, <, journal_size, "ld");
+    pl_cache_journal_close(test2);
+    pl_cache_destroy(&test2);
+
+    // Simulate a crash in the middle of appending a record
+    FILE *jf = fopen(journal, "ab");
+    REQUIRE(jf);
+    fwrite(ref, 1, 20, jf);
+    fclose(jf);
+    test2 = pl_cache_create(pl_cache_params( .log = log, .compress = true ));
+    REQUIRE_CMP(pl_cache_journal_open(test2, journal), ==, 2, "d");
+    REQUIRE_CMP(file_size(journal), ==, compact_size, "ld");
+    REQUIRE(pl_cache_try_set(test2, &(pl_cache_obj) { .key = KEY5, .data = ramp, .size = sizeof(ramp) }));
+    REQUIRE_CMP(file_size(journal), <, compact_size + sizeof(ramp) / 2, "ld");
+    pl_cache_reset(test2);
+    pl_cache_destroy(&test2);
+
+    test2 = pl_cache_create(pl_cache_params( .log = log ));
+    REQUIRE_CMP(pl_cache_journal_open(test2, journal), ==, 0, "d");
+    REQUIRE(pl_cache_try_set(test2, &(pl_cache_obj) { .key = KEY5, .data = ramp, .size = sizeof(ramp) }));
+    pl_cache_destroy(&test2);
+    test2 = pl_cache_create(pl_cache_params( .log = log ));
+    REQUIRE_CMP(pl_cache_journal_open(test2, journal), ==, 1, "d");
+    obj1 = (pl_cache_obj) { .key = KEY5 };
+    REQUIRE(pl_cache_get(test2, &obj1));
+    REQUIRE_MEMEQ(obj1.data, ramp, sizeof(ramp));
+    pl_cache_obj_free(&obj1);
+    pl_cache_destroy(&test2);
+    remove(journal);
+
+    // Regular cache files are not valid journals
+    jf = fopen(journal, "wb");
+    REQUIRE(jf);
+    fwrite(ref, 1, sizeof(ref), jf);
+    fclose(jf);
+    test2 = pl_cache_create(pl_cache_params( .log = log ));
+    REQUIRE_CMP(pl_cache_journal_open(test2, journal), <, 0, "d");
+    REQUIRE_CMP(pl_cache_objects(test2), ==, 0, "d");
+    pl_cache_destroy(&test2);
+    remove(journal);
+
     pl_cache_destroy(&test);
     pl_log_destroy(&log);
     return 0;
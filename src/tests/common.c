@@ -1,16 +1,111 @@
 #include "tests.h"
+#include "log.h"
+#include "pl_thread_pool.h"
 
 static int irand()
 {
     return rand() - RAND_MAX / 2;
 }
 
+static void square(void *priv, int index)
+{
+    int *out = priv;
+    out[index] = index * index;
+}
+
+struct log_count {
+    int msgs;
+    int dropped;
+    bool bad;
+};
+
+static void count_cb(void *priv, enum pl_log_level level, const char *msg)
+{
+    struct log_count *count = priv;
+    int idx;
+    if (sscanf(msg, "message %d", &idx) == 1) {
+        count->bad |= level != PL_LOG_DEBUG || strlen(msg) != 200;
+        count->msgs++;
+    } else if (sscanf(msg, "Dropped %d", &idx) == 1) {
+        count->dropped += idx;
+    }
+}
+
+static void log_msg(void *priv, int index)
+{
+    pl_log log = priv;
+    pl_debug(log, "message %-*d", 200 - 8, index);
+}
+
+static void trace_ev(void *priv, int index)
+{
+    pl_log log = priv;
+    pl_trace_ev(log, PL_EV_CACHE_INSERT, index % 2 ? pl_clock_now() : 0,
+                0xC0FFEE, index);
+}
+
+static void append_cb(void *priv, size_t size, const void *ptr)
+{
+    pl_str *str = priv;
+    pl_str_append(NULL, str, (pl_str) { (uint8_t *) ptr, size });
+}
+
 int main()
 {
     pl_log log = pl_test_logger();
     pl_log_update(log, NULL);
     pl_log_destroy(&log);
 
+    // Test asynchronous logging, with a buffer small enough to drop messages
+    for (int n = 0; n < 2; n++) {
+        struct log_count count = {0};
+        log = pl_log_create(PL_API_VER, pl_log_params(
+            .log_cb         = count_cb,
+            .log_priv       = &count,
+            .log_level      = PL_LOG_DEBUG,
+            .async_buffer   = n ? (1 << 20) : 1024,
+        ));
+        pl_parallel_for(1000, log_msg, (void *) log);
+        pl_log_update(log, NULL); // flushes pending messages
+        REQUIRE(!count.bad);
+        REQUIRE_CMP(count.msgs + count.dropped, ==, 1000, "d");
+        REQUIRE_CMP(count.dropped, ==, (int) pl_log_dropped(log), "d");
+        if (n)
+            REQUIRE_CMP(count.dropped, ==, 0, "d");
+        pl_log_destroy(&log);
+    }
+
+#ifdef PL_HAVE_TRACE
+    // Test structured tracing, including overwriting old events
+    log = pl_log_create(PL_API_VER, pl_log_params( .trace_events = 64 ));
+    pl_parallel_for(100, trace_ev, (void *) log);
+    pl_str json = {0};
+    REQUIRE_CMP(pl_log_trace_save(log, append_cb, &json), ==, 64, "d");
+    REQUIRE(pl_str_startswith0(json, "{\"traceEvents\":["));
+    REQUIRE(pl_str_endswith0(json, "}\n"));
+    REQUIRE(pl_str_find(json, pl_str0("\"key\":\"0xc0ffee\"")) >= 0);
+    REQUIRE(pl_str_find(json, pl_str0("\"ph\":\"X\"")) >= 0);
+    REQUIRE(pl_str_find(json, pl_str0("\"ph\":\"i\"")) >= 0);
+    json.len = 0;
+    REQUIRE_CMP(pl_log_trace_save(log, append_cb, &json), ==, 0, "d");
+    trace_ev((void *) log, 0);
+    REQUIRE_CMP(pl_log_trace_save(log, append_cb, &json), ==, 1, "d");
+
+    // Test CPU zones and the GPU track
+    json.len = 0;
+    {
+        PL_TRACE_ZONE(log, FINALIZE_PASS);
+        pl_trace_gpu(log, PL_EV_GPU_PASS, pl_clock_now(), 2500, 0xbeef);
+    }
+    REQUIRE_CMP(pl_log_trace_save(log, append_cb, &json), ==, 2, "d");
+    REQUIRE(pl_str_find(json, pl_str0("\"name\":\"finalize_pass\"")) >= 0);
+    REQUIRE(pl_str_find(json, pl_str0("\"tid\":0,")) >= 0);
+    REQUIRE(pl_str_find(json, pl_str0("\"dur\":2.5,")) >= 0);
+    REQUIRE(pl_str_find(json, pl_str0("\"signature\":\"0xbeef\"")) >= 0);
+    pl_free(json.buf);
+    pl_log_destroy(&log);
+#endif
+
     // Test some misc helper functions
     pl_rect2d rc2 = {
         irand(), irand(),
@@ -133,4 +228,54 @@ int main()
     REQUIRE_FEQ(rc.x1, -50, 1e-6);
     REQUIRE_FEQ(rc.y0, 980, 1e-6);
     REQUIRE_FEQ(rc.y1, -100, 1e-6);
+
+    // Test the thread pool, including repeated use of the same workers
+    static int squares[1000];
+    for (int n = 0; n < 3; n++) {
+        memset(squares, 0, sizeof(squares));
+        pl_parallel_for(PL_ARRAY_SIZE(squares), square, squares);
+        for (int i = 0; i < PL_ARRAY_SIZE(squares); i++)
+            REQUIRE_CMP(squares[i], ==, i * i, "d");
+    }
+
+    // Large copies are split into chunks, including a partial last chunk
+    const size_t copy_size = PL_PARALLEL_MEMCPY_MIN + 12345;
+    uint8_t *copy_src = malloc(copy_size), *copy_dst = malloc(copy_size);
+    REQUIRE(copy_src && copy_dst);
+    for (size_t i = 0; i < copy_size; i++)
+        copy_src[i] = i * 7 + (i >> 12);
+    pl_parallel_memcpy(copy_dst, copy_src, copy_size);
+    REQUIRE_MEMEQ(copy_dst, copy_src, copy_size);
+    free(copy_src);
+    free(copy_dst);
+
+    // Test the arena allocator, including in-place growth, copies out of the
+    // arena, regular allocations stolen into it, and chunk coalescing
+    void *owner = pl_tmp(NULL);
+    void *arena = pl_arena_create(owner, 64);
+    for (int n = 0; n < 3; n++) {
+        void *parent = pl_tmp(arena);
+        int *arr = pl_calloc_ptr(parent, 4, arr);
+        for (int i = 0; i < 4; i++)
+            REQUIRE_CMP(arr[i], ==, 0, "d");
+        arr[3] = 42;
+        arr = pl_realloc(parent, arr, 1000 * sizeof(*arr));
+        REQUIRE_CMP(pl_get_size(arr), ==, 1000 * sizeof(*arr), "zu");
+        REQUIRE_CMP(arr[3], ==, 42, "d");
+
+        char *str = pl_str0dup0(parent, "hello");
+        char *copy = pl_steal(owner, str);
+        REQUIRE(copy != str);
+        REQUIRE_STREQ(copy, "hello");
+        pl_free(copy);
+
+        char *heap = pl_str0dup0(NULL, "world");
+        REQUIRE(pl_steal(parent, heap) == heap);
+        REQUIRE_STREQ(heap, "world");
+
+        void *nested = pl_arena_create(parent, 0);
+        REQUIRE_STREQ(pl_str0dup0(nested, "nested"), "nested");
+        pl_free_children(arena);
+    }
+    pl_free(owner);
 }
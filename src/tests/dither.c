@@ -1,6 +1,7 @@
 #include "tests.h"
 
 #include <libplacebo/dither.h>
+#include <libplacebo/dummy.h>
 #include <libplacebo/shaders/dithering.h>
 
 #define SHIFT 4
@@ -25,6 +26,27 @@ int main()
         printf("\n");
     }
 
+    // Ensure every rank appears exactly once, for both the precomputed and
+    // the runtime generated sizes
+    for (int size = 2; size <= 128; size *= 2) {
+        const int size2 = size * size;
+        float *noise = malloc(size2 * sizeof(float));
+        bool *seen = calloc(size2, sizeof(bool));
+        REQUIRE(noise && seen);
+        pl_generate_blue_noise(noise, size);
+        for (int i = 0; i < size2; i++) {
+            float rank = noise[i] * size2;
+            int r = (int) rank;
+            REQUIRE_FEQ(rank, r, 1e-3);
+            REQUIRE_CMP(r, >=, 0, "d");
+            REQUIRE_CMP(r, <, size2, "d");
+            REQUIRE(!seen[r]);
+            seen[r] = true;
+        }
+        free(noise);
+        free(seen);
+    }
+
     // Generate an example of a dither shader
     pl_log log = pl_test_logger();
     pl_shader sh = pl_shader_alloc(log, NULL);
@@ -35,7 +57,22 @@ int main()
     REQUIRE(res);
     printf("Generated dither shader:\n%s\n", res->glsl);
 
+    // Spatiotemporal blue noise re-uses the same LUT with a per-frame offset,
+    // which requires a GPU to upload the LUT to
+    pl_gpu gpu = pl_gpu_dummy_create(log, NULL);
+    pl_shader_obj_destroy(&obj);
+    pl_shader_reset(sh, pl_shader_params( .gpu = gpu, .index = 3 ));
+    pl_shader_dither(sh, 8, &obj, pl_dither_params(
+        .method = PL_DITHER_BLUE_NOISE_TEMPORAL,
+    ));
+    res = pl_shader_finalize(sh);
+    REQUIRE(res);
+    REQUIRE(strstr(res->glsl, "bias = fract("));
+    REQUIRE_CMP(res->num_descriptors, ==, 1, "d");
+    REQUIRE_CMP(res->descriptors[0].desc.type, ==, PL_DESC_SAMPLED_TEX, "d");
+
     pl_shader_obj_destroy(&obj);
     pl_shader_free(&sh);
+    pl_gpu_dummy_destroy(&gpu);
     pl_log_destroy(&log);
 }
@@ -1,6 +1,14 @@
 #include "gpu_tests.h"
 
 #include <libplacebo/dummy.h>
+#include <libplacebo/shaders/custom.h>
+#include <libplacebo/utils/capture.h>
+#include <libplacebo/utils/multigpu.h>
+
+static void fill_lut_data(void *data, const struct sh_lut_params *params)
+{
+    memcpy(data, params->priv, params->width * params->comps * sizeof(float));
+}
 
 int main()
 {
@@ -9,6 +17,24 @@ int main()
     pl_buffer_tests(gpu);
     pl_texture_tests(gpu);
 
+    // Format lookups are memoized, and must return consistent results
+    for (int i = 0; i < 2; i++) {
+        REQUIRE(pl_find_fmt(gpu, PL_FMT_UNORM, 4, 8, 8, 0) == pl_find_named_fmt(gpu, "rgba8"));
+        REQUIRE(!pl_find_fmt(gpu, PL_FMT_UNORM, 4, 128, 0, 0));
+
+        int map[4];
+        pl_fmt fmt = pl_plane_find_fmt(gpu, map, &(struct pl_plane_data) {
+            .type           = PL_FMT_UNORM,
+            .component_size = { 8, 8 },
+            .component_map  = { 2, 1 },
+            .pixel_stride   = 2,
+        });
+        REQUIRE(fmt == pl_find_named_fmt(gpu, "rg8"));
+        REQUIRE_CMP(map[0], ==, 2, "d");
+        REQUIRE_CMP(map[1], ==, 1, "d");
+        REQUIRE_CMP(map[2], ==, -1, "d");
+    }
+
     // Attempt creating a shader and accessing the resulting LUT
     pl_tex dummy = pl_tex_dummy_create(gpu, pl_tex_dummy_params(
         .w = 100,
@@ -62,7 +88,309 @@ int main()
     REQUIRE((res = pl_shader_finalize(sh)));
     REQUIRE_CMP(res->input, ==, PL_SHADER_SIG_SAMPLER, "u");
 
+    // Separable approximations of polar filters use a single compute shader
+    pl_shader_obj sep_lut = NULL;
+    struct pl_sample_filter_params sep_params = filter_params;
+    sep_params.filter.separable_terms = 2;
+    sep_params.lut = &sep_lut;
+    src.tex = dummy;
+    pl_shader_reset(sh, pl_shader_params( .gpu = gpu ));
+    REQUIRE(pl_shader_sample_polar(sh, &src, &sep_params));
+    REQUIRE((res = pl_shader_finalize(sh)));
+    REQUIRE(pl_shader_is_compute(sh));
+    REQUIRE(strstr(res->glsl, "pl_shader_sample_polar (separable)"));
+    pl_shader_obj_destroy(&sep_lut);
+
+    // Orthogonal filters can scale both directions in a single compute shader
+    pl_shader_obj tiled_lut = NULL;
+    struct pl_sample_filter_params tiled_params = {
+        .filter = pl_filter_lanczos,
+        .lut = &tiled_lut,
+    };
+    struct pl_sample_src tiled_src = { .tex = dummy, .new_w = 40, .new_h = 30 };
+    pl_shader_reset(sh, pl_shader_params( .gpu = gpu ));
+    REQUIRE(pl_shader_sample_ortho2_tiled(sh, &tiled_src, &tiled_params));
+    REQUIRE((res = pl_shader_finalize(sh)));
+    REQUIRE(pl_shader_is_compute(sh));
+    REQUIRE(strstr(res->glsl, "pl_shader_sample_ortho2_tiled"));
+    REQUIRE_CMP(res->output, ==, PL_SHADER_SIG_COLOR, "u");
+
+    // ... but refuse without modifying the shader if compute is disabled
+    tiled_params.no_compute = true;
+    pl_shader_reset(sh, pl_shader_params( .gpu = gpu ));
+    REQUIRE(!pl_shader_sample_ortho2_tiled(sh, &tiled_src, &tiled_params));
+    REQUIRE(pl_shader_sample_ortho2(sh, pl_sample_src(
+        .tex   = dummy,
+        .new_w = 40,
+        .new_h = 100,
+    ), &tiled_params));
+    REQUIRE((res = pl_shader_finalize(sh)));
+    REQUIRE(!pl_shader_is_compute(sh));
+    pl_shader_obj_destroy(&tiled_lut);
+    src.tex = NULL;
+
+    // Immutable LUT textures are shared between independent shader objects
+    pl_shader_obj dither[2] = {0};
+    pl_tex dither_tex[2] = {0};
+    for (int i = 0; i < 2; i++) {
+        pl_shader_reset(sh, pl_shader_params( .gpu = gpu ));
+        pl_shader_dither(sh, 8, &dither[i], &pl_dither_default_params);
+        REQUIRE((res = pl_shader_finalize(sh)));
+        for (int n = 0; n < res->num_descriptors; n++) {
+            if (res->descriptors[n].desc.type == PL_DESC_SAMPLED_TEX)
+                dither_tex[i] = res->descriptors[n].binding.object;
+        }
+        REQUIRE(dither_tex[i]);
+    }
+    REQUIRE(dither_tex[0] == dither_tex[1]);
+    pl_shader_obj_destroy(&dither[0]);
+    REQUIRE(pl_tex_dummy_data(dither_tex[1]));
+    pl_shader_obj_destroy(&dither[1]);
+
+    // Color mapping between trivially different color spaces should not
+    // round-trip through linear light
+    struct pl_color_space csp = pl_color_space_bt709;
+    csp.hdr.max_cll = 100;
+    pl_shader_reset(sh, pl_shader_params( .gpu = gpu ));
+    REQUIRE(pl_shader_sample_direct(sh, pl_sample_src( .tex = dummy )));
+    pl_shader_color_map_ex(sh, NULL, pl_color_map_args(
+        .src = csp,
+        .dst = pl_color_space_bt709,
+    ));
+    REQUIRE((res = pl_shader_finalize(sh)));
+    REQUIRE(!strstr(res->glsl, "pl_shader_linearize"));
+
+    pl_shader_reset(sh, pl_shader_params( .gpu = gpu ));
+    REQUIRE(pl_shader_sample_direct(sh, pl_sample_src( .tex = dummy )));
+    pl_shader_color_map_ex(sh, NULL, pl_color_map_args(
+        .src = pl_color_space_bt709,
+        .dst = pl_color_space_srgb,
+    ));
+    REQUIRE((res = pl_shader_finalize(sh)));
+    REQUIRE(strstr(res->glsl, "pl_shader_linearize"));
+
+    // Reduced precision only applies to GLSL ES and Vulkan
+    struct pl_shader_params sh_params = {
+        .gpu = gpu,
+        .glsl = gpu->glsl,
+        .low_precision = true,
+    };
+
+    pl_shader_reset(sh, &sh_params);
+    REQUIRE(pl_shader_sample_polar(sh, &src, &filter_params));
+    REQUIRE((res = pl_shader_finalize(sh)));
+    REQUIRE(!strstr(res->glsl, "mediump"));
+
+    sh_params.glsl.vulkan = true;
+    pl_shader_reset(sh, &sh_params);
+    REQUIRE(pl_shader_sample_polar(sh, &src, &filter_params));
+    REQUIRE((res = pl_shader_finalize(sh)));
+    REQUIRE(strstr(res->glsl, "mediump"));
+
+    // Approximate PQ round-trips without evaluating `pow`
+    pl_shader_reset(sh, pl_shader_params( .gpu = gpu, .fast_transfer = true ));
+    pl_shader_linearize(sh, &pl_color_space_hdr10);
+    pl_shader_delinearize(sh, &pl_color_space_hdr10);
+    REQUIRE((res = pl_shader_finalize(sh)));
+    REQUIRE(!strstr(res->glsl, "pow("));
+
+    // YADIF should share the neighbouring lines via shmem when using compute
+    struct pl_field_pair field = pl_field_pair(dummy);
+    pl_shader_reset(sh, pl_shader_params( .gpu = gpu ));
+    pl_shader_deinterlace(sh, pl_deinterlace_source(
+        .prev  = field,
+        .cur   = field,
+        .next  = field,
+        .field = PL_FIELD_TOP,
+    ), NULL);
+    REQUIRE((res = pl_shader_finalize(sh)));
+    REQUIRE(pl_shader_is_compute(sh));
+    REQUIRE(strstr(res->glsl, "shared float"));
+
+    // Batched deinterlacing packs all sources into one output
+    const struct pl_deinterlace_source batch[2] = {
+        { .prev = field, .cur = field, .next = field, .field = PL_FIELD_TOP },
+        { .prev = field, .cur = field, .next = field, .field = PL_FIELD_BOTTOM },
+    };
+
+    const pl_rect2d rects[2] = {
+        { 0,   0, 100, 100 },
+        { 100, 0, 200, 100 },
+    };
+
+    pl_shader_reset(sh, pl_shader_params( .gpu = gpu ));
+    pl_shader_deinterlace_batch(sh, batch, rects, 2, NULL);
+    REQUIRE((res = pl_shader_finalize(sh)));
+    REQUIRE(!strstr(res->glsl, "shared float"));
+    int out_w, out_h;
+    REQUIRE(pl_shader_output_size(sh, &out_w, &out_h));
+    REQUIRE_CMP(out_w, ==, 200, "d");
+    REQUIRE_CMP(out_h, ==, 100, "d");
+
+    // Rects must match the source size
+    pl_shader_reset(sh, pl_shader_params( .gpu = gpu ));
+    pl_shader_deinterlace_batch(sh, batch, &(pl_rect2d) { 0, 0, 50, 50 }, 1, NULL);
+    REQUIRE(!pl_shader_finalize(sh));
+
+    // Polynomial-only reshaping components get baked into a LUT
+    pl_shader_obj dovi_lut = NULL;
+    pl_shader_reset(sh, pl_shader_params( .gpu = gpu ));
+    REQUIRE(pl_shader_sample_direct(sh, pl_sample_src( .tex = dummy )));
+    pl_shader_dovi_reshape_lut(sh, &dovi_meta, &dovi_lut);
+    REQUIRE((res = pl_shader_finalize(sh)));
+    REQUIRE(dovi_lut);
+
+    const float *dovi_data = NULL;
+    for (int n = 0; n < res->num_descriptors; n++) {
+        const struct pl_shader_desc *sd = &res->descriptors[n];
+        if (sd->desc.type == PL_DESC_SAMPLED_TEX)
+            dovi_data = PL_DEF((float *) pl_tex_dummy_data(sd->binding.object), dovi_data);
+    }
+
+    REQUIRE(dovi_data);
+    const float x = 480 / 1023.0f;
+    const float *k = dovi_meta.comp[0].poly_coeffs[2];
+    REQUIRE_FEQ(dovi_data[480 * 4 + 0], (k[2] * x + k[1]) * x + k[0], 1e-6);
+    REQUIRE_FEQ(dovi_data[480 * 4 + 1], x, 1e-6); // MMR, not baked
+
+    // User shader expressions may refer to parameters declared later on
+    static const char *user_shader =
+        "//!HOOK MAIN                                                   \n"
+        "//!WHEN HOOKED.w scale * 300 > mode SLOW = +                   \n"
+        "vec4 hook() { return HOOKED_tex(HOOKED_pos); }                 \n"
+        "                                                               \n"
+        "//!HOOK LUMA                                                   \n"
+        "//!WHEN LUMA.w undefined >                                     \n"
+        "vec4 hook() { return HOOKED_tex(HOOKED_pos); }                 \n"
+        "                                                               \n"
+        "//!PARAM scale                                                 \n"
+        "//!TYPE int                                                    \n"
+        "2                                                              \n"
+        "                                                               \n"
+        "//!PARAM mode                                                  \n"
+        "//!TYPE ENUM int                                               \n"
+        "FAST                                                           \n"
+        "SLOW                                                           \n";
+
+    const struct pl_hook *hook;
+    hook = pl_mpv_user_shader_parse(gpu, user_shader, strlen(user_shader));
+    REQUIRE(hook);
+    struct pl_hook_params hook_params = {
+        .gpu        = gpu,
+        .stage      = PL_HOOK_RGB,
+        .tex        = dummy,
+        .rect       = { 0, 0, 100, 100 },
+        .src_rect   = { 0, 0, 100, 100 },
+        .dst_rect   = { 0, 0, 100, 100 },
+    };
+
+    REQUIRE(!hook->hook(hook->priv, &hook_params).failed); // skipped
+    hook_params.stage = PL_HOOK_LUMA_INPUT;
+    REQUIRE(hook->hook(hook->priv, &hook_params).failed);
+    pl_mpv_user_shader_destroy(&hook);
+
+    // Passes which never run, or whose output is never consumed, are dropped
+    static const char *dead_shader =
+        "//!HOOK CHROMA                                                 \n"
+        "//!SAVE UNUSED                                                 \n"
+        "vec4 hook() { return HOOKED_tex(HOOKED_pos); }                 \n"
+        "                                                               \n"
+        "//!HOOK CHROMA                                                 \n"
+        "//!SAVE USED                                                   \n"
+        "vec4 hook() { return HOOKED_tex(HOOKED_pos); }                 \n"
+        "                                                               \n"
+        "//!HOOK MAIN                                                   \n"
+        "//!WHEN 0                                                      \n"
+        "vec4 hook() { return HOOKED_tex(HOOKED_pos); }                 \n"
+        "                                                               \n"
+        "//!HOOK LUMA                                                   \n"
+        "//!BIND USED                                                   \n"
+        "vec4 hook() { return USED_tex(USED_pos); }                     \n";
+
+    hook = pl_mpv_user_shader_parse(gpu, dead_shader, strlen(dead_shader));
+    REQUIRE(hook);
+    REQUIRE_CMP(hook->stages, ==, PL_HOOK_CHROMA_INPUT | PL_HOOK_LUMA_INPUT, "u");
+    pl_mpv_user_shader_destroy(&hook);
+
+    // Alternate frame rendering cycles through all GPUs
+    pl_gpu gpu2 = pl_gpu_dummy_create(log, NULL);
+    pl_multigpu mg = pl_multigpu_create(log, pl_multigpu_params(
+        .gpus = (const pl_gpu[]) { gpu, gpu2 },
+        .num_gpus = 2,
+    ));
+    REQUIRE(mg);
+    REQUIRE(pl_multigpu_gpu(mg, 0) == gpu);
+    REQUIRE(pl_multigpu_gpu(mg, 3) == gpu2);
+    REQUIRE(pl_multigpu_renderer(mg, 1) != pl_multigpu_renderer(mg, 2));
+    REQUIRE(!pl_multigpu_present(mg, 0, &(struct pl_frame) {0}, 0));
+    pl_multigpu_destroy(&mg);
+    pl_gpu_dummy_destroy(&gpu2);
+
+    // Uniform buffer writes are captured and replayed on other GPUs
+    pl_capture cap = pl_capture_create(gpu);
+    REQUIRE(cap);
+    REQUIRE(!pl_capture_create(gpu));
+    pl_buf ubo = pl_buf_create(gpu, pl_buf_params(
+        .size           = 256,
+        .uniform        = true,
+        .host_writable  = true,
+    ));
+    REQUIRE(ubo);
+    pl_buf_write(gpu, ubo, 0, (float[4]) { 1.0, 2.0, 3.0, 4.0 }, sizeof(float[4]));
+    pl_buf_destroy(gpu, &ubo);
+    size_t cap_size = pl_capture_save(cap, NULL, 0);
+    uint8_t *cap_data = malloc(cap_size);
+    REQUIRE(cap_data);
+    REQUIRE_CMP(pl_capture_save(cap, cap_data, cap_size), ==, cap_size, "zu");
+    pl_capture_destroy(&cap);
+
+    gpu2 = pl_gpu_dummy_create(log, NULL);
+    REQUIRE(pl_capture_replay(gpu2, cap_data, cap_size, pl_capture_replay_params()));
+    REQUIRE(!pl_capture_replay(gpu2, cap_data, cap_size - 1, pl_capture_replay_params()));
+    cap_data[0] ^= 0xFF; // invalid magic bytes
+    REQUIRE(!pl_capture_replay(gpu2, cap_data, cap_size, pl_capture_replay_params()));
+    pl_gpu_dummy_destroy(&gpu2);
+    free(cap_data);
+
+    // Storage buffer LUTs are updated in-place when their contents change
+    float lut_data[64][3];
+    for (int i = 0; i < 64; i++) {
+        for (int c = 0; c < 3; c++)
+            lut_data[i][c] = i * (c + 1);
+    }
+
+    pl_shader_obj ssbo_lut = NULL;
+    pl_buf ssbo = NULL;
+    for (int i = 0; i < 2; i++) {
+        pl_shader_reset(sh, pl_shader_params( .gpu = gpu ));
+        REQUIRE(sh_lut(sh, sh_lut_params(
+            .object     = &ssbo_lut,
+            .var_type   = PL_VAR_FLOAT,
+            .lut_type   = SH_LUT_STORAGE,
+            .width      = 64,
+            .comps      = 3,
+            .dynamic    = true,
+            .update     = i > 0,
+            .fill       = fill_lut_data,
+            .priv       = lut_data,
+        )));
+        REQUIRE((res = pl_shader_finalize(sh)));
+        REQUIRE_CMP(res->num_descriptors, ==, 1, "d");
+        REQUIRE_CMP(res->descriptors[0].desc.type, ==, PL_DESC_BUF_STORAGE, "u");
+        pl_buf buf = res->descriptors[0].binding.object;
+        REQUIRE(!ssbo || buf == ssbo);
+        ssbo = buf;
+
+        const float *data = (float *) pl_buf_dummy_data(buf);
+        REQUIRE(data);
+        REQUIRE_FEQ(data[17 * 3 + 1], lut_data[17][1], 1e-6);
+        REQUIRE_FEQ(data[18 * 3 + 1], lut_data[18][1], 1e-6);
+        lut_data[17][1] = -1.0f;
+    }
+    pl_shader_obj_destroy(&ssbo_lut);
+
     pl_shader_free(&sh);
+    pl_shader_obj_destroy(&dovi_lut);
     pl_shader_obj_destroy(&lut);
     pl_tex_destroy(gpu, &dummy);
     pl_gpu_dummy_destroy(&gpu);
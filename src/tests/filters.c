@@ -74,8 +74,73 @@ int main()
 
         }
 
+        // Identical parameters should return the same (shared) filter
+        pl_filter flt2 = pl_filter_generate(log, &flt->params);
+        REQUIRE(flt2 == flt);
+        pl_filter_free(&flt2);
+        REQUIRE(!flt2);
+        REQUIRE_CMP(flt->params.lut_entries, ==, 256, "d");
+
+        pl_filter flt3 = pl_filter_generate(log, pl_filter_params(
+            .config      = *conf,
+            .lut_entries = 128,
+            .cutoff      = 1e-3,
+        ));
+        REQUIRE(flt3 && flt3 != flt);
+        pl_filter_free(&flt3);
+        pl_filter_free(&flt);
+    }
+
+    // Separable approximations of polar filters should converge to the
+    // original 2D kernel as the number of terms grows
+    double prev_err = INFINITY;
+    for (int terms = 1; terms <= PL_FILTER_MAX_TERMS; terms++) {
+        struct pl_filter_config conf = pl_filter_ewa_lanczossharp;
+        conf.separable_terms = terms;
+        printf("Testing %d separable terms\n", terms);
+        pl_filter flt = pl_filter_generate(log, pl_filter_params(
+            .config      = conf,
+            .lut_entries = 64,
+            .cutoff      = 1e-3,
+        ));
+        REQUIRE(flt);
+        REQUIRE_CMP(flt->num_terms, ==, terms, "d");
+        REQUIRE_CMP(flt->row_stride, >, flt->row_size, "d");
+
+        // Compare both at texel centers (phase 0) and half-way between them
+        double err = 0.0;
+        for (int phase = 0; phase < flt->params.lut_entries; phase += 63) {
+            const double center = flt->row_size / 2 - 1 + phase / 63.0;
+            for (int y = 0; y < flt->row_size; y++) {
+                for (int x = 0; x < flt->row_size; x++) {
+                    double w = 0.0;
+                    for (int k = 0; k < terms; k++) {
+                        const float *row = flt->terms[k] + phase * flt->row_stride;
+                        w += flt->term_signs[k] * row[x] * row[y];
+                    }
+                    const double dx = x - center, dy = y - center;
+                    double ref = pl_filter_sample(&conf, sqrt(dx * dx + dy * dy));
+                    if (dx * dx + dy * dy > flt->radius * flt->radius)
+                        ref = 0.0;
+                    err = fmax(err, fabs(w - ref));
+                }
+            }
+
+            for (int k = 0; k < terms; k++) {
+                const float *row = flt->terms[k] + phase * flt->row_stride;
+                float sum = 0.0;
+                for (int n = 0; n < flt->row_size; n++)
+                    sum += row[n];
+                REQUIRE_FEQ(row[flt->row_size], sum, 1e-5);
+            }
+        }
+
+        printf("max error: %g\n", err);
+        REQUIRE_CMP(err, <=, prev_err + 1e-6, "g");
+        prev_err = err;
         pl_filter_free(&flt);
     }
+    REQUIRE_CMP(prev_err, <=, 1e-2, "g");
 
     pl_log_destroy(&log);
 }
@@ -2,7 +2,10 @@
 #include "shaders.h"
 
 #include <libplacebo/renderer.h>
+#include <libplacebo/utils/capture.h>
 #include <libplacebo/utils/frame_queue.h>
+#include <libplacebo/utils/hdr_analysis.h>
+#include <libplacebo/utils/pipeline.h>
 #include <libplacebo/utils/upload.h>
 
 //#define PRINT_OUTPUT
@@ -189,6 +192,10 @@ static void pl_test_roundtrip(pl_gpu gpu, pl_tex tex[2],
         .priv = &ran_dl,
     }));
 
+    // Polling must eventually report the texture as idle
+    while (pl_tex_poll(gpu, dst_tex, UINT64_MAX))
+        ; // do nothing
+
     pl_gpu_finish(gpu);
     if (gpu->limits.callbacks)
         REQUIRE(ran_ul && ran_dl);
@@ -312,6 +319,157 @@ static void pl_planar_tests(pl_gpu gpu)
     pl_tex_destroy(gpu, &tex);
 }
 
+static void pl_upload_ring_tests(pl_gpu gpu)
+{
+    const int width = 32, height = 16;
+    uint8_t data[3][height][width];
+    for (int i = 0; i < PL_ARRAY_SIZE(data); i++) {
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++)
+                data[i][y][x] = RANDOM_U8;
+        }
+    }
+
+    pl_fmt fmt = pl_find_named_fmt(gpu, "r8");
+    if (!fmt || !(fmt->caps & PL_FMT_CAP_BLITTABLE))
+        return;
+
+    pl_tex dst = pl_tex_create(gpu, pl_tex_params(
+        .w              = width,
+        .h              = height,
+        .format         = fmt,
+        .blit_dst       = true,
+        .host_readable  = true,
+    ));
+    if (!dst)
+        return;
+
+    // Use fewer buffers than uploads, to exercise waiting on the ring
+    pl_upload_ring ring = pl_upload_ring_create(gpu, 2);
+    pl_tex tex = NULL;
+    for (int i = 0; i < PL_ARRAY_SIZE(data); i++) {
+        struct pl_plane plane;
+        REQUIRE(pl_upload_ring_plane(ring, &plane, &tex, &(struct pl_plane_data) {
+            .type           = PL_FMT_UNORM,
+            .width          = width,
+            .height         = height,
+            .component_size = { 8 },
+            .component_map  = { 0 },
+            .pixel_stride   = 1,
+            .pixels         = data[i],
+        }));
+        REQUIRE_CMP(plane.components, ==, 1, "d");
+        if (!tex->params.blit_src)
+            break;
+
+        uint8_t out[height][width];
+        pl_tex_blit(gpu, pl_tex_blit_params( .src = tex, .dst = dst ));
+        REQUIRE(pl_tex_download(gpu, pl_tex_transfer_params(
+            .tex = dst,
+            .ptr = out,
+        )));
+        REQUIRE_MEMEQ(out, data[i], sizeof(out));
+    }
+
+    pl_upload_ring_destroy(&ring);
+    pl_tex_destroy(gpu, &tex);
+    pl_tex_destroy(gpu, &dst);
+}
+
+static void pl_upload_unpack_tests(pl_gpu gpu)
+{
+    // Three packed 12-bit components, with no matching texture format
+    const int width = 40, height = 8;
+    uint8_t data[height][width][5];
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            for (int i = 0; i < 5; i++)
+                data[y][x][i] = RANDOM_U8;
+        }
+    }
+
+    struct pl_plane_data plane_data = {
+        .type           = PL_FMT_UNORM,
+        .width          = width,
+        .height         = height,
+        .component_size = { 12, 12, 12 },
+        .component_map  = { 0, 1, 2 },
+        .pixel_stride   = 5,
+        .pixels         = data,
+    };
+
+    REQUIRE(!pl_plane_find_fmt(gpu, NULL, &plane_data));
+    if (!gpu->glsl.compute || !gpu->limits.max_ssbo_size)
+        return;
+
+    pl_tex tex = NULL;
+    struct pl_plane plane;
+    REQUIRE(pl_upload_plane(gpu, &plane, &tex, &plane_data));
+    REQUIRE_CMP(plane.components, ==, 3, "d");
+    for (int i = 0; i < 3; i++)
+        REQUIRE_CMP(plane.component_mapping[i], ==, i, "d");
+
+    // Big endian packed pixels are swapped as whole words
+    uint16_t be_data[height][width];
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++)
+            be_data[y][x] = RANDOM_U8 << 8 | RANDOM_U8;
+    }
+
+    pl_tex be_tex = NULL;
+    REQUIRE(pl_upload_plane(gpu, NULL, &be_tex, &(struct pl_plane_data) {
+        .type           = PL_FMT_UNORM,
+        .width          = width,
+        .height         = height,
+        .component_size = { 5, 6, 5 },
+        .component_map  = { 2, 1, 0 },
+        .pixel_stride   = 2,
+        .swapped        = true,
+        .pixels         = be_data,
+    }));
+    pl_tex_destroy(gpu, &be_tex);
+
+    pl_fmt fmt = tex->params.format;
+    if (!tex->params.blit_src || fmt->num_components != 4 ||
+        fmt->component_depth[0] != 16 || !pl_fmt_is_ordered(fmt))
+    {
+        pl_tex_destroy(gpu, &tex);
+        return;
+    }
+
+    pl_tex dst = pl_tex_create(gpu, pl_tex_params(
+        .w              = width,
+        .h              = height,
+        .format         = fmt,
+        .blit_dst       = true,
+        .host_readable  = fmt->caps & PL_FMT_CAP_HOST_READABLE,
+    ));
+
+    if (dst && dst->params.host_readable) {
+        uint16_t out[height][width][4];
+        pl_tex_blit(gpu, pl_tex_blit_params( .src = tex, .dst = dst ));
+        REQUIRE(pl_tex_download(gpu, pl_tex_transfer_params(
+            .tex = dst,
+            .ptr = out,
+        )));
+
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                const uint8_t *p = data[y][x];
+                const uint64_t bits = p[0] | p[1] << 8 | p[2] << 16 |
+                                      (uint64_t) p[3] << 24 | (uint64_t) p[4] << 32;
+                for (int i = 0; i < 3; i++) {
+                    const unsigned ref = (bits >> (i * 12)) & 0xFFF;
+                    REQUIRE_FEQ(out[y][x][i] / 65535.0, ref / 4095.0, 1e-4);
+                }
+            }
+        }
+    }
+
+    pl_tex_destroy(gpu, &dst);
+    pl_tex_destroy(gpu, &tex);
+}
+
 static void pl_shader_tests(pl_gpu gpu)
 {
     if (gpu->glsl.version < 410)
@@ -505,6 +663,55 @@ static void pl_shader_tests(pl_gpu gpu)
 
     TEST_FBO_PATTERN(1e-6, "%s", "using custom vertices");
 
+    // Test rapidly updating uniforms of the same pass, both inside and
+    // outside of batches
+    for (int i = 0; i < 16; i++) {
+        if (i == 8)
+            pl_dispatch_batch_begin(dp);
+        float val = i / 16.0f;
+        sh = pl_dispatch_begin(dp);
+        REQUIRE(pl_shader_custom(sh, &(struct pl_custom_shader) {
+            .body           = "color = vec4(val);",
+            .output         = PL_SHADER_SIG_COLOR,
+            .num_variables  = 1,
+            .variables      = &(struct pl_shader_var) {
+                .var  = pl_var_float("val"),
+                .data = &val,
+            },
+        }));
+        REQUIRE(pl_dispatch_finish(dp, pl_dispatch_params(
+            .shader = &sh,
+            .target = fbo,
+        )));
+
+        float px[FBO_H * FBO_W * 4];
+        REQUIRE(pl_tex_download(gpu, &(struct pl_tex_transfer_params) {
+            .tex = fbo,
+            .ptr = px,
+        }));
+        REQUIRE_FEQ(px[0], val, 1e-6);
+    }
+    pl_dispatch_batch_end(dp);
+
+    // Test sharing passes between dispatch objects
+    pl_dispatch_pool pool = pl_dispatch_pool_create(gpu->log, gpu);
+    pl_dispatch shared_dp[2];
+    for (int i = 0; i < PL_ARRAY_SIZE(shared_dp); i++) {
+        shared_dp[i] = pl_dispatch_create_shared(pool);
+        pl_shader ssh = pl_dispatch_begin(shared_dp[i]);
+        REQUIRE(pl_shader_custom(ssh, &(struct pl_custom_shader) {
+            .body       = "color = vec4(0.5);",
+            .output     = PL_SHADER_SIG_COLOR,
+        }));
+        REQUIRE(pl_dispatch_finish(shared_dp[i], pl_dispatch_params(
+            .shader = &ssh,
+            .target = fbo,
+        )));
+    }
+    for (int i = 0; i < PL_ARRAY_SIZE(shared_dp); i++)
+        pl_dispatch_destroy(&shared_dp[i]);
+    pl_dispatch_pool_destroy(&pool);
+
     static float src_data[FBO_H * FBO_W * 4] = {0};
     memcpy(src_data, test_data, sizeof(src_data));
 
@@ -591,6 +798,21 @@ static void pl_shader_tests(pl_gpu gpu)
         TEST_FBO_PATTERN(epsilon, "color system %d", (int) sys);
     }
 
+    // Test switching back and forth between specialization constant values
+    for (int i = 0; i < 6; i++) {
+        const float scale = (i & 1) ? 4.0f : 0.5f;
+        sh = pl_dispatch_begin(dp);
+        pl_shader_sample_nearest(sh, pl_sample_src( .tex = src ));
+        GLSL("color.rg *= "$"; color.rg *= "$"; \n",
+             SH_FLOAT(scale), SH_FLOAT(1.0f / scale));
+        REQUIRE(pl_dispatch_finish(dp, pl_dispatch_params(
+            .shader = &sh,
+            .target = fbo,
+        )));
+
+        TEST_FBO_PATTERN(1e-6, "constant scale %f", scale);
+    }
+
     // Repeat this a few times to test the caching
     pl_cache cache = pl_cache_create(pl_cache_params( .log = gpu->log ));
     pl_gpu_set_cache(gpu, cache);
@@ -674,6 +896,59 @@ static void pl_shader_tests(pl_gpu gpu)
         real_peak = pl_hdr_rescale(PL_HDR_PQ, PL_HDR_NORM, real_peak);
         REQUIRE_FEQ(peak, real_peak, 1e-3);
         REQUIRE_FEQ(avg, real_avg, 1e-2);
+
+        // Test delayed readback with multiple frames in flight
+        peak_params.allow_delayed = true;
+        peak_params.max_delay = 3;
+        for (int i = 0; i < 8; i++) {
+            sh = pl_dispatch_begin(dp);
+            pl_shader_sample_nearest(sh, pl_sample_src( .tex = src ));
+            REQUIRE(pl_shader_detect_peak(sh, csp_gamma22, &peak_state, &peak_params));
+            REQUIRE(pl_dispatch_compute(dp, &(struct pl_dispatch_compute_params) {
+                .shader = &sh,
+                .width = fbo->params.w,
+                .height = fbo->params.h,
+            }));
+            REQUIRE(pl_get_detected_peak(peak_state, &peak, &avg));
+            REQUIRE_FEQ(peak, real_peak, 1e-3);
+        }
+
+        pl_gpu_finish(gpu);
+        REQUIRE(pl_get_detected_peak(peak_state, &peak, &avg));
+        REQUIRE_FEQ(peak, real_peak, 1e-3);
+        REQUIRE_FEQ(avg, real_avg, 1e-2);
+
+        // Strided detection only measures every other pixel in each direction
+        peak_params.allow_delayed = false;
+        peak_params.stride = 2;
+        sh = pl_dispatch_begin(dp);
+        pl_shader_sample_nearest(sh, pl_sample_src( .tex = src ));
+        REQUIRE(pl_shader_detect_peak(sh, csp_gamma22, &peak_state, &peak_params));
+        REQUIRE(pl_dispatch_compute(dp, &(struct pl_dispatch_compute_params) {
+            .shader = &sh,
+            .width = fbo->params.w,
+            .height = fbo->params.h,
+        }));
+        REQUIRE(pl_get_detected_peak(peak_state, &peak, &avg));
+
+        real_peak = real_avg = 0;
+        for (int y = 0; y < FBO_H; y += 2) {
+            for (int x = 0; x < FBO_W; x += 2) {
+                float *color = &src_data[(y * FBO_W + x) * 4];
+                float luma = 0.212639f * powf(color[0], 2.2f) +
+                             0.715169f * powf(color[1], 2.2f) +
+                             0.072192f * powf(color[2], 2.2f);
+                luma = pl_hdr_rescale(PL_HDR_NORM, PL_HDR_PQ, luma);
+                real_peak = PL_MAX(real_peak, luma);
+                real_avg += luma;
+            }
+        }
+        real_avg = real_avg / (PL_DIV_UP(FBO_W, 2) * PL_DIV_UP(FBO_H, 2));
+
+        real_avg  = pl_hdr_rescale(PL_HDR_PQ, PL_HDR_NORM, real_avg);
+        real_peak = pl_hdr_rescale(PL_HDR_PQ, PL_HDR_NORM, real_peak);
+        REQUIRE_FEQ(peak, real_peak, 1e-3);
+        REQUIRE_FEQ(avg, real_avg, 1e-2);
     }
 
     pl_dispatch_abort(dp, &sh);
@@ -763,6 +1038,16 @@ static void pl_shader_tests(pl_gpu gpu)
         .target = fbo,
     }));
 
+    pl_shader_obj dovi_lut = NULL;
+    sh = pl_dispatch_begin(dp);
+    pl_shader_sample_direct(sh, pl_sample_src( .tex = src ));
+    pl_shader_dovi_reshape_lut(sh, &dovi_meta, &dovi_lut);
+    REQUIRE(pl_dispatch_finish(dp, &(struct pl_dispatch_params) {
+        .shader = &sh,
+        .target = fbo,
+    }));
+    pl_shader_obj_destroy(&dovi_lut);
+
     // Test deinterlacing
     sh = pl_dispatch_begin(dp);
     pl_shader_deinterlace(sh, pl_deinterlace_source( .cur = pl_field_pair(src) ), NULL);
@@ -771,6 +1056,16 @@ static void pl_shader_tests(pl_gpu gpu)
         .target = fbo,
     )));
 
+    sh = pl_dispatch_begin(dp);
+    pl_shader_deinterlace_batch(sh, pl_deinterlace_source(
+        .cur   = pl_field_pair(src),
+        .field = PL_FIELD_TOP,
+    ), &(pl_rect2d) { 0, 0, FBO_W, FBO_H }, 1, NULL);
+    REQUIRE(pl_dispatch_finish(dp, pl_dispatch_params(
+        .shader = &sh,
+        .target = fbo,
+    )));
+
     // Test error diffusion
     if (fbo->params.storable) {
         for (int i = 0; i < pl_num_error_diffusion_kernels; i++) {
@@ -794,6 +1089,26 @@ static void pl_shader_tests(pl_gpu gpu)
                 .dispatch_size = {1, 1, 1},
             )));
         }
+
+        // Tiled error diffusion, with partial tiles along both edges
+        const int tile_w = FBO_W / 3, tile_h = FBO_H / 3;
+        sh = pl_dispatch_begin(dp);
+        bool ok = pl_shader_error_diffusion(sh, pl_error_diffusion_params(
+            .input_tex  = src,
+            .output_tex = fbo,
+            .new_depth  = 8,
+            .tile_w     = tile_w,
+            .tile_h     = tile_h,
+        ));
+
+        if (ok) {
+            REQUIRE(pl_dispatch_compute(dp, pl_dispatch_compute_params(
+                .shader = &sh,
+                .dispatch_size = { PL_DIV_UP(FBO_W, tile_w), PL_DIV_UP(FBO_H, tile_h), 1 },
+            )));
+        } else {
+            pl_dispatch_abort(dp, &sh);
+        }
     }
 
     pl_dispatch_destroy(&dp);
@@ -914,6 +1229,19 @@ static const char *user_shader_tests[] = {
     "    return NATIVEBIG_texOff(0);                                        \n"
     "}                                                                      \n",
 
+    // Test fixed-offset convolution (eligible for compute tiling)
+    "//!HOOK LUMA                                                           \n"
+    "//!DESC cross-shaped blur                                              \n"
+    "//!BIND HOOKED                                                         \n"
+    "                                                                       \n"
+    "vec4 hook()                                                            \n"
+    "{                                                                      \n"
+    "    vec4 sum = HOOKED_tex(HOOKED_pos);                                 \n"
+    "    sum += HOOKED_texOff(vec2(-2, 0)) + HOOKED_texOff(vec2(2.0, 0.0)); \n"
+    "    sum += HOOKED_texOff(ivec2(0, -1)) + HOOKED_texOff(vec2(0, 1));    \n"
+    "    return sum / 5.0;                                                  \n"
+    "}                                                                      \n",
+
     // Test use of textures
     "//!HOOK MAIN                                                           \n"
     "//!DESC turn everything into colorful pixels                           \n"
@@ -1043,6 +1371,23 @@ static void render_info_cb(void *priv, const struct pl_render_info *info)
            info->pass->shader->description);
 }
 
+static void count_capture_passes(void *priv, const struct pl_capture_pass_info *info)
+{
+    int *num = priv;
+    REQUIRE_CMP(info->index, ==, *num, "d");
+    REQUIRE_CMP(info->runs, >, 0, "d");
+    REQUIRE(info->shader);
+    (*num)++;
+}
+
+// Checks that frames complete in submission order
+static void render_done(void *priv, pl_render_token token)
+{
+    pl_render_token *last = priv;
+    REQUIRE_CMP(token, ==, *last + 1, PRIu64);
+    *last = token;
+}
+
 static void pl_render_tests(pl_gpu gpu)
 {
     pl_tex img_tex = NULL, fbo = NULL;
@@ -1103,6 +1448,267 @@ static void pl_render_tests(pl_gpu gpu)
     REQUIRE(pl_render_image(rr, &image, &target, NULL));
     REQUIRE(pl_renderer_get_errors(rr).errors == PL_RENDER_ERR_NONE);
 
+    // Test shader precompilation
+    const struct pl_render_params *precompile_params[] = {
+        &pl_render_fast_params,
+        &pl_render_high_quality_params,
+    };
+
+    REQUIRE(pl_render_precompile(rr, pl_render_precompile_params(
+        .images      = &image,
+        .num_images  = 1,
+        .targets     = &target,
+        .num_targets = 1,
+        .params      = precompile_params,
+        .num_params  = PL_ARRAY_SIZE(precompile_params),
+        .num_threads = 4,
+    )));
+    REQUIRE(pl_render_image(rr, &image, &target, &pl_render_high_quality_params));
+    REQUIRE(pl_renderer_get_errors(rr).errors == PL_RENDER_ERR_NONE);
+
+    // Test asynchronous compilation
+    struct pl_render_params async_params = pl_render_high_quality_params;
+    async_params.async_compile = true;
+    async_params.upscaler = &pl_filter_ewa_lanczos;
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(pl_render_image(rr, &image, &target, &async_params));
+        REQUIRE(pl_renderer_get_errors(rr).errors == PL_RENDER_ERR_NONE);
+    }
+
+    // Test that steady-state rendering doesn't hit the system allocator
+    struct pl_alloc_stats stats[PL_ALLOC_SCOPE_COUNT];
+    for (int i = 0; i < 2; i++)
+        REQUIRE(pl_render_image(rr, &image, &target, &pl_render_high_quality_params));
+    pl_alloc_stats_enable(true);
+    pl_alloc_stats_reset();
+    REQUIRE(pl_render_image(rr, &image, &target, &pl_render_high_quality_params));
+    pl_alloc_stats_enable(false);
+    pl_alloc_stats_get(stats);
+    REQUIRE_CMP(stats[PL_ALLOC_SCOPE_RENDERER].sys_calls, ==, 0, PRIu64);
+    REQUIRE_CMP(stats[PL_ALLOC_SCOPE_DISPATCH].sys_calls, ==, 0, PRIu64);
+    REQUIRE_CMP(stats[PL_ALLOC_SCOPE_SHADERS].sys_calls, ==, 0, PRIu64);
+
+    // Steady state frame should not compile any new shaders
+    struct pl_render_stats rstats = pl_renderer_get_stats(rr);
+    REQUIRE_CMP(rstats.num_compiled, ==, 0, "d");
+    REQUIRE_CMP(rstats.num_passes, >, 0, "d");
+    REQUIRE_CMP(!rstats.num_fbos, ==, !rstats.fbo_memory, "d");
+    REQUIRE_CMP(rstats.time_total, ==, rstats.time_read + rstats.time_scale +
+                rstats.time_color + rstats.time_dither + rstats.time_overlay +
+                rstats.time_output, PRIu64);
+
+    // Test the adaptive quality controller with an unreachable target
+    struct pl_render_params aparams = pl_render_high_quality_params;
+    aparams.adaptive_params = pl_adaptive_params( .target_ms = 1e-6, .frames_down = 1 );
+    bool measured = false;
+    for (int i = 0; i < 10; i++) {
+        REQUIRE(pl_render_image(rr, &image, &target, &aparams));
+        measured |= pl_renderer_get_stats(rr).time_total > 0;
+    }
+    REQUIRE(pl_render_image(rr, &image, &target, &aparams));
+    if (measured)
+        REQUIRE_CMP(pl_renderer_get_stats(rr).adaptive_level, >, 0, "d");
+    REQUIRE(pl_render_image(rr, &image, &target, &pl_render_high_quality_params));
+    REQUIRE_CMP(pl_renderer_get_stats(rr).adaptive_level, ==, 0, "d");
+
+    // Test damage tracking, partial redraws should match full redraws
+    if (fbo->params.blit_dst && fbo->params.host_readable) {
+        struct pl_render_params dparams = pl_render_default_params;
+        dparams.damage_tracking = true;
+        static const pl_rect2d damage = { 10, 10, 20, 20 };
+        const size_t size = fbo->params.w * fbo->params.h * fbo->params.format->texel_size;
+        uint8_t *ref = malloc(size), *out = malloc(size);
+        REQUIRE(ref && out);
+
+        REQUIRE(pl_render_image(rr, &image, &target, &dparams));
+        REQUIRE(pl_tex_download(gpu, pl_tex_transfer_params( .tex = fbo, .ptr = ref )));
+        struct pl_render_stats dstats = pl_renderer_get_stats(rr);
+        REQUIRE_CMP(pl_rect_w(dstats.damage), ==, fbo->params.w, "d");
+
+        image.damage = target.damage = &damage;
+        image.num_damage = 1;
+        pl_tex_clear(gpu, fbo, (float[4]) {0});
+        REQUIRE(pl_render_image(rr, &image, &target, &dparams));
+        REQUIRE(pl_tex_download(gpu, pl_tex_transfer_params( .tex = fbo, .ptr = out )));
+        REQUIRE_MEMEQ(ref, out, size);
+        dstats = pl_renderer_get_stats(rr);
+        REQUIRE_CMP(pl_rect_w(dstats.damage), >, 0, "d");
+        REQUIRE_CMP(pl_rect_w(dstats.damage), <, fbo->params.w, "d");
+
+        image.num_damage = 0;
+        pl_tex_clear(gpu, fbo, (float[4]) {0});
+        REQUIRE(pl_render_image(rr, &image, &target, &dparams));
+        REQUIRE(pl_tex_download(gpu, pl_tex_transfer_params( .tex = fbo, .ptr = out )));
+        REQUIRE_MEMEQ(ref, out, size);
+        REQUIRE_CMP(pl_rect_w(pl_renderer_get_stats(rr).damage), ==, 0, "d");
+
+        image.damage = target.damage = NULL;
+        image.num_damage = 0;
+        free(ref);
+        free(out);
+    }
+
+    // Test tiled rendering against an untiled render
+    pl_tex tile_tex = NULL;
+    struct pl_plane tile_plane;
+    enum { tile_w = 80, tile_h = 70 };
+    static float tile_ref[tile_h][tile_w], tile_out[tile_h][tile_w];
+    struct pl_plane_data tile_data = plane_data;
+    tile_data.width = tile_w;
+    tile_data.height = tile_h;
+    tile_data.pixels = tile_out;
+    if (pl_recreate_plane(gpu, &tile_plane, &tile_tex, &tile_data) &&
+        tile_tex->params.host_readable)
+    {
+        struct pl_render_params tparams = pl_render_fast_params;
+        tparams.upscaler = &pl_filter_bicubic;
+        struct pl_frame timage = image, ttarget = target;
+        timage.crop = ttarget.crop = (pl_rect2df) {0};
+        ttarget.planes[0] = tile_plane;
+        REQUIRE(pl_render_image(rr, &timage, &ttarget, &tparams));
+        REQUIRE(pl_tex_download(gpu, pl_tex_transfer_params(
+            .tex = tile_tex,
+            .ptr = tile_ref,
+        )));
+
+        REQUIRE(pl_render_image_tiled(rr, pl_render_tiled_params(
+            .image          = &timage,
+            .target         = &ttarget,
+            .image_data     = &plane_data,
+            .target_data    = &tile_data,
+            .tile_size      = 16,
+            .params         = &tparams,
+        )));
+
+        for (int y = 0; y < tile_h; y++) {
+            for (int x = 0; x < tile_w; x++)
+                REQUIRE_FEQ(tile_ref[y][x], tile_out[y][x], 1e-3);
+        }
+    }
+    pl_tex_destroy(gpu, &tile_tex);
+
+    // Test multi-output rendering against individual renders
+    pl_tex multi_tex = NULL;
+    struct pl_plane multi_plane;
+    enum { multi_w = 30, multi_h = 20 };
+    static float multi_ref[multi_h][multi_w], multi_out[multi_h][multi_w];
+    struct pl_plane_data multi_data = plane_data;
+    multi_data.width = multi_w;
+    multi_data.height = multi_h;
+    if (pl_recreate_plane(gpu, &multi_plane, &multi_tex, &multi_data) &&
+        multi_tex->params.host_readable)
+    {
+        struct pl_frame targets[2] = { target, target };
+        targets[1].planes[0] = multi_plane;
+        targets[0].crop = targets[1].crop = (pl_rect2df) {0};
+        struct pl_frame mimage = image;
+        mimage.crop = (pl_rect2df) {0};
+
+        REQUIRE(pl_render_image(rr, &mimage, &targets[1], NULL));
+        REQUIRE(pl_tex_download(gpu, pl_tex_transfer_params(
+            .tex = multi_tex,
+            .ptr = multi_ref,
+        )));
+
+        if (multi_tex->params.blit_dst)
+            pl_tex_clear(gpu, multi_tex, (float[4]) {0});
+        REQUIRE(pl_render_image_multi(rr, &mimage, targets, 2, NULL));
+        REQUIRE(pl_renderer_get_errors(rr).errors == PL_RENDER_ERR_NONE);
+        REQUIRE(pl_tex_download(gpu, pl_tex_transfer_params(
+            .tex = multi_tex,
+            .ptr = multi_out,
+        )));
+
+        for (int y = 0; y < multi_h; y++) {
+            for (int x = 0; x < multi_w; x++)
+                REQUIRE_FEQ(multi_ref[y][x], multi_out[y][x], 1e-2);
+        }
+    }
+    pl_tex_destroy(gpu, &multi_tex);
+
+    // Test asynchronous rendering with a bounded number of frames in flight
+    pl_render_token done = 0, token = 0;
+    for (int i = 0; i < 5; i++) {
+        const pl_render_token prev = token;
+        token = pl_render_image_async(rr, &image, &target, NULL,
+                                      pl_render_async_params(
+                                          .done = render_done,
+                                          .priv = &done,
+                                          .max_frames_in_flight = 2,
+                                      ));
+        REQUIRE(token > prev);
+        REQUIRE_CMP(token - done, <=, 2, PRIu64);
+    }
+    while (pl_renderer_poll(rr, token, UINT64_MAX))
+        ; // do nothing
+    REQUIRE_CMP(done, ==, token, PRIu64);
+    REQUIRE(!pl_renderer_poll(rr, token + 1, 0));
+
+    // Test reduced precision rendering against the full precision path
+    if (fbo->params.host_readable) {
+        const size_t size = fbo->params.w * fbo->params.h * fbo->params.format->texel_size;
+        float *ref = malloc(size), *out = malloc(size);
+        REQUIRE(ref && out);
+
+        struct pl_render_params lparams = pl_render_high_quality_params;
+        REQUIRE(pl_render_image(rr, &image, &target, &lparams));
+        REQUIRE(pl_tex_download(gpu, pl_tex_transfer_params( .tex = fbo, .ptr = ref )));
+        lparams.low_precision = true;
+        REQUIRE(pl_render_image(rr, &image, &target, &lparams));
+        REQUIRE(pl_tex_download(gpu, pl_tex_transfer_params( .tex = fbo, .ptr = out )));
+
+        for (size_t i = 0; i < size / sizeof(float); i++)
+            REQUIRE_FEQ(ref[i], out[i], 1e-2);
+
+        // Same for packed intermediate FBOs
+        lparams.low_precision = false;
+        lparams.packed_fbos = true;
+        REQUIRE(pl_render_image(rr, &image, &target, &lparams));
+        REQUIRE(pl_tex_download(gpu, pl_tex_transfer_params( .tex = fbo, .ptr = out )));
+
+        for (size_t i = 0; i < size / sizeof(float); i++)
+            REQUIRE_FEQ(ref[i], out[i], 1e-2);
+        free(ref);
+        free(out);
+    }
+
+    // Trimming frees all cached textures, which are recreated on demand
+    struct pl_render_params tparams = pl_render_high_quality_params;
+    REQUIRE(pl_render_image(rr, &image, &target, &tparams));
+    REQUIRE_CMP(pl_renderer_trim(rr, 0), ==, 0, "zu");
+    REQUIRE(pl_render_image(rr, &image, &target, &tparams));
+    pl_renderer_set_memory_budget(rr, 1);
+    REQUIRE(pl_render_image(rr, &image, &target, &tparams));
+    REQUIRE_CMP(pl_renderer_get_stats(rr).fbo_memory, ==, 0, "zu");
+    pl_renderer_set_memory_budget(rr, 0);
+
+    // Pass timing can be sampled across frames
+    tparams.timer_interval = 4;
+    for (int i = 0; i < 8; i++)
+        REQUIRE(pl_render_image(rr, &image, &target, &tparams));
+    tparams.timer_interval = 0;
+
+    // Captured frames can be replayed without the original inputs
+    pl_capture cap = pl_capture_create(gpu);
+    REQUIRE(cap);
+    REQUIRE(!pl_capture_create(gpu));
+    REQUIRE(pl_render_image(rr, &image, &target, &tparams));
+    size_t cap_size = pl_capture_save(cap, NULL, 0);
+    uint8_t *cap_data = malloc(cap_size);
+    REQUIRE(cap_data);
+    REQUIRE_CMP(pl_capture_save(cap, cap_data, cap_size), ==, cap_size, "zu");
+    pl_capture_destroy(&cap);
+
+    int num_passes = 0;
+    REQUIRE(pl_capture_replay(gpu, cap_data, cap_size, pl_capture_replay_params(
+        .iterations = 2,
+        .pass_info  = count_capture_passes,
+        .priv       = &num_passes,
+    )));
+    REQUIRE_CMP(num_passes, >, 0, "d");
+    REQUIRE(!pl_capture_replay(gpu, cap_data, cap_size - 1, pl_capture_replay_params()));
+    free(cap_data);
+
     // TODO: embed a reference texture and ensure it matches
 
     // Test a bunch of different params
@@ -1146,12 +1752,31 @@ static void pl_render_tests(pl_gpu gpu)
         pl_gpu_flush(gpu);
         REQUIRE(pl_renderer_get_errors(rr).errors == PL_RENDER_ERR_NONE);
     }
+
+    // Large downscales are box filtered first, if requested
+    target.crop.x1 = width / 8.0;
+    target.crop.y1 = height / 8.0;
+    struct pl_render_params box_params = pl_render_high_quality_params;
+    box_params.box_prescaling = true;
+    REQUIRE(pl_render_image(rr, &image, &target, &box_params));
+    pl_gpu_flush(gpu);
+    REQUIRE(pl_renderer_get_errors(rr).errors == PL_RENDER_ERR_NONE);
     target.crop.x1 = target.crop.y1 = 0;
 
     TEST_PARAMS(deband, iterations, 3);
+
+    struct pl_deband_params adaptive_deband = pl_deband_default_params;
+    adaptive_deband.iterations = 4;
+    adaptive_deband.adaptive = true;
+    struct pl_render_params deband_params = pl_render_default_params;
+    deband_params.deband_params = &adaptive_deband;
+    REQUIRE(pl_render_image(rr, &image, &target, &deband_params));
+    pl_gpu_flush(gpu);
+    REQUIRE(pl_renderer_get_errors(rr).errors == PL_RENDER_ERR_NONE);
     TEST_PARAMS(sigmoid, center, 1);
     TEST_PARAMS(color_map, intent, PL_INTENT_ABSOLUTE_COLORIMETRIC);
     TEST_PARAMS(dither, method, PL_DITHER_WHITE_NOISE);
+    TEST_PARAMS(dither, method, PL_DITHER_BLUE_NOISE_TEMPORAL);
     TEST_PARAMS(dither, temporal, true);
     TEST_PARAMS(distort, alpha_mode, PL_ALPHA_INDEPENDENT);
     TEST_PARAMS(distort, constrain, true);
@@ -1166,9 +1791,27 @@ static void pl_render_tests(pl_gpu gpu)
     // Test HDR tone mapping
     image.color = pl_color_space_hdr10;
     TEST_PARAMS(color_map, visualize_lut, true);
+    TEST_PARAMS(color_map, lut3d_adaptive, true);
     if (gpu->limits.max_ssbo_size)
         TEST_PARAMS(peak_detect, allow_delayed, true);
 
+    // Test offline HDR analysis, identical frames form a single scene
+    pl_hdr_analysis analysis = pl_hdr_analysis_create(gpu->log, gpu, NULL);
+    if (analysis) {
+        REQUIRE(pl_hdr_analysis_add_frame(analysis, &image));
+        REQUIRE(pl_hdr_analysis_add_frame(analysis, &image));
+        const char *sidecar = pl_hdr_analysis_save(analysis);
+        pl_hdr_scenes scenes = pl_hdr_scenes_parse(gpu->log, sidecar, strlen(sidecar));
+        REQUIRE(scenes);
+        REQUIRE_CMP(scenes->num_scenes, ==, 1, "d");
+        REQUIRE_CMP(scenes->scenes[0].num_frames, ==, 2, PRIu64);
+        struct pl_hdr_metadata hdr = {0};
+        REQUIRE(pl_hdr_scenes_apply(scenes, 1, &hdr));
+        REQUIRE(hdr.max_pq_y > 0 && hdr.avg_pq_y > 0);
+        pl_hdr_scenes_free(&scenes);
+        pl_hdr_analysis_destroy(&analysis);
+    }
+
     // Test inverse tone-mapping and pure BPC
     image.color.hdr.max_luma = 1000;
     target.color.hdr.max_luma = 4000;
@@ -1222,12 +1865,16 @@ static void pl_render_tests(pl_gpu gpu)
     }
     image.film_grain = (struct pl_film_grain_data) {0};
 
-    // Test mpv-style custom shaders
-    for (int i = 0; i < PL_ARRAY_SIZE(user_shader_tests); i++) {
-        printf("testing user shader:\n\n%s\n", user_shader_tests[i]);
+    // Test mpv-style custom shaders, with and without compute tiling
+    for (int i = 0; i < 2 * PL_ARRAY_SIZE(user_shader_tests); i++) {
+        const char *shader = user_shader_tests[i % PL_ARRAY_SIZE(user_shader_tests)];
+        const bool tiling = i >= PL_ARRAY_SIZE(user_shader_tests);
+        printf("testing user shader%s:\n\n%s\n", tiling ? " (tiled)" : "", shader);
         const struct pl_hook *hook;
-        hook = pl_mpv_user_shader_parse(gpu, user_shader_tests[i],
-                                        strlen(user_shader_tests[i]));
+        hook = pl_mpv_user_shader_parse_ex(gpu, shader, strlen(shader),
+                                           pl_mpv_user_shader_params(
+                                               .compute_tiling = tiling,
+                                           ));
         REQUIRE(hook);
 
         params.hooks = &hook;
@@ -1347,6 +1994,63 @@ static void pl_render_tests(pl_gpu gpu)
     REQUIRE(pl_renderer_get_errors(rr).errors == PL_RENDER_ERR_NONE);
     target.num_overlays = 0;
 
+    // Test batching of many overlays into a single draw call
+    enum { num_many = 64 };
+    static struct pl_overlay_part many_parts[num_many];
+    struct pl_overlay many[num_many];
+    for (int i = 0; i < num_many; i++) {
+        many_parts[i] = (struct pl_overlay_part) {
+            .src = { i % 40, i % 30, i % 40 + 10, i % 30 + 20 },
+            .dst = { i, 2 * i, i + 10, 2 * i + 20 },
+        };
+        many[i] = (struct pl_overlay) {
+            .tex = img_plane.texture,
+            .mode = PL_OVERLAY_NORMAL,
+            .num_parts = 1,
+            .parts = &many_parts[i],
+        };
+    }
+
+    target.overlays = many;
+    target.num_overlays = 1;
+    REQUIRE(pl_render_image(rr, &image, &target, &params));
+    const int passes_one = pl_renderer_get_stats(rr).num_passes;
+    target.num_overlays = num_many;
+    REQUIRE(pl_render_image(rr, &image, &target, &params));
+    REQUIRE(pl_renderer_get_errors(rr).errors == PL_RENDER_ERR_NONE);
+    if (img_plane.texture->params.blit_src)
+        REQUIRE_CMP(pl_renderer_get_stats(rr).num_passes, ==, passes_one, "d");
+
+    // Test that cached overlay layers match drawing the overlays directly
+    if (fbo->params.host_readable) {
+        static float osd_ref[height][width], osd_out[height][width];
+        REQUIRE(pl_tex_download(gpu, pl_tex_transfer_params(
+            .tex = fbo,
+            .ptr = osd_ref,
+        )));
+
+        for (int i = 0; i < num_many; i++)
+            many[i].signature = i + 1;
+
+        for (int frame = 0; frame < 3; frame++) {
+            REQUIRE(pl_render_image(rr, &image, &target, &params));
+            REQUIRE(pl_renderer_get_errors(rr).errors == PL_RENDER_ERR_NONE);
+            REQUIRE(pl_tex_download(gpu, pl_tex_transfer_params(
+                .tex = fbo,
+                .ptr = osd_out,
+            )));
+
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++)
+                    REQUIRE_FEQ(osd_ref[y][x], osd_out[y][x], 1e-2);
+            }
+        }
+
+        for (int i = 0; i < num_many; i++)
+            many[i].signature = 0;
+    }
+    target.num_overlays = 0;
+
     // Test rotation
     for (pl_rotation rot = 0; rot < PL_ROTATION_360; rot += PL_ROTATION_90) {
         image.rotation = rot;
@@ -1424,6 +2128,7 @@ static void pl_render_tests(pl_gpu gpu)
         }
 
         REQUIRE_CMP(ret, ==, PL_QUEUE_OK, "u");
+        REQUIRE_CMP(mix.num_retain, >=, mix.num_frames, "d");
         REQUIRE(pl_render_image_mix(rr, &mix, &target, &mix_params));
 
         // Simulate advancing vsync
@@ -1481,6 +2186,113 @@ error:
     pl_tex_destroy(gpu, &fbo);
 }
 
+static void pl_render_mix_tests(pl_gpu gpu)
+{
+    pl_fmt fmt = pl_find_fmt(gpu, PL_FMT_UNORM, 4, 8, 8, PL_FMT_CAP_RENDERABLE |
+                             PL_FMT_CAP_BLITTABLE | PL_FMT_CAP_HOST_READABLE);
+    if (!fmt)
+        return;
+
+    // Mix two frames at the target resolution, which can be sampled directly
+    // by the frame mixing shader without any intermediate textures
+    const int width = 32, height = 16;
+    const uint8_t values[2] = { 0x33, 0x99 };
+    pl_tex src[2];
+    struct pl_frame frames[2];
+    for (int i = 0; i < 2; i++) {
+        src[i] = pl_tex_create(gpu, pl_tex_params(
+            .w              = width,
+            .h              = height,
+            .format         = fmt,
+            .sampleable     = true,
+            .blit_dst       = true,
+        ));
+        REQUIRE(src[i]);
+
+        const float v = values[i] / 255.0f;
+        pl_tex_clear(gpu, src[i], (float[4]) { v, v, v, 1.0 });
+        frames[i] = (struct pl_frame) {
+            .num_planes = 1,
+            .planes[0] = {
+                .texture = src[i],
+                .components = 4,
+                .component_mapping = {0, 1, 2, 3},
+            },
+            .repr = pl_color_repr_rgb,
+            .color = pl_color_space_srgb,
+        };
+    }
+
+    pl_tex fbo = pl_tex_create(gpu, pl_tex_params(
+        .w              = width,
+        .h              = height,
+        .format         = fmt,
+        .renderable     = true,
+        .host_readable  = true,
+    ));
+    REQUIRE(fbo);
+
+    struct pl_frame target;
+    pl_frame_from_swapchain(&target, &(struct pl_swapchain_frame) {
+        .fbo = fbo,
+        .color_repr = pl_color_repr_rgb,
+        .color_space = pl_color_space_srgb,
+    });
+
+    // Each frame covers exactly half of the vsync
+    struct pl_frame_mix mix = {
+        .num_frames = 2,
+        .frames = (const struct pl_frame *[]) { &frames[0], &frames[1] },
+        .signatures = (uint64_t[]) { 0x1, 0x2 },
+        .timestamps = (float[]) { -0.5, 0.25 },
+        .vsync_duration = 0.5,
+    };
+
+    struct pl_render_params params = pl_render_fast_params;
+    params.frame_mixer = &pl_oversample_frame_mixer;
+
+    pl_renderer rr = pl_renderer_create(gpu->log, gpu);
+    REQUIRE(pl_render_image_mix(rr, &mix, &target, &params));
+    REQUIRE(pl_renderer_get_errors(rr).errors == PL_RENDER_ERR_NONE);
+
+    uint8_t data[height][width][4];
+    REQUIRE(pl_tex_download(gpu, pl_tex_transfer_params(
+        .tex = fbo,
+        .ptr = data,
+    )));
+
+    const int ref = (values[0] + values[1]) / 2;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            for (int c = 0; c < 3; c++)
+                REQUIRE_FEQ(data[y][x][c], ref, 1);
+        }
+    }
+
+    // Motion compensation must not displace anything between flat frames,
+    // so interpolating halfway should still produce the average
+    mix.timestamps = (float[]) { -0.5, 0.5 };
+    params.frame_mixer = &pl_filter_motion;
+    REQUIRE(pl_render_image_mix(rr, &mix, &target, &params));
+    REQUIRE(pl_renderer_get_errors(rr).errors == PL_RENDER_ERR_NONE);
+    REQUIRE(pl_tex_download(gpu, pl_tex_transfer_params(
+        .tex = fbo,
+        .ptr = data,
+    )));
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            for (int c = 0; c < 3; c++)
+                REQUIRE_FEQ(data[y][x][c], ref, 1);
+        }
+    }
+
+    pl_renderer_destroy(&rr);
+    pl_tex_destroy(gpu, &fbo);
+    for (int i = 0; i < 2; i++)
+        pl_tex_destroy(gpu, &src[i]);
+}
+
 static struct pl_hook_res noop_hook(void *priv, const struct pl_hook_params *params)
 {
     return (struct pl_hook_res) {0};
@@ -1573,36 +2385,40 @@ static void pl_ycbcr_tests(pl_gpu gpu)
         target.planes[i].texture = dst_tex[i];
     }
 
-    REQUIRE(pl_render_image(rr, &img, &target, &(struct pl_render_params) {
-        .num_hooks = 1,
-        .hooks = &(const struct pl_hook *){&(struct pl_hook) {
-            // Forces chroma merging, to test the chroma merging code
-            .stages = PL_HOOK_CHROMA_INPUT,
-            .hook = noop_hook,
-        }},
-    }));
-    REQUIRE(pl_renderer_get_errors(rr).errors == PL_RENDER_ERR_NONE);
-
     size_t buf_size = data[0].height * data[0].row_stride;
     dst_buffer = malloc(buf_size);
     if (!dst_buffer)
         goto error;
 
-    for (int i = 0; i < 3; i++) {
-        memset(dst_buffer, 0xAA, buf_size);
-        REQUIRE(pl_tex_download(gpu, &(struct pl_tex_transfer_params) {
-            .tex = dst_tex[i],
-            .ptr = dst_buffer,
-            .row_pitch = data[i].row_stride,
+    // Also test dispatching the plane passes as compute shaders
+    for (int parallel = 0; parallel < 2; parallel++) {
+        REQUIRE(pl_render_image(rr, &img, &target, &(struct pl_render_params) {
+            .num_hooks = 1,
+            .hooks = &(const struct pl_hook *){&(struct pl_hook) {
+                // Forces chroma merging, to test the chroma merging code
+                .stages = PL_HOOK_CHROMA_INPUT,
+                .hook = noop_hook,
+            }},
+            .parallel_planes = parallel,
         }));
+        REQUIRE(pl_renderer_get_errors(rr).errors == PL_RENDER_ERR_NONE);
 
-        for (int y = 0; y < data[i].height; y++) {
-            for (int x = 0; x < data[i].width; x++) {
-                size_t off = y * data[i].row_stride + x * data[i].pixel_stride;
-                uint16_t *src_pixel = (uint16_t *) &src_buffer[i][off];
-                uint16_t *dst_pixel = (uint16_t *) &dst_buffer[off];
-                int diff = abs((int) *src_pixel - (int) *dst_pixel);
-                REQUIRE_CMP(diff, <=, 50, "d"); // a little under 0.1%
+        for (int i = 0; i < 3; i++) {
+            memset(dst_buffer, 0xAA, buf_size);
+            REQUIRE(pl_tex_download(gpu, &(struct pl_tex_transfer_params) {
+                .tex = dst_tex[i],
+                .ptr = dst_buffer,
+                .row_pitch = data[i].row_stride,
+            }));
+
+            for (int y = 0; y < data[i].height; y++) {
+                for (int x = 0; x < data[i].width; x++) {
+                    size_t off = y * data[i].row_stride + x * data[i].pixel_stride;
+                    uint16_t *src_pixel = (uint16_t *) &src_buffer[i][off];
+                    uint16_t *dst_pixel = (uint16_t *) &dst_buffer[off];
+                    int diff = abs((int) *src_pixel - (int) *dst_pixel);
+                    REQUIRE_CMP(diff, <=, 50, "d"); // a little under 0.1%
+                }
             }
         }
     }
@@ -1719,15 +2535,88 @@ static void pl_test_host_ptr(pl_gpu gpu)
 #endif // unix
 }
 
+struct pipeline_state {
+    uint64_t frames;
+    uint8_t value;
+};
+
+static void pipeline_output(void *priv, const struct pl_pipeline_frame *frame)
+{
+    struct pipeline_state *state = priv;
+    REQUIRE_CMP(frame->index, ==, state->frames, PRIu64);
+    REQUIRE_CMP((uintptr_t) frame->priv, ==, state->frames, PRIuPTR);
+    REQUIRE_CMP(frame->num_planes, ==, 1, "d");
+    const uint8_t *data = frame->data[0];
+    const uint8_t expected = state->value + frame->index;
+    REQUIRE_CMP(abs(data[0] - expected), <=, 1, "d");
+    REQUIRE_CMP(abs(data[frame->row_stride[0] * 7 + 7] - expected), <=, 1, "d");
+    state->frames++;
+}
+
+static void pl_pipeline_tests(pl_gpu gpu)
+{
+    struct pipeline_state state = { .value = 100 };
+    const struct pl_plane_data out = {
+        .type           = PL_FMT_UNORM,
+        .width          = 8,
+        .height         = 8,
+        .component_size = { 8 },
+        .component_map  = { 0 },
+        .pixel_stride   = 1,
+    };
+
+    pl_pipeline pipe = pl_pipeline_create(gpu->log, gpu, pl_pipeline_params(
+        .planes             = &out,
+        .num_planes         = 1,
+        .repr               = pl_color_repr_rgb,
+        .color              = pl_color_space_srgb,
+        .render_params      = &pl_render_fast_params,
+        .frames_in_flight   = 2,
+        .output             = pipeline_output,
+        .priv               = &state,
+    ));
+    if (!pipe)
+        return;
+
+    static uint8_t src[16][16];
+    for (int i = 0; i < 5; i++) {
+        memset(src, state.value + i, sizeof(src));
+        REQUIRE(pl_pipeline_push(pipe, &(struct pl_pipeline_source) {
+            .planes = &(struct pl_plane_data) {
+                .type           = PL_FMT_UNORM,
+                .width          = 16,
+                .height         = 16,
+                .component_size = { 8 },
+                .component_map  = { 0 },
+                .pixel_stride   = 1,
+                .pixels         = src,
+            },
+            .num_planes = 1,
+            .repr       = pl_color_repr_rgb,
+            .color      = pl_color_space_srgb,
+            .priv       = (void *) (uintptr_t) i,
+        }));
+        REQUIRE_CMP(state.frames + 2, >=, i + 1, PRIu64);
+    }
+
+    REQUIRE(pl_pipeline_flush(pipe));
+    REQUIRE_CMP(state.frames, ==, 5, PRIu64);
+    pl_pipeline_destroy(&pipe);
+}
+
 static void gpu_shader_tests(pl_gpu gpu)
 {
     pl_buffer_tests(gpu);
     pl_texture_tests(gpu);
     pl_planar_tests(gpu);
+    pl_upload_ring_tests(gpu);
+    pl_upload_unpack_tests(gpu);
     pl_shader_tests(gpu);
     pl_scaler_tests(gpu);
     pl_render_tests(gpu);
+    pl_render_mix_tests(gpu);
     pl_ycbcr_tests(gpu);
+    pl_pipeline_tests(gpu);
 
     REQUIRE(!pl_gpu_is_failed(gpu));
 }
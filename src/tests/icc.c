@@ -1,5 +1,6 @@
 #include "tests.h"
 
+#include <libplacebo/dummy.h>
 #include <libplacebo/shaders/icc.h>
 
 static const uint8_t DisplayP3_v2_micro_icc[] = {
@@ -102,5 +103,51 @@ int main()
     REQUIRE_CMP(icc->csp.primaries, ==, PL_COLOR_PRIM_BT_2020, "u");
     pl_icc_close(&icc);
 
+    // Reopening a known profile re-uses the cached analysis
+    pl_cache cache = pl_cache_create(pl_cache_params( .log = log ));
+    icc = pl_icc_open(log, &TEST_PROFILE(DisplayP3_v2_micro_icc), pl_icc_params(
+        .cache = cache,
+    ));
+    REQUIRE(icc);
+    REQUIRE_CMP(pl_cache_objects(cache), ==, 1, "d");
+    const struct pl_color_space ref_csp = icc->csp;
+    const struct pl_icc_params ref_params = icc->params;
+    const float ref_gamma = icc->gamma;
+    pl_icc_close(&icc);
+
+    icc = pl_icc_open(log, &TEST_PROFILE(DisplayP3_v2_micro_icc), pl_icc_params(
+        .cache = cache,
+    ));
+    REQUIRE(icc);
+    REQUIRE_CMP(pl_cache_objects(cache), ==, 1, "d");
+    REQUIRE(pl_color_space_equal(&icc->csp, &ref_csp));
+    REQUIRE_CMP(icc->gamma, ==, ref_gamma, "f");
+    REQUIRE_CMP(icc->params.size_r, ==, ref_params.size_r, "d");
+    REQUIRE_CMP(icc->params.intent, ==, ref_params.intent, "u");
+    pl_icc_close(&icc);
+    pl_cache_destroy(&cache);
+
+    // Progressive refinement should produce usable shaders immediately, and
+    // cleanly tear down any pending background work
+    pl_gpu gpu = pl_gpu_dummy_create(log, NULL);
+    icc = pl_icc_open(log, &TEST_PROFILE(DisplayP3_v2_micro_icc), pl_icc_params(
+        .size_r = 33, .size_g = 33, .size_b = 33,
+        .progressive = true,
+    ));
+    REQUIRE(icc);
+
+    pl_shader_obj lut = NULL;
+    pl_shader sh = pl_shader_alloc(log, pl_shader_params( .gpu = gpu ));
+    for (int i = 0; i < 2; i++) {
+        pl_shader_reset(sh, pl_shader_params( .gpu = gpu ));
+        pl_icc_decode(sh, icc, &lut, NULL);
+        REQUIRE(pl_shader_finalize(sh));
+    }
+
+    pl_shader_free(&sh);
+    pl_shader_obj_destroy(&lut);
+    pl_icc_close(&icc);
+    pl_gpu_dummy_destroy(&gpu);
+
     pl_log_destroy(&log);
 }
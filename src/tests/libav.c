@@ -322,6 +322,18 @@ int main()
 
     TEST(AV_PIX_FMT_RGB565LE, rgb565);
 
+    static const struct pl_plane_data rgb565be[] = {
+        {
+            .type = PL_FMT_UNORM,
+            .component_size = {5, 6, 5},
+            .component_map = {2, 1, 0}, // LSB to MSB
+            .pixel_stride = 2,
+            .swapped = true,
+        }
+    };
+
+    TEST(AV_PIX_FMT_RGB565BE, rgb565be);
+
 #if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 37, 100)
 
     static const struct pl_plane_data rgb32f[] = {
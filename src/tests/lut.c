@@ -79,6 +79,64 @@ int main()
         pl_lut_free(&lut);
     }
 
+    // Large enough to be split into multiple chunks while parsing
+    const int size = 33;
+    pl_str cube = {0};
+    pl_str_append_asprintf(NULL, &cube, "LUT_3D_SIZE %d\n", size);
+    for (int b = 0; b < size; b++) {
+        for (int g = 0; g < size; g++) {
+            for (int r = 0; r < size; r++) {
+                pl_str_append_asprintf(NULL, &cube, "%f %f %f\n",
+                    r / (size - 1.0), g / (size - 1.0), b / (size - 1.0));
+            }
+        }
+    }
+
+    struct pl_custom_lut *lut;
+    lut = pl_lut_parse_cube(log, (char *) cube.buf, cube.len);
+    REQUIRE(lut);
+    REQUIRE_CMP(lut->size[0], ==, size, "d");
+    const float *data = lut->data;
+    for (int b = 0; b < size; b++) {
+        for (int g = 0; g < size; g++) {
+            for (int r = 0; r < size; r++, data += 3) {
+                REQUIRE_FEQ(data[0], r / (size - 1.0), 1e-6);
+                REQUIRE_FEQ(data[1], g / (size - 1.0), 1e-6);
+                REQUIRE_FEQ(data[2], b / (size - 1.0), 1e-6);
+            }
+        }
+    }
+
+    // Round trip through the binary format
+    const size_t bin_size = pl_lut_save(lut, NULL, 0);
+    REQUIRE_CMP(bin_size, >, sizeof(float[3]) * size * size * size, "zu");
+    REQUIRE_CMP(pl_lut_save(lut, NULL, bin_size - 1), ==, bin_size, "zu");
+    uint8_t *bin = pl_alloc(NULL, bin_size);
+    REQUIRE_CMP(pl_lut_save(lut, bin, bin_size - 1), ==, 0, "zu");
+    REQUIRE_CMP(pl_lut_save(lut, bin, bin_size), ==, bin_size, "zu");
+
+    struct pl_custom_lut *loaded = pl_lut_load(log, bin, bin_size);
+    REQUIRE(loaded);
+    REQUIRE_CMP(loaded->signature, ==, lut->signature, PRIu64);
+    for (int i = 0; i < 3; i++)
+        REQUIRE_CMP(loaded->size[i], ==, lut->size[i], "d");
+    REQUIRE_MEMEQ(loaded->data, lut->data, sizeof(float[3]) * size * size * size);
+    pl_lut_free(&loaded);
+
+    // Truncated or corrupt data must be rejected
+    REQUIRE(!pl_lut_load(log, bin, bin_size - 1));
+    REQUIRE(!pl_lut_load(log, bin, 16));
+    bin[0] = 'x';
+    REQUIRE(!pl_lut_load(log, bin, bin_size));
+    pl_free(bin);
+    pl_lut_free(&lut);
+
+    // Truncated or malformed bodies must be rejected
+    REQUIRE(!pl_lut_parse_cube(log, (char *) cube.buf, cube.len - 12));
+    cube.buf[cube.len / 2] = 'x';
+    REQUIRE(!pl_lut_parse_cube(log, (char *) cube.buf, cube.len));
+    pl_free(cube.buf);
+
     pl_shader_obj_destroy(&obj);
     pl_shader_free(&sh);
     pl_gpu_dummy_destroy(&gpu);
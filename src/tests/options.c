@@ -99,6 +99,62 @@ int main()
     REQUIRE(pl_options_load(test, "cone=yes,cone_preset=deuteranomaly"));
     REQUIRE_STREQ(pl_options_save(test), "cone=yes,cones=m,cone_strength=0.5");
 
+    // Test compiled patches, which must match pl_options_load exactly
+    static const char *patch_str =
+        "deband=yes,deband_iterations=3,preset=fast,upscaler=custom,"
+        "upscaler_preset=ewa_lanczos,dither_method=ordered_lut,cone=yes";
+    pl_opt_patch patch = pl_opt_patch_compile(log, patch_str);
+    REQUIRE(patch);
+    pl_options patched = pl_options_alloc(log);
+    for (int i = 0; i < 2; i++) {
+        pl_options_reset(test, &pl_render_high_quality_params);
+        pl_options_reset(patched, &pl_render_high_quality_params);
+        REQUIRE(pl_options_load(test, patch_str));
+        pl_options_apply_patch(patched, patch);
+        REQUIRE_STREQ(pl_options_save(test), pl_options_save(patched));
+        REQUIRE(patched->params.upscaler == &patched->upscaler);
+    }
+    pl_options_free(&patched);
+    pl_opt_patch_free(&patch);
+    REQUIRE(!pl_opt_patch_compile(log, "deband=yes,invalid=1"));
+    REQUIRE(!pl_opt_patch_compile(log, "tone_lut_size=abc"));
+
+    // Snapshots must be self-contained and unaffected by later changes
+    pl_options_reset(test, &pl_render_high_quality_params);
+    REQUIRE(pl_options_load(test, "upscaler=custom,upscaler_preset=ewa_lanczos"));
+    pl_options_add_hook(test, &(struct pl_hook) {0});
+    pl_opt_snapshot snap = pl_options_snapshot(test);
+    const struct pl_options_t snap_pre = *snap;
+    REQUIRE(snap->params.upscaler == &snap->upscaler);
+    REQUIRE(snap->params.deband_params == &snap->deband_params);
+    REQUIRE(snap->params.hooks != test->params.hooks);
+    REQUIRE(pl_options_load(test, "preset=fast,deband_iterations=4"));
+    pl_options_remove_hook_at(test, 0);
+    REQUIRE_MEMEQ(snap, &snap_pre, sizeof(*snap));
+
+    pl_opt_source source = pl_opt_source_create(snap);
+    pl_opt_snapshot cur = NULL;
+    REQUIRE(pl_opt_source_update(source, &cur));
+    REQUIRE(cur == snap);
+    REQUIRE(!pl_opt_source_update(source, &cur));
+    pl_opt_snapshot_unref(&snap);
+    snap = pl_options_snapshot(test);
+    pl_opt_source_publish(source, snap);
+    REQUIRE(cur->params.upscaler == &cur->upscaler); // still valid
+    REQUIRE(pl_opt_source_update(source, &cur));
+    REQUIRE(cur == snap && !cur->params.num_hooks);
+    pl_opt_snapshot_unref(&snap);
+    pl_opt_source_destroy(&source);
+    REQUIRE_CMP(cur->deband_params.iterations, ==, 4, "d");
+    pl_opt_snapshot_unref(&cur);
+
+    // Option lookups must find every option, and nothing else
+    for (int i = 0; i < pl_option_count; i++)
+        REQUIRE(pl_find_option(pl_option_list[i].key) == &pl_option_list[i]);
+    REQUIRE(!pl_find_option("upscale"));
+    REQUIRE(!pl_find_option("upscaler_"));
+    REQUIRE(!pl_find_option(""));
+
     // Test error paths
     pl_options bad = pl_options_alloc(NULL);
     REQUIRE(!pl_options_load(bad, "scale_preset=help"));
@@ -142,6 +142,25 @@ int main()
     res = pl_str_builder_exec(builder);
     REQUIRE(pl_str_equals0(res, "foo 123 bar 56 bat quack baz 3735928559 test123"));
 
+    // Output larger than the previous buffer, mixing all template types
+    pl_str_builder_reset(builder);
+    pl_str_builder concat = pl_str_builder_alloc(tmp);
+    pl_str ref = {0};
+    for (int n = 0; n < 100; n++) {
+        pl_str_builder_printf_c(builder, "_%hx %c %zu %llu %%", (unsigned short) (n * 997),
+                                'a' + n % 26, (size_t) n << 20, 1ull << (n % 64));
+        pl_str_append_asprintf(tmp, &ref, "_%hx %c %zu %llu %%", (unsigned short) (n * 997),
+                               'a' + n % 26, (size_t) n << 20, 1ull << (n % 64));
+        pl_str_builder_const_str(concat, "const;");
+        pl_str_builder_str0(concat, "str;");
+        pl_str_append_asprintf(tmp, &ref, "const;str;");
+        pl_str_builder_concat(builder, concat);
+        pl_str_builder_reset(concat);
+    }
+    res = pl_str_builder_exec(builder);
+    REQUIRE(pl_str_equals(res, ref));
+    REQUIRE_CMP(res.buf[res.len], ==, '\0', "d");
+
     pl_free(tmp);
     return 0;
 }
@@ -59,6 +59,13 @@ int main()
 #endif
         }
 
+        // Test that the LUT agrees with the reference sample function
+        for (int j = 0; j < PL_ARRAY_SIZE(lut); j++) {
+            float x = j / (PL_ARRAY_SIZE(lut) - 1.0f);
+            x = PL_MIX(params.input_min, params.input_max, x);
+            REQUIRE_FEQ(lut[j], pl_tone_map_sample(x, &params), 1e-5);
+        }
+
         if (fun->map_inverse || !tested_pure_bpc++) {
             start = pl_clock_now();
             pl_tone_map_generate(lut, &params_inv);
@@ -112,6 +119,35 @@ int main()
         REQUIRE_FEQ(white[2], 0.0f, 1e-4);
     }
 
+    // Adaptive LUT sizing never grows the LUT, and detects identity mappings
+    struct pl_gamut_map_params fit = {
+        .function     = &pl_gamut_map_perceptual,
+        .input_gamut  = *pl_raw_primaries_get(PL_COLOR_PRIM_BT_2020),
+        .output_gamut = *pl_raw_primaries_get(PL_COLOR_PRIM_BT_709),
+        .max_luma     = pl_hdr_rescale(PL_HDR_NORM, PL_HDR_PQ, 1.0f),
+        .constants    = { PL_GAMUT_MAP_CONSTANTS },
+        .lut_size_I   = 48,
+        .lut_size_C   = 32,
+        .lut_size_h   = 256,
+    };
+    REQUIRE(pl_gamut_map_fit_lut_size(&fit, 1e-3f));
+    printf("Fitted 3DLUT size: %dx%dx%d\n", fit.lut_size_I, fit.lut_size_C, fit.lut_size_h);
+    REQUIRE(fit.lut_size_I >= 2 && fit.lut_size_I <= 48);
+    REQUIRE(fit.lut_size_C >= 2 && fit.lut_size_C <= 32);
+    REQUIRE(fit.lut_size_h >= 2 && fit.lut_size_h <= 256);
+
+    // Linear desaturation is smooth in I and C, so needs only two points there
+    fit.function = &pl_gamut_map_linear;
+    REQUIRE(pl_gamut_map_fit_lut_size(&fit, 1e-3f));
+    REQUIRE_CMP(fit.lut_size_I, ==, 2, "d");
+    REQUIRE_CMP(fit.lut_size_C, ==, 2, "d");
+    REQUIRE(fit.lut_size_h < 256);
+
+    fit.function = &pl_gamut_map_relative;
+    fit.input_gamut = *pl_raw_primaries_get(PL_COLOR_PRIM_BT_709);
+    fit.output_gamut = *pl_raw_primaries_get(PL_COLOR_PRIM_BT_2020);
+    REQUIRE(!pl_gamut_map_fit_lut_size(&fit, 1e-3f));
+
     enum { LUT3D_SIZE = 65 }; // for benchmarking
     struct pl_gamut_map_params perceptual = {
         .function     = &pl_gamut_map_perceptual,
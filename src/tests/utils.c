@@ -1,6 +1,9 @@
 #include "tests.h"
 #include "gpu.h"
 
+#include <libplacebo/utils/convert.h>
+#include <libplacebo/utils/dolbyvision.h>
+#include <libplacebo/utils/hdr_analysis.h>
 #include <libplacebo/utils/upload.h>
 
 int main()
@@ -162,4 +165,170 @@ int main()
         var.dim_a = 100;
         REQUIRE_CMP(nvar->glsl_name, ==, pl_var_glsl_type_name(var), "s");
     }
+
+    // DoVi metadata is only reused while the source bytes stay identical
+    pl_dovi_state dovi = pl_dovi_state_create();
+    struct pl_dovi_metadata meta = {0};
+    const uint8_t src_a[] = {1, 2, 3, 4}, src_b[] = {1, 2, 3, 5};
+    REQUIRE_CMP(pl_dovi_state_signature(dovi), ==, 0, PRIu64);
+    REQUIRE(!pl_dovi_state_lookup(dovi, &meta, src_a, sizeof(src_a)));
+    pl_dovi_state_store(dovi, &dovi_meta, src_a, sizeof(src_a));
+    const uint64_t sig_a = pl_dovi_state_signature(dovi);
+    REQUIRE(sig_a);
+
+    REQUIRE(pl_dovi_state_lookup(dovi, &meta, src_a, sizeof(src_a)));
+    REQUIRE_MEMEQ(&meta, &dovi_meta, sizeof(meta));
+    REQUIRE(!pl_dovi_state_lookup(dovi, &meta, src_b, sizeof(src_b)));
+    REQUIRE_CMP(pl_dovi_state_signature(dovi), ==, sig_a, PRIu64);
+
+    pl_dovi_state_store(dovi, &dovi_meta, src_b, sizeof(src_b));
+    REQUIRE_CMP(pl_dovi_state_signature(dovi), !=, sig_a, PRIu64);
+    pl_dovi_state_destroy(&dovi);
+    REQUIRE(!dovi);
+
+    // HDR scene sidecars round-trip, and reject gaps between scenes
+    pl_log log = pl_test_logger();
+    static const char sidecar[] =
+        "# libplacebo HDR scenes v1\n"
+        "# first_frame num_frames max_pq_y avg_pq_y\n"
+        "0 24 0.75 0.25\n"
+        "\n"
+        "24 48 0.5 0\n";
+    pl_hdr_scenes scenes = pl_hdr_scenes_parse(log, sidecar, sizeof(sidecar) - 1);
+    REQUIRE(scenes);
+    REQUIRE_CMP(scenes->num_scenes, ==, 2, "d");
+    REQUIRE_CMP(scenes->scenes[1].first_frame, ==, 24, PRIu64);
+    struct pl_hdr_metadata hdr = {0};
+    REQUIRE(pl_hdr_scenes_apply(scenes, 23, &hdr));
+    REQUIRE_FEQ(hdr.max_pq_y, 0.75f, 1e-6);
+    REQUIRE_FEQ(hdr.avg_pq_y, 0.25f, 1e-6);
+    REQUIRE(pl_hdr_scenes_apply(scenes, 71, &hdr));
+    REQUIRE_FEQ(hdr.max_pq_y, 0.5f, 1e-6);
+    REQUIRE(hdr.avg_pq_y > 0.0f);
+    REQUIRE(!pl_hdr_scenes_apply(scenes, 72, &hdr));
+    pl_hdr_scenes_free(&scenes);
+    REQUIRE(!scenes);
+
+    static const char gap[] = "# libplacebo HDR scenes v1\n0 24 0.75 0.25\n25 1 0.5 0.1\n";
+    REQUIRE(!pl_hdr_scenes_parse(log, gap, sizeof(gap) - 1));
+    REQUIRE(!pl_hdr_scenes_parse(log, "0 1 0.5 0.1\n", 12));
+
+    // CPU conversion of limited range 4:2:0 YCbCr to packed RGBA
+    static const uint8_t luma[4][4] = {
+        { 16, 16, 235, 235 },
+        { 16, 16, 235, 235 },
+        { 16, 16, 235, 235 },
+        { 16, 16, 235, 235 },
+    };
+    static const uint8_t cb[2][2] = {{ 128, 128 }, { 128, 240 }};
+    static const uint8_t cr[2][2] = {{ 128, 128 }, { 128, 128 }};
+    struct pl_plane_data yuv[3] = {
+        { .type = PL_FMT_UNORM, .width = 4, .height = 4, .pixel_stride = 1,
+          .component_size = {8}, .component_map = {PL_CHANNEL_Y}, .pixels = luma },
+        { .type = PL_FMT_UNORM, .width = 2, .height = 2, .pixel_stride = 1,
+          .component_size = {8}, .component_map = {PL_CHANNEL_CB}, .pixels = cb },
+        { .type = PL_FMT_UNORM, .width = 2, .height = 2, .pixel_stride = 1,
+          .component_size = {8}, .component_map = {PL_CHANNEL_CR}, .pixels = cr },
+    };
+
+    uint8_t rgba[2][2][4];
+    struct pl_plane_data rgba_data = {
+        .type           = PL_FMT_UNORM,
+        .width          = 2,
+        .height         = 2,
+        .pixel_stride   = 4,
+        .component_size = {8, 8, 8, 8},
+        .component_map  = {0, 1, 2, 3},
+    };
+
+    struct pl_convert_params conv = {
+        .src_planes     = yuv,
+        .num_src_planes = 3,
+        .src_repr       = { .sys = PL_COLOR_SYSTEM_BT_709, .levels = PL_COLOR_LEVELS_LIMITED },
+        .src_color      = pl_color_space_bt709,
+        .dst_planes     = &rgba_data,
+        .num_dst_planes = 1,
+        .dst_data       = { rgba },
+        .dst_repr       = pl_color_repr_rgb,
+        .dst_color      = pl_color_space_bt709,
+    };
+
+    REQUIRE(pl_convert_planes(log, &conv));
+    for (int c = 0; c < 4; c++) {
+        REQUIRE_CMP(rgba[0][0][c], ==, c == 3 ? 255 : 0, "u");
+        REQUIRE_CMP(rgba[0][1][c], ==, 255, "u");
+    }
+    REQUIRE_CMP(rgba[1][1][0], ==, 255, "u");
+    REQUIRE_CMP(rgba[1][1][2], ==, 255, "u");
+    REQUIRE_CMP(rgba[1][1][1], <, 255, "u");
+
+    // Conversion to a different size, and from an unsupported system
+    uint8_t rgba_big[8][8][4];
+    rgba_data.width = rgba_data.height = 8;
+    conv.dst_data[0] = rgba_big;
+    REQUIRE(pl_convert_planes(log, &conv));
+    REQUIRE_MEMEQ(rgba_big[7][7], rgba[1][1], sizeof(rgba[1][1]));
+    conv.src_repr.sys = PL_COLOR_SYSTEM_BT_2100_PQ;
+    REQUIRE(!pl_convert_planes(log, &conv));
+
+    // Round trip through a different color space in floating point
+    float rgb_in[16][3], rgb_lin[16][3], rgb_out[16][3];
+    for (int i = 0; i < PL_ARRAY_SIZE(rgb_in); i++) {
+        for (int c = 0; c < 3; c++)
+            rgb_in[i][c] = (i * 3 + c) / 48.0f;
+    }
+
+    struct pl_plane_data rgbf = {
+        .type           = PL_FMT_FLOAT,
+        .width          = 4,
+        .height         = 4,
+        .pixel_stride   = sizeof(rgb_in[0]),
+        .component_size = {32, 32, 32},
+        .component_map  = {0, 1, 2},
+        .pixels         = rgb_in,
+    };
+
+    const struct pl_color_space linear = {
+        .primaries = PL_COLOR_PRIM_BT_709,
+        .transfer  = PL_COLOR_TRC_LINEAR,
+    };
+
+    conv = (struct pl_convert_params) {
+        .src_planes     = &rgbf,
+        .num_src_planes = 1,
+        .src_repr       = pl_color_repr_rgb,
+        .src_color      = pl_color_space_srgb,
+        .dst_planes     = &rgbf,
+        .num_dst_planes = 1,
+        .dst_data       = { rgb_lin },
+        .dst_repr       = pl_color_repr_rgb,
+        .dst_color      = linear,
+    };
+    REQUIRE(pl_convert_planes(log, &conv));
+    REQUIRE_CMP(rgb_lin[0][0], <, rgb_lin[6][0], "f");
+    REQUIRE_CMP(rgb_lin[6][0], <, rgb_in[6][0], "f");
+
+    conv.src_color = linear;
+    conv.dst_color = pl_color_space_srgb;
+    rgbf.pixels = rgb_lin;
+    conv.dst_data[0] = rgb_out;
+    REQUIRE(pl_convert_planes(log, &conv));
+    for (int i = 0; i < PL_ARRAY_SIZE(rgb_in); i++) {
+        for (int c = 0; c < 3; c++)
+            REQUIRE_FEQ(rgb_out[i][c], rgb_in[i][c], 1e-4);
+    }
+
+    // Tone mapping and gamut mapping HDR to SDR preserves the ordering
+    conv.src_color = pl_color_space_hdr10;
+    conv.dst_color = pl_color_space_srgb;
+    rgbf.pixels = rgb_in;
+    REQUIRE(pl_convert_planes(log, &conv));
+    for (int i = 1; i < PL_ARRAY_SIZE(rgb_out); i++) {
+        for (int c = 0; c < 3; c++) {
+            REQUIRE_CMP(rgb_out[i][c], >=, rgb_out[i - 1][c] - 1e-3f, "f");
+            REQUIRE(rgb_out[i][c] >= 0.0f && rgb_out[i][c] <= 1.0f + 1e-3f);
+        }
+    }
+
+    pl_log_destroy(&log);
 }
@@ -104,6 +104,49 @@ static void vulkan_interop_tests(pl_vulkan pl_vk,
         pl_vulkan_sem_destroy(gpu, &sem);
         pl_tex_destroy(gpu, &tex);
     }
+
+    // Test shared pools, by importing a pool into the same process
+    const pl_handle_caps pool_caps = gpu->import_caps.tex & gpu->export_caps.tex &
+                                     gpu->import_caps.sync & gpu->export_caps.sync;
+    if (pool_caps & handle_type) {
+        const struct pl_tex_params tparams = {
+            .w              = 32,
+            .h              = 32,
+            .format         = fmt,
+            .blit_dst       = true,
+            .export_handle  = handle_type,
+        };
+
+        pl_vulkan_shared_pool src = pl_vulkan_shared_pool_create(gpu,
+            pl_vulkan_shared_pool_params(
+                .tex        = &tparams,
+                .num_frames = 2,
+                .sem_handle = handle_type,
+            ));
+        REQUIRE(src);
+
+        pl_vulkan_shared_pool dst = pl_vulkan_shared_pool_create(gpu,
+            pl_vulkan_shared_pool_params(
+                .tex        = &tparams,
+                .import     = pl_vulkan_shared_pool_desc(src),
+            ));
+        REQUIRE(dst);
+
+        uint64_t value;
+        pl_tex_clear(gpu, pl_vulkan_shared_pool_tex(src, 1), (float[4]){0});
+        REQUIRE(pl_vulkan_shared_pool_send(src, 1, &value));
+        REQUIRE(!pl_vulkan_shared_pool_recv(dst, 0, value));
+        REQUIRE(pl_vulkan_shared_pool_recv(dst, 1, value));
+        pl_tex_clear(gpu, pl_vulkan_shared_pool_tex(dst, 1), (float[4]){0});
+        REQUIRE(pl_vulkan_shared_pool_send(dst, 1, &value));
+        REQUIRE_CMP(value, ==, 2, PRIu64);
+        REQUIRE(pl_vulkan_shared_pool_recv(src, 1, value));
+        pl_tex_clear(gpu, pl_vulkan_shared_pool_tex(src, 1), (float[4]){0});
+        pl_gpu_finish(gpu);
+
+        pl_vulkan_shared_pool_destroy(&dst);
+        pl_vulkan_shared_pool_destroy(&src);
+    }
 }
 
 static void vulkan_swapchain_tests(pl_vulkan vk, VkSurfaceKHR surf)
@@ -238,6 +281,14 @@ int main()
         // Print heap statistics
         pl_vk_print_heap(vk->gpu, PL_LOG_DEBUG);
 
+        struct pl_vulkan_heap_budget heaps[VK_MAX_MEMORY_HEAPS];
+        int num_heaps = pl_vulkan_get_memory_budget(vk->gpu, heaps);
+        REQUIRE_CMP(num_heaps, >, 0, "d");
+        for (int n = 0; n < num_heaps; n++) {
+            REQUIRE(heaps[n].size);
+            REQUIRE(heaps[n].budget);
+        }
+
         // Test importing this context via the vulkan interop API
         pl_vulkan vk2 = pl_vulkan_import(log, pl_vulkan_import_params(
             .instance = vk->instance,
@@ -18,8 +18,7 @@
 #include <math.h>
 
 #include "common.h"
-
-#include <libplacebo/tone_mapping.h>
+#include "tone_mapping.h"
 
 #define fclampf(x, lo, hi) fminf(fmaxf(x, lo), hi)
 static void fix_constants(struct pl_tone_map_constants *c)
@@ -193,18 +192,27 @@ static inline float rescale_out(float x, const struct pl_tone_map_params *params
     return x * (params->output_max - params->output_min) + params->output_min;
 }
 
-static inline float bt1886_eotf(float x, float min, float max)
+// BT.1886 black and white point roots, computed once outside the LUT loop
+struct bt1886 {
+    float lb, lw;
+};
+
+static inline struct bt1886 bt1886_init(float min, float max)
+{
+    return (struct bt1886) {
+        .lb = powf(min, 1/2.4f),
+        .lw = powf(max, 1/2.4f),
+    };
+}
+
+static inline float bt1886_eotf(float x, struct bt1886 c)
 {
-    const float lb = powf(min, 1/2.4f);
-    const float lw = powf(max, 1/2.4f);
-    return powf((lw - lb) * x + lb, 2.4f);
+    return powf((c.lw - c.lb) * x + c.lb, 2.4f);
 }
 
-static inline float bt1886_oetf(float x, float min, float max)
+static inline float bt1886_oetf(float x, struct bt1886 c)
 {
-    const float lb = powf(min, 1/2.4f);
-    const float lw = powf(max, 1/2.4f);
-    return (powf(x, 1/2.4f) - lb) / (lw - lb);
+    return (powf(x, 1/2.4f) - c.lb) / (c.lw - c.lb);
 }
 
 static void noop(float *lut, const struct pl_tone_map_params *params)
@@ -381,9 +389,13 @@ static void st2094_40(float *lut, const struct pl_tone_map_params *params)
     pl_assert(Kx >= 0 && Kx <= 1);
     pl_assert(Ky >= 0 && Ky <= 1);
 
+    const struct bt1886 bt_in  = bt1886_init(params->input_min, params->input_max);
+    const struct bt1886 bt_out = bt1886_init(params->output_min, params->output_max);
+    const struct bt1886 bt_ref = bt1886_init(0.0f, 1.0f);
+
     FOREACH_LUT(lut, x) {
-        x = bt1886_oetf(x, params->input_min, params->input_max);
-        x = bt1886_eotf(x, 0.0f, 1.0f);
+        x = bt1886_oetf(x, bt_in);
+        x = bt1886_eotf(x, bt_ref);
 
         if (x <= Kx && Kx) {
             // Linear section
@@ -392,15 +404,24 @@ static void st2094_40(float *lut, const struct pl_tone_map_params *params)
             // Bezier section
             const float t = (x - Kx) / (1 - Kx);
 
+            // Powers of (1 - t), to avoid calling powf() in the inner loop
+            float s[PL_ARRAY_SIZE(P)];
+            s[0] = 1.0f;
+            for (uint8_t p = 1; p <= N; p++)
+                s[p] = s[p - 1] * (1 - t);
+
+            float tp = 1.0f;
             x = 0; // Bn
-            for (uint8_t p = 0; p <= N; p++)
-                x += binom[N][p] * powf(t, p) * powf(1 - t, N - p) * P[p];
+            for (uint8_t p = 0; p <= N; p++) {
+                x += binom[N][p] * tp * s[N - p] * P[p];
+                tp *= t;
+            }
 
             x = Ky + (1 - Ky) * x;
         }
 
-        x = bt1886_oetf(x, 0.0f, 1.0f);
-        x = bt1886_eotf(x, params->output_min, params->output_max);
+        x = bt1886_oetf(x, bt_ref);
+        x = bt1886_eotf(x, bt_out);
     }
 }
 
@@ -457,15 +478,29 @@ const struct pl_tone_map_function pl_tone_map_st2094_10 = {
     .map = st2094_10,
 };
 
-static void bt2390(float *lut, const struct pl_tone_map_params *params)
+void pl_tone_map_bt2390_coeffs(struct pl_tone_bt2390 *out,
+                               const struct pl_tone_map_params *params)
 {
     const float minLum = rescale_in(params->output_min, params);
     const float maxLum = rescale_in(params->output_max, params);
     const float offset = params->constants.knee_offset;
-    const float ks = (1 + offset) * maxLum - offset;
     const float bp = minLum > 0 ? fminf(1 / minLum, 4) : 4;
     const float gain_inv = 1 + minLum / maxLum * powf(1 - maxLum, bp);
-    const float gain = maxLum < 1 ? 1 / gain_inv : 1;
+    *out = (struct pl_tone_bt2390) {
+        .minLum = minLum,
+        .maxLum = maxLum,
+        .ks     = (1 + offset) * maxLum - offset,
+        .bp     = bp,
+        .gain   = maxLum < 1 ? 1 / gain_inv : 1,
+    };
+}
+
+static void bt2390(float *lut, const struct pl_tone_map_params *params)
+{
+    struct pl_tone_bt2390 c;
+    pl_tone_map_bt2390_coeffs(&c, params);
+    const float minLum = c.minLum, maxLum = c.maxLum;
+    const float ks = c.ks, bp = c.bp, gain = c.gain;
 
     FOREACH_LUT(lut, x) {
         x = rescale_in(x, params);
@@ -506,10 +541,12 @@ static void bt2446a(float *lut, const struct pl_tone_map_params *params)
 {
     const float phdr = 1 + 32 * powf(params->input_max / 10000, 1/2.4f);
     const float psdr = 1 + 32 * powf(params->output_max / 10000, 1/2.4f);
+    const float log_phdr_inv = 1.0f / logf(phdr);
+    const struct bt1886 bt_out = bt1886_init(params->output_min, params->output_max);
 
     FOREACH_LUT(lut, x) {
         x = powf(rescale_in(x, params), 1/2.4f);
-        x = logf(1 + (phdr - 1) * x) / logf(phdr);
+        x = logf(1 + (phdr - 1) * x) * log_phdr_inv;
 
         if (x <= 0.7399f) {
             x = 1.0770f * x;
@@ -520,14 +557,16 @@ static void bt2446a(float *lut, const struct pl_tone_map_params *params)
         }
 
         x = (powf(psdr, x) - 1) / (psdr - 1);
-        x = bt1886_eotf(x, params->output_min, params->output_max);
+        x = bt1886_eotf(x, bt_out);
     }
 }
 
 static void bt2446a_inv(float *lut, const struct pl_tone_map_params *params)
 {
+    const struct bt1886 bt_in = bt1886_init(params->input_min, params->input_max);
+
     FOREACH_LUT(lut, x) {
-        x = bt1886_oetf(x, params->input_min, params->input_max);
+        x = bt1886_oetf(x, bt_in);
         x *= 255.0;
         if (x > 70) {
             x = powf(x, (2.8305e-6f * x - 7.4622e-4f) * x + 1.2528f);
@@ -547,7 +586,8 @@ const struct pl_tone_map_function pl_tone_map_bt2446a = {
     .map_inverse = bt2446a_inv,
 };
 
-static void spline(float *lut, const struct pl_tone_map_params *params)
+void pl_tone_map_spline_coeffs(struct pl_tone_spline *out,
+                               const struct pl_tone_map_params *params)
 {
     float src_pivot, dst_pivot;
     st2094_pick_knee(&src_pivot, &dst_pivot, params);
@@ -589,10 +629,23 @@ static void spline(float *lut, const struct pl_tone_map_params *params)
     const float Qb = -3 * (slope * in_max - out_max) / t;
     const float Qc = slope;
 
+    *out = (struct pl_tone_spline) {
+        .src_pivot = src_pivot,
+        .dst_pivot = dst_pivot,
+        .Pa = Pa, .Pb = Pb,
+        .Qa = Qa, .Qb = Qb, .Qc = Qc,
+    };
+}
+
+static void spline(float *lut, const struct pl_tone_map_params *params)
+{
+    struct pl_tone_spline c;
+    pl_tone_map_spline_coeffs(&c, params);
+
     FOREACH_LUT(lut, x) {
-        x -= src_pivot;
-        x = x > 0 ? ((Qa * x + Qb) * x + Qc) * x : (Pa * x + Pb) * x;
-        x += dst_pivot;
+        x -= c.src_pivot;
+        x = x > 0 ? ((c.Qa * x + c.Qb) * x + c.Qc) * x : (c.Pa * x + c.Pb) * x;
+        x += c.dst_pivot;
     }
 }
 
@@ -673,12 +726,17 @@ static void hable_map(float *lut, const struct pl_tone_map_params *params)
     const float peak = params->input_max / params->output_max,
                 scale = 1.0f / hable(peak);
 
+    const struct bt1886 bt_in   = bt1886_init(params->input_min, params->input_max);
+    const struct bt1886 bt_peak = bt1886_init(0.0f, peak);
+    const struct bt1886 bt_ref  = bt1886_init(0.0f, 1.0f);
+    const struct bt1886 bt_out  = bt1886_init(params->output_min, params->output_max);
+
     FOREACH_LUT(lut, x) {
-        x = bt1886_oetf(x, params->input_min, params->input_max);
-        x = bt1886_eotf(x, 0, peak);
+        x = bt1886_oetf(x, bt_in);
+        x = bt1886_eotf(x, bt_peak);
         x = scale * hable(x);
-        x = bt1886_oetf(x, 0, 1);
-        x = bt1886_eotf(x, params->output_min, params->output_max);
+        x = bt1886_oetf(x, bt_ref);
+        x = bt1886_eotf(x, bt_out);
     }
 }
 
@@ -0,0 +1,41 @@
+/*
+ * This file is part of libplacebo.
+ *
+ * libplacebo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libplacebo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libplacebo. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <libplacebo/tone_mapping.h>
+
+// Pre-computed coefficients of some tone mapping functions, shared between the
+// CPU implementation and the pure GLSL fast paths. `params` is expected to be
+// already inferred, and in the function's native scaling (PL_HDR_PQ).
+
+struct pl_tone_spline {
+    float src_pivot, dst_pivot;
+    float Pa, Pb;       // P(x) for x <= 0, relative to the pivot
+    float Qa, Qb, Qc;   // Q(x) for x > 0, relative to the pivot
+};
+
+void pl_tone_map_spline_coeffs(struct pl_tone_spline *out,
+                               const struct pl_tone_map_params *params);
+
+struct pl_tone_bt2390 {
+    float minLum, maxLum;   // input-relative
+    float ks, bp, gain;
+};
+
+void pl_tone_map_bt2390_coeffs(struct pl_tone_bt2390 *out,
+                               const struct pl_tone_map_params *params);
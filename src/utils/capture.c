@@ -0,0 +1,1005 @@
+/*
+ * This file is part of libplacebo.
+ *
+ * libplacebo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libplacebo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libplacebo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "gpu.h"
+
+#include <libplacebo/utils/capture.h>
+
+// A capture is a flat stream of operations, each starting with a `uint32_t`
+// opcode. Objects are defined (and assigned an ID) right before their first
+// use, so the stream can be replayed in a single pass. All fields are stored
+// in host byte order, as the file is not meant to be portable across hosts.
+#define CAPTURE_MAGIC   "pl_captr"
+#define CAPTURE_VERSION 1
+
+enum op {
+    OP_TEX = 1,     // defines a texture
+    OP_BUF,         // defines a buffer
+    OP_PASS,        // defines a pass
+    OP_WRITE,       // pl_buf_write
+    OP_RUN,         // pl_pass_run
+};
+
+struct __attribute__((__packed__)) capture_header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t glsl_version;
+    uint32_t glsl_flags;    // bit 0: gles, bit 1: vulkan
+};
+
+enum { TEX, BUF, PASS };
+
+struct obj {
+    const void *ptr;
+    uint32_t id;
+};
+
+struct pl_capture_t {
+    pl_gpu gpu;
+    pl_str data;
+    PL_ARRAY(struct obj) objs;
+    uint32_t num_ids;
+};
+
+// Nesting depth of `pl_capture_pass_run` on the calling thread, so that
+// backends implementing `pass_run` on top of `pl_pass_run` are only recorded
+// once
+static _Thread_local int run_depth;
+
+pl_capture pl_capture_create(pl_gpu gpu)
+{
+    struct pl_gpu_fns *impl = PL_PRIV(gpu);
+    pl_capture cap = pl_zalloc_ptr(NULL, cap);
+    cap->gpu = gpu;
+
+    pl_mutex_lock(&impl->capture_lock);
+    if (atomic_load(&impl->capture)) {
+        pl_mutex_unlock(&impl->capture_lock);
+        PL_ERR(gpu, "A capture is already attached to this GPU!");
+        pl_free(cap);
+        return NULL;
+    }
+
+    atomic_store(&impl->capture, cap);
+    pl_mutex_unlock(&impl->capture_lock);
+    return cap;
+}
+
+void pl_capture_destroy(pl_capture *pcap)
+{
+    pl_capture cap = *pcap;
+    if (!cap)
+        return;
+
+    struct pl_gpu_fns *impl = PL_PRIV(cap->gpu);
+    pl_mutex_lock(&impl->capture_lock);
+    atomic_store(&impl->capture, NULL);
+    pl_mutex_unlock(&impl->capture_lock);
+
+    pl_free(cap);
+    *pcap = NULL;
+}
+
+size_t pl_capture_save(pl_capture cap, uint8_t *out, size_t out_size)
+{
+    struct pl_gpu_fns *impl = PL_PRIV(cap->gpu);
+    pl_mutex_lock(&impl->capture_lock);
+    const size_t size = sizeof(struct capture_header) + cap->data.len;
+    if (!out || out_size < size)
+        goto done;
+
+    const struct pl_glsl_version glsl = cap->gpu->glsl;
+    memcpy(out, &(struct capture_header) {
+        .magic          = CAPTURE_MAGIC,
+        .version        = CAPTURE_VERSION,
+        .glsl_version   = glsl.version,
+        .glsl_flags     = glsl.gles | glsl.vulkan << 1,
+    }, sizeof(struct capture_header));
+    if (cap->data.len)
+        memcpy(out + sizeof(struct capture_header), cap->data.buf, cap->data.len);
+
+done:
+    pl_mutex_unlock(&impl->capture_lock);
+    return size;
+}
+
+// Locks and returns the attached capture, or NULL (in which case nothing is
+// locked)
+static pl_capture lock_capture(pl_gpu gpu)
+{
+    struct pl_gpu_fns *impl = PL_PRIV(gpu);
+    pl_mutex_lock(&impl->capture_lock);
+    pl_capture cap = atomic_load(&impl->capture);
+    if (!cap)
+        pl_mutex_unlock(&impl->capture_lock);
+    return cap;
+}
+
+static void unlock_capture(pl_capture cap)
+{
+    struct pl_gpu_fns *impl = PL_PRIV(cap->gpu);
+    pl_mutex_unlock(&impl->capture_lock);
+}
+
+static void put_u32(pl_capture cap, uint32_t val)
+{
+    pl_str_append_raw(cap, &cap->data, &val, sizeof(val));
+}
+
+static void put_u64(pl_capture cap, uint64_t val)
+{
+    pl_str_append_raw(cap, &cap->data, &val, sizeof(val));
+}
+
+static void put_blob(pl_capture cap, const void *ptr, size_t size)
+{
+    put_u64(cap, ptr ? size : 0);
+    if (ptr && size)
+        pl_str_append_raw(cap, &cap->data, ptr, size);
+}
+
+// Strings are stored including the trailing \0, or as empty blobs for NULL
+static void put_str(pl_capture cap, const char *str)
+{
+    put_blob(cap, str, str ? strlen(str) + 1 : 0);
+}
+
+static void put_fmt(pl_capture cap, pl_fmt fmt)
+{
+    put_str(cap, fmt ? fmt->name : NULL);
+}
+
+static void put_rect(pl_capture cap, pl_rect2d rc)
+{
+    put_u32(cap, rc.x0);
+    put_u32(cap, rc.y0);
+    put_u32(cap, rc.x1);
+    put_u32(cap, rc.y1);
+}
+
+static size_t constants_size(const struct pl_pass_params *params)
+{
+    size_t size = 0;
+    for (int i = 0; i < params->num_constants; i++) {
+        const struct pl_constant *c = &params->constants[i];
+        size = PL_MAX(size, c->offset + pl_var_type_size(c->type));
+    }
+    return size;
+}
+
+static void put_tex(pl_capture cap, uint32_t id, pl_tex tex)
+{
+    const struct pl_tex_params *par = &tex->params;
+    put_u32(cap, OP_TEX);
+    put_u32(cap, id);
+    put_u32(cap, par->w);
+    put_u32(cap, par->h);
+    put_u32(cap, par->d);
+    put_fmt(cap, par->format);
+    put_u32(cap, par->sampleable    << 0 |
+                 par->renderable    << 1 |
+                 par->storable      << 2 |
+                 par->blit_src      << 3 |
+                 par->blit_dst      << 4 |
+                 par->host_writable << 5 |
+                 par->host_readable << 6);
+}
+
+static void put_buf(pl_capture cap, uint32_t id, pl_buf buf)
+{
+    const struct pl_buf_params *par = &buf->params;
+    put_u32(cap, OP_BUF);
+    put_u32(cap, id);
+    put_u64(cap, par->size);
+    put_fmt(cap, par->format);
+    put_u32(cap, par->memory_type);
+    put_u32(cap, par->host_writable << 0 |
+                 par->host_readable << 1 |
+                 par->uniform       << 2 |
+                 par->storable      << 3 |
+                 par->drawable      << 4);
+}
+
+static void put_pass(pl_capture cap, uint32_t id, pl_pass pass)
+{
+    const struct pl_pass_params *par = &pass->params;
+    put_u32(cap, OP_PASS);
+    put_u32(cap, id);
+    put_u32(cap, par->type);
+    put_str(cap, par->glsl_shader);
+
+    put_u32(cap, par->num_variables);
+    for (int i = 0; i < par->num_variables; i++) {
+        const struct pl_var *var = &par->variables[i];
+        put_str(cap, var->name);
+        put_u32(cap, var->type);
+        put_u32(cap, var->dim_v);
+        put_u32(cap, var->dim_m);
+        put_u32(cap, var->dim_a);
+    }
+
+    put_u32(cap, par->num_descriptors);
+    for (int i = 0; i < par->num_descriptors; i++) {
+        const struct pl_desc *desc = &par->descriptors[i];
+        put_str(cap, desc->name);
+        put_u32(cap, desc->type);
+        put_u32(cap, desc->binding);
+        put_u32(cap, desc->access);
+    }
+
+    put_u32(cap, par->num_constants);
+    for (int i = 0; i < par->num_constants; i++) {
+        const struct pl_constant *c = &par->constants[i];
+        put_u32(cap, c->type);
+        put_u32(cap, c->id);
+        put_u64(cap, c->offset);
+    }
+    put_blob(cap, par->constant_data, constants_size(par));
+    put_u64(cap, par->push_constants_size);
+
+    if (par->type != PL_PASS_RASTER)
+        return;
+
+    put_str(cap, par->vertex_shader);
+    put_u32(cap, par->vertex_type);
+    put_u64(cap, par->vertex_stride);
+    put_u32(cap, par->num_vertex_attribs);
+    for (int i = 0; i < par->num_vertex_attribs; i++) {
+        const struct pl_vertex_attrib *va = &par->vertex_attribs[i];
+        put_str(cap, va->name);
+        put_fmt(cap, va->fmt);
+        put_u64(cap, va->offset);
+        put_u32(cap, va->location);
+    }
+
+    put_fmt(cap, par->target_format);
+    put_u32(cap, par->load_target);
+    put_u32(cap, !!par->blend_params);
+    if (par->blend_params) {
+        put_u32(cap, par->blend_params->src_rgb);
+        put_u32(cap, par->blend_params->dst_rgb);
+        put_u32(cap, par->blend_params->src_alpha);
+        put_u32(cap, par->blend_params->dst_alpha);
+    }
+}
+
+// Returns the ID of `ptr`, defining it first if it was not seen before.
+// 0 is reserved for NULL.
+static uint32_t obj_id(pl_capture cap, const void *ptr, int type)
+{
+    if (!ptr)
+        return 0;
+
+    for (int i = 0; i < cap->objs.num; i++) {
+        if (cap->objs.elem[i].ptr == ptr)
+            return cap->objs.elem[i].id;
+    }
+
+    uint32_t id = ++cap->num_ids;
+    switch (type) {
+    case TEX:  put_tex(cap, id, ptr); break;
+    case BUF:  put_buf(cap, id, ptr); break;
+    case PASS: put_pass(cap, id, ptr); break;
+    }
+
+    PL_ARRAY_APPEND(cap, cap->objs, (struct obj) { ptr, id });
+    return id;
+}
+
+static int desc_obj_type(enum pl_desc_type type)
+{
+    switch (type) {
+    case PL_DESC_SAMPLED_TEX:
+    case PL_DESC_STORAGE_IMG:
+        return TEX;
+    case PL_DESC_BUF_UNIFORM:
+    case PL_DESC_BUF_STORAGE:
+    case PL_DESC_BUF_TEXEL_UNIFORM:
+    case PL_DESC_BUF_TEXEL_STORAGE:
+        return BUF;
+    case PL_DESC_INVALID:
+    case PL_DESC_TYPE_COUNT:
+        break;
+    }
+
+    pl_unreachable();
+}
+
+static void record_run(pl_capture cap, const struct pl_pass_run_params *params)
+{
+    pl_pass pass = params->pass;
+    const struct pl_pass_params *par = &pass->params;
+    const bool raster = par->type == PL_PASS_RASTER;
+
+    // Define all objects first, so they precede the run itself
+    uint32_t *ids = pl_calloc_ptr(NULL, par->num_descriptors, ids);
+    for (int i = 0; i < par->num_descriptors; i++) {
+        ids[i] = obj_id(cap, params->desc_bindings[i].object,
+                        desc_obj_type(par->descriptors[i].type));
+    }
+
+    uint32_t pass_id = obj_id(cap, pass, PASS);
+    uint32_t target_id = 0, vbuf_id = 0, ibuf_id = 0;
+    if (raster) {
+        target_id = obj_id(cap, params->target, TEX);
+        vbuf_id = obj_id(cap, params->vertex_buf, BUF);
+        ibuf_id = obj_id(cap, params->index_buf, BUF);
+    }
+
+    put_u32(cap, OP_RUN);
+    put_u32(cap, pass_id);
+    put_blob(cap, params->constant_data, constants_size(par));
+
+    put_u32(cap, params->num_var_updates);
+    for (int i = 0; i < params->num_var_updates; i++) {
+        const struct pl_var_update *vu = &params->var_updates[i];
+        const struct pl_var *var = &par->variables[vu->index];
+        put_u32(cap, vu->index);
+        put_blob(cap, vu->data, pl_var_host_layout(0, var).size);
+    }
+
+    for (int i = 0; i < par->num_descriptors; i++) {
+        put_u32(cap, ids[i]);
+        put_u32(cap, params->desc_bindings[i].address_mode);
+        put_u32(cap, params->desc_bindings[i].sample_mode);
+    }
+    pl_free(ids);
+
+    put_blob(cap, params->push_constants, par->push_constants_size);
+
+    if (raster) {
+        put_u32(cap, target_id);
+        put_rect(cap, params->viewport);
+        put_rect(cap, params->scissors);
+        put_u32(cap, params->vertex_count);
+        put_u32(cap, params->index_fmt);
+        put_blob(cap, params->vertex_data, pl_vertex_buf_size(params));
+        put_u32(cap, vbuf_id);
+        put_u64(cap, params->buf_offset);
+        put_blob(cap, params->index_data, pl_index_buf_size(params));
+        put_u32(cap, ibuf_id);
+        put_u64(cap, params->index_offset);
+    } else {
+        for (int i = 0; i < PL_ARRAY_SIZE(params->compute_groups); i++)
+            put_u32(cap, params->compute_groups[i]);
+    }
+}
+
+void pl_capture_pass_run(pl_gpu gpu, const struct pl_pass_run_params *params)
+{
+    if (!run_depth) {
+        pl_capture cap = lock_capture(gpu);
+        if (cap) {
+            record_run(cap, params);
+            unlock_capture(cap);
+        }
+    }
+
+    const struct pl_gpu_fns *impl = PL_PRIV(gpu);
+    run_depth++;
+    impl->pass_run(gpu, params);
+    run_depth--;
+}
+
+void pl_capture_buf_write(pl_gpu gpu, pl_buf buf, size_t offset,
+                          const void *data, size_t size)
+{
+    // Only uniform and vertex data is recorded, see the header
+    if (run_depth || !(buf->params.uniform || buf->params.drawable))
+        return;
+
+    pl_capture cap = lock_capture(gpu);
+    if (!cap)
+        return;
+
+    uint32_t id = obj_id(cap, buf, BUF);
+    put_u32(cap, OP_WRITE);
+    put_u32(cap, id);
+    put_u64(cap, offset);
+    put_blob(cap, data, size);
+    unlock_capture(cap);
+}
+
+void pl_capture_forget(pl_gpu gpu, const void *obj)
+{
+    pl_capture cap = lock_capture(gpu);
+    if (!cap)
+        return;
+
+    for (int i = 0; i < cap->objs.num; i++) {
+        if (cap->objs.elem[i].ptr == obj) {
+            PL_ARRAY_REMOVE_AT(cap->objs, i);
+            break;
+        }
+    }
+
+    unlock_capture(cap);
+}
+
+// Replay
+
+struct reader {
+    pl_str data;
+    bool ok;
+};
+
+static void get_raw(struct reader *r, void *out, size_t size)
+{
+    if (r->data.len < size) {
+        r->ok = false;
+        memset(out, 0, size);
+        return;
+    }
+
+    memcpy(out, r->data.buf, size);
+    r->data = pl_str_drop(r->data, size);
+}
+
+static uint32_t get_u32(struct reader *r)
+{
+    uint32_t val;
+    get_raw(r, &val, sizeof(val));
+    return val;
+}
+
+static uint64_t get_u64(struct reader *r)
+{
+    uint64_t val;
+    get_raw(r, &val, sizeof(val));
+    return val;
+}
+
+// Returns a copy of the blob, allocated on `alloc`, or NULL if empty.
+// `size` must match, unless it is NULL.
+static void *get_blob(struct reader *r, void *alloc, size_t *size)
+{
+    uint64_t len = get_u64(r);
+    if (len > r->data.len || (size && *size && len && len != *size)) {
+        r->ok = false;
+        return NULL;
+    }
+
+    void *ptr = len ? pl_memdup(alloc, r->data.buf, len) : NULL;
+    r->data = pl_str_drop(r->data, len);
+    if (size)
+        *size = len;
+    return ptr;
+}
+
+static const char *get_str(struct reader *r, void *alloc)
+{
+    size_t len = 0;
+    char *str = get_blob(r, alloc, &len);
+    if (str && str[len - 1]) {
+        r->ok = false;
+        return NULL;
+    }
+    return str;
+}
+
+// Bounds element counts by the remaining data, to reject garbage early
+static int get_count(struct reader *r)
+{
+    uint32_t num = get_u32(r);
+    if (num > r->data.len) {
+        r->ok = false;
+        return 0;
+    }
+    return num;
+}
+
+static pl_fmt get_fmt(struct reader *r, pl_gpu gpu, void *tmp)
+{
+    const char *name = get_str(r, tmp);
+    if (!name)
+        return NULL;
+
+    pl_fmt fmt = pl_find_named_fmt(gpu, name);
+    if (!fmt) {
+        PL_ERR(gpu, "Failed replaying capture: format '%s' not supported!", name);
+        r->ok = false;
+    }
+    return fmt;
+}
+
+static pl_rect2d get_rect(struct reader *r)
+{
+    pl_rect2d rc;
+    rc.x0 = (int32_t) get_u32(r);
+    rc.y0 = (int32_t) get_u32(r);
+    rc.x1 = (int32_t) get_u32(r);
+    rc.y1 = (int32_t) get_u32(r);
+    return rc;
+}
+
+struct replay_pass {
+    pl_pass pass;
+    int index;
+    int runs;
+    uint64_t ns;
+    bool seen;
+};
+
+struct replay_obj {
+    int type;
+    union {
+        pl_tex tex;
+        pl_buf buf;
+        struct replay_pass *pass;
+    };
+};
+
+struct replay_op {
+    enum op type;
+    pl_timer timer;
+    struct replay_pass *pass;
+    union {
+        struct pl_pass_run_params run;
+        struct {
+            pl_buf buf;
+            size_t offset;
+            const void *data;
+            size_t size;
+        } write;
+    };
+};
+
+struct replay {
+    pl_gpu gpu;
+    void *tmp;
+    struct reader r;
+    PL_ARRAY(struct replay_obj) objs;
+    PL_ARRAY(struct replay_op) ops;
+    int num_passes;
+};
+
+static const void *get_obj(struct replay *rp, int type)
+{
+    uint32_t id = get_u32(&rp->r);
+    if (!id)
+        return NULL;
+    if (id > rp->objs.num || rp->objs.elem[id - 1].type != type) {
+        rp->r.ok = false;
+        return NULL;
+    }
+
+    const struct replay_obj *obj = &rp->objs.elem[id - 1];
+    switch (type) {
+    case TEX:  return obj->tex;
+    case BUF:  return obj->buf;
+    case PASS: return obj->pass;
+    }
+
+    pl_unreachable();
+}
+
+static bool define_obj(struct replay *rp, uint32_t id, struct replay_obj obj)
+{
+    if (id != rp->objs.num + 1)
+        return false;
+    PL_ARRAY_APPEND(rp->tmp, rp->objs, obj);
+    return true;
+}
+
+static bool read_tex(struct replay *rp)
+{
+    struct reader *r = &rp->r;
+    pl_gpu gpu = rp->gpu;
+    uint32_t id = get_u32(r);
+    struct pl_tex_params params = { .debug_tag = PL_DEBUG_TAG };
+    params.w = get_u32(r);
+    params.h = get_u32(r);
+    params.d = get_u32(r);
+    params.format = get_fmt(r, gpu, rp->tmp);
+    uint32_t flags = get_u32(r);
+    if (!r->ok || !params.format)
+        return false;
+
+    params.sampleable    = flags & (1 << 0);
+    params.renderable    = flags & (1 << 1);
+    params.storable      = flags & (1 << 2);
+    params.blit_src      = flags & (1 << 3);
+    params.blit_dst      = flags & (1 << 4);
+    params.host_writable = flags & (1 << 5);
+    params.host_readable = flags & (1 << 6);
+    if (params.format->caps & PL_FMT_CAP_BLITTABLE)
+        params.blit_dst = true; // needed to zero-initialize the contents
+
+    pl_tex tex = pl_tex_create(gpu, &params);
+    if (!tex || !define_obj(rp, id, (struct replay_obj) { .type = TEX, .tex = tex })) {
+        pl_tex_destroy(gpu, &tex);
+        return false;
+    }
+
+    if (params.blit_dst)
+        pl_tex_clear(gpu, tex, (float[4]) {0});
+    return true;
+}
+
+static bool read_buf(struct replay *rp)
+{
+    struct reader *r = &rp->r;
+    pl_gpu gpu = rp->gpu;
+    uint32_t id = get_u32(r);
+    struct pl_buf_params params = { .debug_tag = PL_DEBUG_TAG };
+    params.size = get_u64(r);
+    params.format = get_fmt(r, gpu, rp->tmp);
+    params.memory_type = get_u32(r);
+    uint32_t flags = get_u32(r);
+    if (!r->ok || params.size > gpu->limits.max_buf_size ||
+        params.memory_type >= PL_BUF_MEM_TYPE_COUNT)
+        return false;
+
+    params.host_writable = flags & (1 << 0);
+    params.host_readable = flags & (1 << 1);
+    params.uniform       = flags & (1 << 2);
+    params.storable      = flags & (1 << 3);
+    params.drawable      = flags & (1 << 4);
+
+    void *zero = pl_zalloc(NULL, params.size);
+    params.initial_data = zero;
+    pl_buf buf = pl_buf_create(gpu, &params);
+    pl_free(zero);
+
+    if (!buf || !define_obj(rp, id, (struct replay_obj) { .type = BUF, .buf = buf })) {
+        pl_buf_destroy(gpu, &buf);
+        return false;
+    }
+
+    return true;
+}
+
+static bool read_pass(struct replay *rp)
+{
+    struct reader *r = &rp->r;
+    pl_gpu gpu = rp->gpu;
+    void *tmp = pl_tmp(NULL);
+    uint32_t id = get_u32(r);
+    struct pl_pass_params params = {0};
+    params.type = get_u32(r);
+    params.glsl_shader = get_str(r, tmp);
+
+    if (params.type != PL_PASS_RASTER && params.type != PL_PASS_COMPUTE)
+        goto error;
+
+    params.num_variables = get_count(r);
+    params.variables = pl_calloc_ptr(tmp, params.num_variables, params.variables);
+    for (int i = 0; i < params.num_variables; i++) {
+        struct pl_var *var = &params.variables[i];
+        var->name = get_str(r, tmp);
+        var->type = get_u32(r);
+        var->dim_v = get_u32(r);
+        var->dim_m = get_u32(r);
+        var->dim_a = get_u32(r);
+        if (var->type >= PL_VAR_TYPE_COUNT)
+            goto error;
+    }
+
+    params.num_descriptors = get_count(r);
+    params.descriptors = pl_calloc_ptr(tmp, params.num_descriptors, params.descriptors);
+    for (int i = 0; i < params.num_descriptors; i++) {
+        struct pl_desc *desc = &params.descriptors[i];
+        desc->name = get_str(r, tmp);
+        desc->type = get_u32(r);
+        desc->binding = get_u32(r);
+        desc->access = get_u32(r);
+        if (desc->type == PL_DESC_INVALID || desc->type >= PL_DESC_TYPE_COUNT ||
+            desc->access >= PL_DESC_ACCESS_COUNT)
+            goto error;
+    }
+
+    params.num_constants = get_count(r);
+    params.constants = pl_calloc_ptr(tmp, params.num_constants, params.constants);
+    for (int i = 0; i < params.num_constants; i++) {
+        struct pl_constant *c = &params.constants[i];
+        c->type = get_u32(r);
+        c->id = get_u32(r);
+        c->offset = get_u64(r);
+        if (c->type >= PL_VAR_TYPE_COUNT)
+            goto error;
+    }
+
+    size_t size = constants_size(&params);
+    params.constant_data = get_blob(r, tmp, &size);
+    if (params.num_constants && !params.constant_data)
+        goto error;
+    params.push_constants_size = get_u64(r);
+
+    if (params.type == PL_PASS_RASTER) {
+        params.vertex_shader = get_str(r, tmp);
+        params.vertex_type = get_u32(r);
+        params.vertex_stride = get_u64(r);
+        params.num_vertex_attribs = get_count(r);
+        params.vertex_attribs = pl_calloc_ptr(tmp, params.num_vertex_attribs,
+                                              params.vertex_attribs);
+        for (int i = 0; i < params.num_vertex_attribs; i++) {
+            struct pl_vertex_attrib *va = &params.vertex_attribs[i];
+            va->name = get_str(r, tmp);
+            va->fmt = get_fmt(r, gpu, tmp);
+            va->offset = get_u64(r);
+            va->location = get_u32(r);
+        }
+
+        params.target_format = get_fmt(r, gpu, tmp);
+        params.load_target = get_u32(r);
+        if (get_u32(r)) {
+            struct pl_blend_params *blend = pl_zalloc_ptr(tmp, blend);
+            blend->src_rgb = get_u32(r);
+            blend->dst_rgb = get_u32(r);
+            blend->src_alpha = get_u32(r);
+            blend->dst_alpha = get_u32(r);
+            params.blend_params = blend;
+        }
+
+        if (params.vertex_type >= PL_PRIM_TYPE_COUNT)
+            goto error;
+    }
+
+    if (!r->ok || !params.glsl_shader)
+        goto error;
+
+    struct replay_pass *pass = pl_zalloc_ptr(rp->tmp, pass);
+    pass->index = rp->num_passes;
+    pass->pass = pl_pass_create(gpu, &params);
+    if (!pass->pass)
+        goto error;
+    if (!define_obj(rp, id, (struct replay_obj) { .type = PASS, .pass = pass })) {
+        pl_pass_destroy(gpu, &pass->pass);
+        goto error;
+    }
+
+    rp->num_passes++;
+    pl_free(tmp);
+    return true;
+
+error:
+    pl_free(tmp);
+    return false;
+}
+
+static bool read_write(struct replay *rp)
+{
+    struct reader *r = &rp->r;
+    struct replay_op op = { .type = OP_WRITE };
+    op.write.buf = get_obj(rp, BUF);
+    op.write.offset = get_u64(r);
+    op.write.data = get_blob(r, rp->tmp, &op.write.size);
+    if (!r->ok || !op.write.buf)
+        return false;
+
+    PL_ARRAY_APPEND(rp->tmp, rp->ops, op);
+    return true;
+}
+
+static bool read_run(struct replay *rp)
+{
+    struct reader *r = &rp->r;
+    struct replay_op op = { .type = OP_RUN };
+    struct replay_pass *rpass = op.pass = (struct replay_pass *) get_obj(rp, PASS);
+    if (!rpass)
+        return false;
+
+    pl_pass pass = rpass->pass;
+    const struct pl_pass_params *par = &pass->params;
+    struct pl_pass_run_params *run = &op.run;
+    run->pass = pass;
+
+    size_t size = constants_size(par);
+    run->constant_data = get_blob(r, rp->tmp, &size);
+
+    int num_updates = get_count(r);
+    for (int i = 0; i < num_updates; i++) {
+        uint32_t index = get_u32(r);
+        if (index >= par->num_variables)
+            return false;
+        size = pl_var_host_layout(0, &par->variables[index]).size;
+        const void *data = get_blob(r, rp->tmp, &size);
+        if (!data)
+            return false;
+        PL_ARRAY_APPEND_RAW(rp->tmp, run->var_updates, run->num_var_updates,
+                            (struct pl_var_update) { index, data });
+    }
+
+    if (!rpass->seen) {
+        // Variables not updated during the capture are replayed as zero
+        for (int i = 0; i < par->num_variables; i++) {
+            bool updated = false;
+            for (int n = 0; n < num_updates; n++)
+                updated |= run->var_updates[n].index == i;
+            if (updated)
+                continue;
+            size = pl_var_host_layout(0, &par->variables[i]).size;
+            PL_ARRAY_APPEND_RAW(rp->tmp, run->var_updates, run->num_var_updates,
+                                (struct pl_var_update) { i, pl_zalloc(rp->tmp, size) });
+        }
+        rpass->seen = true;
+    }
+
+    run->desc_bindings = pl_calloc_ptr(rp->tmp, par->num_descriptors,
+                                       run->desc_bindings);
+    for (int i = 0; i < par->num_descriptors; i++) {
+        struct pl_desc_binding *db = &run->desc_bindings[i];
+        db->object = get_obj(rp, desc_obj_type(par->descriptors[i].type));
+        db->address_mode = get_u32(r);
+        db->sample_mode = get_u32(r);
+        if (!db->object || db->address_mode >= PL_TEX_ADDRESS_MODE_COUNT ||
+            db->sample_mode >= PL_TEX_SAMPLE_MODE_COUNT)
+            return false;
+    }
+
+    size = par->push_constants_size;
+    run->push_constants = get_blob(r, rp->tmp, &size);
+    if (par->push_constants_size && !run->push_constants)
+        return false;
+
+    if (par->type == PL_PASS_RASTER) {
+        run->target = get_obj(rp, TEX);
+        run->viewport = get_rect(r);
+        run->scissors = get_rect(r);
+        run->vertex_count = get_u32(r);
+        run->index_fmt = get_u32(r);
+        if (run->index_fmt >= PL_INDEX_FORMAT_COUNT)
+            return false;
+        size_t vert_size = 0, index_size = 0;
+        run->vertex_data = get_blob(r, rp->tmp, &vert_size);
+        run->vertex_buf = get_obj(rp, BUF);
+        run->buf_offset = get_u64(r);
+        run->index_data = get_blob(r, rp->tmp, &index_size);
+        run->index_buf = get_obj(rp, BUF);
+        run->index_offset = get_u64(r);
+        if (!run->target || !run->vertex_data == !run->vertex_buf)
+            return false;
+        if (run->index_data && index_size != pl_index_buf_size(run))
+            return false;
+        if (run->vertex_data && vert_size < pl_vertex_buf_size(run))
+            return false;
+    } else {
+        for (int i = 0; i < PL_ARRAY_SIZE(run->compute_groups); i++)
+            run->compute_groups[i] = get_u32(r);
+    }
+
+    if (!r->ok)
+        return false;
+
+    op.timer = pl_timer_create(rp->gpu);
+    run->timer = op.timer;
+    PL_ARRAY_APPEND(rp->tmp, rp->ops, op);
+    return true;
+}
+
+static void replay_uninit(struct replay *rp)
+{
+    pl_gpu gpu = rp->gpu;
+    for (int i = 0; i < rp->ops.num; i++)
+        pl_timer_destroy(gpu, &rp->ops.elem[i].timer);
+
+    for (int i = 0; i < rp->objs.num; i++) {
+        struct replay_obj *obj = &rp->objs.elem[i];
+        switch (obj->type) {
+        case TEX:  pl_tex_destroy(gpu, &obj->tex); break;
+        case BUF:  pl_buf_destroy(gpu, &obj->buf); break;
+        case PASS: pl_pass_destroy(gpu, &obj->pass->pass); break;
+        }
+    }
+
+    pl_free(rp->tmp);
+}
+
+bool pl_capture_replay(pl_gpu gpu, const uint8_t *data, size_t size,
+                       const struct pl_capture_replay_params *params)
+{
+    struct capture_header header;
+    if (size < sizeof(header)) {
+        PL_ERR(gpu, "Failed replaying capture: file seems empty or truncated");
+        return false;
+    }
+
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, CAPTURE_MAGIC, sizeof(header.magic)) != 0) {
+        PL_ERR(gpu, "Failed replaying capture: invalid magic bytes");
+        return false;
+    }
+    if (header.version != CAPTURE_VERSION) {
+        PL_ERR(gpu, "Failed replaying capture: unsupported version %u",
+               (unsigned) header.version);
+        return false;
+    }
+
+    const struct pl_glsl_version glsl = gpu->glsl;
+    if (header.glsl_version != glsl.version ||
+        header.glsl_flags != (glsl.gles | glsl.vulkan << 1))
+    {
+        PL_WARN(gpu, "Replaying capture from a GPU with a different GLSL "
+                "dialect (version %u, flags 0x%x), shaders may fail to compile!",
+                (unsigned) header.glsl_version, (unsigned) header.glsl_flags);
+    }
+
+    struct replay rp = {
+        .gpu = gpu,
+        .tmp = pl_tmp(NULL),
+        .r = {
+            .data = { (uint8_t *) data + sizeof(header), size - sizeof(header) },
+            .ok = true,
+        },
+    };
+
+    while (rp.r.data.len) {
+        bool ok;
+        enum op op = get_u32(&rp.r);
+        switch (op) {
+        case OP_TEX:   ok = read_tex(&rp); break;
+        case OP_BUF:   ok = read_buf(&rp); break;
+        case OP_PASS:  ok = read_pass(&rp); break;
+        case OP_WRITE: ok = read_write(&rp); break;
+        case OP_RUN:   ok = read_run(&rp); break;
+        default:       ok = false; break;
+        }
+
+        if (!ok || !rp.r.ok) {
+            PL_ERR(gpu, "Failed replaying capture: corrupt or unsupported "
+                   "operation at offset %zu", size - rp.r.data.len);
+            replay_uninit(&rp);
+            return false;
+        }
+    }
+
+    const int iterations = PL_DEF(params->iterations, 1);
+    for (int i = 0; i < iterations; i++) {
+        for (int n = 0; n < rp.ops.num; n++) {
+            struct replay_op *op = &rp.ops.elem[n];
+            switch (op->type) {
+            case OP_WRITE:
+                pl_buf_write(gpu, op->write.buf, op->write.offset,
+                             op->write.data, op->write.size);
+                break;
+            case OP_RUN:
+                pl_pass_run(gpu, &op->run);
+                if (!i)
+                    op->pass->runs++;
+                break;
+            default: pl_unreachable();
+            }
+        }
+
+        pl_gpu_finish(gpu);
+        for (int n = 0; n < rp.ops.num; n++) {
+            struct replay_op *op = &rp.ops.elem[n];
+            uint64_t ns;
+            while (op->timer && (ns = pl_timer_query(gpu, op->timer)))
+                op->pass->ns += ns;
+        }
+    }
+
+    bool ok = !pl_gpu_is_failed(gpu);
+    for (int i = 0; ok && params->pass_info && i < rp.objs.num; i++) {
+        const struct replay_obj *obj = &rp.objs.elem[i];
+        if (obj->type != PASS)
+            continue;
+        const struct replay_pass *pass = obj->pass;
+        params->pass_info(params->priv, &(struct pl_capture_pass_info) {
+            .index      = pass->index,
+            .type       = pass->pass->params.type,
+            .shader     = pass->pass->params.glsl_shader,
+            .runs       = pass->runs,
+            .total_ns   = pass->ns,
+        });
+    }
+
+    replay_uninit(&rp);
+    return ok;
+}
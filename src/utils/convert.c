@@ -0,0 +1,895 @@
+/*
+ * This file is part of libplacebo.
+ *
+ * libplacebo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libplacebo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libplacebo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+
+#include "common.h"
+#include "log.h"
+#include "pl_thread_pool.h"
+
+#include <libplacebo/utils/convert.h>
+
+// Common constants, see src/shaders/colorspace.c
+static const float PQ_M1 = 2610./4096 * 1./4,
+                   PQ_M2 = 2523./4096 * 128,
+                   PQ_C1 = 3424./4096,
+                   PQ_C2 = 2413./4096 * 32,
+                   PQ_C3 = 2392./4096 * 32;
+
+static const float HLG_A = 0.17883277,
+                   HLG_B = 0.28466892,
+                   HLG_C = 0.55991073,
+                   HLG_REF = 1000.0 / PL_COLOR_SDR_WHITE;
+
+static const float VLOG_B = 0.00873,
+                   VLOG_C = 0.241514,
+                   VLOG_D = 0.598206;
+
+static const float SLOG_A = 0.432699,
+                   SLOG_B = 0.037584,
+                   SLOG_C = 0.616596 + 0.03,
+                   SLOG_P = 3.538813,
+                   SLOG_Q = 0.030001,
+                   SLOG_K2 = 155.0 / 219.0;
+
+// Number of rows converted by a single job
+#define ROWS_PER_JOB 8
+
+// Colors are processed one row at a time, as separate arrays per channel,
+// keeping all inner loops simple enough to be vectorized by the compiler
+enum { R, G, B, A, NUM_CH };
+
+struct plane_layout {
+    const struct pl_plane_data *data;
+    uint8_t *pixels;
+    size_t row_stride;
+    int offset[4];      // byte offset of each component, or -1 if unused
+    int size[4];        // size of each component in bytes
+    int *xmap;          // source pixel (in bytes) for each output column
+};
+
+struct transfer {
+    enum pl_color_transfer trc;
+    float min, max;     // nominal luminance range (PL_HDR_NORM)
+    float luma[3];      // RGB->Y coefficients (for HLG)
+};
+
+struct conv {
+    const struct pl_convert_params *params;
+    int src_w, src_h;   // size of the reference source plane
+    int w, h;           // size of the destination image
+
+    struct plane_layout src[PL_MAX_PLANES];
+    struct plane_layout dst[PL_MAX_PLANES];
+    int num_src, num_dst;
+
+    // Decoding
+    float src_scale;
+    bool src_premul;
+    pl_transform3x3 decode;
+
+    // Color mapping. If `full_map` is unset, only `rgb2rgb` is applied
+    bool color_map;
+    struct transfer src_trc, dst_trc;
+    bool full_map;
+    pl_matrix3x3 rgb2rgb;
+    pl_matrix3x3 rgb2lms, lms2rgb;
+
+    struct pl_tone_map_params tone;
+    float *tone_lut;    // or NULL to skip tone mapping
+
+    struct pl_gamut_map_params gamut;
+    bool gamut_map;
+    float *gamut_lut;   // or NULL to sample `gamut` directly
+
+    // Encoding
+    float dst_scale;
+    bool dst_premul;
+    pl_transform3x3 encode;
+};
+
+static bool layout_init(pl_log log, struct plane_layout *layout,
+                        const struct pl_plane_data *data, void *pixels)
+{
+    *layout = (struct plane_layout) {
+        .data       = data,
+        .pixels     = pixels,
+        .row_stride = PL_DEF(data->row_stride, data->width * data->pixel_stride),
+    };
+
+    if (!pixels || data->width <= 0 || data->height <= 0 || !data->pixel_stride) {
+        pl_err(log, "Invalid plane: missing pixel data, stride or dimensions!");
+        return false;
+    }
+
+    int bits = 0;
+    for (int c = 0; c < 4; c++) {
+        layout->offset[c] = -1;
+        if (!data->component_size[c])
+            continue;
+
+        const int size = data->component_size[c];
+        bits += data->component_pad[c];
+        bool ok = bits % 8 == 0;
+        switch (data->type) {
+        case PL_FMT_UNORM: ok &= size == 8 || size == 16; break;
+        case PL_FMT_FLOAT: ok &= size == 32; break;
+        default: ok = false; break;
+        }
+
+        if (!ok) {
+            pl_err(log, "Unsupported plane component (type %d, size %d, offset "
+                   "%d bits): only byte-aligned 8/16-bit UNORM and 32-bit FLOAT "
+                   "components are supported!", (int) data->type, size, bits);
+            return false;
+        }
+
+        if (data->component_map[c] >= 0 && data->component_map[c] < NUM_CH) {
+            layout->offset[c] = bits / 8;
+            layout->size[c] = size / 8;
+        }
+        bits += size;
+    }
+
+    if (bits > data->pixel_stride * 8) {
+        pl_err(log, "Plane components (%d bits) exceed the pixel stride (%zu "
+               "bytes)!", bits, data->pixel_stride);
+        return false;
+    }
+
+    return true;
+}
+
+static inline uint32_t load_word(const uint8_t *ptr, int size, bool swapped)
+{
+    uint8_t bytes[4];
+    for (int i = 0; i < size; i++)
+        bytes[i] = ptr[swapped ? size - 1 - i : i];
+
+    if (size == 1)
+        return bytes[0];
+    if (size == 2) {
+        uint16_t w;
+        memcpy(&w, bytes, sizeof(w));
+        return w;
+    }
+
+    uint32_t w;
+    memcpy(&w, bytes, sizeof(w));
+    return w;
+}
+
+static inline void store_word(uint8_t *ptr, uint32_t w, int size, bool swapped)
+{
+    uint8_t bytes[4];
+    if (size == 1) {
+        bytes[0] = w;
+    } else if (size == 2) {
+        uint16_t w16 = w;
+        memcpy(bytes, &w16, sizeof(w16));
+    } else {
+        memcpy(bytes, &w, sizeof(w));
+    }
+
+    for (int i = 0; i < size; i++)
+        ptr[swapped ? size - 1 - i : i] = bytes[i];
+}
+
+static void read_row(const struct conv *conv, float *ch[NUM_CH], int y)
+{
+    for (int i = 0; i < conv->w; i++) {
+        ch[R][i] = ch[G][i] = ch[B][i] = 0.0f;
+        ch[A][i] = 1.0f;
+    }
+
+    for (int p = 0; p < conv->num_src; p++) {
+        const struct plane_layout *pl = &conv->src[p];
+        const struct pl_plane_data *data = pl->data;
+        int sy = (y + 0.5f) * conv->src_h / conv->h;
+        sy = PL_MIN((int64_t) sy * data->height / conv->src_h, data->height - 1);
+        const uint8_t *row = pl->pixels + sy * pl->row_stride;
+
+        for (int c = 0; c < 4; c++) {
+            if (pl->offset[c] < 0)
+                continue;
+
+            float *out = ch[data->component_map[c]];
+            const int size = pl->size[c];
+            const uint8_t *base = row + pl->offset[c];
+            if (data->type == PL_FMT_FLOAT) {
+                for (int i = 0; i < conv->w; i++) {
+                    uint32_t w = load_word(base + pl->xmap[i], size, data->swapped);
+                    memcpy(&out[i], &w, sizeof(float));
+                }
+            } else {
+                const float scale = 1.0f / ((1LLU << (size * 8)) - 1);
+                for (int i = 0; i < conv->w; i++)
+                    out[i] = load_word(base + pl->xmap[i], size, data->swapped) * scale;
+            }
+        }
+    }
+}
+
+static void write_row(const struct conv *conv, float *ch[NUM_CH], int y)
+{
+    for (int p = 0; p < conv->num_dst; p++) {
+        const struct plane_layout *pl = &conv->dst[p];
+        const struct pl_plane_data *data = pl->data;
+        uint8_t *row = pl->pixels + y * pl->row_stride;
+
+        for (int c = 0; c < 4; c++) {
+            if (pl->offset[c] < 0)
+                continue;
+
+            const float *in = ch[data->component_map[c]];
+            const int size = pl->size[c];
+            uint8_t *base = row + pl->offset[c];
+            if (data->type == PL_FMT_FLOAT) {
+                for (int i = 0; i < conv->w; i++) {
+                    uint32_t w;
+                    memcpy(&w, &in[i], sizeof(float));
+                    store_word(base + i * data->pixel_stride, w, size, data->swapped);
+                }
+            } else {
+                const float scale = (1LLU << (size * 8)) - 1;
+                for (int i = 0; i < conv->w; i++) {
+                    const float v = PL_CLAMP(in[i], 0.0f, 1.0f) * scale + 0.5f;
+                    store_word(base + i * data->pixel_stride, v, size, data->swapped);
+                }
+            }
+        }
+    }
+}
+
+static void apply_matrix(const pl_matrix3x3 *m, const float c[3],
+                         float *ch[NUM_CH], int n)
+{
+    for (int i = 0; i < n; i++) {
+        const float r = ch[R][i], g = ch[G][i], b = ch[B][i];
+        ch[R][i] = m->m[0][0] * r + m->m[0][1] * g + m->m[0][2] * b + c[0];
+        ch[G][i] = m->m[1][0] * r + m->m[1][1] * g + m->m[1][2] * b + c[1];
+        ch[B][i] = m->m[2][0] * r + m->m[2][1] * g + m->m[2][2] * b + c[2];
+    }
+}
+
+static void transfer_init(struct transfer *t, const struct pl_color_space *csp)
+{
+    *t = (struct transfer) { .trc = csp->transfer };
+    pl_color_space_nominal_luma_ex(pl_nominal_luma_params(
+        .color      = csp,
+        .metadata   = PL_HDR_METADATA_HDR10,
+        .scaling    = PL_HDR_NORM,
+        .out_min    = &t->min,
+        .out_max    = &t->max,
+    ));
+
+    const pl_matrix3x3 rgb2xyz =
+        pl_get_rgb2xyz_matrix(pl_raw_primaries_get(csp->primaries));
+    for (int i = 0; i < 3; i++)
+        t->luma[i] = rgb2xyz.m[1][i];
+}
+
+static float trc_gamma(enum pl_color_transfer trc)
+{
+    switch (trc) {
+    case PL_COLOR_TRC_GAMMA18: return 1.8f;
+    case PL_COLOR_TRC_GAMMA20: return 2.0f;
+    case PL_COLOR_TRC_GAMMA24: return 2.4f;
+    case PL_COLOR_TRC_GAMMA26: return 2.6f;
+    case PL_COLOR_TRC_GAMMA28: return 2.8f;
+    default:                   return 2.2f;
+    }
+}
+
+// Whether the transfer function is relative to the display's luminance range
+static bool trc_is_relative(enum pl_color_transfer trc)
+{
+    switch (trc) {
+    case PL_COLOR_TRC_UNKNOWN:
+    case PL_COLOR_TRC_SRGB:
+    case PL_COLOR_TRC_GAMMA18:
+    case PL_COLOR_TRC_GAMMA20:
+    case PL_COLOR_TRC_GAMMA22:
+    case PL_COLOR_TRC_GAMMA24:
+    case PL_COLOR_TRC_GAMMA26:
+    case PL_COLOR_TRC_GAMMA28:
+    case PL_COLOR_TRC_PRO_PHOTO:
+    case PL_COLOR_TRC_ST428:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static inline float pq_eotf(float x)
+{
+    x = powf(PL_CLAMP(x, 0.0f, 1.0f), 1.0f / PQ_M2);
+    x = fmaxf(x - PQ_C1, 0.0f) / (PQ_C2 - PQ_C3 * x);
+    return powf(x, 1.0f / PQ_M1) * (10000.0f / PL_COLOR_SDR_WHITE);
+}
+
+static inline float pq_oetf(float x)
+{
+    x = powf(fmaxf(x * (PL_COLOR_SDR_WHITE / 10000.0f), 0.0f), PQ_M1);
+    x = (PQ_C1 + PQ_C2 * x) / (1.0f + PQ_C3 * x);
+    return powf(x, PQ_M2);
+}
+
+// Equivalent to `pl_shader_linearize`
+static void linearize(const struct transfer *t, float *ch[NUM_CH], int n)
+{
+    if (t->trc == PL_COLOR_TRC_LINEAR)
+        return;
+
+    const float lb = powf(t->min, 1 / 2.4f), lw = powf(t->max, 1 / 2.4f);
+    const float a = powf(lw - lb, 2.4f), b = lb / (lw - lb);
+    const float hlg_y = fmaxf(1.2f + 0.42f * log10f(t->max / HLG_REF), 1);
+    const float hlg_b = sqrtf(3 * powf(t->min / t->max, 1 / hlg_y));
+    const float gamma = trc_gamma(t->trc);
+
+    for (int c = R; c <= B; c++) {
+        float *x = ch[c];
+        for (int i = 0; i < n; i++)
+            x[i] = fmaxf(x[i], 0.0f);
+
+        switch (t->trc) {
+        case PL_COLOR_TRC_SRGB:
+            for (int i = 0; i < n; i++) {
+                x[i] = x[i] > 0.04045f ? powf((x[i] + 0.055f) / 1.055f, 2.4f)
+                                       : x[i] / 12.92f;
+            }
+            break;
+        case PL_COLOR_TRC_BT_1886:
+            for (int i = 0; i < n; i++)
+                x[i] = a * powf(x[i] + b, 2.4f);
+            break;
+        case PL_COLOR_TRC_UNKNOWN:
+        case PL_COLOR_TRC_GAMMA18:
+        case PL_COLOR_TRC_GAMMA20:
+        case PL_COLOR_TRC_GAMMA22:
+        case PL_COLOR_TRC_GAMMA24:
+        case PL_COLOR_TRC_GAMMA26:
+        case PL_COLOR_TRC_GAMMA28:
+            for (int i = 0; i < n; i++)
+                x[i] = powf(x[i], gamma);
+            break;
+        case PL_COLOR_TRC_PRO_PHOTO:
+            for (int i = 0; i < n; i++)
+                x[i] = x[i] > 0.03125f ? powf(x[i], 1.8f) : x[i] / 16.0f;
+            break;
+        case PL_COLOR_TRC_ST428:
+            for (int i = 0; i < n; i++)
+                x[i] = 52.37f / 48.0f * powf(x[i], 2.6f);
+            break;
+        case PL_COLOR_TRC_PQ:
+            for (int i = 0; i < n; i++)
+                x[i] = pq_eotf(x[i]);
+            break;
+        case PL_COLOR_TRC_HLG:
+            for (int i = 0; i < n; i++) {
+                float v = (1 - hlg_b) * x[i] + hlg_b;
+                v = v > 0.5f ? expf((v - HLG_C) / HLG_A) + HLG_B : 4.0f * v * v;
+                x[i] = v / 12.0f;
+            }
+            break;
+        case PL_COLOR_TRC_V_LOG:
+            for (int i = 0; i < n; i++) {
+                x[i] = x[i] >= 0.181f ? powf(10.0f, (x[i] - VLOG_D) / VLOG_C) - VLOG_B
+                                      : (x[i] - 0.125f) / 5.6f;
+            }
+            break;
+        case PL_COLOR_TRC_S_LOG1:
+            for (int i = 0; i < n; i++)
+                x[i] = powf(10.0f, (x[i] - SLOG_C) / SLOG_A) - SLOG_B;
+            break;
+        case PL_COLOR_TRC_S_LOG2:
+            for (int i = 0; i < n; i++) {
+                x[i] = x[i] >= SLOG_Q
+                    ? (powf(10.0f, (x[i] - SLOG_C) / SLOG_A) - SLOG_B) / SLOG_K2
+                    : (x[i] - SLOG_Q) / SLOG_P;
+            }
+            break;
+        case PL_COLOR_TRC_LINEAR:
+        case PL_COLOR_TRC_COUNT:
+            pl_unreachable();
+        }
+
+        if (trc_is_relative(t->trc) && (t->max != 1 || t->min != 0)) {
+            for (int i = 0; i < n; i++)
+                x[i] = (t->max - t->min) * x[i] + t->min;
+        }
+    }
+
+    if (t->trc == PL_COLOR_TRC_HLG) {
+        // OOTF
+        for (int i = 0; i < n; i++) {
+            const float y = t->luma[0] * ch[R][i] + t->luma[1] * ch[G][i] +
+                            t->luma[2] * ch[B][i];
+            const float k = t->max * powf(fmaxf(y, 0.0f), hlg_y - 1);
+            ch[R][i] *= k;
+            ch[G][i] *= k;
+            ch[B][i] *= k;
+        }
+    }
+}
+
+// Equivalent to `pl_shader_delinearize`
+static void delinearize(const struct transfer *t, float *ch[NUM_CH], int n)
+{
+    if (t->trc == PL_COLOR_TRC_LINEAR)
+        return;
+
+    const float lb = powf(t->min, 1 / 2.4f), lw = powf(t->max, 1 / 2.4f);
+    const float a = powf(lw - lb, 2.4f), b = lb / (lw - lb);
+    const float hlg_y = fmaxf(1.2f + 0.42f * log10f(t->max / HLG_REF), 1);
+    const float hlg_b = sqrtf(3 * powf(t->min / t->max, 1 / hlg_y));
+    const float gamma = trc_gamma(t->trc);
+
+    for (int c = R; c <= B; c++) {
+        float *x = ch[c];
+        if (trc_is_relative(t->trc) && (t->max != 1 || t->min != 0)) {
+            for (int i = 0; i < n; i++)
+                x[i] = (x[i] - t->min) / (t->max - t->min);
+        }
+        for (int i = 0; i < n; i++)
+            x[i] = fmaxf(x[i], 0.0f);
+    }
+
+    if (t->trc == PL_COLOR_TRC_HLG) {
+        // OOTF^-1
+        for (int i = 0; i < n; i++) {
+            const float s = 1.0f / t->max;
+            const float y = s * (t->luma[0] * ch[R][i] + t->luma[1] * ch[G][i] +
+                                 t->luma[2] * ch[B][i]);
+            const float k = s * 12.0f * fmaxf(1e-6f, powf(y, (1 - hlg_y) / hlg_y));
+            ch[R][i] *= k;
+            ch[G][i] *= k;
+            ch[B][i] *= k;
+        }
+    }
+
+    for (int c = R; c <= B; c++) {
+        float *x = ch[c];
+        switch (t->trc) {
+        case PL_COLOR_TRC_SRGB:
+            for (int i = 0; i < n; i++) {
+                x[i] = x[i] >= 0.0031308f ? 1.055f * powf(x[i], 1 / 2.4f) - 0.055f
+                                          : x[i] * 12.92f;
+            }
+            break;
+        case PL_COLOR_TRC_BT_1886:
+            for (int i = 0; i < n; i++)
+                x[i] = powf(x[i] / a, 1 / 2.4f) - b;
+            break;
+        case PL_COLOR_TRC_UNKNOWN:
+        case PL_COLOR_TRC_GAMMA18:
+        case PL_COLOR_TRC_GAMMA20:
+        case PL_COLOR_TRC_GAMMA22:
+        case PL_COLOR_TRC_GAMMA24:
+        case PL_COLOR_TRC_GAMMA26:
+        case PL_COLOR_TRC_GAMMA28:
+            for (int i = 0; i < n; i++)
+                x[i] = powf(x[i], 1 / gamma);
+            break;
+        case PL_COLOR_TRC_ST428:
+            for (int i = 0; i < n; i++)
+                x[i] = powf(x[i] * (48.0f / 52.37f), 1 / 2.6f);
+            break;
+        case PL_COLOR_TRC_PRO_PHOTO:
+            for (int i = 0; i < n; i++)
+                x[i] = x[i] >= 0.001953f ? powf(x[i], 1 / 1.8f) : x[i] * 16.0f;
+            break;
+        case PL_COLOR_TRC_PQ:
+            for (int i = 0; i < n; i++)
+                x[i] = pq_oetf(x[i]);
+            break;
+        case PL_COLOR_TRC_HLG:
+            for (int i = 0; i < n; i++) {
+                float v = x[i] > 1.0f ? HLG_A * logf(x[i] - HLG_B) + HLG_C
+                                      : 0.5f * sqrtf(x[i]);
+                x[i] = (v - hlg_b) / (1 - hlg_b);
+            }
+            break;
+        case PL_COLOR_TRC_V_LOG:
+            for (int i = 0; i < n; i++) {
+                x[i] = x[i] >= 0.01f ? VLOG_C * log10f(x[i] + VLOG_B) + VLOG_D
+                                     : 5.6f * x[i] + 0.125f;
+            }
+            break;
+        case PL_COLOR_TRC_S_LOG1:
+            for (int i = 0; i < n; i++)
+                x[i] = SLOG_A * log10f(x[i] + SLOG_B) + SLOG_C;
+            break;
+        case PL_COLOR_TRC_S_LOG2:
+            for (int i = 0; i < n; i++) {
+                x[i] = x[i] >= 0.0f ? SLOG_A * log10f(SLOG_K2 * x[i] + SLOG_B) + SLOG_C
+                                    : SLOG_P * x[i] + SLOG_Q;
+            }
+            break;
+        case PL_COLOR_TRC_LINEAR:
+        case PL_COLOR_TRC_COUNT:
+            pl_unreachable();
+        }
+    }
+}
+
+static inline float tone_map(const struct conv *conv, float x)
+{
+    const struct pl_tone_map_params *tone = &conv->tone;
+    const float range = tone->input_max - tone->input_min;
+    float pos = (x - tone->input_min) / range * (tone->lut_size - 1);
+    pos = PL_CLAMP(pos, 0.0f, tone->lut_size - 1.0f);
+    const int i = PL_MIN((int) pos, tone->lut_size - 2);
+    const float t = pos - i;
+    return PL_MIX(conv->tone_lut[i], conv->tone_lut[i + 1], t);
+}
+
+// Trilinear lookup (in ICh space) into the gamut mapping LUT
+static inline void gamut_map_lut(const struct conv *conv, float ipt[3])
+{
+    const struct pl_gamut_map_params *gamut = &conv->gamut;
+    const int size[3] = { gamut->lut_size_I, gamut->lut_size_C, gamut->lut_size_h };
+    const float idx[3] = {
+        (ipt[0] - gamut->min_luma) / (gamut->max_luma - gamut->min_luma),
+        2.0f * sqrtf(ipt[1] * ipt[1] + ipt[2] * ipt[2]),
+        atan2f(ipt[2], ipt[1]) / (2 * M_PI) + 0.5f,
+    };
+
+    int i0[3];
+    float t[3];
+    for (int c = 0; c < 3; c++) {
+        const float pos = PL_CLAMP(idx[c], 0.0f, 1.0f) * (size[c] - 1);
+        i0[c] = PL_MIN((int) pos, PL_MAX(size[c] - 2, 0));
+        t[c] = pos - i0[c];
+    }
+
+    const int stride[3] = { 3, 3 * size[0], 3 * size[0] * size[1] };
+    const float *base = conv->gamut_lut + i0[0] * stride[0] + i0[1] * stride[1] +
+                        i0[2] * stride[2];
+
+    float out[3] = {0};
+    for (int corner = 0; corner < 8; corner++) {
+        float w = 1.0f;
+        const float *p = base;
+        for (int c = 0; c < 3; c++) {
+            const bool hi = corner & (1 << c);
+            w *= hi ? t[c] : 1.0f - t[c];
+            if (hi && size[c] > 1)
+                p += stride[c];
+        }
+        for (int c = 0; c < 3; c++)
+            out[c] += w * p[c];
+    }
+
+    memcpy(ipt, out, sizeof(out));
+}
+
+// Equivalent to the full path of `pl_shader_color_map_ex`
+static void color_map_full(const struct conv *conv, float *ch[NUM_CH], int n)
+{
+    static const float zero[3] = {0};
+    apply_matrix(&conv->rgb2lms, zero, ch, n);
+    for (int c = R; c <= B; c++) {
+        for (int i = 0; i < n; i++)
+            ch[c][i] = pq_oetf(ch[c][i]);
+    }
+    apply_matrix(&pl_ipt_lms2ipt, zero, ch, n);
+
+    for (int i = 0; i < n; i++) {
+        float ipt[3] = { ch[R][i], ch[G][i], ch[B][i] };
+        if (conv->tone_lut) {
+            // Avoid raising saturation excessively when raising brightness,
+            // and desaturate when reducing brightness greatly
+            const float i_orig = ipt[0];
+            ipt[0] = tone_map(conv, ipt[0]);
+            const float hull_x = ((i_orig - 6.0f) * i_orig + 9.0f) * i_orig;
+            const float hull_y = ((ipt[0] - 6.0f) * ipt[0] + 9.0f) * ipt[0];
+            float k = fminf(i_orig / ipt[0], hull_y / hull_x);
+            if (!isfinite(k))
+                k = 0.0f;
+            ipt[1] *= k;
+            ipt[2] *= k;
+        }
+
+        if (conv->gamut_lut) {
+            gamut_map_lut(conv, ipt);
+        } else if (conv->gamut_map) {
+            pl_gamut_map_sample(ipt, &conv->gamut);
+        }
+
+        ch[R][i] = ipt[0];
+        ch[G][i] = ipt[1];
+        ch[B][i] = ipt[2];
+    }
+
+    apply_matrix(&pl_ipt_ipt2lms, zero, ch, n);
+    for (int c = R; c <= B; c++) {
+        for (int i = 0; i < n; i++)
+            ch[c][i] = pq_eotf(fmaxf(ch[c][i], 0.0f));
+    }
+    apply_matrix(&conv->lms2rgb, zero, ch, n);
+}
+
+static void convert_rows(void *priv, int index)
+{
+    const struct conv *conv = priv;
+    const int n = conv->w;
+    float *buf = pl_alloc(NULL, NUM_CH * n * sizeof(float));
+    float *ch[NUM_CH];
+    for (int c = 0; c < NUM_CH; c++)
+        ch[c] = buf + c * n;
+
+    static const float zero[3] = {0};
+    const int y0 = index * ROWS_PER_JOB, y1 = PL_MIN(y0 + ROWS_PER_JOB, conv->h);
+    for (int y = y0; y < y1; y++) {
+        read_row(conv, ch, y);
+
+        for (int c = 0; c < NUM_CH; c++) {
+            for (int i = 0; i < n; i++)
+                ch[c][i] *= conv->src_scale;
+        }
+
+        if (conv->src_premul) {
+            for (int i = 0; i < n; i++) {
+                const float a = ch[A][i] > 0.0f ? 1.0f / ch[A][i] : 0.0f;
+                ch[R][i] *= a;
+                ch[G][i] *= a;
+                ch[B][i] *= a;
+            }
+        }
+
+        apply_matrix(&conv->decode.mat, conv->decode.c, ch, n);
+
+        if (conv->color_map) {
+            linearize(&conv->src_trc, ch, n);
+            if (conv->full_map) {
+                color_map_full(conv, ch, n);
+            } else {
+                apply_matrix(&conv->rgb2rgb, zero, ch, n);
+            }
+            delinearize(&conv->dst_trc, ch, n);
+        }
+
+        if (conv->dst_premul) {
+            for (int i = 0; i < n; i++) {
+                ch[R][i] *= ch[A][i];
+                ch[G][i] *= ch[A][i];
+                ch[B][i] *= ch[A][i];
+            }
+        }
+
+        apply_matrix(&conv->encode.mat, conv->encode.c, ch, n);
+
+        for (int c = 0; c < NUM_CH; c++) {
+            for (int i = 0; i < n; i++)
+                ch[c][i] *= conv->dst_scale;
+        }
+
+        write_row(conv, ch, y);
+    }
+
+    pl_free(buf);
+}
+
+static inline int default_depth(const struct pl_plane_data *data)
+{
+    return data->type == PL_FMT_UNORM ? data->component_size[0] : 0;
+}
+
+// Mirrors the color mapping setup in `pl_shader_color_map_ex`
+static void color_map_init(void *alloc, struct conv *conv)
+{
+    const struct pl_convert_params *params = conv->params;
+    const struct pl_color_map_params *map;
+    map = PL_DEF(params->color_map_params, &pl_color_map_default_params);
+
+    struct pl_color_space src = params->src_color, dst = params->dst_color;
+    pl_color_space_infer_map(&src, &dst);
+    if (pl_color_space_equal(&src, &dst))
+        return;
+
+    conv->color_map = true;
+    transfer_init(&conv->src_trc, &src);
+    transfer_init(&conv->dst_trc, &dst);
+
+    struct pl_tone_map_params tone = {
+        .function       = PL_DEF(map->tone_mapping_function, &pl_tone_map_clip),
+        .constants      = map->tone_constants,
+        .param          = map->tone_mapping_param,
+        .input_scaling  = PL_HDR_PQ,
+        .output_scaling = PL_HDR_PQ,
+        .lut_size       = PL_DEF(map->lut_size, pl_color_map_default_params.lut_size),
+        .hdr            = src.hdr,
+    };
+
+    pl_color_space_nominal_luma_ex(pl_nominal_luma_params(
+        .color      = &src,
+        .metadata   = map->metadata,
+        .scaling    = tone.input_scaling,
+        .out_min    = &tone.input_min,
+        .out_max    = &tone.input_max,
+        .out_avg    = &tone.input_avg,
+    ));
+
+    pl_color_space_nominal_luma_ex(pl_nominal_luma_params(
+        .color      = &dst,
+        .metadata   = PL_HDR_METADATA_HDR10,
+        .scaling    = tone.output_scaling,
+        .out_min    = &tone.output_min,
+        .out_max    = &tone.output_max,
+    ));
+
+    pl_tone_map_params_infer(&tone);
+    if (fabs(tone.input_max - tone.output_max) < 1e-6)
+        tone.output_max = tone.input_max;
+    if (fabs(tone.input_min - tone.output_min) < 1e-6)
+        tone.output_min = tone.input_min;
+    if (!map->inverse_tone_mapping)
+        tone.output_max = PL_MIN(tone.output_max, tone.input_max);
+
+    const int *lut3d_size_def = pl_color_map_default_params.lut3d_size;
+    struct pl_gamut_map_params gamut = {
+        .function        = PL_DEF(map->gamut_mapping, &pl_gamut_map_clip),
+        .constants       = map->gamut_constants,
+        .input_gamut     = src.hdr.prim,
+        .output_gamut    = dst.hdr.prim,
+        .lut_size_I      = PL_DEF(map->lut3d_size[0], lut3d_size_def[0]),
+        .lut_size_C      = PL_DEF(map->lut3d_size[1], lut3d_size_def[1]),
+        .lut_size_h      = PL_DEF(map->lut3d_size[2], lut3d_size_def[2]),
+        .lut_stride      = 3,
+    };
+
+    pl_color_space_nominal_luma_ex(pl_nominal_luma_params(
+        .color      = &dst,
+        .metadata   = PL_HDR_METADATA_HDR10,
+        .scaling    = PL_HDR_PQ,
+        .out_min    = &gamut.min_luma,
+        .out_max    = &gamut.max_luma,
+    ));
+
+    if (!map->gamut_expansion && gamut.function->bidirectional) {
+        if (pl_primaries_compatible(&gamut.input_gamut, &gamut.output_gamut)) {
+            gamut.output_gamut = pl_primaries_clip(&gamut.output_gamut,
+                                                   &gamut.input_gamut);
+        }
+    }
+
+    const bool need_tone_map = !pl_tone_map_params_noop(&tone);
+    bool need_gamut_map = !pl_gamut_map_params_noop(&gamut);
+
+    conv->rgb2lms = pl_ipt_rgb2lms(pl_raw_primaries_get(src.primaries));
+    conv->lms2rgb = pl_ipt_lms2rgb(pl_raw_primaries_get(dst.primaries));
+    if (need_gamut_map && gamut.function == &pl_gamut_map_saturation) {
+        const pl_matrix3x3 lms2src = pl_ipt_lms2rgb(&gamut.input_gamut);
+        const pl_matrix3x3 dst2lms = pl_ipt_rgb2lms(&gamut.output_gamut);
+        pl_matrix3x3_mul(&conv->lms2rgb, &dst2lms);
+        pl_matrix3x3_mul(&conv->lms2rgb, &lms2src);
+        need_gamut_map = false;
+    }
+
+    if (!need_tone_map && !need_gamut_map) {
+        conv->rgb2rgb = conv->lms2rgb;
+        pl_matrix3x3_mul(&conv->rgb2rgb, &conv->rgb2lms);
+        return;
+    }
+
+    conv->full_map = true;
+    if (need_tone_map) {
+        conv->tone = tone;
+        conv->tone_lut = pl_alloc(alloc, tone.lut_size * sizeof(float));
+        pl_tone_map_generate(conv->tone_lut, &tone);
+    }
+
+    if (need_gamut_map) {
+        conv->gamut = gamut;
+        conv->gamut_map = true;
+
+        // Generating the LUT only pays off if it's smaller than the image
+        const size_t lut_size = (size_t) gamut.lut_size_I * gamut.lut_size_C *
+                                gamut.lut_size_h;
+        if (lut_size < (size_t) conv->w * conv->h) {
+            conv->gamut_lut = pl_alloc(alloc, lut_size * 3 * sizeof(float));
+            pl_gamut_map_generate(conv->gamut_lut, &gamut);
+        }
+    }
+}
+
+bool pl_convert_planes(pl_log log, const struct pl_convert_params *params)
+{
+    if (params->num_src_planes <= 0 || params->num_src_planes > PL_MAX_PLANES ||
+        params->num_dst_planes <= 0 || params->num_dst_planes > PL_MAX_PLANES)
+    {
+        pl_err(log, "Invalid number of planes: %d source, %d destination "
+               "(must be between 1 and %d)!", params->num_src_planes,
+               params->num_dst_planes, PL_MAX_PLANES);
+        return false;
+    }
+
+    if (!pl_color_system_is_linear(params->src_repr.sys) ||
+        !pl_color_system_is_linear(params->dst_repr.sys))
+    {
+        pl_err(log, "Unsupported color system for CPU conversion: %d -> %d",
+               (int) params->src_repr.sys, (int) params->dst_repr.sys);
+        return false;
+    }
+
+    void *tmp = pl_tmp(NULL);
+    bool ok = false;
+
+    struct conv *conv = pl_zalloc_ptr(tmp, conv);
+    conv->params = params;
+    conv->num_src = params->num_src_planes;
+    conv->num_dst = params->num_dst_planes;
+    conv->w = params->dst_planes[0].width;
+    conv->h = params->dst_planes[0].height;
+
+    for (int i = 0; i < conv->num_src; i++) {
+        const struct pl_plane_data *data = &params->src_planes[i];
+        if (!layout_init(log, &conv->src[i], data, (void *) data->pixels))
+            goto done;
+        if (data->width * data->height > conv->src_w * conv->src_h) {
+            conv->src_w = data->width;
+            conv->src_h = data->height;
+        }
+    }
+
+    for (int i = 0; i < conv->num_dst; i++) {
+        const struct pl_plane_data *data = &params->dst_planes[i];
+        if (!layout_init(log, &conv->dst[i], data, params->dst_data[i]))
+            goto done;
+        if (data->width != conv->w || data->height != conv->h) {
+            pl_err(log, "All destination planes must have the same size!");
+            goto done;
+        }
+    }
+
+    // Precompute the source pixel offset of every output column
+    for (int p = 0; p < conv->num_src; p++) {
+        struct plane_layout *pl = &conv->src[p];
+        const struct pl_plane_data *data = pl->data;
+        pl->xmap = pl_alloc(tmp, conv->w * sizeof(int));
+        for (int x = 0; x < conv->w; x++) {
+            int sx = (x + 0.5f) * conv->src_w / conv->w;
+            sx = PL_MIN((int64_t) sx * data->width / conv->src_w, data->width - 1);
+            pl->xmap[x] = sx * data->pixel_stride;
+        }
+    }
+
+    struct pl_color_repr src_repr = params->src_repr;
+    if (!src_repr.bits.sample_depth && !src_repr.bits.color_depth)
+        src_repr.bits.sample_depth = default_depth(&params->src_planes[0]);
+    conv->src_premul = src_repr.alpha == PL_ALPHA_PREMULTIPLIED;
+    conv->src_scale = pl_color_repr_normalize(&src_repr);
+    conv->decode = pl_color_repr_decode(&src_repr, params->adjustment);
+
+    struct pl_color_repr dst_repr = params->dst_repr;
+    if (!dst_repr.bits.sample_depth && !dst_repr.bits.color_depth)
+        dst_repr.bits.sample_depth = default_depth(&params->dst_planes[0]);
+    conv->dst_premul = dst_repr.alpha == PL_ALPHA_PREMULTIPLIED;
+    conv->dst_scale = 1.0f / pl_color_repr_normalize(&dst_repr);
+    conv->encode = pl_color_repr_decode(&dst_repr, NULL);
+    pl_transform3x3_invert(&conv->encode);
+
+    color_map_init(tmp, conv);
+
+    pl_parallel_for(PL_DIV_UP(conv->h, ROWS_PER_JOB), convert_rows, conv);
+    ok = true;
+
+done:
+    pl_free(tmp);
+    return ok;
+}
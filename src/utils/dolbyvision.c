@@ -16,6 +16,7 @@
  */
 
 #include "common.h"
+#include "hash.h"
 #include <libplacebo/utils/dolbyvision.h>
 
 #ifdef PL_HAVE_LIBDOVI
@@ -23,8 +24,9 @@
 #include <libdovi/rpu_parser.h>
 #endif
 
-void pl_hdr_metadata_from_dovi_rpu(struct pl_hdr_metadata *out,
-                                   const uint8_t *buf, size_t size)
+// Parses the L1 brightness metadata from an RPU. Leaves `out` untouched if
+// the RPU does not contain any.
+static void parse_rpu(struct pl_hdr_metadata *out, const uint8_t *buf, size_t size)
 {
 #ifdef PL_HAVE_LIBDOVI
     if (buf && size) {
@@ -61,3 +63,85 @@ void pl_hdr_metadata_from_dovi_rpu(struct pl_hdr_metadata *out,
     }
 #endif
 }
+
+void pl_hdr_metadata_from_dovi_rpu(struct pl_hdr_metadata *out,
+                                   const uint8_t *buf, size_t size)
+{
+    parse_rpu(out, buf, size);
+}
+
+struct pl_dovi_state_t {
+    // Most recently parsed RPU
+    bool has_rpu;
+    uint64_t rpu_hash;
+    bool rpu_l1;
+    float max_pq_y, avg_pq_y;
+
+    // Most recently stored reshaping metadata
+    bool has_meta;
+    uint64_t meta_hash;
+    struct pl_dovi_metadata dovi;
+};
+
+pl_dovi_state pl_dovi_state_create(void)
+{
+    pl_dovi_state state = pl_zalloc_ptr(NULL, state);
+    return state;
+}
+
+void pl_dovi_state_destroy(pl_dovi_state *state)
+{
+    pl_free_ptr(state);
+}
+
+bool pl_dovi_state_parse_rpu(pl_dovi_state state, struct pl_hdr_metadata *out,
+                             const uint8_t *buf, size_t size)
+{
+    const uint64_t hash = pl_mem_hash(buf, size);
+    const bool changed = !state->has_rpu || state->rpu_hash != hash;
+    if (changed) {
+        // Parse into a sentinel-initialized struct to detect missing L1 data
+        struct pl_hdr_metadata hdr = { .max_pq_y = -1.0f };
+        parse_rpu(&hdr, buf, size);
+        state->has_rpu = true;
+        state->rpu_hash = hash;
+        state->rpu_l1 = hdr.max_pq_y >= 0.0f;
+        state->max_pq_y = hdr.max_pq_y;
+        state->avg_pq_y = hdr.avg_pq_y;
+    }
+
+    if (state->rpu_l1) {
+        out->max_pq_y = state->max_pq_y;
+        out->avg_pq_y = state->avg_pq_y;
+    }
+
+    return changed;
+}
+
+bool pl_dovi_state_lookup(pl_dovi_state state, struct pl_dovi_metadata *out,
+                          const void *src, size_t size)
+{
+    if (!state->has_meta || state->meta_hash != pl_mem_hash(src, size))
+        return false;
+
+    *out = state->dovi;
+    return true;
+}
+
+void pl_dovi_state_store(pl_dovi_state state, const struct pl_dovi_metadata *dovi,
+                         const void *src, size_t size)
+{
+    state->has_meta = true;
+    state->meta_hash = pl_mem_hash(src, size);
+    state->dovi = *dovi;
+}
+
+uint64_t pl_dovi_state_signature(pl_dovi_state state)
+{
+    uint64_t sig = 0;
+    if (state->has_rpu)
+        pl_hash_merge(&sig, state->rpu_hash);
+    if (state->has_meta)
+        pl_hash_merge(&sig, state->meta_hash);
+    return sig;
+}
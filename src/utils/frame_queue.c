@@ -19,13 +19,18 @@
 #include <math.h>
 
 #include "common.h"
+#include "hash.h"
 #include "log.h"
+#include "pl_clock.h"
 #include "pl_thread.h"
 
 #include <libplacebo/utils/frame_queue.h>
 
 struct cache_entry {
     pl_tex tex[4];
+    uint64_t key; // hash of texture formats and sizes, see `cache_key`
+    size_t size;  // total size of all textures, in bytes
+    uint64_t age; // value of `pl_queue_t.updates` when last recycled
 };
 
 struct entry {
@@ -36,6 +41,7 @@ struct entry {
     struct pl_frame frame;
     uint64_t signature;
     bool mapped;
+    bool mapping; // currently being mapped by `pl_queue_map_ahead`
     bool ok;
 
     // for interlaced frames
@@ -59,6 +65,37 @@ struct entry {
 
 // Maximum number of not-yet-mapped frames to allow queueing in advance
 #define PREFETCH_FRAMES 2
+#define MAX_PREFETCH_FRAMES 16
+
+// Number of consecutive updates without missed deadlines, and the maximum
+// ratio of map latency to vsync duration, before shrinking adaptive prefetch
+#define PREFETCH_SHRINK_UPDATES 120
+#define PREFETCH_SHRINK_RATIO 0.25
+
+// Number of updates after which cached textures not matching the most
+// recently mapped frame are considered stale and freed
+#define CACHE_MAX_AGE 30
+
+// Number of frames that can be pushed without taking the queue lock, before
+// they are picked up by the consumer side
+#define PUSH_RING_SIZE 64
+
+// Bounded lock-free ring of frames pushed by `pl_queue_push`, drained into the
+// actual queue by whoever next takes `lock_weak`. Multiple producers reserve
+// slots with a CAS on `head`, each slot's `seq` signals when it is filled
+// (`seq == pos + 1`) or free again (`seq == pos + PUSH_RING_SIZE`).
+struct push_slot {
+    atomic_size_t seq;
+    struct pl_source_frame src;
+    bool eof;
+};
+
+struct push_ring {
+    struct push_slot slots[PUSH_RING_SIZE];
+    atomic_size_t head;
+    size_t tail; // only accessed with `lock_weak` held
+    atomic_bool waiting; // consumer is waiting for new frames
+};
 
 struct pool {
     float samples[MAX_SAMPLES];
@@ -92,19 +129,34 @@ struct pl_queue_t {
     bool want_frame;
     bool eof;
 
+    // Prefetch depth and mapping statistics
+    struct pl_queue_stats stats;
+    int prefetch;
+    int good_updates;
+    bool missed;
+
     // Average vsync/frame fps estimation state
     struct pool vps, fps;
     float reported_vps;
     float reported_fps;
     double prev_pts;
+    uint64_t frames_presented;
 
     // Storage for temporary arrays
     PL_ARRAY(uint64_t) tmp_sig;
     PL_ARRAY(float) tmp_ts;
     PL_ARRAY(const struct pl_frame *) tmp_frame;
+    PL_ARRAY(uint64_t) tmp_retain;
 
-    // Queue of GPU objects to reuse
+    // Pool of GPU objects to reuse, ordered from least to most recently used
     PL_ARRAY(struct cache_entry) cache;
+    size_t cache_size;  // total size of all cached textures
+    size_t cache_limit; // from `pl_queue_params.max_cache_size`
+    uint64_t cache_key; // texture configuration of the last mapped frame
+    uint64_t updates;   // number of calls to `pl_queue_update`
+
+    // Frames pushed without holding the lock
+    struct push_ring *ring;
 };
 
 pl_queue pl_queue_create(pl_gpu gpu)
@@ -113,8 +165,16 @@ pl_queue pl_queue_create(pl_gpu gpu)
     *p = (struct pl_queue_t) {
         .gpu = gpu,
         .log = gpu->log,
+        .ring = pl_alloc_ptr(p, p->ring),
     };
 
+    struct push_ring *ring = p->ring;
+    for (size_t i = 0; i < PUSH_RING_SIZE; i++)
+        atomic_init(&ring->slots[i].seq, i);
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->waiting, false);
+    ring->tail = 0;
+
     pl_mutex_init(&p->lock_strong);
     pl_mutex_init(&p->lock_weak);
     int ret = pl_cond_init(&p->wakeup);
@@ -125,6 +185,94 @@ pl_queue pl_queue_create(pl_gpu gpu)
     return p;
 }
 
+static uint64_t cache_key(const struct cache_entry *cache)
+{
+    uint64_t key = 0;
+    for (int i = 0; i < PL_ARRAY_SIZE(cache->tex); i++) {
+        pl_tex tex = cache->tex[i];
+        if (!tex) {
+            pl_hash_merge(&key, 0);
+            continue;
+        }
+
+        pl_hash_merge(&key, (uintptr_t) tex->params.format);
+        pl_hash_merge(&key, pl_var_hash(tex->params.w));
+        pl_hash_merge(&key, pl_var_hash(tex->params.h));
+        pl_hash_merge(&key, pl_var_hash(tex->params.d));
+    }
+
+    return key;
+}
+
+static size_t cache_entry_size(const struct cache_entry *cache)
+{
+    size_t size = 0;
+    for (int i = 0; i < PL_ARRAY_SIZE(cache->tex); i++) {
+        pl_tex tex = cache->tex[i];
+        if (!tex)
+            continue;
+        size += (size_t) tex->params.w * PL_MAX(tex->params.h, 1) *
+                PL_MAX(tex->params.d, 1) * tex->params.format->texel_size;
+    }
+
+    return size;
+}
+
+static void cache_evict(pl_queue p, int idx)
+{
+    struct cache_entry *cache = &p->cache.elem[idx];
+    PL_TRACE(p, "Freeing cached textures (%zu bytes) for key 0x%"PRIx64,
+             cache->size, cache->key);
+    for (int i = 0; i < PL_ARRAY_SIZE(cache->tex); i++)
+        pl_tex_destroy(p->gpu, &cache->tex[i]);
+    p->cache_size -= cache->size;
+    PL_ARRAY_REMOVE_AT(p->cache, idx);
+}
+
+static void cache_trim(pl_queue p)
+{
+    // Free textures that no longer match what is being mapped
+    for (int i = p->cache.num - 1; i >= 0; i--) {
+        const struct cache_entry *cache = &p->cache.elem[i];
+        if (cache->key != p->cache_key && p->updates - cache->age > CACHE_MAX_AGE)
+            cache_evict(p, i);
+    }
+
+    // Enforce the size limit, preferring to evict non-matching entries, and
+    // otherwise the least recently used one
+    while (p->cache_limit && p->cache_size > p->cache_limit) {
+        int idx = 0;
+        for (int i = 0; i < p->cache.num; i++) {
+            if (p->cache.elem[i].key != p->cache_key) {
+                idx = i;
+                break;
+            }
+        }
+        cache_evict(p, idx);
+    }
+}
+
+// Grab a set of textures to map a frame into. Since the frame's textures are
+// only known after mapping, assume it looks like the previously mapped frame.
+static void cache_get(pl_queue p, struct cache_entry *out)
+{
+    if (!p->cache.num)
+        return;
+
+    // Fall back to the oldest entry, so stale textures get recreated first
+    int idx = 0;
+    for (int i = p->cache.num - 1; i >= 0; i--) {
+        if (p->cache.elem[i].key == p->cache_key) {
+            idx = i;
+            break;
+        }
+    }
+
+    *out = p->cache.elem[idx];
+    p->cache_size -= out->size;
+    PL_ARRAY_REMOVE_AT(p->cache, idx);
+}
+
 static void recycle_cache(pl_queue p, struct cache_entry *cache, bool recycle)
 {
     bool has_textures = false;
@@ -140,8 +288,14 @@ static void recycle_cache(pl_queue p, struct cache_entry *cache, bool recycle)
         }
     }
 
-    if (recycle && has_textures)
+    if (recycle && has_textures) {
+        cache->key = cache_key(cache);
+        cache->size = cache_entry_size(cache);
+        cache->age = p->updates;
+        p->cache_size += cache->size;
         PL_ARRAY_APPEND(p, p->cache, *cache);
+        cache_trim(p);
+    }
 
     memset(cache, 0, sizeof(*cache)); // sanity
 }
@@ -185,12 +339,15 @@ static void entry_cull(pl_queue p, struct entry *entry, bool recycle)
     entry_deref(p, &entry, recycle);
 }
 
+static void drain_pushes(pl_queue p);
+
 void pl_queue_destroy(pl_queue *queue)
 {
     pl_queue p = *queue;
     if (!p)
         return;
 
+    drain_pushes(p);
     for (int n = 0; n < p->queue.num; n++)
         entry_cull(p, p->queue.elem[n], false);
     for (int n = 0; n < p->cache.num; n++) {
@@ -210,6 +367,7 @@ void pl_queue_reset(pl_queue p)
     pl_mutex_lock(&p->lock_strong);
     pl_mutex_lock(&p->lock_weak);
 
+    drain_pushes(p);
     for (int i = 0; i < p->queue.num; i++)
         entry_cull(p, p->queue.elem[i], false);
 
@@ -221,15 +379,21 @@ void pl_queue_reset(pl_queue p)
         .lock_strong = p->lock_strong,
         .lock_weak = p->lock_weak,
         .wakeup = p->wakeup,
+        .ring = p->ring,
 
         // Explicitly preserve allocations
         .queue.elem = p->queue.elem,
         .tmp_sig.elem = p->tmp_sig.elem,
         .tmp_ts.elem = p->tmp_ts.elem,
         .tmp_frame.elem = p->tmp_frame.elem,
+        .tmp_retain.elem = p->tmp_retain.elem,
 
         // Reuse GPU object cache entirely
         .cache = p->cache,
+        .cache_size = p->cache_size,
+        .cache_limit = p->cache_limit,
+        .cache_key = p->cache_key,
+        .updates = p->updates,
     };
 
     pl_cond_signal(&p->wakeup);
@@ -315,7 +479,6 @@ static void queue_push(pl_queue p, const struct pl_source_frame *src)
         .src = *src,
     };
     pl_rc_init(&entry->rc);
-    PL_ARRAY_POP(p->cache, &entry->cache);
     PL_TRACE(p, "Added new frame id %"PRIu64" with PTS %f",
              entry->signature, entry->pts);
 
@@ -401,9 +564,69 @@ static void queue_push(pl_queue p, const struct pl_source_frame *src)
     p->want_frame = false;
 }
 
+static bool ring_push(struct push_ring *ring, const struct pl_source_frame *src)
+{
+    struct push_slot *slot;
+    size_t pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    for (;;) {
+        slot = &ring->slots[pos % PUSH_RING_SIZE];
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t) (seq - pos);
+        if (diff < 0)
+            return false; // ring is full
+        if (diff > 0) {
+            pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        } else if (atomic_compare_exchange_weak_explicit(&ring->head, &pos, pos + 1,
+                                                         memory_order_relaxed,
+                                                         memory_order_relaxed))
+        {
+            break;
+        }
+    }
+
+    slot->eof = !src;
+    if (src)
+        slot->src = *src;
+    atomic_store(&slot->seq, pos + 1); // publish
+    return true;
+}
+
+// Move all pending frames from the push ring into the queue. Must be called
+// with `lock_weak` held, before examining the queue contents.
+static void drain_pushes(pl_queue p)
+{
+    struct push_ring *ring = p->ring;
+    for (;;) {
+        struct push_slot *slot = &ring->slots[ring->tail % PUSH_RING_SIZE];
+        if (atomic_load(&slot->seq) != ring->tail + 1)
+            break; // ring is empty
+
+        struct pl_source_frame src = slot->src;
+        bool eof = slot->eof;
+        atomic_store_explicit(&slot->seq, ring->tail + PUSH_RING_SIZE,
+                              memory_order_release);
+        ring->tail++;
+        queue_push(p, eof ? NULL : &src);
+    }
+}
+
 void pl_queue_push(pl_queue p, const struct pl_source_frame *frame)
 {
+    // Fast path, which does not contend with `pl_queue_update`
+    if (ring_push(p->ring, frame)) {
+        if (!atomic_load(&p->ring->waiting))
+            return;
+
+        // Somebody is blocked waiting for a new frame, wake them up
+        pl_mutex_lock(&p->lock_weak);
+        drain_pushes(p);
+        pl_mutex_unlock(&p->lock_weak);
+        return;
+    }
+
+    // Ring is full, push directly (after any frames already in the ring)
     pl_mutex_lock(&p->lock_weak);
+    drain_pushes(p);
     queue_push(p, frame);
     pl_mutex_unlock(&p->lock_weak);
 }
@@ -418,7 +641,7 @@ static bool queue_has_room(pl_queue p)
     if (p->want_frame)
         return true;
 
-    int wanted_frames = PREFETCH_FRAMES;
+    int wanted_frames = PL_DEF(p->prefetch, PREFETCH_FRAMES);
     if (p->fps.estimate && p->vps.estimate && p->vps.estimate <= 1.0f / MIN_FPS)
         wanted_frames += ceilf(p->vps.estimate / p->fps.estimate) - 1;
 
@@ -437,6 +660,7 @@ bool pl_queue_push_block(pl_queue p, uint64_t timeout,
                          const struct pl_source_frame *frame)
 {
     pl_mutex_lock(&p->lock_weak);
+    drain_pushes(p);
     if (!timeout || !frame || p->eof)
         goto skip_blocking;
 
@@ -488,11 +712,18 @@ static enum pl_queue_status get_frame(pl_queue p, const struct pl_queue_params *
         p->want_frame = true;
         pl_cond_signal(&p->wakeup);
 
+        // Make `pl_queue_push` take the lock, so it can wake us up
+        atomic_store(&p->ring->waiting, true);
+        drain_pushes(p);
         while (p->want_frame) {
-            if (pl_cond_timedwait(&p->wakeup, &p->lock_weak, params->timeout) == ETIMEDOUT)
+            if (pl_cond_timedwait(&p->wakeup, &p->lock_weak, params->timeout) == ETIMEDOUT) {
+                atomic_store(&p->ring->waiting, false);
                 return PL_QUEUE_MORE;
+            }
+            drain_pushes(p);
         }
 
+        atomic_store(&p->ring->waiting, false);
         return p->eof ? PL_QUEUE_EOF : PL_QUEUE_OK;
     }
 
@@ -515,20 +746,54 @@ static enum pl_queue_status get_frame(pl_queue p, const struct pl_queue_params *
     }
 
     pl_mutex_lock(&p->lock_weak);
+    drain_pushes(p);
     return ret;
 }
 
+static void record_latency(pl_queue p, double latency)
+{
+    struct pl_queue_stats *stats = &p->stats;
+    stats->map_latency = stats->mapped_frames++
+                       ? PL_MIX(stats->map_latency, latency, 0.1)
+                       : latency;
+    stats->map_latency_max = PL_MAX(stats->map_latency_max, latency);
+}
+
 static inline bool map_frame(pl_queue p, struct entry *entry)
 {
+    if (entry->mapped && !entry->mapping)
+        return entry->ok;
+
+    // This frame is needed right now, but was not mapped in advance
+    pl_clock_t start = pl_clock_now();
+
+    // Wait for any concurrent `pl_queue_map_ahead` to finish with this frame
+    while (entry->mapping)
+        pl_cond_wait(&p->wakeup, &p->lock_weak);
+
     if (!entry->mapped) {
         PL_TRACE(p, "Mapping frame id %"PRIu64" with PTS %f",
                  entry->signature, entry->pts);
         entry->mapped = true;
+        cache_get(p, &entry->cache);
         entry->ok = entry->src.map(p->gpu, entry->cache.tex,
                                    &entry->src, &entry->frame);
-        if (!entry->ok)
+        if (entry->ok) {
+            p->cache_key = cache_key(&entry->cache);
+        } else {
             PL_ERR(p, "Failed mapping frame id %"PRIu64" with PTS %f",
                    entry->signature, entry->pts);
+        }
+        record_latency(p, pl_clock_diff(pl_clock_now(), start));
+    }
+
+    // Frames mapped while prefilling the queue are expected to be late
+    double delay = pl_clock_diff(pl_clock_now(), start);
+    if (p->prev_pts > 0 && p->vps.estimate && delay > p->vps.estimate) {
+        PL_TRACE(p, "Missed mapping deadline for frame id %"PRIu64" by %.3f ms",
+                 entry->signature, 1e3 * (delay - p->vps.estimate));
+        p->stats.missed_frames++;
+        p->missed = true;
     }
 
     return entry->ok;
@@ -895,12 +1160,45 @@ done: ;
     return ret;
 }
 
+static void update_prefetch(pl_queue p, const struct pl_queue_params *params)
+{
+    const int base = PL_DEF(params->prefetch_frames, PREFETCH_FRAMES);
+    bool missed = p->missed;
+    p->missed = false;
+
+    if (!params->adaptive_prefetch || !p->prefetch) {
+        p->prefetch = base;
+        p->good_updates = 0;
+        goto done;
+    }
+
+    if (missed) {
+        p->good_updates = 0;
+        if (p->prefetch < MAX_PREFETCH_FRAMES) {
+            p->prefetch++;
+            PL_DEBUG(p, "Missed mapping deadline, increasing prefetch depth "
+                     "to %d frames", p->prefetch);
+        }
+    } else if (++p->good_updates >= PREFETCH_SHRINK_UPDATES) {
+        p->good_updates = 0;
+        bool fast = p->stats.map_latency < PREFETCH_SHRINK_RATIO * p->vps.estimate;
+        if (fast && p->prefetch > 1) {
+            p->prefetch--;
+            PL_DEBUG(p, "Mapping is fast, decreasing prefetch depth to %d "
+                     "frames", p->prefetch);
+        }
+    }
+
+done:
+    p->stats.prefetch_frames = p->prefetch;
+}
+
 static bool prefill(pl_queue p, const struct pl_queue_params *params)
 {
     int min_frames = 2 * ceilf(params->radius);
     if (p->fps.estimate && p->vps.estimate && p->vps.estimate <= 1.0f / MIN_FPS)
         min_frames *= ceilf(p->vps.estimate / p->fps.estimate);
-    min_frames = PL_MAX(min_frames, PREFETCH_FRAMES);
+    min_frames = PL_MAX(min_frames, p->prefetch);
 
     while (p->queue.num < min_frames) {
         switch (get_frame(p, params)) {
@@ -929,10 +1227,22 @@ static bool prefill(pl_queue p, const struct pl_queue_params *params)
 enum pl_queue_status pl_queue_update(pl_queue p, struct pl_frame_mix *out_mix,
                                      const struct pl_queue_params *params)
 {
+    // Query this before taking any locks, to avoid lock order issues with the
+    // swapchain's internal state
+    struct pl_swapchain_timing timing = {0};
+    bool present_timing = params->swapchain &&
+                          pl_swapchain_get_timing(params->swapchain, &timing);
+
     pl_mutex_lock(&p->lock_strong);
     pl_mutex_lock(&p->lock_weak);
+    drain_pushes(p);
     default_estimate(&p->vps, params->vsync_duration);
 
+    if (present_timing && timing.frames_presented != p->frames_presented) {
+        p->frames_presented = timing.frames_presented;
+        update_estimate(&p->vps, timing.vsync_duration);
+    }
+
     float delta = params->pts - p->prev_pts;
     if (delta < 0.0f) {
 
@@ -958,13 +1268,18 @@ enum pl_queue_status pl_queue_update(pl_queue p, struct pl_frame_mix *out_mix,
         PL_TRACE(p, "Discontinuous target PTS jump %f -> %f, ignoring...",
                  p->prev_pts, params->pts);
 
-    } else if (delta > 0) {
+    } else if (delta > 0 && !present_timing) {
 
         update_estimate(&p->vps, params->pts - p->prev_pts);
 
     }
 
     p->prev_pts = params->pts;
+    p->cache_limit = params->max_cache_size;
+    p->updates++;
+    cache_trim(p);
+    if (!p->prefetch)
+        update_prefetch(p, params);
 
     // As a special case, prefill the queue if this is the first frame
     if (!params->pts && !p->queue.num) {
@@ -989,15 +1304,80 @@ enum pl_queue_status pl_queue_update(pl_queue p, struct pl_frame_mix *out_mix,
         ret = nearest(p, out_mix, params);
     }
 
+    // Hint all frames still in the queue to the renderer, since any of them
+    // may become part of a future mix
+    if (out_mix && ret != PL_QUEUE_ERR) {
+        p->tmp_retain.num = 0;
+        for (int i = 0; i < p->queue.num; i++)
+            PL_ARRAY_APPEND(p, p->tmp_retain, p->queue.elem[i]->signature);
+        out_mix->retain = p->tmp_retain.elem;
+        out_mix->num_retain = p->tmp_retain.num;
+    }
+
+    update_prefetch(p, params);
     pl_cond_signal(&p->wakeup);
     pl_mutex_unlock(&p->lock_weak);
     pl_mutex_unlock(&p->lock_strong);
     return ret;
 }
 
+int pl_queue_map_ahead(pl_queue p, int num_frames)
+{
+    int mapped = 0;
+    pl_mutex_lock(&p->lock_weak);
+    drain_pushes(p);
+
+restart:
+    for (int i = 0, upcoming = 0; i < p->queue.num && upcoming < num_frames; i++) {
+        struct entry *entry = p->queue.elem[i];
+        if (entry->pts <= p->prev_pts)
+            continue; // already needed, left to `pl_queue_update`
+
+        upcoming++;
+        entry = PL_DEF(entry->primary, entry);
+        if (entry->mapped || entry->mapping)
+            continue;
+
+        PL_TRACE(p, "Mapping frame id %"PRIu64" with PTS %f ahead of time",
+                 entry->signature, entry->pts);
+
+        // Don't hold the lock while mapping, only keep this entry alive
+        entry->mapping = true;
+        entry_ref(entry);
+        cache_get(p, &entry->cache);
+        pl_mutex_unlock(&p->lock_weak);
+        pl_clock_t start = pl_clock_now();
+        bool ok = entry->src.map(p->gpu, entry->cache.tex, &entry->src, &entry->frame);
+        double latency = pl_clock_diff(pl_clock_now(), start);
+        pl_mutex_lock(&p->lock_weak);
+        record_latency(p, latency);
+
+        if (ok) {
+            p->cache_key = cache_key(&entry->cache);
+        } else {
+            PL_ERR(p, "Failed mapping frame id %"PRIu64" with PTS %f",
+                   entry->signature, entry->pts);
+        }
+
+        entry->ok = ok;
+        entry->mapped = true;
+        entry->mapping = false;
+        entry_deref(p, &entry, true);
+        pl_cond_broadcast(&p->wakeup);
+        mapped++;
+
+        // The queue may have changed while we weren't holding the lock
+        goto restart;
+    }
+
+    pl_mutex_unlock(&p->lock_weak);
+    return mapped;
+}
+
 float pl_queue_estimate_fps(pl_queue p)
 {
     pl_mutex_lock(&p->lock_weak);
+    drain_pushes(p);
     float estimate = p->fps.estimate;
     pl_mutex_unlock(&p->lock_weak);
     return estimate ? 1.0f / estimate : 0.0f;
@@ -1011,9 +1391,18 @@ float pl_queue_estimate_vps(pl_queue p)
     return estimate ? 1.0f / estimate : 0.0f;
 }
 
+void pl_queue_get_stats(pl_queue p, struct pl_queue_stats *out)
+{
+    pl_mutex_lock(&p->lock_weak);
+    *out = p->stats;
+    out->prefetch_frames = PL_DEF(p->prefetch, PREFETCH_FRAMES);
+    pl_mutex_unlock(&p->lock_weak);
+}
+
 int pl_queue_num_frames(pl_queue p)
 {
     pl_mutex_lock(&p->lock_weak);
+    drain_pushes(p);
     int count = p->queue.num;
     pl_mutex_unlock(&p->lock_weak);
     return count;
@@ -1022,6 +1411,7 @@ int pl_queue_num_frames(pl_queue p)
 bool pl_queue_peek(pl_queue p, int idx, struct pl_source_frame *out)
 {
     pl_mutex_lock(&p->lock_weak);
+    drain_pushes(p);
     bool ok = idx >= 0 && idx < p->queue.num;
     if (ok)
         *out = p->queue.elem[idx]->src;
@@ -0,0 +1,260 @@
+/*
+ * This file is part of libplacebo.
+ *
+ * libplacebo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libplacebo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libplacebo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+
+#include "common.h"
+#include "log.h"
+
+#include <libplacebo/utils/hdr_analysis.h>
+
+#define SIDECAR_HEADER "# libplacebo HDR scenes v1"
+
+const struct pl_hdr_analysis_params pl_hdr_analysis_default_params = { PL_HDR_ANALYSIS_DEFAULTS };
+
+struct pl_hdr_analysis_t {
+    pl_log log;
+    pl_gpu gpu;
+    pl_renderer rr;
+    pl_tex fbo; // dummy render target, only its size (and cost) matters
+    struct pl_hdr_analysis_params params;
+    PL_ARRAY(struct pl_hdr_scene) scenes;
+    uint64_t num_frames;
+    double scene_sum;   // sum of `avg_pq_y` over the current scene
+    float last_avg;     // `avg_pq_y` of the previous frame
+    pl_str sidecar;
+};
+
+pl_hdr_analysis pl_hdr_analysis_create(pl_log log, pl_gpu gpu,
+                                       const struct pl_hdr_analysis_params *params)
+{
+    params = PL_DEF(params, &pl_hdr_analysis_default_params);
+    if (!gpu->glsl.compute || !gpu->limits.max_ssbo_size) {
+        pl_err(log, "HDR analysis requires a GPU with support for compute "
+               "shaders and storage buffers!");
+        return NULL;
+    }
+
+    pl_fmt fmt = pl_find_fmt(gpu, PL_FMT_UNORM, 4, 8, 8, PL_FMT_CAP_RENDERABLE);
+    if (!fmt) {
+        pl_err(log, "No renderable 8-bit RGBA format found!");
+        return NULL;
+    }
+
+    pl_hdr_analysis an = pl_zalloc_ptr(NULL, an);
+    an->log = log;
+    an->gpu = gpu;
+    an->params = *params;
+    an->rr = pl_renderer_create(log, gpu);
+    an->fbo = pl_tex_create(gpu, pl_tex_params(
+        .w          = 64,
+        .h          = 64,
+        .format     = fmt,
+        .renderable = true,
+        .debug_tag  = PL_DEBUG_TAG,
+    ));
+
+    if (!an->rr || !an->fbo) {
+        pl_hdr_analysis_destroy(&an);
+        return NULL;
+    }
+
+    return an;
+}
+
+void pl_hdr_analysis_destroy(pl_hdr_analysis *pan)
+{
+    pl_hdr_analysis an = *pan;
+    if (!an)
+        return;
+
+    pl_tex_destroy(an->gpu, &an->fbo);
+    pl_renderer_destroy(&an->rr);
+    pl_free(an);
+    *pan = NULL;
+}
+
+bool pl_hdr_analysis_add_frame(pl_hdr_analysis an, const struct pl_frame *image)
+{
+    if (!pl_color_space_is_hdr(&image->color)) {
+        PL_ERR(an, "HDR analysis requires HDR input!");
+        return false;
+    }
+
+    // Strip any existing dynamic metadata, which would otherwise make the
+    // renderer skip peak detection for this frame
+    struct pl_frame img = *image;
+    img.color.hdr.max_pq_y = img.color.hdr.avg_pq_y = 0.0f;
+
+    struct pl_frame target = {
+        .num_planes = 1,
+        .planes     = {{
+            .texture            = an->fbo,
+            .components         = 4,
+            .component_mapping  = {0, 1, 2, 3},
+        }},
+        .repr       = pl_color_repr_rgb,
+        .color      = pl_color_space_srgb,
+    };
+
+    // Measure each frame on its own, scene detection is done below
+    const struct pl_peak_detect_params peak = {
+        .percentile     = an->params.percentile,
+        .stride         = an->params.stride,
+        .allow_delayed  = false,
+    };
+
+    struct pl_render_params params = pl_render_fast_params;
+    params.peak_detect_params = &peak;
+    params.color_map_params = &pl_color_map_default_params;
+
+    if (!pl_render_image(an->rr, &img, &target, &params))
+        return false;
+
+    struct pl_hdr_metadata hdr;
+    if (!pl_renderer_get_hdr_metadata(an->rr, &hdr)) {
+        PL_ERR(an, "Failed measuring frame %llu, peak detection unavailable?",
+               (unsigned long long) an->num_frames);
+        return false;
+    }
+
+    const float thresh = an->params.scene_threshold * 1e-2f;
+    if (!an->scenes.num || fabsf(hdr.avg_pq_y - an->last_avg) > thresh) {
+        PL_ARRAY_APPEND(an, an->scenes, (struct pl_hdr_scene) {
+            .first_frame = an->num_frames,
+        });
+        an->scene_sum = 0.0;
+    }
+
+    struct pl_hdr_scene *scene = &an->scenes.elem[an->scenes.num - 1];
+    scene->num_frames++;
+    scene->max_pq_y = PL_MAX(scene->max_pq_y, hdr.max_pq_y);
+    an->scene_sum += hdr.avg_pq_y;
+    scene->avg_pq_y = an->scene_sum / scene->num_frames;
+
+    an->last_avg = hdr.avg_pq_y;
+    an->num_frames++;
+    return true;
+}
+
+const char *pl_hdr_analysis_save(pl_hdr_analysis an)
+{
+    an->sidecar.len = 0;
+    pl_str_append_asprintf_c(an, &an->sidecar, SIDECAR_HEADER "\n"
+                             "# first_frame num_frames max_pq_y avg_pq_y\n");
+
+    for (int i = 0; i < an->scenes.num; i++) {
+        const struct pl_hdr_scene *scene = &an->scenes.elem[i];
+        pl_str_append_asprintf_c(an, &an->sidecar, "%llu %llu %f %f\n",
+                                 (unsigned long long) scene->first_frame,
+                                 (unsigned long long) scene->num_frames,
+                                 (double) scene->max_pq_y,
+                                 (double) scene->avg_pq_y);
+    }
+
+    return (const char *) an->sidecar.buf;
+}
+
+pl_hdr_scenes pl_hdr_scenes_parse(pl_log log, const char *str, size_t len)
+{
+    pl_str rest = { (uint8_t *) str, len };
+    pl_str line = pl_str_strip(pl_str_getline(rest, &rest));
+    if (!pl_str_equals0(line, SIDECAR_HEADER)) {
+        pl_err(log, "Failed parsing HDR scenes: missing or invalid header!");
+        return NULL;
+    }
+
+    struct pl_hdr_scenes_t *res = pl_zalloc_ptr(NULL, res);
+    PL_ARRAY(struct pl_hdr_scene) scenes = {0};
+    uint64_t next_frame = 0;
+    for (int num = 2; rest.len; num++) {
+        line = pl_str_strip(pl_str_getline(rest, &rest));
+        if (!line.len || line.buf[0] == '#')
+            continue;
+
+        const pl_str orig = line;
+        struct pl_hdr_scene scene;
+        pl_str first = pl_str_split_char(line, ' ', &line);
+        pl_str count = pl_str_split_char(pl_str_strip(line), ' ', &line);
+        pl_str max = pl_str_split_char(pl_str_strip(line), ' ', &line);
+        pl_str avg = pl_str_strip(line);
+        if (!pl_str_parse_uint64(first, &scene.first_frame) ||
+            !pl_str_parse_uint64(count, &scene.num_frames) ||
+            !pl_str_parse_float(max, &scene.max_pq_y) ||
+            !pl_str_parse_float(avg, &scene.avg_pq_y))
+        {
+            pl_err(log, "Failed parsing HDR scenes: malformed line %d: '%.*s'",
+                   num, PL_STR_FMT(orig));
+            goto error;
+        }
+
+        if (scene.first_frame != next_frame || !scene.num_frames ||
+            !(scene.max_pq_y >= 0.0f && scene.max_pq_y <= 1.0f) ||
+            !(scene.avg_pq_y >= 0.0f && scene.avg_pq_y <= 1.0f))
+        {
+            pl_err(log, "Failed parsing HDR scenes: invalid scene on line %d!", num);
+            goto error;
+        }
+
+        next_frame = scene.first_frame + scene.num_frames;
+        PL_ARRAY_APPEND(res, scenes, scene);
+    }
+
+    res->scenes = scenes.elem;
+    res->num_scenes = scenes.num;
+    return res;
+
+error:
+    pl_free(res);
+    return NULL;
+}
+
+void pl_hdr_scenes_free(pl_hdr_scenes *scenes)
+{
+    pl_free((void *) *scenes);
+    *scenes = NULL;
+}
+
+bool pl_hdr_scenes_apply(pl_hdr_scenes scenes, uint64_t index,
+                         struct pl_hdr_metadata *hdr)
+{
+    if (!scenes)
+        return false;
+
+    // Binary search for the last scene starting at or before `index`
+    int lo = 0, hi = scenes->num_scenes;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (scenes->scenes[mid].first_frame <= index) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (!lo)
+        return false;
+
+    const struct pl_hdr_scene *scene = &scenes->scenes[lo - 1];
+    if (index - scene->first_frame >= scene->num_frames)
+        return false;
+
+    hdr->max_pq_y = scene->max_pq_y;
+    // Ensure `avg_pq_y` is non-zero, so the renderer treats it as present
+    hdr->avg_pq_y = PL_MAX(scene->avg_pq_y, PL_COLOR_HDR_BLACK);
+    return true;
+}
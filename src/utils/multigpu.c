@@ -0,0 +1,276 @@
+/*
+ * This file is part of libplacebo.
+ *
+ * libplacebo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libplacebo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libplacebo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "log.h"
+
+#include <libplacebo/utils/multigpu.h>
+
+struct slot {
+    pl_gpu gpu;
+    pl_renderer rr;
+    pl_tex tex;         // intermediate render target
+    pl_buf buf;         // download buffer on `gpu`, unless this is the primary
+    pl_buf imported;    // `buf` imported into the primary GPU, if supported
+    size_t row_pitch;
+    uint64_t index;
+    bool pending;
+};
+
+struct pl_multigpu_t {
+    pl_log log;
+    int num_slots;
+    struct slot slots[PL_MULTIGPU_MAX];
+};
+
+static inline pl_gpu primary_gpu(pl_multigpu mg)
+{
+    return mg->slots[0].gpu;
+}
+
+static void await_buf(pl_gpu gpu, pl_buf buf)
+{
+    while (buf && pl_buf_poll(gpu, buf, UINT64_MAX))
+        ; // do nothing
+}
+
+static void destroy_bufs(pl_multigpu mg, struct slot *s)
+{
+    await_buf(primary_gpu(mg), s->imported);
+    await_buf(s->gpu, s->buf);
+    pl_buf_destroy(primary_gpu(mg), &s->imported);
+    pl_buf_destroy(s->gpu, &s->buf);
+}
+
+pl_multigpu pl_multigpu_create(pl_log log, const struct pl_multigpu_params *params)
+{
+    if (params->num_gpus < 1 || params->num_gpus > PL_MULTIGPU_MAX) {
+        pl_err(log, "Invalid number of GPUs %d, must be between 1 and %d!",
+               params->num_gpus, PL_MULTIGPU_MAX);
+        return NULL;
+    }
+
+    pl_multigpu mg = pl_zalloc_ptr(NULL, mg);
+    mg->log = log;
+    mg->num_slots = params->num_gpus;
+    for (int i = 0; i < mg->num_slots; i++) {
+        struct slot *s = &mg->slots[i];
+        s->gpu = params->gpus[i];
+        s->rr = pl_renderer_create(log, s->gpu);
+        if (!s->rr) {
+            pl_multigpu_destroy(&mg);
+            return NULL;
+        }
+    }
+
+    return mg;
+}
+
+void pl_multigpu_destroy(pl_multigpu *pmg)
+{
+    pl_multigpu mg = *pmg;
+    if (!mg)
+        return;
+
+    for (int i = 0; i < mg->num_slots; i++) {
+        struct slot *s = &mg->slots[i];
+        destroy_bufs(mg, s);
+        pl_tex_destroy(s->gpu, &s->tex);
+        pl_renderer_destroy(&s->rr);
+    }
+
+    pl_free(mg);
+    *pmg = NULL;
+}
+
+pl_gpu pl_multigpu_gpu(pl_multigpu mg, uint64_t index)
+{
+    return mg->slots[index % mg->num_slots].gpu;
+}
+
+pl_renderer pl_multigpu_renderer(pl_multigpu mg, uint64_t index)
+{
+    return mg->slots[index % mg->num_slots].rr;
+}
+
+// (Re)creates the buffers used to transfer `s->tex` to the primary GPU,
+// preferring zero-copy DMA-BUF sharing where supported
+static bool setup_bufs(pl_multigpu mg, struct slot *s)
+{
+    pl_gpu primary = primary_gpu(mg);
+    const pl_fmt fmt = s->tex->params.format;
+    const size_t align = pl_lcm(PL_DEF(s->gpu->limits.align_tex_xfer_pitch, 1),
+                                PL_DEF(primary->limits.align_tex_xfer_pitch, 1));
+    s->row_pitch = PL_ALIGN(s->tex->params.w * fmt->texel_size, align);
+    const size_t size = s->row_pitch * s->tex->params.h;
+    if (s->buf && s->buf->params.size >= size)
+        return true;
+
+    destroy_bufs(mg, s);
+    if ((s->gpu->export_caps.buf & PL_HANDLE_DMA_BUF) &&
+        (primary->import_caps.buf & PL_HANDLE_DMA_BUF))
+    {
+        s->buf = pl_buf_create(s->gpu, pl_buf_params(
+            .size           = size,
+            .memory_type    = PL_BUF_MEM_HOST,
+            .export_handle  = PL_HANDLE_DMA_BUF,
+            .debug_tag      = PL_DEBUG_TAG,
+        ));
+
+        if (s->buf) {
+            s->imported = pl_buf_create(primary, pl_buf_params(
+                .size           = size,
+                .memory_type    = PL_BUF_MEM_HOST,
+                .import_handle  = PL_HANDLE_DMA_BUF,
+                .shared_mem     = s->buf->shared_mem,
+                .debug_tag      = PL_DEBUG_TAG,
+            ));
+        }
+
+        if (s->imported)
+            return true;
+
+        PL_WARN(mg, "Failed sharing DMA-BUF between GPUs, falling back to "
+                "host memory transfers");
+        pl_buf_destroy(s->gpu, &s->buf);
+    }
+
+    s->buf = pl_buf_create(s->gpu, pl_buf_params(
+        .size           = size,
+        .memory_type    = PL_BUF_MEM_HOST,
+        .host_mapped    = true,
+        .debug_tag      = PL_DEBUG_TAG,
+    ));
+
+    return s->buf;
+}
+
+bool pl_multigpu_render(pl_multigpu mg, uint64_t index,
+                        const struct pl_frame *image,
+                        const struct pl_frame *target,
+                        const struct pl_render_params *params)
+{
+    struct slot *s = &mg->slots[index % mg->num_slots];
+    const bool is_primary = s == &mg->slots[0];
+    if (s->pending) {
+        PL_ERR(mg, "Frame %"PRIu64" must be presented before rendering frame "
+               "%"PRIu64"!", s->index, index);
+        return false;
+    }
+
+    if (target->num_planes != 1) {
+        PL_ERR(mg, "Multi-GPU rendering requires single-plane targets!");
+        return false;
+    }
+
+    const pl_tex ref = target->planes[0].texture;
+    pl_fmt fmt = ref->params.format;
+    if (!is_primary)
+        fmt = pl_find_named_fmt(s->gpu, fmt->name);
+    const enum pl_fmt_caps caps = PL_FMT_CAP_RENDERABLE |
+        (is_primary ? PL_FMT_CAP_BLITTABLE : PL_FMT_CAP_HOST_READABLE);
+    if (!fmt || (fmt->caps & caps) != caps) {
+        PL_ERR(mg, "Target format '%s' is not supported by the GPU rendering "
+               "frame %"PRIu64"!", ref->params.format->name, index);
+        return false;
+    }
+
+    bool ok = pl_tex_recreate(s->gpu, &s->tex, pl_tex_params(
+        .w              = ref->params.w,
+        .h              = ref->params.h,
+        .format         = fmt,
+        .renderable     = true,
+        .blit_src       = is_primary,
+        .host_readable  = !is_primary,
+        .debug_tag      = PL_DEBUG_TAG,
+    ));
+
+    if (!ok)
+        return false;
+
+    struct pl_frame frame = *target;
+    frame.planes[0].texture = s->tex;
+    if (!pl_render_image(s->rr, image, &frame, params))
+        return false;
+
+    if (!is_primary) {
+        if (!setup_bufs(mg, s))
+            return false;
+
+        // The primary GPU may still be reading from the previous frame
+        await_buf(primary_gpu(mg), s->imported);
+        ok = pl_tex_download(s->gpu, pl_tex_transfer_params(
+            .tex        = s->tex,
+            .row_pitch  = s->row_pitch,
+            .buf        = s->buf,
+        ));
+
+        if (!ok)
+            return false;
+    }
+
+    pl_gpu_flush(s->gpu);
+    s->index = index;
+    s->pending = true;
+    return true;
+}
+
+bool pl_multigpu_present(pl_multigpu mg, uint64_t index,
+                         const struct pl_frame *target,
+                         uint64_t timeout)
+{
+    struct slot *s = &mg->slots[index % mg->num_slots];
+    pl_gpu primary = primary_gpu(mg);
+    if (!s->pending || s->index != index) {
+        PL_ERR(mg, "Frame %"PRIu64" was never rendered!", index);
+        return false;
+    }
+
+    pl_tex dst = target->planes[0].texture;
+    if (s == &mg->slots[0]) {
+        pl_tex_blit(primary, pl_tex_blit_params(
+            .src = s->tex,
+            .dst = dst,
+        ));
+        s->pending = false;
+        return true;
+    }
+
+    if (pl_buf_poll(s->gpu, s->buf, timeout))
+        return false; // still being downloaded
+
+    bool ok;
+    if (s->imported) {
+        ok = pl_tex_upload(primary, pl_tex_transfer_params(
+            .tex        = dst,
+            .row_pitch  = s->row_pitch,
+            .buf        = s->imported,
+        ));
+    } else {
+        // Always memcpy, since importing the other GPU's mapped memory as a
+        // host pointer can't be expected to work
+        ok = pl_tex_upload(primary, pl_tex_transfer_params(
+            .tex        = dst,
+            .row_pitch  = s->row_pitch,
+            .ptr        = s->buf->data,
+            .no_import  = true,
+        ));
+    }
+
+    s->pending = false;
+    return ok;
+}
@@ -0,0 +1,269 @@
+/*
+ * This file is part of libplacebo.
+ *
+ * libplacebo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libplacebo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libplacebo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "log.h"
+
+#include <libplacebo/utils/pipeline.h>
+
+#define MAX_FRAMES 16
+
+// Resources of a single frame in flight
+struct slot {
+    pl_tex src[PL_MAX_PLANES];
+    pl_tex dst[PL_MAX_PLANES];
+    struct pl_plane target[PL_MAX_PLANES];
+    pl_buf buf[PL_MAX_PLANES];  // download buffers, or NULL
+    void *host[PL_MAX_PLANES];  // host copies, unless `buf` is host-mapped
+    struct pl_pipeline_frame frame;
+};
+
+struct pl_pipeline_t {
+    pl_log log;
+    pl_gpu gpu;
+    pl_renderer rr;
+    pl_upload_ring ring;
+    struct pl_pipeline_params params;
+    struct pl_plane_data planes[PL_MAX_PLANES];
+    size_t stride[PL_MAX_PLANES];
+    uint64_t index;
+    bool dropped;
+
+    // Ring of frames in flight, starting at `head`
+    struct slot slots[MAX_FRAMES];
+    int num_slots;
+    int head, num_busy;
+};
+
+static bool slot_init(pl_pipeline pipe, struct slot *slot)
+{
+    pl_gpu gpu = pipe->gpu;
+    for (int i = 0; i < pipe->params.num_planes; i++) {
+        const struct pl_plane_data *data = &pipe->planes[i];
+        if (!pl_recreate_plane(gpu, &slot->target[i], &slot->dst[i], data))
+            return false;
+
+        pl_tex tex = slot->dst[i];
+        const size_t texel_size = tex->params.format->texel_size;
+        const size_t stride = PL_DEF(data->row_stride, data->width * texel_size);
+        if (!tex->params.host_readable || stride % texel_size) {
+            PL_ERR(pipe, "Output plane %d (format '%s') is not host-readable, "
+                   "or has a misaligned row stride!", i, tex->params.format->name);
+            return false;
+        }
+
+        const size_t size = stride * data->height;
+        pipe->stride[i] = stride;
+        if (gpu->limits.buf_transfer) {
+            const bool mapped = size <= gpu->limits.max_mapped_size;
+            slot->buf[i] = pl_buf_create(gpu, pl_buf_params(
+                .size           = size,
+                .host_mapped    = mapped,
+                .host_readable  = !mapped,
+                .debug_tag      = PL_DEBUG_TAG,
+            ));
+        }
+
+        if (!slot->buf[i] || !slot->buf[i]->data)
+            slot->host[i] = pl_alloc(pipe, size);
+    }
+
+    return true;
+}
+
+pl_pipeline pl_pipeline_create(pl_log log, pl_gpu gpu,
+                               const struct pl_pipeline_params *params)
+{
+    if (!params->output || params->num_planes <= 0 ||
+        params->num_planes > PL_MAX_PLANES)
+    {
+        pl_err(log, "Invalid pipeline parameters: `output` and between 1 and "
+               "%d `planes` are required!", PL_MAX_PLANES);
+        return NULL;
+    }
+
+    pl_pipeline pipe = pl_zalloc_ptr(NULL, pipe);
+    pipe->log = log;
+    pipe->gpu = gpu;
+    pipe->params = *params;
+    memcpy(pipe->planes, params->planes, params->num_planes * sizeof(pipe->planes[0]));
+    pipe->params.planes = pipe->planes;
+    pipe->num_slots = PL_CLAMP(PL_DEF(params->frames_in_flight, 3), 1, MAX_FRAMES);
+    pipe->rr = pl_renderer_create(log, gpu);
+    pipe->ring = pl_upload_ring_create(gpu, pipe->num_slots * PL_MAX_PLANES);
+
+    for (int i = 0; i < pipe->num_slots; i++) {
+        if (!slot_init(pipe, &pipe->slots[i])) {
+            pl_pipeline_destroy(&pipe);
+            return NULL;
+        }
+    }
+
+    return pipe;
+}
+
+void pl_pipeline_destroy(pl_pipeline *ppipe)
+{
+    pl_pipeline pipe = *ppipe;
+    if (!pipe)
+        return;
+
+    for (int i = 0; i < pipe->num_slots; i++) {
+        struct slot *slot = &pipe->slots[i];
+        for (int n = 0; n < PL_MAX_PLANES; n++) {
+            pl_tex_destroy(pipe->gpu, &slot->src[n]);
+            pl_tex_destroy(pipe->gpu, &slot->dst[n]);
+            pl_buf_destroy(pipe->gpu, &slot->buf[n]);
+        }
+    }
+
+    pl_upload_ring_destroy(&pipe->ring);
+    pl_renderer_destroy(&pipe->rr);
+    pl_free(pipe);
+    *ppipe = NULL;
+}
+
+// Delivers the oldest frame in flight, optionally blocking until it has
+// completed. Returns false if it is still in flight.
+static bool deliver(pl_pipeline pipe, bool block)
+{
+    pl_gpu gpu = pipe->gpu;
+    struct slot *slot = &pipe->slots[pipe->head];
+    const uint64_t timeout = block ? UINT64_MAX : 0;
+    for (int i = 0; i < pipe->params.num_planes; i++) {
+        bool busy;
+        do {
+            busy = slot->buf[i] ? pl_buf_poll(gpu, slot->buf[i], timeout)
+                                : pl_tex_poll(gpu, slot->dst[i], timeout);
+        } while (busy && block);
+        if (busy)
+            return false;
+    }
+
+    bool ok = true;
+    struct pl_pipeline_frame *frame = &slot->frame;
+    for (int i = 0; i < pipe->params.num_planes; i++) {
+        const size_t size = pipe->stride[i] * pipe->planes[i].height;
+        pl_buf buf = slot->buf[i];
+        if (buf && buf->data) {
+            frame->data[i] = buf->data;
+        } else if (buf) {
+            ok &= pl_buf_read(gpu, buf, 0, slot->host[i], size);
+            frame->data[i] = slot->host[i];
+        } else {
+            ok &= pl_tex_download(gpu, pl_tex_transfer_params(
+                .tex        = slot->dst[i],
+                .ptr        = slot->host[i],
+                .row_pitch  = pipe->stride[i],
+            ));
+            frame->data[i] = slot->host[i];
+        }
+    }
+
+    if (ok) {
+        pipe->params.output(pipe->params.priv, frame);
+    } else {
+        PL_ERR(pipe, "Failed downloading frame %"PRIu64", dropping", frame->index);
+        pipe->dropped = true;
+    }
+
+    pipe->head = (pipe->head + 1) % pipe->num_slots;
+    pipe->num_busy--;
+    return true;
+}
+
+bool pl_pipeline_push(pl_pipeline pipe, const struct pl_pipeline_source *src)
+{
+    pl_gpu gpu = pipe->gpu;
+    if (src->num_planes <= 0 || src->num_planes > PL_MAX_PLANES) {
+        PL_ERR(pipe, "Invalid number of source planes: %d", src->num_planes);
+        return false;
+    }
+
+    while (pipe->num_busy && deliver(pipe, false))
+        ; // deliver all completed frames
+    if (pipe->num_busy == pipe->num_slots)
+        deliver(pipe, true);
+
+    const int idx = (pipe->head + pipe->num_busy) % pipe->num_slots;
+    struct slot *slot = &pipe->slots[idx];
+
+    // Stage 1: upload the source planes
+    struct pl_frame image = {
+        .num_planes = src->num_planes,
+        .repr       = src->repr,
+        .color      = src->color,
+    };
+
+    for (int i = 0; i < src->num_planes; i++) {
+        if (!pl_upload_ring_plane(pipe->ring, &image.planes[i], &slot->src[i],
+                                  &src->planes[i]))
+        {
+            PL_ERR(pipe, "Failed uploading plane %d of frame %"PRIu64, i, pipe->index);
+            return false;
+        }
+    }
+    pl_frame_set_chroma_location(&image, src->chroma_location);
+
+    // Stage 2: render to the output planes
+    struct pl_frame target = {
+        .num_planes = pipe->params.num_planes,
+        .repr       = pipe->params.repr,
+        .color      = pipe->params.color,
+    };
+    memcpy(target.planes, slot->target, sizeof(target.planes));
+    pl_frame_set_chroma_location(&target, pipe->params.chroma_location);
+    if (!pl_render_image(pipe->rr, &image, &target, pipe->params.render_params)) {
+        PL_ERR(pipe, "Failed rendering frame %"PRIu64, pipe->index);
+        return false;
+    }
+
+    // Stage 3: download the result asynchronously, if possible
+    for (int i = 0; i < pipe->params.num_planes; i++) {
+        if (!slot->buf[i])
+            continue; // downloaded synchronously on delivery
+        if (!pl_tex_download(gpu, pl_tex_transfer_params(
+                .tex        = slot->dst[i],
+                .buf        = slot->buf[i],
+                .row_pitch  = pipe->stride[i],
+            )))
+        {
+            PL_ERR(pipe, "Failed downloading plane %d of frame %"PRIu64, i, pipe->index);
+            return false;
+        }
+    }
+
+    slot->frame = (struct pl_pipeline_frame) {
+        .index      = pipe->index++,
+        .priv       = src->priv,
+        .num_planes = pipe->params.num_planes,
+    };
+    memcpy(slot->frame.row_stride, pipe->stride, sizeof(pipe->stride));
+    pipe->num_busy++;
+    pl_gpu_flush(gpu);
+    return true;
+}
+
+bool pl_pipeline_flush(pl_pipeline pipe)
+{
+    while (pipe->num_busy)
+        deliver(pipe, true);
+
+    const bool ok = !pipe->dropped;
+    pipe->dropped = false;
+    return ok;
+}
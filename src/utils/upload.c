@@ -18,6 +18,8 @@
 #include "log.h"
 #include "common.h"
 #include "gpu.h"
+#include "hash.h"
+#include "shaders.h"
 
 #include <libplacebo/utils/upload.h>
 
@@ -166,13 +168,30 @@ misaligned:
     return false;
 }
 
-pl_fmt pl_plane_find_fmt(pl_gpu gpu, int out_map[4], const struct pl_plane_data *data)
+// Size of the words to byte swap for `swapped` planes: each component for
+// byte-aligned formats with uniform component sizes, or the entire pixel for
+// packed formats. Returns 0 if the layout can't be swapped.
+static int swap_wordsize(const struct pl_plane_data *data)
 {
-    int dummy[4] = {0};
-    out_map = PL_DEF(out_map, dummy);
+    int size = 0;
+    for (int i = 0; i < MAX_COMPS; i++) {
+        int bits = data->component_size[i];
+        if (!bits)
+            continue;
+        if (bits % 8 || data->component_pad[i] % 8 || (size && size != bits)) {
+            size = data->pixel_stride * 8;
+            break;
+        }
+        size = bits;
+    }
+
+    return (size == 16 || size == 32) ? size / 8 : 0;
+}
 
+static pl_fmt plane_find_fmt(pl_gpu gpu, int out_map[4], const struct pl_plane_data *data)
+{
     // Endian swapping requires compute shaders (currently)
-    if (data->swapped && !gpu->limits.max_ssbo_size)
+    if (data->swapped && (!gpu->limits.max_ssbo_size || !swap_wordsize(data)))
         return NULL;
 
     // Count the number of components and initialize out_map
@@ -228,6 +247,234 @@ next_fmt: ; // acts as `continue`
     return NULL;
 }
 
+pl_fmt pl_plane_find_fmt(pl_gpu gpu, int out_map[4], const struct pl_plane_data *data)
+{
+    int dummy[4] = {0};
+    out_map = PL_DEF(out_map, dummy);
+
+    // Only hash the fields relevant for the format choice
+    struct {
+        uint32_t type, swapped;
+        int32_t size[4], pad[4], map[4];
+        uint64_t pixel_stride, row_stride;
+    } params = {
+        .type = data->type,
+        .pixel_stride = data->pixel_stride,
+        .row_stride = data->row_stride,
+        .swapped = data->swapped,
+    };
+
+    for (int i = 0; i < MAX_COMPS; i++) {
+        params.size[i] = data->component_size[i];
+        params.pad[i] = data->component_pad[i];
+        params.map[i] = data->component_map[i];
+    }
+
+    const uint64_t key = pl_var_hash(params);
+    pl_fmt fmt;
+    if (pl_gpu_fmt_cache_get(gpu, key, &fmt, out_map))
+        return fmt;
+
+    fmt = plane_find_fmt(gpu, out_map, data);
+    pl_gpu_fmt_cache_set(gpu, key, fmt, out_map);
+    return fmt;
+}
+
+// Fallback for layouts without a matching texture format: uploads the raw
+// pixel data into a storage buffer, and unpacks the individual components
+// into a storable texture using a compute shader
+static bool upload_plane_compute(pl_gpu gpu, struct pl_plane *out_plane,
+                                 pl_tex *tex, const struct pl_plane_data *data)
+{
+    const int wordsize = data->swapped ? swap_wordsize(data) : 0;
+    if (data->type != PL_FMT_UNORM || (data->swapped && !wordsize))
+        return false;
+    if (!gpu->glsl.compute || !gpu->limits.max_ssbo_size)
+        return false;
+
+    struct { int offset, size, map; } comps[MAX_COMPS];
+    int num = 0, offset = 0, depth = 0;
+    for (int i = 0; i < MAX_COMPS; i++) {
+        offset += data->component_pad[i];
+        if (data->component_size[i]) {
+            comps[num].offset = offset;
+            comps[num].size = data->component_size[i];
+            comps[num].map = data->component_map[i];
+            depth = PL_MAX(depth, comps[num].size);
+            num++;
+        }
+        offset += data->component_size[i];
+    }
+
+    if (!num || depth > 32 || offset > data->pixel_stride * 8)
+        return false;
+
+    // Storable formats with 3 components are rare, so allow padding
+    pl_fmt fmt = NULL;
+    for (int n = num; !fmt && n <= 4; n++) {
+        fmt = pl_find_fmt(gpu, PL_FMT_UNORM, n, PL_MIN(depth, 16), 0,
+                          PL_FMT_CAP_SAMPLEABLE | PL_FMT_CAP_STORABLE);
+    }
+    if (!fmt)
+        return false;
+
+    const size_t row_stride = PL_DEF(data->row_stride, data->width * data->pixel_stride);
+    const size_t size = (data->height - 1) * row_stride +
+                        data->width * data->pixel_stride;
+
+    // Pad by one extra word, since components may straddle word boundaries
+    // and the shader always reads two consecutive words
+    const size_t buf_size = PL_ALIGN2(size, 4) + sizeof(uint32_t);
+    if (buf_size > gpu->limits.max_ssbo_size || row_stride % PL_DEF(wordsize, 1))
+        return false;
+
+    // Swapped data always goes through a temporary buffer, which is then
+    // swapped in-place before unpacking
+    pl_buf buf = data->buf, tmp = NULL;
+    size_t base = data->buf_offset;
+    if (wordsize || !buf || !buf->params.storable || base % 4 ||
+        base + buf_size > buf->params.size)
+    {
+        tmp = pl_buf_create(gpu, pl_buf_params(
+            .size           = buf_size,
+            .storable       = true,
+            .host_writable  = !!data->pixels,
+        ));
+        if (!tmp) {
+            PL_ERR(gpu, "Failed creating buffer for compute unpacking!");
+            return false;
+        }
+
+        if (data->pixels) {
+            pl_buf_write(gpu, tmp, 0, data->pixels, size);
+        } else {
+            pl_buf_copy(gpu, tmp, 0, buf, base,
+                        PL_MIN(size, buf->params.size - base));
+        }
+
+        buf = tmp;
+        base = 0;
+    }
+
+    if (wordsize) {
+        bool swapped = pl_buf_copy_swap(gpu, &(struct pl_buf_copy_swap_params) {
+            .src        = buf,
+            .dst        = buf,
+            .size       = PL_ALIGN2(size, 4),
+            .wordsize   = wordsize,
+        });
+
+        if (!swapped) {
+            PL_ERR(gpu, "Failed swapping endianness!");
+            goto error;
+        }
+    }
+
+    bool ok = pl_tex_recreate(gpu, tex, pl_tex_params(
+        .w = data->width,
+        .h = data->height,
+        .format = fmt,
+        .sampleable = true,
+        .storable = true,
+        .blit_src = fmt->caps & PL_FMT_CAP_BLITTABLE,
+    ));
+
+    if (!ok) {
+        PL_ERR(gpu, "Failed initializing plane texture!");
+        goto error;
+    }
+
+    const int bw = 32, bh = 8;
+    pl_dispatch dp = pl_gpu_dispatch(gpu);
+    pl_shader sh = pl_dispatch_begin(dp);
+    if (!sh_try_compute(sh, bw, bh, false, 0)) {
+        pl_dispatch_abort(dp, &sh);
+        goto error;
+    }
+
+    sh_desc(sh, (struct pl_shader_desc) {
+        .binding.object = buf,
+        .desc = {
+            .name = "SrcBuf",
+            .type = PL_DESC_BUF_STORAGE,
+            .access = PL_DESC_ACCESS_READONLY,
+        },
+        .num_buffer_vars = 1,
+        .buffer_vars = &(struct pl_buffer_var) {
+            .var = {
+                .name = "src",
+                .type = PL_VAR_UINT,
+                .dim_v = 1,
+                .dim_m = 1,
+                .dim_a = (base + buf_size) / sizeof(uint32_t),
+            },
+        },
+    });
+
+    ident_t img = sh_desc(sh, (struct pl_shader_desc) {
+        .binding.object = *tex,
+        .desc = {
+            .name = "image",
+            .type = PL_DESC_STORAGE_IMG,
+            .access = PL_DESC_ACCESS_WRITEONLY,
+        },
+    });
+
+    GLSL("// pl_upload_plane (compute unpack)               \n"
+         "ivec2 pos = ivec2(gl_GlobalInvocationID);         \n"
+         "if (pos.x >= %d || pos.y >= %d)                   \n"
+         "    return;                                       \n"
+         "uint base = "$" + uint(pos.y) * "$" + uint(pos.x) * "$"; \n"
+         "vec4 color = vec4(0.0, 0.0, 0.0, 1.0);            \n"
+         "uint addr, word;                                  \n",
+         data->width, data->height, SH_UINT_DYN(base),
+         SH_UINT(row_stride), SH_UINT(data->pixel_stride));
+
+    for (int i = 0; i < num; i++) {
+        const unsigned mask = comps[i].size < 32 ? (1u << comps[i].size) - 1 : ~0u;
+        GLSL("addr = base + %uu;                                \n"
+             "word = src[addr >> 2] >> ((addr & 3u) * 8u + %uu); \n",
+             (unsigned) comps[i].offset / 8, (unsigned) comps[i].offset % 8);
+        if (comps[i].size > 1) {
+            // The bits missing from the first word come from the next one;
+            // double shift to avoid shifting by 32 when already aligned
+            GLSL("word |= (src[(addr >> 2) + 1u] << 1u) <<        \n"
+                 "        (31u - ((addr & 3u) * 8u + %uu));      \n",
+                 (unsigned) comps[i].offset % 8);
+        }
+        GLSL("color[%d] = float(word & %uu) / %u.0; \n", i, mask, mask);
+    }
+
+    GLSL("imageStore("$", pos, color); \n", img);
+    ok = pl_dispatch_compute(dp, pl_dispatch_compute_params(
+        .shader = &sh,
+        .dispatch_size = {
+            PL_DIV_UP(data->width, bw),
+            PL_DIV_UP(data->height, bh),
+            1,
+        },
+    ));
+
+    if (!ok)
+        goto error;
+
+    if (out_plane) {
+        out_plane->texture = *tex;
+        out_plane->components = num;
+        for (int i = 0; i < PL_ARRAY_SIZE(out_plane->component_mapping); i++)
+            out_plane->component_mapping[i] = i < num ? comps[i].map : -1;
+    }
+
+    pl_buf_destroy(gpu, &tmp);
+    if (data->callback)
+        data->callback(data->priv);
+    return true;
+
+error:
+    pl_buf_destroy(gpu, &tmp);
+    return false;
+}
+
 bool pl_upload_plane(pl_gpu gpu, struct pl_plane *out_plane,
                      pl_tex *tex, const struct pl_plane_data *data)
 {
@@ -236,10 +483,13 @@ bool pl_upload_plane(pl_gpu gpu, struct pl_plane *out_plane,
     int out_map[4];
     pl_fmt fmt = pl_plane_find_fmt(gpu, out_map, data);
     if (!fmt) {
+        PL_DEBUG(gpu, "No texture format matching plane layout, attempting "
+                 "to unpack using compute shaders...");
+        if (upload_plane_compute(gpu, out_plane, tex, data))
+            return true;
+
         PL_ERR(gpu, "Failed picking any compatible texture format for a plane!");
         return false;
-
-        // TODO: try soft-converting to a supported format using e.g zimg?
     }
 
     bool ok = pl_tex_recreate(gpu, tex, pl_tex_params(
@@ -300,7 +550,7 @@ bool pl_upload_plane(pl_gpu gpu, struct pl_plane *out_plane,
             .src        = swapbuf,
             .dst        = swapbuf,
             .size       = aligned,
-            .wordsize   = fmt->texel_size / fmt->num_components,
+            .wordsize   = swap_wordsize(data),
         };
 
         bool can_reuse = params.buf && params.buf->params.storable &&
@@ -337,6 +587,80 @@ bool pl_upload_plane(pl_gpu gpu, struct pl_plane *out_plane,
     return ok;
 }
 
+struct pl_upload_ring_t {
+    pl_gpu gpu;
+    pl_buf *bufs;
+    int num_bufs;
+    int idx;
+};
+
+pl_upload_ring pl_upload_ring_create(pl_gpu gpu, int num_buffers)
+{
+    pl_assert(num_buffers > 0);
+    pl_upload_ring ring = pl_zalloc_ptr(NULL, ring);
+    ring->gpu = gpu;
+    ring->bufs = pl_calloc_ptr(ring, num_buffers, ring->bufs);
+    ring->num_bufs = num_buffers;
+    return ring;
+}
+
+void pl_upload_ring_destroy(pl_upload_ring *pring)
+{
+    pl_upload_ring ring = *pring;
+    if (!ring)
+        return;
+
+    for (int i = 0; i < ring->num_bufs; i++)
+        pl_buf_destroy(ring->gpu, &ring->bufs[i]);
+    pl_free_ptr(pring);
+}
+
+bool pl_upload_ring_plane(pl_upload_ring ring, struct pl_plane *out_plane,
+                          pl_tex *tex, const struct pl_plane_data *data)
+{
+    pl_gpu gpu = ring->gpu;
+    if (!data->pixels || !gpu->limits.buf_transfer)
+        return pl_upload_plane(gpu, out_plane, tex, data);
+
+    const size_t row_stride = PL_DEF(data->row_stride, data->width * data->pixel_stride);
+    const size_t size = (data->height - 1) * row_stride +
+                        data->width * data->pixel_stride;
+
+    pl_buf *buf = &ring->bufs[ring->idx];
+    if (*buf && (*buf)->params.size >= size) {
+        // Wait for the previous upload from this buffer to complete
+        while (pl_buf_poll(gpu, *buf, UINT64_MAX))
+            ; // do nothing
+    } else {
+        pl_buf_destroy(gpu, buf);
+        *buf = pl_buf_create(gpu, pl_buf_params(
+            .size          = PL_ALIGN2(size, 4),
+            .host_writable = true,
+            .host_mapped   = size <= gpu->limits.max_mapped_size,
+            .storable      = data->swapped,
+        ));
+        if (!*buf) {
+            PL_WARN(gpu, "Failed creating staging buffer, falling back to "
+                    "direct upload!");
+            return pl_upload_plane(gpu, out_plane, tex, data);
+        }
+    }
+
+    if ((*buf)->data) {
+        memcpy((*buf)->data, data->pixels, size);
+    } else {
+        pl_buf_write(gpu, *buf, 0, data->pixels, size);
+    }
+
+    ring->idx = (ring->idx + 1) % ring->num_bufs;
+
+    struct pl_plane_data staged = *data;
+    staged.pixels = NULL;
+    staged.buf = *buf;
+    staged.buf_offset = 0;
+    return pl_upload_plane(gpu, out_plane, tex, &staged);
+}
+
 bool pl_recreate_plane(pl_gpu gpu, struct pl_plane *out_plane,
                        pl_tex *tex, const struct pl_plane_data *data)
 {
@@ -18,6 +18,10 @@
 #include "command.h"
 #include "utils.h"
 
+// Upper bound on the number of commands held back by vk_cmd_queue before
+// they're submitted regardless, since queued commands can't be recycled
+#define MAX_QUEUED_CMDS 16
+
 // returns VK_SUCCESS (completed), VK_TIMEOUT (not yet completed) or an error
 static VkResult vk_cmd_poll(struct vk_cmd *cmd, uint64_t timeout)
 {
@@ -54,6 +58,8 @@ static void vk_cmd_reset(struct vk_cmd *cmd)
     cmd->callbacks.num = 0;
     cmd->deps.num = 0;
     cmd->sigs.num = 0;
+    cmd->img_barriers.num = 0;
+    cmd->buf_barriers.num = 0;
 }
 
 static void vk_cmd_destroy(struct vk_cmd *cmd)
@@ -65,7 +71,7 @@ static void vk_cmd_destroy(struct vk_cmd *cmd)
     vk_cmd_poll(cmd, UINT64_MAX);
     vk_cmd_reset(cmd);
     vk->DestroySemaphore(vk->dev, cmd->sync.sem, PL_VK_ALLOC);
-    vk->FreeCommandBuffers(vk->dev, cmd->pool->pool, 1, &cmd->buf);
+    vk->DestroyCommandPool(vk->dev, cmd->cmdpool, PL_VK_ALLOC);
 
     pl_free(cmd);
 }
@@ -76,9 +82,21 @@ static struct vk_cmd *vk_cmd_create(struct vk_cmdpool *pool)
     struct vk_cmd *cmd = pl_zalloc_ptr(NULL, cmd);
     cmd->pool = pool;
 
+    // Give every command buffer its own VkCommandPool. This lets us recycle
+    // it with a cheap vkResetCommandPool, and means that distinct vk_cmds
+    // never share externally synchronized state, so they may be recorded
+    // from different threads at the same time.
+    VkCommandPoolCreateInfo cinfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+        .queueFamilyIndex = pool->qf,
+    };
+
+    VK(vk->CreateCommandPool(vk->dev, &cinfo, PL_VK_ALLOC, &cmd->cmdpool));
+
     VkCommandBufferAllocateInfo ainfo = {
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-        .commandPool = pool->pool,
+        .commandPool = cmd->cmdpool,
         .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
         .commandBufferCount = 1,
     };
@@ -111,7 +129,10 @@ void vk_dev_callback(struct vk_ctx *vk, vk_cb callback,
                      const void *priv, const void *arg)
 {
     pl_mutex_lock(&vk->lock);
-    if (vk->cmds_pending.num > 0) {
+    if (vk->cmds_queued.num > 0) {
+        struct vk_cmd *last_cmd = vk->cmds_queued.elem[vk->cmds_queued.num - 1];
+        vk_cmd_callback(last_cmd, callback, priv, arg);
+    } else if (vk->cmds_pending.num > 0) {
         struct vk_cmd *last_cmd = vk->cmds_pending.elem[vk->cmds_pending.num - 1];
         vk_cmd_callback(last_cmd, callback, priv, arg);
     } else {
@@ -189,7 +210,7 @@ static VkPipelineStageFlags lower_stage2(VkPipelineStageFlags2 flags2)
 
 #undef SET
 
-void vk_cmd_barrier(struct vk_cmd *cmd, const VkDependencyInfo *info)
+static void record_barrier(struct vk_cmd *cmd, const VkDependencyInfo *info)
 {
     struct vk_ctx *vk = cmd->pool->vk;
     if (vk->CmdPipelineBarrier2KHR) {
@@ -199,11 +220,10 @@ void vk_cmd_barrier(struct vk_cmd *cmd, const VkDependencyInfo *info)
 
     pl_assert(!info->pNext);
     pl_assert(info->memoryBarrierCount == 0);
-    pl_assert(info->bufferMemoryBarrierCount + info->imageMemoryBarrierCount == 1);
-
-    if (info->bufferMemoryBarrierCount) {
 
-        const VkBufferMemoryBarrier2 *barr2 = info->pBufferMemoryBarriers;
+    // The legacy API has no per-barrier stage masks, so emit these one by one
+    for (int i = 0; i < info->bufferMemoryBarrierCount; i++) {
+        const VkBufferMemoryBarrier2 *barr2 = &info->pBufferMemoryBarriers[i];
         const VkBufferMemoryBarrier barr = {
             .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
             .pNext               = barr2->pNext,
@@ -220,10 +240,10 @@ void vk_cmd_barrier(struct vk_cmd *cmd, const VkDependencyInfo *info)
                                lower_stage2(barr2->dstStageMask),
                                info->dependencyFlags,
                                0, NULL, 1, &barr, 0, NULL);
+    }
 
-    } else {
-
-        const VkImageMemoryBarrier2 *barr2 = info->pImageMemoryBarriers;
+    for (int i = 0; i < info->imageMemoryBarrierCount; i++) {
+        const VkImageMemoryBarrier2 *barr2 = &info->pImageMemoryBarriers[i];
         const VkImageMemoryBarrier barr = {
             .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
             .pNext               = barr2->pNext,
@@ -244,6 +264,60 @@ void vk_cmd_barrier(struct vk_cmd *cmd, const VkDependencyInfo *info)
     }
 }
 
+void vk_cmd_barrier(struct vk_cmd *cmd, const VkDependencyInfo *info)
+{
+    vk_cmd_flush_barriers(cmd);
+    record_barrier(cmd, info);
+}
+
+void vk_cmd_barrier_img(struct vk_cmd *cmd, const VkImageMemoryBarrier2 *barr)
+{
+    // Multiple barriers within the same dependency are not ordered with
+    // respect to each other, so flush if this image already has one pending
+    for (int i = 0; i < cmd->img_barriers.num; i++) {
+        if (cmd->img_barriers.elem[i].image == barr->image) {
+            vk_cmd_flush_barriers(cmd);
+            break;
+        }
+    }
+
+    PL_ARRAY_APPEND(cmd, cmd->img_barriers, *barr);
+}
+
+void vk_cmd_barrier_buf(struct vk_cmd *cmd, const VkBufferMemoryBarrier2 *barr)
+{
+    // Buffers are suballocated, so check for overlapping ranges instead
+    for (int i = 0; i < cmd->buf_barriers.num; i++) {
+        const VkBufferMemoryBarrier2 *prev = &cmd->buf_barriers.elem[i];
+        if (prev->buffer == barr->buffer &&
+            prev->offset < barr->offset + barr->size &&
+            barr->offset < prev->offset + prev->size)
+        {
+            vk_cmd_flush_barriers(cmd);
+            break;
+        }
+    }
+
+    PL_ARRAY_APPEND(cmd, cmd->buf_barriers, *barr);
+}
+
+void vk_cmd_flush_barriers(struct vk_cmd *cmd)
+{
+    if (!cmd->img_barriers.num && !cmd->buf_barriers.num)
+        return;
+
+    record_barrier(cmd, &(VkDependencyInfo) {
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .bufferMemoryBarrierCount = cmd->buf_barriers.num,
+        .pBufferMemoryBarriers = cmd->buf_barriers.elem,
+        .imageMemoryBarrierCount = cmd->img_barriers.num,
+        .pImageMemoryBarriers = cmd->img_barriers.elem,
+    });
+
+    cmd->img_barriers.num = 0;
+    cmd->buf_barriers.num = 0;
+}
+
 struct vk_sync_scope vk_sem_barrier(struct vk_cmd *cmd, struct vk_sem *sem,
                                     VkPipelineStageFlags2 stage,
                                     VkAccessFlags2 access, bool is_trans)
@@ -314,35 +388,23 @@ struct vk_sync_scope vk_sem_barrier(struct vk_cmd *cmd, struct vk_sem *sem,
     return last;
 }
 
-struct vk_cmdpool *vk_cmdpool_create(struct vk_ctx *vk, int qf, int qnum,
-                                     VkQueueFamilyProperties props)
+struct vk_cmdpool *vk_cmdpool_create(struct vk_ctx *vk, int qf, int qfirst,
+                                     int qnum, VkQueueFamilyProperties props)
 {
     struct vk_cmdpool *pool = pl_alloc_ptr(NULL, pool);
     *pool = (struct vk_cmdpool) {
         .vk         = vk,
         .props      = props,
         .qf         = qf,
+        .qfirst     = qfirst,
         .queues     = pl_calloc(pool, qnum, sizeof(VkQueue)),
         .num_queues = qnum,
     };
 
     for (int n = 0; n < qnum; n++)
-        vk->GetDeviceQueue(vk->dev, qf, n, &pool->queues[n]);
-
-    VkCommandPoolCreateInfo cinfo = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT |
-                 VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
-        .queueFamilyIndex = qf,
-    };
+        vk->GetDeviceQueue(vk->dev, qf, qfirst + n, &pool->queues[n]);
 
-    VK(vk->CreateCommandPool(vk->dev, &cinfo, PL_VK_ALLOC, &pool->pool));
     return pool;
-
-error:
-    vk_cmdpool_destroy(pool);
-    vk->failed = true;
-    return NULL;
 }
 
 void vk_cmdpool_destroy(struct vk_cmdpool *pool)
@@ -353,8 +415,6 @@ void vk_cmdpool_destroy(struct vk_cmdpool *pool)
     for (int i = 0; i < pool->cmds.num; i++)
         vk_cmd_destroy(pool->cmds.elem[i]);
 
-    struct vk_ctx *vk = pool->vk;
-    vk->DestroyCommandPool(vk->dev, pool->pool, PL_VK_ALLOC);
     pl_free(pool);
 }
 
@@ -368,7 +428,8 @@ struct vk_cmd *vk_cmd_begin(struct vk_cmdpool *pool, pl_debug_tag debug_tag)
 
     struct vk_cmd *cmd = NULL;
     pl_mutex_lock(&vk->lock);
-    if (!PL_ARRAY_POP(pool->cmds, &cmd)) {
+    bool reused = PL_ARRAY_POP(pool->cmds, &cmd);
+    if (!reused) {
         cmd = vk_cmd_create(pool);
         if (!cmd) {
             pl_mutex_unlock(&vk->lock);
@@ -380,6 +441,11 @@ struct vk_cmd *vk_cmd_begin(struct vk_cmdpool *pool, pl_debug_tag debug_tag)
     cmd->queue = pool->queues[cmd->qindex];
     pl_mutex_unlock(&vk->lock);
 
+    // The command buffer is exclusively ours from here on, so its pool can be
+    // reset without holding any locks
+    if (reused)
+        VK(vk->ResetCommandPool(vk->dev, cmd->cmdpool, 0));
+
     VkCommandBufferBeginInfo binfo = {
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
         .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
@@ -402,63 +468,154 @@ error:
     return NULL;
 }
 
-static VkResult vk_queue_submit2(struct vk_ctx *vk, VkQueue queue,
-                                 const VkSubmitInfo2 *info2, VkFence fence)
+static VkResult vk_queue_submit2(struct vk_ctx *vk, VkQueue queue, int num,
+                                 const VkSubmitInfo2 *infos2, VkFence fence)
 {
     if (vk->QueueSubmit2KHR)
-        return vk->QueueSubmit2KHR(queue, 1, info2, fence);
-
-    const uint32_t num_deps = info2->waitSemaphoreInfoCount;
-    const uint32_t num_sigs = info2->signalSemaphoreInfoCount;
-    const uint32_t num_cmds = info2->commandBufferInfoCount;
+        return vk->QueueSubmit2KHR(queue, num, infos2, fence);
 
     void *tmp = pl_tmp(NULL);
-    VkSemaphore *deps           = pl_calloc_ptr(tmp, num_deps, deps);
-    VkPipelineStageFlags *masks = pl_calloc_ptr(tmp, num_deps, masks);
-    uint64_t *depvals           = pl_calloc_ptr(tmp, num_deps, depvals);
-    VkSemaphore *sigs           = pl_calloc_ptr(tmp, num_sigs, sigs);
-    uint64_t *sigvals           = pl_calloc_ptr(tmp, num_sigs, sigvals);
-    VkCommandBuffer *cmds       = pl_calloc_ptr(tmp, num_cmds, cmds);
-
-    for (int i = 0; i < num_deps; i++) {
-        deps[i] = info2->pWaitSemaphoreInfos[i].semaphore;
-        masks[i] = info2->pWaitSemaphoreInfos[i].stageMask;
-        depvals[i] = info2->pWaitSemaphoreInfos[i].value;
+    VkSubmitInfo *infos = pl_calloc_ptr(tmp, num, infos);
+    VkTimelineSemaphoreSubmitInfo *tinfos = pl_calloc_ptr(tmp, num, tinfos);
+
+    for (int n = 0; n < num; n++) {
+        const VkSubmitInfo2 *info2 = &infos2[n];
+        const uint32_t num_deps = info2->waitSemaphoreInfoCount;
+        const uint32_t num_sigs = info2->signalSemaphoreInfoCount;
+        const uint32_t num_cmds = info2->commandBufferInfoCount;
+
+        VkSemaphore *deps           = pl_calloc_ptr(tmp, num_deps, deps);
+        VkPipelineStageFlags *masks = pl_calloc_ptr(tmp, num_deps, masks);
+        uint64_t *depvals           = pl_calloc_ptr(tmp, num_deps, depvals);
+        VkSemaphore *sigs           = pl_calloc_ptr(tmp, num_sigs, sigs);
+        uint64_t *sigvals           = pl_calloc_ptr(tmp, num_sigs, sigvals);
+        VkCommandBuffer *cmds       = pl_calloc_ptr(tmp, num_cmds, cmds);
+
+        for (int i = 0; i < num_deps; i++) {
+            deps[i] = info2->pWaitSemaphoreInfos[i].semaphore;
+            masks[i] = info2->pWaitSemaphoreInfos[i].stageMask;
+            depvals[i] = info2->pWaitSemaphoreInfos[i].value;
+        }
+        for (int i = 0; i < num_sigs; i++) {
+            sigs[i] = info2->pSignalSemaphoreInfos[i].semaphore;
+            sigvals[i] = info2->pSignalSemaphoreInfos[i].value;
+        }
+        for (int i = 0; i < num_cmds; i++)
+            cmds[i] = info2->pCommandBufferInfos[i].commandBuffer;
+
+        tinfos[n] = (VkTimelineSemaphoreSubmitInfo) {
+            .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+            .pNext = info2->pNext,
+            .waitSemaphoreValueCount = num_deps,
+            .pWaitSemaphoreValues = depvals,
+            .signalSemaphoreValueCount = num_sigs,
+            .pSignalSemaphoreValues = sigvals,
+        };
+
+        infos[n] = (VkSubmitInfo) {
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            .pNext = &tinfos[n],
+            .waitSemaphoreCount = num_deps,
+            .pWaitSemaphores = deps,
+            .pWaitDstStageMask = masks,
+            .commandBufferCount = num_cmds,
+            .pCommandBuffers = cmds,
+            .signalSemaphoreCount = num_sigs,
+            .pSignalSemaphores = sigs,
+        };
     }
-    for (int i = 0; i < num_sigs; i++) {
-        sigs[i] = info2->pSignalSemaphoreInfos[i].semaphore;
-        sigvals[i] = info2->pSignalSemaphoreInfos[i].value;
+
+    VkResult res = vk->QueueSubmit(queue, num, infos, fence);
+    pl_free(tmp);
+    return res;
+}
+
+static void trace_cmd(struct vk_ctx *vk, const struct vk_cmd *cmd)
+{
+    PL_TRACE(vk, "Submitting command %p on queue %p (QF %d):",
+             (void *) cmd->buf, (void *) cmd->queue, cmd->pool->qf);
+    for (int n = 0; n < cmd->deps.num; n++) {
+        PL_TRACE(vk, "    waits on semaphore 0x%"PRIx64" = %"PRIu64,
+                 (uint64_t) cmd->deps.elem[n].semaphore, cmd->deps.elem[n].value);
     }
-    for (int i = 0; i < num_cmds; i++)
-        cmds[i] = info2->pCommandBufferInfos[i].commandBuffer;
-
-    const VkTimelineSemaphoreSubmitInfo tinfo = {
-        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
-        .pNext = info2->pNext,
-        .waitSemaphoreValueCount = num_deps,
-        .pWaitSemaphoreValues = depvals,
-        .signalSemaphoreValueCount = num_sigs,
-        .pSignalSemaphoreValues = sigvals,
-    };
+    for (int n = 0; n < cmd->sigs.num; n++) {
+        PL_TRACE(vk, "    signals semaphore 0x%"PRIx64" = %"PRIu64,
+                (uint64_t) cmd->sigs.elem[n].semaphore, cmd->sigs.elem[n].value);
+    }
+    if (cmd->callbacks.num)
+        PL_TRACE(vk, "    signals %d callbacks", cmd->callbacks.num);
+}
 
-    const VkSubmitInfo info = {
-        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .pNext = &tinfo,
-        .waitSemaphoreCount = num_deps,
-        .pWaitSemaphores = deps,
-        .pWaitDstStageMask = masks,
-        .commandBufferCount = num_cmds,
-        .pCommandBuffers = cmds,
-        .signalSemaphoreCount = num_sigs,
-        .pSignalSemaphores = sigs,
-    };
+// Submits all queued commands, merging consecutive commands on the same queue
+// into a single vkQueueSubmit2. Must be called with vk->lock held.
+static bool flush_queued(struct vk_ctx *vk)
+{
+    bool ret = true;
+    const int num_queued = vk->cmds_queued.num;
+    if (!num_queued)
+        return ret;
+
+    void *tmp = pl_tmp(NULL);
+    VkSubmitInfo2 *infos = pl_calloc_ptr(tmp, num_queued, infos);
+    VkCommandBufferSubmitInfo *bufs = pl_calloc_ptr(tmp, num_queued, bufs);
+    bool trace = pl_msg_test(vk->log, PL_LOG_TRACE);
 
-    VkResult res = vk->QueueSubmit(queue, 1, &info, fence);
+    for (int i = 0; i < num_queued; i++) {
+        const struct vk_cmd *cmd = vk->cmds_queued.elem[i];
+        bufs[i] = (VkCommandBufferSubmitInfo) {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+            .commandBuffer = cmd->buf,
+        };
+
+        infos[i] = (VkSubmitInfo2) {
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+            .waitSemaphoreInfoCount = cmd->deps.num,
+            .pWaitSemaphoreInfos = cmd->deps.elem,
+            .signalSemaphoreInfoCount = cmd->sigs.num,
+            .pSignalSemaphoreInfos = cmd->sigs.elem,
+            .commandBufferInfoCount = 1,
+            .pCommandBufferInfos = &bufs[i],
+        };
+
+        if (trace)
+            trace_cmd(vk, cmd);
+    }
+
+    // Only merge consecutive runs, so the submission order stays the same as
+    // the order in which commands were recorded
+    for (int i = 0, num; i < num_queued; i += num) {
+        struct vk_cmd *cmd = vk->cmds_queued.elem[i];
+        struct vk_cmdpool *pool = cmd->pool;
+        num = 1;
+        while (i + num < num_queued && vk->cmds_queued.elem[i + num]->queue == cmd->queue)
+            num++;
+
+        const int qidx = pool->qfirst + cmd->qindex;
+        vk->lock_queue(vk->queue_ctx, pool->qf, qidx);
+        VkResult res = vk_queue_submit2(vk, cmd->queue, num, &infos[i], VK_NULL_HANDLE);
+        vk->unlock_queue(vk->queue_ctx, pool->qf, qidx);
+
+        if (res == VK_SUCCESS) {
+            for (int n = 0; n < num; n++)
+                PL_ARRAY_APPEND(vk->alloc, vk->cmds_pending, vk->cmds_queued.elem[i + n]);
+        } else {
+            PL_ERR(vk, "vkQueueSubmit2: %s", vk_res_str(res));
+            for (int n = 0; n < num; n++) {
+                struct vk_cmd *c = vk->cmds_queued.elem[i + n];
+                vk_cmd_reset(c);
+                PL_ARRAY_APPEND(c->pool, c->pool->cmds, c);
+            }
+            vk->failed = true;
+            ret = false;
+        }
+    }
+
+    vk->cmds_queued.num = 0;
     pl_free(tmp);
-    return res;
+    return ret;
 }
 
-bool vk_cmd_submit(struct vk_cmd **pcmd)
+bool vk_cmd_queue(struct vk_cmd **pcmd)
 {
     struct vk_cmd *cmd = *pcmd;
     if (!cmd)
@@ -468,45 +625,16 @@ bool vk_cmd_submit(struct vk_cmd **pcmd)
     struct vk_cmdpool *pool = cmd->pool;
     struct vk_ctx *vk = pool->vk;
 
+    vk_cmd_flush_barriers(cmd);
     VK(vk->EndCommandBuffer(cmd->buf));
 
-    VkSubmitInfo2 sinfo = {
-        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
-        .waitSemaphoreInfoCount = cmd->deps.num,
-        .pWaitSemaphoreInfos = cmd->deps.elem,
-        .signalSemaphoreInfoCount = cmd->sigs.num,
-        .pSignalSemaphoreInfos = cmd->sigs.elem,
-        .commandBufferInfoCount = 1,
-        .pCommandBufferInfos = &(VkCommandBufferSubmitInfo) {
-            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
-            .commandBuffer = cmd->buf,
-        },
-    };
-
-    if (pl_msg_test(vk->log, PL_LOG_TRACE)) {
-        PL_TRACE(vk, "Submitting command %p on queue %p (QF %d):",
-                 (void *) cmd->buf, (void *) cmd->queue, pool->qf);
-        for (int n = 0; n < cmd->deps.num; n++) {
-            PL_TRACE(vk, "    waits on semaphore 0x%"PRIx64" = %"PRIu64,
-                     (uint64_t) cmd->deps.elem[n].semaphore, cmd->deps.elem[n].value);
-        }
-        for (int n = 0; n < cmd->sigs.num; n++) {
-            PL_TRACE(vk, "    signals semaphore 0x%"PRIx64" = %"PRIu64,
-                    (uint64_t) cmd->sigs.elem[n].semaphore, cmd->sigs.elem[n].value);
-        }
-        if (cmd->callbacks.num)
-            PL_TRACE(vk, "    signals %d callbacks", cmd->callbacks.num);
-    }
-
-    vk->lock_queue(vk->queue_ctx, pool->qf, cmd->qindex);
-    VkResult res = vk_queue_submit2(vk, cmd->queue, &sinfo, VK_NULL_HANDLE);
-    vk->unlock_queue(vk->queue_ctx, pool->qf, cmd->qindex);
-    PL_VK_ASSERT(res, "vkQueueSubmit2");
-
+    bool ret = true;
     pl_mutex_lock(&vk->lock);
-    PL_ARRAY_APPEND(vk->alloc, vk->cmds_pending, cmd);
+    PL_ARRAY_APPEND(vk->alloc, vk->cmds_queued, cmd);
+    if (vk->cmds_queued.num >= MAX_QUEUED_CMDS)
+        ret = flush_queued(vk);
     pl_mutex_unlock(&vk->lock);
-    return true;
+    return ret;
 
 error:
     vk_cmd_reset(cmd);
@@ -517,11 +645,34 @@ error:
     return false;
 }
 
+bool vk_cmd_submit(struct vk_cmd **pcmd)
+{
+    struct vk_cmd *cmd = *pcmd;
+    struct vk_ctx *vk = cmd ? cmd->pool->vk : NULL;
+    PL_TRACE_ZONE(vk ? vk->log : NULL, VK_SUBMIT);
+    bool ret = vk_cmd_queue(pcmd);
+    if (vk)
+        ret &= vk_flush_commands(vk);
+    return ret;
+}
+
+bool vk_flush_commands(struct vk_ctx *vk)
+{
+    pl_mutex_lock(&vk->lock);
+    bool ret = flush_queued(vk);
+    pl_mutex_unlock(&vk->lock);
+    return ret;
+}
+
 bool vk_poll_commands(struct vk_ctx *vk, uint64_t timeout)
 {
     bool ret = false;
     pl_mutex_lock(&vk->lock);
 
+    // Make sure we never block on commands that were never submitted
+    if (timeout)
+        flush_queued(vk);
+
     while (vk->cmds_pending.num) {
         struct vk_cmd *cmd = vk->cmds_pending.elem[0];
         struct vk_cmdpool *pool = cmd->pool;
@@ -554,6 +705,7 @@ bool vk_poll_commands(struct vk_ctx *vk, uint64_t timeout)
 void vk_rotate_queues(struct vk_ctx *vk)
 {
     pl_mutex_lock(&vk->lock);
+    flush_queued(vk);
 
     // Rotate the queues to ensure good parallelism across frames
     for (int i = 0; i < vk->pools.num; i++) {
@@ -38,12 +38,14 @@ void vk_dev_callback(struct vk_ctx *vk, vk_cb callback,
 // Helper wrapper around command buffers that also track dependencies,
 // callbacks and synchronization primitives
 //
-// Thread-safety: Unsafe
+// Thread-safety: Unsafe. However, each vk_cmd owns its VkCommandPool, so
+// different vk_cmds may be recorded concurrently from different threads.
 struct vk_cmd {
     struct vk_cmdpool *pool; // pool it was allocated from
     pl_vulkan_sem sync;      // pending execution, tied to lifetime of device
     VkQueue queue;           // the submission queue (for recording/pending)
     int qindex;              // the index of `queue` in `pool`
+    VkCommandPool cmdpool;   // the pool `buf` was allocated from (owned)
     VkCommandBuffer buf;     // the command buffer itself
     // Command dependencies and signals. Not owned by the vk_cmd.
     PL_ARRAY(VkSemaphoreSubmitInfo) deps;
@@ -51,6 +53,9 @@ struct vk_cmd {
     // "Callbacks" to fire once a command completes. These are used for
     // multiple purposes, ranging from resource deallocation to fencing.
     PL_ARRAY(struct vk_callback) callbacks;
+    // Pipeline barriers pending a `vk_cmd_flush_barriers`
+    PL_ARRAY(VkImageMemoryBarrier2) img_barriers;
+    PL_ARRAY(VkBufferMemoryBarrier2) buf_barriers;
 };
 
 // Associate a callback with the completion of the current command. This
@@ -58,6 +63,19 @@ struct vk_cmd {
 void vk_cmd_callback(struct vk_cmd *cmd, vk_cb callback,
                      const void *priv, const void *arg);
 
+// Track references held by the current command. Returns true (and updates
+// `*ref`) only the first time this is called for a given `ref` during the
+// recording of `cmd`, so that resources used many times within the same
+// command need only a single reference and completion callback.
+static inline bool vk_cmd_ref(const struct vk_cmd *cmd, pl_vulkan_sem *ref)
+{
+    if (ref->sem == cmd->sync.sem && ref->value == cmd->sync.value)
+        return false;
+
+    *ref = cmd->sync;
+    return true;
+}
+
 // Associate a raw dependency for the current command. This semaphore must
 // signal by the corresponding stage before the command may execute.
 void vk_cmd_dep(struct vk_cmd *cmd, VkPipelineStageFlags2 stage, pl_vulkan_sem dep);
@@ -66,9 +84,19 @@ void vk_cmd_dep(struct vk_cmd *cmd, VkPipelineStageFlags2 stage, pl_vulkan_sem d
 // after the given stage completes.
 void vk_cmd_sig(struct vk_cmd *cmd, VkPipelineStageFlags2 stage, pl_vulkan_sem sig);
 
-// Compatibility wrappers for vkCmdPipelineBarrier2 (works with pre-1.3)
+// Compatibility wrappers for vkCmdPipelineBarrier2 (works with pre-1.3).
+// Records the barrier immediately, after any pending barriers.
 void vk_cmd_barrier(struct vk_cmd *cmd, const VkDependencyInfo *info);
 
+// Accumulate a single image or buffer barrier, to be recorded together with
+// all other pending barriers as a single dependency. Pending barriers must be
+// flushed with `vk_cmd_flush_barriers` before recording any command that
+// depends on them. (This is done implicitly by `vk_cmd_barrier` and when the
+// command buffer is ended.)
+void vk_cmd_barrier_img(struct vk_cmd *cmd, const VkImageMemoryBarrier2 *barr);
+void vk_cmd_barrier_buf(struct vk_cmd *cmd, const VkBufferMemoryBarrier2 *barr);
+void vk_cmd_flush_barriers(struct vk_cmd *cmd);
+
 // Synchronization scope
 struct vk_sync_scope {
     pl_vulkan_sem sync;         // semaphore of last access
@@ -96,7 +124,7 @@ struct vk_cmdpool {
     struct vk_ctx *vk;
     VkQueueFamilyProperties props;
     int qf; // queue family index
-    VkCommandPool pool;
+    int qfirst; // index of `queues[0]` within the queue family
     VkQueue *queues;
     int num_queues;
     int idx_queues;
@@ -105,10 +133,11 @@ struct vk_cmdpool {
     PL_ARRAY(struct vk_cmd *) cmds;
 };
 
-// Set up a vk_cmdpool corresponding to a queue family. `qnum` may be less than
-// `props.queueCount`, to restrict the number of queues in this queue family.
-struct vk_cmdpool *vk_cmdpool_create(struct vk_ctx *vk, int qf, int qnum,
-                                     VkQueueFamilyProperties props);
+// Set up a vk_cmdpool corresponding to a queue family, using the queues
+// `qfirst` to `qfirst + qnum - 1`. This may be a subset of `props.queueCount`,
+// to restrict the queues used from this queue family.
+struct vk_cmdpool *vk_cmdpool_create(struct vk_ctx *vk, int qf, int qfirst,
+                                     int qnum, VkQueueFamilyProperties props);
 
 void vk_cmdpool_destroy(struct vk_cmdpool *pool);
 
@@ -116,19 +145,31 @@ void vk_cmdpool_destroy(struct vk_cmdpool *pool);
 // Returns NULL on failure.
 struct vk_cmd *vk_cmd_begin(struct vk_cmdpool *pool, pl_debug_tag debug_tag);
 
-// Finish recording a command buffer and submit it for execution. This function
-// takes over ownership of **cmd, and sets *cmd to NULL in doing so.
+// Finish recording a command buffer and queue it for submission. Queued
+// commands are batched together and submitted by the next call to
+// `vk_flush_commands`, `vk_cmd_submit`, `vk_rotate_queues` or a blocking
+// `vk_poll_commands`. This function takes over ownership of **cmd, and sets
+// *cmd to NULL in doing so.
+bool vk_cmd_queue(struct vk_cmd **cmd);
+
+// Finish recording a command buffer and submit it for execution, together
+// with any previously queued commands. This function takes over ownership of
+// **cmd, and sets *cmd to NULL in doing so.
 bool vk_cmd_submit(struct vk_cmd **cmd);
 
+// Submit all queued commands for execution.
+bool vk_flush_commands(struct vk_ctx *vk);
+
 // Block until some commands complete executing. This is the only function that
 // actually processes the callbacks. Will wait at most `timeout` nanoseconds
 // for the completion of any command. The timeout may also be passed as 0, in
 // which case this function will not block, but only poll for completed
 // commands. Returns whether any forward progress was made.
 //
-// This does *not* flush any queued commands, forgetting to do so may result
-// in infinite loops if waiting for the completion of callbacks that were
-// never flushed!
+// Unless `timeout` is 0, this also flushes commands queued by `vk_cmd_queue`.
+// It does *not* flush the command currently being recorded, forgetting to do
+// so may result in infinite loops if waiting for the completion of callbacks
+// that were never flushed!
 bool vk_poll_commands(struct vk_ctx *vk, uint64_t timeout);
 
 // Rotate through queues in each command pool. Call this once per frame, after
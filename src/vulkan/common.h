@@ -61,6 +61,7 @@ struct vk_ctx {
     VkPhysicalDeviceProperties props;
     VkPhysicalDeviceFeatures2 features;
     uint32_t api_ver; // device API version
+    enum pl_vulkan_spirv_opt spirv_opt;
     VkDevice dev;
     bool imported; // device was not created by us
 
@@ -84,8 +85,14 @@ struct vk_ctx {
     void (*unlock_queue)(void *queue_ctx, uint32_t qf, uint32_t idx);
     void *queue_ctx;
 
+    // Memory budget tracking
+    bool memory_budget; // VK_EXT_memory_budget is enabled
+    pl_vulkan_memory_pressure_cb memory_pressure;
+    void *memory_pressure_priv;
+
     // Pending commands. These are shared for the entire mpvk_ctx to ensure
     // submission and callbacks are FIFO
+    PL_ARRAY(struct vk_cmd *) cmds_queued;  // recorded but not submitted
     PL_ARRAY(struct vk_cmd *) cmds_pending; // submitted but not completed
 
     // Pending callbacks that still need to be drained before processing
@@ -106,6 +113,7 @@ struct vk_ctx {
     PL_VK_FUN(GetPhysicalDeviceFormatProperties2KHR);
     PL_VK_FUN(GetPhysicalDeviceImageFormatProperties2KHR);
     PL_VK_FUN(GetPhysicalDeviceMemoryProperties);
+    PL_VK_FUN(GetPhysicalDeviceMemoryProperties2);
     PL_VK_FUN(GetPhysicalDeviceProperties);
     PL_VK_FUN(GetPhysicalDeviceProperties2);
     PL_VK_FUN(GetPhysicalDeviceQueueFamilyProperties);
@@ -142,7 +150,7 @@ struct vk_ctx {
     PL_VK_FUN(CmdPipelineBarrier);
     PL_VK_FUN(CmdPipelineBarrier2KHR);
     PL_VK_FUN(CmdPushConstants);
-    PL_VK_FUN(CmdPushDescriptorSetKHR);
+    PL_VK_FUN(CmdPushDescriptorSetWithTemplateKHR);
     PL_VK_FUN(CmdResetQueryPool);
     PL_VK_FUN(CmdSetScissor);
     PL_VK_FUN(CmdSetViewport);
@@ -155,6 +163,7 @@ struct vk_ctx {
     PL_VK_FUN(CreateDebugReportCallbackEXT);
     PL_VK_FUN(CreateDescriptorPool);
     PL_VK_FUN(CreateDescriptorSetLayout);
+    PL_VK_FUN(CreateDescriptorUpdateTemplate);
     PL_VK_FUN(CreateFence);
     PL_VK_FUN(CreateFramebuffer);
     PL_VK_FUN(CreateGraphicsPipelines);
@@ -174,6 +183,7 @@ struct vk_ctx {
     PL_VK_FUN(DestroyDebugReportCallbackEXT);
     PL_VK_FUN(DestroyDescriptorPool);
     PL_VK_FUN(DestroyDescriptorSetLayout);
+    PL_VK_FUN(DestroyDescriptorUpdateTemplate);
     PL_VK_FUN(DestroyDevice);
     PL_VK_FUN(DestroyFence);
     PL_VK_FUN(DestroyFramebuffer);
@@ -194,6 +204,7 @@ struct vk_ctx {
     PL_VK_FUN(FlushMappedMemoryRanges);
     PL_VK_FUN(FreeCommandBuffers);
     PL_VK_FUN(FreeMemory);
+    PL_VK_FUN(GetBufferDeviceAddress);
     PL_VK_FUN(GetBufferMemoryRequirements);
     PL_VK_FUN(GetDeviceQueue);
     PL_VK_FUN(GetImageDrmFormatModifierPropertiesEXT);
@@ -202,27 +213,32 @@ struct vk_ctx {
     PL_VK_FUN(GetMemoryFdKHR);
     PL_VK_FUN(GetMemoryFdPropertiesKHR);
     PL_VK_FUN(GetMemoryHostPointerPropertiesEXT);
+    PL_VK_FUN(GetPastPresentationTimingGOOGLE);
     PL_VK_FUN(GetPipelineCacheData);
     PL_VK_FUN(GetQueryPoolResults);
+    PL_VK_FUN(GetRefreshCycleDurationGOOGLE);
     PL_VK_FUN(GetSemaphoreFdKHR);
     PL_VK_FUN(GetSwapchainImagesKHR);
+    PL_VK_FUN(ImportSemaphoreFdKHR);
     PL_VK_FUN(InvalidateMappedMemoryRanges);
     PL_VK_FUN(MapMemory);
     PL_VK_FUN(QueuePresentKHR);
     PL_VK_FUN(QueueSubmit);
     PL_VK_FUN(QueueSubmit2KHR);
     PL_VK_FUN(QueueWaitIdle);
+    PL_VK_FUN(ResetCommandPool);
     PL_VK_FUN(ResetFences);
     PL_VK_FUN(ResetQueryPool);
     PL_VK_FUN(SetDebugUtilsObjectNameEXT);
     PL_VK_FUN(SetHdrMetadataEXT);
-    PL_VK_FUN(UpdateDescriptorSets);
+    PL_VK_FUN(UpdateDescriptorSetWithTemplate);
     PL_VK_FUN(WaitForFences);
     PL_VK_FUN(WaitSemaphores);
 
 #ifdef PL_HAVE_WIN32
     PL_VK_FUN(GetMemoryWin32HandleKHR);
     PL_VK_FUN(GetSemaphoreWin32HandleKHR);
+    PL_VK_FUN(ImportSemaphoreWin32HandleKHR);
 #endif
 
 #ifdef VK_EXT_metal_objects
@@ -231,4 +247,19 @@ struct vk_ctx {
 #ifdef VK_EXT_full_screen_exclusive
     PL_VK_FUN(AcquireFullScreenExclusiveModeEXT);
 #endif
+#ifdef VK_KHR_present_wait
+    PL_VK_FUN(WaitForPresentKHR);
+#endif
+#ifdef VK_EXT_descriptor_buffer
+    PL_VK_FUN(CmdBindDescriptorBuffersEXT);
+    PL_VK_FUN(CmdSetDescriptorBufferOffsetsEXT);
+    PL_VK_FUN(GetDescriptorEXT);
+    PL_VK_FUN(GetDescriptorSetLayoutBindingOffsetEXT);
+    PL_VK_FUN(GetDescriptorSetLayoutSizeEXT);
+#endif
+#ifdef VK_EXT_host_image_copy
+    PL_VK_FUN(CopyImageToMemoryEXT);
+    PL_VK_FUN(CopyMemoryToImageEXT);
+    PL_VK_FUN(TransitionImageLayoutEXT);
+#endif
 };
@@ -72,6 +72,7 @@ static const struct vk_fun vk_inst_funs[] = {
     PL_VK_INST_FUN(GetPhysicalDeviceFormatProperties2KHR),
     PL_VK_INST_FUN(GetPhysicalDeviceImageFormatProperties2KHR),
     PL_VK_INST_FUN(GetPhysicalDeviceMemoryProperties),
+    PL_VK_INST_FUN(GetPhysicalDeviceMemoryProperties2),
     PL_VK_INST_FUN(GetPhysicalDeviceProperties),
     PL_VK_INST_FUN(GetPhysicalDeviceProperties2),
     PL_VK_INST_FUN(GetPhysicalDeviceQueueFamilyProperties),
@@ -103,7 +104,7 @@ static const struct vk_ext vk_device_extensions[] = {
     }, {
         .name = VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME,
         .funs = (const struct vk_fun[]) {
-            PL_VK_DEV_FUN(CmdPushDescriptorSetKHR),
+            PL_VK_DEV_FUN(CmdPushDescriptorSetWithTemplateKHR),
             {0}
         },
     }, {
@@ -136,6 +137,7 @@ static const struct vk_ext vk_device_extensions[] = {
         .name = VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME,
         .funs = (const struct vk_fun[]) {
             PL_VK_DEV_FUN(GetSemaphoreFdKHR),
+            PL_VK_DEV_FUN(ImportSemaphoreFdKHR),
             {0}
         },
 #ifdef PL_HAVE_WIN32
@@ -143,17 +145,41 @@ static const struct vk_ext vk_device_extensions[] = {
         .name = VK_KHR_EXTERNAL_SEMAPHORE_WIN32_EXTENSION_NAME,
         .funs = (const struct vk_fun[]) {
             PL_VK_DEV_FUN(GetSemaphoreWin32HandleKHR),
+            PL_VK_DEV_FUN(ImportSemaphoreWin32HandleKHR),
             {0}
         },
 #endif
     }, {
         .name = VK_EXT_PCI_BUS_INFO_EXTENSION_NAME,
+    }, {
+        .name = VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
     }, {
         .name = VK_EXT_HDR_METADATA_EXTENSION_NAME,
         .funs = (const struct vk_fun[]) {
             PL_VK_DEV_FUN(SetHdrMetadataEXT),
             {0}
         },
+    }, {
+        .name = VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME,
+    }, {
+        .name = VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME,
+        .funs = (const struct vk_fun[]) {
+            PL_VK_DEV_FUN(GetPastPresentationTimingGOOGLE),
+            PL_VK_DEV_FUN(GetRefreshCycleDurationGOOGLE),
+            {0}
+        },
+#ifdef VK_KHR_present_id
+    }, {
+        .name = VK_KHR_PRESENT_ID_EXTENSION_NAME,
+#endif
+#ifdef VK_KHR_present_wait
+    }, {
+        .name = VK_KHR_PRESENT_WAIT_EXTENSION_NAME,
+        .funs = (const struct vk_fun[]) {
+            PL_VK_DEV_FUN(WaitForPresentKHR),
+            {0}
+        },
+#endif
     }, {
         .name = VK_EXT_IMAGE_DRM_FORMAT_MODIFIER_EXTENSION_NAME,
         .funs = (const struct vk_fun[]) {
@@ -179,6 +205,34 @@ static const struct vk_ext vk_device_extensions[] = {
             PL_VK_DEV_FUN(AcquireFullScreenExclusiveModeEXT),
             {0}
         },
+#endif
+#ifdef VK_EXT_graphics_pipeline_library
+    }, {
+        .name = VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME,
+    }, {
+        .name = VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME,
+#endif
+#ifdef VK_EXT_descriptor_buffer
+    }, {
+        .name = VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME,
+        .funs = (const struct vk_fun[]) {
+            PL_VK_DEV_FUN(CmdBindDescriptorBuffersEXT),
+            PL_VK_DEV_FUN(CmdSetDescriptorBufferOffsetsEXT),
+            PL_VK_DEV_FUN(GetDescriptorEXT),
+            PL_VK_DEV_FUN(GetDescriptorSetLayoutBindingOffsetEXT),
+            PL_VK_DEV_FUN(GetDescriptorSetLayoutSizeEXT),
+            {0}
+        },
+#endif
+#ifdef VK_EXT_host_image_copy
+    }, {
+        .name = VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME,
+        .funs = (const struct vk_fun[]) {
+            PL_VK_DEV_FUN(CopyImageToMemoryEXT),
+            PL_VK_DEV_FUN(CopyMemoryToImageEXT),
+            PL_VK_DEV_FUN(TransitionImageLayoutEXT),
+            {0}
+        },
 #endif
     }, {
         .name = VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME,
@@ -202,7 +256,16 @@ const char * const pl_vulkan_recommended_extensions[] = {
     VK_KHR_EXTERNAL_SEMAPHORE_WIN32_EXTENSION_NAME,
 #endif
     VK_EXT_PCI_BUS_INFO_EXTENSION_NAME,
+    VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
     VK_EXT_HDR_METADATA_EXTENSION_NAME,
+    VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME,
+    VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME,
+#ifdef VK_KHR_present_id
+    VK_KHR_PRESENT_ID_EXTENSION_NAME,
+#endif
+#ifdef VK_KHR_present_wait
+    VK_KHR_PRESENT_WAIT_EXTENSION_NAME,
+#endif
     VK_EXT_IMAGE_DRM_FORMAT_MODIFIER_EXTENSION_NAME,
 #ifdef VK_KHR_portability_subset
     VK_KHR_PORTABILITY_SUBSET_EXTENSION_NAME,
@@ -212,6 +275,16 @@ const char * const pl_vulkan_recommended_extensions[] = {
 #endif
 #ifdef VK_EXT_full_screen_exclusive
     VK_EXT_FULL_SCREEN_EXCLUSIVE_EXTENSION_NAME,
+#endif
+#ifdef VK_EXT_graphics_pipeline_library
+    VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME,
+    VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME,
+#endif
+#ifdef VK_EXT_descriptor_buffer
+    VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME,
+#endif
+#ifdef VK_EXT_host_image_copy
+    VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME,
 #endif
     VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME,
 };
@@ -287,6 +360,16 @@ const VkPhysicalDeviceFeatures2 pl_vulkan_required_features = {
     .pNext = (void *) &required_vk11,
 };
 
+static bool has_extension(const char * const *exts, int num_exts, const char *name)
+{
+    for (int i = 0; i < num_exts; i++) {
+        if (strcmp(exts[i], name) == 0)
+            return true;
+    }
+
+    return false;
+}
+
 static bool check_required_features(struct vk_ctx *vk)
 {
     #define CHECK_FEATURE(maj, min, feat) do {                                  \
@@ -348,6 +431,7 @@ static const struct vk_fun vk_dev_funs[] = {
     PL_VK_DEV_FUN(CreateComputePipelines),
     PL_VK_DEV_FUN(CreateDescriptorPool),
     PL_VK_DEV_FUN(CreateDescriptorSetLayout),
+    PL_VK_DEV_FUN(CreateDescriptorUpdateTemplate),
     PL_VK_DEV_FUN(CreateFence),
     PL_VK_DEV_FUN(CreateFramebuffer),
     PL_VK_DEV_FUN(CreateGraphicsPipelines),
@@ -365,6 +449,7 @@ static const struct vk_fun vk_dev_funs[] = {
     PL_VK_DEV_FUN(DestroyCommandPool),
     PL_VK_DEV_FUN(DestroyDescriptorPool),
     PL_VK_DEV_FUN(DestroyDescriptorSetLayout),
+    PL_VK_DEV_FUN(DestroyDescriptorUpdateTemplate),
     PL_VK_DEV_FUN(DestroyDevice),
     PL_VK_DEV_FUN(DestroyFence),
     PL_VK_DEV_FUN(DestroyFramebuffer),
@@ -384,6 +469,7 @@ static const struct vk_fun vk_dev_funs[] = {
     PL_VK_DEV_FUN(FlushMappedMemoryRanges),
     PL_VK_DEV_FUN(FreeCommandBuffers),
     PL_VK_DEV_FUN(FreeMemory),
+    PL_VK_DEV_FUN(GetBufferDeviceAddress),
     PL_VK_DEV_FUN(GetBufferMemoryRequirements),
     PL_VK_DEV_FUN(GetDeviceQueue),
     PL_VK_DEV_FUN(GetImageMemoryRequirements2),
@@ -394,10 +480,11 @@ static const struct vk_fun vk_dev_funs[] = {
     PL_VK_DEV_FUN(MapMemory),
     PL_VK_DEV_FUN(QueueSubmit),
     PL_VK_DEV_FUN(QueueWaitIdle),
+    PL_VK_DEV_FUN(ResetCommandPool),
     PL_VK_DEV_FUN(ResetFences),
     PL_VK_DEV_FUN(ResetQueryPool),
     PL_VK_DEV_FUN(SetDebugUtilsObjectNameEXT),
-    PL_VK_DEV_FUN(UpdateDescriptorSets),
+    PL_VK_DEV_FUN(UpdateDescriptorSetWithTemplate),
     PL_VK_DEV_FUN(WaitForFences),
     PL_VK_DEV_FUN(WaitSemaphores),
 };
@@ -1229,6 +1316,25 @@ static bool device_init(struct vk_ctx *vk, const struct pl_vulkan_params *params
         }
     }
 
+    // Request the global queue priority, if supported
+    VkDeviceQueueGlobalPriorityCreateInfoEXT qprio = {
+        .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_GLOBAL_PRIORITY_CREATE_INFO_EXT,
+    };
+
+    if (params->global_priority) {
+        for (int n = 0; n < num_exts_avail; n++) {
+            const char *ext = VK_EXT_GLOBAL_PRIORITY_EXTENSION_NAME;
+            if (strcmp(ext, exts_avail[n].extensionName) == 0) {
+                PL_ARRAY_APPEND(vk->alloc, vk->exts, ext);
+                qprio.globalPriority = params->global_priority;
+                break;
+            }
+        }
+
+        if (!qprio.globalPriority)
+            PL_WARN(vk, "Global queue priority requested, but not supported!");
+    }
+
     VkPhysicalDeviceFeatures2 features = {
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR
     };
@@ -1237,6 +1343,51 @@ static bool device_init(struct vk_ctx *vk, const struct pl_vulkan_params *params
     vk_features_normalize(tmp, &pl_vulkan_recommended_features, vk->api_ver, &features);
     vk_features_normalize(tmp, params->features, vk->api_ver, &features);
 
+#ifdef VK_KHR_present_wait
+    // The features of non-core extensions may only be chained if the
+    // extension is actually enabled
+    if (has_extension(vk->exts.elem, vk->exts.num, VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+        has_extension(vk->exts.elem, vk->exts.num, VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+    {
+        VkPhysicalDevicePresentIdFeaturesKHR *present_id;
+        present_id = vk_chain_alloc(tmp, &features,
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR);
+        present_id->presentId = true;
+
+        VkPhysicalDevicePresentWaitFeaturesKHR *present_wait;
+        present_wait = vk_chain_alloc(tmp, &features,
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR);
+        present_wait->presentWait = true;
+    }
+#endif
+
+#ifdef VK_EXT_graphics_pipeline_library
+    if (has_extension(vk->exts.elem, vk->exts.num, VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME)) {
+        VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT *gpl;
+        gpl = vk_chain_alloc(tmp, &features,
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT);
+        gpl->graphicsPipelineLibrary = true;
+    }
+#endif
+
+#ifdef VK_EXT_descriptor_buffer
+    if (has_extension(vk->exts.elem, vk->exts.num, VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME)) {
+        VkPhysicalDeviceDescriptorBufferFeaturesEXT *descbuf;
+        descbuf = vk_chain_alloc(tmp, &features,
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT);
+        descbuf->descriptorBuffer = true;
+    }
+#endif
+
+#ifdef VK_EXT_host_image_copy
+    if (has_extension(vk->exts.elem, vk->exts.num, VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME)) {
+        VkPhysicalDeviceHostImageCopyFeaturesEXT *host_copy;
+        host_copy = vk_chain_alloc(tmp, &features,
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT);
+        host_copy->hostImageCopy = true;
+    }
+#endif
+
     // Explicitly clear the features struct before querying feature support
     // from the driver. This way, we don't mistakenly mark as supported
     // features coming from structs the driver doesn't have support for.
@@ -1276,6 +1427,7 @@ static bool device_init(struct vk_ctx *vk, const struct pl_vulkan_params *params
             continue;
         PL_ARRAY_APPEND(tmp, qinfos, (VkDeviceQueueCreateInfo) {
             .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .pNext = qprio.globalPriority ? &qprio : NULL,
             .queueFamilyIndex = i,
             .queueCount = qfs[i].queueCount,
             .pQueuePriorities = pl_calloc(tmp, qfs[i].queueCount, sizeof(float)),
@@ -1296,7 +1448,16 @@ static bool device_init(struct vk_ctx *vk, const struct pl_vulkan_params *params
         PL_INFO(vk, "    %s", vk->exts.elem[i]);
 
     start = pl_clock_now();
-    VK(vk->CreateDevice(vk->physd, &dinfo, PL_VK_ALLOC, &vk->dev));
+    VkResult res = vk->CreateDevice(vk->physd, &dinfo, PL_VK_ALLOC, &vk->dev);
+    if (res == VK_ERROR_NOT_PERMITTED_EXT && qprio.globalPriority) {
+        // Elevated priorities may require privileges we don't have
+        PL_WARN(vk, "Not permitted to use global queue priority %d, falling "
+                "back to the default priority", (int) qprio.globalPriority);
+        for (int i = 0; i < qinfos.num; i++)
+            qinfos.elem[i].pNext = NULL;
+        res = vk->CreateDevice(vk->physd, &dinfo, PL_VK_ALLOC, &vk->dev);
+    }
+    PL_VK_ASSERT(res, "vkCreateDevice");
     pl_log_cpu_time(vk->log, start, pl_clock_now(), "creating vulkan device");
 
     // Load all mandatory device-level functions
@@ -1319,7 +1480,7 @@ static bool device_init(struct vk_ctx *vk, const struct pl_vulkan_params *params
             qnum = qmax;
         }
 
-        struct vk_cmdpool *pool = vk_cmdpool_create(vk, i, qnum, qfs[i]);
+        struct vk_cmdpool *pool = vk_cmdpool_create(vk, i, 0, qnum, qfs[i]);
         if (!pool)
             goto error;
         PL_ARRAY_APPEND(vk->alloc, vk->pools, pool);
@@ -1435,6 +1596,8 @@ pl_vulkan pl_vulkan_create(pl_log log, const struct pl_vulkan_params *params)
         .log = log,
         .inst = params->instance,
         .GetInstanceProcAddr = get_proc_addr_fallback(log, params->get_proc_addr),
+        .memory_pressure = params->memory_pressure,
+        .memory_pressure_priv = params->memory_pressure_priv,
     };
 
     pl_mutex_init_type(&vk->lock, PL_MUTEX_RECURSIVE);
@@ -1521,6 +1684,9 @@ pl_vulkan pl_vulkan_create(pl_log log, const struct pl_vulkan_params *params)
     if (!device_init(vk, params))
         goto error;
 
+    vk->memory_budget = has_extension(vk->exts.elem, vk->exts.num,
+                                      VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    vk->spirv_opt = params->spirv_opt;
     if (!finalize_context(pl_vk, params->max_glsl_version))
         goto error;
 
@@ -1550,6 +1716,8 @@ pl_vulkan pl_vulkan_import(pl_log log, const struct pl_vulkan_import_params *par
         .lock_queue = params->lock_queue,
         .unlock_queue = params->unlock_queue,
         .queue_ctx = params->queue_ctx,
+        .memory_pressure = params->memory_pressure,
+        .memory_pressure_priv = params->memory_pressure_priv,
     };
 
     pl_mutex_init_type(&vk->lock, PL_MUTEX_RECURSIVE);
@@ -1662,6 +1830,12 @@ pl_vulkan pl_vulkan_import(pl_log log, const struct pl_vulkan_import_params *par
 
         // API sanity check
         pl_assert(qfs[qf].queueFlags & qinfos[i].flags);
+        const int qlast = params->first_queue + qinfos[i].info->count - 1;
+        if (params->first_queue < 0 || qlast >= qfs[qf].queueCount) {
+            PL_ERR(vk, "Queues %d to %d requested, but QF %d only has %d queues!",
+                   params->first_queue, qlast, qf, (int) qfs[qf].queueCount);
+            goto error;
+        }
 
         // See if we already created a pool for this queue family
         for (int j = 0; j < i; j++) {
@@ -1671,7 +1845,8 @@ pl_vulkan pl_vulkan_import(pl_log log, const struct pl_vulkan_import_params *par
             }
         }
 
-        *pool = vk_cmdpool_create(vk, qf, qinfos[i].info->count, qfs[qf]);
+        *pool = vk_cmdpool_create(vk, qf, params->first_queue,
+                                  qinfos[i].info->count, qfs[qf]);
         if (!*pool)
             goto error;
         PL_ARRAY_APPEND(vk->alloc, vk->pools, *pool);
@@ -1690,6 +1865,9 @@ next_qf: ;
         goto error;
     }
 
+    vk->memory_budget = has_extension(params->extensions, params->num_extensions,
+                                      VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    vk->spirv_opt = params->spirv_opt;
     if (!finalize_context(pl_vk, params->max_glsl_version))
         goto error;
 
@@ -20,6 +20,7 @@
 #include "glsl/spirv.h"
 
 #ifdef PL_HAVE_UNIX
+#include <errno.h>
 #include <unistd.h>
 #endif
 
@@ -162,7 +163,7 @@ struct vk_cmd *_begin_cmd(pl_gpu gpu, enum queue_type type, const char *label,
     }
 
     if (!p->cmd || p->cmd->pool != pool) {
-        vk_cmd_submit(&p->cmd);
+        vk_cmd_queue(&p->cmd);
         p->cmd = vk_cmd_begin(pool, label);
         if (!p->cmd) {
             pl_mutex_unlock(&p->recording);
@@ -188,7 +189,15 @@ static void timer_end_cb(void *ptimer, void *pindex)
     timer->pending &= ~timer_bit(index);
 }
 
-bool _end_cmd(pl_gpu gpu, struct vk_cmd **pcmd, bool submit)
+static bool end_recording(struct pl_vk *p, bool flush)
+{
+    bool ret = vk_cmd_queue(&p->cmd);
+    if (flush)
+        ret &= vk_flush_commands(p->vk);
+    return ret;
+}
+
+bool _end_cmd(pl_gpu gpu, struct vk_cmd **pcmd, bool submit, bool flush)
 {
     struct pl_vk *p = PL_PRIV(gpu);
     struct vk_ctx *vk = p->vk;
@@ -196,7 +205,7 @@ bool _end_cmd(pl_gpu gpu, struct vk_cmd **pcmd, bool submit)
     if (!pcmd) {
         if (submit) {
             pl_mutex_lock(&p->recording);
-            ret = vk_cmd_submit(&p->cmd);
+            ret = end_recording(p, flush);
             pl_mutex_unlock(&p->recording);
         }
         return ret;
@@ -227,7 +236,7 @@ bool _end_cmd(pl_gpu gpu, struct vk_cmd **pcmd, bool submit)
         vk->CmdEndDebugUtilsLabelEXT(cmd->buf);
 
     if (submit)
-        ret = vk_cmd_submit(&p->cmd);
+        ret = end_recording(p, flush);
 
     pl_mutex_unlock(&p->recording);
     return ret;
@@ -260,6 +269,10 @@ static void vk_gpu_destroy(pl_gpu gpu)
             vk->DestroySampler(vk->dev, p->samplers[s][a], PL_VK_ALLOC);
     }
 
+    for (int i = 0; i < p->modules.num; i++)
+        vk->DestroyShaderModule(vk->dev, p->modules.elem[i].module, PL_VK_ALLOC);
+    pl_mutex_destroy(&p->modules_lock);
+
     pl_spirv_destroy(&p->spirv);
     pl_mutex_destroy(&p->recording);
     pl_free((void *) gpu);
@@ -276,7 +289,18 @@ pl_vulkan pl_vulkan_get(pl_gpu gpu)
     return NULL;
 }
 
-static pl_handle_caps vk_sync_handle_caps(struct vk_ctx *vk)
+int pl_vulkan_get_memory_budget(pl_gpu gpu,
+                                struct pl_vulkan_heap_budget out[VK_MAX_MEMORY_HEAPS])
+{
+    pl_vulkan vulkan = pl_vulkan_get(gpu);
+    if (!vulkan)
+        return 0;
+
+    struct vk_ctx *vk = PL_PRIV(vulkan);
+    return vk_malloc_query_budget(vk->ma, out);
+}
+
+static pl_handle_caps vk_sync_handle_caps(struct vk_ctx *vk, bool import)
 {
     pl_handle_caps caps = 0;
 
@@ -294,9 +318,11 @@ static pl_handle_caps vk_sync_handle_caps(struct vk_ctx *vk)
 
         vk->GetPhysicalDeviceExternalSemaphoreProperties(vk->physd, &info, &props);
         VkExternalSemaphoreFeatureFlags flags = props.externalSemaphoreFeatures;
-        if ((props.compatibleHandleTypes & info.handleType) &&
-            (flags & VK_EXTERNAL_SEMAPHORE_FEATURE_EXPORTABLE_BIT_KHR))
-        {
+        VkExternalSemaphoreFeatureFlags req = import
+            ? VK_EXTERNAL_SEMAPHORE_FEATURE_IMPORTABLE_BIT_KHR
+            : VK_EXTERNAL_SEMAPHORE_FEATURE_EXPORTABLE_BIT_KHR;
+
+        if ((props.compatibleHandleTypes & info.handleType) && (flags & req)) {
             caps |= type;
         }
     }
@@ -415,12 +441,27 @@ pl_gpu pl_gpu_create_vk(struct vk_ctx *vk)
 
     struct pl_vk *p = PL_PRIV(gpu);
     pl_mutex_init(&p->recording);
+    pl_mutex_init(&p->modules_lock);
     p->vk = vk;
     p->impl = pl_fns_vk;
     p->spirv = pl_spirv_create(vk->log, get_spirv_version(vk));
     if (!p->spirv)
         goto error;
 
+    // A single worker is enough to overlap vertex and fragment shader
+    // compilation; wider parallelism comes from the callers themselves (e.g.
+    // `pl_dispatch_precompile_begin`), which share in-flight jobs
+    pl_spirv_set_threads(p->spirv, 1);
+
+    static const enum pl_spirv_opt spirv_opts[] = {
+        [PL_VULKAN_SPIRV_OPT_NONE]          = PL_SPIRV_OPT_NONE,
+        [PL_VULKAN_SPIRV_OPT_PERFORMANCE]   = PL_SPIRV_OPT_PERF,
+        [PL_VULKAN_SPIRV_OPT_SIZE]          = PL_SPIRV_OPT_SIZE,
+    };
+
+    pl_assert(vk->spirv_opt < PL_ARRAY_SIZE(spirv_opts));
+    pl_spirv_set_opt(p->spirv, spirv_opts[vk->spirv_opt]);
+
     // Query all device properties
     VkPhysicalDevicePCIBusInfoPropertiesEXT pci_props = {
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PCI_BUS_INFO_PROPERTIES_EXT,
@@ -468,9 +509,63 @@ pl_gpu pl_gpu_create_vk(struct vk_ctx *vk)
     }
 #endif
 
+#ifdef VK_EXT_graphics_pipeline_library
+    VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT gpl_props = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT,
+    };
+
+    const VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT *gpl;
+    gpl = vk_find_struct(&vk->features,
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT);
+    if (gpl && gpl->graphicsPipelineLibrary)
+        vk_link_struct(&props, &gpl_props);
+#endif
+
+#ifdef VK_EXT_descriptor_buffer
+    VkPhysicalDeviceDescriptorBufferPropertiesEXT descbuf_props = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT,
+    };
+
+    const VkPhysicalDeviceDescriptorBufferFeaturesEXT *descbuf;
+    const VkPhysicalDeviceVulkan12Features *vk12;
+    descbuf = vk_find_struct(&vk->features,
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT);
+    vk12 = vk_find_struct(&vk->features,
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES);
+    if (descbuf && descbuf->descriptorBuffer && vk12 && vk12->bufferDeviceAddress) {
+        vk_link_struct(&props, &descbuf_props);
+        p->has_descbuf = true;
+    }
+#endif
+
+#ifdef VK_EXT_host_image_copy
+    const VkPhysicalDeviceHostImageCopyFeaturesEXT *host_copy;
+    host_copy = vk_find_struct(&vk->features,
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT);
+    p->has_host_copy = host_copy && host_copy->hostImageCopy;
+#endif
+
     vk->GetPhysicalDeviceProperties2(vk->physd, &props);
     VkPhysicalDeviceLimits limits = props.properties.limits;
 
+#ifdef VK_EXT_graphics_pipeline_library
+    // Without fast linking, there is no benefit over monolithic pipelines
+    p->has_gpl = gpl && gpl->graphicsPipelineLibrary &&
+                 gpl_props.graphicsPipelineLibraryFastLinking;
+#endif
+
+#ifdef VK_EXT_descriptor_buffer
+    if (p->has_descbuf) {
+        p->descbuf_align = descbuf_props.descriptorBufferOffsetAlignment;
+        p->desc_size[PL_DESC_SAMPLED_TEX] = descbuf_props.combinedImageSamplerDescriptorSize;
+        p->desc_size[PL_DESC_STORAGE_IMG] = descbuf_props.storageImageDescriptorSize;
+        p->desc_size[PL_DESC_BUF_UNIFORM] = descbuf_props.uniformBufferDescriptorSize;
+        p->desc_size[PL_DESC_BUF_STORAGE] = descbuf_props.storageBufferDescriptorSize;
+        p->desc_size[PL_DESC_BUF_TEXEL_UNIFORM] = descbuf_props.uniformTexelBufferDescriptorSize;
+        p->desc_size[PL_DESC_BUF_TEXEL_STORAGE] = descbuf_props.storageTexelBufferDescriptorSize;
+    }
+#endif
+
     // Determine GLSL features and limits
     gpu->glsl = (struct pl_glsl_version) {
         .version = 450,
@@ -549,8 +644,16 @@ pl_gpu pl_gpu_create_vk(struct vk_ctx *vk)
     gpu->import_caps.buf = vk_malloc_handle_caps(vk->ma, true);
     gpu->export_caps.tex = vk_tex_handle_caps(vk, false);
     gpu->import_caps.tex = vk_tex_handle_caps(vk, true);
-    gpu->export_caps.sync = vk_sync_handle_caps(vk);
-    gpu->import_caps.sync = 0; // Not supported yet
+    gpu->export_caps.sync = vk_sync_handle_caps(vk, false);
+    gpu->import_caps.sync = 0;
+    if (vk->ImportSemaphoreFdKHR)
+        gpu->import_caps.sync |= vk_sync_handle_caps(vk, true) & PL_HANDLE_FD;
+#ifdef PL_HAVE_WIN32
+    if (vk->ImportSemaphoreWin32HandleKHR) {
+        gpu->import_caps.sync |= vk_sync_handle_caps(vk, true) &
+                                 (PL_HANDLE_WIN32 | PL_HANDLE_WIN32_KMT);
+    }
+#endif
 
     if (pl_gpu_supports_interop(gpu)) {
         pl_static_assert(sizeof(gpu->uuid) == VK_UUID_SIZE);
@@ -562,7 +665,7 @@ pl_gpu pl_gpu_create_vk(struct vk_ctx *vk)
         gpu->pci.function = pci_props.pciFunction;
     }
 
-    if (vk->CmdPushDescriptorSetKHR)
+    if (vk->CmdPushDescriptorSetWithTemplateKHR)
         p->max_push_descriptors = pushd_props.maxPushDescriptors;
 
     vk_setup_formats(gpu);
@@ -752,12 +855,20 @@ VkSemaphore pl_vulkan_sem_create(pl_gpu gpu, const struct pl_vulkan_sem_params *
     struct vk_ctx *vk = p->vk;
 
     pl_assert(PL_ISPOT(params->export_handle));
+    pl_assert(PL_ISPOT(params->import_handle));
+    pl_assert(!params->export_handle || !params->import_handle);
     if ((params->export_handle & gpu->export_caps.sync) != params->export_handle) {
         PL_ERR(gpu, "Invalid handle type 0x%"PRIx64" specified for "
                "`pl_vulkan_sem_create`!", (uint64_t) params->export_handle);
         return VK_NULL_HANDLE;
     }
 
+    if ((params->import_handle & gpu->import_caps.sync) != params->import_handle) {
+        PL_ERR(gpu, "Invalid import handle type 0x%"PRIx64" specified for "
+               "`pl_vulkan_sem_create`!", (uint64_t) params->import_handle);
+        return VK_NULL_HANDLE;
+    }
+
     switch (params->export_handle) {
     case PL_HANDLE_FD:
         params->out_handle->fd = -1;
@@ -804,6 +915,27 @@ VkSemaphore pl_vulkan_sem_create(pl_gpu gpu, const struct pl_vulkan_sem_params *
 
         VK(vk->GetSemaphoreFdKHR(vk->dev, &finfo, &params->out_handle->fd));
     }
+
+    if (params->import_handle == PL_HANDLE_FD) {
+        // Vulkan takes over ownership of the fd on success, so import a copy
+        VkImportSemaphoreFdInfoKHR iinfo = {
+            .sType = VK_STRUCTURE_TYPE_IMPORT_SEMAPHORE_FD_INFO_KHR,
+            .semaphore = sem,
+            .handleType = vk_sync_handle_type(params->import_handle),
+            .fd = dup(params->import.fd),
+        };
+
+        if (iinfo.fd < 0) {
+            PL_ERR(gpu, "Failed to dup() fd (%d) when importing semaphore: %s",
+                   params->import.fd, strerror(errno));
+            goto error;
+        }
+
+        VkResult res = vk->ImportSemaphoreFdKHR(vk->dev, &iinfo);
+        if (res != VK_SUCCESS)
+            close(iinfo.fd);
+        PL_VK_ASSERT(res, "vkImportSemaphoreFdKHR");
+    }
 #endif
 
 #ifdef PL_HAVE_WIN32
@@ -819,6 +951,19 @@ VkSemaphore pl_vulkan_sem_create(pl_gpu gpu, const struct pl_vulkan_sem_params *
         VK(vk->GetSemaphoreWin32HandleKHR(vk->dev, &handle_info,
                                           &params->out_handle->handle));
     }
+
+    if (params->import_handle == PL_HANDLE_WIN32 ||
+        params->import_handle == PL_HANDLE_WIN32_KMT)
+    {
+        VkImportSemaphoreWin32HandleInfoKHR iinfo = {
+            .sType = VK_STRUCTURE_TYPE_IMPORT_SEMAPHORE_WIN32_HANDLE_INFO_KHR,
+            .semaphore = sem,
+            .handleType = vk_sync_handle_type(params->import_handle),
+            .handle = params->import.handle,
+        };
+
+        VK(vk->ImportSemaphoreWin32HandleKHR(vk->dev, &iinfo));
+    }
 #endif
 
     return sem;
@@ -51,6 +51,16 @@ enum queue_type {
     ANY,
 };
 
+// Shader module shared between all passes with identical shader stages
+struct vk_shader_module {
+    uint64_t key;           // hash of the GLSL source and shader stage
+    uint64_t spirv_hash;    // hash of the compiled SPIR-V
+    size_t spirv_size;
+    VkShaderModule module;
+    int refs;               // number of passes currently holding `module`
+    uint64_t last_used;
+};
+
 struct pl_vk {
     struct pl_gpu_fns impl;
     struct vk_ctx *vk;
@@ -59,6 +69,15 @@ struct pl_vk {
     // Some additional cached device limits and features checks
     uint32_t max_push_descriptors;
     size_t min_texel_alignment;
+    bool has_gpl; // VK_EXT_graphics_pipeline_library with fast linking
+
+    // VK_EXT_descriptor_buffer, if enabled
+    bool has_descbuf;
+    size_t descbuf_align;
+    size_t desc_size[PL_DESC_TYPE_COUNT];
+
+    // VK_EXT_host_image_copy, if enabled
+    bool has_host_copy;
 
     // The "currently recording" command. This will be queued and replaced by
     // a new command every time we need to "switch" between queue families.
@@ -69,17 +88,23 @@ struct pl_vk {
     // Array of VkSamplers for every combination of sample/address modes
     VkSampler samplers[PL_TEX_SAMPLE_MODE_COUNT][PL_TEX_ADDRESS_MODE_COUNT];
 
+    // Cache of shader modules, shared between passes
+    pl_mutex modules_lock;
+    PL_ARRAY(struct vk_shader_module) modules;
+    uint64_t modules_age;
+
     // To avoid spamming warnings
     bool warned_modless;
 };
 
 struct vk_cmd *_begin_cmd(pl_gpu, enum queue_type, const char *label, pl_timer);
-bool _end_cmd(pl_gpu, struct vk_cmd **, bool submit);
+bool _end_cmd(pl_gpu, struct vk_cmd **, bool submit, bool flush);
 
 #define CMD_BEGIN(type)              _begin_cmd(gpu, type, __func__, NULL)
 #define CMD_BEGIN_TIMED(type, timer) _begin_cmd(gpu, type, __func__, timer)
-#define CMD_FINISH(cmd) _end_cmd(gpu, cmd, false)
-#define CMD_SUBMIT(cmd) _end_cmd(gpu, cmd, true)
+#define CMD_FINISH(cmd) _end_cmd(gpu, cmd, false, false)
+#define CMD_QUEUE(cmd)  _end_cmd(gpu, cmd, true, false)
+#define CMD_SUBMIT(cmd) _end_cmd(gpu, cmd, true, true)
 
 // Helper to fire a callback the next time the `pl_gpu` is in an idle state
 //
@@ -95,6 +120,7 @@ struct pl_tex_vk {
     VkImageType type;
     VkImage img;
     VkImageAspectFlags aspect;
+    uint32_t layer; // array layer, for wrapped layered images
     struct vk_memslice mem;
     // cached properties
     VkFormat img_fmt;
@@ -105,12 +131,15 @@ struct pl_tex_vk {
     VkFramebuffer framebuffer;
     // for vk_tex_upload/download fallback code
     pl_fmt texel_fmt;
+    // created with VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT
+    bool host_copy;
     // for planar textures (as a convenience)
     int num_planes;
     struct pl_tex_vk *planes[4];
 
     // synchronization and current state (planes only)
     struct vk_sem sem;
+    pl_vulkan_sem ref; // last command holding a reference, see `vk_cmd_ref`
     VkImageLayout layout;
     PL_ARRAY(pl_vulkan_sem) ext_deps; // external semaphore, not owned by the pl_tex
     pl_sync ext_sync; // indicates an exported image
@@ -136,9 +165,11 @@ struct pl_buf_vk {
     struct vk_memslice mem;
     enum queue_type update_queue;
     VkBufferView view; // for texel buffers
+    VkDeviceAddress addr; // for descriptor buffers, includes `mem.offset`
 
     // synchronization and current state
     struct vk_sem sem;
+    pl_vulkan_sem ref; // last command holding a reference, see `vk_cmd_ref`
     bool exported;
     bool needs_flush;
 };
@@ -16,6 +16,7 @@
  */
 
 #include "gpu.h"
+#include "pl_thread_pool.h"
 
 void vk_buf_barrier(pl_gpu gpu, struct vk_cmd *cmd, pl_buf buf,
                     VkPipelineStageFlags2 stage, VkAccessFlags2 access,
@@ -25,7 +26,10 @@ void vk_buf_barrier(pl_gpu gpu, struct vk_cmd *cmd, pl_buf buf,
     struct vk_ctx *vk = p->vk;
     struct pl_buf_vk *buf_vk = PL_PRIV(buf);
     pl_assert(!export || !buf_vk->exported); // can't re-export exported buffers
-    pl_rc_ref(&buf_vk->rc);
+    if (vk_cmd_ref(cmd, &buf_vk->ref)) {
+        pl_rc_ref(&buf_vk->rc);
+        vk_cmd_callback(cmd, (vk_cb) vk_buf_deref, gpu, buf);
+    }
 
     bool needs_flush = buf_vk->needs_flush || buf->params.host_mapped ||
                        buf->params.import_handle == PL_HANDLE_HOST_PTR;
@@ -53,27 +57,22 @@ void vk_buf_barrier(pl_gpu gpu, struct vk_cmd *cmd, pl_buf buf,
     uint32_t dst_qf = export ? VK_QUEUE_FAMILY_EXTERNAL_KHR : qf;
 
     if (last.access || src_qf != dst_qf) {
-        vk_cmd_barrier(cmd, &(VkDependencyInfo) {
-            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
-            .bufferMemoryBarrierCount = 1,
-            .pBufferMemoryBarriers = &(VkBufferMemoryBarrier2) {
-                .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
-                .srcStageMask = last.stage,
-                .srcAccessMask = last.access,
-                .dstStageMask = stage,
-                .dstAccessMask = access,
-                .srcQueueFamilyIndex = src_qf,
-                .dstQueueFamilyIndex = dst_qf,
-                .buffer = buf_vk->mem.buf,
-                .offset = buf_vk->mem.offset + offset,
-                .size = size,
-            },
+        vk_cmd_barrier_buf(cmd, &(VkBufferMemoryBarrier2) {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+            .srcStageMask = last.stage,
+            .srcAccessMask = last.access,
+            .dstStageMask = stage,
+            .dstAccessMask = access,
+            .srcQueueFamilyIndex = src_qf,
+            .dstQueueFamilyIndex = dst_qf,
+            .buffer = buf_vk->mem.buf,
+            .offset = buf_vk->mem.offset + offset,
+            .size = size,
         });
     }
 
     buf_vk->needs_flush = false;
     buf_vk->exported = export;
-    vk_cmd_callback(cmd, (vk_cb) vk_buf_deref, gpu, buf);
 }
 
 void vk_buf_deref(pl_gpu gpu, pl_buf buf)
@@ -156,6 +155,10 @@ pl_buf vk_buf_create(pl_gpu gpu, const struct pl_buf_params *params)
         *align = pl_lcm(*align, params->format->texel_size);
     }
 
+    // Descriptor buffers reference buffers by their device address
+    if (p->has_descbuf && (params->uniform || params->storable))
+        mparams.buf_usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+
     if (params->drawable) {
         mparams.buf_usage |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
                              VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
@@ -221,6 +224,14 @@ pl_buf vk_buf_create(pl_gpu gpu, const struct pl_buf_params *params)
     if (params->host_mapped)
         buf->data = buf_vk->mem.data;
 
+    if (mparams.buf_usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) {
+        buf_vk->addr = vk->GetBufferDeviceAddress(vk->dev, &(VkBufferDeviceAddressInfo) {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+            .buffer = buf_vk->mem.buf,
+        });
+        buf_vk->addr += buf_vk->mem.offset;
+    }
+
     if (params->export_handle) {
         buf->shared_mem = buf_vk->mem.shared_mem;
         buf->shared_mem.drm_format_mod = DRM_FORMAT_MOD_LINEAR;
@@ -344,7 +355,7 @@ void vk_buf_write(pl_gpu gpu, pl_buf buf, size_t offset,
             ; // do nothing
 
         uintptr_t addr = (uintptr_t) buf_vk->mem.data + offset;
-        memcpy((void *) addr, data, size);
+        pl_parallel_memcpy((void *) addr, data, size);
         buf_vk->needs_flush = true;
     } else {
         struct vk_cmd *cmd = CMD_BEGIN(buf_vk->update_queue);
@@ -369,6 +380,7 @@ void vk_buf_write(pl_gpu gpu, pl_buf buf, size_t offset,
                      "instead!");
         }
 
+        vk_cmd_flush_barriers(cmd);
         for (size_t xfer = 0; xfer < size_base; xfer += max_transfer) {
             vk->CmdUpdateBuffer(cmd->buf, buf_vk->mem.buf,
                                 buf_offset + xfer,
@@ -409,7 +421,7 @@ bool vk_buf_read(pl_gpu gpu, pl_buf buf, size_t offset, void *dest, size_t size)
     }
 
     uintptr_t addr = (uintptr_t) buf_vk->mem.data + (size_t) offset;
-    memcpy(dest, (void *) addr, size);
+    pl_parallel_memcpy(dest, (void *) addr, size);
     return true;
 
 error:
@@ -441,6 +453,7 @@ void vk_buf_copy(pl_gpu gpu, pl_buf dst, size_t dst_offset,
         .size = size,
     };
 
+    vk_cmd_flush_barriers(cmd);
     vk->CmdCopyBuffer(cmd->buf, src_vk->mem.buf, dst_vk->mem.buf,
                       1, &region);
 
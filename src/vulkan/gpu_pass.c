@@ -19,34 +19,70 @@
 #include "cache.h"
 #include "glsl/spirv.h"
 
+// Number of previously used specializations to keep pipelines around for
+#define NUM_SPEC_VARIANTS 4
+
+struct vk_spec_variant {
+    uint64_t hash; // hash of the specialization constant data
+    VkPipeline pipe;
+};
+
+// Descriptor data for a single binding, as referenced by `dsTemplate`
+union vk_desc_info {
+    VkDescriptorImageInfo image;
+    VkDescriptorBufferInfo buffer;
+    VkBufferView view;
+};
+
 // For pl_pass.priv
 struct pl_pass_vk {
     // Pipeline / render pass
     VkPipeline base;
     VkPipeline pipe;
     VkPipelineLayout pipeLayout;
+    VkPipelineCreateFlags pipeFlags;
     VkRenderPass renderPass;
     // Descriptor set (bindings)
     bool use_pushd;
+    bool use_descbuf;
     VkDescriptorSetLayout dsLayout;
     VkDescriptorPool dsPool;
+    VkDescriptorUpdateTemplate dsTemplate;
     // To keep track of which descriptor sets are and aren't available, we
-    // allocate a fixed number and use a bitmask of all available sets.
+    // allocate a fixed number and use a bitmask of all available sets. When
+    // using descriptor buffers, these are slots in `dbmem` instead.
     VkDescriptorSet dss[16];
     uint16_t dmask;
+    // Descriptor buffer (VK_EXT_descriptor_buffer)
+    struct vk_memslice dbmem;
+    VkDeviceAddress dbaddr; // base address of `dbmem.buf`
+    VkDeviceSize dbsize; // size of each slot
+    VkDeviceSize *dboffsets; // offset of each binding within a slot
 
     // For recompilation
     VkVertexInputAttributeDescription *attrs;
     VkPipelineCache cache;
+    uint64_t cache_key;
+    float cache_cost;
     VkShaderModule vert;
     VkShaderModule shader;
 
     // For updating
-    VkWriteDescriptorSet *dswrite;
-    VkDescriptorImageInfo *dsiinfo;
-    VkDescriptorBufferInfo *dsbinfo;
+    union vk_desc_info *dsinfo;
     VkSpecializationInfo specInfo;
     size_t spec_size;
+    uint64_t spec_hash; // hash of `specInfo.pData` (current pipeline)
+    uint64_t base_hash; // specialization of `base`, or 0 if unspecialized
+
+    // Pipelines for previously used specializations, most recent first
+    struct vk_spec_variant variants[NUM_SPEC_VARIANTS];
+
+    // Graphics pipeline library parts, for fast re-specialization (if used):
+    // vertex input, pre-rasterization shaders, fragment output
+    VkPipeline libs[3];
+    VkPipeline pending_lib; // fragment shader library waiting for `lto`
+    uint64_t pending_hash;
+    struct vk_lto_job *lto;
 };
 
 int vk_desc_namespace(pl_gpu gpu, enum pl_desc_type type)
@@ -54,21 +90,32 @@ int vk_desc_namespace(pl_gpu gpu, enum pl_desc_type type)
     return 0;
 }
 
+static void lto_finish(pl_gpu gpu, pl_pass pass, bool discard);
+static void module_release(pl_gpu gpu, VkShaderModule module);
+
 static void pass_destroy_cb(pl_gpu gpu, pl_pass pass)
 {
     struct pl_vk *p = PL_PRIV(gpu);
     struct vk_ctx *vk = p->vk;
     struct pl_pass_vk *pass_vk = PL_PRIV(pass);
 
+    lto_finish(gpu, pass, true);
+    for (int i = 0; i < PL_ARRAY_SIZE(pass_vk->libs); i++)
+        vk->DestroyPipeline(vk->dev, pass_vk->libs[i], PL_VK_ALLOC);
+    vk->DestroyPipeline(vk->dev, pass_vk->pending_lib, PL_VK_ALLOC);
     vk->DestroyPipeline(vk->dev, pass_vk->pipe, PL_VK_ALLOC);
     vk->DestroyPipeline(vk->dev, pass_vk->base, PL_VK_ALLOC);
+    for (int i = 0; i < NUM_SPEC_VARIANTS; i++)
+        vk->DestroyPipeline(vk->dev, pass_vk->variants[i].pipe, PL_VK_ALLOC);
     vk->DestroyRenderPass(vk->dev, pass_vk->renderPass, PL_VK_ALLOC);
     vk->DestroyPipelineLayout(vk->dev, pass_vk->pipeLayout, PL_VK_ALLOC);
     vk->DestroyPipelineCache(vk->dev, pass_vk->cache, PL_VK_ALLOC);
+    vk->DestroyDescriptorUpdateTemplate(vk->dev, pass_vk->dsTemplate, PL_VK_ALLOC);
     vk->DestroyDescriptorPool(vk->dev, pass_vk->dsPool, PL_VK_ALLOC);
     vk->DestroyDescriptorSetLayout(vk->dev, pass_vk->dsLayout, PL_VK_ALLOC);
-    vk->DestroyShaderModule(vk->dev, pass_vk->vert, PL_VK_ALLOC);
-    vk->DestroyShaderModule(vk->dev, pass_vk->shader, PL_VK_ALLOC);
+    vk_malloc_free(vk->ma, &pass_vk->dbmem);
+    module_release(gpu, pass_vk->vert);
+    module_release(gpu, pass_vk->shader);
 
     pl_free((void *) pass);
 }
@@ -87,44 +134,283 @@ static const VkDescriptorType dsType[] = {
     [PL_DESC_BUF_TEXEL_STORAGE] = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER,
 };
 
-static VkResult vk_compile_glsl(pl_gpu gpu, void *alloc,
-                                enum glsl_shader_stage stage,
-                                const char *shader,
-                                pl_cache_obj *out_spirv)
+// In-progress GLSL -> SPIR-V compilation
+struct vk_compile {
+    pl_cache_obj obj;
+    pl_spirv_job job; // NULL if `obj` was found in the cache
+    pl_clock_t start;
+};
+
+// Shader stage of a pass being created
+struct vk_stage {
+    enum glsl_shader_stage type;
+    const char *glsl;
+    VkShaderModule *out;
+    const char *name;
+    int idx; // index into the pipeline cache key hashes
+
+    struct vk_shader_module mod;
+    struct vk_compile compile;
+    pl_cache_obj spirv;
+};
+
+// Looks up the shader in the cache, or submits it for compilation otherwise.
+// Must always be followed by a call to `vk_compile_end`.
+static void vk_compile_begin(pl_gpu gpu, enum glsl_shader_stage stage,
+                             const char *shader, struct vk_compile *out)
 {
     struct pl_vk *p = PL_PRIV(gpu);
     pl_cache cache = pl_gpu_cache(gpu);
-    uint64_t key = CACHE_KEY_SPIRV;
     if (cache) { // skip computing key if `cache
-        pl_hash_merge(&key, p->spirv->signature);
-        pl_hash_merge(&key, pl_str0_hash(shader));
-        out_spirv->key = key;
-        if (pl_cache_get(cache, out_spirv)) {
-            PL_DEBUG(gpu, "Re-using cached SPIR-V object 0x%"PRIx64, key);
-            return VK_SUCCESS;
+        out->obj.key = pl_spirv_cache_key(p->spirv, shader);
+        if (pl_cache_get(cache, &out->obj)) {
+            PL_DEBUG(gpu, "Re-using cached SPIR-V object 0x%"PRIx64, out->obj.key);
+            return;
         }
     }
 
-    pl_clock_t start = pl_clock_now();
-    pl_str spirv = pl_spirv_compile_glsl(p->spirv, alloc, gpu->glsl, stage, shader);
-    pl_log_cpu_time(gpu->log, start, pl_clock_now(), "translating SPIR-V");
+    out->start = pl_clock_now();
+    out->job = pl_spirv_compile_async(p->spirv, gpu->glsl, stage, shader);
+}
+
+static VkResult vk_compile_end(pl_gpu gpu, void *alloc, struct vk_compile *c,
+                               pl_cache_obj *out_spirv)
+{
+    struct pl_vk *p = PL_PRIV(gpu);
+    *out_spirv = c->obj;
+    if (!c->job)
+        return VK_SUCCESS;
+
+    pl_str spirv = pl_spirv_job_wait(p->spirv, &c->job, alloc);
+    pl_log_cpu_time(gpu->log, c->start, pl_clock_now(), "translating SPIR-V");
     out_spirv->data = spirv.buf;
     out_spirv->size = spirv.len;
     out_spirv->free = pl_free;
     return spirv.len ? VK_SUCCESS : VK_ERROR_INITIALIZATION_FAILED;
 }
 
+// Maximum number of shader modules kept around while not used by any pass
+#define MAX_IDLE_MODULES 64
+
+static uint64_t module_key(pl_gpu gpu, enum glsl_shader_stage stage,
+                           const char *shader)
+{
+    struct pl_vk *p = PL_PRIV(gpu);
+    uint64_t key = pl_spirv_cache_key(p->spirv, shader);
+    pl_hash_merge(&key, stage);
+    return key;
+}
+
+// Looks up a previously created shader module for the GLSL source with the
+// given `key`, and takes a reference to it if found
+static struct vk_shader_module module_acquire(pl_gpu gpu, uint64_t key)
+{
+    struct pl_vk *p = PL_PRIV(gpu);
+    struct vk_shader_module ret = {0};
+    pl_mutex_lock(&p->modules_lock);
+    for (int i = 0; i < p->modules.num; i++) {
+        struct vk_shader_module *mod = &p->modules.elem[i];
+        if (mod->key == key) {
+            mod->refs++;
+            ret = *mod;
+            break;
+        }
+    }
+    pl_mutex_unlock(&p->modules_lock);
+    return ret;
+}
+
+// Registers a newly created shader module, taking over ownership of it. If
+// a module with identical SPIR-V already exists, `mod->module` is destroyed
+// and replaced by the existing one. Returns a reference to the module.
+static VkShaderModule module_insert(pl_gpu gpu, struct vk_shader_module *mod)
+{
+    struct pl_vk *p = PL_PRIV(gpu);
+    struct vk_ctx *vk = p->vk;
+    pl_mutex_lock(&p->modules_lock);
+    for (int i = 0; i < p->modules.num; i++) {
+        struct vk_shader_module *other = &p->modules.elem[i];
+        if (other->spirv_hash == mod->spirv_hash && other->spirv_size == mod->spirv_size) {
+            vk->DestroyShaderModule(vk->dev, mod->module, PL_VK_ALLOC);
+            mod->module = other->module;
+            other->refs++;
+            goto done;
+        }
+    }
+
+    mod->refs = 1;
+    PL_ARRAY_APPEND(gpu, p->modules, *mod);
+
+done:
+    pl_mutex_unlock(&p->modules_lock);
+    return mod->module;
+}
+
+// Releases a reference to a shader module, evicting the least recently used
+// unreferenced modules in excess of `MAX_IDLE_MODULES`
+static void module_release(pl_gpu gpu, VkShaderModule module)
+{
+    struct pl_vk *p = PL_PRIV(gpu);
+    struct vk_ctx *vk = p->vk;
+    if (!module)
+        return;
+
+    pl_mutex_lock(&p->modules_lock);
+    int num_idle = 0, oldest = -1;
+    for (int i = 0; i < p->modules.num; i++) {
+        struct vk_shader_module *mod = &p->modules.elem[i];
+        if (mod->module == module) {
+            pl_assert(mod->refs > 0);
+            mod->refs--;
+            mod->last_used = ++p->modules_age;
+        }
+        if (mod->refs)
+            continue;
+        num_idle++;
+        if (oldest < 0 || mod->last_used < p->modules.elem[oldest].last_used)
+            oldest = i;
+    }
+
+    if (num_idle > MAX_IDLE_MODULES) {
+        vk->DestroyShaderModule(vk->dev, p->modules.elem[oldest].module, PL_VK_ALLOC);
+        PL_ARRAY_REMOVE_AT(p->modules, oldest);
+    }
+    pl_mutex_unlock(&p->modules_lock);
+}
+
 static const VkShaderStageFlags stageFlags[] = {
     [PL_PASS_RASTER]  = VK_SHADER_STAGE_FRAGMENT_BIT |
                         VK_SHADER_STAGE_VERTEX_BIT,
     [PL_PASS_COMPUTE] = VK_SHADER_STAGE_COMPUTE_BIT,
 };
 
+static const VkPipelineBindPoint bindPoint[] = {
+    [PL_PASS_RASTER]  = VK_PIPELINE_BIND_POINT_GRAPHICS,
+    [PL_PASS_COMPUTE] = VK_PIPELINE_BIND_POINT_COMPUTE,
+};
+
 static void destroy_pipeline(struct vk_ctx *vk, void *pipeline)
 {
     vk->DestroyPipeline(vk->dev, vk_unwrap_handle(pipeline), PL_VK_ALLOC);
 }
 
+// Fixed-function state of a raster pass, shared between monolithic pipelines
+// and pipeline libraries
+struct raster_state {
+    VkPipelineShaderStageCreateInfo stages[2];
+    VkVertexInputBindingDescription binding;
+    VkPipelineVertexInputStateCreateInfo vertex;
+    VkPipelineInputAssemblyStateCreateInfo assembly;
+    VkPipelineViewportStateCreateInfo viewport;
+    VkPipelineRasterizationStateCreateInfo raster;
+    VkPipelineMultisampleStateCreateInfo multisample;
+    VkPipelineColorBlendAttachmentState blend_att;
+    VkPipelineColorBlendStateCreateInfo blend;
+    VkDynamicState dyn_states[2];
+    VkPipelineDynamicStateCreateInfo dynamic;
+};
+
+static void get_raster_state(pl_pass pass, struct raster_state *st)
+{
+    struct pl_pass_vk *pass_vk = PL_PRIV(pass);
+    const struct pl_pass_params *params = &pass->params;
+
+    static const VkBlendFactor blendFactors[] = {
+        [PL_BLEND_ZERO]                = VK_BLEND_FACTOR_ZERO,
+        [PL_BLEND_ONE]                 = VK_BLEND_FACTOR_ONE,
+        [PL_BLEND_SRC_ALPHA]           = VK_BLEND_FACTOR_SRC_ALPHA,
+        [PL_BLEND_ONE_MINUS_SRC_ALPHA] = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+    };
+
+    static const VkPrimitiveTopology topologies[PL_PRIM_TYPE_COUNT] = {
+        [PL_PRIM_TRIANGLE_LIST]  = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+        [PL_PRIM_TRIANGLE_STRIP] = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP,
+    };
+
+    const VkSpecializationInfo *specInfo = &pass_vk->specInfo;
+    if (!specInfo->dataSize)
+        specInfo = NULL;
+
+    *st = (struct raster_state) {
+        .stages = {
+            {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                .stage = VK_SHADER_STAGE_VERTEX_BIT,
+                .module = pass_vk->vert,
+                .pName = "main",
+            }, {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+                .module = pass_vk->shader,
+                .pName = "main",
+                .pSpecializationInfo = specInfo,
+            }
+        },
+        .binding = {
+            .binding = 0,
+            .stride = params->vertex_stride,
+            .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+        },
+        .vertex = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+            .vertexBindingDescriptionCount = 1,
+            .pVertexBindingDescriptions = &st->binding,
+            .vertexAttributeDescriptionCount = params->num_vertex_attribs,
+            .pVertexAttributeDescriptions = pass_vk->attrs,
+        },
+        .assembly = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+            .topology = topologies[params->vertex_type],
+        },
+        .viewport = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+            .viewportCount = 1,
+            .scissorCount = 1,
+        },
+        .raster = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+            .polygonMode = VK_POLYGON_MODE_FILL,
+            .cullMode = VK_CULL_MODE_NONE,
+            .lineWidth = 1.0f,
+        },
+        .multisample = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+            .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
+        },
+        .blend_att = {
+            .colorBlendOp = VK_BLEND_OP_ADD,
+            .alphaBlendOp = VK_BLEND_OP_ADD,
+            .colorWriteMask = VK_COLOR_COMPONENT_R_BIT |
+                              VK_COLOR_COMPONENT_G_BIT |
+                              VK_COLOR_COMPONENT_B_BIT |
+                              VK_COLOR_COMPONENT_A_BIT,
+        },
+        .blend = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+            .attachmentCount = 1,
+            .pAttachments = &st->blend_att,
+        },
+        .dyn_states = {
+            VK_DYNAMIC_STATE_VIEWPORT,
+            VK_DYNAMIC_STATE_SCISSOR,
+        },
+        .dynamic = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+            .dynamicStateCount = PL_ARRAY_SIZE(st->dyn_states),
+            .pDynamicStates = st->dyn_states,
+        },
+    };
+
+    const struct pl_blend_params *blend = params->blend_params;
+    if (blend) {
+        st->blend_att.blendEnable = true;
+        st->blend_att.srcColorBlendFactor = blendFactors[blend->src_rgb];
+        st->blend_att.dstColorBlendFactor = blendFactors[blend->dst_rgb];
+        st->blend_att.srcAlphaBlendFactor = blendFactors[blend->src_alpha];
+        st->blend_att.dstAlphaBlendFactor = blendFactors[blend->dst_alpha];
+    }
+}
+
 static VkResult vk_recreate_pipelines(struct vk_ctx *vk, pl_pass pass,
                                       bool derivable, VkPipeline base,
                                       VkPipeline *out_pipe)
@@ -141,7 +427,7 @@ static VkResult vk_recreate_pipelines(struct vk_ctx *vk, pl_pass pass,
         *out_pipe = VK_NULL_HANDLE;
     }
 
-    VkPipelineCreateFlags flags = 0;
+    VkPipelineCreateFlags flags = pass_vk->pipeFlags;
     if (derivable)
         flags |= VK_PIPELINE_CREATE_ALLOW_DERIVATIVES_BIT;
     if (base)
@@ -153,97 +439,21 @@ static VkResult vk_recreate_pipelines(struct vk_ctx *vk, pl_pass pass,
 
     switch (params->type) {
     case PL_PASS_RASTER: {
-        static const VkBlendFactor blendFactors[] = {
-            [PL_BLEND_ZERO]                = VK_BLEND_FACTOR_ZERO,
-            [PL_BLEND_ONE]                 = VK_BLEND_FACTOR_ONE,
-            [PL_BLEND_SRC_ALPHA]           = VK_BLEND_FACTOR_SRC_ALPHA,
-            [PL_BLEND_ONE_MINUS_SRC_ALPHA] = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
-        };
-
-        VkPipelineColorBlendAttachmentState blendState = {
-            .colorBlendOp = VK_BLEND_OP_ADD,
-            .alphaBlendOp = VK_BLEND_OP_ADD,
-            .colorWriteMask = VK_COLOR_COMPONENT_R_BIT |
-                              VK_COLOR_COMPONENT_G_BIT |
-                              VK_COLOR_COMPONENT_B_BIT |
-                              VK_COLOR_COMPONENT_A_BIT,
-        };
-
-        const struct pl_blend_params *blend = params->blend_params;
-        if (blend) {
-            blendState.blendEnable = true;
-            blendState.srcColorBlendFactor = blendFactors[blend->src_rgb];
-            blendState.dstColorBlendFactor = blendFactors[blend->dst_rgb];
-            blendState.srcAlphaBlendFactor = blendFactors[blend->src_alpha];
-            blendState.dstAlphaBlendFactor = blendFactors[blend->dst_alpha];
-        }
-
-        static const VkPrimitiveTopology topologies[PL_PRIM_TYPE_COUNT] = {
-            [PL_PRIM_TRIANGLE_LIST]  = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
-            [PL_PRIM_TRIANGLE_STRIP] = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP,
-        };
+        struct raster_state st;
+        get_raster_state(pass, &st);
 
         VkGraphicsPipelineCreateInfo cinfo = {
             .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
             .flags = flags,
-            .stageCount = 2,
-            .pStages = (VkPipelineShaderStageCreateInfo[]) {
-                {
-                    .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-                    .stage = VK_SHADER_STAGE_VERTEX_BIT,
-                    .module = pass_vk->vert,
-                    .pName = "main",
-                }, {
-                    .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-                    .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
-                    .module = pass_vk->shader,
-                    .pName = "main",
-                    .pSpecializationInfo = specInfo,
-                }
-            },
-            .pVertexInputState = &(VkPipelineVertexInputStateCreateInfo) {
-                .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
-                .vertexBindingDescriptionCount = 1,
-                .pVertexBindingDescriptions = &(VkVertexInputBindingDescription) {
-                    .binding = 0,
-                    .stride = params->vertex_stride,
-                    .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
-                },
-                .vertexAttributeDescriptionCount = params->num_vertex_attribs,
-                .pVertexAttributeDescriptions = pass_vk->attrs,
-            },
-            .pInputAssemblyState = &(VkPipelineInputAssemblyStateCreateInfo) {
-                .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
-                .topology = topologies[params->vertex_type],
-            },
-            .pViewportState = &(VkPipelineViewportStateCreateInfo) {
-                .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
-                .viewportCount = 1,
-                .scissorCount = 1,
-            },
-            .pRasterizationState = &(VkPipelineRasterizationStateCreateInfo) {
-                .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
-                .polygonMode = VK_POLYGON_MODE_FILL,
-                .cullMode = VK_CULL_MODE_NONE,
-                .lineWidth = 1.0f,
-            },
-            .pMultisampleState = &(VkPipelineMultisampleStateCreateInfo) {
-                .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
-                .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
-            },
-            .pColorBlendState = &(VkPipelineColorBlendStateCreateInfo) {
-                .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
-                .attachmentCount = 1,
-                .pAttachments = &blendState,
-            },
-            .pDynamicState = &(VkPipelineDynamicStateCreateInfo) {
-                .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
-                .dynamicStateCount = 2,
-                .pDynamicStates = (VkDynamicState[]){
-                    VK_DYNAMIC_STATE_VIEWPORT,
-                    VK_DYNAMIC_STATE_SCISSOR,
-                },
-            },
+            .stageCount = PL_ARRAY_SIZE(st.stages),
+            .pStages = st.stages,
+            .pVertexInputState = &st.vertex,
+            .pInputAssemblyState = &st.assembly,
+            .pViewportState = &st.viewport,
+            .pRasterizationState = &st.raster,
+            .pMultisampleState = &st.multisample,
+            .pColorBlendState = &st.blend,
+            .pDynamicState = &st.dynamic,
             .layout = pass_vk->pipeLayout,
             .renderPass = pass_vk->renderPass,
             .basePipelineHandle = base,
@@ -282,6 +492,377 @@ static VkResult vk_recreate_pipelines(struct vk_ctx *vk, pl_pass pass,
     pl_unreachable();
 }
 
+// Writes the contents of the pass's VkPipelineCache back to the `pl_cache`,
+// so pipelines created after the initial compilation (e.g. additional
+// specializations) are persisted as well
+static void save_pipecache(pl_gpu gpu, pl_pass pass)
+{
+    struct pl_vk *p = PL_PRIV(gpu);
+    struct vk_ctx *vk = p->vk;
+    struct pl_pass_vk *pass_vk = PL_PRIV(pass);
+    const pl_cache cache = pl_gpu_cache(gpu);
+    if (!cache || !pass_vk->cache || !pass_vk->cache_key)
+        return;
+
+    pl_cache_obj obj = {
+        .key = pass_vk->cache_key,
+        .cost = pass_vk->cache_cost,
+    };
+
+    size_t size = 0;
+    VK(vk->GetPipelineCacheData(vk->dev, pass_vk->cache, &size, NULL));
+    pl_cache_obj_resize(NULL, &obj, size);
+    VK(vk->GetPipelineCacheData(vk->dev, pass_vk->cache, &size, obj.data));
+    obj.size = size;
+    pl_cache_steal(cache, &obj);
+    return;
+
+error:
+    pl_cache_obj_free(&obj);
+}
+
+#ifdef VK_EXT_graphics_pipeline_library
+
+// Returns the pipeline slot holding the given specialization, if any
+static VkPipeline *find_pipe(pl_pass pass, uint64_t spec_hash)
+{
+    struct pl_pass_vk *pass_vk = PL_PRIV(pass);
+    if (pass_vk->pipe && pass_vk->spec_hash == spec_hash)
+        return &pass_vk->pipe;
+
+    for (int i = 0; i < NUM_SPEC_VARIANTS; i++) {
+        struct vk_spec_variant *var = &pass_vk->variants[i];
+        if (var->pipe && var->hash == spec_hash)
+            return &var->pipe;
+    }
+
+    return NULL;
+}
+
+// Background link-time optimization of a fast-linked pipeline
+struct vk_lto_job {
+    pl_thread thread;
+    struct vk_ctx *vk;
+    pl_pass pass;
+    VkPipeline frag_lib; // owned by the job
+    uint64_t spec_hash;
+    VkPipeline pipe;
+    VkResult res;
+    atomic_bool done;
+};
+
+static VkResult create_library(struct vk_ctx *vk, pl_pass pass,
+                               VkGraphicsPipelineLibraryFlagsEXT part,
+                               VkPipeline *out_lib)
+{
+    struct pl_pass_vk *pass_vk = PL_PRIV(pass);
+    struct raster_state st;
+    get_raster_state(pass, &st);
+
+    VkGraphicsPipelineCreateInfo cinfo = {
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .pNext = &(VkGraphicsPipelineLibraryCreateInfoEXT) {
+            .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT,
+            .flags = part,
+        },
+        .flags = pass_vk->pipeFlags | VK_PIPELINE_CREATE_LIBRARY_BIT_KHR |
+                 VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT,
+        .layout = pass_vk->pipeLayout,
+        .renderPass = pass_vk->renderPass,
+    };
+
+    switch (part) {
+    case VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT:
+        cinfo.pVertexInputState = &st.vertex;
+        cinfo.pInputAssemblyState = &st.assembly;
+        break;
+    case VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT:
+        cinfo.stageCount = 1;
+        cinfo.pStages = &st.stages[0];
+        cinfo.pViewportState = &st.viewport;
+        cinfo.pRasterizationState = &st.raster;
+        cinfo.pDynamicState = &st.dynamic;
+        break;
+    case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT:
+        cinfo.stageCount = 1;
+        cinfo.pStages = &st.stages[1];
+        cinfo.pMultisampleState = &st.multisample;
+        break;
+    case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT:
+        cinfo.pMultisampleState = &st.multisample;
+        cinfo.pColorBlendState = &st.blend;
+        break;
+    default: pl_unreachable();
+    }
+
+    return vk->CreateGraphicsPipelines(vk->dev, pass_vk->cache, 1, &cinfo,
+                                       PL_VK_ALLOC, out_lib);
+}
+
+// Links the shared libraries with the given fragment shader library into a
+// complete pipeline. Without `optimize`, this is (very) fast.
+static VkResult link_pipeline(struct vk_ctx *vk, pl_pass pass,
+                              VkPipeline frag_lib, bool optimize,
+                              VkPipeline *out_pipe)
+{
+    struct pl_pass_vk *pass_vk = PL_PRIV(pass);
+    const VkPipeline libs[] = {
+        pass_vk->libs[0], pass_vk->libs[1], frag_lib, pass_vk->libs[2],
+    };
+
+    VkGraphicsPipelineCreateInfo cinfo = {
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .pNext = &(VkPipelineLibraryCreateInfoKHR) {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR,
+            .libraryCount = PL_ARRAY_SIZE(libs),
+            .pLibraries = libs,
+        },
+        .flags = pass_vk->pipeFlags |
+                 (optimize ? VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT : 0),
+        .layout = pass_vk->pipeLayout,
+        .renderPass = pass_vk->renderPass,
+    };
+
+    return vk->CreateGraphicsPipelines(vk->dev, pass_vk->cache, 1, &cinfo,
+                                       PL_VK_ALLOC, out_pipe);
+}
+
+static PL_THREAD_VOID lto_worker(void *arg)
+{
+    struct vk_lto_job *job = arg;
+    job->res = link_pipeline(job->vk, job->pass, job->frag_lib, true, &job->pipe);
+    atomic_store(&job->done, true);
+    PL_THREAD_RETURN();
+}
+
+static void lto_start(pl_gpu gpu, pl_pass pass, VkPipeline frag_lib,
+                      uint64_t spec_hash)
+{
+    struct pl_vk *p = PL_PRIV(gpu);
+    struct vk_ctx *vk = p->vk;
+    struct pl_pass_vk *pass_vk = PL_PRIV(pass);
+    pl_assert(!pass_vk->lto);
+
+    struct vk_lto_job *job = pl_alloc_ptr(NULL, job);
+    *job = (struct vk_lto_job) {
+        .vk = vk,
+        .pass = pass,
+        .frag_lib = frag_lib,
+        .spec_hash = spec_hash,
+    };
+
+    atomic_init(&job->done, false);
+    if (pl_thread_create(&job->thread, lto_worker, job) != 0) {
+        // Just keep using the fast-linked pipeline
+        vk->DestroyPipeline(vk->dev, frag_lib, PL_VK_ALLOC);
+        pl_free(job);
+        return;
+    }
+
+    pass_vk->lto = job;
+}
+
+// Collects the result of the background optimization job, if finished. With
+// `discard`, blocks until the job is done and throws away the result.
+static void lto_finish(pl_gpu gpu, pl_pass pass, bool discard)
+{
+    struct pl_vk *p = PL_PRIV(gpu);
+    struct vk_ctx *vk = p->vk;
+    struct pl_pass_vk *pass_vk = PL_PRIV(pass);
+    struct vk_lto_job *job = pass_vk->lto;
+    if (!job || (!discard && !atomic_load(&job->done)))
+        return;
+
+    pl_thread_join(job->thread);
+    pass_vk->lto = NULL;
+    vk->DestroyPipeline(vk->dev, job->frag_lib, PL_VK_ALLOC);
+
+    VkPipeline *slot = discard ? NULL : find_pipe(pass, job->spec_hash);
+    if (job->res != VK_SUCCESS) {
+        PL_DEBUG(vk, "Failed optimizing pipeline: %s", vk_res_str(job->res));
+    } else if (!slot) {
+        // Result is outdated, the specialization was evicted in the meantime
+        vk->DestroyPipeline(vk->dev, job->pipe, PL_VK_ALLOC);
+    } else {
+        vk_dev_callback(vk, (vk_cb) destroy_pipeline, vk, vk_wrap_handle(*slot));
+        *slot = job->pipe;
+        save_pipecache(gpu, pass);
+    }
+
+    pl_free(job);
+
+    if (pass_vk->pending_lib && !discard) {
+        lto_start(gpu, pass, pass_vk->pending_lib, pass_vk->pending_hash);
+        pass_vk->pending_lib = VK_NULL_HANDLE;
+    }
+}
+
+static VkResult vk_create_libraries(struct vk_ctx *vk, pl_pass pass)
+{
+    struct pl_pass_vk *pass_vk = PL_PRIV(pass);
+    static const VkGraphicsPipelineLibraryFlagsEXT parts[] = {
+        VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT,
+        VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+        VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT,
+    };
+
+    static_assert(PL_ARRAY_SIZE(parts) == PL_ARRAY_SIZE(pass_vk->libs), "");
+    for (int i = 0; i < PL_ARRAY_SIZE(parts); i++) {
+        VkResult res = create_library(vk, pass, parts[i], &pass_vk->libs[i]);
+        if (res != VK_SUCCESS)
+            return res;
+    }
+
+    return VK_SUCCESS;
+}
+
+// (Re-)specializes a pass using pipeline libraries: only the fragment shader
+// is recompiled, followed by a fast link. The fully optimized pipeline is
+// then generated on a background thread and swapped in once ready.
+static VkResult vk_respec_libraries(pl_gpu gpu, pl_pass pass)
+{
+    struct pl_vk *p = PL_PRIV(gpu);
+    struct vk_ctx *vk = p->vk;
+    struct pl_pass_vk *pass_vk = PL_PRIV(pass);
+
+    VkPipeline frag_lib = VK_NULL_HANDLE, pipe = VK_NULL_HANDLE;
+    VkResult res = create_library(vk, pass,
+        VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT, &frag_lib);
+    if (res != VK_SUCCESS)
+        return res;
+
+    res = link_pipeline(vk, pass, frag_lib, false, &pipe);
+    if (res != VK_SUCCESS) {
+        vk->DestroyPipeline(vk->dev, frag_lib, PL_VK_ALLOC);
+        return res;
+    }
+
+    if (pass_vk->pipe)
+        vk_dev_callback(vk, (vk_cb) destroy_pipeline, vk, vk_wrap_handle(pass_vk->pipe));
+    pass_vk->pipe = pipe;
+
+    if (pass_vk->lto) {
+        // Still busy optimizing a previous specialization, queue this one
+        vk->DestroyPipeline(vk->dev, pass_vk->pending_lib, PL_VK_ALLOC);
+        pass_vk->pending_lib = frag_lib;
+        pass_vk->pending_hash = pass_vk->spec_hash;
+    } else {
+        lto_start(gpu, pass, frag_lib, pass_vk->spec_hash);
+    }
+
+    return VK_SUCCESS;
+}
+
+#else // !VK_EXT_graphics_pipeline_library
+
+static void lto_finish(pl_gpu gpu, pl_pass pass, bool discard) {}
+
+static VkResult vk_create_libraries(struct vk_ctx *vk, pl_pass pass)
+{
+    pl_unreachable();
+}
+
+static VkResult vk_respec_libraries(pl_gpu gpu, pl_pass pass)
+{
+    pl_unreachable();
+}
+
+#endif
+
+#ifdef VK_EXT_descriptor_buffer
+
+// Allocates `NUM_DS` slots worth of descriptor buffer memory for this pass
+static VkResult vk_alloc_descbuf(pl_gpu gpu, pl_pass pass)
+{
+    struct pl_vk *p = PL_PRIV(gpu);
+    struct vk_ctx *vk = p->vk;
+    struct pl_pass_vk *pass_vk = PL_PRIV(pass);
+    int num_desc = pass->params.num_descriptors;
+
+    VkDeviceSize set_size;
+    vk->GetDescriptorSetLayoutSizeEXT(vk->dev, pass_vk->dsLayout, &set_size);
+    pass_vk->dbsize = PL_ALIGN(set_size, p->descbuf_align);
+    pass_vk->dboffsets = pl_calloc_ptr(pass, num_desc, pass_vk->dboffsets);
+    for (int i = 0; i < num_desc; i++) {
+        vk->GetDescriptorSetLayoutBindingOffsetEXT(vk->dev, pass_vk->dsLayout,
+                                                   pass->params.descriptors[i].binding,
+                                                   &pass_vk->dboffsets[i]);
+    }
+
+    struct vk_malloc_params mparams = {
+        .reqs = {
+            .size = pass_vk->dbsize * PL_ARRAY_SIZE(pass_vk->dss),
+            .alignment = p->descbuf_align,
+            .memoryTypeBits = UINT32_MAX,
+        },
+        .required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        .optimal = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        .buf_usage = VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT |
+                     VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+                     VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+        .debug_tag = PL_DEBUG_TAG,
+    };
+
+    if (!vk_malloc_slice(vk->ma, &pass_vk->dbmem, &mparams))
+        return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+
+    pass_vk->dbaddr = vk->GetBufferDeviceAddress(vk->dev, &(VkBufferDeviceAddressInfo) {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+        .buffer = pass_vk->dbmem.buf,
+    });
+    return VK_SUCCESS;
+}
+
+#else // !VK_EXT_descriptor_buffer
+
+static VkResult vk_alloc_descbuf(pl_gpu gpu, pl_pass pass)
+{
+    pl_unreachable();
+}
+
+#endif
+
+// Creates an update template covering all descriptors, reading from `dsinfo`
+static VkResult vk_create_template(pl_gpu gpu, pl_pass pass)
+{
+    struct pl_vk *p = PL_PRIV(gpu);
+    struct vk_ctx *vk = p->vk;
+    struct pl_pass_vk *pass_vk = PL_PRIV(pass);
+    int num_desc = pass->params.num_descriptors;
+
+    VkDescriptorUpdateTemplateEntry *entries;
+    entries = pl_calloc_ptr(NULL, num_desc, entries);
+    for (int i = 0; i < num_desc; i++) {
+        const struct pl_desc *desc = &pass->params.descriptors[i];
+        entries[i] = (VkDescriptorUpdateTemplateEntry) {
+            .dstBinding = desc->binding,
+            .descriptorCount = 1,
+            .descriptorType = dsType[desc->type],
+            .offset = i * sizeof(union vk_desc_info),
+            .stride = sizeof(union vk_desc_info),
+        };
+    }
+
+    VkDescriptorUpdateTemplateCreateInfo tinfo = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO,
+        .descriptorUpdateEntryCount = num_desc,
+        .pDescriptorUpdateEntries = entries,
+        .templateType = pass_vk->use_pushd
+                            ? VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR
+                            : VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET,
+        .descriptorSetLayout = pass_vk->dsLayout,
+        .pipelineBindPoint = bindPoint[pass->params.type],
+        .pipelineLayout = pass_vk->pipeLayout,
+        .set = 0,
+    };
+
+    VkResult res = vk->CreateDescriptorUpdateTemplate(vk->dev, &tinfo, PL_VK_ALLOC,
+                                                      &pass_vk->dsTemplate);
+    pl_free(entries);
+    return res;
+}
+
 pl_pass vk_pass_create(pl_gpu gpu, const struct pl_pass_params *params)
 {
     struct pl_vk *p = PL_PRIV(gpu);
@@ -307,9 +888,7 @@ pl_pass vk_pass_create(pl_gpu gpu, const struct pl_pass_params *params)
         goto error;
     }
 
-    pass_vk->dswrite = pl_calloc(pass, num_desc, sizeof(VkWriteDescriptorSet));
-    pass_vk->dsiinfo = pl_calloc(pass, num_desc, sizeof(VkDescriptorImageInfo));
-    pass_vk->dsbinfo = pl_calloc(pass, num_desc, sizeof(VkDescriptorBufferInfo));
+    pass_vk->dsinfo = pl_calloc_ptr(pass, num_desc, pass_vk->dsinfo);
 
 #define NUM_DS (PL_ARRAY_SIZE(pass_vk->dss))
 
@@ -356,6 +935,10 @@ pl_pass vk_pass_create(pl_gpu gpu, const struct pl_pass_params *params)
     if (p->max_push_descriptors && num_desc <= p->max_push_descriptors) {
         dinfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
         pass_vk->use_pushd = true;
+    } else if (p->has_descbuf) {
+        dinfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+        pass_vk->pipeFlags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+        pass_vk->use_descbuf = true;
     } else if (p->max_push_descriptors) {
         PL_INFO(gpu, "Pass with %d descriptors exceeds the maximum push "
                 "descriptor count (%d). Falling back to descriptor sets!",
@@ -365,7 +948,9 @@ pl_pass vk_pass_create(pl_gpu gpu, const struct pl_pass_params *params)
     VK(vk->CreateDescriptorSetLayout(vk->dev, &dinfo, PL_VK_ALLOC,
                                      &pass_vk->dsLayout));
 
-    if (!pass_vk->use_pushd) {
+    if (pass_vk->use_descbuf) {
+        VK(vk_alloc_descbuf(gpu, pass));
+    } else if (!pass_vk->use_pushd) {
         PL_ARRAY(VkDescriptorPoolSize) dsPoolSizes = {0};
 
         for (enum pl_desc_type t = 0; t < PL_DESC_TYPE_COUNT; t++) {
@@ -432,6 +1017,7 @@ no_descriptors: ;
         if (params->constant_data) {
             pass_vk->specInfo.pData = pl_memdup(pass, params->constant_data, spec_size);
             pass_vk->specInfo.dataSize = spec_size;
+            pass_vk->spec_hash = pl_mem_hash(params->constant_data, spec_size);
         }
     }
 
@@ -450,29 +1036,84 @@ no_descriptors: ;
     VK(vk->CreatePipelineLayout(vk->dev, &linfo, PL_VK_ALLOC,
                                 &pass_vk->pipeLayout));
 
-    pl_cache_obj vert = {0}, frag = {0}, comp = {0};
+    if (num_desc && !pass_vk->use_descbuf)
+        VK(vk_create_template(gpu, pass));
+
+    struct vk_stage stages[2];
+    int num_stages = 0;
     switch (params->type) {
-    case PL_PASS_RASTER: ;
-        VK(vk_compile_glsl(gpu, tmp, GLSL_SHADER_VERTEX, params->vertex_shader, &vert));
-        VK(vk_compile_glsl(gpu, tmp, GLSL_SHADER_FRAGMENT, params->glsl_shader, &frag));
+    case PL_PASS_RASTER:
+        stages[num_stages++] = (struct vk_stage) {
+            .type = GLSL_SHADER_VERTEX,
+            .glsl = params->vertex_shader,
+            .out  = &pass_vk->vert,
+            .name = "vertex",
+            .idx  = 0,
+        };
+        stages[num_stages++] = (struct vk_stage) {
+            .type = GLSL_SHADER_FRAGMENT,
+            .glsl = params->glsl_shader,
+            .out  = &pass_vk->shader,
+            .name = "fragment",
+            .idx  = 1,
+        };
         break;
     case PL_PASS_COMPUTE:
-        VK(vk_compile_glsl(gpu, tmp, GLSL_SHADER_COMPUTE, params->glsl_shader, &comp));
+        stages[num_stages++] = (struct vk_stage) {
+            .type = GLSL_SHADER_COMPUTE,
+            .glsl = params->glsl_shader,
+            .out  = &pass_vk->shader,
+            .name = "compute",
+            .idx  = 2,
+        };
         break;
     case PL_PASS_INVALID:
     case PL_PASS_TYPE_COUNT:
         pl_unreachable();
     }
 
+    // Re-use existing shader modules where possible, and compile all other
+    // stages concurrently
+    for (int i = 0; i < num_stages; i++) {
+        struct vk_stage *st = &stages[i];
+        const uint64_t key = module_key(gpu, st->type, st->glsl);
+        st->mod = module_acquire(gpu, key);
+        if (st->mod.module) {
+            PL_DEBUG(gpu, "Re-using %s shader module 0x%"PRIx64, st->name, key);
+            *st->out = st->mod.module;
+        } else {
+            st->mod.key = key;
+            vk_compile_begin(gpu, st->type, st->glsl, &st->compile);
+        }
+    }
+
+    VkResult res = VK_SUCCESS;
+    for (int i = 0; i < num_stages; i++) {
+        struct vk_stage *st = &stages[i];
+        if (!st->mod.module) {
+            VkResult res_stage = vk_compile_end(gpu, tmp, &st->compile, &st->spirv);
+            if (res == VK_SUCCESS)
+                res = res_stage;
+            st->mod.spirv_hash = pl_mem_hash(st->spirv.data, st->spirv.size);
+            st->mod.spirv_size = st->spirv.size;
+        }
+    }
+    VK(res);
+
     // Use hash of generated SPIR-V as key for pipeline cache
     const pl_cache cache = pl_gpu_cache(gpu);
     pl_cache_obj pipecache = {0};
     if (cache) {
         pipecache.key = CACHE_KEY_VK_PIPE;
+        uint64_t hashes[3];
+        for (int i = 0; i < PL_ARRAY_SIZE(hashes); i++)
+            hashes[i] = pl_mem_hash(NULL, 0);
+        for (int i = 0; i < num_stages; i++)
+            hashes[stages[i].idx] = stages[i].mod.spirv_hash;
+
         pl_hash_merge(&pipecache.key, pl_var_hash(vk->props.pipelineCacheUUID));
-        pl_hash_merge(&pipecache.key, pl_mem_hash(vert.data, vert.size));
-        pl_hash_merge(&pipecache.key, pl_mem_hash(frag.data, frag.size));
-        pl_hash_merge(&pipecache.key, pl_mem_hash(comp.data, comp.size));
+        for (int i = 0; i < PL_ARRAY_SIZE(hashes); i++)
+            pl_hash_merge(&pipecache.key, hashes[i]);
         pl_cache_get(cache, &pipecache);
     }
 
@@ -494,18 +1135,19 @@ no_descriptors: ;
     };
 
     pl_clock_t start = pl_clock_now();
+    for (int i = 0; i < num_stages; i++) {
+        struct vk_stage *st = &stages[i];
+        if (*st->out)
+            continue; // re-used existing module
+        sinfo.pCode = (uint32_t *) st->spirv.data;
+        sinfo.codeSize = st->spirv.size;
+        VK(vk->CreateShaderModule(vk->dev, &sinfo, PL_VK_ALLOC, &st->mod.module));
+        PL_VK_NAME(SHADER_MODULE, st->mod.module, st->name);
+        *st->out = module_insert(gpu, &st->mod);
+    }
+
     switch (params->type) {
     case PL_PASS_RASTER: {
-        sinfo.pCode = (uint32_t *) vert.data;
-        sinfo.codeSize = vert.size;
-        VK(vk->CreateShaderModule(vk->dev, &sinfo, PL_VK_ALLOC, &pass_vk->vert));
-        PL_VK_NAME(SHADER_MODULE, pass_vk->vert, "vertex");
-
-        sinfo.pCode = (uint32_t *) frag.data;
-        sinfo.codeSize = frag.size;
-        VK(vk->CreateShaderModule(vk->dev, &sinfo, PL_VK_ALLOC, &pass_vk->shader));
-        PL_VK_NAME(SHADER_MODULE, pass_vk->shader, "fragment");
-
         pass_vk->attrs = pl_calloc_ptr(pass, params->num_vertex_attribs, pass_vk->attrs);
         for (int i = 0; i < params->num_vertex_attribs; i++) {
             struct pl_vertex_attrib *va = &params->vertex_attribs[i];
@@ -546,13 +1188,8 @@ no_descriptors: ;
         VK(vk->CreateRenderPass(vk->dev, &rinfo, PL_VK_ALLOC, &pass_vk->renderPass));
         break;
     }
-    case PL_PASS_COMPUTE: {
-        sinfo.pCode = (uint32_t *) comp.data;
-        sinfo.codeSize = comp.size;
-        VK(vk->CreateShaderModule(vk->dev, &sinfo, PL_VK_ALLOC, &pass_vk->shader));
-        PL_VK_NAME(SHADER_MODULE, pass_vk->shader, "compute");
+    case PL_PASS_COMPUTE:
         break;
-    }
     case PL_PASS_INVALID:
     case PL_PASS_TYPE_COUNT:
         pl_unreachable();
@@ -562,14 +1199,20 @@ no_descriptors: ;
     pl_log_cpu_time(gpu->log, start, after_compilation, "compiling shader");
 
     // Update cache entries on successful compilation
-    pl_cache_steal(cache, &vert);
-    pl_cache_steal(cache, &frag);
-    pl_cache_steal(cache, &comp);
+    for (int i = 0; i < num_stages; i++)
+        pl_cache_steal(cache, &stages[i].spirv);
 
     // Create the graphics/compute pipeline
-    VkPipeline *pipe = has_spec ? &pass_vk->base : &pass_vk->pipe;
-    VK(vk_recreate_pipelines(vk, pass, has_spec, VK_NULL_HANDLE, pipe));
-    pl_log_cpu_time(gpu->log, after_compilation, pl_clock_now(), "creating pipeline");
+    if (has_spec && p->has_gpl && params->type == PL_PASS_RASTER) {
+        VK(vk_create_libraries(vk, pass));
+        VK(vk_respec_libraries(gpu, pass));
+    } else {
+        VkPipeline *pipe = has_spec ? &pass_vk->base : &pass_vk->pipe;
+        VK(vk_recreate_pipelines(vk, pass, has_spec, VK_NULL_HANDLE, pipe));
+        pass_vk->base_hash = pass_vk->spec_hash;
+    }
+    pl_clock_t after_pipeline = pl_clock_now();
+    pl_log_cpu_time(gpu->log, after_compilation, after_pipeline, "creating pipeline");
 
     // Update pipeline cache
     if (cache) {
@@ -577,22 +1220,28 @@ no_descriptors: ;
         VK(vk->GetPipelineCacheData(vk->dev, pass_vk->cache, &size, NULL));
         pl_cache_obj_resize(tmp, &pipecache, size);
         VK(vk->GetPipelineCacheData(vk->dev, pass_vk->cache, &size, pipecache.data));
+        pipecache.cost = pl_clock_diff(after_pipeline, start);
+        pass_vk->cache_key = pipecache.key;
+        pass_vk->cache_cost = pipecache.cost;
         pl_cache_steal(cache, &pipecache);
     }
 
     if (!has_spec) {
         // We can free these if we no longer need them for specialization
         pl_free_ptr(&pass_vk->attrs);
-        vk->DestroyShaderModule(vk->dev, pass_vk->vert, PL_VK_ALLOC);
-        vk->DestroyShaderModule(vk->dev, pass_vk->shader, PL_VK_ALLOC);
+        module_release(gpu, pass_vk->vert);
+        module_release(gpu, pass_vk->shader);
         vk->DestroyPipelineCache(vk->dev, pass_vk->cache, PL_VK_ALLOC);
         pass_vk->vert = VK_NULL_HANDLE;
         pass_vk->shader = VK_NULL_HANDLE;
         pass_vk->cache = VK_NULL_HANDLE;
     }
 
+    size_t spirv_size[3] = {0};
+    for (int i = 0; i < num_stages; i++)
+        spirv_size[stages[i].idx] = stages[i].mod.spirv_size;
     PL_DEBUG(vk, "Pass statistics: size %zu, SPIR-V: vert %zu frag %zu comp %zu",
-             pipecache.size, vert.size, frag.size, comp.size);
+             pipecache.size, spirv_size[0], spirv_size[1], spirv_size[2]);
 
     success = true;
 
@@ -613,22 +1262,80 @@ static const VkPipelineStageFlags2 shaderStages[] = {
     [PL_PASS_COMPUTE] = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
 };
 
+#ifdef VK_EXT_descriptor_buffer
+
+// Writes the descriptor for `dsinfo[idx]` directly into descriptor buffer
+// memory, at the binding's offset within the slot `dbdata`
+static void vk_write_descbuf(pl_gpu gpu, pl_pass pass, struct pl_desc_binding db,
+                             uint8_t *dbdata, int idx)
+{
+    struct pl_vk *p = PL_PRIV(gpu);
+    struct vk_ctx *vk = p->vk;
+    struct pl_pass_vk *pass_vk = PL_PRIV(pass);
+    const struct pl_desc *desc = &pass->params.descriptors[idx];
+    const union vk_desc_info *info = &pass_vk->dsinfo[idx];
+
+    VkDescriptorGetInfoEXT ginfo = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+        .type = dsType[desc->type],
+    };
+
+    VkDescriptorAddressInfoEXT ainfo = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT,
+    };
+
+    switch (desc->type) {
+    case PL_DESC_SAMPLED_TEX:
+        ginfo.data.pCombinedImageSampler = &info->image;
+        break;
+    case PL_DESC_STORAGE_IMG:
+        ginfo.data.pStorageImage = &info->image;
+        break;
+    case PL_DESC_BUF_UNIFORM:
+    case PL_DESC_BUF_STORAGE:
+    case PL_DESC_BUF_TEXEL_UNIFORM:
+    case PL_DESC_BUF_TEXEL_STORAGE: {
+        pl_buf buf = db.object;
+        const struct pl_buf_vk *buf_vk = PL_PRIV(buf);
+        ainfo.address = buf_vk->addr;
+        ainfo.range = buf->params.size;
+        if (buf->params.format) {
+            const struct pl_fmt_vk *fmtp = PL_PRIV(buf->params.format);
+            ainfo.format = PL_DEF(fmtp->vk_fmt->bfmt, fmtp->vk_fmt->tfmt);
+        }
+        // All of these union members are pointers to VkDescriptorAddressInfoEXT
+        ginfo.data.pUniformBuffer = &ainfo;
+        break;
+    }
+    case PL_DESC_INVALID:
+    case PL_DESC_TYPE_COUNT:
+        pl_unreachable();
+    }
+
+    vk->GetDescriptorEXT(vk->dev, &ginfo, p->desc_size[desc->type],
+                         dbdata + pass_vk->dboffsets[idx]);
+}
+
+#else // !VK_EXT_descriptor_buffer
+
+static void vk_write_descbuf(pl_gpu gpu, pl_pass pass, struct pl_desc_binding db,
+                             uint8_t *dbdata, int idx)
+{
+    pl_unreachable();
+}
+
+#endif
+
+// Updates `dsinfo[idx]` and records the necessary barriers. If `dbdata` is
+// set, the descriptor is also written to the given descriptor buffer slot.
 static void vk_update_descriptor(pl_gpu gpu, struct vk_cmd *cmd, pl_pass pass,
                                  struct pl_desc_binding db,
-                                 VkDescriptorSet ds, int idx)
+                                 uint8_t *dbdata, int idx)
 {
     struct pl_vk *p = PL_PRIV(gpu);
     struct pl_pass_vk *pass_vk = PL_PRIV(pass);
     struct pl_desc *desc = &pass->params.descriptors[idx];
-
-    VkWriteDescriptorSet *wds = &pass_vk->dswrite[idx];
-    *wds = (VkWriteDescriptorSet) {
-        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-        .dstSet = ds,
-        .dstBinding = desc->binding,
-        .descriptorCount = 1,
-        .descriptorType = dsType[desc->type],
-    };
+    union vk_desc_info *info = &pass_vk->dsinfo[idx];
 
     static const VkAccessFlags2 storageAccess[PL_DESC_ACCESS_COUNT] = {
         [PL_DESC_ACCESS_READONLY]   = VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
@@ -647,15 +1354,12 @@ static void vk_update_descriptor(pl_gpu gpu, struct vk_cmd *cmd, pl_pass pass,
                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
                        VK_QUEUE_FAMILY_IGNORED);
 
-        VkDescriptorImageInfo *iinfo = &pass_vk->dsiinfo[idx];
-        *iinfo = (VkDescriptorImageInfo) {
+        info->image = (VkDescriptorImageInfo) {
             .sampler = p->samplers[db.sample_mode][db.address_mode],
             .imageView = tex_vk->view,
             .imageLayout = tex_vk->layout,
         };
-
-        wds->pImageInfo = iinfo;
-        return;
+        break;
     }
     case PL_DESC_STORAGE_IMG: {
         pl_tex tex = db.object;
@@ -665,14 +1369,11 @@ static void vk_update_descriptor(pl_gpu gpu, struct vk_cmd *cmd, pl_pass pass,
                        storageAccess[desc->access], VK_IMAGE_LAYOUT_GENERAL,
                        VK_QUEUE_FAMILY_IGNORED);
 
-        VkDescriptorImageInfo *iinfo = &pass_vk->dsiinfo[idx];
-        *iinfo = (VkDescriptorImageInfo) {
+        info->image = (VkDescriptorImageInfo) {
             .imageView = tex_vk->view,
             .imageLayout = tex_vk->layout,
         };
-
-        wds->pImageInfo = iinfo;
-        return;
+        break;
     }
     case PL_DESC_BUF_UNIFORM:
     case PL_DESC_BUF_STORAGE: {
@@ -686,15 +1387,12 @@ static void vk_update_descriptor(pl_gpu gpu, struct vk_cmd *cmd, pl_pass pass,
         vk_buf_barrier(gpu, cmd, buf, shaderStages[pass->params.type],
                        access, 0, buf->params.size, false);
 
-        VkDescriptorBufferInfo *binfo = &pass_vk->dsbinfo[idx];
-        *binfo = (VkDescriptorBufferInfo) {
+        info->buffer = (VkDescriptorBufferInfo) {
             .buffer = buf_vk->mem.buf,
             .offset = buf_vk->mem.offset,
             .range = buf->params.size,
         };
-
-        wds->pBufferInfo = binfo;
-        return;
+        break;
     }
     case PL_DESC_BUF_TEXEL_UNIFORM:
     case PL_DESC_BUF_TEXEL_STORAGE: {
@@ -708,15 +1406,16 @@ static void vk_update_descriptor(pl_gpu gpu, struct vk_cmd *cmd, pl_pass pass,
         vk_buf_barrier(gpu, cmd, buf, shaderStages[pass->params.type],
                        access, 0, buf->params.size, false);
 
-        wds->pTexelBufferView = &buf_vk->view;
-        return;
+        info->view = buf_vk->view;
+        break;
     }
     case PL_DESC_INVALID:
     case PL_DESC_TYPE_COUNT:
-        break;
+        pl_unreachable();
     }
 
-    pl_unreachable();
+    if (dbdata)
+        vk_write_descbuf(gpu, pass, db, dbdata, idx);
 }
 
 static void vk_release_descriptor(pl_gpu gpu, struct vk_cmd *cmd, pl_pass pass,
@@ -774,6 +1473,66 @@ static bool need_respec(pl_pass pass, const struct pl_pass_run_params *params)
     return false;
 }
 
+// Switches the pass to the specialization currently in `specInfo`, re-using
+// the pipeline of a recently used specialization if possible
+static VkResult vk_respec(pl_gpu gpu, pl_pass pass)
+{
+    struct pl_vk *p = PL_PRIV(gpu);
+    struct vk_ctx *vk = p->vk;
+    struct pl_pass_vk *pass_vk = PL_PRIV(pass);
+    struct vk_spec_variant *vars = pass_vk->variants;
+    const uint64_t hash = pl_mem_hash(pass_vk->specInfo.pData, pass_vk->spec_size);
+
+    VkPipeline found = VK_NULL_HANDLE;
+    for (int i = 0; i < NUM_SPEC_VARIANTS; i++) {
+        if (vars[i].pipe && vars[i].hash == hash) {
+            found = vars[i].pipe;
+            memmove(&vars[i], &vars[i + 1], (NUM_SPEC_VARIANTS - i - 1) * sizeof(vars[0]));
+            vars[NUM_SPEC_VARIANTS - 1] = (struct vk_spec_variant) {0};
+            break;
+        }
+    }
+
+    // Move the current pipeline to the front of the list, evicting the least
+    // recently used one
+    if (pass_vk->pipe) {
+        VkPipeline lru = vars[NUM_SPEC_VARIANTS - 1].pipe;
+        if (lru)
+            vk_dev_callback(vk, (vk_cb) destroy_pipeline, vk, vk_wrap_handle(lru));
+        memmove(&vars[1], &vars[0], (NUM_SPEC_VARIANTS - 1) * sizeof(vars[0]));
+        vars[0] = (struct vk_spec_variant) {
+            .hash = pass_vk->spec_hash,
+            .pipe = pass_vk->pipe,
+        };
+        pass_vk->pipe = VK_NULL_HANDLE;
+    }
+
+    pass_vk->spec_hash = hash;
+    if (found) {
+        pass_vk->pipe = found;
+        return VK_SUCCESS;
+    } else if (pass_vk->base && pass_vk->base_hash == hash) {
+        return VK_SUCCESS; // `base` already has this specialization
+    }
+
+    VkResult res;
+    pl_clock_t start = pl_clock_now();
+    if (pass_vk->libs[0]) {
+        res = vk_respec_libraries(gpu, pass);
+    } else {
+        res = vk_recreate_pipelines(vk, pass, false, pass_vk->base, &pass_vk->pipe);
+    }
+
+    if (res != VK_SUCCESS)
+        return res;
+
+    pl_clock_t stop = pl_clock_now();
+    pl_log_cpu_time(gpu->log, start, stop, "re-specializing shader");
+    pass_vk->cache_cost += pl_clock_diff(stop, start);
+    save_pipecache(gpu, pass);
+    return VK_SUCCESS;
+}
+
 void vk_pass_run(pl_gpu gpu, const struct pl_pass_run_params *params)
 {
     struct pl_vk *p = PL_PRIV(gpu);
@@ -784,12 +1543,12 @@ void vk_pass_run(pl_gpu gpu, const struct pl_pass_run_params *params)
     if (params->vertex_data || params->index_data)
         return pl_pass_run_vbo(gpu, params);
 
+    // Pick up the optimized pipeline, if it finished in the meantime
+    lto_finish(gpu, pass, false);
+
     // Check if we need to re-specialize this pipeline
-    if (need_respec(pass, params)) {
-        pl_clock_t start = pl_clock_now();
-        VK(vk_recreate_pipelines(vk, pass, false, pass_vk->base, &pass_vk->pipe));
-        pl_log_cpu_time(gpu->log, start, pl_clock_now(), "re-specializing shader");
-    }
+    if (need_respec(pass, params))
+        VK(vk_respec(gpu, pass));
 
     if (!pass_vk->use_pushd) {
         // Wait for a free descriptor set
@@ -808,13 +1567,19 @@ void vk_pass_run(pl_gpu gpu, const struct pl_pass_run_params *params)
     if (!cmd)
         goto error;
 
-    // Find a descriptor set to use
+    // Find a descriptor set (or descriptor buffer slot) to use
     VkDescriptorSet ds = VK_NULL_HANDLE;
+    VkDeviceSize dboffset = 0;
+    uint8_t *dbdata = NULL;
     if (!pass_vk->use_pushd) {
         for (int i = 0; i < PL_ARRAY_SIZE(pass_vk->dss); i++) {
             uint16_t dsbit = 1u << i;
             if (pass_vk->dmask & dsbit) {
                 ds = pass_vk->dss[i];
+                if (pass_vk->use_descbuf) {
+                    dboffset = pass_vk->dbmem.offset + i * pass_vk->dbsize;
+                    dbdata = (uint8_t *) pass_vk->dbmem.data + i * pass_vk->dbsize;
+                }
                 pass_vk->dmask &= ~dsbit; // unset
                 vk_cmd_callback(cmd, (vk_cb) set_ds, pass_vk,
                                 (void *)(uintptr_t) dsbit);
@@ -823,21 +1588,14 @@ void vk_pass_run(pl_gpu gpu, const struct pl_pass_run_params *params)
         }
     }
 
-    // Update the dswrite structure with all of the new values
+    // Update the dsinfo structure with all of the new values
     for (int i = 0; i < pass->params.num_descriptors; i++)
-        vk_update_descriptor(gpu, cmd, pass, params->desc_bindings[i], ds, i);
+        vk_update_descriptor(gpu, cmd, pass, params->desc_bindings[i], dbdata, i);
 
-    if (!pass_vk->use_pushd) {
-        vk->UpdateDescriptorSets(vk->dev, pass->params.num_descriptors,
-                                 pass_vk->dswrite, 0, NULL);
-    }
+    if (ds)
+        vk->UpdateDescriptorSetWithTemplate(vk->dev, ds, pass_vk->dsTemplate, pass_vk->dsinfo);
 
     // Bind the pipeline, descriptor set, etc.
-    static const VkPipelineBindPoint bindPoint[] = {
-        [PL_PASS_RASTER]  = VK_PIPELINE_BIND_POINT_GRAPHICS,
-        [PL_PASS_COMPUTE] = VK_PIPELINE_BIND_POINT_COMPUTE,
-    };
-
     vk->CmdBindPipeline(cmd->buf, bindPoint[pass->params.type],
                         PL_DEF(pass_vk->pipe, pass_vk->base));
 
@@ -847,11 +1605,26 @@ void vk_pass_run(pl_gpu gpu, const struct pl_pass_run_params *params)
     }
 
     if (pass_vk->use_pushd) {
-        vk->CmdPushDescriptorSetKHR(cmd->buf, bindPoint[pass->params.type],
-                                    pass_vk->pipeLayout, 0,
-                                    pass->params.num_descriptors,
-                                    pass_vk->dswrite);
+        vk->CmdPushDescriptorSetWithTemplateKHR(cmd->buf, pass_vk->dsTemplate,
+                                                pass_vk->pipeLayout, 0,
+                                                pass_vk->dsinfo);
+    }
+
+#ifdef VK_EXT_descriptor_buffer
+    if (dbdata) {
+        vk->CmdBindDescriptorBuffersEXT(cmd->buf, 1, &(VkDescriptorBufferBindingInfoEXT) {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+            .address = pass_vk->dbaddr,
+            .usage = VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT |
+                     VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT,
+        });
+
+        uint32_t index = 0;
+        vk->CmdSetDescriptorBufferOffsetsEXT(cmd->buf, bindPoint[pass->params.type],
+                                             pass_vk->pipeLayout, 0, 1,
+                                             &index, &dboffset);
     }
+#endif
 
     if (pass->params.push_constants_size) {
         vk->CmdPushConstants(cmd->buf, pass_vk->pipeLayout,
@@ -932,6 +1705,7 @@ void vk_pass_run(pl_gpu gpu, const struct pl_pass_run_params *params)
             .renderArea.extent = {tex->params.w, tex->params.h},
         };
 
+        vk_cmd_flush_barriers(cmd);
         vk->CmdBeginRenderPass(cmd->buf, &binfo, VK_SUBPASS_CONTENTS_INLINE);
 
         if (index) {
@@ -944,6 +1718,7 @@ void vk_pass_run(pl_gpu gpu, const struct pl_pass_run_params *params)
         break;
     }
     case PL_PASS_COMPUTE:
+        vk_cmd_flush_barriers(cmd);
         vk->CmdDispatch(cmd->buf, params->compute_groups[0],
                         params->compute_groups[1],
                         params->compute_groups[2]);
@@ -956,8 +1731,9 @@ void vk_pass_run(pl_gpu gpu, const struct pl_pass_run_params *params)
     for (int i = 0; i < pass->params.num_descriptors; i++)
         vk_release_descriptor(gpu, cmd, pass, params->desc_bindings[i], i);
 
-    // submit this command buffer for better intra-frame granularity
-    CMD_SUBMIT(&cmd);
+    // end this command buffer for better intra-frame granularity, but leave
+    // the actual submission to be batched together with the following passes
+    CMD_QUEUE(&cmd);
 
 error:
     return;
@@ -17,6 +17,10 @@
 
 #include "gpu.h"
 
+#ifdef PL_HAVE_UNIX
+#include <unistd.h>
+#endif
+
 void vk_tex_barrier(pl_gpu gpu, struct vk_cmd *cmd, pl_tex tex,
                     VkPipelineStageFlags2 stage, VkAccessFlags2 access,
                     VkImageLayout layout, uint32_t qf)
@@ -24,9 +28,12 @@ void vk_tex_barrier(pl_gpu gpu, struct vk_cmd *cmd, pl_tex tex,
     struct pl_vk *p = PL_PRIV(gpu);
     struct vk_ctx *vk = p->vk;
     struct pl_tex_vk *tex_vk = PL_PRIV(tex);
-    pl_rc_ref(&tex_vk->rc);
     pl_assert(!tex_vk->held);
     pl_assert(!tex_vk->num_planes);
+    if (vk_cmd_ref(cmd, &tex_vk->ref)) {
+        pl_rc_ref(&tex_vk->rc);
+        vk_cmd_callback(cmd, (vk_cb) vk_tex_deref, gpu, tex);
+    }
 
     // CONCURRENT images require transitioning to/from IGNORED, EXCLUSIVE
     // images require transitioning to/from the concrete QF index
@@ -54,6 +61,7 @@ void vk_tex_barrier(pl_gpu gpu, struct vk_cmd *cmd, pl_tex tex,
         .image = tex_vk->img,
         .subresourceRange = {
             .aspectMask = tex_vk->aspect,
+            .baseArrayLayer = tex_vk->layer,
             .levelCount = 1,
             .layerCount = 1,
         },
@@ -64,17 +72,11 @@ void vk_tex_barrier(pl_gpu gpu, struct vk_cmd *cmd, pl_tex tex,
         barr.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     }
 
-    if (last.access || is_trans || is_xfer) {
-        vk_cmd_barrier(cmd, &(VkDependencyInfo) {
-            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
-            .imageMemoryBarrierCount = 1,
-            .pImageMemoryBarriers = &barr,
-        });
-    }
+    if (last.access || is_trans || is_xfer)
+        vk_cmd_barrier_img(cmd, &barr);
 
     tex_vk->qf = qf;
     tex_vk->layout = layout;
-    vk_cmd_callback(cmd, (vk_cb) vk_tex_deref, gpu, tex);
 
     for (int i = 0; i < tex_vk->ext_deps.num; i++)
         vk_cmd_dep(cmd, stage, tex_vk->ext_deps.elem[i]);
@@ -155,13 +157,25 @@ static bool vk_init_image(pl_gpu gpu, pl_tex tex, pl_debug_tag debug_tag)
             [VK_IMAGE_TYPE_3D] = VK_IMAGE_VIEW_TYPE_3D,
         };
 
+        // Restrict the view to the usage we actually need, since the image
+        // may have been created with usage flags (e.g. video decode) that
+        // are incompatible with the per-plane view format
+        const VkImageViewUsageCreateInfo vusage = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO,
+            .usage = tex_vk->usage_flags & (VK_IMAGE_USAGE_SAMPLED_BIT |
+                                            VK_IMAGE_USAGE_STORAGE_BIT |
+                                            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT),
+        };
+
         const VkImageViewCreateInfo vinfo = {
             .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .pNext = vusage.usage ? &vusage : NULL,
             .image = tex_vk->img,
             .viewType = viewType[tex_vk->type],
             .format = tex_vk->img_fmt,
             .subresourceRange = {
                 .aspectMask = tex_vk->aspect,
+                .baseArrayLayer = tex_vk->layer,
                 .levelCount = 1,
                 .layerCount = 1,
             },
@@ -231,6 +245,30 @@ error:
     return ret;
 }
 
+#ifdef VK_EXT_host_image_copy
+// Returns whether host image copies are supported for the given image, *and*
+// don't come at the cost of device access performance
+static bool host_copy_supported(pl_gpu gpu, VkPhysicalDeviceImageFormatInfo2KHR pinfo)
+{
+    struct pl_vk *p = PL_PRIV(gpu);
+    struct vk_ctx *vk = p->vk;
+    pinfo.usage |= VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT;
+
+    VkHostImageCopyDevicePerformanceQueryEXT perf = {
+        .sType = VK_STRUCTURE_TYPE_HOST_IMAGE_COPY_DEVICE_PERFORMANCE_QUERY_EXT,
+    };
+
+    VkImageFormatProperties2KHR props = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_FORMAT_PROPERTIES_2_KHR,
+        .pNext = &perf,
+    };
+
+    VkResult res;
+    res = vk->GetPhysicalDeviceImageFormatProperties2KHR(vk->physd, &pinfo, &props);
+    return res == VK_SUCCESS && perf.optimalDeviceAccess;
+}
+#endif
+
 pl_tex vk_tex_create(pl_gpu gpu, const struct pl_tex_params *params)
 {
     struct pl_vk *p = PL_PRIV(gpu);
@@ -444,6 +482,17 @@ pl_tex vk_tex_create(pl_gpu gpu, const struct pl_tex_params *params)
         .flags = iinfo.flags,
     };
 
+#ifdef VK_EXT_host_image_copy
+    if (p->has_host_copy && (params->host_writable || params->host_readable) &&
+        !tex_vk->num_planes && !fmt->emulated && !handle_type &&
+        host_copy_supported(gpu, pinfo))
+    {
+        iinfo.usage |= VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT;
+        pinfo.usage = iinfo.usage;
+        tex_vk->host_copy = true;
+    }
+#endif
+
     VkExternalImageFormatPropertiesKHR ext_props = {
         .sType = VK_STRUCTURE_TYPE_EXTERNAL_IMAGE_FORMAT_PROPERTIES_KHR,
     };
@@ -686,12 +735,14 @@ void vk_tex_clear_ex(pl_gpu gpu, pl_tex tex, const union pl_clear_color color)
     const VkClearColorValue *clearColor = (const VkClearColorValue *) &color;
 
     pl_assert(tex_vk->aspect == VK_IMAGE_ASPECT_COLOR_BIT);
-    static const VkImageSubresourceRange range = {
+    const VkImageSubresourceRange range = {
         .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseArrayLayer = tex_vk->layer,
         .levelCount = 1,
         .layerCount = 1,
     };
 
+    vk_cmd_flush_barriers(cmd);
     vk->CmdClearColorImage(cmd->buf, tex_vk->img, tex_vk->layout,
                            clearColor, 1, &range);
 
@@ -740,10 +791,12 @@ void vk_tex_blit(pl_gpu gpu, const struct pl_tex_blit_params *params)
         VkImageCopy region = {
             .srcSubresource = {
                 .aspectMask = src_vk->aspect,
+                .baseArrayLayer = src_vk->layer,
                 .layerCount = 1,
             },
             .dstSubresource = {
                 .aspectMask = dst_vk->aspect,
+                .baseArrayLayer = dst_vk->layer,
                 .layerCount = 1,
             },
             .srcOffset = {src_rc.x0, src_rc.y0, src_rc.z0},
@@ -755,6 +808,7 @@ void vk_tex_blit(pl_gpu gpu, const struct pl_tex_blit_params *params)
             },
         };
 
+        vk_cmd_flush_barriers(cmd);
         vk->CmdCopyImage(cmd->buf, src_vk->img, src_vk->layout,
                          dst_vk->img, dst_vk->layout, 1, &region);
     } else {
@@ -771,10 +825,12 @@ void vk_tex_blit(pl_gpu gpu, const struct pl_tex_blit_params *params)
         VkImageBlit region = {
             .srcSubresource = {
                 .aspectMask = src_vk->aspect,
+                .baseArrayLayer = src_vk->layer,
                 .layerCount = 1,
             },
             .dstSubresource = {
                 .aspectMask = dst_vk->aspect,
+                .baseArrayLayer = dst_vk->layer,
                 .layerCount = 1,
             },
             .srcOffsets = {{src_rc.x0, src_rc.y0, src_rc.z0},
@@ -788,6 +844,7 @@ void vk_tex_blit(pl_gpu gpu, const struct pl_tex_blit_params *params)
             [PL_TEX_SAMPLE_LINEAR]  = VK_FILTER_LINEAR,
         };
 
+        vk_cmd_flush_barriers(cmd);
         vk->CmdBlitImage(cmd->buf, src_vk->img, src_vk->layout,
                          dst_vk->img, dst_vk->layout, 1, &region,
                          filters[params->sample_mode]);
@@ -853,6 +910,138 @@ static void tex_xfer_cb(void *ctx, void *arg)
     fun(arg);
 }
 
+#ifdef VK_EXT_host_image_copy
+
+// Transfers larger than this are better off going through the DMA engine,
+// which runs asynchronously instead of blocking the calling thread
+#define HOST_COPY_MAX (4 << 20)
+
+// Host image copies bypass all GPU synchronization, so they are only used for
+// small transfers to/from idle textures. Transitions the image to
+// VK_IMAGE_LAYOUT_GENERAL on success.
+static bool host_copy_prepare(pl_gpu gpu, const struct pl_tex_transfer_params *params)
+{
+    struct pl_vk *p = PL_PRIV(gpu);
+    struct vk_ctx *vk = p->vk;
+    pl_tex tex = params->tex;
+    pl_fmt fmt = tex->params.format;
+    struct pl_tex_vk *tex_vk = PL_PRIV(tex);
+
+    if (!tex_vk->host_copy || params->buf || params->timer)
+        return false;
+    if (pl_tex_transfer_size(params) > HOST_COPY_MAX)
+        return false;
+    if (params->row_pitch % fmt->texel_size || params->depth_pitch % params->row_pitch)
+        return false;
+    if (tex_vk->held || tex_vk->ext_deps.num || tex_vk->ext_sync)
+        return false;
+
+    vk_poll_commands(vk, 0);
+    if (pl_rc_count(&tex_vk->rc) > 1)
+        return false;
+
+    if (tex_vk->layout != VK_IMAGE_LAYOUT_GENERAL) {
+        VkHostImageLayoutTransitionInfoEXT info = {
+            .sType = VK_STRUCTURE_TYPE_HOST_IMAGE_LAYOUT_TRANSITION_INFO_EXT,
+            .image = tex_vk->img,
+            .oldLayout = tex_vk->may_invalidate ? VK_IMAGE_LAYOUT_UNDEFINED
+                                                : tex_vk->layout,
+            .newLayout = VK_IMAGE_LAYOUT_GENERAL,
+            .subresourceRange = {
+                .aspectMask = tex_vk->aspect,
+                .levelCount = 1,
+                .baseArrayLayer = tex_vk->layer,
+                .layerCount = 1,
+            },
+        };
+
+        if (vk->TransitionImageLayoutEXT(vk->dev, 1, &info) != VK_SUCCESS)
+            return false;
+        tex_vk->layout = VK_IMAGE_LAYOUT_GENERAL;
+        tex_vk->may_invalidate = false;
+    }
+
+    return true;
+}
+
+static bool host_copy_upload(pl_gpu gpu, const struct pl_tex_transfer_params *params)
+{
+    struct pl_vk *p = PL_PRIV(gpu);
+    struct vk_ctx *vk = p->vk;
+    pl_tex tex = params->tex;
+    pl_fmt fmt = tex->params.format;
+    struct pl_tex_vk *tex_vk = PL_PRIV(tex);
+    if (!host_copy_prepare(gpu, params))
+        return false;
+
+    pl_rect3d rc = params->rc;
+    VkResult res = vk->CopyMemoryToImageEXT(vk->dev, &(VkCopyMemoryToImageInfoEXT) {
+        .sType = VK_STRUCTURE_TYPE_COPY_MEMORY_TO_IMAGE_INFO_EXT,
+        .dstImage = tex_vk->img,
+        .dstImageLayout = tex_vk->layout,
+        .regionCount = 1,
+        .pRegions = &(VkMemoryToImageCopyEXT) {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_TO_IMAGE_COPY_EXT,
+            .pHostPointer = params->ptr,
+            .memoryRowLength = params->row_pitch / fmt->texel_size,
+            .memoryImageHeight = params->depth_pitch / params->row_pitch,
+            .imageSubresource = {
+                .aspectMask = tex_vk->aspect,
+                .baseArrayLayer = tex_vk->layer,
+                .layerCount = 1,
+            },
+            .imageOffset = { rc.x0, rc.y0, rc.z0 },
+            .imageExtent = { rc.x1 - rc.x0, rc.y1 - rc.y0, rc.z1 - rc.z0 },
+        },
+    });
+
+    if (res != VK_SUCCESS)
+        return false;
+    if (params->callback)
+        params->callback(params->priv);
+    return true;
+}
+
+static bool host_copy_download(pl_gpu gpu, const struct pl_tex_transfer_params *params)
+{
+    struct pl_vk *p = PL_PRIV(gpu);
+    struct vk_ctx *vk = p->vk;
+    pl_tex tex = params->tex;
+    pl_fmt fmt = tex->params.format;
+    struct pl_tex_vk *tex_vk = PL_PRIV(tex);
+    if (!host_copy_prepare(gpu, params))
+        return false;
+
+    pl_rect3d rc = params->rc;
+    VkResult res = vk->CopyImageToMemoryEXT(vk->dev, &(VkCopyImageToMemoryInfoEXT) {
+        .sType = VK_STRUCTURE_TYPE_COPY_IMAGE_TO_MEMORY_INFO_EXT,
+        .srcImage = tex_vk->img,
+        .srcImageLayout = tex_vk->layout,
+        .regionCount = 1,
+        .pRegions = &(VkImageToMemoryCopyEXT) {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_TO_MEMORY_COPY_EXT,
+            .pHostPointer = params->ptr,
+            .memoryRowLength = params->row_pitch / fmt->texel_size,
+            .memoryImageHeight = params->depth_pitch / params->row_pitch,
+            .imageSubresource = {
+                .aspectMask = tex_vk->aspect,
+                .baseArrayLayer = tex_vk->layer,
+                .layerCount = 1,
+            },
+            .imageOffset = { rc.x0, rc.y0, rc.z0 },
+            .imageExtent = { rc.x1 - rc.x0, rc.y1 - rc.y0, rc.z1 - rc.z0 },
+        },
+    });
+
+    if (res != VK_SUCCESS)
+        return false;
+    if (params->callback)
+        params->callback(params->priv);
+    return true;
+}
+
+#endif // VK_EXT_host_image_copy
+
 bool vk_tex_upload(pl_gpu gpu, const struct pl_tex_transfer_params *params)
 {
     struct pl_vk *p = PL_PRIV(gpu);
@@ -863,6 +1052,11 @@ bool vk_tex_upload(pl_gpu gpu, const struct pl_tex_transfer_params *params)
     struct pl_tex_transfer_params *slices = NULL;
     int num_slices = 0;
 
+#ifdef VK_EXT_host_image_copy
+    if (host_copy_upload(gpu, params))
+        return true;
+#endif
+
     if (!params->buf)
         return pl_tex_upload_pbo(gpu, params);
 
@@ -905,13 +1099,16 @@ bool vk_tex_upload(pl_gpu gpu, const struct pl_tex_transfer_params *params)
                        VK_ACCESS_2_TRANSFER_READ_BIT, params->buf_offset, size,
                        false);
 
+        for (int i = 0; i < num_slices; i++) {
+            vk_buf_barrier(gpu, cmd, slices[i].buf, VK_PIPELINE_STAGE_2_COPY_BIT,
+                           VK_ACCESS_2_TRANSFER_WRITE_BIT, 0,
+                           slices[i].buf->params.size, false);
+        }
+
+        vk_cmd_flush_barriers(cmd);
         for (int i = 0; i < num_slices; i++) {
             pl_buf slice = slices[i].buf;
             struct pl_buf_vk *slice_vk = PL_PRIV(slice);
-            vk_buf_barrier(gpu, cmd, slice, VK_PIPELINE_STAGE_2_COPY_BIT,
-                           VK_ACCESS_2_TRANSFER_WRITE_BIT, 0, slice->params.size,
-                           false);
-
             vk->CmdCopyBuffer(cmd->buf, buf_vk->mem.buf, slice_vk->mem.buf, 1, &(VkBufferCopy) {
                 .srcOffset = buf_vk->mem.offset + slices[i].buf_offset,
                 .dstOffset = slice_vk->mem.offset,
@@ -950,6 +1147,7 @@ bool vk_tex_upload(pl_gpu gpu, const struct pl_tex_transfer_params *params)
             .imageExtent = { rc.x1, rc.y1, rc.z1 },
             .imageSubresource = {
                 .aspectMask = tex_vk->aspect,
+                .baseArrayLayer = tex_vk->layer,
                 .layerCount = 1,
             },
         };
@@ -966,6 +1164,7 @@ bool vk_tex_upload(pl_gpu gpu, const struct pl_tex_transfer_params *params)
                        VK_ACCESS_2_TRANSFER_WRITE_BIT,
                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                        VK_QUEUE_FAMILY_IGNORED);
+        vk_cmd_flush_barriers(cmd);
         vk->CmdCopyBufferToImage(cmd->buf, buf_vk->mem.buf, tex_vk->img,
                                  tex_vk->layout, 1, &region);
 
@@ -994,6 +1193,11 @@ bool vk_tex_download(pl_gpu gpu, const struct pl_tex_transfer_params *params)
     struct pl_tex_transfer_params *slices = NULL;
     int num_slices = 0;
 
+#ifdef VK_EXT_host_image_copy
+    if (host_copy_download(gpu, params))
+        return true;
+#endif
+
     if (!params->buf)
         return pl_tex_download_pbo(gpu, params);
 
@@ -1046,13 +1250,16 @@ bool vk_tex_download(pl_gpu gpu, const struct pl_tex_transfer_params *params)
                        VK_ACCESS_2_TRANSFER_WRITE_BIT, params->buf_offset, size,
                        false);
 
+        for (int i = 0; i < num_slices; i++) {
+            vk_buf_barrier(gpu, cmd, slices[i].buf, VK_PIPELINE_STAGE_2_COPY_BIT,
+                           VK_ACCESS_2_TRANSFER_READ_BIT, 0,
+                           slices[i].buf->params.size, false);
+        }
+
+        vk_cmd_flush_barriers(cmd);
         for (int i = 0; i < num_slices; i++) {
             pl_buf slice = slices[i].buf;
             struct pl_buf_vk *slice_vk = PL_PRIV(slice);
-            vk_buf_barrier(gpu, cmd, slice, VK_PIPELINE_STAGE_2_COPY_BIT,
-                           VK_ACCESS_2_TRANSFER_READ_BIT, 0, slice->params.size,
-                           false);
-
             vk->CmdCopyBuffer(cmd->buf, slice_vk->mem.buf, buf_vk->mem.buf, 1, &(VkBufferCopy) {
                 .srcOffset = slice_vk->mem.offset,
                 .dstOffset = buf_vk->mem.offset + slices[i].buf_offset,
@@ -1082,6 +1289,7 @@ bool vk_tex_download(pl_gpu gpu, const struct pl_tex_transfer_params *params)
             .imageExtent = { rc.x1, rc.y1, rc.z1 },
             .imageSubresource = {
                 .aspectMask = tex_vk->aspect,
+                .baseArrayLayer = tex_vk->layer,
                 .layerCount = 1,
             },
         };
@@ -1099,6 +1307,7 @@ bool vk_tex_download(pl_gpu gpu, const struct pl_tex_transfer_params *params)
                        VK_ACCESS_2_TRANSFER_READ_BIT,
                        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
                        VK_QUEUE_FAMILY_IGNORED);
+        vk_cmd_flush_barriers(cmd);
         vk->CmdCopyImageToBuffer(cmd->buf, tex_vk->img, tex_vk->layout,
                                  buf_vk->mem.buf, 1, &region);
         vk_buf_flush(gpu, cmd, buf, params->buf_offset, size);
@@ -1260,6 +1469,7 @@ pl_tex pl_vulkan_wrap(pl_gpu gpu, const struct pl_vulkan_wrap_params *params)
     tex_vk->num_planes = fmt->num_planes;
     tex_vk->usage_flags = usage;
     tex_vk->aspect = params->aspect;
+    tex_vk->layer = params->layer;
 
     if (!tex_vk->aspect) {
         for (int i = 0; i < tex_vk->num_planes; i++)
@@ -1295,6 +1505,7 @@ pl_tex pl_vulkan_wrap(pl_gpu gpu, const struct pl_vulkan_wrap_params *params)
             .height     = PL_RSHIFT_UP(tex->params.h, fmt->planes[i].shift_y),
             .format     = fmtp->vk_fmt->pfmt[i].fmt,
             .usage      = params->usage,
+            .layer      = params->layer,
             .user_data  = params->user_data,
             .debug_tag  = PL_DEF(params->debug_tag, wrapped_plane_names[i]),
         ));
@@ -1451,3 +1662,180 @@ void pl_vulkan_release(pl_gpu gpu, pl_tex tex, VkImageLayout layout,
         .qf         = VK_QUEUE_FAMILY_IGNORED,
     ));
 }
+
+struct pl_vulkan_shared_pool_t {
+    pl_gpu gpu;
+    bool imported;
+    struct pl_vulkan_shared_pool_desc desc;
+    pl_tex tex[PL_VULKAN_SHARED_POOL_MAX];
+    VkSemaphore sem[PL_VULKAN_SHARED_POOL_MAX];
+    uint64_t value[PL_VULKAN_SHARED_POOL_MAX]; // last used semaphore value
+};
+
+pl_vulkan_shared_pool pl_vulkan_shared_pool_create(pl_gpu gpu,
+                                const struct pl_vulkan_shared_pool_params *params)
+{
+    const struct pl_vulkan_shared_pool_desc *import = params->import;
+    struct pl_tex_params tparams = *params->tex;
+    pl_vulkan_shared_pool pool = pl_zalloc_ptr(NULL, pool);
+    pool->gpu = gpu;
+    pool->imported = import;
+
+    if (import) {
+        pool->desc = *import;
+        tparams.w = import->width;
+        tparams.h = import->height;
+        tparams.format = pl_find_named_fmt(gpu, import->format);
+        tparams.export_handle = 0;
+        tparams.import_handle = import->mem_handle;
+        if (!tparams.format) {
+            PL_ERR(gpu, "Shared pool format '%s' is not supported!", import->format);
+            goto error;
+        }
+    } else {
+        pool->desc = (struct pl_vulkan_shared_pool_desc) {
+            .num_frames = params->num_frames,
+            .width      = tparams.w,
+            .height     = tparams.h,
+            .mem_handle = tparams.export_handle,
+            .sem_handle = params->sem_handle,
+        };
+        snprintf(pool->desc.format, sizeof(pool->desc.format), "%s",
+                 tparams.format->name);
+        if (!tparams.export_handle || !params->sem_handle) {
+            PL_ERR(gpu, "Shared pools require `export_handle` and `sem_handle`!");
+            goto error;
+        }
+    }
+
+    const int num_frames = pool->desc.num_frames;
+    if (num_frames < 1 || num_frames > PL_VULKAN_SHARED_POOL_MAX) {
+        PL_ERR(gpu, "Invalid shared pool size %d, must be between 1 and %d!",
+               num_frames, PL_VULKAN_SHARED_POOL_MAX);
+        goto error;
+    }
+
+    if (tparams.format->num_planes || tparams.d || !tparams.h) {
+        PL_ERR(gpu, "Shared pools only support non-planar 2D textures!");
+        goto error;
+    }
+
+    for (int i = 0; i < num_frames; i++) {
+        if (import)
+            tparams.shared_mem = import->mem[i];
+        pool->tex[i] = pl_tex_create(gpu, &tparams);
+        if (!pool->tex[i])
+            goto error;
+
+        pool->sem[i] = pl_vulkan_sem_create(gpu, pl_vulkan_sem_params(
+            .type           = VK_SEMAPHORE_TYPE_TIMELINE,
+            .export_handle  = import ? 0 : params->sem_handle,
+            .out_handle     = &pool->desc.sem[i],
+            .import_handle  = import ? import->sem_handle : 0,
+            .import         = import ? import->sem[i] : (union pl_handle) {0},
+            .debug_tag      = PL_DEF(tparams.debug_tag, "shared pool"),
+        ));
+        if (!pool->sem[i])
+            goto error;
+
+        if (import) {
+            // Frames of imported pools start out owned by the peer
+            struct pl_tex_vk *tex_vk = PL_PRIV(pool->tex[i]);
+            tex_vk->held = true;
+        } else {
+            pool->desc.mem[i] = pool->tex[i]->shared_mem;
+        }
+    }
+
+    return pool;
+
+error:
+    pl_vulkan_shared_pool_destroy(&pool);
+    return NULL;
+}
+
+void pl_vulkan_shared_pool_destroy(pl_vulkan_shared_pool *ppool)
+{
+    pl_vulkan_shared_pool pool = *ppool;
+    if (!pool)
+        return;
+
+    pl_gpu gpu = pool->gpu;
+    pl_gpu_finish(gpu); // semaphores may still be in use
+    for (int i = 0; i < PL_VULKAN_SHARED_POOL_MAX; i++) {
+        pl_tex_destroy(gpu, &pool->tex[i]);
+        if (!pool->sem[i])
+            continue;
+
+        pl_vulkan_sem_destroy(gpu, &pool->sem[i]);
+        if (pool->imported)
+            continue;
+
+#ifdef PL_HAVE_UNIX
+        if (pool->desc.sem_handle == PL_HANDLE_FD && pool->desc.sem[i].fd > -1)
+            close(pool->desc.sem[i].fd);
+#endif
+#ifdef PL_HAVE_WIN32
+        if (pool->desc.sem_handle == PL_HANDLE_WIN32 && pool->desc.sem[i].handle)
+            CloseHandle(pool->desc.sem[i].handle);
+        // PL_HANDLE_WIN32_KMT is just an identifier. It doesn't get closed.
+#endif
+    }
+
+    pl_free(pool);
+    *ppool = NULL;
+}
+
+const struct pl_vulkan_shared_pool_desc *
+pl_vulkan_shared_pool_desc(pl_vulkan_shared_pool pool)
+{
+    return &pool->desc;
+}
+
+pl_tex pl_vulkan_shared_pool_tex(pl_vulkan_shared_pool pool, int index)
+{
+    pl_assert(index >= 0 && index < pool->desc.num_frames);
+    return pool->tex[index];
+}
+
+bool pl_vulkan_shared_pool_send(pl_vulkan_shared_pool pool, int index,
+                                uint64_t *out_value)
+{
+    pl_assert(index >= 0 && index < pool->desc.num_frames);
+    const uint64_t value = pool->value[index] + 1;
+    bool ok = pl_vulkan_hold_ex(pool->gpu, pl_vulkan_hold_params(
+        .tex        = pool->tex[index],
+        .layout     = VK_IMAGE_LAYOUT_GENERAL,
+        .qf         = VK_QUEUE_FAMILY_EXTERNAL,
+        .semaphore  = { pool->sem[index], value },
+    ));
+
+    if (!ok)
+        return false;
+
+    pool->value[index] = value;
+    *out_value = value;
+    return true;
+}
+
+bool pl_vulkan_shared_pool_recv(pl_vulkan_shared_pool pool, int index,
+                                uint64_t value)
+{
+    pl_assert(index >= 0 && index < pool->desc.num_frames);
+    struct pl_tex_vk *tex_vk = PL_PRIV(pool->tex[index]);
+    if (!tex_vk->held || value <= pool->value[index]) {
+        PL_ERR(pool->gpu, "Received shared pool frame %d (value %"PRIu64") "
+               "that is not owned by the peer!", index, value);
+        return false;
+    }
+
+    pl_vulkan_release_ex(pool->gpu, pl_vulkan_release_params(
+        .tex        = pool->tex[index],
+        .layout     = VK_IMAGE_LAYOUT_GENERAL,
+        .qf         = VK_QUEUE_FAMILY_EXTERNAL,
+        .semaphore  = { pool->sem[index], value },
+    ));
+
+    pool->value[index] = value;
+    return true;
+}
@@ -18,6 +18,7 @@
 #include "malloc.h"
 #include "command.h"
 #include "utils.h"
+#include "hash.h"
 #include "pl_thread.h"
 
 #ifdef PL_HAVE_UNIX
@@ -25,17 +26,17 @@
 #include <unistd.h>
 #endif
 
-// Controls the page size alignment, to help coalesce allocations into the same
-// slab. Pages are rounded up to multiples of this value. (Default: 4 KB)
-#define PAGE_SIZE_ALIGN (1LLU << 12)
+// Controls the minimum block size of the buddy allocator used to sub-allocate
+// slabs. Allocations are rounded up to power-of-two multiples of this value,
+// the exponent of which is called the block's "order". (Default: 4 KB)
+#define MINIMUM_BLOCK_SIZE (1LLU << 12)
+#define BLOCK_SIZE(order) (MINIMUM_BLOCK_SIZE << (order))
+#define MAXIMUM_BLOCK_ORDERS 32
 
-// Controls the minimum/maximum number of pages for new slabs. As slabs are
-// exhausted of memory, the number of pages per new slab grows exponentially,
-// starting with the minimum until the maximum is reached.
-//
-// Note: The maximum must never exceed the size of `vk_slab.spacemap`.
+// Controls the minimum number of blocks (of the requested size) for new slabs.
+// As slabs are exhausted of memory, the size of new slabs grows exponentially,
+// up to a maximum of MINIMUM_PAGE_COUNT times the maximum page size.
 #define MINIMUM_PAGE_COUNT 4
-#define MAXIMUM_PAGE_COUNT (sizeof(uint64_t) * 8)
 
 // Controls the maximum page size. Any allocations above this threshold
 // (absolute size or fraction of VRAM, whichever is higher) will be served by
@@ -51,6 +52,16 @@
 // this many invocations of `vk_malloc_garbage_collect` will be released.
 #define MAXIMUM_SLAB_AGE 32
 
+// Fraction of a heap's budget above which the heap is considered to be under
+// memory pressure, and empty slabs are released immediately.
+#define MEMORY_PRESSURE_THRESHOLD 0.9
+
+// Fraction of a host-visible, device-local heap (e.g. the PCIe BAR, or all of
+// VRAM with resizable BAR) above which allocations that merely *prefer* such
+// memory spill over into other memory types, so they don't starve allocations
+// that strictly require it.
+#define HOST_VRAM_BUDGET 0.5
+
 // A single slab represents a contiguous region of allocated memory. Actual
 // allocations are served as pages of this. Slabs are organized into pools,
 // each of which contains a list of slabs of differing page sizes.
@@ -63,9 +74,12 @@ struct vk_slab {
     bool dedicated;         // slab is allocated specifically for one object
     bool imported;          // slab represents an imported memory allocation
 
-    // free space accounting (only for non-dedicated slabs)
-    uint64_t spacemap;      // bitset of available pages
-    size_t pagesize;        // size in bytes per page
+    // free space accounting (only for non-dedicated slabs), using a binary
+    // buddy allocator whose root block spans the entire slab
+    int order;              // order of the root block
+    uint64_t *freemap[MAXIMUM_BLOCK_ORDERS]; // bitset of free blocks, per order
+    int num_free[MAXIMUM_BLOCK_ORDERS];      // number of free blocks, per order
+    size_t reserved;        // number of bytes in handed out blocks
     size_t used;            // number of bytes actually in use
     uint64_t age;           // timestamp of last use
 
@@ -80,12 +94,16 @@ struct vk_slab {
 // Represents a single memory pool. We keep track of a vk_pool for each
 // combination of malloc parameters. This shouldn't actually be that many in
 // practice, because some combinations simply never occur, and others will
-// generally be the same for the same objects.
+// generally be the same for the same objects. Allocations of all sizes share
+// the same slabs within a pool.
 //
-// Note: `vk_pool` addresses are not immutable, so we mustn't expose any
-// dangling references to a `vk_pool` from e.g. `vk_memslice.priv = vk_slab`.
+// Pools are never freed before the vk_malloc itself, so their addresses are
+// stable. Each pool has its own lock, so allocations from different pools
+// don't contend with each other.
 struct vk_pool {
+    pl_mutex lock;                    // protects `slabs`
     struct vk_malloc_params params;   // allocation params (with some fields nulled)
+    uint64_t hash;                    // hash of `params`, for fast lookup
     PL_ARRAY(struct vk_slab *) slabs; // array of slabs, unsorted
     int index;                        // running index in `vk_malloc.pools`
 };
@@ -94,11 +112,15 @@ struct vk_pool {
 // memory type.
 struct vk_malloc {
     struct vk_ctx *vk;
-    pl_mutex lock;
+    pl_mutex lock; // protects `pools`, but not the pools' contents
     VkPhysicalDeviceMemoryProperties props;
     size_t maximum_page_size;
-    PL_ARRAY(struct vk_pool) pools;
+    int maximum_slab_order;
+    PL_ARRAY(struct vk_pool *) pools;
     uint64_t age;
+
+    // Bytes allocated by us per heap, excluding imported memory
+    _Atomic uint64_t heap_usage[VK_MAX_MEMORY_HEAPS];
 };
 
 static inline float efficiency(size_t used, size_t total)
@@ -109,6 +131,112 @@ static inline float efficiency(size_t used, size_t total)
     return 100.0f * used / total;
 }
 
+// Returns the smallest block order that can hold `size` bytes
+static inline int block_order(size_t size)
+{
+    size_t blocks = PL_DIV_UP(size, MINIMUM_BLOCK_SIZE);
+    int order = 0;
+    while (((size_t) 1 << order) < blocks)
+        order++;
+    return order;
+}
+
+static inline bool block_is_free(const struct vk_slab *slab, int order, size_t idx)
+{
+    return slab->freemap[order][idx >> 6] & (1LLU << (idx & 63));
+}
+
+static inline void block_set_free(struct vk_slab *slab, int order, size_t idx)
+{
+    slab->freemap[order][idx >> 6] |= 1LLU << (idx & 63);
+    slab->num_free[order]++;
+}
+
+static inline void block_set_used(struct vk_slab *slab, int order, size_t idx)
+{
+    slab->freemap[order][idx >> 6] &= ~(1LLU << (idx & 63));
+    slab->num_free[order]--;
+}
+
+static void buddy_init(struct vk_slab *slab, int order)
+{
+    pl_assert(order < MAXIMUM_BLOCK_ORDERS);
+    slab->order = order;
+    for (int o = 0; o <= order; o++) {
+        size_t num_blocks = (size_t) 1 << (order - o);
+        slab->freemap[o] = pl_calloc(slab, PL_DIV_UP(num_blocks, 64), sizeof(uint64_t));
+    }
+
+    block_set_free(slab, order, 0);
+}
+
+static inline bool buddy_can_alloc(const struct vk_slab *slab, int order)
+{
+    for (int o = order; o <= slab->order; o++) {
+        if (slab->num_free[o])
+            return true;
+    }
+
+    return false;
+}
+
+// Finds and reserves a free block of the given order, splitting larger blocks
+// as needed. Returns false if the slab has no suitable space left.
+static bool buddy_alloc(struct vk_slab *slab, int order, VkDeviceSize *offset)
+{
+    int o = order;
+    while (o <= slab->order && !slab->num_free[o])
+        o++;
+    if (o > slab->order)
+        return false;
+
+    size_t idx = 0;
+    const uint64_t *map = slab->freemap[o];
+    while (!map[idx >> 6])
+        idx += 64;
+    idx += __builtin_ctzll(map[idx >> 6]);
+    block_set_used(slab, o, idx);
+
+    // Split the block down to the requested size, keeping the upper halves
+    while (o > order) {
+        o--;
+        idx <<= 1;
+        block_set_free(slab, o, idx + 1);
+    }
+
+    slab->reserved += BLOCK_SIZE(order);
+    *offset = idx * BLOCK_SIZE(order);
+    return true;
+}
+
+// Releases a block previously returned by `buddy_alloc`, merging it with its
+// buddies as far as possible.
+static void buddy_free(struct vk_slab *slab, VkDeviceSize offset, int order)
+{
+    pl_assert(offset % BLOCK_SIZE(order) == 0);
+    size_t idx = offset / BLOCK_SIZE(order);
+    slab->reserved -= BLOCK_SIZE(order);
+
+    while (order < slab->order && block_is_free(slab, order, idx ^ 1)) {
+        block_set_used(slab, order, idx ^ 1);
+        idx >>= 1;
+        order++;
+    }
+
+    pl_assert(!block_is_free(slab, order, idx));
+    block_set_free(slab, order, idx);
+}
+
+static inline size_t buddy_largest_free(const struct vk_slab *slab)
+{
+    for (int o = slab->order; o >= 0; o--) {
+        if (slab->num_free[o])
+            return BLOCK_SIZE(o);
+    }
+
+    return 0;
+}
+
 static const char *print_size(char buf[8], size_t size)
 {
     const char *suffixes = "\0KMG";
@@ -148,7 +276,7 @@ void vk_malloc_print_stats(struct vk_malloc *ma, enum pl_log_level lev)
 
     pl_mutex_lock(&ma->lock);
     for (int i = 0; i < ma->pools.num; i++) {
-        struct vk_pool *pool = &ma->pools.elem[i];
+        struct vk_pool *pool = ma->pools.elem[i];
         const struct vk_malloc_params *par = &pool->params;
 
         PL_MSG(vk, lev, "Memory pool %d:", i);
@@ -166,16 +294,16 @@ void vk_malloc_print_stats(struct vk_malloc *ma, enum pl_log_level lev)
         size_t pool_used = 0;
         size_t pool_res = 0;
 
+        pl_mutex_lock(&pool->lock);
         for (int j = 0; j < pool->slabs.num; j++) {
             struct vk_slab *slab = pool->slabs.elem[j];
             pl_mutex_lock(&slab->lock);
 
-            size_t avail = __builtin_popcountll(slab->spacemap) * slab->pagesize;
-            size_t slab_res = slab->size - avail;
+            size_t slab_res = slab->reserved;
 
-            PL_MSG(vk, lev, "    Slab %2d: %8"PRIx64" x %s: "
+            PL_MSG(vk, lev, "    Slab %2d: largest free %s: "
                    "%s used %s res %s alloc from heap %d, efficiency %.2f%%  [%s]",
-                   j, slab->spacemap, PRINT_SIZE(slab->pagesize),
+                   j, PRINT_SIZE(buddy_largest_free(slab)),
                    PRINT_SIZE(slab->used), PRINT_SIZE(slab_res),
                    PRINT_SIZE(slab->size), (int) slab->mtype.heapIndex,
                    efficiency(slab->used, slab_res),
@@ -186,6 +314,7 @@ void vk_malloc_print_stats(struct vk_malloc *ma, enum pl_log_level lev)
             pool_res += slab_res;
             pl_mutex_unlock(&slab->lock);
         }
+        pl_mutex_unlock(&pool->lock);
 
         PL_MSG(vk, lev, "    Pool summary: %s used %s res %s alloc, "
                "efficiency %.2f%%, utilization %.2f%%",
@@ -207,8 +336,9 @@ void vk_malloc_print_stats(struct vk_malloc *ma, enum pl_log_level lev)
            PRINT_SIZE(ma->maximum_page_size));
 }
 
-static void slab_free(struct vk_ctx *vk, struct vk_slab *slab)
+static void slab_free(struct vk_malloc *ma, struct vk_slab *slab)
 {
+    struct vk_ctx *vk = ma->vk;
     if (!slab)
         return;
 
@@ -276,6 +406,9 @@ static void slab_free(struct vk_ctx *vk, struct vk_slab *slab)
         PL_DEBUG(vk, "Freeing slab of size %s", PRINT_SIZE(slab->size));
     }
 
+    if (!slab->imported && slab->mem)
+        atomic_fetch_sub(&ma->heap_usage[slab->mtype.heapIndex], slab->size);
+
     vk->DestroyBuffer(vk->dev, slab->buffer, PL_VK_ALLOC);
     // also implicitly unmaps the memory if needed
     vk->FreeMemory(vk->dev, slab->mem, PL_VK_ALLOC);
@@ -286,7 +419,7 @@ static void slab_free(struct vk_ctx *vk, struct vk_slab *slab)
 
 // type_mask: optional
 // thread-safety: safe
-static bool find_best_memtype(const struct vk_malloc *ma, uint32_t type_mask,
+static bool find_best_memtype(struct vk_malloc *ma, uint32_t type_mask,
                               const struct vk_malloc_params *params,
                               uint32_t *out_index)
 {
@@ -299,27 +432,43 @@ static bool find_best_memtype(const struct vk_malloc *ma, uint32_t type_mask,
     // better optional flags.
 
     type_mask &= params->reqs.memoryTypeBits;
-    for (int i = 0; i < ma->props.memoryTypeCount; i++) {
-        const VkMemoryType *mtype = &ma->props.memoryTypes[i];
+    const VkMemoryPropertyFlags host_vram = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    bool need_host_vram = (params->required & host_vram) == host_vram;
+
+    // The first pass skips host-visible VRAM over budget, the second pass
+    // only happens if nothing else was suitable
+    for (int pass = 0; pass < 2 && best < 0; pass++) {
+        for (int i = 0; i < ma->props.memoryTypeCount; i++) {
+            const VkMemoryType *mtype = &ma->props.memoryTypes[i];
+
+            // The memory type flags must include our properties
+            if ((mtype->propertyFlags & params->required) != params->required)
+                continue;
 
-        // The memory type flags must include our properties
-        if ((mtype->propertyFlags & params->required) != params->required)
-            continue;
+            // The memory heap must be large enough for the allocation
+            VkDeviceSize heapSize = ma->props.memoryHeaps[mtype->heapIndex].size;
+            if (params->reqs.size > heapSize)
+                continue;
 
-        // The memory heap must be large enough for the allocation
-        VkDeviceSize heapSize = ma->props.memoryHeaps[mtype->heapIndex].size;
-        if (params->reqs.size > heapSize)
-            continue;
+            // The memory type must be supported by the type mask (bitfield)
+            if (!(type_mask & (1LU << i)))
+                continue;
 
-        // The memory type must be supported by the type mask (bitfield)
-        if (!(type_mask & (1LU << i)))
-            continue;
+            if (!pass && !need_host_vram &&
+                (mtype->propertyFlags & host_vram) == host_vram)
+            {
+                uint64_t usage = atomic_load(&ma->heap_usage[mtype->heapIndex]);
+                if (usage + params->reqs.size > heapSize * HOST_VRAM_BUDGET)
+                    continue;
+            }
 
-        // Calculate the score as the number of optimal property flags matched
-        int score = __builtin_popcountl(mtype->propertyFlags & params->optimal);
-        if (score > best) {
-            *out_index = i;
-            best = score;
+            // Calculate the score as the number of optimal property flags matched
+            int score = __builtin_popcountl(mtype->propertyFlags & params->optimal);
+            if (score > best) {
+                *out_index = i;
+                best = score;
+            }
         }
     }
 
@@ -451,6 +600,14 @@ static struct vk_slab *slab_alloc(struct vk_malloc *ma,
     if (params->ded_image)
         vk_link_struct(&minfo, &dinfo);
 
+    VkMemoryAllocateFlagsInfo finfo = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO,
+        .flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT,
+    };
+
+    if (params->buf_usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT)
+        vk_link_struct(&minfo, &finfo);
+
     if (!find_best_memtype(ma, type_mask, params, &minfo.memoryTypeIndex))
         goto error;
 
@@ -478,6 +635,7 @@ static struct vk_slab *slab_alloc(struct vk_malloc *ma,
     }
 
     slab->mtype = *mtype;
+    atomic_fetch_add(&ma->heap_usage[mtype->heapIndex], slab->size);
     if (mtype->propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
         VK(vk->MapMemory(vk->dev, slab->mem, 0, VK_WHOLE_SIZE, 0, &slab->data));
         slab->coherent = mtype->propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
@@ -523,17 +681,18 @@ static struct vk_slab *slab_alloc(struct vk_malloc *ma,
 error:
     if (params->debug_tag)
         PL_ERR(vk, "  for malloc: %s", params->debug_tag);
-    slab_free(vk, slab);
+    slab_free(ma, slab);
     return NULL;
 }
 
-static void pool_uninit(struct vk_ctx *vk, struct vk_pool *pool)
+static void pool_uninit(struct vk_malloc *ma, struct vk_pool *pool)
 {
     for (int i = 0; i < pool->slabs.num; i++)
-        slab_free(vk, pool->slabs.elem[i]);
+        slab_free(ma, pool->slabs.elem[i]);
 
     pl_free(pool->slabs.elem);
-    *pool = (struct vk_pool) {0};
+    pl_mutex_destroy(&pool->lock);
+    pl_free(pool);
 }
 
 struct vk_malloc *vk_malloc_create(struct vk_ctx *vk)
@@ -553,6 +712,14 @@ struct vk_malloc *vk_malloc_create(struct vk_ctx *vk)
         }
     }
 
+    // Largest power-of-two slab that fits MINIMUM_PAGE_COUNT maximum pages
+    const VkDeviceSize max_slab_size = ma->maximum_page_size * MINIMUM_PAGE_COUNT;
+    while (ma->maximum_slab_order + 1 < MAXIMUM_BLOCK_ORDERS &&
+           BLOCK_SIZE(ma->maximum_slab_order + 1) <= max_slab_size)
+    {
+        ma->maximum_slab_order++;
+    }
+
     vk_malloc_print_stats(ma, PL_LOG_INFO);
     return ma;
 }
@@ -565,25 +732,71 @@ void vk_malloc_destroy(struct vk_malloc **ma_ptr)
 
     vk_malloc_print_stats(ma, PL_LOG_DEBUG);
     for (int i = 0; i < ma->pools.num; i++)
-        pool_uninit(ma->vk, &ma->pools.elem[i]);
+        pool_uninit(ma, ma->pools.elem[i]);
 
     pl_mutex_destroy(&ma->lock);
     pl_free_ptr(ma_ptr);
 }
 
+int vk_malloc_query_budget(struct vk_malloc *ma,
+                           struct pl_vulkan_heap_budget out[VK_MAX_MEMORY_HEAPS])
+{
+    struct vk_ctx *vk = ma->vk;
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT,
+    };
+
+    if (vk->memory_budget) {
+        vk->GetPhysicalDeviceMemoryProperties2(vk->physd, &(VkPhysicalDeviceMemoryProperties2) {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+            .pNext = &budget,
+        });
+    }
+
+    for (int i = 0; i < ma->props.memoryHeapCount; i++) {
+        const VkMemoryHeap *heap = &ma->props.memoryHeaps[i];
+        out[i] = (struct pl_vulkan_heap_budget) {
+            .flags  = heap->flags,
+            .size   = heap->size,
+            .budget = heap->size,
+            .usage  = atomic_load(&ma->heap_usage[i]),
+        };
+
+        if (vk->memory_budget) {
+            out[i].budget = budget.heapBudget[i];
+            out[i].usage = budget.heapUsage[i];
+        }
+    }
+
+    return ma->props.memoryHeapCount;
+}
+
 void vk_malloc_garbage_collect(struct vk_malloc *ma)
 {
     struct vk_ctx *vk = ma->vk;
 
+    // Check which heaps, if any, are running out of memory
+    struct pl_vulkan_heap_budget heaps[VK_MAX_MEMORY_HEAPS];
+    int num_heaps = vk_malloc_query_budget(ma, heaps);
+    uint32_t pressure = 0;
+    for (int i = 0; i < num_heaps; i++) {
+        if (heaps[i].usage > heaps[i].budget * MEMORY_PRESSURE_THRESHOLD)
+            pressure |= 1u << i;
+    }
+
     pl_mutex_lock(&ma->lock);
     ma->age++;
 
     for (int i = 0; i < ma->pools.num; i++) {
-        struct vk_pool *pool = &ma->pools.elem[i];
+        struct vk_pool *pool = ma->pools.elem[i];
+        pl_mutex_lock(&pool->lock);
         for (int n = 0; n < pool->slabs.num; n++) {
             struct vk_slab *slab = pool->slabs.elem[n];
             pl_mutex_lock(&slab->lock);
-            if (slab->used || (ma->age - slab->age) <= MAXIMUM_SLAB_AGE) {
+            bool expired = (ma->age - slab->age) > MAXIMUM_SLAB_AGE;
+            if (pressure & (1u << slab->mtype.heapIndex))
+                expired = true;
+            if (slab->used || !expired) {
                 pl_mutex_unlock(&slab->lock);
                 continue;
             }
@@ -592,12 +805,23 @@ void vk_malloc_garbage_collect(struct vk_malloc *ma)
                      PRINT_SIZE(slab->size), pool->index);
 
             pl_mutex_unlock(&slab->lock);
-            slab_free(ma->vk, slab);
+            slab_free(ma, slab);
             PL_ARRAY_REMOVE_AT(pool->slabs, n--);
         }
+        pl_mutex_unlock(&pool->lock);
     }
 
     pl_mutex_unlock(&ma->lock);
+
+    for (int i = 0; pressure && i < num_heaps; i++) {
+        if (!(pressure & (1u << i)))
+            continue;
+
+        PL_DEBUG(vk, "Memory heap %d under pressure: %s used of %s budget",
+                 i, PRINT_SIZE(heaps[i].usage), PRINT_SIZE(heaps[i].budget));
+        if (vk->memory_pressure)
+            vk->memory_pressure(vk->memory_pressure_priv, i, &heaps[i]);
+    }
 }
 
 pl_handle_caps vk_malloc_handle_caps(const struct vk_malloc *ma, bool import)
@@ -620,17 +844,15 @@ pl_handle_caps vk_malloc_handle_caps(const struct vk_malloc *ma, bool import)
 
 void vk_malloc_free(struct vk_malloc *ma, struct vk_memslice *slice)
 {
-    struct vk_ctx *vk = ma->vk;
     struct vk_slab *slab = slice->priv;
     if (!slab || slab->dedicated) {
-        slab_free(vk, slab);
+        slab_free(ma, slab);
         goto done;
     }
 
     pl_mutex_lock(&slab->lock);
 
-    int page_idx = slice->offset / slab->pagesize;
-    slab->spacemap |= 0x1LLU << page_idx;
+    buddy_free(slab, slice->offset, block_order(slice->size));
     slab->used -= slice->size;
     slab->age = ma->age;
     pl_assert(slab->used >= 0);
@@ -653,6 +875,18 @@ static inline bool pool_params_eq(const struct vk_malloc_params *a,
            a->export_handle == b->export_handle;
 }
 
+static inline uint64_t pool_params_hash(const struct vk_malloc_params *par)
+{
+    uint64_t hash = 0;
+    pl_hash_merge(&hash, par->reqs.memoryTypeBits);
+    pl_hash_merge(&hash, par->required);
+    pl_hash_merge(&hash, par->optimal);
+    pl_hash_merge(&hash, par->buf_usage);
+    pl_hash_merge(&hash, par->export_handle);
+    return hash;
+}
+
+// thread-safety: safe
 static struct vk_pool *find_pool(struct vk_malloc *ma,
                                  const struct vk_malloc_params *params)
 {
@@ -664,86 +898,97 @@ static struct vk_pool *find_pool(struct vk_malloc *ma,
     fixed.reqs.size = 0;
     fixed.shared_mem = (struct pl_shared_mem) {0};
 
+    uint64_t hash = pool_params_hash(&fixed);
+
+    pl_mutex_lock(&ma->lock);
     for (int i = 0; i < ma->pools.num; i++) {
-        if (pool_params_eq(&ma->pools.elem[i].params, &fixed))
-            return &ma->pools.elem[i];
+        struct vk_pool *pool = ma->pools.elem[i];
+        if (pool->hash == hash && pool_params_eq(&pool->params, &fixed)) {
+            pl_mutex_unlock(&ma->lock);
+            return pool;
+        }
     }
 
     // Not found => add it
-    PL_ARRAY_GROW(ma, ma->pools);
-    size_t idx = ma->pools.num++;
-    ma->pools.elem[idx] = (struct vk_pool) {
+    struct vk_pool *pool = pl_alloc_ptr(NULL, pool);
+    *pool = (struct vk_pool) {
         .params = fixed,
-        .index = idx,
+        .hash = hash,
+        .index = ma->pools.num,
     };
-    return &ma->pools.elem[idx];
+    pl_mutex_init(&pool->lock);
+    PL_ARRAY_APPEND(ma, ma->pools, pool);
+    pl_mutex_unlock(&ma->lock);
+    return pool;
 }
 
-// Returns a suitable memory page from the pool. A new slab will be allocated
-// under the hood, if necessary.
+// Returns a slab with a free block of the given order from the pool. A new
+// slab will be allocated under the hood, if necessary.
 //
-// Note: This locks the slab it returns
-static struct vk_slab *pool_get_page(struct vk_malloc *ma, struct vk_pool *pool,
-                                     size_t size, size_t align,
-                                     VkDeviceSize *offset)
+// Note: This must be called with `pool->lock` held, and locks the slab it
+// returns
+static struct vk_slab *pool_get_block(struct vk_malloc *ma, struct vk_pool *pool,
+                                      int order, VkDeviceSize *offset)
 {
-    struct vk_slab *slab = NULL;
-    int slab_pages = MINIMUM_PAGE_COUNT;
-    size = PL_ALIGN2(size, PAGE_SIZE_ALIGN);
-    const size_t pagesize = PL_ALIGN(size, align);
-
+    struct vk_slab *slab = NULL, *best = NULL;
+    size_t best_avail = SIZE_MAX;
+    int num_full = 0;
+
+    // Place the allocation in the fullest slab that can still serve it. This
+    // keeps sparsely used slabs from receiving new allocations, so that they
+    // drain over time and can eventually be garbage collected, rather than
+    // fragmenting long-running sessions across many partially used slabs.
     for (int i = 0; i < pool->slabs.num; i++) {
         slab = pool->slabs.elem[i];
-        if (slab->pagesize < size)
-            continue;
-        if (slab->pagesize > pagesize * MINIMUM_PAGE_COUNT) // rough heuristic
-            continue;
-        if (slab->pagesize % align)
+        if (slab->order < order)
             continue;
 
         pl_mutex_lock(&slab->lock);
-        int page_idx = __builtin_ffsll(slab->spacemap);
-        if (!page_idx--) {
-            pl_mutex_unlock(&slab->lock);
-            // Increase the number of slabs to allocate for new slabs the
-            // more existing full slabs exist for this size range
-            slab_pages = PL_MIN(slab_pages << 1, MAXIMUM_PAGE_COUNT);
-            continue;
+        size_t avail = BLOCK_SIZE(slab->order) - slab->reserved;
+        bool fits = buddy_can_alloc(slab, order);
+        pl_mutex_unlock(&slab->lock);
+
+        if (!fits) {
+            // Increase the size of new slabs the more existing slabs are full
+            num_full++;
+        } else if (avail < best_avail) {
+            best = slab;
+            best_avail = avail;
         }
+    }
 
-        slab->spacemap ^= 0x1LLU << page_idx;
-        *offset = page_idx * slab->pagesize;
-        return slab;
+    if (best) {
+        // Blocks can only be allocated with `pool->lock` held, so this can't
+        // have been taken by somebody else in the meantime
+        pl_mutex_lock(&best->lock);
+        buddy_alloc(best, order, offset);
+        return best;
     }
 
     // Otherwise, allocate a new vk_slab and append it to the list.
-    VkDeviceSize slab_size = slab_pages * pagesize;
-    pl_static_assert(MINIMUM_SLAB_SIZE <= PAGE_SIZE_ALIGN * MAXIMUM_PAGE_COUNT);
-    const VkDeviceSize max_slab_size = ma->maximum_page_size * MINIMUM_PAGE_COUNT;
-    pl_assert(pagesize <= ma->maximum_page_size);
-    slab_size = PL_CLAMP(slab_size, MINIMUM_SLAB_SIZE, max_slab_size);
-    slab_pages = slab_size / pagesize;
-    slab_size = slab_pages * pagesize; // max_slab_size may be npot2, trim excess
+    pl_assert(order <= ma->maximum_slab_order);
+    int slab_order = order + block_order(MINIMUM_PAGE_COUNT * MINIMUM_BLOCK_SIZE);
+    slab_order = PL_MAX(slab_order, block_order(MINIMUM_SLAB_SIZE)) + num_full;
+    slab_order = PL_CLAMP(slab_order, order, ma->maximum_slab_order);
 
     struct vk_malloc_params params = pool->params;
-    params.reqs.size = slab_size;
+    params.reqs.size = BLOCK_SIZE(slab_order);
 
     // Don't hold the lock while allocating the slab, because it can be a
     // potentially very costly operation.
-    pl_mutex_unlock(&ma->lock);
+    pl_mutex_unlock(&pool->lock);
     slab = slab_alloc(ma, &params);
-    pl_mutex_lock(&ma->lock);
+    pl_mutex_lock(&pool->lock);
     if (!slab)
         return NULL;
     pl_mutex_lock(&slab->lock);
 
-    slab->spacemap = (slab_pages == sizeof(uint64_t) * 8) ? ~0LLU : ~(~0LLU << slab_pages);
-    slab->pagesize = pagesize;
+    buddy_init(slab, slab_order);
     PL_ARRAY_APPEND(NULL, pool->slabs, slab);
 
-    // Return the first page in this newly allocated slab
-    slab->spacemap ^= 0x1;
-    *offset = 0;
+    // Return the first block in this newly allocated slab
+    pl_assert(slab_order >= order);
+    buddy_alloc(slab, order, offset);
     return slab;
 }
 
@@ -781,6 +1026,14 @@ static bool vk_malloc_import(struct vk_malloc *ma, struct vk_memslice *out,
     if (params->ded_image)
         vk_link_struct(&ainfo, &dinfo);
 
+    VkMemoryAllocateFlagsInfo finfo = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO,
+        .flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT,
+    };
+
+    if (params->buf_usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT)
+        vk_link_struct(&ainfo, &finfo);
+
     VkBuffer buffer = VK_NULL_HANDLE;
     VkMemoryRequirements reqs = params->reqs;
 
@@ -999,6 +1252,7 @@ bool vk_malloc_slice(struct vk_malloc *ma, struct vk_memslice *out,
     if (params->import_handle)
         return vk_malloc_import(ma, out, params);
 
+    pl_clock_t start = pl_trace_test(vk->log) ? pl_clock_now() : 0;
     pl_assert(params->reqs.size);
     size_t size = params->reqs.size;
     size_t align = params->reqs.alignment;
@@ -1008,17 +1262,24 @@ bool vk_malloc_slice(struct vk_malloc *ma, struct vk_memslice *out,
     struct vk_slab *slab;
     VkDeviceSize offset;
 
-    if (params->ded_image || size > ma->maximum_page_size) {
+    // Buddy blocks are only aligned to their own (power of two) size
+    bool align_pot = !(align & (align - 1));
+    if (params->ded_image || size > ma->maximum_page_size || !align_pot) {
         slab = slab_alloc(ma, params);
         if (!slab)
             return false;
         slab->dedicated = true;
         offset = 0;
     } else {
-        pl_mutex_lock(&ma->lock);
+        // For accounting, just treat the alignment as part of the used size.
+        // Doing it this way makes sure that the sizes reported to vk_memslice
+        // consumers are always aligned properly.
+        size = PL_ALIGN2(size, align);
+
         struct vk_pool *pool = find_pool(ma, params);
-        slab = pool_get_page(ma, pool, size, align, &offset);
-        pl_mutex_unlock(&ma->lock);
+        pl_mutex_lock(&pool->lock);
+        slab = pool_get_block(ma, pool, block_order(size), &offset);
+        pl_mutex_unlock(&pool->lock);
         if (!slab) {
             PL_ERR(ma->vk, "No slab to serve request for %s bytes (with "
                    "alignment 0x%zx) in pool %d!",
@@ -1026,10 +1287,6 @@ bool vk_malloc_slice(struct vk_malloc *ma, struct vk_memslice *out,
             return false;
         }
 
-        // For accounting, just treat the alignment as part of the used size.
-        // Doing it this way makes sure that the sizes reported to vk_memslice
-        // consumers are always aligned properly.
-        size = PL_ALIGN(size, align);
         slab->used += size;
         slab->age = ma->age;
         if (params->debug_tag)
@@ -1054,5 +1311,7 @@ bool vk_malloc_slice(struct vk_malloc *ma, struct vk_memslice *out,
             .size = slab->size,
         },
     };
+
+    pl_trace_ev(vk->log, PL_EV_VK_MALLOC, start, size, slab->dedicated);
     return true;
 }
@@ -65,8 +65,14 @@ bool vk_malloc_slice(struct vk_malloc *ma, struct vk_memslice *out,
 void vk_malloc_free(struct vk_malloc *ma, struct vk_memslice *slice);
 
 // Clean up unused slabs. Call this roughly once per frame to reduce
-// memory pressure / memory leaks.
+// memory pressure / memory leaks. Empty slabs are released immediately, and
+// the user's memory pressure callback invoked, for heaps close to their
+// budget.
 void vk_malloc_garbage_collect(struct vk_malloc *ma);
 
+// Query the current usage and budget of each heap. Returns the number of heaps.
+int vk_malloc_query_budget(struct vk_malloc *ma,
+                           struct pl_vulkan_heap_budget out[VK_MAX_MEMORY_HEAPS]);
+
 // For debugging purposes. Doesn't include dedicated slab allocations!
 void vk_malloc_print_stats(struct vk_malloc *ma, enum pl_log_level);
@@ -52,6 +52,12 @@ pl_vulkan pl_vulkan_get(pl_gpu gpu)
     return NULL;
 }
 
+int pl_vulkan_get_memory_budget(pl_gpu gpu,
+                                struct pl_vulkan_heap_budget out[VK_MAX_MEMORY_HEAPS])
+{
+    return 0;
+}
+
 VkPhysicalDevice pl_vulkan_choose_device(pl_log log,
                               const struct pl_vulkan_device_params *params)
 {
@@ -70,6 +76,17 @@ bool pl_vulkan_swapchain_suboptimal(pl_swapchain sw)
     pl_unreachable();
 }
 
+bool pl_vulkan_swapchain_set_present_mode(pl_swapchain sw, VkPresentModeKHR mode)
+{
+    pl_unreachable();
+}
+
+void pl_vulkan_swapchain_get_stats(pl_swapchain sw,
+                                   struct pl_vulkan_swapchain_stats *out)
+{
+    pl_unreachable();
+}
+
 pl_vulkan pl_vulkan_import(pl_log log, const struct pl_vulkan_import_params *params)
 {
     pl_fatal(log, "libplacebo compiled without Vulkan support!");
@@ -106,3 +123,37 @@ void pl_vulkan_sem_destroy(pl_gpu gpu, VkSemaphore *semaphore)
 {
     pl_unreachable();
 }
+
+pl_vulkan_shared_pool pl_vulkan_shared_pool_create(pl_gpu gpu,
+                                const struct pl_vulkan_shared_pool_params *params)
+{
+    pl_unreachable();
+}
+
+void pl_vulkan_shared_pool_destroy(pl_vulkan_shared_pool *pool)
+{
+    pl_unreachable();
+}
+
+const struct pl_vulkan_shared_pool_desc *
+pl_vulkan_shared_pool_desc(pl_vulkan_shared_pool pool)
+{
+    pl_unreachable();
+}
+
+pl_tex pl_vulkan_shared_pool_tex(pl_vulkan_shared_pool pool, int index)
+{
+    pl_unreachable();
+}
+
+bool pl_vulkan_shared_pool_send(pl_vulkan_shared_pool pool, int index,
+                                uint64_t *out_value)
+{
+    pl_unreachable();
+}
+
+bool pl_vulkan_shared_pool_recv(pl_vulkan_shared_pool pool, int index,
+                                uint64_t value)
+{
+    pl_unreachable();
+}
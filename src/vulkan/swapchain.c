@@ -15,12 +15,15 @@
  * License along with libplacebo.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <time.h>
+
 #include "common.h"
 #include "command.h"
 #include "formats.h"
 #include "utils.h"
 #include "gpu.h"
 #include "swapchain.h"
+#include "pl_clock.h"
 #include "pl_thread.h"
 
 struct sem_pair {
@@ -35,6 +38,7 @@ struct priv {
     struct vk_ctx *vk;
     VkSurfaceKHR surf;
     PL_ARRAY(VkSurfaceFormatKHR) formats;
+    PL_ARRAY(VkPresentModeKHR) present_modes;
 
     // current swapchain and metadata:
     struct pl_vulkan_swapchain_params params;
@@ -54,6 +58,22 @@ struct priv {
     PL_ARRAY(struct sem_pair) sems; // pool of semaphores used to synchronize images
     int idx_sems;                   // index of next free semaphore pair
     int last_imgidx;                // the image index last acquired (for submit)
+
+    // presentation timing feedback (VK_GOOGLE_display_timing) and runtime
+    // statistics, guarded by their own lock since they may be queried during
+    // a started frame
+    pl_mutex timing_lock;
+    struct pl_sw_timing timing;
+    struct pl_vulkan_swapchain_stats stats;
+
+    // presentation IDs, also used for VK_KHR_present_wait if available
+    uint64_t present_id;            // ID of the last submitted presentation
+    uint64_t first_present_id;      // ID of the first present on `swapchain`
+    bool present_wait;
+
+    // damaged regions of the current frame (VK_KHR_incremental_present)
+    bool incremental_present;
+    PL_ARRAY(VkRectLayerKHR) damage;
 };
 
 static const struct pl_sw_fns vulkan_swapchain;
@@ -315,6 +335,16 @@ static void set_hdr_metadata(struct priv *p, const struct pl_hdr_metadata *metad
     p->color_space.hdr = p->hdr_metadata;
 }
 
+static bool present_mode_supported(const struct priv *p, VkPresentModeKHR mode)
+{
+    for (int i = 0; i < p->present_modes.num; i++) {
+        if (p->present_modes.elem[i] == mode)
+            return true;
+    }
+
+    return false;
+}
+
 pl_swapchain pl_vulkan_create_swapchain(pl_vulkan plvk,
                               const struct pl_vulkan_swapchain_params *params)
 {
@@ -332,6 +362,9 @@ pl_swapchain pl_vulkan_create_swapchain(pl_vulkan plvk,
 
     struct priv *p = PL_PRIV(sw);
     pl_mutex_init(&p->lock);
+    pl_mutex_init(&p->timing_lock);
+    p->timing.last_count = -1;
+    p->first_present_id = 1;
     p->impl = vulkan_swapchain;
     p->params = *params;
     p->vk = vk;
@@ -345,11 +378,28 @@ pl_swapchain pl_vulkan_create_swapchain(pl_vulkan plvk,
         .surface = p->surf,
         .imageArrayLayers = 1, // non-stereoscopic
         .imageSharingMode = VK_SHARING_MODE_EXCLUSIVE,
-        .minImageCount = p->swapchain_depth + 1, // +1 for the FB
+        .minImageCount = PL_DEF(params->image_count, p->swapchain_depth + 1), // +1 for the FB
         .presentMode = params->present_mode,
         .clipped = true,
     };
 
+#ifdef VK_KHR_present_wait
+    const VkPhysicalDevicePresentIdFeaturesKHR *present_id;
+    const VkPhysicalDevicePresentWaitFeaturesKHR *present_wait;
+    present_id = vk_find_struct(&vk->features,
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR);
+    present_wait = vk_find_struct(&vk->features,
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR);
+    p->present_wait = vk->WaitForPresentKHR &&
+                      present_id && present_id->presentId &&
+                      present_wait && present_wait->presentWait;
+#endif
+
+    for (int i = 0; i < vk->exts.num; i++) {
+        if (!strcmp(vk->exts.elem[i], VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME))
+            p->incremental_present = true;
+    }
+
     // These fields will be updated by `vk_sw_recreate`
     p->color_space = pl_color_space_unknown;
     p->color_repr = (struct pl_color_repr) {
@@ -359,18 +409,14 @@ pl_swapchain pl_vulkan_create_swapchain(pl_vulkan plvk,
     };
 
     // Make sure the swapchain present mode is supported
-    VkPresentModeKHR *modes = NULL;
     uint32_t num_modes = 0;
     VK(vk->GetPhysicalDeviceSurfacePresentModesKHR(vk->physd, p->surf, &num_modes, NULL));
-    modes = pl_calloc_ptr(NULL, num_modes, modes);
-    VK(vk->GetPhysicalDeviceSurfacePresentModesKHR(vk->physd, p->surf, &num_modes, modes));
-
-    bool supported = false;
-    for (int i = 0; i < num_modes; i++)
-        supported |= (modes[i] == p->protoInfo.presentMode);
-    pl_free_ptr(&modes);
+    PL_ARRAY_RESIZE(sw, p->present_modes, num_modes);
+    VK(vk->GetPhysicalDeviceSurfacePresentModesKHR(vk->physd, p->surf, &num_modes,
+                                                   p->present_modes.elem));
+    p->present_modes.num = num_modes;
 
-    if (!supported) {
+    if (!present_mode_supported(p, p->protoInfo.presentMode)) {
         PL_WARN(vk, "Requested swap mode unsupported by this device, falling "
                 "back to VK_PRESENT_MODE_FIFO_KHR");
         p->protoInfo.presentMode = VK_PRESENT_MODE_FIFO_KHR;
@@ -398,7 +444,6 @@ pl_swapchain pl_vulkan_create_swapchain(pl_vulkan plvk,
     return sw;
 
 error:
-    pl_free(modes);
     pl_free(sw);
     return NULL;
 }
@@ -428,6 +473,7 @@ static void vk_sw_destroy(pl_swapchain sw)
     }
 
     vk->DestroySwapchainKHR(vk->dev, p->swapchain, PL_VK_ALLOC);
+    pl_mutex_destroy(&p->timing_lock);
     pl_mutex_destroy(&p->lock);
     pl_free((void *) sw);
 }
@@ -615,10 +661,19 @@ static bool vk_sw_recreate(pl_swapchain sw, int w, int h)
     // collect it afterwards - asynchronously as it may still be in use
     sinfo.oldSwapchain = p->swapchain;
     p->swapchain = VK_NULL_HANDLE;
+    p->first_present_id = p->present_id + 1;
     VkResult res = vk->CreateSwapchainKHR(vk->dev, &sinfo, PL_VK_ALLOC, &p->swapchain);
     vk_dev_callback(vk, (vk_cb) destroy_swapchain, vk, vk_wrap_handle(sinfo.oldSwapchain));
     PL_VK_ASSERT(res, "vk->CreateSwapchainKHR(...)");
 
+    if (vk->GetRefreshCycleDurationGOOGLE) {
+        VkRefreshCycleDurationGOOGLE refresh = {0};
+        res = vk->GetRefreshCycleDurationGOOGLE(vk->dev, p->swapchain, &refresh);
+        pl_mutex_lock(&p->timing_lock);
+        p->timing.nominal = res == VK_SUCCESS ? refresh.refreshDuration * 1e-9 : 0.0;
+        pl_mutex_unlock(&p->timing_lock);
+    }
+
     // Get the new swapchain images
     VK(vk->GetSwapchainImagesKHR(vk->dev, p->swapchain, &num_images, NULL));
     vkimages = pl_calloc_ptr(NULL, num_images, vkimages);
@@ -664,6 +719,11 @@ static bool vk_sw_recreate(pl_swapchain sw, int w, int h)
     }
 
     pl_assert(num_images > 0);
+    pl_mutex_lock(&p->timing_lock);
+    p->stats.present_mode = sinfo.presentMode;
+    p->stats.num_images = num_images;
+    pl_mutex_unlock(&p->timing_lock);
+
     int bits = 0;
 
     // The channel with the most bits is probably the most authoritative about
@@ -718,6 +778,7 @@ static bool vk_sw_start_frame(pl_swapchain sw,
 
     for (int attempts = 0; attempts < 2; attempts++) {
         uint32_t imgidx = 0;
+        pl_clock_t start = pl_clock_now();
         VkResult res = vk->AcquireNextImageKHR(vk->dev, p->swapchain, UINT64_MAX,
                                                sem_in, VK_NULL_HANDLE, &imgidx);
 
@@ -725,8 +786,18 @@ static bool vk_sw_start_frame(pl_swapchain sw,
         case VK_SUBOPTIMAL_KHR:
             p->suboptimal = true;
             // fall through
-        case VK_SUCCESS:
+        case VK_SUCCESS: {
+            const float time = pl_clock_diff(pl_clock_now(), start);
+            pl_mutex_lock(&p->timing_lock);
+            struct pl_vulkan_swapchain_stats *stats = &p->stats;
+            stats->acquire_time = stats->acquired_frames++
+                                ? PL_MIX(stats->acquire_time, time, 0.1)
+                                : time;
+            stats->acquire_time_max = PL_MAX(stats->acquire_time_max, time);
+            pl_mutex_unlock(&p->timing_lock);
+
             p->last_imgidx = imgidx;
+            p->damage.num = 0;
             pl_vulkan_release_ex(sw->gpu, pl_vulkan_release_params(
                 .tex        = p->images.elem[imgidx],
                 .layout     = VK_IMAGE_LAYOUT_UNDEFINED,
@@ -741,6 +812,7 @@ static bool vk_sw_start_frame(pl_swapchain sw,
             };
             // keep lock held
             return true;
+        }
 
         case VK_ERROR_OUT_OF_DATE_KHR: {
             // In these cases try recreating the swapchain
@@ -769,6 +841,62 @@ static void present_cb(struct priv *p, void *arg)
     (void) pl_rc_deref(&p->frames_in_flight);
 }
 
+// Collect the timing feedback for all completed presentations. Must be
+// called with `p->lock` held, since it accesses the swapchain
+static void poll_timing(struct priv *p)
+{
+    struct vk_ctx *vk = p->vk;
+    if (!vk->GetPastPresentationTimingGOOGLE || !p->swapchain)
+        return;
+
+    VkPastPresentationTimingGOOGLE timings[16];
+    uint32_t num;
+    VkResult res;
+    do {
+        num = PL_ARRAY_SIZE(timings);
+        res = vk->GetPastPresentationTimingGOOGLE(vk->dev, p->swapchain, &num, timings);
+        if (res != VK_SUCCESS && res != VK_INCOMPLETE)
+            return;
+
+        pl_mutex_lock(&p->timing_lock);
+        for (uint32_t i = 0; i < num; i++)
+            pl_sw_timing_push(&p->timing, timings[i].actualPresentTime * 1e-9, -1);
+        pl_mutex_unlock(&p->timing_lock);
+    } while (res == VK_INCOMPLETE);
+}
+
+static void vk_sw_damage(pl_swapchain sw, const pl_rect2d *rects, int num_rects)
+{
+    struct priv *p = PL_PRIV(sw);
+    p->damage.num = 0;
+    if (!p->incremental_present)
+        return;
+
+    // Called with `p->lock` held, between start_frame and submit_frame
+    pl_assert(p->last_imgidx >= 0);
+    const int w = p->cur_width, h = p->cur_height;
+    for (int i = 0; i < num_rects; i++) {
+        pl_rect2d rc = rects[i];
+        pl_rect2d_normalize(&rc);
+        rc.x0 = PL_CLAMP(rc.x0, 0, w);
+        rc.y0 = PL_CLAMP(rc.y0, 0, h);
+        rc.x1 = PL_CLAMP(rc.x1, 0, w);
+        rc.y1 = PL_CLAMP(rc.y1, 0, h);
+        if (!pl_rect_w(rc) || !pl_rect_h(rc))
+            continue;
+        PL_ARRAY_APPEND(sw, p->damage, (VkRectLayerKHR) {
+            .offset = { rc.x0, rc.y0 },
+            .extent = { pl_rect_w(rc), pl_rect_h(rc) },
+        });
+    }
+
+    if (num_rects && !p->damage.num) {
+        // Nothing changed, but a zero rect count means "everything changed",
+        // so submit a single (valid) pixel instead
+        PL_ARRAY_APPEND(sw, p->damage, (VkRectLayerKHR) { .extent = {1, 1} });
+    }
+}
+
 static bool vk_sw_submit_frame(pl_swapchain sw)
 {
     pl_gpu gpu = sw->gpu;
@@ -823,10 +951,51 @@ static bool vk_sw_submit_frame(pl_swapchain sw)
         .pImageIndices = &idx,
     };
 
+    // Tag each presentation with an ID, which is required for receiving
+    // timing feedback about it, or waiting on it
+    const uint64_t present_id = ++p->present_id;
+    VkPresentTimesInfoGOOGLE times = {
+        .sType = VK_STRUCTURE_TYPE_PRESENT_TIMES_INFO_GOOGLE,
+        .swapchainCount = 1,
+        .pTimes = &(VkPresentTimeGOOGLE) {
+            .presentID = (uint32_t) present_id,
+        },
+    };
+
+    if (vk->GetPastPresentationTimingGOOGLE) {
+        vk_link_struct(&pinfo, &times);
+        poll_timing(p);
+    }
+
+#ifdef VK_KHR_present_wait
+    VkPresentIdKHR ids = {
+        .sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR,
+        .swapchainCount = 1,
+        .pPresentIds = &present_id,
+    };
+
+    if (p->present_wait)
+        vk_link_struct(&pinfo, &ids);
+#endif
+
+    VkPresentRegionsKHR regions = {
+        .sType = VK_STRUCTURE_TYPE_PRESENT_REGIONS_KHR,
+        .swapchainCount = 1,
+        .pRegions = &(VkPresentRegionKHR) {
+            .rectangleCount = p->damage.num,
+            .pRectangles = p->damage.elem,
+        },
+    };
+
+    if (p->damage.num) {
+        vk_link_struct(&pinfo, &regions);
+        p->damage.num = 0;
+    }
+
     PL_TRACE(vk, "vkQueuePresentKHR waits on 0x%"PRIx64, (uint64_t) sem_out);
-    vk->lock_queue(vk->queue_ctx, pool->qf, qidx);
+    vk->lock_queue(vk->queue_ctx, pool->qf, pool->qfirst + qidx);
     VkResult res = vk->QueuePresentKHR(queue, &pinfo);
-    vk->unlock_queue(vk->queue_ctx, pool->qf, qidx);
+    vk->unlock_queue(vk->queue_ctx, pool->qf, pool->qfirst + qidx);
     pl_mutex_unlock(&p->lock);
 
     switch (res) {
@@ -853,12 +1022,18 @@ static void vk_sw_swap_buffers(pl_swapchain sw)
     struct priv *p = PL_PRIV(sw);
 
     pl_mutex_lock(&p->lock);
+    pl_clock_t start = pl_clock_now();
     while (pl_rc_count(&p->frames_in_flight) >= p->swapchain_depth) {
         pl_mutex_unlock(&p->lock); // don't hold mutex while blocking
         vk_poll_commands(p->vk, UINT64_MAX);
         pl_mutex_lock(&p->lock);
     }
     pl_mutex_unlock(&p->lock);
+
+    const float time = pl_clock_diff(pl_clock_now(), start);
+    pl_mutex_lock(&p->timing_lock);
+    p->stats.swap_time = PL_MIX(p->stats.swap_time, time, 0.1);
+    pl_mutex_unlock(&p->timing_lock);
 }
 
 static bool vk_sw_resize(pl_swapchain sw, int *width, int *height)
@@ -894,18 +1069,109 @@ static void vk_sw_colorspace_hint(pl_swapchain sw, const struct pl_color_space *
     pl_mutex_unlock(&p->lock);
 }
 
+static bool vk_sw_wait_presented(pl_swapchain sw, int max_queued, uint64_t timeout)
+{
+#ifdef VK_KHR_present_wait
+    struct priv *p = PL_PRIV(sw);
+    struct vk_ctx *vk = p->vk;
+    if (!p->present_wait)
+        return false;
+
+    pl_mutex_lock(&p->lock);
+    max_queued = PL_MAX(max_queued, 0);
+    uint64_t target = p->present_id - PL_MIN(p->present_id, max_queued);
+    if (!target || target < p->first_present_id || !p->swapchain) {
+        // Nothing to wait on, or only presents to retired swapchains
+        pl_mutex_unlock(&p->lock);
+        return true;
+    }
+
+    VkResult res = vk->WaitForPresentKHR(vk->dev, p->swapchain, target, timeout);
+    pl_mutex_unlock(&p->lock);
+
+    switch (res) {
+    case VK_SUBOPTIMAL_KHR:
+        p->suboptimal = true;
+        // fall through
+    case VK_SUCCESS:
+    case VK_ERROR_OUT_OF_DATE_KHR: // will be recreated on the next frame
+        return true;
+
+    case VK_TIMEOUT:
+        return false;
+
+    default:
+        PL_ERR(vk, "Failed waiting for presentation: %s", vk_res_str(res));
+        return false;
+    }
+#else
+    return false;
+#endif
+}
+
+static double monotonic_time(void)
+{
+#if defined(CLOCK_MONOTONIC) && !defined(PL_HAVE_WIN32)
+    // Matches the time base used by common VK_GOOGLE_display_timing
+    // implementations
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+        return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+    return 0.0;
+}
+
+static bool vk_sw_get_timing(pl_swapchain sw, struct pl_swapchain_timing *out)
+{
+    struct priv *p = PL_PRIV(sw);
+    pl_mutex_lock(&p->timing_lock);
+    bool ok = pl_sw_timing_get(&p->timing, monotonic_time(), out);
+    pl_mutex_unlock(&p->timing_lock);
+    return ok;
+}
+
 bool pl_vulkan_swapchain_suboptimal(pl_swapchain sw)
 {
     struct priv *p = PL_PRIV(sw);
     return p->suboptimal;
 }
 
+bool pl_vulkan_swapchain_set_present_mode(pl_swapchain sw, VkPresentModeKHR mode)
+{
+    struct priv *p = PL_PRIV(sw);
+    if (!present_mode_supported(p, mode)) {
+        PL_ERR(p->vk, "Requested swap mode unsupported by this device!");
+        return false;
+    }
+
+    pl_mutex_lock(&p->lock);
+    if (p->protoInfo.presentMode != mode) {
+        p->protoInfo.presentMode = mode;
+        p->needs_recreate = true;
+    }
+    pl_mutex_unlock(&p->lock);
+    return true;
+}
+
+void pl_vulkan_swapchain_get_stats(pl_swapchain sw,
+                                   struct pl_vulkan_swapchain_stats *out)
+{
+    struct priv *p = PL_PRIV(sw);
+    pl_mutex_lock(&p->timing_lock);
+    *out = p->stats;
+    pl_mutex_unlock(&p->timing_lock);
+    out->frames_in_flight = pl_rc_count(&p->frames_in_flight);
+}
+
 static const struct pl_sw_fns vulkan_swapchain = {
     .destroy            = vk_sw_destroy,
     .latency            = vk_sw_latency,
     .resize             = vk_sw_resize,
     .colorspace_hint    = vk_sw_colorspace_hint,
     .start_frame        = vk_sw_start_frame,
+    .damage             = vk_sw_damage,
     .submit_frame       = vk_sw_submit_frame,
     .swap_buffers       = vk_sw_swap_buffers,
+    .get_timing         = vk_sw_get_timing,
+    .wait_presented     = vk_sw_wait_presented,
 };